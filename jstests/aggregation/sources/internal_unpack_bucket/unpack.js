@@ -0,0 +1,62 @@
+// Basic testing for the $_internalUnpackBucket aggregation stage, which unpacks time-series bucket
+// documents into the measurements they hold.
+(function() {
+"use strict";
+
+load("jstests/aggregation/extras/utils.js");  // For assertArrayEq.
+
+const coll = db.internal_unpack_bucket;
+coll.drop();
+
+const t0 = ISODate("2020-01-01T00:00:00Z");
+const t1 = ISODate("2020-01-01T00:00:01Z");
+const t2 = ISODate("2020-01-01T00:01:00Z");
+const t3 = ISODate("2020-01-01T00:01:01Z");
+
+assert.commandWorked(coll.insert([
+    {
+        _id: 0,
+        meta: {sensor: "a"},
+        control: {min: {_id: 0, time: t0, temp: 20}, max: {_id: 1, time: t1, temp: 21}},
+        data: {_id: {"0": 0, "1": 1}, time: {"0": t0, "1": t1}, temp: {"0": 20, "1": 21}}
+    },
+    {
+        _id: 1,
+        meta: {sensor: "b"},
+        control: {min: {_id: 2, time: t2, temp: 30}, max: {_id: 3, time: t3, temp: 30}},
+        data: {_id: {"0": 2, "1": 3}, time: {"0": t2, "1": t3}, temp: {"1": 30}}
+    },
+]));
+
+const unpack = {$_internalUnpackBucket: {exclude: [], timeField: "time", metaField: "tag"}};
+
+// Every measurement is unpacked, with the bucket's meta value as its 'tag' field.
+assertArrayEq({
+    actual: coll.aggregate([unpack]).toArray(),
+    expected: [
+        {_id: 0, time: t0, temp: 20, tag: {sensor: "a"}},
+        {_id: 1, time: t1, temp: 21, tag: {sensor: "a"}},
+        {_id: 2, time: t2, tag: {sensor: "b"}},
+        {_id: 3, time: t3, temp: 30, tag: {sensor: "b"}},
+    ]
+});
+
+// Only the included fields are produced.
+assertArrayEq({
+    actual: coll.aggregate([
+                    {$_internalUnpackBucket: {include: ["temp"], timeField: "time"}}
+                ]).toArray(),
+    expected: [{temp: 20}, {temp: 21}, {}, {temp: 30}]
+});
+
+// Predicates on the meta and time fields give the same results as filtering the measurements.
+assertArrayEq({
+    actual: coll.aggregate([unpack, {$match: {"tag.sensor": "a", time: {$gt: t0}}}]).toArray(),
+    expected: [{_id: 1, time: t1, temp: 21, tag: {sensor: "a"}}]
+});
+assertArrayEq({
+    actual: coll.aggregate([unpack, {$match: {time: {$gte: t2}, temp: {$exists: false}}}])
+                .toArray(),
+    expected: [{_id: 2, time: t2, tag: {sensor: "b"}}]
+});
+})();
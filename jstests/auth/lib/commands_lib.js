@@ -2646,6 +2646,19 @@ var authCommandsLib = {
               }
           ]
         },
+        {
+          testname: "cpuProfile",
+          command: {cpuProfile: 1},
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: Object.extend({backup: 1}, roles_monitoring),
+                privileges: [{resource: {cluster: true}, actions: ["serverStatus"]}]
+              },
+              {runOnDb: firstDbName, roles: {}, expectFail: true},
+              {runOnDb: secondDbName, roles: {}, expectFail: true}
+          ]
+        },
         {
           testname: "createRole_authenticationRestrictions",
           command: {
@@ -0,0 +1,58 @@
+// Tests the dbHash command with {unordered: true}, which hashes the documents of each collection
+// without regard to the order they are stored in.
+// @tags: [
+//   assumes_superuser_permissions,
+//   # dbhash command is not available on embedded
+//   incompatible_with_embedded,
+// ]
+(function() {
+"use strict";
+
+const testDB = db.getSiblingDB("dbhash_unordered");
+assert.commandWorked(testDB.dropDatabase());
+
+const docs = [];
+for (let i = 0; i < 100; ++i) {
+    docs.push({_id: i, x: i, s: "value " + i});
+}
+
+// Insert the same documents into two collections in opposite orders.
+assert.commandWorked(testDB.forward.insert(docs));
+assert.commandWorked(testDB.backward.insert(docs.slice().reverse()));
+
+const unorderedHashes = () => {
+    return assert.commandWorked(testDB.runCommand({dbHash: 1, unordered: true})).collections;
+};
+
+let hashes = unorderedHashes();
+assert.eq(hashes.forward, hashes.backward, tojson(hashes));
+
+// The hash is stable across runs.
+assert.eq(hashes, unorderedHashes());
+
+// Changing a single document changes the hash.
+assert.commandWorked(testDB.backward.update({_id: 50}, {$set: {x: -1}}));
+hashes = unorderedHashes();
+assert.neq(hashes.forward, hashes.backward, tojson(hashes));
+
+// Changing it back restores it.
+assert.commandWorked(testDB.backward.update({_id: 50}, {$set: {x: 50}}));
+hashes = unorderedHashes();
+assert.eq(hashes.forward, hashes.backward, tojson(hashes));
+
+// Removing a document changes the hash.
+assert.commandWorked(testDB.backward.remove({_id: 0}));
+hashes = unorderedHashes();
+assert.neq(hashes.forward, hashes.backward, tojson(hashes));
+
+// An empty collection hashes the same regardless.
+assert.commandWorked(testDB.forward.remove({}));
+assert.commandWorked(testDB.backward.remove({}));
+hashes = unorderedHashes();
+assert.eq(hashes.forward, hashes.backward, tojson(hashes));
+
+// The 'collections' filter is honored.
+const res = testDB.runCommand({dbHash: 1, unordered: true, collections: ["forward"]});
+hashes = assert.commandWorked(res).collections;
+assert.eq(["forward"], Object.keys(hashes), tojson(hashes));
+})();
@@ -0,0 +1,50 @@
+/**
+ * Tests that a $match immediately followed by $sample is answered by filtering documents read from
+ * a random cursor when enough of the collection matches and no index can answer the $match, and by
+ * the query planner otherwise.
+ * @tags: [requires_wiredtiger, assumes_unsharded_collection]
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/analyze_plan.js");
+
+// Although this test is tagged with 'requires_wiredtiger', this is not sufficient for ensuring
+// that the parallel suite runs this test only on WT configurations.
+if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+    jsTest.log("Skipping test on non-WT storage engine: " + jsTest.options().storageEngine);
+    return;
+}
+
+const coll = db.sample_with_match_random_cursor;
+coll.drop();
+
+let docsToInsert = [];
+for (let i = 0; i < 1000; ++i) {
+    docsToInsert.push({_id: i, even: i % 2 === 0, rare: i === 0});
+}
+assert.commandWorked(coll.insert(docsToInsert));
+
+// Half of the collection matches, so the random cursor can be used.
+const pipeline = [{$match: {even: true}}, {$sample: {size: 10}}];
+let explain = coll.explain().aggregate(pipeline);
+assert(aggPlanHasStage(explain, "MULTI_ITERATOR"), tojson(explain));
+
+const results = coll.aggregate(pipeline).toArray();
+assert.eq(results.length, 10, tojson(results));
+assert.eq(new Set(results.map(doc => doc._id)).size, 10, tojson(results));
+results.forEach(doc => assert(doc.even, tojson(results)));
+
+// Too few documents match for rejection sampling, so the query planner answers the $match.
+explain = coll.explain().aggregate([{$match: {rare: true}}, {$sample: {size: 1}}]);
+assert(!aggPlanHasStage(explain, "MULTI_ITERATOR"), tojson(explain));
+assert.eq(coll.aggregate([{$match: {rare: true}}, {$sample: {size: 1}}]).toArray(),
+          [{_id: 0, even: true, rare: true}]);
+
+// An index can answer the $match, so the query planner is used without presampling.
+assert.commandWorked(coll.createIndex({even: 1}));
+explain = coll.explain().aggregate(pipeline);
+assert(!aggPlanHasStage(explain, "MULTI_ITERATOR"), tojson(explain));
+assert(aggPlanHasStage(explain, "IXSCAN"), tojson(explain));
+assert.eq(coll.aggregate(pipeline).toArray().length, 10);
+}());
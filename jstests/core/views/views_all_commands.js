@@ -178,6 +178,7 @@ let viewsCommandTests = {
     coordinateCommitTransaction: {skip: isUnrelated},
     count: {command: {count: "view"}},
     cpuload: {skip: isAnInternalCommand},
+    cpuProfile: {skip: isUnrelated},
     create: {skip: "tested in views/views_creation.js"},
     createIndexes: {
         command: {createIndexes: "view", indexes: [{key: {x: 1}, name: "x_1"}]},
@@ -0,0 +1,80 @@
+/**
+ * Tests that validate with {background: true} in a replica set reports the same results whether
+ * the indexes are traversed concurrently with the collection or after it.
+ *
+ * @tags: [
+ *   # Background validation is only supported by WT.
+ *   requires_wiredtiger,
+ *   # inMemory does not have checkpoints; background validation only runs on a checkpoint.
+ *   requires_persistence,
+ *   # Checkpoint cursors cannot be open in lsm.
+ *   does_not_support_wiredtiger_lsm,
+ *   requires_replication,
+ * ]
+ */
+(function() {
+'use strict';
+
+const replSet = new ReplSetTest({nodes: 1});
+replSet.startSet();
+replSet.initiate();
+
+const primary = replSet.getPrimary();
+const testDB = primary.getDB("test");
+const coll = testDB.background_validation_concurrent_index_traversal;
+
+assert.commandWorked(coll.createIndex({a: 1}));
+assert.commandWorked(coll.createIndex({b: 1}));
+assert.commandWorked(coll.createIndex({c: 1}));
+assert.commandWorked(coll.createIndex({"$**": 1}));
+
+const numDocs = 1000;
+const docs = [];
+for (let i = 0; i < numDocs; ++i) {
+    docs.push({a: i, b: i, c: i});
+}
+assert.commandWorked(coll.insert(docs));
+
+// Runs background validation with each number of index traversal threads and checks the results.
+const validateWithEachThreadCount = (checkFn) => {
+    assert.commandWorked(testDB.adminCommand({fsync: 1}));
+    for (let numThreads of [0, 1, 4]) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, maxValidateIndexTraversalThreads: numThreads}));
+        const res = assert.commandWorked(coll.validate({background: true}));
+        jsTestLog("Validated with " + numThreads + " index traversal threads: " + tojson(res));
+        checkFn(res);
+    }
+};
+
+validateWithEachThreadCount((res) => {
+    assert(res.valid, tojson(res));
+    assert.eq(res.nrecords, numDocs, tojson(res));
+    assert.eq(res.keysPerIndex._id_, numDocs, tojson(res));
+    assert.eq(res.keysPerIndex.a_1, numDocs, tojson(res));
+    assert.eq(res.keysPerIndex.b_1, numDocs, tojson(res));
+    assert.eq(res.keysPerIndex.c_1, numDocs, tojson(res));
+});
+
+// Leave behind an index entry in 'b_1' that no longer has a document.
+assert.commandWorked(primary.adminCommand({
+    configureFailPoint: "skipUnindexingDocumentWhenDeleted",
+    mode: "alwaysOn",
+    data: {indexName: "b_1"}
+}));
+assert.commandWorked(coll.remove({a: 0}));
+assert.commandWorked(
+    primary.adminCommand({configureFailPoint: "skipUnindexingDocumentWhenDeleted", mode: "off"}));
+
+validateWithEachThreadCount((res) => {
+    assert(!res.valid, tojson(res));
+    assert.eq(res.nrecords, numDocs - 1, tojson(res));
+    assert.eq(res.keysPerIndex.a_1, numDocs - 1, tojson(res));
+    assert.eq(res.keysPerIndex.b_1, numDocs, tojson(res));
+    assert.eq(res.extraIndexEntries.length, 1, tojson(res));
+    assert.eq(res.extraIndexEntries[0].indexName, "b_1", tojson(res));
+    assert.eq(res.missingIndexEntries.length, 0, tojson(res));
+});
+
+replSet.stopSet(undefined, undefined, {skipValidation: true});
+})();
@@ -0,0 +1,55 @@
+/**
+ * Tests that the sampling CPU profiler aggregates stacks tagged by command, and reports them
+ * through the cpuProfile command and the cpuProfile serverStatus section.
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod(
+    {setParameter: {cpuProfilingEnabled: true, cpuProfilingSampleHz: 997}});
+const adminDB = conn.getDB("admin");
+const testDB = conn.getDB("test");
+
+let res = assert.commandWorked(adminDB.runCommand({cpuProfile: 1}));
+if (!res.running) {
+    // The profiler needs perf_events, which are only available on Linux, and may be restricted by
+    // kernel.perf_event_paranoid.
+    jsTestLog("Skipping test because the CPU profiler could not start");
+    MongoRunner.stopMongod(conn);
+    return;
+}
+
+assert.commandFailedWithCode(adminDB.runCommand({cpuProfile: 1, maxStacks: 0}),
+                             ErrorCodes.BadValue);
+assert.commandFailedWithCode(testDB.runCommand({cpuProfile: 1}), ErrorCodes.Unauthorized);
+
+assert.commandWorked(testDB.coll.insert([...Array(1000).keys()].map(i => ({_id: i, x: i}))));
+
+// Spend enough CPU time in aggregations for them to be sampled.
+assert.soon(() => {
+    testDB.coll.aggregate([{$group: {_id: {$mod: ["$x", 7]}, total: {$sum: "$x"}}}]).toArray();
+
+    res = assert.commandWorked(adminDB.runCommand({cpuProfile: 1}));
+    return res.stacks.some(stack => stack.stack.startsWith("aggregate;"));
+}, "no aggregate samples", 5 * 60 * 1000, 10);
+
+assert.gt(res.samples, 0, tojson(res));
+assert.lte(res.stacks.length, res.numStacks, tojson(res));
+for (let stack of res.stacks) {
+    assert.gt(stack.count, 0, tojson(stack));
+}
+
+const limited = assert.commandWorked(adminDB.runCommand({cpuProfile: 1, maxStacks: 1}));
+assert.eq(1, limited.stacks.length, tojson(limited));
+
+const section = assert.commandWorked(adminDB.runCommand({serverStatus: 1})).cpuProfile;
+assert(section, "missing cpuProfile serverStatus section");
+assert.gt(section.stats.samples, 0, tojson(section));
+
+// Resetting discards the samples aggregated so far.
+assert.commandWorked(adminDB.runCommand({cpuProfile: 1, reset: true}));
+res = assert.commandWorked(adminDB.runCommand({cpuProfile: 1}));
+assert.lt(res.samples, limited.samples, tojson(res));
+
+MongoRunner.stopMongod(conn);
+})();
@@ -60,12 +60,13 @@ function sendAndCheckReads({rst, cmd, minRate, maxRate}) {
     jsTestLog(`Verified ${tojson(cmd)} was mirrored`);
 }
 
-function verifyMirrorReads(rst, cmd) {
+function verifyMirrorReads(rst, cmd, cachePriming = false) {
     {
         jsTestLog(`Verifying disabled read mirroring with ${tojson(cmd)}`);
         let samplingRate = 0.0;
 
-        assert.commandWorked(setParameter({rst: rst, value: {samplingRate: samplingRate}}));
+        assert.commandWorked(setParameter(
+            {rst: rst, value: {samplingRate: samplingRate, cachePriming: cachePriming}}));
         sendAndCheckReads({rst: rst, cmd: cmd, minRate: samplingRate, maxRate: samplingRate});
     }
 
@@ -73,7 +74,8 @@ function verifyMirrorReads(rst, cmd) {
         jsTestLog(`Verifying full read mirroring with ${tojson(cmd)}`);
         let samplingRate = 1.0;
 
-        assert.commandWorked(setParameter({rst: rst, value: {samplingRate: samplingRate}}));
+        assert.commandWorked(setParameter(
+            {rst: rst, value: {samplingRate: samplingRate, cachePriming: cachePriming}}));
         sendAndCheckReads({rst: rst, cmd: cmd, minRate: samplingRate, maxRate: samplingRate});
     }
 
@@ -84,11 +86,38 @@ function verifyMirrorReads(rst, cmd) {
         let max = samplingRate + gaussDeviation;
         let min = samplingRate - gaussDeviation;
 
-        assert.commandWorked(setParameter({rst: rst, value: {samplingRate: samplingRate}}));
+        assert.commandWorked(setParameter(
+            {rst: rst, value: {samplingRate: samplingRate, cachePriming: cachePriming}}));
         sendAndCheckReads({rst: rst, cmd: cmd, minRate: min, maxRate: max});
     }
 }
 
+function verifyCachePrimingStats(rst, cmd) {
+    assert.commandWorked(setParameter({rst: rst, value: {samplingRate: 1.0, cachePriming: true}}));
+
+    const before = getMirroredReadsStats(rst).cachePriming || {};
+    sendAndCheckReads({rst: rst, cmd: cmd, minRate: 1.0, maxRate: 1.0});
+
+    // Every secondary answers every mirrored read, so all of them report the same count.
+    assert.soon(() => {
+        const after = getMirroredReadsStats(rst).cachePriming;
+        jsTestLog(`Cache priming stats: ${tojson(after)}`);
+        return after && rst.getSecondaries().every(function(secondary) {
+            const host = secondary.host;
+            const resolvedBefore = before[host] ? before[host].resolved : 0;
+            return host in after && after[host].resolved - resolvedBefore >= kBurstCount;
+        });
+    });
+
+    const after = getMirroredReadsStats(rst).cachePriming;
+    rst.getSecondaries().forEach(function(secondary) {
+        const stats = after[secondary.host];
+        assert.eq(stats.errors, 0, tojson(stats));
+        assert.gt(stats.latencyMicros, 0, tojson(stats));
+        assert.gt(stats.latencyRatio, 0, tojson(stats));
+    });
+}
+
 {
     const rst = new ReplSetTest({
         nodes: 3,
@@ -128,6 +157,25 @@ function verifyMirrorReads(rst, cmd) {
     verifyMirrorReads(
         rst, {update: kCollName, updates: [{q: {_id: 1}, u: {'$inc': {x: 1}}}], ordered: false});
 
+    jsTestLog("Verifying mirrored reads for 'aggregate' commands");
+    verifyMirrorReads(rst, {aggregate: kCollName, pipeline: [{$match: {}}], cursor: {}});
+
+    jsTestLog("Verifying mirrored reads for 'find' commands in cache priming mode");
+    verifyMirrorReads(rst, {find: kCollName, filter: {}}, true /* cachePriming */);
+
+    jsTestLog("Verifying cache priming statistics");
+    verifyCachePrimingStats(rst, {aggregate: kCollName, pipeline: [{$match: {}}], cursor: {}});
+
+    jsTestLog("Verifying pipelines with write stages are not mirrored");
+    assert.commandWorked(setParameter({rst: rst, value: {samplingRate: 1.0}}));
+    {
+        const before = getMirroredReadsStats(rst);
+        assert.commandWorked(rst.getPrimary().getDB(kDbName).runCommand(
+            {aggregate: kCollName, pipeline: [{$out: "out"}], cursor: {}}));
+        const after = getMirroredReadsStats(rst);
+        assert.eq(before.seen, after.seen);
+    }
+
     rst.stopSet();
 }
 
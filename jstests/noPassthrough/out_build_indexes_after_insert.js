@@ -0,0 +1,58 @@
+/**
+ * Tests that $out with 'internalQueryOutBuildIndexesAfterInsert' builds the indexes of the target
+ * collection once the temp collection is populated, without waiting for the secondaries to build
+ * them, and that unique index violations still fail the $out and leave the target as it was.
+ * @tags: [requires_replication]
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/write_concern_util.js");  // For stopServerReplication.
+
+const rst = new ReplSetTest({
+    nodes: 3,
+    nodeOptions: {setParameter: {internalQueryOutBuildIndexesAfterInsert: true}},
+});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const testDB = primary.getDB(jsTestName());
+const source = testDB.source;
+const target = testDB.target;
+
+assert.commandWorked(source.insert([{_id: 0, a: 0}, {_id: 1, a: 1}, {_id: 2, a: 2}]));
+assert.commandWorked(target.insert({_id: 10, a: 10}));
+assert.commandWorked(target.createIndex({a: 1}, {unique: true}));
+rst.awaitReplication();
+
+// The $out finishes while no secondary can build the indexes of the temp collection.
+stopServerReplication(rst.getSecondaries());
+source.aggregate([{$out: target.getName()}]);
+assert.sameMembers(target.find().toArray(), source.find().toArray());
+assert.eq(2, target.getIndexes().length, tojson(target.getIndexes()));
+restartServerReplication(rst.getSecondaries());
+
+rst.awaitReplication();
+for (let secondary of rst.getSecondaries()) {
+    const secondaryTarget = secondary.getDB(jsTestName()).target;
+    assert.eq(3, secondaryTarget.find().itcount());
+    assert.eq(2, secondaryTarget.getIndexes().length, tojson(secondaryTarget.getIndexes()));
+}
+
+// Results which violate the unique index fail the $out once they have all been inserted, and the
+// target collection is left unchanged.
+assert.commandWorked(source.insert({_id: 3, a: 0}));
+const err = assert.throws(() => source.aggregate([{$out: target.getName()}]));
+assert.commandFailedWithCode(err, ErrorCodes.DuplicateKey);
+assert.eq(3, target.find().itcount());
+assert.eq(0, target.find({_id: 3}).itcount());
+assert.eq(2, target.getIndexes().length, tojson(target.getIndexes()));
+
+// The temp collection of the failed $out has been dropped.
+assert.eq([],
+          testDB.getCollectionNames().filter(name => name.startsWith("tmp.agg_out")),
+          testDB.getCollectionNames());
+
+rst.stopSet();
+})();
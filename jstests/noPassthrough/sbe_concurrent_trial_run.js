@@ -0,0 +1,83 @@
+/**
+ * Tests that the trial periods of candidate plans which the slot-based execution engine runs on
+ * pool threads fall back to the thread of the operation when a pool thread cannot get its locks,
+ * and stop when the operation is killed or times out.
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/fail_point_util.js");
+load("jstests/libs/parallel_shell_helpers.js");
+
+const conn = MongoRunner.runMongod({
+    setParameter: {
+        internalQueryEnableSlotBasedExecutionEngine: true,
+        internalQuerySlotBasedExecutionMaxTrialRunThreads: 2,
+    }
+});
+assert.neq(null, conn, "mongod was unable to start up");
+
+const db = conn.getDB("test");
+const coll = db.sbe_concurrent_trial_run;
+coll.drop();
+
+const docs = [];
+for (let i = 0; i < 1000; ++i) {
+    docs.push({_id: i, a: i % 10, b: i % 7, c: i % 3});
+}
+assert.commandWorked(coll.insert(docs));
+assert.commandWorked(coll.createIndex({a: 1}));
+assert.commandWorked(coll.createIndex({b: 1}));
+assert.commandWorked(coll.createIndex({c: 1}));
+
+const filter = {a: 1, b: 1, c: 1};
+const expected = coll.find(filter).sort({_id: 1}).toArray();
+assert.gt(expected.length, 0);
+
+// A pool thread which times out waiting for a lock does not fail the query.
+let failPoint = configureFailPoint(conn, "sbeTrialRunPoolThreadLockTimeout");
+assert.eq(expected, coll.find(filter).sort({_id: 1}).toArray());
+failPoint.off();
+assert.eq(expected, coll.find(filter).sort({_id: 1}).toArray());
+
+// A killed operation stops its pool threads and fails.
+const comment = "sbe_concurrent_trial_run_kill";
+failPoint = configureFailPoint(conn, "hangSBETrialRunPoolThreadBeforeRound");
+const awaitFind = startParallelShell(
+    funWithArgs(function(collName, filter, comment) {
+        assert.commandFailedWithCode(
+            db.runCommand({find: collName, filter: filter, comment: comment}),
+            ErrorCodes.Interrupted);
+    }, coll.getName(), filter, comment), conn.port);
+failPoint.wait();
+
+let opId;
+assert.soon(() => {
+    const ops = db.getSiblingDB("admin")
+                    .aggregate([{$currentOp: {}}, {$match: {"command.comment": comment}}])
+                    .toArray();
+    if (ops.length !== 1) {
+        return false;
+    }
+    opId = ops[0].opid;
+    return true;
+});
+assert.commandWorked(db.killOp(opId));
+failPoint.off();
+awaitFind();
+
+// An operation which runs out of time fails the same way.
+failPoint = configureFailPoint(conn, "hangSBETrialRunPoolThreadBeforeRound");
+const awaitTimedOutFind = startParallelShell(
+    funWithArgs(function(collName, filter) {
+        assert.commandFailedWithCode(
+            db.runCommand({find: collName, filter: filter, maxTimeMS: 1000}),
+            ErrorCodes.MaxTimeMSExpired);
+    }, coll.getName(), filter), conn.port);
+failPoint.wait();
+sleep(2000);
+failPoint.off();
+awaitTimedOutFind();
+
+MongoRunner.stopMongod(conn);
+}());
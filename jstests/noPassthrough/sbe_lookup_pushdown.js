@@ -0,0 +1,102 @@
+/**
+ * Tests that an equality $lookup which the slot-based execution engine runs as a join of the query
+ * plan returns the same results as the classic $lookup stage, with and without an index on the
+ * foreign field.
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+const testDB = conn.getDB("test");
+const local = testDB.local;
+const foreign = testDB.foreign;
+
+function setPushdown(enabled) {
+    assert.commandWorked(testDB.adminCommand({
+        setParameter: 1,
+        internalQueryEnableSlotBasedExecutionEngine: enabled,
+        internalQuerySlotBasedExecutionEnableLookupPushdown: enabled
+    }));
+}
+
+// The order of the joined documents is not specified, so compare them ordered by _id.
+function normalize(results) {
+    return results.map(doc => {
+        if (Array.isArray(doc.joined)) {
+            doc.joined.sort((a, b) => a._id - b._id);
+        }
+        return doc;
+    });
+}
+
+function runLookup(unwind) {
+    const pipeline = [
+        {$sort: {_id: 1}},
+        {$lookup: {from: foreign.getName(), localField: "a", foreignField: "b", as: "joined"}}
+    ];
+    if (unwind) {
+        pipeline.push({$unwind: "$joined"}, {$sort: {_id: 1, "joined._id": 1}});
+    }
+    return normalize(local.aggregate(pipeline).toArray());
+}
+
+function assertSameResults() {
+    for (let unwind of [false, true]) {
+        setPushdown(false);
+        const expected = runLookup(unwind);
+        setPushdown(true);
+        assert.eq(expected, runLookup(unwind), {unwind: unwind});
+    }
+}
+
+function runTests() {
+    local.drop();
+    assert.commandWorked(local.insert([
+        {_id: 0, a: 1},
+        {_id: 1, a: null},
+        {_id: 2},
+        {_id: 3, a: []},
+        {_id: 4, a: [1, 2]},
+        {_id: 5, a: [[1, 2]]},
+        {_id: 6, a: [null, 3]},
+        {_id: 7, a: "abc"},
+        {_id: 8, a: NumberLong(2)},
+        {_id: 9, a: {x: 1}},
+    ]));
+    assertSameResults();
+
+    // The pushed down join cannot compare a regex, so it fails the query instead of returning
+    // different results from the classic $lookup.
+    assert.commandWorked(local.insert({_id: 10, a: [/^a/, "abc"]}));
+    setPushdown(false);
+    assert.eq(11, runLookup(false).length);
+    setPushdown(true);
+    assert.throwsWithCode(() => runLookup(false), 4798623);
+    assert.commandWorked(local.remove({_id: 10}));
+
+    assert.commandWorked(foreign.insert({_id: 100, b: /^a/}));
+    setPushdown(true);
+    assert.throwsWithCode(() => runLookup(false), 4798623);
+    assert.commandWorked(foreign.remove({_id: 100}));
+}
+
+assert.commandWorked(foreign.insert([
+    {_id: 0, b: 1},
+    {_id: 1, b: null},
+    {_id: 2},
+    {_id: 3, b: [1, 2]},
+    {_id: 4, b: 2.0},
+    {_id: 5, b: "abc"},
+    {_id: 6, b: [null]},
+    {_id: 7, b: [[1, 2]]},
+    {_id: 8, b: 3},
+    {_id: 9, b: {x: 1}},
+]));
+runTests();
+
+assert.commandWorked(foreign.createIndex({b: 1}));
+runTests();
+
+MongoRunner.stopMongod(conn);
+}());
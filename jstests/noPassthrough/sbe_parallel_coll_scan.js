@@ -0,0 +1,104 @@
+/**
+ * Tests that a collection scan which the slot-based execution engine runs in parallel returns the
+ * same results as a serial scan, is not used for reads from a snapshot, and stops when its
+ * operation is killed or times out.
+ *
+ * @tags: [requires_replication, requires_snapshot_read]
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/fail_point_util.js");
+load("jstests/libs/parallel_shell_helpers.js");
+
+const rst = new ReplSetTest({nodes: 1});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const db = primary.getDB("test");
+const coll = db.parallel_coll_scan;
+
+const docs = [];
+for (let i = 0; i < 10000; ++i) {
+    docs.push({_id: i, a: i % 100});
+}
+const insertTime =
+    assert.commandWorked(db.runCommand({insert: coll.getName(), documents: docs})).operationTime;
+
+function setDOP(dop) {
+    assert.commandWorked(db.adminCommand({
+        setParameter: 1,
+        internalQueryEnableSlotBasedExecutionEngine: true,
+        internalQueryDefaultDOP: dop
+    }));
+}
+
+function runFind(readConcern) {
+    const cmd = {find: coll.getName(), filter: {a: {$gte: 50}}, batchSize: 100000};
+    if (readConcern) {
+        cmd.readConcern = readConcern;
+    }
+    const res = assert.commandWorked(db.runCommand(cmd));
+    return res.cursor.firstBatch.sort((x, y) => x._id - y._id);
+}
+
+// The parallel scan returns the same documents as the serial one, though possibly in another
+// order.
+setDOP(1);
+const expected = runFind();
+assert.eq(5000, expected.length);
+setDOP(4);
+assert.eq(expected, runFind());
+
+// A read from a snapshot sees none of the writes made after it, as with a serial scan.
+assert.commandWorked(coll.insert({_id: 10000, a: 99}));
+const snapshot = {level: "snapshot", atClusterTime: insertTime};
+setDOP(1);
+assert.eq(expected, runFind(snapshot));
+setDOP(4);
+assert.eq(expected, runFind(snapshot));
+assert.eq(5001, runFind().length);
+
+// A killed operation fails, rather than returning the results which its producers had found.
+const comment = "parallel_coll_scan_kill";
+let hangProducers = configureFailPoint(primary, "hangExchangeProducerBeforeGetNext");
+const awaitFind = startParallelShell(
+    funWithArgs(function(collName, comment) {
+        assert.commandFailedWithCode(
+            db.runCommand(
+                {find: collName, filter: {a: {$gte: 50}}, batchSize: 100000, comment: comment}),
+            ErrorCodes.Interrupted);
+    }, coll.getName(), comment), primary.port);
+hangProducers.wait();
+
+let opId;
+assert.soon(() => {
+    const ops = db.getSiblingDB("admin")
+                    .aggregate([{$currentOp: {}}, {$match: {"command.comment": comment}}])
+                    .toArray();
+    if (ops.length !== 1) {
+        return false;
+    }
+    opId = ops[0].opid;
+    return true;
+});
+assert.commandWorked(db.killOp(opId));
+hangProducers.off();
+awaitFind();
+
+// An operation which runs out of time fails the same way.
+hangProducers = configureFailPoint(primary, "hangExchangeProducerBeforeGetNext");
+const awaitTimedOutFind = startParallelShell(
+    funWithArgs(function(collName) {
+        assert.commandFailedWithCode(
+            db.runCommand({find: collName, filter: {a: {$gte: 50}}, maxTimeMS: 1000}),
+            ErrorCodes.MaxTimeMSExpired);
+    }, coll.getName()), primary.port);
+hangProducers.wait();
+sleep(2000);
+hangProducers.off();
+awaitTimedOutFind();
+
+rst.stopSet();
+}());
@@ -0,0 +1,92 @@
+/**
+ * Tests that change streams which share one oplog scan each see exactly their own events, including
+ * after resuming and after the stream is invalidated.
+ * @tags: [requires_replication, requires_journaling, uses_change_streams]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({
+    nodes: 1,
+    nodeOptions: {
+        setParameter: {
+            internalChangeStreamUseSharedOplogReader: true,
+            internalChangeStreamSharedOplogReaderBatchSize: 3,
+        }
+    }
+});
+rst.startSet();
+rst.initiate();
+
+const testDB = rst.getPrimary().getDB(jsTestName());
+const collA = testDB.a;
+const collB = testDB.b;
+assert.commandWorked(collA.insert({_id: -1}));
+assert.commandWorked(collB.insert({_id: -1}));
+
+function assertNextInsert(changeStream, id) {
+    assert.soon(() => changeStream.hasNext());
+    const event = changeStream.next();
+    assert.eq(event.operationType, "insert", event);
+    assert.eq(event.documentKey._id, id, event);
+    return event;
+}
+
+function runTest() {
+    // Several streams on both collections and on the whole database read the oplog at once.
+    const streamsA = [collA.watch(), collA.watch()];
+    const streamB = collB.watch();
+    const dbStream = testDB.watch();
+
+    for (let i = 0; i < 10; ++i) {
+        assert.commandWorked(collA.insert({_id: i}));
+        assert.commandWorked(collB.insert({_id: i}));
+    }
+
+    const resumeTokens = [];
+    for (let i = 0; i < 10; ++i) {
+        for (let stream of streamsA) {
+            assert.eq(assertNextInsert(stream, i).ns.coll, "a");
+        }
+        resumeTokens.push(streamsA[0].getResumeToken());
+        assert.eq(assertNextInsert(streamB, i).ns.coll, "b");
+        assert.eq(assertNextInsert(dbStream, i).ns.coll, "a");
+        assert.eq(assertNextInsert(dbStream, i).ns.coll, "b");
+    }
+
+    // A stream resumed after an event starts behind the streams which are still open.
+    const resumed = collA.watch([], {resumeAfter: resumeTokens[4]});
+    for (let i = 5; i < 10; ++i) {
+        assertNextInsert(resumed, i);
+    }
+
+    // Dropping a collection invalidates only the streams on it.
+    assert(collA.drop());
+    for (let stream of streamsA.concat([resumed])) {
+        assert.soon(() => stream.hasNext());
+        assert.eq(stream.next().operationType, "drop");
+        assert.soon(() => stream.hasNext());
+        assert.eq(stream.next().operationType, "invalidate");
+        stream.close();
+    }
+    assert.soon(() => dbStream.hasNext());
+    assert.eq(dbStream.next().operationType, "drop");
+
+    assert.commandWorked(collB.insert({_id: 10}));
+    assertNextInsert(streamB, 10);
+    assertNextInsert(dbStream, 10);
+
+    streamB.close();
+    dbStream.close();
+    assert(collB.drop());
+}
+
+runTest();
+
+// Streams which fall too far behind leave the shared scan and must still see every event.
+assert.commandWorked(testDB.adminCommand(
+    {setParameter: 1, internalChangeStreamSharedOplogReaderMaxBufferedBytes: 1}));
+runTest();
+
+rst.stopSet();
+})();
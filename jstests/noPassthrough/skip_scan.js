@@ -0,0 +1,56 @@
+/**
+ * Tests that the planner only considers skip-scan plans when internalQueryPlannerEnableSkipScan is
+ * set, that explain reports such a plan as an index scan with unbounded leading fields, and that a
+ * skip scan does not let a query run with 'notablescan'.
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/analyze_plan.js");
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+
+const db = conn.getDB("test");
+const coll = db.skip_scan;
+coll.drop();
+
+const docs = [];
+for (let i = 0; i < 1000; ++i) {
+    docs.push({_id: i, a: i % 2, b: i});
+}
+assert.commandWorked(coll.insert(docs));
+assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+function setSkipScan(enabled) {
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryPlannerEnableSkipScan: enabled}));
+}
+
+// Skip scans are off by default, so the query has to scan the collection.
+let explain = coll.find({b: 5}).explain();
+assert(isCollscan(db, explain.queryPlanner.winningPlan), tojson(explain));
+assert.eq([{_id: 5, a: 1, b: 5}], coll.find({b: 5}).toArray());
+
+// A skip scan seeks past each of the two values of 'a', so it wins over the collection scan.
+setSkipScan(true);
+explain = coll.find({b: 5}).explain();
+const ixscan = getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN");
+assert.neq(null, ixscan, tojson(explain));
+assert.eq({a: 1, b: 1}, ixscan.keyPattern, tojson(ixscan));
+assert.eq({a: ["[MinKey, MaxKey]"], b: ["[5.0, 5.0]"]}, ixscan.indexBounds, tojson(ixscan));
+assert.eq(1, getRejectedPlans(explain).length, tojson(explain));
+assert.eq([{_id: 5, a: 1, b: 5}], coll.find({b: 5}).toArray());
+
+// A skip scan may read the whole index, so it is not allowed with 'notablescan' either.
+assert.commandWorked(db.adminCommand({setParameter: 1, notablescan: true}));
+assert.commandFailedWithCode(db.runCommand({find: coll.getName(), filter: {b: 5}}),
+                             ErrorCodes.NoQueryExecutionPlans);
+assert.commandFailedWithCode(
+    db.runCommand({explain: {find: coll.getName(), filter: {b: 5}}}),
+    ErrorCodes.NoQueryExecutionPlans);
+assert.eq([{_id: 5, a: 1, b: 5}], coll.find({a: 1, b: 5}).toArray());
+assert.commandWorked(db.adminCommand({setParameter: 1, notablescan: false}));
+
+MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,44 @@
+// Test that the TTL monitor stops deleting from an index after ttlIndexDeleteTargetDocs documents,
+// and keeps making sub-passes until it has removed all expired documents.
+(function() {
+"use strict";
+
+const kNumDocs = 100;
+const kTargetDocs = 10;
+
+const conn = MongoRunner.runMongod({
+    setParameter: {
+        ttlMonitorSleepSecs: 1,
+        ttlIndexDeleteTargetDocs: kTargetDocs,
+        ttlMonitorSubPassSleepMillis: 0,
+    }
+});
+const db = conn.getDB("test");
+const coll = db.ttl_index_delete_target_docs;
+
+const now = new Date();
+const docs = [];
+for (let i = 0; i < kNumDocs; ++i) {
+    docs.push({_id: i, x: now});
+}
+assert.commandWorked(coll.insert(docs));
+
+const ttlMetrics = () => db.serverStatus().metrics.ttl;
+const initialMetrics = ttlMetrics();
+
+// Only create the index once all of the documents exist, so that the first pass over it sees every
+// one of them.
+assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 0}));
+
+assert.soon(() => coll.find().itcount() === 0, "TTL monitor did not delete the expired documents");
+
+// Every sub-pass which continues an earlier one is counted in 'subPasses' but not in 'passes'.
+// Removing all of the documents takes at least kNumDocs / kTargetDocs sub-passes of the same pass.
+const metrics = ttlMetrics();
+assert.gte(metrics.deletedDocuments - initialMetrics.deletedDocuments, kNumDocs, metrics);
+const continuedSubPasses = (metrics.subPasses - metrics.passes) -
+    (initialMetrics.subPasses - initialMetrics.passes);
+assert.gte(continuedSubPasses, kNumDocs / kTargetDocs - 1, metrics);
+
+MongoRunner.stopMongod(conn);
+})();
@@ -17,6 +17,17 @@ testNumericServerParameter('maxValidateMBperSec',
                            false /*hasUpperBound*/,
                            "unused" /*upperOutOfBounds*/);
 
+// Valid parameter values are in the range [0, infinity).
+testNumericServerParameter('maxValidateIndexTraversalThreads',
+                           true /*isStartupParameter*/,
+                           true /*isRuntimeParameter*/,
+                           4 /*defaultValue*/,
+                           1 /*nonDefaultValidValue*/,
+                           true /*hasLowerBound*/,
+                           -1 /*lowerOutOfBounds*/,
+                           false /*hasUpperBound*/,
+                           "unused" /*upperOutOfBounds*/);
+
 // Valid parameter values are in the range (0, infinity).
 testNumericServerParameter('maxValidateMemoryUsageMB',
                            true /*isStartupParameter*/,
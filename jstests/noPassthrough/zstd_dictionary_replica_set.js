@@ -0,0 +1,63 @@
+/**
+ * Tests that a replica set member refuses to create a collection or an index which uses a zstd
+ * dictionary block compressor, since the dictionary is local to the node which trained it and the
+ * other members could not apply the create.
+ *
+ * @tags: [requires_replication, requires_wiredtiger]
+ */
+(function() {
+"use strict";
+
+const compressorConfig = {wiredTiger: {configString: "block_compressor=zstd_dict_sample"}};
+
+function trainDictionary(db) {
+    const docs = [];
+    for (let i = 0; i < 1000; ++i) {
+        docs.push({_id: i, name: "user" + i, city: "city" + (i % 10), active: i % 2 === 0});
+    }
+    assert.commandWorked(db.sample.insert(docs));
+    assert.commandWorked(db.runCommand({trainZstdDictionary: "sample", name: "sample"}));
+}
+
+// A standalone may create collections which use its dictionaries.
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+const standaloneDB = conn.getDB("test");
+trainDictionary(standaloneDB);
+assert.commandWorked(standaloneDB.createCollection("compressed", {storageEngine: compressorConfig}));
+assert.commandWorked(standaloneDB.compressed.insert({a: 1}));
+MongoRunner.stopMongod(conn);
+
+const rst = new ReplSetTest({nodes: 2});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const primaryDB = primary.getDB("test");
+trainDictionary(primaryDB);
+
+// The secondaries do not have the dictionary, so the primary refuses the create rather than
+// replicate an operation they would fail to apply.
+assert.commandFailedWithCode(
+    primaryDB.createCollection("compressed", {storageEngine: compressorConfig}),
+    ErrorCodes.InvalidOptions);
+assert.commandFailedWithCode(primaryDB.runCommand({
+    createIndexes: "sample",
+    indexes: [{key: {name: 1}, name: "name_1", storageEngine: compressorConfig}]
+}),
+                             ErrorCodes.InvalidOptions);
+
+// Nothing was replicated, and the set keeps replicating other writes.
+assert.commandWorked(primaryDB.runCommand(
+    {insert: "sample", documents: [{_id: "after"}], writeConcern: {w: 2}}));
+rst.awaitReplication();
+const secondaryDB = rst.getSecondary().getDB("test");
+assert.eq(null, secondaryDB.getCollectionInfos({name: "compressed"})[0]);
+
+// Unreplicated collections may still use the dictionary.
+const localDB = primary.getDB("local");
+assert.commandWorked(localDB.createCollection("compressed", {storageEngine: compressorConfig}));
+assert.commandWorked(localDB.compressed.insert({a: 1}));
+
+rst.stopSet();
+}());
@@ -103,6 +103,7 @@ const allCommands = {
         expectedErrorCode: ErrorCodes.NotMasterOrSecondary,
     },
     cpuload: {skip: isNotAUserDataRead},
+    cpuProfile: {skip: isNotAUserDataRead},
     create: {skip: isPrimaryOnly},
     createIndexes: {skip: isPrimaryOnly},
     createRole: {skip: isPrimaryOnly},
@@ -519,6 +519,7 @@ const testCases = {
     coordinateCommitTransaction: {skip: isNotRunOnUserDatabase},
     count: {skip: isNotWriteCommand},
     cpuload: {skip: isNotRunOnUserDatabase},
+    cpuProfile: {skip: isNotRunOnUserDatabase},
     create: {
         command: function(dbName, collName) {
             return {create: collName};
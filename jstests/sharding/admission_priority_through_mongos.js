@@ -0,0 +1,51 @@
+/**
+ * Tests that mongos only accepts a raised admissionPriority from users authorized for internal
+ * actions, so that routing a request through mongos cannot be used to raise its priority on the
+ * shards.
+ */
+
+(function() {
+"use strict";
+
+// Multiple users cannot be authenticated on one connection within a session.
+TestData.disableImplicitSessions = true;
+
+let st = new ShardingTest({mongos: 1, config: 1, shards: 1, keyFile: 'jstests/libs/key1'});
+
+let adminDB = st.s.getDB('admin');
+
+assert.commandWorked(adminDB.runCommand({createUser: "admin", pwd: "admin", roles: ["root"]}));
+assert.eq(1, adminDB.auth("admin", "admin"));
+
+assert.commandWorked(adminDB.runCommand({
+    createRole: "internalRole",
+    privileges: [{resource: {cluster: true}, actions: ["internal"]}],
+    roles: []
+}));
+
+let testDB = adminDB.getSiblingDB("testDB");
+assert.commandWorked(
+    testDB.runCommand({createUser: 'NotTrusted', pwd: 'pwd', roles: ['readWrite']}));
+assert.commandWorked(testDB.runCommand(
+    {createUser: 'Trusted', pwd: 'pwd', roles: [{role: 'internalRole', db: 'admin'}, 'readWrite']}));
+adminDB.logout();
+
+assert.eq(1, testDB.auth("NotTrusted", "pwd"));
+assert.commandWorked(testDB.runCommand({insert: "foo", documents: [{_id: 0}]}));
+assert.commandWorked(testDB.runCommand({find: "foo", admissionPriority: "low"}));
+assert.commandWorked(testDB.runCommand({find: "foo", admissionPriority: "normal"}));
+assert.commandFailedWithCode(testDB.runCommand({find: "foo", admissionPriority: "high"}),
+                             ErrorCodes.Unauthorized);
+assert.commandFailedWithCode(
+    testDB.runCommand({insert: "foo", documents: [{_id: 1}], admissionPriority: "high"}),
+    ErrorCodes.Unauthorized);
+assert.commandFailedWithCode(testDB.runCommand({find: "foo", admissionPriority: "urgent"}),
+                             ErrorCodes.BadValue);
+testDB.logout();
+
+assert.eq(1, testDB.auth("Trusted", "pwd"));
+assert.commandWorked(testDB.runCommand({find: "foo", admissionPriority: "high"}));
+testDB.logout();
+
+st.stop();
+})();
@@ -240,6 +240,7 @@ let testCases = {
         checkWriteConcern: false,
     },
     cpuload: {skip: "does not accept read or write concern"},
+    cpuProfile: {skip: "does not accept read or write concern"},
     create: {
         command: {create: coll},
         checkReadConcern: false,
@@ -125,6 +125,7 @@ let testCases = {
         behavior: "versioned"
     },
     cpuload: {skip: "does not return user data"},
+    cpuProfile: {skip: "does not return user data"},
     create: {skip: "primary only"},
     createIndexes: {skip: "primary only"},
     createRole: {skip: "primary only"},
@@ -31,6 +31,7 @@
 
 #include <benchmark/benchmark.h>
 
+#include "mongo/bson/bson_validate.h"
 #include "mongo/bson/bsonobjbuilder.h"
 
 namespace mongo {
@@ -63,7 +64,57 @@ void BM_arrayLookup(benchmark::State& state) {
     state.SetItemsProcessed(totalLen);
 }
 
+BSONObj buildSampleObj(long long i) {
+    BSONObjBuilder builder;
+    builder.append("_id", OID::gen());
+    builder.append("counter", i);
+    builder.append("name", "sample document");
+    builder.append("created", Date_t::now());
+    builder.append("ratio", 0.5);
+    builder.append("flag", true);
+    {
+        BSONObjBuilder subBuilder(builder.subobjStart("address"));
+        subBuilder.append("street", "123 Main St");
+        subBuilder.append("city", "New York");
+        subBuilder.append("zip", 10001);
+    }
+    {
+        BSONArrayBuilder tags(builder.subarrayStart("tags"));
+        for (int j = 0; j < 4; ++j) {
+            tags.append("tag" + std::to_string(j));
+        }
+    }
+    return builder.obj();
+}
+
+void BM_validate(benchmark::State& state) {
+    BSONArrayBuilder builder;
+    auto len = state.range(0);
+    size_t totalSize = 0;
+    for (auto j = 0; j < len; j++)
+        builder.append(buildSampleObj(j));
+    BSONObj array = builder.done();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(array.objdata(), array.objsize()));
+        totalSize += array.objsize();
+    }
+    state.SetBytesProcessed(totalSize);
+}
+
+void BM_validateSmallObj(benchmark::State& state) {
+    BSONObj obj = buildSampleObj(0);
+    size_t totalSize = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize()));
+        totalSize += obj.objsize();
+    }
+    state.SetBytesProcessed(totalSize);
+}
+
 BENCHMARK(BM_arrayBuilder)->Ranges({{{1}, {100'000}}});
 BENCHMARK(BM_arrayLookup)->Ranges({{{1}, {100'000}}});
+BENCHMARK(BM_validate)->Ranges({{{1}, {1'000}}});
+BENCHMARK(BM_validateSmallObj);
 
 }  // namespace mongo
@@ -27,9 +27,9 @@
  *    it in the license file.
  */
 
+#include <boost/container/small_vector.hpp>
 #include <cstring>
 #include <limits>
-#include <vector>
 
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
@@ -303,9 +303,12 @@ Status validateElementInfo(Buffer* buffer,
     }
 }
 
+// Documents are rarely nested deeper than this, so their frames fit in inline storage and
+// validation does not allocate.
+constexpr size_t kFewNestedFrames = 16;
+
 Status validateBSONIterative(Buffer* buffer) {
-    std::vector<ValidationObjectFrame> frames;
-    frames.reserve(16);
+    boost::container::small_vector<ValidationObjectFrame, kFewNestedFrames> frames;
     ValidationObjectFrame* curr = nullptr;
     ValidationState::State state = ValidationState::BeginObj;
 
@@ -1307,10 +1307,7 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
                     }
                     unsigned char first = uassertStatusOK(fromHex(q));
                     unsigned char second = uassertStatusOK(fromHex(q += 2));
-                    const std::string& utf8str = encodeUTF8(first, second);
-                    for (unsigned int i = 0; i < utf8str.size(); i++) {
-                        result->push_back(utf8str[i]);
-                    }
+                    result->append(encodeUTF8(first, second));
                     ++q;
                     break;
                 }
@@ -1339,7 +1336,15 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
             }
             ++q;
         } else {
-            result->push_back(*q++);
+            // Copy the run of characters that need no unescaping or checks beyond the ones above
+            // in one go, rather than appending them to 'result' one at a time.
+            const char* runStart = q;
+            do {
+                ++q;
+            } while (q < _input_end && !match(*q, terminalSet) &&
+                     (allowedSet == nullptr || match(*q, allowedSet)) && *q != '\\' &&
+                     !(0x00 <= *q && *q <= 0x1F));
+            result->append(runStart, q);
         }
     }
     if (q < _input_end) {
@@ -1350,18 +1355,18 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
 }
 
 std::string JParse::encodeUTF8(unsigned char first, unsigned char second) const {
-    std::ostringstream oss;
+    std::string utf8;
     if (first == 0 && second < 0x80) {
-        oss << second;
+        utf8.push_back(second);
     } else if (first < 0x08) {
-        oss << char(0xc0 | (first << 2 | second >> 6));
-        oss << char(0x80 | (~0xc0 & second));
+        utf8.push_back(char(0xc0 | (first << 2 | second >> 6)));
+        utf8.push_back(char(0x80 | (~0xc0 & second)));
     } else {
-        oss << char(0xe0 | (first >> 4));
-        oss << char(0x80 | (~0xc0 & (first << 2 | second >> 6)));
-        oss << char(0x80 | (~0xc0 & second));
+        utf8.push_back(char(0xe0 | (first >> 4)));
+        utf8.push_back(char(0x80 | (~0xc0 & (first << 2 | second >> 6))));
+        utf8.push_back(char(0x80 | (~0xc0 & second)));
     }
-    return oss.str();
+    return utf8;
 }
 
 inline bool JParse::peekToken(const char* token) {
@@ -243,7 +243,7 @@ Future<void> AsyncDBClient::initWireVersion(const std::string& appName,
         });
 }
 
-Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHandle& baton) {
+StatusWith<Message> AsyncDBClient::_prepareRequestMessage(Message request, int32_t msgId) {
     auto swm = _compressorManager.compressMessage(request);
     if (!swm.isOK()) {
         return swm.getStatus();
@@ -260,7 +260,16 @@ Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHan
     OpMsg::appendChecksum(&request);
 #endif
 
-    return _session->asyncSinkMessage(request, baton);
+    return std::move(request);
+}
+
+Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHandle& baton) {
+    auto swm = _prepareRequestMessage(std::move(request), msgId);
+    if (!swm.isOK()) {
+        return swm.getStatus();
+    }
+
+    return _session->asyncSinkMessage(std::move(swm.getValue()), baton);
 }
 
 Future<Message> AsyncDBClient::_waitForResponse(boost::optional<int32_t> msgId,
@@ -323,6 +332,85 @@ Future<executor::RemoteCommandResponse> AsyncDBClient::runCommandRequest(
         });
 }
 
+std::vector<Future<executor::RemoteCommandResponse>> AsyncDBClient::runPipelinedCommandRequests(
+    std::vector<executor::RemoteCommandRequest> requests, const BatonHandle& baton) {
+    invariant(_negotiatedProtocol);
+
+    struct PipelineState {
+        std::vector<int32_t> msgIds;
+        std::vector<Promise<executor::RemoteCommandResponse>> promises;
+        size_t next = 0;
+    };
+    auto state = std::make_shared<PipelineState>();
+
+    std::vector<Future<executor::RemoteCommandResponse>> futures;
+    std::vector<Message> messages;
+    Status prepareStatus = Status::OK();
+    for (auto& request : requests) {
+        invariant(request.fireAndForgetMode ==
+                  executor::RemoteCommandRequest::FireAndForgetMode::kOff);
+
+        auto [promise, future] = makePromiseFuture<executor::RemoteCommandResponse>();
+        state->promises.push_back(std::move(promise));
+        futures.push_back(std::move(future));
+
+        auto opMsgRequest = OpMsgRequest::fromDBAndBody(
+            std::move(request.dbname), std::move(request.cmdObj), std::move(request.metadata));
+        auto msgId = nextMessageId();
+        auto swm = _prepareRequestMessage(
+            rpc::messageFromOpMsgRequest(*_negotiatedProtocol, std::move(opMsgRequest)), msgId);
+        if (!swm.isOK()) {
+            prepareStatus = swm.getStatus();
+            continue;
+        }
+        state->msgIds.push_back(msgId);
+        messages.push_back(std::move(swm.getValue()));
+    }
+
+    auto failRemaining = [state](Status status) {
+        for (; state->next < state->promises.size(); ++state->next) {
+            state->promises[state->next].setError(status);
+        }
+    };
+
+    if (!prepareStatus.isOK()) {
+        failRemaining(std::move(prepareStatus));
+        return futures;
+    }
+
+    auto clkSource = _svcCtx->getPreciseClockSource();
+    auto start = clkSource->now();
+
+    // Each reply is matched to the request at the front of the pipeline, so they have to be read
+    // one at a time, in the order the requests were sent.
+    auto receiveAll = [this, state, baton, clkSource, start]() {
+        auto receiveNext = [this, state, baton, clkSource, start](auto& self) -> Future<void> {
+            if (state->next == state->promises.size()) {
+                return Status::OK();
+            }
+
+            return _waitForResponse(state->msgIds[state->next], baton)
+                .then([this, state, baton, clkSource, start, self](Message responseMsg) mutable {
+                    auto response = rpc::UniqueReply(responseMsg, rpc::makeReply(&responseMsg));
+                    auto duration = duration_cast<Milliseconds>(clkSource->now() - start);
+                    state->promises[state->next++].emplaceValue(*response, duration);
+                    return self(self);
+                });
+        };
+        return receiveNext(receiveNext);
+    };
+
+    _session->asyncSinkMessages(std::move(messages), baton)
+        .then(std::move(receiveAll))
+        .getAsync([failRemaining = std::move(failRemaining)](Status status) {
+            if (!status.isOK()) {
+                failRemaining(std::move(status));
+            }
+        });
+
+    return futures;
+}
+
 Future<executor::RemoteCommandResponse> AsyncDBClient::_continueReceiveExhaustResponse(
     ClockSource::StopWatch stopwatch, boost::optional<int32_t> msgId, const BatonHandle& baton) {
     return _waitForResponse(msgId, baton)
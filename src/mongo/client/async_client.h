@@ -62,6 +62,14 @@ public:
 
     Future<executor::RemoteCommandResponse> runCommandRequest(
         executor::RemoteCommandRequest request, const BatonHandle& baton = nullptr);
+    /**
+     * Sends all of the requests with a single write and reads their replies in order. The returned
+     * futures correspond to the requests and become ready as each reply arrives. A failure to read
+     * one reply fails it and all of the requests behind it, since the connection can no longer be
+     * used. Fire-and-forget requests are not supported.
+     */
+    std::vector<Future<executor::RemoteCommandResponse>> runPipelinedCommandRequests(
+        std::vector<executor::RemoteCommandRequest> requests, const BatonHandle& baton = nullptr);
     Future<rpc::UniqueReply> runCommand(OpMsgRequest request,
                                         const BatonHandle& baton = nullptr,
                                         bool fireAndForget = false);
@@ -100,6 +108,7 @@ private:
         const BatonHandle& baton = nullptr);
     Future<Message> _waitForResponse(boost::optional<int32_t> msgId,
                                      const BatonHandle& baton = nullptr);
+    StatusWith<Message> _prepareRequestMessage(Message request, int32_t msgId);
     Future<void> _call(Message request, int32_t msgId, const BatonHandle& baton = nullptr);
     BSONObj _buildIsMasterRequest(const std::string& appName,
                                   executor::NetworkConnectionHook* hook);
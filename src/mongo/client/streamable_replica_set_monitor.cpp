@@ -40,10 +40,12 @@
 #include "mongo/client/connpool.h"
 #include "mongo/client/global_conn_pool.h"
 #include "mongo/client/read_preference.h"
+#include "mongo/client/replica_set_monitor_server_parameters_gen.h"
 #include "mongo/client/streamable_replica_set_monitor_query_processor.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/bson_extract_optime.h"
 #include "mongo/db/server_options.h"
+#include "mongo/executor/host_latency_tracker.h"
 #include "mongo/executor/thread_pool_task_executor.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/atomic_word.h"
@@ -239,6 +241,10 @@ SemiFuture<HostAndPort> StreamableReplicaSetMonitor::getHostOrRefresh(
         .thenRunOn(_executor)
         .then([self = shared_from_this()](const std::vector<HostAndPort>& result) {
             invariant(result.size());
+            // The hosts are already ordered by expected latency.
+            if (gReplicaSetMonitorLatencyAwareHostSelection.load()) {
+                return result.front();
+            }
             return result[self->_random.nextInt64(result.size())];
         })
         .semi();
@@ -365,7 +371,14 @@ boost::optional<std::vector<HostAndPort>> StreamableReplicaSetMonitor::_getHosts
     auto result = _serverSelector->selectServers(topology, criteria);
     if (!result)
         return boost::none;
-    return _extractHosts(*result);
+    auto hosts = _extractHosts(*result);
+    if (gReplicaSetMonitorLatencyAwareHostSelection.load()) {
+        // The latency window does not account for the commands this process already has
+        // outstanding against each host. Put the host expected to answer soonest first, so that it
+        // is both the one chosen by getHostOrRefresh() and the first target of a hedged read.
+        executor::HostLatencyTracker::get()->orderByExpectedLatency(&hosts, _executor->now());
+    }
+    return hosts;
 }
 
 boost::optional<std::vector<HostAndPort>> StreamableReplicaSetMonitor::_getHosts(
@@ -323,6 +323,7 @@ auto authorizationManagerCreateRegistration =
 }  // namespace
 
 int authorizationManagerCacheSize;
+int authorizationManagerCacheMaxStalenessMillis;
 
 void AuthorizationManagerPinnedUsersServerParameter::append(OperationContext* opCtx,
                                                             BSONObjBuilder& out,
@@ -355,6 +356,7 @@ AuthorizationManagerImpl::AuthorizationManagerImpl(
 
           return options;
       }()) {
+    _userCache.setMaxStaleness(Milliseconds(authorizationManagerCacheMaxStalenessMillis));
     _threadPool.startup();
 }
 
@@ -205,5 +205,6 @@ private:
 };
 
 extern int authorizationManagerCacheSize;
+extern int authorizationManagerCacheMaxStalenessMillis;
 
 }  // namespace mongo
@@ -57,7 +57,7 @@ void AuthorizationSessionForTest::assumePrivilegesForDB(PrivilegeVector privileg
 
     _authenticatedUsers.add(userHandle);
     _testUsers.emplace_back(std::move(userHandle));
-    _buildAuthenticatedRolesVector();
+    _updateInternalAuthorizationState();
 }
 
 void AuthorizationSessionForTest::revokePrivilegesForDB(StringData dbName) {
@@ -67,6 +67,7 @@ void AuthorizationSessionForTest::revokePrivilegesForDB(StringData dbName) {
                        _testUsers.end(),
                        [&](const auto& user) { return dbName == user->getName().getDB(); }),
         _testUsers.end());
+    _updateInternalAuthorizationState();
 }
 
 void AuthorizationSessionForTest::revokeAllPrivileges() {
@@ -77,5 +78,6 @@ void AuthorizationSessionForTest::revokeAllPrivileges() {
                                         return true;
                                     }),
                      _testUsers.end());
+    _updateInternalAuthorizationState();
 }
 }  // namespace mongo
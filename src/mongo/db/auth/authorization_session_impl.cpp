@@ -154,7 +154,7 @@ Status AuthorizationSessionImpl::addAndAuthorizeUser(OperationContext* opCtx,
     // If there are any users and roles in the impersonation data, clear it out.
     clearImpersonatedUserData();
 
-    _buildAuthenticatedRolesVector();
+    _updateInternalAuthorizationState();
     return Status::OK();
 }
 
@@ -183,7 +183,7 @@ void AuthorizationSessionImpl::logoutDatabase(OperationContext* opCtx, StringDat
     stdx::lock_guard<Client> lk(*opCtx->getClient());
     _authenticatedUsers.removeByDBName(dbname);
     clearImpersonatedUserData();
-    _buildAuthenticatedRolesVector();
+    _updateInternalAuthorizationState();
 }
 
 UserNameIterator AuthorizationSessionImpl::getAuthenticatedUserNames() {
@@ -197,7 +197,7 @@ RoleNameIterator AuthorizationSessionImpl::getAuthenticatedRoleNames() {
 void AuthorizationSessionImpl::grantInternalAuthorization(Client* client) {
     stdx::lock_guard<Client> lk(*client);
     _authenticatedUsers.add(internalSecurity.user);
-    _buildAuthenticatedRolesVector();
+    _updateInternalAuthorizationState();
 }
 
 /**
@@ -610,6 +610,10 @@ bool AuthorizationSessionImpl::isAuthorizedForActionsOnNamespace(const Namespace
 }
 
 static const int resourceSearchListCapacity = 5;
+
+// Bounds the memory used for caching the authorization decisions of a single connection, which may
+// touch an arbitrary number of namespaces.
+static const size_t kMaxAuthorizedActionsCacheEntries = 1024;
 /**
  * Builds from "target" an exhaustive list of all ResourcePatterns that match "target".
  *
@@ -733,11 +737,24 @@ bool AuthorizationSessionImpl::isAuthenticated() {
 
 void AuthorizationSessionImpl::_refreshUserInfoAsNeeded(OperationContext* opCtx) {
     AuthorizationManager& authMan = getAuthorizationManager();
+
+    // Any change to the user cache may have changed the privileges of the authenticated users, so
+    // the cached authorization decisions can no longer be trusted
+    const auto cacheGeneration = authMan.getCacheGeneration();
+    if (cacheGeneration != _authorizedActionsCacheGeneration) {
+        _authorizedActionsCache.clear();
+        _authorizedActionsCacheGeneration = cacheGeneration;
+    }
+
     UserSet::iterator it = _authenticatedUsers.begin();
 
     while (it != _authenticatedUsers.end()) {
         auto& user = *it;
         if (!user.isValid()) {
+            // Whatever the outcome of the refresh, the cached decisions were made using the
+            // privileges of the out-of-date user
+            _authorizedActionsCache.clear();
+
             // Make a good faith effort to acquire an up-to-date user object, since the one
             // we've cached is marked "out-of-date."
             UserName name = user->getName();
@@ -824,6 +841,11 @@ void AuthorizationSessionImpl::_refreshUserInfoAsNeeded(OperationContext* opCtx)
     _buildAuthenticatedRolesVector();
 }
 
+void AuthorizationSessionImpl::_updateInternalAuthorizationState() {
+    _authorizedActionsCache.clear();
+    _buildAuthenticatedRolesVector();
+}
+
 void AuthorizationSessionImpl::_buildAuthenticatedRolesVector() {
     _authenticatedRoleNames.clear();
     for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
@@ -905,6 +927,12 @@ bool AuthorizationSessionImpl::isAuthorizedForAnyActionOnResource(const Resource
 bool AuthorizationSessionImpl::_isAuthorizedForPrivilege(const Privilege& privilege) {
     const ResourcePattern& target(privilege.getResourcePattern());
 
+    const auto cachedIt = _authorizedActionsCache.find(target);
+    if (cachedIt != _authorizedActionsCache.end() &&
+        cachedIt->second.isSupersetOf(privilege.getActions())) {
+        return true;
+    }
+
     ResourcePattern resourceSearchList[resourceSearchListCapacity];
     const int resourceSearchListLength = buildResourceSearchList(target, resourceSearchList);
 
@@ -931,6 +959,14 @@ bool AuthorizationSessionImpl::_isAuthorizedForPrivilege(const Privilege& privil
             unmetRequirements.removeAllActionsFromSet(userActions);
 
             if (unmetRequirements.empty()) {
+                // The default privileges depend on the state of the server rather than on the
+                // authenticated users, so only cache the decisions which did not rely on them
+                if (defaultPrivileges.empty()) {
+                    if (_authorizedActionsCache.size() >= kMaxAuthorizedActionsCacheEntries) {
+                        _authorizedActionsCache.clear();
+                    }
+                    _authorizedActionsCache[target].addAllActionsFromSet(privilege.getActions());
+                }
                 return true;
             }
         }
@@ -43,6 +43,7 @@
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/pipeline/aggregation_request.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -197,6 +198,10 @@ protected:
     // logged in or logged out, as well as when the user cache is determined to be out of date.
     void _buildAuthenticatedRolesVector();
 
+    // Clears the cached authorization decisions and rebuilds the vector of authenticated roles.
+    // Must be called whenever the set of users authenticated on this connection is changed.
+    void _updateInternalAuthorizationState();
+
     // All Users who have been authenticated on this connection.
     UserSet _authenticatedUsers;
 
@@ -221,6 +226,13 @@ private:
 
     std::unique_ptr<AuthzSessionExternalState> _externalState;
 
+    // The actions on each resource, which the authenticated users have already been found to be
+    // authorized for. Only decisions which were made from the privileges of the authenticated
+    // users alone are cached, so the cache stays valid for as long as the set of authenticated
+    // users and the user cache generation they were acquired under remain the same.
+    stdx::unordered_map<ResourcePattern, ActionSet> _authorizedActionsCache;
+    OID _authorizedActionsCacheGeneration;
+
     // A vector of impersonated UserNames and a vector of those users' RoleNames.
     // These are used in the auditing system. They are not used for authz checks.
     std::vector<UserName> _impersonatedUserNames;
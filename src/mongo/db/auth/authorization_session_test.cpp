@@ -451,6 +451,37 @@ TEST_F(AuthorizationSessionTest, InvalidateUser) {
     ASSERT_FALSE(authzSession->lookupUser(UserName("spencer", "test")));
 }
 
+TEST_F(AuthorizationSessionTest, LogoutDiscardsCachedAuthorizationDecisions) {
+    ASSERT_OK(managerState->insertPrivilegeDocument(_opCtx.get(),
+                                                    BSON("user"
+                                                         << "spencer"
+                                                         << "db"
+                                                         << "test"
+                                                         << "credentials" << credentials << "roles"
+                                                         << BSON_ARRAY(BSON("role"
+                                                                            << "readWrite"
+                                                                            << "db"
+                                                                            << "test"))),
+                                                    BSONObj()));
+    ASSERT_OK(authzSession->addAndAuthorizeUser(_opCtx.get(), UserName("spencer", "test")));
+
+    // Repeated checks are answered from the cached decisions
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(
+            authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::find));
+        ASSERT_TRUE(authzSession->isAuthorizedForActionsOnResource(
+            testFooCollResource, ActionSet{ActionType::find, ActionType::insert}));
+    }
+    ASSERT_FALSE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::collMod));
+
+    authzSession->logoutDatabase(_opCtx.get(), "test");
+    ASSERT_FALSE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::find));
+    ASSERT_FALSE(authzSession->isAuthorizedForActionsOnResource(
+        testFooCollResource, ActionSet{ActionType::find, ActionType::insert}));
+}
+
 TEST_F(AuthorizationSessionTest, UseOldUserInfoInFaceOfConnectivityProblems) {
     // Add a readWrite user
     ASSERT_OK(managerState->insertPrivilegeDocument(_opCtx.get(),
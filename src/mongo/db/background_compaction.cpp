@@ -0,0 +1,309 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/background_compaction.h"
+
+#include "mongo/base/counter.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/background_compaction_gen.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/fsync_locked.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/background.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+
+namespace mongo {
+
+class BackgroundCompactor;
+
+namespace {
+
+const auto getBackgroundCompactor =
+    ServiceContext::declareDecoration<std::unique_ptr<BackgroundCompactor>>();
+
+// Upper bound on the steps spent on a single table in a pass, so that a table which keeps getting
+// fragmented by writes does not keep the other tables from being compacted.
+const int kMaxStepsPerTable = 100;
+
+Counter64 backgroundCompactionPasses;
+Counter64 backgroundCompactionSteps;
+Counter64 backgroundCompactionCollections;
+
+ServerStatusMetricField<Counter64> backgroundCompactionPassesDisplay(
+    "backgroundCompaction.passes", &backgroundCompactionPasses);
+ServerStatusMetricField<Counter64> backgroundCompactionStepsDisplay(
+    "backgroundCompaction.steps", &backgroundCompactionSteps);
+ServerStatusMetricField<Counter64> backgroundCompactionCollectionsDisplay(
+    "backgroundCompaction.collectionsCompacted", &backgroundCompactionCollections);
+
+}  // namespace
+
+/**
+ * Walks all collections and, for those whose files have enough free space, compacts the
+ * collection and then its indexes. Compaction happens in steps which are limited in time with a
+ * deadline on the step's operation, and which only hold intent locks, so writes go on during
+ * compaction. The compactor sleeps between steps to keep to 'backgroundCompactionDutyCyclePercent'.
+ */
+class BackgroundCompactor : public BackgroundJob {
+public:
+    BackgroundCompactor() : BackgroundJob(false /* selfDelete */) {}
+
+    static BackgroundCompactor* get(ServiceContext* serviceCtx) {
+        return getBackgroundCompactor(serviceCtx).get();
+    }
+
+    static void set(ServiceContext* serviceCtx, std::unique_ptr<BackgroundCompactor> compactor) {
+        auto& backgroundCompactor = getBackgroundCompactor(serviceCtx);
+        if (backgroundCompactor) {
+            invariant(!backgroundCompactor->running(),
+                      "Tried to reset the BackgroundCompactor without shutting down the original "
+                      "instance.");
+        }
+
+        invariant(compactor);
+        backgroundCompactor = std::move(compactor);
+    }
+
+    std::string name() const {
+        return "BackgroundCompactor";
+    }
+
+    void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+
+        {
+            stdx::lock_guard<Client> lk(*tc.get());
+            tc.get()->setSystemOperationKillable(lk);
+        }
+
+        while (_sleepFor(Seconds(backgroundCompactionSleepSecs.load()))) {
+            if (!backgroundCompactionEnabled.load()) {
+                continue;
+            }
+
+            if (lockedForWriting()) {
+                continue;
+            }
+
+            try {
+                _doPass();
+            } catch (const ExceptionForCat<ErrorCategory::Interruption>& interruption) {
+                LOGV2_DEBUG(5021445,
+                            1,
+                            "Background compaction was interrupted",
+                            "error"_attr = interruption);
+            }
+        }
+    }
+
+    /**
+     * Signals the thread to quit and then waits until it does.
+     */
+    void shutdown() {
+        LOGV2(5021446, "Shutting down background compaction thread");
+        {
+            stdx::lock_guard<Latch> lk(_stateMutex);
+            _shuttingDown = true;
+            _shuttingDownCV.notify_one();
+        }
+        wait();
+        LOGV2(5021447, "Finished shutting down background compaction thread");
+    }
+
+private:
+    enum class StepResult { kDone, kUnfinished, kSkipped };
+
+    /**
+     * Sleeps for 'duration' or until shutdown. Returns false if shutting down.
+     */
+    bool _sleepFor(Milliseconds duration) {
+        auto deadline = Date_t::now() + duration;
+        stdx::unique_lock<Latch> lk(_stateMutex);
+
+        MONGO_IDLE_THREAD_BLOCK;
+        _shuttingDownCV.wait_until(lk, deadline.toSystemTimePoint(), [&] { return _shuttingDown; });
+        return !_shuttingDown;
+    }
+
+    void _doPass() {
+        backgroundCompactionPasses.increment();
+
+        std::vector<NamespaceString> namespaces;
+        {
+            auto opCtx = cc().makeOperationContext();
+            auto& catalog = CollectionCatalog::get(opCtx.get());
+            for (const auto& dbName : catalog.getAllDbNames()) {
+                for (auto& nss : catalog.getAllCollectionNamesFromDb(opCtx.get(), dbName)) {
+                    if (!nss.isDropPendingNamespace()) {
+                        namespaces.push_back(std::move(nss));
+                    }
+                }
+            }
+        }
+
+        for (size_t i = 0; i < namespaces.size(); ++i) {
+            if (!backgroundCompactionEnabled.load()) {
+                return;
+            }
+
+            const auto& nss = namespaces[i];
+            const std::string message = str::stream()
+                << "Background compaction of " << nss << " (collection " << (i + 1) << " of "
+                << namespaces.size() << ")";
+
+            // First the collection, then its indexes.
+            bool compacted = false;
+            for (bool indexes : {false, true}) {
+                for (int step = 0; step < kMaxStepsPerTable; ++step) {
+                    const auto result = _doStep(nss, indexes, message);
+                    if (result == StepResult::kSkipped) {
+                        break;
+                    }
+                    compacted = true;
+                    if (result == StepResult::kDone) {
+                        break;
+                    }
+                }
+                if (!compacted) {
+                    break;
+                }
+            }
+
+            if (compacted) {
+                backgroundCompactionCollections.increment();
+            }
+        }
+    }
+
+    /**
+     * Compacts the collection 'nss', or its indexes, for at most 'backgroundCompactionStepSecs',
+     * and then sleeps according to the duty cycle.
+     */
+    StepResult _doStep(const NamespaceString& nss, bool indexes, const std::string& message) {
+        auto opCtx = cc().makeOperationContext();
+        {
+            stdx::lock_guard<Client> lk(*opCtx->getClient());
+            CurOp::get(opCtx.get())->setNS_inlock(nss.ns());
+            CurOp::get(opCtx.get())->setMessage_inlock(message);
+        }
+
+        const auto start = Date_t::now();
+        opCtx->setDeadlineAfterNowBy(Seconds(backgroundCompactionStepSecs.load()),
+                                     ErrorCodes::ExceededTimeLimit);
+
+        Status status = Status::OK();
+        try {
+            AutoGetCollection autoColl(opCtx.get(), nss, MODE_IX);
+            Collection* collection = autoColl.getCollection();
+            if (!collection) {
+                return StepResult::kSkipped;
+            }
+
+            auto recordStore = collection->getRecordStore();
+            if (!recordStore->compactSupported() || !recordStore->supportsOnlineCompaction()) {
+                return StepResult::kSkipped;
+            }
+
+            if (!indexes) {
+                const auto minFreeBytes = backgroundCompactionMinFreeStorageMB.load() * 1024 * 1024;
+                if (recordStore->freeStorageSize(opCtx.get()) < minFreeBytes) {
+                    return StepResult::kSkipped;
+                }
+            }
+
+            LOGV2_DEBUG(5021448,
+                        2,
+                        "Background compaction step",
+                        "namespace"_attr = nss,
+                        "indexes"_attr = indexes);
+            backgroundCompactionSteps.increment();
+            status = indexes ? collection->getIndexCatalog()->compactIndexes(opCtx.get())
+                             : recordStore->compact(opCtx.get());
+        } catch (const ExceptionFor<ErrorCodes::ExceededTimeLimit>& ex) {
+            status = ex.toStatus();
+        }
+
+        // Sleep for long enough that steps only take up the configured share of the time.
+        const auto elapsed = Date_t::now() - start;
+        const auto dutyCyclePercent = backgroundCompactionDutyCyclePercent.load();
+        if (!_sleepFor(elapsed * (100 - dutyCyclePercent) / dutyCyclePercent)) {
+            uasserted(ErrorCodes::InterruptedAtShutdown, "Background compaction shutting down");
+        }
+
+        if (status == ErrorCodes::ExceededTimeLimit) {
+            return StepResult::kUnfinished;
+        }
+        if (!status.isOK()) {
+            LOGV2_WARNING(5021449,
+                          "Background compaction failed",
+                          "namespace"_attr = nss,
+                          "indexes"_attr = indexes,
+                          "error"_attr = redact(status));
+        }
+        return StepResult::kDone;
+    }
+
+    // Protects the state below.
+    mutable Mutex _stateMutex = MONGO_MAKE_LATCH("BackgroundCompactor::_stateMutex");
+
+    // Signaled to wake up the thread, if the thread is waiting. The thread will check whether
+    // _shuttingDown is set and stop accordingly.
+    mutable stdx::condition_variable _shuttingDownCV;
+
+    bool _shuttingDown = false;
+};
+
+void startBackgroundCompactor(ServiceContext* serviceContext) {
+    auto compactor = std::make_unique<BackgroundCompactor>();
+    compactor->go();
+    BackgroundCompactor::set(serviceContext, std::move(compactor));
+}
+
+void shutdownBackgroundCompactor(ServiceContext* serviceContext) {
+    auto compactor = BackgroundCompactor::get(serviceContext);
+    // The BackgroundCompactor may not be set if shutdown occurs before the thread was started.
+    if (compactor) {
+        compactor->shutdown();
+    }
+}
+
+}  // namespace mongo
@@ -368,13 +368,15 @@ public:
     /**
      * Inserts a document into the record store for a bulk loader that manages the index building
      * outside this Collection. The bulk loader is notified with the RecordId of the document
-     * inserted into the RecordStore.
+     * inserted into the RecordStore. If 'recordStoreBulkLoader' is not null, the document is
+     * inserted through it rather than as part of the caller's WriteUnitOfWork.
      *
      * NOTE: It is up to caller to commit the indexes.
      */
     virtual Status insertDocumentForBulkLoader(OperationContext* const opCtx,
                                                const BSONObj& doc,
-                                               const OnRecordInsertedFn& onRecordInserted) = 0;
+                                               const OnRecordInsertedFn& onRecordInserted,
+                                               RecordStoreBulkLoader* recordStoreBulkLoader) = 0;
 
     /**
      * Updates the document @ oldLocation with newDoc.
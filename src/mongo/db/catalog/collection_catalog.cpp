@@ -76,7 +76,7 @@ CollectionCatalog::iterator::iterator(StringData dbName,
     : _dbName(dbName), _genNum(genNum), _catalog(&catalog) {
     auto minUuid = UUID::parse("00000000-0000-0000-0000-000000000000").getValue();
 
-    stdx::lock_guard<Latch> lock(_catalog->_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalog->_catalogLock);
     _mapIter = _catalog->_orderedCollections.lower_bound(std::make_pair(_dbName, minUuid));
 
     // Start with the first collection that is visible outside of its transaction.
@@ -94,7 +94,7 @@ CollectionCatalog::iterator::iterator(
     : _mapIter(mapIter) {}
 
 CollectionCatalog::iterator::value_type CollectionCatalog::iterator::operator*() {
-    stdx::lock_guard<Latch> lock(_catalog->_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalog->_catalogLock);
     _repositionIfNeeded();
     if (_exhausted()) {
         return _nullCollection;
@@ -108,7 +108,7 @@ boost::optional<CollectionUUID> CollectionCatalog::iterator::uuid() {
 }
 
 CollectionCatalog::iterator CollectionCatalog::iterator::operator++() {
-    stdx::lock_guard<Latch> lock(_catalog->_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalog->_catalogLock);
 
     if (!_repositionIfNeeded()) {
         _mapIter++;  // If the position was not updated, increment iterator to next element.
@@ -138,7 +138,7 @@ CollectionCatalog::iterator CollectionCatalog::iterator::operator++(int) {
 }
 
 bool CollectionCatalog::iterator::operator==(const iterator& other) {
-    stdx::lock_guard<Latch> lock(_catalog->_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalog->_catalogLock);
 
     if (other._mapIter == _catalog->_orderedCollections.end()) {
         return _uuid == boost::none;
@@ -202,11 +202,13 @@ void CollectionCatalog::setCollectionNamespace(OperationContext* opCtx,
     // manager locks) are held. The purpose of this function is ensure that we write to the
     // Collection's namespace string under '_catalogLock'.
     invariant(coll);
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    stdx::lock_guard<ReadMostlyMutex> lock(_catalogLock);
 
     coll->setNs(toCollection);
 
-    _collections[toCollection] = _collections[fromCollection];
+    // Copy the entry out first, since inserting into the map may move its elements.
+    Collection* const collection = _collections[fromCollection];
+    _collections[toCollection] = collection;
     _collections.erase(fromCollection);
 
     ResourceId oldRid = ResourceId(RESOURCE_COLLECTION, fromCollection.ns());
@@ -216,10 +218,11 @@ void CollectionCatalog::setCollectionNamespace(OperationContext* opCtx,
     addResource(newRid, toCollection.ns());
 
     opCtx->recoveryUnit()->onRollback([this, coll, fromCollection, toCollection] {
-        stdx::lock_guard<Latch> lock(_catalogLock);
+        stdx::lock_guard<ReadMostlyMutex> lock(_catalogLock);
         coll->setNs(fromCollection);
 
-        _collections[fromCollection] = _collections[toCollection];
+        Collection* const collection = _collections[toCollection];
+        _collections[fromCollection] = collection;
         _collections.erase(toCollection);
 
         ResourceId oldRid = ResourceId(RESOURCE_COLLECTION, fromCollection.ns());
@@ -238,7 +241,7 @@ void CollectionCatalog::onCloseDatabase(OperationContext* opCtx, std::string dbN
 
 void CollectionCatalog::onCloseCatalog(OperationContext* opCtx) {
     invariant(opCtx->lockState()->isW());
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    stdx::lock_guard<ReadMostlyMutex> lock(_catalogLock);
     invariant(!_shadowCatalog);
     _shadowCatalog.emplace();
     for (auto& entry : _catalog)
@@ -247,7 +250,7 @@ void CollectionCatalog::onCloseCatalog(OperationContext* opCtx) {
 
 void CollectionCatalog::onOpenCatalog(OperationContext* opCtx) {
     invariant(opCtx->lockState()->isW());
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    stdx::lock_guard<ReadMostlyMutex> lock(_catalogLock);
     invariant(_shadowCatalog);
     _shadowCatalog.reset();
     ++_epoch;
@@ -263,19 +266,19 @@ Collection* CollectionCatalog::lookupCollectionByUUID(OperationContext* opCtx,
         return coll;
     }
 
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalogLock);
     auto coll = _lookupCollectionByUUID(lock, uuid);
     return (coll && coll->isCommitted()) ? coll : nullptr;
 }
 
 void CollectionCatalog::makeCollectionVisible(CollectionUUID uuid) {
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    stdx::lock_guard<ReadMostlyMutex> lock(_catalogLock);
     auto coll = _lookupCollectionByUUID(lock, uuid);
     coll->setCommitted(true);
 }
 
 bool CollectionCatalog::isCollectionAwaitingVisibility(CollectionUUID uuid) const {
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalogLock);
     auto coll = _lookupCollectionByUUID(lock, uuid);
     return coll && !coll->isCommitted();
 }
@@ -291,7 +294,7 @@ Collection* CollectionCatalog::lookupCollectionByNamespace(OperationContext* opC
         return coll;
     }
 
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalogLock);
     auto it = _collections.find(nss);
     auto coll = (it == _collections.end() ? nullptr : it->second);
     return (coll && coll->isCommitted()) ? coll : nullptr;
@@ -303,7 +306,7 @@ boost::optional<NamespaceString> CollectionCatalog::lookupNSSByUUID(OperationCon
         return coll->ns();
     }
 
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalogLock);
     auto foundIt = _catalog.find(uuid);
     if (foundIt != _catalog.end()) {
         boost::optional<NamespaceString> ns = foundIt->second->ns();
@@ -328,7 +331,7 @@ boost::optional<CollectionUUID> CollectionCatalog::lookupUUIDByNSS(
         return coll->uuid();
     }
 
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalogLock);
     auto it = _collections.find(nss);
     if (it != _collections.end()) {
         boost::optional<CollectionUUID> uuid = it->second->uuid();
@@ -364,7 +367,7 @@ bool CollectionCatalog::checkIfCollectionSatisfiable(CollectionUUID uuid,
                                                      CollectionInfoFn predicate) const {
     invariant(predicate);
 
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalogLock);
     auto collection = _lookupCollectionByUUID(lock, uuid);
 
     if (!collection) {
@@ -376,7 +379,7 @@ bool CollectionCatalog::checkIfCollectionSatisfiable(CollectionUUID uuid,
 
 std::vector<CollectionUUID> CollectionCatalog::getAllCollectionUUIDsFromDb(
     StringData dbName) const {
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalogLock);
     auto minUuid = UUID::parse("00000000-0000-0000-0000-000000000000").getValue();
     auto it = _orderedCollections.lower_bound(std::make_pair(dbName.toString(), minUuid));
 
@@ -394,7 +397,7 @@ std::vector<NamespaceString> CollectionCatalog::getAllCollectionNamesFromDb(
     OperationContext* opCtx, StringData dbName) const {
     invariant(opCtx->lockState()->isDbLockedForMode(dbName, MODE_S));
 
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalogLock);
     auto minUuid = UUID::parse("00000000-0000-0000-0000-000000000000").getValue();
 
     std::vector<NamespaceString> ret;
@@ -410,7 +413,7 @@ std::vector<NamespaceString> CollectionCatalog::getAllCollectionNamesFromDb(
 
 std::vector<std::string> CollectionCatalog::getAllDbNames() const {
     std::vector<std::string> ret;
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    ReadMostlyMutex::SharedLock lock(_catalogLock);
     auto maxUuid = UUID::parse("FFFFFFFF-FFFF-FFFF-FFFF-FFFFFFFFFFFF").getValue();
     auto iter = _orderedCollections.upper_bound(std::make_pair("", maxUuid));
     while (iter != _orderedCollections.end()) {
@@ -451,7 +454,7 @@ void CollectionCatalog::clearDatabaseProfileLevel(StringData dbName) {
 
 void CollectionCatalog::registerCollection(CollectionUUID uuid, std::unique_ptr<Collection>* coll) {
     auto ns = (*coll)->ns();
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    stdx::lock_guard<ReadMostlyMutex> lock(_catalogLock);
     if (_collections.find(ns) != _collections.end()) {
         LOGV2(20279,
               "Conflicted creating a collection. ns: {coll_ns} ({coll_uuid}).",
@@ -487,7 +490,7 @@ void CollectionCatalog::registerCollection(CollectionUUID uuid, std::unique_ptr<
 }
 
 std::unique_ptr<Collection> CollectionCatalog::deregisterCollection(CollectionUUID uuid) {
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    stdx::lock_guard<ReadMostlyMutex> lock(_catalogLock);
 
     invariant(_catalog.find(uuid) != _catalog.end());
 
@@ -522,7 +525,7 @@ std::unique_ptr<RecoveryUnit::Change> CollectionCatalog::makeFinishDropCollectio
 }
 
 void CollectionCatalog::deregisterAllCollections() {
-    stdx::lock_guard<Latch> lock(_catalogLock);
+    stdx::lock_guard<ReadMostlyMutex> lock(_catalogLock);
 
     LOGV2(20282, "Deregistering all the collections");
     for (auto& entry : _catalog) {
@@ -36,6 +36,8 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/read_mostly_mutex.h"
+#include "mongo/util/flat_hash_map.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -290,7 +292,10 @@ private:
 
     const std::vector<CollectionUUID>& _getOrdering_inlock(const StringData& db,
                                                            const stdx::lock_guard<Latch>&);
-    mutable mongo::Mutex _catalogLock;
+
+    // Taken in shared mode by lookups and iteration, which happen on nearly every operation, and
+    // in exclusive mode only when the catalog itself changes.
+    mutable ReadMostlyMutex _catalogLock;
 
     /**
      * When present, indicates that the catalog is in closed state, and contains a map from UUID
@@ -300,10 +305,12 @@ private:
         mongo::stdx::unordered_map<CollectionUUID, NamespaceString, CollectionUUID::Hash>>
         _shadowCatalog;
 
+    // These maps are looked up on every collection access and can hold hundreds of thousands of
+    // entries, so they are flat. Their elements are (smart) pointers, which are fine to move.
     using CollectionCatalogMap =
-        stdx::unordered_map<CollectionUUID, std::unique_ptr<Collection>, CollectionUUID::Hash>;
+        FlatHashMap<CollectionUUID, std::unique_ptr<Collection>, CollectionUUID::Hash>;
     using OrderedCollectionMap = std::map<std::pair<std::string, CollectionUUID>, Collection*>;
-    using NamespaceCollectionMap = stdx::unordered_map<NamespaceString, Collection*>;
+    using NamespaceCollectionMap = FlatHashMap<NamespaceString, Collection*>;
     using DatabaseProfileLevelMap = StringMap<int>;
 
     CollectionCatalogMap _catalog;
@@ -550,7 +550,8 @@ Status CollectionImpl::insertDocument(OperationContext* opCtx,
 
 Status CollectionImpl::insertDocumentForBulkLoader(OperationContext* opCtx,
                                                    const BSONObj& doc,
-                                                   const OnRecordInsertedFn& onRecordInserted) {
+                                                   const OnRecordInsertedFn& onRecordInserted,
+                                                   RecordStoreBulkLoader* recordStoreBulkLoader) {
 
     auto status = checkFailCollectionInsertsFailPoint(_ns, doc);
     if (!status.isOK()) {
@@ -565,9 +566,10 @@ Status CollectionImpl::insertDocumentForBulkLoader(OperationContext* opCtx,
     dassert(opCtx->lockState()->isCollectionLockedForMode(ns(), MODE_IX));
 
     // Using timestamp 0 for these inserts, which are non-oplog so we don't have an appropriate
-    // timestamp to use.
-    StatusWith<RecordId> loc =
-        _recordStore->insertRecord(opCtx, doc.objdata(), doc.objsize(), Timestamp());
+    // timestamp to use. Records written by a bulk loader are not timestamped either.
+    StatusWith<RecordId> loc = recordStoreBulkLoader
+        ? recordStoreBulkLoader->insertRecord(doc.objdata(), doc.objsize())
+        : _recordStore->insertRecord(opCtx, doc.objdata(), doc.objsize(), Timestamp());
 
     if (!loc.isOK())
         return loc.getStatus();
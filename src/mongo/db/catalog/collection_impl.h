@@ -181,7 +181,8 @@ public:
      */
     Status insertDocumentForBulkLoader(OperationContext* opCtx,
                                        const BSONObj& doc,
-                                       const OnRecordInsertedFn& onRecordInserted) final;
+                                       const OnRecordInsertedFn& onRecordInserted,
+                                       RecordStoreBulkLoader* recordStoreBulkLoader) final;
 
     /**
      * Updates the document @ oldLocation with newDoc.
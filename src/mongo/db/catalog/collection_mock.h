@@ -139,7 +139,8 @@ public:
 
     Status insertDocumentForBulkLoader(OperationContext* opCtx,
                                        const BSONObj& doc,
-                                       const OnRecordInsertedFn& onRecordInserted) {
+                                       const OnRecordInsertedFn& onRecordInserted,
+                                       RecordStoreBulkLoader* recordStoreBulkLoader) {
         std::abort();
     }
 
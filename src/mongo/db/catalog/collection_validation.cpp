@@ -38,13 +38,20 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_consistency.h"
+#include "mongo/db/catalog/throttle_cursor.h"
 #include "mongo/db/catalog/validate_adaptor.h"
+#include "mongo/db/catalog/validate_gen.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/durable_catalog.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 
 namespace mongo {
@@ -112,6 +119,270 @@ std::map<std::string, int64_t> _validateIndexesInternalStructure(
     return numIndexKeysPerIndex;
 }
 
+/**
+ * Traverses a collection's indexes on a pool of worker threads while the validate command's own
+ * thread traverses the record store.
+ *
+ * Each worker reads through its own snapshot, opened at the same timestamp as the validate
+ * command's, so every traversal sees the same data. Workers take their own intent locks and yield
+ * them periodically, just as background validation does on the command's thread. Index keys are
+ * counted into per-worker hash buckets, which are merged into the IndexConsistency once all of
+ * the traversals have finished.
+ */
+class ConcurrentIndexTraversal {
+    ConcurrentIndexTraversal(const ConcurrentIndexTraversal&) = delete;
+    ConcurrentIndexTraversal& operator=(const ConcurrentIndexTraversal&) = delete;
+
+public:
+    struct IndexResult {
+        int64_t numTraversedKeys = 0;
+        ValidateResults results;
+    };
+
+    /**
+     * Starts traversing 'indexes' on up to 'maxThreads' threads.
+     */
+    ConcurrentIndexTraversal(OperationContext* opCtx,
+                             ValidateState* validateState,
+                             ValidateAdaptor* indexValidator,
+                             IndexConsistency* indexConsistency,
+                             std::vector<const IndexCatalogEntry*> indexes,
+                             size_t maxThreads)
+        : _indexValidator(indexValidator),
+          _indexConsistency(indexConsistency),
+          _dbName(validateState->nss().db().toString()),
+          _uuid(validateState->uuid()),
+          _readTimestamp(*validateState->getValidateTimestamp()),
+          _prepareConflictBehavior(opCtx->recoveryUnit()->getPrepareConflictBehavior()),
+          _indexes(std::move(indexes)),
+          _pool([&] {
+              ThreadPool::Options options;
+              options.poolName = "ValidateIndexTraversal";
+              options.minThreads = 0;
+              options.maxThreads = std::min(maxThreads, _indexes.size());
+              options.onCreateThread = [](const std::string& threadName) {
+                  Client::initThread(threadName.c_str());
+              };
+              return options;
+          }()) {
+        for (const auto index : _indexes) {
+            _results.emplace(index->descriptor()->indexName(), IndexResult());
+        }
+
+        _pool.startup();
+
+        const size_t numWorkers = std::min(maxThreads, _indexes.size());
+        _numRunningWorkers = numWorkers;
+        for (size_t i = 0; i < numWorkers; ++i) {
+            _pool.schedule([this](Status status) {
+                if (!status.isOK()) {
+                    _onWorkerDone(status, {});
+                    return;
+                }
+                _runWorker();
+            });
+        }
+    }
+
+    /**
+     * Interrupts any traversals that are still running and waits for the workers to exit.
+     */
+    ~ConcurrentIndexTraversal() {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _shuttingDown = true;
+            for (auto workerOpCtx : _workerOpCtxs) {
+                stdx::lock_guard<Client> clientLock(*workerOpCtx->getClient());
+                workerOpCtx->getServiceContext()->killOperation(
+                    clientLock, workerOpCtx, ErrorCodes::Interrupted);
+            }
+        }
+        _pool.shutdown();
+        _pool.join();
+    }
+
+    /**
+     * Waits for every index to be traversed, then adds the key counts gathered by the workers to
+     * the IndexConsistency. Throws the first error a worker ran into, or if 'opCtx' is
+     * interrupted while waiting.
+     */
+    void wait(OperationContext* opCtx) {
+        stdx::unique_lock<Latch> lk(_mutex);
+        opCtx->waitForConditionOrInterrupt(
+            _workersDone, lk, [&] { return _numRunningWorkers == 0; });
+        uassertStatusOK(_status);
+        invariant(_nextIndex == _indexes.size());
+
+        for (const auto& buckets : _workerBuckets) {
+            _indexConsistency->mergeIndexKeyBuckets(buckets);
+        }
+        _workerBuckets.clear();
+    }
+
+    /**
+     * Returns the result of traversing 'indexName', or nullptr if the index was not traversed
+     * here. Only valid after wait() has returned.
+     */
+    IndexResult* getResult(const std::string& indexName) {
+        auto it = _results.find(indexName);
+        return it == _results.end() ? nullptr : &it->second;
+    }
+
+private:
+    void _runWorker() {
+        auto opCtxHolder = cc().makeOperationContext();
+        OperationContext* opCtx = opCtxHolder.get();
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _workerOpCtxs.insert(opCtx);
+        }
+
+        auto buckets = _indexConsistency->makeIndexKeyBuckets();
+        Status status = Status::OK();
+        try {
+            opCtx->recoveryUnit()->setPrepareConflictBehavior(_prepareConflictBehavior);
+            opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kProvided,
+                                                          _readTimestamp);
+
+            // Hold the global lock throughout, so that yielding the database and collection locks
+            // does not abandon our snapshot.
+            Lock::GlobalLock globalLock(opCtx, MODE_IS);
+            while (const IndexCatalogEntry* index = _getNextIndex()) {
+                _traverseIndex(opCtx, index, &buckets);
+            }
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        _onWorkerDone(std::move(status), std::move(buckets), opCtx);
+    }
+
+    void _traverseIndex(OperationContext* opCtx,
+                        const IndexCatalogEntry* index,
+                        IndexConsistency::IndexKeyBuckets* buckets) {
+        const IndexDescriptor* descriptor = index->descriptor();
+        IndexResult& result = _results.at(descriptor->indexName());
+
+        LOGV2_OPTIONS(4798611,
+                      {LogComponent::kIndex},
+                      "Validating index consistency concurrently with the collection",
+                      "index"_attr = descriptor->indexName(),
+                      "uuid"_attr = _uuid);
+
+        boost::optional<Lock::DBLock> dbLock;
+        boost::optional<Lock::CollectionLock> collectionLock;
+        auto relock = [&] {
+            collectionLock.reset();
+            dbLock.reset();
+
+            dbLock.emplace(opCtx, _dbName, MODE_IS);
+            try {
+                collectionLock.emplace(opCtx, NamespaceStringOrUUID(_dbName, _uuid), MODE_IS);
+            } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+                uasserted(ErrorCodes::Interrupted,
+                          str::stream() << "Interrupted due to: collection drop: " << _uuid
+                                        << " while validating the collection");
+            }
+
+            uassert(ErrorCodes::Interrupted,
+                    str::stream()
+                        << "Interrupted due to: index being validated was dropped from collection: "
+                        << _uuid << ", index: " << descriptor->indexName(),
+                    !index->isDropped());
+        };
+        relock();
+
+        // Throttled validations never run here, see _getIndexesForConcurrentTraversal().
+        DataThrottle dataThrottle(opCtx);
+        dataThrottle.turnThrottlingOff();
+        SortedDataInterfaceThrottleCursor cursor(opCtx, index->accessMethod(), &dataThrottle);
+
+        _indexValidator->traverseIndex(
+            opCtx, index, &cursor, relock, buckets, &result.numTraversedKeys, &result.results);
+    }
+
+    const IndexCatalogEntry* _getNextIndex() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_shuttingDown || !_status.isOK() || _nextIndex == _indexes.size()) {
+            return nullptr;
+        }
+        return _indexes[_nextIndex++];
+    }
+
+    void _onWorkerDone(Status status,
+                       IndexConsistency::IndexKeyBuckets buckets,
+                       OperationContext* opCtx = nullptr) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _workerOpCtxs.erase(opCtx);
+
+        if (!status.isOK()) {
+            if (_status.isOK()) {
+                _status = std::move(status);
+            }
+        } else {
+            _workerBuckets.push_back(std::move(buckets));
+        }
+
+        if (--_numRunningWorkers == 0) {
+            _workersDone.notify_all();
+        }
+    }
+
+    ValidateAdaptor* const _indexValidator;
+    IndexConsistency* const _indexConsistency;
+
+    const std::string _dbName;
+    const UUID _uuid;
+    const Timestamp _readTimestamp;
+    const PrepareConflictBehavior _prepareConflictBehavior;
+
+    const std::vector<const IndexCatalogEntry*> _indexes;
+
+    // Populated up front. Each entry is only written by the worker traversing that index.
+    std::map<std::string, IndexResult> _results;
+
+    ThreadPool _pool;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("ConcurrentIndexTraversal::_mutex");
+    stdx::condition_variable _workersDone;
+
+    // All of the following are protected by '_mutex'.
+    size_t _nextIndex = 0;
+    size_t _numRunningWorkers = 0;
+    bool _shuttingDown = false;
+    Status _status = Status::OK();
+    std::set<OperationContext*> _workerOpCtxs;
+    std::vector<IndexConsistency::IndexKeyBuckets> _workerBuckets;
+};
+
+/**
+ * Returns the indexes to traverse with a ConcurrentIndexTraversal, or an empty list if every
+ * index must be traversed after the record store on the validate command's own thread.
+ *
+ * Foreground validation holds an exclusive collection lock, so no other operation could read the
+ * collection alongside it. Background validation on a node that does not read at a timestamp has
+ * no way to give another thread the same view of the data. Throttled validations stay on one
+ * thread so that 'maxValidateMBperSec' keeps limiting the whole command.
+ */
+std::vector<const IndexCatalogEntry*> _getIndexesForConcurrentTraversal(
+    ValidateState* validateState) {
+    if (!validateState->isBackground() || !validateState->getValidateTimestamp() ||
+        gMaxValidateMBperSec.load() > 0 || gMaxValidateIndexTraversalThreads.load() == 0) {
+        return {};
+    }
+
+    std::vector<const IndexCatalogEntry*> indexes;
+    for (const auto& index : validateState->getIndexes()) {
+        // $** indexes check their multikey metadata keys against the paths gathered while
+        // traversing the record store, so they can only be traversed after it.
+        if (index->descriptor()->getIndexType() == IndexType::INDEX_WILDCARD) {
+            continue;
+        }
+        indexes.push_back(index.get());
+    }
+    return indexes;
+}
+
 /**
  * Validates each index in the Index Catalog using the cursors in 'indexCursors'.
  *
@@ -123,6 +394,7 @@ void _validateIndexes(OperationContext* opCtx,
                       BSONObjBuilder* keysPerIndex,
                       ValidateAdaptor* indexValidator,
                       const std::map<std::string, int64_t>& numIndexKeysPerIndex,
+                      ConcurrentIndexTraversal* concurrentIndexTraversal,
                       ValidateResultsMap* indexNsResultsMap,
                       ValidateResults* results) {
     // Validate Indexes, checking for mismatch between index entries and collection records.
@@ -130,16 +402,32 @@ void _validateIndexes(OperationContext* opCtx,
         opCtx->checkForInterrupt();
 
         const IndexDescriptor* descriptor = index->descriptor();
-
-        LOGV2_OPTIONS(20296,
-                      {LogComponent::kIndex},
-                      "Validating index consistency",
-                      "index"_attr = descriptor->indexName(),
-                      "namespace"_attr = validateState->nss());
-
         ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexName()];
         int64_t numTraversedKeys;
-        indexValidator->traverseIndex(opCtx, index.get(), &numTraversedKeys, &curIndexResults);
+
+        auto concurrentResult = concurrentIndexTraversal
+            ? concurrentIndexTraversal->getResult(descriptor->indexName())
+            : nullptr;
+        if (concurrentResult) {
+            // This index was already traversed alongside the record store.
+            const ValidateResults& traversalResults = concurrentResult->results;
+            numTraversedKeys = concurrentResult->numTraversedKeys;
+            curIndexResults.valid = curIndexResults.valid && traversalResults.valid;
+            curIndexResults.errors.insert(curIndexResults.errors.end(),
+                                          traversalResults.errors.begin(),
+                                          traversalResults.errors.end());
+            curIndexResults.warnings.insert(curIndexResults.warnings.end(),
+                                            traversalResults.warnings.begin(),
+                                            traversalResults.warnings.end());
+        } else {
+            LOGV2_OPTIONS(20296,
+                          {LogComponent::kIndex},
+                          "Validating index consistency",
+                          "index"_attr = descriptor->indexName(),
+                          "namespace"_attr = validateState->nss());
+
+            indexValidator->traverseIndex(opCtx, index.get(), &numTraversedKeys, &curIndexResults);
+        }
 
         // If we are performing a full index validation, we have information on the number of index
         // keys validated in _validateIndexesInternalStructure (when we validated the internal
@@ -492,6 +780,19 @@ Status validate(OperationContext* opCtx,
         IndexConsistency indexConsistency(opCtx, &validateState);
         ValidateAdaptor indexValidator(&indexConsistency, &validateState, &indexNsResultsMap);
 
+        // Where possible, traverse the indexes on other threads while this thread traverses the
+        // record store.
+        boost::optional<ConcurrentIndexTraversal> concurrentIndexTraversal;
+        auto concurrentIndexes = _getIndexesForConcurrentTraversal(&validateState);
+        if (!concurrentIndexes.empty()) {
+            concurrentIndexTraversal.emplace(opCtx,
+                                             &validateState,
+                                             &indexValidator,
+                                             &indexConsistency,
+                                             std::move(concurrentIndexes),
+                                             gMaxValidateIndexTraversalThreads.load());
+        }
+
         // In traverseRecordStore(), the index validator keeps track the records in the record
         // store so that _validateIndexes() can confirm that the index entries match the records in
         // the collection.
@@ -526,12 +827,17 @@ Status validate(OperationContext* opCtx,
             return Status::OK();
         }
 
+        if (concurrentIndexTraversal) {
+            concurrentIndexTraversal->wait(opCtx);
+        }
+
         // Validate indexes and check for mismatches.
         _validateIndexes(opCtx,
                          &validateState,
                          &keysPerIndex,
                          &indexValidator,
                          numIndexKeysPerIndex,
+                         concurrentIndexTraversal.get_ptr(),
                          &indexNsResultsMap,
                          results);
 
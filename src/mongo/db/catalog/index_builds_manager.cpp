@@ -245,6 +245,11 @@ Status IndexBuildsManager::drainBackgroundWrites(
     return builder->drainBackgroundWrites(opCtx, readSource, drainYieldPolicy);
 }
 
+long long IndexBuildsManager::getNumPendingSideWrites(const UUID& buildUUID) {
+    auto builder = invariant(_getBuilder(buildUUID));
+    return builder->getNumPendingSideWrites();
+}
+
 Status IndexBuildsManager::retrySkippedRecords(OperationContext* opCtx,
                                                const UUID& buildUUID,
                                                Collection* collection) {
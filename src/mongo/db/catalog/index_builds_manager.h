@@ -117,6 +117,12 @@ public:
                                  RecoveryUnit::ReadSource readSource,
                                  IndexBuildInterceptor::DrainYieldPolicy drainYieldPolicy);
 
+    /**
+     * Returns the number of side writes recorded for the index build which have not been drained
+     * yet.
+     */
+    long long getNumPendingSideWrites(const UUID& buildUUID);
+
     /**
      * Retries the key generation and insertion of records that were skipped during the scanning
      * phase due to error suppression.
@@ -246,14 +246,16 @@ void IndexConsistency::addDocKey(OperationContext* opCtx,
 
 void IndexConsistency::addIndexKey(const KeyString::Value& ks,
                                    IndexInfo* indexInfo,
-                                   RecordId recordId) {
+                                   RecordId recordId,
+                                   IndexKeyBuckets* buckets) {
     const uint32_t hash = _hashKeyString(ks, indexInfo->indexNameHash);
 
     if (_firstPhase) {
         // During the first phase of validation we only keep track of the count for the index entry
         // keys encountered.
-        _indexKeyBuckets[hash].indexKeyCount--;
-        _indexKeyBuckets[hash].bucketSizeBytes += ks.getSize();
+        IndexKeyBucket& bucket = buckets ? (*buckets)[hash] : _indexKeyBuckets[hash];
+        bucket.indexKeyCount--;
+        bucket.bucketSizeBytes += ks.getSize();
         indexInfo->numKeys++;
 
         if (MONGO_unlikely(_validateState->extraLoggingForTest())) {
@@ -265,6 +267,8 @@ void IndexConsistency::addIndexKey(const KeyString::Value& ks,
                 recordId, ks, keyPatternBson, keyStringBson, "[validate](index)");
         }
     } else if (_indexKeyBuckets[hash].indexKeyCount) {
+        invariant(!buckets);
+
         // Found an index key for a bucket that has inconsistencies.
         // If there is a corresponding document key for the index entry key, we remove the key from
         // the '_missingIndexEntries' map. However if there was no document key for the index entry
@@ -290,6 +294,22 @@ void IndexConsistency::addIndexKey(const KeyString::Value& ks,
     }
 }
 
+IndexConsistency::IndexKeyBuckets IndexConsistency::makeIndexKeyBuckets() const {
+    return IndexKeyBuckets(kNumHashBuckets);
+}
+
+void IndexConsistency::mergeIndexKeyBuckets(const IndexKeyBuckets& buckets) {
+    invariant(_firstPhase);
+    invariant(buckets.size() == _indexKeyBuckets.size());
+
+    // The counts are unsigned, so adding a bucket that went "negative" wraps around to the same
+    // result as if its keys had been counted here directly.
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        _indexKeyBuckets[i].indexKeyCount += buckets[i].indexKeyCount;
+        _indexKeyBuckets[i].bucketSizeBytes += buckets[i].bucketSizeBytes;
+    }
+}
+
 bool IndexConsistency::limitMemoryUsageForSecondPhase(ValidateResults* result) {
     invariant(!_firstPhase);
 
@@ -72,6 +72,12 @@ class IndexConsistency final {
     using IndexKey = std::pair<std::string, std::string>;
 
 public:
+    struct IndexKeyBucket {
+        uint32_t indexKeyCount;
+        uint32_t bucketSizeBytes;
+    };
+    using IndexKeyBuckets = std::vector<IndexKeyBucket>;
+
     IndexConsistency(OperationContext* opCtx, CollectionValidation::ValidateState* validateState);
 
     /**
@@ -90,8 +96,27 @@ public:
      * corresponding `_indexKeyCount` by hashing it.
      * For the second phase of validation, try to match the index entry keys that hashed to
      * inconsistent hash buckets during the first phase of validation to document keys.
+     *
+     * If 'buckets' is provided, first phase counts are accumulated there instead, so that an index
+     * can be traversed concurrently with the collection. They must later be folded in with
+     * mergeIndexKeyBuckets().
+     */
+    void addIndexKey(const KeyString::Value& ks,
+                     IndexInfo* indexInfo,
+                     RecordId recordId,
+                     IndexKeyBuckets* buckets = nullptr);
+
+    /**
+     * Returns an empty set of hash buckets for use with addIndexKey() during the first phase of
+     * validation.
      */
-    void addIndexKey(const KeyString::Value& ks, IndexInfo* indexInfo, RecordId recordId);
+    IndexKeyBuckets makeIndexKeyBuckets() const;
+
+    /**
+     * Adds the counts in 'buckets' to this object's hash buckets. Must be called during the first
+     * phase of validation, while no other thread is adding keys.
+     */
+    void mergeIndexKeyBuckets(const IndexKeyBuckets& buckets);
 
     /**
      * To validate $** multikey metadata paths, we first scan the collection and add a hash of all
@@ -139,11 +164,6 @@ public:
     bool limitMemoryUsageForSecondPhase(ValidateResults* result);
 
 private:
-    struct IndexKeyBucket {
-        uint32_t indexKeyCount;
-        uint32_t bucketSizeBytes;
-    };
-
     IndexConsistency() = delete;
 
     CollectionValidation::ValidateState* _validateState;
@@ -159,7 +179,7 @@ private:
     //       than zero, there are too few index entries.
     //     - Similarly, if that count ends up less than zero, there are too many index entries.
 
-    std::vector<IndexKeyBucket> _indexKeyBuckets;
+    IndexKeyBuckets _indexKeyBuckets;
 
     // A vector of IndexInfo indexes by index number
     IndexInfoMap _indexesInfo;
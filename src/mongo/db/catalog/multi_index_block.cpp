@@ -638,6 +638,16 @@ Status MultiIndexBlock::drainBackgroundWrites(
     return Status::OK();
 }
 
+long long MultiIndexBlock::getNumPendingSideWrites() const {
+    long long numPending = 0;
+    for (const auto& index : _indexes) {
+        if (auto interceptor = index.block->getEntry()->indexBuildInterceptor()) {
+            numPending += interceptor->getNumPendingSideWrites();
+        }
+    }
+    return numPending;
+}
+
 Status MultiIndexBlock::retrySkippedRecords(OperationContext* opCtx, Collection* collection) {
     invariant(!_buildIsCleanedUp);
     for (auto&& index : _indexes) {
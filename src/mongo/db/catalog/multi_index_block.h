@@ -194,6 +194,11 @@ public:
                                  RecoveryUnit::ReadSource readSource,
                                  IndexBuildInterceptor::DrainYieldPolicy drainYieldPolicy);
 
+    /**
+     * Returns the number of side writes recorded for the indexes being built which have not been
+     * drained yet. See IndexBuildInterceptor::getNumPendingSideWrites().
+     */
+    long long getNumPendingSideWrites() const;
 
     /**
      * Retries key generation and insertion for all records skipped during the collection scanning
@@ -254,13 +254,6 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
                                     const IndexCatalogEntry* index,
                                     int64_t* numTraversedKeys,
                                     ValidateResults* results) {
-    const IndexDescriptor* descriptor = index->descriptor();
-    auto indexName = descriptor->indexName();
-    IndexInfo& indexInfo = _indexConsistency->getIndexInfo(indexName);
-    int64_t numKeys = 0;
-
-    bool isFirstEntry = true;
-
     // The progress meter will be inactive after traversing the record store to allow the message
     // and the total to be set to different values.
     if (!_progress->isActive()) {
@@ -269,6 +262,49 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
         _progress.set(CurOp::get(opCtx)->setProgress_inlock(curopMessage, _totalIndexKeys));
     }
 
+    // Ensure that this index has an open index cursor.
+    const auto& indexCursors = _validateState->getIndexCursors();
+    const auto indexCursorIt = indexCursors.find(index->descriptor()->indexName());
+    invariant(indexCursorIt != indexCursors.end());
+
+    _traverseIndex(opCtx,
+                   index,
+                   indexCursorIt->second.get(),
+                   [&] { _validateState->yield(opCtx); },
+                   /*buckets=*/nullptr,
+                   numTraversedKeys,
+                   results);
+}
+
+void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
+                                    const IndexCatalogEntry* index,
+                                    SortedDataInterfaceThrottleCursor* cursor,
+                                    const std::function<void()>& yieldFn,
+                                    IndexConsistency::IndexKeyBuckets* buckets,
+                                    int64_t* numTraversedKeys,
+                                    ValidateResults* results) {
+    invariant(index->descriptor()->getIndexType() != IndexType::INDEX_WILDCARD);
+    invariant(buckets);
+    _traverseIndex(opCtx, index, cursor, yieldFn, buckets, numTraversedKeys, results);
+}
+
+void ValidateAdaptor::_traverseIndex(OperationContext* opCtx,
+                                     const IndexCatalogEntry* index,
+                                     SortedDataInterfaceThrottleCursor* cursor,
+                                     const std::function<void()>& yieldFn,
+                                     IndexConsistency::IndexKeyBuckets* buckets,
+                                     int64_t* numTraversedKeys,
+                                     ValidateResults* results) {
+    const IndexDescriptor* descriptor = index->descriptor();
+    auto indexName = descriptor->indexName();
+    IndexInfo& indexInfo = _indexConsistency->getIndexInfo(indexName);
+    int64_t numKeys = 0;
+
+    bool isFirstEntry = true;
+
+    // Progress is only reported for traversals on the validate command's own thread.
+    const bool reportProgress = !buckets;
+
     const KeyString::Version version =
         index->accessMethod()->getSortedDataInterface()->getKeyStringVersion();
 
@@ -281,14 +317,8 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
 
     KeyString::Value prevIndexKeyStringValue;
 
-    // Ensure that this index has an open index cursor.
-    const auto indexCursorIt = _validateState->getIndexCursors().find(indexName);
-    invariant(indexCursorIt != _validateState->getIndexCursors().end());
-
-    const std::unique_ptr<SortedDataInterfaceThrottleCursor>& indexCursor = indexCursorIt->second;
-    for (auto indexEntry = indexCursor->seekForKeyString(opCtx, firstKeyString.release());
-         indexEntry;
-         indexEntry = indexCursor->nextKeyString(opCtx)) {
+    for (auto indexEntry = cursor->seekForKeyString(opCtx, firstKeyString.release()); indexEntry;
+         indexEntry = cursor->nextKeyString(opCtx)) {
 
         if (!isFirstEntry) {
             _validateKeyOrder(
@@ -305,8 +335,11 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
             continue;
         }
 
-        _indexConsistency->addIndexKey(indexEntry->keyString, &indexInfo, indexEntry->loc);
-        _progress->hit();
+        _indexConsistency->addIndexKey(
+            indexEntry->keyString, &indexInfo, indexEntry->loc, buckets);
+        if (reportProgress) {
+            _progress->hit();
+        }
         numKeys++;
         isFirstEntry = false;
         prevIndexKeyStringValue = indexEntry->keyString;
@@ -314,7 +347,7 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
         if (numKeys % kInterruptIntervalNumRecords == 0) {
             // Periodically checks for interrupts and yields.
             opCtx->checkForInterrupt();
-            _validateState->yield(opCtx);
+            yieldFn();
         }
     }
 
@@ -29,12 +29,14 @@
 
 #pragma once
 
+#include <functional>
+
+#include "mongo/db/catalog/index_consistency.h"
 #include "mongo/db/catalog/validate_state.h"
 #include "mongo/util/progress_meter.h"
 
 namespace mongo {
 
-class IndexConsistency;
 class IndexDescriptor;
 class OperationContext;
 
@@ -73,6 +75,24 @@ public:
                        int64_t* numTraversedKeys,
                        ValidateResults* results);
 
+    /**
+     * Like traverseIndex() above, but safe to run on another thread while the record store is
+     * being traversed. Index entries are read through 'cursor', which must belong to 'opCtx', and
+     * first phase counts are accumulated into 'buckets' instead of the shared IndexConsistency
+     * state. 'yieldFn' is called periodically in place of ValidateState::yield(). Progress is not
+     * reported.
+     *
+     * Must not be used for $** indexes, whose multikey metadata keys are checked against the
+     * record store traversal.
+     */
+    void traverseIndex(OperationContext* opCtx,
+                       const IndexCatalogEntry* index,
+                       SortedDataInterfaceThrottleCursor* cursor,
+                       const std::function<void()>& yieldFn,
+                       IndexConsistency::IndexKeyBuckets* buckets,
+                       int64_t* numTraversedKeys,
+                       ValidateResults* results);
+
     /**
      * Traverses the record store to retrieve every record and go through its document key
      * set to keep track of the index consistency during a validation.
@@ -88,6 +108,14 @@ public:
     void validateIndexKeyCount(const IndexCatalogEntry* index, ValidateResults& results);
 
 private:
+    void _traverseIndex(OperationContext* opCtx,
+                        const IndexCatalogEntry* index,
+                        SortedDataInterfaceThrottleCursor* cursor,
+                        const std::function<void()>& yieldFn,
+                        IndexConsistency::IndexKeyBuckets* buckets,
+                        int64_t* numTraversedKeys,
+                        ValidateResults* results);
+
     IndexConsistency* _indexConsistency;
     CollectionValidation::ValidateState* _validateState;
     ValidateResultsMap* _indexNsResultsMap;
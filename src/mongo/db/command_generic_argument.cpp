@@ -52,7 +52,7 @@ struct SpecialArgRecord {
 // If that changes, it should be added. When you add to this list, consider whether you
 // should also change the filterCommandRequestForPassthrough() function.
 // clang-format off
-static constexpr std::array<SpecialArgRecord, 34> specials{{
+static constexpr std::array<SpecialArgRecord, 35> specials{{
     //                                       /-isGeneric
     //                                       |  /-stripFromRequest
     //                                       |  |  /-stripFromReply
@@ -88,6 +88,7 @@ static constexpr std::array<SpecialArgRecord, 34> specials{{
     {"readOnly"_sd,                          0, 0, 1},
     {"comment"_sd,                           1, 0, 0},
     {"maxTimeMSOpOnly"_sd,                   1, 0, 0},
+    {"admissionPriority"_sd,                 1, 0, 0},
     {"$configTime"_sd,                       1, 1, 1},
     {"$topologyTime"_sd,                     1, 1, 1}}};
 // clang-format on
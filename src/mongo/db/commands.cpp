@@ -856,6 +856,18 @@ Command::Command(StringData name, std::vector<StringData> aliases)
     globalCommandRegistry()->registerCommand(this, _name, _aliases);
 }
 
+std::size_t Command::bytesToReserveForReply() const {
+    return std::max(reserveBytesForReply(), _recentReplySize.loadRelaxed());
+}
+
+void Command::noteReplySize(std::size_t bytes) const {
+    bytes = std::min(bytes, kMaxRecentReplySizeBytes);
+    const auto recentReplySize = _recentReplySize.loadRelaxed();
+    if (bytes > recentReplySize || bytes < recentReplySize / 2) {
+        _recentReplySize.store(bytes);
+    }
+}
+
 bool Command::hasAlias(const StringData& alias) const {
     return globalCommandRegistry()->findCommand(alias) == this;
 }
@@ -488,6 +488,18 @@ public:
         _commandsFailed.increment();
     }
 
+    /**
+     * Returns how many bytes the rpc system should reserve for the reply to this command: the
+     * larger of reserveBytesForReply() and the size of recent replies recorded with
+     * noteReplySize(). Reserving up front saves growing the reply buffer by repeated doubling.
+     */
+    std::size_t bytesToReserveForReply() const;
+
+    /**
+     * Records the size of a reply to this command, for use by bytesToReserveForReply().
+     */
+    void noteReplySize(std::size_t bytes) const;
+
     /**
      * Generates a reply from the 'help' information associated with a command. The state of
      * the passed ReplyBuilder will be in kOutputDocs after calling this method.
@@ -518,6 +530,15 @@ private:
     // The list of aliases for the command
     const std::vector<StringData> _aliases;
 
+    // Recent replies larger than this are not worth reserving for, since doubling a buffer past
+    // this size costs few reallocations relative to the data copied into it.
+    static constexpr std::size_t kMaxRecentReplySizeBytes = 16 * 1024;
+
+    // Size of the largest recent reply, capped at kMaxRecentReplySizeBytes. Only rewritten when a
+    // reply outgrows it or shrinks to less than half of it, so that the commonly steady reply
+    // sizes of a command do not cause a shared write on every execution.
+    mutable AtomicWord<std::size_t> _recentReplySize{0};
+
     // Counters for how many times this command has been executed and failed
     mutable Counter64 _commandsExecuted;
     mutable Counter64 _commandsFailed;
@@ -0,0 +1,234 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/ops/write_ops.h"
+#include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+
+namespace mongo {
+namespace {
+constexpr long long kDefaultSampleSize = 10000;
+constexpr long long kDefaultNumBuckets = 100;
+
+/**
+ * Returns up to 'sampleSize' documents drawn at random from 'collection', or all of its documents
+ * if it has no more than 'sampleSize'.
+ */
+std::vector<BSONObj> sampleCollection(OperationContext* opCtx,
+                                      const Collection* collection,
+                                      long long sampleSize) {
+    std::vector<BSONObj> sample;
+
+    std::unique_ptr<RecordCursor> cursor;
+    if (collection->numRecords(opCtx) > sampleSize) {
+        cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    }
+    if (!cursor) {
+        // Record stores without random cursors are sampled from their start.
+        cursor = collection->getCursor(opCtx);
+    }
+
+    while (static_cast<long long>(sample.size()) < sampleSize) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        sample.push_back(record->data.releaseToBson().getOwned());
+    }
+    return sample;
+}
+
+/**
+ * Writes 'stats' for the collection 'nss' with the given 'uuid' into the statistics collection of
+ * its database, where the query planner loads them from.
+ */
+void persistStatistics(OperationContext* opCtx,
+                       const NamespaceString& nss,
+                       const UUID& uuid,
+                       const CollectionStatistics& stats) {
+    const NamespaceString statsNss(nss.db(), NamespaceString::kSystemDotStatisticsCollectionName);
+
+    BSONObjBuilder doc;
+    doc.append("_id", nss.coll());
+    uuid.appendToBuilder(&doc, "uuid");
+    doc.appendElements(stats.toBSON());
+
+    DBDirectClient client(opCtx);
+    const auto commandResponse = client.runCommand([&] {
+        write_ops::Update updateOp(statsNss);
+        updateOp.setUpdates({[&] {
+            write_ops::UpdateOpEntry entry;
+            entry.setQ(BSON("_id" << nss.coll()));
+            entry.setU(doc.obj());
+            entry.setUpsert(true);
+            return entry;
+        }()});
+        return updateOp.serialize({});
+    }());
+    uassertStatusOK(getStatusFromWriteCommandReply(commandResponse->getCommandReply()));
+}
+}  // namespace
+
+/**
+ * The 'analyze' command samples a collection and builds a histogram and an estimate of the number
+ * of distinct values for each of the given fields. The query planner uses these statistics to
+ * skip the trial period of candidate plans which are estimated to examine much more than the
+ * others. The statistics are stored in the 'system.statistics' collection of the database, and
+ * are updated from a sample of the documents inserted afterwards.
+ *
+ *    {
+ *        analyze: <collection>,
+ *        keys: [<path>, ...],
+ *        sampleSize: <number of documents to sample>,
+ *        numBuckets: <maximum number of histogram buckets per field>
+ *    }
+ */
+class AnalyzeCommand final : public BasicCommand {
+public:
+    AnalyzeCommand() : BasicCommand("analyze") {}
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override;
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return true;
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kNever;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override;
+
+    std::string help() const override {
+        return "Builds statistics about the values of fields of a collection for query planning.";
+    }
+} analyzeCommand;
+
+Status AnalyzeCommand::checkAuthForCommand(Client* client,
+                                           const std::string& dbname,
+                                           const BSONObj& cmdObj) const {
+    AuthorizationSession* authzSession = AuthorizationSession::get(client);
+    ResourcePattern pattern = parseResourcePattern(dbname, cmdObj);
+
+    if (authzSession->isAuthorizedForActionsOnResource(pattern, ActionType::planCacheWrite)) {
+        return Status::OK();
+    }
+
+    return Status(ErrorCodes::Unauthorized, "unauthorized");
+}
+
+bool AnalyzeCommand::run(OperationContext* opCtx,
+                         const std::string& dbname,
+                         const BSONObj& cmdObj,
+                         BSONObjBuilder& result) {
+    const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+
+    std::vector<std::string> keys;
+    const auto keysElem = cmdObj["keys"];
+    uassert(5021420, "'keys' must be a non-empty array", keysElem.type() == BSONType::Array);
+    for (auto&& key : keysElem.Obj()) {
+        uassert(5021421,
+                "'keys' must only contain non-empty strings",
+                key.type() == BSONType::String && !key.valueStringData().empty());
+        keys.push_back(key.str());
+    }
+    uassert(5021422, "'keys' must be a non-empty array", !keys.empty());
+
+    auto sampleSize = kDefaultSampleSize;
+    if (auto elem = cmdObj["sampleSize"]) {
+        uassert(5021423,
+                "'sampleSize' must be a positive number",
+                elem.isNumber() && elem.safeNumberLong() > 0);
+        sampleSize = elem.safeNumberLong();
+    }
+
+    auto numBuckets = kDefaultNumBuckets;
+    if (auto elem = cmdObj["numBuckets"]) {
+        uassert(5021424,
+                "'numBuckets' must be a number of at least 2",
+                elem.isNumber() && elem.safeNumberLong() >= 2);
+        numBuckets = elem.safeNumberLong();
+    }
+
+    std::shared_ptr<CollectionStatistics> stats;
+    boost::optional<UUID> uuid;
+    size_t numSampled = 0;
+    {
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        auto collection = ctx.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "Collection " << nss << " does not exist",
+                collection);
+
+        const auto sample = sampleCollection(opCtx, collection, sampleSize);
+        numSampled = sample.size();
+        stats = CollectionStatistics::build(
+            sample, collection->numRecords(opCtx), keys, static_cast<size_t>(numBuckets));
+        uuid = collection->uuid();
+
+        // Plans cached before the statistics existed were not chosen with them.
+        auto& queryInfo = CollectionQueryInfo::get(collection);
+        queryInfo.setCollectionStatistics(stats);
+        queryInfo.clearQueryCache(collection);
+    }
+
+    persistStatistics(opCtx, nss, *uuid, *stats);
+
+    LOGV2_DEBUG(5021425,
+                1,
+                "Built collection statistics",
+                "namespace"_attr = nss,
+                "keys"_attr = keys,
+                "numSampled"_attr = numSampled);
+
+    result.append("numSampled", static_cast<long long>(numSampled));
+    return true;
+}
+
+}  // namespace mongo
@@ -37,11 +37,13 @@
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/count.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/query/collection_query_info.h"
 #include "mongo/db/query/count_command_as_aggregation_command.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_result_cache.h"
 #include "mongo/db/query/view_response_formatter.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/views/resolved_view.h"
@@ -211,6 +213,11 @@ public:
                     AutoGetCollection::ViewMode::kViewsPermitted);
         const auto& nss = ctx->getNss();
 
+        // If the namespace is opted in to the result cache, note its epoch before anything opens a
+        // storage snapshot, so that a count read from a snapshot which predates a concurrent write
+        // is not cached.
+        const auto resultCacheEpoch = QueryResultCache::get(opCtx).getEpoch(nss);
+
         CurOpFailpointHelpers::waitWhileFailPointEnabled(
             &hangBeforeCollectionCount, opCtx, "hangBeforeCollectionCount", []() {}, false, nss);
 
@@ -245,13 +252,34 @@ public:
                 ->getOwnershipFilter(
                     opCtx, CollectionShardingState::OrphanCleanupPolicy::kDisallowOrphanCleanup);
 
+        auto expCtx = makeExpressionContextForGetExecutor(
+            opCtx, request.getCollation().value_or(BSONObj()), nss);
+
+        // Answer from the result cache if an identical count has been cached since the last write
+        // to the collection.
+        boost::optional<std::string> resultCacheKey;
+        if (resultCacheEpoch && collection) {
+            auto swFilter =
+                MatchExpressionParser::parse(request.getQuery(),
+                                             expCtx,
+                                             ExtensionsCallbackNoop(),
+                                             MatchExpressionParser::kAllowAllSpecialFeatures);
+            if (swFilter.isOK() &&
+                QueryResultCache::isCacheableCount(opCtx, nss, *swFilter.getValue())) {
+                resultCacheKey = QueryResultCache::computeCountKey(request);
+                if (auto cached = QueryResultCache::get(opCtx).lookup(nss, *resultCacheKey)) {
+                    {
+                        stdx::lock_guard<Client> lk(*opCtx->getClient());
+                        CurOp::get(opCtx)->setPlanSummary_inlock("QUERY_RESULT_CACHE"_sd);
+                    }
+                    result.appendElements(cached->docs.front());
+                    return true;
+                }
+            }
+        }
+
         auto statusWithPlanExecutor =
-            getExecutorCount(makeExpressionContextForGetExecutor(
-                                 opCtx, request.getCollation().value_or(BSONObj()), nss),
-                             collection,
-                             request,
-                             false /*explain*/,
-                             nss);
+            getExecutorCount(expCtx, collection, request, false /*explain*/, nss);
         uassertStatusOK(statusWithPlanExecutor.getStatus());
 
         auto exec = std::move(statusWithPlanExecutor.getValue());
@@ -282,6 +310,16 @@ public:
         auto* countStats = static_cast<const CountStats*>(exec->getRootStage()->getSpecificStats());
 
         result.appendNumber("n", countStats->nCounted);
+
+        if (resultCacheKey) {
+            QueryResultCache::CachedResult resultToCache;
+            BSONObjBuilder cachedBob;
+            cachedBob.appendNumber("n", countStats->nCounted);
+            resultToCache.docs.push_back(cachedBob.obj());
+            resultToCache.sizeBytes = resultToCache.docs.front().objsize();
+            QueryResultCache::get(opCtx).add(
+                nss, std::move(*resultCacheKey), *resultCacheEpoch, std::move(resultToCache));
+        }
         return true;
     }
 
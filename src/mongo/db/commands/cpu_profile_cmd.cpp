@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/commands.h"
+#include "mongo/util/cpu_profiler.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Admin command returning the folded stacks aggregated by the CPU profiler:
+ *
+ *   {cpuProfile: 1, maxStacks: <number, optional>, reset: <bool, optional>}
+ *
+ * With 'reset', the samples are discarded after being reported, so that successive invocations
+ * return the profile of the interval between them.
+ */
+class CmdCpuProfile : public BasicCommand {
+public:
+    CmdCpuProfile() : BasicCommand("cpuProfile") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "return the stacks sampled by the CPU profiler, in folded format";
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const final {
+        bool isAuthorized = AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+            ResourcePattern::forClusterResource(), ActionType::serverStatus);
+        return isAuthorized ? Status::OK() : Status(ErrorCodes::Unauthorized, "Unauthorized");
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        long long maxStacks = kDefaultMaxStacks;
+        if (auto maxStacksElem = cmdObj["maxStacks"]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "'maxStacks' must be a number",
+                    maxStacksElem.isNumber());
+            maxStacks = maxStacksElem.safeNumberLong();
+            uassert(ErrorCodes::BadValue, "'maxStacks' must be positive", maxStacks > 0);
+        }
+
+        CpuProfiler::report(&result, maxStacks, cmdObj["reset"].trueValue());
+        return true;
+    }
+
+private:
+    static constexpr long long kDefaultMaxStacks = 1000;
+
+} cmdCpuProfile;
+
+}  // namespace
+}  // namespace mongo
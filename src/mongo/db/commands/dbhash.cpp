@@ -52,14 +52,42 @@
 #include "mongo/db/transaction_participant.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/util/hex.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/timer.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
 
 namespace mongo {
 
 namespace {
 
+// How often to check for interrupts while hashing a collection without a plan executor.
+const long long kInterruptIntervalNumRecords = 4096;
+
+/**
+ * An order-independent hash of a set of documents: the sum, lane by lane and modulo 2^64, of the
+ * 128-bit MurmurHash3 of each document's BSON. Because addition is commutative, documents can be
+ * hashed in any order, and the hashes of disjoint sets of documents can be added together to get
+ * the hash of their union.
+ */
+class UnorderedHash {
+public:
+    void add(const char* data, int size) {
+        uint64_t docHash[2];
+        MurmurHash3_x64_128(data, size, 0, docHash);
+        _sum[0] += docHash[0];
+        _sum[1] += docHash[1];
+    }
+
+    std::string toString() const {
+        return toHexLower(_sum, sizeof(_sum));
+    }
+
+private:
+    uint64_t _sum[2] = {0, 0};
+};
+
 class DBHashCmd : public ErrmsgCommandDeprecated {
 public:
     DBHashCmd() : ErrmsgCommandDeprecated("dbHash", "dbhash") {}
@@ -132,6 +160,10 @@ public:
             }
         }
 
+        // With {unordered: true}, each collection is hashed by a scan of its record store in
+        // whatever order the records are stored, rather than in _id order.
+        const bool unordered = cmdObj["unordered"].trueValue();
+
         const std::string ns = parseNs(dbname, cmdObj);
         uassert(ErrorCodes::InvalidNamespace,
                 str::stream() << "Invalid db name: " << ns,
@@ -268,7 +300,8 @@ public:
             }
 
             // Compute the hash for this collection.
-            std::string hash = _hashCollection(opCtx, db, collNss);
+            std::string hash = unordered ? _hashCollectionUnordered(opCtx, db, collNss)
+                                         : _hashCollection(opCtx, db, collNss);
 
             collectionToHashMap[collNss.coll().toString()] = hash;
 
@@ -314,13 +347,17 @@ public:
     }
 
 private:
-    std::string _hashCollection(OperationContext* opCtx, Database* db, const NamespaceString& nss) {
-
+    /**
+     * Returns the collection 'nss', after checking that it can be read at the snapshot this
+     * command reads from.
+     */
+    Collection* _getCollectionToHash(OperationContext* opCtx,
+                                     Database* db,
+                                     const NamespaceString& nss) {
         Collection* collection =
             CollectionCatalog::get(opCtx).lookupCollectionByNamespace(opCtx, nss);
         invariant(collection);
 
-        boost::optional<Lock::CollectionLock> collLock;
         if (opCtx->recoveryUnit()->getTimestampReadSource() ==
             RecoveryUnit::ReadSource::kProvided) {
             // When performing a read at a timestamp, we are only holding the database lock in
@@ -344,6 +381,12 @@ private:
             invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_S));
         }
 
+        return collection;
+    }
+
+    std::string _hashCollection(OperationContext* opCtx, Database* db, const NamespaceString& nss) {
+        Collection* collection = _getCollectionToHash(opCtx, db, nss);
+
         auto desc = collection->getIndexCatalog()->findIdIndex(opCtx);
 
         std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
@@ -393,6 +436,37 @@ private:
         return hash;
     }
 
+    /**
+     * Hashes the documents in 'nss' with an UnorderedHash. The record store is read directly in
+     * storage order, so no index is needed and collections without an _id index can be hashed
+     * too.
+     */
+    std::string _hashCollectionUnordered(OperationContext* opCtx,
+                                         Database* db,
+                                         const NamespaceString& nss) {
+        Collection* collection = _getCollectionToHash(opCtx, db, nss);
+
+        UnorderedHash hash;
+        try {
+            auto cursor = collection->getCursor(opCtx);
+            long long n = 0;
+            while (auto record = cursor->next()) {
+                hash.add(record->data.data(), record->data.size());
+                if (++n % kInterruptIntervalNumRecords == 0) {
+                    opCtx->checkForInterrupt();
+                }
+            }
+        } catch (DBException& exception) {
+            LOGV2_WARNING(4798612,
+                          "Error while hashing, db possibly dropped",
+                          "namespace"_attr = nss);
+            exception.addContext("Error while running dbHash command with {unordered: true}");
+            throw;
+        }
+
+        return hash.toString();
+    }
+
 } dbhashCmd;
 
 }  // namespace
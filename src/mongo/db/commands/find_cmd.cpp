@@ -48,6 +48,8 @@
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_result_cache.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
@@ -121,6 +123,34 @@ boost::intrusive_ptr<ExpressionContext> makeExpressionContext(
     return expCtx;
 }
 
+/**
+ * Builds the response to a find from a result held by the QueryResultCache. The cached result is
+ * always a complete, single batch, so no cursor is returned.
+ */
+void replyFromResultCache(OperationContext* opCtx,
+                          const NamespaceString& nss,
+                          const QueryResultCache::CachedResult& cached,
+                          rpc::ReplyBuilderInterface* result) {
+    {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        CurOp::get(opCtx)->setPlanSummary_inlock("QUERY_RESULT_CACHE"_sd);
+    }
+
+    CursorResponseBuilder::Options options;
+    options.isInitialResponse = true;
+    CursorResponseBuilder firstBatch(result, options);
+    for (auto&& doc : cached.docs) {
+        firstBatch.append(doc);
+    }
+
+    auto curOp = CurOp::get(opCtx);
+    curOp->debug().nreturned = cached.docs.size();
+    curOp->debug().cursorid = -1;
+    curOp->debug().cursorExhausted = true;
+
+    firstBatch.done(0, nss.ns());
+}
+
 /**
  * A command for running .find() queries.
  */
@@ -362,6 +392,11 @@ public:
                         AutoGetCollection::ViewMode::kViewsPermitted);
             const auto& nss = ctx->getNss();
 
+            // If the namespace is opted in to the result cache, note its epoch before anything
+            // opens a storage snapshot, so that a result read from a snapshot which predates a
+            // concurrent write is not cached.
+            const auto resultCacheEpoch = QueryResultCache::get(opCtx).getEpoch(nss);
+
             qr->refreshNSS(opCtx);
 
             // Check whether we are allowed to read from this node after acquiring our locks.
@@ -410,6 +445,17 @@ public:
 
             Collection* const collection = ctx->getCollection();
 
+            // Answer from the result cache if an identical query has been cached since the last
+            // write to the collection.
+            boost::optional<std::string> resultCacheKey;
+            if (resultCacheEpoch && collection && QueryResultCache::isCacheable(opCtx, *cq)) {
+                resultCacheKey = QueryResultCache::computeKey(*cq);
+                if (auto cached = QueryResultCache::get(opCtx).lookup(nss, *resultCacheKey)) {
+                    replyFromResultCache(opCtx, nss, *cached, result);
+                    return;
+                }
+            }
+
             if (cq->getQueryRequest().isReadOnce()) {
                 // The readOnce option causes any storage-layer cursors created during plan
                 // execution to assume read data will not be needed again and need not be cached.
@@ -452,6 +498,12 @@ public:
             PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
             std::uint64_t numResults = 0;
 
+            // Owned copies of the first batch, kept if the result may be added to the cache.
+            boost::optional<QueryResultCache::CachedResult> resultToCache;
+            if (resultCacheKey) {
+                resultToCache.emplace();
+            }
+
             try {
                 while (!FindCommon::enoughForFirstBatch(originalQR, numResults) &&
                        PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
@@ -468,6 +520,17 @@ public:
                     // Add result to output buffer.
                     firstBatch.append(obj);
                     numResults++;
+
+                    if (resultToCache) {
+                        resultToCache->sizeBytes += obj.objsize();
+                        if (resultToCache->sizeBytes >
+                            static_cast<size_t>(
+                                internalQueryResultCacheMaxEntrySizeBytes.load())) {
+                            resultToCache.reset();
+                        } else {
+                            resultToCache->docs.push_back(obj.getOwned());
+                        }
+                    }
                 }
             } catch (DBException& exception) {
                 firstBatch.abandon();
@@ -519,6 +582,14 @@ public:
                 endQueryOp(opCtx, collection, *cursorExec, numResults, cursorId);
             } else {
                 endQueryOp(opCtx, collection, *exec, numResults, cursorId);
+
+                // The whole result fit in the first batch, so it can be served from the cache.
+                if (resultToCache) {
+                    QueryResultCache::get(opCtx).add(nss,
+                                                     std::move(*resultCacheKey),
+                                                     *resultCacheEpoch,
+                                                     std::move(*resultToCache));
+                }
             }
 
             // Generate the response object to send to the client.
@@ -37,6 +37,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_state.h"
+#include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 
@@ -82,6 +83,10 @@ public:
              BSONObjBuilder& result) {
         auto lockToClientMap = LockManager::getLockToClientMap(opCtx->getServiceContext());
         getGlobalLockManager()->getLockInfoBSON(lockToClientMap, &result);
+
+        BSONArrayBuilder contendedBuilder(result.subarrayStart("topContendedResources"));
+        reportTopContendedResources(&contendedBuilder, LockContentionSampler::kNumSlots);
+        contendedBuilder.done();
         return true;
     }
 } cmdLockInfo;
@@ -124,6 +124,45 @@ public:
             return true;
         }
 
+        bool supportsReadMirroring() const override {
+            // Only mirror pipelines that read a collection and nothing else. Pipelines starting
+            // with an initial source (e.g. $mergeCursors or $currentOp) don't scan the collection,
+            // and change streams and exchanges keep state that a mirrored copy must not touch.
+            return !_aggregationRequest.getExplain() &&
+                !_aggregationRequest.getExchangeSpec() &&
+                !_aggregationRequest.getNamespaceString().isCollectionlessAggregateNS() &&
+                !_liteParsedPipeline.startsWithInitialSource() &&
+                !_liteParsedPipeline.hasChangeStream() &&
+                !Pipeline::aggHasWriteStage(_request.body);
+        }
+
+        void appendMirrorableRequest(BSONObjBuilder* bob) const override {
+            // Filter the keys that can be mirrored
+            static const auto kMirrorableKeys = [] {
+                BSONObjBuilder keyBob;
+                keyBob.append(AggregationRequest::kCommandName, 1);
+                keyBob.append(AggregationRequest::kCollationName, 1);
+                keyBob.append(AggregationRequest::kHintName, 1);
+                keyBob.append(AggregationRequest::kAllowDiskUseName, 1);
+                keyBob.append(AggregationRequest::kLetName, 1);
+                return keyBob.obj();
+            }();
+
+            _request.body.filterFieldsUndotted(bob, kMirrorableKeys, true);
+
+            // Limit the result to a single document so that the first batch exhausts the cursor
+            // and nothing is left open on the secondary. Blocking stages still read their whole
+            // input, which is what warms the secondary's cache.
+            {
+                BSONArrayBuilder pipelineBob(bob->subarrayStart(AggregationRequest::kPipelineName));
+                for (auto&& stage : _request.body[AggregationRequest::kPipelineName].Obj()) {
+                    pipelineBob.append(stage);
+                }
+                pipelineBob.append(BSON("$limit" << 1));
+            }
+            bob->append(AggregationRequest::kCursorName, BSONObj());
+        }
+
         void run(OperationContext* opCtx, rpc::ReplyBuilderInterface* reply) override {
             CommandHelpers::handleMarkKillOnClientDisconnect(
                 opCtx, !Pipeline::aggHasWriteStage(_request.body));
@@ -161,7 +200,8 @@ public:
                         ->isAuthorizedForPrivileges(_privileges));
         }
 
-        const OpMsgRequest& _request;
+        // Held by value, since mirroring may read it after the command has returned.
+        const OpMsgRequest _request;
         const std::string _dbName;
         const AggregationRequest _aggregationRequest;
         const LiteParsedPipeline _liteParsedPipeline;
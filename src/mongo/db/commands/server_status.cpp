@@ -164,6 +164,19 @@ public:
         return true;
     }
 
+    void appendSections(OperationContext* opCtx,
+                        const std::vector<std::string>& sectionNames,
+                        const BSONObj& config,
+                        BSONObjBuilder* result) const {
+        for (const auto& name : sectionNames) {
+            auto it = _sections.find(name);
+            if (it == _sections.end()) {
+                continue;
+            }
+            it->second->appendSection(opCtx, config[name], result);
+        }
+    }
+
     void addSection(ServerStatusSection* section) {
         // Disallow adding a section named "timing" as it is reserved for the server status command.
         dassert(section->getSectionName() != kTimingSection);
@@ -201,6 +214,13 @@ ServerStatusSection::ServerStatusSection(const string& sectionName) : _sectionNa
     CmdServerStatusInstantiator::getInstance().addSection(this);
 }
 
+void appendServerStatusSections(OperationContext* opCtx,
+                                const std::vector<std::string>& sectionNames,
+                                const BSONObj& config,
+                                BSONObjBuilder* result) {
+    CmdServerStatusInstantiator::getInstance().appendSections(opCtx, sectionNames, config, result);
+}
+
 OpCounterServerStatusSection::OpCounterServerStatusSection(const string& sectionName,
                                                            OpCounters* counters)
     : ServerStatusSection(sectionName), _counters(counters) {}
@@ -34,6 +34,7 @@
 #include "mongo/db/stats/counters.h"
 #include "mongo/platform/atomic_word.h"
 #include <string>
+#include <vector>
 
 namespace mongo {
 
@@ -121,4 +122,18 @@ public:
 private:
     const OpCounters* _counters;
 };
+
+/**
+ * Appends the named serverStatus sections to 'result', as the serverStatus command does when they
+ * are requested with the elements of the same name in 'config'. Unknown names are skipped and no
+ * privileges are checked.
+ *
+ * Lets internal consumers like FTDC sample a few sections without building the whole serverStatus
+ * reply.
+ */
+void appendServerStatusSections(OperationContext* opCtx,
+                                const std::vector<std::string>& sectionNames,
+                                const BSONObj& config,
+                                BSONObjBuilder* result);
+
 }  // namespace mongo
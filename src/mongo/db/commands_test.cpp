@@ -401,5 +401,26 @@ TEST_F(TypedCommandTest, runThrowStatus) {
     });
 }
 
+TEST(CommandReplySizeTest, ReservesForRecentReplySizes) {
+    ASSERT_EQ(exampleMinimalCommand.bytesToReserveForReply(), 0u);
+
+    exampleMinimalCommand.noteReplySize(1000);
+    ASSERT_EQ(exampleMinimalCommand.bytesToReserveForReply(), 1000u);
+
+    // Replies that are only somewhat smaller keep the larger reservation.
+    exampleMinimalCommand.noteReplySize(600);
+    ASSERT_EQ(exampleMinimalCommand.bytesToReserveForReply(), 1000u);
+
+    exampleMinimalCommand.noteReplySize(100);
+    ASSERT_EQ(exampleMinimalCommand.bytesToReserveForReply(), 100u);
+
+    // Very large replies are not worth reserving for in full.
+    exampleMinimalCommand.noteReplySize(16 * 1024 * 1024);
+    ASSERT_EQ(exampleMinimalCommand.bytesToReserveForReply(), 16u * 1024);
+
+    exampleMinimalCommand.noteReplySize(0);
+    ASSERT_EQ(exampleMinimalCommand.bytesToReserveForReply(), 0u);
+}
+
 }  // namespace
 }  // namespace mongo
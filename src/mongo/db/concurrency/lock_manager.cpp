@@ -413,9 +413,10 @@ void LockHead::migratePartitionedLockHeads() {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
-// Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+// Balance scalability of intent locks against potential added cost of conflicting locks. Only the
+// partitions a resource was actually locked in are visited when its intent locks are migrated, so
+// having as many partitions as buckets costs little. Should be power of two.
+const unsigned LockManager::_numPartitions = 128;
 
 // static
 std::map<LockerId, BSONObj> LockManager::getLockToClientMap(ServiceContext* serviceContext) {
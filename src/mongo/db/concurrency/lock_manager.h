@@ -42,8 +42,9 @@
 #include "mongo/platform/compiler.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
-#include "mongo/stdx/unordered_map.h"
+#include "mongo/stdx/new.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/flat_hash_map.h"
 
 namespace mongo {
 
@@ -155,11 +156,12 @@ private:
     // The lockheads need access to the partitions
     friend struct LockHead;
 
-    // These types describe the locks hash table
+    // These types describe the locks hash table. Buckets and partitions are cache aligned, so that
+    // threads using different ones do not contend on the same cache line.
 
-    struct LockBucket {
+    struct alignas(stdx::hardware_destructive_interference_size) LockBucket {
         SimpleMutex mutex;
-        typedef stdx::unordered_map<ResourceId, LockHead*> Map;
+        typedef FlatHashMap<ResourceId, LockHead*> Map;
         Map data;
         LockHead* findOrInsert(ResourceId resId);
     };
@@ -167,10 +169,10 @@ private:
     // Each locker maps to a partition that is used for resources acquired in intent modes
     // modes and potentially other modes that don't conflict with themselves. This avoids
     // contention on the regular LockHead in the lock manager.
-    struct Partition {
+    struct alignas(stdx::hardware_destructive_interference_size) Partition {
         PartitionedLockHead* find(ResourceId resId);
         PartitionedLockHead* findOrInsert(ResourceId resId);
-        typedef stdx::unordered_map<ResourceId, PartitionedLockHead*> Map;
+        typedef FlatHashMap<ResourceId, PartitionedLockHead*> Map;
         SimpleMutex mutex;
         Map data;
     };
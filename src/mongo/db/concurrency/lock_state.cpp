@@ -37,7 +37,9 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/json.h"
+#include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/concurrency/flow_control_ticketholder.h"
+#include "mongo/db/concurrency/lock_stats_gen.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/flow_control.h"
@@ -131,6 +133,24 @@ AtomicWord<unsigned long long> idCounter(0);
 // indexed by LockerId in order to minimize concurrent access conflicts.
 PartitionedInstanceWideLockStats globalStats;
 
+// Distribution of the total time each lock acquisition spent waiting, across all Locker instances.
+LockWaitHistograms globalWaitHistograms;
+
+// Sampled lock waits, attributed to the individual resource being waited on.
+LockContentionSampler globalContentionSampler;
+
+// Counts lock waits in order to pick those sampled by globalContentionSampler.
+AtomicWord<unsigned long long> waitSampleCounter(0);
+
+void recordCompletedWait(ResourceId resId, LockMode mode, uint64_t waitMicros) {
+    globalWaitHistograms.record(resId, mode, waitMicros);
+
+    const int samplingRate = gLockContentionSamplingRate.load();
+    if (samplingRate > 0 && waitSampleCounter.fetchAndAdd(1) % samplingRate == 0) {
+        globalContentionSampler.record(resId, mode, waitMicros);
+    }
+}
+
 }  // namespace
 
 bool LockerImpl::_shouldDelayUnlock(ResourceId resId, LockMode mode) const {
@@ -310,6 +330,26 @@ LockerImpl::~LockerImpl() {
     _stats.reset();
 }
 
+void LockerImpl::reset() {
+    invariant(!inAWriteUnitOfWork());
+    invariant(_numResourcesToUnlockAtEndUnitOfWork == 0);
+    invariant(_requests.empty());
+    invariant(_modeForTicket == MODE_NONE);
+    invariant(_uninterruptibleLocksRequested == 0);
+    invariant(!_waitingResource.isValid());
+
+    _notify.clear();
+    _stats.reset();
+    _clientState.store(kInactive);
+    _threadId = stdx::this_thread::get_id();
+    _sharedLocksShouldTwoPhaseLock = false;
+    _maxLockTimeout = boost::none;
+    _flowControlStats = FlowControlTicketholder::CurOp();
+    _globalLockMode = (1 << MODE_NONE);
+    _wasGlobalLockTakenInModeConflictingWithWrites.store(false);
+    _resetSettings();
+}
+
 Locker::ClientState LockerImpl::getClientState() const {
     auto state = _clientState.load();
     if (state == kActiveReader && hasLockPending())
@@ -360,9 +400,10 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
             invariant(!opCtx->recoveryUnit()->isTimestamped());
 
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+        const auto priority = opCtx ? opCtx->getAdmissionPriority() : AdmissionPriority::kNormal;
         if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+            holder->waitForTicket(interruptible, priority);
+        } else if (!holder->waitForTicketUntil(interruptible, deadline, priority)) {
             return false;
         }
         restoreStateOnErrorGuard.dismiss();
@@ -929,6 +970,10 @@ void LockerImpl::_lockComplete(OperationContext* opCtx,
     const uint64_t startOfTotalWaitTime = curTimeMicros64();
     uint64_t startOfCurrentWaitTime = startOfTotalWaitTime;
 
+    // Account for the total wait of this acquisition, whether it is granted or times out.
+    ON_BLOCK_EXIT(
+        [&] { recordCompletedWait(resId, mode, curTimeMicros64() - startOfTotalWaitTime); });
+
     while (true) {
         // It is OK if this call wakes up spuriously, because we re-evaluate the remaining
         // wait time anyways.
@@ -1098,8 +1143,27 @@ void reportGlobalLockingStats(SingleThreadedLockStats* outStats) {
     globalStats.report(outStats);
 }
 
+void reportGlobalLockWaitHistograms(BSONObjBuilder* builder) {
+    globalWaitHistograms.report(builder);
+}
+
+void reportTopContendedResources(BSONArrayBuilder* builder, size_t limit) {
+    for (const auto& entry : globalContentionSampler.getTopContended(limit)) {
+        boost::optional<std::string> ns;
+        const auto type = entry.resId.getType();
+        if (type == RESOURCE_DATABASE || type == RESOURCE_COLLECTION) {
+            ns = CollectionCatalog::get(getGlobalServiceContext()).lookupResourceName(entry.resId);
+        }
+
+        BSONObjBuilder entryBuilder(builder->subobjStart());
+        entry.report(&entryBuilder, ns.get_ptr());
+    }
+}
+
 void resetGlobalLockStats() {
     globalStats.reset();
+    globalWaitHistograms.reset();
+    globalContentionSampler.reset();
 }
 
 // Hardcoded resource IDs.
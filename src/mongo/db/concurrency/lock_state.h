@@ -102,6 +102,13 @@ public:
 
     virtual ~LockerImpl();
 
+    /**
+     * Returns this locker to the state of a newly constructed one, so that the next operation of
+     * the same Client can use it without allocating memory. The memory for lock requests is kept
+     * and so is the identifier. Must not be holding any locks or be in a write unit of work.
+     */
+    void reset();
+
     virtual ClientState getClientState() const;
 
     virtual LockerId getId() const {
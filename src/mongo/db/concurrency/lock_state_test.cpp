@@ -714,6 +714,51 @@ TEST_F(LockerImplTest, DefaultLocker) {
     ASSERT(locker.unlockGlobal());
 }
 
+TEST_F(LockerImplTest, ResetRestoresStateOfNewLocker) {
+    auto opCtx = makeOperationContext();
+
+    const ResourceId resIdDatabase(RESOURCE_DATABASE, "TestDB"_sd);
+    const ResourceId resIdCollection(RESOURCE_COLLECTION, "TestDB.collection"_sd);
+
+    LockerImpl locker;
+    const auto id = locker.getId();
+    locker.setSharedLocksShouldTwoPhaseLock(true);
+    locker.setMaxLockTimeout(Milliseconds(100));
+    locker.setShouldConflictWithSecondaryBatchApplication(false);
+    locker.skipAcquireTicket();
+    locker.setDebugInfo("debug");
+
+    locker.lockGlobal(opCtx.get(), MODE_IX);
+    locker.lock(resIdDatabase, MODE_IX);
+    locker.lock(resIdCollection, MODE_IX);
+    ASSERT(locker.unlock(resIdCollection));
+    ASSERT(locker.unlock(resIdDatabase));
+    ASSERT(locker.unlockGlobal());
+    ASSERT(locker.wasGlobalLockTaken());
+
+    locker.reset();
+
+    ASSERT_EQ(id, locker.getId());
+    ASSERT_FALSE(locker.hasMaxLockTimeout());
+    ASSERT(locker.shouldConflictWithSecondaryBatchApplication());
+    ASSERT(locker.shouldAcquireTicket());
+    ASSERT_EQ("", locker.getDebugInfo());
+    ASSERT_FALSE(locker.wasGlobalLockTaken());
+    ASSERT(locker.getClientState() == Locker::kInactive);
+
+    Locker::LockerInfo info;
+    locker.getLockerInfo(&info, boost::none);
+    ASSERT(info.locks.empty());
+    ASSERT_EQ(0, info.stats.get(resourceIdGlobal, MODE_IX).numAcquisitions);
+
+    // Shared locks are released at once again.
+    locker.lockGlobal(opCtx.get(), MODE_IS);
+    locker.lock(resIdDatabase, MODE_IS);
+    ASSERT(locker.unlock(resIdDatabase));
+    ASSERT(locker.isLockHeldForMode(resIdDatabase, MODE_NONE));
+    ASSERT(locker.unlockGlobal());
+}
+
 TEST_F(LockerImplTest, SharedLocksShouldTwoPhaseLockIsTrue) {
     // Test that when setSharedLocksShouldTwoPhaseLock is true and we are in a WUOW, unlock on IS
     // and S locks are postponed until endWriteUnitOfWork() is called. Mode IX and X locks always
@@ -31,7 +31,10 @@
 
 #include "mongo/db/concurrency/lock_stats.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
 
 namespace mongo {
 
@@ -131,6 +134,192 @@ void LockStats<CounterType>::reset() {
 }
 
 
+
+LockWaitHistograms::LockWaitHistograms() {
+    reset();
+}
+
+int LockWaitHistograms::getBucket(uint64_t waitMicros) {
+    if (waitMicros == 0) {
+        return 0;
+    }
+
+    const int log2 = 63 - countLeadingZeros64(waitMicros);
+    return std::min(log2 + 1, kNumBuckets - 1);
+}
+
+uint64_t LockWaitHistograms::getBucketLowerBound(int bucket) {
+    return bucket == 0 ? 0 : 1ULL << (bucket - 1);
+}
+
+void LockWaitHistograms::record(ResourceId resId, LockMode mode, uint64_t waitMicros) {
+    Histogram& histogram = _get(resId, mode);
+    histogram.buckets[getBucket(waitMicros)].addAndFetch(1);
+    histogram.sumMicros.addAndFetch(waitMicros);
+}
+
+void LockWaitHistograms::report(BSONObjBuilder* builder) const {
+    // Position 0 is the sentinel value for invalid resource/no lock, so it is not reported.
+    for (int i = 1; i < ResourceTypesCount; i++) {
+        _report(builder, resourceTypeName(static_cast<ResourceType>(i)), _histograms[i]);
+    }
+
+    _report(builder, "oplog", _oplogHistograms);
+}
+
+void LockWaitHistograms::_report(BSONObjBuilder* builder,
+                                 const char* resourceTypeName,
+                                 const PerModeHistograms& histograms) const {
+    std::unique_ptr<BSONObjBuilder> section;
+
+    for (int mode = 1; mode < LockModesCount; mode++) {
+        const Histogram& histogram = histograms.modeHistograms[mode];
+
+        long long numWaits = 0;
+        for (int bucket = 0; bucket < kNumBuckets; bucket++) {
+            numWaits += histogram.buckets[bucket].load();
+        }
+
+        if (numWaits == 0) {
+            continue;
+        }
+
+        if (!section) {
+            section.reset(new BSONObjBuilder(builder->subobjStart(resourceTypeName)));
+        }
+
+        BSONObjBuilder modeBuilder(
+            section->subobjStart(legacyModeName(static_cast<LockMode>(mode))));
+        {
+            BSONArrayBuilder arrayBuilder(modeBuilder.subarrayStart("histogram"));
+            for (int bucket = 0; bucket < kNumBuckets; bucket++) {
+                long long count = histogram.buckets[bucket].load();
+                if (count == 0) {
+                    continue;
+                }
+
+                BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+                entryBuilder.append("micros", static_cast<long long>(getBucketLowerBound(bucket)));
+                entryBuilder.append("count", count);
+            }
+        }
+        modeBuilder.append("waits", numWaits);
+        modeBuilder.append("timeAcquiringMicros", histogram.sumMicros.load());
+    }
+}
+
+void LockWaitHistograms::reset() {
+    auto resetHistograms = [](PerModeHistograms& histograms) {
+        for (int mode = 0; mode < LockModesCount; mode++) {
+            Histogram& histogram = histograms.modeHistograms[mode];
+            for (int bucket = 0; bucket < kNumBuckets; bucket++) {
+                histogram.buckets[bucket].store(0);
+            }
+            histogram.sumMicros.store(0);
+        }
+    };
+
+    for (int i = 0; i < ResourceTypesCount; i++) {
+        resetHistograms(_histograms[i]);
+    }
+
+    resetHistograms(_oplogHistograms);
+}
+
+
+long long LockContentionSampler::Entry::totalWaitMicros() const {
+    long long total = overestimateMicros;
+    for (int mode = 0; mode < LockModesCount; mode++) {
+        total += waitMicros[mode];
+    }
+    return total;
+}
+
+void LockContentionSampler::Entry::report(BSONObjBuilder* builder, const std::string* ns) const {
+    builder->append("resource", resId.toString());
+    builder->append("type", resourceTypeName(resId.getType()));
+    if (ns) {
+        builder->append("ns", *ns);
+    }
+
+    {
+        BSONObjBuilder numWaitsBuilder(builder->subobjStart("acquireWaitCount"));
+        for (int mode = 1; mode < LockModesCount; mode++) {
+            if (numWaits[mode] > 0) {
+                numWaitsBuilder.append(legacyModeName(static_cast<LockMode>(mode)), numWaits[mode]);
+            }
+        }
+    }
+
+    {
+        BSONObjBuilder waitMicrosBuilder(builder->subobjStart("timeAcquiringMicros"));
+        for (int mode = 1; mode < LockModesCount; mode++) {
+            if (numWaits[mode] > 0) {
+                waitMicrosBuilder.append(legacyModeName(static_cast<LockMode>(mode)),
+                                         waitMicros[mode]);
+            }
+        }
+    }
+
+    if (overestimateMicros > 0) {
+        builder->append("overestimateMicros", overestimateMicros);
+    }
+}
+
+void LockContentionSampler::record(ResourceId resId, LockMode mode, uint64_t waitMicros) {
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    auto it = std::find_if(
+        _entries.begin(), _entries.end(), [&](const Entry& entry) { return entry.resId == resId; });
+
+    if (it == _entries.end()) {
+        if (_entries.size() < kNumSlots) {
+            it = _entries.emplace(_entries.end());
+        } else {
+            // Evict the least contended resource, charging its wait time to the newcomer so that
+            // recently seen resources are not immediately evicted again.
+            it = std::min_element(
+                _entries.begin(), _entries.end(), [](const auto& a, const auto& b) {
+                    return a.totalWaitMicros() < b.totalWaitMicros();
+                });
+
+            const long long inheritedMicros = it->totalWaitMicros();
+            *it = Entry();
+            it->overestimateMicros = inheritedMicros;
+        }
+
+        it->resId = resId;
+    }
+
+    it->numWaits[mode]++;
+    it->waitMicros[mode] += waitMicros;
+}
+
+std::vector<LockContentionSampler::Entry> LockContentionSampler::getTopContended(
+    size_t limit) const {
+    std::vector<Entry> entries;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        entries = _entries;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.totalWaitMicros() > b.totalWaitMicros();
+    });
+
+    if (entries.size() > limit) {
+        entries.resize(limit);
+    }
+
+    return entries;
+}
+
+void LockContentionSampler::reset() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _entries.clear();
+}
+
+
 // Ensures that there are instances compiled for LockStats for AtomicWord<long long> and int64_t
 template class LockStats<int64_t>;
 template class LockStats<AtomicWord<long long>>;
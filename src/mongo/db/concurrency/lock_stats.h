@@ -29,11 +29,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
 
 namespace mongo {
 
+class BSONArrayBuilder;
 class BSONObjBuilder;
 
 
@@ -216,11 +220,132 @@ typedef LockStats<int64_t> SingleThreadedLockStats;
 typedef LockStats<AtomicWord<long long>> AtomicLockStats;
 
 
+/**
+ * Distribution of the time individual lock acquisitions spent waiting before being granted or
+ * timing out, split per resource type and mode like LockStats, with the oplog special-cased.
+ *
+ * Bucket i counts the waits of [2^(i-1), 2^i) microseconds, except for bucket 0 which counts waits
+ * under a microsecond, and the last bucket which counts all the longer ones.
+ */
+class LockWaitHistograms {
+public:
+    static constexpr int kNumBuckets = 26;
+
+    LockWaitHistograms();
+
+    void record(ResourceId resId, LockMode mode, uint64_t waitMicros);
+
+    long long getCount(ResourceId resId, LockMode mode, int bucket) const {
+        return _get(resId, mode).buckets[bucket].load();
+    }
+
+    void report(BSONObjBuilder* builder) const;
+    void reset();
+
+    /**
+     * Returns the bucket into which a wait of 'waitMicros' falls.
+     */
+    static int getBucket(uint64_t waitMicros);
+
+    /**
+     * Returns the smallest wait, in microseconds, which falls into 'bucket'.
+     */
+    static uint64_t getBucketLowerBound(int bucket);
+
+private:
+    struct Histogram {
+        AtomicWord<long long> buckets[kNumBuckets];
+        AtomicWord<long long> sumMicros;
+    };
+
+    struct PerModeHistograms {
+        Histogram modeHistograms[LockModesCount];
+    };
+
+    const Histogram& _get(ResourceId resId, LockMode mode) const {
+        if (resId == resourceIdOplog) {
+            return _oplogHistograms.modeHistograms[mode];
+        }
+
+        return _histograms[resId.getType()].modeHistograms[mode];
+    }
+
+    Histogram& _get(ResourceId resId, LockMode mode) {
+        if (resId == resourceIdOplog) {
+            return _oplogHistograms.modeHistograms[mode];
+        }
+
+        return _histograms[resId.getType()].modeHistograms[mode];
+    }
+
+    void _report(BSONObjBuilder* builder,
+                 const char* resourceTypeName,
+                 const PerModeHistograms& histograms) const;
+
+    PerModeHistograms _histograms[ResourceTypesCount];
+    PerModeHistograms _oplogHistograms;
+};
+
+
+/**
+ * Approximates the set of individual resources on which lock acquisitions spent the most time
+ * waiting, using the space-saving algorithm over a fixed number of slots. When all slots are taken,
+ * the resource with the least wait time is evicted and its totals are inherited by the newcomer,
+ * so a resource's totals may overestimate its actual waits by at most 'overestimateMicros'.
+ *
+ * Only called on the slow path of lock acquisition, after a waiter has already blocked, which is
+ * why a mutex is acceptable here.
+ */
+class LockContentionSampler {
+public:
+    static constexpr size_t kNumSlots = 64;
+
+    struct Entry {
+        long long totalWaitMicros() const;
+
+        /**
+         * Appends this entry's statistics. The namespace is only known to the caller, which can
+         * look it up in the catalog for database and collection resources.
+         */
+        void report(BSONObjBuilder* builder, const std::string* ns) const;
+
+        ResourceId resId;
+        long long numWaits[LockModesCount] = {};
+        long long waitMicros[LockModesCount] = {};
+        long long overestimateMicros = 0;
+    };
+
+    void record(ResourceId resId, LockMode mode, uint64_t waitMicros);
+
+    /**
+     * Returns up to 'limit' entries, in decreasing order of total wait time.
+     */
+    std::vector<Entry> getTopContended(size_t limit) const;
+
+    void reset();
+
+private:
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("LockContentionSampler::_mutex");
+    std::vector<Entry> _entries;
+};
+
+
 /**
  * Reports instance-wide locking statistics, which can then be converted to BSON or logged.
  */
 void reportGlobalLockingStats(SingleThreadedLockStats* outStats);
 
+/**
+ * Reports the instance-wide distribution of lock acquisition wait times.
+ */
+void reportGlobalLockWaitHistograms(BSONObjBuilder* builder);
+
+/**
+ * Appends one document for each of the (at most 'limit') resources with the most sampled lock wait
+ * time, resolving database and collection resources back to their namespace where possible.
+ */
+void reportTopContendedResources(BSONArrayBuilder* builder, size_t limit);
+
 /**
  * Currently used for testing only.
  */
@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/unittest/unittest.h"
@@ -232,4 +233,102 @@ TEST_F(LockStatsTest, ServerStatus) {
                       .getIntField("w"));
 }
 
+TEST_F(LockStatsTest, WaitHistogramAndContendedResources) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.WaitHistogram"));
+
+    resetGlobalLockStats();
+
+    auto opCtx = makeOperationContext();
+    LockerForTests locker(opCtx.get(), MODE_IX);
+    locker.lock(resId, MODE_X);
+
+    {
+        LockerForTests lockerConflict(opCtx.get(), MODE_IX);
+        ASSERT_THROWS_CODE(
+            lockerConflict.lock(opCtx.get(), resId, MODE_S, Date_t::now() + Milliseconds(5)),
+            AssertionException,
+            ErrorCodes::LockTimeout);
+    }
+
+    // The timed out wait lands in a single histogram bucket for collection S locks.
+    BSONObjBuilder histogramsBuilder;
+    reportGlobalLockWaitHistograms(&histogramsBuilder);
+    auto histograms = histogramsBuilder.done();
+    auto modeHistogram = histograms.getObjectField("Collection").getObjectField("R");
+    ASSERT_EQUALS(1, modeHistogram.getIntField("waits"));
+    ASSERT_GREATER_THAN(modeHistogram["timeAcquiringMicros"].numberLong(), 0);
+    auto buckets = modeHistogram["histogram"].Array();
+    ASSERT_EQUALS(1U, buckets.size());
+    ASSERT_EQUALS(1, buckets[0].Obj().getIntField("count"));
+    ASSERT_FALSE(histograms.hasField("Database"));
+
+    // The wait is attributed to the collection resource.
+    BSONArrayBuilder resourcesBuilder;
+    reportTopContendedResources(&resourcesBuilder, 10);
+    auto resources = resourcesBuilder.arr();
+    ASSERT_EQUALS(1, resources.nFields());
+    auto resource = resources[0].Obj();
+    ASSERT_EQUALS("Collection", resource.getStringField("type"));
+    ASSERT_EQUALS(1, resource.getObjectField("acquireWaitCount").getIntField("R"));
+    ASSERT_FALSE(resource.hasField("overestimateMicros"));
+
+    resetGlobalLockStats();
+    BSONArrayBuilder emptyBuilder;
+    reportTopContendedResources(&emptyBuilder, 10);
+    ASSERT_EQUALS(0, emptyBuilder.arr().nFields());
+}
+
+TEST(LockWaitHistogramsTest, Buckets) {
+    ASSERT_EQUALS(0, LockWaitHistograms::getBucket(0));
+    ASSERT_EQUALS(1, LockWaitHistograms::getBucket(1));
+    ASSERT_EQUALS(2, LockWaitHistograms::getBucket(2));
+    ASSERT_EQUALS(2, LockWaitHistograms::getBucket(3));
+    ASSERT_EQUALS(11, LockWaitHistograms::getBucket(1024));
+    ASSERT_EQUALS(LockWaitHistograms::kNumBuckets - 1,
+                  LockWaitHistograms::getBucket(std::numeric_limits<uint64_t>::max()));
+
+    for (int bucket = 0; bucket < LockWaitHistograms::kNumBuckets; bucket++) {
+        const auto lowerBound = LockWaitHistograms::getBucketLowerBound(bucket);
+        ASSERT_EQUALS(bucket, LockWaitHistograms::getBucket(lowerBound));
+    }
+
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockWaitHistograms.Buckets"));
+    LockWaitHistograms histograms;
+    histograms.record(resId, MODE_X, 3);
+    histograms.record(resId, MODE_X, 2);
+    histograms.record(resourceIdOplog, MODE_X, 3);
+    ASSERT_EQUALS(2, histograms.getCount(resId, MODE_X, 2));
+    ASSERT_EQUALS(0, histograms.getCount(resId, MODE_S, 2));
+    ASSERT_EQUALS(1, histograms.getCount(resourceIdOplog, MODE_X, 2));
+}
+
+TEST(LockContentionSamplerTest, EvictsLeastContended) {
+    LockContentionSampler sampler;
+    for (size_t i = 0; i < LockContentionSampler::kNumSlots; i++) {
+        sampler.record(ResourceId(RESOURCE_COLLECTION, i), MODE_X, 100 + i);
+    }
+
+    const ResourceId hot(RESOURCE_COLLECTION, std::string("LockContentionSampler.Hot"));
+    sampler.record(hot, MODE_X, 1000);
+    sampler.record(hot, MODE_IX, 1000);
+
+    auto top = sampler.getTopContended(2);
+    ASSERT_EQUALS(2U, top.size());
+    ASSERT_EQUALS(hot, top[0].resId);
+    ASSERT_EQUALS(1, top[0].numWaits[MODE_X]);
+    ASSERT_EQUALS(1, top[0].numWaits[MODE_IX]);
+
+    // The newcomer took over the slot of the least contended resource and inherited its wait time.
+    ASSERT_EQUALS(100, top[0].overestimateMicros);
+    ASSERT_EQUALS(2100, top[0].totalWaitMicros());
+    ASSERT_EQUALS(ResourceId(RESOURCE_COLLECTION, LockContentionSampler::kNumSlots - 1),
+                  top[1].resId);
+
+    auto all = sampler.getTopContended(LockContentionSampler::kNumSlots * 2);
+    ASSERT_EQUALS(LockContentionSampler::kNumSlots, all.size());
+    for (const auto& entry : all) {
+        ASSERT_NOT_EQUALS(ResourceId(RESOURCE_COLLECTION, 0ULL), entry.resId);
+    }
+}
+
 }  // namespace mongo
@@ -523,6 +523,16 @@ public:
 protected:
     Locker() {}
 
+    /**
+     * Restores the settings of a newly constructed Locker, for implementations which can be
+     * reused by another operation.
+     */
+    void _resetSettings() {
+        _shouldConflictWithSecondaryBatchApplication = true;
+        _shouldAcquireTicket = true;
+        _debugInfo.clear();
+    }
+
     /**
      * The number of callers that are guarding from lock interruptions.
      * When 0, all lock acquisitions are interruptible. When positive, no lock acquisitions are
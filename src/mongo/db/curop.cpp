@@ -84,6 +84,33 @@ TimerStats oplogGetMoreStats;
 ServerStatusMetricField<TimerStats> displayBatchesReceived("repl.network.oplogGetMoresProcessed",
                                                            &oplogGetMoreStats);
 
+/**
+ * Returns the CPU time used so far by the calling thread, or boost::none if the platform does not
+ * support measuring it.
+ */
+boost::optional<Nanoseconds> getThreadCPUTime() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec t;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t) != 0) {
+        return boost::none;
+    }
+    return Nanoseconds(static_cast<long long>(t.tv_sec) * 1000 * 1000 * 1000 + t.tv_nsec);
+#elif defined(_WIN32)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return boost::none;
+    }
+    // FILETIMEs count 100 nanosecond intervals.
+    auto toNanos = [](const FILETIME& t) {
+        return Nanoseconds(
+            100 * ((static_cast<long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime));
+    };
+    return toNanos(kernelTime) + toNanos(userTime);
+#else
+    return boost::none;
+#endif
+}
+
 }  // namespace
 
 BSONObj upconvertQueryEntry(const BSONObj& query,
@@ -434,6 +461,8 @@ TickSource::Tick CurOp::startTime() {
     // that writes to '_start' never race.
     TickSource::Tick unassignedStart = 0;
     invariant(_start.compare_exchange_strong(unassignedStart, _tickSource->getTicks()));
+    _cpuTimeAtStart = getThreadCPUTime();
+    _startThreadId = stdx::this_thread::get_id();
     return _start.load();
 }
 
@@ -444,6 +473,12 @@ void CurOp::done() {
     invariant(!_stack->opCtx() || Client::getCurrent() == _stack->opCtx()->getClient());
 
     _end = _tickSource->getTicks();
+
+    if (_cpuTimeAtStart && _startThreadId == stdx::this_thread::get_id()) {
+        if (auto cpuTime = getThreadCPUTime()) {
+            _debug.cpuTime = *cpuTime - *_cpuTimeAtStart;
+        }
+    }
 }
 
 Microseconds CurOp::computeElapsedTimeTotal(TickSource::Tick startTime,
@@ -468,6 +503,47 @@ void CurOp::raiseDbProfileLevel(int dbProfileLevel) {
     _dbprofile = std::max(dbProfileLevel, _dbprofile);
 }
 
+void CurOp::_fetchStorageStats(OperationContext* opCtx, logv2::LogComponent component) {
+    if (_debug.storageStats == nullptr && opCtx->lockState()->wasGlobalLockTaken() &&
+        opCtx->getServiceContext()->getStorageEngine()) {
+        // Do not fetch operation statistics again if we have already got them (for instance,
+        // as a part of stashing the transaction).
+        // Take a lock before calling into the storage engine to prevent racing against a
+        // shutdown. Any operation that used a storage engine would have at-least held a
+        // global lock at one point, hence we limit our lock acquisition to such operations.
+        // We can get here and our lock acquisition be timed out or interrupted, log a
+        // message if that happens.
+        try {
+            // Retrieving storage stats should not be blocked by oplog application.
+            ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(
+                opCtx->lockState());
+            Lock::GlobalLock lk(opCtx,
+                                MODE_IS,
+                                Date_t::now() + Milliseconds(500),
+                                Lock::InterruptBehavior::kLeaveUnlocked);
+            if (lk.isLocked()) {
+                _debug.storageStats = opCtx->recoveryUnit()->getOperationStatistics();
+            } else {
+                LOGV2_WARNING_OPTIONS(
+                    20525,
+                    {component},
+                    "Failed to gather storage statistics for {opId} due to {reason}",
+                    "Failed to gather storage statistics for slow operation",
+                    "opId"_attr = opCtx->getOpID(),
+                    "error"_attr = "lock acquire timeout"_sd);
+            }
+        } catch (const ExceptionForCat<ErrorCategory::Interruption>& ex) {
+            LOGV2_WARNING_OPTIONS(
+                20526,
+                {component},
+                "Failed to gather storage statistics for {opId} due to {reason}",
+                "Failed to gather storage statistics for slow operation",
+                "opId"_attr = opCtx->getOpID(),
+                "error"_attr = redact(ex));
+        }
+    }
+}
+
 bool CurOp::completeAndLogOperation(OperationContext* opCtx,
                                     logv2::LogComponent component,
                                     boost::optional<size_t> responseLength,
@@ -496,47 +572,21 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
     std::tie(shouldLogSlowOp, shouldSample) = shouldLogSlowOpWithSampling(
         opCtx, component, Milliseconds(executionTimeMillis), Milliseconds(slowMs));
 
-    if (forceLog || shouldLogSlowOp) {
-        auto lockerInfo = opCtx->lockState()->getLockerInfo(_lockStatsBase);
-        if (_debug.storageStats == nullptr && opCtx->lockState()->wasGlobalLockTaken() &&
-            opCtx->getServiceContext()->getStorageEngine()) {
-            // Do not fetch operation statistics again if we have already got them (for instance,
-            // as a part of stashing the transaction).
-            // Take a lock before calling into the storage engine to prevent racing against a
-            // shutdown. Any operation that used a storage engine would have at-least held a
-            // global lock at one point, hence we limit our lock acquisition to such operations.
-            // We can get here and our lock acquisition be timed out or interrupted, log a
-            // message if that happens.
-            try {
-                // Retrieving storage stats should not be blocked by oplog application.
-                ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(
-                    opCtx->lockState());
-                Lock::GlobalLock lk(opCtx,
-                                    MODE_IS,
-                                    Date_t::now() + Milliseconds(500),
-                                    Lock::InterruptBehavior::kLeaveUnlocked);
-                if (lk.isLocked()) {
-                    _debug.storageStats = opCtx->recoveryUnit()->getOperationStatistics();
-                } else {
-                    LOGV2_WARNING_OPTIONS(
-                        20525,
-                        {component},
-                        "Failed to gather storage statistics for {opId} due to {reason}",
-                        "Failed to gather storage statistics for slow operation",
-                        "opId"_attr = opCtx->getOpID(),
-                        "error"_attr = "lock acquire timeout"_sd);
-                }
-            } catch (const ExceptionForCat<ErrorCategory::Interruption>& ex) {
-                LOGV2_WARNING_OPTIONS(
-                    20526,
-                    {component},
-                    "Failed to gather storage statistics for {opId} due to {reason}",
-                    "Failed to gather storage statistics for slow operation",
-                    "opId"_attr = opCtx->getOpID(),
-                    "error"_attr = redact(ex));
-            }
-        }
+    const bool shouldLog = forceLog || shouldLogSlowOp;
+    const bool shouldProfile = shouldDBProfile(shouldSample);
+
+    // Snapshot the lock statistics before locking to fetch the storage statistics.
+    boost::optional<Locker::LockerInfo> lockerInfo;
+    if (shouldLog) {
+        lockerInfo = opCtx->lockState()->getLockerInfo(_lockStatsBase);
+    }
+
+    // Storage statistics are reported by both the slow query log and the profiler.
+    if (shouldLog || shouldProfile) {
+        _fetchStorageStats(opCtx, component);
+    }
 
+    if (shouldLog) {
         // Gets the time spent blocked on prepare conflicts.
         auto prepareConflictDurationMicros =
             PrepareConflictTracker::get(opCtx).getPrepareConflictDuration();
@@ -549,7 +599,7 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
     }
 
     // Return 'true' if this operation should also be added to the profiler.
-    return shouldDBProfile(shouldSample);
+    return shouldProfile;
 }
 
 Command::ReadWriteType CurOp::getReadWriteType() const {
@@ -892,6 +942,10 @@ string OpDebug::report(OperationContext* opCtx, const SingleThreadedLockStats* l
         s << " remoteOpWaitMillis:" << durationCount<Milliseconds>(*remoteOpWaitTime);
     }
 
+    if (cpuTime) {
+        s << " cpuNanos:" << durationCount<Nanoseconds>(*cpuTime);
+    }
+
     s << " " << durationCount<Milliseconds>(executionTime) << "ms";
 
     return s.str();
@@ -1061,6 +1115,10 @@ void OpDebug::report(OperationContext* opCtx,
         pAttrs->add("remoteOpWaitMillis", durationCount<Milliseconds>(*remoteOpWaitTime));
     }
 
+    if (cpuTime) {
+        pAttrs->add("cpuNanos", durationCount<Nanoseconds>(*cpuTime));
+    }
+
     pAttrs->add("durationMillis", durationCount<Milliseconds>(executionTime));
 }
 
@@ -1183,6 +1241,10 @@ void OpDebug::append(OperationContext* opCtx,
         b.append("remoteOpWaitMillis", durationCount<Milliseconds>(*remoteOpWaitTime));
     }
 
+    if (cpuTime) {
+        b.append("cpuNanos", durationCount<Nanoseconds>(*cpuTime));
+    }
+
     b.appendIntOrLL("millis", durationCount<Milliseconds>(executionTime));
 
     if (!curop.getPlanSummary().empty()) {
@@ -40,6 +40,7 @@
 #include "mongo/logv2/attribute_storage.h"
 #include "mongo/logv2/log_component.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/time_support.h"
 
@@ -234,6 +235,8 @@ public:
 
     // response info
     Microseconds executionTime{0};
+    // CPU time used by the thread which executed the operation, if the platform can measure it.
+    boost::optional<Nanoseconds> cpuTime;
     long long nreturned{-1};
     int responseLength{-1};
 
@@ -730,6 +733,11 @@ private:
     Microseconds computeElapsedTimeTotal(TickSource::Tick startTime,
                                          TickSource::Tick endTime) const;
 
+    /**
+     * Fetches the operation's storage statistics into '_debug', unless they were already fetched.
+     */
+    void _fetchStorageStats(OperationContext* opCtx, logv2::LogComponent component);
+
     static const OperationContext::Decoration<CurOpStack> _curopStack;
 
     CurOp(OperationContext*, CurOpStack*);
@@ -744,6 +752,11 @@ private:
     // The time at which this CurOp instance was marked as done or 0 if the CurOp is not yet done.
     std::atomic<TickSource::Tick> _end{0};  // NOLINT
 
+    // The CPU time of the thread which started this CurOp when it was started, and that thread's
+    // id. CPU time is only attributed to the operation if it is marked as done on the same thread.
+    boost::optional<Nanoseconds> _cpuTimeAtStart;
+    stdx::thread::id _startThreadId;
+
     // The time at which this CurOp instance had its timer paused, or 0 if the timer is not
     // currently paused.
     TickSource::Tick _lastPauseTime{0};
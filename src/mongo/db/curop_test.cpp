@@ -262,5 +262,24 @@ TEST(CurOpTest, ElapsedTimeReflectsTickSource) {
     ASSERT_EQ(Milliseconds{20}, duration_cast<Milliseconds>(curop->elapsedTimeTotal()));
 }
 
+TEST(CurOpTest, ReportsCPUTimeOfTheThreadWhichRanTheOperation) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto curop = CurOp::get(*opCtx);
+
+    curop->ensureStarted();
+    ASSERT_FALSE(curop->debug().cpuTime);
+
+    curop->done();
+#if defined(CLOCK_THREAD_CPUTIME_ID) || defined(_WIN32)
+    ASSERT_TRUE(curop->debug().cpuTime);
+    ASSERT_GTE(*curop->debug().cpuTime, Nanoseconds(0));
+
+    BSONObjBuilder builder;
+    curop->debug().append(opCtx.get(), SingleThreadedLockStats(), {}, builder);
+    ASSERT_TRUE(builder.done().hasField("cpuNanos"));
+#endif
+}
+
 }  // namespace
 }  // namespace mongo
@@ -104,7 +104,7 @@ std::pair<Status, int> CursorManager::killCursorsWithMatchingSessions(
 
 CursorManager::CursorManager()
     : _random(std::make_unique<PseudoRandom>(SecureRandom().nextInt64())),
-      _cursorMap(std::make_unique<Partitioned<stdx::unordered_map<CursorId, ClientCursor*>>>()) {}
+      _cursorMap(std::make_unique<Partitioned<CursorMap>>()) {}
 
 CursorManager::~CursorManager() {
     auto allPartitions = _cursorMap->lockAllPartitions();
@@ -384,7 +384,7 @@ void CursorManager::deregisterCursor(ClientCursor* cursor) {
 }
 
 void CursorManager::deregisterAndDestroyCursor(
-    Partitioned<stdx::unordered_map<CursorId, ClientCursor*>, kNumPartitions>::OnePartition&& lk,
+    Partitioned<CursorMap, kNumPartitions>::OnePartition&& lk,
     OperationContext* opCtx,
     std::unique_ptr<ClientCursor, ClientCursor::Deleter> cursor) {
     {
@@ -43,6 +43,7 @@
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/duration.h"
+#include "mongo/util/flat_hash_map.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -187,6 +188,10 @@ public:
 
 private:
     static constexpr int kNumPartitions = 16;
+
+    // Only cursor pointers are stored in the partitions, so they don't need stable addresses.
+    using CursorMap = FlatHashMap<CursorId, ClientCursor*>;
+
     friend class ClientCursorPin;
 
     CursorId allocateCursorId_inlock();
@@ -195,10 +200,9 @@ private:
         OperationContext* opCtx, std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor);
 
     void deregisterCursor(ClientCursor* cursor);
-    void deregisterAndDestroyCursor(
-        Partitioned<stdx::unordered_map<CursorId, ClientCursor*>, kNumPartitions>::OnePartition&&,
-        OperationContext* opCtx,
-        std::unique_ptr<ClientCursor, ClientCursor::Deleter> cursor);
+    void deregisterAndDestroyCursor(Partitioned<CursorMap, kNumPartitions>::OnePartition&&,
+                                    OperationContext* opCtx,
+                                    std::unique_ptr<ClientCursor, ClientCursor::Deleter> cursor);
 
     void unpin(OperationContext* opCtx,
                std::unique_ptr<ClientCursor, ClientCursor::Deleter> cursor);
@@ -233,8 +237,7 @@ private:
     // mutexes for all partitions.
     mutable SimpleMutex _registrationLock;
     std::unique_ptr<PseudoRandom> _random;
-    std::unique_ptr<Partitioned<stdx::unordered_map<CursorId, ClientCursor*>, kNumPartitions>>
-        _cursorMap;
+    std::unique_ptr<Partitioned<CursorMap, kNumPartitions>> _cursorMap;
 
     // A mapping from client OperationKey to corresponding CursorID. Note that it's possible that
     // cursors in the map above are not present in this map, since OperationKey is not required when
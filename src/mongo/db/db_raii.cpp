@@ -34,6 +34,7 @@
 #include "mongo/db/db_raii.h"
 
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii_gen.h"
@@ -53,6 +54,16 @@ const boost::optional<int> kDoNotChangeProfilingLevel = boost::none;
 const auto allowSecondaryReadsDuringBatchApplication_DONT_USE =
     OperationContext::declareDecoration<boost::optional<bool>>();
 
+// Number of secondary collection acquisitions that read at the lastApplied timestamp without
+// conflicting with batch application, and the number that had to retry while holding the PBWM
+// lock because of catalog changes newer than lastApplied.
+Counter64 secondaryReadsAtLastApplied;
+Counter64 secondaryReadsRetriedWithPBWM;
+ServerStatusMetricField<Counter64> displaySecondaryReadsAtLastApplied(
+    "repl.secondaryReads.atLastApplied", &secondaryReadsAtLastApplied);
+ServerStatusMetricField<Counter64> displaySecondaryReadsRetriedWithPBWM(
+    "repl.secondaryReads.retriedWithPBWM", &secondaryReadsRetriedWithPBWM);
+
 }  // namespace
 
 AutoStatsTracker::AutoStatsTracker(OperationContext* opCtx,
@@ -156,6 +167,10 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
 
         auto minSnapshot = coll->getMinimumVisibleSnapshot();
         if (!SnapshotHelper::collectionChangesConflictWithRead(minSnapshot, readTimestamp)) {
+            if (readSource == RecoveryUnit::ReadSource::kLastApplied &&
+                !opCtx->lockState()->shouldConflictWithSecondaryBatchApplication()) {
+                secondaryReadsAtLastApplied.increment();
+            }
             return;
         }
 
@@ -204,6 +219,7 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
             // shouldNotConflictWithSecondaryBatchApplicationBlock outside of this function), this
             // does not take the PBWM lock.
             _shouldNotConflictWithSecondaryBatchApplicationBlock = boost::none;
+            secondaryReadsRetriedWithPBWM.increment();
 
             // As alluded to above, if we are AutoGetting multiple collections, it
             // is possible that our "reaquire the PBWM" trick doesn't work, since we've already done
@@ -120,6 +120,36 @@ RecordId Helpers::findOne(OperationContext* opCtx,
     return RecordId();
 }
 
+std::vector<BSONObj> Helpers::findAll(OperationContext* opCtx, std::unique_ptr<QueryRequest> qr) {
+    AutoGetCollectionForRead autoColl(opCtx, qr->nss());
+    Collection* collection = autoColl.getCollection();
+    if (!collection)
+        return {};
+
+    const ExtensionsCallbackReal extensionsCallback(opCtx, &collection->ns());
+
+    const boost::intrusive_ptr<ExpressionContext> expCtx;
+    auto cq = uassertStatusOK(
+        CanonicalQuery::canonicalize(opCtx,
+                                     std::move(qr),
+                                     expCtx,
+                                     extensionsCallback,
+                                     MatchExpressionParser::kAllowAllSpecialFeatures));
+
+    auto exec = uassertStatusOK(getExecutor(opCtx,
+                                            collection,
+                                            std::move(cq),
+                                            PlanYieldPolicy::YieldPolicy::YIELD_AUTO,
+                                            QueryPlannerParams::DEFAULT));
+
+    std::vector<BSONObj> results;
+    BSONObj obj;
+    while (PlanExecutor::ADVANCED == exec->getNext(&obj, nullptr)) {
+        results.push_back(obj.getOwned());
+    }
+    return results;
+}
+
 bool Helpers::findById(OperationContext* opCtx,
                        Database* database,
                        StringData ns,
@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
 
@@ -74,6 +77,15 @@ struct Helpers {
                             std::unique_ptr<QueryRequest> qr,
                             bool requireIndex);
 
+    /**
+     * Runs the query 'qr' in-process and returns owned copies of all the documents it returns, or
+     * no documents if its collection does not exist. Takes the collection lock itself and yields
+     * like a find. Internal callers can use this instead of a DBDirectClient query, which
+     * serializes the query into a command and runs it through the command layer. No auth, read
+     * concern, CurOp or profiling handling is performed.
+     */
+    static std::vector<BSONObj> findAll(OperationContext* opCtx, std::unique_ptr<QueryRequest> qr);
+
     /**
      * @param foundIndex if passed in will be set to 1 if ns and index found
      * @return true if object found
@@ -243,6 +243,23 @@ void AddFieldsProjectionExecutor::parse(const BSONObj& spec) {
 }
 
 Document AddFieldsProjectionExecutor::applyProjection(const Document& inputDoc) const {
+    // When every added field is top-level and the input is plain BSON, build the output BSON in
+    // one pass over the input instead of layering the added fields over it as a MutableDocument.
+    if (_root->hasOnlyTopLevelComputedFields()) {
+        if (auto bson = inputDoc.toBsonIfTriviallyConvertible()) {
+            BSONObjBuilder bob;
+            _root->applyExpressionsToBson(inputDoc, *bson, &bob);
+
+            Document outputDoc{bob.obj()};
+            if (inputDoc.metadata()) {
+                MutableDocument md{std::move(outputDoc)};
+                md.copyMetaDataFrom(inputDoc);
+                return md.freeze();
+            }
+            return outputDoc;
+        }
+    }
+
     // The output doc is the same as the input doc, with the added fields.
     MutableDocument output(inputDoc);
     _root->applyExpressions(inputDoc, &output);
@@ -544,6 +544,44 @@ TEST(AddFieldsProjectionExecutorExecutionTest, AddsNestedAddedFieldsInOrderSpeci
     ASSERT_DOCUMENT_EQ(result, expectedResult);
 }
 
+//
+// BSON-backed input.
+//
+
+TEST(AddFieldsProjectionExecutorExecutionTest, AddsTopLevelFieldsToBsonInputInOnePass) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    AddFieldsProjectionExecutor addition(expCtx);
+    addition.parse(fromjson("{d: {$add: ['$a', 1]}, b: 'REPLACED', c: '$$REMOVE'}"));
+
+    auto result = addition.applyProjection(Document{fromjson("{a: 1, b: 2, c: 3, e: 4}")});
+
+    // The output is built directly as BSON, with replaced fields kept in place.
+    ASSERT(result.toBsonIfTriviallyConvertible());
+    ASSERT_DOCUMENT_EQ(result, Document{fromjson("{a: 1, b: 'REPLACED', e: 4, d: 2}")});
+}
+
+TEST(AddFieldsProjectionExecutorExecutionTest, ReplacesOnlyFirstDuplicateFieldOfBsonInput) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    AddFieldsProjectionExecutor addition(expCtx);
+    addition.parse(BSON("a" << 3));
+
+    auto bsonInput = BSON("a" << 1 << "a" << 2);
+    auto result = addition.applyProjection(Document{bsonInput});
+
+    MutableDocument expected(Document{bsonInput});
+    expected.setField("a", Value(3));
+    ASSERT_BSONOBJ_EQ(result.toBson(), expected.freeze().toBson());
+}
+
+TEST(AddFieldsProjectionExecutorExecutionTest, AddsNestedFieldsToBsonInput) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    AddFieldsProjectionExecutor addition(expCtx);
+    addition.parse(fromjson("{'a.b': 'COMPUTED', c: 1}"));
+
+    auto result = addition.applyProjection(Document{fromjson("{a: {b: 1, d: 2}, e: 3}")});
+    ASSERT_DOCUMENT_EQ(result, Document{fromjson("{a: {b: 'COMPUTED', d: 2}, e: 3, c: 1}")});
+}
+
 //
 // Misc/Metadata.
 //
@@ -565,5 +603,22 @@ TEST(AddFieldsProjectionExecutorExecutionTest, AlwaysKeepsMetadataFromOriginalDo
     expectedDoc.copyMetaDataFrom(inputDoc);
     ASSERT_DOCUMENT_EQ(result, expectedDoc.freeze());
 }
+
+TEST(AddFieldsProjectionExecutorExecutionTest, KeepsMetadataFromBsonInput) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    AddFieldsProjectionExecutor addition(expCtx);
+    addition.parse(fromjson("{b: {$meta: 'randVal'}}"));
+
+    MutableDocument inputDocBuilder(Document{fromjson("{a: 1}")});
+    inputDocBuilder.metadata().setRandVal(1.0);
+    Document inputDoc = inputDocBuilder.freeze();
+
+    auto result = addition.applyProjection(inputDoc);
+
+    MutableDocument expectedDoc(Document{{"a", 1}, {"b", 1.0}});
+    expectedDoc.copyMetaDataFrom(inputDoc);
+    ASSERT_DOCUMENT_EQ(result, expectedDoc.freeze());
+    ASSERT_EQ(result.metadata().getRandVal(), 1.0);
+}
 }  // namespace
 }  // namespace mongo::projection_executor
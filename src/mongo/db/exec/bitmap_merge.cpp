@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/bitmap_merge.h"
+
+#include <memory>
+
+#include "mongo/db/exec/working_set.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+// static
+const char* BitmapMergeStage::kAndStageType = "AND_BITMAP";
+const char* BitmapMergeStage::kOrStageType = "OR_BITMAP";
+
+BitmapMergeStage::BitmapMergeStage(ExpressionContext* expCtx,
+                                   WorkingSet* ws,
+                                   MergeType mergeType,
+                                   size_t maxMemUsage)
+    : PlanStage(mergeType == MergeType::kIntersection ? kAndStageType : kOrStageType, expCtx),
+      _ws(ws),
+      _mergeType(mergeType),
+      _maxMemUsage(maxMemUsage) {
+    _specificStats.memLimit = _maxMemUsage;
+}
+
+void BitmapMergeStage::addChild(std::unique_ptr<PlanStage> child) {
+    _children.emplace_back(std::move(child));
+}
+
+bool BitmapMergeStage::isEOF() {
+    return _resultIt && !_resultIt->more();
+}
+
+PlanStage::StageState BitmapMergeStage::doWork(WorkingSetID* out) {
+    if (isEOF()) {
+        return PlanStage::IS_EOF;
+    }
+
+    if (!_resultIt) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        const auto childStatus = _children[_currentChild]->work(&id);
+        if (PlanStage::ADVANCED == childStatus) {
+            WorkingSetMember* member = _ws->get(id);
+            invariant(member->hasRecordId());
+            _childBitmap.add(member->recordId);
+            _ws->free(id);
+
+            const auto memUsage = _result.memUsageBytes() + _childBitmap.memUsageBytes();
+            _specificStats.memUsage = std::max(_specificStats.memUsage, memUsage);
+            if (memUsage > _maxMemUsage) {
+                uasserted(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+                          str::stream() << "bitmap " << getCommonStats()->stageTypeStr
+                                        << " stage buffered data usage of " << memUsage
+                                        << " bytes exceeds internal limit of " << _maxMemUsage
+                                        << " bytes");
+            }
+            return PlanStage::NEED_TIME;
+        } else if (PlanStage::IS_EOF == childStatus) {
+            finishChild();
+            return PlanStage::NEED_TIME;
+        } else if (PlanStage::NEED_YIELD == childStatus) {
+            *out = id;
+        }
+        return childStatus;
+    }
+
+    *out = _ws->allocate();
+    WorkingSetMember* member = _ws->get(*out);
+    member->recordId = _resultIt->next();
+    _ws->transitionToRecordIdAndIdx(*out);
+    return PlanStage::ADVANCED;
+}
+
+void BitmapMergeStage::finishChild() {
+    if (_currentChild == 0) {
+        _result = std::move(_childBitmap);
+    } else if (_mergeType == MergeType::kIntersection) {
+        _result.intersectWith(_childBitmap);
+    } else {
+        _result.unionWith(_childBitmap);
+    }
+    _childBitmap = RecordIdBitmap();
+    _specificStats.recordIdsAfterChild.push_back(_result.size());
+    ++_currentChild;
+
+    // Once the intersection is empty, the remaining children can't add anything to it.
+    if (_currentChild == _children.size() ||
+        (_mergeType == MergeType::kIntersection && _result.empty())) {
+        _resultIt.emplace(_result.iterator());
+    }
+}
+
+std::unique_ptr<PlanStageStats> BitmapMergeStage::getStats() {
+    _commonStats.isEOF = isEOF();
+
+    auto ret = std::make_unique<PlanStageStats>(_commonStats, stageType());
+    ret->specific = std::make_unique<BitmapMergeStats>(_specificStats);
+    for (size_t i = 0; i < _children.size(); ++i) {
+        ret->children.emplace_back(_children[i]->getStats());
+    }
+    return ret;
+}
+
+const SpecificStats* BitmapMergeStage::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
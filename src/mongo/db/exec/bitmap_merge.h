@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/exec/record_id_bitmap.h"
+
+namespace mongo {
+
+/**
+ * Reads the RecordIds of N children into compressed bitmaps, and outputs the intersection or the
+ * union of them in RecordId order. Unlike AndHashStage, only the RecordIds are kept: the results
+ * have neither index keys nor documents, so they must be fetched, and the fetch must apply the
+ * whole predicate since a document may have changed between the scans of the children.
+ *
+ * Preconditions: Valid RecordId. More than one child.
+ */
+class BitmapMergeStage final : public PlanStage {
+public:
+    enum class MergeType { kIntersection, kUnion };
+
+    BitmapMergeStage(ExpressionContext* expCtx,
+                     WorkingSet* ws,
+                     MergeType mergeType,
+                     size_t maxMemUsage = kDefaultMaxMemUsageBytes);
+
+    void addChild(std::unique_ptr<PlanStage> child);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    StageType stageType() const final {
+        return _mergeType == MergeType::kIntersection ? STAGE_AND_BITMAP : STAGE_OR_BITMAP;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kAndStageType;
+    static const char* kOrStageType;
+
+private:
+    // Upper limit for the memory used by the bitmaps, as for the hash table of AndHashStage.
+    static constexpr size_t kDefaultMaxMemUsageBytes = 32 * 1024 * 1024;
+
+    // Merges the bitmap of the current child into '_result', and moves on to the next child.
+    void finishChild();
+
+    // Not owned by us.
+    WorkingSet* _ws;
+
+    const MergeType _mergeType;
+
+    // The index of the child whose RecordIds are being read.
+    size_t _currentChild = 0;
+
+    // The merge of the RecordIds of the children before '_currentChild'.
+    RecordIdBitmap _result;
+
+    // The RecordIds read so far from '_currentChild'.
+    RecordIdBitmap _childBitmap;
+
+    // Set once all the children are read, to return the RecordIds in '_result'.
+    boost::optional<RecordIdBitmap::Iterator> _resultIt;
+
+    const size_t _maxMemUsage;
+
+    BitmapMergeStats _specificStats;
+};
+
+}  // namespace mongo
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/bitmap_merge.h"
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("db.dummy");
+
+class BitmapMergeStageTest : public ServiceContextMongoDTest {
+protected:
+    /**
+     * Returns a stage which outputs members with the given RecordIds, and a NEED_TIME after each.
+     */
+    std::unique_ptr<PlanStage> makeChild(const std::vector<int64_t>& ids) {
+        auto child = std::make_unique<QueuedDataStage>(_expCtx.get(), &_ws);
+        for (auto id : ids) {
+            WorkingSetID wsid = _ws.allocate();
+            _ws.get(wsid)->recordId = RecordId(id);
+            _ws.transitionToRecordIdAndIdx(wsid);
+            child->pushBack(wsid);
+            child->pushBack(PlanStage::NEED_TIME);
+        }
+        return child;
+    }
+
+    std::vector<int64_t> runStage(BitmapMergeStage* stage) {
+        std::vector<int64_t> out;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while ((state = stage->work(&id)) != PlanStage::IS_EOF) {
+            if (PlanStage::ADVANCED == state) {
+                auto member = _ws.get(id);
+                ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
+                out.push_back(member->recordId.repr());
+                _ws.free(id);
+            }
+        }
+        return out;
+    }
+
+    ServiceContext::UniqueOperationContext _opCtx = makeOperationContext();
+    boost::intrusive_ptr<ExpressionContext> _expCtx =
+        make_intrusive<ExpressionContext>(_opCtx.get(), nullptr, kNss);
+    WorkingSet _ws;
+};
+
+TEST_F(BitmapMergeStageTest, IntersectionReturnsCommonRecordIdsInOrder) {
+    BitmapMergeStage stage(_expCtx.get(), &_ws, BitmapMergeStage::MergeType::kIntersection);
+    stage.addChild(makeChild({9, 1, 5, 70000, 3}));
+    stage.addChild(makeChild({5, 3, 70000, 8}));
+    stage.addChild(makeChild({70000, 2, 3, 5}));
+
+    ASSERT(std::vector<int64_t>({3, 5, 70000}) == runStage(&stage));
+
+    auto stats = static_cast<const BitmapMergeStats*>(stage.getSpecificStats());
+    ASSERT(std::vector<size_t>({5, 3, 3}) == stats->recordIdsAfterChild);
+}
+
+TEST_F(BitmapMergeStageTest, EmptyIntersectionSkipsRemainingChildren) {
+    BitmapMergeStage stage(_expCtx.get(), &_ws, BitmapMergeStage::MergeType::kIntersection);
+    stage.addChild(makeChild({1, 2}));
+    stage.addChild(makeChild({3, 4}));
+    stage.addChild(makeChild({1, 2, 3, 4}));
+
+    ASSERT(runStage(&stage).empty());
+
+    auto stats = static_cast<const BitmapMergeStats*>(stage.getSpecificStats());
+    ASSERT_EQ(2U, stats->recordIdsAfterChild.size());
+}
+
+TEST_F(BitmapMergeStageTest, UnionReturnsDistinctRecordIdsInOrder) {
+    BitmapMergeStage stage(_expCtx.get(), &_ws, BitmapMergeStage::MergeType::kUnion);
+    stage.addChild(makeChild({9, 1, 5}));
+    stage.addChild(makeChild({5, 3}));
+
+    ASSERT(std::vector<int64_t>({1, 3, 5, 9}) == runStage(&stage));
+    ASSERT_EQ(STAGE_OR_BITMAP, stage.stageType());
+}
+
+TEST_F(BitmapMergeStageTest, ExceedingMemoryLimitFails) {
+    BitmapMergeStage stage(_expCtx.get(), &_ws, BitmapMergeStage::MergeType::kUnion, 64);
+    std::vector<int64_t> ids;
+    for (int64_t i = 0; i < 100; ++i) {
+        ids.push_back(i << 16);
+    }
+    stage.addChild(makeChild(ids));
+    stage.addChild(makeChild({1}));
+
+    ASSERT_THROWS_CODE(
+        runStage(&stage), DBException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -122,6 +122,10 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
             }
 
             _cursor = collection()->getCursor(opCtx(), forward);
+            if (!_params.tailable && !_params.resumeAfterRecordId && !_params.minTs &&
+                !_params.maxTs) {
+                _cursor->setSequentialScanHint();
+            }
 
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
@@ -126,7 +126,7 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
                 _startKeyInclusive);
             entry = _cursor->seek(keyStringForSeek);
         } else {
-            entry = _cursor->next(kWantLoc);
+            entry = _keyBatcher.next(opCtx(), _cursor.get(), kWantLoc);
         }
     } catch (const WriteConflictException&) {
         if (needInit) {
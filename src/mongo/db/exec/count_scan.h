@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/db/exec/index_key_batcher.h"
 #include "mongo/db/exec/requires_index_stage.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/operation_context.h"
@@ -128,6 +129,9 @@ private:
 
     std::unique_ptr<SortedDataInterface::Cursor> _cursor;
 
+    // Reads the RecordIds after the initial seek from '_cursor' in batches.
+    IndexKeyBatcher _keyBatcher;
+
     // The set of record ids we've returned so far. Used to avoid returning duplicates, if
     // '_shouldDedup' is set to true.
     stdx::unordered_set<RecordId, RecordId::Hasher> _returned;
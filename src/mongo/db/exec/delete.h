@@ -64,6 +64,10 @@ struct DeleteStageParams {
     // Should we return the document we just deleted?
     bool returnDeleted;
 
+    // If positive, the stage reports EOF once it has deleted this many documents, even if its
+    // child could produce more. Only meaningful for multi deletes.
+    long long limit = 0;
+
     // The stmtId for this particular delete.
     StmtId stmtId = kUninitializedStmtId;
 
@@ -31,12 +31,16 @@
 
 #include "mongo/db/exec/document_value/document.h"
 
+#include <algorithm>
+#include <array>
 #include <boost/functional/hash.hpp>
 
 #include "mongo/bson/bson_depth.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/resume_token.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -44,6 +48,92 @@ using boost::intrusive_ptr;
 using std::string;
 using std::vector;
 
+namespace {
+
+/**
+ * A per-thread cache of the memory freed by DocumentStorage: both the storage objects themselves
+ * and their power-of-two sized buffers. Memory freed on a thread other than the one which allocated
+ * it simply joins the cache of the freeing thread.
+ */
+class DocumentStoragePool {
+public:
+    // Buffers of kMinBufferBytes, twice that, and so on up to kMaxBufferBytes are recycled. Larger
+    // buffers are rare and always come from the heap.
+    static constexpr size_t kMinBufferBytes = 128;
+    static constexpr size_t kMaxBufferBytes = 4096;
+    static constexpr size_t kNumBufferSizes = 6;
+    static_assert(kMinBufferBytes << (kNumBufferSizes - 1) == kMaxBufferBytes);
+
+    // The total size of the free memory a thread retains.
+    static constexpr size_t kMaxFreeBytes = 64 * 1024;
+
+    /**
+     * Returns the pool of the calling thread, or nullptr if the thread is exiting and its pool has
+     * already been destroyed.
+     */
+    static DocumentStoragePool* get() {
+        if (_destroyed) {
+            return nullptr;
+        }
+        static thread_local DocumentStoragePool pool;
+        return &pool;
+    }
+
+    ~DocumentStoragePool() {
+        _destroyed = true;
+        for (auto ptr : _freeStorage) {
+            ::operator delete(ptr);
+        }
+        for (auto&& freeList : _freeBuffers) {
+            for (auto ptr : freeList) {
+                ::operator delete(ptr);
+            }
+        }
+    }
+
+    void* allocate(size_t bytes) {
+        auto freeList = freeListFor(bytes);
+        if (!freeList || freeList->empty()) {
+            return ::operator new(bytes);
+        }
+        auto ptr = freeList->back();
+        freeList->pop_back();
+        _freeBytes -= bytes;
+        return ptr;
+    }
+
+    void free(void* ptr, size_t bytes) {
+        auto freeList = freeListFor(bytes);
+        if (!freeList || _freeBytes + bytes > kMaxFreeBytes) {
+            ::operator delete(ptr);
+            return;
+        }
+        freeList->push_back(ptr);
+        _freeBytes += bytes;
+    }
+
+private:
+    std::vector<void*>* freeListFor(size_t bytes) {
+        if (bytes == sizeof(DocumentStorage)) {
+            return &_freeStorage;
+        }
+        if (bytes < kMinBufferBytes || bytes > kMaxBufferBytes || (bytes & (bytes - 1))) {
+            return nullptr;
+        }
+        return &_freeBuffers[countTrailingZeros64(bytes / kMinBufferBytes)];
+    }
+
+    static thread_local bool _destroyed;
+
+    std::vector<void*> _freeStorage;
+    std::array<std::vector<void*>, kNumBufferSizes> _freeBuffers;
+    size_t _freeBytes = 0;
+};
+
+thread_local bool DocumentStoragePool::_destroyed = false;
+
+}  // namespace
+
 const DocumentStorage DocumentStorage::kEmptyDoc;
 
 const StringDataSet Document::allMetadataFieldNames{Document::metaFieldTextScore,
@@ -160,16 +250,49 @@ Position DocumentStorage::findField(StringData requested, LookupPolicy policy) c
         return pos;
     }
 
-    for (auto&& bsonElement : _bson) {
-        if (requested == bsonElement.fieldNameStringData()) {
-            return const_cast<DocumentStorage*>(this)->constructInCache(bsonElement);
-        }
+    if (auto bsonElement = findFieldInBson(requested)) {
+        return const_cast<DocumentStorage*>(this)->constructInCache(bsonElement);
     }
 
     // if we got here, there's no such field
     return Position();
 }
 
+BSONElement DocumentStorage::findFieldInBson(StringData name) const {
+    // Nothing is recorded for an empty '_bson', which is what the shared 'kEmptyDoc' holds.
+    if (_bson.isEmpty()) {
+        return BSONElement();
+    }
+
+    if (_bsonFieldIndex.empty() && ++_numBsonSearches >= kBsonSearchesBeforeIndexing) {
+        _bsonFieldIndex.reserve(_bson.nFields());
+        for (auto&& bsonElement : _bson) {
+            _bsonFieldIndex.emplace_back(bsonElement.fieldNameStringData(), bsonElement);
+        }
+        // A stable sort keeps duplicate field names in document order, so that a search of the
+        // index finds the same element as a scan of '_bson'.
+        std::stable_sort(_bsonFieldIndex.begin(),
+                         _bsonFieldIndex.end(),
+                         [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    }
+
+    if (!_bsonFieldIndex.empty()) {
+        auto it = std::lower_bound(
+            _bsonFieldIndex.begin(),
+            _bsonFieldIndex.end(),
+            name,
+            [](const auto& entry, StringData fieldName) { return entry.first < fieldName; });
+        return it != _bsonFieldIndex.end() && it->first == name ? it->second : BSONElement();
+    }
+
+    for (auto&& bsonElement : _bson) {
+        if (name == bsonElement.fieldNameStringData()) {
+            return bsonElement;
+        }
+    }
+    return BSONElement();
+}
+
 Position DocumentStorage::constructInCache(const BSONElement& elem) {
     auto savedModified = _modified;
     auto pos = getNextPosition();
@@ -253,13 +376,17 @@ void DocumentStorage::alloc(unsigned newSize) {
 
     uassert(16490, "Tried to make oversized document", capacity <= size_t(BufferMaxSize));
 
-    std::unique_ptr<char[]> oldBuf(_cache);
-    _cache = new char[capacity];
+    char* oldBuf = _cache;
+    const size_t oldBufBytes = _cacheCapacity;
+    _cache = allocateBuffer(capacity);
     _cacheEnd = _cache + capacity - hashTabBytes();
+    _cacheCapacity = capacity;
 
     if (!firstAlloc) {
+        ON_BLOCK_EXIT([&] { freeBuffer(oldBuf, oldBufBytes); });
+
         // This just copies the elements
-        memcpy(_cache, oldBuf.get(), _usedBytes);
+        memcpy(_cache, oldBuf, _usedBytes);
 
         if (_numFields >= HASH_TAB_MIN) {
             // if we were hashing, deal with the hash table
@@ -267,7 +394,7 @@ void DocumentStorage::alloc(unsigned newSize) {
                 rehash();
             } else {
                 // no rehash needed so just slide table down to new position
-                memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                memcpy(_hashTab, oldBuf + oldCapacity, hashTabBytes());
             }
         }
     }
@@ -286,8 +413,14 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 
     uassert(16491, "Tried to make oversized document", newSize <= size_t(BufferMaxSize));
 
-    _cache = new char[newSize + hashTabBytes()];
-    _cacheEnd = _cache + newSize;
+    // Round up to a power of two like alloc() does, so that the buffer can be recycled.
+    size_t capacity = 128;
+    while (capacity < newSize + hashTabBytes())
+        capacity *= 2;
+
+    _cache = allocateBuffer(capacity);
+    _cacheEnd = _cache + capacity - hashTabBytes();
+    _cacheCapacity = capacity;
 }
 
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
@@ -297,8 +430,9 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
         // Make a copy of the buffer with the fields.
         // It is very important that the positions of each field are the same after cloning.
         const size_t bufferBytes = allocatedBytes();
-        out->_cache = new char[bufferBytes];
+        out->_cache = allocateBuffer(bufferBytes);
         out->_cacheEnd = out->_cache + (_cacheEnd - _cache);
+        out->_cacheCapacity = bufferBytes;
         memcpy(out->_cache, _cache, bufferBytes);
 
         out->_hashTabMask = _hashTabMask;
@@ -329,15 +463,42 @@ size_t DocumentStorage::getMetadataApproximateSize() const {
 }
 
 DocumentStorage::~DocumentStorage() {
-    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_cache);
-
     for (auto it = iteratorCacheOnly(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
+
+    if (_cache) {
+        freeBuffer(_cache, _cacheCapacity);
+    }
+}
+
+void* DocumentStorage::operator new(size_t bytes) {
+    if (auto pool = DocumentStoragePool::get()) {
+        return pool->allocate(bytes);
+    }
+    return ::operator new(bytes);
+}
+
+void DocumentStorage::operator delete(void* ptr, size_t bytes) {
+    if (auto pool = DocumentStoragePool::get()) {
+        pool->free(ptr, bytes);
+        return;
+    }
+    ::operator delete(ptr);
+}
+
+char* DocumentStorage::allocateBuffer(size_t bytes) {
+    return static_cast<char*>(DocumentStorage::operator new(bytes));
+}
+
+void DocumentStorage::freeBuffer(char* buffer, size_t bytes) {
+    DocumentStorage::operator delete(buffer, bytes);
 }
 
 void DocumentStorage::reset(const BSONObj& bson, bool stripMetadata) {
     _bson = bson;
+    _numBsonSearches = 0;
+    _bsonFieldIndex.clear();
     _stripMetadata = stripMetadata;
     _modified = false;
 
@@ -33,6 +33,8 @@
 
 #include <bitset>
 #include <boost/intrusive_ptr.hpp>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/static_assert.h"
 #include "mongo/db/exec/document_value/document_metadata_fields.h"
@@ -297,6 +299,13 @@ public:
 
     ~DocumentStorage();
 
+    /**
+     * DocumentStorage objects and their buffers are recycled through a per-thread pool, since
+     * pipelines create and destroy them at a high rate.
+     */
+    static void* operator new(size_t bytes);
+    static void operator delete(void* ptr, size_t bytes);
+
     void reset(const BSONObj& bson, bool stripMetadata);
 
     static const DocumentStorage& emptyDoc() {
@@ -363,10 +372,8 @@ public:
             return {getField(pos).val};
         }
 
-        for (auto&& bsonElement : _bson) {
-            if (name == bsonElement.fieldNameStringData()) {
-                return {bsonElement};
-            }
+        if (auto bsonElement = findFieldInBson(name)) {
+            return {bsonElement};
         }
 
         // Field not found. Return EOO Value.
@@ -410,6 +417,8 @@ public:
 
     void makeOwned() {
         _bson = _bson.getOwned();
+        // The index refers to the memory of the previous, unowned '_bson'.
+        _bsonFieldIndex.clear();
     }
 
     /**
@@ -499,6 +508,10 @@ private:
     /// Allocates space in _cache. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
+    /// Allocate and free the memory backing _cache, through the per-thread pool when possible.
+    static char* allocateBuffer(size_t bytes);
+    static void freeBuffer(char* buffer, size_t bytes);
+
     /// Call after adding field to _cache and increasing _numFields
     void addFieldToHashTable(Position pos);
 
@@ -533,6 +546,11 @@ private:
 
     void loadLazyMetadata() const;
 
+    /**
+     * Returns the first element of the backing '_bson' named 'name', or EOO if there is none.
+     */
+    BSONElement findFieldInBson(StringData name) const;
+
     enum {
         HASH_TAB_INIT_SIZE = 8,  // must be power of 2
         HASH_TAB_MIN = 4,        // don't hash fields for docs smaller than this
@@ -562,9 +580,21 @@ private:
     unsigned _usedBytes;    // position where next field would start
     unsigned _numFields;    // this includes removed fields
     unsigned _hashTabMask;  // equal to hashTabBuckets()-1 but used more often
+    unsigned _cacheCapacity = 0;  // bytes allocated for _cache, including the hash table
 
     BSONObj _bson;
 
+    // Number of searches of '_bson' after which '_bsonFieldIndex' is built.
+    static constexpr int kBsonSearchesBeforeIndexing = 16;
+
+    // Fields that are not yet in the cache are found by a linear scan of '_bson'. When many
+    // different fields of a wide document are requested, for instance by a filter, a projection
+    // and a sort on the same document, each of these scans is linear in its number of fields. After
+    // a number of scans the fields of '_bson' are indexed by name, sorted so that each later search
+    // is a binary search. The index is only ever used for fields that are not in the cache.
+    mutable int _numBsonSearches = 0;
+    mutable std::vector<std::pair<StringData, BSONElement>> _bsonFieldIndex;
+
     // If '_stripMetadata' is true, tracks whether or not the metadata has been lazy-loaded from the
     // backing '_bson' object. If so, then no attempt will be made to load the metadata again, even
     // if the metadata has been released by a call to 'releaseMetadata()'.
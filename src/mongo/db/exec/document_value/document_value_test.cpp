@@ -45,6 +45,7 @@
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 
 namespace DocumentTests {
 
@@ -137,6 +138,42 @@ TEST(DocumentConstruction, FromBsonReset) {
     ASSERT_BSONOBJ_EQ(bson, toBson(newDocument));
 }
 
+TEST(DocumentConstruction, RecycledStorageHoldsOnlyItsOwnFields) {
+    // Grow and destroy documents of several sizes so that their storage and buffers are recycled.
+    for (int numFields = 1; numFields < 200; numFields *= 3) {
+        MutableDocument md;
+        for (int i = 0; i < numFields; ++i) {
+            md.addField("field" + std::to_string(i), Value(i));
+        }
+        ASSERT_EQUALS(size_t(numFields), md.freeze().computeSize());
+    }
+
+    for (int numFields = 1; numFields < 200; numFields *= 3) {
+        MutableDocument md(numFields);
+        md.addField("x", Value(numFields));
+        auto document = md.freeze();
+        ASSERT_EQUALS(1ULL, document.computeSize());
+        ASSERT_EQUALS(numFields, document["x"].getInt());
+        ASSERT_TRUE(document["field0"].missing());
+    }
+}
+
+TEST(DocumentConstruction, StorageCanBeFreedOnAnotherThread) {
+    std::vector<Document> documents;
+    for (int i = 0; i < 100; ++i) {
+        documents.push_back(Document{{"a", i}, {"b", std::string(i, 'x')}});
+    }
+
+    stdx::thread([&] {
+        documents.clear();
+        auto document = Document{{"c", 1}};
+        ASSERT_EQUALS(1, document["c"].getInt());
+    }).join();
+
+    auto document = Document{{"a", 1}, {"b", "q"_sd}};
+    ASSERT_EQUALS(2ULL, document.computeSize());
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
@@ -198,6 +235,33 @@ TEST(DocumentGetFieldNonCaching, UncachedTopLevelFields) {
     assertRoundTrips(document);
 }
 
+TEST(DocumentGetFieldNonCaching, ManyLookupsInWideDocumentFindFirstOfDuplicateFields) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < 100; ++i) {
+        builder.append("field" + std::to_string(i), i);
+    }
+    builder.append("field7", "duplicate");
+    BSONObj bson = builder.obj();
+    Document document = fromBson(bson);
+
+    // Look up enough fields without caching them for the backing BSON to be indexed.
+    for (int i = 99; i >= 0; --i) {
+        auto valueVariant = document.getNestedFieldNonCaching("field" + std::to_string(i));
+        ASSERT_TRUE(stdx::holds_alternative<BSONElement>(valueVariant));
+        ASSERT_EQ(stdx::get<BSONElement>(valueVariant).numberInt(), i);
+    }
+    ASSERT_TRUE(
+        stdx::holds_alternative<stdx::monostate>(document.getNestedFieldNonCaching("field100")));
+
+    // Fields found through the index are cached as usual.
+    ASSERT_VALUE_EQ(document["field7"], Value(7));
+    ASSERT_TRUE(stdx::holds_alternative<Value>(document.getNestedFieldNonCaching("field7")));
+    ASSERT_VALUE_EQ(document["field42"], Value(42));
+    ASSERT_TRUE(document["doesnotexist"].missing());
+
+    assertRoundTrips(document);
+}
+
 TEST(DocumentGetFieldNonCaching, CachedTopLevelFields) {
     BSONObj bson = BSON("scalar" << 1 << "array" << BSON_ARRAY(1 << 2 << 3) << "scalar2" << true);
     Document document = fromBson(bson);
@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/fetch.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/catalog/collection.h"
@@ -53,11 +54,13 @@ FetchStage::FetchStage(ExpressionContext* expCtx,
                        WorkingSet* ws,
                        std::unique_ptr<PlanStage> child,
                        const MatchExpression* filter,
-                       const Collection* collection)
+                       const Collection* collection,
+                       size_t recordIdBatchSize)
     : RequiresCollectionStage(kStageType, expCtx, collection),
       _ws(ws),
       _filter((filter && !filter->isTriviallyTrue()) ? filter : nullptr),
-      _idRetrying(WorkingSet::INVALID_ID) {
+      _idRetrying(WorkingSet::INVALID_ID),
+      _recordIdBatchSize(recordIdBatchSize) {
     _children.emplace_back(std::move(child));
 }
 
@@ -69,6 +72,11 @@ bool FetchStage::isEOF() {
         return false;
     }
 
+    if (_batchPos < _batch.size()) {
+        // There are buffered members left to fetch.
+        return false;
+    }
+
     return child()->isEOF();
 }
 
@@ -80,12 +88,14 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
+    if (_idRetrying != WorkingSet::INVALID_ID) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+    } else if (_recordIdBatchSize > 0) {
+        status = nextFromBatch(&id);
+    } else {
+        status = child()->work(&id);
     }
 
     if (PlanStage::ADVANCED == status) {
@@ -125,6 +135,47 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::nextFromBatch(WorkingSetID* out) {
+    if (_isBatchSorted && _batchPos == _batch.size()) {
+        _batch.clear();
+        _batchPos = 0;
+        _isBatchSorted = false;
+    }
+
+    if (!_isBatchSorted) {
+        // The buffered members survive yields: WorkingSetCommon::fetch() checks their index keys
+        // against the document if the snapshot changed since they were produced.
+        for (size_t works = 0;
+             works < _recordIdBatchSize && _batch.size() < _recordIdBatchSize && !child()->isEOF();
+             ++works) {
+            WorkingSetID id;
+            const auto status = child()->work(&id);
+            if (PlanStage::ADVANCED == status) {
+                _batch.push_back(id);
+            } else if (PlanStage::NEED_YIELD == status) {
+                *out = id;
+                return status;
+            }
+        }
+
+        if (_batch.size() < _recordIdBatchSize && !child()->isEOF()) {
+            return PlanStage::NEED_TIME;
+        }
+        if (_batch.empty()) {
+            return PlanStage::IS_EOF;
+        }
+
+        std::sort(_batch.begin(), _batch.end(), [this](WorkingSetID lhs, WorkingSetID rhs) {
+            return _ws->get(lhs)->recordId < _ws->get(rhs)->recordId;
+        });
+        _isBatchSorted = true;
+        ++_specificStats.recordIdBatches;
+    }
+
+    *out = _batch[_batchPos++];
+    return PlanStage::ADVANCED;
+}
+
 void FetchStage::doSaveStateRequiresCollection() {
     if (_cursor) {
         _cursor->saveUnpositioned();
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/jsobj.h"
@@ -46,6 +47,10 @@ class SeekableRecordCursor;
  * In WorkingSetMember terms, it transitions from RID_AND_IDX to RID_AND_OBJ by reading
  * the record at the provided RecordId.  Returns verbatim any data that already has an object.
  *
+ * If 'recordIdBatchSize' is non-zero, the stage buffers that many members from its child and
+ * fetches them in RecordId order, so that the record store is read sequentially rather than in
+ * the order of the child. The results are then no longer in the order of the child.
+ *
  * Preconditions: Valid RecordId.
  */
 class FetchStage : public RequiresCollectionStage {
@@ -54,7 +59,8 @@ public:
                WorkingSet* ws,
                std::unique_ptr<PlanStage> child,
                const MatchExpression* filter,
-               const Collection* collection);
+               const Collection* collection,
+               size_t recordIdBatchSize = 0);
 
     ~FetchStage();
 
@@ -86,6 +92,13 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Returns the next member of the current batch, or buffers and sorts the next batch from the
+     * child if the current one is exhausted. Does at most '_recordIdBatchSize' works of the child
+     * per call.
+     */
+    StageState nextFromBatch(WorkingSetID* out);
+
     // Used to fetch Records from _collection.
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
@@ -98,6 +111,15 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // If non-zero, the number of members buffered from the child and fetched in RecordId order.
+    const size_t _recordIdBatchSize;
+
+    // The members buffered from the child, and the position of the next one to fetch once the
+    // batch is full and sorted.
+    std::vector<WorkingSetID> _batch;
+    size_t _batchPos = 0;
+    bool _isBatchSorted = false;
+
     // Stats
     FetchStats _specificStats;
 };
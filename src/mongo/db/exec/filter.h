@@ -43,7 +43,7 @@ namespace mongo {
 class WorkingSetMatchableDocument : public MatchableDocument {
 public:
     WorkingSetMatchableDocument(WorkingSetMember* wsm)
-        : _wsm(wsm), _obj(_wsm->doc.value().toBson()) {}
+        : _wsm(wsm), _obj(_wsm->doc.value().toBson()), _bsonDoc(_obj) {}
 
     // This is only called by a $where query.  The query system must be smart enough to realize
     // that it should do a fetch beforehand.
@@ -53,9 +53,11 @@ public:
 
     ElementIterator* allocateIterator(const ElementPath* path) const final {
         // BSONElementIterator does some interesting things with arrays that I don't think
-        // SimpleArrayElementIterator does.
+        // SimpleArrayElementIterator does. Going through BSONMatchableDocument also lets a filter
+        // with many predicates look up the document's top-level fields by name, rather than
+        // scanning the document once per predicate.
         if (_wsm->hasObj()) {
-            return new BSONElementIterator(path, _obj);
+            return _bsonDoc.allocateIterator(path);
         }
 
         // NOTE: This (kind of) duplicates code in WorkingSetMember::getFieldDotted.
@@ -90,12 +92,17 @@ public:
     }
 
     void releaseIterator(ElementIterator* iterator) const final {
-        delete iterator;
+        if (_wsm->hasObj()) {
+            _bsonDoc.releaseIterator(iterator);
+        } else {
+            delete iterator;
+        }
     }
 
 private:
     WorkingSetMember* _wsm;
     BSONObj _obj;
+    BSONMatchableDocument _bsonDoc;
 };
 
 class IndexKeyMatchableDocument : public MatchableDocument {
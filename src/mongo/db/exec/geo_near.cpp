@@ -51,6 +51,7 @@
 #include "mongo/db/query/expression_index_knobs_gen.h"
 
 #include <algorithm>
+#include <cmath>
 
 namespace mongo {
 
@@ -760,6 +761,68 @@ S2Region* buildS2Region(const R2Annulus& sphereBounds) {
     // Takes ownership of caps
     return new S2RegionIntersection(&regions);
 }
+// The number of results each interval of a 2dsphere $near search should return.
+const long long kTargetResultsPerSphereInterval = 300;
+
+// Bounds the change of the bounds increment between consecutive intervals, so that a density
+// estimated from few results cannot shrink or grow the search area by too much.
+const double kMaxBoundsIncrementGrowth = 4.0;
+
+/**
+ * Returns the area of the spherical cap of the given radius, in units of the area of the unit
+ * sphere's cap, i.e. 1 - cos(radius / R). Written in terms of sin() to stay precise for radii
+ * which are tiny relative to the radius of the Earth.
+ */
+double sphereCapArea(double radiusInMeters) {
+    const double halfAngle = std::max(0.0, radiusInMeters) / kRadiusOfEarthInMeters / 2;
+    return 2 * std::sin(halfAngle) * std::sin(halfAngle);
+}
+
+/**
+ * Inverse of sphereCapArea().
+ */
+double sphereCapRadius(double capArea) {
+    if (capArea >= 2.0) {
+        return kMaxEarthDistanceInMeters;
+    }
+    return 2 * std::asin(std::sqrt(capArea / 2)) * kRadiusOfEarthInMeters;
+}
+
+/**
+ * Computes the amount by which to grow the next search annulus of a 2dsphere $near search.
+ *
+ * As long as nothing has been found, the increment doubles for each interval. Once documents
+ * have been returned, their density over the area searched so far predicts how far the next
+ * annulus must reach to return about kTargetResultsPerSphereInterval documents, so that sparse
+ * data is searched in few large intervals and dense data in small ones.
+ */
+double nextSphereBoundsIncrement(const std::vector<IntervalStats>& intervalStats,
+                                 const R2Annulus& fullBounds,
+                                 const R2Annulus& currBounds,
+                                 double lastBoundsIncrement) {
+    long long numResultsReturned = 0;
+    for (auto&& stats : intervalStats) {
+        numResultsReturned += stats.numResultsReturned;
+    }
+
+    if (numResultsReturned == 0) {
+        return lastBoundsIncrement * 2;
+    }
+
+    const double searchedArea =
+        sphereCapArea(currBounds.getOuter()) - sphereCapArea(fullBounds.getInner());
+    if (searchedArea <= 0.0) {
+        return lastBoundsIncrement * 2;
+    }
+
+    const double density = numResultsReturned / searchedArea;
+    const double nextOuter = sphereCapRadius(sphereCapArea(currBounds.getOuter()) +
+                                             kTargetResultsPerSphereInterval / density);
+    const double increment = nextOuter - currBounds.getOuter();
+    return std::max(lastBoundsIncrement / kMaxBoundsIncrementGrowth,
+                    std::min(increment, lastBoundsIncrement * kMaxBoundsIncrementGrowth));
+}
+
 }  // namespace
 
 GeoNear2DSphereStage::DensityEstimator::DensityEstimator(const Collection* collection,
@@ -930,13 +993,8 @@ std::unique_ptr<NearStage::CoveredInterval> GeoNear2DSphereStage::nextInterval(
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement = nextSphereBoundsIncrement(
+            _specificStats.intervalStats, _fullBounds, _currBounds, _boundsIncrement);
     }
 
     invariant(_boundsIncrement > 0.0);
@@ -33,9 +33,11 @@
 
 namespace mongo::projection_executor {
 Document FastPathEligibleInclusionNode::applyToDocument(const Document& inputDoc) const {
-    // A fast-path inclusion projection supports inclusion-only fields, so make sure we have no
-    // computed fields in the specification.
-    invariant(!_subtreeContainsComputedFields);
+    // Computed fields below the top level have to be merged into the projected subdocuments,
+    // which only the default implementation knows how to do.
+    if (_subtreeContainsComputedFields && !hasOnlyTopLevelComputedFields()) {
+        return InclusionNode::applyToDocument(inputDoc);
+    }
 
     // If we can get the backing BSON object off the input document without allocating an owned
     // copy, then we can apply a fast-path BSON-to-BSON inclusion projection.
@@ -43,6 +45,12 @@ Document FastPathEligibleInclusionNode::applyToDocument(const Document& inputDoc
         BSONObjBuilder bob;
         _applyProjections(*bson, &bob);
 
+        // Computed fields cannot share a name with an included field, so they all go after the
+        // included ones, just as the default implementation orders them.
+        if (_subtreeContainsComputedFields) {
+            applyExpressionsToBson(inputDoc, BSONObj(), &bob);
+        }
+
         Document outputDoc{bob.obj()};
         // Make sure that we always pass through any metadata present in the input doc.
         if (inputDoc.metadata()) {
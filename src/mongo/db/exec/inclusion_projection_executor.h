@@ -103,12 +103,13 @@ protected:
 
 /**
  * A fast-path inclusion projection implementation which applies a BSON-to-BSON transformation
- * rather than constructing an output document using the Document/Value API. For inclusion-only
- * projections (which are projections without expressions, metadata, find-only expressions ($slice,
- * $elemMatch, and positional), and not requiring an entire document) it can be much faster than the
- * default InclusionNode implementation. On a document-by-document basis, if the fast-path
- * projection cannot be applied to the input document, it will fall back to the default
- * implementation.
+ * rather than constructing an output document using the Document/Value API. For inclusion
+ * projections without find-only expressions ($slice, $elemMatch, and positional) and not requiring
+ * an entire document, it can be much faster than the default InclusionNode implementation.
+ * Included fields are copied straight from the input BSON, and top-level computed fields are the
+ * only values evaluated through the Value API. On a document-by-document basis, if the fast-path
+ * projection cannot be applied to the input document, or the projection has computed fields below
+ * the top level, it will fall back to the default implementation.
  */
 class FastPathEligibleInclusionNode final : public InclusionNode {
 public:
@@ -1054,37 +1054,40 @@ TEST_F(InclusionProjectionExecutionTestWithoutFallBackToDefault,
 }
 
 TEST_F(InclusionProjectionExecutionTestWithoutFallBackToDefault,
-       CannotUseFastPathWithRegularExpression) {
+       AppliesTopLevelComputedFieldsOnFastPath) {
     _runDefault = false;
-    ASSERT_THROWS_CODE(
-        makeInclusionProjectionWithDefaultPolicies(fromjson("{a: 1, b: {$add: ['$c', 1]}}")),
-        AssertionException,
-        51752);
+    auto inclusion = makeInclusionProjectionWithDefaultPolicies(
+        fromjson("{a: 1, b: {$add: ['$c', 1]}, d: '$c', e: {$literal: 'abc'}, f: '$missing'}"));
+
+    auto result = inclusion->applyTransformation(Document{fromjson("{_id: 0, c: 1, a: 2, z: 3}")});
+
+    // The output was built directly as BSON, with the computed fields after the included ones.
+    ASSERT(result.toBsonIfTriviallyConvertible());
+    ASSERT_DOCUMENT_EQ(result, Document{fromjson("{_id: 0, a: 2, b: 2, d: 1, e: 'abc'}")});
 }
 
 TEST_F(InclusionProjectionExecutionTestWithoutFallBackToDefault,
-       CannotUseFastPathWithMetadataExpression) {
+       AppliesMetadataExpressionOnFastPath) {
     _runDefault = false;
-    ASSERT_THROWS_CODE(
-        makeInclusionProjectionWithDefaultPolicies(fromjson("{a: 1, b: {$meta: 'randVal'}}")),
-        AssertionException,
-        51752);
-}
+    auto inclusion =
+        makeInclusionProjectionWithDefaultPolicies(fromjson("{a: 1, b: {$meta: 'randVal'}}"));
 
-TEST_F(InclusionProjectionExecutionTestWithoutFallBackToDefault, CannotUseFastPathWithLiteral) {
-    _runDefault = false;
-    ASSERT_THROWS_CODE(
-        makeInclusionProjectionWithDefaultPolicies(BSON("a" << 1 << "b" << wrapInLiteral("abc"))),
-        AssertionException,
-        51752);
+    MutableDocument inputDocBuilder(Document{fromjson("{a: 1, c: 2}")});
+    inputDocBuilder.metadata().setRandVal(1.0);
+    auto result = inclusion->applyTransformation(inputDocBuilder.freeze());
+
+    ASSERT_DOCUMENT_EQ(result, Document{fromjson("{a: 1, b: 1.0}")});
+    ASSERT_EQ(result.metadata().getRandVal(), 1.0);
 }
 
 TEST_F(InclusionProjectionExecutionTestWithoutFallBackToDefault,
-       CannotUseFastPathWithFieldPathExpression) {
+       FallsBackToDefaultForNestedComputedFields) {
     _runDefault = false;
-    ASSERT_THROWS_CODE(makeInclusionProjectionWithDefaultPolicies(fromjson("{a: 1, b: '$c'}")),
-                       AssertionException,
-                       51752);
+    auto inclusion =
+        makeInclusionProjectionWithDefaultPolicies(fromjson("{a: 1, 'x.y': {$literal: 1}}"));
+
+    auto result = inclusion->applyTransformation(Document{fromjson("{a: 1, x: {y: 2, z: 3}}")});
+    ASSERT_DOCUMENT_EQ(result, Document{fromjson("{a: 1, x: {y: 1}}")});
 }
 }  // namespace fast_path_projection_only_tests
 }  // namespace mongo::projection_executor
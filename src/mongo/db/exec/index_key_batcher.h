@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/storage/snapshot.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+
+namespace mongo {
+
+/**
+ * Reads forward from a SortedDataInterface::Cursor in batches on behalf of a scan stage which
+ * consumes the entries one at a time, so that the per-call overhead of the cursor is paid once per
+ * batch rather than once per key.
+ *
+ * The batch size starts at one and doubles, up to internalQueryIndexScanKeyBatchSize, for as long
+ * as the scan keeps moving forward. After every seek the stage must call reset(), which discards
+ * what is buffered and starts again from one. This bounds the keys read but never consumed by a
+ * scan which stops or seeks soon after it starts to the number it did consume.
+ *
+ * Buffered entries have owned keys, so they stay valid across yields. snapshotId() reports the
+ * storage snapshot an entry was read in, which may be older than the current one.
+ */
+class IndexKeyBatcher {
+public:
+    /**
+     * Returns the entry after the last one returned, or boost::none when 'cursor' is exhausted.
+     */
+    boost::optional<IndexKeyEntry> next(OperationContext* opCtx,
+                                        SortedDataInterface::Cursor* cursor,
+                                        SortedDataInterface::Cursor::RequestedInfo parts) {
+        if (_pos == _entries.size()) {
+            _entries.clear();
+            _pos = 0;
+
+            const size_t maxBatchSize = internalQueryIndexScanKeyBatchSize.load();
+            const size_t batchSize = std::min(_nextBatchSize, maxBatchSize);
+            _nextBatchSize = std::min(2 * batchSize, maxBatchSize);
+
+            // If this throws, whatever was appended before the error is consumed first on retry.
+            _snapshotId = opCtx->recoveryUnit()->getSnapshotId();
+            cursor->nextBatch(batchSize, &_entries, parts);
+            if (_entries.empty()) {
+                return boost::none;
+            }
+        }
+        return std::move(_entries[_pos++]);
+    }
+
+    /**
+     * Discards the buffered entries. Must be called whenever the cursor is repositioned.
+     */
+    void reset() {
+        _entries.clear();
+        _pos = 0;
+        _nextBatchSize = 1;
+    }
+
+    /**
+     * The snapshot which the entries in the current batch were read from.
+     */
+    SnapshotId snapshotId() const {
+        return _snapshotId;
+    }
+
+private:
+    std::vector<IndexKeyEntry> _entries;
+    size_t _pos = 0;
+    size_t _nextBatchSize = 1;
+    SnapshotId _snapshotId;
+};
+
+}  // namespace mongo
@@ -144,17 +144,22 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
         switch (_scanState) {
             case INITIALIZING:
                 kv = initIndexScan();
+                _keySnapshotId = opCtx()->recoveryUnit()->getSnapshotId();
                 break;
             case GETTING_NEXT:
-                kv = _indexCursor->next();
+                kv = _keyBatcher.next(
+                    opCtx(), _indexCursor.get(), SortedDataInterface::Cursor::kKeyAndLoc);
+                _keySnapshotId = _keyBatcher.snapshotId();
                 break;
             case NEED_SEEK:
                 ++_specificStats.seeks;
+                _keyBatcher.reset();
                 kv = _indexCursor->seek(IndexEntryComparison::makeKeyStringFromSeekPointForSeek(
                     _seekPoint,
                     indexAccessMethod()->getSortedDataInterface()->getKeyStringVersion(),
                     indexAccessMethod()->getSortedDataInterface()->getOrdering(),
                     _forward));
+                _keySnapshotId = opCtx()->recoveryUnit()->getSnapshotId();
                 break;
             case HIT_END:
                 return PlanStage::IS_EOF;
@@ -224,15 +229,13 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
-    if (!kv->key.isOwned())
-        kv->key = kv->key.getOwned();
-
-    // We found something to return, so fill out the WSM.
+    // We found something to return, so fill out the WSM. The member takes an owned copy of the
+    // key, reusing its own storage where it can. A key read ahead in a batch keeps the snapshot it
+    // came from, so that a later fetch knows to check it against the document.
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = kv->loc;
-    member->keyData.push_back(IndexKeyDatum(
-        _keyPattern, kv->key, workingSetIndexId(), opCtx()->recoveryUnit()->getSnapshotId()));
+    member->appendIndexKey(_keyPattern, kv->key, workingSetIndexId(), _keySnapshotId);
     _workingSet->transitionToRecordIdAndIdx(id);
 
     if (_addKeyMetadata) {
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/db/exec/index_key_batcher.h"
 #include "mongo/db/exec/requires_index_stage.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
@@ -164,6 +165,12 @@ private:
     // Stats
     IndexScanStats _specificStats;
 
+    // Reads keys from '_indexCursor' in batches while the scan moves forward.
+    IndexKeyBatcher _keyBatcher;
+
+    // The storage snapshot which the key being examined was read from.
+    SnapshotId _keySnapshotId;
+
     // Keeps track of what work we need to do next.
     ScanState _scanState = ScanState::INITIALIZING;
 
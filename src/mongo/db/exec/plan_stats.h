@@ -190,6 +190,29 @@ struct AndHashStats : public SpecificStats {
     size_t memLimit = 0u;
 };
 
+struct BitmapMergeStats : public SpecificStats {
+    BitmapMergeStats() = default;
+
+    SpecificStats* clone() const final {
+        BitmapMergeStats* specific = new BitmapMergeStats(*this);
+        return specific;
+    }
+
+    uint64_t estimateObjectSizeInBytes() const {
+        return container_size_helper::estimateObjectSizeInBytes(recordIdsAfterChild) +
+            sizeof(*this);
+    }
+
+    // How many RecordIds are in the intersection or union of children 0 through 'i'?
+    std::vector<size_t> recordIdsAfterChild;
+
+    // What's our peak memory usage?
+    size_t memUsage = 0u;
+
+    // What's our memory limit?
+    size_t memLimit = 0u;
+};
+
 struct AndSortedStats : public SpecificStats {
     AndSortedStats() = default;
 
@@ -428,6 +451,9 @@ struct FetchStats : public SpecificStats {
 
     // The total number of full documents touched by the fetch stage.
     size_t docsExamined = 0u;
+
+    // The number of batches of members fetched in RecordId order.
+    size_t recordIdBatches = 0u;
 };
 
 struct IDHackStats : public SpecificStats {
@@ -269,9 +269,10 @@ std::unique_ptr<ProjectionExecutor> buildProjectionExecutor(
     BuilderParamsBitSet params) {
     invariant(projection);
 
-    // Fast-path can only be used with inclusion-only projections, so we need to reset the
-    // fast-path flag.
-    if (!projection->isInclusionOnly()) {
+    // Fast-path can only be used with inclusion projections which need neither the whole document
+    // nor the query's match details, so we need to reset the fast-path flag otherwise.
+    if (projection->type() != kInclusion || projection->requiresDocument() ||
+        projection->requiresMatchDetails()) {
         params.reset(kAllowFastPath);
     }
 
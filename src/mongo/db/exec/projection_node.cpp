@@ -31,6 +31,8 @@
 
 #include "mongo/db/exec/projection_node.h"
 
+#include <algorithm>
+
 namespace mongo::projection_executor {
 using ArrayRecursionPolicy = ProjectionPolicies::ArrayRecursionPolicy;
 using ComputedFieldsPolicy = ProjectionPolicies::ComputedFieldsPolicy;
@@ -195,14 +197,75 @@ void ProjectionNode::applyExpressions(const Document& root, MutableDocument* out
             outputDoc->setField(
                 field, childIt->second->applyExpressionsToValue(root, outputDoc->peek()[field]));
         } else {
-            auto expressionIt = _expressions.find(field);
-            invariant(expressionIt != _expressions.end());
-            outputDoc->setField(
-                field,
-                expressionIt->second->evaluate(
-                    root, &expressionIt->second->getExpressionContext()->variables));
+            outputDoc->setField(field, evaluateExpression(field, root));
+        }
+    }
+}
+
+bool ProjectionNode::hasOnlyTopLevelComputedFields() const {
+    return std::none_of(_children.begin(), _children.end(), [](auto&& child) {
+        return child.second->_subtreeContainsComputedFields;
+    });
+}
+
+void ProjectionNode::applyExpressionsToBson(const Document& root,
+                                            const BSONObj& input,
+                                            BSONObjBuilder* output) const {
+    dassert(hasOnlyTopLevelComputedFields());
+
+    // With no computed children, '_orderToProcessAdditionsAndChildren' names only expressions.
+    // Evaluate all of them up front in specification order, as applyExpressions() would.
+    const auto& fields = _orderToProcessAdditionsAndChildren;
+    std::vector<Value> values;
+    values.reserve(fields.size());
+    for (auto&& field : fields) {
+        values.push_back(evaluateExpression(field, root));
+    }
+
+    // A computed field that is already present keeps its position. A missing value removes it.
+    std::vector<bool> written(fields.size(), false);
+    for (auto&& elem : input) {
+        const auto fieldName = elem.fieldNameStringData();
+        auto fieldIt = std::find(fields.begin(), fields.end(), fieldName);
+        const size_t index = fieldIt - fields.begin();
+        if (fieldIt == fields.end() || written[index]) {
+            output->append(elem);
+            continue;
+        }
+        written[index] = true;
+        if (!values[index].missing()) {
+            values[index].addToBsonObj(output, fieldName);
+        }
+    }
+
+    for (size_t index = 0; index < fields.size(); ++index) {
+        if (!written[index] && !values[index].missing()) {
+            values[index].addToBsonObj(output, fields[index]);
+        }
+    }
+}
+
+Value ProjectionNode::evaluateExpression(const std::string& field, const Document& root) const {
+    if (!_expressionsCompiled) {
+        for (auto&& [name, expr] : _expressions) {
+            if (auto compiled = expression_compiler::compile(expr->getExpressionContext(),
+                                                             expr.get())) {
+                _compiledExpressions.emplace(name, std::move(compiled));
+            }
+        }
+        _expressionsCompiled = true;
+    }
+
+    if (auto compiledIt = _compiledExpressions.find(field);
+        compiledIt != _compiledExpressions.end()) {
+        if (auto result = compiledIt->second->evaluate(root)) {
+            return std::move(*result);
         }
     }
+    auto expressionIt = _expressions.find(field);
+    invariant(expressionIt != _expressions.end());
+    return expressionIt->second->evaluate(root,
+                                          &expressionIt->second->getExpressionContext()->variables);
 }
 
 Value ProjectionNode::applyExpressionsToValue(const Document& root, Value inputValue) const {
@@ -267,6 +330,8 @@ void ProjectionNode::optimize() {
     }
 
     _maxFieldsToProject = maxFieldsToProject();
+    _compiledExpressions.clear();
+    _expressionsCompiled = false;
 }
 
 Document ProjectionNode::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/projection_executor.h"
+#include "mongo/db/pipeline/expression_compiler.h"
 
 #include "mongo/db/query/projection_policies.h"
 
@@ -94,6 +95,22 @@ public:
      */
     void applyExpressions(const Document& root, MutableDocument* outputDoc) const;
 
+    /**
+     * Returns true if all of the computed fields in this tree belong to this node itself rather
+     * than to one of its descendants, which allows applyExpressionsToBson() to be used.
+     */
+    bool hasOnlyTopLevelComputedFields() const;
+
+    /**
+     * BSON counterpart of applyExpressions() for trees with only top-level computed fields. Copies
+     * 'input' into 'output', except that each computed field is evaluated against 'root' and
+     * either replaces the first element of 'input' with the same name in place, or is appended
+     * after the elements of 'input' in specification order.
+     */
+    void applyExpressionsToBson(const Document& root,
+                                const BSONObj& input,
+                                BSONObjBuilder* output) const;
+
     /**
      * Reports dependencies on any fields that are required by this projection.
      */
@@ -187,6 +204,10 @@ private:
     Value applyExpressionsToValue(const Document& root, Value inputVal) const;
     Value applyProjectionsToValue(Value inputVal) const;
 
+    // Evaluates the computed field 'field' of this node against 'root', using its compiled form
+    // if there is one.
+    Value evaluateExpression(const std::string& field, const Document& root) const;
+
     // Adds a new ProjectionNode as a child. 'field' cannot be dotted.
     ProjectionNode* addChild(const std::string& field);
 
@@ -222,6 +243,12 @@ private:
     // example above, '_orderToProcessAdditionsAndChildren' would be ["a", "b", "d"].
     std::vector<std::string> _orderToProcessAdditionsAndChildren;
 
+    // Compiled forms of the entries in '_expressions', built the first time expressions are applied
+    // and discarded by optimize(). Expressions which could not be compiled have no entry.
+    mutable stdx::unordered_map<std::string, std::unique_ptr<CompiledExpression>>
+        _compiledExpressions;
+    mutable bool _expressionsCompiled{false};
+
     // Maximum number of fields that need to be projected. This allows for an "early" return
     // optimization which means we don't have to iterate over an entire document. The value is
     // stored here to avoid re-computation for each document.
@@ -0,0 +1,262 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+bool RecordIdBitmap::Chunk::add(uint16_t value) {
+    if (isBitset()) {
+        auto& word = _bits[value / 64];
+        const auto bit = uint64_t{1} << (value % 64);
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+        ++_size;
+        return true;
+    }
+
+    auto it = std::lower_bound(_array.begin(), _array.end(), value);
+    if (it != _array.end() && *it == value) {
+        return false;
+    }
+    _array.insert(it, value);
+    ++_size;
+    if (_array.size() > kMaxArraySize) {
+        convertToBitset();
+    }
+    return true;
+}
+
+bool RecordIdBitmap::Chunk::contains(uint16_t value) const {
+    if (isBitset()) {
+        return _bits[value / 64] & (uint64_t{1} << (value % 64));
+    }
+    return std::binary_search(_array.begin(), _array.end(), value);
+}
+
+void RecordIdBitmap::Chunk::intersectWith(const Chunk& other) {
+    if (isBitset() && other.isBitset()) {
+        for (size_t i = 0; i < kNumWords; ++i) {
+            _bits[i] &= other._bits[i];
+        }
+        finishBitsetMerge();
+    } else if (isBitset()) {
+        std::vector<uint16_t> result;
+        std::copy_if(other._array.begin(),
+                     other._array.end(),
+                     std::back_inserter(result),
+                     [&](uint16_t value) { return contains(value); });
+        _array = std::move(result);
+        _bits = {};
+        _size = _array.size();
+    } else if (other.isBitset()) {
+        _array.erase(std::remove_if(_array.begin(),
+                                    _array.end(),
+                                    [&](uint16_t value) { return !other.contains(value); }),
+                     _array.end());
+        _size = _array.size();
+    } else {
+        std::vector<uint16_t> result;
+        std::set_intersection(_array.begin(),
+                              _array.end(),
+                              other._array.begin(),
+                              other._array.end(),
+                              std::back_inserter(result));
+        _array = std::move(result);
+        _size = _array.size();
+    }
+}
+
+void RecordIdBitmap::Chunk::unionWith(const Chunk& other) {
+    if (!isBitset() && !other.isBitset()) {
+        std::vector<uint16_t> result;
+        std::set_union(_array.begin(),
+                       _array.end(),
+                       other._array.begin(),
+                       other._array.end(),
+                       std::back_inserter(result));
+        _array = std::move(result);
+        _size = _array.size();
+        if (_array.size() > kMaxArraySize) {
+            convertToBitset();
+        }
+        return;
+    }
+
+    if (!isBitset()) {
+        convertToBitset();
+    }
+    if (other.isBitset()) {
+        for (size_t i = 0; i < kNumWords; ++i) {
+            _bits[i] |= other._bits[i];
+        }
+    } else {
+        for (auto value : other._array) {
+            _bits[value / 64] |= uint64_t{1} << (value % 64);
+        }
+    }
+    finishBitsetMerge();
+}
+
+bool RecordIdBitmap::Chunk::valueAt(uint32_t* pos, uint16_t* value) const {
+    if (!isBitset()) {
+        if (*pos >= _array.size()) {
+            return false;
+        }
+        *value = _array[*pos];
+        return true;
+    }
+
+    for (size_t i = *pos / 64; i < kNumWords; ++i) {
+        // Ignore the bits before 'pos' in its word.
+        auto word = _bits[i];
+        if (i == *pos / 64) {
+            word &= ~uint64_t{0} << (*pos % 64);
+        }
+        if (word) {
+            *pos = i * 64 + countTrailingZeros64(word);
+            *value = *pos;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RecordIdBitmap::Chunk::convertToBitset() {
+    invariant(!isBitset());
+    _bits.assign(kNumWords, 0);
+    for (auto value : _array) {
+        _bits[value / 64] |= uint64_t{1} << (value % 64);
+    }
+    _array = {};
+}
+
+void RecordIdBitmap::Chunk::finishBitsetMerge() {
+    invariant(isBitset());
+    size_t size = 0;
+    for (auto word : _bits) {
+        size += std::bitset<64>(word).count();
+    }
+    _size = size;
+
+    if (_size <= kMaxArraySize) {
+        _array.reserve(_size);
+        for (size_t i = 0; i < kNumWords; ++i) {
+            for (auto word = _bits[i]; word; word &= word - 1) {
+                _array.push_back(i * 64 + countTrailingZeros64(word));
+            }
+        }
+        _bits = {};
+    }
+}
+
+RecordIdBitmap::Iterator::Iterator(const RecordIdBitmap& bitmap)
+    : _chunk(bitmap._chunks.begin()), _end(bitmap._chunks.end()) {
+    skipToValue();
+}
+
+RecordId RecordIdBitmap::Iterator::next() {
+    invariant(more());
+    uint16_t value;
+    invariant(_chunk->second.valueAt(&_pos, &value));
+    const auto id = fromKey((_chunk->first << 16) | value);
+    ++_pos;
+    skipToValue();
+    return id;
+}
+
+void RecordIdBitmap::Iterator::skipToValue() {
+    uint16_t value;
+    while (_chunk != _end && !_chunk->second.valueAt(&_pos, &value)) {
+        ++_chunk;
+        _pos = 0;
+    }
+}
+
+void RecordIdBitmap::add(const RecordId& id) {
+    const auto key = toKey(id);
+    auto [it, inserted] = _chunks.try_emplace(key >> 16);
+    const auto memUsageBefore = inserted ? 0 : it->second.memUsageBytes();
+    if (it->second.add(key & 0xFFFF)) {
+        ++_size;
+    }
+    _memUsageBytes = _memUsageBytes - memUsageBefore + it->second.memUsageBytes();
+}
+
+bool RecordIdBitmap::contains(const RecordId& id) const {
+    const auto key = toKey(id);
+    auto it = _chunks.find(key >> 16);
+    return it != _chunks.end() && it->second.contains(key & 0xFFFF);
+}
+
+void RecordIdBitmap::intersectWith(const RecordIdBitmap& other) {
+    for (auto it = _chunks.begin(); it != _chunks.end(); ++it) {
+        auto otherIt = other._chunks.find(it->first);
+        if (otherIt == other._chunks.end()) {
+            it->second = Chunk();
+        } else {
+            it->second.intersectWith(otherIt->second);
+        }
+    }
+    recount();
+}
+
+void RecordIdBitmap::unionWith(const RecordIdBitmap& other) {
+    for (auto&& [chunkKey, chunk] : other._chunks) {
+        _chunks[chunkKey].unionWith(chunk);
+    }
+    recount();
+}
+
+void RecordIdBitmap::recount() {
+    _size = 0;
+    _memUsageBytes = 0;
+    for (auto it = _chunks.begin(); it != _chunks.end();) {
+        if (it->second.size() == 0) {
+            it = _chunks.erase(it);
+            continue;
+        }
+        _size += it->second.size();
+        _memUsageBytes += it->second.memUsageBytes();
+        ++it;
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,180 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A compressed set of RecordIds in the style of a roaring bitmap. The RecordIds are partitioned by
+ * their high 48 bits into chunks of 2^16 consecutive RecordIds. A chunk stores the low 16 bits of
+ * its RecordIds as a sorted array if it holds at most kMaxArraySize of them, and as a 2^16-bit
+ * bitset otherwise, so a chunk never takes more than 8KB and dense ranges of RecordIds take one bit
+ * per RecordId. Bitsets are intersected and unioned a 64-bit word at a time, in loops which the
+ * compiler vectorizes.
+ *
+ * Iteration returns the RecordIds in increasing order.
+ */
+class RecordIdBitmap {
+    // The RecordIds which share their high 48 bits.
+    class Chunk {
+    public:
+        /**
+         * Returns true if 'value' wasn't in the chunk already.
+         */
+        bool add(uint16_t value);
+        bool contains(uint16_t value) const;
+        void intersectWith(const Chunk& other);
+        void unionWith(const Chunk& other);
+
+        /**
+         * Returns the first value in the chunk at or after position 'pos', and sets 'pos' to its
+         * position. Returns false if there is none.
+         */
+        bool valueAt(uint32_t* pos, uint16_t* value) const;
+
+        size_t size() const {
+            return _size;
+        }
+
+        size_t memUsageBytes() const {
+            return sizeof(Chunk) + _array.capacity() * sizeof(uint16_t) +
+                _bits.capacity() * sizeof(uint64_t);
+        }
+
+    private:
+        static constexpr size_t kNumWords = (1 << 16) / 64;
+
+        bool isBitset() const {
+            return !_bits.empty();
+        }
+
+        void convertToBitset();
+
+        // Converts a bitset back to an array once it holds few enough values, and recounts them.
+        void finishBitsetMerge();
+
+        // The sorted values if the chunk is an array, and empty otherwise.
+        std::vector<uint16_t> _array;
+
+        // The bits of the values if the chunk is a bitset, and empty otherwise.
+        std::vector<uint64_t> _bits;
+
+        uint32_t _size = 0;
+    };
+
+public:
+    // The largest number of RecordIds a chunk stores as an array rather than a bitset, which is
+    // where the array reaches the size of the bitset.
+    static constexpr size_t kMaxArraySize = 4096;
+
+    class Iterator {
+    public:
+        bool more() const {
+            return _chunk != _end;
+        }
+
+        RecordId next();
+
+    private:
+        friend class RecordIdBitmap;
+
+        explicit Iterator(const RecordIdBitmap& bitmap);
+
+        // Positions '_pos' on the next value in '_chunk', or moves to the next chunk if there is
+        // none.
+        void skipToValue();
+
+        std::map<uint64_t, Chunk>::const_iterator _chunk;
+        std::map<uint64_t, Chunk>::const_iterator _end;
+
+        // The index of the next value in an array chunk, or of the next set bit in a bitset chunk.
+        uint32_t _pos = 0;
+    };
+
+    /**
+     * Adds 'id' to the set. Has no effect if it is already in it.
+     */
+    void add(const RecordId& id);
+
+    bool contains(const RecordId& id) const;
+
+    /**
+     * Removes the RecordIds which are not in 'other' from this set.
+     */
+    void intersectWith(const RecordIdBitmap& other);
+
+    /**
+     * Adds the RecordIds of 'other' to this set.
+     */
+    void unionWith(const RecordIdBitmap& other);
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    size_t memUsageBytes() const {
+        return _memUsageBytes;
+    }
+
+    Iterator iterator() const {
+        return Iterator(*this);
+    }
+
+private:
+    friend class Iterator;
+
+    // Converts between RecordIds and keys, which are their repr values with the sign bit flipped so
+    // that they sort as unsigned values. The high 48 bits of a key select its chunk.
+    static uint64_t toKey(const RecordId& id) {
+        return static_cast<uint64_t>(id.repr()) ^ (uint64_t{1} << 63);
+    }
+    static RecordId fromKey(uint64_t key) {
+        return RecordId(static_cast<int64_t>(key ^ (uint64_t{1} << 63)));
+    }
+
+    // Recomputes '_size' and '_memUsageBytes', and drops the empty chunks.
+    void recount();
+
+    std::map<uint64_t, Chunk> _chunks;
+    size_t _size = 0;
+    size_t _memUsageBytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <set>
+#include <vector>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<RecordId> toVector(const RecordIdBitmap& bitmap) {
+    std::vector<RecordId> out;
+    for (auto it = bitmap.iterator(); it.more();) {
+        out.push_back(it.next());
+    }
+    return out;
+}
+
+RecordIdBitmap makeBitmap(const std::set<RecordId>& ids) {
+    RecordIdBitmap bitmap;
+    for (auto&& id : ids) {
+        bitmap.add(id);
+    }
+    return bitmap;
+}
+
+/**
+ * Returns 'n' random RecordIds in [1, 'range'].
+ */
+std::set<RecordId> randomIds(PseudoRandom* random, size_t n, int64_t range) {
+    std::set<RecordId> ids;
+    for (size_t i = 0; i < n; ++i) {
+        ids.insert(RecordId(1 + random->nextInt64(range)));
+    }
+    return ids;
+}
+
+TEST(RecordIdBitmapTest, IteratesInRecordIdOrder) {
+    RecordIdBitmap bitmap;
+    ASSERT(bitmap.empty());
+    ASSERT_FALSE(bitmap.iterator().more());
+
+    const std::vector<RecordId> ids{RecordId(RecordId::kMinRepr),
+                                    RecordId(-5),
+                                    RecordId(3),
+                                    RecordId(65535),
+                                    RecordId(65536),
+                                    RecordId(int64_t{1} << 40),
+                                    RecordId(RecordId::kMaxRepr)};
+    for (auto it = ids.rbegin(); it != ids.rend(); ++it) {
+        bitmap.add(*it);
+        bitmap.add(*it);
+    }
+
+    ASSERT_EQ(ids.size(), bitmap.size());
+    ASSERT(ids == toVector(bitmap));
+    for (auto&& id : ids) {
+        ASSERT(bitmap.contains(id));
+    }
+    ASSERT_FALSE(bitmap.contains(RecordId(4)));
+}
+
+TEST(RecordIdBitmapTest, DenseChunkUsesBitset) {
+    RecordIdBitmap bitmap;
+    for (int64_t i = 0; i < (1 << 16); ++i) {
+        bitmap.add(RecordId(i));
+    }
+    ASSERT_EQ(size_t(1) << 16, bitmap.size());
+
+    // A full chunk takes one bit per RecordId.
+    ASSERT_LT(bitmap.memUsageBytes(), size_t(9 * 1024));
+
+    auto it = bitmap.iterator();
+    for (int64_t i = 0; i < (1 << 16); ++i) {
+        ASSERT(it.more());
+        ASSERT_EQ(RecordId(i), it.next());
+    }
+    ASSERT_FALSE(it.more());
+}
+
+TEST(RecordIdBitmapTest, IntersectionAndUnionMatchSets) {
+    PseudoRandom random(1234);
+
+    // Cover array and bitset chunks, and all combinations of both.
+    for (auto [leftCount, rightCount] : std::vector<std::pair<size_t, size_t>>{
+             {100, 200}, {100, 20000}, {20000, 100}, {20000, 30000}}) {
+        const auto left = randomIds(&random, leftCount, 3 * (1 << 16));
+        const auto right = randomIds(&random, rightCount, 3 * (1 << 16));
+
+        std::vector<RecordId> expectedIntersection;
+        std::set_intersection(left.begin(),
+                              left.end(),
+                              right.begin(),
+                              right.end(),
+                              std::back_inserter(expectedIntersection));
+        auto intersection = makeBitmap(left);
+        intersection.intersectWith(makeBitmap(right));
+        ASSERT_EQ(expectedIntersection.size(), intersection.size());
+        ASSERT(expectedIntersection == toVector(intersection));
+
+        std::vector<RecordId> expectedUnion;
+        std::set_union(left.begin(),
+                       left.end(),
+                       right.begin(),
+                       right.end(),
+                       std::back_inserter(expectedUnion));
+        auto unionBitmap = makeBitmap(left);
+        unionBitmap.unionWith(makeBitmap(right));
+        ASSERT_EQ(expectedUnion.size(), unionBitmap.size());
+        ASSERT(expectedUnion == toVector(unionBitmap));
+    }
+}
+
+TEST(RecordIdBitmapTest, DisjointIntersectionIsEmpty) {
+    auto bitmap = makeBitmap({RecordId(1), RecordId(2)});
+    bitmap.intersectWith(makeBitmap({RecordId(1 << 20)}));
+    ASSERT(bitmap.empty());
+    ASSERT_EQ(0U, bitmap.memUsageBytes());
+    ASSERT_FALSE(bitmap.iterator().more());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -122,6 +122,36 @@ std::unique_ptr<EExpression> EPrimBinary::clone() const {
 std::unique_ptr<vm::CodeFragment> EPrimBinary::compile(CompileCtx& ctx) const {
     auto code = std::make_unique<vm::CodeFragment>();
 
+    // Comparisons against a constant are compiled into a single instruction carrying the constant
+    // as an immediate operand rather than into a push of the constant followed by the comparison.
+    if (auto constant = dynamic_cast<const EConstant*>(_nodes[1].get()); constant) {
+        auto appendImm = [&]() -> void (vm::CodeFragment::*)(value::TypeTags, value::Value) {
+            switch (_op) {
+                case EPrimBinary::less:
+                    return &vm::CodeFragment::appendLessImm;
+                case EPrimBinary::lessEq:
+                    return &vm::CodeFragment::appendLessEqImm;
+                case EPrimBinary::greater:
+                    return &vm::CodeFragment::appendGreaterImm;
+                case EPrimBinary::greaterEq:
+                    return &vm::CodeFragment::appendGreaterEqImm;
+                case EPrimBinary::eq:
+                    return &vm::CodeFragment::appendEqImm;
+                case EPrimBinary::neq:
+                    return &vm::CodeFragment::appendNeqImm;
+                default:
+                    return nullptr;
+            }
+        }();
+
+        if (appendImm) {
+            auto [tag, val] = constant->getConstant();
+            code->append(_nodes[0]->compile(ctx));
+            (*code.*appendImm)(tag, val);
+            return code;
+        }
+    }
+
     auto lhs = _nodes[0]->compile(ctx);
     auto rhs = _nodes[1]->compile(ctx);
 
@@ -360,6 +390,9 @@ static stdx::unordered_map<std::string, BuiltinFn> kBuiltinFunctions = {
     {"addToSet", BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::addToSet, true}},
     {"doubleDoubleSum",
      BuiltinFn{[](size_t n) { return n > 0; }, vm::Builtin::doubleDoubleSum, true}},
+    {"eqLookupMatch",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::eqLookupMatch, false}},
+    {"eqLookupKey", BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::eqLookupKey, false}},
 };
 
 /**
@@ -447,6 +480,17 @@ std::unique_ptr<vm::CodeFragment> EFunction::compile(CompileCtx& ctx) const {
             code->appendAccessVal(ctx.accumulator);
         }
 
+        // A field lookup by a constant name is compiled into a single instruction carrying the
+        // name as an immediate operand.
+        if (_name == "getField") {
+            if (auto constant = dynamic_cast<const EConstant*>(_nodes[1].get()); constant) {
+                auto [tag, val] = constant->getConstant();
+                code->append(_nodes[0]->compile(ctx));
+                code->appendGetFieldImm(tag, val);
+                return code;
+            }
+        }
+
         // The order of evaluation is flipped for instruction functions. We may want to change the
         // evaluation code for those functions so we have the same behavior for all functions.
         for (size_t idx = 0; idx < _nodes.size(); ++idx) {
@@ -171,6 +171,13 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    /**
+     * Returns a non-owned view of the constant.
+     */
+    std::pair<value::TypeTags, value::Value> getConstant() const {
+        return {_tag, _val};
+    }
+
 private:
     value::TypeTags _tag;
     value::Value _val;
@@ -284,6 +291,10 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    const std::string& name() const {
+        return _name;
+    }
+
 private:
     std::string _name;
 };
@@ -33,6 +33,7 @@
 #include "mongo/db/exec/sbe/parser/parser.h"
 
 #include "mongo/db/exec/sbe/stages/branch.h"
+#include "mongo/db/exec/sbe/stages/bson_scan.h"
 #include "mongo/db/exec/sbe/stages/co_scan.h"
 #include "mongo/db/exec/sbe/stages/exchange.h"
 #include "mongo/db/exec/sbe/stages/filter.h"
@@ -60,10 +61,10 @@ static std::string format_error_message(size_t ln, size_t col, const std::string
 
 static constexpr auto kSyntax = R"(
                 ROOT <- OPERATOR
-                OPERATOR <- SCAN / PSCAN / SEEK / IXSCAN / IXSEEK / PROJECT / FILTER / CFILTER /
-                            MKOBJ / GROUP / HJOIN / NLJOIN / LIMIT / SKIP / COSCAN / TRAVERSE /
-                            EXCHANGE / SORT / UNWIND / UNION / BRANCH / SIMPLE_PROJ / PFO /
-                            ESPOOL / LSPOOL / CSPOOL / SSPOOL
+                OPERATOR <- SCAN / PSCAN / SEEK / IXSCAN / IXSEEK / BSCAN / PROJECT / FILTER /
+                            CFILTER / MKOBJ / GROUP / HJOIN / NLJOIN / LIMIT / SKIP / COSCAN /
+                            TRAVERSE / EXCHANGE / SORT / UNWIND / UNION / BRANCH / SIMPLE_PROJ /
+                            PFO / ESPOOL / LSPOOL / CSPOOL / SSPOOL
 
                 FORWARD_FLAG <- <'true'> / <'false'>
 
@@ -100,6 +101,10 @@ static constexpr auto kSyntax = R"(
                                    IDENT # index name to scan
                                    FORWARD_FLAG # forward scan or not
 
+                BSCAN <- 'bscan' IDENT? # optional variable name of the root object delivered by the scan
+                                 IDENT_LIST_WITH_RENAMES  # list of projected fields (may be empty)
+                                 IDENT # name of the BSON input registered with the parser
+
                 PROJECT <- 'project' PROJECT_LIST OPERATOR
                 SIMPLE_PROJ <- '$p' IDENT # output
                                     IDENT # input
@@ -742,6 +747,36 @@ void Parser::walkIndexSeek(AstQuery& ast) {
                                       nullptr);
 }
 
+void Parser::walkBSONScan(AstQuery& ast) {
+    walkChildren(ast);
+
+    std::string recordName;
+    int projectsPos;
+    int inputPos;
+
+    if (ast.nodes.size() == 3) {
+        recordName = std::move(ast.nodes[0]->identifier);
+        projectsPos = 1;
+        inputPos = 2;
+    } else if (ast.nodes.size() == 2) {
+        projectsPos = 0;
+        inputPos = 1;
+    } else {
+        MONGO_UNREACHABLE;
+    }
+
+    auto it = _bsonInputs.find(ast.nodes[inputPos]->identifier);
+    uassert(4885907,
+            str::stream() << "Unknown BSON input [" << ast.nodes[inputPos]->identifier << "]",
+            it != _bsonInputs.end());
+
+    ast.stage = makeS<BSONScanStage>(it->second.first,
+                                     it->second.second,
+                                     lookupSlot(recordName),
+                                     ast.nodes[projectsPos]->identifiers,
+                                     lookupSlots(ast.nodes[projectsPos]->renames));
+}
+
 void Parser::walkProject(AstQuery& ast) {
     walkChildren(ast);
 
@@ -1329,6 +1364,9 @@ void Parser::walk(AstQuery& ast) {
         case "IXSEEK"_:
             walkIndexSeek(ast);
             break;
+        case "BSCAN"_:
+            walkBSONScan(ast);
+            break;
         case "PROJECT"_:
             walkProject(ast);
             break;
@@ -1474,6 +1512,10 @@ Parser::Parser() {
     _parser.enable_ast<AstQuery>();
 }
 
+void Parser::addBSONInput(std::string name, const char* bsonBegin, const char* bsonEnd) {
+    _bsonInputs[std::move(name)] = {bsonBegin, bsonEnd};
+}
+
 std::unique_ptr<PlanStage> Parser::parse(OperationContext* opCtx,
                                          StringData defaultDb,
                                          StringData line) {
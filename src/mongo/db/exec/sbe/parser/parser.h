@@ -64,6 +64,12 @@ public:
                                      StringData defaultDb,
                                      StringData line);
 
+    /**
+     * Makes the buffer of concatenated BSON objects [bsonBegin, bsonEnd) available to the 'bscan'
+     * operator under the given name. The buffer must outlive any plan parsed from it.
+     */
+    void addBSONInput(std::string name, const char* bsonBegin, const char* bsonEnd);
+
     std::pair<boost::optional<value::SlotId>, boost::optional<value::SlotId>> getTopLevelSlots()
         const {
         return {_resultSlot, _recordIdSlot};
@@ -77,6 +83,7 @@ private:
     std::string _defaultDb;
     SymbolTable _symbolsLookupTable;
     SpoolBufferLookupTable _spoolBuffersLookupTable;
+    stdx::unordered_map<std::string, std::pair<const char*, const char*>> _bsonInputs;
     value::SlotIdGenerator _slotIdGenerator;
     value::SpoolIdGenerator _spoolIdGenerator;
     FrameId _frameId{0};
@@ -193,6 +200,7 @@ private:
     void walkSeek(AstQuery& ast);
     void walkIndexScan(AstQuery& ast);
     void walkIndexSeek(AstQuery& ast);
+    void walkBSONScan(AstQuery& ast);
     void walkProject(AstQuery& ast);
     void walkFilter(AstQuery& ast);
     void walkCFilter(AstQuery& ast);
@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Benchmarks for SBE plans built with the SBE text parser and run over synthetic BSON. Every
+ * benchmark runs twice: without and with timing info collection, so the overhead of the
+ * per-stage cycle counters shows up as the difference between the two.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/parser/parser.h"
+
+namespace mongo::sbe {
+namespace {
+
+constexpr size_t kNumDocs = 10000;
+constexpr auto kInputName = "input"_sd;
+
+/**
+ * Returns a buffer of 'kNumDocs' concatenated documents of the form
+ * {a: <i % 10>, b: "x", c: <i>, d: <i * 7919 % kNumDocs>}.
+ */
+BufBuilder makeInput() {
+    BufBuilder buffer;
+    for (size_t i = 0; i < kNumDocs; ++i) {
+        auto obj = BSON("a" << static_cast<int>(i % 10) << "b"
+                            << "x"
+                            << "c" << static_cast<int>(i) << "d"
+                            << static_cast<int>(i * 7919 % kNumDocs));
+        buffer.appendBuf(obj.objdata(), obj.objsize());
+    }
+    return buffer;
+}
+
+size_t sumInstrsExecuted(const PlanStageStats& stats) {
+    auto total = stats.common.instrsExecuted;
+    for (auto&& child : stats.children) {
+        total += sumInstrsExecuted(*child);
+    }
+    return total;
+}
+
+/**
+ * Parses 'plan' and runs it to completion on every iteration, reporting the documents scanned
+ * per second along with the VM instructions and, when timing info is collected, the cycles
+ * spent per scanned document.
+ */
+void runPlan(benchmark::State& state, StringData plan) {
+    const bool collectTimingInfo = state.range(0);
+    auto input = makeInput();
+
+    Parser parser;
+    parser.addBSONInput(kInputName.toString(), input.buf(), input.buf() + input.len());
+    auto root = parser.parse(nullptr, "test"_sd, plan);
+    if (collectTimingInfo) {
+        root->markShouldCollectTimingInfo();
+    }
+
+    CompileCtx ctx;
+    root->prepare(ctx);
+
+    size_t runs = 0;
+    size_t results = 0;
+    for (auto _ : state) {
+        root->open(runs > 0);
+        while (root->getNext() == PlanState::ADVANCED) {
+            ++results;
+        }
+        root->close();
+        ++runs;
+    }
+    benchmark::DoNotOptimize(results);
+
+    auto stats = root->getStats();
+    const auto docsScanned = static_cast<double>(runs * kNumDocs);
+    state.SetItemsProcessed(runs * kNumDocs);
+    state.counters["instrsPerDoc"] = sumInstrsExecuted(*stats) / docsScanned;
+    if (stats->common.executionCycles) {
+        state.counters["cyclesPerDoc"] = *stats->common.executionCycles / docsScanned;
+    }
+}
+
+void BM_Scan(benchmark::State& state) {
+    runPlan(state, "bscan [va = a, vc = c] input");
+}
+
+void BM_Filter(benchmark::State& state) {
+    runPlan(state, "filter {va == 5} bscan [va = a] input");
+}
+
+void BM_Project(benchmark::State& state) {
+    runPlan(state, "project [ve = vc * 2 + 1] bscan [vc = c] input");
+}
+
+void BM_FilterProject(benchmark::State& state) {
+    runPlan(state,
+            "project [ve = vc * 2 + 1] "
+            "filter {va == 5 && vc > 100} "
+            "bscan [va = a, vc = c] input");
+}
+
+void BM_Group(benchmark::State& state) {
+    runPlan(state, "group [va] [s = sum(vc)] bscan [va = a, vc = c] input");
+}
+
+void BM_Sort(benchmark::State& state) {
+    runPlan(state, "sort [vd] [vc] bscan [vc = c, vd = d] input");
+}
+
+BENCHMARK(BM_Scan)->Arg(false)->Arg(true);
+BENCHMARK(BM_Filter)->Arg(false)->Arg(true);
+BENCHMARK(BM_Project)->Arg(false)->Arg(true);
+BENCHMARK(BM_FilterProject)->Arg(false)->Arg(true);
+BENCHMARK(BM_Group)->Arg(false)->Arg(true);
+BENCHMARK(BM_Sort)->Arg(false)->Arg(true);
+
+}  // namespace
+}  // namespace mongo::sbe
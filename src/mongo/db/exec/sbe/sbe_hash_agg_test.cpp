@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * This file contains tests for sbe::HashAggStage.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sbe/stages/bson_scan.h"
+#include "mongo/db/exec/sbe/stages/hash_agg.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo::sbe {
+namespace {
+class HashAggStageTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _oldDbPath = storageGlobalParams.dbpath;
+        storageGlobalParams.dbpath = _tempDir.path();
+
+        // Build documents of the form {a: i % 10, b: i}.
+        for (int i = 0; i < 100; ++i) {
+            auto obj = BSON("a" << (i % 10) << "b" << i);
+            _buffer.appendBuf(obj.objdata(), obj.objsize());
+        }
+    }
+
+    void tearDown() override {
+        storageGlobalParams.dbpath = _oldDbPath;
+    }
+
+    /**
+     * Builds a HashAggStage grouping the test documents by 'a' and computing the aggregate
+     * function 'aggName' over 'b'.
+     */
+    std::unique_ptr<PlanStage> makeHashAgg(StringData aggName,
+                                           bool allowDiskUse,
+                                           boost::optional<size_t> memoryLimit) {
+        auto scan = makeS<BSONScanStage>(_buffer.buf(),
+                                         _buffer.buf() + _buffer.len(),
+                                         boost::none,
+                                         std::vector<std::string>{"a", "b"},
+                                         makeSV(kGroupSlot, kInputSlot));
+        return makeS<HashAggStage>(
+            std::move(scan),
+            makeSV(kGroupSlot),
+            makeEM(kAggSlot,
+                   makeE<EFunction>(aggName.toString(), makeEs(makeE<EVariable>(kInputSlot)))),
+            allowDiskUse,
+            memoryLimit);
+    }
+
+    /**
+     * Runs the given stage to completion and returns the aggregated values by group.
+     */
+    std::map<int32_t, int64_t> runHashAgg(PlanStage* stage) {
+        CompileCtx ctx;
+        stage->prepare(ctx);
+        auto groupAccessor = stage->getAccessor(ctx, kGroupSlot);
+        auto aggAccessor = stage->getAccessor(ctx, kAggSlot);
+
+        std::map<int32_t, int64_t> results;
+        stage->open(false);
+        while (stage->getNext() == PlanState::ADVANCED) {
+            auto [groupTag, groupVal] = groupAccessor->getViewOfValue();
+            auto [aggTag, aggVal] = aggAccessor->getViewOfValue();
+            ASSERT_EQ(groupTag, value::TypeTags::NumberInt32);
+            ASSERT(value::isNumber(aggTag));
+
+            auto [it, inserted] =
+                results.emplace(value::bitcastTo<int32_t>(groupVal),
+                                value::numericCast<int64_t>(aggTag, aggVal));
+            ASSERT(inserted);
+        }
+        stage->close();
+
+        return results;
+    }
+
+    void assertResults(const std::map<int32_t, int64_t>& results,
+                       std::function<int64_t(int32_t)> expected) {
+        ASSERT_EQ(results.size(), 10U);
+        for (auto&& [group, value] : results) {
+            ASSERT_EQ(value, expected(group));
+        }
+    }
+
+    static constexpr value::SlotId kGroupSlot = 1;
+    static constexpr value::SlotId kInputSlot = 2;
+    static constexpr value::SlotId kAggSlot = 3;
+
+    unittest::TempDir _tempDir{"sbe_hash_agg_test"};
+    std::string _oldDbPath;
+    BufBuilder _buffer;
+};
+
+TEST_F(HashAggStageTest, AggregatesInMemory) {
+    auto stage = makeHashAgg("sum", false, boost::none);
+    assertResults(runHashAgg(stage.get()), [](int32_t group) { return 10 * group + 450; });
+}
+
+TEST_F(HashAggStageTest, SpilledSumMatchesInMemorySum) {
+    // A memory limit of one byte forces a spill after every new group.
+    auto stage = makeHashAgg("sum", true, 1);
+    assertResults(runHashAgg(stage.get()), [](int32_t group) { return 10 * group + 450; });
+}
+
+TEST_F(HashAggStageTest, SpilledMinAndMax) {
+    auto minStage = makeHashAgg("min", true, 1);
+    assertResults(runHashAgg(minStage.get()), [](int32_t group) { return group; });
+
+    auto maxStage = makeHashAgg("max", true, 1);
+    assertResults(runHashAgg(maxStage.get()), [](int32_t group) { return group + 90; });
+}
+
+TEST_F(HashAggStageTest, SpilledFirstAndLastPreserveInputOrder) {
+    auto firstStage = makeHashAgg("first", true, 1);
+    assertResults(runHashAgg(firstStage.get()), [](int32_t group) { return group; });
+
+    auto lastStage = makeHashAgg("last", true, 1);
+    assertResults(runHashAgg(lastStage.get()), [](int32_t group) { return group + 90; });
+}
+
+TEST_F(HashAggStageTest, ExceedingMemoryLimitWithoutDiskUseFails) {
+    auto stage = makeHashAgg("sum", false, 1);
+    ASSERT_THROWS_CODE(
+        runHashAgg(stage.get()), DBException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+}
+}  // namespace
+}  // namespace mongo::sbe
@@ -0,0 +1,178 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * This file contains tests for sbe::HashJoinStage.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/stages/bson_scan.h"
+#include "mongo/db/exec/sbe/stages/hash_join.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo::sbe {
+namespace {
+using JoinResult = std::tuple<int32_t, int32_t, int32_t>;
+
+class HashJoinStageTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _oldDbPath = storageGlobalParams.dbpath;
+        storageGlobalParams.dbpath = _tempDir.path();
+
+        // Build outer documents of the form {k: i, v: i} and inner documents of the form
+        // {k: i % 40, v: i}, so that only half of the inner documents find a match.
+        for (int i = 0; i < 20; ++i) {
+            auto obj = BSON("k" << i << "v" << i);
+            _outerBuffer.appendBuf(obj.objdata(), obj.objsize());
+        }
+        for (int i = 0; i < 100; ++i) {
+            auto obj = BSON("k" << (i % 40) << "v" << i);
+            _innerBuffer.appendBuf(obj.objdata(), obj.objsize());
+        }
+    }
+
+    void tearDown() override {
+        storageGlobalParams.dbpath = _oldDbPath;
+    }
+
+    std::unique_ptr<PlanStage> makeHashJoin(bool allowDiskUse,
+                                            boost::optional<size_t> memoryLimit) {
+        auto outer = makeS<BSONScanStage>(_outerBuffer.buf(),
+                                          _outerBuffer.buf() + _outerBuffer.len(),
+                                          boost::none,
+                                          std::vector<std::string>{"k", "v"},
+                                          makeSV(kOuterKeySlot, kOuterValueSlot));
+        auto inner = makeS<BSONScanStage>(_innerBuffer.buf(),
+                                          _innerBuffer.buf() + _innerBuffer.len(),
+                                          boost::none,
+                                          std::vector<std::string>{"k", "v"},
+                                          makeSV(kInnerKeySlot, kInnerValueSlot));
+        return makeS<HashJoinStage>(std::move(outer),
+                                    std::move(inner),
+                                    makeSV(kOuterKeySlot),
+                                    makeSV(kOuterValueSlot),
+                                    makeSV(kInnerKeySlot),
+                                    makeSV(kInnerValueSlot),
+                                    allowDiskUse,
+                                    memoryLimit);
+    }
+
+    /**
+     * Runs the given stage to completion 'numRuns' times and returns the sorted (key, outer value,
+     * inner value) triples produced by the last run.
+     */
+    std::vector<JoinResult> runHashJoin(PlanStage* stage, size_t numRuns = 1) {
+        CompileCtx ctx;
+        stage->prepare(ctx);
+        auto keyAccessor = stage->getAccessor(ctx, kInnerKeySlot);
+        auto outerAccessor = stage->getAccessor(ctx, kOuterValueSlot);
+        auto innerAccessor = stage->getAccessor(ctx, kInnerValueSlot);
+
+        auto getInt = [](value::SlotAccessor* accessor) {
+            auto [tag, val] = accessor->getViewOfValue();
+            ASSERT_EQ(tag, value::TypeTags::NumberInt32);
+            return value::bitcastTo<int32_t>(val);
+        };
+
+        std::vector<JoinResult> results;
+        for (size_t run = 0; run < numRuns; ++run) {
+            results.clear();
+            stage->open(run > 0);
+            while (stage->getNext() == PlanState::ADVANCED) {
+                results.emplace_back(
+                    getInt(keyAccessor), getInt(outerAccessor), getInt(innerAccessor));
+            }
+            stage->close();
+        }
+
+        std::sort(results.begin(), results.end());
+        return results;
+    }
+
+    static std::vector<JoinResult> expectedResults() {
+        std::vector<JoinResult> results;
+        for (int i = 0; i < 100; ++i) {
+            if (i % 40 < 20) {
+                results.emplace_back(i % 40, i % 40, i);
+            }
+        }
+        std::sort(results.begin(), results.end());
+        return results;
+    }
+
+    static constexpr value::SlotId kOuterKeySlot = 1;
+    static constexpr value::SlotId kOuterValueSlot = 2;
+    static constexpr value::SlotId kInnerKeySlot = 3;
+    static constexpr value::SlotId kInnerValueSlot = 4;
+
+    unittest::TempDir _tempDir{"sbe_hash_join_test"};
+    std::string _oldDbPath;
+    BufBuilder _outerBuffer;
+    BufBuilder _innerBuffer;
+};
+
+TEST_F(HashJoinStageTest, JoinsInMemory) {
+    auto stage = makeHashJoin(false, boost::none);
+    ASSERT(runHashJoin(stage.get()) == expectedResults());
+}
+
+TEST_F(HashJoinStageTest, PartitionedJoinMatchesInMemoryJoin) {
+    // A memory limit of one byte forces the join to partition after the first outer row.
+    auto stage = makeHashJoin(true, 1);
+    ASSERT(runHashJoin(stage.get()) == expectedResults());
+}
+
+TEST_F(HashJoinStageTest, JoinCanBeReopened) {
+    auto stage = makeHashJoin(false, boost::none);
+    ASSERT(runHashJoin(stage.get(), 2) == expectedResults());
+}
+
+TEST_F(HashJoinStageTest, PartitionedJoinCanBeReopened) {
+    auto stage = makeHashJoin(true, 1);
+    ASSERT(runHashJoin(stage.get(), 2) == expectedResults());
+}
+
+TEST_F(HashJoinStageTest, ExceedingMemoryLimitWithoutDiskUseFails) {
+    auto stage = makeHashJoin(false, 1);
+    ASSERT_THROWS_CODE(
+        runHashJoin(stage.get()), DBException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+}
+}  // namespace
+}  // namespace mongo::sbe
@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for sbe::SortStage.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/stages/bson_scan.h"
+#include "mongo/db/exec/sbe/stages/sort.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo::sbe {
+namespace {
+using SortResult = std::pair<int32_t, int32_t>;
+
+constexpr size_t kNoLimit = std::numeric_limits<size_t>::max();
+
+class SortStageTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _oldDbPath = storageGlobalParams.dbpath;
+        storageGlobalParams.dbpath = _tempDir.path();
+
+        // Build documents of the form {k: <permutation of 0..99>, v: i}.
+        for (int i = 0; i < kNumDocs; ++i) {
+            auto obj = BSON("k" << (i * 37) % kNumDocs << "v" << i);
+            _buffer.appendBuf(obj.objdata(), obj.objsize());
+        }
+    }
+
+    void tearDown() override {
+        storageGlobalParams.dbpath = _oldDbPath;
+    }
+
+    std::unique_ptr<PlanStage> makeSort(size_t limit, size_t memoryLimit, bool allowDiskUse) {
+        auto scan = makeS<BSONScanStage>(_buffer.buf(),
+                                         _buffer.buf() + _buffer.len(),
+                                         boost::none,
+                                         std::vector<std::string>{"k", "v"},
+                                         makeSV(kKeySlot, kValueSlot));
+        return makeS<SortStage>(std::move(scan),
+                                makeSV(kKeySlot),
+                                std::vector<value::SortDirection>{value::SortDirection::Descending},
+                                makeSV(kValueSlot),
+                                limit,
+                                memoryLimit,
+                                allowDiskUse,
+                                nullptr);
+    }
+
+    /**
+     * Runs the given stage to completion 'numRuns' times and returns the (key, value) pairs
+     * produced by the last run in the order they were returned.
+     */
+    std::vector<SortResult> runSort(PlanStage* stage, size_t numRuns = 1) {
+        CompileCtx ctx;
+        stage->prepare(ctx);
+        auto keyAccessor = stage->getAccessor(ctx, kKeySlot);
+        auto valueAccessor = stage->getAccessor(ctx, kValueSlot);
+
+        auto getInt = [](value::SlotAccessor* accessor) {
+            auto [tag, val] = accessor->getViewOfValue();
+            ASSERT_EQ(tag, value::TypeTags::NumberInt32);
+            return value::bitcastTo<int32_t>(val);
+        };
+
+        std::vector<SortResult> results;
+        for (size_t run = 0; run < numRuns; ++run) {
+            results.clear();
+            stage->open(run > 0);
+            while (stage->getNext() == PlanState::ADVANCED) {
+                results.emplace_back(getInt(keyAccessor), getInt(valueAccessor));
+            }
+            stage->close();
+        }
+        return results;
+    }
+
+    static std::vector<SortResult> expectedResults(size_t limit) {
+        std::vector<SortResult> results;
+        for (int i = 0; i < kNumDocs; ++i) {
+            results.emplace_back((i * 37) % kNumDocs, i);
+        }
+        std::sort(results.begin(), results.end(), [](auto&& lhs, auto&& rhs) {
+            return lhs.first > rhs.first;
+        });
+        results.resize(std::min(results.size(), limit));
+        return results;
+    }
+
+    static constexpr int kNumDocs = 100;
+    static constexpr value::SlotId kKeySlot = 1;
+    static constexpr value::SlotId kValueSlot = 2;
+    static constexpr size_t kLargeMemoryLimit = 100 * 1024 * 1024;
+
+    unittest::TempDir _tempDir{"sbe_sort_test"};
+    std::string _oldDbPath;
+    BufBuilder _buffer;
+};
+
+TEST_F(SortStageTest, SortsInMemory) {
+    auto stage = makeSort(kNoLimit, kLargeMemoryLimit, false);
+    ASSERT(runSort(stage.get()) == expectedResults(kNoLimit));
+}
+
+TEST_F(SortStageTest, SpilledSortMatchesInMemorySort) {
+    // A memory limit of one byte spills after every row.
+    auto stage = makeSort(kNoLimit, 1, true);
+    ASSERT(runSort(stage.get()) == expectedResults(kNoLimit));
+}
+
+TEST_F(SortStageTest, TopKInMemory) {
+    auto stage = makeSort(7, kLargeMemoryLimit, false);
+    ASSERT(runSort(stage.get()) == expectedResults(7));
+}
+
+TEST_F(SortStageTest, SpilledTopKMatchesInMemoryTopK) {
+    auto stage = makeSort(7, 1, true);
+    ASSERT(runSort(stage.get()) == expectedResults(7));
+}
+
+TEST_F(SortStageTest, SortCanBeReopenedAfterSpilling) {
+    auto stage = makeSort(7, 1, true);
+    ASSERT(runSort(stage.get(), 2) == expectedResults(7));
+}
+
+TEST_F(SortStageTest, ExceedingMemoryLimitWithoutDiskUseFails) {
+    auto stage = makeSort(7, 1, false);
+    ASSERT_THROWS_CODE(
+        runSort(stage.get()), DBException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+}
+}  // namespace
+}  // namespace mongo::sbe
@@ -27,6 +27,9 @@
  *    it in the license file.
  */
 
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/parser/parser.h"
 #include "mongo/db/exec/sbe/values/value.h"
 #include "mongo/db/exec/sbe/vm/vm.h"
 #include "mongo/unittest/unittest.h"
@@ -80,6 +83,46 @@ TEST(SBEValues, Basic) {
     }
 }
 
+TEST(SBEValues, PushBackGrowsEmptyContainers) {
+    {
+        const auto [tag, val] = value::makeNewArray();
+        auto arr = value::getArrayView(val);
+        ASSERT_EQUALS(arr->size(), 0);
+
+        for (int32_t i = 0; i < 10; ++i) {
+            arr->push_back(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(i));
+        }
+
+        ASSERT_EQUALS(arr->size(), 10);
+        for (int32_t i = 0; i < 10; ++i) {
+            const auto [elemTag, elemVal] = arr->getAt(i);
+            ASSERT_EQUALS(elemTag, value::TypeTags::NumberInt32);
+            ASSERT_EQUALS(value::bitcastTo<int32_t>(elemVal), i);
+        }
+
+        value::releaseValue(tag, val);
+    }
+    {
+        const auto [tag, val] = value::makeNewObject();
+        auto obj = value::getObjectView(val);
+        ASSERT_EQUALS(obj->size(), 0);
+
+        for (int32_t i = 0; i < 10; ++i) {
+            obj->push_back(
+                std::to_string(i), value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(i));
+        }
+
+        ASSERT_EQUALS(obj->size(), 10);
+        for (int32_t i = 0; i < 10; ++i) {
+            const auto [fieldTag, fieldVal] = obj->getField(std::to_string(i));
+            ASSERT_EQUALS(fieldTag, value::TypeTags::NumberInt32);
+            ASSERT_EQUALS(value::bitcastTo<int32_t>(fieldVal), i);
+        }
+
+        value::releaseValue(tag, val);
+    }
+}
+
 TEST(SBEValues, Hash) {
     auto tagInt32 = value::TypeTags::NumberInt32;
     auto valInt32 = value::bitcastFrom<int32_t>(-5);
@@ -159,4 +202,193 @@ TEST(SBEVM, Add) {
     }
 }
 
+
+TEST(SBEVM, CompareImmediateMatchesCompare) {
+    auto tagLhs = value::TypeTags::NumberInt32;
+    auto valLhs = value::bitcastFrom<int32_t>(3);
+
+    auto tagRhs = value::TypeTags::NumberDouble;
+    auto valRhs = value::bitcastFrom<double>(5.0);
+
+    using AppendFn = void (vm::CodeFragment::*)();
+    using AppendImmFn = void (vm::CodeFragment::*)(value::TypeTags, value::Value);
+    std::vector<std::pair<AppendFn, AppendImmFn>> comparisons = {
+        {&vm::CodeFragment::appendLess, &vm::CodeFragment::appendLessImm},
+        {&vm::CodeFragment::appendLessEq, &vm::CodeFragment::appendLessEqImm},
+        {&vm::CodeFragment::appendGreater, &vm::CodeFragment::appendGreaterImm},
+        {&vm::CodeFragment::appendGreaterEq, &vm::CodeFragment::appendGreaterEqImm},
+        {&vm::CodeFragment::appendEq, &vm::CodeFragment::appendEqImm},
+        {&vm::CodeFragment::appendNeq, &vm::CodeFragment::appendNeqImm}};
+
+    for (auto [append, appendImm] : comparisons) {
+        vm::CodeFragment code;
+        code.appendConstVal(tagLhs, valLhs);
+        code.appendConstVal(tagRhs, valRhs);
+        (code.*append)();
+
+        vm::CodeFragment codeImm;
+        codeImm.appendConstVal(tagLhs, valLhs);
+        (codeImm.*appendImm)(tagRhs, valRhs);
+        ASSERT_EQUALS(codeImm.stackSize(), 1);
+
+        vm::ByteCode interpreter;
+        auto [owned, tag, val] = interpreter.run(&code);
+        auto [ownedImm, tagImm, valImm] = interpreter.run(&codeImm);
+
+        ASSERT_EQUALS(tagImm, value::TypeTags::Boolean);
+        ASSERT_EQUALS(tag, tagImm);
+        ASSERT_EQUALS(val, valImm);
+    }
+}
+
+TEST(SBEVM, GetFieldImmediate) {
+    auto obj = BSON("a" << 1 << "b" << 2);
+    auto tagObj = value::TypeTags::bsonObject;
+    auto valObj = value::bitcastFrom(obj.objdata());
+
+    auto [tagField, valField] = value::makeNewString("b");
+
+    vm::CodeFragment code;
+    code.appendConstVal(tagObj, valObj);
+    code.appendGetFieldImm(tagField, valField);
+    code.appendEqImm(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(2));
+
+    vm::ByteCode interpreter;
+    ASSERT_TRUE(interpreter.runPredicate(&code));
+
+    value::releaseValue(tagField, valField);
+}
+
+namespace {
+bool runEqLookupMatch(value::TypeTags localTag,
+                      value::Value localVal,
+                      value::TypeTags foreignTag,
+                      value::Value foreignVal) {
+    vm::CodeFragment code;
+    code.appendConstVal(localTag, localVal);
+    code.appendConstVal(foreignTag, foreignVal);
+    code.appendFunction(vm::Builtin::eqLookupMatch, 2);
+
+    vm::ByteCode interpreter;
+    auto [owned, tag, val] = interpreter.run(&code);
+    ASSERT_FALSE(owned);
+    ASSERT_EQUALS(tag, value::TypeTags::Boolean);
+    return val != 0;
+}
+}  // namespace
+
+TEST(SBEVM, EqLookupMatch) {
+    const auto one = value::bitcastFrom<int32_t>(1);
+    const auto two = value::bitcastFrom<int64_t>(2);
+
+    // Scalars match by value, across numeric types.
+    ASSERT_TRUE(runEqLookupMatch(value::TypeTags::NumberInt32,
+                                 one,
+                                 value::TypeTags::NumberDouble,
+                                 value::bitcastFrom<double>(1.0)));
+    ASSERT_FALSE(runEqLookupMatch(
+        value::TypeTags::NumberInt32, one, value::TypeTags::NumberInt64, two));
+
+    // A missing local value behaves like null, and matches null or missing foreign values.
+    ASSERT_TRUE(runEqLookupMatch(value::TypeTags::Nothing, 0, value::TypeTags::Null, 0));
+    ASSERT_TRUE(runEqLookupMatch(value::TypeTags::Null, 0, value::TypeTags::Nothing, 0));
+    ASSERT_FALSE(runEqLookupMatch(value::TypeTags::Nothing, 0, value::TypeTags::NumberInt32, one));
+
+    auto [tagForeign, valForeign] = value::makeNewArray();
+    value::ValueGuard foreignGuard{tagForeign, valForeign};
+    auto foreign = value::getArrayView(valForeign);
+    foreign->push_back(value::TypeTags::NumberInt64, two);
+    foreign->push_back(value::TypeTags::Null, 0);
+
+    // A foreign array matches if any of its elements does.
+    ASSERT_TRUE(runEqLookupMatch(
+        value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(2), tagForeign, valForeign));
+    ASSERT_TRUE(runEqLookupMatch(value::TypeTags::Nothing, 0, tagForeign, valForeign));
+    ASSERT_FALSE(runEqLookupMatch(value::TypeTags::NumberInt32, one, tagForeign, valForeign));
+
+    // An empty local array joins like a missing value.
+    auto [tagLocal, valLocal] = value::makeNewArray();
+    value::ValueGuard localGuard{tagLocal, valLocal};
+    ASSERT_TRUE(runEqLookupMatch(tagLocal, valLocal, value::TypeTags::Null, 0));
+    ASSERT_TRUE(runEqLookupMatch(tagLocal, valLocal, tagForeign, valForeign));
+    ASSERT_FALSE(runEqLookupMatch(tagLocal, valLocal, value::TypeTags::NumberInt32, one));
+
+    // A local array matches if any of its elements does.
+
+    auto local = value::getArrayView(valLocal);
+    local->push_back(value::TypeTags::NumberInt32, one);
+    ASSERT_FALSE(runEqLookupMatch(tagLocal, valLocal, value::TypeTags::NumberInt64, two));
+    local->push_back(value::TypeTags::NumberInt64, two);
+    ASSERT_TRUE(runEqLookupMatch(tagLocal, valLocal, value::TypeTags::NumberInt64, two));
+    ASSERT_TRUE(runEqLookupMatch(tagLocal, valLocal, tagForeign, valForeign));
+}
+
+TEST(SBEVM, EqLookupKey) {
+    auto runEqLookupKey = [](const BSONObj& doc, std::string_view field) {
+        vm::CodeFragment code;
+        code.appendConstVal(value::TypeTags::bsonObject, value::bitcastFrom(doc.objdata()));
+        auto [fieldTag, fieldVal] = value::makeNewString(field);
+        value::ValueGuard fieldGuard{fieldTag, fieldVal};
+        code.appendConstVal(fieldTag, fieldVal);
+        code.appendFunction(vm::Builtin::eqLookupKey, 2);
+
+        vm::ByteCode interpreter;
+        auto [owned, tag, val] = interpreter.run(&code);
+        ASSERT_FALSE(owned);
+        return tag;
+    };
+
+    const auto doc = BSON("a" << 1 << "b" << BSON_ARRAY(1 << BSON("c" << 2)) << "re"
+                              << BSONRegEx("^a") << "nested" << BSON_ARRAY(1 << BSONRegEx("^a")));
+    ASSERT_EQUALS(runEqLookupKey(doc, "a"), value::TypeTags::NumberInt32);
+    ASSERT_EQUALS(runEqLookupKey(doc, "b"), value::TypeTags::bsonArray);
+    ASSERT_EQUALS(runEqLookupKey(doc, "missing"), value::TypeTags::Nothing);
+
+    // A regex would read as Nothing and join like a missing value, so it fails the join instead.
+    ASSERT_THROWS_CODE(runEqLookupKey(doc, "re"), AssertionException, 4798623);
+    ASSERT_THROWS_CODE(runEqLookupKey(doc, "nested"), AssertionException, 4798623);
+}
+
+TEST(SBEPlanStats, CollectsCyclesAndInstructionsPerStage) {
+    BufBuilder input;
+    for (int i = 0; i < 10; ++i) {
+        auto obj = BSON("a" << i);
+        input.appendBuf(obj.objdata(), obj.objsize());
+    }
+
+    Parser parser;
+    parser.addBSONInput("input", input.buf(), input.buf() + input.len());
+    auto root = parser.parse(nullptr, "test", "filter {va < 3} bscan [va = a] input");
+    ASSERT_FALSE(root->getCommonStats()->executionCycles);
+    root->markShouldCollectTimingInfo();
+
+    CompileCtx ctx;
+    root->prepare(ctx);
+    root->open(false);
+    size_t results = 0;
+    while (root->getNext() == PlanState::ADVANCED) {
+        ++results;
+    }
+    root->close();
+    ASSERT_EQ(results, 3);
+
+    auto stats = root->getStats();
+    ASSERT_EQ(stats->common.advances, 3);
+    ASSERT_TRUE(stats->common.executionCycles);
+    ASSERT_GT(stats->common.instrsExecuted, 0);
+
+    // The filter's cycles include those of the scan below it, which runs no expressions.
+    ASSERT_EQ(stats->children.size(), 1);
+    auto&& scanStats = stats->children[0];
+    ASSERT_TRUE(scanStats->common.executionCycles);
+    ASSERT_LTE(*scanStats->common.executionCycles, *stats->common.executionCycles);
+    ASSERT_EQ(scanStats->common.instrsExecuted, 0);
+}
+
+TEST(SBEPlanStats, BSONScanRejectsUnknownInput) {
+    Parser parser;
+    ASSERT_THROWS_CODE(
+        parser.parse(nullptr, "test", "bscan [va = a] input"), AssertionException, 4885907);
+}
+
 }  // namespace mongo::sbe
@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/values/slot.h"
+#include "mongo/db/exec/sbe/vm/vm.h"
+
+namespace mongo::sbe {
+namespace {
+
+constexpr value::SlotId kInputSlot = 1;
+constexpr size_t kNumRows = 1000;
+
+std::vector<BSONObj> makeRows() {
+    std::vector<BSONObj> rows;
+    rows.reserve(kNumRows);
+    for (size_t i = 0; i < kNumRows; ++i) {
+        rows.push_back(BSON("a" << static_cast<int>(i % 10) << "b"
+                                << "x"));
+    }
+    return rows;
+}
+
+/**
+ * Runs a predicate over every row and reports rows and VM instructions per second.
+ */
+void runFilter(benchmark::State& state, vm::CodeFragment* code, value::ViewOfValueAccessor* input) {
+    auto rows = makeRows();
+    vm::ByteCode interpreter;
+    size_t rowsProcessed = 0;
+    size_t matched = 0;
+
+    for (auto _ : state) {
+        for (auto&& row : rows) {
+            input->reset(value::TypeTags::bsonObject, value::bitcastFrom(row.objdata()));
+            matched += interpreter.runPredicate(code);
+        }
+        rowsProcessed += rows.size();
+    }
+    benchmark::DoNotOptimize(matched);
+
+    state.SetItemsProcessed(rowsProcessed);
+    state.counters["instrsPerRow"] = code->instrCount();
+    state.counters["instrsPerSecond"] = benchmark::Counter(
+        static_cast<double>(rowsProcessed * code->instrCount()), benchmark::Counter::kIsRate);
+}
+
+/**
+ * The filter {a: 5} as the stage builders generate it; the compiler fuses the constant operands
+ * into the getField and comparison instructions.
+ */
+void BM_FilterCompiled(benchmark::State& state) {
+    value::ViewOfValueAccessor input;
+    auto expr = makeE<EPrimBinary>(
+        EPrimBinary::eq,
+        makeE<EFunction>("getField",
+                         makeEs(makeE<EVariable>(kInputSlot), makeE<EConstant>("a"))),
+        makeE<EConstant>(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(5)));
+
+    CompileCtx ctx;
+    ctx.pushCorrelated(kInputSlot, &input);
+    auto code = expr->compile(ctx);
+
+    runFilter(state, code.get(), &input);
+}
+
+/**
+ * The same filter with every operand pushed on the stack separately.
+ */
+void BM_FilterUnfused(benchmark::State& state) {
+    value::ViewOfValueAccessor input;
+    auto [fieldTag, fieldVal] = value::makeNewString("a");
+
+    vm::CodeFragment code;
+    code.appendAccessVal(&input);
+    code.appendConstVal(fieldTag, fieldVal);
+    code.appendGetField();
+    code.appendConstVal(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(5));
+    code.appendEq();
+
+    runFilter(state, &code, &input);
+
+    value::releaseValue(fieldTag, fieldVal);
+}
+
+BENCHMARK(BM_FilterCompiled);
+BENCHMARK(BM_FilterUnfused);
+
+}  // namespace
+}  // namespace mongo::sbe
@@ -104,6 +104,8 @@ value::SlotAccessor* BranchStage::getAccessor(CompileCtx& ctx, value::SlotId slo
 }
 
 void BranchStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _specificStats.numTested++;
 
@@ -128,6 +130,8 @@ void BranchStage::open(bool reOpen) {
 }
 
 PlanState BranchStage::getNext() {
+    auto optTimer(getOptTimer());
+
     if (!_activeBranch) {
         return trackPlanState(PlanState::IS_EOF);
     }
@@ -154,6 +158,8 @@ PlanState BranchStage::getNext() {
 }
 
 void BranchStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
 
     if (_thenOpened) {
@@ -168,6 +174,7 @@ void BranchStage::close() {
 
 std::unique_ptr<PlanStageStats> BranchStage::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->common.instrsExecuted = _bytecode.instrsExecuted();
     ret->specific = std::make_unique<FilterStats>(_specificStats);
     ret->children.emplace_back(_children[0]->getStats());
     ret->children.emplace_back(_children[1]->getStats());
@@ -80,11 +80,15 @@ value::SlotAccessor* BSONScanStage::getAccessor(CompileCtx& ctx, value::SlotId s
 }
 
 void BSONScanStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _bsonCurrent = _bsonBegin;
 }
 
 PlanState BSONScanStage::getNext() {
+    auto optTimer(getOptTimer());
+
     if (_bsonCurrent < _bsonEnd) {
         if (_recordAccessor) {
             _recordAccessor->reset(value::TypeTags::bsonObject,
@@ -127,6 +131,8 @@ PlanState BSONScanStage::getNext() {
 }
 
 void BSONScanStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
 }
 
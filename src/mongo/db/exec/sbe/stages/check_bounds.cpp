@@ -67,12 +67,16 @@ value::SlotAccessor* CheckBoundsStage::getAccessor(CompileCtx& ctx, value::SlotI
 }
 
 void CheckBoundsStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
     _isEOF = false;
 }
 
 PlanState CheckBoundsStage::getNext() {
+    auto optTimer(getOptTimer());
+
     if (_isEOF) {
         return trackPlanState(PlanState::IS_EOF);
     }
@@ -117,6 +121,8 @@ PlanState CheckBoundsStage::getNext() {
 }
 
 void CheckBoundsStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
     _children[0]->close();
 }
@@ -44,10 +44,14 @@ value::SlotAccessor* CoScanStage::getAccessor(CompileCtx& ctx, value::SlotId slo
 }
 
 void CoScanStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
 }
 
 PlanState CoScanStage::getNext() {
+    auto optTimer(getOptTimer());
+
     checkForInterrupt(_opCtx);
 
     // Run forever.
@@ -65,6 +69,8 @@ const SpecificStats* CoScanStage::getSpecificStats() const {
 }
 
 void CoScanStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
 }
 
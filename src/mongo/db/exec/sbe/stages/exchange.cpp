@@ -33,8 +33,14 @@
 
 #include "mongo/base/init.h"
 #include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/fail_point.h"
 
 namespace mongo::sbe {
+namespace {
+MONGO_FAIL_POINT_DEFINE(hangExchangeProducerBeforeGetNext);
+}  // namespace
+
 std::unique_ptr<ThreadPool> s_globalThreadPool;
 MONGO_INITIALIZER(s_globalThreadPool)(InitializerContext* context) {
     ThreadPool::Options options;
@@ -194,6 +200,8 @@ value::SlotAccessor* ExchangeConsumer::getAccessor(CompileCtx& ctx, value::SlotI
     return ctx.getAccessor(slot);
 }
 void ExchangeConsumer::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
 
     if (reOpen) {
@@ -245,6 +253,7 @@ void ExchangeConsumer::open(bool reOpen) {
             }
 
             // Start n producers.
+            _state->setParentOpCtx(_opCtx);
             for (size_t idx = 0; idx < _state->numOfProducers(); ++idx) {
                 auto pf = makePromiseFuture<void>();
                 s_globalThreadPool->schedule(
@@ -252,6 +261,10 @@ void ExchangeConsumer::open(bool reOpen) {
                         invariant(status);
 
                         auto opCtx = cc().makeOperationContext();
+                        if (auto parent = _state->parentOpCtx(); parent && parent->hasDeadline()) {
+                            opCtx->setDeadlineByDate(parent->getDeadline(),
+                                                     parent->getTimeoutError());
+                        }
 
                         promise.setWith([&] {
                             ExchangeProducer::start(opCtx.get(),
@@ -284,6 +297,8 @@ void ExchangeConsumer::open(bool reOpen) {
 }
 
 PlanState ExchangeConsumer::getNext() {
+    auto optTimer(getOptTimer());
+
     if (_orderPreserving) {
         // Build a heap and return min element.
         uasserted(4822834, "ordere exchange not yet implemented");
@@ -291,7 +306,9 @@ PlanState ExchangeConsumer::getNext() {
         while (_eofs < _state->numOfProducers()) {
             auto buffer = getBuffer(0);
             if (!buffer) {
-                // early out
+                // early out. A producer stops early when the operation is interrupted, which must
+                // not look like the end of the results.
+                _opCtx->checkForInterrupt();
                 return trackPlanState(PlanState::IS_EOF);
             }
             if (_bufferPos[0] < buffer->count()) {
@@ -316,6 +333,8 @@ PlanState ExchangeConsumer::getNext() {
     return trackPlanState(PlanState::IS_EOF);
 }
 void ExchangeConsumer::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
 
     {
@@ -483,6 +502,8 @@ value::SlotAccessor* ExchangeProducer::getAccessor(CompileCtx& ctx, value::SlotI
     return _children[0]->getAccessor(ctx, slot);
 }
 void ExchangeProducer::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     if (reOpen) {
         uasserted(4822839, "exchange producer cannot be reopened");
@@ -505,8 +526,24 @@ bool ExchangeProducer::appendData(size_t consumerId) {
     return true;
 }
 
+void ExchangeProducer::checkForParentInterrupt() {
+    if (auto parent = _state->parentOpCtx()) {
+        if (auto killCode = parent->getKillStatus(); killCode != ErrorCodes::OK) {
+            uasserted(killCode, "The operation running the exchange was killed");
+        }
+    }
+}
+
 PlanState ExchangeProducer::getNext() {
+    auto optTimer(getOptTimer());
+
+    hangExchangeProducerBeforeGetNext.pauseWhileSet();
+    checkForParentInterrupt();
+
     while (_children[0]->getNext() == PlanState::ADVANCED) {
+        // The stages below check the operation of this producer, which has the parent's deadline.
+        checkForParentInterrupt();
+
         // Push to the correct pipe.
         switch (_state->policy()) {
             case ExchangePolicy::broadcast: {
@@ -547,6 +584,8 @@ PlanState ExchangeProducer::getNext() {
     return trackPlanState(PlanState::IS_EOF);
 }
 void ExchangeProducer::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
     _children[0]->close();
 }
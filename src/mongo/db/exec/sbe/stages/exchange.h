@@ -212,6 +212,17 @@ public:
     }
     ExchangePipe* pipe(size_t consumerTid, size_t producerTid);
 
+    /**
+     * The operation on whose behalf the producers run. Each producer runs under an operation
+     * context of its own, which inherits the deadline of this one, and stops when it is killed.
+     */
+    void setParentOpCtx(OperationContext* opCtx) {
+        _parentOpCtx = opCtx;
+    }
+    OperationContext* parentOpCtx() const {
+        return _parentOpCtx;
+    }
+
 private:
     const ExchangePolicy _policy;
     const size_t _numOfProducers;
@@ -219,6 +230,7 @@ private:
     std::vector<ExchangeProducer*> _producers;
     std::vector<std::unique_ptr<PlanStage>> _producerPlans;
     std::vector<Future<void>> _producerResults;
+    OperationContext* _parentOpCtx{nullptr};
 
     // Variables (fields) that pass through the exchange.
     const value::SlotVector _fields;
@@ -317,6 +329,11 @@ private:
     void closePipes();
     bool appendData(size_t consumerId);
 
+    /**
+     * Throws if the operation on whose behalf this producer runs has been killed.
+     */
+    void checkForParentInterrupt();
+
     std::shared_ptr<ExchangeState> _state;
     size_t _tid{0};
     size_t _roundRobinCounter{0};
@@ -67,6 +67,8 @@ public:
     }
 
     void open(bool reOpen) final {
+        auto optTimer(getOptTimer());
+
         _commonStats.opens++;
 
         if constexpr (IsConst) {
@@ -83,6 +85,8 @@ public:
     }
 
     PlanState getNext() final {
+        auto optTimer(getOptTimer());
+
         // The constant filter evaluates the predicate in the open method.
         if constexpr (IsConst) {
             if (!_childOpened) {
@@ -115,6 +119,8 @@ public:
     }
 
     void close() final {
+        auto optTimer(getOptTimer());
+
         _commonStats.closes++;
 
         if (_childOpened) {
@@ -125,6 +131,7 @@ public:
 
     std::unique_ptr<PlanStageStats> getStats() const {
         auto ret = std::make_unique<PlanStageStats>(_commonStats);
+        ret->common.instrsExecuted = _bytecode.instrsExecuted();
         ret->specific = std::make_unique<FilterStats>(_specificStats);
         ret->children.emplace_back(_children[0]->getStats());
         return ret;
@@ -31,23 +31,86 @@
 
 #include "mongo/db/exec/sbe/stages/hash_agg.h"
 
+#include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/util/str.h"
 
+namespace {
+std::string nextFileName() {
+    static mongo::AtomicWord<unsigned> hashAggFileCounter;
+    return "extsort-hash-agg-sbe." + std::to_string(hashAggFileCounter.fetchAndAdd(1));
+}
+}  // namespace
+
 namespace mongo {
 namespace sbe {
+namespace {
+/**
+ * Returns the function which appends an instruction combining two partial results of the given
+ * aggregate expression, or nullptr if the partial results of the aggregate cannot be combined.
+ */
+void (vm::CodeFragment::*getMergeInstruction(const EExpression* expr))() {
+    auto func = dynamic_cast<const EFunction*>(expr);
+    if (!func) {
+        return nullptr;
+    }
+
+    const auto& name = func->name();
+    if (name == "sum") {
+        return &vm::CodeFragment::appendSum;
+    } else if (name == "min") {
+        return &vm::CodeFragment::appendMin;
+    } else if (name == "max") {
+        return &vm::CodeFragment::appendMax;
+    } else if (name == "first") {
+        return &vm::CodeFragment::appendFirst;
+    } else if (name == "last") {
+        return &vm::CodeFragment::appendLast;
+    }
+
+    return nullptr;
+}
+
+/**
+ * Compares the group-by keys of two materialized rows.
+ */
+int compareKeys(const value::MaterializedRow& lhs, const value::MaterializedRow& rhs) {
+    for (size_t idx = 0; idx < lhs._fields.size(); ++idx) {
+        auto [lhsTag, lhsVal] = lhs._fields[idx].getViewOfValue();
+        auto [rhsTag, rhsVal] = rhs._fields[idx].getViewOfValue();
+        auto [tag, val] = value::compareValue(lhsTag, lhsVal, rhsTag, rhsVal);
+        invariant(tag == value::TypeTags::NumberInt32);
+        if (auto result = value::bitcastTo<int32_t>(val); result != 0) {
+            return result;
+        }
+    }
+
+    return 0;
+}
+}  // namespace
+
 HashAggStage::HashAggStage(std::unique_ptr<PlanStage> input,
                            value::SlotVector gbs,
-                           value::SlotMap<std::unique_ptr<EExpression>> aggs)
-    : PlanStage("group"_sd), _gbs(std::move(gbs)), _aggs(std::move(aggs)) {
+                           value::SlotMap<std::unique_ptr<EExpression>> aggs,
+                           bool allowDiskUse,
+                           boost::optional<size_t> memoryLimit)
+    : PlanStage("group"_sd),
+      _gbs(std::move(gbs)),
+      _aggs(std::move(aggs)),
+      _allowDiskUse(allowDiskUse),
+      _memoryLimit(memoryLimit) {
     _children.emplace_back(std::move(input));
 }
 
+HashAggStage::~HashAggStage() {}
+
 std::unique_ptr<PlanStage> HashAggStage::clone() const {
     value::SlotMap<std::unique_ptr<EExpression>> aggs;
     for (auto& [k, v] : _aggs) {
         aggs.emplace(k, v->clone());
     }
-    return std::make_unique<HashAggStage>(_children[0]->clone(), _gbs, std::move(aggs));
+    return std::make_unique<HashAggStage>(
+        _children[0]->clone(), _gbs, std::move(aggs), _allowDiskUse, _memoryLimit);
 }
 
 void HashAggStage::prepare(CompileCtx& ctx) {
@@ -61,10 +124,15 @@ void HashAggStage::prepare(CompileCtx& ctx) {
         uassert(4822827, str::stream() << "duplicate field: " << slot, inserted);
 
         _inKeyAccessors.emplace_back(_children[0]->getAccessor(ctx, slot));
-        _outKeyAccessors.emplace_back(std::make_unique<HashKeyAccessor>(_htIt, counter++));
-        _outAccessors[slot] = _outKeyAccessors.back().get();
+        std::vector<std::unique_ptr<value::SlotAccessor>> accessors;
+        accessors.emplace_back(std::make_unique<HashKeyAccessor>(_htIt, counter));
+        accessors.emplace_back(std::make_unique<SpilledKeyAccessor>(_mergeDataIt, counter));
+        _outAccessors.emplace(slot, value::SwitchAccessor{std::move(accessors)});
+        ++counter;
     }
+    _seekKeys._fields.resize(_inKeyAccessors.size());
 
+    _canSpill = true;
     counter = 0;
     for (auto& [slot, expr] : _aggs) {
         auto [it, inserted] = dupCheck.emplace(slot);
@@ -74,8 +142,11 @@ void HashAggStage::prepare(CompileCtx& ctx) {
         const auto slotId = slot;
         uassert(4822828, str::stream() << "duplicate field: " << slotId, inserted);
 
-        _outAggAccessors.emplace_back(std::make_unique<HashAggAccessor>(_htIt, counter++));
-        _outAccessors[slot] = _outAggAccessors.back().get();
+        _outAggAccessors.emplace_back(std::make_unique<HashAggAccessor>(_htIt, counter));
+        std::vector<std::unique_ptr<value::SlotAccessor>> accessors;
+        accessors.emplace_back(std::make_unique<HashAggAccessor>(_htIt, counter));
+        accessors.emplace_back(std::make_unique<SpilledAggAccessor>(_mergeDataIt, counter));
+        _outAccessors.emplace(slot, value::SwitchAccessor{std::move(accessors)});
 
         ctx.root = this;
         ctx.aggExpression = true;
@@ -83,6 +154,24 @@ void HashAggStage::prepare(CompileCtx& ctx) {
 
         _aggCodes.emplace_back(expr->compile(ctx));
         ctx.aggExpression = false;
+
+        // Generate the code to combine two partial results of this aggregate, in case we need to
+        // spill.
+        if (auto mergeInstruction = getMergeInstruction(expr.get()); mergeInstruction) {
+            _mergeAccAccessors.emplace_back(
+                std::make_unique<SpilledAggAccessor>(_mergeDataIt, counter));
+            _mergePartialAccessors.emplace_back(
+                std::make_unique<SpilledAggAccessor>(_nextMergeDataIt, counter));
+
+            auto code = std::make_unique<vm::CodeFragment>();
+            code->appendAccessVal(_mergeAccAccessors.back().get());
+            code->appendAccessVal(_mergePartialAccessors.back().get());
+            (*code.*mergeInstruction)();
+            _mergeCodes.emplace_back(std::move(code));
+        } else {
+            _canSpill = false;
+        }
+        ++counter;
     }
     _compiled = true;
 }
@@ -90,7 +179,7 @@ void HashAggStage::prepare(CompileCtx& ctx) {
 value::SlotAccessor* HashAggStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
     if (_compiled) {
         if (auto it = _outAccessors.find(slot); it != _outAccessors.end()) {
-            return it->second;
+            return &it->second;
         }
     } else {
         return _children[0]->getAccessor(ctx, slot);
@@ -99,22 +188,109 @@ value::SlotAccessor* HashAggStage::getAccessor(CompileCtx& ctx, value::SlotId sl
     return ctx.getAccessor(slot);
 }
 
+void HashAggStage::spill() {
+    uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+            str::stream() << "Exceeded memory limit for hash aggregation of " << *_memoryLimit
+                          << " bytes, but did not opt in to external sorting. Aborting operation."
+                          << " Pass allowDiskUse:true to opt in.",
+            _allowDiskUse);
+    uassert(5009100,
+            "Exceeded memory limit for hash aggregation, but its aggregates cannot be spilled",
+            _canSpill);
+
+    SortOptions opts;
+    opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+    if (_spillFileName.empty()) {
+        _spillFileName = opts.tempDir + "/" + nextFileName();
+    }
+
+    std::vector<TableType::iterator> sorted;
+    sorted.reserve(_ht.size());
+    for (auto it = _ht.begin(); it != _ht.end(); ++it) {
+        sorted.push_back(it);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+        return compareKeys(lhs->first, rhs->first) < 0;
+    });
+
+    SortedFileWriter<value::MaterializedRow, value::MaterializedRow> writer{
+        opts, _spillFileName, _nextSpillFileOffset};
+    const auto runIndex = static_cast<int64_t>(_iters.size());
+    for (auto& it : sorted) {
+        // Tag every row with the index of the run it belongs to.
+        it->second._fields.emplace_back();
+        it->second._fields.back().reset(
+            false, value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(runIndex));
+        writer.addAlreadySorted(it->first, it->second);
+    }
+    _ht.clear();
+    _memUsage = 0;
+
+    _iters.push_back(std::shared_ptr<SorterIterator>(writer.done()));
+    _nextSpillFileOffset = writer.getFileEndOffset();
+}
+
+bool HashAggStage::advanceMerged() {
+    if (!_hasNextMergeData) {
+        if (!_mergeIt->more()) {
+            return false;
+        }
+        _nextMergeData = _mergeIt->next();
+    }
+
+    _mergeData = std::move(_nextMergeData);
+    _hasNextMergeData = false;
+
+    // Fold all partial aggregates of the same group into '_mergeData'. The runs are merged in key
+    // order and, for equal keys, in the order in which they were spilled.
+    while (_mergeIt->more()) {
+        _nextMergeData = _mergeIt->next();
+        if (compareKeys(_mergeData.first, _nextMergeData.first) != 0) {
+            _hasNextMergeData = true;
+            break;
+        }
+
+        for (size_t idx = 0; idx < _mergeCodes.size(); ++idx) {
+            auto [owned, tag, val] = _bytecode.run(_mergeCodes[idx].get());
+            _mergeAccAccessors[idx]->reset(owned, tag, val);
+        }
+    }
+
+    return true;
+}
+
 void HashAggStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
 
+    // A re-opened stage (e.g. on the inner side of a loop join) must group its new input from
+    // scratch rather than accumulate into the groups of the previous run.
+    _ht.clear();
+    _memUsage = 0;
+    _iters.clear();
+    _mergeIt.reset();
+    _hasNextMergeData = false;
+    _nextSpillFileOffset = 0;
+    for (auto&& [_, acc] : _outAccessors) {
+        acc.setIndex(0);
+    }
+
     while (_children[0]->getNext() == PlanState::ADVANCED) {
-        value::MaterializedRow key;
-        key._fields.resize(_inKeyAccessors.size());
         // Copy keys in order to do the lookup.
         size_t idx = 0;
         for (auto& p : _inKeyAccessors) {
             auto [tag, val] = p->getViewOfValue();
-            key._fields[idx++].reset(false, tag, val);
+            _seekKeys._fields[idx++].reset(false, tag, val);
         }
 
-        auto [it, inserted] = _ht.emplace(std::move(key), value::MaterializedRow{});
-        if (inserted) {
+        // Only allocate a new hash table entry if the group is not in the table yet.
+        bool inserted = false;
+        auto it = _ht.find(_seekKeys);
+        if (it == _ht.end()) {
+            it = _ht.emplace(_seekKeys, value::MaterializedRow{}).first;
+            inserted = true;
             // Copy keys.
             const_cast<value::MaterializedRow&>(it->first).makeOwned();
             // Initialize accumulators.
@@ -127,14 +303,58 @@ void HashAggStage::open(bool reOpen) {
             auto [owned, tag, val] = _bytecode.run(_aggCodes[idx].get());
             _outAggAccessors[idx]->reset(owned, tag, val);
         }
+
+        if (_memoryLimit) {
+            if (inserted) {
+                _memUsage += it->first.memUsageForSorter() + it->second.memUsageForSorter();
+            }
+
+            if (_memUsage > *_memoryLimit) {
+                spill();
+            }
+        }
     }
 
     _children[0]->close();
 
+    if (!_iters.empty()) {
+        // Spill the last part that still sits in memory, and merge all the runs.
+        if (!_ht.empty()) {
+            spill();
+        }
+
+        SortOptions opts;
+        opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+        _mergeIt.reset(SorterIterator::merge(
+            _iters, _spillFileName, opts, [](const SorterData& lhs, const SorterData& rhs) {
+                if (auto result = compareKeys(lhs.first, rhs.first); result != 0) {
+                    return result;
+                }
+
+                auto lhsRun = value::bitcastTo<int64_t>(
+                    lhs.second._fields.back().getViewOfValue().second);
+                auto rhsRun = value::bitcastTo<int64_t>(
+                    rhs.second._fields.back().getViewOfValue().second);
+                return lhsRun < rhsRun ? -1 : (lhsRun > rhsRun ? 1 : 0);
+            }));
+
+        // Switch all output accessors to point to the spilled data.
+        for (auto&& [_, acc] : _outAccessors) {
+            acc.setIndex(1);
+        }
+    }
+
     _htIt = _ht.end();
 }
 
 PlanState HashAggStage::getNext() {
+    auto optTimer(getOptTimer());
+
+    // When the table was spilled to disk then read back the merged groups.
+    if (_mergeIt) {
+        return trackPlanState(advanceMerged() ? PlanState::ADVANCED : PlanState::IS_EOF);
+    }
+
     if (_htIt == _ht.end()) {
         _htIt = _ht.begin();
     } else {
@@ -150,6 +370,7 @@ PlanState HashAggStage::getNext() {
 
 std::unique_ptr<PlanStageStats> HashAggStage::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->common.instrsExecuted = _bytecode.instrsExecuted();
     ret->children.emplace_back(_children[0]->getStats());
     return ret;
 }
@@ -159,7 +380,11 @@ const SpecificStats* HashAggStage::getSpecificStats() const {
 }
 
 void HashAggStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
+    _mergeIt.reset();
+    _iters.clear();
 }
 
 std::vector<DebugPrinter::Block> HashAggStage::debugPrint() const {
@@ -197,3 +422,5 @@ std::vector<DebugPrinter::Block> HashAggStage::debugPrint() const {
 }
 }  // namespace sbe
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
@@ -36,13 +36,33 @@
 #include "mongo/db/exec/sbe/vm/vm.h"
 #include "mongo/stdx/unordered_map.h"
 
+namespace mongo {
+template <typename Key, typename Value>
+class SortIteratorInterface;
+}  // namespace mongo
+
 namespace mongo {
 namespace sbe {
+/**
+ * This is a hash aggregation plan stage. It groups the rows produced by its child by the values of
+ * the 'gbs' slots and computes the 'aggs' aggregate expressions for every group.
+ *
+ * If 'memoryLimit' is provided, the stage keeps track of the approximate size of the hash table.
+ * Once the limit is exceeded, the table is sorted by the group-by key and spilled to disk as a run
+ * of partial aggregates, provided that 'allowDiskUse' is true (otherwise the query fails). After
+ * the input is exhausted, the spilled runs are merged and partial aggregates of the same group are
+ * combined. Spilling is only possible if every aggregate is one of sum(), min(), max(), first() or
+ * last(), as these can be recomputed from their own partial results.
+ */
 class HashAggStage final : public PlanStage {
 public:
     HashAggStage(std::unique_ptr<PlanStage> input,
                  value::SlotVector gbs,
-                 value::SlotMap<std::unique_ptr<EExpression>> aggs);
+                 value::SlotMap<std::unique_ptr<EExpression>> aggs,
+                 bool allowDiskUse = false,
+                 boost::optional<size_t> memoryLimit = boost::none);
+
+    ~HashAggStage();
 
     std::unique_ptr<PlanStage> clone() const final;
 
@@ -63,19 +83,66 @@ private:
     using HashKeyAccessor = value::MaterializedRowKeyAccessor<TableType::iterator>;
     using HashAggAccessor = value::MaterializedRowValueAccessor<TableType::iterator>;
 
+    using SorterIterator = SortIteratorInterface<value::MaterializedRow, value::MaterializedRow>;
+    using SorterData = std::pair<value::MaterializedRow, value::MaterializedRow>;
+    using SpilledKeyAccessor = value::MaterializedRowKeyAccessor<SorterData*>;
+    using SpilledAggAccessor = value::MaterializedRowValueAccessor<SorterData*>;
+
+    /**
+     * Sorts the current content of the hash table by the group-by key, writes it to the spill
+     * file as a new sorted run, and clears the hash table.
+     */
+    void spill();
+
+    /**
+     * Reads the next group from the merged spilled runs into '_mergeData', combining all partial
+     * aggregates with the same key. Returns false if there are no more groups.
+     */
+    bool advanceMerged();
+
     const value::SlotVector _gbs;
     const value::SlotMap<std::unique_ptr<EExpression>> _aggs;
+    const bool _allowDiskUse;
+    const boost::optional<size_t> _memoryLimit;
 
-    value::SlotAccessorMap _outAccessors;
+    // The output accessors switch between the in-memory hash table (index 0) and the merged
+    // spilled data (index 1).
+    value::SlotMap<value::SwitchAccessor> _outAccessors;
     std::vector<value::SlotAccessor*> _inKeyAccessors;
-    std::vector<std::unique_ptr<HashKeyAccessor>> _outKeyAccessors;
 
     std::vector<std::unique_ptr<HashAggAccessor>> _outAggAccessors;
     std::vector<std::unique_ptr<vm::CodeFragment>> _aggCodes;
 
+    // Code to combine two partial aggregates, one per aggregate expression. Empty if at least one
+    // of the aggregates cannot be spilled.
+    std::vector<std::unique_ptr<SpilledAggAccessor>> _mergeAccAccessors;
+    std::vector<std::unique_ptr<SpilledAggAccessor>> _mergePartialAccessors;
+    std::vector<std::unique_ptr<vm::CodeFragment>> _mergeCodes;
+    bool _canSpill{false};
+
+    // Key used to probe the hash table. It only holds views of the input values, so that rows of
+    // groups which already exist do not allocate.
+    value::MaterializedRow _seekKeys;
+
     TableType _ht;
     TableType::iterator _htIt;
 
+    // Approximate size in bytes of the content of the hash table.
+    size_t _memUsage{0};
+
+    // Sorted runs of partial aggregates that have been spilled to disk. Every spilled row carries
+    // the index of its run as the last value, so that partial aggregates of the same group are
+    // combined in the order in which they were produced.
+    std::string _spillFileName;
+    std::streampos _nextSpillFileOffset{0};
+    std::vector<std::shared_ptr<SorterIterator>> _iters;
+    std::unique_ptr<SorterIterator> _mergeIt;
+    SorterData _mergeData;
+    SorterData* _mergeDataIt{&_mergeData};
+    SorterData _nextMergeData;
+    SorterData* _nextMergeDataIt{&_nextMergeData};
+    bool _hasNextMergeData{false};
+
     vm::ByteCode _bytecode;
 
     bool _compiled{false};
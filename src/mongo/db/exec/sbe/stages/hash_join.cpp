@@ -31,22 +31,64 @@
 
 #include "mongo/db/exec/sbe/stages/hash_join.h"
 
+#include <boost/filesystem/operations.hpp>
+
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/util/destructor_guard.h"
 #include "mongo/util/str.h"
 
+namespace {
+std::string nextFileName() {
+    static mongo::AtomicWord<unsigned> hashJoinFileCounter;
+    return "extsort-hash-join-sbe." + std::to_string(hashJoinFileCounter.fetchAndAdd(1));
+}
+}  // namespace
+
 namespace mongo {
 namespace sbe {
+namespace {
+// The Bloom filter is sized for a false positive rate of roughly 3% with three hash functions.
+constexpr size_t kBloomFilterBitsPerKey = 8;
+constexpr size_t kBloomFilterNumHashes = 3;
+
+/**
+ * Derives the hash functions of the Bloom filter from the single hash of the key by double
+ * hashing. The second hash is made odd so that it cannot degenerate to zero.
+ */
+template <typename F>
+void forEachBloomFilterBit(size_t hash, size_t mask, F&& f) {
+    const size_t step = (hash >> 17) | 1;
+    for (size_t i = 0; i < kBloomFilterNumHashes; ++i) {
+        f((hash + i * step) & mask);
+    }
+}
+
+/**
+ * Uses a different set of bits of the hash than the hash table does, so the keys within a single
+ * partition are still spread across the whole table.
+ */
+size_t getPartitionIndex(size_t hash, size_t numPartitionsLog2) {
+    return (static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> (64 - numPartitionsLog2);
+}
+}  // namespace
+
 HashJoinStage::HashJoinStage(std::unique_ptr<PlanStage> outer,
                              std::unique_ptr<PlanStage> inner,
                              value::SlotVector outerCond,
                              value::SlotVector outerProjects,
                              value::SlotVector innerCond,
-                             value::SlotVector innerProjects)
+                             value::SlotVector innerProjects,
+                             bool allowDiskUse,
+                             boost::optional<size_t> memoryLimit)
     : PlanStage("hj"_sd),
       _outerCond(std::move(outerCond)),
       _outerProjects(std::move(outerProjects)),
       _innerCond(std::move(innerCond)),
-      _innerProjects(std::move(innerProjects)) {
+      _innerProjects(std::move(innerProjects)),
+      _allowDiskUse(allowDiskUse),
+      _memoryLimit(memoryLimit) {
     if (_outerCond.size() != _innerCond.size()) {
         uasserted(4822823, "left and right size do not match");
     }
@@ -55,13 +97,19 @@ HashJoinStage::HashJoinStage(std::unique_ptr<PlanStage> outer,
     _children.emplace_back(std::move(inner));
 }
 
+HashJoinStage::~HashJoinStage() {
+    removePartitions();
+}
+
 std::unique_ptr<PlanStage> HashJoinStage::clone() const {
     return std::make_unique<HashJoinStage>(_children[0]->clone(),
                                            _children[1]->clone(),
                                            _outerCond,
                                            _outerProjects,
                                            _innerCond,
-                                           _innerProjects);
+                                           _innerProjects,
+                                           _allowDiskUse,
+                                           _memoryLimit);
 }
 
 void HashJoinStage::prepare(CompileCtx& ctx) {
@@ -85,6 +133,21 @@ void HashJoinStage::prepare(CompileCtx& ctx) {
         uassert(4822825, str::stream() << "duplicate field: " << slot, inserted);
 
         _inInnerKeyAccessors.emplace_back(_children[1]->getAccessor(ctx, slot));
+        _outInnerAccessors.try_emplace(
+            slot,
+            _inInnerKeyAccessors.back(),
+            std::make_unique<SpilledKeyAccessor>(_spilledProbeIt, counter++),
+            _partitioned);
+    }
+
+    counter = 0;
+    for (auto& slot : _innerProjects) {
+        _inInnerProjectAccessors.emplace_back(_children[1]->getAccessor(ctx, slot));
+        _outInnerAccessors.try_emplace(
+            slot,
+            _inInnerProjectAccessors.back(),
+            std::make_unique<SpilledProjectAccessor>(_spilledProbeIt, counter++),
+            _partitioned);
     }
 
     counter = 0;
@@ -108,18 +171,162 @@ value::SlotAccessor* HashJoinStage::getAccessor(CompileCtx& ctx, value::SlotId s
         if (auto it = _outOuterAccessors.find(slot); it != _outOuterAccessors.end()) {
             return it->second;
         }
+        if (auto it = _outInnerAccessors.find(slot); it != _outInnerAccessors.end()) {
+            return &it->second;
+        }
 
+        _innerPassThrough = true;
         return _children[1]->getAccessor(ctx, slot);
     }
 
     return ctx.getAccessor(slot);
 }
 
+void HashJoinStage::partition() {
+    uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+            str::stream() << "Exceeded memory limit for hash join of " << *_memoryLimit
+                          << " bytes, but did not opt in to external sorting. Aborting operation."
+                          << " Pass allowDiskUse:true to opt in.",
+            _allowDiskUse);
+    uassert(5009101,
+            "Exceeded memory limit for hash join, but its inner side values cannot be spilled",
+            !_innerPassThrough);
+
+    _partitioned = true;
+    _outerPartitions.resize(kNumPartitions);
+    _innerPartitions.resize(kNumPartitions);
+
+    for (auto& [key, project] : _ht) {
+        appendToPartition(_outerPartitions, key, project);
+    }
+    _ht.clear();
+    _memUsage = 0;
+}
+
+void HashJoinStage::appendToPartition(std::vector<Partition>& partitions,
+                                      const value::MaterializedRow& key,
+                                      const value::MaterializedRow& project) {
+    auto& partition =
+        partitions[getPartitionIndex(_ht.hash_function()(key), kNumPartitionsLog2)];
+    if (!partition.writer) {
+        SortOptions opts;
+        opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+        partition.fileName = opts.tempDir + "/" + nextFileName();
+        partition.writer = std::make_unique<SpillWriter>(opts, partition.fileName, 0);
+    }
+
+    partition.writer->addAlreadySorted(key, project);
+}
+
+void HashJoinStage::finishPartitions() {
+    for (auto partitions : {&_outerPartitions, &_innerPartitions}) {
+        for (auto& partition : *partitions) {
+            if (partition.writer) {
+                partition.iter.reset(partition.writer->done());
+                partition.writer.reset();
+            }
+        }
+    }
+}
+
+bool HashJoinStage::loadNextPartition() {
+    if (_probePartition) {
+        _probePartition->iter->closeSource();
+        _probePartition = nullptr;
+    }
+    _ht.clear();
+    _htIt = _ht.end();
+    _htItEnd = _ht.end();
+
+    while (_nextPartition < kNumPartitions) {
+        auto& outer = _outerPartitions[_nextPartition];
+        auto& inner = _innerPartitions[_nextPartition];
+        ++_nextPartition;
+
+        // A partition pair can only produce results if both of its sides are non-empty.
+        if (!outer.iter || !inner.iter) {
+            continue;
+        }
+
+        // Partitions are joined one at a time, so we deliberately do not enforce the memory limit
+        // while loading a single partition.
+        outer.iter->openSource();
+        while (outer.iter->more()) {
+            auto [key, project] = outer.iter->next();
+            _ht.emplace(std::move(key), std::move(project));
+        }
+        outer.iter->closeSource();
+        buildBloomFilter();
+
+        inner.iter->openSource();
+        _probePartition = &inner;
+        _htIt = _ht.end();
+        _htItEnd = _ht.end();
+        return true;
+    }
+
+    return false;
+}
+
+void HashJoinStage::removePartitions() {
+    if (_probePartition) {
+        DESTRUCTOR_GUARD(_probePartition->iter->closeSource());
+        _probePartition = nullptr;
+    }
+
+    for (auto partitions : {&_outerPartitions, &_innerPartitions}) {
+        for (auto& partition : *partitions) {
+            partition.writer.reset();
+            partition.iter.reset();
+            if (!partition.fileName.empty()) {
+                DESTRUCTOR_GUARD(boost::filesystem::remove(partition.fileName));
+            }
+        }
+        partitions->clear();
+    }
+
+    _partitioned = false;
+    _nextPartition = 0;
+}
+
+void HashJoinStage::buildBloomFilter() {
+    // The number of bits is rounded up to a power of two so that the bit index of a hash can be
+    // computed by masking.
+    size_t numWords = 1;
+    while (numWords * 64 < _ht.size() * kBloomFilterBitsPerKey) {
+        numWords *= 2;
+    }
+
+    _bloomFilter.assign(numWords, 0);
+    const size_t mask = numWords * 64 - 1;
+    auto hasher = _ht.hash_function();
+    for (auto& [key, project] : _ht) {
+        forEachBloomFilterBit(hasher(key), mask, [&](size_t bit) {
+            _bloomFilter[bit / 64] |= uint64_t{1} << (bit % 64);
+        });
+    }
+}
+
+bool HashJoinStage::bloomFilterMayContain(const value::MaterializedRow& key) const {
+    const size_t mask = _bloomFilter.size() * 64 - 1;
+    bool mayContain = true;
+    forEachBloomFilterBit(_ht.hash_function()(key), mask, [&](size_t bit) {
+        mayContain = mayContain && (_bloomFilter[bit / 64] & (uint64_t{1} << (bit % 64)));
+    });
+    return mayContain;
+}
+
 void HashJoinStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
-    // Insert the outer side into the hash table.
 
+    removePartitions();
+    _ht.clear();
+    _memUsage = 0;
+
+    // Insert the outer side into the hash table.
     while (_children[0]->getNext() == PlanState::ADVANCED) {
         value::MaterializedRow key;
         value::MaterializedRow project;
@@ -140,24 +347,80 @@ void HashJoinStage::open(bool reOpen) {
             project._fields.back().reset(true, tag, val);
         }
 
+        if (_partitioned) {
+            appendToPartition(_outerPartitions, key, project);
+            continue;
+        }
+
+        if (_memoryLimit) {
+            _memUsage += key.memUsageForSorter() + project.memUsageForSorter();
+        }
         _ht.emplace(std::move(key), std::move(project));
+
+        if (_memoryLimit && _memUsage > *_memoryLimit) {
+            partition();
+        }
     }
 
     _children[0]->close();
 
     _children[1]->open(reOpen);
 
+    if (_partitioned) {
+        // The outer side did not fit into memory, so partition the inner side the same way.
+        while (_children[1]->getNext() == PlanState::ADVANCED) {
+            value::MaterializedRow key;
+            value::MaterializedRow project;
+            key._fields.resize(_inInnerKeyAccessors.size());
+            project._fields.resize(_inInnerProjectAccessors.size());
+
+            size_t idx = 0;
+            for (auto& p : _inInnerKeyAccessors) {
+                auto [tag, val] = p->getViewOfValue();
+                key._fields[idx++].reset(false, tag, val);
+            }
+
+            idx = 0;
+            for (auto& p : _inInnerProjectAccessors) {
+                auto [tag, val] = p->getViewOfValue();
+                project._fields[idx++].reset(false, tag, val);
+            }
+
+            appendToPartition(_innerPartitions, key, project);
+        }
+        finishPartitions();
+    } else {
+        buildBloomFilter();
+    }
+
     _htIt = _ht.end();
     _htItEnd = _ht.end();
 }
 
 PlanState HashJoinStage::getNext() {
+    auto optTimer(getOptTimer());
+
     if (_htIt != _htItEnd) {
         ++_htIt;
     }
 
-    if (_htIt == _htItEnd) {
-        while (_htIt == _htItEnd) {
+    while (_htIt == _htItEnd) {
+        if (_partitioned) {
+            if (!_probePartition || !_probePartition->iter->more()) {
+                if (!loadNextPartition()) {
+                    return trackPlanState(PlanState::IS_EOF);
+                }
+                continue;
+            }
+
+            _spilledProbe = _probePartition->iter->next();
+
+            size_t idx = 0;
+            for (auto& field : _spilledProbe.first._fields) {
+                auto [tag, val] = field.getViewOfValue();
+                _probeKey._fields[idx++].reset(false, tag, val);
+            }
+        } else {
             auto state = _children[1]->getNext();
             if (state == PlanState::IS_EOF) {
                 // LEFT and OUTER joins should enumerate "non-returned" rows here.
@@ -170,25 +433,33 @@ PlanState HashJoinStage::getNext() {
                 auto [tag, val] = p->getViewOfValue();
                 _probeKey._fields[idx++].reset(false, tag, val);
             }
+        }
 
-            auto [low, hi] = _ht.equal_range(_probeKey);
-            _htIt = low;
-            _htItEnd = hi;
-            // If _htIt == _htItEnd (i.e. no match) then RIGHT and OUTER joins
-            // should enumerate "non-returned" rows here.
+        if (!bloomFilterMayContain(_probeKey)) {
+            continue;
         }
+
+        auto [low, hi] = _ht.equal_range(_probeKey);
+        _htIt = low;
+        _htItEnd = hi;
+        // If _htIt == _htItEnd (i.e. no match) then RIGHT and OUTER joins
+        // should enumerate "non-returned" rows here.
     }
 
     return trackPlanState(PlanState::ADVANCED);
 }
 
 void HashJoinStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
     _children[1]->close();
+    removePartitions();
 }
 
 std::unique_ptr<PlanStageStats> HashJoinStage::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->common.instrsExecuted = _bytecode.instrsExecuted();
     ret->children.emplace_back(_children[0]->getStats());
     ret->children.emplace_back(_children[1]->getStats());
     return ret;
@@ -261,3 +532,5 @@ std::vector<DebugPrinter::Block> HashJoinStage::debugPrint() const {
 }
 }  // namespace sbe
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
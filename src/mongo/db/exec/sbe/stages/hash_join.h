@@ -34,7 +34,24 @@
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/db/exec/sbe/vm/vm.h"
 
+namespace mongo {
+template <typename Key, typename Value>
+class SortIteratorInterface;
+template <typename Key, typename Value>
+class SortedFileWriter;
+}  // namespace mongo
+
 namespace mongo::sbe {
+/**
+ * Joins the rows of the outer (build) side with the rows of the inner (probe) side on equality of
+ * the 'outerCond' and 'innerCond' slots.
+ *
+ * If a 'memoryLimit' is given and the hash table built from the outer side outgrows it, the join
+ * falls back to a grace hash join: both sides are hash partitioned to disk, and the partitions are
+ * then joined pairwise. This requires 'allowDiskUse'. Every hash table is paired with a Bloom
+ * filter over its keys, so that most of the probes which cannot match are rejected without
+ * searching the table.
+ */
 class HashJoinStage final : public PlanStage {
 public:
     HashJoinStage(std::unique_ptr<PlanStage> outer,
@@ -42,7 +59,11 @@ public:
                   value::SlotVector outerCond,
                   value::SlotVector outerProjects,
                   value::SlotVector innerCond,
-                  value::SlotVector innerProjects);
+                  value::SlotVector innerProjects,
+                  bool allowDiskUse = false,
+                  boost::optional<size_t> memoryLimit = boost::none);
+
+    ~HashJoinStage();
 
     std::unique_ptr<PlanStage> clone() const final;
 
@@ -64,6 +85,90 @@ private:
     using HashKeyAccessor = value::MaterializedRowKeyAccessor<TableType::iterator>;
     using HashProjectAccessor = value::MaterializedRowValueAccessor<TableType::iterator>;
 
+    using SorterIterator = SortIteratorInterface<value::MaterializedRow, value::MaterializedRow>;
+    using SorterData = std::pair<value::MaterializedRow, value::MaterializedRow>;
+    using SpillWriter = SortedFileWriter<value::MaterializedRow, value::MaterializedRow>;
+    using SpilledKeyAccessor = value::MaterializedRowKeyAccessor<SorterData*>;
+    using SpilledProjectAccessor = value::MaterializedRowValueAccessor<SorterData*>;
+
+    /**
+     * Provides a view of an inner side value, which comes either directly from the inner child or,
+     * once the join has been partitioned, from the inner row read back from a partition.
+     */
+    class InnerAccessor final : public value::SlotAccessor {
+    public:
+        InnerAccessor(value::SlotAccessor* child,
+                      std::unique_ptr<value::SlotAccessor> spilled,
+                      const bool& partitioned)
+            : _child(child), _spilled(std::move(spilled)), _partitioned(partitioned) {}
+
+        std::pair<value::TypeTags, value::Value> getViewOfValue() const override {
+            return _partitioned ? _spilled->getViewOfValue() : _child->getViewOfValue();
+        }
+        std::pair<value::TypeTags, value::Value> copyOrMoveValue() override {
+            return _partitioned ? _spilled->copyOrMoveValue() : _child->copyOrMoveValue();
+        }
+
+    private:
+        value::SlotAccessor* const _child;
+        std::unique_ptr<value::SlotAccessor> _spilled;
+        const bool& _partitioned;
+    };
+
+    /**
+     * A single on-disk partition of either side of the join. The writer is created lazily when the
+     * first row is routed to the partition, so empty partitions never touch the disk.
+     */
+    struct Partition {
+        std::string fileName;
+        std::unique_ptr<SpillWriter> writer;
+        std::unique_ptr<SorterIterator> iter;
+    };
+
+    // The number of partitions each side is split into once the join spills to disk.
+    static constexpr size_t kNumPartitionsLog2 = 4;
+    static constexpr size_t kNumPartitions = size_t{1} << kNumPartitionsLog2;
+
+    /**
+     * Switches the join to partitioned mode, moving the contents of the hash table to the outer
+     * side partitions.
+     */
+    void partition();
+
+    /**
+     * Routes the given row to the partition of 'partitions' selected by the hash of 'key'.
+     */
+    void appendToPartition(std::vector<Partition>& partitions,
+                           const value::MaterializedRow& key,
+                           const value::MaterializedRow& project);
+
+    /**
+     * Finishes writing all partitions of both sides after the inner side has been consumed.
+     */
+    void finishPartitions();
+
+    /**
+     * Loads the next pair of partitions that may produce results: the outer partition is read into
+     * the hash table and the inner partition is opened for probing. Returns false once all the
+     * partitions have been joined.
+     */
+    bool loadNextPartition();
+
+    /**
+     * Closes and deletes all the files backing the partitions.
+     */
+    void removePartitions();
+
+    /**
+     * Rebuilds the Bloom filter from the keys currently stored in the hash table.
+     */
+    void buildBloomFilter();
+
+    /**
+     * Returns false if the given key is definitely not present in the hash table.
+     */
+    bool bloomFilterMayContain(const value::MaterializedRow& key) const;
+
     const value::SlotVector _outerCond;
     const value::SlotVector _outerProjects;
     const value::SlotVector _innerCond;
@@ -87,6 +192,17 @@ private:
     // Accessors of input codition values (keys) that are being inserted into the hash table.
     std::vector<value::SlotAccessor*> _inInnerKeyAccessors;
 
+    // Accessors of input projection values of the inner side, which are written to the inner
+    // partitions once the join spills.
+    std::vector<value::SlotAccessor*> _inInnerProjectAccessors;
+
+    // Accessors of the inner key and projection values, which may come from a partition.
+    value::SlotMap<InnerAccessor> _outInnerAccessors;
+
+    // Set if a parent reads an inner side value which is neither a key nor a projection and thus
+    // cannot be restored from a partition.
+    bool _innerPassThrough{false};
+
     // Key used to probe inside the hash table.
     value::MaterializedRow _probeKey;
 
@@ -94,6 +210,25 @@ private:
     TableType::iterator _htIt;
     TableType::iterator _htItEnd;
 
+    // Bloom filter over the keys of the hash table. Its size in bits is always a power of two.
+    std::vector<uint64_t> _bloomFilter;
+
+    const bool _allowDiskUse;
+    const boost::optional<size_t> _memoryLimit;
+    size_t _memUsage{0};
+
+    bool _partitioned{false};
+    std::vector<Partition> _outerPartitions;
+    std::vector<Partition> _innerPartitions;
+
+    // The partition pair which is currently being joined.
+    size_t _nextPartition{0};
+    Partition* _probePartition{nullptr};
+
+    // The inner row which is currently probing the hash table in partitioned mode.
+    SorterData _spilledProbe;
+    SorterData* _spilledProbeIt{&_spilledProbe};
+
     vm::ByteCode _bytecode;
 
     bool _compiled{false};
@@ -153,7 +153,15 @@ void IndexScanStage::doAttachFromOperationContext(OperationContext* opCtx) {
     }
 }
 
+void IndexScanStage::doAttachNewTrialRunTracker(TrialRunProgressTracker* tracker) {
+    if (_tracker) {
+        _tracker = tracker;
+    }
+}
+
 void IndexScanStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
 
     invariant(_opCtx);
@@ -162,7 +170,7 @@ void IndexScanStage::open(bool reOpen) {
         invariant(!_coll);
         _coll.emplace(_opCtx, _name);
     } else {
-        invariant(_cursor);
+        // There is no cursor to re-use when the collection or the index does not exist.
         invariant(_coll);
     }
 
@@ -219,6 +227,8 @@ void IndexScanStage::open(bool reOpen) {
 }
 
 PlanState IndexScanStage::getNext() {
+    auto optTimer(getOptTimer());
+
     if (!_cursor) {
         return trackPlanState(PlanState::IS_EOF);
     }
@@ -278,6 +288,8 @@ PlanState IndexScanStage::getNext() {
 }
 
 void IndexScanStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
 
     _cursor.reset();
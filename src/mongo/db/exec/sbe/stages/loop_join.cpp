@@ -86,6 +86,8 @@ value::SlotAccessor* LoopJoinStage::getAccessor(CompileCtx& ctx, value::SlotId s
 }
 
 void LoopJoinStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
     _outerGetNext = true;
@@ -100,6 +102,8 @@ void LoopJoinStage::openInner() {
 }
 
 PlanState LoopJoinStage::getNext() {
+    auto optTimer(getOptTimer());
+
     if (_outerGetNext) {
         auto state = _children[0]->getNext();
         if (state != PlanState::ADVANCED) {
@@ -141,6 +145,8 @@ PlanState LoopJoinStage::getNext() {
 }
 
 void LoopJoinStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
 
     if (_reOpenInner) {
@@ -154,6 +160,7 @@ void LoopJoinStage::close() {
 
 std::unique_ptr<PlanStageStats> LoopJoinStage::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->common.instrsExecuted = _bytecode.instrsExecuted();
     ret->children.emplace_back(_children[0]->getStats());
     ret->children.emplace_back(_children[1]->getStats());
     return ret;
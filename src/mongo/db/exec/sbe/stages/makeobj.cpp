@@ -87,6 +87,7 @@ void MakeObjStage::prepare(CompileCtx& ctx) {
         uassert(4822819, str::stream() << "duplicate field: " << p, inserted);
         _projects.emplace_back(p, _children[0]->getAccessor(ctx, _projectVars[idx]));
     }
+    _alreadyProjected.resize(_projects.size());
     _compiled = true;
 }
 
@@ -109,17 +110,21 @@ void MakeObjStage::projectField(value::Object* obj, size_t idx) {
 }
 
 void MakeObjStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
 }
 
 PlanState MakeObjStage::getNext() {
+    auto optTimer(getOptTimer());
+
     auto state = _children[0]->getNext();
 
     if (state == PlanState::ADVANCED) {
         auto [tag, val] = value::makeNewObject();
         auto obj = value::getObjectView(val);
-        absl::flat_hash_set<size_t> alreadyProjected;
+        std::fill(_alreadyProjected.begin(), _alreadyProjected.end(), false);
 
         _obj.reset(tag, val);
 
@@ -144,7 +149,7 @@ PlanState MakeObjStage::getNext() {
                         obj->push_back(sv, copyTag, copyVal);
                     } else if (it != _projectFieldsMap.end()) {
                         projectField(obj, it->second);
-                        alreadyProjected.insert(it->second);
+                        _alreadyProjected[it->second] = true;
                     }
 
                     be = bson::advance(be, sv.size());
@@ -162,12 +167,12 @@ PlanState MakeObjStage::getNext() {
                         obj->push_back(sv, copyTag, copyVal);
                     } else if (it != _projectFieldsMap.end()) {
                         projectField(obj, it->second);
-                        alreadyProjected.insert(it->second);
+                        _alreadyProjected[it->second] = true;
                     }
                 }
             } else {
                 for (size_t idx = 0; idx < _projects.size(); ++idx) {
-                    if (alreadyProjected.count(idx) == 0) {
+                    if (!_alreadyProjected[idx]) {
                         projectField(obj, idx);
                     }
                 }
@@ -185,8 +190,11 @@ PlanState MakeObjStage::getNext() {
                 return trackPlanState(state);
             }
         }
+        if (!_root) {
+            obj->reserve(_projects.size());
+        }
         for (size_t idx = 0; idx < _projects.size(); ++idx) {
-            if (alreadyProjected.count(idx) == 0) {
+            if (!_alreadyProjected[idx]) {
                 projectField(obj, idx);
             }
         }
@@ -195,6 +203,8 @@ PlanState MakeObjStage::getNext() {
 }
 
 void MakeObjStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
     _children[0]->close();
 }
@@ -76,6 +76,10 @@ private:
 
     std::vector<std::pair<std::string, value::SlotAccessor*>> _projects;
 
+    // Flags the projections which have already been added to the current object. Kept across
+    // calls to getNext() to avoid allocating a new set for every row.
+    std::vector<bool> _alreadyProjected;
+
     value::OwnedValueAccessor _obj;
 
     value::SlotAccessor* _root{nullptr};
@@ -47,6 +47,11 @@ struct CommonStats {
     size_t yields{0};
     size_t unyields{0};
     bool isEOF{false};
+    // Number of VM instructions executed by the expressions owned by this stage.
+    size_t instrsExecuted{0};
+    // Cycles spent in open(), getNext() and close() of this stage, including its children. Only
+    // populated when the plan was asked to collect timing info.
+    boost::optional<uint64_t> executionCycles;
 };
 using PlanStageStats = BasePlanStageStats<CommonStats>;
 
@@ -67,11 +67,15 @@ value::SlotAccessor* ProjectStage::getAccessor(CompileCtx& ctx, value::SlotId sl
     }
 }
 void ProjectStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
 }
 
 PlanState ProjectStage::getNext() {
+    auto optTimer(getOptTimer());
+
     auto state = _children[0]->getNext();
 
     if (state == PlanState::ADVANCED) {
@@ -88,12 +92,15 @@ PlanState ProjectStage::getNext() {
 }
 
 void ProjectStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
     _children[0]->close();
 }
 
 std::unique_ptr<PlanStageStats> ProjectStage::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->common.instrsExecuted = _bytecode.instrsExecuted();
     ret->children.emplace_back(_children[0]->getStats());
     return ret;
 }
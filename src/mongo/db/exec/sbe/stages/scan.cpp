@@ -151,7 +151,15 @@ void ScanStage::doAttachFromOperationContext(OperationContext* opCtx) {
     }
 }
 
+void ScanStage::doAttachNewTrialRunTracker(TrialRunProgressTracker* tracker) {
+    if (_tracker) {
+        _tracker = tracker;
+    }
+}
+
 void ScanStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     invariant(_opCtx);
     if (!reOpen) {
@@ -159,8 +167,9 @@ void ScanStage::open(bool reOpen) {
         invariant(!_coll);
         _coll.emplace(_opCtx, _name);
     } else {
-        invariant(_cursor);
         invariant(_coll);
+        // There is no cursor to re-use when the collection does not exist.
+        invariant(_cursor || !_coll->getCollection());
     }
 
     // TODO: this is currently used only to wait for oplog entries to become visible, so we
@@ -191,6 +200,8 @@ void ScanStage::open(bool reOpen) {
 }
 
 PlanState ScanStage::getNext() {
+    auto optTimer(getOptTimer());
+
     if (!_cursor) {
         return trackPlanState(PlanState::IS_EOF);
     }
@@ -253,6 +264,8 @@ PlanState ScanStage::getNext() {
 }
 
 void ScanStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
     _cursor.reset();
     _coll.reset();
@@ -422,6 +435,8 @@ void ParallelScanStage::doAttachFromOperationContext(OperationContext* opCtx) {
 }
 
 void ParallelScanStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     invariant(_opCtx);
     invariant(!reOpen, "parallel scan is not restartable");
 
@@ -479,6 +494,8 @@ boost::optional<Record> ParallelScanStage::nextRange() {
 }
 
 PlanState ParallelScanStage::getNext() {
+    auto optTimer(getOptTimer());
+
     if (!_cursor) {
         _commonStats.isEOF = true;
         return PlanState::IS_EOF;
@@ -542,6 +559,8 @@ PlanState ParallelScanStage::getNext() {
 }
 
 void ParallelScanStage::close() {
+    auto optTimer(getOptTimer());
+
     _cursor.reset();
     _coll.reset();
     _open = false;
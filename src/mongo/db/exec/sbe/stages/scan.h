@@ -69,6 +69,7 @@ protected:
     void doRestoreState() override;
     void doDetachFromOperationContext() override;
     void doAttachFromOperationContext(OperationContext* opCtx) override;
+    void doAttachNewTrialRunTracker(TrialRunProgressTracker* tracker) override;
 
 private:
     const NamespaceStringOrUUID _name;
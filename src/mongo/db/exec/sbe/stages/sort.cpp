@@ -73,6 +73,12 @@ std::unique_ptr<PlanStage> SortStage::clone() const {
         _children[0]->clone(), _obs, _dirs, _vals, _limit, _memoryLimit, _allowDiskUse, _tracker);
 }
 
+void SortStage::doAttachNewTrialRunTracker(TrialRunProgressTracker* tracker) {
+    if (_tracker) {
+        _tracker = tracker;
+    }
+}
+
 void SortStage::prepare(CompileCtx& ctx) {
     _children[0]->prepare(ctx);
 
@@ -109,6 +115,23 @@ void SortStage::prepare(CompileCtx& ctx) {
     }
 }
 
+bool SortStage::inputSortsBefore(const value::MaterializedRow& keys) const {
+    for (size_t idx = 0; idx < _inKeyAccessors.size(); ++idx) {
+        auto [lhsTag, lhsVal] = _inKeyAccessors[idx]->getViewOfValue();
+        auto [rhsTag, rhsVal] = keys._fields[idx].getViewOfValue();
+        auto [tag, val] = value::compareValue(lhsTag, lhsVal, rhsTag, rhsVal);
+        if (tag != value::TypeTags::NumberInt32) {
+            return false;
+        }
+        auto result = value::bitcastTo<int32_t>(val);
+        if (result != 0) {
+            return _dirs[idx] == value::SortDirection::Descending ? result > 0 : result < 0;
+        }
+    }
+
+    return false;
+}
+
 value::SlotAccessor* SortStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
     if (auto it = _outAccessors.find(slot); it != _outAccessors.end()) {
         return &it->second;
@@ -118,6 +141,8 @@ value::SlotAccessor* SortStage::getAccessor(CompileCtx& ctx, value::SlotId slot)
 }
 
 void SortStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
 
@@ -127,9 +152,25 @@ void SortStage::open(bool reOpen) {
     std::streampos nextSortedFileWriterOffset = 0;
     size_t memorySize = 0;
 
+    // In the top-k mode at most '_limit' rows are kept in memory, and the merge of spilled runs
+    // stops after '_limit' rows.
+    const bool isTopK = _limit != std::numeric_limits<std::size_t>::max();
+    if (isTopK) {
+        opts.limit = _limit;
+    }
+
+    // The best worst key of the spilled runs holding '_limit' rows. No input row sorting at or
+    // after it can make it into the result.
+    boost::optional<value::MaterializedRow> spilledCutoff;
+
     _mergeIt.reset();
     _iters.clear();
 
+    // Read from the in-memory table unless this run spills.
+    for (auto&& [_, acc] : _outAccessors) {
+        acc.setIndex(0);
+    }
+
     auto spill = [&]() {
         SortedFileWriter<value::MaterializedRow, value::MaterializedRow> writer{
             opts, spillFileName, nextSortedFileWriterOffset};
@@ -137,6 +178,13 @@ void SortStage::open(bool reOpen) {
         for (auto& [k, v] : _st) {
             writer.addAlreadySorted(k, v);
         }
+        if (isTopK && _st.size() == _limit) {
+            auto& worstKeys = _st.rbegin()->first;
+            if (!spilledCutoff ||
+                value::MaterializedRowComparator{_dirs}(worstKeys, *spilledCutoff)) {
+                spilledCutoff = worstKeys;
+            }
+        }
         _st.clear();
         memorySize = 0;
 
@@ -147,28 +195,37 @@ void SortStage::open(bool reOpen) {
     };
 
     while (_children[0]->getNext() == PlanState::ADVANCED) {
-        value::MaterializedRow keys;
-        value::MaterializedRow vals;
-        keys._fields.reserve(_inKeyAccessors.size());
-        vals._fields.reserve(_inValueAccessors.size());
-
-        for (auto accesor : _inKeyAccessors) {
-            keys._fields.push_back(value::OwnedValueAccessor{});
-            auto [tag, val] = accesor->copyOrMoveValue();
-            keys._fields.back().reset(true, tag, val);
-        }
-        for (auto accesor : _inValueAccessors) {
-            vals._fields.push_back(value::OwnedValueAccessor{});
-            auto [tag, val] = accesor->copyOrMoveValue();
-            vals._fields.back().reset(true, tag, val);
-        }
-
-        memorySize += keys.memUsageForSorter();
-        memorySize += vals.memUsageForSorter();
-
-        _st.emplace(std::move(keys), std::move(vals));
-        if (_st.size() - 1 == _limit) {
-            _st.erase(--_st.end());
+        // Once the top-k rows are known, a row has to beat the current worst one to be kept.
+        bool rejected = isTopK &&
+            ((_st.size() == _limit && !inputSortsBefore(_st.rbegin()->first)) ||
+             (spilledCutoff && !inputSortsBefore(*spilledCutoff)));
+
+        if (!rejected) {
+            value::MaterializedRow keys;
+            value::MaterializedRow vals;
+            keys._fields.reserve(_inKeyAccessors.size());
+            vals._fields.reserve(_inValueAccessors.size());
+
+            for (auto accesor : _inKeyAccessors) {
+                keys._fields.push_back(value::OwnedValueAccessor{});
+                auto [tag, val] = accesor->copyOrMoveValue();
+                keys._fields.back().reset(true, tag, val);
+            }
+            for (auto accesor : _inValueAccessors) {
+                vals._fields.push_back(value::OwnedValueAccessor{});
+                auto [tag, val] = accesor->copyOrMoveValue();
+                vals._fields.back().reset(true, tag, val);
+            }
+
+            memorySize += keys.memUsageForSorter();
+            memorySize += vals.memUsageForSorter();
+
+            _st.emplace(std::move(keys), std::move(vals));
+            if (_st.size() - 1 == _limit) {
+                auto last = --_st.end();
+                memorySize -= last->first.memUsageForSorter() + last->second.memUsageForSorter();
+                _st.erase(last);
+            }
         }
 
         if (_tracker && _tracker->trackProgress<TrialRunProgressTracker::kNumResults>(1)) {
@@ -185,9 +242,9 @@ void SortStage::open(bool reOpen) {
             uasserted(ErrorCodes::QueryTrialRunCompleted, "Trial run early exit");
         }
 
-        // Test if we have to spill
-        // TODO SERVER-49829 - topk spilling
-        if (_limit == std::numeric_limits<std::size_t>::max() && memorySize > _memoryLimit) {
+        // Test if we have to spill. In the top-k mode the spilled runs are sorted and hold at
+        // most '_limit' rows each.
+        if (memorySize > _memoryLimit) {
             uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
                     str::stream()
                         << "Sort exceeded memory limit of " << _memoryLimit
@@ -232,6 +289,8 @@ void SortStage::open(bool reOpen) {
 }
 
 PlanState SortStage::getNext() {
+    auto optTimer(getOptTimer());
+
     // When the sort spilled data to disk then read back the sorted runs.
     if (_mergeIt) {
         if (_mergeIt->more()) {
@@ -257,8 +316,12 @@ PlanState SortStage::getNext() {
 }
 
 void SortStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
     _st.clear();
+    _mergeIt.reset();
+    _iters.clear();
 }
 
 std::unique_ptr<PlanStageStats> SortStage::getStats() const {
@@ -63,6 +63,9 @@ public:
     const SpecificStats* getSpecificStats() const final;
     std::vector<DebugPrinter::Block> debugPrint() const final;
 
+protected:
+    void doAttachNewTrialRunTracker(TrialRunProgressTracker* tracker) final;
+
 private:
     using TableType = std::
         multimap<value::MaterializedRow, value::MaterializedRow, value::MaterializedRowComparator>;
@@ -73,6 +76,12 @@ private:
     using SorterIterator = SortIteratorInterface<value::MaterializedRow, value::MaterializedRow>;
     using SorterData = std::pair<value::MaterializedRow, value::MaterializedRow>;
 
+    /**
+     * Returns true if the sort key of the current input row sorts strictly before 'keys'. This
+     * lets the top-k mode reject rows without materializing them first.
+     */
+    bool inputSortsBefore(const value::MaterializedRow& keys) const;
+
     const value::SlotVector _obs;
     const std::vector<value::SortDirection> _dirs;
     const value::SlotVector _vals;
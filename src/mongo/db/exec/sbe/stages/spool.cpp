@@ -72,6 +72,8 @@ value::SlotAccessor* SpoolEagerProducerStage::getAccessor(CompileCtx& ctx, value
 }
 
 void SpoolEagerProducerStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
 
@@ -97,6 +99,8 @@ void SpoolEagerProducerStage::open(bool reOpen) {
 }
 
 PlanState SpoolEagerProducerStage::getNext() {
+    auto optTimer(getOptTimer());
+
     if (_bufferIt == _buffer->size()) {
         _bufferIt = 0;
     } else {
@@ -111,6 +115,8 @@ PlanState SpoolEagerProducerStage::getNext() {
 }
 
 void SpoolEagerProducerStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
 }
 
@@ -199,6 +205,8 @@ value::SlotAccessor* SpoolLazyProducerStage::getAccessor(CompileCtx& ctx, value:
 }
 
 void SpoolLazyProducerStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
 
@@ -208,6 +216,8 @@ void SpoolLazyProducerStage::open(bool reOpen) {
 }
 
 PlanState SpoolLazyProducerStage::getNext() {
+    auto optTimer(getOptTimer());
+
     auto state = _children[0]->getNext();
 
     if (state == PlanState::ADVANCED) {
@@ -246,11 +256,14 @@ PlanState SpoolLazyProducerStage::getNext() {
 }
 
 void SpoolLazyProducerStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
 }
 
 std::unique_ptr<PlanStageStats> SpoolLazyProducerStage::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->common.instrsExecuted = _bytecode.instrsExecuted();
     ret->children.emplace_back(_children[0]->getStats());
     return ret;
 }
@@ -179,11 +179,15 @@ public:
     }
 
     void open(bool reOpen) {
+        auto optTimer(getOptTimer());
+
         _commonStats.opens++;
         _bufferIt = _buffer->size();
     }
 
     PlanState getNext() {
+        auto optTimer(getOptTimer());
+
         if constexpr (IsStack) {
             if (_bufferIt != _buffer->size()) {
                 _buffer->erase(_buffer->begin() + _bufferIt);
@@ -209,6 +213,8 @@ public:
     }
 
     void close() {
+        auto optTimer(getOptTimer());
+
         _commonStats.closes++;
     }
 
@@ -75,5 +75,33 @@ void CanChangeState::restoreState() {
 
     doRestoreState();
 }
+
+void PlanStage::attachNewYieldPolicy(PlanYieldPolicy* yieldPolicy) {
+    for (auto&& child : _children) {
+        child->attachNewYieldPolicy(yieldPolicy);
+    }
+
+    if (_yieldPolicy) {
+        _yieldPolicy = yieldPolicy;
+    }
+}
+
+void PlanStage::attachNewTrialRunTracker(TrialRunProgressTracker* tracker) {
+    for (auto&& child : _children) {
+        child->attachNewTrialRunTracker(tracker);
+    }
+
+    doAttachNewTrialRunTracker(tracker);
+}
+
+void PlanStage::markShouldCollectTimingInfo() {
+    for (auto&& child : _children) {
+        child->markShouldCollectTimingInfo();
+    }
+
+    if (!_commonStats.executionCycles) {
+        _commonStats.executionCycles.emplace(0);
+    }
+}
 }  // namespace sbe
 }  // namespace mongo
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/sbe/stages/plan_stats.h"
+#include "mongo/db/exec/sbe/util/cycle_timer.h"
 #include "mongo/db/exec/sbe/util/debug_print.h"
 #include "mongo/db/exec/sbe/values/slot.h"
 #include "mongo/db/exec/sbe/values/value.h"
@@ -38,6 +39,8 @@
 #include "mongo/db/query/plan_yield_policy.h"
 
 namespace mongo {
+class TrialRunProgressTracker;
+
 namespace sbe {
 
 struct CompileCtx;
@@ -174,6 +177,18 @@ protected:
         return state;
     }
 
+    /**
+     * Returns an optional timer which is used to collect the cycles spent executing the current
+     * stage. Returns boost::none unless the plan was asked to collect timing info.
+     */
+    boost::optional<ScopedCycleTimer> getOptTimer() {
+        if (_commonStats.executionCycles) {
+            return ScopedCycleTimer{_commonStats.executionCycles.get_ptr()};
+        }
+
+        return boost::none;
+    }
+
     CommonStats _commonStats;
 };
 
@@ -208,7 +223,7 @@ public:
     }
 
 protected:
-    PlanYieldPolicy* const _yieldPolicy{nullptr};
+    PlanYieldPolicy* _yieldPolicy{nullptr};
 
 private:
     static const int kInterruptCheckPeriod = 128;
@@ -275,10 +290,37 @@ public:
 
     virtual std::vector<DebugPrinter::Block> debugPrint() const = 0;
 
+    /**
+     * Replaces the yield policy of this stage and all of its descendants. Only the stages which
+     * were constructed with a yield policy are switched to the new one, the rest keep yielding
+     * disabled. This is used when a copy of a cached plan stage tree is executed by a new query.
+     *
+     * Must be called before prepare().
+     */
+    void attachNewYieldPolicy(PlanYieldPolicy* yieldPolicy);
+
+    /**
+     * Replaces the trial run progress tracker of this stage and all of its descendants. Likewise,
+     * only the stages which were constructed with a tracker are switched to the new one.
+     *
+     * Must be called before prepare().
+     */
+    void attachNewTrialRunTracker(TrialRunProgressTracker* tracker);
+
+    /**
+     * Forces this stage and all of its descendants to count the cycles spent in open(), getNext()
+     * and close(). Stages don't collect timing info by default as it costs two reads of the cycle
+     * counter per call.
+     */
+    void markShouldCollectTimingInfo();
+
     friend class CanSwitchOperationContext;
     friend class CanChangeState;
 
 protected:
+    // Stages which track the progress of a trial run must override this method.
+    virtual void doAttachNewTrialRunTracker(TrialRunProgressTracker* tracker) {}
+
     std::vector<std::unique_ptr<PlanStage>> _children;
 };
 
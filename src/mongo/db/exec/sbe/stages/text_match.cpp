@@ -55,11 +55,15 @@ value::SlotAccessor* TextMatchStage::getAccessor(CompileCtx& ctx, value::SlotId
 }
 
 void TextMatchStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
 }
 
 PlanState TextMatchStage::getNext() {
+    auto optTimer(getOptTimer());
+
     auto state = _children[0]->getNext();
 
     if (state == PlanState::ADVANCED) {
@@ -83,6 +87,8 @@ PlanState TextMatchStage::getNext() {
 }
 
 void TextMatchStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
     _children[0]->close();
 }
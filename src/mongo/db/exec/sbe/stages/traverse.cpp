@@ -121,6 +121,8 @@ value::SlotAccessor* TraverseStage::getAccessor(CompileCtx& ctx, value::SlotId s
 }
 
 void TraverseStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
     // Do not open the inner child as we do not have values of correlated parameters yet.
@@ -137,6 +139,8 @@ void TraverseStage::openInner(value::TypeTags tag, value::Value val) {
 }
 
 PlanState TraverseStage::getNext() {
+    auto optTimer(getOptTimer());
+
     auto state = _children[0]->getNext();
     if (state != PlanState::ADVANCED) {
         return trackPlanState(state);
@@ -247,6 +251,8 @@ bool TraverseStage::traverse(value::SlotAccessor* inFieldAccessor,
 }
 
 void TraverseStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
 
     if (_reOpenInner) {
@@ -260,6 +266,7 @@ void TraverseStage::close() {
 
 std::unique_ptr<PlanStageStats> TraverseStage::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->common.instrsExecuted = _bytecode.instrsExecuted();
     ret->children.emplace_back(_children[0]->getStats());
     ret->children.emplace_back(_children[1]->getStats());
     return ret;
@@ -90,6 +90,8 @@ value::SlotAccessor* UnionStage::getAccessor(CompileCtx& ctx, value::SlotId slot
 }
 
 void UnionStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     if (reOpen) {
         std::queue<UnionBranch> emptyQueue;
@@ -105,6 +107,8 @@ void UnionStage::open(bool reOpen) {
 }
 
 PlanState UnionStage::getNext() {
+    auto optTimer(getOptTimer());
+
     auto state = PlanState::IS_EOF;
 
     while (!_remainingBranchesToDrain.empty() && state != PlanState::ADVANCED) {
@@ -133,6 +137,8 @@ PlanState UnionStage::getNext() {
 }
 
 void UnionStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
     _currentStage = nullptr;
     while (!_remainingBranchesToDrain.empty()) {
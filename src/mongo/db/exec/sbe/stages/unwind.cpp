@@ -82,6 +82,8 @@ value::SlotAccessor* UnwindStage::getAccessor(CompileCtx& ctx, value::SlotId slo
 }
 
 void UnwindStage::open(bool reOpen) {
+    auto optTimer(getOptTimer());
+
     _commonStats.opens++;
     _children[0]->open(reOpen);
 
@@ -90,6 +92,8 @@ void UnwindStage::open(bool reOpen) {
 }
 
 PlanState UnwindStage::getNext() {
+    auto optTimer(getOptTimer());
+
     if (!_inArray) {
         do {
             auto state = _children[0]->getNext();
@@ -144,6 +148,8 @@ PlanState UnwindStage::getNext() {
 }
 
 void UnwindStage::close() {
+    auto optTimer(getOptTimer());
+
     _commonStats.closes++;
     _children[0]->close();
 }
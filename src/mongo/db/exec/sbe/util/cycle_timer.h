@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace mongo {
+namespace sbe {
+/**
+ * Reads the processor's timestamp counter. On platforms without one, falls back to a steady
+ * clock reading, in which case the returned "cycles" are clock ticks.
+ */
+inline uint64_t readCycleCounter() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+/**
+ * Adds the number of cycles elapsed between its construction and destruction to a counter. Unlike
+ * ScopedTimer this does not go through a ClockSource, so it is cheap enough to wrap every call
+ * into a plan stage.
+ */
+class ScopedCycleTimer {
+    ScopedCycleTimer(const ScopedCycleTimer&) = delete;
+    ScopedCycleTimer& operator=(const ScopedCycleTimer&) = delete;
+
+public:
+    explicit ScopedCycleTimer(uint64_t* counter) : _counter(counter), _start(readCycleCounter()) {}
+
+    ScopedCycleTimer(ScopedCycleTimer&& other) : _counter(other._counter), _start(other._start) {
+        other._counter = nullptr;
+    }
+
+    ~ScopedCycleTimer() {
+        if (_counter) {
+            *_counter += readCycleCounter() - _start;
+        }
+    }
+
+private:
+    uint64_t* _counter;
+    const uint64_t _start;
+};
+}  // namespace sbe
+}  // namespace mongo
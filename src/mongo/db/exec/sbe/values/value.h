@@ -31,6 +31,7 @@
 
 #include <absl/container/flat_hash_map.h>
 #include <absl/container/flat_hash_set.h>
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <cstdint>
@@ -232,8 +233,10 @@ public:
         if (tag != TypeTags::Nothing) {
             ValueGuard guard{tag, val};
             // Reserve space in all vectors, they are the same size. We arbitrarily picked _typeTags
-            // to determine the size.
-            reserve(_typeTags.size() + 1);
+            // to determine the size. The capacity is doubled so that appends are amortized O(1).
+            if (_typeTags.size() == _typeTags.capacity()) {
+                reserve(std::max<size_t>(1, 2 * _typeTags.size()));
+            }
             _names.emplace_back(std::string(name));
 
             _typeTags.push_back(tag);
@@ -309,8 +312,10 @@ public:
         if (tag != TypeTags::Nothing) {
             ValueGuard guard{tag, val};
             // Reserve space in all vectors, they are the same size. We arbitrarily picked _typeTags
-            // to determine the size.
-            reserve(_typeTags.size() + 1);
+            // to determine the size. The capacity is doubled so that appends are amortized O(1).
+            if (_typeTags.size() == _typeTags.capacity()) {
+                reserve(std::max<size_t>(1, 2 * _typeTags.size()));
+            }
 
             _typeTags.push_back(tag);
             _values.push_back(val);
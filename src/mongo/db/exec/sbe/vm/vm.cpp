@@ -38,6 +38,7 @@
 #include "mongo/db/query/datetime/date_time_support.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/str.h"
 #include "mongo/util/summation.h"
 
 MONGO_FAIL_POINT_DEFINE(failOnPoisonedFieldLookup);
@@ -75,11 +76,20 @@ int Instruction::stackOffset[Instruction::Tags::lastInstruction] = {
     -1,  // greaterEq
     -1,  // eq
     -1,  // neq
+
+    0,  // lessImm
+    0,  // lessEqImm
+    0,  // greaterImm
+    0,  // greaterEqImm
+    0,  // eqImm
+    0,  // neqImm
+
     -1,  // cmp3w
 
     -1,  // fillEmpty
 
     -1,  // getField
+    0,   // getFieldImm
 
     -1,  // sum
     -1,  // min
@@ -130,6 +140,7 @@ void CodeFragment::copyCodeAndFixup(const CodeFragment& from) {
     }
 
     _instrs.insert(_instrs.end(), from._instrs.begin(), from._instrs.end());
+    _instrCount += from._instrCount;
 }
 
 void CodeFragment::append(std::unique_ptr<CodeFragment> code) {
@@ -255,6 +266,20 @@ void CodeFragment::appendSimpleInstruction(Instruction::Tags tag) {
     offset += value::writeToMemory(offset, i);
 }
 
+void CodeFragment::appendConstInstruction(Instruction::Tags tag,
+                                          value::TypeTags constTag,
+                                          value::Value constVal) {
+    Instruction i;
+    i.tag = tag;
+    adjustStackSimple(i);
+
+    auto offset = allocateSpace(sizeof(Instruction) + sizeof(constTag) + sizeof(constVal));
+
+    offset += value::writeToMemory(offset, i);
+    offset += value::writeToMemory(offset, constTag);
+    offset += value::writeToMemory(offset, constVal);
+}
+
 void CodeFragment::appendGetField() {
     appendSimpleInstruction(Instruction::getField);
 }
@@ -701,14 +726,23 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinNewKeyString(ui
 
     for (size_t idx = 2; idx < arity - 1u; ++idx) {
         auto [_, tag, val] = getFromStack(idx);
-        if (value::isNumber(tag)) {
+        if (tag == value::TypeTags::NumberInt32 || tag == value::TypeTags::NumberInt64) {
             auto num = value::numericCast<int64_t>(tag, val);
             kb.appendNumberLong(num);
         } else if (value::isString(tag)) {
             auto str = value::getStringView(tag, val);
             kb.appendString(StringData{str.data(), str.length()});
         } else {
-            uasserted(4822802, "unsuppored key string type");
+            uassert(4822802, "unsuppored key string type", tag != value::TypeTags::Nothing);
+
+            // Any other type goes through its BSON representation, which is what the index keys
+            // were generated from.
+            value::Object keyObj;
+            auto [copyTag, copyVal] = value::copyValue(tag, val);
+            keyObj.push_back("", copyTag, copyVal);
+            BSONObjBuilder keyBuilder;
+            bson::convertToBsonObj(keyBuilder, &keyObj);
+            kb.appendBSONElement(keyBuilder.done().firstElement());
         }
     }
 
@@ -1019,6 +1053,125 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinDateWeekYear(ui
         timezoneTuple);
 }
 
+namespace {
+bool lookupValuesEqual(value::TypeTags lhsTag,
+                       value::Value lhsVal,
+                       value::TypeTags rhsTag,
+                       value::Value rhsVal) {
+    auto [tag, val] = value::compareValue(lhsTag, lhsVal, rhsTag, rhsVal);
+    return tag == value::TypeTags::NumberInt32 && value::bitcastTo<int32_t>(val) == 0;
+}
+
+/**
+ * Matches a single (non-array) local value against a foreign value the way {foreignField: local}
+ * does: a null or missing local value matches a null or missing foreign value, and any local value
+ * matches a foreign array that has an equal element.
+ */
+bool lookupScalarMatch(value::TypeTags localTag,
+                       value::Value localVal,
+                       value::TypeTags foreignTag,
+                       value::Value foreignVal) {
+    const bool localIsNull =
+        localTag == value::TypeTags::Nothing || localTag == value::TypeTags::Null;
+    if (localIsNull &&
+        (foreignTag == value::TypeTags::Nothing || foreignTag == value::TypeTags::Null)) {
+        return true;
+    }
+    if (!localIsNull && lookupValuesEqual(localTag, localVal, foreignTag, foreignVal)) {
+        return true;
+    }
+
+    if (value::isArray(foreignTag)) {
+        for (value::ArrayEnumerator it{foreignTag, foreignVal}; !it.atEnd(); it.advance()) {
+            auto [elemTag, elemVal] = it.getViewOfValue();
+            if (localIsNull ? elemTag == value::TypeTags::Null
+                            : lookupValuesEqual(localTag, localVal, elemTag, elemVal)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns true if 'elem' and everything nested in it have a type that the slot-based values can
+ * represent. Values of other types, such as regular expressions, read as Nothing.
+ */
+bool isLookupKeyRepresentable(const BSONElement& elem) {
+    switch (elem.type()) {
+        case BSONType::Object:
+        case BSONType::Array:
+            for (auto&& child : elem.Obj()) {
+                if (!isLookupKeyRepresentable(child)) {
+                    return false;
+                }
+            }
+            return true;
+        case BSONType::NumberDouble:
+        case BSONType::NumberDecimal:
+        case BSONType::String:
+        case BSONType::jstOID:
+        case BSONType::Bool:
+        case BSONType::Date:
+        case BSONType::jstNULL:
+        case BSONType::NumberInt:
+        case BSONType::bsonTimestamp:
+        case BSONType::NumberLong:
+            return true;
+        default:
+            return false;
+    }
+}
+}  // namespace
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinEqLookupMatch(uint8_t arity) {
+    invariant(arity == 2);
+
+    auto [_, localTag, localVal] = getFromStack(0);
+    auto [__, foreignTag, foreignVal] = getFromStack(1);
+
+    // A local array matches if any of its elements matches. Like the classic $lookup, which
+    // rewrites such a join to an $or of $eq predicates when the array holds a regex, the elements
+    // are compared by equality, so a regex only matches an equal regex. An empty local array has
+    // no values to join on and is treated as null.
+    bool matched = false;
+    if (value::isArray(localTag) && !value::ArrayEnumerator{localTag, localVal}.atEnd()) {
+        for (value::ArrayEnumerator it{localTag, localVal}; !matched && !it.atEnd(); it.advance()) {
+            auto [elemTag, elemVal] = it.getViewOfValue();
+            matched = lookupScalarMatch(elemTag, elemVal, foreignTag, foreignVal);
+        }
+    } else if (value::isArray(localTag)) {
+        matched = lookupScalarMatch(value::TypeTags::Null, 0, foreignTag, foreignVal);
+    } else {
+        matched = lookupScalarMatch(localTag, localVal, foreignTag, foreignVal);
+    }
+
+    return {false, value::TypeTags::Boolean, value::bitcastFrom(matched)};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinEqLookupKey(uint8_t arity) {
+    invariant(arity == 2);
+
+    auto [_, objTag, objVal] = getFromStack(0);
+    auto [__, fieldTag, fieldVal] = getFromStack(1);
+
+    // A value that reads as Nothing would join like a missing one, so refuse to join it rather
+    // than return matches which the classic $lookup would not.
+    if (objTag == value::TypeTags::bsonObject && value::isString(fieldTag)) {
+        auto fieldStr = value::getStringView(fieldTag, fieldVal);
+        BSONObj obj{value::bitcastTo<const char*>(objVal)};
+        auto elem = obj[StringData{fieldStr.data(), fieldStr.size()}];
+        uassert(4798623,
+                str::stream() << "Cannot join on the value of '" << elem.fieldNameStringData()
+                              << "' of type " << typeName(elem.type())
+                              << " with a pushed down $lookup; disable "
+                                 "internalQuerySlotBasedExecutionEnableLookupPushdown",
+                elem.eoo() || isLookupKeyRepresentable(elem));
+    }
+
+    return getField(objTag, objVal, fieldTag, fieldVal);
+}
+
 std::tuple<bool, value::TypeTags, value::Value> ByteCode::dispatchBuiltin(Builtin f,
                                                                           uint8_t arity) {
     switch (f) {
@@ -1046,14 +1199,106 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::dispatchBuiltin(Builti
             return builtinAddToSet(arity);
         case Builtin::doubleDoubleSum:
             return builtinDoubleDoubleSum(arity);
+        case Builtin::eqLookupMatch:
+            return builtinEqLookupMatch(arity);
+        case Builtin::eqLookupKey:
+            return builtinEqLookupKey(arity);
     }
 
     MONGO_UNREACHABLE;
 }
 
+/*
+ * Compilers with the "labels as values" extension use threaded dispatch: every instruction
+ * handler decodes the next instruction and jumps straight to its handler through a table of label
+ * addresses. Each handler then ends in its own indirect branch, which predicts far better than
+ * the single shared branch at the top of the switch. The switch on the instruction tag is still
+ * used to dispatch the first instruction and is the only dispatch mechanism on other compilers.
+ */
+#if defined(__GNUC__)
+#define SBE_VM_THREADED_DISPATCH
+#endif
+
+#ifdef SBE_VM_THREADED_DISPATCH
+#define SBE_VM_INSTRUCTION(name) \
+    case Instruction::name:      \
+    instr_##name:
+#define SBE_VM_DISPATCH_NEXT()                                                 \
+    do {                                                                       \
+        if (pcPointer == pcEnd) {                                              \
+            goto dispatchDone;                                                 \
+        }                                                                      \
+        auto nextTag = value::readFromMemory<Instruction>(pcPointer).tag;      \
+        pcPointer += sizeof(Instruction);                                      \
+        ++instrsExecuted;                                                      \
+        goto* kDispatchTable[nextTag];                                         \
+    } while (false)
+#else
+#define SBE_VM_INSTRUCTION(name) case Instruction::name:
+#define SBE_VM_DISPATCH_NEXT() break
+#endif
+
 std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* code) {
     auto pcPointer = code->instrs().data();
     auto pcEnd = pcPointer + code->instrs().size();
+    // Counted in a local so the hot loop doesn't write to memory on every instruction.
+    size_t instrsExecuted = 0;
+
+#ifdef SBE_VM_THREADED_DISPATCH
+    // This table must be kept in sync with Instruction::Tags.
+    static const void* const kDispatchTable[] = {
+        &&instr_pushConstVal,
+        &&instr_pushAccessVal,
+        &&instr_pushMoveVal,
+        &&instr_pushLocalVal,
+        &&instr_pop,
+        &&instr_swap,
+        &&instr_add,
+        &&instr_sub,
+        &&instr_mul,
+        &&instr_div,
+        &&instr_idiv,
+        &&instr_mod,
+        &&instr_negate,
+        &&instr_numConvert,
+        &&instr_logicNot,
+        &&instr_less,
+        &&instr_lessEq,
+        &&instr_greater,
+        &&instr_greaterEq,
+        &&instr_eq,
+        &&instr_neq,
+        &&instr_lessImm,
+        &&instr_lessEqImm,
+        &&instr_greaterImm,
+        &&instr_greaterEqImm,
+        &&instr_eqImm,
+        &&instr_neqImm,
+        &&instr_cmp3w,
+        &&instr_fillEmpty,
+        &&instr_getField,
+        &&instr_getFieldImm,
+        &&instr_aggSum,
+        &&instr_aggMin,
+        &&instr_aggMax,
+        &&instr_aggFirst,
+        &&instr_aggLast,
+        &&instr_exists,
+        &&instr_isNull,
+        &&instr_isObject,
+        &&instr_isArray,
+        &&instr_isString,
+        &&instr_isNumber,
+        &&instr_typeMatch,
+        &&instr_function,
+        &&instr_jmp,
+        &&instr_jmpTrue,
+        &&instr_jmpNothing,
+        &&instr_fail,
+    };
+    static_assert(sizeof(kDispatchTable) / sizeof(kDispatchTable[0]) ==
+                  Instruction::Tags::lastInstruction);
+#endif
 
     for (;;) {
         if (pcPointer == pcEnd) {
@@ -1061,8 +1306,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
         } else {
             Instruction i = value::readFromMemory<Instruction>(pcPointer);
             pcPointer += sizeof(i);
+            ++instrsExecuted;
             switch (i.tag) {
-                case Instruction::pushConstVal: {
+                SBE_VM_INSTRUCTION(pushConstVal) {
                     auto tag = value::readFromMemory<value::TypeTags>(pcPointer);
                     pcPointer += sizeof(tag);
                     auto val = value::readFromMemory<value::Value>(pcPointer);
@@ -1070,27 +1316,27 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
 
                     pushStack(false, tag, val);
 
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::pushAccessVal: {
+                SBE_VM_INSTRUCTION(pushAccessVal) {
                     auto accessor = value::readFromMemory<value::SlotAccessor*>(pcPointer);
                     pcPointer += sizeof(accessor);
 
                     auto [tag, val] = accessor->getViewOfValue();
                     pushStack(false, tag, val);
 
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::pushMoveVal: {
+                SBE_VM_INSTRUCTION(pushMoveVal) {
                     auto accessor = value::readFromMemory<value::SlotAccessor*>(pcPointer);
                     pcPointer += sizeof(accessor);
 
                     auto [tag, val] = accessor->copyOrMoveValue();
                     pushStack(true, tag, val);
 
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::pushLocalVal: {
+                SBE_VM_INSTRUCTION(pushLocalVal) {
                     auto stackOffset = value::readFromMemory<int>(pcPointer);
                     pcPointer += sizeof(stackOffset);
 
@@ -1098,9 +1344,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
 
                     pushStack(false, tag, val);
 
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::pop: {
+                SBE_VM_INSTRUCTION(pop) {
                     auto [owned, tag, val] = getFromStack(0);
                     popStack();
 
@@ -1108,9 +1354,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                         value::releaseValue(tag, val);
                     }
 
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::swap: {
+                SBE_VM_INSTRUCTION(swap) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(1);
 
@@ -1126,9 +1372,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                         invariant(!rhsOwned);
                     }
 
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::add: {
+                SBE_VM_INSTRUCTION(add) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1143,9 +1389,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::sub: {
+                SBE_VM_INSTRUCTION(sub) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1160,9 +1406,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::mul: {
+                SBE_VM_INSTRUCTION(mul) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1177,9 +1423,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::div: {
+                SBE_VM_INSTRUCTION(div) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1194,9 +1440,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::idiv: {
+                SBE_VM_INSTRUCTION(idiv) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1211,9 +1457,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::mod: {
+                SBE_VM_INSTRUCTION(mod) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1228,9 +1474,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::negate: {
+                SBE_VM_INSTRUCTION(negate) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     auto [resultOwned, resultTag, resultVal] =
@@ -1242,9 +1488,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                         value::releaseValue(resultTag, resultVal);
                     }
 
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::numConvert: {
+                SBE_VM_INSTRUCTION(numConvert) {
                     auto tag = value::readFromMemory<value::TypeTags>(pcPointer);
                     pcPointer += sizeof(tag);
 
@@ -1258,9 +1504,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                         value::releaseValue(lhsTag, lhsVal);
                     }
 
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::logicNot: {
+                SBE_VM_INSTRUCTION(logicNot) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     auto [resultOwned, resultTag, resultVal] = genericNot(tag, val);
@@ -1270,9 +1516,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::less: {
+                SBE_VM_INSTRUCTION(less) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1287,9 +1533,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::lessEq: {
+                SBE_VM_INSTRUCTION(lessEq) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1305,9 +1551,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::greater: {
+                SBE_VM_INSTRUCTION(greater) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1323,9 +1569,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::greaterEq: {
+                SBE_VM_INSTRUCTION(greaterEq) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1341,9 +1587,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::eq: {
+                SBE_VM_INSTRUCTION(eq) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1358,9 +1604,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::neq: {
+                SBE_VM_INSTRUCTION(neq) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1375,9 +1621,114 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::cmp3w: {
+                SBE_VM_INSTRUCTION(lessImm) {
+                    auto rhsTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(rhsTag);
+                    auto rhsVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(rhsVal);
+
+                    auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
+
+                    auto [tag, val] = genericCompare<std::less<>>(lhsTag, lhsVal, rhsTag, rhsVal);
+
+                    topStack(false, tag, val);
+
+                    if (lhsOwned) {
+                        value::releaseValue(lhsTag, lhsVal);
+                    }
+                    SBE_VM_DISPATCH_NEXT();
+                }
+                SBE_VM_INSTRUCTION(lessEqImm) {
+                    auto rhsTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(rhsTag);
+                    auto rhsVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(rhsVal);
+
+                    auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
+
+                    auto [tag, val] =
+                        genericCompare<std::less_equal<>>(lhsTag, lhsVal, rhsTag, rhsVal);
+
+                    topStack(false, tag, val);
+
+                    if (lhsOwned) {
+                        value::releaseValue(lhsTag, lhsVal);
+                    }
+                    SBE_VM_DISPATCH_NEXT();
+                }
+                SBE_VM_INSTRUCTION(greaterImm) {
+                    auto rhsTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(rhsTag);
+                    auto rhsVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(rhsVal);
+
+                    auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
+
+                    auto [tag, val] =
+                        genericCompare<std::greater<>>(lhsTag, lhsVal, rhsTag, rhsVal);
+
+                    topStack(false, tag, val);
+
+                    if (lhsOwned) {
+                        value::releaseValue(lhsTag, lhsVal);
+                    }
+                    SBE_VM_DISPATCH_NEXT();
+                }
+                SBE_VM_INSTRUCTION(greaterEqImm) {
+                    auto rhsTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(rhsTag);
+                    auto rhsVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(rhsVal);
+
+                    auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
+
+                    auto [tag, val] =
+                        genericCompare<std::greater_equal<>>(lhsTag, lhsVal, rhsTag, rhsVal);
+
+                    topStack(false, tag, val);
+
+                    if (lhsOwned) {
+                        value::releaseValue(lhsTag, lhsVal);
+                    }
+                    SBE_VM_DISPATCH_NEXT();
+                }
+                SBE_VM_INSTRUCTION(eqImm) {
+                    auto rhsTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(rhsTag);
+                    auto rhsVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(rhsVal);
+
+                    auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
+
+                    auto [tag, val] = genericCompareEq(lhsTag, lhsVal, rhsTag, rhsVal);
+
+                    topStack(false, tag, val);
+
+                    if (lhsOwned) {
+                        value::releaseValue(lhsTag, lhsVal);
+                    }
+                    SBE_VM_DISPATCH_NEXT();
+                }
+                SBE_VM_INSTRUCTION(neqImm) {
+                    auto rhsTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(rhsTag);
+                    auto rhsVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(rhsVal);
+
+                    auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
+
+                    auto [tag, val] = genericCompareNeq(lhsTag, lhsVal, rhsTag, rhsVal);
+
+                    topStack(false, tag, val);
+
+                    if (lhsOwned) {
+                        value::releaseValue(lhsTag, lhsVal);
+                    }
+                    SBE_VM_DISPATCH_NEXT();
+                }
+                SBE_VM_INSTRUCTION(cmp3w) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1392,9 +1743,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::fillEmpty: {
+                SBE_VM_INSTRUCTION(fillEmpty) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1410,9 +1761,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                             value::releaseValue(rhsTag, rhsVal);
                         }
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::getField: {
+                SBE_VM_INSTRUCTION(getField) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1427,9 +1778,26 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::aggSum: {
+                SBE_VM_INSTRUCTION(getFieldImm) {
+                    auto fieldTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(fieldTag);
+                    auto fieldVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(fieldVal);
+
+                    auto [objOwned, objTag, objVal] = getFromStack(0);
+
+                    auto [owned, tag, val] = getField(objTag, objVal, fieldTag, fieldVal);
+
+                    topStack(owned, tag, val);
+
+                    if (objOwned) {
+                        value::releaseValue(objTag, objVal);
+                    }
+                    SBE_VM_DISPATCH_NEXT();
+                }
+                SBE_VM_INSTRUCTION(aggSum) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1444,9 +1812,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::aggMin: {
+                SBE_VM_INSTRUCTION(aggMin) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1461,9 +1829,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::aggMax: {
+                SBE_VM_INSTRUCTION(aggMax) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1478,9 +1846,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::aggFirst: {
+                SBE_VM_INSTRUCTION(aggFirst) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1495,9 +1863,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::aggLast: {
+                SBE_VM_INSTRUCTION(aggLast) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1512,9 +1880,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::exists: {
+                SBE_VM_INSTRUCTION(exists) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     topStack(false, value::TypeTags::Boolean, tag != value::TypeTags::Nothing);
@@ -1522,9 +1890,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::isNull: {
+                SBE_VM_INSTRUCTION(isNull) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -1534,9 +1902,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::isObject: {
+                SBE_VM_INSTRUCTION(isObject) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -1546,9 +1914,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::isArray: {
+                SBE_VM_INSTRUCTION(isArray) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -1558,9 +1926,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::isString: {
+                SBE_VM_INSTRUCTION(isString) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -1570,9 +1938,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::isNumber: {
+                SBE_VM_INSTRUCTION(isNumber) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -1582,9 +1950,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::typeMatch: {
+                SBE_VM_INSTRUCTION(typeMatch) {
                     auto typeMask = value::readFromMemory<uint32_t>(pcPointer);
                     pcPointer += sizeof(typeMask);
 
@@ -1598,9 +1966,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::function: {
+                SBE_VM_INSTRUCTION(function) {
                     auto f = value::readFromMemory<Builtin>(pcPointer);
                     pcPointer += sizeof(f);
                     auto arity = value::readFromMemory<uint8_t>(pcPointer);
@@ -1618,16 +1986,16 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
 
                     pushStack(owned, tag, val);
 
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::jmp: {
+                SBE_VM_INSTRUCTION(jmp) {
                     auto jumpOffset = value::readFromMemory<int>(pcPointer);
                     pcPointer += sizeof(jumpOffset);
 
                     pcPointer += jumpOffset;
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::jmpTrue: {
+                SBE_VM_INSTRUCTION(jmpTrue) {
                     auto jumpOffset = value::readFromMemory<int>(pcPointer);
                     pcPointer += sizeof(jumpOffset);
 
@@ -1641,9 +2009,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::jmpNothing: {
+                SBE_VM_INSTRUCTION(jmpNothing) {
                     auto jumpOffset = value::readFromMemory<int>(pcPointer);
                     pcPointer += sizeof(jumpOffset);
 
@@ -1651,9 +2019,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
                     if (tag == value::TypeTags::Nothing) {
                         pcPointer += jumpOffset;
                     }
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
-                case Instruction::fail: {
+                SBE_VM_INSTRUCTION(fail) {
                     auto [ownedCode, tagCode, valCode] = getFromStack(1);
                     invariant(tagCode == value::TypeTags::NumberInt64);
 
@@ -1666,13 +2034,18 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
 
                     uasserted(code, message);
 
-                    break;
+                    SBE_VM_DISPATCH_NEXT();
                 }
                 default:
                     MONGO_UNREACHABLE;
             }
         }
     }
+#ifdef SBE_VM_THREADED_DISPATCH
+dispatchDone:
+#endif
+    _instrsExecuted += instrsExecuted;
+
     uassert(
         4822801, "The evaluation stack must hold only a single value", _argStackOwned.size() == 1);
 
@@ -1687,6 +2060,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(CodeFragment* c
     return {owned, tag, val};
 }
 
+#undef SBE_VM_DISPATCH_NEXT
+#undef SBE_VM_INSTRUCTION
+
 bool ByteCode::runPredicate(CodeFragment* code) {
     auto [owned, tag, val] = run(code);
 
@@ -128,12 +128,21 @@ struct Instruction {
         eq,
         neq,
 
+        // Comparisons against a constant right hand side encoded in the instruction stream.
+        lessImm,
+        lessEqImm,
+        greaterImm,
+        greaterEqImm,
+        eqImm,
+        neqImm,
+
         // 3 way comparison (spaceship) with bson woCompare semantics.
         cmp3w,
 
         fillEmpty,
 
         getField,
+        getFieldImm,  // the field name is encoded in the instruction stream
 
         aggSum,
         aggMin,
@@ -180,6 +189,8 @@ enum class Builtin : uint8_t {
     addToArray,       // agg function to append to an array
     addToSet,         // agg function to append to a set
     doubleDoubleSum,  // special double summation
+    eqLookupMatch,    // $lookup equality match of a local value against a foreign value
+    eqLookupKey,      // field of a document to be matched by eqLookupMatch
 };
 
 class CodeFragment {
@@ -190,6 +201,9 @@ public:
     auto stackSize() const {
         return _stackSize;
     }
+    auto instrCount() const {
+        return _instrCount;
+    }
     void removeFixup(FrameId frameId);
 
     void append(std::unique_ptr<CodeFragment> code);
@@ -230,6 +244,24 @@ public:
     void appendNeq() {
         appendSimpleInstruction(Instruction::neq);
     }
+    void appendLessImm(value::TypeTags tag, value::Value val) {
+        appendConstInstruction(Instruction::lessImm, tag, val);
+    }
+    void appendLessEqImm(value::TypeTags tag, value::Value val) {
+        appendConstInstruction(Instruction::lessEqImm, tag, val);
+    }
+    void appendGreaterImm(value::TypeTags tag, value::Value val) {
+        appendConstInstruction(Instruction::greaterImm, tag, val);
+    }
+    void appendGreaterEqImm(value::TypeTags tag, value::Value val) {
+        appendConstInstruction(Instruction::greaterEqImm, tag, val);
+    }
+    void appendEqImm(value::TypeTags tag, value::Value val) {
+        appendConstInstruction(Instruction::eqImm, tag, val);
+    }
+    void appendNeqImm(value::TypeTags tag, value::Value val) {
+        appendConstInstruction(Instruction::neqImm, tag, val);
+    }
     void appendCmp3w() {
         appendSimpleInstruction(Instruction::cmp3w);
     }
@@ -237,6 +269,9 @@ public:
         appendSimpleInstruction(Instruction::fillEmpty);
     }
     void appendGetField();
+    void appendGetFieldImm(value::TypeTags tag, value::Value val) {
+        appendConstInstruction(Instruction::getFieldImm, tag, val);
+    }
     void appendSum();
     void appendMin();
     void appendMax();
@@ -260,7 +295,16 @@ public:
 
 private:
     void appendSimpleInstruction(Instruction::Tags tag);
+    /**
+     * Appends an instruction followed by a non-owned constant operand. The constant must outlive
+     * the code fragment, which holds for constants owned by the compiled expression tree.
+     */
+    void appendConstInstruction(Instruction::Tags tag,
+                                value::TypeTags constTag,
+                                value::Value constVal);
+    // Every instruction is appended through a single allocation of its encoded size.
     auto allocateSpace(size_t size) {
+        ++_instrCount;
         auto oldSize = _instrs.size();
         _instrs.resize(oldSize + size);
         return _instrs.data() + oldSize;
@@ -286,6 +330,9 @@ private:
     std::vector<FixUp> _fixUps;
 
     int _stackSize{0};
+
+    // The number of instructions in the fragment (regardless of the control flow).
+    size_t _instrCount{0};
 };
 
 class ByteCode {
@@ -295,7 +342,17 @@ public:
     std::tuple<uint8_t, value::TypeTags, value::Value> run(CodeFragment* code);
     bool runPredicate(CodeFragment* code);
 
+    /**
+     * Returns the total number of instructions executed by this interpreter across all calls to
+     * run().
+     */
+    size_t instrsExecuted() const {
+        return _instrsExecuted;
+    }
+
 private:
+    size_t _instrsExecuted{0};
+
     std::vector<uint8_t> _argStackOwned;
     std::vector<value::TypeTags> _argStackTags;
     std::vector<value::Value> _argStackVals;
@@ -397,6 +454,8 @@ private:
     std::tuple<bool, value::TypeTags, value::Value> builtinAddToArray(uint8_t arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinAddToSet(uint8_t arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinDoubleDoubleSum(uint8_t arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinEqLookupMatch(uint8_t arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinEqLookupKey(uint8_t arity);
 
     std::tuple<bool, value::TypeTags, value::Value> dispatchBuiltin(Builtin f, uint8_t arity);
 
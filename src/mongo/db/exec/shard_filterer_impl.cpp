@@ -43,13 +43,18 @@ ShardFiltererImpl::ShardFiltererImpl(ScopedCollectionFilter cf) : _collectionFil
 }
 
 ShardFilterer::DocumentBelongsResult ShardFiltererImpl::_shardKeyBelongsToMe(
-    const BSONObj shardKey) const {
+    const BSONObj& shardKey) const {
     if (shardKey.isEmpty()) {
         return DocumentBelongsResult::kNoShardKey;
     }
 
-    return _collectionFilter.keyBelongsToMe(shardKey) ? DocumentBelongsResult::kBelongs
-                                                      : DocumentBelongsResult::kDoesNotBelong;
+    if (!_lastChunkRange || !_lastChunkRange->containsKey(shardKey)) {
+        _lastChunkRange = boost::none;
+        _lastChunkBelongs = _collectionFilter.keyBelongsToMe(shardKey, &_lastChunkRange);
+    }
+
+    return _lastChunkBelongs ? DocumentBelongsResult::kBelongs
+                             : DocumentBelongsResult::kDoesNotBelong;
 }
 
 
@@ -66,7 +71,7 @@ ShardFilterer::DocumentBelongsResult ShardFiltererImpl::documentBelongsToMe(
     // extractShardKeyFromIndexKeyData().
     invariant(!wsm.keyData.empty());
     std::vector<ShardKeyPattern::IndexKeyData> indexKeyDataVector;
-    indexKeyDataVector.resize(wsm.keyData.size());
+    indexKeyDataVector.reserve(wsm.keyData.size());
     for (auto&& indexKeyData : wsm.keyData) {
         indexKeyDataVector.push_back({indexKeyData.keyData, indexKeyData.indexKeyPattern});
     }
@@ -52,8 +52,15 @@ public:
     }
 
 private:
-    DocumentBelongsResult _shardKeyBelongsToMe(BSONObj shardKey) const;
+    DocumentBelongsResult _shardKeyBelongsToMe(const BSONObj& shardKey) const;
     ScopedCollectionFilter _collectionFilter;
     boost::optional<ShardKeyPattern> _keyPattern;
+
+    // Bounds and ownership of the chunk which contained the most recently filtered shard key. Scans
+    // tend to return runs of documents from the same chunk, so checking this range first lets
+    // most documents skip the routing table lookup. The filter is a fixed snapshot of the chunk
+    // ownership, so the cached answer stays valid for the lifetime of this object.
+    mutable boost::optional<ChunkRange> _lastChunkRange;
+    mutable bool _lastChunkBelongs = false;
 };
 }  // namespace mongo
@@ -98,7 +98,8 @@ SortStageDefault::SortStageDefault(boost::intrusive_ptr<ExpressionContext> expCt
                     limit,
                     maxMemoryUsageBytes,
                     expCtx->tempDir,
-                    expCtx->allowDiskUse) {}
+                    expCtx->allowDiskUse,
+                    addSortKeyMetadata) {}
 
 void SortStageDefault::spool(WorkingSetID wsid) {
     SortableWorkingSetMember extractedMember{_ws->extract(wsid)};
@@ -134,7 +135,8 @@ SortStageSimple::SortStageSimple(boost::intrusive_ptr<ExpressionContext> expCtx,
                     limit,
                     maxMemoryUsageBytes,
                     expCtx->tempDir,
-                    expCtx->allowDiskUse) {}
+                    expCtx->allowDiskUse,
+                    addSortKeyMetadata) {}
 
 void SortStageSimple::spool(WorkingSetID wsid) {
     auto member = _ws->get(wsid);
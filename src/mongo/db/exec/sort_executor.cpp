@@ -61,3 +61,12 @@ MONGO_CREATE_SORTER(mongo::Value,
                     mongo::SortableWorkingSetMember,
                     mongo::SortExecutor<mongo::SortableWorkingSetMember>::Comparator);
 MONGO_CREATE_SORTER(mongo::Value, mongo::BSONObj, mongo::SortExecutor<mongo::BSONObj>::Comparator);
+MONGO_CREATE_SORTER(mongo::KeyString::Value,
+                    mongo::Document,
+                    mongo::SortExecutor<mongo::Document>::KeyStringComparator);
+MONGO_CREATE_SORTER(mongo::KeyString::Value,
+                    mongo::SortableWorkingSetMember,
+                    mongo::SortExecutor<mongo::SortableWorkingSetMember>::KeyStringComparator);
+MONGO_CREATE_SORTER(mongo::KeyString::Value,
+                    mongo::BSONObj,
+                    mongo::SortExecutor<mongo::BSONObj>::KeyStringComparator);
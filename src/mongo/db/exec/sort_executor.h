@@ -34,8 +34,10 @@
 #include "mongo/db/exec/sort_key_comparator.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/sort_pattern.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/key_string.h"
 
 namespace mongo {
 /**
@@ -47,6 +49,10 @@ namespace mongo {
  * The template parameter is the type of data being sorted. In DocumentSource execution, we sort
  * Document objects directly, but in the PlanStage layer we may sort WorkingSetMembers. The type of
  * the sort key, on the other hand, is always Value.
+ *
+ * If the caller does not need the sort keys back, and 'internalQueryUseKeyStringSortKeys' is set,
+ * each sort key is encoded into a KeyString when it is added, and the data is sorted by comparing
+ * the KeyStrings byte-wise.
  */
 template <typename T>
 class SortExecutor {
@@ -64,17 +70,32 @@ public:
         SortKeyComparator _sortKeyComparator;
     };
 
+    using KeyStringSorter = Sorter<KeyString::Value, T>;
+    class KeyStringComparator {
+    public:
+        int operator()(const typename KeyStringSorter::Data& lhs,
+                       const typename KeyStringSorter::Data& rhs) const {
+            return lhs.first.compare(rhs.first);
+        }
+    };
+
     /**
-     * If the passed in limit is 0, this is treated as no limit.
+     * If the passed in limit is 0, this is treated as no limit. If 'returnSortKeys' is false, the
+     * sort keys returned by 'getNext()' may be missing.
      */
     SortExecutor(SortPattern sortPattern,
                  uint64_t limit,
                  uint64_t maxMemoryUsageBytes,
                  std::string tempDir,
-                 bool allowDiskUse)
+                 bool allowDiskUse,
+                 bool returnSortKeys)
         : _sortPattern(std::move(sortPattern)),
           _tempDir(std::move(tempDir)),
           _diskUseAllowed(allowDiskUse) {
+        if (!returnSortKeys && internalQueryUseKeyStringSortKeys.load() &&
+            SortKeyKeyStringEncoder::canEncode(_sortPattern)) {
+            _keyStringEncoder.emplace(_sortPattern);
+        }
         _stats.sortPattern =
             _sortPattern.serialize(SortPattern::SortKeySerialization::kForExplain).toBson();
         _stats.limit = limit;
@@ -123,10 +144,17 @@ public:
      * Should only be called before 'loadingDone()' is called.
      */
     void add(const Value& sortKey, const T& data) {
-        if (!_sorter) {
-            _sorter.reset(DocumentSorter::make(makeSortOptions(), Comparator(_sortPattern)));
+        if (_keyStringEncoder) {
+            if (!_keyStringSorter) {
+                _keyStringSorter.reset(makeKeyStringSorter());
+            }
+            _keyStringSorter->add(_keyStringEncoder->encode(sortKey), data);
+        } else {
+            if (!_sorter) {
+                _sorter.reset(DocumentSorter::make(makeSortOptions(), Comparator(_sortPattern)));
+            }
+            _sorter->add(sortKey, data);
         }
-        _sorter->add(sortKey, data);
 
         _stats.totalDataSizeBytes += data.memUsageForSorter();
     }
@@ -135,6 +163,17 @@ public:
      * Signals to the sort executor that there will be no more input documents.
      */
     void loadingDone() {
+        if (_keyStringEncoder) {
+            // This conditional should only pass if no documents were added to the sorter.
+            if (!_keyStringSorter) {
+                _keyStringSorter.reset(makeKeyStringSorter());
+            }
+            _keyStringOutput.reset(_keyStringSorter->done());
+            _stats.wasDiskUsed = _stats.wasDiskUsed || _keyStringSorter->usedDisk();
+            _keyStringSorter.reset();
+            return;
+        }
+
         // This conditional should only pass if no documents were added to the sorter.
         if (!_sorter) {
             _sorter.reset(DocumentSorter::make(makeSortOptions(), Comparator(_sortPattern)));
@@ -153,8 +192,9 @@ public:
             return false;
         }
 
-        if (!_output->more()) {
+        if (_keyStringEncoder ? !_keyStringOutput->more() : !_output->more()) {
             _output.reset();
+            _keyStringOutput.reset();
             _isEOF = true;
             return false;
         }
@@ -168,6 +208,9 @@ public:
      * end-of-stream must be detected with 'hasNext()'.
      */
     std::pair<Value, T> getNext() {
+        if (_keyStringEncoder) {
+            return {Value(), _keyStringOutput->next().second};
+        }
         return _output->next();
     }
 
@@ -183,10 +226,19 @@ private:
             opts.extSortAllowed = true;
             opts.tempDir = _tempDir;
         }
+        opts.readAhead = internalQueryEnableSorterReadAhead.load();
+        opts.maxSortThreads = internalSorterMaxThreads.load();
 
         return opts;
     }
 
+    KeyStringSorter* makeKeyStringSorter() const {
+        return KeyStringSorter::make(
+            makeSortOptions(),
+            KeyStringComparator(),
+            typename KeyStringSorter::Settings{KeyString::Version::kLatestVersion, {}});
+    }
+
     const SortPattern _sortPattern;
     const std::string _tempDir;
     const bool _diskUseAllowed;
@@ -194,6 +246,11 @@ private:
     std::unique_ptr<DocumentSorter> _sorter;
     std::unique_ptr<typename DocumentSorter::Iterator> _output;
 
+    // Set if the sort keys are encoded into KeyStrings, which are sorted by '_keyStringSorter'.
+    boost::optional<SortKeyKeyStringEncoder> _keyStringEncoder;
+    std::unique_ptr<KeyStringSorter> _keyStringSorter;
+    std::unique_ptr<typename KeyStringSorter::Iterator> _keyStringOutput;
+
     SortStats _stats;
 
     bool _isEOF = false;
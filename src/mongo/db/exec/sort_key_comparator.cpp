@@ -29,6 +29,8 @@
 
 #include "mongo/db/exec/sort_key_comparator.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
+
 namespace mongo {
 
 SortKeyComparator::SortKeyComparator(const SortPattern& sortPattern) {
@@ -82,4 +84,45 @@ SortKeyComparator::SortKeyComparator(const BSONObj& sortPattern) {
                    });
 }
 
+namespace {
+Ordering makeOrdering(const SortPattern& sortPattern) {
+    BSONObjBuilder directions;
+    for (auto&& part : sortPattern) {
+        directions.append("", part.isAscending ? 1 : -1);
+    }
+    return Ordering::make(directions.done());
+}
+}  // namespace
+
+bool SortKeyKeyStringEncoder::canEncode(const SortPattern& sortPattern) {
+    return sortPattern.size() <= Ordering::kMaxCompoundIndexKeys;
+}
+
+SortKeyKeyStringEncoder::SortKeyKeyStringEncoder(const SortPattern& sortPattern)
+    : _ordering(makeOrdering(sortPattern)), _numParts(sortPattern.size()) {
+    invariant(canEncode(sortPattern));
+}
+
+KeyString::Value SortKeyKeyStringEncoder::encode(const Value& sortKey) const {
+    BSONObjBuilder parts;
+    auto appendPart = [&](const Value& part) {
+        // A missing component compares equal to undefined, as it does in Value::compare().
+        if (part.missing()) {
+            parts.appendUndefined("");
+        } else {
+            part.addToBsonObj(&parts, ""_sd);
+        }
+    };
+    if (_numParts == 1) {
+        appendPart(sortKey);
+    } else {
+        for (size_t i = 0; i < _numParts; ++i) {
+            appendPart(sortKey[i]);
+        }
+    }
+
+    KeyString::Builder builder(KeyString::Version::kLatestVersion, parts.done(), _ordering);
+    return builder.getValueCopy();
+}
+
 }  // namespace mongo
@@ -31,8 +31,10 @@
 
 #include <vector>
 
+#include "mongo/bson/ordering.h"
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/db/query/sort_pattern.h"
+#include "mongo/db/storage/key_string.h"
 
 namespace mongo {
 
@@ -55,4 +57,27 @@ private:
     std::vector<SortDirection> _pattern;
 };
 
+/**
+ * Encodes sort keys as KeyStrings, which compare byte-wise in the same order in which
+ * SortKeyComparator compares the sort keys themselves. This lets a blocking sort pay for the
+ * type-aware comparison of a sort key once, rather than on every comparison. A sort key cannot be
+ * decoded from its KeyString.
+ */
+class SortKeyKeyStringEncoder {
+public:
+    /**
+     * Returns true if the sort keys of 'sortPattern' can be encoded. KeyStrings store the sort
+     * direction of at most 32 components.
+     */
+    static bool canEncode(const SortPattern& sortPattern);
+
+    explicit SortKeyKeyStringEncoder(const SortPattern& sortPattern);
+
+    KeyString::Value encode(const Value& sortKey) const;
+
+private:
+    Ordering _ordering;
+    size_t _numParts;
+};
+
 }  // namespace mongo
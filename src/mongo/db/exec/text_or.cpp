@@ -61,8 +61,7 @@ TextOrStage::TextOrStage(ExpressionContext* expCtx,
       _ftsSpec(ftsSpec),
       _ws(ws),
       _scoreIterator(_scores.end()),
-      _filter(filter),
-      _idRetrying(WorkingSet::INVALID_ID) {}
+      _filter(filter) {}
 
 void TextOrStage::addChild(unique_ptr<PlanStage> child) {
     _children.push_back(std::move(child));
@@ -170,19 +169,11 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
     invariant(_currentChild < _children.size());
 
-    // Either retry the last WSM we worked on or get a new one from our current child.
     WorkingSetID id;
-    StageState childState;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        childState = _children[_currentChild]->work(&id);
-    } else {
-        childState = ADVANCED;
-        id = _idRetrying;
-        _idRetrying = WorkingSet::INVALID_ID;
-    }
+    StageState childState = _children[_currentChild]->work(&id);
 
     if (PlanStage::ADVANCED == childState) {
-        return addTerm(id, out);
+        return addTerm(id);
     } else if (PlanStage::IS_EOF == childState) {
         // Done with this child.
         ++_currentChild;
@@ -212,14 +203,32 @@ PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
 
     // Retrieve the record that contains the text score.
     TextRecordData textRecordData = _scoreIterator->second;
-    ++_scoreIterator;
 
     // Ignore non-matched documents.
     if (textRecordData.score < 0) {
         invariant(textRecordData.wsid == WorkingSet::INVALID_ID);
+        ++_scoreIterator;
         return PlanStage::NEED_TIME;
     }
 
+    // Our parent expects RID_AND_OBJ members, so we fetch the document now that it has been scored.
+    // Fetching only here, rather than when the document's first term is read, means that only one
+    // fetched document at a time is held in the working set. If fetching throws a write conflict,
+    // the same document is retried after yielding.
+    try {
+        if (!WorkingSetCommon::fetch(
+                opCtx(), _ws, textRecordData.wsid, _recordCursor, collection()->ns())) {
+            _ws->free(textRecordData.wsid);
+            ++_scoreIterator;
+            return PlanStage::NEED_TIME;
+        }
+        ++_specificStats.fetches;
+    } catch (const WriteConflictException&) {
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+    ++_scoreIterator;
+
     WorkingSetMember* wsm = _ws->get(textRecordData.wsid);
 
     // Populate the working set member with the text score metadata and return it.
@@ -228,7 +237,7 @@ PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     return PlanStage::ADVANCED;
 }
 
-PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out) {
+PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid) {
     WorkingSetMember* wsm = _ws->get(wsid);
     invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
     invariant(1 == wsm->keyData.size());
@@ -252,34 +261,15 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
             return NEED_TIME;
         }
 
-        // Our parent expects RID_AND_OBJ members, so we fetch the document here if we haven't
-        // already.
-        try {
-            if (!WorkingSetCommon::fetch(opCtx(), _ws, wsid, _recordCursor, collection()->ns())) {
-                _ws->free(wsid);
-                textRecordData->score = -1;
-                return NEED_TIME;
-            }
-            ++_specificStats.fetches;
-        } catch (const WriteConflictException&) {
-            wsm->makeObjOwnedIfNeeded();
-            _idRetrying = wsid;
-            *out = WorkingSet::INVALID_ID;
-            return NEED_YIELD;
-        }
-
+        // Keep the index key member around; the document is fetched once all terms have been read.
         textRecordData->wsid = wsid;
-
-        // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
-        wsm->makeObjOwnedIfNeeded();
     } else {
-        // We already have a working set member for this RecordId. Free the new WSM and retrieve the
-        // old one. Note that since we don't keep all index keys, we could get a score that doesn't
-        // match the document, but this has always been a problem.
+        // We already have a working set member for this RecordId. Free the new WSM. Note that
+        // since we don't keep all index keys, we could get a score that doesn't match the
+        // document, but this has always been a problem.
         // TODO something to improve the situation.
         invariant(wsid != textRecordData->wsid);
         _ws->free(wsid);
-        wsm = _ws->get(textRecordData->wsid);
     }
 
     // Locate score within possibly compound key: {prefix,term,score,suffix}.
@@ -116,10 +116,11 @@ private:
      * Helper called from readFromChildren to update aggregate score with a newfound (term, score)
      * pair for this document.
      */
-    StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
+    StageState addTerm(WorkingSetID wsid);
 
     /**
-     * Worker for kReturningResults. Returns a wsm with RecordID and Score.
+     * Worker for kReturningResults. Fetches the next scored document and returns a wsm with
+     * RecordID, document and Score.
      */
     StageState returnResults(WorkingSetID* out);
 
@@ -154,7 +155,6 @@ private:
 
     // Members needed only for using the TextMatchableDocument.
     const MatchExpression* _filter;
-    WorkingSetID _idRetrying;
     std::unique_ptr<SeekableRecordCursor> _recordCursor;
 };
 }  // namespace mongo
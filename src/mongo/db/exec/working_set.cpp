@@ -29,6 +29,8 @@
 
 #include "mongo/db/exec/working_set.h"
 
+#include <cstring>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
@@ -43,35 +45,41 @@ WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
 WorkingSetID WorkingSet::allocate() {
     if (_freeList == INVALID_ID) {
-        // The free list is empty so we need to make a single new WSM to return. This relies on
-        // vector::resize being amortized O(1) for efficient allocation. Note that the free list
-        // remains empty until something is returned by a call to free().
-        WorkingSetID id = _data.size();
-        _data.resize(_data.size() + 1);
-        _data.back().nextFreeOrSelf = id;
+        // The free list is empty so we need to hand out a member that has never been used. Members
+        // are constructed a slab at a time, so this only allocates once every kMembersPerSlab
+        // calls. Note that the free list remains empty until something is returned by a call to
+        // free().
+        WorkingSetID id = _numMembers;
+        if (id % kMembersPerSlab == 0) {
+            _slabs.push_back(std::make_unique<MemberHolder[]>(kMembersPerSlab));
+        }
+        ++_numMembers;
+        holder(id).nextFreeOrSelf = id;
         return id;
     }
 
     // Pop the head off the free list and return it.
     WorkingSetID id = _freeList;
-    _freeList = _data[id].nextFreeOrSelf;
-    _data[id].nextFreeOrSelf = id;  // set to self to mark as in-use
+    _freeList = holder(id).nextFreeOrSelf;
+    holder(id).nextFreeOrSelf = id;  // set to self to mark as in-use
     return id;
 }
 
 void WorkingSet::free(WorkingSetID i) {
-    MemberHolder& holder = _data[i];
-    verify(i < _data.size());            // ID has been allocated.
-    verify(holder.nextFreeOrSelf == i);  // ID currently in use.
-
-    // Free resources and push this WSM to the head of the freelist.
-    holder.member.clear();
-    holder.nextFreeOrSelf = _freeList;
+    verify(i < _numMembers);  // ID has been allocated.
+    MemberHolder& memberHolder = holder(i);
+    verify(memberHolder.nextFreeOrSelf == i);  // ID currently in use.
+
+    // Free resources and push this WSM to the head of the freelist. Clearing the member keeps
+    // whatever storage it can for the next user of this id.
+    memberHolder.member.clear();
+    memberHolder.nextFreeOrSelf = _freeList;
     _freeList = i;
 }
 
 void WorkingSet::clear() {
-    _data.clear();
+    _slabs.clear();
+    _numMembers = 0;
 
     // Since working set is now empty, the free list pointer should
     // point to nothing.
@@ -94,8 +102,8 @@ void WorkingSet::transitionToOwnedObj(WorkingSetID id) {
 }
 
 WorkingSetMember WorkingSet::extract(WorkingSetID wsid) {
-    invariant(wsid < _data.size());
-    WorkingSetMember ret = std::move(_data[wsid].member);
+    invariant(wsid < _numMembers);
+    WorkingSetMember ret = std::move(holder(wsid).member);
     free(wsid);
     return ret;
 }
@@ -156,6 +164,25 @@ void WorkingSetMember::makeObjOwnedIfNeeded() {
     }
 }
 
+void WorkingSetMember::appendIndexKey(const BSONObj& keyPattern,
+                                      const BSONObj& key,
+                                      WorkingSetRegisteredIndexId indexId,
+                                      SnapshotId snapshotId) {
+    if (key.isOwned() || key.objsize() > kInlineKeyStorageBytes) {
+        keyData.emplace_back(keyPattern, key.getOwned(), indexId, snapshotId);
+        return;
+    }
+
+    // The inline storage can only be overwritten once no BSONObj refers to it any longer. It may
+    // still be referenced by an earlier key of this member, or by a copy of that key which another
+    // stage has taken, in which case we leave it to them and start a new buffer.
+    if (!_inlineKeyStorage || _inlineKeyStorage.isShared()) {
+        _inlineKeyStorage = SharedBuffer::allocate(kInlineKeyStorageBytes);
+    }
+    std::memcpy(_inlineKeyStorage.get(), key.objdata(), key.objsize());
+    keyData.emplace_back(keyPattern, BSONObj(_inlineKeyStorage), indexId, snapshotId);
+}
+
 bool WorkingSetMember::getFieldDotted(const string& field, BSONElement* out) const {
     // If our state is such that we have an object, use it.
     if (hasObj()) {
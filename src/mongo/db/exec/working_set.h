@@ -30,6 +30,7 @@
 #pragma once
 
 #include "boost/optional.hpp"
+#include <memory>
 #include <vector>
 
 #include "mongo/db/exec/document_value/document.h"
@@ -38,6 +39,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/snapshot.h"
 #include "mongo/stdx/unordered_set.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
@@ -129,6 +131,10 @@ public:
         OWNED_OBJ,
     };
 
+    // Unowned index keys up to this size are copied into storage that the member keeps across
+    // calls to clear(), rather than into a freshly allocated buffer.
+    static constexpr int kInlineKeyStorageBytes = 128;
+
     static WorkingSetMember deserialize(BufReader& buf);
 
     /**
@@ -158,6 +164,17 @@ public:
     bool hasObj() const;
     bool hasOwnedObj() const;
 
+    /**
+     * Adds an owned copy of 'key' to 'keyData'. An owned 'key' is shared rather than copied. An
+     * unowned 'key' of at most kInlineKeyStorageBytes is copied into this member's inline key
+     * storage, which is reused by later keys once nothing else references it. This means that index
+     * scans over small keys do not allocate per key once their WorkingSet has warmed up.
+     */
+    void appendIndexKey(const BSONObj& keyPattern,
+                        const BSONObj& key,
+                        WorkingSetRegisteredIndexId indexId,
+                        SnapshotId snapshotId);
+
     /**
      * Ensures that 'obj' of a WSM in the RID_AND_OBJ state is owned BSON. It is a no-op if the WSM
      * is in a different state or if 'obj' is already owned.
@@ -230,6 +247,10 @@ private:
     MemberState _state = WorkingSetMember::INVALID;
 
     DocumentMetadataFields _metadata;
+
+    // Buffer of kInlineKeyStorageBytes backing the most recent small key added by
+    // appendIndexKey(). Survives clear() so that a recycled member can reuse it.
+    SharedBuffer _inlineKeyStorage;
 };
 
 /**
@@ -321,22 +342,22 @@ public:
      * release it.
      */
     WorkingSetMember* get(WorkingSetID i) {
-        dassert(i < _data.size());              // ID has been allocated.
-        dassert(_data[i].nextFreeOrSelf == i);  // ID currently in use.
-        return &_data[i].member;
+        dassert(i < _numMembers);                // ID has been allocated.
+        dassert(holder(i).nextFreeOrSelf == i);  // ID currently in use.
+        return &holder(i).member;
     }
 
     const WorkingSetMember* get(WorkingSetID i) const {
-        dassert(i < _data.size());              // ID has been allocated.
-        dassert(_data[i].nextFreeOrSelf == i);  // ID currently in use.
-        return &_data[i].member;
+        dassert(i < _numMembers);                // ID has been allocated.
+        dassert(holder(i).nextFreeOrSelf == i);  // ID currently in use.
+        return &holder(i).member;
     }
 
     /**
      * Returns true if WorkingSetMember with id 'i' is free.
      */
     bool isFree(WorkingSetID i) const {
-        return _data[i].nextFreeOrSelf != i;
+        return holder(i).nextFreeOrSelf != i;
     }
 
     /**
@@ -389,6 +410,9 @@ public:
      */
     WorkingSetID emplace(WorkingSetMember&&);
 
+    // Number of members in each slab. Must be a power of two.
+    static constexpr size_t kMembersPerSlab = 64;
+
 private:
     struct MemberHolder {
         // Free list link if freed. Points to self if in use.
@@ -397,13 +421,27 @@ private:
         WorkingSetMember member;
     };
 
-    // All WorkingSetIDs are indexes into this, except for INVALID_ID.
-    // Elements are added to _freeList rather than removed when freed.
-    std::vector<MemberHolder> _data;
+    MemberHolder& holder(WorkingSetID i) {
+        return _slabs[i / kMembersPerSlab][i % kMembersPerSlab];
+    }
+
+    const MemberHolder& holder(WorkingSetID i) const {
+        return _slabs[i / kMembersPerSlab][i % kMembersPerSlab];
+    }
+
+    // Members are allocated kMembersPerSlab at a time, so growing the WorkingSet never moves
+    // existing members and costs one allocation per slab rather than a reallocation of every
+    // member. A WorkingSetID 'i' lives at index 'i % kMembersPerSlab' of slab
+    // 'i / kMembersPerSlab'. Elements are added to _freeList rather than removed when freed.
+    std::vector<std::unique_ptr<MemberHolder[]>> _slabs;
+
+    // The number of members handed out from '_slabs' so far, whether in use or free. All
+    // WorkingSetIDs are less than this, except for INVALID_ID.
+    size_t _numMembers = 0;
 
-    // Index into _data, forming a linked-list using MemberHolder::nextFreeOrSelf as the next
+    // Index into the slabs, forming a linked-list using MemberHolder::nextFreeOrSelf as the next
     // link. INVALID_ID is the list terminator since 0 is a valid index.
-    // If _freeList == INVALID_ID, the free list is empty and all elements in _data are in use.
+    // If _freeList == INVALID_ID, the free list is empty and all allocated members are in use.
     WorkingSetID _freeList;
 
     // Holds IndexAccessMethods that have been registered with 'registerIndexAccessMethod()`. The
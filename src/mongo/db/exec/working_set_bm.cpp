@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/working_set.h"
+
+namespace mongo {
+namespace {
+
+const BSONObj kKeyPattern = BSON("a" << 1 << "b" << 1);
+
+/**
+ * Simulates an index scan feeding a streaming parent: each iteration allocates a member, fills it
+ * the way IndexScanStage does from an unowned cursor key, and frees it again. Reports how many
+ * key buffers had to be allocated per document, which drops to zero once members are recycled
+ * with their inline key storage.
+ */
+void BM_WorkingSetIndexScanStreaming(benchmark::State& state, bool useInlineKeyStorage) {
+    const BSONObj key = BSON("" << 42 << ""
+                                << "abc");
+    WorkingSet ws;
+    const char* lastKeyData = nullptr;
+    int64_t keyAllocations = 0;
+    for (auto _ : state) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->recordId = RecordId(1);
+        if (useInlineKeyStorage) {
+            member->appendIndexKey(kKeyPattern, BSONObj(key.objdata()), 0u, SnapshotId());
+        } else {
+            member->keyData.push_back(
+                IndexKeyDatum(kKeyPattern, BSONObj(key.objdata()).getOwned(), 0u, SnapshotId()));
+        }
+        ws.transitionToRecordIdAndIdx(id);
+        benchmark::DoNotOptimize(member);
+
+        const char* keyData = member->keyData[0].keyData.objdata();
+        if (keyData != lastKeyData) {
+            ++keyAllocations;
+            lastKeyData = keyData;
+        }
+        ws.free(id);
+    }
+    state.counters["keyAllocsPerDoc"] =
+        benchmark::Counter(keyAllocations, benchmark::Counter::kAvgIterations);
+}
+
+/**
+ * Simulates a blocking parent such as a sort buffering every member of an index scan before
+ * releasing them. Members are only recycled once a whole batch has been freed, so this measures
+ * the cost of growing the WorkingSet.
+ */
+void BM_WorkingSetIndexScanBuffered(benchmark::State& state) {
+    const BSONObj key = BSON("" << 42 << ""
+                                << "abc");
+    const size_t batchSize = state.range(0);
+    std::vector<WorkingSetID> ids(batchSize);
+    for (auto _ : state) {
+        WorkingSet ws;
+        for (size_t i = 0; i < batchSize; ++i) {
+            ids[i] = ws.allocate();
+            WorkingSetMember* member = ws.get(ids[i]);
+            member->recordId = RecordId(static_cast<int64_t>(i));
+            member->appendIndexKey(kKeyPattern, BSONObj(key.objdata()), 0u, SnapshotId());
+            ws.transitionToRecordIdAndIdx(ids[i]);
+        }
+        for (auto id : ids) {
+            ws.free(id);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+BENCHMARK_CAPTURE(BM_WorkingSetIndexScanStreaming, GetOwned, false);
+BENCHMARK_CAPTURE(BM_WorkingSetIndexScanStreaming, InlineKeyStorage, true);
+
+BENCHMARK(BM_WorkingSetIndexScanBuffered)->Arg(100)->Arg(10 * 1000)->Arg(100 * 1000);
+
+}  // namespace
+}  // namespace mongo
@@ -313,4 +313,55 @@ TEST_F(WorkingSetFixture, WsmCanBeExtractedAndReinserted) {
     ASSERT_FALSE(emplacedWsm->metadata());
 }
 
+TEST_F(WorkingSetFixture, MembersKeepTheirAddressAcrossSlabs) {
+    // Allocating enough members to need several slabs must not move the ones already handed out.
+    std::vector<WorkingSetID> ids;
+    for (size_t i = 0; i < 3 * WorkingSet::kMembersPerSlab; ++i) {
+        ids.push_back(ws->allocate());
+        ws->get(ids.back())->recordId = RecordId(static_cast<int64_t>(i + 1));
+    }
+    ASSERT_EQ(ws->get(id), member);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ASSERT_EQ(ws->get(ids[i])->recordId, RecordId(static_cast<int64_t>(i + 1)));
+    }
+
+    // A freed id is recycled before any new member is handed out.
+    ws->free(ids[5]);
+    ASSERT_TRUE(ws->isFree(ids[5]));
+    ASSERT_EQ(ws->allocate(), ids[5]);
+}
+
+TEST_F(WorkingSetFixture, AppendIndexKeyReusesInlineStorageOfRecycledMember) {
+    BSONObj keyPattern = BSON("a" << 1);
+    BSONObj firstKey = BSON("" << 1);
+    member->appendIndexKey(keyPattern, BSONObj(firstKey.objdata()), 0u, SnapshotId());
+    ws->transitionToRecordIdAndIdx(id);
+    ASSERT_EQ(member->keyData.size(), 1U);
+    ASSERT_TRUE(member->keyData[0].keyData.isOwned());
+    ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, firstKey);
+    const char* inlineStorage = member->keyData[0].keyData.objdata();
+
+    // Once freed and reallocated, the member copies the next small key into the same storage.
+    ws->free(id);
+    ASSERT_EQ(ws->allocate(), id);
+    BSONObj secondKey = BSON("" << 2);
+    member->appendIndexKey(keyPattern, BSONObj(secondKey.objdata()), 0u, SnapshotId());
+    ASSERT_EQ(member->keyData[0].keyData.objdata(), inlineStorage);
+    ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, secondKey);
+
+    // A copy of the key held elsewhere keeps its storage from being overwritten.
+    BSONObj heldKey = member->keyData[0].keyData;
+    ws->free(id);
+    ASSERT_EQ(ws->allocate(), id);
+    member->appendIndexKey(keyPattern, BSONObj(firstKey.objdata()), 0u, SnapshotId());
+    ASSERT_NE(member->keyData[0].keyData.objdata(), inlineStorage);
+    ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, firstKey);
+    ASSERT_BSONOBJ_EQ(heldKey, secondKey);
+
+    // Owned keys are shared rather than copied.
+    member->keyData.clear();
+    member->appendIndexKey(keyPattern, secondKey, 0u, SnapshotId());
+    ASSERT_EQ(member->keyData[0].keyData.objdata(), secondKey.objdata());
+}
+
 }  // namespace mongo
@@ -32,12 +32,72 @@
 #include "mongo/db/ftdc/block_compressor.h"
 
 #include <zlib.h>
+#include <zstd.h>
 
+#include "mongo/base/data_view.h"
+
+#include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
 
-StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source) {
+namespace {
+// zstd favors speed at its low levels while still compressing FTDC chunks better than zlib does at
+// its default level.
+constexpr int kZstdCompressionLevel = 3;
+
+bool isZstdFrame(ConstDataRange source) {
+    return source.length() >= sizeof(std::uint32_t) &&
+        ConstDataView(source.data()).read<LittleEndian<std::uint32_t>>() == ZSTD_MAGICNUMBER;
+}
+}  // namespace
+
+StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source,
+                                                     FTDCCompression compression) {
+    switch (compression) {
+        case FTDCCompression::kZlib:
+            return _compressZlib(source);
+        case FTDCCompression::kZstd:
+            return _compressZstd(source);
+    }
+    MONGO_UNREACHABLE;
+}
+
+StatusWith<ConstDataRange> BlockCompressor::uncompress(ConstDataRange source,
+                                                       size_t uncompressedLength) {
+    if (isZstdFrame(source)) {
+        return _uncompressZstd(source, uncompressedLength);
+    }
+    return _uncompressZlib(source, uncompressedLength);
+}
+
+StatusWith<ConstDataRange> BlockCompressor::_compressZstd(ConstDataRange source) {
+    _buffer.resize(ZSTD_compressBound(source.length()));
+
+    size_t ret = ZSTD_compress(
+        _buffer.data(), _buffer.size(), source.data(), source.length(), kZstdCompressionLevel);
+    if (ZSTD_isError(ret)) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "ZSTD_compress failed with " << ZSTD_getErrorName(ret)};
+    }
+
+    return ConstDataRange(_buffer.data(), ret);
+}
+
+StatusWith<ConstDataRange> BlockCompressor::_uncompressZstd(ConstDataRange source,
+                                                            size_t uncompressedLength) {
+    _buffer.resize(uncompressedLength);
+
+    size_t ret = ZSTD_decompress(_buffer.data(), _buffer.size(), source.data(), source.length());
+    if (ZSTD_isError(ret)) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "ZSTD_decompress failed with " << ZSTD_getErrorName(ret)};
+    }
+
+    return ConstDataRange(_buffer.data(), ret);
+}
+
+StatusWith<ConstDataRange> BlockCompressor::_compressZlib(ConstDataRange source) {
     z_stream stream;
     int level = Z_DEFAULT_COMPRESSION;
 
@@ -77,8 +137,8 @@ StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source) {
     return ConstDataRange(_buffer.data(), stream.total_out);
 }
 
-StatusWith<ConstDataRange> BlockCompressor::uncompress(ConstDataRange source,
-                                                       size_t uncompressedLength) {
+StatusWith<ConstDataRange> BlockCompressor::_uncompressZlib(ConstDataRange source,
+                                                            size_t uncompressedLength) {
     z_stream stream;
 
     stream.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(source.data()));
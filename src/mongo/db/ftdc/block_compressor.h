@@ -34,11 +34,14 @@
 
 #include "mongo/base/data_range.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/ftdc/config.h"
 
 namespace mongo {
 
 /**
- * Compesses and uncompresses a block of buffer using zlib.
+ * Compesses and uncompresses a block of buffer using zlib or zstd.
+ *
+ * Both formats are self-describing, uncompress() detects which one a block uses from its header.
  */
 class BlockCompressor {
     BlockCompressor(const BlockCompressor&) = delete;
@@ -53,7 +56,8 @@ public:
      * Returns a pointer to a buffer that BlockCompressor owns.
      * The returned buffer is valid until the next call to compress or uncompress.
      */
-    StatusWith<ConstDataRange> compress(ConstDataRange source);
+    StatusWith<ConstDataRange> compress(ConstDataRange source,
+                                        FTDCCompression compression = FTDCCompression::kZlib);
 
     /**
      * Uncompress a buffer of data.
@@ -67,6 +71,12 @@ public:
     StatusWith<ConstDataRange> uncompress(ConstDataRange source, size_t maxUncompressedLength);
 
 private:
+    StatusWith<ConstDataRange> _compressZlib(ConstDataRange source);
+    StatusWith<ConstDataRange> _compressZstd(ConstDataRange source);
+
+    StatusWith<ConstDataRange> _uncompressZlib(ConstDataRange source, size_t uncompressedLength);
+    StatusWith<ConstDataRange> _uncompressZstd(ConstDataRange source, size_t uncompressedLength);
+
     std::vector<std::uint8_t> _buffer;
 };
 
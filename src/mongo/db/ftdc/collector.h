@@ -92,6 +92,10 @@ public:
      */
     void add(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    bool empty() const {
+        return _collectors.empty();
+    }
+
     /**
      * Collect a sample from all collectors. Called after all adding is complete.
      * Returns a tuple of a sample, and the time at which collecting started.
@@ -31,7 +31,8 @@
 
 #include "mongo/db/ftdc/compressor.h"
 
-#include "mongo/base/data_builder.h"
+#include <third_party/s2/util/coding/varint.h>
+
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/ftdc/varint.h"
@@ -129,11 +130,6 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
     _uncompressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_deltaCount));
 
     if (_metricsCount != 0 && _deltaCount != 0) {
-        // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
-        DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
-
-        std::uint32_t zeroesCount = 0;
-
         // For each set of samples for a particular metric,
         // we think of it is simple array of 64-bit integers we try to compress into a byte array.
         // This is done in three steps for each metric
@@ -143,13 +139,47 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         // 2. Run Length Encoding of zeros
         //   - We find consecutive sets of zeros and represent them as a tuple of (0, count - 1).
         //   - Each memeber is stored as VarInt packed integer
+        //   - Runs of zeros continue across metrics
         // 3. Finally, for non-zero members, we store these as VarInt packed
         //
         // These byte arrays are added to a buffer which is then concatenated with other chunks and
-        // compressed with ZLIB.
+        // compressed with ZLIB or ZSTD.
+        //
+        // A delta encodes to at most one VarInt, and a run of zeros to a one byte VarInt plus the
+        // VarInt of its 32-bit count, so this bounds the size of the compacted metric chunk and
+        // lets us encode without any bounds checks.
+        _encodeBuffer.resize(static_cast<size_t>(_metricsCount) * _deltaCount *
+                                 FTDCVarInt::kMaxSizeBytes64 +
+                             FTDCVarInt::kMaxSizeBytes64);
+
+        char* const begin = _encodeBuffer.data();
+        char* out = begin;
+        std::uint32_t zeroesCount = 0;
+
+        auto writeZeroes = [&] {
+            out = Varint::Encode64(out, 0);
+            out = Varint::Encode64(out, zeroesCount - 1);
+            zeroesCount = 0;
+        };
+
         for (std::uint32_t i = 0; i < _metricsCount; i++) {
-            for (std::uint32_t j = 0; j < _deltaCount; j++) {
-                std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
+            const std::uint64_t* deltas = &_deltas[getArrayOffset(_maxDeltas, 0, i)];
+
+            std::uint32_t j = 0;
+            while (j < _deltaCount) {
+                // Most metrics do not change between samples, so skip over zeros a block of
+                // deltas at a time.
+                while (j + 4 <= _deltaCount &&
+                       (deltas[j] | deltas[j + 1] | deltas[j + 2] | deltas[j + 3]) == 0) {
+                    zeroesCount += 4;
+                    j += 4;
+                }
+
+                if (j == _deltaCount) {
+                    break;
+                }
+
+                std::uint64_t delta = deltas[j++];
 
                 if (delta == 0) {
                     ++zeroesCount;
@@ -158,48 +188,27 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
 
                 // If we have a non-zero sample, then write out all the accumulated zero samples.
                 if (zeroesCount > 0) {
-                    auto s1 = db.writeAndAdvance(FTDCVarInt(0));
-                    if (!s1.isOK()) {
-                        return s1;
-                    }
-
-                    auto s2 = db.writeAndAdvance(FTDCVarInt(zeroesCount - 1));
-                    if (!s2.isOK()) {
-                        return s2;
-                    }
-
-                    zeroesCount = 0;
+                    writeZeroes();
                 }
 
-                auto s3 = db.writeAndAdvance(FTDCVarInt(delta));
-                if (!s3.isOK()) {
-                    return s3;
-                }
+                out = Varint::Encode64(out, delta);
             }
+        }
 
-            // If we are on the last metric, and the previous loop ended in a zero, write out the
-            // RLE
-            // pair of zero information.
-            if ((i == (_metricsCount - 1)) && zeroesCount) {
-                auto s1 = db.writeAndAdvance(FTDCVarInt(0));
-                if (!s1.isOK()) {
-                    return s1;
-                }
-
-                auto s2 = db.writeAndAdvance(FTDCVarInt(zeroesCount - 1));
-                if (!s2.isOK()) {
-                    return s2;
-                }
-            }
+        // If the last metric ended in a zero, write out the RLE pair of zero information.
+        if (zeroesCount > 0) {
+            writeZeroes();
         }
 
+        dassert(static_cast<size_t>(out - begin) <= _encodeBuffer.size());
+
         // Append the entire compacted metric chunk into the uncompressed buffer
-        ConstDataRange cdr = db.getCursor();
-        _uncompressedChunkBuffer.appendBuf(cdr.data(), cdr.length());
+        _uncompressedChunkBuffer.appendBuf(begin, out - begin);
     }
 
     auto swDest = _compressor.compress(
-        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()));
+        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()),
+        _config->compression);
 
     // The only way for compression to fail is if the buffer size calculations are wrong
     if (!swDest.isOK()) {
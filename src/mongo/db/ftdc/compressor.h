@@ -54,7 +54,7 @@ namespace mongo {
  * 2. It stores the deltas into an array of std::int64_t.
  * 3. It compressed each std::int64_t using VarInt integer compression. See varint.h.
  * 4. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
- * 5. ZLIB compresses the final processed array
+ * 5. ZLIB or ZSTD compresses the final processed array, see FTDCConfig::compression
  *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
@@ -183,6 +183,9 @@ private:
     // Buffer for uncompressed metric chunk
     BufBuilder _uncompressedChunkBuffer;
 
+    // Buffer for the VarInt packed deltas of a metric chunk
+    std::vector<char> _encodeBuffer;
+
     // Buffer to hold metrics
     std::vector<std::uint64_t> _metrics;
     std::vector<std::uint64_t> _prevmetrics;
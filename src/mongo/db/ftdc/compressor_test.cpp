@@ -122,8 +122,11 @@ TEST_F(FTDCCompressorTest, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict)
-        : _compressor(&_config), _mode(mode) {}
+    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict,
+            FTDCCompression compression = FTDCCompression::kZlib)
+        : _compressor(&_config), _mode(mode) {
+        _config.compression = compression;
+    }
 
     ~TestTie() {
         validate(boost::none);
@@ -497,6 +500,59 @@ TEST_F(FTDCCompressorTest, TestFull) {
     }
 }
 
+// Test runs of zeros of every length, within and across metrics
+TEST_F(FTDCCompressorTest, TestZeroRuns) {
+    for (auto compression : {FTDCCompression::kZlib, FTDCCompression::kZstd}) {
+        TestTie c(FTDCValidationMode::kStrict, compression);
+
+        auto st = c.addSample(BSON("key1" << 0 << "key2" << 0 << "key3" << 0 << "key4" << 0));
+        ASSERT_HAS_SPACE(st);
+
+        // key1 never changes, key2 changes on every 7th sample, key3 on every other one and key4 on
+        // every sample.
+        for (long long i = 1; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 1; i++) {
+            st = c.addSample(BSON("key1" << 0 << "key2" << (i / 7) << "key3" << (i / 2) << "key4"
+                                         << i));
+            ASSERT_HAS_SPACE(st);
+        }
+
+        st = c.addSample(BSON("key1" << 0 << "key2" << 0 << "key3" << 0 << "key4" << 0));
+        ASSERT_FULL(st);
+    }
+}
+
+// Test that zstd compressed chunks round trip
+TEST_F(FTDCCompressorTest, TestZstd) {
+    TestTie c(FTDCValidationMode::kStrict, FTDCCompression::kZstd);
+
+    auto st = c.addSample(BSON("name"
+                               << "joe"
+                               << "key1" << 33 << "key2" << 42));
+    ASSERT_HAS_SPACE(st);
+
+    for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 2; i++) {
+        st = c.addSample(BSON("name"
+                              << "joe"
+                              << "key1" << static_cast<long long int>(i) << "key2" << 45));
+        ASSERT_HAS_SPACE(st);
+    }
+
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 34 << "key2" << 45));
+    ASSERT_FULL(st);
+
+    // Schema change with pending samples
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 34 << "key2" << 45));
+    ASSERT_HAS_SPACE(st);
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 34));
+    ASSERT_SCHEMA_CHANGED(st);
+}
+
 template <typename T>
 BSONObj generateSample(std::random_device& rd, T generator, size_t count) {
     BSONObjBuilder builder;
@@ -35,6 +35,13 @@
 
 namespace mongo {
 
+/**
+ * Block compression applied to metric chunks.
+ *
+ * zlib is the default since it is what existing FTDC decoders understand.
+ */
+enum class FTDCCompression { kZlib, kZstd };
+
 /**
  * Configuration settings for full-time diagnostic data capture (FTDC).
  *
@@ -46,6 +53,7 @@ struct FTDCConfig {
           maxDirectorySizeBytes(kMaxDirectorySizeBytesDefault),
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
+          highFrequencyPeriod(0),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
           maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
 
@@ -73,6 +81,15 @@ struct FTDCConfig {
      */
     Milliseconds period;
 
+    /**
+     * Period at which to run the high frequency collectors, zero disables them.
+     *
+     * Their samples form a second series of metric chunks interleaved with the periodic ones in the
+     * same files. It is not written to the interim file, so up to a chunk of it is lost if the
+     * process terminates.
+     */
+    Milliseconds highFrequencyPeriod;
+
     /**
      * Maximum number of samples to collect in an archive metric chunk for long term storage.
      */
@@ -84,6 +101,11 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Block compression applied to metric chunks.
+     */
+    FTDCCompression compression{FTDCCompression::kZlib};
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
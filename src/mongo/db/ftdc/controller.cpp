@@ -70,6 +70,18 @@ void FTDCController::setPeriod(Milliseconds millis) {
     _condvar.notify_one();
 }
 
+void FTDCController::setHighFrequencyPeriod(Milliseconds millis) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    _configTemp.highFrequencyPeriod = millis;
+    _condvar.notify_one();
+}
+
+void FTDCController::setCompression(FTDCCompression compression) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    _configTemp.compression = compression;
+    _condvar.notify_one();
+}
+
 void FTDCController::setMaxDirectorySizeBytes(std::uint64_t size) {
     stdx::lock_guard<Latch> lock(_mutex);
     _configTemp.maxDirectorySizeBytes = size;
@@ -120,6 +132,16 @@ void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighFrequencyCollector(
+    std::unique_ptr<FTDCCollectorInterface> collector) {
+    {
+        stdx::lock_guard<Latch> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _highFrequencyCollectors.add(std::move(collector));
+    }
+}
+
 void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
     {
         stdx::lock_guard<Latch> lock(_mutex);
@@ -206,7 +228,18 @@ void FTDCController::doLoop() noexcept {
         auto now = getGlobalServiceContext()->getPreciseClockSource()->now();
 
         // Get next time to run at
-        auto next_time = FTDCUtil::roundTime(now, _config.period);
+        auto next_periodic_time = FTDCUtil::roundTime(now, _config.period);
+        auto next_time = next_periodic_time;
+
+        // The high frequency collectors run on their own period, and together with the periodic
+        // collectors whenever both are due.
+        bool highFrequency =
+            _config.highFrequencyPeriod > Milliseconds(0) && !_highFrequencyCollectors.empty();
+        if (highFrequency) {
+            auto next_high_frequency_time = FTDCUtil::roundTime(now, _config.highFrequencyPeriod);
+            highFrequency = next_high_frequency_time <= next_periodic_time;
+            next_time = std::min(next_time, next_high_frequency_time);
+        }
 
         // Wait for the next run or signal to shutdown
         {
@@ -246,6 +279,19 @@ void FTDCController::doLoop() noexcept {
                 _mgr = uassertStatusOK(std::move(swMgr));
             }
 
+            if (highFrequency) {
+                auto collectSample = _highFrequencyCollectors.collect(client);
+
+                Status s = _mgr->writeHighFrequencySampleAndRotateIfNeeded(
+                    client, std::get<0>(collectSample), std::get<1>(collectSample));
+
+                uassertStatusOK(s);
+            }
+
+            if (next_time != next_periodic_time) {
+                continue;
+            }
+
             auto collectSample = _periodicCollectors.collect(client);
 
             Status s = _mgr->writeSampleAndRotateIfNeeded(
@@ -75,6 +75,16 @@ public:
      */
     void setPeriod(Milliseconds millis);
 
+    /**
+     * Set the period for collection by the high frequency collectors, zero disables them.
+     */
+    void setHighFrequencyPeriod(Milliseconds millis);
+
+    /**
+     * Set the block compression applied to metric chunks written from now on.
+     */
+    void setCompression(FTDCCompression compression);
+
     /**
      * Set the maximum directory size in bytes.
      */
@@ -111,6 +121,14 @@ public:
      */
     void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a metric collector to collect on the high frequency period, i.e., a few serverStatus
+     * sections.
+     *
+     * Its samples are compressed and stored separately from those of the periodic collectors.
+     */
+    void addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+
     /**
      * Add a collector to collect on server start, and file rotation. i.e. hostInfo
      *
@@ -200,6 +218,9 @@ private:
     // Set of periodic collectors
     FTDCCollectorCollection _periodicCollectors;
 
+    // Set of high frequency collectors
+    FTDCCollectorCollection _highFrequencyCollectors;
+
     // Last seen sample document from periodic collectors
     // Owned
     BSONObj _mostRecentPeriodicDocument;
@@ -339,6 +339,22 @@ Status FTDCFileManager::writeSampleAndRotateIfNeeded(Client* client,
     return Status::OK();
 }
 
+Status FTDCFileManager::writeHighFrequencySampleAndRotateIfNeeded(Client* client,
+                                                                  const BSONObj& sample,
+                                                                  Date_t date) {
+    Status s = _writer.writeHighFrequencySample(sample, date);
+
+    if (!s.isOK()) {
+        return s;
+    }
+
+    if (_writer.getSize() > _config->maxFileSizeBytes) {
+        return rotate(client);
+    }
+
+    return Status::OK();
+}
+
 Status FTDCFileManager::close() {
     return _writer.close();
 }
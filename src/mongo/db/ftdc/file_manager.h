@@ -85,6 +85,15 @@ public:
      */
     Status writeSampleAndRotateIfNeeded(Client* client, const BSONObj& sample, Date_t date);
 
+    /**
+     * Writes a sample of the high frequency collectors to disk via FTDCFileWriter.
+     *
+     * Rotates files as needed.
+     */
+    Status writeHighFrequencySampleAndRotateIfNeeded(Client* client,
+                                                     const BSONObj& sample,
+                                                     Date_t date);
+
     /**
      * Closes the current file manager down.
      */
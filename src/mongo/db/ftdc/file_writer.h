@@ -63,7 +63,8 @@ class FTDCFileWriter {
     FTDCFileWriter& operator=(const FTDCFileWriter&) = delete;
 
 public:
-    FTDCFileWriter(const FTDCConfig* config) : _config(config), _compressor(_config) {}
+    FTDCFileWriter(const FTDCConfig* config)
+        : _config(config), _compressor(_config), _highFrequencyCompressor(_config) {}
     ~FTDCFileWriter();
 
     /**
@@ -81,6 +82,14 @@ public:
      */
     Status writeSample(const BSONObj& sample, Date_t date);
 
+    /**
+     * Write a sample of the high frequency collectors to the archive log as needed.
+     *
+     * These samples are compressed separately from the ones passed to writeSample, their chunks are
+     * interleaved with the other chunks in the archive log but not written to the interim file.
+     */
+    Status writeHighFrequencySample(const BSONObj& sample, Date_t date);
+
     /**
      * Close all the files and shutdown cleanly by zeroing the beginning of the interim file.
      */
@@ -107,6 +116,11 @@ private:
      */
     Status flush(const boost::optional<ConstDataRange>&, Date_t date);
 
+    /**
+     * Write the pending high frequency samples to the archive log.
+     */
+    Status flushHighFrequency();
+
     /**
      * Write a buffer to the beginning of the interim file.
      */
@@ -136,6 +150,9 @@ private:
     // FTDC compressor
     FTDCCompressor _compressor;
 
+    // FTDC compressor for the samples of the high frequency collectors
+    FTDCCompressor _highFrequencyCompressor;
+
     // Size of archive file
     std::size_t _size{0};
 
@@ -268,6 +268,60 @@ TEST_F(FTDCFileTest, TestFull) {
     }
 }
 
+// Test that high frequency samples are stored as their own series next to the periodic samples
+TEST_F(FTDCFileTest, TestHighFrequencySamples) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path p(tempdir.path());
+    p /= kTestFile;
+
+    deleteFileIfNeeded(p);
+
+    FTDCConfig config;
+    config.maxSamplesPerArchiveMetricChunk = 8;
+    config.compression = FTDCCompression::kZstd;
+    FTDCFileWriter writer(&config);
+
+    ASSERT_OK(writer.open(p));
+
+    std::vector<BSONObj> periodicDocs;
+    std::vector<BSONObj> highFrequencyDocs;
+    for (int i = 0; i < 20; i++) {
+        periodicDocs.emplace_back(BSON("name"
+                                       << "joe"
+                                       << "key1" << i << "key2" << 45));
+        ASSERT_OK(writer.writeSample(periodicDocs.back(), Date_t()));
+
+        for (int j = 0; j < 10; j++) {
+            highFrequencyDocs.emplace_back(BSON("name"
+                                                << "jane"
+                                                << "key3" << (i * 10 + j)));
+            ASSERT_OK(writer.writeHighFrequencySample(highFrequencyDocs.back(), Date_t()));
+        }
+    }
+
+    ASSERT_OK(writer.close());
+
+    FTDCFileReader reader;
+    ASSERT_OK(reader.open(p));
+
+    std::vector<BSONObj> periodicDocsRead;
+    std::vector<BSONObj> highFrequencyDocsRead;
+    auto sw = reader.hasNext();
+    while (sw.isOK() && sw.getValue()) {
+        auto doc = std::get<1>(reader.next()).getOwned();
+        if (doc["name"].str() == "joe") {
+            periodicDocsRead.emplace_back(doc);
+        } else {
+            highFrequencyDocsRead.emplace_back(doc);
+        }
+        sw = reader.hasNext();
+    }
+    ASSERT_OK(sw);
+
+    ValidateDocumentList(periodicDocsRead, periodicDocs, FTDCValidationMode::kStrict);
+    ValidateDocumentList(highFrequencyDocsRead, highFrequencyDocs, FTDCValidationMode::kStrict);
+}
+
 // Test a large documents so that we cause multiple 4kb buffers to flush on Windows.
 TEST_F(FTDCFileTest, TestLargeDocuments) {
     FileTestTie c;
@@ -38,6 +38,7 @@
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
@@ -46,6 +47,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/mirror_maestro.h"
 #include "mongo/db/service_context.h"
+#include "mongo/util/str.h"
 #include "mongo/util/synchronized_value.h"
 
 namespace mongo {
@@ -68,6 +70,22 @@ FTDCController* getGlobalFTDCController() {
  */
 synchronized_value<boost::filesystem::path> ftdcDirectoryPathParameter;
 
+// The high frequency collectors are meant to sample a few metrics several times a second, the
+// periodic collectors cover longer periods.
+constexpr int kMinHighFrequencyPeriodMillis = 10;
+
+StatusWith<FTDCCompression> parseFTDCCompressor(StringData value) {
+    if (value == "zlib"_sd) {
+        return FTDCCompression::kZlib;
+    }
+    if (value == "zstd"_sd) {
+        return FTDCCompression::kZstd;
+    }
+    return Status(ErrorCodes::BadValue,
+                  str::stream() << "Unsupported diagnosticDataCollectionCompressor '" << value
+                                << "', must be either 'zlib' or 'zstd'");
+}
+
 }  // namespace
 
 FTDCStartupParams ftdcStartupParams;
@@ -116,6 +134,44 @@ Status onUpdateFTDCPeriod(const std::int32_t potentialNewValue) {
     return Status::OK();
 }
 
+Status validateFTDCHighFrequencyPeriod(const std::int32_t& value) {
+    if (value != 0 && value < kMinHighFrequencyPeriodMillis) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "diagnosticDataCollectionHighFrequencyPeriodMillis must be "
+                                       "either 0 or greater than or equal to "
+                                    << kMinHighFrequencyPeriodMillis);
+    }
+
+    return Status::OK();
+}
+
+Status onUpdateFTDCHighFrequencyPeriod(const std::int32_t potentialNewValue) {
+    auto controller = getGlobalFTDCController();
+    if (controller) {
+        controller->setHighFrequencyPeriod(Milliseconds(potentialNewValue));
+    }
+
+    return Status::OK();
+}
+
+Status validateFTDCCompressor(const std::string& value) {
+    return parseFTDCCompressor(value).getStatus();
+}
+
+Status onUpdateFTDCCompressor(const std::string& value) {
+    auto swCompression = parseFTDCCompressor(value);
+    if (!swCompression.isOK()) {
+        return swCompression.getStatus();
+    }
+
+    auto controller = getGlobalFTDCController();
+    if (controller) {
+        controller->setCompression(swCompression.getValue());
+    }
+
+    return Status::OK();
+}
+
 Status onUpdateFTDCDirectorySize(const std::int32_t potentialNewValue) {
     if (potentialNewValue < ftdcStartupParams.maxFileSizeMB.load()) {
         return Status(
@@ -208,6 +264,8 @@ public:
         // of active migrations.
         // "timing" is filtered out because it triggers frequent schema changes.
         // "defaultRWConcern" is excluded because it changes rarely and instead included in rotation
+        // "lockContention.topContendedResources" is filtered out because it lists namespaces which
+        // vary as contention shifts; the wait histograms of that section are still collected.
         // "mirroredReads" is included to append the number of mirror-able operations observed and
         // mirrored by this process in FTDC collections.
 
@@ -217,6 +275,7 @@ public:
         commandBuilder.append("timing", false);
         commandBuilder.append("defaultRWConcern", false);
         commandBuilder.append(MirrorMaestro::kServerStatusSectionName, true);
+        commandBuilder.append("lockContention", BSON("topContendedResources" << false));
 
         if (gDiagnosticDataCollectionEnableLatencyHistograms.load()) {
             BSONObjBuilder subObjBuilder(commandBuilder.subobjStart("opLatencies"));
@@ -240,6 +299,45 @@ public:
     }
 };
 
+/**
+ * A FTDC Collector for the serverStatus sections listed in
+ * diagnosticDataCollectionHighFrequencySections.
+ *
+ * Generates just those sections rather than running the serverStatus command, which builds every
+ * section, so that they can be sampled several times a second.
+ */
+class FTDCServerStatusSectionsCollector : public FTDCCollectorInterface {
+private:
+    constexpr static StringData kName = "serverStatusHighFrequency"_sd;
+
+public:
+    FTDCServerStatusSectionsCollector()
+        : _config(BSON("lockContention" << BSON("topContendedResources" << false))) {}
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        auto sections = gDiagnosticDataCollectionHighFrequencySections.get();
+        if (sections != _sections) {
+            _sectionNames.clear();
+            str::splitStringDelim(sections, &_sectionNames, ',');
+            _sections = std::move(sections);
+        }
+
+        appendServerStatusSections(opCtx, _sectionNames, _config, &builder);
+    }
+
+    std::string name() const final {
+        return kName.toString();
+    }
+
+private:
+    // Same settings for the sections as FTDCServerStatusCommandCollector uses
+    const BSONObj _config;
+
+    // Last seen value of diagnosticDataCollectionHighFrequencySections, and its parsed form
+    std::string _sections;
+    std::vector<std::string> _sectionNames;
+};
+
 // Register the FTDC system
 // Note: This must be run before the server parameters are parsed during startup
 // so that the FTDCController is initialized.
@@ -249,6 +347,9 @@ void startFTDC(boost::filesystem::path& path,
                RegisterCollectorsFunction registerCollectors) {
     FTDCConfig config;
     config.period = Milliseconds(ftdcStartupParams.periodMillis.load());
+    config.highFrequencyPeriod = Milliseconds(ftdcStartupParams.highFrequencyPeriodMillis.load());
+    config.compression =
+        uassertStatusOK(parseFTDCCompressor(gDiagnosticDataCollectionCompressor.get()));
     // Only enable FTDC if our caller says to enable FTDC, MongoS may not have a valid path to write
     // files to so update the diagnosticDataCollectionEnabled set parameter to reflect that.
     ftdcStartupParams.enabled.store(startupMode == FTDCStartMode::kStart &&
@@ -271,6 +372,10 @@ void startFTDC(boost::filesystem::path& path,
     // GetDiagnosticDataCommand
     controller->addPeriodicCollector(std::make_unique<FTDCServerStatusCommandCollector>());
 
+    // Install the high frequency collector
+    // This is collected on the high frequency period interval in FTDCConfig.
+    controller->addHighFrequencyCollector(std::make_unique<FTDCServerStatusSectionsCollector>());
+
     registerCollectors(controller.get());
 
     // Install System Metric Collector as a periodic collector
@@ -177,10 +177,21 @@ void FTSSpec::scoreDocument(const BSONObj& obj, TermFrequencyMap* term_freqs) co
 
     FTSElementIterator it(*this, obj);
 
+    // Text fields of a document are usually in the same language. Creating a tokenizer sets up a
+    // stemmer, so each language's tokenizer is created once and reused for all of its fields.
+    std::vector<std::pair<const FTSLanguage*, std::unique_ptr<FTSTokenizer>>> tokenizers;
+
     while (it.more()) {
         FTSIteratorValue val = it.next();
-        std::unique_ptr<FTSTokenizer> tokenizer(val._language->createTokenizer());
-        _scoreStringV2(tokenizer.get(), val._text, term_freqs, val._weight);
+        auto tokenizerIt =
+            std::find_if(tokenizers.begin(), tokenizers.end(), [&](const auto& entry) {
+                return entry.first == val._language;
+            });
+        if (tokenizerIt == tokenizers.end()) {
+            tokenizerIt = tokenizers.emplace(
+                tokenizers.end(), val._language, val._language->createTokenizer());
+        }
+        _scoreStringV2(tokenizerIt->second.get(), val._text, term_freqs, val._weight);
     }
 }
 
@@ -53,6 +53,10 @@ StringData Stemmer::stem(StringData word) const {
     if (!_stemmer)
         return word;
 
+    if (auto it = _stemCache.find(word); it != _stemCache.end()) {
+        return it->second;
+    }
+
     const sb_symbol* sb_sym =
         sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
 
@@ -61,7 +65,12 @@ StringData Stemmer::stem(StringData word) const {
         MONGO_UNREACHABLE;
     }
 
-    return StringData((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    if (_stemCache.size() >= kMaxCachedStems) {
+        _stemCache.clear();
+    }
+    return _stemCache
+        .try_emplace(word, (const char*)(sb_sym), static_cast<size_t>(sb_stemmer_length(_stemmer)))
+        .first->second;
 }
 }  // namespace fts
 }  // namespace mongo
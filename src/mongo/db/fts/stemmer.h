@@ -30,8 +30,11 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
+#include "mongo/util/string_map.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
 
 namespace mongo {
@@ -61,7 +64,14 @@ public:
     StringData stem(StringData word) const;
 
 private:
+    // Upper bound on the number of remembered stems; the cache is cleared when it is reached.
+    static constexpr size_t kMaxCachedStems = 1024;
+
     struct sb_stemmer* _stemmer;
+
+    // Text repeats words, and running the Snowball algorithm over a word costs much more than a
+    // hash lookup, so the stems computed by this object are remembered.
+    mutable StringMap<std::string> _stemCache;
 };
 }  // namespace fts
 }  // namespace mongo
@@ -56,5 +56,15 @@ TEST(English, Caps) {
     ASSERT_EQUALS("unit", s.stem("united"));
     ASSERT_EQUALS("Unite", s.stem("United"));
 }
+TEST(English, RepeatedStemsAreConsistent) {
+    Stemmer s(languageEnglishV2());
+    for (int i = 0; i < 3000; ++i) {
+        ASSERT_EQUALS("run", s.stem("running"));
+        ASSERT_EQUALS("Run", s.stem("Running"));
+        const std::string word = "word" + std::to_string(i) + "ing";
+        ASSERT_EQUALS("word" + std::to_string(i), s.stem(word));
+    }
+}
+
 }  // namespace fts
 }  // namespace mongo
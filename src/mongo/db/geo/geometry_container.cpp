@@ -33,6 +33,7 @@
 #include "mongo/db/geo/geoparser.h"
 #include "mongo/util/str.h"
 #include "mongo/util/transitional_tools_do_not_use/vector_spooling.h"
+#include "third_party/s2/s2regioncoverer.h"
 
 namespace mongo {
 
@@ -372,8 +373,32 @@ bool containsPoint(const S2Polygon& poly, const S2Cell& otherCell, const S2Point
     return poly.MayIntersect(otherCell);
 }
 
+namespace {
+// Polygons with fewer vertices than this are cheap enough to test exactly.
+const int kMinVerticesForInteriorCovering = 64;
+// Upper bound on the size of the interior covering, to keep computing and probing it cheap.
+const int kMaxInteriorCoveringCells = 128;
+}  // namespace
+
+void GeometryContainer::computeInteriorCovering() {
+    if (nullptr == _polygon || nullptr == _polygon->s2Polygon ||
+        _polygon->s2Polygon->num_vertices() < kMinVerticesForInteriorCovering) {
+        return;
+    }
+
+    S2RegionCoverer coverer;
+    coverer.set_max_cells(kMaxInteriorCoveringCells);
+    _interiorCovering = std::make_unique<S2CellUnion>();
+    coverer.GetInteriorCellUnion(*_polygon->s2Polygon, _interiorCovering.get());
+}
+
 bool GeometryContainer::contains(const S2Cell& otherCell, const S2Point& otherPoint) const {
     if (nullptr != _polygon && (nullptr != _polygon->s2Polygon)) {
+        // A point in a cell that lies entirely inside the polygon is contained by it. Only points
+        // outside of the interior covering, close to the polygon's edges, need an exact test.
+        if (_interiorCovering && _interiorCovering->Contains(otherCell.id())) {
+            return true;
+        }
         return containsPoint(*_polygon->s2Polygon, otherCell, otherPoint);
     }
 
@@ -32,6 +32,7 @@
 #include <string>
 
 #include "mongo/db/geo/shapes.h"
+#include "third_party/s2/s2cellunion.h"
 #include "third_party/s2/s2regionunion.h"
 
 namespace mongo {
@@ -102,6 +103,14 @@ public:
      */
     bool contains(const GeometryContainer& otherContainer) const;
 
+    /**
+     * Precomputes cells lying entirely inside this geometry, if it is a spherical polygon with
+     * enough vertices for exact point containment tests to be expensive. contains() then accepts
+     * points inside those cells without an exact test. Meant for query geometries which are
+     * matched against many documents; the geometry must not be modified afterwards.
+     */
+    void computeInteriorCovering();
+
     /**
      * To check intersection, we iterate over the otherContainer's geometries, checking each
      * geometry to see if we intersect it.  If we intersect one geometry, we intersect the
@@ -161,6 +170,9 @@ private:
     // TODO: _s2Region is currently generated immediately - don't necessarily need to do this
     std::unique_ptr<S2RegionUnion> _s2Region;
     std::unique_ptr<R2Region> _r2Region;
+
+    // Cells entirely contained by '_polygon', if computeInteriorCovering() built them.
+    std::unique_ptr<S2CellUnion> _interiorCovering;
 };
 
 }  // namespace mongo
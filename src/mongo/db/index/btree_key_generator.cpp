@@ -29,6 +29,7 @@
 
 #include "mongo/db/index/btree_key_generator.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <memory>
 
@@ -502,24 +503,55 @@ void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*>* fieldNames,
                 arrObj, subPositionalInfo[i].remainingPath);
         }
 
-        // Generate a key for each element of the indexed array.
-        std::vector<const char*> fieldNamesTemp;
-        std::vector<BSONElement> fixedTemp;
-        for (const auto arrObjElem : arrObj) {
-            _getKeysArrEltFixed(*fieldNames,
-                                *fixed,
-                                &fieldNamesTemp,
-                                &fixedTemp,
-                                pooledBufferBuilder,
-                                arrObjElem,
-                                keys,
-                                numNotFound,
-                                arrElt,
-                                arrIdxs,
-                                mayExpandArrayUnembedded,
-                                subPositionalInfo,
-                                multikeyPaths,
-                                id);
+        const bool allPathsEndAtArray =
+            std::all_of(fieldNames->begin(), fieldNames->end(), [](const char* fieldName) {
+                return *fieldName == '\0';
+            });
+        if (allPathsEndAtArray) {
+            // Every indexed field ends at 'arrElt', so each of its elements produces exactly one
+            // key and there is nothing left to traverse. Build the keys here rather than recursing
+            // once per element, which copies the traversal state for every element of the array.
+            std::vector<BSONElement> fixedTemp(*fixed);
+            for (const auto arrObjElem : arrObj) {
+                for (const auto idx : arrIdxs) {
+                    fixedTemp[idx] = mayExpandArrayUnembedded ? arrObjElem : arrElt;
+                }
+                KeyString::PooledBuilder keyString(
+                    pooledBufferBuilder, _keyStringVersion, _ordering);
+                for (const auto& elem : fixedTemp) {
+                    if (_collator) {
+                        keyString.appendBSONElement(elem, [&](StringData stringData) {
+                            return _collator->getComparisonString(stringData);
+                        });
+                    } else {
+                        keyString.appendBSONElement(elem);
+                    }
+                }
+                if (id) {
+                    keyString.appendRecordId(*id);
+                }
+                keys->push_back(keyString.release());
+            }
+        } else {
+            // Generate a key for each element of the indexed array.
+            std::vector<const char*> fieldNamesTemp;
+            std::vector<BSONElement> fixedTemp;
+            for (const auto arrObjElem : arrObj) {
+                _getKeysArrEltFixed(*fieldNames,
+                                    *fixed,
+                                    &fieldNamesTemp,
+                                    &fixedTemp,
+                                    pooledBufferBuilder,
+                                    arrObjElem,
+                                    keys,
+                                    numNotFound,
+                                    arrElt,
+                                    arrIdxs,
+                                    mayExpandArrayUnembedded,
+                                    subPositionalInfo,
+                                    multikeyPaths,
+                                    id);
+            }
         }
     }
 
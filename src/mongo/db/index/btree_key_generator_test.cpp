@@ -265,6 +265,19 @@ TEST(BtreeKeyGeneratorTest, GetKeysFromArrayFirstElement) {
     ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysFromArrayWithNestedArraysCompound) {
+    BSONObj keyPattern = fromjson("{a: 1, b: 1}");
+    BSONObj genKeysFrom = fromjson("{a: [1, [2, 3], 1], b: 4}");
+    KeyString::HeapBuilder keyString1(
+        KeyString::Version::kLatestVersion, fromjson("{'': 1, '': 4}"), Ordering::make(BSONObj()));
+    KeyString::HeapBuilder keyString2(KeyString::Version::kLatestVersion,
+                                      fromjson("{'': [2, 3], '': 4}"),
+                                      Ordering::make(BSONObj()));
+    KeyStringSet expectedKeys{keyString1.release(), keyString2.release()};
+    MultikeyPaths expectedMultikeyPaths{{0U}, MultikeyComponents{}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
 TEST(BtreeKeyGeneratorTest, GetKeysFromArraySecondElement) {
     BSONObj keyPattern = fromjson("{first: 1, a: 1}");
     BSONObj genKeysFrom = fromjson("{first: 5, a: [1, 2, 3]}");
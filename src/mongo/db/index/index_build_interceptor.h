@@ -158,6 +158,15 @@ public:
      */
     bool areAllWritesApplied(OperationContext* opCtx) const;
 
+    /**
+     * Returns the number of writes recorded in the side writes table which have not been applied
+     * yet. This includes writes whose transactions have not committed, so it is an estimate of the
+     * work left for the next drain.
+     */
+    long long getNumPendingSideWrites() const {
+        return _sideWritesCounter->load() - _numApplied;
+    }
+
     /**
      * When an index builder wants to commit, use this to retrieve any recorded multikey paths
      * that were tracked during the build.
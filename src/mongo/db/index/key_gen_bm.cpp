@@ -165,6 +165,69 @@ void BM_KeyGenArrayOfArray(benchmark::State& state, int32_t elements) {
     }
 }
 
+void BM_KeyGenArrayCompound(benchmark::State& state, int32_t elements) {
+    std::mt19937 gen(numGen());
+
+    BSONObjBuilder builder;
+    BSONArrayBuilder arrBuilder(builder.subarrayStart(kFieldName));
+    for (int32_t i = 0; i < elements; ++i) {
+        arrBuilder.append(static_cast<int32_t>(gen()));
+    }
+    arrBuilder.done();
+    builder.append("b", "compound");
+    BSONObj obj = builder.obj();
+
+    BtreeKeyGenerator generator({kFieldName, "b"},
+                                {BSONElement{}, BSONElement{}},
+                                false,
+                                nullptr,
+                                KeyString::Version::kLatestVersion,
+                                Ordering::make(BSON(kFieldName << 1 << "b" << 1)));
+
+    SharedBufferFragmentBuilder allocator(kMemBlockSize,
+                                          SharedBufferFragmentBuilder::ConstantGrowStrategy());
+    KeyStringSet keys;
+    MultikeyPaths multikeyPaths;
+
+    for (auto _ : state) {
+        generator.getKeys(allocator, obj, false, &keys, &multikeyPaths);
+        benchmark::ClobberMemory();
+        keys.clear();
+        multikeyPaths.clear();
+    }
+}
+
+void BM_KeyGenArrayOfObjects(benchmark::State& state, int32_t elements) {
+    std::mt19937 gen(numGen());
+
+    BSONObjBuilder builder;
+    BSONArrayBuilder arrBuilder(builder.subarrayStart(kFieldName));
+    for (int32_t i = 0; i < elements; ++i) {
+        arrBuilder.append(BSON("b" << static_cast<int32_t>(gen())));
+    }
+    arrBuilder.done();
+    BSONObj obj = builder.obj();
+
+    BtreeKeyGenerator generator({"a.b"},
+                                {BSONElement{}},
+                                false,
+                                nullptr,
+                                KeyString::Version::kLatestVersion,
+                                makeOrdering("a.b"));
+
+    SharedBufferFragmentBuilder allocator(kMemBlockSize,
+                                          SharedBufferFragmentBuilder::ConstantGrowStrategy());
+    KeyStringSet keys;
+    MultikeyPaths multikeyPaths;
+
+    for (auto _ : state) {
+        generator.getKeys(allocator, obj, false, &keys, &multikeyPaths);
+        benchmark::ClobberMemory();
+        keys.clear();
+        multikeyPaths.clear();
+    }
+}
+
 BENCHMARK_CAPTURE(BM_KeyGenBasic, Generic, false);
 BENCHMARK_CAPTURE(BM_KeyGenBasic, SkipMultikey, true);
 
@@ -180,5 +243,13 @@ BENCHMARK_CAPTURE(BM_KeyGenArrayOfArray, 10x10, 10);
 BENCHMARK_CAPTURE(BM_KeyGenArrayOfArray, 100x100, 100);
 BENCHMARK_CAPTURE(BM_KeyGenArrayOfArray, 1Kx1K, 1000);
 
+BENCHMARK_CAPTURE(BM_KeyGenArrayCompound, 1K, 1000);
+BENCHMARK_CAPTURE(BM_KeyGenArrayCompound, 10K, 10000);
+BENCHMARK_CAPTURE(BM_KeyGenArrayCompound, 100K, 100000);
+
+BENCHMARK_CAPTURE(BM_KeyGenArrayOfObjects, 1K, 1000);
+BENCHMARK_CAPTURE(BM_KeyGenArrayOfObjects, 10K, 10000);
+BENCHMARK_CAPTURE(BM_KeyGenArrayOfObjects, 100K, 100000);
+
 }  // namespace
 }  // namespace mongo
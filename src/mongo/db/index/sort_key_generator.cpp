@@ -39,6 +39,10 @@ namespace mongo {
 
 SortKeyGenerator::SortKeyGenerator(SortPattern sortPattern, const CollatorInterface* collator)
     : _collator(collator), _sortPattern(std::move(sortPattern)) {
+    if (_collator) {
+        _collationKeyCache = std::make_unique<CollationKeyCache>(_collator);
+    }
+
     BSONObjBuilder btreeBob;
     size_t nFields = 0;
 
@@ -198,10 +202,10 @@ Value SortKeyGenerator::getCollationComparisonKey(const Value& val) const {
         return val;
     }
 
-    // If 'val' is a string, directly use the collator to obtain a comparison key.
+    // If 'val' is a string, directly use the collator to obtain a comparison key. Sort keys often
+    // repeat, so the keys of recent strings are cached.
     if (val.getType() == BSONType::String) {
-        auto compKey = _collator->getComparisonKey(val.getString());
-        return Value(compKey.getKeyData());
+        return Value(_collationKeyCache->getComparisonKey(val.getStringData()));
     }
 
     // Otherwise, for non-string collatable types, take the slow path and round-trip the value
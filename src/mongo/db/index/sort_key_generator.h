@@ -33,6 +33,7 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/index/btree_key_generator.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/collation/collation_key_cache.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/sort_pattern.h"
 
@@ -133,6 +134,10 @@ private:
 
     const CollatorInterface* _collator = nullptr;
 
+    // Comparison keys of recently seen strings, only set if '_collator' is. Used from const methods
+    // since caching does not change the keys generated.
+    std::unique_ptr<CollationKeyCache> _collationKeyCache;
+
     SortPattern _sortPattern;
 
     // The sort pattern with any $meta sort components stripped out, since the underlying index key
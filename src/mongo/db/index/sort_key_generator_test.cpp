@@ -104,6 +104,18 @@ TEST(SortKeyGeneratorTest, ExtractStringSortKeyWithCollatorUsesComparisonKey) {
     ASSERT_VALUE_EQ(sortKey, Value{"2gniht"_sd});
 }
 
+TEST(SortKeyGeneratorTest, RepeatedStringSortKeysWithCollatorUseComparisonKeys) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    auto sortKeyGen = makeSortKeyGen(BSON("a" << 1 << "b" << 1), &collator);
+    for (int i = 0; i < 3; ++i) {
+        auto sortKey = sortKeyGen->computeSortKeyFromDocument(
+            Document{{"a", {"thing1"_sd}}, {"b", {i % 2 ? "thing2"_sd : "thing3"_sd}}});
+        ASSERT_VALUE_EQ(sortKey,
+                        Value(std::vector<Value>{Value("1gniht"_sd),
+                                                 Value(i % 2 ? "2gniht"_sd : "3gniht"_sd)}));
+    }
+}
+
 TEST(SortKeyGeneratorTest, CollatorHasNoEffectWhenExtractingNonStringSortKey) {
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     auto sortKeyGen = makeSortKeyGen(BSON("a" << 1), &collator);
@@ -58,6 +58,7 @@
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/durable_catalog.h"
+#include "mongo/db/storage/two_phase_index_build_knobs_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/assert_util.h"
@@ -2408,17 +2409,36 @@ void IndexBuildsCoordinator::_scanCollectionAndInsertKeysIntoSorter(
  */
 void IndexBuildsCoordinator::_insertKeysFromSideTablesWithoutBlockingWrites(
     OperationContext* opCtx, std::shared_ptr<ReplIndexBuildState> replState) {
-    // Perform the first drain while holding an intent lock.
+    // Perform the first drain while holding an intent lock. On a collection with a high write
+    // rate, keep draining for as long as each round shrinks the backlog, so that the drains which
+    // block writes only have to apply the few writes that arrive after the last round.
     const NamespaceStringOrUUID dbAndUUID(replState->dbName, replState->collectionUUID);
-    {
-        Lock::DBLock autoDb(opCtx, replState->dbName, MODE_IX);
-        Lock::CollectionLock collLock(opCtx, dbAndUUID, MODE_IX);
+    const auto maxPendingBeforeBlocking = maxIndexBuildDrainSideWritesBeforeBlocking.load();
+    auto numPending = std::numeric_limits<long long>::max();
+    for (int round = 1;; ++round) {
+        {
+            Lock::DBLock autoDb(opCtx, replState->dbName, MODE_IX);
+            Lock::CollectionLock collLock(opCtx, dbAndUUID, MODE_IX);
 
-        uassertStatusOK(_indexBuildsManager.drainBackgroundWrites(
-            opCtx,
-            replState->buildUUID,
-            RecoveryUnit::ReadSource::kUnset,
-            IndexBuildInterceptor::DrainYieldPolicy::kYield));
+            uassertStatusOK(_indexBuildsManager.drainBackgroundWrites(
+                opCtx,
+                replState->buildUUID,
+                RecoveryUnit::ReadSource::kUnset,
+                IndexBuildInterceptor::DrainYieldPolicy::kYield));
+        }
+
+        const auto previousNumPending = numPending;
+        numPending = _indexBuildsManager.getNumPendingSideWrites(replState->buildUUID);
+        if (maxPendingBeforeBlocking == 0 || numPending <= maxPendingBeforeBlocking ||
+            numPending >= previousNumPending) {
+            break;
+        }
+
+        LOGV2(4798100,
+              "Index build: draining side writes again before blocking writes",
+              "buildUUID"_attr = replState->buildUUID,
+              "round"_attr = round,
+              "pendingSideWrites"_attr = numPending);
     }
 
     if (MONGO_unlikely(hangAfterIndexBuildFirstDrain.shouldFail())) {
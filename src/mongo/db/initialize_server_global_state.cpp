@@ -383,6 +383,11 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
     }
 
     lv2Config.timestampFormat = serverGlobalParams.logTimestampFormat;
+    lv2Config.asyncEnabled = gAsyncLogging;
+    lv2Config.asyncBufferSize = gAsyncLoggingBufferSize;
+    lv2Config.asyncOverflowPolicy = gAsyncLoggingDropOnOverflow
+        ? logv2::LogDomainGlobal::ConfigurationOptions::OverflowPolicy::kDrop
+        : logv2::LogDomainGlobal::ConfigurationOptions::OverflowPolicy::kBlock;
     Status result = lv2Manager.getGlobalDomainInternal().configure(lv2Config);
     if (result.isOK() && writeServerRestartedAfterLogConfig)
         LOGV2_WARNING_OPTIONS(
@@ -245,6 +245,7 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         // Clear the refresh-related stats with the beginning of our run.
         _stats.setLastSessionsCollectionJobDurationMillis(0);
         _stats.setLastSessionsCollectionJobEntriesRefreshed(0);
+        _stats.setLastSessionsCollectionJobEntriesSkipped(0);
         _stats.setLastSessionsCollectionJobEntriesEnded(0);
         _stats.setLastSessionsCollectionJobCursorsClosed(0);
 
@@ -320,17 +321,60 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         activeSessionRecords.insert(it.second);
     }
 
+    // Skip the sessions, whose records were written recently enough that they will not expire
+    // before a later refresh gets to write them again.
+    const auto refreshTime = _service->now();
+    const auto minRecordRefreshInterval = _getMinRecordRefreshInterval();
+    size_t numSkipped = 0;
+    {
+        stdx::lock_guard<Latch> lk(_lastRefreshedMutex);
+        if (minRecordRefreshInterval > Milliseconds(0)) {
+            for (auto it = activeSessionRecords.begin(); it != activeSessionRecords.end();) {
+                const auto lastRefreshedIt = _lastRefreshed.find(it->getId());
+                if (lastRefreshedIt != _lastRefreshed.end() &&
+                    refreshTime - lastRefreshedIt->second < minRecordRefreshInterval) {
+                    activeSessionRecords.erase(it++);
+                    ++numSkipped;
+                } else {
+                    ++it;
+                }
+            }
+        } else {
+            _lastRefreshed.clear();
+        }
+    }
+
     // Refresh the active sessions in the sessions collection.
-    _sessionsColl->refreshSessions(opCtx, activeSessionRecords);
+    _refreshSessions(opCtx, activeSessionRecords);
     activeSessionsBackSwapper.dismiss();
+    if (minRecordRefreshInterval > Milliseconds(0)) {
+        stdx::lock_guard<Latch> lk(_lastRefreshedMutex);
+        for (auto it = _lastRefreshed.begin(); it != _lastRefreshed.end();) {
+            if (refreshTime - it->second >= minRecordRefreshInterval) {
+                _lastRefreshed.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+        for (const auto& record : activeSessionRecords) {
+            _lastRefreshed[record.getId()] = refreshTime;
+        }
+    }
     {
         stdx::lock_guard<Latch> lk(_mutex);
         _stats.setLastSessionsCollectionJobEntriesRefreshed(activeSessionRecords.size());
+        _stats.setLastSessionsCollectionJobEntriesSkipped(numSkipped);
     }
 
     // Remove the ending sessions from the sessions collection.
     _sessionsColl->removeRecords(opCtx, explicitlyEndingSessions);
     explicitlyEndingBackSwaper.dismiss();
+    {
+        stdx::lock_guard<Latch> lk(_lastRefreshedMutex);
+        for (const auto& lsid : explicitlyEndingSessions) {
+            _lastRefreshed.erase(lsid);
+        }
+    }
     {
         stdx::lock_guard<Latch> lk(_mutex);
         _stats.setLastSessionsCollectionJobEntriesEnded(explicitlyEndingSessions.size());
@@ -390,6 +434,42 @@ LogicalSessionCacheStats LogicalSessionCacheImpl::getStats() {
     return _stats;
 }
 
+Milliseconds LogicalSessionCacheImpl::_getMinRecordRefreshInterval() const {
+    // Leave a margin of two refresh intervals before the record expires, one for the refresh
+    // that skips it last and one for a refresh that fails
+    const Milliseconds maxInterval = Minutes(localLogicalSessionTimeoutMinutes) -
+        2 * Milliseconds(logicalSessionRefreshMillis);
+    return std::max(
+        Milliseconds(0),
+        std::min(Milliseconds(logicalSessionRefreshMinRecordIntervalMillis.load()), maxInterval));
+}
+
+void LogicalSessionCacheImpl::_refreshSessions(OperationContext* opCtx,
+                                               const LogicalSessionRecordSet& records) {
+    const auto maxRecordsPerSecond = size_t(logicalSessionRefreshMaxRecordsPerSecond.load());
+    if (!maxRecordsPerSecond || records.size() <= maxRecordsPerSecond) {
+        _sessionsColl->refreshSessions(opCtx, records);
+        return;
+    }
+
+    LogicalSessionRecordSet batch;
+    auto it = records.begin();
+    while (it != records.end()) {
+        const auto batchStart = _service->now();
+
+        batch.clear();
+        for (; it != records.end() && batch.size() < maxRecordsPerSecond; ++it) {
+            batch.insert(*it);
+        }
+        _sessionsColl->refreshSessions(opCtx, batch);
+
+        const auto elapsed = _service->now() - batchStart;
+        if (it != records.end() && elapsed < Seconds(1)) {
+            opCtx->sleepFor(Seconds(1) - elapsed);
+        }
+    }
+}
+
 Status LogicalSessionCacheImpl::_addToCacheIfNotFull(WithLock, LogicalSessionRecord record) {
     if (_activeSessions.size() >= size_t(maxSessions)) {
         Status status = {ErrorCodes::TooManyLogicalSessions,
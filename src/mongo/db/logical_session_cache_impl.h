@@ -51,6 +51,14 @@ namespace mongo {
  *    every 5 minutes (300,000). If the caller is setting the sessionTimeout by hand, it is
  *    suggested that they consider also setting the refresh interval accordingly.
  *      --setParameter logicalSessionRefreshMillis=X.
+ *
+ *  - The minimum interval between two writes of the record of a session, which stays in use. By
+ *    default every session used since the previous refresh is written by the next one.
+ *      --setParameter logicalSessionRefreshMinRecordIntervalMillis=X
+ *
+ *  - The maximum number of session records written per second by a refresh. By default, the
+ *    rate of the refresh writes is not limited.
+ *      --setParameter logicalSessionRefreshMaxRecordsPerSecond=X
  */
 class LogicalSessionCacheImpl final : public LogicalSessionCache {
 public:
@@ -103,6 +111,19 @@ private:
 
     Status _addToCacheIfNotFull(WithLock, LogicalSessionRecord record);
 
+    /**
+     * Returns the interval for which the records written by a refresh may be skipped by the
+     * subsequent ones. It is capped so that the skipped records are still rewritten at least one
+     * refresh interval before they would expire from the sessions collection.
+     */
+    Milliseconds _getMinRecordRefreshInterval() const;
+
+    /**
+     * Writes 'records' to the sessions collection, spreading the writes over multiple seconds if
+     * logicalSessionRefreshMaxRecordsPerSecond is set.
+     */
+    void _refreshSessions(OperationContext* opCtx, const LogicalSessionRecordSet& records);
+
     const std::unique_ptr<ServiceLiaison> _service;
     const std::shared_ptr<SessionsCollection> _sessionsColl;
     const ReapSessionsOlderThanFn _reapSessionsOlderThanFn;
@@ -117,6 +138,16 @@ private:
     Date_t _lastRefreshTime;
 
     LogicalSessionCacheStats _stats;
+
+    // Protects the state below. It is only used by the refreshes and is never acquired together
+    // with '_mutex'.
+    Mutex _lastRefreshedMutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0),
+                                                 "LogicalSessionCacheImpl::_lastRefreshedMutex");
+
+    // The time at which a refresh last wrote the record of each session, for the sessions which
+    // may be skipped by the next refresh. Any entries older than the minimum record refresh
+    // interval are pruned after each refresh.
+    LogicalSessionIdMap<Date_t> _lastRefreshed;
 };
 
 }  // namespace mongo
@@ -50,6 +50,7 @@
 #include "mongo/stdx/future.h"
 #include "mongo/unittest/ensure_fcv.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -216,6 +217,59 @@ TEST_F(LogicalSessionCacheTest, ManySignedLsidsInCacheRefresh) {
     ASSERT_OK(cache()->refreshNow(opCtx()));
 }
 
+// Test that sessions refreshed within the minimum record refresh interval are not written again
+TEST_F(LogicalSessionCacheTest, RefreshSkipsRecentlyRefreshedSessions) {
+    logicalSessionRefreshMinRecordIntervalMillis.store(2 * kForceRefresh.count());
+    ON_BLOCK_EXIT([] { logicalSessionRefreshMinRecordIntervalMillis.store(0); });
+
+    const auto lsid = makeLogicalSessionIdForTest();
+    ASSERT_OK(cache()->startSession(opCtx(), makeLogicalSessionRecord(lsid, service()->now())));
+
+    size_t numRefreshed = 0;
+    sessions()->setRefreshHook([&numRefreshed](const LogicalSessionRecordSet& sessions) {
+        numRefreshed += sessions.size();
+    });
+
+    // The first refresh writes the session record
+    ASSERT_OK(cache()->refreshNow(opCtx()));
+    ASSERT_EQ(1U, numRefreshed);
+
+    // The session is used again, but its record was written too recently to need a refresh
+    service()->fastForward(kForceRefresh);
+    ASSERT_OK(cache()->vivify(opCtx(), lsid));
+    ASSERT_OK(cache()->refreshNow(opCtx()));
+    ASSERT_EQ(1U, numRefreshed);
+    ASSERT_EQ(1, cache()->getStats().getLastSessionsCollectionJobEntriesSkipped());
+
+    // Once the interval has elapsed, the record is written again
+    service()->fastForward(kForceRefresh);
+    ASSERT_OK(cache()->vivify(opCtx(), lsid));
+    ASSERT_OK(cache()->refreshNow(opCtx()));
+    ASSERT_EQ(2U, numRefreshed);
+    ASSERT_EQ(0, cache()->getStats().getLastSessionsCollectionJobEntriesSkipped());
+}
+
+// Test that a refresh spreads its writes when the number of records per second is limited
+TEST_F(LogicalSessionCacheTest, RefreshIsRateLimited) {
+    logicalSessionRefreshMaxRecordsPerSecond.store(3);
+    ON_BLOCK_EXIT([] { logicalSessionRefreshMaxRecordsPerSecond.store(0); });
+
+    for (int i = 0; i < 5; i++) {
+        ASSERT_OK(cache()->startSession(opCtx(), makeLogicalSessionRecordForTest()));
+    }
+
+    std::vector<size_t> batchSizes;
+    sessions()->setRefreshHook([&batchSizes](const LogicalSessionRecordSet& sessions) {
+        batchSizes.push_back(sessions.size());
+    });
+
+    ASSERT_OK(cache()->refreshNow(opCtx()));
+    ASSERT_EQ(2U, batchSizes.size());
+    ASSERT_EQ(3U, batchSizes[0]);
+    ASSERT_EQ(2U, batchSizes[1]);
+    ASSERT_EQ(5, cache()->getStats().getLastSessionsCollectionJobEntriesRefreshed());
+}
+
 //
 TEST_F(LogicalSessionCacheTest, RefreshMatrixSessionState) {
     const std::vector<std::vector<std::string>> stateNames = {
@@ -141,6 +141,11 @@ Status GeoExpression::parseFrom(const BSONObj& obj) {
         geoContainer->projectInto(SPHERE);
     }
 
+    // A $within geometry is tested for containment of every candidate document.
+    if (GeoExpression::WITHIN == predicate) {
+        geoContainer->computeInteriorCovering();
+    }
+
     return Status::OK();
 }
 
@@ -31,6 +31,7 @@
 
 #include "mongo/unittest/unittest.h"
 
+#include <cmath>
 #include <memory>
 
 #include "mongo/db/jsobj.h"
@@ -55,6 +56,35 @@ TEST(ExpressionGeoTest, Geo1) {
     ASSERT(ge.matchesBSON(fromjson("{a: {x: 5, y:5.1}}")));
 }
 
+TEST(ExpressionGeoTest, GeoWithinPolygonWithManyVertices) {
+    // Approximate a circle of radius 1 degree around the origin, with enough vertices for the
+    // polygon's interior covering to be used.
+    const int kNumVertices = 100;
+    BSONArrayBuilder ring;
+    for (int i = 0; i < kNumVertices; ++i) {
+        const double angle = 2 * M_PI * i / kNumVertices;
+        ring.append(BSON_ARRAY(std::cos(angle) << std::sin(angle)));
+    }
+    ring.append(BSON_ARRAY(1.0 << 0.0));
+
+    BSONObj query = BSON(
+        "loc" << BSON("$geoWithin" << BSON(
+                          "$geometry" << BSON("type"
+                                              << "Polygon"
+                                              << "coordinates" << BSON_ARRAY(ring.arr())))));
+
+    std::unique_ptr<GeoExpression> gq(new GeoExpression);
+    ASSERT_OK(gq->parseFrom(query["loc"].Obj()));
+
+    GeoMatchExpression ge("a", gq.release(), query);
+
+    ASSERT(ge.matchesBSON(fromjson("{a: {type: 'Point', coordinates: [0, 0]}}")));
+    ASSERT(ge.matchesBSON(fromjson("{a: {type: 'Point', coordinates: [0.5, -0.5]}}")));
+    ASSERT(ge.matchesBSON(fromjson("{a: {type: 'Point', coordinates: [0.99, 0]}}")));
+    ASSERT(!ge.matchesBSON(fromjson("{a: {type: 'Point', coordinates: [1.01, 0]}}")));
+    ASSERT(!ge.matchesBSON(fromjson("{a: {type: 'Point', coordinates: [2, 0]}}")));
+}
+
 TEST(ExpressionGeoTest, GeoNear1) {
     BSONObj query = fromjson(
         "{loc:{$near:{$maxDistance:100, "
@@ -32,8 +32,10 @@
 #include "mongo/db/matcher/expression_leaf.h"
 
 #include <cmath>
+#include <cstring>
 #include <memory>
 #include <pcrecpp.h>
+#include <string_view>
 
 #include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/bsonmisc.h"
@@ -203,6 +205,49 @@ constexpr StringData GTEMatchExpression::kName;
 
 const std::set<char> RegexMatchExpression::kValidRegexFlags = {'i', 'm', 's', 'x'};
 
+namespace {
+
+/**
+ * Returns the longest run of literal characters that any string matching 'regex' must contain, or
+ * an empty string if no such run can be determined cheaply. Only patterns which are a flat sequence
+ * of atoms are analyzed; any alternation, group, character class or escape disables the analysis,
+ * as do the case-insensitive and extended flags, which change how literal characters match.
+ */
+std::string extractRequiredLiteral(const std::string& regex, const std::string& flags) {
+    if (flags.find_first_of("ix") != std::string::npos ||
+        regex.find_first_of("|()[\\") != std::string::npos) {
+        return {};
+    }
+
+    auto isQuantifier = [](char c) { return c == '*' || c == '+' || c == '?' || c == '{'; };
+
+    std::string longest;
+    std::string current;
+    for (size_t i = 0; i < regex.size(); ++i) {
+        const char c = regex[i];
+        // Non-ASCII bytes are part of multi-byte UTF-8 characters, which a following quantifier
+        // applies to as a whole, so they end the current run.
+        const bool isLiteral = static_cast<unsigned char>(c) < 0x80 &&
+            std::strchr("^$.*+?{}]", c) == nullptr;
+        const bool isQuantified = i + 1 < regex.size() && isQuantifier(regex[i + 1]);
+        if (isLiteral && !isQuantified) {
+            current.push_back(c);
+            continue;
+        }
+        if (current.size() > longest.size()) {
+            longest = current;
+        }
+        current.clear();
+        if (c == '{') {
+            // Skip over the bounds of a counted repetition such as "{2,3}".
+            i = std::min(regex.find('}', i), regex.size());
+        }
+    }
+    return current.size() > longest.size() ? current : longest;
+}
+
+}  // namespace
+
 std::unique_ptr<pcrecpp::RE> RegexMatchExpression::makeRegex(const std::string& regex,
                                                              const std::string& flags) {
     return std::make_unique<pcrecpp::RE>(regex.c_str(),
@@ -238,6 +283,8 @@ void RegexMatchExpression::_init() {
     uassert(51091,
             str::stream() << "Regular expression is invalid: " << _re->error(),
             _re->error().empty());
+
+    _requiredLiteral = extractRequiredLiteral(_regex, _flags);
 }
 
 RegexMatchExpression::~RegexMatchExpression() {}
@@ -259,6 +306,11 @@ bool RegexMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetai
             // pcrecpp::StringPiece instance using the full length of the string to avoid truncating
             // 'data' early.
             pcrecpp::StringPiece data(e.valuestr(), e.valuestrsize() - 1);
+            if (!_requiredLiteral.empty() &&
+                std::string_view(data.data(), data.size()).find(_requiredLiteral) ==
+                    std::string_view::npos) {
+                return false;
+            }
             return _re->PartialMatch(data);
         }
         case RegEx:
@@ -384,8 +436,8 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     }
     next->_hasNull = _hasNull;
     next->_hasEmptyArray = _hasEmptyArray;
-    next->_equalitySet = _equalitySet;
     next->_originalEqualityVector = _originalEqualityVector;
+    next->_updateEqualitySet();
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
             static_cast<RegexMatchExpression*>(regex->shallowClone().release()));
@@ -395,6 +447,9 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
 }
 
 bool InMatchExpression::contains(const BSONElement& e) const {
+    if (_hashedEqualitySet) {
+        return _hashedEqualitySet->count(e) > 0;
+    }
     return std::binary_search(_equalitySet.begin(), _equalitySet.end(), e, _eltCmp.makeLessThan());
 }
 
@@ -492,6 +547,11 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
     _collator = collator;
     _eltCmp = BSONElementComparator(BSONElementComparator::FieldNamesMode::kIgnore, _collator);
 
+    // We need to re-compute '_equalitySet', since our set comparator has changed.
+    _updateEqualitySet();
+}
+
+void InMatchExpression::_updateEqualitySet() {
     if (!std::is_sorted(_originalEqualityVector.begin(),
                         _originalEqualityVector.end(),
                         _eltCmp.makeLessThan())) {
@@ -499,13 +559,20 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
             _originalEqualityVector.begin(), _originalEqualityVector.end(), _eltCmp.makeLessThan());
     }
 
-    // We need to re-compute '_equalitySet', since our set comparator has changed.
     _equalitySet.clear();
     _equalitySet.reserve(_originalEqualityVector.size());
     std::unique_copy(_originalEqualityVector.begin(),
                      _originalEqualityVector.end(),
                      std::back_inserter(_equalitySet),
                      _eltCmp.makeEqualTo());
+
+    _hashedEqualitySet.reset();
+    if (_equalitySet.size() >= kMinEqualitiesForHashedLookup) {
+        _hashedEqualitySet =
+            std::make_unique<BSONEltUnorderedSet>(_eltCmp.makeBSONEltUnorderedSet());
+        _hashedEqualitySet->reserve(_equalitySet.size());
+        _hashedEqualitySet->insert(_equalitySet.begin(), _equalitySet.end());
+    }
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -525,20 +592,7 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
     }
 
     _originalEqualityVector = std::move(equalities);
-
-    if (!std::is_sorted(_originalEqualityVector.begin(),
-                        _originalEqualityVector.end(),
-                        _eltCmp.makeLessThan())) {
-        std::sort(
-            _originalEqualityVector.begin(), _originalEqualityVector.end(), _eltCmp.makeLessThan());
-    }
-
-    _equalitySet.clear();
-    _equalitySet.reserve(_originalEqualityVector.size());
-    std::unique_copy(_originalEqualityVector.begin(),
-                     _originalEqualityVector.end(),
-                     std::back_inserter(_equalitySet),
-                     _eltCmp.makeEqualTo());
+    _updateEqualitySet();
 
     return Status::OK();
 }
@@ -407,6 +407,10 @@ private:
     std::string _regex;
     std::string _flags;
     std::unique_ptr<pcrecpp::RE> _re;
+
+    // A literal substring that every string matched by '_re' must contain, or empty if none could
+    // be determined. Strings which do not contain it are rejected without running '_re'.
+    std::string _requiredLiteral;
 };
 
 class ModMatchExpression : public LeafMatchExpression {
@@ -545,8 +549,19 @@ public:
     }
 
 private:
+    // Equality sets with at least this many distinct elements are also indexed in
+    // '_hashedEqualitySet', so that membership tests cost a single hash probe rather than a
+    // logarithmic number of element comparisons.
+    static constexpr size_t kMinEqualitiesForHashedLookup = 64;
+
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    /**
+     * Sorts '_originalEqualityVector' according to '_eltCmp' and recomputes '_equalitySet' and
+     * '_hashedEqualitySet' from it.
+     */
+    void _updateEqualitySet();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -570,10 +585,13 @@ private:
     // support std::binary_search. Because we need to sort the elements anyway for things like index
     // bounds building, using binary search avoids the overhead of inserting into a hash table which
     // doesn't pay for itself in the common case where lookups are done a few times if ever.
-    // TODO It may be worth dynamically creating a hashset after matchesSingleElement() has been
-    // called "many" times.
     std::vector<BSONElement> _equalitySet;
 
+    // Hashed copy of '_equalitySet', only built for sets of at least kMinEqualitiesForHashedLookup
+    // elements where the extra hash table pays for itself. Its hasher and equality predicate refer
+    // to '_eltCmp', so it must be rebuilt rather than copied when the expression is cloned.
+    std::unique_ptr<BSONEltUnorderedSet> _hashedEqualitySet;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
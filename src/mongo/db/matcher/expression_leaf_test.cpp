@@ -1014,6 +1014,44 @@ TEST(RegexMatchExpression, RegexAcceptsLFOption) {
                                      << "a\rb")));
 }
 
+TEST(RegexMatchExpression, MatchesUnanchoredRegexWithRequiredLiterals) {
+    RegexMatchExpression regex("a", "error.*timeout", "");
+    ASSERT(regex.matchesBSON(BSON("a"
+                                  << "network error: request timeout")));
+    ASSERT(!regex.matchesBSON(BSON("a"
+                                   << "network error: request refused")));
+    ASSERT(!regex.matchesBSON(BSON("a"
+                                   << "timeout before error")));
+}
+
+TEST(RegexMatchExpression, MatchesRegexWithQuantifiedLiterals) {
+    RegexMatchExpression optional("a", "colou?r", "");
+    ASSERT(optional.matchesBSON(BSON("a"
+                                     << "color")));
+    ASSERT(optional.matchesBSON(BSON("a"
+                                     << "colour")));
+
+    RegexMatchExpression counted("a", "ab{0,2}c", "");
+    ASSERT(counted.matchesBSON(BSON("a"
+                                    << "ac")));
+    ASSERT(counted.matchesBSON(BSON("a"
+                                    << "abbc")));
+    ASSERT(!counted.matchesBSON(BSON("a"
+                                     << "abbbc")));
+
+    RegexMatchExpression multiByte("a", "x\u304B*y", "");
+    ASSERT(multiByte.matchesBSON(BSON("a"
+                                      << "xy")));
+    ASSERT(multiByte.matchesBSON(BSON("a"
+                                      << "x\u304B\u304By")));
+}
+
+TEST(RegexMatchExpression, CaseInsensitiveRegexMatchesLiteralsInAnyCase) {
+    RegexMatchExpression regex("a", "error", "i");
+    ASSERT(regex.matchesBSON(BSON("a"
+                                  << "ERROR")));
+}
+
 TEST(ModMatchExpression, MatchesElement) {
     BSONObj match = BSON("a" << 1);
     BSONObj largerMatch = BSON("a" << 4.0);
@@ -1370,6 +1408,58 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.contains(obj2.firstElement()));
 }
 
+TEST(InMatchExpression, LargeEqualitySetsMatchNumericallyEquivalentValues) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 1000; i += 2) {
+        bab.append(i);
+    }
+    BSONArray operand = bab.arr();
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    for (auto&& elt : operand) {
+        equalities.push_back(elt);
+    }
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    BSONObj match = BSON("a" << 998LL << "b" << 4.0 << "c" << Decimal128(0));
+    BSONObj notMatch = BSON("a" << 999 << "b" << 4.5 << "c"
+                                << "4");
+    ASSERT(in.matchesSingleElement(match["a"]));
+    ASSERT(in.matchesSingleElement(match["b"]));
+    ASSERT(in.matchesSingleElement(match["c"]));
+    ASSERT(!in.matchesSingleElement(notMatch["a"]));
+    ASSERT(!in.matchesSingleElement(notMatch["b"]));
+    ASSERT(!in.matchesSingleElement(notMatch["c"]));
+
+    auto clone = in.shallowClone();
+    ASSERT(clone->matchesSingleElement(match["a"]));
+    ASSERT(!clone->matchesSingleElement(notMatch["a"]));
+}
+
+TEST(InMatchExpression, LargeEqualitySetsRespectCollation) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 100; ++i) {
+        bab.append("string" + std::to_string(i));
+    }
+    BSONArray operand = bab.arr();
+    BSONObj match = BSON("a"
+                         << "STRING42");
+    BSONObj notMatch = BSON("a"
+                            << "STRING100");
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    for (auto&& elt : operand) {
+        equalities.push_back(elt);
+    }
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT(!in.matchesSingleElement(match["a"]));
+
+    in.setCollator(&collator);
+    ASSERT(in.matchesSingleElement(match["a"]));
+    ASSERT(!in.matchesSingleElement(notMatch["a"]));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
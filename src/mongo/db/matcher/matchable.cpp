@@ -38,4 +38,40 @@ BSONMatchableDocument::BSONMatchableDocument(const BSONObj& obj) : _obj(obj) {
 }
 
 BSONMatchableDocument::~BSONMatchableDocument() {}
+
+ElementIterator* BSONMatchableDocument::allocateIterator(const ElementPath* path) const {
+    auto iterator = _iteratorUsed ? new BSONElementIterator() : &_iterator;
+    _iteratorUsed = true;
+
+    if (auto topLevelField = _findTopLevelField(path)) {
+        iterator->reset(path, 1, *topLevelField);
+    } else {
+        iterator->reset(path, _obj);
+    }
+    return iterator;
+}
+
+boost::optional<BSONElement> BSONMatchableDocument::_findTopLevelField(
+    const ElementPath* path) const {
+    const int kLookupsBeforeIndexing = 16;
+    if (path->fieldRef().numParts() == 0 || ++_numLookups < kLookupsBeforeIndexing) {
+        return boost::none;
+    }
+
+    auto byFieldName = [](const auto& field, StringData name) { return field.first < name; };
+    if (_numLookups == kLookupsBeforeIndexing) {
+        for (auto&& elem : _obj) {
+            _topLevelFields.emplace_back(elem.fieldNameStringData(), elem);
+        }
+        // A stable sort keeps the first of several fields with the same name ahead of the others,
+        // which is the one a scan of the object would find.
+        std::stable_sort(_topLevelFields.begin(),
+                         _topLevelFields.end(),
+                         [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    }
+
+    const auto name = path->fieldRef().getPart(0);
+    auto it = std::lower_bound(_topLevelFields.begin(), _topLevelFields.end(), name, byFieldName);
+    return it != _topLevelFields.end() && it->first == name ? it->second : BSONElement();
+}
 }  // namespace mongo
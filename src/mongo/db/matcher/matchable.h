@@ -83,13 +83,7 @@ public:
         return _obj;
     }
 
-    virtual ElementIterator* allocateIterator(const ElementPath* path) const {
-        if (_iteratorUsed)
-            return new BSONElementIterator(path, _obj);
-        _iteratorUsed = true;
-        _iterator.reset(path, _obj);
-        return &_iterator;
-    }
+    virtual ElementIterator* allocateIterator(const ElementPath* path) const;
 
     virtual void releaseIterator(ElementIterator* iterator) const {
         if (iterator == &_iterator) {
@@ -100,9 +94,22 @@ public:
     }
 
 private:
+    /**
+     * Returns the top-level element of '_obj' named by the first component of 'path', or EOO if
+     * there is none, once enough paths have been looked up to make it worth indexing the top-level
+     * fields of '_obj'. Returns boost::none if the caller should search '_obj' itself.
+     */
+    boost::optional<BSONElement> _findTopLevelField(const ElementPath* path) const;
+
     BSONObj _obj;
     mutable BSONElementIterator _iterator;
     mutable bool _iteratorUsed;
+
+    // Expressions such as $jsonSchema validators look up many paths in the same document, and
+    // each scan of '_obj' for a field is linear in its number of fields. After a number of lookups,
+    // the top-level fields are indexed by name so that each later lookup is a binary search.
+    mutable int _numLookups = 0;
+    mutable std::vector<std::pair<StringData, BSONElement>> _topLevelFields;
 };
 
 /**
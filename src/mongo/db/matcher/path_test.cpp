@@ -31,6 +31,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/json.h"
+#include "mongo/db/matcher/matchable.h"
 #include "mongo/db/matcher/path.h"
 
 namespace mongo {
@@ -566,4 +567,34 @@ TEST(SingleElementElementIterator, Simple1) {
 
     ASSERT(!i.more());
 }
+TEST(Path, BSONMatchableDocumentFindsSameElementsOnceTopLevelFieldsAreIndexed) {
+    BSONObj doc = fromjson(
+        "{z: 1, a: {b: [{c: 2}, {c: 3}]}, d: [4, 5], e: 'x', a: 6, f: {g: 7}, h: null}");
+    BSONMatchableDocument matchable(doc);
+
+    // Look up enough paths for the document to index its top-level fields, and check that every
+    // lookup matches the elements found by scanning the document.
+    const std::vector<std::string> paths = {
+        "a", "a.b", "a.b.c", "d", "d.0", "e", "e.x", "f.g", "f.h", "h", "missing", "missing.x"};
+    for (int round = 0; round < 3; ++round) {
+        for (auto&& pathString : paths) {
+            ElementPath path;
+            path.init(pathString);
+
+            std::vector<BSONElement> expected;
+            BSONElementIterator scan(&path, doc);
+            while (scan.more()) {
+                expected.push_back(scan.next().element());
+            }
+
+            MatchableDocument::IteratorHolder cursor(&matchable, &path);
+            for (auto&& elem : expected) {
+                ASSERT(cursor->more());
+                ASSERT_BSONELT_EQ(elem, cursor->next().element());
+            }
+            ASSERT(!cursor->more());
+        }
+    }
+}
+
 }  // namespace mongo
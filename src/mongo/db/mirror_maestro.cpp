@@ -45,6 +45,7 @@
 #include "mongo/db/client_out_of_line_executor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/mirror_maestro_gen.h"
 #include "mongo/db/mirroring_sampler.h"
 #include "mongo/db/repl/is_master_response.h"
@@ -55,8 +56,10 @@
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/thread_pool_task_executor.h"
 #include "mongo/logv2/log.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/synchronized_value.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -72,6 +75,7 @@ constexpr auto kMirroredReadsSeenKey = "seen"_sd;
 constexpr auto kMirroredReadsSentKey = "sent"_sd;
 constexpr auto kMirroredReadsResolvedKey = "resolved"_sd;
 constexpr auto kMirroredReadsResolvedBreakdownKey = "resolvedBreakdown"_sd;
+constexpr auto kMirroredReadsCachePrimingKey = "cachePriming"_sd;
 
 MONGO_FAIL_POINT_DEFINE(mirrorMaestroExpectsResponse);
 
@@ -88,9 +92,11 @@ public:
     void shutdown() noexcept;
 
     /**
-     * Mirror only if this maestro has been initialized
+     * Mirror only if this maestro has been initialized. The primaryLatency is how long the
+     * invocation took to run on this node.
      */
-    void tryMirror(std::shared_ptr<CommandInvocation> invocation) noexcept;
+    void tryMirror(std::shared_ptr<CommandInvocation> invocation,
+                   Microseconds primaryLatency) noexcept;
 
     /**
      * Maintains the state required for mirroring requests.
@@ -100,17 +106,19 @@ public:
         MirroredRequestState(MirrorMaestroImpl* maestro,
                              std::vector<HostAndPort> hosts,
                              std::shared_ptr<CommandInvocation> invocation,
-                             MirroredReadsParameters params)
+                             MirroredReadsParameters params,
+                             Microseconds primaryLatency)
             : _maestro(std::move(maestro)),
               _hosts(std::move(hosts)),
               _invocation(std::move(invocation)),
-              _params(std::move(params)) {}
+              _params(std::move(params)),
+              _primaryLatency(primaryLatency) {}
 
         MirroredRequestState() = delete;
 
         void mirror() noexcept {
             invariant(_maestro);
-            _maestro->_mirror(_hosts, _invocation, _params);
+            _maestro->_mirror(_hosts, _invocation, _params, _primaryLatency);
         }
 
     private:
@@ -118,6 +126,7 @@ public:
         std::vector<HostAndPort> _hosts;
         std::shared_ptr<CommandInvocation> _invocation;
         MirroredReadsParameters _params;
+        Microseconds _primaryLatency;
     };
 
 private:
@@ -128,7 +137,8 @@ private:
      */
     void _mirror(const std::vector<HostAndPort>& hosts,
                  std::shared_ptr<CommandInvocation> invocation,
-                 const MirroredReadsParameters& params) noexcept;
+                 const MirroredReadsParameters& params,
+                 Microseconds primaryLatency) noexcept;
 
     /**
      * An enum detailing the liveness of the Maestro
@@ -187,6 +197,10 @@ public:
             section.append(kMirroredReadsResolvedBreakdownKey, resolvedBreakdown.toBSON());
         }
 
+        if (auto cachePrimingStats = cachePrimingBreakdown.toBSON(); !cachePrimingStats.isEmpty()) {
+            section.append(kMirroredReadsCachePrimingKey, cachePrimingStats);
+        }
+
         return section.obj();
     };
 
@@ -222,7 +236,65 @@ public:
         stdx::unordered_map<std::string, CounterT> _resolved;
     };
 
+    /**
+     * Maintains, for each secondary, how long the reads mirrored to it in cache priming mode took
+     * compared to how long the same reads took on this node.
+     *
+     * In that mode every electable secondary is sent the same reads, so the figures of different
+     * secondaries can be compared directly: a secondary whose latency is well above the others' has
+     * a colder cache, and a failover to it would hurt. The mirrored latency also includes the
+     * network round trip, and a mirrored read only returns its first result, so the ratio to this
+     * node's latency is only meaningful relative to the other secondaries'.
+     */
+    class CachePrimingBreakdownByHost {
+    public:
+        void onResponseReceived(const HostAndPort& host,
+                                bool isOK,
+                                Microseconds latency,
+                                Microseconds primaryLatency) noexcept {
+            const auto hostName = host.toString();
+            stdx::lock_guard<Mutex> lk(_mutex);
+
+            auto& stats = _stats[hostName];
+            stats.resolved++;
+            if (!isOK) {
+                stats.errors++;
+            }
+            stats.latencyMicros += durationCount<Microseconds>(latency);
+            stats.primaryLatencyMicros += durationCount<Microseconds>(primaryLatency);
+        }
+
+        BSONObj toBSON() const noexcept {
+            stdx::lock_guard<Mutex> lk(_mutex);
+            BSONObjBuilder bob;
+            for (const auto& [hostName, stats] : _stats) {
+                BSONObjBuilder hostBob(bob.subobjStart(hostName));
+                hostBob.append("resolved", stats.resolved);
+                hostBob.append("errors", stats.errors);
+                hostBob.append("latencyMicros", stats.latencyMicros);
+                hostBob.append("primaryLatencyMicros", stats.primaryLatencyMicros);
+                hostBob.append("latencyRatio",
+                               static_cast<double>(stats.latencyMicros) /
+                                   std::max(stats.primaryLatencyMicros, CounterT(1)));
+            }
+            return bob.obj();
+        }
+
+    private:
+        struct Stats {
+            CounterT resolved = 0;
+            CounterT errors = 0;
+            CounterT latencyMicros = 0;
+            CounterT primaryLatencyMicros = 0;
+        };
+
+        mutable Mutex _mutex = MONGO_MAKE_LATCH("CachePrimingBreakdownByHost"_sd);
+
+        stdx::unordered_map<std::string, Stats> _stats;
+    };
+
     ResolvedBreakdownByHost resolvedBreakdown;
+    CachePrimingBreakdownByHost cachePrimingBreakdown;
 
     AtomicWord<CounterT> seen;
     AtomicWord<CounterT> sent;
@@ -285,10 +357,13 @@ void MirrorMaestro::tryMirrorRequest(OperationContext* opCtx) noexcept {
 
     auto invocation = CommandInvocation::get(opCtx);
 
-    impl.tryMirror(std::move(invocation));
+    // This runs right after the command, so the elapsed time of the operation is how long the
+    // command took on this node.
+    impl.tryMirror(std::move(invocation), CurOp::get(opCtx)->elapsedTimeExcludingPauses());
 }
 
-void MirrorMaestroImpl::tryMirror(std::shared_ptr<CommandInvocation> invocation) noexcept {
+void MirrorMaestroImpl::tryMirror(std::shared_ptr<CommandInvocation> invocation,
+                                  Microseconds primaryLatency) noexcept {
     if (!_isInitialized.load()) {
         // If we're not even available, nothing to do
         return;
@@ -310,7 +385,7 @@ void MirrorMaestroImpl::tryMirror(std::shared_ptr<CommandInvocation> invocation)
 
     auto imr = _topologyVersionObserver.getCached();
     auto samplingParams = MirroringSampler::SamplingParameters(params.getSamplingRate());
-    if (!_sampler.shouldSample(imr, samplingParams)) {
+    if (!_sampler.shouldSample(imr, samplingParams, params.getCachePriming())) {
         // If we wouldn't select a host, then nothing more to do
         return;
     }
@@ -329,7 +404,7 @@ void MirrorMaestroImpl::tryMirror(std::shared_ptr<CommandInvocation> invocation)
     // out-of-line. This means the command itself can return quickly and we do the arduous work of
     // building new bsons and evaluating randomness in a less important context.
     auto requestState = std::make_unique<MirroredRequestState>(
-        this, std::move(hosts), std::move(invocation), std::move(params));
+        this, std::move(hosts), std::move(invocation), std::move(params), primaryLatency);
     ExecutorFuture(_executor)  //
         .getAsync([clientExecutorHandle,
                    requestState = std::move(requestState)](const auto& status) mutable {
@@ -344,7 +419,8 @@ void MirrorMaestroImpl::tryMirror(std::shared_ptr<CommandInvocation> invocation)
 
 void MirrorMaestroImpl::_mirror(const std::vector<HostAndPort>& hosts,
                                 std::shared_ptr<CommandInvocation> invocation,
-                                const MirroredReadsParameters& params) noexcept try {
+                                const MirroredReadsParameters& params,
+                                Microseconds primaryLatency) noexcept try {
     auto payload = [&] {
         BSONObjBuilder bob;
 
@@ -367,13 +443,25 @@ void MirrorMaestroImpl::_mirror(const std::vector<HostAndPort>& hosts,
         return bob.obj();
     }();
 
-    // Mirror to a normalized subset of eligible hosts (i.e., secondaries).
+    // Mirror to a normalized subset of eligible hosts (i.e., secondaries), or to all of them when
+    // priming their caches.
+    const bool cachePriming = params.getCachePriming();
     const auto startIndex = rand() % hosts.size();
-    const auto mirroringFactor = std::ceil(params.getSamplingRate() * hosts.size());
+    const auto mirroringFactor = cachePriming
+        ? hosts.size()
+        : std::ceil(params.getSamplingRate() * hosts.size());
 
-    for (auto i = 0; i < mirroringFactor; i++) {
+    for (size_t i = 0; i < mirroringFactor; i++) {
         auto& host = hosts[(startIndex + i) % hosts.size()];
-        auto mirrorResponseCallback = [host](auto& args) {
+        auto mirrorResponseCallback = [host, cachePriming, primaryLatency, timer = Timer()](
+                                          auto& args) {
+            if (cachePriming) {
+                auto isOK = args.response.isOK() &&
+                    getStatusFromCommandResult(args.response.data).isOK();
+                gMirroredReadsSection.cachePrimingBreakdown.onResponseReceived(
+                    host, isOK, Microseconds(timer.micros()), primaryLatency);
+            }
+
             if (MONGO_likely(!mirrorMaestroExpectsResponse.shouldFail())) {
                 // If we don't expect responses, then there is nothing to do here
                 return;
@@ -393,7 +481,7 @@ void MirrorMaestroImpl::_mirror(const std::vector<HostAndPort>& hosts,
 
         auto newRequest = executor::RemoteCommandRequest(
             host, invocation->ns().db().toString(), payload, nullptr);
-        if (MONGO_likely(!mirrorMaestroExpectsResponse.shouldFail())) {
+        if (!cachePriming && MONGO_likely(!mirrorMaestroExpectsResponse.shouldFail())) {
             // If we're not expecting a response, set to fire and forget
             newRequest.fireAndForgetMode = executor::RemoteCommandRequest::FireAndForgetMode::kOn;
         }
@@ -64,7 +64,8 @@ MirroringSampler::SamplingParameters::SamplingParameters(const double ratio,
       }()) {}
 
 bool MirroringSampler::shouldSample(const std::shared_ptr<const repl::IsMasterResponse>& imr,
-                                    const SamplingParameters& params) const noexcept {
+                                    const SamplingParameters& params,
+                                    bool mirrorToAllTargets) const noexcept {
     if (!imr) {
         // If we don't have an IsMasterResponse, we can't know where to send our mirrored request.
         return false;
@@ -77,6 +78,10 @@ bool MirroringSampler::shouldSample(const std::shared_ptr<const repl::IsMasterRe
     }
     invariant(secondariesCount > 0);
 
+    if (mirrorToAllTargets) {
+        return params.value < static_cast<int>(params.max * params.ratio);
+    }
+
     // Adjust ratio to mirror read requests to approximately `samplingRate x secondariesCount`.
     const auto secondariesRatio = secondariesCount * params.ratio;
     const auto mirroringFactor = std::ceil(secondariesRatio);
@@ -84,12 +84,20 @@ public:
 
     /**
      * Use the given imr and params to determine if we should attempt to sample.
+     *
+     * Each eligible secondary receives approximately `ratio` of the requests either way. If
+     * `mirrorToAllTargets` is true, a sampled request goes to every eligible secondary, so the
+     * request is sampled with probability `ratio`. Otherwise it goes to a subset of them and the
+     * probability is scaled up to match.
      */
     bool shouldSample(const std::shared_ptr<const repl::IsMasterResponse>& imr,
-                      const SamplingParameters& params) const noexcept;
+                      const SamplingParameters& params,
+                      bool mirrorToAllTargets = false) const noexcept;
 
     /**
-     * Return all eligible hosts from an IsMasterResponse that we should mirror to.
+     * Return all eligible hosts from an IsMasterResponse that we should mirror to. These are the
+     * electable members other than the primary; passive, hidden and arbiter members are not
+     * listed as hosts by isMaster and are never mirrored to.
      */
     std::vector<HostAndPort> getRawMirroringTargets(
         const std::shared_ptr<const repl::IsMasterResponse>& isMaster) noexcept;
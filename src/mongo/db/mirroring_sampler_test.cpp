@@ -206,4 +206,37 @@ TEST_F(MirroringSamplerFixture, MirrorAll) {
     }
 }
 
+TEST_F(MirroringSamplerFixture, MirrorToAllTargetsSamplesAtRatio) {
+    std::vector<size_t> secondariesCount = {1, 2, 3, 4, 5, 6, 7};
+    std::vector<double> ratios = {0.01, 0.10, 0.25, 0.50, 0.90};
+    for (auto secondaryQ : secondariesCount) {
+        init(secondaryQ);
+        auto isMaster = getIsMaster();
+        auto sampler = MirroringSampler();
+
+        for (auto ratio : ratios) {
+            resetPseudoRandomSeed();
+            resetHitCounts();
+
+            auto pseudoRandomGen = [&]() -> int { return this->nextPseudoRandom(); };
+
+            for (size_t i = 0; i < repeats; i++) {
+                auto params =
+                    MirroringSampler::SamplingParameters(ratio, RAND_MAX, pseudoRandomGen);
+                if (sampler.shouldSample(isMaster, params, true /* mirrorToAllTargets */)) {
+                    auto targets = sampler.getRawMirroringTargets(isMaster);
+                    populteHitCounts(targets);
+                }
+            }
+
+            // Every secondary sees the same requests, and each of them sees about 'ratio' of them.
+            ASSERT_EQ(getHitCountsSTD(), 0);
+            const double observedMirroredCmds = getHitCountsSum();
+            const double expectedMirroredCmds = repeats * ratio * secondaryQ;
+            ASSERT_GT(observedMirroredCmds / expectedMirroredCmds, 0.95);
+            ASSERT_LT(observedMirroredCmds / expectedMirroredCmds, 1.05);
+        }
+    }
+}
+
 }  // namespace mongo
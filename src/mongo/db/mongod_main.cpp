@@ -52,6 +52,7 @@
 #include "mongo/db/auth/auth_op_observer.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/sasl_options.h"
+#include "mongo/db/background_compaction.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/collection_impl.h"
@@ -108,6 +109,8 @@
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
 #include "mongo/db/pipeline/process_interface/replica_set_node_process_interface.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/plan_cache_persistence.h"
+#include "mongo/db/query/query_result_cache_op_observer.h"
 #include "mongo/db/read_write_concern_defaults_cache_lookup_mongod.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
 #include "mongo/db/repl/oplog.h"
@@ -177,6 +180,7 @@
 #include "mongo/util/cmdline_utils/censor_cmdline.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/cpu_profiler.h"
 #include "mongo/util/exception_filter_win32.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point.h"
@@ -657,6 +661,8 @@ ExitCode _initAndListen(ServiceContext* serviceContext, int listenPort) {
             startTTLMonitor(serviceContext);
         }
 
+        startBackgroundCompactor(serviceContext);
+
         if (replSettings.usingReplSets() || !gInternalValidateFeaturesAsMaster) {
             serverGlobalParams.validateFeaturesAsMaster.store(false);
         }
@@ -664,6 +670,10 @@ ExitCode _initAndListen(ServiceContext* serviceContext, int listenPort) {
 
     startClientCursorMonitor();
 
+    if (!storageGlobalParams.readOnly) {
+        startPlanCachePersistence();
+    }
+
     PeriodicTask::startRunningPeriodicTasks();
 
     SessionKiller::set(serviceContext,
@@ -988,6 +998,7 @@ void setUpObservers(ServiceContext* serviceContext) {
         opObserverRegistry->addObserver(std::make_unique<OpObserverImpl>());
     }
     opObserverRegistry->addObserver(std::make_unique<AuthOpObserver>());
+    opObserverRegistry->addObserver(std::make_unique<QueryResultCacheOpObserver>());
 
     setupFreeMonitoringOpObserver(opObserverRegistry.get());
 
@@ -1280,6 +1291,9 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
     LOGV2(4784928, "Shutting down the TTL monitor");
     shutdownTTLMonitor(serviceContext);
 
+    LOGV2(5021450, "Shutting down the background compactor");
+    shutdownBackgroundCompactor(serviceContext);
+
     // We should always be able to acquire the global lock at shutdown.
     // An OperationContext is not necessary to call lockGlobal() during shutdown, as it's only used
     // to check that lockGlobal() is not called after a transaction timestamp has been set.
@@ -1377,6 +1391,9 @@ int mongod_main(int argc, char* argv[]) {
     // initializeServerGlobalState) and before the creation of any other threads
     startSignalProcessingThread();
 
+    // The CPU profiler only samples the threads created after it starts.
+    CpuProfiler::startIfEnabled();
+
     ReadWriteConcernDefaults::create(service, readWriteConcernDefaultsCacheLookupMongoD);
 
 #if defined(_WIN32)
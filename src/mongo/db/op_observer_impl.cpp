@@ -916,7 +916,11 @@ std::vector<repl::ReplOperation>::iterator packTransactionStatementsForApplyOps(
             (opsArray.arrSize() > 0 &&
              (opsArray.len() + OplogEntry::getDurableReplOperationSize(stmt) > BSONObjMaxUserSize)))
             break;
-        opsArray.append(stmt.toBSON());
+        // Serialize directly into the array buffer rather than building each operation as a
+        // standalone object and copying it in, which is measurable on commit of large
+        // transactions.
+        BSONObjBuilder stmtBuilder(opsArray.subobjStart());
+        stmt.serialize(&stmtBuilder);
     }
     try {
         // BSONArrayBuilder will throw a BSONObjectTooLarge exception if we exceeded the max BSON
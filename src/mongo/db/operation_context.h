@@ -45,6 +45,7 @@
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/transport/session.h"
+#include "mongo/util/concurrency/admission_priority.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/decorable.h"
 #include "mongo/util/interruptible.h"
@@ -140,6 +141,12 @@ public:
      */
     std::unique_ptr<Locker> swapLockState(std::unique_ptr<Locker> locker, WithLock);
 
+    /**
+     * Releases the locker to the caller, leaving this OperationContext without one. Call during
+     * OperationContext destruction, once it can no longer be reached through its Client, only.
+     */
+    std::unique_ptr<Locker> releaseLockState();
+
     /**
      * Returns Status::OK() unless this operation is in a killed state.
      */
@@ -443,6 +450,17 @@ public:
         return _comment ? boost::optional<BSONElement>(_comment->firstElement()) : boost::none;
     }
 
+    /**
+     * Returns the priority with which this operation waits for storage engine tickets.
+     */
+    AdmissionPriority getAdmissionPriority() const {
+        return _admissionPriority;
+    }
+
+    void setAdmissionPriority(AdmissionPriority priority) {
+        _admissionPriority = priority;
+    }
+
     /**
      * Sets whether this operation is an exhaust command.
      */
@@ -607,6 +625,8 @@ private:
 
     // Whether this operation is an exhaust command.
     bool _exhaust = false;
+
+    AdmissionPriority _admissionPriority = AdmissionPriority::kNormal;
 };
 
 // Gets a TimeZoneDatabase pointer from the ServiceContext.
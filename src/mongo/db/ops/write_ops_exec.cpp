@@ -321,6 +321,22 @@ void insertDocuments(OperationContext* opCtx,
 
     uassertStatusOK(
         collection->insertDocuments(opCtx, begin, end, &CurOp::get(opCtx)->debug(), fromMigrate));
+
+    // Keep the statistics created by the 'analyze' command current with a sample of the inserts,
+    // once they are visible. Inside a multi-document transaction, that is when it commits.
+    if (auto stats = CollectionQueryInfo::get(collection).getCollectionStatistics();
+        stats && *stats) {
+        std::vector<BSONObj> docs;
+        for (auto it = begin; it != end; ++it) {
+            docs.push_back(it->doc.getOwned());
+        }
+        opCtx->recoveryUnit()->onCommit(
+            [stats = *stats, docs = std::move(docs)](boost::optional<Timestamp>) {
+                for (auto&& doc : docs) {
+                    stats->sampleInsertedDocument(doc);
+                }
+            });
+    }
     wuow.commit();
 }
 
@@ -576,8 +592,10 @@ WriteResult performInserts(OperationContext* opCtx,
                 }
             }
 
+            // Documents that need no fixing are inserted straight from the request, which for
+            // document sequences is a view into the message buffer.
             BSONObj toInsert = fixedDoc.getValue().isEmpty() ? doc : std::move(fixedDoc.getValue());
-            batch.emplace_back(stmtId, toInsert);
+            batch.emplace_back(stmtId, std::move(toInsert));
             bytesInBatch += batch.back().doc.objsize();
             if (!isLastDoc && batch.size() < maxBatchSize && bytesInBatch < maxBatchBytes)
                 continue;  // Add more to batch before inserting.
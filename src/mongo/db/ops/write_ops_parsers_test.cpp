@@ -221,6 +221,28 @@ TEST(CommandWriteOpsParsers, SingleInsert) {
     }
 }
 
+TEST(CommandWriteOpsParsers, InsertDocumentSequenceDoesNotCopyDocuments) {
+    const auto ns = NamespaceString("test", "foo");
+    OpMsgBuilder builder;
+    {
+        auto docSeq = builder.beginDocSequence("documents");
+        docSeq.append(BSON("x" << 0));
+        docSeq.append(BSON("x" << 1));
+    }
+    builder.setBody(BSON("insert" << ns.coll() << "$db" << ns.db()));
+    const auto message = builder.finish();
+
+    const auto op = InsertOp::parse(OpMsgRequest::parseOwned(message));
+    ASSERT_EQ(op.getDocuments().size(), 2u);
+    const char* const begin = message.buf();
+    const char* const end = begin + message.size();
+    for (const auto& doc : op.getDocuments()) {
+        // The documents are views into the message buffer, which they keep alive.
+        ASSERT(doc.isOwned());
+        ASSERT(doc.objdata() > begin && doc.objdata() < end);
+    }
+}
+
 TEST(CommandWriteOpsParsers, EmptyMultiInsertFails) {
     const auto ns = NamespaceString("test", "foo");
     auto cmd = BSON("insert" << ns.coll() << "documents" << BSONArray());
@@ -30,9 +30,11 @@
 #pragma once
 
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/dbhelpers.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/ops/write_ops_gen.h"
+#include "mongo/db/query/query_request.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -141,12 +143,9 @@ public:
      * to continue.
      */
     void forEach(OperationContext* opCtx, Query query, std::function<bool(const T&)> handler) {
-        DBDirectClient dbClient(opCtx);
-
-        auto cursor = dbClient.query(_storageNss, query);
-
-        while (cursor->more()) {
-            auto bson = cursor->next();
+        // The handler runs after the query has released its locks, since it may write to the
+        // store itself.
+        for (auto&& bson : Helpers::findAll(opCtx, _makeQueryRequest(query))) {
             auto t = T::parse(
                 IDLParserErrorContext("PersistentTaskStore:" + _storageNss.toString()), bson);
 
@@ -159,15 +158,20 @@ public:
      * Returns the number of documents in the store matching the given query.
      */
     size_t count(OperationContext* opCtx, Query query = Query()) {
-        DBDirectClient client(opCtx);
-
-        auto projection = BSON("_id" << 1);
-        auto cursor = client.query(_storageNss, query, 0, 0, &projection);
-
-        return cursor->itcount();
+        auto qr = _makeQueryRequest(query);
+        qr->setProj(BSON("_id" << 1));
+        return Helpers::findAll(opCtx, std::move(qr)).size();
     }
 
 private:
+    std::unique_ptr<QueryRequest> _makeQueryRequest(const Query& query) const {
+        auto qr = std::make_unique<QueryRequest>(_storageNss);
+        qr->setFilter(query.getFilter());
+        qr->setSort(query.getSort());
+        qr->setHint(query.getHint());
+        return qr;
+    }
+
     NamespaceString _storageNss;
 };
 
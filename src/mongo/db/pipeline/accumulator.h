@@ -31,9 +31,11 @@
 
 #include "mongo/platform/basic.h"
 
+#include <array>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/optional.hpp>
 #include <functional>
+#include <limits>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -355,6 +357,85 @@ public:
     static boost::intrusive_ptr<AccumulatorState> create(ExpressionContext* const expCtx);
 };
 
+/**
+ * Estimates the number of distinct values in a group using a HyperLogLog sketch. Unlike
+ * $addToSet, the sketch occupies a fixed amount of memory regardless of how many values are seen,
+ * and partial sketches from different shards can be merged by taking the per-register maximum.
+ */
+class AccumulatorApproxCountDistinct final : public AccumulatorState {
+public:
+    // The sketch uses 2^kPrecision single-byte registers, for a standard error of about 1.6%.
+    static constexpr int kPrecision = 12;
+    static constexpr size_t kNumRegisters = size_t{1} << kPrecision;
+
+    explicit AccumulatorApproxCountDistinct(ExpressionContext* const expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<AccumulatorState> create(ExpressionContext* const expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    std::array<uint8_t, kNumRegisters> _registers;
+};
+
+/**
+ * Estimates the 'p'th percentile of the numeric values in a group using a merging t-digest. The
+ * digest keeps at most a bounded number of centroids, so the memory used by each group is fixed,
+ * and the centroids from different shards can be combined and recompressed when merging.
+ *
+ * The syntax is {$percentile: {input: <expression>, p: <number between 0 and 1>}}.
+ */
+class AccumulatorPercentile final : public AccumulatorState {
+public:
+    // Controls the trade-off between accuracy and the number of centroids retained.
+    static constexpr int kCompression = 100;
+
+    AccumulatorPercentile(ExpressionContext* const expCtx, double p);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    Document serialize(boost::intrusive_ptr<Expression> initializer,
+                       boost::intrusive_ptr<Expression> argument,
+                       bool explain) const final;
+
+    static boost::intrusive_ptr<AccumulatorState> create(ExpressionContext* const expCtx,
+                                                         double p);
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    // Adds a centroid to the unmerged buffer, compressing first if the buffer is full.
+    void _add(double mean, double weight);
+
+    // Folds the buffered points into '_centroids', combining neighbours while each centroid stays
+    // within the t-digest size bound for its quantile.
+    void _compress();
+
+    const double _p;
+    std::vector<Centroid> _centroids;
+    std::vector<Centroid> _buffer;
+    double _totalWeight = 0;
+    double _min = std::numeric_limits<double>::infinity();
+    double _max = -std::numeric_limits<double>::infinity();
+};
+
 class AccumulatorMergeObjects : public AccumulatorState {
 public:
     AccumulatorMergeObjects(ExpressionContext* const expCtx);
@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cmath>
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR(approxCountDistinct,
+                     genericParseSingleExpressionAccumulator<AccumulatorApproxCountDistinct>);
+
+namespace {
+/**
+ * The hashes produced by ValueComparator are not guaranteed to be well distributed in every bit,
+ * so they are passed through the MurmurHash3 finalizer before being split into a register index
+ * and a rank.
+ */
+uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+}  // namespace
+
+const char* AccumulatorApproxCountDistinct::getOpName() const {
+    return "$approxCountDistinct";
+}
+
+void AccumulatorApproxCountDistinct::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        // Like $addToSet, missing values are not counted but null values are.
+        if (input.missing())
+            return;
+
+        // Values which compare equal under the collation hash to the same value, so they land in
+        // the same register with the same rank.
+        const uint64_t hash = mixHash(getExpressionContext()->getValueComparator().hash(input));
+        const size_t index = hash >> (64 - kPrecision);
+
+        // The rank is the position of the first set bit after the index bits. Setting the lowest
+        // of the kPrecision bits shifted in from the right bounds the rank for an all-zero tail.
+        const uint64_t remaining = (hash << kPrecision) | (uint64_t{1} << (kPrecision - 1));
+        const uint8_t rank = countLeadingZeros64(remaining) + 1;
+        if (rank > _registers[index])
+            _registers[index] = rank;
+    } else {
+        // This is what getValue(true) produced below.
+        verify(input.getType() == BinData);
+        const BSONBinData registers = input.getBinData();
+        verify(static_cast<size_t>(registers.length) == kNumRegisters);
+
+        const auto* data = static_cast<const uint8_t*>(registers.data);
+        for (size_t i = 0; i < kNumRegisters; ++i) {
+            if (data[i] > _registers[i])
+                _registers[i] = data[i];
+        }
+    }
+}
+
+Value AccumulatorApproxCountDistinct::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        return Value(BSONBinData(_registers.data(), kNumRegisters, BinDataGeneral));
+    }
+
+    // This is the estimator from Flajolet et al., "HyperLogLog: the analysis of a near-optimal
+    // cardinality estimation algorithm", including the linear counting correction for small
+    // cardinalities. A 64-bit hash makes the large range correction unnecessary.
+    const double m = kNumRegisters;
+    double sum = 0;
+    size_t numZeroRegisters = 0;
+    for (auto reg : _registers) {
+        sum += std::ldexp(1.0, -reg);
+        if (reg == 0)
+            ++numZeroRegisters;
+    }
+
+    const double alpha = 0.7213 / (1 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && numZeroRegisters > 0) {
+        estimate = m * std::log(m / numZeroRegisters);
+    }
+    return Value(static_cast<long long>(std::llround(estimate)));
+}
+
+AccumulatorApproxCountDistinct::AccumulatorApproxCountDistinct(ExpressionContext* const expCtx)
+    : AccumulatorState(expCtx) {
+    _registers.fill(0);
+    // This is a fixed size AccumulatorState so we never need to update this
+    _memUsageBytes = sizeof(*this);
+}
+
+void AccumulatorApproxCountDistinct::reset() {
+    _registers.fill(0);
+}
+
+intrusive_ptr<AccumulatorState> AccumulatorApproxCountDistinct::create(
+    ExpressionContext* const expCtx) {
+    return new AccumulatorApproxCountDistinct(expCtx);
+}
+
+}  // namespace mongo
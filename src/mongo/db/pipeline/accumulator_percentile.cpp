@@ -0,0 +1,246 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+namespace {
+// The number of points buffered before they are folded into the centroids.
+constexpr size_t kBufferSize = 5 * AccumulatorPercentile::kCompression;
+
+// Maps a quantile onto the k1 scale, which is steepest near the tails of the distribution.
+double scale(double q) {
+    return AccumulatorPercentile::kCompression / (2 * M_PI) * std::asin(2 * q - 1);
+}
+
+AccumulationExpression parsePercentile(ExpressionContext* const expCtx,
+                                       BSONElement elem,
+                                       VariablesParseState vps) {
+    uassert(5021431,
+            str::stream() << "$percentile expects an object as an argument; found: "
+                          << typeName(elem.type()),
+            elem.type() == BSONType::Object);
+
+    intrusive_ptr<Expression> input;
+    boost::optional<double> p;
+    for (auto&& element : elem.embeddedObject()) {
+        auto name = element.fieldNameStringData();
+        if (name == "input") {
+            input = Expression::parseOperand(expCtx, element, vps);
+        } else if (name == "p") {
+            uassert(5021432,
+                    str::stream() << "$percentile 'p' must be a number between 0 and 1; found: "
+                                  << element,
+                    element.isNumber() && element.numberDouble() >= 0 &&
+                        element.numberDouble() <= 1);
+            p = element.numberDouble();
+        } else {
+            uasserted(5021433, str::stream() << "$percentile got an unexpected field: " << name);
+        }
+    }
+    uassert(5021434, "$percentile missing required argument 'input'", input);
+    uassert(5021435, "$percentile missing required argument 'p'", p);
+
+    auto initializer = ExpressionConstant::create(expCtx, Value(BSONNULL));
+    return {std::move(initializer), std::move(input), [expCtx, p = *p]() {
+                return AccumulatorPercentile::create(expCtx, p);
+            }};
+}
+}  // namespace
+
+REGISTER_ACCUMULATOR(percentile, parsePercentile);
+
+const char* AccumulatorPercentile::getOpName() const {
+    return "$percentile";
+}
+
+Document AccumulatorPercentile::serialize(intrusive_ptr<Expression> initializer,
+                                          intrusive_ptr<Expression> argument,
+                                          bool explain) const {
+    return DOC(getOpName() << DOC("input" << argument->serialize(explain) << "p" << _p));
+}
+
+void AccumulatorPercentile::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        // Non-numeric types and NaN have no position in the distribution.
+        if (!input.numeric())
+            return;
+
+        const double val = input.getDouble();
+        if (std::isnan(val))
+            return;
+
+        _min = std::min(_min, val);
+        _max = std::max(_max, val);
+        _add(val, 1);
+    } else {
+        // This is what getValue(true) produced below.
+        verify(input.getType() == Object);
+        const auto& means = input["means"].getArray();
+        const auto& weights = input["weights"].getArray();
+        verify(means.size() == weights.size());
+
+        if (means.empty())
+            return;  // This partition had no data to contribute.
+
+        _min = std::min(_min, input["min"].getDouble());
+        _max = std::max(_max, input["max"].getDouble());
+        for (size_t i = 0; i < means.size(); ++i) {
+            _add(means[i].getDouble(), weights[i].getDouble());
+        }
+    }
+}
+
+void AccumulatorPercentile::_add(double mean, double weight) {
+    if (_buffer.size() >= kBufferSize)
+        _compress();
+
+    _buffer.push_back({mean, weight});
+    _totalWeight += weight;
+}
+
+void AccumulatorPercentile::_compress() {
+    if (_buffer.empty())
+        return;
+
+    // This is the merging variant of the t-digest from Dunning and Ertl, "Computing Extremely
+    // Accurate Quantiles Using t-Digests", using the arcsine scale function k1. A centroid may span
+    // at most one unit of k, so centroids near the tails stay small, and since k ranges over
+    // compression / 2 units in total, no more than about 'kCompression' centroids are retained.
+    _buffer.insert(_buffer.end(), _centroids.begin(), _centroids.end());
+    std::sort(_buffer.begin(), _buffer.end(), [](const Centroid& lhs, const Centroid& rhs) {
+        return lhs.mean < rhs.mean;
+    });
+
+    _centroids.clear();
+    Centroid current = _buffer.front();
+    double weightSoFar = 0;
+    for (auto it = _buffer.begin() + 1; it != _buffer.end(); ++it) {
+        const double q0 = weightSoFar / _totalWeight;
+        const double q2 =
+            std::min(1.0, (weightSoFar + current.weight + it->weight) / _totalWeight);
+
+        if (scale(q2) - scale(q0) <= 1) {
+            current.weight += it->weight;
+            current.mean += (it->mean - current.mean) * it->weight / current.weight;
+        } else {
+            weightSoFar += current.weight;
+            _centroids.push_back(current);
+            current = *it;
+        }
+    }
+    _centroids.push_back(current);
+    _buffer.clear();
+
+    _memUsageBytes =
+        sizeof(*this) + (_centroids.capacity() + _buffer.capacity()) * sizeof(Centroid);
+}
+
+Value AccumulatorPercentile::getValue(bool toBeMerged) {
+    _compress();
+
+    if (toBeMerged) {
+        std::vector<Value> means;
+        std::vector<Value> weights;
+        means.reserve(_centroids.size());
+        weights.reserve(_centroids.size());
+        for (auto&& centroid : _centroids) {
+            means.emplace_back(centroid.mean);
+            weights.emplace_back(centroid.weight);
+        }
+        return Value(DOC("means" << means << "weights" << weights << "min" << _min << "max"
+                                 << _max));
+    }
+
+    if (_centroids.empty())
+        return Value(BSONNULL);
+
+    // Each centroid's mean is placed at the middle of the ranks it covers, and the rank being
+    // sought is interpolated linearly between its neighbouring centroids. The observed minimum and
+    // maximum anchor the two ends of the distribution.
+    const double target = _p * _totalWeight;
+    double prevRank = 0;
+    double prevValue = _min;
+    double rankSoFar = 0;
+    for (auto&& centroid : _centroids) {
+        const double rank = rankSoFar + centroid.weight / 2;
+        if (target <= rank) {
+            if (rank == prevRank)
+                return Value(centroid.mean);
+            return Value(prevValue +
+                         (centroid.mean - prevValue) * (target - prevRank) / (rank - prevRank));
+        }
+        rankSoFar += centroid.weight;
+        prevRank = rank;
+        prevValue = centroid.mean;
+    }
+
+    if (_totalWeight == prevRank)
+        return Value(_max);
+    return Value(prevValue + (_max - prevValue) * (target - prevRank) / (_totalWeight - prevRank));
+}
+
+AccumulatorPercentile::AccumulatorPercentile(ExpressionContext* const expCtx, double p)
+    : AccumulatorState(expCtx), _p(p) {
+    // Both vectors are sized up front so that the memory used by each group stays fixed. The
+    // buffer also has room for the centroids it is combined with during compression.
+    _centroids.reserve(2 * kCompression);
+    _buffer.reserve(kBufferSize + 2 * kCompression);
+    _memUsageBytes =
+        sizeof(*this) + (_centroids.capacity() + _buffer.capacity()) * sizeof(Centroid);
+}
+
+void AccumulatorPercentile::reset() {
+    _centroids.clear();
+    _buffer.clear();
+    _totalWeight = 0;
+    _min = std::numeric_limits<double>::infinity();
+    _max = -std::numeric_limits<double>::infinity();
+}
+
+intrusive_ptr<AccumulatorState> AccumulatorPercentile::create(ExpressionContext* const expCtx,
+                                                              double p) {
+    return new AccumulatorPercentile(expCtx, p);
+}
+
+}  // namespace mongo
@@ -368,6 +368,130 @@ TEST(Accumulators, PushRespectsMaxMemoryConstraint) {
         ErrorCodes::ExceededMemoryLimit);
 }
 
+TEST(Accumulators, ApproxCountDistinct) {
+    auto expCtx = ExpressionContextForTest{};
+    assertExpectedResults<AccumulatorApproxCountDistinct>(
+        &expCtx,
+        {// No documents evaluated.
+         {{}, Value(0LL)},
+         // Distinct values of different types.
+         {{Value(1), Value("a"_sd), Value(BSONNULL)}, Value(3LL)},
+         // Repeated and numerically equal values are counted once.
+         {{Value(1), Value(1.0), Value(1LL), Value(2)}, Value(2LL)},
+         // Missing values are ignored.
+         {{Value(5), Value()}, Value(1LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctRespectsCollation) {
+    auto expCtx = ExpressionContextForTest{};
+    auto collator =
+        std::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx.setCollator(std::move(collator));
+    assertExpectedResults<AccumulatorApproxCountDistinct>(
+        &expCtx, {{{Value("a"_sd), Value("b"_sd), Value("c"_sd)}, Value(1LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctUsesFixedMemoryAndMergesAcrossShards) {
+    auto expCtx = ExpressionContextForTest{};
+    const int numShards = 4;
+    const long long numValues = 100000;
+
+    auto merger = AccumulatorApproxCountDistinct::create(&expCtx);
+    const int initialMemUsage = merger->memUsageForSorter();
+    for (int shard = 0; shard < numShards; ++shard) {
+        // Each shard sees its own values plus some overlap with the next shard.
+        auto accum = AccumulatorApproxCountDistinct::create(&expCtx);
+        for (long long i = 0; i < numValues / numShards + 1000; ++i) {
+            accum->process(Value((shard * numValues / numShards + i) % numValues), false);
+        }
+        ASSERT_EQ(initialMemUsage, accum->memUsageForSorter());
+        merger->process(accum->getValue(true), true);
+    }
+
+    const long long estimate = merger->getValue(false).getLong();
+    ASSERT_LT(std::abs(estimate - numValues), numValues / 20);
+}
+
+TEST(Accumulators, Percentile) {
+    auto expCtx = ExpressionContextForTest{};
+    std::vector<Value> input{Value(3), Value(1.0), Value("a"_sd), Value(5LL), Value(2), Value(4)};
+
+    auto percentile = [&](double p, bool sharded) {
+        auto accum = AccumulatorPercentile::create(&expCtx, p);
+        for (auto&& val : input) {
+            if (!sharded) {
+                accum->process(val, false);
+                continue;
+            }
+            auto shard = AccumulatorPercentile::create(&expCtx, p);
+            shard->process(val, false);
+            accum->process(shard->getValue(true), true);
+        }
+        return accum->getValue(false);
+    };
+
+    for (bool sharded : {false, true}) {
+        // Non-numeric values are ignored, and the extremes are exact.
+        ASSERT_VALUE_EQ(Value(1.0), percentile(0, sharded));
+        ASSERT_VALUE_EQ(Value(3.0), percentile(0.5, sharded));
+        ASSERT_VALUE_EQ(Value(5.0), percentile(1, sharded));
+    }
+
+    // No documents evaluated.
+    ASSERT_VALUE_EQ(Value(BSONNULL), AccumulatorPercentile::create(&expCtx, 0.5)->getValue(false));
+}
+
+TEST(Accumulators, PercentileUsesBoundedMemoryAndMergesAcrossShards) {
+    auto expCtx = ExpressionContextForTest{};
+    const int numShards = 4;
+    const int numValues = 100000;
+
+    auto merger = AccumulatorPercentile::create(&expCtx, 0.9);
+    const int initialMemUsage = merger->memUsageForSorter();
+    for (int shard = 0; shard < numShards; ++shard) {
+        auto accum = AccumulatorPercentile::create(&expCtx, 0.9);
+        for (int i = shard; i < numValues; i += numShards) {
+            accum->process(Value(i), false);
+        }
+        ASSERT_EQ(initialMemUsage, accum->memUsageForSorter());
+        merger->process(accum->getValue(true), true);
+    }
+    ASSERT_EQ(initialMemUsage, merger->memUsageForSorter());
+
+    const double estimate = merger->getValue(false).getDouble();
+    ASSERT_APPROX_EQUAL(0.9 * numValues, estimate, numValues / 100.0);
+}
+
+TEST(Accumulators, PercentileRejectsInvalidSpecifications) {
+    auto expCtx = ExpressionContextForTest{};
+    auto parse = [&](BSONObj spec) {
+        return AccumulationStatement::parseAccumulationStatement(
+            &expCtx, spec.firstElement(), expCtx.variablesParseState);
+    };
+
+    ASSERT_THROWS_CODE(parse(BSON("x" << BSON("$percentile"
+                                              << "$a"))),
+                       AssertionException,
+                       5021431);
+    ASSERT_THROWS_CODE(parse(BSON("x" << BSON("$percentile" << BSON("input"
+                                                                    << "$a"
+                                                                    << "p" << 1.5)))),
+                       AssertionException,
+                       5021432);
+    ASSERT_THROWS_CODE(parse(BSON("x" << BSON("$percentile" << BSON("p" << 0.5)))),
+                       AssertionException,
+                       5021434);
+
+    auto stmt = parse(BSON("x" << BSON("$percentile" << BSON("input"
+                                                             << "$a"
+                                                             << "p" << 0.5))));
+    ASSERT_VALUE_EQ(Value(DOC("$percentile" << DOC("input"
+                                                   << "$a"_sd
+                                                   << "p" << 0.5))),
+                    Value(stmt.makeAccumulator()->serialize(
+                        stmt.expr.initializer, stmt.expr.argument, false)));
+}
+
 /* ------------------------- AccumulatorMergeObjects -------------------------- */
 
 TEST(AccumulatorMergeObjects, MergingZeroObjectsShouldReturnEmptyDocument) {
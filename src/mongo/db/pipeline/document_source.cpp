@@ -114,6 +114,15 @@ list<intrusive_ptr<DocumentSource>> DocumentSource::parse(
     return it->second.parser(stageSpec, expCtx);
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSource::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxDocs) {
+    auto next = doGetNext();
+    if (next.isAdvanced()) {
+        batch->push_back(next.releaseDocument());
+    }
+    return next.getStatus();
+}
+
 const char* DocumentSource::getSourceName() const {
     static const char unknown[] = "[UNKNOWN]";
     return unknown;
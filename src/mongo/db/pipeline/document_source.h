@@ -275,6 +275,46 @@ public:
         return next;
     }
 
+    // The number of results a stage consuming its whole input requests from its source at once.
+    static constexpr size_t kInputBatchSize = 128;
+
+    /**
+     * Batch counterpart of getNext(). On kAdvanced, between one and 'maxDocs' results of this
+     * DocumentSource have been appended to 'batch'. On kEOF or kPauseExecution, nothing has been
+     * appended. Calls to getNext() and getNextBatch() may be freely interleaved.
+     *
+     * Stages which buffer their output anyway, such as DocumentSourceCursor, return several results
+     * at once. Other stages return a single result per call, since a streaming stage must not keep
+     * references to the documents it has already returned (see getNext()).
+     */
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch, size_t maxDocs) {
+        invariant(maxDocs > 0);
+        pExpCtx->checkForInterrupt();
+
+        if (MONGO_likely(!pExpCtx->shouldCollectDocumentSourceExecStats())) {
+            return doGetNextBatch(batch, maxDocs);
+        }
+
+        auto serviceCtx = pExpCtx->opCtx->getServiceContext();
+        invariant(serviceCtx);
+        auto fcs = serviceCtx->getFastClockSource();
+        invariant(fcs);
+
+        invariant(_commonStats.executionTimeMillis);
+        ScopedTimer timer(fcs, _commonStats.executionTimeMillis.get_ptr());
+
+        // Account for the batch as if it had been produced by successive calls to getNext().
+        const auto sizeBefore = batch->size();
+        auto status = doGetNextBatch(batch, maxDocs);
+        if (status == GetNextResult::ReturnStatus::kAdvanced) {
+            _commonStats.works += batch->size() - sizeBefore;
+            _commonStats.advanced += batch->size() - sizeBefore;
+        } else {
+            ++_commonStats.works;
+        }
+        return status;
+    }
+
     /**
      * Returns a struct containing information about any special constraints imposed on using this
      * stage. Input parameter Pipeline::SplitState is used by stages whose requirements change
@@ -523,6 +563,13 @@ protected:
      */
     virtual GetNextResult doGetNext() = 0;
 
+    /**
+     * The batch execution API of a DocumentSource. See comment at getNextBatch(). The default
+     * implementation returns the single result of doGetNext().
+     */
+    virtual GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                                       size_t maxDocs);
+
     /**
      * Attempt to perform an optimization with the following source in the pipeline. 'container'
      * refers to the entire pipeline, and 'itr' points to this stage within the pipeline.
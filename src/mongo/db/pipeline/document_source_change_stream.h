@@ -236,6 +236,11 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxDocs) final {
+        MONGO_UNREACHABLE;
+    }
+
     StageConstraints constraints(Pipeline::SplitState pipeState) const final;
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const final;
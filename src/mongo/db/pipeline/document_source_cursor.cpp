@@ -99,6 +99,28 @@ Document DocumentSourceCursor::Batch::dequeue() {
     MONGO_UNREACHABLE;
 }
 
+size_t DocumentSourceCursor::Batch::dequeueInto(std::vector<Document>* out, size_t maxDocs) {
+    switch (_type) {
+        case CursorType::kRegular: {
+            const size_t numDocs = std::min(maxDocs, _batchOfDocs.size());
+            auto end = _batchOfDocs.begin() + numDocs;
+            std::move(_batchOfDocs.begin(), end, std::back_inserter(*out));
+            _batchOfDocs.erase(_batchOfDocs.begin(), end);
+            if (_batchOfDocs.empty()) {
+                _memUsageBytes = 0;
+            }
+            return numDocs;
+        }
+        case CursorType::kEmptyDocuments: {
+            const size_t numDocs = std::min(maxDocs, _count);
+            out->resize(out->size() + numDocs);
+            _count -= numDocs;
+            return numDocs;
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
 void DocumentSourceCursor::Batch::clear() {
     _batchOfDocs.clear();
     _count = 0;
@@ -120,6 +142,25 @@ DocumentSource::GetNextResult DocumentSourceCursor::doGetNext() {
     return _currentBatch.dequeue();
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceCursor::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxDocs) {
+    if (_trackOplogTS) {
+        // The cached latest optime must be updated as each document is returned.
+        return DocumentSource::doGetNextBatch(batch, maxDocs);
+    }
+
+    if (_currentBatch.isEmpty()) {
+        loadBatch();
+    }
+
+    if (_currentBatch.isEmpty())
+        return GetNextResult::ReturnStatus::kEOF;
+
+    // The documents of '_currentBatch' are owned, so they can be handed over all at once.
+    _currentBatch.dequeueInto(batch, maxDocs);
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 void DocumentSourceCursor::loadBatch() {
     if (!_exec || _exec->isDisposed()) {
         // No more documents.
@@ -119,6 +119,8 @@ protected:
                          bool trackOplogTimestamp = false);
 
     GetNextResult doGetNext() final;
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxDocs) final;
 
     ~DocumentSourceCursor();
 
@@ -158,6 +160,12 @@ private:
          */
         Document dequeue();
 
+        /**
+         * Moves up to 'maxDocs' documents from the front of the batch to the end of 'out', and
+         * returns the number of documents moved.
+         */
+        size_t dequeueInto(std::vector<Document>* out, size_t maxDocs);
+
         void clear();
 
         bool isEmpty() const;
@@ -271,44 +271,68 @@ std::vector<FieldPath> Exchange::extractKeyPaths(const BSONObj& keyPattern) {
 
 void Exchange::unblockLoading(size_t consumerId) {
     // See if the loading is blocked on this consumer and if so unblock it.
-    if (_loadingThreadId == consumerId) {
-        _loadingThreadId = kInvalidThreadId;
-        _haveBufferSpace.notify_all();
+    if (_loadingThreadId.load() == consumerId) {
+        _loadingThreadId.store(kInvalidThreadId);
+        notifyConsumers();
     }
 }
+
+void Exchange::notifyConsumers() {
+    for (auto& c : _consumers) {
+        c->haveDocuments.notify_all();
+    }
+}
+
 DocumentSource::GetNextResult Exchange::getNext(OperationContext* opCtx,
                                                 size_t consumerId,
                                                 ResourceYielder* resourceYielder) {
-    // Grab a lock.
-    stdx::unique_lock<Latch> lk(_mutex);
+    auto& buffer = *_consumers[consumerId];
 
     for (;;) {
-        // Guard against some of the trickiness we do with moving the lock to/from the
-        // MutexAndResourceLock.
-        invariant(lk.owns_lock());
         // Execute only in case we have not encountered an error.
-        if (!_errorInLoadNextBatch.isOK()) {
+        if (_loadFailed.load()) {
             uasserted(ErrorCodes::ExchangePassthrough,
                       "Exchange failed due to an error on different thread.");
         }
 
-        // Check if we have a document.
-        if (!_consumers[consumerId]->isEmpty()) {
-            auto doc = _consumers[consumerId]->getNext();
-            unblockLoading(consumerId);
+        // Check if we have a document. Documents already in our buffer are taken without the
+        // mutex, even while another consumer is loading.
+        if (auto doc = buffer.tryGetNext()) {
+            // Taking the document made room, so release the loading if it is blocked on us.
+            if (_loadingThreadId.load() == consumerId) {
+                stdx::lock_guard<Latch> lk(_mutex);
+                unblockLoading(consumerId);
+            }
 
-            return doc;
+            return std::move(*doc);
         }
 
-        // There is not any document so try to load more from the source.
-        if (_loadingThreadId == kInvalidThreadId) {
+        stdx::unique_lock<Latch> lk(_mutex);
+
+        if (!_errorInLoadNextBatch.isOK()) {
+            uasserted(ErrorCodes::ExchangePassthrough,
+                      "Exchange failed due to an error on different thread.");
+        }
+
+        // The loading thread may have appended to our buffer since we last looked.
+        if (!buffer.isEmpty()) {
+            continue;
+        }
+
+        // There is not any document so try to load more from the source. The loading may still be
+        // attributed to us if it stopped on our buffer after we had already emptied it; an empty
+        // buffer has room, so we may as well load.
+        const auto loadingThreadId = _loadingThreadId.load();
+        if (loadingThreadId == kInvalidThreadId || loadingThreadId == consumerId) {
             LOGV2_DEBUG(
                 20896, 3, "A consumer {consumerId} begins loading", "consumerId"_attr = consumerId);
 
-            try {
-                // This consumer won the race and will fill the buffers.
-                _loadingThreadId = consumerId;
+            // This consumer won the race and will fill the buffers. The other consumers keep
+            // draining their buffers while we load, so the mutex is not held.
+            _loadingThreadId.store(consumerId);
+            lk.unlock();
 
+            try {
                 _pipeline->reattachToOperationContext(opCtx);
 
                 // This will return when some exchange buffer is full and we cannot make any forward
@@ -324,61 +348,122 @@ DocumentSource::GetNextResult Exchange::getNext(OperationContext* opCtx,
 
                 _pipeline->detachFromOperationContext();
 
+                lk.lock();
+
+                // A consumer disposed of while we were loading will never make room in its buffer.
+                if (fullConsumerId != kInvalidThreadId &&
+                    _consumers[fullConsumerId]->isDisposed()) {
+                    fullConsumerId = kInvalidThreadId;
+                }
+
                 // The loading cannot continue until the consumer with the full buffer consumes some
                 // documents.
-                _loadingThreadId = fullConsumerId;
+                _loadingThreadId.store(fullConsumerId);
 
                 // Wake up everybody and try to make some progress.
-                _haveBufferSpace.notify_all();
+                notifyConsumers();
             } catch (const DBException& ex) {
+                if (!lk.owns_lock()) {
+                    lk.lock();
+                }
                 _errorInLoadNextBatch = ex.toStatus();
+                _loadFailed.store(true);
 
                 // We have to wake up all other blocked threads so they can detect the error and
                 // fail too. They can be woken up only after _errorInLoadNextBatch has been set.
-                _haveBufferSpace.notify_all();
+                notifyConsumers();
 
                 throw;
             }
         } else {
-            // Some other consumer is already loading the buffers. There is nothing else we can do
-            // but wait.
-            MutexAndResourceLock mutexAndResourceLock(opCtx, std::move(lk), resourceYielder);
-            _haveBufferSpace.wait(mutexAndResourceLock);
-            lk = mutexAndResourceLock.releaseLockOwnership();
+            // Some other consumer is already loading the buffers, or the loading is blocked on a
+            // full buffer. There is nothing else we can do but wait. The flag is published before
+            // rechecking the buffer so that the loading thread either sees it and wakes us, or has
+            // already appended a document that the recheck finds.
+            buffer.consumerWaiting.store(true);
+            if (buffer.isEmpty()) {
+                MutexAndResourceLock mutexAndResourceLock(opCtx, std::move(lk), resourceYielder);
+                buffer.haveDocuments.wait(mutexAndResourceLock);
+                lk = mutexAndResourceLock.releaseLockOwnership();
+            }
+            buffer.consumerWaiting.store(false);
         }
     }
 }
 
+bool Exchange::appendDocument(size_t consumerId, DocumentSource::GetNextResult input) {
+    auto& buffer = *_consumers[consumerId];
+    const bool full = buffer.appendDocument(std::move(input), _maxBufferSize);
+
+    // Only a consumer that has gone to sleep on an empty buffer needs a signal. The mutex
+    // guarantees that it is already waiting by the time we notify.
+    if (buffer.consumerWaiting.swap(false)) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        buffer.haveDocuments.notify_all();
+    }
+
+    return full;
+}
+
 size_t Exchange::loadNextBatch() {
-    auto input = _pipeline->getSources().back()->getNext();
+    auto nextInput = [&] {
+        if (_pendingInput) {
+            auto input = std::move(*_pendingInput);
+            _pendingInput = boost::none;
+            return input;
+        }
+        return _pipeline->getSources().back()->getNext();
+    };
+
+    auto input = nextInput();
 
-    for (; input.isAdvanced(); input = _pipeline->getSources().back()->getNext()) {
-        // We have a document and we will deliver it to a consumer(s) based on the policy.
+    for (; input.isAdvanced(); input = nextInput()) {
+        // We have a document and we will deliver it to a consumer(s) based on the policy. If a
+        // target buffer has no free slot, the document is kept for the next batch and the loading
+        // waits on that consumer.
         switch (_policy) {
             case ExchangePolicyEnum::kBroadcast: {
-                bool full = false;
+                for (size_t idx = 0; idx < _consumers.size(); ++idx) {
+                    if (!_consumers[idx]->hasRoom()) {
+                        _pendingInput = std::move(input);
+                        return idx;
+                    }
+                }
+
+                size_t fullConsumerId = kInvalidThreadId;
                 // The document is sent to all consumers.
-                for (auto& c : _consumers) {
+                for (size_t idx = 0; idx < _consumers.size(); ++idx) {
                     // By default the Document is shallow copied. However, the broadcasted document
                     // can be used by multiple threads (consumers) and the Document is not thread
                     // safe. Hence we have to clone the Document.
                     auto copy = DocumentSource::GetNextResult(input.getDocument().clone());
-                    full = c->appendDocument(copy, _maxBufferSize);
+                    if (appendDocument(idx, std::move(copy)) &&
+                        fullConsumerId == kInvalidThreadId) {
+                        fullConsumerId = idx;
+                    }
                 }
 
-                if (full)
-                    return 0;
+                if (fullConsumerId != kInvalidThreadId)
+                    return fullConsumerId;
             } break;
             case ExchangePolicyEnum::kRoundRobin: {
                 size_t target = _roundRobinCounter;
+                if (!_consumers[target]->hasRoom()) {
+                    _pendingInput = std::move(input);
+                    return target;
+                }
                 _roundRobinCounter = (_roundRobinCounter + 1) % _consumers.size();
 
-                if (_consumers[target]->appendDocument(std::move(input), _maxBufferSize))
+                if (appendDocument(target, std::move(input)))
                     return target;
             } break;
             case ExchangePolicyEnum::kKeyRange: {
                 size_t target = getTargetConsumer(input.getDocument());
-                bool full = _consumers[target]->appendDocument(std::move(input), _maxBufferSize);
+                if (!_consumers[target]->hasRoom()) {
+                    _pendingInput = std::move(input);
+                    return target;
+                }
+                bool full = appendDocument(target, std::move(input));
                 if (full && _orderPreserving) {
                     // TODO send the high watermark here.
                 }
@@ -393,8 +478,8 @@ size_t Exchange::loadNextBatch() {
     invariant(input.isEOF());
 
     // We have reached the end so send EOS to all consumers.
-    for (auto& c : _consumers) {
-        c->appendDocument(input, _maxBufferSize);
+    for (size_t idx = 0; idx < _consumers.size(); ++idx) {
+        appendDocument(idx, input);
     }
 
     return kInvalidThreadId;
@@ -448,7 +533,7 @@ void Exchange::dispose(OperationContext* opCtx, size_t consumerId) {
     // If _errorInLoadNextBatch status is not OK then an exception was thrown. In that case the
     // throwing thread will do the dispose.
     if (!_errorInLoadNextBatch.isOK()) {
-        if (_loadingThreadId == consumerId) {
+        if (_loadingThreadId.load() == consumerId) {
             _pipeline->dispose(opCtx);
         }
     } else if (_disposeRunDown == getConsumers()) {
@@ -459,32 +544,57 @@ void Exchange::dispose(OperationContext* opCtx, size_t consumerId) {
     unblockLoading(consumerId);
 }
 
-DocumentSource::GetNextResult Exchange::ExchangeBuffer::getNext() {
-    invariant(!_buffer.empty());
+boost::optional<DocumentSource::GetNextResult> Exchange::ExchangeBuffer::tryGetNext() {
+    const auto head = _head.loadRelaxed();
+    if (head == _tail.load()) {
+        return boost::none;
+    }
 
-    auto result = std::move(_buffer.front());
-    _buffer.pop_front();
+    auto& slot = _slots[head % kCapacity];
+    auto result = std::move(*slot);
+    slot = boost::none;
 
     if (result.isAdvanced()) {
-        _bytesInBuffer -= result.getDocument().getApproximateSize();
+        _bytesInBuffer.subtractAndFetch(result.getDocument().getApproximateSize());
     }
 
+    // Publishing the new head hands the slot back to the producer.
+    _head.store(head + 1);
+
     return result;
 }
 
 bool Exchange::ExchangeBuffer::appendDocument(DocumentSource::GetNextResult input, size_t limit) {
     // If the buffer is disposed then we simply ignore any appends.
-    if (_disposed) {
+    if (_disposed.load()) {
+        return false;
+    }
+
+    const auto tail = _tail.loadRelaxed();
+    if (tail - _head.load() == kCapacity) {
+        // Documents are only appended while hasRoom(), so a buffer without any free slot already
+        // ends with an EOF and does not need another one.
+        invariant(input.isEOF());
         return false;
     }
 
     if (input.isAdvanced()) {
-        _bytesInBuffer += input.getDocument().getApproximateSize();
+        _bytesInBuffer.addAndFetch(input.getDocument().getApproximateSize());
     }
-    _buffer.push_back(std::move(input));
+    _slots[tail % kCapacity] = std::move(input);
+
+    // Publishing the new tail hands the slot over to the consumer.
+    _tail.store(tail + 1);
 
-    // The buffer is full.
-    return _bytesInBuffer >= limit;
+    // The buffer is full. A buffer disposed of concurrently never blocks the loading.
+    return _bytesInBuffer.load() >= limit && !_disposed.load();
+}
+
+void Exchange::ExchangeBuffer::dispose() {
+    invariant(!_disposed.load());
+    _disposed.store(true);
+    while (tryGetNext()) {
+    }
 }
 
 }  // namespace mongo
@@ -29,13 +29,14 @@
 
 #pragma once
 
-#include <deque>
+#include <boost/optional.hpp>
 #include <vector>
 
 #include "mongo/bson/ordering.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/exchange_spec_gen.h"
 #include "mongo/db/pipeline/field_path.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 
@@ -100,7 +101,8 @@ public:
      * by consumerId. Note that there is no such thing as being blocked by multiple consumers. It is
      * always one consumer that blocks the loading (i.e. the consumer's buffer is full and we can
      * not append new documents). The unblocking happens when a consumer consumes some documents
-     * from its buffer (i.e. making room for appends) or when a consumer is disposed.
+     * from its buffer (i.e. making room for appends) or when a consumer is disposed. The caller
+     * must hold '_mutex'.
      */
     void unblockLoading(size_t consumerId);
 
@@ -109,29 +111,72 @@ private:
 
     size_t getTargetConsumer(const Document& input);
 
+    /**
+     * Appends 'input' to the buffer of the consumer 'consumerId' and wakes the consumer if it is
+     * asleep waiting for documents. Returns true if the buffer is full.
+     */
+    bool appendDocument(size_t consumerId, DocumentSource::GetNextResult input);
+
+    /**
+     * Wakes every consumer blocked in getNext() so that it can recheck its buffer and the loading
+     * state. The caller must hold '_mutex'.
+     */
+    void notifyConsumers();
+
+    /**
+     * A single-producer single-consumer ring buffer of the documents routed to one consumer. The
+     * producer is whichever thread currently holds the loading role, which is only ever handed
+     * over under '_mutex', and the consumer is the thread running the consumer's
+     * DocumentSourceExchange. Neither side takes a lock to append or remove a document.
+     */
     class ExchangeBuffer {
     public:
+        // The number of documents a buffer can hold, in addition to the byte limit from the spec.
+        static constexpr size_t kCapacity = 1024;
+
+        ExchangeBuffer() : _slots(kCapacity) {}
+
+        /**
+         * Producer side. Returns true if a document can be appended while still leaving room for
+         * the EOF that ends the stream.
+         */
+        bool hasRoom() const {
+            return _disposed.load() || _tail.load() - _head.load() < kCapacity - 1;
+        }
         bool appendDocument(DocumentSource::GetNextResult input, size_t limit);
-        DocumentSource::GetNextResult getNext();
+
+        /**
+         * Consumer side. Returns boost::none if the buffer is empty.
+         */
+        boost::optional<DocumentSource::GetNextResult> tryGetNext();
         bool isEmpty() const {
-            return _buffer.empty();
+            return _head.load() == _tail.load();
         }
         /**
          * Mark the buffer associated with a consumer as disposed. After calling this method,
          * subsequent results that are appended to this buffer are instead discarded to prevent this
          * unused buffer from filling up and blocking progress on other threads.
          */
-        void dispose() {
-            invariant(!_disposed);
-            _disposed = true;
-            _buffer.clear();
-            _bytesInBuffer = 0;
+        void dispose();
+        bool isDisposed() const {
+            return _disposed.load();
         }
 
+        // Set by the consumer, under '_mutex', before it goes to sleep waiting for documents. The
+        // producer clears it and signals 'haveDocuments' when it appends to the buffer.
+        AtomicWord<bool> consumerWaiting{false};
+        stdx::condition_variable haveDocuments;
+
     private:
-        size_t _bytesInBuffer{0};
-        std::deque<DocumentSource::GetNextResult> _buffer;
-        bool _disposed{false};
+        std::vector<boost::optional<DocumentSource::GetNextResult>> _slots;
+
+        // Monotonic positions of the next slot to read and to write. '_head' is only written by
+        // the consumer and '_tail' only by the producer.
+        AtomicWord<size_t> _head{0};
+        AtomicWord<size_t> _tail{0};
+
+        AtomicWord<size_t> _bytesInBuffer{0};
+        AtomicWord<bool> _disposed{false};
     };
 
     // Keep a copy of the spec for serialization purposes.
@@ -169,19 +214,28 @@ private:
     // An input to the exchange operator
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
 
-    // Synchronization.
+    // Synchronization. The mutex guards handing over the loading role and putting consumers to
+    // sleep; documents move through the per-consumer buffers without it.
     Mutex _mutex = MONGO_MAKE_LATCH("Exchange::_mutex");
-    stdx::condition_variable _haveBufferSpace;
 
-    // A thread that is currently loading the exchange buffers.
-    size_t _loadingThreadId{kInvalidThreadId};
+    // A thread that is currently loading the exchange buffers. Only changed under '_mutex', but
+    // consumers read it without the mutex after taking a document from their buffer.
+    AtomicWord<size_t> _loadingThreadId{kInvalidThreadId};
 
     // A status indicating that the exception was thrown during loadNextBatch(). Once in the failed
     // state all other producing threads will fail too.
     Status _errorInLoadNextBatch{Status::OK()};
 
+    // Mirrors '!_errorInLoadNextBatch.isOK()' so that consumers can check it without '_mutex'.
+    AtomicWord<bool> _loadFailed{false};
+
+    // The following are only accessed by the thread holding the loading role.
     size_t _roundRobinCounter{0};
 
+    // A document read from the input that could not be appended because its target buffer had no
+    // free slot. It is delivered first by the next loadNextBatch().
+    boost::optional<DocumentSource::GetNextResult> _pendingInput;
+
     // A rundown counter of consumers disposing of the pipelines. Only the last consumer will
     // dispose of the 'inner' exchange pipeline.
     size_t _disposeRunDown{0};
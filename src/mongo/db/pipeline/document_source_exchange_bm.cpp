@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/process_interface/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.exchangeBm");
+const int kNumDocs = 100 * 1000;
+
+/**
+ * Pushes 'kNumDocs' documents through an exchange with the given policy and state.range(0)
+ * consumers, each of which drains its output on its own thread.
+ */
+void runExchange(benchmark::State& state, ExchangePolicyEnum policy) {
+    const size_t nConsumers = state.range(0);
+
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    for (auto keepRunning : state) {
+        state.PauseTiming();
+        auto expCtx = make_intrusive<ExpressionContext>(opCtx.get(), nullptr, kNss);
+        expCtx->mongoProcessInterface = std::make_shared<StubMongoProcessInterface>();
+
+        auto source = DocumentSourceMock::createForTest(expCtx);
+        for (int i = 0; i < kNumDocs; ++i) {
+            source->emplace_back(Document{{"a", i}, {"b", "aaaaaaaaaaaaaaaaaaaaaaaaaaa"_sd}});
+        }
+
+        ExchangeSpec spec;
+        spec.setPolicy(policy);
+        spec.setConsumers(nConsumers);
+        spec.setBufferSize(1024 * 1024);
+        boost::intrusive_ptr<Exchange> exchange =
+            new Exchange(std::move(spec), Pipeline::create({source}, expCtx));
+        state.ResumeTiming();
+
+        std::vector<stdx::thread> consumers;
+        for (size_t id = 0; id < nConsumers; ++id) {
+            consumers.emplace_back([&, id] {
+                auto client = serviceContext.getServiceContext()->makeClient("exchange consumer");
+                auto consumerOpCtx = client->makeOperationContext();
+                while (exchange->getNext(consumerOpCtx.get(), id, nullptr).isAdvanced()) {
+                }
+            });
+        }
+        for (auto& consumer : consumers) {
+            consumer.join();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * kNumDocs);
+}
+
+void BM_ExchangeRoundRobin(benchmark::State& state) {
+    runExchange(state, ExchangePolicyEnum::kRoundRobin);
+}
+
+void BM_ExchangeBroadcast(benchmark::State& state) {
+    runExchange(state, ExchangePolicyEnum::kBroadcast);
+}
+
+BENCHMARK(BM_ExchangeRoundRobin)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+BENCHMARK(BM_ExchangeBroadcast)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
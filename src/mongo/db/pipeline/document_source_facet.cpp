@@ -39,12 +39,17 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
 #include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/client.h"
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/db/pipeline/document_source_tee_consumer.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/javascript_execution.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
 
@@ -144,16 +149,20 @@ DocumentSource::GetNextResult DocumentSourceFacet::doGetNext() {
     }
 
     vector<vector<Value>> results(_facets.size());
-    bool allPipelinesEOF = false;
-    while (!allPipelinesEOF) {
-        allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
-        for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
-            const auto& pipeline = _facets[facetId].pipeline;
-            auto next = pipeline->getSources().back()->getNext();
-            for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
-                results[facetId].emplace_back(next.releaseDocument());
+    if (canRunConcurrently()) {
+        runConcurrently(&results);
+    } else {
+        bool allPipelinesEOF = false;
+        while (!allPipelinesEOF) {
+            allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
+            for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+                const auto& pipeline = _facets[facetId].pipeline;
+                auto next = pipeline->getSources().back()->getNext();
+                for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+                    results[facetId].emplace_back(next.releaseDocument());
+                }
+                allPipelinesEOF = allPipelinesEOF && next.isEOF();
             }
-            allPipelinesEOF = allPipelinesEOF && next.isEOF();
         }
     }
 
@@ -166,6 +175,121 @@ DocumentSource::GetNextResult DocumentSourceFacet::doGetNext() {
     return resultDoc.freeze();
 }
 
+bool DocumentSourceFacet::canRunConcurrently() const {
+    if (internalQueryFacetMaxConcurrentPipelines.load() <= 1 || _facets.size() <= 1 ||
+        pExpCtx->inMongos || !pExpCtx->opCtx) {
+        return false;
+    }
+
+    for (auto&& facet : _facets) {
+        stdx::unordered_set<NamespaceString> involvedCollections;
+        for (auto&& source : facet.pipeline->getSources()) {
+            source->addInvolvedCollections(&involvedCollections);
+        }
+        if (!involvedCollections.empty()) {
+            return false;
+        }
+
+        for (auto&& stageSpec : facet.pipeline->serializeToBson()) {
+            if (JsExecution::usedBy(stageSpec)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void DocumentSourceFacet::runConcurrently(vector<vector<Value>>* results) {
+    // Every sub-pipeline is rebuilt with an ExpressionContext of its own, which holds the
+    // OperationContext of the thread running it. The original sub-pipelines have not run yet, and
+    // must not be disposed of since that would detach their consumers from the TeeBuffer.
+    for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+        auto& facet = _facets[facetId];
+        auto expCtx = pExpCtx->copyWith(pExpCtx->ns, pExpCtx->uuid);
+        auto pipeline = Pipeline::parse(facet.pipeline->serializeToBson(), expCtx);
+        pipeline->optimizePipeline();
+        pipeline->addInitialSource(DocumentSourceTeeConsumer::create(expCtx, facetId, _teeBuffer));
+
+        facet.pipeline.get_deleter().dismissDisposal();
+        facet.pipeline = std::move(pipeline);
+    }
+    _teeBuffer->enableConcurrentConsumers();
+
+    const size_t numThreads =
+        std::min(size_t(internalQueryFacetMaxConcurrentPipelines.load()), _facets.size());
+    const long long maxMemoryBytes = internalQueryFacetConcurrentMaxMemoryBytes.load();
+    auto parentOpCtx = pExpCtx->opCtx;
+    auto serviceContext = parentOpCtx->getServiceContext();
+    AtomicWord<long long> resultBytes{0};
+
+    bool moreInput = true;
+    while (moreInput) {
+        moreInput = _teeBuffer->loadNextConcurrentBatch();
+
+        // The threads take the next sub-pipeline which has not consumed this batch yet.
+        AtomicWord<unsigned> nextFacetId{0};
+        std::vector<Status> statuses(_facets.size(), Status::OK());
+        auto consumeBatch = [&] {
+            ThreadClient tc("FacetConsumer", serviceContext);
+            auto opCtx = tc->makeOperationContext();
+            if (parentOpCtx->hasDeadline()) {
+                opCtx->setDeadlineByDate(parentOpCtx->getDeadline(),
+                                         parentOpCtx->getTimeoutError());
+            }
+
+            // The operation context of this thread has the deadline of the operation running this
+            // $facet, but is not killed along with it, so the kill status is checked separately.
+            auto checkForInterrupt = [&] {
+                if (auto killCode = parentOpCtx->getKillStatus(); killCode != ErrorCodes::OK) {
+                    uasserted(killCode, "The operation running this $facet was killed");
+                }
+                opCtx->checkForInterrupt();
+            };
+
+            for (size_t facetId = nextFacetId.fetchAndAdd(1); facetId < _facets.size();
+                 facetId = nextFacetId.fetchAndAdd(1)) {
+                const auto& pipeline = _facets[facetId].pipeline;
+                pipeline->getContext()->opCtx = opCtx.get();
+                try {
+                    checkForInterrupt();
+                    auto next = pipeline->getSources().back()->getNext();
+                    for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+                        checkForInterrupt();
+                        uassert(5021430,
+                                str::stream()
+                                    << "$facet exceeded its memory limit of " << maxMemoryBytes
+                                    << " bytes while running its sub-pipelines concurrently",
+                                resultBytes.addAndFetch(next.getDocument().getApproximateSize()) <=
+                                    maxMemoryBytes);
+                        (*results)[facetId].emplace_back(next.releaseDocument());
+                    }
+                } catch (const DBException& ex) {
+                    statuses[facetId] = ex.toStatus();
+                }
+                pipeline->getContext()->opCtx = nullptr;
+            }
+        };
+
+        _teeBuffer->setConsumersRunning(true);
+        std::vector<stdx::thread> threads;
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads.emplace_back(consumeBatch);
+        }
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+        _teeBuffer->setConsumersRunning(false);
+
+        // The sub-pipelines are disposed of and explained under the operation running this $facet.
+        for (auto&& facet : _facets) {
+            facet.pipeline->getContext()->opCtx = pExpCtx->opCtx;
+        }
+        for (auto&& status : statuses) {
+            uassertStatusOK(status);
+        }
+    }
+}
+
 Value DocumentSourceFacet::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument serialized;
     for (auto&& facet : _facets) {
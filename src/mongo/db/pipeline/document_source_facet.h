@@ -153,6 +153,20 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Returns true if the sub-pipelines may consume the input on threads of their own. Such
+     * sub-pipelines must not read from storage or run JavaScript, since both are bound to the
+     * operation running this $facet.
+     */
+    bool canRunConcurrently() const;
+
+    /**
+     * Runs the sub-pipelines to completion on concurrent threads, appending the results of each to
+     * the corresponding entry of 'results'. This thread loads the input one batch at a time into
+     * the TeeBuffer, and waits for every sub-pipeline to consume a batch before loading the next.
+     */
+    void runConcurrently(std::vector<std::vector<Value>>* results);
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
@@ -44,8 +44,10 @@
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -476,6 +478,75 @@ TEST_F(DocumentSourceFacetTest, ShouldPropagateDisposeThroughToSource) {
     ASSERT_TRUE(mockSource->isDisposed);
 }
 
+TEST_F(DocumentSourceFacetTest, ShouldProduceTheSameResultsWhenRunningConcurrently) {
+    auto ctx = getExpCtx();
+
+    // Use a small buffer so that the input is consumed over several batches.
+    const auto originalBufferSize = internalQueryFacetBufferSizeBytes.load();
+    internalQueryFacetBufferSizeBytes.store(1000);
+    ON_BLOCK_EXIT([&] { internalQueryFacetBufferSizeBytes.store(originalBufferSize); });
+
+    const auto spec = fromjson(
+        "{$facet: {byKey: [{$group: {_id: '$key', total: {$sum: '$value'}}}, {$sort: {_id: 1}}],"
+        " large: [{$match: {value: {$gte: 450}}}, {$project: {_id: 0, value: 1}}],"
+        " first: [{$limit: 3}], skipped: [{$skip: 497}], counted: [{$count: 'n'}]}}");
+
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 500; ++i) {
+        inputs.push_back(Document{{"_id", i}, {"key", i % 7}, {"value", i}});
+    }
+
+    auto runFacet = [&](int concurrentPipelines) {
+        const auto originalPipelines = internalQueryFacetMaxConcurrentPipelines.load();
+        internalQueryFacetMaxConcurrentPipelines.store(concurrentPipelines);
+        ON_BLOCK_EXIT([&] { internalQueryFacetMaxConcurrentPipelines.store(originalPipelines); });
+
+        auto facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+        auto mock = DocumentSourceMock::createForTest(inputs, ctx);
+        facetStage->setSource(mock.get());
+
+        auto output = facetStage->getNext();
+        ASSERT_TRUE(output.isAdvanced());
+        ASSERT_TRUE(facetStage->getNext().isEOF());
+        return output.releaseDocument();
+    };
+
+    auto serialOutput = runFacet(1);
+    ASSERT_EQ(serialOutput["first"].getArrayLength(), 3UL);
+    ASSERT_EQ(serialOutput["skipped"].getArrayLength(), 3UL);
+    ASSERT_DOCUMENT_EQ(runFacet(3), serialOutput);
+}
+
+/**
+ * Runs a $facet whose sub-pipelines may run concurrently on the given input.
+ */
+void runConcurrentFacet(const boost::intrusive_ptr<ExpressionContext>& ctx) {
+    const auto originalPipelines = internalQueryFacetMaxConcurrentPipelines.load();
+    internalQueryFacetMaxConcurrentPipelines.store(2);
+    ON_BLOCK_EXIT([&] { internalQueryFacetMaxConcurrentPipelines.store(originalPipelines); });
+
+    const auto spec = fromjson("{$facet: {a: [{$skip: 1}], b: [{$limit: 1}]}}");
+    auto facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+    auto mock =
+        DocumentSourceMock::createForTest({Document{{"_id", 0}}, Document{{"_id", 1}}}, ctx);
+    facetStage->setSource(mock.get());
+    facetStage->getNext();
+}
+
+TEST_F(DocumentSourceFacetTest, ConcurrentPipelinesShouldStopWhenTheOperationTimesOut) {
+    // The sub-pipelines run on operation contexts of their own, which take the deadline of the
+    // operation running the $facet.
+    getOpCtx()->setDeadlineAfterNowBy(Milliseconds{0}, ErrorCodes::MaxTimeMSExpired);
+    ASSERT_THROWS_CODE(
+        runConcurrentFacet(getExpCtx()), AssertionException, ErrorCodes::MaxTimeMSExpired);
+}
+
+TEST_F(DocumentSourceFacetTest, ConcurrentPipelinesShouldStopWhenTheOperationIsKilled) {
+    getOpCtx()->markKilled(ErrorCodes::Interrupted);
+    ASSERT_THROWS_CODE(
+        runConcurrentFacet(getExpCtx()), AssertionException, ErrorCodes::Interrupted);
+}
+
 // TODO: DocumentSourceFacet will have to propagate pauses if we ever allow nested $facets.
 DEATH_TEST_REGEX_F(DocumentSourceFacetTest,
                    ShouldFailIfGivenPausedInput,
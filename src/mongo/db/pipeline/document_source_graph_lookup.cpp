@@ -31,6 +31,7 @@
 
 #include "mongo/db/pipeline/document_source_graph_lookup.h"
 
+#include <boost/filesystem/operations.hpp>
 #include <memory>
 
 #include "mongo/base/init.h"
@@ -44,6 +45,8 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/destructor_guard.h"
 
 namespace mongo {
 
@@ -51,6 +54,11 @@ namespace {
 bool foreignShardedLookupAllowed() {
     return getTestCommandsEnabled() && internalQueryAllowShardedLookup.load();
 }
+
+std::string nextFileName() {
+    static AtomicWord<unsigned> graphLookupFileCounter;
+    return "extsort-graph-lookup." + std::to_string(graphLookupFileCounter.fetchAndAdd(1));
+}
 }  // namespace
 
 using boost::intrusive_ptr;
@@ -106,11 +114,9 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::doGetNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (hasVisited()) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(popVisited()));
     }
 
     MutableDocument output(*_input);
@@ -129,7 +135,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        if (!hasVisited()) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -145,7 +151,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!hasVisited()) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -159,13 +165,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(popVisited()));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
@@ -176,6 +180,30 @@ void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
     _visited.clear();
+    removeSpillFile();
+}
+
+Document DocumentSourceGraphLookUp::popVisited() {
+    if (!_visited.empty()) {
+        auto it = _visited.begin();
+        auto result = std::move(it->second);
+        _visited.erase(it);
+        return result;
+    }
+
+    // Everything held in memory has been returned, so read back the documents that were spilled.
+    invariant(!_spilledVisited.empty());
+    auto run = _spilledVisited.front();
+    auto result = run->next().second;
+    if (!run->more()) {
+        run->closeSource();
+        _spilledVisited.erase(_spilledVisited.begin());
+        if (_spilledVisited.empty()) {
+            // Every document discovered for the current input has now been returned.
+            removeSpillFile();
+        }
+    }
+    return result;
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
@@ -189,48 +217,21 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
         }
         shouldPerformAnotherQuery = false;
 
-        // Check whether each key in the frontier exists in the cache or needs to be queried.
-        auto cached = pExpCtx->getDocumentComparator().makeUnorderedDocumentSet();
-        auto matchStage = makeMatchStageFromFrontier(&cached);
-
-        ValueUnorderedSet queried = pExpCtx->getValueComparator().makeUnorderedValueSet();
-        _frontier.swap(queried);
+        // Take the values on the frontier for this level of the search, including any which were
+        // spilled. Expanding them populates '_frontier' for the next iteration of search.
+        ValueUnorderedSet frontier = pExpCtx->getValueComparator().makeUnorderedValueSet();
+        _frontier.swap(frontier);
         _frontierUsageBytes = 0;
+        auto spilledFrontier = std::move(_spilledFrontier);
+        _spilledFrontier.clear();
 
-        // Process cached values, populating '_frontier' for the next iteration of search.
-        while (!cached.empty()) {
-            auto doc = *cached.begin();
-            cached.erase(cached.begin());
+        // Query for the frontier a batch at a time. This bounds the size of each query and lets the
+        // results of one batch be processed, and possibly spilled, before the next is issued.
+        ValueUnorderedSet batch = pExpCtx->getValueComparator().makeUnorderedValueSet();
+        while (takeFrontierBatch(&frontier, &spilledFrontier, &batch)) {
             shouldPerformAnotherQuery =
-                addToVisitedAndFrontier(std::move(doc), depth) || shouldPerformAnotherQuery;
-            checkMemoryUsage();
-        }
-
-        if (matchStage) {
-            // Query for all keys that were in the frontier and not in the cache, populating
-            // '_frontier' for the next iteration of search.
-
-            // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-            _fromPipeline.back() = *matchStage;
-            MakePipelineOptions pipelineOpts;
-            pipelineOpts.optimize = true;
-            pipelineOpts.attachCursorSource = true;
-            // By default, $graphLookup doesn't support a sharded 'from' collection.
-            pipelineOpts.allowTargetingShards = internalQueryAllowShardedLookup.load();
-            _variables.copyToExpCtx(_variablesParseState, _fromExpCtx.get());
-            auto pipeline = Pipeline::makePipeline(_fromPipeline, _fromExpCtx, pipelineOpts);
-            while (auto next = pipeline->getNext()) {
-                uassert(40271,
-                        str::stream()
-                            << "Documents in the '" << _from.ns()
-                            << "' namespace must contain an _id for de-duplication in $graphLookup",
-                        !(*next)["_id"].missing());
-
-                shouldPerformAnotherQuery =
-                    addToVisitedAndFrontier(*next, depth) || shouldPerformAnotherQuery;
-                addToCache(std::move(*next), queried);
-            }
-            checkMemoryUsage();
+                expandFrontierBatch(std::move(batch), depth) || shouldPerformAnotherQuery;
+            batch = pExpCtx->getValueComparator().makeUnorderedValueSet();
         }
 
         ++depth;
@@ -239,12 +240,90 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 
     _frontier.clear();
     _frontierUsageBytes = 0;
+    for (auto&& run : _spilledFrontier) {
+        run->closeSource();
+    }
+    _spilledFrontier.clear();
+
+    if (_spilledVisited.empty()) {
+        // Only the frontier was spilled, and none of it is needed any more.
+        removeSpillFile();
+    }
+}
+
+bool DocumentSourceGraphLookUp::takeFrontierBatch(
+    ValueUnorderedSet* frontier,
+    std::vector<std::shared_ptr<SpillIterator>>* spilledFrontier,
+    ValueUnorderedSet* batch) {
+    const size_t batchSize = internalDocumentSourceGraphLookupFrontierBatchSize.load();
+    while (batch->size() < batchSize && !frontier->empty()) {
+        batch->insert(*frontier->begin());
+        frontier->erase(frontier->begin());
+    }
+
+    while (batch->size() < batchSize && !spilledFrontier->empty()) {
+        auto& run = spilledFrontier->front();
+        if (!run->more()) {
+            run->closeSource();
+            spilledFrontier->erase(spilledFrontier->begin());
+            continue;
+        }
+        batch->insert(run->next().first);
+    }
+
+    return !batch->empty();
+}
+
+bool DocumentSourceGraphLookUp::expandFrontierBatch(ValueUnorderedSet batch, long long depth) {
+    bool shouldPerformAnotherQuery = false;
+
+    // Check whether each key in the batch exists in the cache or needs to be queried.
+    auto cached = pExpCtx->getDocumentComparator().makeUnorderedDocumentSet();
+    auto matchStage = makeMatchStageFromFrontier(&batch, &cached);
+
+    // Process cached values, populating '_frontier' for the next iteration of search.
+    while (!cached.empty()) {
+        auto doc = *cached.begin();
+        cached.erase(cached.begin());
+        shouldPerformAnotherQuery =
+            addToVisitedAndFrontier(std::move(doc), depth) || shouldPerformAnotherQuery;
+        checkMemoryUsage();
+    }
+
+    if (matchStage) {
+        // Query for all keys that were in the batch and not in the cache, populating '_frontier'
+        // for the next iteration of search.
+
+        // We've already allocated space for the trailing $match stage in '_fromPipeline'.
+        _fromPipeline.back() = *matchStage;
+        MakePipelineOptions pipelineOpts;
+        pipelineOpts.optimize = true;
+        pipelineOpts.attachCursorSource = true;
+        // By default, $graphLookup doesn't support a sharded 'from' collection.
+        pipelineOpts.allowTargetingShards = internalQueryAllowShardedLookup.load();
+        _variables.copyToExpCtx(_variablesParseState, _fromExpCtx.get());
+        auto pipeline = Pipeline::makePipeline(_fromPipeline, _fromExpCtx, pipelineOpts);
+        while (auto next = pipeline->getNext()) {
+            uassert(40271,
+                    str::stream()
+                        << "Documents in the '" << _from.ns()
+                        << "' namespace must contain an _id for de-duplication in $graphLookup",
+                    !(*next)["_id"].missing());
+
+            shouldPerformAnotherQuery =
+                addToVisitedAndFrontier(*next, depth) || shouldPerformAnotherQuery;
+            addToCache(std::move(*next), batch);
+            checkMemoryUsage();
+        }
+    }
+
+    return shouldPerformAnotherQuery;
 }
 
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (isVisited(id)) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -292,18 +371,12 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
 }
 
 boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
-    DocumentUnorderedSet* cached) {
-    // Add any cached values to 'cached' and remove them from '_frontier'.
-    for (auto it = _frontier.begin(); it != _frontier.end();) {
+    ValueUnorderedSet* frontier, DocumentUnorderedSet* cached) {
+    // Add any cached values to 'cached' and remove them from 'frontier'.
+    for (auto it = frontier->begin(); it != frontier->end();) {
         if (auto entry = _cache[*it]) {
             cached->insert(entry->begin(), entry->end());
-            size_t valueSize = it->getApproximateSize();
-            _frontier.erase(it++);
-
-            // If the cached value increased in size while in the cache, we don't want to underflow
-            // '_frontierUsageBytes'.
-            invariant(valueSize <= _frontierUsageBytes);
-            _frontierUsageBytes -= valueSize;
+            frontier->erase(it++);
         } else {
             ++it;
         }
@@ -328,7 +401,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
                     BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
                     {
                         BSONArrayBuilder in(subObj.subarrayStart("$in"));
-                        for (auto&& value : _frontier) {
+                        for (auto&& value : *frontier) {
                             in << value;
                         }
                     }
@@ -337,7 +410,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
         }
     }
 
-    return _frontier.empty() ? boost::none : boost::optional<BSONObj>(match.obj());
+    return frontier->empty() ? boost::none : boost::optional<BSONObj>(match.obj());
 }
 
 void DocumentSourceGraphLookUp::performSearch() {
@@ -403,13 +476,84 @@ Pipeline::SourceContainer::iterator DocumentSourceGraphLookUp::doOptimizeAt(
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    if (_allowDiskUse && (_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes) {
+        if (!_frontier.empty()) {
+            spillFrontier();
+        }
+        if (!_visited.empty()) {
+            spillVisited();
+        }
+    }
+
     uassert(40099,
             "$graphLookup reached maximum memory consumption",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
     _cache.evictDownTo(_maxMemoryUsageBytes - _frontierUsageBytes - _visitedUsageBytes);
 }
 
+void DocumentSourceGraphLookUp::spillFrontier() {
+    auto writer = makeSpillWriter();
+    for (auto&& value : _frontier) {
+        writer->addAlreadySorted(value, Document());
+    }
+    _spilledFrontier.push_back(finishSpillWriter(writer.get()));
+
+    _frontier.clear();
+    _frontierUsageBytes = 0;
+}
+
+void DocumentSourceGraphLookUp::spillVisited() {
+    auto writer = makeSpillWriter();
+    for (auto&& [id, doc] : _visited) {
+        writer->addAlreadySorted(id, doc);
+        _spilledVisitedIds.insert(id);
+        _spilledVisitedIdsUsageBytes += id.getApproximateSize();
+    }
+    _spilledVisited.push_back(finishSpillWriter(writer.get()));
+
+    _visited.clear();
+    _visitedUsageBytes = _spilledVisitedIdsUsageBytes;
+}
+
+std::unique_ptr<DocumentSourceGraphLookUp::SpillWriter>
+DocumentSourceGraphLookUp::makeSpillWriter() {
+    if (_spillFileName.empty()) {
+        _spillFileName = pExpCtx->tempDir + "/" + nextFileName();
+        _nextSpillFileOffset = 0;
+    }
+    _usedDisk = true;
+    return std::make_unique<SpillWriter>(
+        SortOptions().TempDir(pExpCtx->tempDir), _spillFileName, _nextSpillFileOffset);
+}
+
+std::shared_ptr<DocumentSourceGraphLookUp::SpillIterator>
+DocumentSourceGraphLookUp::finishSpillWriter(SpillWriter* writer) {
+    std::shared_ptr<SpillIterator> run(writer->done());
+    _nextSpillFileOffset = writer->getFileEndOffset();
+    run->openSource();
+    return run;
+}
+
+void DocumentSourceGraphLookUp::removeSpillFile() {
+    for (auto&& run : _spilledFrontier) {
+        DESTRUCTOR_GUARD(run->closeSource());
+    }
+    _spilledFrontier.clear();
+    for (auto&& run : _spilledVisited) {
+        DESTRUCTOR_GUARD(run->closeSource());
+    }
+    _spilledVisited.clear();
+    _spilledVisitedIds.clear();
+    _spilledVisitedIdsUsageBytes = 0;
+
+    if (_spillFileName.empty()) {
+        return;
+    }
+    DESTRUCTOR_GUARD(boost::filesystem::remove(_spillFileName));
+    _spillFileName.clear();
+    _nextSpillFileOffset = 0;
+}
+
 void DocumentSourceGraphLookUp::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     // Serialize default options.
@@ -477,8 +621,11 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(internalDocumentSourceGraphLookupMaxMemoryBytes.load()),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _spilledVisitedIds(ValueComparator::kInstance.makeUnorderedValueSet()),
+      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos),
       _cache(pExpCtx->getValueComparator()),
       _unwind(unwindSrc),
       _variables(expCtx->variables),
@@ -493,6 +640,10 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
     _fromPipeline.push_back(BSON("$match" << BSONObj()));
 }
 
+DocumentSourceGraphLookUp::~DocumentSourceGraphLookUp() {
+    removeSpillFile();
+}
+
 intrusive_ptr<DocumentSourceGraphLookUp> DocumentSourceGraphLookUp::create(
     const intrusive_ptr<ExpressionContext>& expCtx,
     NamespaceString fromNs,
@@ -626,3 +777,6 @@ void DocumentSourceGraphLookUp::addInvolvedCollections(
     }
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
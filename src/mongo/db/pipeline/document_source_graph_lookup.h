@@ -29,11 +29,16 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -91,11 +96,15 @@ public:
      */
     GetModPathsReturn getModifiedPaths() const final;
 
+    bool usedDisk() final {
+        return _usedDisk;
+    }
+
     StageConstraints constraints(Pipeline::SplitState pipeState) const final {
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      HostTypeRequirement::kPrimaryShard,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     DiskUseRequirement::kWritesTmpData,
                                      FacetRequirement::kAllowed,
                                      TransactionRequirement::kAllowed,
                                      LookupRequirement::kAllowed,
@@ -136,6 +145,8 @@ public:
     static boost::intrusive_ptr<DocumentSource> createFromBson(
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
+    ~DocumentSourceGraphLookUp();
+
 protected:
     GetNextResult doGetNext() final;
     void doDispose() final;
@@ -147,6 +158,9 @@ protected:
                                                      Pipeline::SourceContainer* container) final;
 
 private:
+    using SpillWriter = SortedFileWriter<Value, Document>;
+    using SpillIterator = SortIteratorInterface<Value, Document>;
+
     DocumentSourceGraphLookUp(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         NamespaceString from,
@@ -166,14 +180,31 @@ private:
 
     /**
      * Prepares the query to execute on the 'from' collection wrapped in a $match by using the
-     * contents of '_frontier'.
+     * contents of 'frontier', a batch of values taken from '_frontier'.
      *
-     * Fills 'cached' with any values that were retrieved from the cache.
+     * Fills 'cached' with any values that were retrieved from the cache, and removes those values
+     * from 'frontier'.
      *
      * Returns boost::none if no query is necessary, i.e., all values were retrieved from the cache.
      * Otherwise, returns a query object.
      */
-    boost::optional<BSONObj> makeMatchStageFromFrontier(DocumentUnorderedSet* cached);
+    boost::optional<BSONObj> makeMatchStageFromFrontier(ValueUnorderedSet* frontier,
+                                                        DocumentUnorderedSet* cached);
+
+    /**
+     * Moves up to 'internalDocumentSourceGraphLookupFrontierBatchSize' values from 'frontier', or
+     * from 'spilledFrontier' once 'frontier' is empty, into 'batch'. Returns false if there were no
+     * values left to move.
+     */
+    bool takeFrontierBatch(ValueUnorderedSet* frontier,
+                           std::vector<std::shared_ptr<SpillIterator>>* spilledFrontier,
+                           ValueUnorderedSet* batch);
+
+    /**
+     * Queries the 'from' collection for the documents connected to the values in 'batch', which
+     * are at the given 'depth' of the search. Returns whether any new documents were visited.
+     */
+    bool expandFrontierBatch(ValueUnorderedSet batch, long long depth);
 
     /**
      * If we have internalized a $unwind, getNext() dispatches to this function.
@@ -201,10 +232,59 @@ private:
 
     /**
      * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'. If disk use
+     * is allowed, the contents of '_visited' and '_frontier' are written to disk rather than
+     * exceeding the limit.
      */
     void checkMemoryUsage();
 
+    /**
+     * Writes the values in '_frontier' to the spill file, to be queried for by the next level of
+     * the search.
+     */
+    void spillFrontier();
+
+    /**
+     * Writes the documents in '_visited' to the spill file, remembering only their '_id's so that
+     * they are not visited again.
+     */
+    void spillVisited();
+
+    /**
+     * Returns a writer which appends to the spill file, creating the file if necessary.
+     */
+    std::unique_ptr<SpillWriter> makeSpillWriter();
+
+    /**
+     * Finishes writing with 'writer', returning an iterator over the documents it wrote.
+     */
+    std::shared_ptr<SpillIterator> finishSpillWriter(SpillWriter* writer);
+
+    void removeSpillFile();
+
+    /**
+     * Returns true if the search for the current input discovered any documents which have not yet
+     * been returned.
+     */
+    bool hasVisited() const {
+        return !_visited.empty() || !_spilledVisited.empty();
+    }
+
+    /**
+     * Removes and returns one of the documents discovered by the search for the current input.
+     * Must only be called if hasVisited() is true.
+     */
+    Document popVisited();
+
+    /**
+     * Returns true if a document with the given '_id' was visited by the search for the current
+     * input.
+     */
+    bool isVisited(const Value& id) const {
+        return _visited.find(id) != _visited.end() ||
+            _spilledVisitedIds.find(id) != _spilledVisitedIds.end();
+    }
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -230,20 +310,38 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    const size_t _maxMemoryUsageBytes;
 
-    // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
+    // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'. The '_id's of spilled
+    // documents remain in memory, and are accounted for in '_visitedUsageBytes'.
     size_t _visitedUsageBytes = 0;
     size_t _frontierUsageBytes = 0;
 
     // Only used during the breadth-first search, tracks the set of values on the current frontier.
     ValueUnorderedSet _frontier;
 
+    // Values of the frontier which have been written to disk, in runs of the spill file.
+    std::vector<std::shared_ptr<SpillIterator>> _spilledFrontier;
+
     // Tracks nodes that have been discovered for a given input. Keys are the '_id' value of the
     // document from the foreign collection, value is the document itself.  The keys are compared
     // using the simple collation.
     ValueUnorderedMap<Document> _visited;
 
+    // Nodes which have been discovered for a given input but written to disk. The '_id's of these
+    // documents are kept in memory, and the documents are read back from the spill file once
+    // '_visited' has been drained.
+    ValueUnorderedSet _spilledVisitedIds;
+    size_t _spilledVisitedIdsUsageBytes = 0;
+    std::vector<std::shared_ptr<SpillIterator>> _spilledVisited;
+
+    // If disk use is allowed, '_frontier' and '_visited' are written to '_spillFileName' instead of
+    // exceeding '_maxMemoryUsageBytes'. Each spill appends a run at '_nextSpillFileOffset'.
+    const bool _allowDiskUse;
+    std::string _spillFileName;
+    std::streampos _nextSpillFileOffset = 0;
+    bool _usedDisk = false;
+
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
     LookupSetCache _cache;
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <set>
 
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/document_value/document_value_test_util.h"
@@ -38,8 +39,11 @@
 #include "mongo/db/pipeline/document_source_graph_lookup.h"
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/process_interface/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -613,5 +617,99 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+/**
+ * Makes a graph in which the document with _id 0 connects to 'numLeaves' padded leaf documents,
+ * which together are much larger than 'internalDocumentSourceGraphLookupMaxMemoryBytes' allows.
+ */
+std::deque<DocumentSource::GetNextResult> makeWideGraph(int numLeaves) {
+    std::vector<Value> leafIds;
+    for (int i = 1; i <= numLeaves; ++i) {
+        leafIds.push_back(Value(i));
+    }
+
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    fromContents.push_back(Document{{"_id", 0}, {"to", std::move(leafIds)}});
+    for (int i = 1; i <= numLeaves; ++i) {
+        fromContents.push_back(Document{{"_id", i}, {"padding", std::string(200, 'x')}});
+    }
+    return fromContents;
+}
+
+boost::intrusive_ptr<DocumentSourceGraphLookUp> makeWideGraphLookup(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    int numLeaves,
+    DocumentSourceMock* inputMock) {
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(makeWideGraph(numLeaves));
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx.get(), "startVal"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock);
+    return graphLookupStage;
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillVisitedAndFrontierToDiskWhenAllowed) {
+    const auto originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    const auto originalBatchSize = internalDocumentSourceGraphLookupFrontierBatchSize.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(6 * 1024);
+    internalDocumentSourceGraphLookupFrontierBatchSize.store(7);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory);
+        internalDocumentSourceGraphLookupFrontierBatchSize.store(originalBatchSize);
+    });
+
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const int numLeaves = 200;
+    auto inputMock = DocumentSourceMock::createForTest(
+        {Document{{"_id", 0}, {"startVal", 0}}, Document{{"_id", 1}, {"startVal", 0}}}, expCtx);
+    auto graphLookupStage = makeWideGraphLookup(expCtx, numLeaves, inputMock.get());
+
+    // The second input repeats the search, to check that nothing spilled for the first is left
+    // behind.
+    for (int input = 0; input < 2; ++input) {
+        auto next = graphLookupStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+
+        auto resultsValue = next.getDocument().getField("results");
+        ASSERT(resultsValue.isArray());
+        std::set<int> ids;
+        for (auto&& result : resultsValue.getArray()) {
+            ids.insert(result.getDocument().getField("_id").getInt());
+        }
+        ASSERT_EQ(static_cast<size_t>(numLeaves + 1), resultsValue.getArray().size());
+        ASSERT_EQ(static_cast<size_t>(numLeaves + 1), ids.size());
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+    ASSERT_TRUE(graphLookupStage->usedDisk());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldErrorWhenExceedingMemoryLimitWithoutDiskUse) {
+    const auto originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(6 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory); });
+
+    auto expCtx = getExpCtx();
+    auto inputMock =
+        DocumentSourceMock::createForTest({Document{{"_id", 0}, {"startVal", 0}}}, expCtx);
+    auto graphLookupStage = makeWideGraphLookup(expCtx, 200, inputMock.get());
+
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), AssertionException, 40099);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -40,7 +40,10 @@
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/javascript_execution.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/pipeline/parallel_group_executor.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/destructor_guard.h"
 
 namespace mongo {
@@ -132,12 +135,23 @@ const char* DocumentSourceGroup::getSourceName() const {
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::doGetNext() {
+    if (!_parallelExecutionDecided) {
+        _parallelExecutor = makeParallelExecutor();
+        _parallelExecutionDecided = true;
+    }
+
     if (!_initialized) {
-        const auto initializationResult = initialize();
+        const auto initializationResult =
+            _parallelExecutor ? _parallelExecutor->consume(pSource) : initialize();
         if (initializationResult.isPaused()) {
             return initializationResult;
         }
         invariant(initializationResult.isEOF());
+        _initialized = true;
+    }
+
+    if (_parallelExecutor) {
+        return _parallelExecutor->getNext();
     }
 
     for (auto&& accum : _currentAccumulators) {
@@ -151,6 +165,19 @@ DocumentSource::GetNextResult DocumentSourceGroup::doGetNext() {
     }
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceGroup::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxDocs) {
+    // Every output document is built afresh, so several can be returned at once.
+    for (size_t numDocs = 0; numDocs < maxDocs; ++numDocs) {
+        auto next = doGetNext();
+        if (!next.isAdvanced()) {
+            return numDocs ? GetNextResult::ReturnStatus::kAdvanced : next.getStatus();
+        }
+        batch->push_back(next.releaseDocument());
+    }
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
     // We aren't streaming, and we have spilled to disk.
     if (!_sorterIterator)
@@ -210,6 +237,10 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
 }
 
 void DocumentSourceGroup::doDispose() {
+    if (_parallelExecutor) {
+        _parallelExecutor->dispose();
+    }
+
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
@@ -479,9 +510,29 @@ private:
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     const size_t numAccumulators = _accumulatedFields.size();
 
+    // The input is requested in batches, which saves a virtual call per document when 'pSource'
+    // is able to produce several documents at once.
+    std::vector<Document> batch;
+    size_t nextInBatch = 0;
+    auto getNextInput = [&]() -> GetNextResult {
+        if (nextInBatch == batch.size()) {
+            batch.clear();
+            nextInBatch = 0;
+            switch (pSource->getNextBatch(&batch, kInputBatchSize)) {
+                case GetNextResult::ReturnStatus::kAdvanced:
+                    break;
+                case GetNextResult::ReturnStatus::kPauseExecution:
+                    return GetNextResult::makePauseExecution();
+                case GetNextResult::ReturnStatus::kEOF:
+                    return GetNextResult::makeEOF();
+            }
+        }
+        return std::move(batch[nextInBatch++]);
+    };
+
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
-    GetNextResult input = pSource->getNext();
-    for (; input.isAdvanced(); input = pSource->getNext()) {
+    GetNextResult input = getNextInput();
+    for (; input.isAdvanced(); input = getNextInput()) {
         if (_memoryUsageBytes > _maxMemoryUsageBytes) {
             uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
                     "Exceeded memory limit for $group, but didn't allow external sort."
@@ -569,7 +620,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
                     _sortedFiles,
                     _fileName,
-                    SortOptions(),
+                    SortOptions().ReadAhead(internalQueryEnableSorterReadAhead.load()),
                     SorterComparator(pExpCtx->getValueComparator())));
                 _ownsFileDeletion = false;
 
@@ -596,7 +647,34 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 }
 
 bool DocumentSourceGroup::usedDisk() {
-    return _usedDisk;
+    return _usedDisk || (_parallelExecutor && _parallelExecutor->usedDisk());
+}
+
+std::unique_ptr<ParallelGroupExecutor> DocumentSourceGroup::makeParallelExecutor() {
+    const size_t numConsumers = internalDocumentSourceGroupParallelConsumers.load();
+    if (numConsumers <= 1 || pExpCtx->inMongos || !pExpCtx->opCtx) {
+        return nullptr;
+    }
+
+    const auto spec = serialize().getDocument().toBson();
+    if (JsExecution::usedBy(spec)) {
+        return nullptr;
+    }
+
+    // Every consumer is a copy of this $group with an ExpressionContext of its own, and gets an
+    // equal share of the memory limit.
+    std::vector<intrusive_ptr<DocumentSource>> consumers;
+    for (size_t i = 0; i < numConsumers; ++i) {
+        auto consumer =
+            createFromBson(spec.firstElement(), pExpCtx->copyWith(pExpCtx->ns, pExpCtx->uuid));
+        auto group = static_cast<DocumentSourceGroup*>(consumer.get());
+        group->_maxMemoryUsageBytes = std::max(_maxMemoryUsageBytes / numConsumers, size_t(1));
+        group->_parallelExecutionDecided = true;
+        consumers.push_back(std::move(consumer));
+    }
+
+    return std::make_unique<ParallelGroupExecutor>(
+        pExpCtx, std::move(consumers), [this](const Document& root) { return computeId(root); });
 }
 
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
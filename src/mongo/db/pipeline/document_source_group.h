@@ -40,6 +40,8 @@
 
 namespace mongo {
 
+class ParallelGroupExecutor;
+
 /**
  * GroupFromFirstTransformation consists of a list of (field name, expression pairs). It returns a
  * document synthesized by assigning each field name in the output document to the result of
@@ -179,6 +181,8 @@ public:
 
 protected:
     GetNextResult doGetNext() final;
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxDocs) final;
     void doDispose() final;
 
 private:
@@ -232,6 +236,13 @@ private:
      */
     bool pathIncludedInGroupKeys(const std::string& dottedPath) const;
 
+    /**
+     * Returns an executor which aggregates the input of this stage on several threads, or nullptr
+     * if this $group should run on the calling thread. Controlled by the
+     * internalDocumentSourceGroupParallelConsumers knob.
+     */
+    std::unique_ptr<ParallelGroupExecutor> makeParallelExecutor();
+
     std::vector<AccumulationStatement> _accumulatedFields;
 
     bool _usedDisk;  // Keeps track of whether this $group spilled to disk.
@@ -266,6 +277,11 @@ private:
     const bool _allowDiskUse;
 
     std::pair<Value, Value> _firstPartOfNextGroup;
+
+    // Set on the first call to doGetNext() if this $group runs in parallel, in which case the
+    // executor produces all of the output and the members above are left unused.
+    std::unique_ptr<ParallelGroupExecutor> _parallelExecutor;
+    bool _parallelExecutionDecided = false;
 };
 
 }  // namespace mongo
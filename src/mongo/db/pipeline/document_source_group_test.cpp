@@ -49,11 +49,13 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -206,6 +208,84 @@ TEST_F(DocumentSourceGroupTest, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
         group->getNext(), AssertionException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldProduceEveryGroupOnceWhenRunningInParallel) {
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const auto originalConsumers = internalDocumentSourceGroupParallelConsumers.load();
+    internalDocumentSourceGroupParallelConsumers.store(4);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelConsumers.store(originalConsumers); });
+
+    auto&& parser = AccumulationStatement::getParser("$sum", boost::none);
+    auto accumulatorArg = BSON(""
+                               << "$value");
+    auto accExpr = parser(expCtx.get(), accumulatorArg.firstElement(), expCtx->variablesParseState);
+    AccumulationStatement sumStatement{"total", accExpr};
+    auto groupByExpression =
+        ExpressionFieldPath::parse(expCtx.get(), "$key", expCtx->variablesParseState);
+    auto group = DocumentSourceGroup::create(expCtx, groupByExpression, {sumStatement});
+
+    const int numKeys = 37;
+    deque<DocumentSource::GetNextResult> inputs;
+    map<int, long long> expectedTotals;
+    for (int i = 0; i < 2000; ++i) {
+        if (i % 500 == 0) {
+            inputs.push_back(DocumentSource::GetNextResult::makePauseExecution());
+        }
+        inputs.push_back(Document{{"key", i % numKeys}, {"value", i}});
+        expectedTotals[i % numKeys] += i;
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs), expCtx);
+    group->setSource(mock.get());
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(group->getNext().isPaused());
+    }
+
+    map<int, long long> totals;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(totals.count(doc["_id"].getInt()), 0UL);
+        totals[doc["_id"].getInt()] = doc["total"].coerceToLong();
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT(totals == expectedTotals);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldReportConsumerErrorWhenRunningInParallel) {
+    auto expCtx = getExpCtx();
+    const size_t maxMemoryUsageBytes = 1000;
+
+    const auto originalConsumers = internalDocumentSourceGroupParallelConsumers.load();
+    internalDocumentSourceGroupParallelConsumers.store(4);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelConsumers.store(originalConsumers); });
+
+    auto&& parser = AccumulationStatement::getParser("$push", boost::none);
+    auto accumulatorArg = BSON(""
+                               << "$largeStr");
+    auto accExpr = parser(expCtx.get(), accumulatorArg.firstElement(), expCtx->variablesParseState);
+    AccumulationStatement pushStatement{"spaceHog", accExpr};
+    auto groupByExpression =
+        ExpressionFieldPath::parse(expCtx.get(), "$_id", expCtx->variablesParseState);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {pushStatement}, maxMemoryUsageBytes);
+
+    // Each consumer gets a quarter of the memory limit, which a single document exceeds.
+    string largeStr(maxMemoryUsageBytes / 2, 'x');
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 1000; ++i) {
+        inputs.push_back(Document{{"_id", i}, {"largeStr", largeStr}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs), expCtx);
+    group->setSource(mock.get());
+
+    ASSERT_THROWS_CODE(
+        group->getNext(), AssertionException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+    group->dispose();
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldReportSingleFieldGroupKeyAsARename) {
     auto expCtx = getExpCtx();
     VariablesParseState vps = expCtx->variablesParseState;
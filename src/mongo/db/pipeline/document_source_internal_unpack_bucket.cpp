@@ -0,0 +1,407 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/pipeline/dependencies.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(_internalUnpackBucket,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceInternalUnpackBucket::createFromBson);
+
+constexpr StringData BucketUnpacker::kBucketMetaFieldName;
+constexpr StringData BucketUnpacker::kBucketControlMinFieldName;
+constexpr StringData BucketUnpacker::kBucketControlMaxFieldName;
+constexpr StringData BucketUnpacker::kBucketDataFieldName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kStageName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kInclude;
+constexpr StringData DocumentSourceInternalUnpackBucket::kExclude;
+constexpr StringData DocumentSourceInternalUnpackBucket::kTimeFieldName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kMetaFieldName;
+
+namespace {
+
+/**
+ * Returns the value of 'elem', which must be a top-level field name naming the 'parameter' field
+ * of the stage specification.
+ */
+std::string parseFieldName(StringData parameter, const BSONElement& elem) {
+    uassert(4798601,
+            str::stream() << "The " << parameter << " parameter of "
+                          << DocumentSourceInternalUnpackBucket::kStageName
+                          << " must be a string, but found: " << elem,
+            elem.type() == BSONType::String);
+    auto fieldName = elem.str();
+    uassert(4798602,
+            str::stream() << "The " << parameter << " parameter of "
+                          << DocumentSourceInternalUnpackBucket::kStageName
+                          << " must be a non-empty field name without dots, but found: "
+                          << fieldName,
+            !fieldName.empty() && fieldName.find('.') == std::string::npos);
+    return fieldName;
+}
+
+}  // namespace
+
+BucketUnpacker::BucketUnpacker(BucketSpec spec, Behavior behavior)
+    : _spec(std::move(spec)),
+      _behavior(behavior),
+      _includeTimeField(includesField(_spec.timeField)),
+      _includeMetaField(_spec.metaField && includesField(*_spec.metaField)) {}
+
+void BucketUnpacker::reset(BSONObj bucket) {
+    _timeFieldIter = boost::none;
+    _columns.clear();
+    _metaValue = Value();
+
+    _bucket = std::move(bucket);
+    if (_bucket.isEmpty()) {
+        return;
+    }
+
+    auto dataRegion = _bucket[kBucketDataFieldName];
+    uassert(4798603,
+            str::stream() << "A time-series bucket must have a '" << kBucketDataFieldName
+                          << "' field of type object, but found: " << _bucket,
+            dataRegion.type() == BSONType::Object);
+
+    // A column named like the meta field is ignored, since the meta field of a measurement always
+    // holds the meta value of its bucket.
+    for (auto&& column : dataRegion.embeddedObject()) {
+        uassert(4798604,
+                str::stream() << "The columns of a time-series bucket must be objects, but found: "
+                              << column,
+                column.type() == BSONType::Object);
+
+        const auto name = column.fieldNameStringData();
+        if (name == _spec.timeField) {
+            _timeFieldIter.emplace(column.embeddedObject());
+            if (_includeTimeField) {
+                _columns.push_back({name, boost::none});
+            }
+        } else if ((!_spec.metaField || name != *_spec.metaField) &&
+                   includesField(name.toString())) {
+            _columns.push_back({name, BSONObjIterator(column.embeddedObject())});
+        }
+    }
+
+    // A bucket without any columns holds no measurements. Otherwise, it must have a time column
+    // for the other columns to be unpacked by.
+    uassert(4798605,
+            str::stream() << "A time-series bucket must have a column for the time field '"
+                          << _spec.timeField << "', but found: " << _bucket,
+            _timeFieldIter || dataRegion.embeddedObject().isEmpty());
+
+    if (_includeMetaField) {
+        auto metaElem = _bucket[kBucketMetaFieldName];
+        if (!metaElem.eoo()) {
+            _metaValue = Value(metaElem);
+        }
+    }
+}
+
+Document BucketUnpacker::getNext() {
+    invariant(hasNext());
+
+    auto timeElem = _timeFieldIter->next();
+    const auto measurementIndex = timeElem.fieldNameStringData();
+
+    MutableDocument measurement;
+    for (auto&& column : _columns) {
+        if (!column.iter) {
+            measurement.addField(column.name, Value(timeElem));
+            continue;
+        }
+
+        // The columns other than the time column are sparse, so only take the next value of the
+        // column if it belongs to this measurement.
+        if (column.iter->more() && (**column.iter).fieldNameStringData() == measurementIndex) {
+            measurement.addField(column.name, Value(column.iter->next()));
+        }
+    }
+
+    if (!_metaValue.missing()) {
+        measurement.addField(*_spec.metaField, _metaValue);
+    }
+
+    return measurement.freeze();
+}
+
+DocumentSourceInternalUnpackBucket::DocumentSourceInternalUnpackBucket(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, BucketUnpacker bucketUnpacker)
+    : DocumentSource(kStageName, expCtx), _bucketUnpacker(std::move(bucketUnpacker)) {}
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createFromBson(
+    BSONElement specElem, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(4798606,
+            str::stream() << kStageName << " specification must be an object, but found: "
+                          << specElem,
+            specElem.type() == BSONType::Object);
+
+    BucketSpec bucketSpec;
+    boost::optional<BucketUnpacker::Behavior> behavior;
+    bool hasTimeField = false;
+    for (auto&& elem : specElem.embeddedObject()) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == kInclude || fieldName == kExclude) {
+            uassert(4798607,
+                    str::stream() << kStageName << " cannot have both '" << kInclude << "' and '"
+                                  << kExclude << "' parameters",
+                    !behavior);
+            uassert(4798608,
+                    str::stream() << "The " << fieldName << " parameter of " << kStageName
+                                  << " must be an array, but found: " << elem,
+                    elem.type() == BSONType::Array);
+            for (auto&& field : elem.embeddedObject()) {
+                bucketSpec.fieldSet.insert(parseFieldName(fieldName, field));
+            }
+            behavior = fieldName == kInclude ? BucketUnpacker::Behavior::kInclude
+                                             : BucketUnpacker::Behavior::kExclude;
+        } else if (fieldName == kTimeFieldName) {
+            bucketSpec.timeField = parseFieldName(fieldName, elem);
+            hasTimeField = true;
+        } else if (fieldName == kMetaFieldName) {
+            bucketSpec.metaField = parseFieldName(fieldName, elem);
+        } else {
+            uasserted(4798609,
+                      str::stream() << "Unrecognized parameter to " << kStageName << ": "
+                                    << fieldName);
+        }
+    }
+
+    uassert(4798610,
+            str::stream() << kStageName << " requires a '" << kTimeFieldName << "' parameter",
+            hasTimeField);
+
+    return new DocumentSourceInternalUnpackBucket(
+        expCtx,
+        BucketUnpacker(std::move(bucketSpec),
+                       behavior.value_or(BucketUnpacker::Behavior::kExclude)));
+}
+
+Value DocumentSourceInternalUnpackBucket::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    const auto& spec = _bucketUnpacker.bucketSpec();
+
+    std::vector<Value> fields;
+    for (auto&& field : spec.fieldSet) {
+        fields.emplace_back(field);
+    }
+
+    MutableDocument out;
+    out.addField(_bucketUnpacker.behavior() == BucketUnpacker::Behavior::kInclude ? kInclude
+                                                                                   : kExclude,
+                 Value{std::move(fields)});
+    out.addField(kTimeFieldName, Value{spec.timeField});
+    if (spec.metaField) {
+        out.addField(kMetaFieldName, Value{*spec.metaField});
+    }
+    return Value(Document{{getSourceName(), out.freeze()}});
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::doGetNext() {
+    if (_bucketUnpacker.hasNext()) {
+        return _bucketUnpacker.getNext();
+    }
+
+    // Skip over any buckets which hold no measurements.
+    auto nextResult = pSource->getNext();
+    while (nextResult.isAdvanced()) {
+        _bucketUnpacker.reset(nextResult.getDocument().toBson());
+        if (_bucketUnpacker.hasNext()) {
+            return _bucketUnpacker.getNext();
+        }
+        nextResult = pSource->getNext();
+    }
+    return nextResult;
+}
+
+boost::intrusive_ptr<DocumentSourceMatch>
+DocumentSourceInternalUnpackBucket::_pushDownMetaPredicates(
+    Pipeline::SourceContainer::iterator itr,
+    Pipeline::SourceContainer* container,
+    boost::intrusive_ptr<DocumentSourceMatch> nextMatch) {
+    const auto& metaField = _bucketUnpacker.bucketSpec().metaField;
+    if (!metaField || !_bucketUnpacker.includesField(*metaField)) {
+        return nextMatch;
+    }
+
+    // Splitting a $match only renames the paths of leaf and logical expressions, so leave any
+    // $match with other kinds of expressions intact.
+    bool canRename = true;
+    expression::mapOver(nextMatch->getMatchExpression(), [&](MatchExpression* expr, std::string) {
+        auto category = expr->getCategory();
+        canRename = canRename &&
+            (category == MatchExpression::MatchCategory::kLeaf ||
+             category == MatchExpression::MatchCategory::kLogical);
+    });
+    if (!canRename) {
+        return nextMatch;
+    }
+
+    DepsTracker deps;
+    nextMatch->getDependencies(&deps);
+    if (deps.needWholeDocument) {
+        return nextMatch;
+    }
+
+    std::set<std::string> nonMetaFields;
+    for (auto&& path : deps.fields) {
+        auto topLevelField = FieldPath::extractFirstFieldFromDottedPath(path);
+        if (topLevelField != *metaField) {
+            nonMetaFields.insert(topLevelField.toString());
+        }
+    }
+
+    // Every measurement of a bucket has the bucket's meta value as its meta field, so a predicate
+    // on the meta field selects either all or none of the measurements of a bucket and can be
+    // applied to the bucket instead.
+    auto [metaOnlyMatch, remainingMatch] = nextMatch->splitSourceBy(
+        nonMetaFields, {{*metaField, BucketUnpacker::kBucketMetaFieldName.toString()}});
+    if (metaOnlyMatch) {
+        container->insert(itr, metaOnlyMatch);
+    }
+    return remainingMatch;
+}
+
+BSONObj DocumentSourceInternalUnpackBucket::_makeBucketLevelTimePredicate(
+    const DocumentSourceMatch& match) const {
+    const auto& timeField = _bucketUnpacker.bucketSpec().timeField;
+    const std::string minPath = str::stream()
+        << BucketUnpacker::kBucketControlMinFieldName << "." << timeField;
+    const std::string maxPath = str::stream()
+        << BucketUnpacker::kBucketControlMaxFieldName << "." << timeField;
+
+    // Only the top-level conjuncts of the $match constrain every matched measurement.
+    const MatchExpression* expr = match.getMatchExpression();
+    std::vector<const MatchExpression*> conjuncts;
+    if (expr->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            conjuncts.push_back(expr->getChild(i));
+        }
+    } else {
+        conjuncts.push_back(expr);
+    }
+
+    // The time of every measurement is a date, so comparisons against a date follow the ordering
+    // of dates, and a bucket can hold a matching measurement only if its time range overlaps that
+    // of the predicate.
+    BSONArrayBuilder predicates;
+    for (auto&& conjunct : conjuncts) {
+        if (conjunct->path() != timeField) {
+            continue;
+        }
+
+        const auto matchType = conjunct->matchType();
+        if (matchType != MatchExpression::EQ && matchType != MatchExpression::GT &&
+            matchType != MatchExpression::GTE && matchType != MatchExpression::LT &&
+            matchType != MatchExpression::LTE) {
+            continue;
+        }
+
+        const auto& rhs = static_cast<const ComparisonMatchExpressionBase*>(conjunct)->getData();
+        if (rhs.type() != BSONType::Date) {
+            continue;
+        }
+
+        switch (matchType) {
+            case MatchExpression::EQ:
+                predicates << BSON(minPath << BSON("$lte" << rhs));
+                predicates << BSON(maxPath << BSON("$gte" << rhs));
+                break;
+            case MatchExpression::GT:
+                predicates << BSON(maxPath << BSON("$gt" << rhs));
+                break;
+            case MatchExpression::GTE:
+                predicates << BSON(maxPath << BSON("$gte" << rhs));
+                break;
+            case MatchExpression::LT:
+                predicates << BSON(minPath << BSON("$lt" << rhs));
+                break;
+            case MatchExpression::LTE:
+                predicates << BSON(minPath << BSON("$lte" << rhs));
+                break;
+            default:
+                MONGO_UNREACHABLE;
+        }
+    }
+
+    auto predicatesArr = predicates.arr();
+    return predicatesArr.isEmpty() ? BSONObj() : BSON("$and" << predicatesArr);
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextStageItr = std::next(itr);
+    if (nextStageItr == container->end()) {
+        return container->end();
+    }
+
+    auto nextMatch = dynamic_cast<DocumentSourceMatch*>(nextStageItr->get());
+    if (!nextMatch) {
+        return nextStageItr;
+    }
+
+    const auto sizeBefore = container->size();
+
+    auto remainingMatch = _pushDownMetaPredicates(itr, container, nextMatch);
+    if (!remainingMatch) {
+        container->erase(nextStageItr);
+    } else if (remainingMatch != nextMatch) {
+        *nextStageItr = remainingMatch;
+    }
+
+    if (remainingMatch && !_triedBucketLevelTimePredicate) {
+        auto timePredicate = _makeBucketLevelTimePredicate(*remainingMatch);
+        if (!timePredicate.isEmpty()) {
+            container->insert(itr, DocumentSourceMatch::create(timePredicate, pExpCtx));
+            _triedBucketLevelTimePredicate = true;
+        }
+    }
+
+    // If stages were added ahead of this one, give them the chance to be optimized with whatever
+    // precedes this stage, for instance to be pushed down into the query layer.
+    if (container->size() > sizeBefore || !remainingMatch) {
+        return itr == container->begin() ? itr : std::prev(itr);
+    }
+    return std::next(itr);
+}
+
+}  // namespace mongo
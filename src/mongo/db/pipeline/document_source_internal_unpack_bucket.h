@@ -0,0 +1,220 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_match.h"
+
+namespace mongo {
+
+/**
+ * Carries the user's specification of a time-series bucket collection: the names of the time and
+ * meta fields, and the set of fields to include in or exclude from the unpacked measurements.
+ */
+struct BucketSpec {
+    // The user-supplied name of the field holding the time of each measurement.
+    std::string timeField;
+
+    // The user-supplied name of the field holding the metadata shared by all the measurements of
+    // a bucket, if there is one.
+    boost::optional<std::string> metaField;
+
+    // The set of field names named in the 'include' or 'exclude' list of the stage.
+    std::set<std::string> fieldSet;
+};
+
+/**
+ * Unpacks time-series bucket documents into the measurements they contain. A bucket has the form
+ *
+ *   {_id: <bucket id>,
+ *    meta: <metadata shared by all measurements, optional>,
+ *    control: {min: {<field>: <min value>, ...}, max: {<field>: <max value>, ...}},
+ *    data: {<field>: {"0": <value>, "1": <value>, ...}, ...}}
+ *
+ * where each column in 'data' maps the index of a measurement to that measurement's value of the
+ * field. Columns may be sparse, except for the time column, which has an entry for every
+ * measurement and so determines how many measurements the bucket holds. The meta value is
+ * produced under the name 'metaField' in every measurement.
+ */
+class BucketUnpacker {
+public:
+    // Determines whether the field set of the BucketSpec names the fields to keep or to drop.
+    enum class Behavior { kInclude, kExclude };
+
+    // The names of the fields of a bucket document.
+    static constexpr StringData kBucketMetaFieldName = "meta"_sd;
+    static constexpr StringData kBucketControlMinFieldName = "control.min"_sd;
+    static constexpr StringData kBucketControlMaxFieldName = "control.max"_sd;
+    static constexpr StringData kBucketDataFieldName = "data"_sd;
+
+    BucketUnpacker(BucketSpec spec, Behavior behavior);
+
+    /**
+     * Starts unpacking 'bucket', discarding any measurements left in the previous bucket.
+     */
+    void reset(BSONObj bucket);
+
+    /**
+     * Returns true if the current bucket has measurements which have not been returned yet.
+     */
+    bool hasNext() const {
+        return _timeFieldIter && _timeFieldIter->more();
+    }
+
+    /**
+     * Returns the next measurement of the current bucket. Only valid if hasNext() is true.
+     */
+    Document getNext();
+
+    const BucketSpec& bucketSpec() const {
+        return _spec;
+    }
+
+    Behavior behavior() const {
+        return _behavior;
+    }
+
+    /**
+     * Returns true if the measurements produced by this unpacker contain the field 'name'.
+     */
+    bool includesField(const std::string& name) const {
+        return (_behavior == Behavior::kInclude) == (_spec.fieldSet.count(name) > 0);
+    }
+
+private:
+    struct Column {
+        StringData name;
+
+        // Not set for the time column.
+        boost::optional<BSONObjIterator> iter;
+    };
+
+    const BucketSpec _spec;
+    const Behavior _behavior;
+    const bool _includeTimeField;
+    const bool _includeMetaField;
+
+    // The bucket being unpacked. Owns the memory which the iterators below point into.
+    BSONObj _bucket;
+
+    // Iterates the time column, which drives the unpacking.
+    boost::optional<BSONObjIterator> _timeFieldIter;
+
+    // The value of the bucket's meta field, if it is to be included in the measurements.
+    Value _metaValue;
+
+    // The columns of the bucket which are included in the measurements, in the order in which
+    // they appear in the bucket's data region. The time column has no iterator of its own, since
+    // it is advanced through '_timeFieldIter'.
+    std::vector<Column> _columns;
+};
+
+/**
+ * Unpacks each time-series bucket produced by its source into the individual measurements it
+ * holds. See BucketUnpacker for the bucket format. The stage has the specification
+ *
+ *   {$_internalUnpackBucket: {include | exclude: [<field>, ...],
+ *                             timeField: <string>,
+ *                             metaField: <string, optional>}}
+ *
+ * When it is followed by a $match, predicates on the meta field are moved ahead of the stage and
+ * applied to the buckets themselves, and comparisons of the time field against dates are used to
+ * add a filter on the buckets' control.min and control.max fields ahead of it.
+ */
+class DocumentSourceInternalUnpackBucket final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalUnpackBucket"_sd;
+    static constexpr StringData kInclude = "include"_sd;
+    static constexpr StringData kExclude = "exclude"_sd;
+    static constexpr StringData kTimeFieldName = "timeField"_sd;
+    static constexpr StringData kMetaFieldName = "metaField"_sd;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    DocumentSourceInternalUnpackBucket(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                       BucketUnpacker bucketUnpacker);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        return {StreamType::kStreaming,
+                PositionRequirement::kNone,
+                HostTypeRequirement::kNone,
+                DiskUseRequirement::kNoDiskUse,
+                FacetRequirement::kAllowed,
+                TransactionRequirement::kAllowed,
+                LookupRequirement::kAllowed,
+                UnionRequirement::kAllowed};
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+private:
+    GetNextResult doGetNext() final;
+
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
+    /**
+     * Moves the portion of 'nextMatch' which depends only on the meta field ahead of this stage,
+     * rewritten to apply to the buckets' meta field. Returns the stage which now holds the rest
+     * of 'nextMatch', or nullptr if none of it is left. Takes ownership of 'nextMatch'.
+     */
+    boost::intrusive_ptr<DocumentSourceMatch> _pushDownMetaPredicates(
+        Pipeline::SourceContainer::iterator itr,
+        Pipeline::SourceContainer* container,
+        boost::intrusive_ptr<DocumentSourceMatch> nextMatch);
+
+    /**
+     * Returns a predicate on the buckets' control.min and control.max fields which every bucket
+     * holding a measurement matched by 'match' satisfies, or an empty object if 'match' has no
+     * comparisons of the time field against dates.
+     */
+    BSONObj _makeBucketLevelTimePredicate(const DocumentSourceMatch& match) const;
+
+    BucketUnpacker _bucketUnpacker;
+
+    // Set once this stage has added a filter on the buckets' time range ahead of itself, so that
+    // re-optimizing the pipeline does not add it again.
+    bool _triedBucketLevelTimePredicate = false;
+};
+
+}  // namespace mongo
@@ -0,0 +1,270 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <deque>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using InternalUnpackBucketStageTest = AggregationContextFixture;
+
+boost::intrusive_ptr<DocumentSource> makeUnpackStage(
+    const BSONObj& spec, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    return DocumentSourceInternalUnpackBucket::createFromBson(spec.firstElement(), expCtx);
+}
+
+/**
+ * Runs the buckets in 'buckets' through an unpack stage with the specification 'spec' and returns
+ * the measurements it produces.
+ */
+std::vector<Document> unpackBuckets(const BSONObj& spec,
+                                    const std::vector<std::string>& buckets,
+                                    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    auto unpack = makeUnpackStage(spec, expCtx);
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (auto&& bucket : buckets) {
+        inputs.emplace_back(Document(fromjson(bucket)));
+    }
+    auto source = DocumentSourceMock::createForTest(std::move(inputs), expCtx);
+    unpack->setSource(source.get());
+
+    std::vector<Document> results;
+    for (auto next = unpack->getNext(); next.isAdvanced(); next = unpack->getNext()) {
+        results.push_back(next.releaseDocument());
+    }
+    return results;
+}
+
+TEST_F(InternalUnpackBucketStageTest, UnpacksEveryMeasurementOfABucket) {
+    auto results = unpackBuckets(
+        fromjson("{$_internalUnpackBucket: {exclude: [], timeField: 'time'}}"),
+        {"{meta: 'a', data: {_id: {'0': 1, '1': 2}, time: {'0': 1, '1': 2}, x: {'0': 1, '1': 2}}}"},
+        getExpCtx());
+
+    ASSERT_EQ(results.size(), 2U);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{_id: 1, time: 1, x: 1}")));
+    ASSERT_DOCUMENT_EQ(results[1], Document(fromjson("{_id: 2, time: 2, x: 2}")));
+}
+
+TEST_F(InternalUnpackBucketStageTest, OmitsFieldsMissingFromSparseColumns) {
+    auto results = unpackBuckets(
+        fromjson("{$_internalUnpackBucket: {exclude: [], timeField: 'time'}}"),
+        {"{data: {time: {'0': 1, '1': 2, '2': 3}, x: {'1': 2}, y: {'0': 1, '2': 3}}}"},
+        getExpCtx());
+
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{time: 1, y: 1}")));
+    ASSERT_DOCUMENT_EQ(results[1], Document(fromjson("{time: 2, x: 2}")));
+    ASSERT_DOCUMENT_EQ(results[2], Document(fromjson("{time: 3, y: 3}")));
+}
+
+TEST_F(InternalUnpackBucketStageTest, AddsMetaFieldToEveryMeasurement) {
+    auto results = unpackBuckets(
+        fromjson("{$_internalUnpackBucket: {exclude: [], timeField: 'time', metaField: 'tag'}}"),
+        {"{meta: {a: 1}, data: {time: {'0': 1, '1': 2}, tag: {'0': 'ignored'}}}",
+         "{data: {time: {'0': 3}}}"},
+        getExpCtx());
+
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{time: 1, tag: {a: 1}}")));
+    ASSERT_DOCUMENT_EQ(results[1], Document(fromjson("{time: 2, tag: {a: 1}}")));
+    ASSERT_DOCUMENT_EQ(results[2], Document(fromjson("{time: 3}")));
+}
+
+TEST_F(InternalUnpackBucketStageTest, IncludesOnlyTheRequestedFields) {
+    auto results = unpackBuckets(
+        fromjson("{$_internalUnpackBucket: {include: ['x', 'tag'], timeField: 'time', "
+                 "metaField: 'tag'}}"),
+        {"{meta: 'a', data: {_id: {'0': 1}, time: {'0': 1}, x: {'0': 1}, y: {'0': 1}}}"},
+        getExpCtx());
+
+    ASSERT_EQ(results.size(), 1U);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{x: 1, tag: 'a'}")));
+}
+
+TEST_F(InternalUnpackBucketStageTest, ExcludesTheRequestedFields) {
+    auto results = unpackBuckets(
+        fromjson("{$_internalUnpackBucket: {exclude: ['_id', 'tag'], timeField: 'time', "
+                 "metaField: 'tag'}}"),
+        {"{meta: 'a', data: {_id: {'0': 1}, time: {'0': 1}, x: {'0': 1}}}"},
+        getExpCtx());
+
+    ASSERT_EQ(results.size(), 1U);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{time: 1, x: 1}")));
+}
+
+TEST_F(InternalUnpackBucketStageTest, SkipsBucketsWithoutMeasurements) {
+    auto results = unpackBuckets(fromjson("{$_internalUnpackBucket: {timeField: 'time'}}"),
+                                 {"{data: {}}", "{data: {time: {'0': 1}}}", "{data: {}}"},
+                                 getExpCtx());
+
+    ASSERT_EQ(results.size(), 1U);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{time: 1}")));
+}
+
+TEST_F(InternalUnpackBucketStageTest, FailsOnBucketWithoutTimeColumn) {
+    ASSERT_THROWS_CODE(unpackBuckets(fromjson("{$_internalUnpackBucket: {timeField: 'time'}}"),
+                                     {"{data: {x: {'0': 1}}}"},
+                                     getExpCtx()),
+                       AssertionException,
+                       4798605);
+}
+
+TEST_F(InternalUnpackBucketStageTest, RejectsInvalidSpecifications) {
+    ASSERT_THROWS_CODE(makeUnpackStage(fromjson("{$_internalUnpackBucket: 1}"), getExpCtx()),
+                       AssertionException,
+                       4798606);
+    ASSERT_THROWS_CODE(
+        makeUnpackStage(fromjson("{$_internalUnpackBucket: {include: [], exclude: [], "
+                                 "timeField: 'time'}}"),
+                        getExpCtx()),
+        AssertionException,
+        4798607);
+    ASSERT_THROWS_CODE(
+        makeUnpackStage(fromjson("{$_internalUnpackBucket: {include: 'x', timeField: 'time'}}"),
+                        getExpCtx()),
+        AssertionException,
+        4798608);
+    ASSERT_THROWS_CODE(
+        makeUnpackStage(fromjson("{$_internalUnpackBucket: {foo: 1, timeField: 'time'}}"),
+                        getExpCtx()),
+        AssertionException,
+        4798609);
+    ASSERT_THROWS_CODE(
+        makeUnpackStage(fromjson("{$_internalUnpackBucket: {exclude: []}}"), getExpCtx()),
+        AssertionException,
+        4798610);
+    ASSERT_THROWS_CODE(
+        makeUnpackStage(fromjson("{$_internalUnpackBucket: {timeField: 1}}"), getExpCtx()),
+        AssertionException,
+        4798601);
+    ASSERT_THROWS_CODE(
+        makeUnpackStage(fromjson("{$_internalUnpackBucket: {timeField: 'a.b'}}"), getExpCtx()),
+        AssertionException,
+        4798602);
+}
+
+TEST_F(InternalUnpackBucketStageTest, SerializesItsSpecification) {
+    auto spec = fromjson(
+        "{$_internalUnpackBucket: {include: ['a', 'b'], timeField: 'time', metaField: 'tag'}}");
+    auto unpack = makeUnpackStage(spec, getExpCtx());
+
+    std::vector<Value> serialized;
+    unpack->serializeToArray(serialized);
+    ASSERT_EQ(serialized.size(), 1U);
+    ASSERT_VALUE_EQ(serialized[0], Value(spec));
+}
+
+TEST_F(InternalUnpackBucketStageTest, MovesMetaPredicatesAheadOfTheStage) {
+    auto pipeline = Pipeline::parse(
+        {fromjson("{$_internalUnpackBucket: {exclude: [], timeField: 'time', metaField: 'tag'}}"),
+         fromjson("{$match: {'tag.a': 1, x: 2}}")},
+        getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(serialized.size(), 3U);
+    ASSERT_BSONOBJ_EQ(serialized[0], fromjson("{$match: {'meta.a': {$eq: 1}}}"));
+    ASSERT_EQ(serialized[1].firstElementFieldNameStringData(),
+              DocumentSourceInternalUnpackBucket::kStageName);
+    ASSERT_BSONOBJ_EQ(serialized[2], fromjson("{$match: {x: {$eq: 2}}}"));
+}
+
+TEST_F(InternalUnpackBucketStageTest, MovesMatchOnlyOnMetaFieldEntirelyAheadOfTheStage) {
+    auto pipeline = Pipeline::parse(
+        {fromjson("{$_internalUnpackBucket: {exclude: [], timeField: 'time', metaField: 'tag'}}"),
+         fromjson("{$match: {tag: 'a'}}")},
+        getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(serialized.size(), 2U);
+    ASSERT_BSONOBJ_EQ(serialized[0], fromjson("{$match: {meta: {$eq: 'a'}}}"));
+    ASSERT_EQ(serialized[1].firstElementFieldNameStringData(),
+              DocumentSourceInternalUnpackBucket::kStageName);
+}
+
+TEST_F(InternalUnpackBucketStageTest, DoesNotMoveMetaPredicatesWhenMetaFieldIsExcluded) {
+    auto pipeline = Pipeline::parse(
+        {fromjson("{$_internalUnpackBucket: {exclude: ['tag'], timeField: 'time', "
+                  "metaField: 'tag'}}"),
+         fromjson("{$match: {tag: 'a'}}")},
+        getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(serialized.size(), 2U);
+    ASSERT_EQ(serialized[0].firstElementFieldNameStringData(),
+              DocumentSourceInternalUnpackBucket::kStageName);
+}
+
+TEST_F(InternalUnpackBucketStageTest, AddsBucketLevelFilterForTimePredicates) {
+    auto pipeline = Pipeline::parse(
+        {fromjson("{$_internalUnpackBucket: {exclude: [], timeField: 'time'}}"),
+         fromjson("{$match: {time: {$gte: {$date: 1000}, $lt: {$date: 2000}}, x: {$gt: 1}}}")},
+        getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(serialized.size(), 3U);
+    ASSERT_BSONOBJ_EQ(serialized[0],
+                      fromjson("{$match: {$and: [{'control.max.time': {$gte: {$date: 1000}}}, "
+                               "{'control.min.time': {$lt: {$date: 2000}}}]}}"));
+    ASSERT_EQ(serialized[1].firstElementFieldNameStringData(),
+              DocumentSourceInternalUnpackBucket::kStageName);
+
+    // The original predicate still applies to the measurements.
+    ASSERT_EQ(serialized[2].firstElementFieldNameStringData(), "$match"_sd);
+}
+
+TEST_F(InternalUnpackBucketStageTest, DoesNotAddBucketLevelFilterForNonDateTimePredicates) {
+    auto pipeline = Pipeline::parse(
+        {fromjson("{$_internalUnpackBucket: {exclude: [], timeField: 'time'}}"),
+         fromjson("{$match: {time: {$gte: 5}}}")},
+        getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(serialized.size(), 2U);
+    ASSERT_EQ(serialized[0].firstElementFieldNameStringData(),
+              DocumentSourceInternalUnpackBucket::kStageName);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,16 +31,22 @@
 
 #include "mongo/db/pipeline/document_source_lookup.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/base/init.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/collation/collation_spec.h"
+#include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/util/fail_point.h"
@@ -93,7 +99,7 @@ DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
 
     _userPipeline = std::move(pipeline);
 
-    _cache.emplace(internalDocumentSourceLookupCacheSizeBytes.load());
+    _cache.emplace(internalDocumentSourceLookupCacheSizeBytes.load(), getCacheTempDir());
 
     for (auto&& varElem : letVariables) {
         const auto varName = varElem.fieldNameStringData();
@@ -249,32 +255,97 @@ bool foreignShardedLookupAllowed() {
 }
 }  // namespace
 
-DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
-    if (_unwindSrc) {
-        return unwindResult();
+DocumentSourceLookUp::ForeignDocumentTable::ForeignDocumentTable(
+    const FieldPath& foreignField, const ValueComparator& comparator)
+    : _foreignPath(foreignField.fullPath()),
+      _docsByValue(comparator.makeUnorderedValueMap<std::vector<size_t>>()) {}
+
+bool DocumentSourceLookUp::ForeignDocumentTable::add(Document doc, long long maxSizeBytes) {
+    // Index the document under every element that an equality predicate on the foreign field
+    // would be evaluated against, including whole arrays as well as their elements.
+    const auto obj = doc.toBson();
+    const auto docIndex = _docs.size();
+    long long addedBytes = doc.getApproximateSize();
+    std::vector<Value> values;
+    BSONElementIterator it(&_foreignPath, obj);
+    while (it.more()) {
+        auto elem = it.next().element();
+        if (!elem.eoo()) {
+            values.emplace_back(elem);
+            addedBytes += values.back().getApproximateSize() + sizeof(size_t);
+        }
     }
 
-    auto nextInput = pSource->getNext();
-    if (!nextInput.isAdvanced()) {
-        return nextInput;
+    if (_sizeBytes + addedBytes > maxSizeBytes) {
+        return false;
     }
+    _sizeBytes += addedBytes;
 
-    auto inputDoc = nextInput.releaseDocument();
+    for (auto&& value : values) {
+        auto& docIndexes = _docsByValue[std::move(value)];
+        if (docIndexes.empty() || docIndexes.back() != docIndex) {
+            docIndexes.push_back(docIndex);
+        }
+    }
+    _docs.push_back(std::move(doc));
+    return true;
+}
 
-    // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
-    // '_unwindSrc' would be non-null, and we would not have made it here.
-    invariant(!_matchSrc);
+std::vector<Document> DocumentSourceLookUp::ForeignDocumentTable::probe(
+    const std::vector<Value>& localValues) const {
+    std::vector<size_t> docIndexes;
+    for (auto&& value : localValues) {
+        auto it = _docsByValue.find(value);
+        if (it != _docsByValue.end()) {
+            docIndexes.insert(docIndexes.end(), it->second.begin(), it->second.end());
+        }
+    }
 
-    if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
-        // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-        _resolvedPipeline.back() = matchStage;
+    // A foreign document matching several of the local values is only joined once.
+    if (localValues.size() > 1) {
+        std::sort(docIndexes.begin(), docIndexes.end());
+        docIndexes.erase(std::unique(docIndexes.begin(), docIndexes.end()), docIndexes.end());
     }
 
-    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    std::vector<Document> joined;
+    joined.reserve(docIndexes.size());
+    for (auto docIndex : docIndexes) {
+        joined.push_back(_docs[docIndex]);
+    }
+    return joined;
+}
+
+bool DocumentSourceLookUp::canJoinWithoutPerDocumentPipeline() const {
+    // A sharded foreign collection is read through the same sub-pipeline targeting as for a single
+    // input document, so the batched $in queries are routed to the shards owning their values and
+    // the hash join table is built from a single read of the foreign side across all shards.
+    return !wasConstructedWithPipelineSyntax();
+}
+
+boost::optional<std::vector<Value>> DocumentSourceLookUp::getLocalValues(
+    const Document& input) const {
+    std::vector<Value> localValues;
+    bool needsSubPipeline = false;
+    document_path_support::visitAllValuesAtPath(input, *_localField, [&](const Value& value) {
+        // An equality to null also matches missing foreign fields, which the table does not
+        // index, and an equality to undefined is rejected by the query parser. A regular
+        // expression is kept out of the table probe and the batched $in query, where it would
+        // pattern match strings, and is joined by the sub-pipeline's equality query instead.
+        needsSubPipeline =
+            needsSubPipeline || value.nullish() || value.getType() == BSONType::RegEx;
+        localValues.push_back(value);
+    });
+
+    if (needsSubPipeline || localValues.empty()) {
+        return boost::none;
+    }
+    return localValues;
+}
+
+std::unique_ptr<Pipeline, PipelineDeleter>
+DocumentSourceLookUp::buildPipelineCheckingForeignSharding(const Document& inputDoc) {
     try {
-        pipeline = buildPipeline(inputDoc);
+        return buildPipeline(inputDoc);
     } catch (const ExceptionForCat<ErrorCategory::StaleShardVersionError>& ex) {
         // If lookup on a sharded collection is disallowed and the foreign collection is sharded,
         // throw a custom exception.
@@ -286,14 +357,235 @@ DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
         }
         throw;
     }
+}
+
+bool DocumentSourceLookUp::foreignTableIsWorthBuilding() const {
+    if (pExpCtx->inMongos) {
+        return false;
+    }
+
+    auto opCtx = _fromExpCtx->opCtx;
+    const auto& processInterface = _fromExpCtx->mongoProcessInterface;
+
+    // Reading a sharded foreign collection in full scatter-gathers it from every shard, and neither
+    // its indexes nor its size can be read from a single shard.
+    if (processInterface->isSharded(opCtx, _resolvedNs)) {
+        return false;
+    }
+
+    // The batched $in queries are answered by an index on 'foreignField' without reading the rest
+    // of the foreign collection, whereas the table has to read all of it.
+    const auto collatorSpec = _fromExpCtx->getCollator()
+        ? _fromExpCtx->getCollator()->getSpec().toBSON()
+        : CollationSpec::kSimpleSpec;
+    for (auto&& spec : processInterface->getIndexSpecs(opCtx, _resolvedNs, false)) {
+        const auto keyPattern = spec[IndexDescriptor::kKeyPatternFieldName].Obj();
+        const auto indexType = IndexNames::findPluginName(keyPattern);
+        const auto indexCollation = spec.hasField(IndexDescriptor::kCollationFieldName)
+            ? spec[IndexDescriptor::kCollationFieldName].Obj()
+            : CollationSpec::kSimpleSpec;
+        if (keyPattern.firstElementFieldNameStringData() == _foreignField->fullPath() &&
+            (indexType == IndexNames::BTREE || indexType == IndexNames::HASHED) &&
+            !spec.hasField(IndexDescriptor::kPartialFilterExprFieldName) &&
+            SimpleBSONObjComparator::kInstance.evaluate(indexCollation == collatorSpec)) {
+            return false;
+        }
+    }
+
+    // Only start reading a foreign collection whose data is known to fit in the table, rather than
+    // finding out after having read as much of it as the table can hold.
+    BSONObjBuilder stats;
+    if (!processInterface->appendStorageStats(opCtx, _resolvedNs, BSONObj(), &stats).isOK()) {
+        return false;
+    }
+    const auto dataSize = stats.obj()["size"];
+    return dataSize.isNumber() &&
+        dataSize.safeNumberLong() <= internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+}
+
+bool DocumentSourceLookUp::buildForeignTable() {
+    invariant(!_foreignTable);
+
+    // Read the foreign side through the regular sub-pipeline, so that any view definition is
+    // applied, with the trailing $match reduced to the predicates absorbed from a later $match.
+    _resolvedPipeline.back() = BSON("$match" << _additionalFilter.value_or(BSONObj()));
+    auto pipeline = buildPipelineCheckingForeignSharding(Document());
+
+    const auto maxSizeBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    _foreignTable.emplace(*_foreignField, _fromExpCtx->getValueComparator());
+    while (auto result = pipeline->getNext()) {
+        if (!_foreignTable->add(result->getOwned(), maxSizeBytes)) {
+            _foreignTable.reset();
+            break;
+        }
+    }
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+    return static_cast<bool>(_foreignTable);
+}
+
+void DocumentSourceLookUp::fillPendingInputs() {
+    auto nextInput = pSource->getNext();
+    if (!nextInput.isAdvanced()) {
+        _deferredInputResult = std::move(nextInput);
+        return;
+    }
+
+    const auto batchSize = static_cast<size_t>(internalDocumentSourceLookupBatchedProbeSize.load());
+    if (_joinStrategy == JoinStrategy::kUndecided) {
+        _joinStrategy = canJoinWithoutPerDocumentPipeline() ? JoinStrategy::kBatchedIn
+                                                            : JoinStrategy::kPerDocument;
+    }
+
+    // Only read the whole foreign side once the input has turned out to be larger than a single
+    // batch, so that a $lookup over a few local documents never scans the foreign collection.
+    if (_joinStrategy == JoinStrategy::kBatchedIn && !_foreignTableAbandoned &&
+        _numInputsJoined >= static_cast<long long>(batchSize) &&
+        internalDocumentSourceLookupHashJoinMaxMemoryBytes.load() > 0) {
+        if (foreignTableIsWorthBuilding() && buildForeignTable()) {
+            _joinStrategy = JoinStrategy::kHashJoin;
+        } else {
+            _foreignTableAbandoned = true;
+        }
+    }
+
+    switch (_joinStrategy) {
+        case JoinStrategy::kUndecided:
+            MONGO_UNREACHABLE;
+        case JoinStrategy::kPerDocument: {
+            _pendingInputs.push_back({nextInput.releaseDocument(), boost::none});
+            return;
+        }
+        case JoinStrategy::kHashJoin: {
+            auto input = nextInput.releaseDocument();
+            auto localValues = getLocalValues(input);
+            auto joined = localValues
+                ? boost::make_optional(_foreignTable->probe(*localValues))
+                : boost::none;
+            _pendingInputs.push_back({std::move(input), std::move(joined)});
+            ++_numInputsJoined;
+            return;
+        }
+        case JoinStrategy::kBatchedIn:
+            break;
+    }
+
+    std::vector<Document> batch{nextInput.releaseDocument()};
+    while (batch.size() < batchSize) {
+        nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            _deferredInputResult = std::move(nextInput);
+            break;
+        }
+        batch.push_back(nextInput.releaseDocument());
+    }
+    _numInputsJoined += batch.size();
+
+    // Query the foreign side once for the union of the batch's local values.
+    std::vector<boost::optional<std::vector<Value>>> localValuesPerInput;
+    localValuesPerInput.reserve(batch.size());
+    auto batchValues = _fromExpCtx->getValueComparator().makeUnorderedValueSet();
+    std::vector<Value> queryValues;
+    for (auto&& input : batch) {
+        localValuesPerInput.push_back(getLocalValues(input));
+        if (localValuesPerInput.back()) {
+            for (auto&& value : *localValuesPerInput.back()) {
+                if (batchValues.insert(value).second) {
+                    queryValues.push_back(value);
+                }
+            }
+        }
+    }
+
+    boost::optional<ForeignDocumentTable> batchTable;
+    if (!queryValues.empty()) {
+        _resolvedPipeline.back() =
+            makeMatchStageFromInput(Document{{"values"_sd, Value(std::move(queryValues))}},
+                                    FieldPath("values"),
+                                    _foreignField->fullPath(),
+                                    _additionalFilter.value_or(BSONObj()));
+        auto pipeline = buildPipelineCheckingForeignSharding(Document());
+
+        // The batch's results are bounded like the results for a single input document. If they
+        // do not fit, go back to running the sub-pipeline for every input document.
+        const auto maxSizeBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
+        batchTable.emplace(*_foreignField, _fromExpCtx->getValueComparator());
+        while (auto result = pipeline->getNext()) {
+            if (!batchTable->add(result->getOwned(), maxSizeBytes)) {
+                batchTable.reset();
+                _joinStrategy = JoinStrategy::kPerDocument;
+                break;
+            }
+        }
+        _usedDisk = _usedDisk || pipeline->usedDisk();
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto joined = batchTable && localValuesPerInput[i]
+            ? boost::make_optional(batchTable->probe(*localValuesPerInput[i]))
+            : boost::none;
+        _pendingInputs.push_back({std::move(batch[i]), std::move(joined)});
+    }
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextInput(
+    boost::optional<std::vector<Document>>* joined) {
+    if (_joinStrategy == JoinStrategy::kPerDocument && _pendingInputs.empty() &&
+        !_deferredInputResult) {
+        *joined = boost::none;
+        return pSource->getNext();
+    }
+
+    while (_pendingInputs.empty()) {
+        if (_deferredInputResult) {
+            auto result = std::move(*_deferredInputResult);
+            _deferredInputResult.reset();
+            return result;
+        }
+        fillPendingInputs();
+    }
+
+    auto pending = std::move(_pendingInputs.front());
+    _pendingInputs.pop_front();
+    *joined = std::move(pending.joined);
+    return std::move(pending.input);
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
+    if (_unwindSrc) {
+        return unwindResult();
+    }
+
+    boost::optional<std::vector<Document>> joined;
+    auto nextInput = getNextInput(&joined);
+    if (!nextInput.isAdvanced()) {
+        return nextInput;
+    }
+
+    auto inputDoc = nextInput.releaseDocument();
+
+    // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
+    // '_unwindSrc' would be non-null, and we would not have made it here.
+    invariant(!_matchSrc);
+
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    if (!joined) {
+        if (!wasConstructedWithPipelineSyntax()) {
+            auto matchStage = makeMatchStageFromInput(
+                inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
+            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+            _resolvedPipeline.back() = matchStage;
+        }
+
+        pipeline = buildPipelineCheckingForeignSharding(inputDoc);
+    }
 
     std::vector<Value> results;
     long long objsize = 0;
     const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
 
-    while (auto result = pipeline->getNext()) {
+    auto appendResult = [&](Document result) {
         long long safeSum = 0;
-        bool hasOverflowed = overflow::add(objsize, result->getApproximateSize(), &safeSum);
+        bool hasOverflowed = overflow::add(objsize, result.getApproximateSize(), &safeSum);
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll()
                               << " matching pipeline's $lookup stage exceeds " << maxBytes
@@ -301,9 +593,19 @@ DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
 
                 !hasOverflowed && objsize <= maxBytes);
         objsize = safeSum;
-        results.emplace_back(std::move(*result));
+        results.emplace_back(std::move(result));
+    };
+
+    if (joined) {
+        for (auto&& result : *joined) {
+            appendResult(std::move(result));
+        }
+    } else {
+        while (auto result = pipeline->getNext()) {
+            appendResult(std::move(*result));
+        }
+        _usedDisk = _usedDisk || pipeline->usedDisk();
     }
-    _usedDisk = _usedDisk || pipeline->usedDisk();
 
     MutableDocument output(std::move(inputDoc));
     output.setNestedField(_as, Value(std::move(results)));
@@ -505,7 +807,7 @@ Pipeline::SourceContainer::iterator DocumentSourceLookUp::doOptimizeAt(
 bool DocumentSourceLookUp::usedDisk() {
     if (_pipeline)
         _usedDisk = _usedDisk || _pipeline->usedDisk();
-    return _usedDisk;
+    return _usedDisk || (_cache && _cache->isSpilled());
 }
 
 void DocumentSourceLookUp::doDispose() {
@@ -514,6 +816,9 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _unwindJoined.reset();
+    _foreignTable.reset();
+    _pendingInputs.clear();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -606,36 +911,44 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
-        auto nextInput = pSource->getNext();
+    while ((!_pipeline && !_unwindJoined) || !_nextValue) {
+        boost::optional<std::vector<Document>> joined;
+        auto nextInput = getNextInput(&joined);
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
 
         _input = nextInput.releaseDocument();
 
-        if (!wasConstructedWithPipelineSyntax()) {
-            BSONObj filter = _additionalFilter.value_or(BSONObj());
-            auto matchStage =
-                makeMatchStageFromInput(*_input, *_localField, _foreignField->fullPath(), filter);
-            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-            _resolvedPipeline.back() = matchStage;
-        }
-
         if (_pipeline) {
             _usedDisk = _usedDisk || _pipeline->usedDisk();
             _pipeline->dispose(pExpCtx->opCtx);
+            _pipeline.reset();
         }
 
-        _pipeline = buildPipeline(*_input);
+        _unwindJoined = std::move(joined);
+        _unwindJoinedIndex = 0;
+
+        if (!_unwindJoined) {
+            if (!wasConstructedWithPipelineSyntax()) {
+                BSONObj filter = _additionalFilter.value_or(BSONObj());
+                auto matchStage = makeMatchStageFromInput(
+                    *_input, *_localField, _foreignField->fullPath(), filter);
+                // We've already allocated space for the trailing $match stage in
+                // '_resolvedPipeline'.
+                _resolvedPipeline.back() = matchStage;
+            }
+
+            _pipeline = buildPipeline(*_input);
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = nextUnwindValue();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -653,7 +966,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = nextUnwindValue();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -667,6 +980,16 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     return output.freeze();
 }
 
+boost::optional<Document> DocumentSourceLookUp::nextUnwindValue() {
+    if (_unwindJoined) {
+        if (_unwindJoinedIndex == _unwindJoined->size()) {
+            return boost::none;
+        }
+        return (*_unwindJoined)[_unwindJoinedIndex++];
+    }
+    return _pipeline->getNext();
+}
+
 void DocumentSourceLookUp::resolveLetVariables(const Document& localDoc, Variables* variables) {
     invariant(variables);
 
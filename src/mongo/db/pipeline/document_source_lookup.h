@@ -30,8 +30,11 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
+#include <vector>
 
 #include "mongo/db/exec/document_value/value_comparator.h"
+#include "mongo/db/matcher/path.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_sequential_document_cache.h"
@@ -162,6 +165,33 @@ public:
         return _localField;
     }
 
+    const NamespaceString& getFromNs() const {
+        return _fromNs;
+    }
+
+    /**
+     * Returns the namespace the foreign side is read from, which differs from 'getFromNs()' when
+     * the $lookup is on a view.
+     */
+    const NamespaceString& getResolvedNs() const {
+        return _resolvedNs;
+    }
+
+    const FieldPath& getAsField() const {
+        return _as;
+    }
+
+    const boost::optional<BSONObj>& getAdditionalFilter() const {
+        return _additionalFilter;
+    }
+
+    /**
+     * Returns the $unwind stage absorbed by this $lookup, or null if there is none.
+     */
+    const boost::intrusive_ptr<DocumentSourceUnwind>& getUnwindSource() const {
+        return _unwindSrc;
+    }
+
     const std::vector<LetVariable>& getLetVariables() const {
         return _letVariables;
     }
@@ -240,8 +270,116 @@ private:
         MONGO_UNREACHABLE;
     }
 
+    /**
+     * How a $lookup specified with localField/foreignField syntax finds the foreign documents for
+     * each input document.
+     */
+    enum class JoinStrategy {
+        // The strategy is chosen when the first input document arrives.
+        kUndecided,
+        // Build and run the sub-pipeline once per input document.
+        kPerDocument,
+        // Query the foreign collection once per group of input documents with the union of their
+        // local values, and distribute the results among the group.
+        kBatchedIn,
+        // Read the whole foreign side once into a hash table keyed on 'foreignField', and probe it
+        // for every input document.
+        kHashJoin,
+    };
+
+    /**
+     * Foreign documents held in memory and indexed by every value the matcher would compare
+     * against in an equality predicate on 'foreignField', so that a localField/foreignField join
+     * can be answered without querying the foreign collection.
+     */
+    class ForeignDocumentTable {
+    public:
+        ForeignDocumentTable(const FieldPath& foreignField, const ValueComparator& comparator);
+
+        /**
+         * Adds 'doc' to the table. Returns false without adding it if the table would grow beyond
+         * 'maxSizeBytes'.
+         */
+        bool add(Document doc, long long maxSizeBytes);
+
+        /**
+         * Returns the documents with a value equal to any of 'localValues' at 'foreignField', in
+         * the order they were added.
+         */
+        std::vector<Document> probe(const std::vector<Value>& localValues) const;
+
+    private:
+        ElementPath _foreignPath;
+        std::vector<Document> _docs;
+        ValueUnorderedMap<std::vector<size_t>> _docsByValue;
+        long long _sizeBytes = 0;
+    };
+
+    /**
+     * An input document whose foreign documents have already been found by the batched or hash
+     * join strategy. 'joined' is boost::none if the sub-pipeline must be run for 'input' instead.
+     */
+    struct PendingInput {
+        Document input;
+        boost::optional<std::vector<Document>> joined;
+    };
+
     GetNextResult unwindResult();
 
+    /**
+     * Returns the next input document from the source. If the foreign documents for it were found
+     * without running the sub-pipeline, sets 'joined' to them, otherwise sets it to boost::none.
+     */
+    GetNextResult getNextInput(boost::optional<std::vector<Document>>* joined);
+
+    /**
+     * Reads the next input document, or the next group of them with the batched strategy, joins
+     * them and appends them to '_pendingInputs'. Stashes a non-advanced result from the source in
+     * '_deferredInputResult' so that it is returned once '_pendingInputs' has been drained.
+     */
+    void fillPendingInputs();
+
+    /**
+     * Returns true if this $lookup can look up foreign documents without building a sub-pipeline
+     * for every input document.
+     */
+    bool canJoinWithoutPerDocumentPipeline() const;
+
+    /**
+     * Returns true if the foreign collection is unsharded, has no index that could answer an
+     * equality predicate on 'foreignField', and its data fits in
+     * 'internalDocumentSourceLookupHashJoinMaxMemoryBytes', so that reading all of it into
+     * '_foreignTable' is cheaper than the batched $in queries.
+     */
+    bool foreignTableIsWorthBuilding() const;
+
+    /**
+     * Reads the foreign side, filtered by any absorbed $match, into '_foreignTable'. Returns false
+     * and leaves '_foreignTable' empty if it does not fit in
+     * 'internalDocumentSourceLookupHashJoinMaxMemoryBytes'.
+     */
+    bool buildForeignTable();
+
+    /**
+     * Returns the values of the local field of 'input' to join on, or boost::none if the
+     * sub-pipeline must be used for 'input' since it joins on null, undefined, a regular
+     * expression or a missing field.
+     */
+    boost::optional<std::vector<Value>> getLocalValues(const Document& input) const;
+
+    /**
+     * Builds the sub-pipeline via buildPipeline(), turning a stale shard version for a sharded
+     * foreign collection into a user-facing error when sharded $lookup is not allowed.
+     */
+    std::unique_ptr<Pipeline, PipelineDeleter> buildPipelineCheckingForeignSharding(
+        const Document& inputDoc);
+
+    /**
+     * Returns the next foreign document for the current input when unwinding, from either
+     * '_unwindJoined' or '_pipeline'.
+     */
+    boost::optional<Document> nextUnwindValue();
+
     /**
      * Resolves let defined variables against 'localDoc' and stores the results in 'variables'.
      */
@@ -267,7 +405,15 @@ private:
     void reInitializeCache(size_t maxCacheSizeBytes) {
         invariant(wasConstructedWithPipelineSyntax());
         invariant(!_cache || (_cache->isBuilding() && _cache->sizeBytes() == 0));
-        _cache.emplace(maxCacheSizeBytes);
+        _cache.emplace(maxCacheSizeBytes, getCacheTempDir());
+    }
+
+    /**
+     * Returns the directory to which the cache spills once it exceeds its maximum size, or an
+     * empty string if the cache must be abandoned instead because disk use is not allowed.
+     */
+    std::string getCacheTempDir() const {
+        return pExpCtx->allowDiskUse && !pExpCtx->inMongos ? pExpCtx->tempDir : std::string();
     }
 
     bool _usedDisk = false;
@@ -289,7 +435,8 @@ private:
     // Caches documents returned by the non-correlated prefix of the $lookup pipeline during the
     // first iteration, up to a specified size limit in bytes. If this limit is not exceeded by the
     // time we hit EOF, subsequent iterations of the pipeline will draw from the cache rather than
-    // from a cursor source.
+    // from a cursor source. When disk use is allowed, the cache spills to disk instead of being
+    // abandoned once it exceeds the limit.
     boost::optional<SequentialDocumentCache> _cache;
 
     // The ExpressionContext used when performing aggregation pipelines against the '_resolvedNs'
@@ -317,6 +464,16 @@ private:
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+    boost::optional<std::vector<Document>> _unwindJoined;
+    size_t _unwindJoinedIndex = 0;
+
+    // State for joining localField/foreignField $lookups without a sub-pipeline per document.
+    JoinStrategy _joinStrategy = JoinStrategy::kUndecided;
+    boost::optional<ForeignDocumentTable> _foreignTable;
+    bool _foreignTableAbandoned = false;
+    long long _numInputsJoined = 0;
+    std::deque<PendingInput> _pendingInputs;
+    boost::optional<GetNextResult> _deferredInputResult;
 };
 
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/exec/document_value/value.h"
@@ -48,6 +49,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -490,7 +492,7 @@ public:
           _removeLeadingQueryStages(removeLeadingQueryStages) {}
 
     bool isSharded(OperationContext* opCtx, const NamespaceString& ns) final {
-        return false;
+        return _sharded;
     }
 
     std::unique_ptr<Pipeline, PipelineDeleter> attachCursorSourceToPipeline(
@@ -508,12 +510,56 @@ public:
 
         pipeline->addInitialSource(
             DocumentSourceMock::createForTest(_mockResults, pipeline->getContext()));
+        ++_numAttachedPipelines;
         return pipeline;
     }
 
+    std::list<BSONObj> getIndexSpecs(OperationContext* opCtx,
+                                     const NamespaceString& ns,
+                                     bool includeBuildUUIDs) final {
+        return _indexSpecs;
+    }
+
+    Status appendStorageStats(OperationContext* opCtx,
+                              const NamespaceString& nss,
+                              const BSONObj& param,
+                              BSONObjBuilder* builder) const final {
+        long long dataSize = 0;
+        for (auto&& result : _mockResults) {
+            if (result.isAdvanced()) {
+                dataSize += result.getDocument().toBson().objsize();
+            }
+        }
+        builder->appendNumber("size", _dataSize.value_or(dataSize));
+        return Status::OK();
+    }
+
+    int numAttachedPipelines() const {
+        return _numAttachedPipelines;
+    }
+
+    void setSharded(bool sharded) {
+        _sharded = sharded;
+    }
+
+    void setIndexSpecs(std::list<BSONObj> indexSpecs) {
+        _indexSpecs = std::move(indexSpecs);
+    }
+
+    /**
+     * Reports 'dataSize' as the size of the collection instead of the size of the mock results.
+     */
+    void setDataSize(long long dataSize) {
+        _dataSize = dataSize;
+    }
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    int _numAttachedPipelines = 0;
+    bool _sharded = false;
+    std::list<BSONObj> _indexSpecs;
+    boost::optional<long long> _dataSize;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -624,6 +670,355 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     lookup->dispose();
 }
 
+//
+// Tests for joining localField/foreignField $lookups without a sub-pipeline per input document.
+//
+
+/**
+ * Runs a $lookup of 'localInputs' against 'foreignContents' on "lk" = "fk", returning the output
+ * documents and setting 'numAttachedPipelines' to the number of queries against the foreign side.
+ */
+vector<Document> runLocalForeignLookup(const intrusive_ptr<ExpressionContext>& expCtx,
+                                       deque<DocumentSource::GetNextResult> localInputs,
+                                       const vector<Document>& foreignDocs,
+                                       bool unwind,
+                                       int* numAttachedPipelines,
+                                       std::list<BSONObj> foreignIndexes = {},
+                                       boost::optional<long long> foreignDataSize = boost::none,
+                                       bool foreignSharded = false) {
+    deque<DocumentSource::GetNextResult> foreignContents;
+    for (auto&& doc : foreignDocs) {
+        foreignContents.emplace_back(Document(doc));
+    }
+
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(foreignContents));
+    mongoInterface->setSharded(foreignSharded);
+    mongoInterface->setIndexSpecs(std::move(foreignIndexes));
+    if (foreignDataSize) {
+        mongoInterface->setDataSize(*foreignDataSize);
+    }
+    expCtx->mongoProcessInterface = mongoInterface;
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "lk"_sd},
+                                         {"foreignField", "fk"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+    if (unwind) {
+        lookup->setUnwindStage(DocumentSourceUnwind::create(expCtx, "joined", false, boost::none));
+    }
+
+    auto mockLocalSource = DocumentSourceMock::createForTest(std::move(localInputs), expCtx);
+    lookup->setSource(mockLocalSource.get());
+
+    vector<Document> results;
+    for (auto next = lookup->getNext(); next.isAdvanced(); next = lookup->getNext()) {
+        results.push_back(next.releaseDocument());
+    }
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+
+    *numAttachedPipelines = mongoInterface->numAttachedPipelines();
+    return results;
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldJoinWithForeignTableOnceInputExceedsABatch) {
+    const auto originalBatchSize = internalDocumentSourceLookupBatchedProbeSize.load();
+    internalDocumentSourceLookupBatchedProbeSize.store(1);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupBatchedProbeSize.store(originalBatchSize); });
+
+    Document foreign0{{"_id", 0}, {"fk", 1}};
+    Document foreign1{{"_id", 1}, {"fk", vector<Value>{Value(1), Value(2)}}};
+    Document foreign2{{"_id", 2}, {"fk", vector<Value>{Value(vector<Value>{Value(3)})}}};
+    Document foreign3{{"_id", 3}};
+
+    int numAttachedPipelines = 0;
+    auto results = runLocalForeignLookup(
+        getExpCtx(),
+        {Document{{"_id", 0}, {"lk", 1}},
+         Document{{"_id", 1}, {"lk", vector<Value>{Value(2), Value(3)}}},
+         Document{{"_id", 2}, {"lk", vector<Value>{Value(vector<Value>{Value(3)})}}},
+         Document{{"_id", 3}}},
+        {foreign0, foreign1, foreign2, foreign3},
+        false,
+        &numAttachedPipelines);
+
+    ASSERT_EQ(results.size(), 4U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign0), Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{Value(foreign2)}));
+    ASSERT_VALUE_EQ(results[3]["joined"], Value(vector<Value>{Value(foreign3)}));
+
+    // One query for the first batch, one to build the table, and one for the missing local field,
+    // which still runs the sub-pipeline since an equality to null also matches missing fields.
+    ASSERT_EQ(numAttachedPipelines, 3);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldFallBackToBatchedQueriesIfForeignTableDoesNotFit) {
+    const auto originalBatchSize = internalDocumentSourceLookupBatchedProbeSize.load();
+    const auto originalMaxMemory = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    internalDocumentSourceLookupBatchedProbeSize.store(2);
+    internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupBatchedProbeSize.store(originalBatchSize);
+        internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(originalMaxMemory);
+    });
+
+    Document foreign0{{"_id", 0}, {"fk", 0}};
+    Document foreign1{{"_id", 1}, {"fk", 1}};
+    Document foreign2{{"_id", 2}, {"fk", 0}};
+
+    // Report an empty collection, so that the table is only found not to fit while building it.
+    int numAttachedPipelines = 0;
+    auto results = runLocalForeignLookup(getExpCtx(),
+                                         {Document{{"_id", 0}, {"lk", 0}},
+                                          Document{{"_id", 1}, {"lk", 1}},
+                                          Document{{"_id", 2}, {"lk", 0}}},
+                                         {foreign0, foreign1, foreign2},
+                                         false,
+                                         &numAttachedPipelines,
+                                         {},
+                                         0);
+
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign0), Value(foreign2)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{Value(foreign0), Value(foreign2)}));
+
+    // One query per batch of two input documents, plus the abandoned attempt to build the table.
+    ASSERT_EQ(numAttachedPipelines, 3);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotBuildForeignTableIfForeignCollectionIsTooLarge) {
+    const auto originalBatchSize = internalDocumentSourceLookupBatchedProbeSize.load();
+    internalDocumentSourceLookupBatchedProbeSize.store(2);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupBatchedProbeSize.store(originalBatchSize); });
+
+    Document foreign0{{"_id", 0}, {"fk", 0}};
+    Document foreign1{{"_id", 1}, {"fk", 1}};
+
+    int numAttachedPipelines = 0;
+    auto results =
+        runLocalForeignLookup(getExpCtx(),
+                              {Document{{"_id", 0}, {"lk", 0}},
+                               Document{{"_id", 1}, {"lk", 1}},
+                               Document{{"_id", 2}, {"lk", 0}}},
+                              {foreign0, foreign1},
+                              false,
+                              &numAttachedPipelines,
+                              {},
+                              internalDocumentSourceLookupHashJoinMaxMemoryBytes.load() + 1);
+
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign0)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{Value(foreign0)}));
+
+    // One query per batch of two input documents, without reading the whole foreign collection.
+    ASSERT_EQ(numAttachedPipelines, 2);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotBuildForeignTableIfForeignFieldIsIndexed) {
+    const auto originalBatchSize = internalDocumentSourceLookupBatchedProbeSize.load();
+    internalDocumentSourceLookupBatchedProbeSize.store(2);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupBatchedProbeSize.store(originalBatchSize); });
+
+    Document foreign0{{"_id", 0}, {"fk", 0}};
+    Document foreign1{{"_id", 1}, {"fk", 1}};
+
+    int numAttachedPipelines = 0;
+    auto results = runLocalForeignLookup(getExpCtx(),
+                                         {Document{{"_id", 0}, {"lk", 0}},
+                                          Document{{"_id", 1}, {"lk", 1}},
+                                          Document{{"_id", 2}, {"lk", 0}}},
+                                         {foreign0, foreign1},
+                                         false,
+                                         &numAttachedPipelines,
+                                         {BSON("v" << 2 << "key" << BSON("_id" << 1) << "name"
+                                                   << "_id_"),
+                                          BSON("v" << 2 << "key" << BSON("fk" << 1 << "x" << 1)
+                                                   << "name"
+                                                   << "fk_1_x_1")});
+
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign0)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{Value(foreign0)}));
+
+    // One query per batch of two input documents, each of which the index on 'fk' can answer.
+    ASSERT_EQ(numAttachedPipelines, 2);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldBuildForeignTableIfNoIndexCanAnswerForeignField) {
+    const auto originalBatchSize = internalDocumentSourceLookupBatchedProbeSize.load();
+    internalDocumentSourceLookupBatchedProbeSize.store(1);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupBatchedProbeSize.store(originalBatchSize); });
+
+    Document foreign0{{"_id", 0}, {"fk", 0}};
+    Document foreign1{{"_id", 1}, {"fk", 1}};
+
+    // Neither a partial index, an index with a non-simple collation, a text index nor an index
+    // whose leading field is not 'fk' can answer every equality predicate on 'fk'.
+    int numAttachedPipelines = 0;
+    auto results = runLocalForeignLookup(
+        getExpCtx(),
+        {Document{{"_id", 0}, {"lk", 0}},
+         Document{{"_id", 1}, {"lk", 1}},
+         Document{{"_id", 2}, {"lk", 0}}},
+        {foreign0, foreign1},
+        false,
+        &numAttachedPipelines,
+        {BSON("v" << 2 << "key" << BSON("x" << 1 << "fk" << 1) << "name"
+                  << "x_1_fk_1"),
+         BSON("v" << 2 << "key" << BSON("fk" << 1) << "name"
+                  << "fk_1_partial"
+                  << "partialFilterExpression" << BSON("x" << 1)),
+         BSON("v" << 2 << "key" << BSON("fk" << 1) << "name"
+                  << "fk_1_collation"
+                  << "collation" << BSON("locale" << "fr")),
+         BSON("v" << 2 << "key" << BSON("fk" << "text") << "name"
+                  << "fk_text")});
+
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign0)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{Value(foreign0)}));
+
+    // One query for the first batch and one to build the table.
+    ASSERT_EQ(numAttachedPipelines, 2);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldJoinRegexLocalValuesOnlyWithEqualRegexes) {
+    const auto originalBatchSize = internalDocumentSourceLookupBatchedProbeSize.load();
+    internalDocumentSourceLookupBatchedProbeSize.store(1);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupBatchedProbeSize.store(originalBatchSize); });
+
+    Document foreign0{{"_id", 0}, {"fk", "abc"_sd}};
+    Document foreign1{{"_id", 1}, {"fk", Value(BSONRegEx("^a"))}};
+    Document foreign2{{"_id", 2}, {"fk", "abd"_sd}};
+
+    int numAttachedPipelines = 0;
+    auto results = runLocalForeignLookup(
+        getExpCtx(),
+        {Document{{"_id", 0}, {"lk", "abc"_sd}},
+         Document{{"_id", 1}, {"lk", Value(BSONRegEx("^a"))}},
+         Document{{"_id", 2}, {"lk", vector<Value>{Value("abc"_sd), Value(BSONRegEx("^a"))}}}},
+        {foreign0, foreign1, foreign2},
+        false,
+        &numAttachedPipelines);
+
+    // A regular expression local value does not pattern match the foreign strings.
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign0)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{Value(foreign0), Value(foreign1)}));
+
+    // One query for the first batch and one to build the table, while both inputs joining on a
+    // regular expression run the sub-pipeline.
+    ASSERT_EQ(numAttachedPipelines, 4);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldJoinWithForeignTableWhenShardedLookupIsAllowed) {
+    const auto originalBatchSize = internalDocumentSourceLookupBatchedProbeSize.load();
+    const auto originalAllowShardedLookup = internalQueryAllowShardedLookup.load();
+    const auto originalTestCommandsEnabled = getTestCommandsEnabled();
+    internalDocumentSourceLookupBatchedProbeSize.store(1);
+    internalQueryAllowShardedLookup.store(true);
+    setTestCommandsEnabled(true);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupBatchedProbeSize.store(originalBatchSize);
+        internalQueryAllowShardedLookup.store(originalAllowShardedLookup);
+        setTestCommandsEnabled(originalTestCommandsEnabled);
+    });
+
+    Document foreign0{{"_id", 0}, {"fk", 0}};
+    Document foreign1{{"_id", 1}, {"fk", 1}};
+
+    int numAttachedPipelines = 0;
+    auto results = runLocalForeignLookup(getExpCtx(),
+                                         {Document{{"_id", 0}, {"lk", 0}},
+                                          Document{{"_id", 1}, {"lk", 1}},
+                                          Document{{"_id", 2}, {"lk", 0}}},
+                                         {foreign0, foreign1},
+                                         false,
+                                         &numAttachedPipelines);
+
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign0)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{Value(foreign0)}));
+
+    // One query for the first batch and one to build the table, as for an unsharded collection.
+    ASSERT_EQ(numAttachedPipelines, 2);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotBuildForeignTableIfForeignCollectionIsSharded) {
+    const auto originalBatchSize = internalDocumentSourceLookupBatchedProbeSize.load();
+    const auto originalAllowShardedLookup = internalQueryAllowShardedLookup.load();
+    const auto originalTestCommandsEnabled = getTestCommandsEnabled();
+    internalDocumentSourceLookupBatchedProbeSize.store(2);
+    internalQueryAllowShardedLookup.store(true);
+    setTestCommandsEnabled(true);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupBatchedProbeSize.store(originalBatchSize);
+        internalQueryAllowShardedLookup.store(originalAllowShardedLookup);
+        setTestCommandsEnabled(originalTestCommandsEnabled);
+    });
+
+    Document foreign0{{"_id", 0}, {"fk", 0}};
+    Document foreign1{{"_id", 1}, {"fk", 1}};
+
+    int numAttachedPipelines = 0;
+    auto results = runLocalForeignLookup(getExpCtx(),
+                                         {Document{{"_id", 0}, {"lk", 0}},
+                                          Document{{"_id", 1}, {"lk", 1}},
+                                          Document{{"_id", 2}, {"lk", 0}}},
+                                         {foreign0, foreign1},
+                                         false,
+                                         &numAttachedPipelines,
+                                         {},
+                                         boost::none,
+                                         true);
+
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign0)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{Value(foreign0)}));
+
+    // One batched query per two input documents, without scatter-gathering the whole collection.
+    ASSERT_EQ(numAttachedPipelines, 2);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldUnwindResultsJoinedWithForeignTable) {
+    const auto originalBatchSize = internalDocumentSourceLookupBatchedProbeSize.load();
+    internalDocumentSourceLookupBatchedProbeSize.store(1);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupBatchedProbeSize.store(originalBatchSize); });
+
+    Document foreign0{{"_id", 0}, {"fk", 1}};
+    Document foreign1{{"_id", 1}, {"fk", vector<Value>{Value(1), Value(2)}}};
+
+    int numAttachedPipelines = 0;
+    auto results = runLocalForeignLookup(getExpCtx(),
+                                         {Document{{"_id", 0}, {"lk", 1}},
+                                          Document{{"_id", 1}, {"lk", 2}},
+                                          Document{{"_id", 2}, {"lk", 3}}},
+                                         {foreign0, foreign1},
+                                         true,
+                                         &numAttachedPipelines);
+
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_DOCUMENT_EQ(results[0], (Document{{"_id", 0}, {"lk", 1}, {"joined", foreign0}}));
+    ASSERT_DOCUMENT_EQ(results[1], (Document{{"_id", 0}, {"lk", 1}, {"joined", foreign1}}));
+    ASSERT_DOCUMENT_EQ(results[2], (Document{{"_id", 1}, {"lk", 2}, {"joined", foreign1}}));
+    ASSERT_EQ(numAttachedPipelines, 2);
+}
+
 TEST_F(DocumentSourceLookUpTest, LookupReportsAsFieldIsModified) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
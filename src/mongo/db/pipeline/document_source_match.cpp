@@ -37,6 +37,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/matcher/expression_array.h"
+#include "mongo/db/matcher/expression_expr.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -86,14 +87,7 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
 
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
-        // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
-        // only serialize the fields we need to do the match.
-        BSONObj toMatch = _dependencies.needWholeDocument
-            ? nextInput.getDocument().toBson()
-            : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
-                                                             _dependencies.fields);
-
-        if (_expression->matchesBSON(toMatch)) {
+        if (matches(nextInput.getDocument())) {
             return nextInput;
         }
 
@@ -108,6 +102,82 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
     return nextInput;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceMatch::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxDocs) {
+    if (_isTextQuery) {
+        return DocumentSource::doGetNextBatch(batch, maxDocs);
+    }
+
+    const auto batchStart = batch->size();
+    for (;;) {
+        auto status = pSource->getNextBatch(batch, maxDocs);
+        if (status != GetNextResult::ReturnStatus::kAdvanced) {
+            return status;
+        }
+
+        // Compact the matching documents to the front of the newly appended range, releasing the
+        // others as we go.
+        auto out = batch->begin() + batchStart;
+        for (auto it = out; it != batch->end(); ++it) {
+            if (matches(*it)) {
+                if (out != it) {
+                    *out = std::move(*it);
+                }
+                ++out;
+            } else {
+                *it = Document();
+            }
+        }
+        batch->erase(out, batch->end());
+
+        if (batch->size() > batchStart) {
+            return status;
+        }
+    }
+}
+
+bool DocumentSourceMatch::matches(const Document& doc) const {
+    if (!_exprCompiled) {
+        _compiledExpr = compileExprPredicate();
+        _exprCompiled = true;
+    }
+    if (_compiledExpr) {
+        if (auto result = _compiledExpr->evaluate(doc)) {
+            return result->coerceToBool();
+        }
+    }
+
+    // MatchExpression only takes BSON documents, so we have to make one. As an optimization, only
+    // serialize the fields we need to do the match.
+    BSONObj toMatch = _dependencies.needWholeDocument
+        ? doc.toBson()
+        : document_path_support::documentToBsonWithPaths(doc, _dependencies.fields);
+    return _expression->matchesBSON(toMatch);
+}
+
+std::unique_ptr<CompiledExpression> DocumentSourceMatch::compileExprPredicate() const {
+    // The predicates which the $expr rewrite adds can only reject documents the $expr rejects as
+    // well, so the $expr alone decides whether a document matches.
+    ExprMatchExpression* exprPredicate = nullptr;
+    if (_expression->matchType() == MatchExpression::EXPRESSION) {
+        exprPredicate = static_cast<ExprMatchExpression*>(_expression.get());
+    } else if (_expression->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < _expression->numChildren(); ++i) {
+            auto child = _expression->getChild(i);
+            if (child->matchType() == MatchExpression::EXPRESSION && !exprPredicate) {
+                exprPredicate = static_cast<ExprMatchExpression*>(child);
+            } else if (child->matchType() != MatchExpression::INTERNAL_EXPR_EQ) {
+                return nullptr;
+            }
+        }
+    }
+
+    if (!exprPredicate) {
+        return nullptr;
+    }
+    return expression_compiler::compile(pExpCtx.get(), exprPredicate->getExpression().get());
+}
+
 Pipeline::SourceContainer::iterator DocumentSourceMatch::doOptimizeAt(
     Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
     invariant(*itr == this);
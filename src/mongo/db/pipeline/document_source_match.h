@@ -36,6 +36,7 @@
 #include "mongo/client/connpool.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/expression_compiler.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -158,6 +159,11 @@ public:
         return _isTextQuery;
     }
 
+    /**
+     * Returns true if 'doc' satisfies the predicate of this $match.
+     */
+    bool matches(const Document& doc) const;
+
     /**
      * Attempt to split this $match into two stages, where the first is not dependent upon any path
      * from 'fields', and where applying them in sequence is equivalent to applying this stage once.
@@ -188,14 +194,28 @@ protected:
               other.pExpCtx) {}
 
     GetNextResult doGetNext() override;
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxDocs) override;
     DocumentSourceMatch(const BSONObj& query,
                         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     BSONObj _predicate;
 
 private:
+    /**
+     * Compiles the aggregation expression of a predicate which consists only of a $expr, along
+     * with any predicates rewritten from it. Returns nullptr if the predicate has any other shape
+     * or the expression cannot be compiled.
+     */
+    std::unique_ptr<CompiledExpression> compileExprPredicate() const;
+
     std::unique_ptr<MatchExpression> _expression;
 
+    // The compiled form of a $expr predicate, built by the first call to matches() once the
+    // pipeline has been optimized.
+    mutable std::unique_ptr<CompiledExpression> _compiledExpr;
+    mutable bool _exprCompiled = false;
+
     bool _isTextQuery;
 
     // Cache the dependencies so that we know what fields we need to serialize to BSON for matching.
@@ -32,6 +32,7 @@
 #include "mongo/platform/basic.h"
 
 #include <string>
+#include <vector>
 
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
@@ -41,6 +42,7 @@
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/logv2/log.h"
 #include "mongo/unittest/death_test.h"
@@ -503,6 +505,38 @@ TEST_F(DocumentSourceMatchTest, ShouldPropagatePauses) {
     ASSERT_TRUE(match->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceMatchTest, ShouldFilterBatchesAndPropagatePauses) {
+    auto match = DocumentSourceMatch::create(fromjson("{a: {$in: [1, 3, 5]}}"), getExpCtx());
+    auto sort = DocumentSourceSort::create(getExpCtx(), BSON("a" << 1));
+    auto mock =
+        DocumentSourceMock::createForTest({Document{{"a", 4}},
+                                           Document{{"a", 1}},
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"a", 5}},
+                                           Document{{"a", 2}},
+                                           Document{{"a", 3}}},
+                                          getExpCtx());
+    sort->setSource(mock.get());
+    match->setSource(sort.get());
+
+    std::vector<Document> batch;
+    ASSERT_TRUE(match->getNextBatch(&batch, 10) ==
+                DocumentSource::GetNextResult::ReturnStatus::kPauseExecution);
+    ASSERT_TRUE(batch.empty());
+
+    // The $sort produces all of its output at once, and only the matching documents are kept.
+    ASSERT_TRUE(match->getNextBatch(&batch, 10) ==
+                DocumentSource::GetNextResult::ReturnStatus::kAdvanced);
+    ASSERT_EQ(batch.size(), 3UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 1}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"a", 3}}));
+    ASSERT_DOCUMENT_EQ(batch[2], (Document{{"a", 5}}));
+
+    ASSERT_TRUE(match->getNextBatch(&batch, 10) ==
+                DocumentSource::GetNextResult::ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 3UL);
+}
+
 TEST_F(DocumentSourceMatchTest, ShouldCorrectlyJoinWithSubsequentMatch) {
     const auto match = DocumentSourceMatch::create(BSON("a" << 1), getExpCtx());
     const auto secondMatch = DocumentSourceMatch::create(BSON("b" << 1), getExpCtx());
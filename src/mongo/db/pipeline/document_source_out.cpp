@@ -38,6 +38,7 @@
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/pipeline/document_path_support.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/util/destructor_guard.h"
@@ -150,6 +151,13 @@ void DocumentSourceOut::initialize() {
         return;
     }
 
+    // Building the indexes once the temp collection is populated sorts the keys of all of the
+    // results in bulk, which is much cheaper than maintaining every index on each insert.
+    _buildIndexesAfterInsert = internalQueryOutBuildIndexesAfterInsert.load();
+    if (_buildIndexesAfterInsert) {
+        return;
+    }
+
     // Copy the indexes of the output collection to the temp collection.
     try {
         std::vector<BSONObj> tempNsIndexes = {std::begin(_originalIndexes),
@@ -165,6 +173,18 @@ void DocumentSourceOut::initialize() {
 void DocumentSourceOut::finalize() {
     DocumentSourceWriteBlock writeBlock(pExpCtx->opCtx);
 
+    if (_buildIndexesAfterInsert) {
+        try {
+            std::vector<BSONObj> tempNsIndexes = {std::begin(_originalIndexes),
+                                                  std::end(_originalIndexes)};
+            pExpCtx->mongoProcessInterface->createIndexesOnPopulatedCollection(
+                pExpCtx->opCtx, _tempNs, tempNsIndexes);
+        } catch (DBException& ex) {
+            ex.addContext("Building indexes for $out failed");
+            throw;
+        }
+    }
+
     const auto& outputNs = getOutputNs();
     auto renameCommandObj =
         BSON("renameCollection" << _tempNs.ns() << "to" << outputNs.ns() << "dropTarget" << true);
@@ -139,6 +139,10 @@ private:
     BSONObj _originalOutOptions;
     std::list<BSONObj> _originalIndexes;
 
+    // If true, the indexes in '_originalIndexes' are only copied to the temporary collection once
+    // all of the results have been inserted.
+    bool _buildIndexesAfterInsert = false;
+
     // The temporary namespace for the $out writes.
     NamespaceString _tempNs;
 };
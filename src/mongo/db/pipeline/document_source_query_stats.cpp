@@ -0,0 +1,81 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_query_stats.h"
+
+#include "mongo/db/stats/query_stats_store.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(queryStats,
+                         DocumentSourceQueryStats::LiteParsed::parse,
+                         DocumentSourceQueryStats::createFromBson);
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceQueryStats::createFromBson(
+    BSONElement spec, const boost::intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << kStageName
+                          << " value must be an object. Found: " << typeName(spec.type()),
+            spec.type() == BSONType::Object);
+
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << kStageName << " parameters object must be empty. Found: "
+                          << spec.embeddedObject(),
+            spec.embeddedObject().isEmpty());
+
+    uassert(ErrorCodes::InvalidNamespace,
+            str::stream() << kStageName
+                          << " must be run against the 'admin' database with {aggregate: 1}",
+            pExpCtx->ns.db() == NamespaceString::kAdminDb &&
+                pExpCtx->ns.isCollectionlessAggregateNS());
+
+    return new DocumentSourceQueryStats(pExpCtx);
+}
+
+DocumentSourceQueryStats::DocumentSourceQueryStats(
+    const boost::intrusive_ptr<ExpressionContext>& pExpCtx)
+    : DocumentSource(kStageName, pExpCtx) {}
+
+DocumentSource::GetNextResult DocumentSourceQueryStats::doGetNext() {
+    if (!_haveRetrievedStats) {
+        _results = QueryStatsStore::get(pExpCtx->opCtx->getServiceContext()).getStats();
+        _resultsIter = _results.begin();
+        _haveRetrievedStats = true;
+    }
+
+    if (_resultsIter == _results.end()) {
+        return GetNextResult::makeEOF();
+    }
+
+    return Document{*_resultsIter++};
+}
+
+}  // namespace mongo
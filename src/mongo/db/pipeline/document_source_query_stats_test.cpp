@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_query_stats.h"
+#include "mongo/db/stats/query_stats_store.h"
+#include "mongo/db/stats/query_stats_store_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+class DocumentSourceQueryStatsTest : public AggregationContextFixture {
+public:
+    DocumentSourceQueryStatsTest()
+        : AggregationContextFixture(NamespaceString::makeCollectionlessAggregateNSS("admin")) {}
+};
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldFailToParseIfSpecIsNotObject) {
+    const auto specObj = fromjson("{$queryStats: 1}");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::FailedToParse);
+}
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldFailToParseIfSpecIsANonEmptyObject) {
+    const auto specObj = fromjson("{$queryStats: {unknownOption: 1}}");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::FailedToParse);
+}
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldFailToParseOnACollection) {
+    getExpCtx()->ns = NamespaceString("admin.coll");
+    const auto specObj = fromjson("{$queryStats: {}}");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::InvalidNamespace);
+}
+
+TEST_F(DocumentSourceQueryStatsTest, CanParseAndSerializeSuccessfully) {
+    const auto specObj = fromjson("{$queryStats: {}}");
+    auto stage = DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx());
+    std::vector<Value> serialized;
+    stage->serializeToArray(serialized);
+    ASSERT_EQ(1u, serialized.size());
+    ASSERT_BSONOBJ_EQ(specObj, serialized[0].getDocument().toBson());
+}
+
+TEST_F(DocumentSourceQueryStatsTest, ReturnsOneDocumentPerQueryShape) {
+    const auto oldMaxEntries = gQueryStatsStoreMaxEntries;
+    ON_BLOCK_EXIT([&] { gQueryStatsStoreMaxEntries = oldMaxEntries; });
+    gQueryStatsStoreMaxEntries = 10;
+
+    auto& store = QueryStatsStore::get(getServiceContext());
+    store.record({"test.coll", "find", 1}, QueryStatsMetrics{}, Date_t::now());
+    store.record({"test.coll", "aggregate", 1}, QueryStatsMetrics{}, Date_t::now());
+
+    const auto specObj = fromjson("{$queryStats: {}}");
+    auto stage = DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx());
+
+    auto next = stage->getNext();
+    ASSERT(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["command"], Value("aggregate"_sd));
+
+    next = stage->getNext();
+    ASSERT(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["command"], Value("find"_sd));
+    ASSERT_VALUE_EQ(next.getDocument()["execCount"], Value(1LL));
+
+    ASSERT(stage->getNext().isEOF());
+}
+
+}  // namespace
+}  // namespace mongo
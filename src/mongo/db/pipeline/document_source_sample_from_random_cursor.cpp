@@ -38,6 +38,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/logv2/log.h"
@@ -49,12 +50,14 @@ DocumentSourceSampleFromRandomCursor::DocumentSourceSampleFromRandomCursor(
     const intrusive_ptr<ExpressionContext>& pExpCtx,
     long long size,
     std::string idField,
-    long long nDocsInCollection)
+    long long nDocsInCollection,
+    intrusive_ptr<DocumentSourceMatch> filter)
     : DocumentSource(kStageName, pExpCtx),
       _size(size),
       _idField(std::move(idField)),
       _seenDocs(pExpCtx->getValueComparator().makeUnorderedValueSet()),
-      _nDocsInColl(nDocsInCollection) {}
+      _nDocsInColl(nDocsInCollection),
+      _filter(std::move(filter)) {}
 
 const char* DocumentSourceSampleFromRandomCursor::getSourceName() const {
     return kStageName.rawData();
@@ -101,13 +104,24 @@ DocumentSource::GetNextResult DocumentSourceSampleFromRandomCursor::doGetNext()
 }
 
 DocumentSource::GetNextResult DocumentSourceSampleFromRandomCursor::getNextNonDuplicateDocument() {
+    if (_fallbackPipeline) {
+        return getNextFromFallbackPipeline();
+    }
+
     // We may get duplicate documents back from the random cursor, and should not return duplicate
-    // documents, so keep trying until we get a new one.
-    const int kMaxAttempts = 100;
+    // documents, so keep trying until we get a new one. A document which does not match '_filter'
+    // is another failed attempt, and a random cursor is only filtered if about one in 20 documents
+    // was estimated to match.
+    const int kMaxAttempts = _filter ? 2000 : 100;
     for (int i = 0; i < kMaxAttempts; ++i) {
+        pExpCtx->checkForInterrupt();
         auto nextInput = pSource->getNext();
         switch (nextInput.getStatus()) {
             case GetNextResult::ReturnStatus::kAdvanced: {
+                if (_filter && !_filter->matches(nextInput.getDocument())) {
+                    break;  // Try again with the next document.
+                }
+
                 auto idField = nextInput.getDocument()[_idField];
                 uassert(28793,
                         str::stream()
@@ -136,6 +150,11 @@ DocumentSource::GetNextResult DocumentSourceSampleFromRandomCursor::getNextNonDu
             }
         }
     }
+
+    if (_filter) {
+        // Fewer documents match than estimated, possibly fewer than '_size'.
+        return getNextFromFallbackPipeline();
+    }
     uasserted(28799,
               str::stream() << "$sample stage could not find a non-duplicate document after "
                             << kMaxAttempts
@@ -143,12 +162,68 @@ DocumentSource::GetNextResult DocumentSourceSampleFromRandomCursor::getNextNonDu
                                "sporadic failure, please try again.");
 }
 
+DocumentSource::GetNextResult DocumentSourceSampleFromRandomCursor::getNextFromFallbackPipeline() {
+    if (!_fallbackPipeline) {
+        LOGV2_DEBUG(4798626,
+                    1,
+                    "$sample found too few matching documents through a random cursor, and samples "
+                    "from all of the matching documents instead",
+                    "numReturned"_attr = _seenDocs.size(),
+                    "size"_attr = _size);
+        auto expCtx = pExpCtx->copyWith(pExpCtx->ns, pExpCtx->uuid);
+        auto pipeline = Pipeline::parse({BSON("$match" << _filter->getQuery())}, expCtx);
+        _fallbackPipeline =
+            pExpCtx->mongoProcessInterface->attachCursorSourceToPipelineForLocalRead(
+                pipeline.release());
+        // The $sample is only added once the cursor is attached, so that it is not answered by a
+        // random cursor again.
+        _fallbackPipeline->addFinalSource(DocumentSourceSample::create(expCtx, _size));
+    }
+
+    // The fallback pipeline returns '_size' matching documents in a uniformly random order. As at
+    // most '_seenDocs.size()' of them were returned already, the others include the first
+    // '_size - _seenDocs.size()' documents of a uniformly random order of the matching documents
+    // not returned yet, which complete the sample.
+    while (auto next = _fallbackPipeline->getNext()) {
+        if (_seenDocs.insert((*next)[_idField]).second) {
+            return std::move(*next);
+        }
+    }
+    return GetNextResult::makeEOF();
+}
+
+void DocumentSourceSampleFromRandomCursor::doDispose() {
+    if (_fallbackPipeline) {
+        _fallbackPipeline->dispose(pExpCtx->opCtx);
+        _fallbackPipeline.reset();
+    }
+}
+
+void DocumentSourceSampleFromRandomCursor::detachFromOperationContext() {
+    if (_fallbackPipeline) {
+        _fallbackPipeline->detachFromOperationContext();
+    }
+}
+
+void DocumentSourceSampleFromRandomCursor::reattachToOperationContext(OperationContext* opCtx) {
+    if (_fallbackPipeline) {
+        _fallbackPipeline->reattachToOperationContext(opCtx);
+    }
+}
+
 Value DocumentSourceSampleFromRandomCursor::serialize(
     boost::optional<ExplainOptions::Verbosity> explain) const {
-    return Value(DOC(getSourceName() << DOC("size" << _size)));
+    MutableDocument spec(DOC("size" << _size));
+    if (_filter) {
+        spec["filter"] = Value(_filter->getQuery());
+    }
+    return Value(DOC(getSourceName() << spec.freeze()));
 }
 
 DepsTracker::State DocumentSourceSampleFromRandomCursor::getDependencies(DepsTracker* deps) const {
+    if (_filter) {
+        _filter->getDependencies(deps);
+    }
     deps->fields.insert(_idField);
     return DepsTracker::State::SEE_NEXT;
 }
@@ -157,9 +232,11 @@ intrusive_ptr<DocumentSourceSampleFromRandomCursor> DocumentSourceSampleFromRand
     const intrusive_ptr<ExpressionContext>& expCtx,
     long long size,
     std::string idField,
-    long long nDocsInCollection) {
+    long long nDocsInCollection,
+    intrusive_ptr<DocumentSourceMatch> filter) {
     intrusive_ptr<DocumentSourceSampleFromRandomCursor> source(
-        new DocumentSourceSampleFromRandomCursor(expCtx, size, idField, nDocsInCollection));
+        new DocumentSourceSampleFromRandomCursor(
+            expCtx, size, idField, nDocsInCollection, std::move(filter)));
     return source;
 }
 }  // namespace mongo
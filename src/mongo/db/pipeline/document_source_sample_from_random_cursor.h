@@ -31,6 +31,8 @@
 
 #include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/pipeline.h"
 
 namespace mongo {
 
@@ -60,27 +62,47 @@ public:
         return boost::none;
     }
 
+    /**
+     * Creates a stage which samples 'size' documents from a random cursor over a collection of
+     * 'collectionSize' documents. If 'filter' is given, only the documents which match it are
+     * sampled, and 'collectionSize' is the estimated number of matching documents.
+     */
     static boost::intrusive_ptr<DocumentSourceSampleFromRandomCursor> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         long long size,
         std::string idField,
-        long long collectionSize);
+        long long collectionSize,
+        boost::intrusive_ptr<DocumentSourceMatch> filter = nullptr);
+
+    void detachFromOperationContext() final;
+
+    void reattachToOperationContext(OperationContext* opCtx) final;
 
 private:
     DocumentSourceSampleFromRandomCursor(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                          long long size,
                                          std::string idField,
-                                         long long collectionSize);
+                                         long long collectionSize,
+                                         boost::intrusive_ptr<DocumentSourceMatch> filter);
 
     GetNextResult doGetNext() final;
 
+    void doDispose() final;
+
     /**
-     * Keep asking for documents from the random cursor until it yields a new document. Errors if a
-     * a document is encountered without a value for '_idField', or if the random cursor keeps
-     * returning duplicate elements.
+     * Keep asking for documents from the random cursor until it yields a new document which matches
+     * '_filter'. Errors if a document is encountered without a value for '_idField', or if the
+     * random cursor keeps returning duplicate elements. With a '_filter', switches to
+     * '_fallbackPipeline' instead once too many documents in a row were duplicates or did not
+     * match, since the estimated number of matching documents was then too high.
      */
     GetNextResult getNextNonDuplicateDocument();
 
+    /**
+     * Returns the next document sampled by '_fallbackPipeline' which has not been returned yet.
+     */
+    GetNextResult getNextFromFallbackPipeline();
+
     long long _size;
 
     // The field to use as the id of a document. Usually '_id', but 'ts' for the oplog.
@@ -93,6 +115,14 @@ private:
     // The approximate number of documents in the collection (includes orphans).
     const long long _nDocsInColl;
 
+    // If set, only the documents from the random cursor which match this $match are sampled.
+    boost::intrusive_ptr<DocumentSourceMatch> _filter;
+
+    // Samples '_size' documents matching '_filter' by running it through the query planner and
+    // sorting the matching documents by a random value. Only built if the random cursor could not
+    // produce enough matching documents.
+    std::unique_ptr<Pipeline, PipelineDeleter> _fallbackPipeline;
+
     // The value to be assigned to the randMetaField of outcoming documents. Each call to getNext()
     // will decrement this value by an amount scaled by _nDocsInColl as an attempt to appear as if
     // the documents were produced by a top-k random sort.
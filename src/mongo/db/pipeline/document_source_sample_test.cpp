@@ -31,16 +31,19 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <memory>
+#include <set>
 
 #include "mongo/bson/bsonelement.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/process_interface/stub_mongo_process_interface.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
@@ -390,6 +393,88 @@ TEST_F(SampleFromRandomCursorBasics, MimicNonOptimized) {
     ASSERT_LTE(secondTotal / nTrials, 0.52);
 }
 
+/**
+ * Scans 'collection' in place of the query planner for the pipeline which a filtered
+ * $sampleFromRandomCursor stage falls back to.
+ */
+class FallbackMongoInterface final : public StubMongoProcessInterface {
+public:
+    explicit FallbackMongoInterface(std::deque<DocumentSource::GetNextResult> collection)
+        : _collection(std::move(collection)) {}
+
+    std::unique_ptr<Pipeline, PipelineDeleter> attachCursorSourceToPipelineForLocalRead(
+        Pipeline* ownedPipeline) final {
+        std::unique_ptr<Pipeline, PipelineDeleter> pipeline(
+            ownedPipeline, PipelineDeleter(ownedPipeline->getContext()->opCtx));
+        pipeline->addInitialSource(
+            DocumentSourceMock::createForTest(_collection, pipeline->getContext()));
+        ++_numAttachedPipelines;
+        return pipeline;
+    }
+
+    int numAttachedPipelines() const {
+        return _numAttachedPipelines;
+    }
+
+private:
+    std::deque<DocumentSource::GetNextResult> _collection;
+    int _numAttachedPipelines = 0;
+};
+
+/**
+ * The $sampleFromRandomCursor stage should only sample the documents which match its filter.
+ */
+TEST_F(SampleFromRandomCursorBasics, OnlySamplesDocumentsMatchingFilter) {
+    _sample = DocumentSourceSampleFromRandomCursor::create(
+        getExpCtx(), 2, "_id", 100, DocumentSourceMatch::create(BSON("x" << 1), getExpCtx()));
+    sample()->setSource(_mock.get());
+    source()->push_back(DOC("_id" << 0 << "x" << 0));
+    source()->push_back(DOC("_id" << 1 << "x" << 1));
+    source()->push_back(DOC("_id" << 2 << "x" << 0));
+    source()->push_back(DOC("_id" << 3 << "x" << 1));
+
+    auto next = sample()->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQUALS(1, next.getDocument()["_id"].getInt());
+    next = sample()->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQUALS(3, next.getDocument()["_id"].getInt());
+    assertEOF();
+}
+
+/**
+ * If fewer documents match the filter than estimated, the $sampleFromRandomCursor stage should
+ * sample the rest from all of the matching documents rather than error on the duplicates.
+ */
+TEST_F(SampleFromRandomCursorBasics, FallsBackToSamplingAllMatchingDocumentsIfEstimateIsTooHigh) {
+    // Only three documents match, but the sample was planned for an estimated 100 of them.
+    std::deque<DocumentSource::GetNextResult> collection;
+    for (int i = 0; i < 6; ++i) {
+        collection.push_back(DOC("_id" << i << "x" << (i < 3 ? 1 : 0)));
+    }
+    auto mongoInterface = std::make_shared<FallbackMongoInterface>(collection);
+    getExpCtx()->mongoProcessInterface = mongoInterface;
+
+    _sample = DocumentSourceSampleFromRandomCursor::create(
+        getExpCtx(), 4, "_id", 100, DocumentSourceMatch::create(BSON("x" << 1), getExpCtx()));
+    sample()->setSource(_mock.get());
+
+    // The random cursor only ever finds two of the matching documents.
+    for (int i = 0; i < 3000; ++i) {
+        source()->push_back(DOC("_id" << (i % 4) << "x" << (i % 4 < 2 ? 1 : 0)));
+    }
+
+    std::set<int> sampledIds;
+    for (auto next = sample()->getNext(); next.isAdvanced(); next = sample()->getNext()) {
+        ASSERT_EQUALS(1, next.getDocument()["x"].getInt());
+        ASSERT_TRUE(next.getDocument().metadata().hasRandVal());
+        ASSERT_TRUE(sampledIds.insert(next.getDocument()["_id"].getInt()).second);
+    }
+    ASSERT(sampledIds == (std::set<int>{0, 1, 2}));
+    ASSERT_EQ(mongoInterface->numAttachedPipelines(), 1);
+    assertEOF();
+}
+
 DEATH_TEST_REGEX_F(SampleFromRandomCursorBasics,
                    ShouldFailIfGivenPausedInput,
                    "Invariant failure.*Hit a MONGO_UNREACHABLE!") {
@@ -0,0 +1,383 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_shared_oplog_cursor.h"
+
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/pipeline_d.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getSharedOplogTailer = ServiceContext::declareDecoration<SharedOplogTailer>();
+
+/**
+ * Returns a context for reading the oplog on behalf of the change stream using 'expCtx'. Oplog
+ * filters are always evaluated with the simple collation, and the raised sub-pipeline depth stops
+ * PipelineD from substituting a shared cursor for the oplog scan built with this context.
+ */
+boost::intrusive_ptr<ExpressionContext> makeOplogExpCtx(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    auto oplogExpCtx = expCtx->copyWith(
+        NamespaceString::kRsOplogNamespace, boost::none, std::unique_ptr<CollatorInterface>{});
+    oplogExpCtx->tailableMode = TailableModeEnum::kTailableAndAwaitData;
+    oplogExpCtx->subPipelineDepth += 1;
+    return oplogExpCtx;
+}
+
+/**
+ * Builds a tailable oplog scan returning the entries which match 'filter'.
+ */
+std::unique_ptr<Pipeline, PipelineDeleter> makeOplogPipeline(
+    const boost::intrusive_ptr<ExpressionContext>& oplogExpCtx, BSONObj filter) {
+    auto pipeline = Pipeline::create(
+        {DocumentSourceOplogMatch::create(std::move(filter), oplogExpCtx)}, oplogExpCtx);
+    return oplogExpCtx->mongoProcessInterface->attachCursorSourceToPipelineForLocalRead(
+        pipeline.release());
+}
+
+}  // namespace
+
+SharedOplogTailer* SharedOplogTailer::get(ServiceContext* serviceContext) {
+    return &getSharedOplogTailer(serviceContext);
+}
+
+std::shared_ptr<SharedOplogTailer::Subscription> SharedOplogTailer::subscribe(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const BSONObj& filter,
+    Timestamp startFrom) {
+    auto oplogExpCtx = makeOplogExpCtx(expCtx);
+    auto statusWithMatcher =
+        MatchExpressionParser::parse(filter,
+                                     oplogExpCtx,
+                                     ExtensionsCallbackNoop(),
+                                     MatchExpressionParser::kBanAllSpecialFeatures);
+    if (!statusWithMatcher.isOK()) {
+        return nullptr;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_expCtx && (startFrom < _scanStart || startFrom <= _position)) {
+        // The shared scan has already passed entries the stream must see.
+        return nullptr;
+    }
+
+    if (!_expCtx) {
+        _expCtx = std::move(oplogExpCtx);
+        _scanStart = startFrom;
+        _position = Timestamp();
+    }
+
+    auto subscription = std::make_shared<Subscription>(std::move(statusWithMatcher.getValue()));
+    subscription->_scannedThrough = _position;
+    _subscriptions.push_back(subscription);
+    return subscription;
+}
+
+void SharedOplogTailer::unsubscribe(OperationContext* opCtx,
+                                    const std::shared_ptr<Subscription>& subscription) {
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _subscriptions.remove(subscription);
+        if (_subscriptions.empty()) {
+            // The loading stream is still subscribed while it reads, so nobody can be loading.
+            invariant(!_loading);
+            pipeline = reset();
+        }
+    }
+    disposePipeline(opCtx, std::move(pipeline));
+}
+
+SharedOplogTailer::NextResult SharedOplogTailer::getNext(OperationContext* opCtx,
+                                                         Subscription* subscription) {
+    stdx::unique_lock<Latch> lk(_mutex);
+    while (true) {
+        if (!subscription->_buffer.empty()) {
+            NextResult result;
+            result.entry = std::move(subscription->_buffer.front());
+            result.scannedThrough = subscription->_scannedThrough;
+            subscription->_buffer.pop_front();
+            subscription->_bufferedBytes -= result.entry->objsize();
+            return result;
+        }
+
+        if (subscription->_detached) {
+            return {boost::none, true, subscription->_scannedThrough};
+        }
+
+        if (!_loading) {
+            _loading = true;
+            lk.unlock();
+
+            bool reachedEnd = false;
+            std::vector<BSONObj> batch;
+            try {
+                batch = readBatch(opCtx, &reachedEnd);
+            } catch (const DBException&) {
+                // The shared scan cannot be trusted after a failed read. Every stream continues
+                // with its own cursor from the last entry distributed to it.
+                lk.lock();
+                _loading = false;
+                auto pipeline = reset();
+                lk.unlock();
+                _batchDistributed.notify_all();
+                disposePipeline(opCtx, std::move(pipeline));
+                throw;
+            }
+
+            lk.lock();
+            _loading = false;
+            distribute(batch);
+            _batchDistributed.notify_all();
+
+            if (reachedEnd && subscription->_buffer.empty()) {
+                return {boost::none, false, subscription->_scannedThrough};
+            }
+            continue;
+        }
+
+        // Another stream is reading. Wait for its batch if the stream is willing to wait for new
+        // entries, otherwise report that there is nothing more to return for now.
+        const auto& awaitData = awaitDataState(opCtx);
+        if (!awaitData.shouldWaitForInserts ||
+            !opCtx->waitForConditionOrInterruptUntil(
+                _batchDistributed, lk, awaitData.waitForInsertsDeadline, [&] {
+                    return !_loading || subscription->_detached ||
+                        !subscription->_buffer.empty();
+                })) {
+            return {boost::none, false, subscription->_scannedThrough};
+        }
+    }
+}
+
+std::vector<BSONObj> SharedOplogTailer::readBatch(OperationContext* opCtx, bool* reachedEnd) {
+    if (!_pipeline) {
+        _expCtx->opCtx = opCtx;
+        _pipeline = makeOplogPipeline(_expCtx, BSON("ts" << GTE << _scanStart));
+        _pipeline.get_deleter().dismissDisposal();
+    } else {
+        _pipeline->reattachToOperationContext(opCtx);
+    }
+    ON_BLOCK_EXIT([&] {
+        if (_pipeline) {
+            _pipeline->detachFromOperationContext();
+        }
+    });
+
+    // Only the first read may wait for new entries. Once there is something to distribute, the
+    // batch is handed out as soon as the oplog is exhausted.
+    auto& awaitData = awaitDataState(opCtx);
+    const bool shouldWaitForInserts = awaitData.shouldWaitForInserts;
+    ON_BLOCK_EXIT([&] { awaitData.shouldWaitForInserts = shouldWaitForInserts; });
+
+    const size_t batchSize = internalChangeStreamSharedOplogReaderBatchSize.load();
+    std::vector<BSONObj> batch;
+    batch.reserve(batchSize);
+    while (batch.size() < batchSize) {
+        auto next = _pipeline->getNext();
+        if (!next) {
+            *reachedEnd = true;
+            break;
+        }
+
+        auto entry = next->toBsonIfTriviallyConvertible();
+        batch.push_back(entry ? entry->getOwned() : next->toBson());
+        awaitData.shouldWaitForInserts = false;
+    }
+    return batch;
+}
+
+void SharedOplogTailer::distribute(const std::vector<BSONObj>& batch) {
+    const size_t maxBufferedBytes = internalChangeStreamSharedOplogReaderMaxBufferedBytes.load();
+    for (auto&& entry : batch) {
+        const auto ts = entry["ts"].timestamp();
+        for (auto&& subscription : _subscriptions) {
+            if (subscription->_detached) {
+                continue;
+            }
+
+            if (subscription->_filter->matchesBSON(entry)) {
+                const size_t entrySize = entry.objsize();
+                if (subscription->_bufferedBytes + entrySize > maxBufferedBytes) {
+                    // The stream is too far behind. It resumes after the last entry it was given.
+                    subscription->_detached = true;
+                    continue;
+                }
+                subscription->_buffer.push_back(entry);
+                subscription->_bufferedBytes += entrySize;
+            }
+            subscription->_scannedThrough = ts;
+        }
+        _position = ts;
+    }
+}
+
+std::unique_ptr<Pipeline, PipelineDeleter> SharedOplogTailer::reset() {
+    for (auto&& subscription : _subscriptions) {
+        subscription->_detached = true;
+    }
+    _expCtx.reset();
+    _scanStart = Timestamp();
+    _position = Timestamp();
+    return std::move(_pipeline);
+}
+
+void SharedOplogTailer::disposePipeline(OperationContext* opCtx,
+                                        std::unique_ptr<Pipeline, PipelineDeleter> pipeline) {
+    if (pipeline) {
+        pipeline->reattachToOperationContext(opCtx);
+        pipeline->dispose(opCtx);
+    }
+}
+
+boost::intrusive_ptr<DocumentSourceSharedOplogCursor> DocumentSourceSharedOplogCursor::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, BSONObj filter, Timestamp startFrom) {
+    return new DocumentSourceSharedOplogCursor(expCtx, std::move(filter), startFrom);
+}
+
+boost::optional<Timestamp> DocumentSourceSharedOplogCursor::parseStartFrom(const BSONObj& filter) {
+    // The filter is {$and: [{ts: {$gte: <startFrom>}}, ...]}.
+    auto andElem = filter["$and"];
+    if (filter.nFields() != 1 || andElem.type() != BSONType::Array) {
+        return boost::none;
+    }
+
+    auto tsElem = andElem.Obj().firstElement();
+    if (tsElem.type() != BSONType::Object || tsElem.Obj().nFields() != 1) {
+        return boost::none;
+    }
+
+    auto gteElem = tsElem.Obj()["ts"];
+    if (gteElem.type() != BSONType::Object || gteElem.Obj().nFields() != 1) {
+        return boost::none;
+    }
+
+    auto startFrom = gteElem.Obj()["$gte"];
+    if (startFrom.type() != BSONType::bsonTimestamp) {
+        return boost::none;
+    }
+    return startFrom.timestamp();
+}
+
+DocumentSourceSharedOplogCursor::DocumentSourceSharedOplogCursor(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, BSONObj filter, Timestamp startFrom)
+    : DocumentSource(kStageName, expCtx), _filter(filter.getOwned()), _startFrom(startFrom) {}
+
+Value DocumentSourceSharedOplogCursor::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(DOC(getSourceName() << DOC("filter" << _filter)));
+}
+
+DocumentSource::GetNextResult DocumentSourceSharedOplogCursor::doGetNext() {
+    auto tailer = SharedOplogTailer::get(pExpCtx->opCtx->getServiceContext());
+    if (!_subscription && !_independentPipeline) {
+        _subscription = tailer->subscribe(pExpCtx, _filter, _startFrom);
+        if (!_subscription) {
+            startIndependentScan(Timestamp());
+        }
+    }
+
+    if (_subscription) {
+        auto next = tailer->getNext(pExpCtx->opCtx, _subscription.get());
+        if (next.entry) {
+            _latestOplogTimestamp = (*next.entry)["ts"].timestamp();
+            return Document(*next.entry);
+        }
+
+        if (!next.detached) {
+            // Everything up to 'scannedThrough' has been examined on behalf of this stream, but
+            // the shared scan may not have reached the stream's start point yet.
+            if (next.scannedThrough >= _startFrom && next.scannedThrough > _latestOplogTimestamp) {
+                _latestOplogTimestamp = next.scannedThrough;
+            }
+            return GetNextResult::makeEOF();
+        }
+
+        tailer->unsubscribe(pExpCtx->opCtx, _subscription);
+        _subscription.reset();
+        startIndependentScan(next.scannedThrough);
+    }
+
+    if (auto next = _independentPipeline->getNext()) {
+        return std::move(*next);
+    }
+    return GetNextResult::makeEOF();
+}
+
+void DocumentSourceSharedOplogCursor::startIndependentScan(Timestamp scannedThrough) {
+    _independentPipeline = makeOplogPipeline(
+        makeOplogExpCtx(pExpCtx),
+        BSON("$and" << BSON_ARRAY(BSON("ts" << GT << scannedThrough) << _filter)));
+    _independentPipeline.get_deleter().dismissDisposal();
+}
+
+Timestamp DocumentSourceSharedOplogCursor::getLatestOplogTimestamp() const {
+    if (_independentPipeline) {
+        return std::max(_latestOplogTimestamp,
+                        PipelineD::getLatestOplogTimestamp(_independentPipeline.get()));
+    }
+    return _latestOplogTimestamp;
+}
+
+void DocumentSourceSharedOplogCursor::detachFromOperationContext() {
+    if (_independentPipeline) {
+        _independentPipeline->detachFromOperationContext();
+    }
+}
+
+void DocumentSourceSharedOplogCursor::reattachToOperationContext(OperationContext* opCtx) {
+    if (_independentPipeline) {
+        _independentPipeline->reattachToOperationContext(opCtx);
+    }
+}
+
+void DocumentSourceSharedOplogCursor::doDispose() {
+    if (_subscription) {
+        SharedOplogTailer::get(pExpCtx->opCtx->getServiceContext())
+            ->unsubscribe(pExpCtx->opCtx, _subscription);
+        _subscription.reset();
+    }
+    if (_independentPipeline) {
+        _independentPipeline->dispose(pExpCtx->opCtx);
+        _independentPipeline.reset();
+    }
+}
+
+}  // namespace mongo
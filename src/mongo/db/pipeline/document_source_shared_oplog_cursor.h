@@ -0,0 +1,243 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <list>
+#include <memory>
+
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+
+namespace mongo {
+
+/**
+ * A single tailable scan of the oplog shared by the change streams open on this node. Rather than
+ * each stream scanning the oplog with its own cursor, every stream registers the filter of its
+ * $_internalOplogMatch stage here. Entries are read once, each stream's filter is evaluated
+ * against every entry, and the matching entries are buffered for the stream that wants them.
+ *
+ * There is no dedicated thread. Like the Exchange, the stream which finds its buffer empty while
+ * nobody else is reading takes the loading role and reads the next batch using its own
+ * OperationContext, while the other streams wait for the batch to be distributed. A stream which
+ * starts before the scan's current position, or which lets its buffer grow past
+ * 'internalChangeStreamSharedOplogReaderMaxBufferedBytes', is detached and must continue with
+ * an independent scan from the last entry evaluated on its behalf.
+ */
+class SharedOplogTailer {
+public:
+    class Subscription {
+    public:
+        Subscription(std::unique_ptr<MatchExpression> filter) : _filter(std::move(filter)) {}
+
+    private:
+        friend class SharedOplogTailer;
+
+        const std::unique_ptr<MatchExpression> _filter;
+
+        // Matching entries which the stream has yet to consume, and their total size.
+        std::deque<BSONObj> _buffer;
+        size_t _bufferedBytes = 0;
+
+        // Every oplog entry up to and including this timestamp has been evaluated against the
+        // stream's filter.
+        Timestamp _scannedThrough;
+
+        // Set once the stream no longer receives entries from the shared scan.
+        bool _detached = false;
+    };
+
+    struct NextResult {
+        // The next entry for the stream, if one is buffered.
+        boost::optional<BSONObj> entry;
+
+        // If true, the shared scan will not deliver any more entries to the stream, which should
+        // resume reading after 'scannedThrough' with its own cursor.
+        bool detached = false;
+
+        Timestamp scannedThrough;
+    };
+
+    static SharedOplogTailer* get(ServiceContext* serviceContext);
+
+    /**
+     * Registers a stream which must see every oplog entry matching 'filter' with a timestamp of at
+     * least 'startFrom'. Returns nullptr if the shared scan has already gone past 'startFrom', or
+     * if 'filter' cannot be evaluated outside of the stream's own pipeline.
+     */
+    std::shared_ptr<Subscription> subscribe(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                            const BSONObj& filter,
+                                            Timestamp startFrom);
+
+    /**
+     * Removes the stream's registration. The last stream to leave disposes of the shared scan.
+     */
+    void unsubscribe(OperationContext* opCtx, const std::shared_ptr<Subscription>& subscription);
+
+    /**
+     * Returns the next entry buffered for 'subscription', reading more of the oplog when the
+     * buffer is empty. Returns without an entry if the end of the oplog is reached, or if the
+     * awaitData deadline of 'opCtx' passes while another stream is reading.
+     */
+    NextResult getNext(OperationContext* opCtx, Subscription* subscription);
+
+private:
+    /**
+     * Reads up to 'internalChangeStreamSharedOplogReaderBatchSize' entries. Only the first read
+     * may wait for new entries to be written. Must be called by the thread holding the loading
+     * role, without '_mutex'.
+     */
+    std::vector<BSONObj> readBatch(OperationContext* opCtx, bool* reachedEnd);
+
+    /**
+     * Evaluates the filter of every attached subscription against each entry in 'batch' and
+     * buffers the matching entries. The caller must hold '_mutex'.
+     */
+    void distribute(const std::vector<BSONObj>& batch);
+
+    /**
+     * Detaches every subscription and forgets the shared scan, which is returned so that the
+     * caller may dispose of it without holding '_mutex'.
+     */
+    std::unique_ptr<Pipeline, PipelineDeleter> reset();
+
+    static void disposePipeline(OperationContext* opCtx,
+                                std::unique_ptr<Pipeline, PipelineDeleter> pipeline);
+
+    Mutex _mutex = MONGO_MAKE_LATCH("SharedOplogTailer::_mutex");
+    stdx::condition_variable _batchDistributed;
+
+    std::list<std::shared_ptr<Subscription>> _subscriptions;
+
+    // The context used to build the shared scan, and the timestamp the scan starts from. Set by
+    // the first subscription.
+    boost::intrusive_ptr<ExpressionContext> _expCtx;
+    Timestamp _scanStart;
+
+    // The timestamp of the last entry which was distributed.
+    Timestamp _position;
+
+    // True while a stream holds the loading role. Only that stream touches '_pipeline'.
+    bool _loading = false;
+
+    // The shared tailable scan. Built lazily by the first stream to load. Its disposal is managed
+    // explicitly since it outlives the OperationContext it was built with.
+    std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
+};
+
+/**
+ * Replaces the $_internalOplogMatch stage and the oplog cursor at the front of a change stream
+ * pipeline, reading the stream's oplog entries from the SharedOplogTailer. If the stream cannot
+ * join the shared scan or is detached from it, this stage builds an ordinary oplog cursor
+ * pipeline for the stream and reads from that instead.
+ */
+class DocumentSourceSharedOplogCursor final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$sharedOplogCursor"_sd;
+
+    /**
+     * Creates a stage which returns the oplog entries matching 'filter', the predicate of the
+     * stream's $_internalOplogMatch stage.
+     */
+    static boost::intrusive_ptr<DocumentSourceSharedOplogCursor> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx, BSONObj filter, Timestamp startFrom);
+
+    /**
+     * Returns the timestamp from which a change stream with oplog filter 'filter' starts reading,
+     * or boost::none if 'filter' does not have the form produced by
+     * DocumentSourceChangeStream::buildMatchFilter().
+     */
+    static boost::optional<Timestamp> parseStartFrom(const BSONObj& filter);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed,
+                                     LookupRequirement::kNotAllowed,
+                                     UnionRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    void detachFromOperationContext() final;
+
+    void reattachToOperationContext(OperationContext* opCtx) final;
+
+    /**
+     * Returns the timestamp through which the oplog has been read on behalf of this stream, in the
+     * same sense as DocumentSourceCursor::getLatestOplogTimestamp().
+     */
+    Timestamp getLatestOplogTimestamp() const;
+
+private:
+    DocumentSourceSharedOplogCursor(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                    BSONObj filter,
+                                    Timestamp startFrom);
+
+    GetNextResult doGetNext() final;
+
+    void doDispose() final;
+
+    /**
+     * Builds an oplog cursor pipeline returning the entries after 'scannedThrough' which match
+     * '_filter', and reads from it from now on.
+     */
+    void startIndependentScan(Timestamp scannedThrough);
+
+    const BSONObj _filter;
+    const Timestamp _startFrom;
+
+    std::shared_ptr<SharedOplogTailer::Subscription> _subscription;
+
+    Timestamp _latestOplogTimestamp;
+
+    // Set once the stream reads the oplog with its own cursor.
+    std::unique_ptr<Pipeline, PipelineDeleter> _independentPipeline;
+};
+
+}  // namespace mongo
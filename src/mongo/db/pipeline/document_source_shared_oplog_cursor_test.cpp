@@ -0,0 +1,265 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_shared_oplog_cursor.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/process_interface/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+using std::deque;
+using std::vector;
+
+/**
+ * A mock MongoProcessInterface which serves every oplog scan from an in-memory oplog. Entries
+ * appended to the oplog become visible to the scans which are already open, as they would to a
+ * tailable cursor.
+ */
+class MockOplogInterface final : public StubMongoProcessInterface {
+public:
+    std::unique_ptr<Pipeline, PipelineDeleter> attachCursorSourceToPipelineForLocalRead(
+        Pipeline* ownedPipeline) final {
+        std::unique_ptr<Pipeline, PipelineDeleter> pipeline(
+            ownedPipeline, PipelineDeleter(ownedPipeline->getContext()->opCtx));
+
+        deque<DocumentSource::GetNextResult> results;
+        for (auto&& entry : _oplog) {
+            results.emplace_back(Document(entry));
+        }
+        auto scan = DocumentSourceMock::createForTest(std::move(results), pipeline->getContext());
+        _scans.push_back(scan);
+        pipeline->addInitialSource(scan);
+        return pipeline;
+    }
+
+    void appendEntry(BSONObj entry) {
+        _oplog.push_back(entry);
+        for (auto&& scan : _scans) {
+            if (!scan->isDisposed) {
+                scan->push_back(Document(entry));
+            }
+        }
+    }
+
+    size_t numScans() const {
+        return _scans.size();
+    }
+
+    size_t numOpenScans() const {
+        return std::count_if(
+            _scans.begin(), _scans.end(), [](auto&& scan) { return !scan->isDisposed; });
+    }
+
+private:
+    vector<BSONObj> _oplog;
+    vector<intrusive_ptr<DocumentSourceMock>> _scans;
+};
+
+class DocumentSourceSharedOplogCursorTest : public AggregationContextFixture {
+public:
+    DocumentSourceSharedOplogCursorTest() : _oplog(std::make_shared<MockOplogInterface>()) {
+        getExpCtx()->mongoProcessInterface = _oplog;
+    }
+
+    MockOplogInterface* oplog() {
+        return _oplog.get();
+    }
+
+    static BSONObj makeInsert(unsigned secs, StringData coll) {
+        return BSON("ts" << Timestamp(secs, 1) << "op"
+                         << "i"
+                         << "ns"
+                         << ("test." + coll) << "o" << BSON("_id" << static_cast<int>(secs)));
+    }
+
+    static BSONObj makeDrop(unsigned secs, StringData coll) {
+        return BSON("ts" << Timestamp(secs, 1) << "op"
+                         << "c"
+                         << "ns"
+                         << "test.$cmd"
+                         << "o" << BSON("drop" << coll));
+    }
+
+    /**
+     * Creates a stream which sees the inserts into and the drop of 'coll' from 'startFrom'
+     * onwards, with a filter of the form the change stream stages build.
+     */
+    intrusive_ptr<DocumentSourceSharedOplogCursor> makeStream(StringData coll,
+                                                              Timestamp startFrom) {
+        auto filter = BSON(
+            "$and" << BSON_ARRAY(BSON("ts" << BSON("$gte" << startFrom))
+                                 << BSON("$or" << BSON_ARRAY(BSON("ns" << ("test." + coll))
+                                                             << BSON("o.drop" << coll)))));
+        ASSERT_EQ(startFrom, *DocumentSourceSharedOplogCursor::parseStartFrom(filter));
+        return DocumentSourceSharedOplogCursor::create(getExpCtx(), filter, startFrom);
+    }
+
+    /**
+     * Returns the seconds of the timestamps of the entries 'stream' returns before it reports EOF.
+     */
+    static vector<unsigned> drain(DocumentSourceSharedOplogCursor* stream) {
+        vector<unsigned> seen;
+        for (auto next = stream->getNext(); next.isAdvanced(); next = stream->getNext()) {
+            seen.push_back(next.getDocument()["ts"].getTimestamp().getSecs());
+        }
+        return seen;
+    }
+
+private:
+    std::shared_ptr<MockOplogInterface> _oplog;
+};
+
+TEST_F(DocumentSourceSharedOplogCursorTest, ShouldFanOutOneScanToEveryStream) {
+    auto streamA = makeStream("a", Timestamp(1, 1));
+    auto streamB = makeStream("b", Timestamp(1, 1));
+    ON_BLOCK_EXIT([&] {
+        streamA->dispose();
+        streamB->dispose();
+    });
+
+    // Both streams subscribe before the shared scan has returned anything.
+    ASSERT_TRUE(drain(streamA.get()).empty());
+    ASSERT_TRUE(drain(streamB.get()).empty());
+
+    for (unsigned secs = 1; secs <= 6; ++secs) {
+        oplog()->appendEntry(makeInsert(secs, secs % 2 ? "a" : "b"));
+    }
+
+    ASSERT(drain(streamA.get()) == vector<unsigned>({1, 3, 5}));
+    ASSERT(drain(streamB.get()) == vector<unsigned>({2, 4, 6}));
+    ASSERT_EQ(1U, oplog()->numScans());
+
+    oplog()->appendEntry(makeInsert(7, "b"));
+    ASSERT_TRUE(drain(streamA.get()).empty());
+    ASSERT(drain(streamB.get()) == vector<unsigned>({7}));
+    ASSERT_EQ(1U, oplog()->numScans());
+
+    // A stream which had nothing to return has still examined the whole oplog.
+    ASSERT_EQ(Timestamp(7, 1), streamA->getLatestOplogTimestamp());
+}
+
+TEST_F(DocumentSourceSharedOplogCursorTest, ShouldResumeBehindTheSharedScanWithItsOwnCursor) {
+    auto streamA = makeStream("a", Timestamp(1, 1));
+    ON_BLOCK_EXIT([&] { streamA->dispose(); });
+    ASSERT_TRUE(drain(streamA.get()).empty());
+
+    for (unsigned secs = 1; secs <= 4; ++secs) {
+        oplog()->appendEntry(makeInsert(secs, "a"));
+    }
+    ASSERT(drain(streamA.get()) == vector<unsigned>({1, 2, 3, 4}));
+
+    // The shared scan has already passed the point the resumed stream starts from.
+    auto resumed = makeStream("a", Timestamp(2, 1));
+    ON_BLOCK_EXIT([&] { resumed->dispose(); });
+    ASSERT(drain(resumed.get()) == vector<unsigned>({2, 3, 4}));
+    ASSERT_EQ(2U, oplog()->numScans());
+
+    oplog()->appendEntry(makeInsert(5, "a"));
+    ASSERT(drain(streamA.get()) == vector<unsigned>({5}));
+    ASSERT(drain(resumed.get()) == vector<unsigned>({5}));
+    ASSERT_EQ(2U, oplog()->numScans());
+}
+
+TEST_F(DocumentSourceSharedOplogCursorTest, DetachedStreamsShouldContinueAfterTheirLastEntry) {
+    // Only two entries fit in a stream's buffer.
+    const auto originalMaxBufferedBytes =
+        internalChangeStreamSharedOplogReaderMaxBufferedBytes.load();
+    internalChangeStreamSharedOplogReaderMaxBufferedBytes.store(2 * makeInsert(1, "a").objsize());
+    ON_BLOCK_EXIT([&] {
+        internalChangeStreamSharedOplogReaderMaxBufferedBytes.store(originalMaxBufferedBytes);
+    });
+
+    auto streamA = makeStream("a", Timestamp(1, 1));
+    auto streamB = makeStream("a", Timestamp(1, 1));
+    ON_BLOCK_EXIT([&] {
+        streamA->dispose();
+        streamB->dispose();
+    });
+    ASSERT_TRUE(drain(streamA.get()).empty());
+    ASSERT_TRUE(drain(streamB.get()).empty());
+
+    for (unsigned secs = 1; secs <= 5; ++secs) {
+        oplog()->appendEntry(makeInsert(secs, "a"));
+    }
+
+    // Both streams overflow their buffers on the third entry and read the rest themselves.
+    ASSERT(drain(streamA.get()) == vector<unsigned>({1, 2, 3, 4, 5}));
+    ASSERT(drain(streamB.get()) == vector<unsigned>({1, 2, 3, 4, 5}));
+    ASSERT_EQ(3U, oplog()->numScans());
+
+    // The shared scan is released once its last stream has detached.
+    ASSERT_EQ(2U, oplog()->numOpenScans());
+
+    oplog()->appendEntry(makeInsert(6, "a"));
+    ASSERT(drain(streamA.get()) == vector<unsigned>({6}));
+    ASSERT(drain(streamB.get()) == vector<unsigned>({6}));
+}
+
+TEST_F(DocumentSourceSharedOplogCursorTest, ShouldReleaseTheSharedScanWhenTheLastStreamCloses) {
+    auto streamA = makeStream("a", Timestamp(1, 1));
+    ASSERT_TRUE(drain(streamA.get()).empty());
+
+    oplog()->appendEntry(makeInsert(1, "a"));
+    oplog()->appendEntry(makeInsert(2, "b"));
+    oplog()->appendEntry(makeDrop(3, "a"));
+
+    // The drop which invalidates the stream is delivered like any other entry.
+    ASSERT(drain(streamA.get()) == vector<unsigned>({1, 3}));
+    ASSERT_EQ(1U, oplog()->numOpenScans());
+
+    // Closing the invalidated stream disposes of the shared scan...
+    streamA->dispose();
+    ASSERT_EQ(0U, oplog()->numOpenScans());
+
+    // ...so a stream which starts before the old scan's position begins a new shared scan.
+    auto streamB = makeStream("b", Timestamp(1, 1));
+    ON_BLOCK_EXIT([&] { streamB->dispose(); });
+    ASSERT(drain(streamB.get()) == vector<unsigned>({2}));
+    ASSERT_EQ(2U, oplog()->numScans());
+    ASSERT_EQ(1U, oplog()->numOpenScans());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -68,6 +68,17 @@ DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::doGetN
     return _parsedTransform->applyTransformation(input.releaseDocument());
 }
 
+DocumentSource::GetNextResult::ReturnStatus
+DocumentSourceSingleDocumentTransformation::doGetNextBatch(std::vector<Document>* batch,
+                                                           size_t maxDocs) {
+    const auto batchStart = batch->size();
+    auto status = pSource->getNextBatch(batch, maxDocs);
+    for (auto it = batch->begin() + batchStart; it != batch->end(); ++it) {
+        *it = _parsedTransform->applyTransformation(*it);
+    }
+    return status;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimize() {
     _parsedTransform->optimize();
     return this;
@@ -96,6 +96,8 @@ public:
 
 protected:
     GetNextResult doGetNext() final;
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxDocs) final;
     void doDispose() final;
 
     Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
@@ -64,7 +64,8 @@ DocumentSourceSort::DocumentSourceSort(const boost::intrusive_ptr<ExpressionCont
                      limit,
                      maxMemoryUsageBytes,
                      pExpCtx->tempDir,
-                     pExpCtx->allowDiskUse}),
+                     pExpCtx->allowDiskUse,
+                     false /* returnSortKeys */}),
       // The SortKeyGenerator expects the expressions to be serialized in order to detect a sort
       // by a metadata field.
       _sortKeyGen({{sortOrder, pExpCtx}, pExpCtx->getCollator()}) {
@@ -93,6 +94,25 @@ DocumentSource::GetNextResult DocumentSourceSort::doGetNext() {
     return GetNextResult{_sortExecutor->getNext().second};
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceSort::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxDocs) {
+    if (!_populated) {
+        const auto populationResult = populate();
+        if (populationResult.isPaused()) {
+            return populationResult.getStatus();
+        }
+        invariant(populationResult.isEOF());
+    }
+
+    // The sorted documents are not referenced by anything else, so several can be returned at
+    // once.
+    size_t numDocs = 0;
+    for (; numDocs < maxDocs && _sortExecutor->hasNext(); ++numDocs) {
+        batch->push_back(_sortExecutor->getNext().second);
+    }
+    return numDocs ? GetNextResult::ReturnStatus::kAdvanced : GetNextResult::ReturnStatus::kEOF;
+}
+
 void DocumentSourceSort::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     uint64_t limit = _sortExecutor->getLimit();
@@ -225,14 +245,20 @@ intrusive_ptr<DocumentSourceSort> DocumentSourceSort::create(
 }
 
 DocumentSource::GetNextResult DocumentSourceSort::populate() {
-    auto nextInput = pSource->getNext();
-    for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
-        loadDocument(nextInput.releaseDocument());
+    std::vector<Document> batch;
+    auto status = pSource->getNextBatch(&batch, kInputBatchSize);
+    for (; status == GetNextResult::ReturnStatus::kAdvanced;
+         status = pSource->getNextBatch(&batch, kInputBatchSize)) {
+        for (auto&& doc : batch) {
+            loadDocument(std::move(doc));
+        }
+        batch.clear();
     }
-    if (nextInput.isEOF()) {
-        loadingDone();
+    if (status == GetNextResult::ReturnStatus::kPauseExecution) {
+        return GetNextResult::makePauseExecution();
     }
-    return nextInput;
+    loadingDone();
+    return GetNextResult::makeEOF();
 }
 
 void DocumentSourceSort::loadDocument(Document&& doc) {
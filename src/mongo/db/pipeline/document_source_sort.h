@@ -148,6 +148,8 @@ public:
 
 protected:
     GetNextResult doGetNext() final;
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxDocs) final;
     /**
      * Attempts to absorb a subsequent $limit stage so that it can perform a top-k sort.
      */
@@ -45,8 +45,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -475,5 +477,56 @@ TEST_F(DocumentSourceSortExecutionTest, ShouldCorrectlyTrackMemoryUsageBetweenPa
         sort->getNext(), AssertionException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
 }
 
+TEST_F(DocumentSourceSortExecutionTest, KeyStringSortKeysGiveTheSameOrder) {
+    const auto originalUseKeyString = internalQueryUseKeyStringSortKeys.load();
+    internalQueryUseKeyStringSortKeys.store(true);
+    ON_BLOCK_EXIT([&] { internalQueryUseKeyStringSortKeys.store(originalUseKeyString); });
+
+    checkResults({Document{{"_id", 0}, {"a", 2.5}},
+                  Document{{"_id", 1}, {"a", "foo"_sd}},
+                  Document{{"_id", 2}},
+                  Document{{"_id", 3}, {"a", BSONNULL}},
+                  Document{{"_id", 4}, {"a", 2}},
+                  Document{{"_id", 5}, {"a", Document{{"b", 1}}}}},
+                 BSON("a" << 1),
+                 "[{_id:2},{_id:3,a:null},{_id:4,a:2},{_id:0,a:2.5},{_id:1,a:'foo'},"
+                 "{_id:5,a:{b:1}}]");
+    checkResults({Document{{"_id", 0}, {"a", 1}, {"b", 3}},
+                  Document{{"_id", 1}, {"a", 1}, {"b", "x"_sd}},
+                  Document{{"_id", 2}, {"a", 0}},
+                  Document{{"_id", 3}, {"a", 1}}},
+                 BSON("a" << -1 << "b" << 1),
+                 "[{_id:3,a:1},{_id:0,a:1,b:3},{_id:1,a:1,b:'x'},{_id:2,a:0}]");
+}
+
+TEST_F(DocumentSourceSortExecutionTest, KeyStringSortKeysCanBeSpilled) {
+    const auto originalUseKeyString = internalQueryUseKeyStringSortKeys.load();
+    internalQueryUseKeyStringSortKeys.store(true);
+    ON_BLOCK_EXIT([&] { internalQueryUseKeyStringSortKeys.store(originalUseKeyString); });
+
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceSortTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    auto sort = DocumentSourceSort::create(expCtx, BSON("_id" << -1), 0, maxMemoryUsageBytes);
+
+    string largeStr(maxMemoryUsageBytes, 'x');
+    auto mock = DocumentSourceMock::createForTest({Document{{"_id", 1}, {"largeStr", largeStr}},
+                                                   Document{{"_id", 0}, {"largeStr", largeStr}},
+                                                   Document{{"_id", 2}, {"largeStr", largeStr}}},
+                                                  expCtx);
+    sort->setSource(mock.get());
+
+    for (int id = 2; id >= 0; --id) {
+        auto next = sort->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(id));
+    }
+    ASSERT_TRUE(sort->getNext().isEOF());
+    ASSERT_TRUE(sort->usedDisk());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -30,15 +30,25 @@
 
 #include "mongo/platform/basic.h"
 
+#include <deque>
 #include <iterator>
 
+#include "mongo/db/client.h"
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
+#include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_source_union_with.h"
 #include "mongo/db/pipeline/document_source_union_with_gen.h"
+#include "mongo/db/pipeline/javascript_execution.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/views/resolved_view.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
 
 namespace mongo {
 
@@ -82,6 +92,162 @@ std::unique_ptr<Pipeline, PipelineDeleter> buildPipelineFromViewDefinition(
 
 }  // namespace
 
+/**
+ * Runs the sub-pipeline of a $unionWith on a thread of its own, so that its results are ready by
+ * the time the input of the $unionWith is exhausted. The thread stops producing results while
+ * 'internalQueryUnionWithPrefetchMaxBufferBytes' worth of them are waiting to be returned.
+ */
+class DocumentSourceUnionWith::Prefetcher {
+public:
+    /**
+     * Starts running 'pipeline', which must have a cursor source attached and be detached from its
+     * OperationContext. The thread inherits the deadline of 'parentOpCtx'.
+     */
+    Prefetcher(std::unique_ptr<Pipeline, PipelineDeleter> pipeline, OperationContext* parentOpCtx)
+        : _pipeline(std::move(pipeline)),
+          _maxBufferedBytes(internalQueryUnionWithPrefetchMaxBufferBytes.load()) {
+        _thread = stdx::thread([this,
+                                serviceContext = parentOpCtx->getServiceContext(),
+                                deadline = parentOpCtx->getDeadline(),
+                                timeoutError = parentOpCtx->getTimeoutError()] {
+            run(serviceContext, deadline, timeoutError);
+        });
+    }
+
+    ~Prefetcher() {
+        stop();
+    }
+
+    /**
+     * Waits on 'opCtx' for the next result of the sub-pipeline, or returns boost::none once it is
+     * exhausted. Rethrows the error the sub-pipeline failed with, if any.
+     */
+    boost::optional<Document> getNext(OperationContext* opCtx) {
+        stdx::unique_lock<Latch> lk(_mutex);
+        opCtx->waitForConditionOrInterrupt(_cv, lk, [&] { return !_buffer.empty() || _done; });
+        if (!_buffer.empty()) {
+            return popFront(lk);
+        }
+        uassertStatusOK(_status);
+        return boost::none;
+    }
+
+    /**
+     * Returns the next result of the sub-pipeline if it has already been produced.
+     */
+    boost::optional<Document> tryGetNext() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_buffer.empty()) {
+            return boost::none;
+        }
+        return popFront(lk);
+    }
+
+    /**
+     * Interrupts the sub-pipeline and waits for its thread to dispose of it. Any results which
+     * have not been returned are discarded.
+     */
+    void stop() {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _stopped = true;
+            if (_opCtx) {
+                stdx::lock_guard<Client> clientLock(*_opCtx->getClient());
+                _opCtx->getServiceContext()->killOperation(clientLock, _opCtx);
+            }
+            _cv.notify_all();
+        }
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    bool usedDisk() const {
+        return _usedDisk.load();
+    }
+
+private:
+    void run(ServiceContext* serviceContext, Date_t deadline, ErrorCodes::Error timeoutError) {
+        ThreadClient tc("UnionWithPrefetcher", serviceContext);
+        auto opCtx = tc->makeOperationContext();
+        if (deadline != Date_t::max()) {
+            opCtx->setDeadlineByDate(deadline, timeoutError);
+        }
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _opCtx = opCtx.get();
+        }
+
+        Status status = Status::OK();
+        try {
+            _pipeline->reattachToOperationContext(opCtx.get());
+            while (auto next = _pipeline->getNext()) {
+                const size_t bytes = next->getApproximateSize();
+                stdx::unique_lock<Latch> lk(_mutex);
+                _cv.wait(lk, [&] {
+                    return _stopped || _buffer.empty() ||
+                        _bufferedBytes + bytes <= size_t(_maxBufferedBytes);
+                });
+                if (_stopped) {
+                    break;
+                }
+                _bufferedBytes += bytes;
+                _buffer.push_back(std::move(*next));
+                _cv.notify_all();
+            }
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        // The sub-pipeline was attached under the OperationContext of the $unionWith, which the
+        // PipelineDeleter would otherwise dispose of it with.
+        _usedDisk.store(_pipeline->usedDisk());
+        _pipeline.get_deleter().dismissDisposal();
+        try {
+            _pipeline->dispose(opCtx.get());
+        } catch (const DBException& ex) {
+            if (status.isOK()) {
+                status = ex.toStatus();
+            }
+        }
+        _pipeline.reset();
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        _opCtx = nullptr;
+        _status = std::move(status);
+        _done = true;
+        _cv.notify_all();
+    }
+
+    Document popFront(WithLock) {
+        auto next = std::move(_buffer.front());
+        _buffer.pop_front();
+        _bufferedBytes -= next.getApproximateSize();
+        _cv.notify_all();
+        return next;
+    }
+
+    std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
+    const long long _maxBufferedBytes;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("DocumentSourceUnionWith::Prefetcher::_mutex");
+    stdx::condition_variable _cv;
+    std::deque<Document> _buffer;
+    size_t _bufferedBytes = 0;
+    OperationContext* _opCtx = nullptr;
+    bool _stopped = false;
+    bool _done = false;
+    Status _status = Status::OK();
+
+    AtomicWord<bool> _usedDisk{false};
+    stdx::thread _thread;
+};
+
+DocumentSourceUnionWith::DocumentSourceUnionWith(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline)
+    : DocumentSource(kStageName, expCtx), _pipeline(std::move(pipeline)) {}
+
 DocumentSourceUnionWith::~DocumentSourceUnionWith() {
     if (_pipeline && _pipeline->getContext()->explain) {
         _pipeline->dispose(pExpCtx->opCtx);
@@ -165,22 +331,52 @@ boost::intrusive_ptr<DocumentSource> DocumentSourceUnionWith::createFromBson(
 }
 
 DocumentSource::GetNextResult DocumentSourceUnionWith::doGetNext() {
-    if (!_pipeline) {
+    if (!_pipeline && !_prefetcher) {
         // We must have already been disposed, so we're finished.
         return GetNextResult::makeEOF();
     }
 
     if (_executionState == ExecutionProgress::kIteratingSource) {
+        if (!_checkedPrefetch) {
+            _checkedPrefetch = true;
+            if (canPrefetch()) {
+                startPrefetch();
+            }
+        }
+        if (_prefetcher && _interleaveWithSubPipeline) {
+            if (auto next = _prefetcher->tryGetNext()) {
+                return std::move(*next);
+            }
+        }
         auto nextInput = pSource->getNext();
         if (!nextInput.isEOF()) {
             return nextInput;
         }
-        _executionState = ExecutionProgress::kStartingSubPipeline;
+        _executionState = _prefetcher ? ExecutionProgress::kIteratingSubPipeline
+                                      : ExecutionProgress::kStartingSubPipeline;
         // All documents from the base collection have been returned, switch to iterating the sub-
         // pipeline by falling through below.
     }
 
     if (_executionState == ExecutionProgress::kStartingSubPipeline) {
+        attachCursorSourceToSubPipeline();
+        _executionState = ExecutionProgress::kIteratingSubPipeline;
+    }
+
+    if (_prefetcher) {
+        if (auto next = _prefetcher->getNext(pExpCtx->opCtx)) {
+            return std::move(*next);
+        }
+    } else if (auto res = _pipeline->getNext()) {
+        return std::move(*res);
+    }
+
+    _executionState = ExecutionProgress::kFinished;
+    return GetNextResult::makeEOF();
+}
+
+void DocumentSourceUnionWith::attachCursorSourceToSubPipeline() {
+    while (true) {
         auto serializedPipe = _pipeline->serializeToBson();
         LOGV2_DEBUG(23869,
                     1,
@@ -189,7 +385,7 @@ DocumentSource::GetNextResult DocumentSourceUnionWith::doGetNext() {
         try {
             _pipeline =
                 pExpCtx->mongoProcessInterface->attachCursorSourceToPipeline(_pipeline.release());
-            _executionState = ExecutionProgress::kIteratingSubPipeline;
+            return;
         } catch (const ExceptionFor<ErrorCodes::CommandOnShardedViewNotSupportedOnMongod>& e) {
             _pipeline = buildPipelineFromViewDefinition(
                 pExpCtx,
@@ -202,16 +398,40 @@ DocumentSource::GetNextResult DocumentSourceUnionWith::doGetNext() {
                         "ns"_attr = e->getNamespace(),
                         "pipeline"_attr = Value(e->getPipeline()),
                         "new_pipe"_attr = _pipeline->serializeToBson());
-            return doGetNext();
         }
     }
+}
 
-    auto res = _pipeline->getNext();
-    if (res)
-        return std::move(*res);
+bool DocumentSourceUnionWith::canPrefetch() const {
+    if (!internalQueryUnionWithPrefetch.load() || !pExpCtx->opCtx || pExpCtx->inMongos ||
+        pExpCtx->fromMongos || pExpCtx->needsMerge || pExpCtx->inMultiDocumentTransaction ||
+        pExpCtx->explain || pExpCtx->tailableMode != TailableModeEnum::kNormal) {
+        return false;
+    }
 
-    _executionState = ExecutionProgress::kFinished;
-    return GetNextResult::makeEOF();
+    // The sub-pipeline reads from a snapshot of its own, under the default read concern.
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(pExpCtx->opCtx);
+    if (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern ||
+        readConcernArgs.getArgsAfterClusterTime() || readConcernArgs.getArgsAtClusterTime()) {
+        return false;
+    }
+
+    for (auto&& stageSpec : _pipeline->serializeToBson()) {
+        if (JsExecution::usedBy(stageSpec)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DocumentSourceUnionWith::startPrefetch() {
+    // The cursor source is attached under the OperationContext of this stage, so that any error in
+    // resolving the sub-pipeline is reported right away. The prefetching thread then reattaches
+    // the sub-pipeline to an OperationContext of its own.
+    attachCursorSourceToSubPipeline();
+    _pipeline->detachFromOperationContext();
+    _prefetcher = std::make_unique<Prefetcher>(std::move(_pipeline), pExpCtx->opCtx);
+    LOGV2_DEBUG(5021436, 3, "$unionWith started prefetching its sub-pipeline");
 }
 
 Pipeline::SourceContainer::iterator DocumentSourceUnionWith::doOptimizeAt(
@@ -223,6 +443,9 @@ Pipeline::SourceContainer::iterator DocumentSourceUnionWith::doOptimizeAt(
         return newStageItr == container->begin() ? newStageItr : std::prev(newStageItr);
     };
     if (std::next(itr) != container->end()) {
+        // A $sort does not depend on the order of its input, so the results of the sub-pipeline
+        // can be returned as soon as they are prefetched.
+        _interleaveWithSubPipeline = dynamic_cast<DocumentSourceSort*>(std::next(itr)->get());
         if (auto nextMatch = dynamic_cast<DocumentSourceMatch*>((*std::next(itr)).get()))
             return duplicateAcrossUnion(nextMatch);
         else if (auto nextProject = dynamic_cast<DocumentSourceSingleDocumentTransformation*>(
@@ -233,6 +456,9 @@ Pipeline::SourceContainer::iterator DocumentSourceUnionWith::doOptimizeAt(
 };
 
 bool DocumentSourceUnionWith::usedDisk() {
+    if (_prefetcher) {
+        _usedDisk = _usedDisk || _prefetcher->usedDisk();
+    }
     if (_pipeline) {
         _usedDisk = _usedDisk || _pipeline->usedDisk();
     }
@@ -240,6 +466,11 @@ bool DocumentSourceUnionWith::usedDisk() {
 }
 
 void DocumentSourceUnionWith::doDispose() {
+    if (_prefetcher) {
+        _prefetcher->stop();
+        _usedDisk = _usedDisk || _prefetcher->usedDisk();
+        _prefetcher.reset();
+    }
     if (_pipeline) {
         _usedDisk = _usedDisk || _pipeline->usedDisk();
         if (!_pipeline->getContext()->explain) {
@@ -61,8 +61,7 @@ public:
     };
 
     DocumentSourceUnionWith(const boost::intrusive_ptr<ExpressionContext>& expCtx,
-                            std::unique_ptr<Pipeline, PipelineDeleter> pipeline)
-        : DocumentSource(kStageName, expCtx), _pipeline(std::move(pipeline)) {}
+                            std::unique_ptr<Pipeline, PipelineDeleter> pipeline);
 
     ~DocumentSourceUnionWith();
 
@@ -154,7 +153,31 @@ private:
 
     void addViewDefinition(NamespaceString nss, std::vector<BSONObj> viewPipeline);
 
+    /**
+     * Replaces '_pipeline' with a pipeline which has a cursor source attached, following the
+     * definition of the view the sub-pipeline reads from if necessary.
+     */
+    void attachCursorSourceToSubPipeline();
+
+    /**
+     * Returns true if the sub-pipeline can run under an OperationContext and snapshot of its own
+     * while this stage is still reading its input.
+     */
+    bool canPrefetch() const;
+
+    /**
+     * Hands '_pipeline' over to a '_prefetcher' which starts running it on a thread of its own.
+     */
+    void startPrefetch();
+
+    class Prefetcher;
+
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
+    std::unique_ptr<Prefetcher> _prefetcher;
+    bool _checkedPrefetch = false;
+    // Set if the stage which follows this one does not depend on the order of its input, in which
+    // case prefetched results are returned as soon as they are available.
+    bool _interleaveWithSubPipeline = false;
     bool _usedDisk = false;
     ExecutionProgress _executionState = ExecutionProgress::kIteratingSource;
 };
@@ -48,7 +48,9 @@
 #include "mongo/db/pipeline/document_source_union_with.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/process_interface/stub_lookup_single_document_process_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -342,6 +344,62 @@ TEST_F(DocumentSourceUnionWithTest, ReturnEOFAfterBeingDisposed) {
     ASSERT_TRUE(unionWith.getNext().isEOF());
 }
 
+TEST_F(DocumentSourceUnionWithTest, PrefetchedSubPipelineResultsFollowTheInput) {
+    const auto originalPrefetch = internalQueryUnionWithPrefetch.load();
+    internalQueryUnionWithPrefetch.store(true);
+    ON_BLOCK_EXIT([&] { internalQueryUnionWithPrefetch.store(originalPrefetch); });
+
+    const auto mockInput =
+        DocumentSourceMock::createForTest({Document{{"a", 1}}, Document{{"a", 2}}}, getExpCtx());
+    const auto mockUnionInput = std::deque<DocumentSource::GetNextResult>{
+        Document{{"b", 1}}, Document{{"b", 2}}, Document{{"b", 3}}};
+    const auto mockCtx = getExpCtx()->copyWith({});
+    mockCtx->mongoProcessInterface = std::make_unique<MockMongoInterface>(mockUnionInput);
+    auto unionWith = DocumentSourceUnionWith(
+        mockCtx,
+        Pipeline::create(std::list<boost::intrusive_ptr<DocumentSource>>{},
+                         getExpCtx()->copyWith({})));
+    unionWith.setSource(mockInput.get());
+
+    for (auto&& expected : {Document{{"a", 1}},
+                            Document{{"a", 2}},
+                            Document{{"b", 1}},
+                            Document{{"b", 2}},
+                            Document{{"b", 3}}}) {
+        auto next = unionWith.getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), expected);
+    }
+    ASSERT_TRUE(unionWith.getNext().isEOF());
+    ASSERT_TRUE(unionWith.getNext().isEOF());
+}
+
+TEST_F(DocumentSourceUnionWithTest, DisposeStopsPrefetchingWhenTheBufferIsFull) {
+    const auto originalPrefetch = internalQueryUnionWithPrefetch.load();
+    const auto originalMaxBufferBytes = internalQueryUnionWithPrefetchMaxBufferBytes.load();
+    internalQueryUnionWithPrefetch.store(true);
+    internalQueryUnionWithPrefetchMaxBufferBytes.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalQueryUnionWithPrefetch.store(originalPrefetch);
+        internalQueryUnionWithPrefetchMaxBufferBytes.store(originalMaxBufferBytes);
+    });
+
+    const auto mockInput = DocumentSourceMock::createForTest({Document(), Document()}, getExpCtx());
+    const auto mockUnionInput = std::deque<DocumentSource::GetNextResult>(100, Document{{"b", 1}});
+    const auto mockCtx = getExpCtx()->copyWith({});
+    mockCtx->mongoProcessInterface = std::make_unique<MockMongoInterface>(mockUnionInput);
+    auto unionWith = DocumentSourceUnionWith(
+        mockCtx,
+        Pipeline::create(std::list<boost::intrusive_ptr<DocumentSource>>{},
+                         getExpCtx()->copyWith({})));
+    unionWith.setSource(mockInput.get());
+
+    ASSERT_TRUE(unionWith.getNext().isAdvanced());
+
+    unionWith.dispose();
+    ASSERT_TRUE(unionWith.getNext().isEOF());
+}
+
 TEST_F(DocumentSourceUnionWithTest, DependencyAnalysisReportsFullDoc) {
     auto expCtx = getExpCtx();
     const auto replaceRoot =
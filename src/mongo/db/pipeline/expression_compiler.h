@@ -0,0 +1,80 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <functional>
+#include <memory>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+
+namespace mongo {
+
+class Expression;
+class ExpressionContext;
+
+/**
+ * An Expression translated ahead of time into a form which evaluates faster than walking the
+ * Expression tree, such as slot-based execution engine bytecode. A CompiledExpression belongs to a
+ * single stage and must not be shared across threads.
+ */
+class CompiledExpression {
+public:
+    virtual ~CompiledExpression() = default;
+
+    /**
+     * Evaluates the expression against 'root'. Returns boost::none if the compiled form cannot
+     * handle this particular document or result, in which case the caller must fall back to
+     * Expression::evaluate().
+     */
+    virtual boost::optional<Value> evaluate(const Document& root) = 0;
+};
+
+namespace expression_compiler {
+
+using CompileFn =
+    std::function<std::unique_ptr<CompiledExpression>(ExpressionContext*, Expression*)>;
+
+/**
+ * Installs the function used to compile Expressions. The compiler lives outside of the pipeline
+ * libraries, so it is registered at startup by the library implementing it.
+ */
+void registerCompiler(CompileFn compileFn);
+
+/**
+ * Compiles 'expr', which must already be optimized so that its constant subtrees are folded.
+ * Returns nullptr if compilation is disabled by the internalQueryCompileAggExpressionsToSbe knob,
+ * if no compiler is registered, or if 'expr' uses anything the compiler does not support.
+ */
+std::unique_ptr<CompiledExpression> compile(ExpressionContext* expCtx, Expression* expr);
+
+}  // namespace expression_compiler
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/scripting/engine.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -274,5 +275,47 @@ TEST_F(MapReduceFixture, ExpressionInternalJsErrorsIfProducesTooManyDocumentsFor
     ASSERT_THROWS_CODE(
         expr->evaluate(Document{BSON("val" << 1)}, getVariables()), AssertionException, 31292);
 }
+
+TEST_F(MapReduceFixture, ReleasedThreadScopeIsReusedForTheSamePoolName) {
+    auto engine = getGlobalScriptEngine();
+    auto scope = engine->getPooledScopeForCurrentThread("pool", boost::none);
+    scope->setNumber("x", 1);
+    engine->releaseScopeForCurrentThread("pool", std::move(scope));
+
+    scope = engine->getPooledScopeForCurrentThread("pool", boost::none);
+    ASSERT_EQ(scope->getNumber("x"), 1);
+}
+
+TEST_F(MapReduceFixture, ReleasedThreadScopeIsNotReusedForADifferentPoolName) {
+    auto engine = getGlobalScriptEngine();
+    auto scope = engine->getPooledScopeForCurrentThread("pool", boost::none);
+    scope->setNumber("x", 1);
+    engine->releaseScopeForCurrentThread("pool", std::move(scope));
+
+    scope = engine->getPooledScopeForCurrentThread("otherPool", boost::none);
+    ASSERT_EQ(scope->type("x"), Undefined);
+}
+
+TEST_F(MapReduceFixture, ReleasedThreadScopeIsNotReusedAfterAnotherThreadDropsTheScopeCache) {
+    auto engine = getGlobalScriptEngine();
+    auto scope = engine->getPooledScopeForCurrentThread("pool", boost::none);
+    scope->setNumber("x", 1);
+    engine->releaseScopeForCurrentThread("pool", std::move(scope));
+
+    stdx::thread([] { ScriptEngine::dropScopeCache(); }).join();
+
+    scope = engine->getPooledScopeForCurrentThread("pool", boost::none);
+    ASSERT_EQ(scope->type("x"), Undefined);
+}
+
+TEST_F(MapReduceFixture, ReleasedThreadScopeIsNotReusedForAnEmptyPoolName) {
+    auto engine = getGlobalScriptEngine();
+    auto scope = engine->getPooledScopeForCurrentThread("", boost::none);
+    scope->setNumber("x", 1);
+    engine->releaseScopeForCurrentThread("", std::move(scope));
+
+    scope = engine->getPooledScopeForCurrentThread("", boost::none);
+    ASSERT_EQ(scope->type("x"), Undefined);
+}
 }  // namespace
 }  // namespace mongo
@@ -34,14 +34,76 @@
 #include <iostream>
 
 #include "mongo/base/status_with.h"
+#include "mongo/db/auth/authorization_session.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
 
 namespace {
 const auto getExec = OperationContext::declareDecoration<std::unique_ptr<JsExecution>>();
+
+/**
+ * Returns the name of the pool a scope can be reused from. Globals set by an operation remain
+ * visible to the next user of the scope, so scopes are only shared by operations on the same
+ * database, by the same users and with the same heap limit and stored procedures. Returns an empty
+ * string if the authenticated users cannot be determined.
+ */
+std::string makePoolName(OperationContext* opCtx,
+                         StringData database,
+                         bool loadStoredProcedures,
+                         boost::optional<int> jsHeapLimitMB) {
+    auto client = opCtx->getClient();
+    if (!client || !AuthorizationSession::exists(client)) {
+        return std::string();
+    }
+    auto as = AuthorizationSession::get(client);
+
+    // Using a NUL byte which isn't valid in database or user names to separate the components.
+    StringBuilder sb;
+    sb << database << '\0' << loadStoredProcedures << '\0' << jsHeapLimitMB.value_or(0);
+    for (auto nameIter = as->getAuthenticatedUserNames(); nameIter.more(); nameIter.next()) {
+        sb << '\0' << nameIter->getUnambiguousName();
+    }
+    return sb.str();
+}
+
+// Replaces 'emit' in a scope which is released for reuse, since the native function injected by
+// the previous operation refers to state owned by that operation.
+BSONObj emitUnavailable(const BSONObj& args, void* data) {
+    uasserted(4798620, "emit is not available outside of a mapReduce map function");
+}
 }  // namespace
 
+JsExecution::JsExecution(OperationContext* opCtx,
+                         const BSONObj& scopeVars,
+                         boost::optional<int> jsHeapLimitMB,
+                         std::string poolName)
+    : _scopeVars(scopeVars.getOwned()),
+      _poolName(std::move(poolName)),
+      _scope(getGlobalScriptEngine()->getPooledScopeForCurrentThread(
+          internalQueryJavaScriptReuseScopes.load() ? _poolName : std::string(), jsHeapLimitMB)) {
+    _scope->init(&_scopeVars);
+    _fnCallTimeoutMillis = internalQueryJavaScriptFnTimeoutMillis.load();
+    _scope->registerOperation(opCtx);
+}
+
+JsExecution::~JsExecution() {
+    _scope->unregisterOperation();
+
+    if (_poolName.empty() || !internalQueryJavaScriptReuseScopes.load()) {
+        return;
+    }
+
+    if (_emitCreated) {
+        try {
+            _scope->injectNative("emit", emitUnavailable);
+        } catch (const DBException&) {
+            return;
+        }
+    }
+    getGlobalScriptEngine()->releaseScopeForCurrentThread(_poolName, std::move(_scope));
+}
+
 JsExecution* JsExecution::get(OperationContext* opCtx,
                               const BSONObj& scope,
                               StringData database,
@@ -49,7 +111,11 @@ JsExecution* JsExecution::get(OperationContext* opCtx,
                               boost::optional<int> jsHeapLimitMB) {
     auto& exec = getExec(opCtx);
     if (!exec) {
-        exec = std::make_unique<JsExecution>(opCtx, scope, jsHeapLimitMB);
+        exec.reset(new JsExecution(
+            opCtx,
+            scope,
+            jsHeapLimitMB,
+            makePoolName(opCtx, database, loadStoredProcedures, jsHeapLimitMB)));
         exec->getScope()->setLocalDB(database);
         if (loadStoredProcedures) {
             exec->getScope()->loadStored(opCtx, true);
@@ -75,6 +141,20 @@ Value JsExecution::callFunction(ScriptingFunction func,
     return Value(returnValue.done().firstElement());
 }
 
+bool JsExecution::usedBy(const BSONObj& spec) {
+    for (auto&& elem : spec) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "$function"_sd || fieldName == "$accumulator"_sd ||
+            fieldName == "$_internalJsEmit"_sd || fieldName == "$_internalJsReduce"_sd) {
+            return true;
+        }
+        if (elem.isABSONObj() && usedBy(elem.embeddedObject())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void JsExecution::callFunctionWithoutReturn(ScriptingFunction func,
                                             const BSONObj& params,
                                             const BSONObj& thisObj) {
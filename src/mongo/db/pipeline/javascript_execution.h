@@ -58,22 +58,27 @@ public:
                             StringData database,
                             bool loadStoredProcedures,
                             boost::optional<int> jsHeapLimitMB);
+
+    /**
+     * Returns true if the stage or expression specification 'spec' uses an expression or
+     * accumulator which runs JavaScript. The JsExecution is bound to the operation which created
+     * it, so such a specification cannot be evaluated on behalf of that operation on other threads.
+     */
+    static bool usedBy(const BSONObj& spec);
+
     /**
      * Construct with a thread-local scope and initialize with the given scope variables.
      */
     JsExecution(OperationContext* opCtx,
                 const BSONObj& scopeVars,
                 boost::optional<int> jsHeapLimitMB = boost::none)
-        : _scope(getGlobalScriptEngine()->newScopeForCurrentThread(jsHeapLimitMB)) {
-        _scopeVars = scopeVars.getOwned();
-        _scope->init(&_scopeVars);
-        _fnCallTimeoutMillis = internalQueryJavaScriptFnTimeoutMillis.load();
-        _scope->registerOperation(opCtx);
-    }
+        : JsExecution(opCtx, scopeVars, jsHeapLimitMB, std::string()) {}
 
-    ~JsExecution() {
-        _scope->unregisterOperation();
-    };
+    /**
+     * If this JsExecution was created with a pool name, hands its scope back to the current thread
+     * so that the next JsExecution created with the same pool name on this thread can reuse it.
+     */
+    ~JsExecution();
 
     /**
      * Invokes the javascript function given by 'func' with the arguments 'params' and input object
@@ -116,7 +121,17 @@ public:
     }
 
 private:
+    /**
+     * Construct with the idle scope of the current thread if it was released under 'poolName', or
+     * with a new thread-local scope otherwise. An empty 'poolName' never reuses a scope.
+     */
+    JsExecution(OperationContext* opCtx,
+                const BSONObj& scopeVars,
+                boost::optional<int> jsHeapLimitMB,
+                std::string poolName);
+
     BSONObj _scopeVars;
+    std::string _poolName;
     std::unique_ptr<Scope> _scope;
     bool _emitCreated = false;
     bool _storedProceduresLoaded = false;
@@ -0,0 +1,299 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/parallel_group_executor.h"
+
+#include <algorithm>
+
+#include "mongo/db/client.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/producer_consumer_queue.h"
+
+namespace mongo {
+namespace {
+
+// Documents are handed over to the consumer threads in batches, so that the threads synchronize
+// once per batch rather than once per document.
+constexpr size_t kBatchSize = 128;
+
+// The number of batches that may be waiting for a consumer before the reading thread blocks.
+constexpr size_t kMaxQueuedBatches = 16;
+
+using BatchQueue = SingleProducerSingleConsumerQueue<std::vector<Document>>;
+
+/**
+ * Returns a copy of 'doc' which does not share any mutable state with 'doc'. A Document caches the
+ * fields it has looked up in its underlying BSON, and documents produced by stages such as $unwind
+ * share their storage, so a document cannot be read on two threads at once.
+ */
+Document makeIndependent(Document doc) {
+    if (!doc.metadata()) {
+        if (auto bson = doc.toBsonIfTriviallyConvertible()) {
+            return Document(bson->getOwned());
+        }
+    }
+    return Document::fromBsonWithMetaData(doc.toBsonWithMetaData());
+}
+
+/**
+ * Feeds the documents routed to a consumer to its $group stage.
+ */
+class DocumentSourcePartitionInput final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalParallelGroupInput"_sd;
+
+    DocumentSourcePartitionInput(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                 BatchQueue* queue)
+        : DocumentSource(kStageName, expCtx), _queue(queue) {}
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    Value serialize(
+        boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final {
+        // This stage only exists inside a ParallelGroupExecutor, which is never serialized.
+        MONGO_UNREACHABLE;
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kNone,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kAllowed,
+                                     LookupRequirement::kAllowed,
+                                     UnionRequirement::kAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+private:
+    GetNextResult doGetNext() final {
+        while (_nextInBatch == _batch.size()) {
+            try {
+                _batch = _queue->pop(pExpCtx->opCtx);
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
+                return GetNextResult::makeEOF();
+            }
+            _nextInBatch = 0;
+        }
+        return std::move(_batch[_nextInBatch++]);
+    }
+
+    BatchQueue* _queue;
+    std::vector<Document> _batch;
+    size_t _nextInBatch = 0;
+};
+
+BatchQueue::Options makeQueueOptions() {
+    BatchQueue::Options options;
+    options.maxQueueDepth = kMaxQueuedBatches;
+    return options;
+}
+
+}  // namespace
+
+struct ParallelGroupExecutor::Consumer {
+    explicit Consumer(boost::intrusive_ptr<DocumentSource> groupStage)
+        : group(std::move(groupStage)),
+          queue(makeQueueOptions()),
+          input(make_intrusive<DocumentSourcePartitionInput>(group->getContext(), &queue)) {
+        group->setSource(input.get());
+    }
+
+    boost::intrusive_ptr<DocumentSource> group;
+    BatchQueue queue;
+    boost::intrusive_ptr<DocumentSource> input;
+
+    // Documents routed to this consumer which have not been pushed to 'queue' yet.
+    std::vector<Document> pending;
+
+    // The first result of 'group', which the consumer thread produces while aggregating.
+    boost::optional<DocumentSource::GetNextResult> firstResult;
+    Status status = Status::OK();
+    stdx::thread thread;
+};
+
+ParallelGroupExecutor::ParallelGroupExecutor(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::vector<boost::intrusive_ptr<DocumentSource>> consumers,
+    PartitionKeyFn partitionKey)
+    : _expCtx(expCtx), _partitionKey(std::move(partitionKey)) {
+    invariant(!consumers.empty());
+    for (auto&& group : consumers) {
+        _consumers.push_back(std::make_unique<Consumer>(std::move(group)));
+    }
+}
+
+ParallelGroupExecutor::~ParallelGroupExecutor() {
+    if (_started && !_finishedConsuming) {
+        joinConsumers(true);
+    }
+}
+
+void ParallelGroupExecutor::startConsumers() {
+    auto serviceContext = _expCtx->opCtx->getServiceContext();
+    for (auto&& consumer : _consumers) {
+        consumer->pending.reserve(kBatchSize);
+        consumer->thread = stdx::thread([consumer = consumer.get(), serviceContext] {
+            ThreadClient tc("ParallelGroupConsumer", serviceContext);
+            auto opCtx = tc->makeOperationContext();
+            auto& expCtx = consumer->group->getContext();
+            expCtx->opCtx = opCtx.get();
+            try {
+                // An unsorted $group consumes all of its input before returning its first result.
+                consumer->firstResult = consumer->group->getNext();
+            } catch (const DBException& ex) {
+                consumer->status = ex.toStatus();
+                // Unblock the reading thread if it is waiting for space in the queue.
+                consumer->queue.closeConsumerEnd();
+            }
+            expCtx->opCtx = nullptr;
+        });
+    }
+    _started = true;
+}
+
+void ParallelGroupExecutor::flush(Consumer* consumer) {
+    auto batch = std::move(consumer->pending);
+    consumer->pending.clear();
+    consumer->pending.reserve(kBatchSize);
+    try {
+        consumer->queue.push(std::move(batch), _expCtx->opCtx);
+    } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+        // The consumer has failed. Stop the others and report its error.
+        joinConsumers(true);
+        uassertStatusOK(consumer->status);
+        throw;
+    }
+}
+
+void ParallelGroupExecutor::joinConsumers(bool abandon) {
+    for (auto&& consumer : _consumers) {
+        if (abandon) {
+            consumer->queue.closeConsumerEnd();
+        } else {
+            consumer->queue.closeProducerEnd();
+        }
+    }
+    for (auto&& consumer : _consumers) {
+        if (consumer->thread.joinable()) {
+            consumer->thread.join();
+        }
+    }
+    _finishedConsuming = true;
+}
+
+DocumentSource::GetNextResult ParallelGroupExecutor::consume(DocumentSource* source) {
+    invariant(!_finishedConsuming);
+    if (!_started) {
+        startConsumers();
+    }
+
+    auto input = source->getNext();
+    for (; input.isAdvanced(); input = source->getNext()) {
+        auto doc = makeIndependent(input.releaseDocument());
+        auto hash = _expCtx->getValueComparator().hash(_partitionKey(doc));
+        auto consumer = _consumers[hash % _consumers.size()].get();
+        consumer->pending.push_back(std::move(doc));
+        if (consumer->pending.size() == kBatchSize) {
+            flush(consumer);
+        }
+    }
+
+    if (input.isPaused()) {
+        return input;
+    }
+    invariant(input.isEOF());
+
+    for (auto&& consumer : _consumers) {
+        if (!consumer->pending.empty()) {
+            flush(consumer.get());
+        }
+    }
+    joinConsumers(false);
+
+    for (auto&& consumer : _consumers) {
+        uassertStatusOK(consumer->status);
+    }
+    return input;
+}
+
+DocumentSource::GetNextResult ParallelGroupExecutor::getNext() {
+    invariant(_finishedConsuming);
+    while (_outputConsumer < _consumers.size()) {
+        auto& consumer = *_consumers[_outputConsumer];
+        // The consumer continues on this thread, under whichever operation is now executing it.
+        consumer.group->getContext()->opCtx = _expCtx->opCtx;
+
+        auto next = consumer.firstResult ? std::move(*consumer.firstResult)
+                                         : consumer.group->getNext();
+        consumer.firstResult.reset();
+        if (next.isAdvanced()) {
+            return next;
+        }
+        invariant(next.isEOF());
+        ++_outputConsumer;
+    }
+    return DocumentSource::GetNextResult::makeEOF();
+}
+
+bool ParallelGroupExecutor::usedDisk() {
+    if (!_finishedConsuming) {
+        return false;
+    }
+    return std::any_of(_consumers.begin(), _consumers.end(), [](auto&& consumer) {
+        return consumer->group->usedDisk();
+    });
+}
+
+void ParallelGroupExecutor::dispose() {
+    if (_disposed) {
+        return;
+    }
+    if (_started && !_finishedConsuming) {
+        joinConsumers(true);
+    }
+    for (auto&& consumer : _consumers) {
+        consumer->group->getContext()->opCtx = _expCtx->opCtx;
+        consumer->group->dispose();
+    }
+    _disposed = true;
+}
+
+}  // namespace mongo
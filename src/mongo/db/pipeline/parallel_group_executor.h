@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+/**
+ * Runs the accumulation phase of a $group on several threads. Input documents are hash partitioned
+ * on their group key among a number of consumer $group stages, so that every group is built by
+ * exactly one consumer and the consumers' outputs can simply be concatenated.
+ *
+ * The thread calling consume() reads the input and routes it to the consumers, each running on a
+ * thread of its own. The consumers only aggregate documents and never read from storage, so they
+ * do not need the locks or the storage snapshot of the calling operation.
+ */
+class ParallelGroupExecutor {
+public:
+    using PartitionKeyFn = std::function<Value(const Document&)>;
+
+    /**
+     * 'consumers' must be $group stages without a source, each with an ExpressionContext of its
+     * own. 'partitionKey' computes the group key of an input document on the calling thread.
+     */
+    ParallelGroupExecutor(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                          std::vector<boost::intrusive_ptr<DocumentSource>> consumers,
+                          PartitionKeyFn partitionKey);
+
+    ~ParallelGroupExecutor();
+
+    ParallelGroupExecutor(const ParallelGroupExecutor&) = delete;
+    ParallelGroupExecutor& operator=(const ParallelGroupExecutor&) = delete;
+
+    /**
+     * Routes the documents of 'source' to the consumers until 'source' pauses or is exhausted, and
+     * returns the pause or EOF. Once 'source' is exhausted, waits for every consumer to finish
+     * aggregating and rethrows the first error a consumer ran into.
+     */
+    DocumentSource::GetNextResult consume(DocumentSource* source);
+
+    /**
+     * Returns the next output document, draining the consumers one after another. May only be
+     * called after consume() has returned EOF.
+     */
+    DocumentSource::GetNextResult getNext();
+
+    bool usedDisk();
+
+    /**
+     * Stops any consumer threads that are still running and disposes of the consumers.
+     */
+    void dispose();
+
+private:
+    struct Consumer;
+
+    void startConsumers();
+
+    /**
+     * Hands the documents buffered for 'consumer' over to its thread.
+     */
+    void flush(Consumer* consumer);
+
+    /**
+     * Waits for all consumer threads to exit. If 'abandon' is true, the consumers are told to stop
+     * without finishing their input.
+     */
+    void joinConsumers(bool abandon);
+
+    boost::intrusive_ptr<ExpressionContext> _expCtx;
+    PartitionKeyFn _partitionKey;
+    std::vector<std::unique_ptr<Consumer>> _consumers;
+    bool _started = false;
+    bool _finishedConsuming = false;
+    bool _disposed = false;
+    size_t _outputConsumer = 0;
+};
+
+}  // namespace mongo
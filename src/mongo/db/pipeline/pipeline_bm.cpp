@@ -0,0 +1,223 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/pipeline/process_interface/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace {
+
+// Counts the calls to the global operator new, so that the benchmarks can report the allocations
+// per document. DocumentStorage allocates through the global operator new whenever its per-thread
+// pool has no buffer to recycle, so document buffers are included.
+mongo::AtomicWord<long long> numAllocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    numAllocations.fetchAndAddRelaxed(1);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.pipelineBm");
+const NamespaceString kForeignNss("test.pipelineBmForeign");
+const int kNumDocs = 10 * 1000;
+const int kNumForeignDocs = 20;
+
+/**
+ * A MongoProcessInterface which feeds every $lookup sub-pipeline from the same set of foreign
+ * documents.
+ */
+class LookupMongoProcessInterface final : public StubMongoProcessInterface {
+public:
+    explicit LookupMongoProcessInterface(std::deque<DocumentSource::GetNextResult> foreignDocs)
+        : _foreignDocs(std::move(foreignDocs)) {}
+
+    bool isSharded(OperationContext* opCtx, const NamespaceString& ns) final {
+        return false;
+    }
+
+    std::unique_ptr<Pipeline, PipelineDeleter> attachCursorSourceToPipeline(
+        Pipeline* ownedPipeline, bool allowTargetingShards = true) final {
+        std::unique_ptr<Pipeline, PipelineDeleter> pipeline(
+            ownedPipeline, PipelineDeleter(ownedPipeline->getContext()->opCtx));
+        pipeline->addInitialSource(
+            DocumentSourceMock::createForTest(_foreignDocs, pipeline->getContext()));
+        return pipeline;
+    }
+
+private:
+    std::deque<DocumentSource::GetNextResult> _foreignDocs;
+};
+
+/**
+ * Builds 'kNumDocs' input documents of the shape selected by the benchmark arguments, with
+ * state.range(0) extra scalar fields and an array of state.range(1) elements.
+ *
+ * {_id: <i>, a: <i % 100>, b: <string>, arr: [0, 1, ...], f0: <i>, f1: <i>, ...}
+ */
+std::deque<DocumentSource::GetNextResult> makeInputDocs(const benchmark::State& state) {
+    const int numExtraFields = state.range(0);
+    const int arrayLength = state.range(1);
+
+    std::vector<Value> arr;
+    for (int i = 0; i < arrayLength; ++i) {
+        arr.emplace_back(i);
+    }
+
+    std::deque<DocumentSource::GetNextResult> docs;
+    for (int i = 0; i < kNumDocs; ++i) {
+        MutableDocument doc;
+        doc.addField("_id", Value(i));
+        doc.addField("a", Value(i % 100));
+        doc.addField("b", Value("abcdefghijklmnopqrstuvwxyz"_sd));
+        doc.addField("arr", Value(arr));
+        for (int field = 0; field < numExtraFields; ++field) {
+            doc.addField("f" + std::to_string(field), Value(i));
+        }
+        docs.emplace_back(doc.freeze());
+    }
+    return docs;
+}
+
+/**
+ * Runs the single stage 'stageSpec' over the input documents, reporting the number of inputs
+ * processed, so the per-document time can be read off, and the allocations per input document.
+ */
+void runStage(benchmark::State& state, const BSONObj& stageSpec) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto expCtx = make_intrusive<ExpressionContext>(opCtx.get(), nullptr, kNss);
+    std::deque<DocumentSource::GetNextResult> foreignDocs;
+    for (int i = 0; i < kNumForeignDocs; ++i) {
+        foreignDocs.emplace_back(Document{{"_id", i}, {"a", i}});
+    }
+    expCtx->mongoProcessInterface =
+        std::make_shared<LookupMongoProcessInterface>(std::move(foreignDocs));
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {kForeignNss.coll().toString(), {kForeignNss, std::vector<BSONObj>()}}});
+
+    const auto inputDocs = makeInputDocs(state);
+
+    long long allocations = 0;
+    for (auto keepRunning : state) {
+        state.PauseTiming();
+        auto pipeline = Pipeline::parse({stageSpec}, expCtx);
+        pipeline->addInitialSource(DocumentSourceMock::createForTest(inputDocs, expCtx));
+        state.ResumeTiming();
+
+        const long long allocationsBefore = numAllocations.loadRelaxed();
+        while (auto next = pipeline->getNext()) {
+            benchmark::DoNotOptimize(next);
+        }
+        allocations += numAllocations.loadRelaxed() - allocationsBefore;
+
+        state.PauseTiming();
+        pipeline.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kNumDocs);
+    state.counters["allocsPerDoc"] =
+        benchmark::Counter(static_cast<double>(allocations) / kNumDocs,
+                           benchmark::Counter::kAvgIterations);
+}
+
+void BM_Match(benchmark::State& state) {
+    runStage(state, fromjson("{$match: {a: {$lt: 50}, b: {$exists: true}}}"));
+}
+
+void BM_Project(benchmark::State& state) {
+    runStage(state, fromjson("{$project: {_id: 0, a: 1, c: {$add: ['$a', 1]}}}"));
+}
+
+void BM_Group(benchmark::State& state) {
+    runStage(state, fromjson("{$group: {_id: '$a', total: {$sum: '$_id'}, n: {$sum: 1}}}"));
+}
+
+void BM_Sort(benchmark::State& state) {
+    runStage(state, fromjson("{$sort: {a: 1, _id: -1}}"));
+}
+
+void BM_Unwind(benchmark::State& state) {
+    runStage(state, fromjson("{$unwind: '$arr'}"));
+}
+
+void BM_Lookup(benchmark::State& state) {
+    runStage(state,
+             BSON("$lookup" << BSON("from" << kForeignNss.coll() << "localField"
+                                           << "a"
+                                           << "foreignField"
+                                           << "a"
+                                           << "as"
+                                           << "joined")));
+}
+
+// Arguments are {number of extra fields, array length}: narrow and wide documents with a short
+// array, and wide documents with a long array.
+#define PIPELINE_BENCHMARK(bm) BENCHMARK(bm)->Args({0, 4})->Args({32, 4})->Args({32, 64})
+
+PIPELINE_BENCHMARK(BM_Match);
+PIPELINE_BENCHMARK(BM_Project);
+PIPELINE_BENCHMARK(BM_Group);
+PIPELINE_BENCHMARK(BM_Sort);
+PIPELINE_BENCHMARK(BM_Unwind);
+PIPELINE_BENCHMARK(BM_Lookup);
+
+}  // namespace
+}  // namespace mongo
@@ -62,16 +62,21 @@
 #include "mongo/db/pipeline/document_source_geo_near.h"
 #include "mongo/db/pipeline/document_source_geo_near_cursor.h"
 #include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_lookup.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
+#include "mongo/db/pipeline/document_source_shared_oplog_cursor.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_executor_factory.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/sort_pattern.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -174,6 +179,53 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorEx
         expCtx, std::move(ws), std::move(root), coll, PlanYieldPolicy::YieldPolicy::YIELD_AUTO);
 }
 
+/**
+ * Estimates the fraction of the documents in 'coll' that match 'filter' by evaluating it against up
+ * to 'maxPresampleSize' documents read through a random cursor. Returns boost::none if the storage
+ * engine has no random cursor support.
+ */
+boost::optional<double> estimateSelectivityWithRandomCursor(Collection* coll,
+                                                            OperationContext* opCtx,
+                                                            const MatchExpression* filter,
+                                                            size_t maxPresampleSize) {
+    auto rsRandCursor = coll->getRecordStore()->getRandomCursor(opCtx);
+    if (!rsRandCursor) {
+        return boost::none;
+    }
+
+    size_t presampled = 0;
+    size_t matched = 0;
+    for (; presampled < maxPresampleSize; ++presampled) {
+        opCtx->checkForInterrupt();
+        auto record = rsRandCursor->next();
+        if (!record) {
+            break;
+        }
+        if (filter->matchesBSON(record->data.toBson())) {
+            ++matched;
+        }
+    }
+    return presampled == 0 ? 0.0 : static_cast<double>(matched) / presampled;
+}
+
+/**
+ * Returns true if 'coll' has an index whose leading field is a path that 'filter' has a predicate
+ * on, since the query planner can then answer 'filter' without reading every document.
+ */
+bool hasIndexForFilter(Collection* coll, OperationContext* opCtx, const MatchExpression* filter) {
+    stdx::unordered_set<std::string> fields;
+    QueryPlannerIXSelect::getFields(filter, &fields);
+
+    auto it = coll->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (it->more()) {
+        const auto* desc = it->next()->descriptor();
+        if (fields.count(desc->keyPattern().firstElementFieldName())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExecutor(
     const intrusive_ptr<ExpressionContext>& expCtx,
     Collection* collection,
@@ -186,7 +238,8 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
     boost::optional<std::string> groupIdForDistinctScan,
     const AggregationRequest* aggRequest,
     const size_t plannerOpts,
-    const MatchExpressionParser::AllowedFeatureSet& matcherFeatures) {
+    const MatchExpressionParser::AllowedFeatureSet& matcherFeatures,
+    std::vector<EqLookupPushdown> lookupPushdowns = {}) {
     auto qr = std::make_unique<QueryRequest>(nss);
     qr->setTailableMode(expCtx->tailableMode);
     qr->setFilter(queryObj);
@@ -223,6 +276,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
 
     // Mark the metadata that's requested by the pipeline on the CQ.
     cq.getValue()->requestAdditionalMetadata(metadataRequested);
+    cq.getValue()->setEqLookupPushdowns(std::move(lookupPushdowns));
 
     if (groupIdForDistinctScan) {
         // When the pipeline includes a $group that groups by a single field
@@ -318,14 +372,72 @@ PipelineD::buildInnerQueryExecutor(Collection* collection,
     // We are going to generate an input cursor, so we need to be holding the collection lock.
     dassert(expCtx->opCtx->lockState()->isCollectionLockedForMode(nss, MODE_IS));
 
+    // A change stream may read the oplog through the scan shared by all the change streams on this
+    // node rather than through its own cursor. Oplog scans built on behalf of the shared scan have
+    // a non-zero sub-pipeline depth and are never substituted.
+    if (internalChangeStreamUseSharedOplogReader.load() && !expCtx->explain &&
+        expCtx->subPipelineDepth == 0 && !sources.empty()) {
+        if (auto oplogMatch = dynamic_cast<DocumentSourceOplogMatch*>(sources.front().get())) {
+            auto filter = oplogMatch->getQuery();
+            if (auto startFrom = DocumentSourceSharedOplogCursor::parseStartFrom(filter)) {
+                pipeline->popFront();
+                pipeline->addInitialSource(
+                    DocumentSourceSharedOplogCursor::create(expCtx, filter, *startFrom));
+                return {};
+            }
+        }
+    }
+
     if (!sources.empty()) {
         auto sampleStage = dynamic_cast<DocumentSourceSample*>(sources.front().get());
+
+        // A $match directly followed by $sample can sample the matching documents by rejecting the
+        // random documents that do not match, as long as enough of them do.
+        boost::intrusive_ptr<DocumentSourceMatch> matchStage;
+        if (!sampleStage && sources.size() >= 2) {
+            matchStage = dynamic_cast<DocumentSourceMatch*>(sources.front().get());
+            sampleStage = dynamic_cast<DocumentSourceSample*>(std::next(sources.begin())->get());
+            if (!sampleStage || !matchStage || matchStage->isTextQuery()) {
+                matchStage = nullptr;
+                sampleStage = nullptr;
+            }
+        }
+
         // Optimize an initial $sample stage if possible.
         if (collection && sampleStage) {
             const long long sampleSize = sampleStage->getSampleSize();
             const long long numRecords = collection->getRecordStore()->numRecords(expCtx->opCtx);
-            auto exec = uassertStatusOK(
-                createRandomCursorExecutor(collection, expCtx, sampleSize, numRecords));
+
+            // With a $match, the documents being sampled from are the estimated number of matching
+            // documents. Rejection sampling reads about 1/selectivity random documents per sampled
+            // document, so it is only used when at least kMinSelectivityForRandCursor of the
+            // documents match.
+            static const size_t kMaxPresampleSize = 100;
+            static const double kMinSelectivityForRandCursor = 0.05;
+            long long numCandidates = numRecords;
+            bool canSampleFromRandomCursor = true;
+            if (matchStage &&
+                hasIndexForFilter(collection, expCtx->opCtx, matchStage->getMatchExpression())) {
+                // The query planner can find the matching documents through the index.
+                canSampleFromRandomCursor = false;
+                numCandidates = 0;
+            } else if (matchStage) {
+                const auto selectivity =
+                    estimateSelectivityWithRandomCursor(collection,
+                                                        expCtx->opCtx,
+                                                        matchStage->getMatchExpression(),
+                                                        kMaxPresampleSize);
+                canSampleFromRandomCursor =
+                    selectivity && *selectivity >= kMinSelectivityForRandCursor;
+                numCandidates = canSampleFromRandomCursor
+                    ? static_cast<long long>(numRecords * *selectivity)
+                    : 0;
+            }
+
+            auto exec = canSampleFromRandomCursor
+                ? uassertStatusOK(
+                      createRandomCursorExecutor(collection, expCtx, sampleSize, numCandidates))
+                : nullptr;
             if (exec) {
                 // For sharded collections, the root of the plan tree is a TrialStage that may have
                 // chosen either a random-sampling cursor trial plan or a COLLSCAN backup plan. We
@@ -333,13 +445,23 @@ PipelineD::buildInnerQueryExecutor(Collection* collection,
                 auto* trialStage = (exec->getRootStage()->stageType() == StageType::STAGE_TRIAL
                                         ? static_cast<TrialStage*>(exec->getRootStage())
                                         : nullptr);
-                if (!trialStage || !trialStage->pickedBackupPlan()) {
-                    // Replace $sample stage with $sampleFromRandomCursor stage.
+                const bool pickedRandomCursor = !trialStage || !trialStage->pickedBackupPlan();
+                if (matchStage && !pickedRandomCursor) {
+                    // Let the query planner answer the $match rather than scanning the collection.
+                    exec.reset();
+                } else if (pickedRandomCursor) {
+                    // Replace $sample stage with $sampleFromRandomCursor stage, which also filters
+                    // the random documents by the $match before sampling them.
                     pipeline->popFront();
+                    if (matchStage) {
+                        pipeline->popFront();
+                    }
                     std::string idString = collection->ns().isOplog() ? "ts" : "_id";
                     pipeline->addInitialSource(DocumentSourceSampleFromRandomCursor::create(
-                        expCtx, sampleSize, idString, numRecords));
+                        expCtx, sampleSize, idString, numCandidates, matchStage));
                 }
+            }
+            if (exec) {
 
                 // The order in which we evaluate these arguments is significant. We'd like to be
                 // sure that the DocumentSourceCursor is created _last_, because if we run into a
@@ -450,6 +572,75 @@ boost::optional<long long> extractLimitForPushdown(Pipeline* pipeline) {
     return limit;
 }
 
+/**
+ * Returns true if the slot-based execution engine can run 'lookup' as an equality join over the
+ * results of the query: the $lookup must use localField/foreignField syntax on top-level fields of
+ * an unsharded collection (not a view), and any $unwind or $match it absorbed must be a plain
+ * $unwind of the 'as' field.
+ */
+bool isLookupEligibleForPushdown(const intrusive_ptr<ExpressionContext>& expCtx,
+                                 const DocumentSourceLookUp& lookup) {
+    if (lookup.wasConstructedWithPipelineSyntax() || lookup.getAdditionalFilter() ||
+        lookup.getFromNs() != lookup.getResolvedNs()) {
+        return false;
+    }
+
+    // The join reads the foreign collection locally, so it would see only this shard's chunks of a
+    // sharded foreign collection.
+    if (expCtx->mongoProcessInterface->isSharded(expCtx->opCtx, lookup.getFromNs())) {
+        return false;
+    }
+
+    if (lookup.getLocalField()->getPathLength() != 1 ||
+        lookup.getForeignField()->getPathLength() != 1 ||
+        lookup.getAsField().getPathLength() != 1) {
+        return false;
+    }
+
+    if (auto&& unwind = lookup.getUnwindSource();
+        unwind && (unwind->preserveNullAndEmptyArrays() || unwind->indexPath())) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * If the slot-based execution engine is going to execute the query, removes the $lookup stages at
+ * the front of 'pipeline' which it can execute as part of the query plan, and returns them in
+ * pipeline order.
+ */
+std::vector<EqLookupPushdown> extractLookupsForPushdown(
+    const intrusive_ptr<ExpressionContext>& expCtx, Pipeline* pipeline) {
+    std::vector<EqLookupPushdown> pushdowns;
+    if (!internalQueryEnableSlotBasedExecutionEngine.load() ||
+        !internalQuerySlotBasedExecutionEnableLookupPushdown.load() ||
+        MONGO_unlikely(disablePipelineOptimization.shouldFail())) {
+        return pushdowns;
+    }
+
+    // The join compares values with the simple collation.
+    if (expCtx->getCollator()) {
+        return pushdowns;
+    }
+
+    auto&& sources = pipeline->getSources();
+    while (!sources.empty()) {
+        auto lookup = dynamic_cast<DocumentSourceLookUp*>(sources.front().get());
+        if (!lookup || !isLookupEligibleForPushdown(expCtx, *lookup)) {
+            break;
+        }
+
+        pushdowns.push_back({lookup->getFromNs(),
+                             lookup->getLocalField()->fullPath(),
+                             lookup->getForeignField()->fullPath(),
+                             lookup->getAsField().fullPath(),
+                             static_cast<bool>(lookup->getUnwindSource())});
+        pipeline->popFront();
+    }
+    return pushdowns;
+}
+
 /**
  * Given a dependency set and a pipeline, builds a projection BSON object to push down into the
  * PlanStage layer. The rules to push down the projection are as follows:
@@ -676,21 +867,31 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         pipeline->popFrontWithName(DocumentSourceSort::kStageName);
     }
 
+    // Equality $lookup stages which follow the query can be executed by an SBE plan as joins with
+    // the foreign collection, rather than running a sub-pipeline for every document. This is
+    // incompatible with a DISTINCT_SCAN, which only applies if a $group immediately follows the
+    // query anyway.
+    auto lookupPushdowns = rewrittenGroupStage ? std::vector<EqLookupPushdown>{}
+                                               : extractLookupsForPushdown(expCtx, pipeline);
+
     // Perform dependency analysis. In order to minimize the dependency set, we only analyze the
     // stages that remain in the pipeline after pushdown. In particular, any dependencies for a
     // $match or $sort pushed down into the query layer will not be reflected here.
     auto deps = pipeline->getDependencies(unavailableMetadata);
-    *hasNoRequirements = deps.hasNoRequirements();
+    *hasNoRequirements = deps.hasNoRequirements() && lookupPushdowns.empty();
 
     BSONObj projObj;
     if (*hasNoRequirements) {
         // This query might be eligible for count optimizations, since the remaining stages in the
         // pipeline don't actually need to read any data produced by the query execution layer.
         plannerOpts |= QueryPlannerParams::IS_COUNT;
-    } else {
+    } else if (lookupPushdowns.empty()) {
         // Build a BSONObj representing a projection eligible for pushdown. If there is an inclusion
         // projection at the front of the pipeline, it will be removed and handled by the PlanStage
         // layer. If a projection cannot be pushed down, an empty BSONObj will be returned.
+        //
+        // A projection can't be pushed down below $lookup joins, since they need the entire
+        // documents produced by the query.
         projObj = buildProjectionForPushdown(deps, pipeline);
     }
 
@@ -748,7 +949,8 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
                                 boost::none, /* groupIdForDistinctScan */
                                 aggRequest,
                                 plannerOpts,
-                                matcherFeatures);
+                                matcherFeatures,
+                                std::move(lookupPushdowns));
 }
 
 Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
@@ -756,6 +958,10 @@ Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
         return docSourceCursor->getLatestOplogTimestamp();
     }
+    if (auto sharedOplogCursor =
+            dynamic_cast<DocumentSourceSharedOplogCursor*>(pipeline->_sources.front().get())) {
+        return sharedOplogCursor->getLatestOplogTimestamp();
+    }
     return Timestamp();
 }
 
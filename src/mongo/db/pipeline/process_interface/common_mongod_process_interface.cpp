@@ -35,6 +35,7 @@
 
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/commit_quorum_options.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/create_collection.h"
 #include "mongo/db/catalog/database_holder.h"
@@ -54,6 +55,7 @@
 #include "mongo/db/pipeline/pipeline_d.h"
 #include "mongo/db/query/collection_index_usage_tracker_decoration.h"
 #include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/speculative_majority_read_info.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
@@ -65,6 +67,7 @@
 #include "mongo/db/stats/storage_stats.h"
 #include "mongo/db/storage/backup_cursor_hooks.h"
 #include "mongo/db/storage/durable_catalog.h"
+#include "mongo/db/storage/two_phase_index_build_knobs_gen.h"
 #include "mongo/db/transaction_history_iterator.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/logv2/log.h"
@@ -625,6 +628,22 @@ Update CommonMongodProcessInterface::buildUpdateOp(
     return updateOp;
 }
 
+BSONObj CommonMongodProcessInterface::_makeCreateIndexesOnPopulatedCollectionCmd(
+    OperationContext* opCtx, const NamespaceString& ns, const std::vector<BSONObj>& indexSpecs) {
+    BSONObjBuilder cmd;
+    cmd.append("createIndexes", ns.coll());
+    cmd.append("indexes", indexSpecs);
+
+    // A commit quorum of 0 lets the primary commit the build as soon as it has built the indexes
+    // itself. The secondaries still finish the build before they apply the rename that follows it.
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (replCoord->isReplEnabled() && !replCoord->isOplogDisabledFor(opCtx, ns) &&
+        enableIndexBuildCommitQuorum) {
+        cmd.append("commitQuorum", CommitQuorumOptions::kDisabled);
+    }
+    return cmd.obj();
+}
+
 BSONObj CommonMongodProcessInterface::_convertRenameToInternalRename(
     OperationContext* opCtx,
     const BSONObj& renameCommandObj,
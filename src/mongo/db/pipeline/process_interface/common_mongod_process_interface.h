@@ -142,6 +142,15 @@ protected:
                                                      bool includeIdle,
                                                      std::vector<BSONObj>* ops) const final;
 
+    /**
+     * Builds the createIndexes command for createIndexesOnPopulatedCollection(). The temp
+     * collection is only renamed into place after the build, so the build does not wait for the
+     * other members of the replica set to vote that they have built the indexes too.
+     */
+    BSONObj _makeCreateIndexesOnPopulatedCollectionCmd(OperationContext* opCtx,
+                                                       const NamespaceString& ns,
+                                                       const std::vector<BSONObj>& indexSpecs);
+
     /**
      * Converts a renameCollection command into an internalRenameIfOptionsAndIndexesMatch command.
      */
@@ -251,6 +251,14 @@ public:
                                                 const NamespaceString& ns,
                                                 const std::vector<BSONObj>& indexSpecs) = 0;
 
+    /**
+     * Like createIndexesOnEmptyCollection(), but 'ns' may already contain documents. The keys of
+     * the existing documents are sorted and inserted into the new indexes in bulk.
+     */
+    virtual void createIndexesOnPopulatedCollection(OperationContext* opCtx,
+                                                    const NamespaceString& ns,
+                                                    const std::vector<BSONObj>& indexSpecs) = 0;
+
     virtual void dropCollection(OperationContext* opCtx, const NamespaceString& collection) = 0;
 
     /**
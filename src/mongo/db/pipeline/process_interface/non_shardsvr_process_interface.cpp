@@ -38,7 +38,9 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
 #include "mongo/db/index_builds_coordinator.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 
 namespace mongo {
 
@@ -143,6 +145,22 @@ void NonShardServerProcessInterface::createIndexesOnEmptyCollection(
             wuow.commit();
         });
 }
+
+void NonShardServerProcessInterface::createIndexesOnPopulatedCollection(
+    OperationContext* opCtx, const NamespaceString& ns, const std::vector<BSONObj>& indexSpecs) {
+    // Run the createIndexes command so that the build is replicated like a user's index build. Its
+    // collection scan phase feeds the keys of all of the existing documents to the external sorter
+    // and bulk-loads the sorted keys.
+    DBDirectClient client(opCtx);
+    BSONObj result;
+    client.runCommand(ns.db().toString(),
+                      _makeCreateIndexesOnPopulatedCollectionCmd(opCtx, ns, indexSpecs),
+                      result);
+    uassertStatusOKWithContext(getStatusFromCommandResult(result),
+                               str::stream() << "Failed to create indexes for aggregation on "
+                                             << ns << ": " << BSON("indexes" << indexSpecs));
+}
+
 void NonShardServerProcessInterface::renameIfOptionsAndIndexesHaveNotChanged(
     OperationContext* opCtx,
     const BSONObj& renameCommandObj,
@@ -111,6 +111,10 @@ public:
                                         const NamespaceString& ns,
                                         const std::vector<BSONObj>& indexSpecs) override;
 
+    void createIndexesOnPopulatedCollection(OperationContext* opCtx,
+                                            const NamespaceString& ns,
+                                            const std::vector<BSONObj>& indexSpecs) override;
+
     void setExpectedShardVersion(OperationContext* opCtx,
                                  const NamespaceString& nss,
                                  boost::optional<ChunkVersion> chunkVersion) override {
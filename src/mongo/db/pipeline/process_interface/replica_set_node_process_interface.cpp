@@ -124,6 +124,16 @@ void ReplicaSetNodeProcessInterface::createIndexesOnEmptyCollection(
     uassertStatusOK(_executeCommandOnPrimary(opCtx, ns, cmd.obj()));
 }
 
+void ReplicaSetNodeProcessInterface::createIndexesOnPopulatedCollection(
+    OperationContext* opCtx, const NamespaceString& ns, const std::vector<BSONObj>& indexSpecs) {
+    if (_canWriteLocally(opCtx, ns)) {
+        return NonShardServerProcessInterface::createIndexesOnPopulatedCollection(
+            opCtx, ns, indexSpecs);
+    }
+    uassertStatusOK(_executeCommandOnPrimary(
+        opCtx, ns, _makeCreateIndexesOnPopulatedCollectionCmd(opCtx, ns, indexSpecs)));
+}
+
 void ReplicaSetNodeProcessInterface::renameIfOptionsAndIndexesHaveNotChanged(
     OperationContext* opCtx,
     const BSONObj& renameCommandObj,
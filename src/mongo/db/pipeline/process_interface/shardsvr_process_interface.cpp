@@ -288,11 +288,27 @@ void ShardServerProcessInterface::createCollection(OperationContext* opCtx,
 
 void ShardServerProcessInterface::createIndexesOnEmptyCollection(
     OperationContext* opCtx, const NamespaceString& ns, const std::vector<BSONObj>& indexSpecs) {
+    BSONObjBuilder cmd;
+    cmd.append("createIndexes", ns.coll());
+    cmd.append("indexes", indexSpecs);
+    _createIndexesOnPrimaryShard(opCtx, ns, cmd.obj());
+}
+
+void ShardServerProcessInterface::createIndexesOnPopulatedCollection(
+    OperationContext* opCtx, const NamespaceString& ns, const std::vector<BSONObj>& indexSpecs) {
+    // The createIndexes command run against the primary shard does not require the collection to
+    // be empty.
+    _createIndexesOnPrimaryShard(
+        opCtx, ns, _makeCreateIndexesOnPopulatedCollectionCmd(opCtx, ns, indexSpecs));
+}
+
+void ShardServerProcessInterface::_createIndexesOnPrimaryShard(OperationContext* opCtx,
+                                                               const NamespaceString& ns,
+                                                               const BSONObj& createIndexesCmd) {
     auto cachedDbInfo =
         uassertStatusOK(Grid::get(opCtx)->catalogCache()->getDatabase(opCtx, ns.db()));
     BSONObjBuilder newCmdBuilder;
-    newCmdBuilder.append("createIndexes", ns.coll());
-    newCmdBuilder.append("indexes", indexSpecs);
+    newCmdBuilder.appendElements(createIndexesCmd);
     newCmdBuilder.append(WriteConcernOptions::kWriteConcernField,
                          opCtx->getWriteConcern().toBSON());
     auto cmdObj = newCmdBuilder.done();
@@ -116,6 +116,9 @@ public:
     void createIndexesOnEmptyCollection(OperationContext* opCtx,
                                         const NamespaceString& ns,
                                         const std::vector<BSONObj>& indexSpecs) final;
+    void createIndexesOnPopulatedCollection(OperationContext* opCtx,
+                                            const NamespaceString& ns,
+                                            const std::vector<BSONObj>& indexSpecs) final;
     void dropCollection(OperationContext* opCtx, const NamespaceString& collection) final;
 
     /**
@@ -132,6 +135,14 @@ public:
                                  boost::optional<ChunkVersion> chunkVersion) final;
 
 private:
+    /**
+     * Runs 'createIndexesCmd' against the primary shard of the database of 'ns', with the write
+     * concern of the operation.
+     */
+    void _createIndexesOnPrimaryShard(OperationContext* opCtx,
+                                      const NamespaceString& ns,
+                                      const BSONObj& createIndexesCmd);
+
     // If the current operation is versioned, then we attach the DB version to the command object;
     // otherwise, it is returned unmodified. Used when running internal commands, as the parent
     // operation may be unversioned if run by a client connecting directly to the shard. If a shard
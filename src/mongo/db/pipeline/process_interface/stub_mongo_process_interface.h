@@ -140,6 +140,11 @@ public:
                                         const std::vector<BSONObj>& indexSpecs) override {
         MONGO_UNREACHABLE;
     }
+    void createIndexesOnPopulatedCollection(OperationContext* opCtx,
+                                            const NamespaceString& ns,
+                                            const std::vector<BSONObj>& indexSpecs) override {
+        MONGO_UNREACHABLE;
+    }
     void dropCollection(OperationContext* opCtx, const NamespaceString& ns) override {
         MONGO_UNREACHABLE;
     }
@@ -31,16 +31,36 @@
 
 #include "mongo/db/pipeline/sequential_document_cache.h"
 
+#include <boost/filesystem/operations.hpp>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/destructor_guard.h"
 
 namespace mongo {
 
+namespace {
+std::string nextFileName() {
+    static AtomicWord<unsigned> sequentialDocumentCacheFileCounter;
+    return "extsort-doc-cache." +
+        std::to_string(sequentialDocumentCacheFileCounter.fetchAndAdd(1));
+}
+}  // namespace
+
 void SequentialDocumentCache::add(Document doc) {
     invariant(_status == CacheStatus::kBuilding);
 
-    if (checkCacheSize(doc) != CacheStatus::kAbandoned) {
-        _sizeBytes += doc.getApproximateSize();
+    // Once the cache has spilled, its size is no longer limited.
+    if (!_spillWriter && checkCacheSize(doc) == CacheStatus::kAbandoned) {
+        return;
+    }
+
+    _sizeBytes += doc.getApproximateSize();
+    if (_spillWriter) {
+        _spillWriter->addAlreadySorted(Value(), doc);
+        ++_numSpilled;
+    } else {
         _cache.push_back(std::move(doc));
     }
 }
@@ -52,6 +72,13 @@ void SequentialDocumentCache::freeze() {
     _cache.shrink_to_fit();
 
     _cacheIter = _cache.begin();
+
+    if (_spillWriter) {
+        // done() flushes the writer. Its iterator can only be read once, so a new iterator is made
+        // each time the cache is replayed instead.
+        delete _spillWriter->done();
+        openSpillIterator();
+    }
 }
 
 void SequentialDocumentCache::abandon() {
@@ -61,11 +88,20 @@ void SequentialDocumentCache::abandon() {
     _cache.shrink_to_fit();
 
     _cacheIter = _cache.begin();
+
+    removeSpillFile();
 }
 
 boost::optional<Document> SequentialDocumentCache::getNext() {
     invariant(_status == CacheStatus::kServing);
 
+    if (_spillIter) {
+        if (!_spillIter->more()) {
+            return boost::none;
+        }
+        return _spillIter->next().second;
+    }
+
     if (_cacheIter == _cache.end()) {
         return boost::none;
     }
@@ -76,14 +112,64 @@ boost::optional<Document> SequentialDocumentCache::getNext() {
 void SequentialDocumentCache::restartIteration() {
     invariant(_status == CacheStatus::kServing);
     _cacheIter = _cache.begin();
+
+    if (_spillIter) {
+        _spillIter->closeSource();
+        openSpillIterator();
+    }
 }
 
 SequentialDocumentCache::CacheStatus SequentialDocumentCache::checkCacheSize(const Document& doc) {
     if (_sizeBytes + doc.getApproximateSize() > _maxSizeBytes) {
-        abandon();
+        if (_tempDir.empty()) {
+            abandon();
+        } else {
+            spill();
+        }
     }
 
     return _status;
 }
 
+void SequentialDocumentCache::spill() {
+    invariant(!_spillWriter);
+    _spillFileName = _tempDir + "/" + nextFileName();
+    _spillWriter =
+        std::make_unique<SpillWriter>(SortOptions().TempDir(_tempDir), _spillFileName, 0);
+
+    for (auto&& doc : _cache) {
+        _spillWriter->addAlreadySorted(Value(), doc);
+    }
+    _numSpilled = _cache.size();
+
+    _cache.clear();
+    _cache.shrink_to_fit();
+    _cacheIter = _cache.begin();
+}
+
+void SequentialDocumentCache::openSpillIterator() {
+    _spillIter.reset(_spillWriter->makeIterator());
+    _spillIter->openSource();
+}
+
+void SequentialDocumentCache::removeSpillFile() {
+    if (_spillFileName.empty()) {
+        return;
+    }
+
+    if (_spillIter) {
+        DESTRUCTOR_GUARD(_spillIter->closeSource());
+    }
+    _spillIter.reset();
+    // Destroying the writer closes the file if documents are still being added to it.
+    _spillWriter.reset();
+    _numSpilled = 0;
+
+    DESTRUCTOR_GUARD(boost::filesystem::remove(_spillFileName));
+    _spillFileName.clear();
+}
+
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -30,10 +30,14 @@
 #pragma once
 
 #include <boost/optional/optional.hpp>
+#include <memory>
 #include <stddef.h>
+#include <string>
 #include <vector>
 
 #include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/sorter/sorter.h"
 
 #include "mongo/base/status.h"
 
@@ -42,31 +46,55 @@ namespace mongo {
 /**
  * Implements a sequential cache of Documents, up to an optional maximum size. Can be in one of
  * three states: building, serving, or abandoned. See SequentialDocumentCache::CacheStatus.
+ *
+ * If the cache is given a temporary directory, it does not abandon itself upon exceeding its
+ * maximum size. Instead, it writes the documents held so far and all subsequent ones to a file in
+ * that directory, and serves them from there.
  */
 class SequentialDocumentCache {
     SequentialDocumentCache(const SequentialDocumentCache&) = delete;
     SequentialDocumentCache& operator=(const SequentialDocumentCache&) = delete;
 
 public:
-    explicit SequentialDocumentCache(size_t maxCacheSizeBytes) : _maxSizeBytes(maxCacheSizeBytes) {}
+    explicit SequentialDocumentCache(size_t maxCacheSizeBytes, std::string tempDir = "")
+        : _maxSizeBytes(maxCacheSizeBytes), _tempDir(std::move(tempDir)) {}
 
     SequentialDocumentCache(SequentialDocumentCache&& moveFrom)
         : _status(moveFrom._status),
           _maxSizeBytes(moveFrom._maxSizeBytes),
           _sizeBytes(moveFrom._sizeBytes),
           _cacheIter(std::move(moveFrom._cacheIter)),
-          _cache(std::move(moveFrom._cache)) {}
+          _cache(std::move(moveFrom._cache)),
+          _tempDir(std::move(moveFrom._tempDir)),
+          _spillFileName(std::move(moveFrom._spillFileName)),
+          _spillWriter(std::move(moveFrom._spillWriter)),
+          _spillIter(std::move(moveFrom._spillIter)),
+          _numSpilled(moveFrom._numSpilled) {
+        moveFrom._spillFileName.clear();
+    }
 
     SequentialDocumentCache& operator=(SequentialDocumentCache&& moveFrom) {
+        removeSpillFile();
+
         _cacheIter = std::move(moveFrom._cacheIter);
         _maxSizeBytes = moveFrom._maxSizeBytes;
         _cache = std::move(moveFrom._cache);
         _sizeBytes = moveFrom._sizeBytes;
         _status = moveFrom._status;
+        _tempDir = std::move(moveFrom._tempDir);
+        _spillFileName = std::move(moveFrom._spillFileName);
+        _spillWriter = std::move(moveFrom._spillWriter);
+        _spillIter = std::move(moveFrom._spillIter);
+        _numSpilled = moveFrom._numSpilled;
+        moveFrom._spillFileName.clear();
 
         return *this;
     }
 
+    ~SequentialDocumentCache() {
+        removeSpillFile();
+    }
+
     /**
      * Defines the states that the cache may be in at any given time.
      */
@@ -79,8 +107,8 @@ public:
         // cache is read-only at this point.
         kServing,
 
-        // The maximum permitted cache size has been exceeded, or the caller has explicitly
-        // abandoned the cache. Cannot add more documents or call getNext.
+        // The maximum permitted cache size has been exceeded and the cache may not spill, or the
+        // caller has explicitly abandoned the cache. Cannot add more documents or call getNext.
         kAbandoned,
     };
 
@@ -127,7 +155,14 @@ public:
     }
 
     size_t count() const {
-        return _cache.size();
+        return _cache.size() + _numSpilled;
+    }
+
+    /**
+     * Returns true if the cache has exceeded its maximum size and written its contents to disk.
+     */
+    bool isSpilled() const {
+        return !_spillFileName.empty();
     }
 
     bool isBuilding() const {
@@ -143,14 +178,41 @@ public:
     }
 
 private:
+    using SpillWriter = SortedFileWriter<Value, Document>;
+    using SpillIterator = SortIteratorInterface<Value, Document>;
+
     CacheStatus checkCacheSize(const Document& doc);
 
+    /**
+     * Writes the documents held in memory to a new file in '_tempDir', to which all further
+     * documents are added.
+     */
+    void spill();
+
+    /**
+     * Positions '_spillIter' at the first document in the spill file.
+     */
+    void openSpillIterator();
+
+    void removeSpillFile();
+
     CacheStatus _status = CacheStatus::kBuilding;
     size_t _maxSizeBytes = 0;
     size_t _sizeBytes = 0;
 
     std::vector<Document>::iterator _cacheIter;
     std::vector<Document> _cache;
+
+    // If not empty, the cache spills to a file in this directory instead of being abandoned.
+    std::string _tempDir;
+
+    // Once the cache has spilled, all of its documents are held in '_spillFileName' rather than in
+    // '_cache'. The file is written by '_spillWriter' while building, and read back by
+    // '_spillIter' while serving.
+    std::string _spillFileName;
+    std::unique_ptr<SpillWriter> _spillWriter;
+    std::unique_ptr<SpillIterator> _spillIter;
+    size_t _numSpilled = 0;
 };
 
 }  // namespace mongo
@@ -31,8 +31,12 @@
 
 #include "mongo/db/pipeline/sequential_document_cache.h"
 
+#include <boost/filesystem/operations.hpp>
+
 #include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/service_context_test_fixture.h"
 #include "mongo/unittest/death_test.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -160,5 +164,51 @@ DEATH_TEST(SequentialDocumentCacheTest, CannotCallGetNextWhenAbandoned, "invaria
     cache.getNext();
 }
 
+// Reading a spilled cache back from disk requires a ServiceContext.
+using SequentialDocumentCacheSpillTest = ServiceContextTest;
+
+TEST_F(SequentialDocumentCacheSpillTest, CacheSpillsInsteadOfAbandoningWhenGivenTempDir) {
+    unittest::TempDir tempDir("SequentialDocumentCacheSpillTest");
+    SequentialDocumentCache cache(kCacheSizeBytes, tempDir.path());
+
+    const int numDocs = 100;
+    for (int i = 0; i < numDocs; ++i) {
+        cache.add(DOC("_id" << i << "str" << std::string(50, 'x')));
+    }
+
+    ASSERT(cache.isBuilding());
+    ASSERT(cache.isSpilled());
+    ASSERT_GT(cache.sizeBytes(), kCacheSizeBytes);
+    ASSERT_EQ(cache.count(), size_t(numDocs));
+
+    cache.freeze();
+
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < numDocs; ++i) {
+            auto next = cache.getNext();
+            ASSERT(next);
+            ASSERT_DOCUMENT_EQ(*next, DOC("_id" << i << "str" << std::string(50, 'x')));
+        }
+        ASSERT_FALSE(cache.getNext().is_initialized());
+        cache.restartIteration();
+    }
+}
+
+TEST_F(SequentialDocumentCacheSpillTest, CacheRemovesSpillFileWhenAbandoned) {
+    unittest::TempDir tempDir("SequentialDocumentCacheSpillTest");
+    SequentialDocumentCache cache(kCacheSizeBytes, tempDir.path());
+
+    for (int i = 0; i < 100; ++i) {
+        cache.add(DOC("_id" << i << "str" << std::string(50, 'x')));
+    }
+    ASSERT(cache.isSpilled());
+
+    cache.abandon();
+
+    ASSERT(cache.isAbandoned());
+    ASSERT_FALSE(cache.isSpilled());
+    ASSERT(boost::filesystem::is_empty(tempDir.path()));
+}
+
 }  // namespace
 }  // namespace mongo
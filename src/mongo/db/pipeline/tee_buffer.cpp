@@ -50,6 +50,17 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
+    if (_concurrentConsumers) {
+        auto& consumer = _consumers[consumerId];
+        if (consumer.nLeftToReturn == 0) {
+            return _exhausted ? DocumentSource::GetNextResult::makeEOF()
+                              : DocumentSource::GetNextResult::makePauseExecution();
+        }
+        const size_t bufferIndex = _concurrentBuffer.size() - consumer.nLeftToReturn;
+        --consumer.nLeftToReturn;
+        return Document::fromBsonWithMetaData(_concurrentBuffer[bufferIndex]);
+    }
+
     size_t nConsumersStillProcessingThisBatch =
         std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
             return info.nLeftToReturn > 0;
@@ -104,4 +115,46 @@ void TeeBuffer::loadNextBatch() {
     }
 }
 
+bool TeeBuffer::loadNextConcurrentBatch() {
+    invariant(_concurrentConsumers);
+    invariant(!_exhausted);
+    _concurrentBuffer.clear();
+
+    if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+            return info.stillInUse;
+        })) {
+        if (_source) {
+            _source->dispose();
+        }
+        _exhausted = true;
+        return false;
+    }
+
+    size_t bytesInBuffer = 0;
+    auto input = _source->getNext();
+    for (; input.isAdvanced(); input = _source->getNext()) {
+        const auto& doc = input.getDocument();
+        bytesInBuffer += doc.getApproximateSize();
+
+        // A Document caches the fields looked up in its BSON, so the consumers cannot share one.
+        auto bson = doc.metadata() ? boost::none : doc.toBsonIfTriviallyConvertible();
+        _concurrentBuffer.push_back(bson ? bson->getOwned() : doc.toBsonWithMetaData());
+
+        if (bytesInBuffer >= _bufferSizeBytes) {
+            break;  // Need to break here so we don't get the next input and accidentally ignore it.
+        }
+    }
+
+    // See loadNextBatch() for why the input cannot be paused.
+    invariant(!input.isPaused());  // NOLINT(bugprone-use-after-move)
+    _exhausted = input.isEOF();
+
+    for (auto&& consumer : _consumers) {
+        if (consumer.stillInUse) {
+            consumer.nLeftToReturn = _concurrentBuffer.size();
+        }
+    }
+    return !_exhausted;
+}
+
 }  // namespace mongo
@@ -66,6 +66,11 @@ public:
     void dispose(size_t consumerId) {
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
+        if (_consumersRunning) {
+            // The other consumers may be reading the buffer, so the source is disposed of by the
+            // next call to loadNextConcurrentBatch() instead.
+            return;
+        }
         if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
                 return info.stillInUse;
             })) {
@@ -83,6 +88,31 @@ public:
      */
     DocumentSource::GetNextResult getNext(size_t consumerId);
 
+    /**
+     * Prepares this buffer for consumers which run concurrently on threads of their own. Batches
+     * are then only loaded by calls to loadNextConcurrentBatch(), and each consumer is handed a
+     * Document of its own for every buffered document, so that no Document is read by two threads.
+     * Must be called before the first call to getNext().
+     */
+    void enableConcurrentConsumers() {
+        _concurrentConsumers = true;
+    }
+
+    /**
+     * Loads the batch which the concurrent consumers read next. Must not be called while any
+     * consumer is running. Returns false if '_source' was exhausted by this batch, in which case
+     * the consumers are returned EOF once they reach the end of it.
+     */
+    bool loadNextConcurrentBatch();
+
+    /**
+     * Records whether the concurrent consumers are currently reading the loaded batch.
+     */
+    void setConsumersRunning(bool running) {
+        invariant(_concurrentConsumers);
+        _consumersRunning = running;
+    }
+
 private:
     TeeBuffer(size_t nConsumers, size_t bufferSizeBytes);
 
@@ -98,6 +128,13 @@ private:
     const size_t _bufferSizeBytes;
     std::vector<DocumentSource::GetNextResult> _buffer;
 
+    // When the consumers run concurrently, the batch is held as owned BSON which the consumers
+    // wrap in Documents of their own.
+    bool _concurrentConsumers = false;
+    bool _consumersRunning = false;
+    bool _exhausted = false;
+    std::vector<BSONObj> _concurrentBuffer;
+
     struct ConsumerInfo {
         bool stillInUse = true;
         int nLeftToReturn = 0;
@@ -44,6 +44,23 @@ namespace mongo {
 
 class OperationContext;
 
+/**
+ * An equality $lookup, optionally with an absorbed $unwind of its 'as' field, that has been
+ * removed from the front of an aggregation pipeline to be executed by the query's plan instead.
+ * Every result of the query is joined with the documents of 'foreignCollection' whose
+ * 'foreignField' matches the result's 'localField'.
+ */
+struct EqLookupPushdown {
+    NamespaceString foreignCollection;
+    std::string localField;
+    std::string foreignField;
+    std::string asField;
+
+    // If true, the result is unwound to one document per foreign match, and results without any
+    // matches are dropped. Otherwise, the matches are collected into an array.
+    bool unwind{false};
+};
+
 class CanonicalQuery {
 public:
     // A type that encodes the notion of query shape. Essentialy a query's match, projection and
@@ -215,6 +232,18 @@ public:
         return _expCtx.get();
     }
 
+    /**
+     * The $lookup stages which the plan executing this query must apply, in order, to each of its
+     * results. Only the slot-based execution engine supports these.
+     */
+    const std::vector<EqLookupPushdown>& getEqLookupPushdowns() const {
+        return _eqLookupPushdowns;
+    }
+
+    void setEqLookupPushdowns(std::vector<EqLookupPushdown> pushdowns) {
+        _eqLookupPushdowns = std::move(pushdowns);
+    }
+
 private:
     // You must go through canonicalize to create a CanonicalQuery.
     CanonicalQuery() {}
@@ -247,6 +276,8 @@ private:
     QueryMetadataBitSet _metadataDeps;
 
     bool _canHaveNoopMatchNodes = false;
+
+    std::vector<EqLookupPushdown> _eqLookupPushdowns;
 };
 
 }  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/exec/and_hash.h"
 #include "mongo/db/exec/and_sorted.h"
+#include "mongo/db/exec/bitmap_merge.h"
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/count_scan.h"
 #include "mongo/db/exec/distinct_scan.h"
@@ -115,8 +116,12 @@ std::unique_ptr<PlanStage> ClassicStageBuilder::build(const QuerySolutionNode* r
         case STAGE_FETCH: {
             const FetchNode* fn = static_cast<const FetchNode*>(root);
             auto childStage = build(fn->children[0]);
-            return std::make_unique<FetchStage>(
-                expCtx, _ws, std::move(childStage), fn->filter.get(), _collection);
+            return std::make_unique<FetchStage>(expCtx,
+                                                _ws,
+                                                std::move(childStage),
+                                                fn->filter.get(),
+                                                _collection,
+                                                fn->recordIdBatchSize);
         }
         case STAGE_SORT_DEFAULT: {
             auto snDefault = static_cast<const SortNodeDefault*>(root);
@@ -201,6 +206,20 @@ std::unique_ptr<PlanStage> ClassicStageBuilder::build(const QuerySolutionNode* r
             }
             return ret;
         }
+        case STAGE_AND_BITMAP:
+        case STAGE_OR_BITMAP: {
+            const BitmapMergeNode* bmn = static_cast<const BitmapMergeNode*>(root);
+            auto ret = std::make_unique<BitmapMergeStage>(
+                expCtx,
+                _ws,
+                bmn->isUnion ? BitmapMergeStage::MergeType::kUnion
+                             : BitmapMergeStage::MergeType::kIntersection);
+            for (size_t i = 0; i < bmn->children.size(); ++i) {
+                auto childStage = build(bmn->children[i]);
+                ret->addChild(std::move(childStage));
+            }
+            return ret;
+        }
         case STAGE_OR: {
             const OrNode* orn = static_cast<const OrNode*>(root);
             auto ret = std::make_unique<OrStage>(expCtx, _ws, orn->dedup, orn->filter.get());
@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/string_data.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/util/lru_cache.h"
+
+namespace mongo {
+
+/**
+ * Remembers the comparison keys of the strings most recently given to a collator, so that
+ * repeated values, such as those of a low-cardinality sort field, only have their comparison key
+ * generated once.
+ *
+ * Strings longer than kMaxCachedStringSize are not cached, as they are unlikely to repeat and
+ * would make the cache's memory footprint unpredictable.
+ *
+ * Not thread safe. It is intended to be owned by a single plan stage or operation, unlike
+ * collators, which may be shared.
+ */
+class CollationKeyCache {
+    CollationKeyCache(const CollationKeyCache&) = delete;
+    CollationKeyCache& operator=(const CollationKeyCache&) = delete;
+
+public:
+    static constexpr std::size_t kDefaultCapacity = 128;
+    static constexpr std::size_t kMaxCachedStringSize = 256;
+
+    /**
+     * 'collator' must be non-null and must outlive the cache.
+     */
+    explicit CollationKeyCache(const CollatorInterface* collator,
+                               std::size_t capacity = kDefaultCapacity);
+
+    /**
+     * Returns the same comparison key as 'collator->getComparisonKey(stringData).getKeyData()'.
+     * The returned data is only valid until the next call.
+     */
+    StringData getComparisonKey(StringData stringData);
+
+    std::size_t hits() const {
+        return _hits;
+    }
+
+    std::size_t misses() const {
+        return _misses;
+    }
+
+private:
+    const CollatorInterface* const _collator;
+    LRUCache<std::string, std::string> _cache;
+
+    // Holds the key of the last uncached string.
+    std::string _uncachedKey;
+
+    std::size_t _hits = 0;
+    std::size_t _misses = 0;
+};
+
+}  // namespace mongo
@@ -159,6 +159,17 @@ void CollectionQueryInfo::computeIndexKeys(OperationContext* opCtx, Collection*
     _keysComputed = true;
 }
 
+boost::optional<std::shared_ptr<CollectionStatistics>>
+CollectionQueryInfo::getCollectionStatistics() const {
+    stdx::lock_guard<Latch> lk(_collectionStatsMutex);
+    return _collectionStats;
+}
+
+void CollectionQueryInfo::setCollectionStatistics(std::shared_ptr<CollectionStatistics> stats) {
+    stdx::lock_guard<Latch> lk(_collectionStatsMutex);
+    _collectionStats = std::move(stats);
+}
+
 void CollectionQueryInfo::notifyOfQuery(OperationContext* opCtx,
                                         Collection* coll,
                                         const PlanSummaryStats& summaryStats) {
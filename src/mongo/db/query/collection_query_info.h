@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/update_index_data.h"
@@ -90,6 +91,18 @@ public:
                        Collection* coll,
                        const PlanSummaryStats& summaryStats);
 
+    /**
+     * Returns the statistics created by the 'analyze' command for this collection, which may be
+     * null if there are none, or boost::none if they have not been loaded yet.
+     */
+    boost::optional<std::shared_ptr<CollectionStatistics>> getCollectionStatistics() const;
+
+    /**
+     * Replaces the statistics of this collection. Passing null records that the collection has no
+     * statistics.
+     */
+    void setCollectionStatistics(std::shared_ptr<CollectionStatistics> stats);
+
 private:
     void computeIndexKeys(OperationContext* opCtx, Collection* coll);
     void updatePlanCacheIndexEntries(OperationContext* opCtx, Collection* coll);
@@ -106,6 +119,10 @@ private:
 
     // A cache for query plans.
     std::unique_ptr<PlanCache> _planCache;
+
+    mutable Mutex _collectionStatsMutex =
+        MONGO_MAKE_LATCH("CollectionQueryInfo::_collectionStatsMutex");
+    boost::optional<std::shared_ptr<CollectionStatistics>> _collectionStats;
 };
 
 }  // namespace mongo
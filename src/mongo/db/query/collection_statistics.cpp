@@ -0,0 +1,436 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+#include "mongo/bson/bsonelement_comparator.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/query/query_knobs_gen.h"
+
+namespace mongo {
+namespace {
+constexpr auto kNumDocumentsField = "numDocuments"_sd;
+constexpr auto kFieldsField = "fields"_sd;
+constexpr auto kPathField = "path"_sd;
+constexpr auto kHistogramField = "histogram"_sd;
+constexpr auto kNdvSketchField = "ndvSketch"_sd;
+constexpr auto kUpperBoundField = "upperBound"_sd;
+constexpr auto kEqualCountField = "equalCount"_sd;
+constexpr auto kRangeCountField = "rangeCount"_sd;
+constexpr auto kRangeNdvField = "rangeNdv"_sd;
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+/**
+ * Mixes the bits of a BSON value hash, so that the hashes are uniformly distributed over the full
+ * 64-bit range as the NDV sketch requires.
+ */
+uint64_t mixHash(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * Returns the values of 'path' in 'doc'. Like an index, a document which has no value for 'path'
+ * contributes a null value.
+ */
+std::vector<BSONElement> extractValues(const BSONObj& doc, StringData path, const BSONObj& null) {
+    BSONElementSet elements;
+    dotted_path_support::extractAllElementsAlongPath(doc, path, elements);
+    if (elements.empty()) {
+        return {null.firstElement()};
+    }
+    return {elements.begin(), elements.end()};
+}
+
+/**
+ * Returns the fraction of the range of values between 'lower' and 'upper' which is covered by the
+ * range between 'start' and 'end'. Only numeric ranges can be interpolated, any other overlap is
+ * assumed to cover half of the range.
+ */
+double overlapFraction(const BSONElement& lower,
+                       const BSONElement& upper,
+                       const BSONElement& start,
+                       const BSONElement& end) {
+    if (!lower.isNumber() || !upper.isNumber() || !start.isNumber() || !end.isNumber()) {
+        return 0.5;
+    }
+
+    const auto width = upper.numberDouble() - lower.numberDouble();
+    if (!(width > 0)) {
+        return 0.5;
+    }
+    const auto overlap = std::min(upper.numberDouble(), end.numberDouble()) -
+        std::max(lower.numberDouble(), start.numberDouble());
+    return std::clamp(overlap / width, 0.0, 1.0);
+}
+}  // namespace
+
+void NdvSketch::add(const BSONElement& value) {
+    const BSONElementComparator comparator(BSONElementComparator::FieldNamesMode::kIgnore,
+                                           nullptr);
+    const auto hash = mixHash(comparator.hash(value));
+    if (_hashes.size() == kSize) {
+        if (hash >= *_hashes.rbegin()) {
+            return;
+        }
+        if (_hashes.insert(hash).second) {
+            _hashes.erase(std::prev(_hashes.end()));
+        }
+        return;
+    }
+    _hashes.insert(hash);
+}
+
+double NdvSketch::estimate() const {
+    if (_hashes.size() < kSize) {
+        return _hashes.size();
+    }
+
+    // The k-th smallest of n uniformly distributed hashes is expected at k / n of the hash range.
+    const auto kthHash = static_cast<double>(*_hashes.rbegin()) /
+        static_cast<double>(std::numeric_limits<uint64_t>::max());
+    return (kSize - 1) / kthHash;
+}
+
+void NdvSketch::serialize(BSONArrayBuilder* builder) const {
+    for (auto hash : _hashes) {
+        builder->append(static_cast<long long>(hash));
+    }
+}
+
+NdvSketch NdvSketch::parse(const BSONObj& hashes) {
+    NdvSketch sketch;
+    for (auto&& elem : hashes) {
+        uassert(5021400,
+                "NDV sketch hashes must be of type long",
+                elem.type() == BSONType::NumberLong);
+        sketch._hashes.insert(static_cast<uint64_t>(elem.numberLong()));
+    }
+    uassert(5021401, "NDV sketch has too many hashes", sketch._hashes.size() <= kSize);
+    return sketch;
+}
+
+Histogram Histogram::build(std::vector<BSONObj> values, double valueWeight, size_t maxBuckets) {
+    invariant(maxBuckets >= 2);
+
+    Histogram histogram;
+    if (values.empty()) {
+        return histogram;
+    }
+
+    std::sort(values.begin(), values.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+        return compareValues(lhs.firstElement(), rhs.firstElement()) < 0;
+    });
+
+    // The first bucket holds just the smallest value, so that every other bucket has a lower bound.
+    // The remaining values are split into buckets of about the same depth, without splitting runs
+    // of equal values between buckets.
+    const auto depth =
+        std::max(1.0, static_cast<double>(values.size()) / static_cast<double>(maxBuckets - 1));
+    Bucket current;
+    for (size_t ix = 0; ix < values.size();) {
+        size_t runEnd = ix + 1;
+        while (runEnd < values.size() &&
+               compareValues(values[runEnd].firstElement(), values[ix].firstElement()) == 0) {
+            ++runEnd;
+        }
+        const auto runLength = static_cast<double>(runEnd - ix);
+
+        if (histogram._buckets.empty() || runEnd == values.size() ||
+            current.rangeCount + runLength >= depth) {
+            current.upperBound = values[ix];
+            current.equalCount = runLength;
+            histogram._buckets.push_back(std::move(current));
+            current = Bucket{};
+        } else {
+            current.rangeCount += runLength;
+            current.rangeNdv += 1;
+        }
+        ix = runEnd;
+    }
+
+    for (auto&& bucket : histogram._buckets) {
+        bucket.upperBound = bucket.upperBound.getOwned();
+        bucket.equalCount *= valueWeight;
+        bucket.rangeCount *= valueWeight;
+    }
+    return histogram;
+}
+
+Histogram Histogram::parse(const BSONObj& buckets) {
+    Histogram histogram;
+    for (auto&& elem : buckets) {
+        uassert(5021402, "Histogram bucket must be an object", elem.type() == BSONType::Object);
+        const auto bucketObj = elem.Obj();
+        const auto upperBound = bucketObj[kUpperBoundField];
+        uassert(5021403, "Histogram bucket must have an upper bound", !upperBound.eoo());
+
+        Bucket bucket;
+        bucket.upperBound = upperBound.wrap("");
+        bucket.equalCount = bucketObj[kEqualCountField].numberDouble();
+        bucket.rangeCount = bucketObj[kRangeCountField].numberDouble();
+        bucket.rangeNdv = bucketObj[kRangeNdvField].numberDouble();
+        uassert(5021404,
+                "Histogram buckets must be in ascending order of their upper bounds",
+                histogram._buckets.empty() ||
+                    compareValues(histogram._buckets.back().upperBound.firstElement(),
+                                  bucket.upperBound.firstElement()) < 0);
+        histogram._buckets.push_back(std::move(bucket));
+    }
+    return histogram;
+}
+
+void Histogram::add(const BSONElement& value, double weight) {
+    auto it = std::lower_bound(
+        _buckets.begin(), _buckets.end(), value, [](const Bucket& bucket, const BSONElement& v) {
+            return compareValues(bucket.upperBound.firstElement(), v) < 0;
+        });
+
+    if (it == _buckets.end()) {
+        if (_buckets.empty()) {
+            _buckets.push_back({value.wrap(""), weight, 0, 0});
+            return;
+        }
+
+        // The new value becomes the upper bound of the last bucket, and the previous upper bound
+        // moves into the range of the bucket.
+        auto& last = _buckets.back();
+        last.rangeCount += last.equalCount;
+        last.rangeNdv += 1;
+        last.upperBound = value.wrap("");
+        last.equalCount = weight;
+        return;
+    }
+
+    if (compareValues(it->upperBound.firstElement(), value) == 0) {
+        it->equalCount += weight;
+    } else {
+        it->rangeCount += weight;
+    }
+}
+
+double Histogram::estimateCount(const Interval& interval, double ndvScale) const {
+    // Intervals of descending indexes run from the larger value to the smaller one.
+    auto start = interval.start;
+    auto end = interval.end;
+    auto startInclusive = interval.startInclusive;
+    auto endInclusive = interval.endInclusive;
+    if (compareValues(start, end) > 0) {
+        std::swap(start, end);
+        std::swap(startInclusive, endInclusive);
+    }
+
+    const bool isPoint = compareValues(start, end) == 0;
+    if (isPoint && (!startInclusive || !endInclusive)) {
+        return 0;
+    }
+
+    double count = 0;
+    for (size_t ix = 0; ix < _buckets.size(); ++ix) {
+        const auto& bucket = _buckets[ix];
+        const auto upper = bucket.upperBound.firstElement();
+
+        // The values equal to the upper bound.
+        const auto cmpStart = compareValues(start, upper);
+        const auto cmpEnd = compareValues(end, upper);
+        if ((cmpStart < 0 || (cmpStart == 0 && startInclusive)) &&
+            (cmpEnd > 0 || (cmpEnd == 0 && endInclusive))) {
+            count += bucket.equalCount;
+        }
+
+        // The values between the previous upper bound and this one. The range of the first bucket
+        // has no lower bound.
+        if (bucket.rangeCount == 0 || cmpStart >= 0) {
+            continue;
+        }
+        if (ix == 0) {
+            count += start.type() == BSONType::MinKey
+                ? bucket.rangeCount
+                : bucket.rangeCount * (isPoint ? 1 / std::max(1.0, bucket.rangeNdv * ndvScale)
+                                               : 0.5);
+            continue;
+        }
+
+        const auto lower = _buckets[ix - 1].upperBound.firstElement();
+        if (compareValues(end, lower) <= 0) {
+            continue;
+        }
+        if (isPoint) {
+            count += bucket.rangeCount / std::max(1.0, bucket.rangeNdv * ndvScale);
+        } else if (compareValues(start, lower) <= 0 && cmpEnd >= 0) {
+            count += bucket.rangeCount;
+        } else {
+            count += bucket.rangeCount * overlapFraction(lower, upper, start, end);
+        }
+    }
+    return count;
+}
+
+double Histogram::ndv() const {
+    double ndv = 0;
+    for (auto&& bucket : _buckets) {
+        ndv += bucket.rangeNdv + 1;
+    }
+    return ndv;
+}
+
+void Histogram::serialize(BSONArrayBuilder* builder) const {
+    for (auto&& bucket : _buckets) {
+        BSONObjBuilder bucketBuilder(builder->subobjStart());
+        bucketBuilder.appendAs(bucket.upperBound.firstElement(), kUpperBoundField);
+        bucketBuilder.append(kEqualCountField, bucket.equalCount);
+        bucketBuilder.append(kRangeCountField, bucket.rangeCount);
+        bucketBuilder.append(kRangeNdvField, bucket.rangeNdv);
+    }
+}
+
+std::unique_ptr<CollectionStatistics> CollectionStatistics::build(
+    const std::vector<BSONObj>& sample,
+    double numDocuments,
+    const std::vector<std::string>& paths,
+    size_t maxBuckets) {
+    auto stats = std::make_unique<CollectionStatistics>(numDocuments);
+    const auto valueWeight = sample.empty() ? 0 : numDocuments / sample.size();
+    const auto null = BSON("" << BSONNULL);
+
+    for (auto&& path : paths) {
+        std::vector<BSONObj> values;
+        FieldStatistics field;
+        for (auto&& doc : sample) {
+            for (auto&& value : extractValues(doc, path, null)) {
+                values.push_back(value.wrap(""));
+                field.ndvSketch.add(value);
+            }
+        }
+        field.histogram = Histogram::build(std::move(values), valueWeight, maxBuckets);
+        stats->_fields[path] = std::move(field);
+    }
+    return stats;
+}
+
+std::unique_ptr<CollectionStatistics> CollectionStatistics::parse(const BSONObj& obj) {
+    auto stats = std::make_unique<CollectionStatistics>(obj[kNumDocumentsField].numberDouble());
+    for (auto&& elem : obj[kFieldsField].Obj()) {
+        const auto fieldObj = elem.Obj();
+        FieldStatistics field;
+        field.histogram = Histogram::parse(fieldObj[kHistogramField].Obj());
+        field.ndvSketch = NdvSketch::parse(fieldObj[kNdvSketchField].Obj());
+        stats->_fields[fieldObj[kPathField].str()] = std::move(field);
+    }
+    return stats;
+}
+
+BSONObj CollectionStatistics::toBSON() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    BSONObjBuilder builder;
+    builder.append(kNumDocumentsField, numDocuments());
+    BSONArrayBuilder fields(builder.subarrayStart(kFieldsField));
+    for (auto&& [path, field] : _fields) {
+        BSONObjBuilder fieldBuilder(fields.subobjStart());
+        fieldBuilder.append(kPathField, path);
+        fieldBuilder.append("ndv", field.ndvSketch.estimate());
+        {
+            BSONArrayBuilder histogram(fieldBuilder.subarrayStart(kHistogramField));
+            field.histogram.serialize(&histogram);
+        }
+        {
+            BSONArrayBuilder ndvSketch(fieldBuilder.subarrayStart(kNdvSketchField));
+            field.ndvSketch.serialize(&ndvSketch);
+        }
+    }
+    fields.doneFast();
+    return builder.obj();
+}
+
+boost::optional<double> CollectionStatistics::estimateFraction(
+    StringData path, const OrderedIntervalList& oil) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    const auto totalDocuments = numDocuments();
+    auto it = _fields.find(path);
+    if (it == _fields.end() || !(totalDocuments > 0)) {
+        return boost::none;
+    }
+
+    // The sample underestimates the number of distinct values, which the sketch corrects.
+    const auto& field = it->second;
+    const auto ndvScale =
+        std::max(1.0, field.ndvSketch.estimate() / std::max(1.0, field.histogram.ndv()));
+
+    double count = 0;
+    for (auto&& interval : oil.intervals) {
+        count += field.histogram.estimateCount(interval, ndvScale);
+    }
+    return count / totalDocuments;
+}
+
+void CollectionStatistics::sampleInsertedDocument(const BSONObj& doc) {
+    const auto sampleRate = internalQueryStatisticsInsertSampleRate.load();
+    if (!(sampleRate > 0)) {
+        return;
+    }
+
+    // Every 'samplePeriod'-th insert is sampled, and stands for all the documents inserted since
+    // the previous sample.
+    const auto samplePeriod = std::max(1LL, std::llround(1 / sampleRate));
+    if (_numInserted.fetchAndAdd(1) % samplePeriod != 0) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    addDocument(doc, samplePeriod);
+}
+
+void CollectionStatistics::addDocument(const BSONObj& doc, double weight) {
+    const auto null = BSON("" << BSONNULL);
+    for (auto&& [path, field] : _fields) {
+        for (auto&& value : extractValues(doc, path, null)) {
+            field.histogram.add(value, weight);
+            field.ndvSketch.add(value);
+        }
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,183 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Estimates the number of distinct values of a field using a k-minimum-values sketch, which keeps
+ * the 'kSize' smallest distinct hashes of the values added to it. Values can be added to the
+ * sketch at any time, so the estimate stays current as new documents are sampled.
+ */
+class NdvSketch {
+public:
+    static constexpr size_t kSize = 256;
+
+    void add(const BSONElement& value);
+
+    double estimate() const;
+
+    void serialize(BSONArrayBuilder* builder) const;
+
+    static NdvSketch parse(const BSONObj& hashes);
+
+private:
+    std::set<uint64_t> _hashes;
+};
+
+/**
+ * An equi-depth histogram of the values of one field. Bucket 'i' covers the values greater than
+ * the upper bound of bucket 'i - 1', up to and including its own upper bound, and keeps the
+ * number of values equal to its upper bound separately from the number of values below it. The
+ * first bucket has no lower bound. All counts are estimates in units of documents of the
+ * collection.
+ */
+class Histogram {
+public:
+    struct Bucket {
+        // The largest value in the bucket, stored as the only element of the object.
+        BSONObj upperBound;
+        // The number of values equal to 'upperBound'.
+        double equalCount{0};
+        // The number of values below 'upperBound' and above the previous upper bound.
+        double rangeCount{0};
+        // The number of distinct values counted in 'rangeCount' when the histogram was built.
+        double rangeNdv{0};
+    };
+
+    /**
+     * Builds a histogram with at most 'maxBuckets' buckets from 'values', each of which is an
+     * object with a single element, and which stands for 'valueWeight' documents.
+     */
+    static Histogram build(std::vector<BSONObj> values, double valueWeight, size_t maxBuckets);
+
+    static Histogram parse(const BSONObj& buckets);
+
+    /**
+     * Adds 'weight' occurrences of 'value' to the bucket it falls in. A value above the largest
+     * upper bound extends the last bucket.
+     */
+    void add(const BSONElement& value, double weight);
+
+    /**
+     * Returns the estimated number of values which fall in 'interval'. A value strictly inside a
+     * bucket matches a point interval with a probability of one over the bucket's distinct values,
+     * scaled up by 'ndvScale'.
+     */
+    double estimateCount(const Interval& interval, double ndvScale) const;
+
+    /**
+     * Returns the number of distinct values seen when the histogram was built.
+     */
+    double ndv() const;
+
+    void serialize(BSONArrayBuilder* builder) const;
+
+    const std::vector<Bucket>& buckets() const {
+        return _buckets;
+    }
+
+private:
+    std::vector<Bucket> _buckets;
+};
+
+/**
+ * Statistics about the values of some fields of a collection, created by the 'analyze' command
+ * from a sample of the collection. Once created, a fraction of the documents inserted into the
+ * collection are added to the statistics. Updates and deletes are not tracked, so the statistics
+ * are only an estimate, which the query planner uses as a hint to skip the trial period of
+ * candidate plans that are likely to examine many more index keys than others.
+ *
+ * All methods are thread safe.
+ */
+class CollectionStatistics {
+public:
+    explicit CollectionStatistics(double numDocuments) : _analyzedNumDocuments(numDocuments) {}
+
+    /**
+     * Builds the statistics of 'paths' from 'sample', which was drawn from a collection of
+     * 'numDocuments' documents.
+     */
+    static std::unique_ptr<CollectionStatistics> build(const std::vector<BSONObj>& sample,
+                                                       double numDocuments,
+                                                       const std::vector<std::string>& paths,
+                                                       size_t maxBuckets);
+
+    static std::unique_ptr<CollectionStatistics> parse(const BSONObj& obj);
+
+    BSONObj toBSON() const;
+
+    /**
+     * Returns the estimated fraction of the documents of the collection which have a value of
+     * 'path' in one of the intervals of 'oil', or boost::none if there are no statistics for
+     * 'path'. The fraction may exceed 1 for paths with array values.
+     */
+    boost::optional<double> estimateFraction(StringData path, const OrderedIntervalList& oil) const;
+
+    /**
+     * Counts the inserted document 'doc', and adds its values to the statistics if it is one of
+     * the 'internalQueryStatisticsInsertSampleRate' fraction of inserts which are sampled. Only the
+     * sampled documents take the lock of the statistics.
+     */
+    void sampleInsertedDocument(const BSONObj& doc);
+
+private:
+    struct FieldStatistics {
+        Histogram histogram;
+        NdvSketch ndvSketch;
+    };
+
+    void addDocument(const BSONObj& doc, double weight);
+
+    double numDocuments() const {
+        return _analyzedNumDocuments + _numInserted.load();
+    }
+
+    // The number of documents in the collection when the statistics were created.
+    const double _analyzedNumDocuments;
+    // The number of documents inserted since.
+    AtomicWord<long long> _numInserted{0};
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("CollectionStatistics::_mutex");
+    StringMap<FieldStatistics> _fields;
+};
+
+}  // namespace mongo
@@ -0,0 +1,182 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+OrderedIntervalList makeOil(StringData path, BSONObj bounds) {
+    OrderedIntervalList oil(path.toString());
+    oil.intervals.push_back(Interval(bounds, true, true));
+    return oil;
+}
+
+std::vector<BSONObj> makeValues(const std::vector<int>& values) {
+    std::vector<BSONObj> objs;
+    for (auto value : values) {
+        objs.push_back(BSON("" << value));
+    }
+    return objs;
+}
+
+TEST(HistogramTest, EstimatesRangeOfUniformValues) {
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    auto histogram = Histogram::build(makeValues(values), 1, 11);
+    ASSERT_LTE(histogram.buckets().size(), 11U);
+
+    Interval all(BSON("" << MINKEY << "" << MAXKEY), true, true);
+    ASSERT_APPROX_EQUAL(histogram.estimateCount(all, 1), 1000, 0.001);
+
+    Interval range(BSON("" << 100 << "" << 200), true, true);
+    ASSERT_APPROX_EQUAL(histogram.estimateCount(range, 1), 101, 20);
+
+    // Intervals of descending indexes run from the larger to the smaller value.
+    Interval descending(BSON("" << 200 << "" << 100), true, true);
+    ASSERT_APPROX_EQUAL(histogram.estimateCount(descending, 1), 101, 20);
+
+    Interval above(BSON("" << 2000 << "" << 3000), true, true);
+    ASSERT_EQ(histogram.estimateCount(above, 1), 0);
+}
+
+TEST(HistogramTest, EstimatesPointsOfSkewedValues) {
+    std::vector<int> values(900, 1);
+    for (int i = 2; i < 102; ++i) {
+        values.push_back(i);
+    }
+    auto histogram = Histogram::build(makeValues(values), 2, 10);
+
+    // The frequent value is the upper bound of a bucket, so its count is exact.
+    Interval frequent(BSON("" << 1 << "" << 1), true, true);
+    ASSERT_APPROX_EQUAL(histogram.estimateCount(frequent, 1), 1800, 0.001);
+
+    Interval rare(BSON("" << 50 << "" << 50), true, true);
+    ASSERT_LTE(histogram.estimateCount(rare, 1), 10);
+}
+
+TEST(HistogramTest, AddExtendsLastBucket) {
+    auto histogram = Histogram::build(makeValues({1, 2, 3}), 1, 4);
+    histogram.add(BSON("" << 10).firstElement(), 5);
+
+    Interval ten(BSON("" << 10 << "" << 10), true, true);
+    ASSERT_APPROX_EQUAL(histogram.estimateCount(ten, 1), 5, 0.001);
+    Interval all(BSON("" << MINKEY << "" << MAXKEY), true, true);
+    ASSERT_APPROX_EQUAL(histogram.estimateCount(all, 1), 8, 0.001);
+}
+
+TEST(NdvSketchTest, CountsFewValuesExactly) {
+    NdvSketch sketch;
+    for (int i = 0; i < 100; ++i) {
+        sketch.add(BSON("" << i).firstElement());
+        sketch.add(BSON("" << i).firstElement());
+    }
+    ASSERT_EQ(sketch.estimate(), 100);
+}
+
+TEST(NdvSketchTest, EstimatesManyValues) {
+    NdvSketch sketch;
+    for (int i = 0; i < 20000; ++i) {
+        sketch.add(BSON("" << i).firstElement());
+    }
+    ASSERT_APPROX_EQUAL(sketch.estimate(), 20000, 4000);
+
+    BSONArrayBuilder builder;
+    sketch.serialize(&builder);
+    ASSERT_EQ(NdvSketch::parse(builder.arr()).estimate(), sketch.estimate());
+}
+
+TEST(CollectionStatisticsTest, EstimatesFractionOfDocuments) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 100; ++i) {
+        sample.push_back(i % 2 ? BSON("a" << i % 10) : BSON("b" << 1));
+    }
+    auto stats = CollectionStatistics::build(sample, 1000, {"a"}, 10);
+
+    ASSERT_FALSE(stats->estimateFraction("b", makeOil("b", BSON("" << 1 << "" << 1))));
+
+    // Documents without the field are counted as null.
+    auto nulls = stats->estimateFraction("a", makeOil("a", BSON("" << BSONNULL << "" << BSONNULL)));
+    ASSERT(nulls);
+    ASSERT_APPROX_EQUAL(*nulls, 0.5, 0.001);
+
+    auto all = stats->estimateFraction("a", makeOil("a", BSON("" << MINKEY << "" << MAXKEY)));
+    ASSERT(all);
+    ASSERT_APPROX_EQUAL(*all, 1, 0.001);
+
+    auto parsed = CollectionStatistics::parse(stats->toBSON());
+    auto range = makeOil("a", BSON("" << 3 << "" << 7));
+    ASSERT_APPROX_EQUAL(*parsed->estimateFraction("a", range),
+                        *stats->estimateFraction("a", range),
+                        0.001);
+}
+
+TEST(CollectionStatisticsTest, SampledInsertsUpdateEstimates) {
+    const auto oldSampleRate = internalQueryStatisticsInsertSampleRate.load();
+    internalQueryStatisticsInsertSampleRate.store(1.0);
+    ON_BLOCK_EXIT([&] { internalQueryStatisticsInsertSampleRate.store(oldSampleRate); });
+
+    auto stats = CollectionStatistics::build({BSON("a" << 1), BSON("a" << 2)}, 2, {"a"}, 4);
+    for (int i = 0; i < 8; ++i) {
+        stats->sampleInsertedDocument(BSON("a" << 3));
+    }
+
+    auto three = stats->estimateFraction("a", makeOil("a", BSON("" << 3 << "" << 3)));
+    ASSERT(three);
+    ASSERT_APPROX_EQUAL(*three, 0.8, 0.001);
+}
+
+TEST(CollectionStatisticsTest, SampledInsertsStandForTheUnsampledOnes) {
+    const auto oldSampleRate = internalQueryStatisticsInsertSampleRate.load();
+    internalQueryStatisticsInsertSampleRate.store(0.25);
+    ON_BLOCK_EXIT([&] { internalQueryStatisticsInsertSampleRate.store(oldSampleRate); });
+
+    auto stats = CollectionStatistics::build({BSON("a" << 1), BSON("a" << 2)}, 2, {"a"}, 4);
+    for (int i = 0; i < 8; ++i) {
+        stats->sampleInsertedDocument(BSON("a" << 3));
+    }
+
+    // Two of the inserts are sampled, each standing for four documents.
+    auto three = stats->estimateFraction("a", makeOil("a", BSON("" << 3 << "" << 3)));
+    ASSERT(three);
+    ASSERT_APPROX_EQUAL(*three, 0.8, 0.001);
+    ASSERT_APPROX_EQUAL(stats->toBSON()["numDocuments"].numberDouble(), 10, 0.001);
+}
+
+}  // namespace
+}  // namespace mongo
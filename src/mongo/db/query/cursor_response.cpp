@@ -34,6 +34,7 @@
 #include "mongo/db/query/cursor_response.h"
 
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 
 namespace mongo {
@@ -63,11 +64,24 @@ CursorResponseBuilder::CursorResponseBuilder(rpc::ReplyBuilderInterface* replyBu
     } else {
         _bodyBuilder.emplace(_replyBuilder->getBodyBuilder());
         _cursorObject.emplace(_bodyBuilder->subobjStart(kCursorField));
-        _batch.emplace(_cursorObject->subarrayStart(_options.isInitialResponse ? kBatchFieldInitial
-                                                                               : kBatchField));
+        auto& batchBuf = _cursorObject->subarrayStart(
+            _options.isInitialResponse ? kBatchFieldInitial : kBatchField);
+        _batchLengthOffset = batchBuf.len();
+        _batch.emplace(batchBuf);
+        if (_replyBuilder->supportsBodyFragments()) {
+            _fragmentMinBytes = internalQueryCursorReplyFragmentMinBytes.load();
+        }
     }
 }
 
+void CursorResponseBuilder::_appendFragment(const BSONObj& obj) {
+    // Only the element header is written to the reply buffer. The document itself is inserted
+    // after it when the message is sent.
+    _batch->subobjStart();
+    _replyBuilder->appendBodyFragment(obj);
+    _fragmentBytes += obj.objsize();
+}
+
 void CursorResponseBuilder::done(CursorId cursorId, StringData cursorNamespace) {
     invariant(_active);
     if (_options.useDocumentSequences) {
@@ -76,6 +90,10 @@ void CursorResponseBuilder::done(CursorId cursorId, StringData cursorNamespace)
         _cursorObject.emplace(_bodyBuilder->subobjStart(kCursorField));
     } else {
         _batch.reset();
+        if (_fragmentBytes) {
+            _replyBuilder->addBodyFragmentContainer(_batchLengthOffset);
+            _replyBuilder->addBodyFragmentContainer(_cursorObject->offset());
+        }
     }
     if (!_postBatchResumeToken.isEmpty()) {
         _cursorObject->append(kPostBatchResumeTokenField, _postBatchResumeToken);
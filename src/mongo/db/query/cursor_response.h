@@ -78,13 +78,16 @@ public:
 
     size_t bytesUsed() const {
         invariant(_active);
-        return _options.useDocumentSequences ? _docSeqBuilder->len() : _batch->len();
+        return _options.useDocumentSequences ? _docSeqBuilder->len()
+                                             : _batch->len() + _fragmentBytes;
     }
 
     void append(const BSONObj& obj) {
         invariant(_active);
         if (_options.useDocumentSequences) {
             _docSeqBuilder->append(obj);
+        } else if (_fragmentMinBytes && obj.isOwned() && obj.objsize() >= _fragmentMinBytes) {
+            _appendFragment(obj);
         } else {
             _batch->append(obj);
         }
@@ -117,6 +120,12 @@ public:
     void abandon();
 
 private:
+    /**
+     * Appends "obj" to the batch by reference, so that the reply is sent from the buffer that
+     * already holds the document rather than from a copy of it.
+     */
+    void _appendFragment(const BSONObj& obj);
+
     const Options _options;
     rpc::ReplyBuilderInterface* const _replyBuilder;
     // Order here is important to ensure destruction in the correct order.
@@ -125,6 +134,12 @@ private:
     boost::optional<BSONArrayBuilder> _batch;
     boost::optional<OpMsgBuilder::DocSequenceBuilder> _docSeqBuilder;
 
+    // Owned documents at least this large are appended as body fragments. Zero if the reply
+    // builder does not support fragments or they are disabled.
+    int _fragmentMinBytes = 0;
+    int _fragmentBytes = 0;
+    int _batchLengthOffset = 0;
+
     bool _active = true;
     long long _numDocs = 0;
     BSONObj _postBatchResumeToken;
@@ -34,7 +34,9 @@
 #include "mongo/rpc/op_msg_rpc_impls.h"
 
 #include "mongo/db/pipeline/resume_token.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -397,6 +399,50 @@ TEST(CursorResponseTest, cursorReturnDocumentSequences) {
     ASSERT_BSONOBJ_EQ(opMsg.body, expectedBody);
 }
 
+TEST(CursorResponseTest, cursorReturnsOwnedDocumentsAsFragments) {
+    internalQueryCursorReplyFragmentMinBytes.store(1);
+    ON_BLOCK_EXIT([] { internalQueryCursorReplyFragmentMinBytes.store(0); });
+
+    CursorResponseBuilder::Options options;
+    options.isInitialResponse = true;
+    rpc::OpMsgReplyBuilder builder;
+    BSONObj firstDoc = BSON("_id" << 1 << "test"
+                                  << "123");
+    BSONObj secondDoc = BSON("_id" << 2);
+    // Unowned documents are always copied into the reply.
+    BSONObj unownedDoc(secondDoc.objdata());
+
+    CursorResponseBuilder crb(&builder, options);
+    crb.append(firstDoc);
+    crb.append(unownedDoc);
+    crb.append(secondDoc);
+    ASSERT_EQ(crb.numDocs(), 3U);
+    crb.done(CursorId(123), "db.coll");
+    builder.getBodyBuilder().append("ok", 1.0);
+
+    auto msg = builder.done();
+    ASSERT(msg.isFragmented());
+    std::vector<std::pair<const char*, size_t>> segments;
+    msg.forEachSegment(
+        [&](const char* data, size_t size) { segments.emplace_back(data, size); });
+    ASSERT_EQ(segments.size(), 5U);
+    ASSERT_EQ(segments[1].first, firstDoc.objdata());
+    ASSERT_EQ(segments[3].first, secondDoc.objdata());
+
+    BSONObj expectedBody = BSON(
+        "cursor" << BSON("firstBatch" << BSON_ARRAY(firstDoc << secondDoc << secondDoc) << "id"
+                                      << CursorId(123) << "ns"
+                                      << "db.coll")
+                 << "ok" << 1.0);
+    auto opMsg = OpMsg::parse(msg);
+    ASSERT(!msg.isFragmented());
+    ASSERT_BSONOBJ_EQ(opMsg.body, expectedBody);
+
+    OpMsgBuilder copyingBuilder;
+    copyingBuilder.setBody(expectedBody);
+    ASSERT_EQ(msg.size(), copyingBuilder.finish().size());
+}
+
 }  // namespace
 
 }  // namespace mongo
@@ -296,6 +296,18 @@ void Explain::statsToBSON(const PlanStageStats& stats,
                                   spec->mapAfterChild[i]);
             }
         }
+    } else if (STAGE_AND_BITMAP == stats.stageType || STAGE_OR_BITMAP == stats.stageType) {
+        BitmapMergeStats* spec = static_cast<BitmapMergeStats*>(stats.specific.get());
+
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("memUsage", spec->memUsage);
+            bob->appendNumber("memLimit", spec->memLimit);
+
+            for (size_t i = 0; i < spec->recordIdsAfterChild.size(); ++i) {
+                bob->appendNumber(string(stream() << "recordIdsAfterChild_" << i),
+                                  spec->recordIdsAfterChild[i]);
+            }
+        }
     } else if (STAGE_AND_SORTED == stats.stageType) {
         AndSortedStats* spec = static_cast<AndSortedStats*>(stats.specific.get());
 
@@ -394,6 +406,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsExamined);
             bob->appendNumber("alreadyHasObj", spec->alreadyHasObj);
+            if (spec->recordIdBatches) {
+                bob->appendNumber("recordIdBatches", spec->recordIdBatches);
+            }
         }
     } else if (STAGE_GEO_NEAR_2D == stats.stageType || STAGE_GEO_NEAR_2DSPHERE == stats.stageType) {
         NearStats* spec = static_cast<NearStats*>(stats.specific.get());
@@ -559,6 +574,60 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     childrenBob.doneFast();
 }
 
+void Explain::statsToBSON(const sbe::PlanStageStats& stats,
+                          ExplainOptions::Verbosity verbosity,
+                          BSONObjBuilder* bob,
+                          BSONObjBuilder* topLevelBob) {
+    invariant(bob);
+    invariant(topLevelBob);
+
+    // Stop as soon as the BSON object we're building exceeds 10 MB.
+    static const int kMaxStatsBSONSize = 10 * 1024 * 1024;
+    if (topLevelBob->len() > kMaxStatsBSONSize) {
+        bob->append("warning", "stats tree exceeded 10 MB");
+        return;
+    }
+
+    bob->append("stage", stats.common.stageType);
+
+    if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+        bob->appendNumber("nReturned", static_cast<long long>(stats.common.advances));
+        // The cycle counts include the time spent in the children of the stage.
+        if (stats.common.executionCycles) {
+            bob->appendNumber("executionCycles",
+                              static_cast<long long>(*stats.common.executionCycles));
+        }
+        if (stats.common.instrsExecuted) {
+            bob->appendNumber("instrsExecuted",
+                              static_cast<long long>(stats.common.instrsExecuted));
+        }
+
+        bob->appendNumber("opens", static_cast<long long>(stats.common.opens));
+        bob->appendNumber("closes", static_cast<long long>(stats.common.closes));
+        bob->appendNumber("saveState", static_cast<long long>(stats.common.yields));
+        bob->appendNumber("restoreState", static_cast<long long>(stats.common.unyields));
+        bob->appendNumber("isEOF", stats.common.isEOF);
+    }
+
+    if (stats.children.empty()) {
+        return;
+    }
+
+    if (1 == stats.children.size()) {
+        BSONObjBuilder childBob;
+        statsToBSON(*stats.children[0], verbosity, &childBob, topLevelBob);
+        bob->append("inputStage", childBob.obj());
+        return;
+    }
+
+    BSONArrayBuilder childrenBob(bob->subarrayStart("inputStages"));
+    for (size_t i = 0; i < stats.children.size(); ++i) {
+        BSONObjBuilder childBob(childrenBob.subobjStart());
+        statsToBSON(*stats.children[i], verbosity, &childBob, topLevelBob);
+    }
+    childrenBob.doneFast();
+}
+
 BSONObj Explain::statsToBSON(const PlanStageStats& stats, ExplainOptions::Verbosity verbosity) {
     BSONObjBuilder bob;
     statsToBSON(stats, &bob, verbosity);
@@ -568,6 +637,7 @@ BSONObj Explain::statsToBSON(const PlanStageStats& stats, ExplainOptions::Verbos
 BSONObj Explain::statsToBSON(const sbe::PlanStageStats& stats,
                              ExplainOptions::Verbosity verbosity) {
     BSONObjBuilder bob;
+    statsToBSON(stats, verbosity, &bob, &bob);
     return bob.obj();
 }
 
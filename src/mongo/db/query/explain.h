@@ -218,6 +218,10 @@ private:
                             ExplainOptions::Verbosity verbosity,
                             BSONObjBuilder* bob,
                             BSONObjBuilder* topLevelBob);
+    static void statsToBSON(const sbe::PlanStageStats& stats,
+                            ExplainOptions::Verbosity verbosity,
+                            BSONObjBuilder* bob,
+                            BSONObjBuilder* topLevelBob);
 
     /**
      * Adds the "executionStats" field to out. Assumes PlanExecutor::executePlan() has been called
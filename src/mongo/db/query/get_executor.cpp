@@ -39,7 +39,9 @@
 
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
+#include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/count.h"
@@ -84,6 +86,7 @@
 #include "mongo/db/query/query_settings_decoration.h"
 #include "mongo/db/query/sbe_cached_solution_planner.h"
 #include "mongo/db/query/sbe_multi_planner.h"
+#include "mongo/db/query/sbe_plan_template_cache.h"
 #include "mongo/db/query/sbe_sub_planner.h"
 #include "mongo/db/query/stage_builder_util.h"
 #include "mongo/db/query/util/make_data_structure.h"
@@ -153,6 +156,49 @@ bool isIdHackEligibleQuery(Collection* collection, const CanonicalQuery& query)
         !query.getQueryRequest().isTailable() &&
         CollatorInterface::collatorsMatch(query.getCollator(), collection->getDefaultCollator());
 }
+
+/**
+ * Reads the statistics of 'collection' written by the 'analyze' command from the statistics
+ * collection of its database. Returns null if there are none.
+ */
+std::shared_ptr<CollectionStatistics> loadCollectionStatistics(OperationContext* opCtx,
+                                                               const Collection* collection) {
+    const NamespaceString statsNss(collection->ns().db(),
+                                   NamespaceString::kSystemDotStatisticsCollectionName);
+    Lock::CollectionLock statsLock(opCtx, statsNss, MODE_IS);
+    auto statsColl = CollectionCatalog::get(opCtx).lookupCollectionByNamespace(opCtx, statsNss);
+    if (!statsColl) {
+        return nullptr;
+    }
+
+    auto idIndex = statsColl->getIndexCatalog()->findIdIndex(opCtx);
+    if (!idIndex) {
+        return nullptr;
+    }
+    const auto recordId =
+        statsColl->getIndexCatalog()->getEntry(idIndex)->accessMethod()->findSingle(
+            opCtx, BSON("_id" << collection->ns().coll()));
+    Snapshotted<BSONObj> doc;
+    if (recordId.isNull() || !statsColl->findDoc(opCtx, recordId, &doc)) {
+        return nullptr;
+    }
+
+    // Statistics of an earlier collection with the same name are ignored.
+    auto uuid = UUID::parse(doc.value()["uuid"]);
+    if (!uuid.isOK() || uuid.getValue() != collection->uuid()) {
+        return nullptr;
+    }
+
+    try {
+        return CollectionStatistics::parse(doc.value());
+    } catch (const DBException& ex) {
+        LOGV2_WARNING(5021411,
+                      "Ignoring invalid collection statistics",
+                      "namespace"_attr = collection->ns(),
+                      "error"_attr = ex.toStatus());
+        return nullptr;
+    }
+}
 }  // namespace
 
 bool isAnyComponentOfPathMultikey(const BSONObj& indexKeyPattern,
@@ -323,12 +369,26 @@ void fillOutPlannerParams(OperationContext* opCtx,
         plannerParams->options |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     }
 
+    if (internalQueryPlannerEnableSkipScan.load()) {
+        plannerParams->options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    }
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     if (shouldWaitForOplogVisibility(
             opCtx, collection, canonicalQuery->getQueryRequest().isTailable())) {
         plannerParams->options |= QueryPlannerParams::OPLOG_SCAN_WAIT_FOR_VISIBLE;
     }
+
+    if (internalQueryPlannerStatisticsPruningRatio.load() >= 1) {
+        auto& queryInfo = CollectionQueryInfo::get(collection);
+        auto stats = queryInfo.getCollectionStatistics();
+        if (!stats) {
+            stats = loadCollectionStatistics(opCtx, collection);
+            queryInfo.setCollectionStatistics(*stats);
+        }
+        plannerParams->collectionStats = std::move(*stats);
+    }
 }
 
 bool shouldWaitForOplogVisibility(OperationContext* opCtx,
@@ -919,7 +979,7 @@ protected:
         const QueryPlannerParams& plannerParams,
         size_t decisionWorks) final {
         auto result = makeResult();
-        auto execTree = buildExecutableTree(*solution, true);
+        auto execTree = buildCachedExecutableTree(*solution);
         result->emplace(std::move(execTree), std::move(solution));
         result->setDecisionWorks(decisionWorks);
         return result;
@@ -953,6 +1013,34 @@ private:
         return stage_builder::buildSlotBasedExecutableTree(
             _opCtx, _collection, *_cq, solution, _yieldPolicy, needsTrialRunProgressTracker);
     }
+
+    /**
+     * Builds the PlanStage tree for a solution which was reconstructed from the plan cache. If an
+     * identical query has already built the tree, it is cloned from the plan template cache
+     * instead.
+     */
+    std::pair<std::unique_ptr<sbe::PlanStage>, stage_builder::PlanStageData>
+    buildCachedExecutableTree(const QuerySolution& solution) const {
+        auto key = sbe::PlanTemplateCache::computeKey(*_cq, _collection, solution);
+        if (!key) {
+            return buildExecutableTree(solution, true);
+        }
+
+        auto& cache = sbe::PlanTemplateCache::get(_collection);
+        if (auto cached = cache.lookup(*key)) {
+            auto&& [root, data] = *cached;
+            data.trialRunProgressTracker = std::make_unique<TrialRunProgressTracker>(
+                trial_period::getTrialPeriodNumToReturn(*_cq),
+                trial_period::getTrialPeriodMaxWorks(_opCtx, _collection));
+            root->attachNewYieldPolicy(_yieldPolicy);
+            root->attachNewTrialRunTracker(data.trialRunProgressTracker.get());
+            return std::move(*cached);
+        }
+
+        auto execTree = buildExecutableTree(solution, true);
+        cache.add(*key, *execTree.first, execTree.second);
+        return execTree;
+    }
 };
 
 StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getClassicExecutor(
@@ -1112,6 +1200,9 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> _getExecutorFin
     if (OperationShardingState::isOperationVersioned(opCtx)) {
         plannerOptions |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
     }
+    if (internalQueryFetchRecordIdBatchSize.load() > 0) {
+        plannerOptions |= QueryPlannerParams::FETCH_IN_RECORD_ID_ORDER;
+    }
     return getExecutor(opCtx, collection, std::move(canonicalQuery), yieldPolicy, plannerOptions);
 }
 
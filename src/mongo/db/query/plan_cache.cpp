@@ -409,6 +409,10 @@ std::string SolutionCacheData::toString() const {
             return str::stream() << "(whole index scan solution: "
                                  << "dir=" << this->wholeIXSolnDir << "; "
                                  << "tree=" << this->tree->toString() << ")";
+        case SKIP_SCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(skip scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
         case COLLSCAN_SOLN:
             return "(collection scan)";
         case USE_INDEX_TAGS_SOLN:
@@ -423,9 +427,21 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
-PlanCache::PlanCache() : PlanCache(internalQueryCacheSize.load()) {}
+PlanCache::PlanCache()
+    : PlanCache(internalQueryCacheSize.load(), internalQueryCacheNumPartitions.load()) {}
+
+PlanCache::PlanCache(size_t size, size_t numPartitions) {
+    // Every partition must be able to hold at least one entry. The remainder is spread over the
+    // first partitions so that the total capacity is exactly 'size'.
+    numPartitions = std::max<size_t>(1, std::min(numPartitions, size));
+    const auto partitionSize = size / numPartitions;
+    const auto remainder = size % numPartitions;
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+    _partitions.reserve(numPartitions);
+    for (size_t i = 0; i < numPartitions; ++i) {
+        _partitions.push_back(std::make_unique<Partition>(partitionSize + (i < remainder ? 1 : 0)));
+    }
+}
 
 PlanCache::~PlanCache() {}
 
@@ -592,7 +608,8 @@ Status PlanCache::set(const CanonicalQuery& query,
 
         why->stats);
     const auto key = computeKey(query);
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     bool isNewEntryActive = false;
     uint32_t queryHash;
     uint32_t planCacheKey;
@@ -603,7 +620,7 @@ Status PlanCache::set(const CanonicalQuery& query,
         queryHash = canonical_query_encoder::computeHash(key.getStableKeyStringData());
     } else {
         PlanCacheEntry* oldEntry = nullptr;
-        Status cacheStatus = _cache.get(key, &oldEntry);
+        Status cacheStatus = partition.cache.get(key, &oldEntry);
         invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
         if (oldEntry) {
             queryHash = oldEntry->queryHash;
@@ -630,7 +647,7 @@ Status PlanCache::set(const CanonicalQuery& query,
     auto newEntry(PlanCacheEntry::create(
         solns, std::move(why), query, queryHash, planCacheKey, now, isNewEntryActive, newWorks));
 
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
+    std::unique_ptr<PlanCacheEntry> evictedEntry = partition.cache.add(key, newEntry.release());
 
     if (nullptr != evictedEntry.get()) {
         LOGV2_DEBUG(20942,
@@ -652,9 +669,10 @@ void PlanCache::deactivate(const CanonicalQuery& query) {
     }
 
     PlanCacheKey key = computeKey(query);
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return;
@@ -669,9 +687,10 @@ PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
 }
 
 PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return {CacheEntryState::kNotPresent, nullptr};
@@ -684,13 +703,21 @@ PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    const auto key = computeKey(canonicalQuery);
+    auto& partition = getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
+    return partition.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        partition->cache.clear();
+    }
+}
+
+PlanCache::Partition& PlanCache::getPartition(const PlanCacheKey& key) const {
+    return *_partitions[PlanCacheKeyHasher{}(key) % _partitions.size()];
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -704,9 +731,10 @@ PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
 StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
 
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -716,20 +744,26 @@ StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQ
 }
 
 std::vector<std::unique_ptr<PlanCacheEntry>> PlanCache::getAllEntries() const {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
     std::vector<std::unique_ptr<PlanCacheEntry>> entries;
 
-    for (auto&& cacheEntry : _cache) {
-        auto entry = cacheEntry.second;
-        entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        for (auto&& cacheEntry : partition->cache) {
+            auto entry = cacheEntry.second;
+            entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+        }
     }
 
     return entries;
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t size = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        size += partition->cache.size();
+    }
+    return size;
 }
 
 void PlanCache::notifyOfIndexUpdates(const std::vector<CoreIndexInfo>& indexCores) {
@@ -740,13 +774,15 @@ std::vector<BSONObj> PlanCache::getMatchingStats(
     const std::function<BSONObj(const PlanCacheEntry&)>& serializationFunc,
     const std::function<bool(const BSONObj&)>& filterFunc) const {
     std::vector<BSONObj> results;
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
 
-    for (auto&& cacheEntry : _cache) {
-        const auto entry = cacheEntry.second;
-        auto serializedEntry = serializationFunc(*entry);
-        if (filterFunc(serializedEntry)) {
-            results.push_back(serializedEntry);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        for (auto&& cacheEntry : partition->cache) {
+            const auto entry = cacheEntry.second;
+            auto serializedEntry = serializationFunc(*entry);
+            if (filterFunc(serializedEntry)) {
+                results.push_back(serializedEntry);
+            }
         }
     }
 
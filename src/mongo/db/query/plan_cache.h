@@ -237,7 +237,8 @@ struct SolutionCacheData {
 
     // Owned here. If 'wholeIXSoln' is false, then 'tree'
     // can be used to tag an isomorphic match expression. If 'wholeIXSoln'
-    // is true, then 'tree' is used to store the relevant IndexEntry.
+    // is true, then 'tree' is used to store the relevant IndexEntry. The same goes
+    // for skip scan solutions.
     // If 'collscanSoln' is true, then 'tree' should be NULL.
     std::unique_ptr<PlanCacheIndexTree> tree;
 
@@ -250,6 +251,10 @@ struct SolutionCacheData {
         // The cached plan is a collection scan.
         COLLSCAN_SOLN,
 
+        // The cached plan skip-scans the index in 'tree'
+        // over the distinct values of its leading fields.
+        SKIP_SCAN_SOLN,
+
         // Build the solution by using 'tree'
         // to tag the match expression.
         USE_INDEX_TAGS_SOLN
@@ -457,7 +462,12 @@ public:
      */
     PlanCache();
 
-    PlanCache(size_t size);
+    /**
+     * Creates a cache of at most 'size' entries, split by key hash into 'numPartitions'
+     * independently locked partitions of equal capacity. Least recently used entries are evicted
+     * per partition, so with more than one partition the LRU order is only approximate.
+     */
+    PlanCache(size_t size, size_t numPartitions = 1);
 
     ~PlanCache();
 
@@ -582,10 +592,23 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
+    /**
+     * A shard of the cache which holds the entries whose keys hash to it. Lookups of different
+     * query shapes on the same collection mostly go to different partitions, and so do not contend
+     * on the same mutex.
+     */
+    struct Partition {
+        explicit Partition(size_t size) : cache(size) {}
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> cache;
+
+        // Protects 'cache'.
+        mutable Mutex mutex = MONGO_MAKE_LATCH("PlanCache::Partition::mutex");
+    };
+
+    Partition& getPartition(const PlanCacheKey& key) const;
 
-    // Protects _cache.
-    mutable Mutex _cacheMutex = MONGO_MAKE_LATCH("PlanCache::_cacheMutex");
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     // Holds computed information about the collection's indexes.  Used for generating plan
     // cache keys.
@@ -0,0 +1,373 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cache_persistence.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <fstream>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_file_util.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/background.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/exit.h"
+
+namespace mongo {
+namespace {
+constexpr auto kNamespaceField = "ns"_sd;
+constexpr auto kQueryField = "query"_sd;
+constexpr auto kSortField = "sort"_sd;
+constexpr auto kProjectionField = "projection"_sd;
+constexpr auto kCollationField = "collation"_sd;
+constexpr auto kIndexesField = "indexes"_sd;
+
+void appendIndexNames(const PlanCacheIndexTree* tree, BSONArrayBuilder* indexes) {
+    if (!tree) {
+        return;
+    }
+    if (tree->entry) {
+        indexes->append(tree->entry->identifier.catalogName);
+    }
+    for (auto&& child : tree->children) {
+        appendIndexNames(child, indexes);
+    }
+}
+
+/**
+ * Returns a copy of the query 'obj' in which every literal value is replaced with a placeholder of
+ * the same type, so that the saved query keeps its shape without the values of the user's data.
+ * Field paths and the arguments of the operators which only describe the shape are kept.
+ */
+BSONObj redactLiterals(const BSONObj& obj) {
+    BSONObjBuilder builder;
+    for (auto&& elem : obj) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "$type"_sd || fieldName == "$exists"_sd || fieldName == "$options"_sd ||
+            fieldName == "$meta"_sd) {
+            builder.append(elem);
+            continue;
+        }
+
+        switch (elem.type()) {
+            case Object:
+                builder.append(fieldName, redactLiterals(elem.embeddedObject()));
+                break;
+            case Array:
+                builder.appendArray(fieldName, redactLiterals(elem.embeddedObject()));
+                break;
+            case NumberInt:
+                builder.append(fieldName, 1);
+                break;
+            case NumberLong:
+                builder.append(fieldName, 1LL);
+                break;
+            case NumberDouble:
+                builder.append(fieldName, 1.0);
+                break;
+            case NumberDecimal:
+                builder.append(fieldName, Decimal128(1));
+                break;
+            case String:
+                // A string starting with '$' is a field path or a variable of an expression.
+                if (elem.valueStringData().startsWith("$"_sd)) {
+                    builder.append(elem);
+                } else {
+                    builder.append(fieldName, ""_sd);
+                }
+                break;
+            case RegEx:
+                builder.appendRegex(fieldName, "", elem.regexFlags());
+                break;
+            default:
+                builder.appendMinForType(fieldName, elem.type());
+                break;
+        }
+    }
+    return builder.obj();
+}
+
+BSONObj serializeEntry(const NamespaceString& nss, const PlanCacheEntry& entry) {
+    BSONObjBuilder builder;
+    builder.append(kNamespaceField, nss.ns());
+    builder.append(kQueryField, redactLiterals(entry.query));
+    builder.append(kSortField, entry.sort);
+    builder.append(kProjectionField, entry.projection);
+    builder.append(kCollationField, entry.collation);
+
+    BSONArrayBuilder indexes(builder.subarrayStart(kIndexesField));
+    if (!entry.plannerData.empty()) {
+        appendIndexNames(entry.plannerData[0]->tree.get(), &indexes);
+    }
+    indexes.doneFast();
+    return builder.obj();
+}
+
+/**
+ * Plans the query shape 'shape' against its collection, unless one of the indexes its plan used
+ * is gone. Returns true if the shape has an active plan cache entry afterwards.
+ */
+bool warmShape(OperationContext* opCtx, const BSONObj& shape) {
+    const NamespaceString nss(shape[kNamespaceField].str());
+    if (!nss.isValid()) {
+        return false;
+    }
+
+    AutoGetCollectionForRead autoColl(opCtx, nss);
+    auto collection = autoColl.getCollection();
+    if (!collection) {
+        return false;
+    }
+
+    for (auto&& index : shape[kIndexesField].Obj()) {
+        if (!collection->getIndexCatalog()->findIndexByName(opCtx, index.str())) {
+            return false;
+        }
+    }
+
+    // A new plan cache entry starts out inactive, and becomes active once the same shape is
+    // planned again with no more works, so an entry may need two rounds of planning.
+    const auto planCache = CollectionQueryInfo::get(collection).getPlanCache();
+    for (int round = 0; round < 2; ++round) {
+        auto qr = std::make_unique<QueryRequest>(nss);
+        qr->setFilter(shape[kQueryField].Obj().getOwned());
+        qr->setSort(shape[kSortField].Obj().getOwned());
+        qr->setProj(shape[kProjectionField].Obj().getOwned());
+        qr->setCollation(shape[kCollationField].Obj().getOwned());
+
+        const ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
+        auto statusWithCQ =
+            CanonicalQuery::canonicalize(opCtx,
+                                         std::move(qr),
+                                         nullptr,
+                                         extensionsCallback,
+                                         MatchExpressionParser::kAllowAllSpecialFeatures);
+        if (!statusWithCQ.isOK()) {
+            return false;
+        }
+
+        auto cq = std::move(statusWithCQ.getValue());
+        if (!PlanCache::shouldCacheQuery(*cq)) {
+            return false;
+        }
+        if (planCache->get(*cq).state == PlanCache::CacheEntryState::kPresentActive) {
+            return true;
+        }
+
+        // Creating the executor runs the trial period of the candidate plans, which caches the
+        // winner. The query itself is not executed.
+        auto statusWithExec = getExecutorFind(opCtx, collection, std::move(cq));
+        if (!statusWithExec.isOK()) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+class PlanCachePersistenceJob : public BackgroundJob {
+public:
+    std::string name() const {
+        return "PlanCachePersistence";
+    }
+
+    void run() {
+        ThreadClient tc("planCachePersistence", getGlobalServiceContext());
+        const auto path = (boost::filesystem::path(storageGlobalParams.dbpath) /
+                           "planCacheShapes.bson")
+                              .string();
+
+        {
+            const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+            auto swWarmed = warmPlanCache(opCtx.get(), path);
+            if (swWarmed.isOK()) {
+                LOGV2(5021100,
+                      "Warmed plan caches from saved query shapes",
+                      "numShapes"_attr = swWarmed.getValue());
+            } else {
+                LOGV2_WARNING(5021101,
+                              "Failed to warm plan caches from saved query shapes",
+                              "error"_attr = swWarmed.getStatus());
+            }
+        }
+
+        while (!globalInShutdownDeprecated()) {
+            {
+                MONGO_IDLE_THREAD_BLOCK;
+                const auto interval = internalQueryPlanCachePersistenceIntervalSecs.load();
+                for (int i = 0; i < interval && !globalInShutdownDeprecated(); ++i) {
+                    sleepsecs(1);
+                }
+            }
+            if (globalInShutdownDeprecated()) {
+                break;
+            }
+
+            const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+            if (auto status = savePlanCacheShapes(opCtx.get(), path); !status.isOK()) {
+                LOGV2_WARNING(
+                    5021102, "Failed to save plan cache query shapes", "error"_attr = status);
+            }
+        }
+    }
+};
+
+// Only one instance of the PlanCachePersistenceJob exists.
+PlanCachePersistenceJob planCachePersistenceJob;
+}  // namespace
+
+Status savePlanCacheShapes(OperationContext* opCtx, const std::string& path) {
+    const auto maxShapes = static_cast<size_t>(internalQueryPlanCacheMaxPersistedShapes.load());
+    std::vector<BSONObj> shapes;
+
+    try {
+        const auto& catalog = CollectionCatalog::get(opCtx);
+        for (auto&& dbName : catalog.getAllDbNames()) {
+            std::vector<NamespaceString> collectionNames;
+            {
+                Lock::DBLock dbLock(opCtx, dbName, MODE_IS);
+                collectionNames = catalog.getAllCollectionNamesFromDb(opCtx, dbName);
+            }
+
+            for (auto&& nss : collectionNames) {
+                if (shapes.size() >= maxShapes) {
+                    break;
+                }
+
+                AutoGetCollectionForRead autoColl(opCtx, nss);
+                auto collection = autoColl.getCollection();
+                if (!collection) {
+                    continue;
+                }
+
+                auto planCache = CollectionQueryInfo::get(collection).getPlanCache();
+                for (auto&& entry : planCache->getAllEntries()) {
+                    if (shapes.size() >= maxShapes) {
+                        break;
+                    }
+                    if (entry->isActive) {
+                        shapes.push_back(serializeEntry(nss, *entry));
+                    }
+                }
+            }
+        }
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+
+    // Write to a temporary file first, and make it durable before renaming it, so that a crash
+    // never leaves a partially written file.
+    const auto tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        for (auto&& shape : shapes) {
+            out.write(shape.objdata(), shape.objsize());
+        }
+        out.flush();
+        if (!out.good()) {
+            return {ErrorCodes::FileStreamFailed,
+                    str::stream() << "Failed to write plan cache query shapes to " << tmpPath};
+        }
+    }
+
+    if (auto status = fsyncFile(tmpPath); !status.isOK()) {
+        return status;
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        return {ErrorCodes::FileRenameFailed,
+                str::stream() << "Failed to rename " << tmpPath << " to " << path << ": "
+                              << ec.message()};
+    }
+    return fsyncParentDirectory(path);
+}
+
+StatusWith<size_t> warmPlanCache(OperationContext* opCtx, const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return size_t{0};
+    }
+    const std::string buffer{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+
+    size_t numWarmed = 0;
+    for (size_t offset = 0; offset < buffer.size();) {
+        const char* data = buffer.data() + offset;
+        if (auto status = validateBSON(data, buffer.size() - offset); !status.isOK()) {
+            return status.withContext(str::stream()
+                                      << "Corrupt plan cache query shapes in " << path);
+        }
+        const BSONObj shape(data);
+        offset += shape.objsize();
+
+        try {
+            if (warmShape(opCtx, shape)) {
+                ++numWarmed;
+            }
+        } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+            throw;
+        } catch (const DBException& ex) {
+            // A shape which can no longer be planned is skipped. It will be cached again the next
+            // time a query of that shape runs.
+            LOGV2_DEBUG(5021103,
+                        2,
+                        "Skipping saved plan cache query shape",
+                        "shape"_attr = redact(shape),
+                        "error"_attr = ex.toStatus());
+        }
+    }
+    return numWarmed;
+}
+
+void startPlanCachePersistence() {
+    if (internalQueryPlanCachePersistenceIntervalSecs.load() > 0) {
+        planCachePersistenceJob.go();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,63 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/status_with.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Writes the query shapes of the active plan cache entries of all collections to the file at
+ * 'path', replacing it atomically and durably. Each shape is stored as an example query, in which
+ * every literal value is replaced with a placeholder of the same type, together with the names of
+ * the indexes used by its cached plan.
+ */
+Status savePlanCacheShapes(OperationContext* opCtx, const std::string& path);
+
+/**
+ * Plans every query shape saved in the file at 'path' whose indexes still exist, which puts its
+ * winning plan back into the plan cache of its collection. Returns the number of shapes that have
+ * an active plan cache entry afterwards. A missing file is not an error.
+ */
+StatusWith<size_t> warmPlanCache(OperationContext* opCtx, const std::string& path);
+
+/**
+ * Starts a background job which warms the plan caches from the shapes saved by the previous run
+ * of the server, and then saves the shapes every
+ * 'internalQueryPlanCachePersistenceIntervalSecs' seconds. Does nothing if the interval is not
+ * positive.
+ */
+void startPlanCachePersistence();
+
+}  // namespace mongo
@@ -572,6 +572,49 @@ TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
 }
 
+TEST(PlanCacheTest, PartitionedPlanCacheHoldsEntriesOfAllPartitions) {
+    const size_t kCacheSize = 64;
+    const size_t kNumPartitions = 4;
+    PlanCache planCache(kCacheSize, kNumPartitions);
+    QueryTestServiceContext serviceContext;
+
+    // Shapes are spread over the partitions by hash, and each of them can be looked up again.
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (char field = 'a'; field <= 'l'; ++field) {
+        queries.push_back(canonicalize(BSON(std::string(1, field) << 1)));
+        addCacheEntryForShape(*queries.back(), &planCache);
+    }
+    ASSERT_EQ(planCache.size(), queries.size());
+    ASSERT_EQ(planCache.getAllEntries().size(), queries.size());
+    for (auto&& cq : queries) {
+        ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    }
+
+    ASSERT_OK(planCache.remove(*queries.front()));
+    ASSERT_EQ(planCache.get(*queries.front()).state, PlanCache::CacheEntryState::kNotPresent);
+    ASSERT_EQ(planCache.size(), queries.size() - 1);
+
+    planCache.clear();
+    ASSERT_EQ(planCache.size(), 0U);
+    ASSERT_EQ(planCache.getAllEntries().size(), 0U);
+}
+
+TEST(PlanCacheTest, PartitionedPlanCacheDoesNotExceedItsSize) {
+    const size_t kCacheSize = 5;
+    const size_t kNumPartitions = 3;
+    PlanCache planCache(kCacheSize, kNumPartitions);
+    QueryTestServiceContext serviceContext;
+
+    // The partitions share the capacity exactly, so filling all of them holds at most 'kCacheSize'
+    // entries.
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (char field = 'a'; field <= 'z'; ++field) {
+        queries.push_back(canonicalize(BSON(std::string(1, field) << 1)));
+        addCacheEntryForShape(*queries.back(), &planCache);
+    }
+    ASSERT_LTE(planCache.size(), kCacheSize);
+}
+
 TEST(PlanCacheTest, PlanCacheRemoveDeletesInactiveEntries) {
     PlanCache planCache;
     unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
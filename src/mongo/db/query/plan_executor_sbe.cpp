@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/sbe/values/bson.h"
+#include "mongo/db/query/explain.h"
 #include "mongo/db/query/sbe_stage_builder.h"
 
 namespace mongo {
@@ -80,12 +81,22 @@ PlanExecutorSBE::PlanExecutorSBE(
         _stash = std::move(*stash);
     }
 
+    // The per-stage cycle counts reported by explain are only collected when asked for.
+    if (_cq && _cq->getExpCtx()->explain) {
+        _root->markShouldCollectTimingInfo();
+    }
+
     // Callers are allowed to disable yielding for this plan by passing a null yield policy.
     if (_yieldPolicy) {
         _yieldPolicy->setRootStage(_root.get());
     }
 }
 
+BSONObj PlanExecutorSBE::getStats() const {
+    invariant(_root);
+    return Explain::statsToBSON(*_root->getStats());
+}
+
 void PlanExecutorSBE::saveState() {
     invariant(_root);
     _root->saveState();
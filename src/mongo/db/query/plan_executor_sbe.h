@@ -115,10 +115,7 @@ public:
     // TODO: Support collection of plan summary stats for SBE.
     void getSummaryStats(PlanSummaryStats* statsOut) const override {}
 
-    // TODO: Support debug stats for SBE.
-    BSONObj getStats() const override {
-        return BSONObj{};
-    }
+    BSONObj getStats() const override;
 
 private:
     enum class State { kClosed, kOpened };
@@ -43,6 +43,7 @@
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_text.h"
+#include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
@@ -1090,6 +1091,10 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedAnd(
             auto asn = std::make_unique<AndSortedNode>();
             asn->addChildren(std::move(ixscanNodes));
             andResult = std::move(asn);
+        } else if (internalQueryPlannerEnableBitmapIndexMerge.load()) {
+            auto bmn = std::make_unique<BitmapMergeNode>(false /* isUnion */);
+            bmn->addChildren(std::move(ixscanNodes));
+            andResult = std::move(bmn);
         } else if (internalQueryPlannerEnableHashIntersection.load()) {
             {
                 auto ahn = std::make_unique<AndHashNode>();
@@ -1124,7 +1129,8 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedAnd(
         return andResult;
     }
 
-    if (andResult->getType() == STAGE_AND_HASH || andResult->getType() == STAGE_AND_SORTED) {
+    if (andResult->getType() == STAGE_AND_HASH || andResult->getType() == STAGE_AND_SORTED ||
+        andResult->getType() == STAGE_AND_BITMAP) {
         // We got an index intersection solution, so we aren't allowed to answer predicates exactly
         // using the index. This is because the index intersection stage finds documents that match
         // each index's predicate, but the document isn't guaranteed to be in a state where it
@@ -1172,6 +1178,17 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedOr(
     const QueryPlannerParams& params) {
 
     const bool inArrayOperator = !ownedRoot;
+
+    // Without a limit, the index scans of the OR may be merged as bitmaps of RecordIds. The fetch
+    // above them must then recheck the entire predicate, as for an index intersection, so keep a
+    // copy of it before processIndexScans() trims it.
+    const auto& qr = query.getQueryRequest();
+    std::unique_ptr<MatchExpression> clonedRoot;
+    if (internalQueryPlannerEnableBitmapIndexMerge.load() && !inArrayOperator && !qr.getLimit() &&
+        !qr.getNToReturn()) {
+        clonedRoot = root->shallowClone();
+    }
+
     std::vector<std::unique_ptr<QuerySolutionNode>> ixscanNodes;
     if (!processIndexScans(query, root, inArrayOperator, indices, params, &ixscanNodes)) {
         return nullptr;
@@ -1221,6 +1238,18 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedOr(
             msn->sort = query.getQueryRequest().getSort();
             msn->addChildren(std::move(ixscanNodes));
             orResult = std::move(msn);
+        } else if (clonedRoot &&
+                   std::all_of(ixscanNodes.begin(), ixscanNodes.end(), [](const auto& ixScan) {
+                       return ixScan->getType() == STAGE_IXSCAN &&
+                           static_cast<IndexScanNode*>(ixScan.get())->index.type != INDEX_WILDCARD;
+                   })) {
+            auto bmn = std::make_unique<BitmapMergeNode>(true /* isUnion */);
+            bmn->addChildren(std::move(ixscanNodes));
+
+            auto fetch = std::make_unique<FetchNode>();
+            fetch->filter = std::move(clonedRoot);
+            fetch->children.push_back(bmn.release());
+            return std::move(fetch);
         } else {
             auto orn = std::make_unique<OrNode>();
             orn->addChildren(std::move(ixscanNodes));
@@ -1498,4 +1527,78 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeIndexScan(
     return solnRoot;
 }
 
+
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeSkipScan(
+    const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params) {
+    if (index.type != INDEX_BTREE || index.sparse || index.filterExpr ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return nullptr;
+    }
+
+    // Only a top-level predicate can be used to bound a field of the index. There's no need to
+    // intersect the bounds of several predicates: the fetch below applies the whole query.
+    const MatchExpression* root = query.root();
+    std::vector<const MatchExpression*> preds;
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            preds.push_back(root->getChild(i));
+        }
+    } else {
+        preds.push_back(root);
+    }
+
+    auto findPredicate = [&](StringData path) -> const MatchExpression* {
+        for (auto&& pred : preds) {
+            switch (pred->matchType()) {
+                case MatchExpression::EQ:
+                case MatchExpression::LT:
+                case MatchExpression::LTE:
+                case MatchExpression::GT:
+                case MatchExpression::GTE:
+                case MatchExpression::MATCH_IN:
+                    if (pred->path() == path) {
+                        return pred;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        return nullptr;
+    };
+
+    // Bound the first field with a predicate, which must not be the leading field: the leading
+    // fields are scanned over all their values, and the index cursor seeks past each distinct
+    // prefix of them once the bounded field is exhausted.
+    auto isn = std::make_unique<IndexScanNode>(index);
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+    isn->addKeyMetadata = query.metadataDeps()[DocumentMetadataFields::kIndexKey];
+    isn->queryCollator = query.getCollator();
+
+    bool isBounded = false;
+    size_t pos = 0;
+    for (auto&& keyElt : index.keyPattern) {
+        auto pred = (pos > 0 && !isBounded) ? findPredicate(keyElt.fieldNameStringData()) : nullptr;
+        if (pred) {
+            IndexBoundsBuilder::BoundsTightness tightness;
+            IndexBoundsBuilder::translate(
+                pred, keyElt, index, &isn->bounds.fields[pos], &tightness);
+            isBounded = true;
+        } else {
+            IndexBoundsBuilder::allValuesForField(keyElt, &isn->bounds.fields[pos]);
+        }
+        ++pos;
+    }
+
+    if (!isBounded) {
+        return nullptr;
+    }
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    auto fetch = std::make_unique<FetchNode>();
+    fetch->filter = query.root()->shallowClone();
+    fetch->children.push_back(isn.release());
+    return std::move(fetch);
+}
+
 }  // namespace mongo
@@ -119,6 +119,14 @@ public:
                                                             const BSONObj& startKey,
                                                             const BSONObj& endKey);
 
+    /**
+     * Return a plan that skip-scans the provided index for a query with no predicate on the
+     * leading field of the index, but with one on a later field, or nullptr if there is none.
+     */
+    static std::unique_ptr<QuerySolutionNode> makeSkipScan(const IndexEntry& index,
+                                                           const CanonicalQuery& query,
+                                                           const QueryPlannerParams& params);
+
     /**
      * Consructs a data access plan for 'query' which answers the predicate contained in 'root'.
      * Assumes the presence of the passed in indices. Planning behavior is controlled by the
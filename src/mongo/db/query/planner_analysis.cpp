@@ -40,6 +40,7 @@
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/logv2/log.h"
@@ -479,6 +480,19 @@ bool canUseSimpleSort(const QuerySolutionNode& solnRoot,
         && !splitLimitedSortEligible;
 }
 
+/**
+ * Makes each FETCH over an IXSCAN in the tree rooted at 'node' fetch in batches of
+ * 'recordIdBatchSize' documents in RecordId order.
+ */
+void setRecordIdBatchSize(QuerySolutionNode* node, size_t recordIdBatchSize) {
+    if (STAGE_FETCH == node->getType() && STAGE_IXSCAN == node->children[0]->getType()) {
+        static_cast<FetchNode*>(node)->recordIdBatchSize = recordIdBatchSize;
+    }
+    for (auto&& child : node->children) {
+        setRecordIdBatchSize(child, recordIdBatchSize);
+    }
+}
+
 }  // namespace
 
 // static
@@ -890,10 +904,11 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
         return nullptr;
     }
 
-    // A solution can be blocking if it has a blocking sort stage or
-    // a hashed AND stage.
+    // A solution can be blocking if it has a blocking sort stage,
+    // a hashed AND stage or a bitmap AND or OR stage.
     bool hasAndHashStage = solnRoot->hasNode(STAGE_AND_HASH);
-    soln->hasBlockingStage = hasSortStage || hasAndHashStage;
+    bool hasBitmapStage = solnRoot->hasNode(STAGE_AND_BITMAP) || solnRoot->hasNode(STAGE_OR_BITMAP);
+    soln->hasBlockingStage = hasSortStage || hasAndHashStage || hasBitmapStage;
 
     const QueryRequest& qr = query.getQueryRequest();
 
@@ -951,6 +966,14 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
 
     solnRoot = tryPushdownProjectBeneathSort(std::move(solnRoot));
 
+    // Without a sort or a limit, the order of the results doesn't matter and all of them are likely
+    // to be returned, so the documents may be fetched in RecordId order rather than index order.
+    const auto recordIdBatchSize = internalQueryFetchRecordIdBatchSize.load();
+    if (params.options & QueryPlannerParams::FETCH_IN_RECORD_ID_ORDER && recordIdBatchSize > 0 &&
+        qr.getSort().isEmpty() && !qr.getLimit() && !qr.getNToReturn() && !qr.isTailable()) {
+        setRecordIdBatchSize(solnRoot.get(), recordIdBatchSize);
+    }
+
     soln->root = std::move(solnRoot);
     return soln;
 }
@@ -45,6 +45,7 @@
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_text.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/plan_cache.h"
@@ -97,6 +98,101 @@ Status tagOrChildAccordingToCache(PlanCacheIndexTree* compositeCacheData,
 
     return Status::OK();
 }
+
+// The smallest estimated cost, as a fraction of the collection, which is used as the base of the
+// pruning threshold. Estimates below it are too imprecise to prune other plans by.
+constexpr double kMinPruningBaseCost = 0.001;
+
+/**
+ * Returns the estimated number of index keys and documents examined by the plan rooted at 'node',
+ * as a fraction of the number of documents in the collection, or boost::none if 'stats' has no
+ * statistics to estimate it.
+ */
+boost::optional<double> estimateScanCost(const QuerySolutionNode* node,
+                                         const CollectionStatistics& stats) {
+    switch (node->getType()) {
+        case STAGE_COLLSCAN:
+            return 1.0;
+        case STAGE_IXSCAN: {
+            auto ixn = static_cast<const IndexScanNode*>(node);
+            if (ixn->index.type != INDEX_BTREE || ixn->index.collator ||
+                ixn->bounds.isSimpleRange || ixn->bounds.fields.empty()) {
+                return boost::none;
+            }
+            // Only the bounds of the leading field are used, which overestimates the keys
+            // examined by scans with bounds on several fields.
+            const auto& oil = ixn->bounds.fields[0];
+            return stats.estimateFraction(oil.name, oil);
+        }
+        default: {
+            if (node->children.empty()) {
+                return boost::none;
+            }
+
+            double cost = 0;
+            for (auto&& child : node->children) {
+                auto childCost = estimateScanCost(child, stats);
+                if (!childCost) {
+                    return boost::none;
+                }
+                cost += *childCost;
+            }
+
+            // A fetch reads a document for each key its input examined, at most.
+            if (node->getType() == STAGE_FETCH) {
+                cost *= 2;
+            }
+            return cost;
+        }
+    }
+}
+
+/**
+ * Removes the solutions whose estimated cost exceeds that of the cheapest one by more than
+ * 'internalQueryPlannerStatisticsPruningRatio', so that they are not run in the trial period.
+ * Nothing is pruned unless the cost of every solution can be estimated.
+ */
+void pruneSolutionsByEstimatedCost(const CanonicalQuery& query,
+                                   const QueryPlannerParams& params,
+                                   std::vector<std::unique_ptr<QuerySolution>>* solutions) {
+    const auto ratio = internalQueryPlannerStatisticsPruningRatio.load();
+    if (!params.collectionStats || !(ratio >= 1) || solutions->size() < 2) {
+        return;
+    }
+
+    // A plan which examines more may still be faster if it provides the requested sort, or if it
+    // reaches the limit early, which only the trial period can tell.
+    const auto& qr = query.getQueryRequest();
+    if (!qr.getSort().isEmpty() || qr.getLimit() || qr.getNToReturn()) {
+        return;
+    }
+
+    std::vector<double> costs;
+    for (auto&& soln : *solutions) {
+        auto cost = estimateScanCost(soln->root.get(), *params.collectionStats);
+        if (!cost) {
+            return;
+        }
+        costs.push_back(*cost);
+    }
+
+    const auto threshold =
+        std::max(*std::min_element(costs.begin(), costs.end()), kMinPruningBaseCost) * ratio;
+    std::vector<std::unique_ptr<QuerySolution>> kept;
+    for (size_t ix = 0; ix < solutions->size(); ++ix) {
+        if (costs[ix] <= threshold) {
+            kept.push_back(std::move((*solutions)[ix]));
+        } else {
+            LOGV2_DEBUG(5021410,
+                        5,
+                        "Planner: pruning solution by estimated cost",
+                        "estimatedCost"_attr = costs[ix],
+                        "threshold"_attr = threshold,
+                        "solution"_attr = redact((*solutions)[ix]->toString()));
+        }
+    }
+    *solutions = std::move(kept);
+}
 }  // namespace
 
 using std::numeric_limits;
@@ -173,6 +269,12 @@ string optionString(size_t options) {
             case QueryPlannerParams::PRESERVE_RECORD_ID:
                 ss << "PRESERVE_RECORD_ID ";
                 break;
+            case QueryPlannerParams::GENERATE_SKIP_SCANS:
+                ss << "GENERATE_SKIP_SCANS ";
+                break;
+            case QueryPlannerParams::FETCH_IN_RECORD_ID_ORDER:
+                ss << "FETCH_IN_RECORD_ID_ORDER ";
+                break;
             case QueryPlannerParams::DEFAULT:
                 MONGO_UNREACHABLE;
                 break;
@@ -328,6 +430,16 @@ std::unique_ptr<QuerySolution> buildWholeIXSoln(const IndexEntry& index,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+std::unique_ptr<QuerySolution> buildSkipScanSoln(const IndexEntry& index,
+                                                 const CanonicalQuery& query,
+                                                 const QueryPlannerParams& params) {
+    auto solnRoot = QueryPlannerAccess::makeSkipScan(index, query, params);
+    if (!solnRoot) {
+        return nullptr;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
 bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getQueryRequest().getSort().isPrefixOf(kp, SimpleBSONElementComparator::kInstance);
 }
@@ -497,6 +609,14 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
         } else {
             return {std::move(soln)};
         }
+    } else if (SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        auto soln = buildSkipScanSoln(*winnerCacheData.tree->entry, query, params);
+        if (!soln) {
+            return Status(ErrorCodes::NoQueryExecutionPlans,
+                          "plan cache error: soln that skip-scans index");
+        } else {
+            return {std::move(soln)};
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -1101,11 +1221,41 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         }
     }
 
+    // No index has a predicate on its leading field, but a compound index may still be used by
+    // skipping over the distinct values of its leading fields. These plans compete with the
+    // collscan rather than replace it, as the number of such values is not known. A skip scan may
+    // read the whole index, so it is not allowed with 'notablescan' either.
+    size_t numSkipScanSolns = 0;
+    if (params.options & QueryPlannerParams::GENERATE_SKIP_SCANS && out.empty() && canTableScan &&
+        hintedIndex.isEmpty() && !isTailable &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
+        for (auto&& index : fullIndexList) {
+            auto soln = buildSkipScanSoln(index, query, params);
+            if (!soln) {
+                continue;
+            }
+            LOGV2_DEBUG(5021500,
+                        5,
+                        "Planner: outputting soln that skip-scans index",
+                        "solution"_attr = redact(soln->toString()));
+            PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+            indexTree->setIndexEntry(index);
+            SolutionCacheData* scd = new SolutionCacheData();
+            scd->tree.reset(indexTree);
+            scd->solnType = SolutionCacheData::SKIP_SCAN_SOLN;
+
+            soln->cacheData.reset(scd);
+            out.push_back(std::move(soln));
+            ++numSkipScanSolns;
+        }
+    }
+
     // The caller can explicitly ask for a collscan.
     bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
 
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
-    bool collScanRequired = 0 == out.size();
+    bool collScanRequired = out.size() == numSkipScanSolns;
     if (collScanRequired && !canTableScan) {
         return Status(ErrorCodes::NoQueryExecutionPlans,
                       "No indexed plans available, and running with 'notablescan'");
@@ -1139,6 +1289,8 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         }
     }
 
+    pruneSolutionsByEstimatedCost(query, params, &out);
+
     invariant(out.size() > 0);
     return {std::move(out)};
 }
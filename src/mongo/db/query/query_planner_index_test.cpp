@@ -845,6 +845,59 @@ TEST_F(QueryPlannerTest, IntersectDisableAndHash) {
     internalQueryPlannerEnableHashIntersection.store(oldEnableHashIntersection);
 }
 
+TEST_F(QueryPlannerTest, IntersectWithBitmapRatherThanAndHash) {
+    bool oldEnableHashIntersection = internalQueryPlannerEnableHashIntersection.load();
+    bool oldEnableBitmapIndexMerge = internalQueryPlannerEnableBitmapIndexMerge.load();
+    internalQueryPlannerEnableHashIntersection.store(true);
+    internalQueryPlannerEnableBitmapIndexMerge.store(true);
+    params.options = QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::INDEX_INTERSECTION;
+
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    runQuery(fromjson("{a: {$gt: 1}, b: {$lt: 5}}"));
+
+    // The fetch over the intersection rechecks the entire predicate.
+    assertNumSolutions(3U);
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$lt: 5}}, node: {ixscan: {filter: null, pattern: {a: 1}}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {a: {$gt: 1}}, node: {ixscan: {filter: null, pattern: {b: 1}}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {a: {$gt: 1}, b: {$lt: 5}}, node: {andBitmap: {nodes: ["
+        "{ixscan: {filter: null, pattern: {a: 1}}},"
+        "{ixscan: {filter: null, pattern: {b: 1}}}]}}}}");
+
+    internalQueryPlannerEnableHashIntersection.store(oldEnableHashIntersection);
+    internalQueryPlannerEnableBitmapIndexMerge.store(oldEnableBitmapIndexMerge);
+}
+
+TEST_F(QueryPlannerTest, UnionOrWithBitmapWithoutLimit) {
+    bool oldEnableBitmapIndexMerge = internalQueryPlannerEnableBitmapIndexMerge.load();
+    internalQueryPlannerEnableBitmapIndexMerge.store(true);
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    runQuery(fromjson("{$or: [{a: 1}, {b: 2}]}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {$or: [{a: 1}, {b: 2}]}, node: {orBitmap: {nodes: ["
+        "{ixscan: {filter: null, pattern: {a: 1}}},"
+        "{ixscan: {filter: null, pattern: {b: 1}}}]}}}}");
+
+    // A query with a limit keeps the OR stage, which doesn't need to read all of its children.
+    runQuerySortProjSkipNToReturn(fromjson("{$or: [{a: 1}, {b: 2}]}"), {}, {}, 0, -3);
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{limit: {n: 3, node: {fetch: {filter: null, node: {or: {nodes: ["
+        "{ixscan: {filter: null, pattern: {a: 1}}},"
+        "{ixscan: {filter: null, pattern: {b: 1}}}]}}}}}}");
+
+    internalQueryPlannerEnableBitmapIndexMerge.store(oldEnableBitmapIndexMerge);
+}
+
 //
 // Index intersection cases for SERVER-12825: make sure that
 // we don't generate an ixisect plan if a compound index is
@@ -934,5 +934,68 @@ TEST_F(QueryPlannerTest, PreserveRecordIdOptionPrecludesSimpleSort) {
         "{sort: {pattern: {a: 1}, limit: 0, type: 'default', node: {cscan: {dir: 1}}}}");
 }
 
+
+TEST_F(QueryPlannerTest, SkipScanOnNonLeadingIndexField) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+
+    runQuery(fromjson("{b: 5, d: 3}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5, d: 3}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: 5, d: 3}, node: {ixscan: {filter: null, pattern: {a: 1, b: 1, c: 1},"
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]],"
+        "c: [['MinKey','MaxKey',true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanOnDescendingIndexField) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << -1));
+
+    runQuery(fromjson("{b: {$gt: 5}}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: {$gt: 5}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$gt: 5}}, node: {ixscan: {filter: null, pattern: {a: 1, b: -1},"
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[Infinity,5,true,false]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanWithNoTableScan) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runInvalidQuery(fromjson("{b: {$in: [1, 2]}}"));
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanWhenIndexHasLeadingFieldPredicate) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1 << "c" << 1));
+
+    runQuery(fromjson("{a: 1, c: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{fetch: {filter: {c: 5}, node: {ixscan: {pattern: {a: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanOverSparseIndex) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1), false /* multikey */, true /* sparse */);
+
+    runQuery(fromjson("{b: 5}"));
+
+    assertHasOnlyCollscan();
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanWithoutOption) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuery(fromjson("{b: 5}"));
+
+    assertHasOnlyCollscan();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/db/jsobj.h"
@@ -37,6 +38,8 @@
 
 namespace mongo {
 
+class CollectionStatistics;
+
 struct QueryPlannerParams {
     QueryPlannerParams()
         : options(DEFAULT),
@@ -97,6 +100,14 @@ struct QueryPlannerParams {
         // ids. In some cases, record ids can be discarded as an optimization when they will not be
         // consumed downstream.
         PRESERVE_RECORD_ID = 1 << 10,
+
+        // Set this to generate plans which skip-scan a compound index when no index has a predicate
+        // on its leading field.
+        GENERATE_SKIP_SCANS = 1 << 11,
+
+        // Set this to allow fetches over index scans to read the documents in RecordId order rather
+        // than index order, if the order of the results doesn't matter.
+        FETCH_IN_RECORD_ID_ORDER = 1 << 12,
     };
 
     // See Options enum above.
@@ -117,6 +128,10 @@ struct QueryPlannerParams {
     // plans via the MultiPlanStage, and the set of possible plans is very large for certain
     // index+query combinations.
     size_t maxIndexedSolutions;
+
+    // Statistics about the values of the fields of the collection, used to prune candidate plans
+    // which are estimated to examine much more than the others. May be null.
+    std::shared_ptr<const CollectionStatistics> collectionStats;
 };
 
 }  // namespace mongo
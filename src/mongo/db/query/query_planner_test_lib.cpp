@@ -518,6 +518,16 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
         }
         BSONObj orObj = el.Obj();
         return childrenMatch(orObj, orn, relaxBoundsCheck);
+    } else if (STAGE_AND_BITMAP == trueSoln->getType() ||
+               STAGE_OR_BITMAP == trueSoln->getType()) {
+        const BitmapMergeNode* bmn = static_cast<const BitmapMergeNode*>(trueSoln);
+        BSONElement el = testSoln[bmn->isUnion ? "orBitmap" : "andBitmap"];
+        if (el.eoo() || !el.isABSONObj()) {
+            return false;
+        }
+        BSONObj bitmapObj = el.Obj();
+        invariant(bsonObjFieldsAreInSet(bitmapObj, {"nodes"}));
+        return childrenMatch(bitmapObj, bmn, relaxBoundsCheck);
     } else if (STAGE_AND_HASH == trueSoln->getType()) {
         const AndHashNode* ahn = static_cast<const AndHashNode*>(trueSoln);
         BSONElement el = testSoln["andHash"];
@@ -0,0 +1,413 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_result_cache.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/canonical_query_encoder.h"
+#include "mongo/db/query/count_command_gen.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/query/query_result_cache_gen.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/str.h"
+#include "mongo/util/synchronized_value.h"
+
+namespace mongo {
+namespace {
+
+const auto getQueryResultCache = ServiceContext::declareDecoration<QueryResultCache>();
+
+// The value of the 'queryResultCacheNamespaces' server parameter. It is kept here as well as in
+// the cache because startup parameters are set before the ServiceContext exists.
+synchronized_value<std::vector<NamespaceString>> optedInNamespaces;
+
+StatusWith<std::vector<NamespaceString>> parseNamespaces(const std::vector<std::string>& names) {
+    std::vector<NamespaceString> namespaces;
+    for (auto&& name : names) {
+        NamespaceString nss(name);
+        if (!nss.isValid() || nss.coll().empty()) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "queryResultCacheNamespaces expects full collection "
+                                     "namespaces, but got '"
+                                  << name << "'"};
+        }
+        namespaces.push_back(std::move(nss));
+    }
+    return namespaces;
+}
+
+Status setOptedInNamespaces(const std::vector<std::string>& names) {
+    auto swNamespaces = parseNamespaces(names);
+    if (!swNamespaces.isOK()) {
+        return swNamespaces.getStatus();
+    }
+
+    optedInNamespaces = swNamespaces.getValue();
+    if (hasGlobalServiceContext()) {
+        QueryResultCache::get(getGlobalServiceContext()).setNamespaces(swNamespaces.getValue());
+    }
+    return Status::OK();
+}
+
+class QueryResultCacheServerStatus final : public ServerStatusSection {
+public:
+    QueryResultCacheServerStatus() : ServerStatusSection("queryResultCache") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        QueryResultCache::get(opCtx).appendStats(&builder);
+        return builder.obj();
+    }
+} queryResultCacheServerStatus;
+
+bool filterDependsOnlyOnDocuments(const MatchExpression& filter) {
+    // $expr and $where can depend on things other than the documents, such as $$NOW or $rand.
+    return !QueryPlannerCommon::hasNode(&filter, MatchExpression::EXPRESSION) &&
+        !QueryPlannerCommon::hasNode(&filter, MatchExpression::WHERE);
+}
+
+bool readObservesAllCommittedWrites(OperationContext* opCtx, const NamespaceString& nss) {
+    // Only reads from the latest committed data are guaranteed to observe every write which
+    // invalidates the cache. Shard servers additionally filter results by chunk ownership, which
+    // changes without writes to the collection.
+    if (opCtx->inMultiDocumentTransaction() ||
+        serverGlobalParams.clusterRole != ClusterRole::None) {
+        return false;
+    }
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern ||
+        readConcernArgs.getArgsOpTime() || readConcernArgs.getArgsAfterClusterTime() ||
+        readConcernArgs.getArgsAtClusterTime()) {
+        return false;
+    }
+    return repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, nss);
+}
+
+}  // namespace
+
+void QueryResultCacheNamespacesServerParameter::append(OperationContext*,
+                                                       BSONObjBuilder& bob,
+                                                       const std::string& name) {
+    BSONArrayBuilder arr(bob.subarrayStart(name));
+    for (auto&& nss : optedInNamespaces.get()) {
+        arr.append(nss.ns());
+    }
+}
+
+Status QueryResultCacheNamespacesServerParameter::set(const BSONElement& value) {
+    if (value.type() != BSONType::Array) {
+        return {ErrorCodes::BadValue, "queryResultCacheNamespaces must be an array of strings"};
+    }
+
+    std::vector<std::string> names;
+    for (auto&& elem : value.Obj()) {
+        if (elem.type() != BSONType::String) {
+            return {ErrorCodes::BadValue, "queryResultCacheNamespaces must be an array of strings"};
+        }
+        names.push_back(elem.str());
+    }
+    return setOptedInNamespaces(names);
+}
+
+Status QueryResultCacheNamespacesServerParameter::setFromString(const std::string& str) {
+    // On the command line the namespaces are given as a comma separated list.
+    std::vector<std::string> names;
+    str::splitStringDelim(str, &names, ',');
+    names.erase(std::remove(names.begin(), names.end(), ""), names.end());
+    return setOptedInNamespaces(names);
+}
+
+QueryResultCache::QueryResultCache() {
+    setNamespaces(optedInNamespaces.get());
+}
+
+QueryResultCache& QueryResultCache::get(ServiceContext* serviceContext) {
+    return getQueryResultCache(serviceContext);
+}
+
+QueryResultCache& QueryResultCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+bool QueryResultCache::isCacheable(OperationContext* opCtx, const CanonicalQuery& cq) {
+    const auto& qr = cq.getQueryRequest();
+    if (qr.isTailable() || qr.isExplain() || qr.getRequestResumeToken() ||
+        !qr.getResumeAfter().isEmpty() || qr.getLetParameters()) {
+        return false;
+    }
+
+    if (!filterDependsOnlyOnDocuments(*cq.root())) {
+        return false;
+    }
+    if (cq.getProj() && cq.getProj()->hasExpressions()) {
+        return false;
+    }
+    if (cq.metadataDeps().any()) {
+        return false;
+    }
+    return readObservesAllCommittedWrites(opCtx, cq.nss());
+}
+
+bool QueryResultCache::isCacheableCount(OperationContext* opCtx,
+                                        const NamespaceString& nss,
+                                        const MatchExpression& filter) {
+    return filterDependsOnlyOnDocuments(filter) && readObservesAllCommittedWrites(opCtx, nss);
+}
+
+std::string QueryResultCache::computeKey(const CanonicalQuery& cq) {
+    const auto& qr = cq.getQueryRequest();
+
+    // The shape identifies the structure of the query. The parameters add the values stripped
+    // from the shape, along with everything else in the request which can change its result.
+    BSONObjBuilder params;
+    params.append("filter", qr.getFilter());
+    params.append("projection", qr.getProj());
+    params.append("sort", qr.getSort());
+    params.append("hint", qr.getHint());
+    params.append("collation", qr.getCollation());
+    params.append("min", qr.getMin());
+    params.append("max", qr.getMax());
+    params.append("skip", qr.getSkip().value_or(0));
+    params.append("limit", qr.getLimit().value_or(0));
+    params.append("ntoreturn", qr.getNToReturn().value_or(0));
+    params.append("batchSize", qr.getBatchSize().value_or(-1));
+    params.append("singleBatch", !qr.wantMore());
+    params.append("returnKey", qr.returnKey());
+    params.append("showRecordId", qr.showRecordId());
+    BSONObj paramsObj = params.done();
+
+    std::string key = canonical_query_encoder::encode(cq);
+    key.push_back('\0');
+    key.append(paramsObj.objdata(), paramsObj.objsize());
+    return key;
+}
+
+std::string QueryResultCache::computeCountKey(const CountCommand& request) {
+    BSONObjBuilder params;
+    params.append("query", request.getQuery());
+    params.append("hint", request.getHint());
+    params.append("collation", request.getCollation().value_or(BSONObj()));
+    params.append("skip", request.getSkip().value_or(0));
+    params.append("limit", request.getLimit().value_or(0));
+    BSONObj paramsObj = params.done();
+
+    // No query shape encoding starts with a NUL byte, so count keys never collide with find keys.
+    std::string key("\0count\0", 7);
+    key.append(paramsObj.objdata(), paramsObj.objsize());
+    return key;
+}
+
+boost::optional<uint64_t> QueryResultCache::getEpoch(const NamespaceString& nss) const {
+    if (!_enabled.load()) {
+        return boost::none;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _namespaces.find(nss.ns());
+    if (it == _namespaces.end()) {
+        return boost::none;
+    }
+    return it->second.epoch;
+}
+
+std::shared_ptr<const QueryResultCache::CachedResult> QueryResultCache::lookup(
+    const NamespaceString& nss, const std::string& key) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto nsIt = _namespaces.find(nss.ns());
+    if (nsIt == _namespaces.end()) {
+        return nullptr;
+    }
+
+    auto entryIt = nsIt->second.entries.find(key);
+    if (entryIt == nsIt->second.entries.end()) {
+        _misses.fetchAndAdd(1);
+        return nullptr;
+    }
+
+    _hits.fetchAndAdd(1);
+    _lru.splice(_lru.begin(), _lru, entryIt->second);
+    return entryIt->second->result;
+}
+
+void QueryResultCache::add(const NamespaceString& nss,
+                           std::string key,
+                           uint64_t epoch,
+                           CachedResult result) {
+    const size_t maxSizeBytes = internalQueryResultCacheMaxSizeBytes.load();
+    if (result.sizeBytes >
+        std::min<size_t>(internalQueryResultCacheMaxEntrySizeBytes.load(), maxSizeBytes)) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto nsIt = _namespaces.find(nss.ns());
+    if (nsIt == _namespaces.end()) {
+        return;
+    }
+    NamespaceState& nsState = nsIt->second;
+    if (nsState.epoch != epoch) {
+        // A write committed after this result's snapshot was opened, so it may be stale.
+        ++_rejectedStale;
+        return;
+    }
+
+    auto existing = nsState.entries.find(key);
+    if (existing != nsState.entries.end()) {
+        _erase(lk, &nsState, existing->second);
+    }
+
+    const size_t sizeBytes = result.sizeBytes;
+    _lru.push_front({nss.ns(), key, std::make_shared<const CachedResult>(std::move(result))});
+    nsState.entries.emplace(std::move(key), _lru.begin());
+    _sizeBytes += sizeBytes;
+    ++_inserts;
+
+    _evictToSize(lk, maxSizeBytes);
+}
+
+void QueryResultCache::invalidate(const NamespaceString& nss) {
+    if (!_enabled.load()) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto nsIt = _namespaces.find(nss.ns());
+    if (nsIt != _namespaces.end()) {
+        _invalidate(lk, &nsIt->second);
+    }
+}
+
+void QueryResultCache::invalidateDatabase(StringData dbName) {
+    if (!_enabled.load()) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (auto&& [ns, nsState] : _namespaces) {
+        if (nsToDatabaseSubstring(ns) == dbName) {
+            _invalidate(lk, &nsState);
+        }
+    }
+}
+
+void QueryResultCache::clear() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (auto&& [ns, nsState] : _namespaces) {
+        _invalidate(lk, &nsState);
+    }
+}
+
+void QueryResultCache::setNamespaces(const std::vector<NamespaceString>& namespaces) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    stdx::unordered_map<std::string, NamespaceState> newNamespaces;
+    for (auto&& nss : namespaces) {
+        auto it = _namespaces.find(nss.ns());
+        if (it != _namespaces.end()) {
+            newNamespaces.emplace(nss.ns(), std::move(it->second));
+            _namespaces.erase(it);
+        } else {
+            newNamespaces[nss.ns()].epoch = _nextEpoch++;
+        }
+    }
+
+    // Whatever is left has been removed from the cache.
+    for (auto&& [ns, nsState] : _namespaces) {
+        _invalidate(lk, &nsState);
+    }
+    _namespaces = std::move(newNamespaces);
+    _enabled.store(!_namespaces.empty());
+}
+
+std::vector<NamespaceString> QueryResultCache::getNamespaces() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    std::vector<NamespaceString> namespaces;
+    for (auto&& [ns, nsState] : _namespaces) {
+        namespaces.emplace_back(ns);
+    }
+    return namespaces;
+}
+
+size_t QueryResultCache::sizeBytes() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _sizeBytes;
+}
+
+void QueryResultCache::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    builder->appendNumber("namespaces", static_cast<long long>(_namespaces.size()));
+    builder->appendNumber("entries", static_cast<long long>(_lru.size()));
+    builder->appendNumber("sizeBytes", static_cast<long long>(_sizeBytes));
+    builder->appendNumber("hits", _hits.load());
+    builder->appendNumber("misses", _misses.load());
+    builder->appendNumber("inserts", _inserts);
+    builder->appendNumber("rejectedStale", _rejectedStale);
+    builder->appendNumber("invalidations", _invalidations);
+    builder->appendNumber("evictions", _evictions);
+}
+
+void QueryResultCache::_erase(WithLock, NamespaceState* nsState, EntryList::iterator it) {
+    _sizeBytes -= it->result->sizeBytes;
+    nsState->entries.erase(it->key);
+    _lru.erase(it);
+}
+
+void QueryResultCache::_invalidate(WithLock lk, NamespaceState* nsState) {
+    while (!nsState->entries.empty()) {
+        _erase(lk, nsState, nsState->entries.begin()->second);
+    }
+    nsState->epoch = _nextEpoch++;
+    ++_invalidations;
+}
+
+void QueryResultCache::_evictToSize(WithLock lk, size_t maxSizeBytes) {
+    while (_sizeBytes > maxSizeBytes) {
+        invariant(!_lru.empty());
+        auto victim = std::prev(_lru.end());
+        _erase(lk, &_namespaces.at(victim->ns), victim);
+        ++_evictions;
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,216 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class CanonicalQuery;
+class CountCommand;
+class MatchExpression;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * A cache of complete find command results for the namespaces listed in the
+ * 'queryResultCacheNamespaces' server parameter. A find whose whole result fits in its first batch
+ * is cached under its namespace and a key made of the canonical query shape plus the values of
+ * its parameters, so that an identical find can be answered without planning or executing it.
+ * The results of count commands are cached alongside, so that repeated counts of the same
+ * predicate cost O(1) until the next write instead of a scan of every matching key.
+ *
+ * All entries for a namespace are dropped when a write to it commits (see
+ * QueryResultCacheOpObserver). A find running concurrently with such a write may have read from a
+ * snapshot which predates it, so each namespace also carries an epoch which changes with every
+ * invalidation. A reader obtains the epoch before it opens its storage snapshot and its result is
+ * only added to the cache if the epoch is still current.
+ *
+ * The cache is bounded by internalQueryResultCacheMaxSizeBytes and evicts the least recently used
+ * entries first.
+ */
+class QueryResultCache {
+    QueryResultCache(const QueryResultCache&) = delete;
+    QueryResultCache& operator=(const QueryResultCache&) = delete;
+
+public:
+    /**
+     * The owned documents which make up the single batch of a cached find.
+     */
+    struct CachedResult {
+        std::vector<BSONObj> docs;
+        size_t sizeBytes = 0;
+    };
+
+    QueryResultCache();
+
+    static QueryResultCache& get(ServiceContext* serviceContext);
+    static QueryResultCache& get(OperationContext* opCtx);
+
+    /**
+     * Returns true if results for 'cq' depend only on the contents of its collection, and if the
+     * read which 'opCtx' is about to perform sees every committed write to that collection. This
+     * excludes queries with $expr or $where, projections with expressions, queries requiring
+     * metadata, reads other than local reads on a primary, and reads in a transaction.
+     */
+    static bool isCacheable(OperationContext* opCtx, const CanonicalQuery& cq);
+
+    /**
+     * Returns true if the result of a count on 'nss' with the parsed query 'filter' depends only
+     * on the contents of the collection, under the same conditions as isCacheable().
+     */
+    static bool isCacheableCount(OperationContext* opCtx,
+                                 const NamespaceString& nss,
+                                 const MatchExpression& filter);
+
+    /**
+     * Returns the key under which the result of 'cq' is cached: the encoding of its query shape
+     * followed by the values of the parameters which affect its result.
+     */
+    static std::string computeKey(const CanonicalQuery& cq);
+
+    /**
+     * Returns the key under which the result of the count 'request' is cached. The result is held
+     * as a single document {n: <count>}.
+     */
+    static std::string computeCountKey(const CountCommand& request);
+
+    /**
+     * Returns true if any namespace is opted in to the cache.
+     */
+    bool isEnabled() const {
+        return _enabled.load();
+    }
+
+    /**
+     * Returns the current epoch for 'nss', or boost::none if 'nss' is not opted in to the cache.
+     * Must be called before the read whose result will be passed to add() opens its snapshot.
+     */
+    boost::optional<uint64_t> getEpoch(const NamespaceString& nss) const;
+
+    /**
+     * Returns the cached result for 'key' in 'nss', or nullptr if there is none.
+     */
+    std::shared_ptr<const CachedResult> lookup(const NamespaceString& nss, const std::string& key);
+
+    /**
+     * Caches 'result' for 'key' in 'nss', provided that the epoch of 'nss' is still 'epoch' and the
+     * result is no larger than internalQueryResultCacheMaxEntrySizeBytes.
+     */
+    void add(const NamespaceString& nss, std::string key, uint64_t epoch, CachedResult result);
+
+    /**
+     * Drops every entry for 'nss' and advances its epoch.
+     */
+    void invalidate(const NamespaceString& nss);
+
+    /**
+     * Drops every entry for the namespaces in database 'dbName' and advances their epochs.
+     */
+    void invalidateDatabase(StringData dbName);
+
+    /**
+     * Drops every entry and advances the epoch of every namespace.
+     */
+    void clear();
+
+    /**
+     * Replaces the set of namespaces which are opted in to the cache. Entries for namespaces which
+     * are no longer in the set are dropped.
+     */
+    void setNamespaces(const std::vector<NamespaceString>& namespaces);
+
+    std::vector<NamespaceString> getNamespaces() const;
+
+    /**
+     * Returns the total size of the cached results in bytes.
+     */
+    size_t sizeBytes() const;
+
+    /**
+     * Appends the statistics reported in the 'queryResultCache' serverStatus section.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    struct Entry {
+        std::string ns;
+        std::string key;
+        std::shared_ptr<const CachedResult> result;
+    };
+
+    // Most recently used entries are at the front.
+    using EntryList = std::list<Entry>;
+
+    struct NamespaceState {
+        uint64_t epoch = 0;
+        stdx::unordered_map<std::string, EntryList::iterator> entries;
+    };
+
+    void _erase(WithLock, NamespaceState* nsState, EntryList::iterator it);
+    void _invalidate(WithLock, NamespaceState* nsState);
+    void _evictToSize(WithLock, size_t maxSizeBytes);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("QueryResultCache::_mutex");
+
+    // True if at least one namespace is opted in, so that finds and writes on other namespaces can
+    // skip '_mutex' when the cache is not in use.
+    AtomicWord<bool> _enabled{false};
+
+    // The opted in namespaces, keyed by their full name.
+    stdx::unordered_map<std::string, NamespaceState> _namespaces;
+
+    EntryList _lru;
+    size_t _sizeBytes = 0;
+
+    // Source of epochs. Every invalidation takes a new value so that an epoch is never reused,
+    // even by a namespace which is removed from the cache and added back.
+    uint64_t _nextEpoch = 1;
+
+    AtomicWord<long long> _hits{0};
+    AtomicWord<long long> _misses{0};
+    long long _inserts = 0;
+    long long _rejectedStale = 0;
+    long long _invalidations = 0;
+    long long _evictions = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,209 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/count_command_gen.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("testdb.testcoll");
+const NamespaceString kOtherNss("testdb.othercoll");
+
+QueryResultCache::CachedResult makeResult(std::vector<BSONObj> docs) {
+    QueryResultCache::CachedResult result;
+    for (auto&& doc : docs) {
+        result.sizeBytes += doc.objsize();
+    }
+    result.docs = std::move(docs);
+    return result;
+}
+
+std::unique_ptr<CanonicalQuery> canonicalize(const char* filter, const char* proj = "{}") {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto qr = std::make_unique<QueryRequest>(kNss);
+    qr->setFilter(fromjson(filter));
+    qr->setProj(fromjson(proj));
+    auto statusWithCQ =
+        CanonicalQuery::canonicalize(opCtx.get(),
+                                     std::move(qr),
+                                     nullptr,
+                                     ExtensionsCallbackNoop(),
+                                     MatchExpressionParser::kAllowAllSpecialFeatures);
+    ASSERT_OK(statusWithCQ.getStatus());
+    return std::move(statusWithCQ.getValue());
+}
+
+TEST(QueryResultCacheTest, NamespacesMustOptIn) {
+    QueryResultCache cache;
+    ASSERT_FALSE(cache.isEnabled());
+    ASSERT_FALSE(cache.getEpoch(kNss));
+
+    cache.setNamespaces({kNss});
+    ASSERT_TRUE(cache.isEnabled());
+    ASSERT_TRUE(cache.getEpoch(kNss));
+    ASSERT_FALSE(cache.getEpoch(kOtherNss));
+
+    cache.setNamespaces({});
+    ASSERT_FALSE(cache.isEnabled());
+    ASSERT_FALSE(cache.getEpoch(kNss));
+}
+
+TEST(QueryResultCacheTest, AddThenLookup) {
+    QueryResultCache cache;
+    cache.setNamespaces({kNss});
+    auto epoch = *cache.getEpoch(kNss);
+
+    ASSERT_FALSE(cache.lookup(kNss, "key"));
+    cache.add(kNss, "key", epoch, makeResult({BSON("_id" << 1), BSON("_id" << 2)}));
+
+    auto cached = cache.lookup(kNss, "key");
+    ASSERT_TRUE(cached);
+    ASSERT_EQ(cached->docs.size(), 2U);
+    ASSERT_BSONOBJ_EQ(cached->docs[1], BSON("_id" << 2));
+    ASSERT_FALSE(cache.lookup(kNss, "otherKey"));
+    ASSERT_FALSE(cache.lookup(kOtherNss, "key"));
+}
+
+TEST(QueryResultCacheTest, InvalidationDropsEntriesAndRejectsStaleResults) {
+    QueryResultCache cache;
+    cache.setNamespaces({kNss, kOtherNss});
+    auto epoch = *cache.getEpoch(kNss);
+    cache.add(kNss, "key", epoch, makeResult({BSON("_id" << 1)}));
+    cache.add(kOtherNss, "key", *cache.getEpoch(kOtherNss), makeResult({BSON("_id" << 1)}));
+
+    cache.invalidate(kNss);
+    ASSERT_FALSE(cache.lookup(kNss, "key"));
+    ASSERT_TRUE(cache.lookup(kOtherNss, "key"));
+    ASSERT_NE(*cache.getEpoch(kNss), epoch);
+
+    // A result computed before the invalidation must not be cached after it.
+    cache.add(kNss, "key", epoch, makeResult({BSON("_id" << 1)}));
+    ASSERT_FALSE(cache.lookup(kNss, "key"));
+
+    cache.invalidateDatabase(kNss.db());
+    ASSERT_FALSE(cache.lookup(kOtherNss, "key"));
+    ASSERT_EQ(cache.sizeBytes(), 0U);
+}
+
+TEST(QueryResultCacheTest, EvictsLeastRecentlyUsedBeyondMaxSize) {
+    QueryResultCache cache;
+    cache.setNamespaces({kNss});
+    auto epoch = *cache.getEpoch(kNss);
+    const auto doc = BSON("_id" << 1);
+
+    const auto originalMaxSize = internalQueryResultCacheMaxSizeBytes.load();
+    internalQueryResultCacheMaxSizeBytes.store(2 * doc.objsize());
+    cache.add(kNss, "a", epoch, makeResult({doc}));
+    cache.add(kNss, "b", epoch, makeResult({doc}));
+    ASSERT_TRUE(cache.lookup(kNss, "a"));
+    cache.add(kNss, "c", epoch, makeResult({doc}));
+    internalQueryResultCacheMaxSizeBytes.store(originalMaxSize);
+
+    ASSERT_TRUE(cache.lookup(kNss, "a"));
+    ASSERT_FALSE(cache.lookup(kNss, "b"));
+    ASSERT_TRUE(cache.lookup(kNss, "c"));
+    ASSERT_EQ(cache.sizeBytes(), static_cast<size_t>(2 * doc.objsize()));
+
+    BSONObjBuilder stats;
+    cache.appendStats(&stats);
+    ASSERT_EQ(stats.obj()["evictions"].numberLong(), 1);
+}
+
+TEST(QueryResultCacheTest, ResultsLargerThanMaxEntrySizeAreNotCached) {
+    QueryResultCache cache;
+    cache.setNamespaces({kNss});
+    const auto doc = BSON("_id" << 1);
+
+    const auto originalMaxEntrySize = internalQueryResultCacheMaxEntrySizeBytes.load();
+    internalQueryResultCacheMaxEntrySizeBytes.store(doc.objsize());
+    cache.add(kNss, "key", *cache.getEpoch(kNss), makeResult({doc, doc}));
+    internalQueryResultCacheMaxEntrySizeBytes.store(originalMaxEntrySize);
+
+    ASSERT_FALSE(cache.lookup(kNss, "key"));
+}
+
+TEST(QueryResultCacheTest, KeyDistinguishesParameterValuesOfTheSameShape) {
+    auto key = QueryResultCache::computeKey(*canonicalize("{a: 1}"));
+    ASSERT_EQ(key, QueryResultCache::computeKey(*canonicalize("{a: 1}")));
+    ASSERT_NE(key, QueryResultCache::computeKey(*canonicalize("{a: 2}")));
+    ASSERT_NE(key, QueryResultCache::computeKey(*canonicalize("{a: 1}", "{a: 1}")));
+}
+
+TEST(QueryResultCacheTest, QueriesNotDeterminedByTheDocumentsAreNotCacheable) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    ASSERT_FALSE(
+        QueryResultCache::isCacheable(opCtx.get(), *canonicalize("{$expr: {$eq: ['$a', 1]}}")));
+    ASSERT_FALSE(QueryResultCache::isCacheable(opCtx.get(),
+                                               *canonicalize("{}", "{b: {$add: ['$a', 1]}}")));
+}
+
+
+CountCommand makeCountCommand(const char* query) {
+    CountCommand request(kNss);
+    request.setQuery(fromjson(query));
+    return request;
+}
+
+TEST(QueryResultCacheTest, CountKeyDistinguishesParametersAndDiffersFromFindKeys) {
+    auto key = QueryResultCache::computeCountKey(makeCountCommand("{a: 1}"));
+    ASSERT_EQ(key, QueryResultCache::computeCountKey(makeCountCommand("{a: 1}")));
+    ASSERT_NE(key, QueryResultCache::computeCountKey(makeCountCommand("{a: 2}")));
+
+    auto withLimit = makeCountCommand("{a: 1}");
+    withLimit.setLimit(5);
+    ASSERT_NE(key, QueryResultCache::computeCountKey(withLimit));
+
+    ASSERT_NE(key, QueryResultCache::computeKey(*canonicalize("{a: 1}")));
+}
+
+TEST(QueryResultCacheTest, CountsNotDeterminedByTheDocumentsAreNotCacheable) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto expCtx = make_intrusive<ExpressionContextForTest>(opCtx.get(), kNss);
+    auto filter = uassertStatusOK(MatchExpressionParser::parse(
+        fromjson("{$expr: {$eq: ['$a', 1]}}"), expCtx, ExtensionsCallbackNoop()));
+    ASSERT_FALSE(QueryResultCache::isCacheableCount(opCtx.get(), kNss, *filter));
+}
+
+}  // namespace
+}  // namespace mongo
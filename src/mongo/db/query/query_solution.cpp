@@ -311,6 +311,30 @@ QuerySolutionNode* AndSortedNode::clone() const {
     return copy;
 }
 
+//
+// BitmapMergeNode
+//
+
+BitmapMergeNode::BitmapMergeNode(bool isUnion) : isUnion(isUnion) {}
+
+void BitmapMergeNode::appendToString(str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << (isUnion ? "OR_BITMAP\n" : "AND_BITMAP\n");
+    addCommon(ss, indent);
+    for (size_t i = 0; i < children.size(); ++i) {
+        addIndent(ss, indent + 1);
+        *ss << "Child " << i << ":\n";
+        children[i]->appendToString(ss, indent + 2);
+        *ss << '\n';
+    }
+}
+
+QuerySolutionNode* BitmapMergeNode::clone() const {
+    BitmapMergeNode* copy = new BitmapMergeNode(isUnion);
+    cloneBaseData(copy);
+    return copy;
+}
+
 //
 // OrNode
 //
@@ -437,6 +461,10 @@ FetchNode::FetchNode() {}
 void FetchNode::appendToString(str::stream* ss, int indent) const {
     addIndent(ss, indent);
     *ss << "FETCH\n";
+    if (recordIdBatchSize) {
+        addIndent(ss, indent + 1);
+        *ss << "recordIdBatchSize = " << recordIdBatchSize << '\n';
+    }
     if (nullptr != filter) {
         addIndent(ss, indent + 1);
         StringBuilder sb;
@@ -453,6 +481,7 @@ void FetchNode::appendToString(str::stream* ss, int indent) const {
 QuerySolutionNode* FetchNode::clone() const {
     FetchNode* copy = new FetchNode();
     cloneBaseData(copy);
+    copy->recordIdBatchSize = this->recordIdBatchSize;
     return copy;
 }
 
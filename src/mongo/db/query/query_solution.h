@@ -485,6 +485,37 @@ struct AndSortedNode : public QuerySolutionNodeWithSortSet {
     QuerySolutionNode* clone() const;
 };
 
+struct BitmapMergeNode : public QuerySolutionNode {
+    explicit BitmapMergeNode(bool isUnion);
+    virtual ~BitmapMergeNode() {}
+
+    virtual StageType getType() const {
+        return isUnion ? STAGE_OR_BITMAP : STAGE_AND_BITMAP;
+    }
+
+    virtual void appendToString(str::stream* ss, int indent) const;
+
+    // Only the RecordIds of the children are kept.
+    bool fetched() const {
+        return false;
+    }
+    FieldAvailability getFieldAvailability(const std::string& field) const {
+        return FieldAvailability::kNotProvided;
+    }
+    bool sortedByDiskLoc() const {
+        return true;
+    }
+    const ProvidedSortSet& providedSorts() const {
+        static const ProvidedSortSet kNoSorts;
+        return kNoSorts;
+    }
+
+    QuerySolutionNode* clone() const;
+
+    // Whether this is the union of its children, rather than their intersection.
+    bool isUnion;
+};
+
 struct OrNode : public QuerySolutionNodeWithSortSet {
     OrNode();
     virtual ~OrNode();
@@ -554,13 +585,18 @@ struct FetchNode : public QuerySolutionNode {
         return FieldAvailability::kFullyProvided;
     }
     bool sortedByDiskLoc() const {
-        return children[0]->sortedByDiskLoc();
+        return !recordIdBatchSize && children[0]->sortedByDiskLoc();
     }
     const ProvidedSortSet& providedSorts() const {
-        return children[0]->providedSorts();
+        static const ProvidedSortSet kNoSorts;
+        return recordIdBatchSize ? kNoSorts : children[0]->providedSorts();
     }
 
     QuerySolutionNode* clone() const;
+
+    // If non-zero, the fetch buffers this many results of its child and fetches them in RecordId
+    // order, which loses the order of the child.
+    size_t recordIdBatchSize = 0;
 };
 
 struct IndexScanNode : public QuerySolutionNodeWithSortSet {
@@ -0,0 +1,313 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/sbe/stages/co_scan.h"
+#include "mongo/db/exec/sbe/stages/limit_skip.h"
+#include "mongo/db/exec/sbe/stages/project.h"
+#include "mongo/db/exec/sbe/values/bson.h"
+#include "mongo/db/pipeline/dependencies.h"
+#include "mongo/db/pipeline/expression_compiler.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/expression_walker.h"
+#include "mongo/db/query/sbe_stage_builder_expression.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns true if every variable referenced inside 'expr' is either $$ROOT/$$CURRENT, $$REMOVE or
+ * a variable bound by an enclosing $let. The stage builder has no slots for any other variable,
+ * such as the ones bound by $map or the system variables held by the ExpressionContext.
+ */
+bool referencesOnlyBoundVariables(Expression* expr, std::set<Variables::Id>* boundVariables) {
+    if (auto fieldPath = dynamic_cast<ExpressionFieldPath*>(expr)) {
+        const auto id = fieldPath->getVariableId();
+        return id == Variables::kRootId || id == Variables::kRemoveId ||
+            boundVariables->count(id);
+    }
+
+    // Variables bound by a $let are in scope in its 'in' expression, after the definitions.
+    std::vector<Variables::Id> newlyBound;
+    if (auto let = dynamic_cast<ExpressionLet*>(expr)) {
+        for (auto&& [id, _] : let->getVariableMap()) {
+            if (boundVariables->insert(id).second) {
+                newlyBound.push_back(id);
+            }
+        }
+    }
+
+    bool supported = true;
+    for (auto&& child : expr->getChildren()) {
+        if (child && !referencesOnlyBoundVariables(child.get(), boundVariables)) {
+            supported = false;
+            break;
+        }
+    }
+
+    for (auto id : newlyBound) {
+        boundVariables->erase(id);
+    }
+    return supported;
+}
+
+/**
+ * Returns true if 'elem' only holds BSON types which the slot-based execution engine reads back
+ * faithfully. Any other type, such as BinData or a regex, is converted to Nothing and would not
+ * evaluate the same way it does in the classic engine.
+ */
+bool hasSupportedType(const BSONElement& elem) {
+    switch (elem.type()) {
+        case BSONType::NumberDouble:
+        case BSONType::NumberDecimal:
+        case BSONType::String:
+        case BSONType::jstOID:
+        case BSONType::Bool:
+        case BSONType::Date:
+        case BSONType::jstNULL:
+        case BSONType::NumberInt:
+        case BSONType::bsonTimestamp:
+        case BSONType::NumberLong:
+            return true;
+        case BSONType::Object:
+        case BSONType::Array:
+            for (auto&& child : elem.Obj()) {
+                if (!hasSupportedType(child)) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Converts the result of the compiled expression into a Value, or returns boost::none if the
+ * result holds a type with no Value counterpart.
+ */
+boost::optional<Value> convertToValue(sbe::value::TypeTags tag, sbe::value::Value val) {
+    using sbe::value::TypeTags;
+    using sbe::value::bitcastTo;
+
+    switch (tag) {
+        case TypeTags::Nothing:
+            return Value();
+        case TypeTags::NumberInt32:
+            return Value(bitcastTo<int32_t>(val));
+        case TypeTags::NumberInt64:
+            return Value(bitcastTo<long long>(val));
+        case TypeTags::NumberDouble:
+            return Value(bitcastTo<double>(val));
+        case TypeTags::NumberDecimal:
+            return Value(bitcastTo<Decimal128>(val));
+        case TypeTags::Date:
+            return Value(Date_t::fromMillisSinceEpoch(bitcastTo<int64_t>(val)));
+        case TypeTags::Timestamp:
+            return Value(Timestamp(bitcastTo<uint64_t>(val)));
+        case TypeTags::Boolean:
+            return Value(bitcastTo<bool>(val));
+        case TypeTags::Null:
+            return Value(BSONNULL);
+        case TypeTags::StringSmall:
+        case TypeTags::StringBig:
+        case TypeTags::bsonString: {
+            auto sv = sbe::value::getStringView(tag, val);
+            return Value(StringData{sv.data(), sv.size()});
+        }
+        case TypeTags::ObjectId:
+            return Value(OID::from(sbe::value::getObjectIdView(val)->data()));
+        case TypeTags::bsonObjectId:
+            return Value(OID::from(bitcastTo<const char*>(val)));
+        case TypeTags::bsonObject:
+            return Value(BSONObj(bitcastTo<const char*>(val)).getOwned());
+        case TypeTags::bsonArray:
+            return Value(BSONArray(BSONObj(bitcastTo<const char*>(val)).getOwned()));
+        case TypeTags::Array:
+        case TypeTags::ArraySet: {
+            std::vector<Value> values;
+            for (sbe::value::ArrayEnumerator it{tag, val}; !it.atEnd(); it.advance()) {
+                auto [elemTag, elemVal] = it.getViewOfValue();
+                auto elem = convertToValue(elemTag, elemVal);
+                if (!elem) {
+                    return boost::none;
+                }
+                // Arrays cannot hold missing values, so Nothing becomes null as it does in BSON.
+                values.push_back(elem->missing() ? Value(BSONNULL) : std::move(*elem));
+            }
+            return Value(std::move(values));
+        }
+        case TypeTags::Object: {
+            auto obj = sbe::value::getObjectView(val);
+            MutableDocument doc;
+            for (size_t idx = 0; idx < obj->size(); ++idx) {
+                auto [fieldTag, fieldVal] = obj->getAt(idx);
+                auto field = convertToValue(fieldTag, fieldVal);
+                if (!field) {
+                    return boost::none;
+                }
+                if (!field->missing()) {
+                    doc.addField(obj->field(idx), std::move(*field));
+                }
+            }
+            return doc.freezeToValue();
+        }
+        default:
+            return boost::none;
+    }
+}
+
+/**
+ * An Expression compiled into a ProjectStage over a single-row CoScan, which binds the result of
+ * the expression to a slot. The input document is fed through a correlated slot, so the same plan
+ * is reopened for every document rather than being rebuilt.
+ */
+class SbeCompiledExpression final : public CompiledExpression {
+public:
+    SbeCompiledExpression(OperationContext* opCtx, Expression* expr) {
+        DepsTracker deps;
+        expr->addDependencies(&deps);
+        uassert(ErrorCodes::InternalErrorNotSupported,
+                "expressions reading metadata are not compiled",
+                !deps.getNeedsAnyMetadata());
+        if (!deps.needWholeDocument) {
+            _dependencies.assign(deps.fields.begin(), deps.fields.end());
+        }
+        _needWholeDocument = deps.needWholeDocument;
+
+        sbe::value::SlotIdGenerator slotIdGenerator;
+        sbe::value::FrameIdGenerator frameIdGenerator;
+        _inputSlot = slotIdGenerator.generate();
+
+        auto [slot, sbeExpr, stage] = stage_builder::generateExpression(
+            opCtx,
+            expr,
+            sbe::makeS<sbe::LimitSkipStage>(sbe::makeS<sbe::CoScanStage>(), 1, boost::none),
+            &slotIdGenerator,
+            &frameIdGenerator,
+            _inputSlot);
+
+        const auto resultSlot = slotIdGenerator.generate();
+        _root = sbe::makeProjectStage(std::move(stage), resultSlot, std::move(sbeExpr));
+
+        _ctx.root = _root.get();
+        _ctx.pushCorrelated(_inputSlot, &_inputAccessor);
+        _root->prepare(_ctx);
+        _resultAccessor = _root->getAccessor(_ctx, resultSlot);
+    }
+
+    ~SbeCompiledExpression() {
+        if (_opened) {
+            _root->close();
+        }
+    }
+
+    boost::optional<Value> evaluate(const Document& root) final {
+        // Only documents still backed by their original BSON can be handed to the plan without a
+        // conversion, which would cost more than evaluating the expression directly.
+        auto bson = root.toBsonIfTriviallyConvertible();
+        if (!bson || !hasSupportedInput(*bson)) {
+            return boost::none;
+        }
+
+        _inputAccessor.reset(sbe::value::TypeTags::bsonObject,
+                             sbe::value::bitcastFrom<const char*>(bson->objdata()));
+        _root->open(_opened);
+        _opened = true;
+
+        auto state = _root->getNext();
+        invariant(state == sbe::PlanState::ADVANCED);
+        auto [tag, val] = _resultAccessor->getViewOfValue();
+        return convertToValue(tag, val);
+    }
+
+private:
+    bool hasSupportedInput(const BSONObj& bson) const {
+        if (_needWholeDocument) {
+            for (auto&& elem : bson) {
+                if (!hasSupportedType(elem)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        for (auto&& path : _dependencies) {
+            BSONElementSet elems;
+            dotted_path_support::extractAllElementsAlongPath(bson, path, elems, false);
+            for (auto&& elem : elems) {
+                if (!hasSupportedType(elem)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::vector<std::string> _dependencies;
+    bool _needWholeDocument{false};
+
+    sbe::value::SlotId _inputSlot;
+    sbe::value::ViewOfValueAccessor _inputAccessor;
+    sbe::value::SlotAccessor* _resultAccessor{nullptr};
+
+    std::unique_ptr<sbe::PlanStage> _root;
+    sbe::CompileCtx _ctx;
+    bool _opened{false};
+};
+
+std::unique_ptr<CompiledExpression> compileToSbe(ExpressionContext* expCtx, Expression* expr) {
+    // The comparisons generated by the stage builder do not take a collation into account.
+    if (expCtx->getCollator()) {
+        return nullptr;
+    }
+
+    std::set<Variables::Id> boundVariables;
+    if (!referencesOnlyBoundVariables(expr, &boundVariables)) {
+        return nullptr;
+    }
+
+    try {
+        return std::make_unique<SbeCompiledExpression>(expCtx->opCtx, expr);
+    } catch (const ExceptionFor<ErrorCodes::InternalErrorNotSupported>&) {
+        return nullptr;
+    }
+}
+
+MONGO_INITIALIZER(SbeExpressionCompiler)(InitializerContext* context) {
+    expression_compiler::registerCompiler(compileToSbe);
+    return Status::OK();
+}
+
+}  // namespace
+}  // namespace mongo
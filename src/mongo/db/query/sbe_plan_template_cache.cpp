@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/sbe_plan_template_cache.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo::sbe {
+namespace {
+const auto getPlanTemplateCache = Collection::declareDecoration<PlanTemplateCache>();
+}  // namespace
+
+const PlanTemplateCache& PlanTemplateCache::get(const Collection* collection) {
+    return getPlanTemplateCache(collection);
+}
+
+boost::optional<std::string> PlanTemplateCache::computeKey(const CanonicalQuery& cq,
+                                                           const Collection* collection,
+                                                           const QuerySolution& solution) {
+    if (internalQuerySlotBasedExecutionPlanTemplateCacheSize.load() <= 0) {
+        return boost::none;
+    }
+
+    // Parallel plans share their scan state between the clones of the plan stage tree, and scans
+    // of capped collections and the oplog depend on the position they were built for, so neither
+    // can be cached.
+    if (internalQueryDefaultDOP.load() > 1 || collection->isCapped() ||
+        collection->ns().isOplog()) {
+        return boost::none;
+    }
+
+    const auto& qr = cq.getQueryRequest();
+    if (!solution.root || qr.isTailable() || qr.getRequestResumeToken()) {
+        return boost::none;
+    }
+
+    // The joins of pushed down $lookup stages are not part of the find command, and they pick an
+    // index of the foreign collection which this collection's cache would not invalidate.
+    if (!cq.getEqLookupPushdowns().empty()) {
+        return boost::none;
+    }
+
+    // The fields of the find command which do not affect the plan stage tree are left out of
+    // the key, so that they do not prevent queries from sharing a template.
+    auto findCommand = qr.asFindCommand().removeFields({QueryRequest::kBatchSizeField,
+                                                        QueryRequest::kSingleBatchField,
+                                                        QueryRequest::kNoCursorTimeoutField,
+                                                        QueryRequest::kPartialResultsField,
+                                                        QueryRequest::kMaxTimeMSOpOnlyField,
+                                                        "comment",
+                                                        "maxTimeMS"});
+
+    StringBuilder builder;
+    builder << solution.root->toString() << findCommand.toString()
+            << " allowDiskUse: " << cq.getExpCtx()->allowDiskUse;
+    return builder.str();
+}
+
+boost::optional<std::pair<std::unique_ptr<PlanStage>, stage_builder::PlanStageData>>
+PlanTemplateCache::lookup(const std::string& key) const {
+    stdx::lock_guard<Latch> lock(_mutex);
+    if (!_cache) {
+        return boost::none;
+    }
+
+    Entry* entry;
+    if (!_cache->get(key, &entry).isOK()) {
+        return boost::none;
+    }
+
+    stage_builder::PlanStageData data;
+    data.resultSlot = entry->resultSlot;
+    data.recordIdSlot = entry->recordIdSlot;
+    data.oplogTsSlot = entry->oplogTsSlot;
+    data.shouldTrackLatestOplogTimestamp = entry->shouldTrackLatestOplogTimestamp;
+    data.shouldTrackResumeToken = entry->shouldTrackResumeToken;
+    return std::make_pair(entry->root->clone(), std::move(data));
+}
+
+void PlanTemplateCache::add(const std::string& key,
+                            const PlanStage& root,
+                            const stage_builder::PlanStageData& data) const {
+    auto entry = std::make_unique<Entry>();
+    entry->root = root.clone();
+    entry->resultSlot = data.resultSlot;
+    entry->recordIdSlot = data.recordIdSlot;
+    entry->oplogTsSlot = data.oplogTsSlot;
+    entry->shouldTrackLatestOplogTimestamp = data.shouldTrackLatestOplogTimestamp;
+    entry->shouldTrackResumeToken = data.shouldTrackResumeToken;
+
+    stdx::lock_guard<Latch> lock(_mutex);
+    if (!_cache) {
+        _cache = std::make_unique<LRUKeyValue<std::string, Entry>>(
+            internalQuerySlotBasedExecutionPlanTemplateCacheSize.load());
+    }
+
+    // The evicted entry, if any, is destroyed when the returned pointer goes out of scope.
+    _cache->add(key, entry.release());
+}
+}  // namespace mongo::sbe
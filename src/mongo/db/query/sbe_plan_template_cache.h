@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/query/sbe_stage_builder.h"
+#include "mongo/platform/mutex.h"
+
+namespace mongo {
+class Collection;
+class CanonicalQuery;
+struct QuerySolution;
+
+namespace sbe {
+/**
+ * A per-collection cache of SBE plan stage trees built for query solutions which were
+ * reconstructed from the plan cache. A cache hit saves the query from rebuilding the tree from
+ * the QuerySolution; the tree is cloned from the cached template and re-attached to the yield
+ * policy and the trial run tracker of the new query.
+ *
+ * The stage builder embeds the constants of a query into the plan stage tree, hence a template
+ * may only be reused by a query which produced the same solution from the same find command. The
+ * key returned by computeKey() encodes both.
+ *
+ * The cache is disabled unless 'internalQuerySlotBasedExecutionPlanTemplateCacheSize' is
+ * positive.
+ */
+class PlanTemplateCache {
+public:
+    static const PlanTemplateCache& get(const Collection* collection);
+
+    /**
+     * Returns the key under which the plan stage tree built for 'solution' is cached, or
+     * boost::none if the tree cannot be shared with other queries.
+     */
+    static boost::optional<std::string> computeKey(const CanonicalQuery& cq,
+                                                   const Collection* collection,
+                                                   const QuerySolution& solution);
+
+    /**
+     * Returns a copy of the cached plan stage tree and its PlanStageData, if there is one for
+     * 'key'. The caller must attach the returned tree to its own yield policy and trial run
+     * tracker before preparing it.
+     */
+    boost::optional<std::pair<std::unique_ptr<PlanStage>, stage_builder::PlanStageData>> lookup(
+        const std::string& key) const;
+
+    /**
+     * Caches a copy of 'root', which must not have been prepared yet, under 'key'.
+     */
+    void add(const std::string& key,
+             const PlanStage& root,
+             const stage_builder::PlanStageData& data) const;
+
+private:
+    struct Entry {
+        std::unique_ptr<PlanStage> root;
+        boost::optional<value::SlotId> resultSlot;
+        boost::optional<value::SlotId> recordIdSlot;
+        boost::optional<value::SlotId> oplogTsSlot;
+        bool shouldTrackLatestOplogTimestamp{false};
+        bool shouldTrackResumeToken{false};
+    };
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("PlanTemplateCache::_mutex");
+
+    // Created on first use, so that the size of the cache is taken from the knob at that time.
+    mutable std::unique_ptr<LRUKeyValue<std::string, Entry>> _cache;
+};
+}  // namespace sbe
+}  // namespace mongo
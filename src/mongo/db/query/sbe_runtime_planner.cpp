@@ -26,16 +26,69 @@
  *    exception statement from all source files in the program, then also delete
  *    it in the license file.
  */
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/query/sbe_runtime_planner.h"
 
+#include "mongo/base/init.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/trial_period_utils.h"
 #include "mongo/db/query/plan_executor_sbe.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/stage_builder_util.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/future.h"
 
 namespace mongo::sbe {
 namespace {
+MONGO_FAIL_POINT_DEFINE(hangSBETrialRunPoolThreadBeforeRound);
+MONGO_FAIL_POINT_DEFINE(sbeTrialRunPoolThreadLockTimeout);
+
+std::unique_ptr<ThreadPool> trialRunThreadPool;
+MONGO_INITIALIZER(SBETrialRunThreadPool)(InitializerContext* context) {
+    ThreadPool::Options options;
+    options.poolName = "SBE trial run pool";
+    options.threadNamePrefix = "SBETrialRun";
+    options.minThreads = 0;
+    options.maxThreads = 128;
+    options.onCreateThread = [](const std::string& name) { Client::initThread(name); };
+    trialRunThreadPool = std::make_unique<ThreadPool>(options);
+    trialRunThreadPool->startup();
+
+    return Status::OK();
+}
+
+// A pool thread gives up waiting for a lock after this long, rather than deadlocking with the
+// calling thread if an exclusive lock request is queued behind the locks held by the caller.
+const Milliseconds kTrialRunLockTimeout{500};
+
+/**
+ * The state shared by the calling thread and the pool threads of a concurrent trial run.
+ */
+struct ConcurrentTrialRunState {
+    Mutex mutex = MONGO_MAKE_LATCH("ConcurrentTrialRunState::mutex");
+    stdx::condition_variable roundStarted;
+    stdx::condition_variable roundFinished;
+    // The number of rounds started so far by the calling thread.
+    size_t numRounds{0};
+    // The number of pool threads which have finished the current round.
+    size_t numFinished{0};
+    // Set when the trial run is over, or when a pool thread has failed.
+    bool stop{false};
+    // Set when any plan run by a pool thread has reached EOF or exited the trial run.
+    bool done{false};
+    // The number of plans run by the pool threads which have failed.
+    size_t numFailures{0};
+};
 /**
  * Fetches a next document form the given plan stage tree and returns 'true' if the plan stage
  * returns EOF, or throws 'TrialRunProgressTracker::EarlyExitException' exception. Otherwise, the
@@ -76,11 +129,13 @@ bool fetchNextDocument(plan_ranker::CandidatePlan* candidate,
     }
     return false;
 }
-}  // namespace
 
-std::tuple<sbe::value::SlotAccessor*, sbe::value::SlotAccessor*, bool>
-BaseRuntimePlanner::prepareExecutionPlan(PlanStage* root,
-                                         stage_builder::PlanStageData* data) const {
+/**
+ * Prepares the given plan stage tree for execution and opens it on 'opCtx'. See
+ * 'BaseRuntimePlanner::prepareExecutionPlan()'.
+ */
+std::tuple<sbe::value::SlotAccessor*, sbe::value::SlotAccessor*, bool> prepareExecutionPlan(
+    OperationContext* opCtx, PlanStage* root, stage_builder::PlanStageData* data) {
     invariant(root);
     invariant(data);
 
@@ -98,7 +153,7 @@ BaseRuntimePlanner::prepareExecutionPlan(PlanStage* root,
         uassert(4822872, "Query does not have record ID slot.", recordIdSlot);
     }
 
-    root->attachFromOperationContext(_opCtx);
+    root->attachFromOperationContext(opCtx);
 
     auto exitedEarly{false};
     try {
@@ -110,40 +165,314 @@ BaseRuntimePlanner::prepareExecutionPlan(PlanStage* root,
     return {resultSlot, recordIdSlot, exitedEarly};
 }
 
+
+/**
+ * Fetches one document from each of the candidates in 'group' which has neither failed nor exited
+ * early, and returns 'true' if any of them has reached EOF or exited the trial run. Makes the
+ * fetched documents owned if 'makeOwned' is true.
+ */
+bool runTrialRound(std::vector<plan_ranker::CandidatePlan>* candidates,
+                   const std::vector<std::pair<sbe::value::SlotAccessor*,
+                                               sbe::value::SlotAccessor*>>& slots,
+                   const std::vector<size_t>& group,
+                   bool makeOwned,
+                   size_t* numFailures) {
+    auto done{false};
+    for (auto ix : group) {
+        auto& candidate = (*candidates)[ix];
+        if (candidate.failed || candidate.exitedEarly) {
+            continue;
+        }
+
+        const auto numResults = candidate.results.size();
+        done |= fetchNextDocument(&candidate, slots[ix], numFailures);
+        if (makeOwned && candidate.results.size() > numResults) {
+            auto& obj = candidate.results.back().first;
+            obj = obj.getOwned();
+        }
+    }
+    return done;
+}
+}  // namespace
+
+std::tuple<sbe::value::SlotAccessor*, sbe::value::SlotAccessor*, bool>
+BaseRuntimePlanner::prepareExecutionPlan(PlanStage* root,
+                                         stage_builder::PlanStageData* data) const {
+    return sbe::prepareExecutionPlan(_opCtx, root, data);
+}
+
+size_t BaseRuntimePlanner::getNumTrialRunThreads(size_t numCandidates) const {
+    const auto maxThreads = static_cast<size_t>(
+        internalQuerySlotBasedExecutionMaxTrialRunThreads.load());
+    if (maxThreads == 0 || numCandidates < 2) {
+        return 0;
+    }
+
+    // The pool threads read from their own storage snapshots and take their own intent locks, so
+    // the candidates can only be run concurrently if the operation reads the latest data without
+    // holding any exclusive locks.
+    auto locker = _opCtx->lockState();
+    if (_opCtx->inMultiDocumentTransaction() || locker->inAWriteUnitOfWork() ||
+        locker->isWriteLocked() || locker->isCollectionLockedForMode(_collection->ns(), MODE_X) ||
+        repl::ReadConcernArgs::get(_opCtx).getLevel() !=
+            repl::ReadConcernLevel::kLocalReadConcern) {
+        return 0;
+    }
+
+    return std::min(maxThreads, numCandidates - 1);
+}
+
+boost::optional<size_t> BaseRuntimePlanner::collectExecutionStatsConcurrently(
+    std::vector<plan_ranker::CandidatePlan>* candidates, size_t numThreads) {
+    // Candidate 'ix' is run by the calling thread if 'ix % (numThreads + 1)' is 0, and by pool
+    // thread 'ix % (numThreads + 1) - 1' otherwise.
+    std::vector<std::vector<size_t>> groups(numThreads + 1);
+    for (size_t ix = 0; ix < candidates->size(); ++ix) {
+        groups[ix % groups.size()].push_back(ix);
+    }
+
+    std::vector<std::pair<sbe::value::SlotAccessor*, sbe::value::SlotAccessor*>> slots(
+        candidates->size());
+    auto openGroup = [&](OperationContext* opCtx, const std::vector<size_t>& group) {
+        for (auto ix : group) {
+            auto& candidate = (*candidates)[ix];
+            auto [resultSlot, recordIdSlot, exitedEarly] =
+                sbe::prepareExecutionPlan(opCtx, candidate.root.get(), &candidate.data);
+            candidate.exitedEarly = exitedEarly;
+            slots[ix] = {resultSlot, recordIdSlot};
+        }
+    };
+
+    // The operation context of a pool thread has the deadline of the operation, but is not killed
+    // along with it, so the pool threads also check whether the operation has been killed.
+    auto checkForParentInterrupt = [&] {
+        if (auto killCode = _opCtx->getKillStatus(); killCode != ErrorCodes::OK) {
+            uasserted(killCode, "The operation running the trial period was killed");
+        }
+    };
+
+    ConcurrentTrialRunState state;
+    auto runPoolThread = [&](OperationContext* opCtx, const std::vector<size_t>& group) {
+        opCtx->lockState()->setMaxLockTimeout(kTrialRunLockTimeout);
+        if (_opCtx->hasDeadline()) {
+            opCtx->setDeadlineByDate(_opCtx->getDeadline(), _opCtx->getTimeoutError());
+        }
+
+        // The yield policy of the operation is not thread safe, so the plans run by this thread
+        // only check for interrupts until they are handed back to the calling thread.
+        PlanYieldPolicySBE yieldPolicy(PlanYieldPolicy::YieldPolicy::INTERRUPT_ONLY,
+                                       opCtx->getServiceContext()->getFastClockSource(),
+                                       internalQueryExecYieldIterations.load(),
+                                       Milliseconds{internalQueryExecYieldPeriodMS.load()});
+        for (auto ix : group) {
+            (*candidates)[ix].root->attachNewYieldPolicy(&yieldPolicy);
+        }
+
+        auto status = Status::OK();
+        try {
+            if (MONGO_unlikely(sbeTrialRunPoolThreadLockTimeout.shouldFail())) {
+                uasserted(ErrorCodes::LockTimeout, "Failing the trial run pool thread");
+            }
+
+            openGroup(opCtx, group);
+            for (size_t round = 0;; ++round) {
+                {
+                    stdx::unique_lock<Latch> lk(state.mutex);
+                    state.roundStarted.wait(
+                        lk, [&] { return state.stop || state.numRounds > round; });
+                    if (state.stop) {
+                        break;
+                    }
+                }
+
+                hangSBETrialRunPoolThreadBeforeRound.pauseWhileSet();
+                checkForParentInterrupt();
+                opCtx->checkForInterrupt();
+
+                size_t numFailures{0};
+                auto done = runTrialRound(candidates, slots, group, true, &numFailures);
+                {
+                    stdx::lock_guard<Latch> lk(state.mutex);
+                    state.done |= done;
+                    state.numFailures += numFailures;
+                    ++state.numFinished;
+                }
+                state.roundFinished.notify_one();
+            }
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        // Release the locks and the storage snapshot of this thread, so that the plans can be
+        // restored on the calling thread.
+        for (auto ix : group) {
+            auto& root = (*candidates)[ix].root;
+            root->saveState();
+            root->attachNewYieldPolicy(_yieldPolicy);
+            root->detachFromOperationContext();
+        }
+
+        if (!status.isOK()) {
+            {
+                stdx::lock_guard<Latch> lk(state.mutex);
+                state.stop = true;
+            }
+            state.roundFinished.notify_one();
+            uassertStatusOK(status);
+        }
+    };
+
+    std::vector<Future<void>> futures;
+    for (size_t threadIdx = 1; threadIdx < groups.size(); ++threadIdx) {
+        auto pf = makePromiseFuture<void>();
+        trialRunThreadPool->schedule(
+            [&, threadIdx, promise = std::move(pf.promise)](auto status) mutable {
+                invariant(status);
+
+                auto opCtx = cc().makeOperationContext();
+                promise.setWith([&] { runPoolThread(opCtx.get(), groups[threadIdx]); });
+            });
+        futures.push_back(std::move(pf.future));
+    }
+
+    size_t numFailures{0};
+    auto status = Status::OK();
+    try {
+        openGroup(_opCtx, groups[0]);
+
+        const auto maxNumResults{trial_period::getTrialPeriodNumToReturn(_cq)};
+        for (size_t round = 0; round < maxNumResults; ++round) {
+            {
+                stdx::lock_guard<Latch> lk(state.mutex);
+                state.numFinished = 0;
+                ++state.numRounds;
+            }
+            state.roundStarted.notify_all();
+
+            auto done = runTrialRound(candidates, slots, groups[0], false, &numFailures);
+
+            stdx::unique_lock<Latch> lk(state.mutex);
+            _opCtx->waitForConditionOrInterrupt(state.roundFinished, lk, [&] {
+                return state.stop || state.numFinished == numThreads;
+            });
+            if (state.stop) {
+                // A pool thread has failed, its error is reported by its future.
+                break;
+            }
+            if (done || state.done || numFailures + state.numFailures == candidates->size()) {
+                break;
+            }
+        }
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+
+    {
+        stdx::lock_guard<Latch> lk(state.mutex);
+        state.stop = true;
+    }
+    state.roundStarted.notify_all();
+
+    // Wait for all pool threads to hand their plans back before reporting any error, as the pool
+    // threads reference the candidates.
+    auto lockTimedOut{false};
+    for (auto&& future : futures) {
+        auto threadStatus = future.getNoThrow();
+        if (threadStatus == ErrorCodes::LockTimeout) {
+            lockTimedOut = true;
+        } else if (status.isOK()) {
+            status = threadStatus;
+        }
+    }
+    uassertStatusOK(status);
+
+    if (lockTimedOut) {
+        // A pool thread could not get its locks, possibly because an exclusive lock request is
+        // queued behind the locks of this operation. The operation itself is fine, so the caller
+        // runs the trial period again on this thread.
+        return boost::none;
+    }
+
+    for (size_t threadIdx = 1; threadIdx < groups.size(); ++threadIdx) {
+        for (auto ix : groups[threadIdx]) {
+            auto& root = (*candidates)[ix].root;
+            root->attachFromOperationContext(_opCtx);
+            root->restoreState();
+        }
+    }
+
+    return numFailures + state.numFailures;
+}
+
 std::vector<plan_ranker::CandidatePlan> BaseRuntimePlanner::collectExecutionStats(
     std::vector<std::unique_ptr<QuerySolution>> solutions,
     std::vector<std::pair<std::unique_ptr<PlanStage>, stage_builder::PlanStageData>> roots) {
     invariant(solutions.size() == roots.size());
 
     std::vector<plan_ranker::CandidatePlan> candidates;
-    std::vector<std::pair<sbe::value::SlotAccessor*, sbe::value::SlotAccessor*>> slots;
+    size_t numFailures{0};
 
-    for (size_t ix = 0; ix < roots.size(); ++ix) {
-        auto&& [root, data] = roots[ix];
-        auto [resultSlot, recordIdSlot, exitedEarly] = prepareExecutionPlan(root.get(), &data);
+    if (auto numThreads = getNumTrialRunThreads(roots.size()); numThreads > 0) {
+        for (size_t ix = 0; ix < roots.size(); ++ix) {
+            auto&& [root, data] = roots[ix];
+            candidates.push_back({std::move(solutions[ix]), std::move(root), std::move(data)});
+        }
 
-        candidates.push_back(
-            {std::move(solutions[ix]), std::move(root), std::move(data), exitedEarly});
-        slots.push_back({resultSlot, recordIdSlot});
-    }
+        if (auto threadsNumFailures = collectExecutionStatsConcurrently(&candidates, numThreads)) {
+            numFailures = *threadsNumFailures;
+        } else {
+            LOGV2_DEBUG(4798625,
+                        1,
+                        "A trial run pool thread timed out waiting for a lock, running the trial "
+                        "period on the thread of the operation",
+                        "query"_attr = redact(_cq.toStringShort()));
 
-    auto done{false};
-    size_t numFailures{0};
-    const auto maxNumResults{trial_period::getTrialPeriodNumToReturn(_cq)};
-    for (size_t it = 0; it < maxNumResults && !done; ++it) {
-        for (size_t ix = 0; ix < candidates.size(); ++ix) {
-            // Even if we had a candidate plan that exited early, we still want continue the trial
-            // run as the early exited plan may not be the best. E.g., it could be blocked in a SORT
-            // stage until one of the trial period metrics was reached, causing the plan to raise an
-            // early exit exception and return control back to the runtime planner. If that happens,
-            // we need to continue and complete the trial period for all candidates, as some of them
-            // may have a better cost.
-            if (candidates[ix].failed || candidates[ix].exitedEarly) {
-                continue;
+            // The candidates have already been partly run, so they are rebuilt from their
+            // solutions to collect the execution stats from scratch.
+            solutions.clear();
+            for (auto&& candidate : candidates) {
+                solutions.push_back(std::move(candidate.solution));
+            }
+            candidates.clear();
+
+            roots.clear();
+            for (auto&& solution : solutions) {
+                roots.push_back(stage_builder::buildSlotBasedExecutableTree(
+                    _opCtx, _collection, _cq, *solution, _yieldPolicy, true));
             }
+        }
+    }
 
-            done |= fetchNextDocument(&candidates[ix], slots[ix], &numFailures) ||
-                (numFailures == candidates.size());
+    if (candidates.empty()) {
+        std::vector<std::pair<sbe::value::SlotAccessor*, sbe::value::SlotAccessor*>> slots;
+
+        for (size_t ix = 0; ix < roots.size(); ++ix) {
+            auto&& [root, data] = roots[ix];
+            auto [resultSlot, recordIdSlot, exitedEarly] =
+                prepareExecutionPlan(root.get(), &data);
+
+            candidates.push_back(
+                {std::move(solutions[ix]), std::move(root), std::move(data), exitedEarly});
+            slots.push_back({resultSlot, recordIdSlot});
+        }
+
+        auto done{false};
+        const auto maxNumResults{trial_period::getTrialPeriodNumToReturn(_cq)};
+        for (size_t it = 0; it < maxNumResults && !done; ++it) {
+            for (size_t ix = 0; ix < candidates.size(); ++ix) {
+                // Even if we had a candidate plan that exited early, we still want continue the
+                // trial run as the early exited plan may not be the best. E.g., it could be
+                // blocked in a SORT stage until one of the trial period metrics was reached,
+                // causing the plan to raise an early exit exception and return control back to
+                // the runtime planner. If that happens, we need to continue and complete the
+                // trial period for all candidates, as some of them may have a better cost.
+                if (candidates[ix].failed || candidates[ix].exitedEarly) {
+                    continue;
+                }
+
+                done |= fetchNextDocument(&candidates[ix], slots[ix], &numFailures) ||
+                    (numFailures == candidates.size());
+            }
         }
     }
 
@@ -94,6 +94,28 @@ protected:
         std::vector<std::unique_ptr<QuerySolution>> solutions,
         std::vector<std::pair<std::unique_ptr<PlanStage>, stage_builder::PlanStageData>> roots);
 
+private:
+    /**
+     * Returns the number of pool threads, in addition to the calling thread, which the trial run of
+     * 'numCandidates' plans may use, or 0 if the trial run must be done on the calling thread.
+     */
+    size_t getNumTrialRunThreads(size_t numCandidates) const;
+
+    /**
+     * Runs the trial period of the given 'candidates' in the same rounds as the round-robin trial
+     * run, but splits the candidates between the calling thread and 'numThreads' pool threads,
+     * each with its own operation context and storage snapshot. Every round fetches one document
+     * from each candidate, and all threads finish a round before the next one starts, so the
+     * collected execution stats are the same as if the candidates were run in turns on one thread.
+     *
+     * The candidate plans must not have been opened yet. Once the trial period is over, all plans
+     * are attached back to '_opCtx'. Returns the number of candidates which failed, or boost::none
+     * if a pool thread timed out waiting for a lock, in which case the partly run candidates must
+     * be discarded.
+     */
+    boost::optional<size_t> collectExecutionStatsConcurrently(
+        std::vector<plan_ranker::CandidatePlan>* candidates, size_t numThreads);
+
     OperationContext* const _opCtx;
     const Collection* const _collection;
     const CanonicalQuery& _cq;
@@ -51,9 +51,24 @@
 #include "mongo/db/query/sbe_stage_builder_coll_scan.h"
 #include "mongo/db/query/sbe_stage_builder_filter.h"
 #include "mongo/db/query/sbe_stage_builder_index_scan.h"
+#include "mongo/db/query/sbe_stage_builder_lookup.h"
 #include "mongo/db/query/sbe_stage_builder_projection.h"
 
 namespace mongo::stage_builder {
+namespace {
+/**
+ * Returns the memory limit for the hash aggregation stages used by the given query. The limit is
+ * only enforced if the query allows to use disk, in which case the stage spills to disk instead of
+ * growing its hash table any further.
+ */
+boost::optional<size_t> getHashAggMemoryLimit(const CanonicalQuery& cq) {
+    if (!cq.getExpCtx()->allowDiskUse) {
+        return boost::none;
+    }
+    return static_cast<size_t>(internalDocumentSourceGroupMaxMemoryBytes.load());
+}
+}  // namespace
+
 std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::buildCollScan(
     const QuerySolutionNode* root) {
     auto csn = static_cast<const CollectionScanNode*>(root);
@@ -339,8 +354,11 @@ std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::buildOr(const QuerySoluti
                                              sbe::makeSV(*_data.resultSlot, *_data.recordIdSlot));
 
     if (orn->dedup) {
-        stage = sbe::makeS<sbe::HashAggStage>(
-            std::move(stage), sbe::makeSV(*_data.recordIdSlot), sbe::makeEM());
+        stage = sbe::makeS<sbe::HashAggStage>(std::move(stage),
+                                              sbe::makeSV(*_data.recordIdSlot),
+                                              sbe::makeEM(),
+                                              _cq.getExpCtx()->allowDiskUse,
+                                              getHashAggMemoryLimit(_cq));
     }
 
     if (orn->filter) {
@@ -421,8 +439,11 @@ std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::buildText(const QuerySolu
     // TODO: If text score metadata is requested, then we should sum over the text scores inside the
     // index keys for a given document. This will require expression evaluation to be able to
     // extract the score directly from the key string.
-    auto hashAggStage = sbe::makeS<sbe::HashAggStage>(
-        std::move(unionStage), sbe::makeSV(*_data.recordIdSlot), sbe::makeEM());
+    auto hashAggStage = sbe::makeS<sbe::HashAggStage>(std::move(unionStage),
+                                                      sbe::makeSV(*_data.recordIdSlot),
+                                                      sbe::makeEM(),
+                                                      _cq.getExpCtx()->allowDiskUse,
+                                                      getHashAggMemoryLimit(_cq));
 
     auto nljStage = makeLoopJoinForFetch(std::move(hashAggStage), *_data.recordIdSlot);
 
@@ -464,6 +485,33 @@ std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::buildReturnKey(
     return stage;
 }
 
+std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::buildEqLookups(
+    std::unique_ptr<sbe::PlanStage> stage) {
+    uassert(4822890, "Result slot is not defined", _data.resultSlot);
+
+    sbe::value::SlotVector slotsToForward;
+    if (_data.recordIdSlot) {
+        slotsToForward.push_back(*_data.recordIdSlot);
+    }
+    if (_data.oplogTsSlot) {
+        slotsToForward.push_back(*_data.oplogTsSlot);
+    }
+
+    for (auto&& lookup : _cq.getEqLookupPushdowns()) {
+        auto [resultSlot, lookupStage] = generateEqLookup(_opCtx,
+                                                          std::move(stage),
+                                                          *_data.resultSlot,
+                                                          lookup,
+                                                          slotsToForward,
+                                                          &_slotIdGenerator,
+                                                          _yieldPolicy,
+                                                          _data.trialRunProgressTracker.get());
+        _data.resultSlot = resultSlot;
+        stage = std::move(lookupStage);
+    }
+    return stage;
+}
+
 // Returns a non-null pointer to the root of a plan tree, or a non-OK status if the PlanStage tree
 // could not be constructed.
 std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::build(const QuerySolutionNode* root) {
@@ -489,6 +537,10 @@ std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::build(const QuerySolution
             str::stream() << "Can't build exec tree for node: " << root->toString(),
             kStageBuilders.find(root->getType()) != kStageBuilders.end());
 
-    return std::invoke(kStageBuilders.at(root->getType()), *this, root);
+    auto stage = std::invoke(kStageBuilders.at(root->getType()), *this, root);
+    if (root == _solution.root.get() && !_cq.getEqLookupPushdowns().empty()) {
+        stage = buildEqLookups(std::move(stage));
+    }
+    return stage;
 }
 }  // namespace mongo::stage_builder
@@ -109,6 +109,10 @@ private:
     std::unique_ptr<sbe::PlanStage> buildText(const QuerySolutionNode* root);
     std::unique_ptr<sbe::PlanStage> buildReturnKey(const QuerySolutionNode* root);
 
+    // Joins the results of the plan rooted at 'stage' with the foreign collections of the $lookup
+    // stages pushed down into the query.
+    std::unique_ptr<sbe::PlanStage> buildEqLookups(std::unique_ptr<sbe::PlanStage> stage);
+
     std::unique_ptr<sbe::PlanStage> makeLoopJoinForFetch(
         std::unique_ptr<sbe::PlanStage> inputStage,
         sbe::value::SlotId recordIdKeySlot,
@@ -41,8 +41,10 @@
 #include "mongo/db/exec/sbe/stages/loop_join.h"
 #include "mongo/db/exec/sbe/stages/project.h"
 #include "mongo/db/exec/sbe/stages/scan.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/sbe_stage_builder_filter.h"
 #include "mongo/db/query/util/make_data_structure.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/str.h"
@@ -255,6 +257,78 @@ generateOptimizedOplogScan(OperationContext* opCtx,
             std::move(stage)};
 }
 
+/**
+ * Checks whether a collection scan described by 'csn' can be executed as a parallel scan with the
+ * given degree of parallelism. A parallel scan does not preserve the natural order of the
+ * collection and its producers run under their own operation contexts, so it is only used for
+ * plain forward scans over non-capped, non-oplog collections which are not part of a
+ * multi-document transaction, and never during a trial run of the runtime planner.
+ *
+ * The producers inherit the deadline of the operation and stop when it is killed, but they open
+ * storage snapshots of their own. So the scan must also read the latest data without a timestamp,
+ * as each producer then does, rather than from a snapshot chosen by the read concern.
+ */
+bool canUseParallelCollScan(OperationContext* opCtx,
+                            const Collection* collection,
+                            const CollectionScanNode* csn,
+                            TrialRunProgressTracker* tracker,
+                            int dop) {
+    const auto readSource = opCtx->recoveryUnit()->getTimestampReadSource();
+    const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
+    return dop > 1 && !tracker && !opCtx->inMultiDocumentTransaction() &&
+        (readSource == RecoveryUnit::ReadSource::kUnset ||
+         readSource == RecoveryUnit::ReadSource::kNoTimestamp) &&
+        (readConcernLevel == repl::ReadConcernLevel::kLocalReadConcern ||
+         readConcernLevel == repl::ReadConcernLevel::kAvailableReadConcern) &&
+        csn->direction == CollectionScanParams::FORWARD && !csn->resumeAfterRecordId &&
+        !csn->requestResumeToken && !csn->shouldTrackLatestOplogTimestamp &&
+        !csn->shouldWaitForOplogVisibility && !collection->isCapped() &&
+        !collection->ns().isOplog();
+}
+
+/**
+ * Generates a parallel collection scan sub-tree. The collection is split into RecordId ranges which
+ * are handed out to 'dop' producer threads, each running its own copy of the scan (and the filter,
+ * if any). The results from all producers are merged by an exchange consumer:
+ *
+ *   exchange [resultSlot, recordIdSlot] dop round
+ *       filter <predicate>
+ *       pscan resultSlot recordIdSlot @coll
+ */
+std::tuple<sbe::value::SlotId,
+           sbe::value::SlotId,
+           boost::optional<sbe::value::SlotId>,
+           std::unique_ptr<sbe::PlanStage>>
+generateParallelCollScan(const Collection* collection,
+                         const CollectionScanNode* csn,
+                         sbe::value::SlotIdGenerator* slotIdGenerator,
+                         int dop) {
+    auto resultSlot = slotIdGenerator->generate();
+    auto recordIdSlot = slotIdGenerator->generate();
+
+    NamespaceStringOrUUID nss{collection->ns().db().toString(), collection->uuid()};
+    std::unique_ptr<sbe::PlanStage> stage =
+        sbe::makeS<sbe::ParallelScanStage>(nss,
+                                           resultSlot,
+                                           recordIdSlot,
+                                           std::vector<std::string>{},
+                                           sbe::makeSV(),
+                                           nullptr /* yieldPolicy */);
+
+    if (csn->filter) {
+        stage = generateFilter(csn->filter.get(), std::move(stage), slotIdGenerator, resultSlot);
+    }
+
+    stage = sbe::makeS<sbe::ExchangeConsumer>(std::move(stage),
+                                              dop,
+                                              sbe::makeSV(resultSlot, recordIdSlot),
+                                              sbe::ExchangePolicy::roundrobin,
+                                              nullptr,
+                                              nullptr);
+
+    return {resultSlot, recordIdSlot, boost::none, std::move(stage)};
+}
+
 /**
  * Generates a generic collecion scan sub-tree. If a resume token has been provided, the scan will
  * start from a RecordId contained within this token, otherwise from the beginning of the
@@ -352,6 +426,9 @@ generateCollScan(OperationContext* opCtx,
         if (csn->minTs || csn->maxTs) {
             return generateOptimizedOplogScan(
                 opCtx, collection, csn, slotIdGenerator, yieldPolicy, tracker);
+        } else if (auto dop = internalQueryDefaultDOP.load();
+                   canUseParallelCollScan(opCtx, collection, csn, tracker, dop)) {
+            return generateParallelCollScan(collection, csn, slotIdGenerator, dop);
         } else {
             return generateGenericCollScan(collection, csn, slotIdGenerator, yieldPolicy, tracker);
         }
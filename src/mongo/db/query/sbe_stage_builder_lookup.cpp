@@ -0,0 +1,329 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/sbe_stage_builder_lookup.h"
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/sbe/stages/branch.h"
+#include "mongo/db/exec/sbe/stages/co_scan.h"
+#include "mongo/db/exec/sbe/stages/filter.h"
+#include "mongo/db/exec/sbe/stages/hash_agg.h"
+#include "mongo/db/exec/sbe/stages/ix_scan.h"
+#include "mongo/db/exec/sbe/stages/limit_skip.h"
+#include "mongo/db/exec/sbe/stages/loop_join.h"
+#include "mongo/db/exec/sbe/stages/makeobj.h"
+#include "mongo/db/exec/sbe/stages/project.h"
+#include "mongo/db/exec/sbe/stages/scan.h"
+#include "mongo/db/exec/sbe/stages/union.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/storage/key_string.h"
+
+namespace mongo::stage_builder {
+namespace {
+/**
+ * An index of the foreign collection which yields all matches of a non-array local value with a
+ * single equality seek.
+ */
+struct ForeignIndex {
+    UUID collectionUuid;
+    std::string indexName;
+    KeyString::Version keyStringVersion;
+};
+
+/**
+ * Looks for an ascending single-field index on the foreign field which has the simple collation
+ * and contains an entry for every document of the foreign collection.
+ */
+boost::optional<ForeignIndex> findForeignIndex(OperationContext* opCtx,
+                                               const EqLookupPushdown& lookup) {
+    AutoGetCollectionForRead autoColl(opCtx, lookup.foreignCollection);
+    auto collection = autoColl.getCollection();
+    if (!collection) {
+        return boost::none;
+    }
+
+    const auto keyPattern = BSON(lookup.foreignField << 1);
+    auto it = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (it->more()) {
+        auto entry = it->next();
+        auto descriptor = entry->descriptor();
+        if (descriptor->isSparse() || descriptor->isPartial() || entry->getCollator() ||
+            SimpleBSONObjComparator::kInstance.evaluate(descriptor->keyPattern() != keyPattern)) {
+            continue;
+        }
+
+        return ForeignIndex{
+            collection->uuid(),
+            descriptor->indexName(),
+            entry->accessMethod()->getSortedDataInterface()->getKeyStringVersion()};
+    }
+    return boost::none;
+}
+
+/**
+ * Reads the field 'fieldName' of the document in 'docSlot' into 'keySlot', failing on values which
+ * eqLookupMatch cannot compare.
+ */
+std::unique_ptr<sbe::PlanStage> makeLookupKeyProject(std::unique_ptr<sbe::PlanStage> stage,
+                                                     sbe::value::SlotId keySlot,
+                                                     sbe::value::SlotId docSlot,
+                                                     std::string_view fieldName) {
+    return sbe::makeProjectStage(
+        std::move(stage),
+        keySlot,
+        sbe::makeE<sbe::EFunction>("eqLookupKey",
+                                   sbe::makeEs(sbe::makeE<sbe::EVariable>(docSlot),
+                                               sbe::makeE<sbe::EConstant>(fieldName))));
+}
+
+std::unique_ptr<sbe::EExpression> makeMatchExpr(sbe::value::SlotId localSlot,
+                                                sbe::value::SlotId foreignSlot) {
+    return sbe::makeE<sbe::EFunction>("eqLookupMatch",
+                                      sbe::makeEs(sbe::makeE<sbe::EVariable>(localSlot),
+                                                  sbe::makeE<sbe::EVariable>(foreignSlot)));
+}
+
+/**
+ * Builds a scan of the foreign collection which produces, in the returned slot, the foreign
+ * documents matching the local value in 'localSlot'.
+ */
+std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateForeignScan(
+    const EqLookupPushdown& lookup,
+    sbe::value::SlotId localSlot,
+    sbe::value::SlotIdGenerator* slotIdGenerator,
+    PlanYieldPolicy* yieldPolicy,
+    TrialRunProgressTracker* tracker) {
+    auto foreignDocSlot = slotIdGenerator->generate();
+    auto foreignFieldSlot = slotIdGenerator->generate();
+
+    auto scan = makeLookupKeyProject(
+        sbe::makeS<sbe::ScanStage>(NamespaceStringOrUUID{lookup.foreignCollection},
+                                   foreignDocSlot,
+                                   boost::none,
+                                   std::vector<std::string>{},
+                                   sbe::makeSV(),
+                                   boost::none,
+                                   true,
+                                   yieldPolicy,
+                                   tracker),
+        foreignFieldSlot,
+        foreignDocSlot,
+        lookup.foreignField);
+
+    return {foreignDocSlot,
+            sbe::makeS<sbe::FilterStage<false>>(std::move(scan),
+                                                makeMatchExpr(localSlot, foreignFieldSlot))};
+}
+
+/**
+ * Builds an equality seek into 'index' for the non-array local value in 'localSlot', followed by a
+ * fetch of the foreign documents, which are produced in the returned slot. A missing local value
+ * seeks the null key, under which the index also stores the documents missing the foreign field.
+ */
+std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateForeignIndexSeek(
+    const EqLookupPushdown& lookup,
+    const ForeignIndex& index,
+    sbe::value::SlotId localSlot,
+    sbe::value::SlotIdGenerator* slotIdGenerator,
+    PlanYieldPolicy* yieldPolicy,
+    TrialRunProgressTracker* tracker) {
+    auto lowKeySlot = slotIdGenerator->generate();
+    auto highKeySlot = slotIdGenerator->generate();
+    auto makeSeekKey = [&](KeyString::Discriminator discriminator) {
+        return sbe::makeE<sbe::EFunction>(
+            "ks",
+            sbe::makeEs(
+                sbe::makeE<sbe::EConstant>(
+                    sbe::value::TypeTags::NumberInt64,
+                    sbe::value::bitcastFrom(static_cast<int64_t>(index.keyStringVersion))),
+                sbe::makeE<sbe::EConstant>(sbe::value::TypeTags::NumberInt32,
+                                           sbe::value::bitcastFrom(1)),
+                sbe::makeE<sbe::EFunction>(
+                    "fillEmpty",
+                    sbe::makeEs(sbe::makeE<sbe::EVariable>(localSlot),
+                                sbe::makeE<sbe::EConstant>(sbe::value::TypeTags::Null, 0))),
+                sbe::makeE<sbe::EConstant>(
+                    sbe::value::TypeTags::NumberInt64,
+                    sbe::value::bitcastFrom(static_cast<int64_t>(discriminator)))));
+    };
+
+    // Compute the seek keys for the interval [local, local] from the correlated local value.
+    auto project = sbe::makeProjectStage(
+        sbe::makeS<sbe::LimitSkipStage>(sbe::makeS<sbe::CoScanStage>(), 1, boost::none),
+        lowKeySlot,
+        makeSeekKey(KeyString::Discriminator::kExclusiveBefore),
+        highKeySlot,
+        makeSeekKey(KeyString::Discriminator::kExclusiveAfter));
+
+    auto recordIdSlot = slotIdGenerator->generate();
+    auto ixscan = sbe::makeS<sbe::IndexScanStage>(
+        NamespaceStringOrUUID{lookup.foreignCollection.db().toString(), index.collectionUuid},
+        index.indexName,
+        true,
+        boost::none,
+        recordIdSlot,
+        sbe::IndexKeysInclusionSet{},
+        sbe::makeSV(),
+        lowKeySlot,
+        highKeySlot,
+        yieldPolicy,
+        tracker);
+
+    auto seek = sbe::makeS<sbe::LoopJoinStage>(std::move(project),
+                                               std::move(ixscan),
+                                               sbe::makeSV(),
+                                               sbe::makeSV(lowKeySlot, highKeySlot),
+                                               nullptr);
+
+    // Fetch the foreign documents. They are matched against the local value once more, so that the
+    // index seek and the scan agree on what a match is.
+    auto foreignDocSlot = slotIdGenerator->generate();
+    auto foreignFieldSlot = slotIdGenerator->generate();
+    auto fetch = sbe::makeS<sbe::ScanStage>(
+        NamespaceStringOrUUID{lookup.foreignCollection.db().toString(), index.collectionUuid},
+        foreignDocSlot,
+        boost::none,
+        std::vector<std::string>{},
+        sbe::makeSV(),
+        recordIdSlot,
+        true,
+        nullptr,
+        tracker);
+
+    auto join = sbe::makeS<sbe::LoopJoinStage>(
+        std::move(seek),
+        makeLookupKeyProject(sbe::makeS<sbe::LimitSkipStage>(std::move(fetch), 1, boost::none),
+                             foreignFieldSlot,
+                             foreignDocSlot,
+                             lookup.foreignField),
+        sbe::makeSV(),
+        sbe::makeSV(recordIdSlot),
+        nullptr);
+
+    return {foreignDocSlot,
+            sbe::makeS<sbe::FilterStage<false>>(std::move(join),
+                                                makeMatchExpr(localSlot, foreignFieldSlot))};
+}
+}  // namespace
+
+std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateEqLookup(
+    OperationContext* opCtx,
+    std::unique_ptr<sbe::PlanStage> inputStage,
+    sbe::value::SlotId inputSlot,
+    const EqLookupPushdown& lookup,
+    const sbe::value::SlotVector& slotsToForward,
+    sbe::value::SlotIdGenerator* slotIdGenerator,
+    PlanYieldPolicy* yieldPolicy,
+    TrialRunProgressTracker* tracker) {
+    // Extract the local value of each input document, to be correlated with the foreign side.
+    auto localSlot = slotIdGenerator->generate();
+    auto outerStage =
+        makeLookupKeyProject(std::move(inputStage), localSlot, inputSlot, lookup.localField);
+
+    auto [foreignDocSlot, foreignStage] =
+        generateForeignScan(lookup, localSlot, slotIdGenerator, yieldPolicy, tracker);
+
+    // An array local value needs a seek per element, so only the other values use the index.
+    if (auto index = findForeignIndex(opCtx, lookup)) {
+        auto [seekDocSlot, seekStage] = generateForeignIndexSeek(
+            lookup, *index, localSlot, slotIdGenerator, yieldPolicy, tracker);
+
+        auto branchDocSlot = slotIdGenerator->generate();
+        foreignStage = sbe::makeS<sbe::BranchStage>(
+            std::move(foreignStage),
+            std::move(seekStage),
+            sbe::makeE<sbe::EFunction>("isArray",
+                                       sbe::makeEs(sbe::makeE<sbe::EVariable>(localSlot))),
+            sbe::makeSV(foreignDocSlot),
+            sbe::makeSV(seekDocSlot),
+            sbe::makeSV(branchDocSlot));
+        foreignDocSlot = branchDocSlot;
+    }
+
+    auto asSlot = foreignDocSlot;
+    if (!lookup.unwind) {
+        // Collect the matches into an array. The hash aggregation produces no group without
+        // matches, in which case the union falls through to an empty array.
+        auto matchesSlot = slotIdGenerator->generate();
+        auto groupStage = sbe::makeS<sbe::HashAggStage>(
+            std::move(foreignStage),
+            sbe::makeSV(),
+            sbe::makeEM(matchesSlot,
+                        sbe::makeE<sbe::EFunction>(
+                            "addToArray",
+                            sbe::makeEs(sbe::makeE<sbe::EVariable>(foreignDocSlot)))));
+
+        auto emptySlot = slotIdGenerator->generate();
+        auto [emptyTag, emptyVal] = sbe::value::makeNewArray();
+        auto emptyStage = sbe::makeProjectStage(
+            sbe::makeS<sbe::LimitSkipStage>(sbe::makeS<sbe::CoScanStage>(), 1, boost::none),
+            emptySlot,
+            sbe::makeE<sbe::EConstant>(emptyTag, emptyVal));
+
+        asSlot = slotIdGenerator->generate();
+        std::vector<std::unique_ptr<sbe::PlanStage>> branches;
+        branches.push_back(std::move(groupStage));
+        branches.push_back(std::move(emptyStage));
+        foreignStage = sbe::makeS<sbe::LimitSkipStage>(
+            sbe::makeS<sbe::UnionStage>(std::move(branches),
+                                        std::vector<sbe::value::SlotVector>{
+                                            sbe::makeSV(matchesSlot), sbe::makeSV(emptySlot)},
+                                        sbe::makeSV(asSlot)),
+            1,
+            boost::none);
+    }
+
+    // Without an unwind, every input document joins with exactly one row of the inner side.
+    // Otherwise, an input document without matches produces no results, as with an $unwind which
+    // does not preserve null and empty arrays.
+    auto outerProjects = slotsToForward;
+    outerProjects.push_back(inputSlot);
+    auto join = sbe::makeS<sbe::LoopJoinStage>(std::move(outerStage),
+                                               std::move(foreignStage),
+                                               std::move(outerProjects),
+                                               sbe::makeSV(localSlot),
+                                               nullptr);
+
+    auto resultSlot = slotIdGenerator->generate();
+    return {resultSlot,
+            sbe::makeS<sbe::MakeObjStage>(std::move(join),
+                                          resultSlot,
+                                          inputSlot,
+                                          std::vector<std::string>{},
+                                          std::vector<std::string>{lookup.asField},
+                                          sbe::makeSV(asSlot),
+                                          true,
+                                          false)};
+}
+}  // namespace mongo::stage_builder
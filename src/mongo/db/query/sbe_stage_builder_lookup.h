@@ -0,0 +1,58 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/exec/sbe/stages/stages.h"
+#include "mongo/db/exec/sbe/values/id_generators.h"
+#include "mongo/db/exec/trial_run_progress_tracker.h"
+#include "mongo/db/query/canonical_query.h"
+
+namespace mongo::stage_builder {
+/**
+ * Generates an SBE plan stage sub-tree which joins every document produced by 'inputStage' in
+ * 'inputSlot' with the documents of the foreign collection of 'lookup', as the $lookup stage
+ * described by 'lookup' would. The slots in 'slotsToForward' remain visible above the join.
+ *
+ * The matches are found with a seek into a suitable index on the foreign field when the local
+ * value is not an array, and with a filtered scan of the foreign collection otherwise.
+ *
+ * On success, a pair containing the slot to access the joined documents (a resultSlot) and the
+ * generated PlanStage sub-tree is returned. In cases of an error, throws.
+ */
+std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateEqLookup(
+    OperationContext* opCtx,
+    std::unique_ptr<sbe::PlanStage> inputStage,
+    sbe::value::SlotId inputSlot,
+    const EqLookupPushdown& lookup,
+    const sbe::value::SlotVector& slotsToForward,
+    sbe::value::SlotIdGenerator* slotIdGenerator,
+    PlanYieldPolicy* yieldPolicy,
+    TrialRunProgressTracker* tracker);
+}  // namespace mongo::stage_builder
@@ -35,6 +35,7 @@ namespace mongo {
  * These map to implementations of the PlanStage interface, all of which live in db/exec/
  */
 enum StageType {
+    STAGE_AND_BITMAP,
     STAGE_AND_HASH,
     STAGE_AND_SORTED,
     STAGE_CACHED_PLAN,
@@ -77,6 +78,7 @@ enum StageType {
 
     STAGE_MULTI_PLAN,
     STAGE_OR,
+    STAGE_OR_BITMAP,
 
     // Projection has three alternate implementations.
     STAGE_PROJECTION_DEFAULT,
@@ -109,6 +109,13 @@ Status CollectionBulkLoaderImpl::init(const std::vector<BSONObj>& secondaryIndex
             _idIndexBlock.reset();
         }
 
+        // Only uncapped collections, which are inserted into without updating the indexes of the
+        // collection, can be bulk loaded.
+        if (collectionBulkLoaderUseRecordStoreBulkLoad &&
+            (_idIndexBlock || _secondaryIndexesBlock)) {
+            _recordStoreBulkLoader = coll->getRecordStore()->makeBulkLoader(_opCtx.get());
+        }
+
         return Status::OK();
     });
 }
@@ -119,32 +126,39 @@ Status CollectionBulkLoaderImpl::_insertDocumentsForUncappedCollection(
     auto iter = begin;
     while (iter != end) {
         std::vector<RecordId> locs;
-        Status status = writeConflictRetry(
-            _opCtx.get(), "CollectionBulkLoaderImpl/insertDocumentsUncapped", _nss.ns(), [&] {
-                WriteUnitOfWork wunit(_opCtx.get());
-                auto insertIter = iter;
-                int bytesInBlock = 0;
-                locs.clear();
+        auto insertBatch = [&] {
+            WriteUnitOfWork wunit(_opCtx.get());
+            auto insertIter = iter;
+            int bytesInBlock = 0;
+            locs.clear();
 
-                auto onRecordInserted = [&](const RecordId& location) {
-                    locs.emplace_back(location);
-                    return Status::OK();
-                };
-
-                while (insertIter != end && bytesInBlock < collectionBulkLoaderBatchSizeInBytes) {
-                    const auto& doc = *insertIter++;
-                    bytesInBlock += doc.objsize();
-                    // This version of insert will not update any indexes.
-                    const auto status = _autoColl->getCollection()->insertDocumentForBulkLoader(
-                        _opCtx.get(), doc, onRecordInserted);
-                    if (!status.isOK()) {
-                        return status;
-                    }
+            auto onRecordInserted = [&](const RecordId& location) {
+                locs.emplace_back(location);
+                return Status::OK();
+            };
+
+            while (insertIter != end && bytesInBlock < collectionBulkLoaderBatchSizeInBytes) {
+                const auto& doc = *insertIter++;
+                bytesInBlock += doc.objsize();
+                // This version of insert will not update any indexes.
+                const auto status = _autoColl->getCollection()->insertDocumentForBulkLoader(
+                    _opCtx.get(), doc, onRecordInserted, _recordStoreBulkLoader.get());
+                if (!status.isOK()) {
+                    return status;
                 }
+            }
 
-                wunit.commit();
-                return Status::OK();
-            });
+            wunit.commit();
+            return Status::OK();
+        };
+
+        // Records appended by the bulk loader can't be rolled back, so the batch can't be retried.
+        Status status = _recordStoreBulkLoader
+            ? insertBatch()
+            : writeConflictRetry(_opCtx.get(),
+                                 "CollectionBulkLoaderImpl/insertDocumentsUncapped",
+                                 _nss.ns(),
+                                 insertBatch);
 
         if (!status.isOK()) {
             return status;
@@ -219,6 +233,9 @@ Status CollectionBulkLoaderImpl::commit() {
                     "namespace"_attr = _nss.ns());
         UnreplicatedWritesBlock uwb(_opCtx.get());
 
+        // Finish the bulk load, so that the documents are visible when deleting duplicates.
+        _recordStoreBulkLoader.reset();
+
         // Commit before deleting dups, so the dups will be removed from secondary indexes when
         // deleted.
         if (_secondaryIndexesBlock) {
@@ -331,6 +348,8 @@ Status CollectionBulkLoaderImpl::commit() {
 
 void CollectionBulkLoaderImpl::_releaseResources() {
     invariant(&cc() == _opCtx->getClient());
+    _recordStoreBulkLoader.reset();
+
     if (_secondaryIndexesBlock) {
         _secondaryIndexesBlock->abortIndexBuild(
             _opCtx.get(), _collection, MultiIndexBlock::kNoopOnCleanUpFn);
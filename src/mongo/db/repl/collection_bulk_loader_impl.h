@@ -92,7 +92,8 @@ private:
     /**
      * For uncapped collections, we will insert documents in batches of size
      * collectionBulkLoaderBatchSizeInBytes or up to one document size greater. All insertions in a
-     * given batch will be inserted in one WriteUnitOfWork.
+     * given batch will be inserted in one WriteUnitOfWork, or through '_recordStoreBulkLoader' if
+     * it is set.
      */
     Status _insertDocumentsForUncappedCollection(const std::vector<BSONObj>::const_iterator begin,
                                                  const std::vector<BSONObj>::const_iterator end);
@@ -109,6 +110,9 @@ private:
     NamespaceString _nss;
     std::unique_ptr<MultiIndexBlock> _idIndexBlock;
     std::unique_ptr<MultiIndexBlock> _secondaryIndexesBlock;
+    // Set if the documents of an uncapped collection are appended through the storage engine's
+    // bulk loading interface, until commit().
+    std::unique_ptr<RecordStoreBulkLoader> _recordStoreBulkLoader;
     BSONObj _idIndexSpec;
     Stats _stats;
 };
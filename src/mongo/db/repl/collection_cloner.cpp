@@ -377,11 +377,27 @@ void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
     }
     _firstBatchOfQueryRound = false;
 
+    // Stop reading from the sync source while too many documents are waiting to be inserted. The
+    // insert scheduled for each earlier batch takes all of them at once, so this does not wait
+    // longer than for one insert. A failed insert fails the initial sync instead.
+    while (!mustExit()) {
+        stdx::unique_lock<Latch> lk(_mutex);
+        const auto isBelowHighWaterMark = [&] {
+            return _documentsToInsertBytes <
+                static_cast<size_t>(collectionClonerMaxBufferedBytes.load());
+        };
+        if (_documentsToInsertTaken.wait_for(
+                lk, Seconds(1).toSystemDuration(), isBelowHighWaterMark)) {
+            break;
+        }
+    }
+
     {
         stdx::lock_guard<Latch> lk(_mutex);
         _stats.receivedBatches++;
         while (iter.moreInCurrentBatch()) {
             _documentsToInsert.emplace_back(iter.nextSafe());
+            _documentsToInsertBytes += _documentsToInsert.back().objsize();
         }
     }
 
@@ -425,9 +441,13 @@ void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
 void CollectionCloner::insertDocumentsCallback(const executor::TaskExecutor::CallbackArgs& cbd) {
     uassertStatusOK(cbd.status);
 
+    // Only one batch may be inserted at a time, because CollectionBulkLoader is not thread safe.
+    // Inserting under '_insertMutex' rather than '_mutex' lets the query thread keep buffering the
+    // next batch from the sync source while this one is being written.
+    stdx::lock_guard<Latch> insertLk(_insertMutex);
+    std::vector<BSONObj> docs;
     {
         stdx::lock_guard<Latch> lk(_mutex);
-        std::vector<BSONObj> docs;
         if (_documentsToInsert.size() == 0) {
             LOGV2_WARNING(21145,
                           "insertDocumentsCallback, but no documents to insert for ns:{namespace}",
@@ -436,16 +456,16 @@ void CollectionCloner::insertDocumentsCallback(const executor::TaskExecutor::Cal
             return;
         }
         _documentsToInsert.swap(docs);
+        _documentsToInsertBytes = 0;
+        _documentsToInsertTaken.notify_all();
         _stats.documentsCopied += docs.size();
         ++_stats.fetchedBatches;
         _progressMeter.hit(int(docs.size()));
-        invariant(_collLoader);
-
-        // The insert must be done within the lock, because CollectionBulkLoader is not
-        // thread safe.
-        uassertStatusOK(_collLoader->insertDocuments(docs.cbegin(), docs.cend()));
     }
 
+    invariant(_collLoader);
+    uassertStatusOK(_collLoader->insertDocuments(docs.cbegin(), docs.cend()));
+
     initialSyncHangDuringCollectionClone.executeIf(
         [&](const BSONObj&) {
             LOGV2(21138,
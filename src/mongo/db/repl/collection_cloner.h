@@ -34,6 +34,7 @@
 
 #include "mongo/db/repl/base_cloner.h"
 #include "mongo/db/repl/task_runner.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/progress_meter.h"
 
 namespace mongo {
@@ -252,10 +253,17 @@ private:
     std::vector<BSONObj> _unfinishedIndexSpecs;         // (X)
     BSONObj _idIndexSpec;                               // (X)
     std::unique_ptr<CollectionBulkLoader> _collLoader;  // (X)
+    // Serializes inserts into _collLoader from the database work threads. Never acquired while
+    // holding _mutex.
+    Mutex _insertMutex = MONGO_MAKE_LATCH("CollectionCloner::_insertMutex");  // (S)
     //  Function for scheduling database work using the executor.
     ScheduleDbWorkFn _scheduleDbWorkFn;  // (R)
     // Documents read from source to insert.
     std::vector<BSONObj> _documentsToInsert;  // (M)
+    // The total size of _documentsToInsert.
+    size_t _documentsToInsertBytes = 0;  // (M)
+    // Notified when the documents in _documentsToInsert are taken for insertion.
+    stdx::condition_variable _documentsToInsertTaken;  // (M)
     Stats _stats;                             // (M)
     // Putting _dbWorkTaskRunner last ensures anything the database work threads depend on,
     // like _documentsToInsert, is destroyed after those threads exit.
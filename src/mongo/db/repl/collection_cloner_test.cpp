@@ -34,12 +34,14 @@
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/db/repl/cloner_test_fixture.h"
 #include "mongo/db/repl/collection_cloner.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace repl {
@@ -472,6 +474,59 @@ TEST_F(CollectionClonerTestResumable, InsertDocumentsFailed) {
     clonerThread.join();
 }
 
+TEST_F(CollectionClonerTestResumable, InsertDocumentsWaitsForBufferedDocumentsToBeInserted) {
+    // Any buffered document reaches the high-water mark, so every batch must be inserted before
+    // the next one is read.
+    const auto originalMaxBufferedBytes = collectionClonerMaxBufferedBytes.load();
+    collectionClonerMaxBufferedBytes.store(1);
+    ON_BLOCK_EXIT([&] { collectionClonerMaxBufferedBytes.store(originalMaxBufferedBytes); });
+
+    // Set up data for preliminary stages
+    _mockServer->setCommandReply("count", createCountResponse(3));
+    _mockServer->setCommandReply("listIndexes",
+                                 createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+
+    // Set up documents to be returned from upstream node.
+    _mockServer->insert(_nss.ns(), BSON("_id" << 1));
+    _mockServer->insert(_nss.ns(), BSON("_id" << 2));
+    _mockServer->insert(_nss.ns(), BSON("_id" << 3));
+
+    auto cloner = makeCollectionCloner();
+    cloner->setBatchSize_forTest(1);
+
+    // Stop before running the query to slow down the inserts.
+    auto collClonerBeforeFailPoint = globalFailPointRegistry().find("hangBeforeClonerStage");
+    auto timesEntered = collClonerBeforeFailPoint->setMode(
+        FailPoint::alwaysOn,
+        0,
+        fromjson("{cloner: 'CollectionCloner', stage: 'query', nss: '" + _nss.ns() + "'}"));
+
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_OK(cloner->run());
+    });
+    collClonerBeforeFailPoint->waitForTimesEntered(timesEntered + 1);
+
+    std::vector<size_t> insertedBatchSizes;
+    ASSERT(_loader != nullptr);
+    _loader->insertDocsFn = [&](const std::vector<BSONObj>::const_iterator begin,
+                                const std::vector<BSONObj>::const_iterator end) {
+        sleepmillis(50);
+        insertedBatchSizes.push_back(std::distance(begin, end));
+        return Status::OK();
+    };
+
+    collClonerBeforeFailPoint->setMode(FailPoint::off, 0);
+    clonerThread.join();
+
+    ASSERT_EQUALS(3, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    ASSERT_EQUALS(3u, insertedBatchSizes.size());
+    for (auto batchSize : insertedBatchSizes) {
+        ASSERT_EQUALS(1u, batchSize);
+    }
+}
+
 TEST_F(CollectionClonerTestResumable, DoNotCreateIDIndexIfAutoIndexIdUsed) {
     NamespaceString collNss;
     CollectionOptions collOptions;
@@ -56,13 +56,14 @@ using OplogSlot = repl::OpTime;
 struct InsertStatement {
 public:
     InsertStatement() = default;
-    explicit InsertStatement(BSONObj toInsert) : doc(toInsert) {}
+    explicit InsertStatement(BSONObj toInsert) : doc(std::move(toInsert)) {}
 
-    InsertStatement(StmtId statementId, BSONObj toInsert) : stmtId(statementId), doc(toInsert) {}
+    InsertStatement(StmtId statementId, BSONObj toInsert)
+        : stmtId(statementId), doc(std::move(toInsert)) {}
     InsertStatement(StmtId statementId, BSONObj toInsert, OplogSlot os)
-        : stmtId(statementId), oplogSlot(os), doc(toInsert) {}
+        : stmtId(statementId), oplogSlot(os), doc(std::move(toInsert)) {}
     InsertStatement(BSONObj toInsert, Timestamp ts, long long term)
-        : oplogSlot(repl::OpTime(ts, term)), doc(toInsert) {}
+        : oplogSlot(repl::OpTime(ts, term)), doc(std::move(toInsert)) {}
 
     StmtId stmtId = kUninitializedStmtId;
     OplogSlot oplogSlot;
@@ -164,6 +164,13 @@ public:
 
     const Options& getOptions() const;
 
+    /**
+     * Called by the OplogBatcher with each non-empty batch once it has been formed, before it is
+     * handed over for application. Implementations may use this to warm up the storage engine
+     * cache for the batch. Must not block. The default implementation does nothing.
+     */
+    virtual void prefetchBatch(const std::vector<OplogEntry>& ops) {}
+
 private:
     /**
      * Called from startup() to run oplog application loop.
@@ -31,6 +31,7 @@
 
 #include "mongo/db/repl/oplog_applier_impl.h"
 
+#include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/database.h"
@@ -40,11 +41,13 @@
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/repl/apply_ops.h"
 #include "mongo/db/repl/insert_group.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
+#include "mongo/db/repl/update_delete_group.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/control/storage_control.h"
@@ -52,6 +55,7 @@
 #include "mongo/platform/basic.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log_with_sampling.h"
+#include "mongo/util/timer.h"
 #include "third_party/murmurhash3/MurmurHash3.h"
 
 namespace mongo {
@@ -96,6 +100,33 @@ NamespaceStringOrUUID getNsOrUUID(const NamespaceString& nss, const OplogEntry&
     return nss;
 }
 
+/**
+ * Looks up the target document of each update and delete in 'ops' through the _id index, faulting
+ * the index and record pages into the storage engine cache. This is best-effort: missing
+ * collections, documents and indexes, as well as any other errors, are ignored.
+ */
+void prefetchDocuments(OperationContext* opCtx, const std::vector<OplogEntry>& ops) {
+    // Prefetching reads data that is concurrently being written by batch application, so it must
+    // not wait for the ParallelBatchWriterMode lock the applier holds.
+    ShouldNotConflictWithSecondaryBatchApplicationBlock noPBWMBlock(opCtx->lockState());
+    for (auto&& op : ops) {
+        try {
+            AutoGetCollection autoColl(opCtx, getNsOrUUID(op.getNss(), op), MODE_IS);
+            auto collection = autoColl.getCollection();
+            if (!collection) {
+                continue;
+            }
+            auto recordId = Helpers::findById(opCtx, collection, BSON("_id" << op.getIdElement()));
+            if (!recordId.isNull()) {
+                Snapshotted<BSONObj> doc;
+                collection->findDoc(opCtx, recordId, &doc);
+            }
+        } catch (const DBException&) {
+            // Nothing to do. The writer threads will report any real problem with this op.
+        }
+    }
+}
+
 /**
  * Used for logging a report of ops that take longer than "slowMS" to apply. This is called
  * right before returning from applyOplogEntryOrGroupedInserts, and it returns the same status.
@@ -205,14 +236,45 @@ void processCrudOp(OperationContext* opCtx,
     }
 }
 
+/**
+ * Picks the writer vector for an op with the given hash.
+ *
+ * Without 'writerAssignments' this is simply 'hash % numWriters'. Otherwise, the first op of the
+ * batch with a given hash is assigned to the writer vector holding the fewest ops so far, and every
+ * later op with the same hash follows it to that writer. Ops that conflict (same document, or same
+ * capped collection) share a hash and therefore stay ordered on one writer, while independent hot
+ * keys that would collide modulo 'numWriters' are spread across otherwise idle writers.
+ */
+size_t chooseWriterVector(const std::vector<std::vector<const OplogEntry*>>& writerVectors,
+                          stdx::unordered_map<uint32_t, size_t>* writerAssignments,
+                          uint32_t hash) {
+    const uint32_t numWriters = writerVectors.size();
+    if (!writerAssignments) {
+        return hash % numWriters;
+    }
+
+    auto it = writerAssignments->find(hash);
+    if (it != writerAssignments->end()) {
+        return it->second;
+    }
+
+    auto leastLoaded = std::min_element(
+        writerVectors.begin(), writerVectors.end(), [](const auto& l, const auto& r) {
+            return l.size() < r.size();
+        });
+    size_t writerId = std::distance(writerVectors.begin(), leastLoaded);
+    writerAssignments->emplace(hash, writerId);
+    return writerId;
+}
+
 /**
  * Adds a single oplog entry to the appropriate writer vector.
  */
 void addToWriterVector(OplogEntry* op,
                        std::vector<std::vector<const OplogEntry*>>* writerVectors,
+                       stdx::unordered_map<uint32_t, size_t>* writerAssignments,
                        uint32_t hash) {
-    const uint32_t numWriters = writerVectors->size();
-    auto& writer = (*writerVectors)[hash % numWriters];
+    auto& writer = (*writerVectors)[chooseWriterVector(*writerVectors, writerAssignments, hash)];
     if (writer.empty()) {
         writer.reserve(8);  // Skip a few growth rounds
     }
@@ -227,6 +289,7 @@ void addToWriterVector(OplogEntry* op,
 void addDerivedOps(OperationContext* opCtx,
                    std::vector<OplogEntry>* derivedOps,
                    std::vector<std::vector<const OplogEntry*>>* writerVectors,
+                   stdx::unordered_map<uint32_t, size_t>* writerAssignments,
                    CachedCollectionProperties* collPropertiesCache,
                    bool serial) {
 
@@ -245,9 +308,9 @@ void addDerivedOps(OperationContext* opCtx,
         if (serial) {
             // Serial derived ops go to the writer vector corresponding to the first op of
             // derivedOps.
-            addToWriterVector(&op, writerVectors, serialWriterId.get());
+            addToWriterVector(&op, writerVectors, writerAssignments, serialWriterId.get());
         } else {
-            addToWriterVector(&op, writerVectors, hash);
+            addToWriterVector(&op, writerVectors, writerAssignments, hash);
         }
     }
 }
@@ -257,7 +320,8 @@ void _addOplogChainOpsToWriterVectors(OperationContext* opCtx,
                                       std::vector<std::vector<OplogEntry>>* derivedOps,
                                       OplogEntry* op,
                                       CachedCollectionProperties* collPropertiesCache,
-                                      std::vector<std::vector<const OplogEntry*>>* writerVectors) {
+                                      std::vector<std::vector<const OplogEntry*>>* writerVectors,
+                                      stdx::unordered_map<uint32_t, size_t>* writerAssignments) {
     std::vector<OplogEntry> txnOps;
     bool shouldSerialize = false;
     std::tie(txnOps, shouldSerialize) =
@@ -266,7 +330,12 @@ void _addOplogChainOpsToWriterVectors(OperationContext* opCtx,
     partialTxnList->clear();
 
     // Transaction entries cannot have different session updates.
-    addDerivedOps(opCtx, &derivedOps->back(), writerVectors, collPropertiesCache, shouldSerialize);
+    addDerivedOps(opCtx,
+                  &derivedOps->back(),
+                  writerVectors,
+                  writerAssignments,
+                  collPropertiesCache,
+                  shouldSerialize);
 }
 
 void stableSortByNamespace(std::vector<const OplogEntry*>* oplogEntryPointers) {
@@ -412,7 +481,77 @@ OplogApplierImpl::OplogApplierImpl(executor::TaskExecutor* executor,
       _consistencyMarkers(consistencyMarkers),
       _beginApplyingOpTime(options.beginApplyingOpTime) {}
 
+void OplogApplierImpl::prefetchBatch(const std::vector<OplogEntry>& ops) {
+    if (!_prefetchPool || _prefetchTasksInProgress.load() > 0) {
+        // Prefetching must not fall behind application, or it would only add cache pressure.
+        return;
+    }
+
+    std::vector<OplogEntry> toPrefetch;
+    for (auto&& op : ops) {
+        if (op.getOpType() == OpTypeEnum::kUpdate || op.getOpType() == OpTypeEnum::kDelete) {
+            toPrefetch.push_back(op);
+        }
+    }
+    if (toPrefetch.empty()) {
+        return;
+    }
+
+    // Hand each prefetch thread a contiguous range of the batch so that runs of ops on the same
+    // collection stay together.
+    const size_t numTasks =
+        std::min(toPrefetch.size(), size_t(_prefetchPool->getStats().numThreads));
+    const size_t opsPerTask = (toPrefetch.size() + numTasks - 1) / numTasks;
+    for (size_t begin = 0; begin < toPrefetch.size(); begin += opsPerTask) {
+        auto end = std::min(begin + opsPerTask, toPrefetch.size());
+        std::vector<OplogEntry> taskOps(std::make_move_iterator(toPrefetch.begin() + begin),
+                                        std::make_move_iterator(toPrefetch.begin() + end));
+        _prefetchTasksInProgress.fetchAndAdd(1);
+        _prefetchPool->schedule([this, taskOps = std::move(taskOps)](auto status) {
+            ON_BLOCK_EXIT([this] { _prefetchTasksInProgress.fetchAndSubtract(1); });
+            if (!status.isOK()) {
+                return;
+            }
+            auto opCtx = cc().makeOperationContext();
+            opCtx->setShouldParticipateInFlowControl(false);
+            prefetchDocuments(opCtx.get(), taskOps);
+        });
+    }
+}
+
+void OplogApplierImpl::startupPrefetchPool() {
+    invariant(!_prefetchPool);
+    if (replPrefetchThreadCount <= 0) {
+        return;
+    }
+
+    ThreadPool::Options options;
+    options.threadNamePrefix = "ReplPrefetchWorker-";
+    options.poolName = "ReplPrefetchWorkerThreadPool";
+    options.maxThreads = options.minThreads = static_cast<size_t>(replPrefetchThreadCount);
+    options.onCreateThread = [](const std::string&) {
+        Client::initThread(getThreadName());
+        AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+    };
+    _prefetchPool = std::make_unique<ThreadPool>(options);
+    _prefetchPool->startup();
+}
+
+void OplogApplierImpl::shutdownPrefetchPool() {
+    if (_prefetchPool) {
+        _prefetchPool->shutdown();
+        _prefetchPool->join();
+        _prefetchPool.reset();
+    }
+}
+
 void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
+    startupPrefetchPool();
+
+    // Declared before the batcher shutdown guard below, so that it runs after the batcher has
+    // stopped handing batches to prefetchBatch().
+    ON_BLOCK_EXIT([this] { shutdownPrefetchPool(); });
+
     // Start up a thread from the batcher to pull from the oplog buffer into the batcher's oplog
     // batch.
     _oplogBatcher->startup(_storageInterface);
@@ -494,6 +633,8 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
 
         // Apply the operations in this batch. '_applyOplogBatch' returns the optime of the
         // last op that was applied, which should be the last optime in the batch.
+        const auto numOpsInBatch = ops.getBatch().size();
+        Timer applyTimer;
         auto swLastOpTimeAppliedInBatch = _applyOplogBatch(&opCtx, ops.releaseBatch());
         if (swLastOpTimeAppliedInBatch.getStatus().code() == ErrorCodes::InterruptedAtShutdown) {
             // If an operation was interrupted at shutdown, fail the batch without advancing
@@ -505,6 +646,7 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
         }
         fassertNoTrace(34437, swLastOpTimeAppliedInBatch);
         invariant(swLastOpTimeAppliedInBatch.getValue() == lastOpTimeInBatch);
+        _oplogBatcher->onBatchApplied(numOpsInBatch, Milliseconds(applyTimer.millis()));
 
         // Update various things that care about our last applied optime. Tests rely on 1 happening
         // before 2 even though it isn't strictly necessary.
@@ -618,6 +760,20 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
     // Increment the batch size stat.
     oplogApplicationBatchSize.increment(ops.size());
 
+    BatchPhaseStats batchStats;
+    batchStats.batches = 1;
+    batchStats.ops = ops.size();
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<Latch> lk(_batchPhaseStatsMutex);
+        _batchPhaseStats.batches += batchStats.batches;
+        _batchPhaseStats.ops += batchStats.ops;
+        _batchPhaseStats.writeOplog += batchStats.writeOplog;
+        _batchPhaseStats.fillWriterVectors += batchStats.fillWriterVectors;
+        _batchPhaseStats.apply += batchStats.apply;
+        _batchPhaseStats.writerBusy += batchStats.writerBusy;
+        _batchPhaseStats.finish += batchStats.finish;
+    });
+
     std::vector<WorkerMultikeyPathInfo> multikeyVector(_writerPool->getStats().numThreads);
     {
         // Each node records cumulative batch application stats for itself using this timer.
@@ -628,6 +784,7 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
         ON_BLOCK_EXIT([&] { _writerPool->waitForIdle(); });
 
         // Write batch of ops into oplog.
+        Timer writeOplogTimer;
         if (!getOptions().skipWritesToOplog) {
             _consistencyMarkers->setOplogTruncateAfterPoint(
                 opCtx, _replCoord->getMyLastAppliedOpTime().getTimestamp());
@@ -645,10 +802,13 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
 
         std::vector<std::vector<const OplogEntry*>> writerVectors(
             _writerPool->getStats().numThreads);
+        Timer fillWriterVectorsTimer;
         fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+        batchStats.fillWriterVectors = Microseconds(fillWriterVectorsTimer.micros());
 
         // Wait for writes to finish before applying ops.
         _writerPool->waitForIdle();
+        batchStats.writeOplog = Microseconds(writeOplogTimer.micros());
 
         // Use this fail point to hold the PBWM lock after we have written the oplog entries but
         // before we have applied them.
@@ -667,6 +827,8 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
 
         {
             std::vector<Status> statusVector(_writerPool->getStats().numThreads, Status::OK());
+            std::vector<Microseconds> writerBusyVector(statusVector.size(), Microseconds(0));
+            Timer applyTimer;
 
             // Doles out all the work to the writer pool threads. writerVectors is not modified,
             // but  applyOplogBatchPerWorker will modify the vectors that it contains.
@@ -679,8 +841,11 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
                     [this,
                      &writer = writerVectors.at(i),
                      &status = statusVector.at(i),
-                     &multikeyVector = multikeyVector.at(i)](auto scheduleStatus) {
+                     &multikeyVector = multikeyVector.at(i),
+                     &writerBusy = writerBusyVector.at(i)](auto scheduleStatus) {
                         invariant(scheduleStatus);
+                        Timer writerTimer;
+                        ON_BLOCK_EXIT([&] { writerBusy = Microseconds(writerTimer.micros()); });
 
                         auto opCtx = cc().makeOperationContext();
 
@@ -695,6 +860,10 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
             }
 
             _writerPool->waitForIdle();
+            batchStats.apply = Microseconds(applyTimer.micros());
+            for (auto writerBusy : writerBusyVector) {
+                batchStats.writerBusy += writerBusy;
+            }
 
             // If any of the statuses is not ok, return error.
             for (auto it = statusVector.cbegin(); it != statusVector.cend(); ++it) {
@@ -742,6 +911,7 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
         }
     }
 
+    Timer finishTimer;
     Timestamp firstTimeInBatch = ops.front().getTimestamp();
     // Set any indexes to multikey that this batch ignored. This must be done while holding the
     // parallel batch writer mode lock.
@@ -760,11 +930,17 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
     // Increment the counter for the number of ops applied during catchup if the node is in catchup
     // mode.
     _replCoord->incrementNumCatchUpOpsIfCatchingUp(ops.size());
+    batchStats.finish = Microseconds(finishTimer.micros());
 
     // We have now written all database writes and updated the oplog to match.
     return ops.back().getOpTime();
 }
 
+OplogApplierImpl::BatchPhaseStats OplogApplierImpl::getBatchPhaseStats() const {
+    stdx::lock_guard<Latch> lk(_batchPhaseStatsMutex);
+    return _batchPhaseStats;
+}
+
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
@@ -779,7 +955,8 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
     std::vector<OplogEntry>* ops,
     std::vector<std::vector<const OplogEntry*>>* writerVectors,
     std::vector<std::vector<OplogEntry>>* derivedOps,
-    SessionUpdateTracker* sessionUpdateTracker) noexcept {
+    SessionUpdateTracker* sessionUpdateTracker,
+    stdx::unordered_map<uint32_t, size_t>* writerAssignments) noexcept {
 
     LogicalSessionIdMap<std::vector<OplogEntry*>> partialTxnOps;
     CachedCollectionProperties collPropertiesCache;
@@ -804,6 +981,7 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
                 addDerivedOps(opCtx,
                               &derivedOps->back(),
                               writerVectors,
+                              writerAssignments,
                               &collPropertiesCache,
                               false /*serial*/);
             }
@@ -843,8 +1021,13 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
                 // oplog and fill writers with those operations.
                 // Flush partialTxnList operations for current transaction.
                 auto& partialTxnList = partialTxnOps[*logicalSessionId];
-                _addOplogChainOpsToWriterVectors(
-                    opCtx, &partialTxnList, derivedOps, &op, &collPropertiesCache, writerVectors);
+                _addOplogChainOpsToWriterVectors(opCtx,
+                                                 &partialTxnList,
+                                                 derivedOps,
+                                                 &op,
+                                                 &collPropertiesCache,
+                                                 writerVectors,
+                                                 writerAssignments);
             } else {
                 // The applyOps entry was not generated as part of a transaction.
                 invariant(!op.getPrevWriteOpTimeInTransaction());
@@ -855,6 +1038,7 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
                 addDerivedOps(opCtx,
                               &derivedOps->back(),
                               writerVectors,
+                              writerAssignments,
                               &collPropertiesCache,
                               false /*serial*/);
             }
@@ -867,12 +1051,17 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
         if (op.isPreparedCommit() && (getOptions().mode == OplogApplication::Mode::kInitialSync)) {
             auto logicalSessionId = op.getSessionId();
             auto& partialTxnList = partialTxnOps[*logicalSessionId];
-            _addOplogChainOpsToWriterVectors(
-                opCtx, &partialTxnList, derivedOps, &op, &collPropertiesCache, writerVectors);
+            _addOplogChainOpsToWriterVectors(opCtx,
+                                             &partialTxnList,
+                                             derivedOps,
+                                             &op,
+                                             &collPropertiesCache,
+                                             writerVectors,
+                                             writerAssignments);
             continue;
         }
 
-        addToWriterVector(&op, writerVectors, hash);
+        addToWriterVector(&op, writerVectors, writerAssignments, hash);
     }
 }
 
@@ -882,14 +1071,27 @@ void OplogApplierImpl::fillWriterVectors(
     std::vector<std::vector<const OplogEntry*>>* writerVectors,
     std::vector<std::vector<OplogEntry>>* derivedOps) noexcept {
 
+    // The assignments must be shared by both passes below so that the session table updates
+    // flushed at the end of the batch follow the earlier writes to the same documents.
+    boost::optional<stdx::unordered_map<uint32_t, size_t>> writerAssignments;
+    if (replWriterBalancedAssignment.load()) {
+        writerAssignments.emplace();
+    }
+    auto writerAssignmentsPtr = writerAssignments ? &*writerAssignments : nullptr;
+
     SessionUpdateTracker sessionUpdateTracker;
-    _deriveOpsAndFillWriterVectors(opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker);
+    _deriveOpsAndFillWriterVectors(
+        opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker, writerAssignmentsPtr);
 
     auto newOplogWrites = sessionUpdateTracker.flushAll();
     if (!newOplogWrites.empty()) {
         derivedOps->emplace_back(std::move(newOplogWrites));
-        _deriveOpsAndFillWriterVectors(
-            opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+        _deriveOpsAndFillWriterVectors(opCtx,
+                                       &derivedOps->back(),
+                                       writerVectors,
+                                       derivedOps,
+                                       nullptr,
+                                       writerAssignmentsPtr);
     }
 }
 
@@ -1003,6 +1205,65 @@ Status applyOplogEntryOrGroupedInserts(OperationContext* opCtx,
     MONGO_UNREACHABLE;
 }
 
+Status applyGroupedUpdatesAndDeletes(OperationContext* opCtx,
+                                     std::vector<const OplogEntry*>::const_iterator begin,
+                                     std::vector<const OplogEntry*>::const_iterator end,
+                                     OplogApplication::Mode oplogApplicationMode) {
+    invariant(!opCtx->writesAreReplicated());
+    invariant(documentValidationDisabled(opCtx));
+    invariant(begin != end);
+
+    const auto& firstOp = **begin;
+    const NamespaceString nss(firstOp.getNss());
+    CurOp individualOp(opCtx);
+
+    // applyOperation_inlock does not timestamp writes that have a wrapping WriteUnitOfWork, so
+    // timestamp each one here, following the rule it applies to writes without one.
+    const bool assignOperationTimestamp =
+        ReplicationCoordinator::get(opCtx)->getReplicationMode() ==
+            ReplicationCoordinator::modeReplSet ||
+        oplogApplicationMode == OplogApplication::Mode::kRecovering;
+    // See applyOplogEntryOrGroupedInserts.
+    const bool shouldAlwaysUpsert = !oplogApplicationEnforcesSteadyStateConstraints &&
+        oplogApplicationMode == OplogApplication::Mode::kSecondary;
+
+    size_t numApplied = 0;
+    auto status = writeConflictRetry(opCtx, "applyGroupedUpdatesAndDeletes", nss.ns(), [&] {
+        numApplied = 0;
+        AutoGetCollection autoColl(opCtx, getNsOrUUID(nss, firstOp), MODE_IX);
+        auto db = autoColl.getDb();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "missing database (" << nss.db() << ")",
+                db);
+        OldClientContext ctx(opCtx, autoColl.getNss().ns(), db);
+
+        WriteUnitOfWork wuow(opCtx);
+        for (auto it = begin; it != end; ++it) {
+            const OplogEntry& op = **it;
+            if (assignOperationTimestamp) {
+                uassertStatusOK(opCtx->recoveryUnit()->setTimestamp(op.getTimestamp()));
+            }
+            auto status = applyOperation_inlock(
+                opCtx, db, &op, shouldAlwaysUpsert, oplogApplicationMode, [&] { ++numApplied; });
+            if (status.code() == ErrorCodes::WriteConflict) {
+                throw WriteConflictException();
+            }
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        wuow.commit();
+        return Status::OK();
+    });
+
+    // Only count the ops once the group has committed, since a failed group is applied again one
+    // op at a time.
+    if (status.isOK()) {
+        opsAppliedStats.increment(numApplied);
+    }
+    return status;
+}
+
 Status OplogApplierImpl::applyOplogBatchPerWorker(OperationContext* opCtx,
                                                   std::vector<const OplogEntry*>* ops,
                                                   WorkerMultikeyPathInfo* workerMultikeyPathInfo) {
@@ -1031,6 +1292,8 @@ Status OplogApplierImpl::applyOplogBatchPerWorker(OperationContext* opCtx,
     const auto oplogApplicationMode = getOptions().mode;
 
     InsertGroup insertGroup(ops, opCtx, oplogApplicationMode);
+    UpdateDeleteGroup updateDeleteGroup(ops, opCtx, oplogApplicationMode);
+    const bool groupUpdatesAndDeletes = oplogApplicationGroupsUpdatesAndDeletes.load();
 
     {  // Ensure that the MultikeyPathTracker stops tracking paths.
         ON_BLOCK_EXIT([opCtx] { MultikeyPathTracker::get(opCtx).stopTrackingMultikeyPathInfo(); });
@@ -1047,6 +1310,15 @@ Status OplogApplierImpl::applyOplogBatchPerWorker(OperationContext* opCtx,
                 continue;
             }
 
+            // Likewise for runs of updates and deletes on the same collection.
+            if (groupUpdatesAndDeletes) {
+                auto updateDeleteGroupResult = updateDeleteGroup.groupAndApplyUpdatesAndDeletes(it);
+                if (updateDeleteGroupResult.isOK()) {
+                    it = updateDeleteGroupResult.getValue();
+                    continue;
+                }
+            }
+
             // If we didn't create a group, try to apply the op individually.
             try {
                 const Status status =
@@ -40,6 +40,7 @@
 #include "mongo/db/repl/replication_metrics.h"
 #include "mongo/db/repl/session_update_tracker.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 namespace repl {
@@ -74,6 +75,42 @@ public:
                      const Options& options,
                      ThreadPool* writerPool);
 
+    /**
+     * If replPrefetchThreadCount is non-zero, looks up the documents that the updates and deletes
+     * in 'ops' target on the prefetch thread pool, so that the pages they live on are cached by
+     * the time the writer threads apply them. Batches that arrive while an earlier prefetch is
+     * still running are skipped.
+     */
+    void prefetchBatch(const std::vector<OplogEntry>& ops) override;
+
+    /**
+     * Starts and stops the thread pool used by prefetchBatch(). _run() manages the pool on its
+     * own; callers that drive getNextApplierBatch() and applyOplogBatch() directly, such as
+     * replication recovery, use these to prefetch as well. shutdownPrefetchPool() waits for any
+     * scheduled prefetches and may be called when the pool was never started.
+     */
+    void startupPrefetchPool();
+    void shutdownPrefetchPool();
+
+    /**
+     * Cumulative time spent in each phase of applying the batches passed to applyOplogBatch().
+     */
+    struct BatchPhaseStats {
+        long long batches = 0;
+        long long ops = 0;
+        // Wall time from scheduling the oplog writes until all of them are done. This overlaps
+        // with filling the writer vectors.
+        Microseconds writeOplog{0};
+        Microseconds fillWriterVectors{0};
+        // Wall time from scheduling the writer threads until the last of them is done.
+        Microseconds apply{0};
+        // Sum over the writer threads of the time each spent applying its share of a batch.
+        Microseconds writerBusy{0};
+        // Wall time spent after application, setting indexes multikey.
+        Microseconds finish{0};
+    };
+
+    BatchPhaseStats getBatchPhaseStats() const;
 
 private:
     /**
@@ -98,11 +135,18 @@ private:
      */
     StatusWith<OpTime> _applyOplogBatch(OperationContext* opCtx, std::vector<OplogEntry> ops);
 
-    void _deriveOpsAndFillWriterVectors(OperationContext* opCtx,
-                                        std::vector<OplogEntry>* ops,
-                                        std::vector<std::vector<const OplogEntry*>>* writerVectors,
-                                        std::vector<std::vector<OplogEntry>>* derivedOps,
-                                        SessionUpdateTracker* sessionUpdateTracker) noexcept;
+    /**
+     * If 'writerAssignments' is provided, it records which writer vector each op hash has been
+     * assigned to, and new hashes are placed on the least loaded writer vector. Otherwise ops are
+     * assigned to writer vectors by their hash modulo the number of writers.
+     */
+    void _deriveOpsAndFillWriterVectors(
+        OperationContext* opCtx,
+        std::vector<OplogEntry>* ops,
+        std::vector<std::vector<const OplogEntry*>>* writerVectors,
+        std::vector<std::vector<OplogEntry>>* derivedOps,
+        SessionUpdateTracker* sessionUpdateTracker,
+        stdx::unordered_map<uint32_t, size_t>* writerAssignments) noexcept;
 
     // Not owned by us.
     ReplicationCoordinator* const _replCoord;
@@ -115,6 +159,17 @@ private:
 
     ReplicationConsistencyMarkers* const _consistencyMarkers;
 
+    // Pool of threads used by prefetchBatch(). Only exists between startupPrefetchPool() and
+    // shutdownPrefetchPool(), and only when replPrefetchThreadCount is non-zero.
+    std::unique_ptr<ThreadPool> _prefetchPool;
+
+    // Number of prefetch tasks that have been scheduled but have not finished.
+    AtomicWord<int> _prefetchTasksInProgress{0};
+
+    mutable Mutex _batchPhaseStatsMutex =
+        MONGO_MAKE_LATCH("OplogApplierImpl::_batchPhaseStatsMutex");
+    BatchPhaseStats _batchPhaseStats;
+
     // Used to determine which operations should be applied during initial sync. If this is null,
     // we will apply all operations that were fetched.
     OpTime _beginApplyingOpTime = OpTime();
@@ -146,5 +201,15 @@ Status applyOplogEntryOrGroupedInserts(OperationContext* opCtx,
                                        const OplogEntryOrGroupedInserts& entryOrGroupedInserts,
                                        OplogApplication::Mode oplogApplicationMode);
 
+/**
+ * Applies the update and delete operations in [begin, end), which must all target the same
+ * collection, in a single WriteUnitOfWork. Each write is timestamped with its own oplog entry's
+ * timestamp. If any operation fails, none of them are applied.
+ */
+Status applyGroupedUpdatesAndDeletes(OperationContext* opCtx,
+                                     std::vector<const OplogEntry*>::const_iterator begin,
+                                     std::vector<const OplogEntry*>::const_iterator end,
+                                     OplogApplication::Mode oplogApplicationMode);
+
 }  // namespace repl
 }  // namespace mongo
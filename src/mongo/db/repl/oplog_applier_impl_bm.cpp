@@ -0,0 +1,301 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Benchmarks for OplogApplierImpl against a fresh WiredTiger storage engine. The generated
+ * workloads run in steady state replication mode. To replay a recorded oplog segment, point
+ * OPLOG_APPLIER_BM_REPLAY_FILE at a file of concatenated oplog entries, such as the .bson file
+ * mongodump writes for local.oplog.rs, and run BM_ReplayRecordedOplog.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/repl/idempotency_scalar_generator.h"
+#include "mongo/db/repl/idempotency_update_sequence.h"
+#include "mongo/db/repl/oplog_applier_impl_test_fixture.h"
+#include "mongo/db/repl/oplog_entry_test_helpers.h"
+#include "mongo/db/repl/storage_interface.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/unordered_set.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+constexpr size_t kOpsPerIteration = 10000;
+constexpr size_t kBatchLimitOps = 5000;
+constexpr size_t kNumDocsToUpdate = 1000;
+constexpr auto kReplayFileEnvVar = "OPLOG_APPLIER_BM_REPLAY_FILE";
+const NamespaceString kNss("bench.coll");
+
+/**
+ * Stands up a storage engine and the replication mocks the OplogApplierImpl unit tests use,
+ * outside of the unit test framework.
+ */
+class OplogApplierBenchmarkFixture : public OplogApplierImplTest {
+public:
+    OplogApplierBenchmarkFixture() : OplogApplierImplTest("wiredTiger") {
+        setUp();
+    }
+
+    ~OplogApplierBenchmarkFixture() {
+        tearDown();
+    }
+
+    OperationContext* opCtx() const {
+        return _opCtx.get();
+    }
+
+    OpTime nextOpTime() {
+        return OplogApplierImplTest::nextOpTime();
+    }
+
+    void createCollection(const NamespaceString& nss, boost::optional<UUID> uuid = boost::none) {
+        CollectionOptions options;
+        options.uuid = uuid ? *uuid : UUID::gen();
+        uassertStatusOK(getStorageInterface()->createCollection(opCtx(), nss, options));
+    }
+
+    std::unique_ptr<OplogApplierImpl> makeApplier(OplogApplication::Mode mode,
+                                                  ThreadPool* writerPool) {
+        return std::make_unique<OplogApplierImpl>(nullptr,  // executor
+                                                  nullptr,  // oplogBuffer
+                                                  &_observer,
+                                                  ReplicationCoordinator::get(opCtx()),
+                                                  getConsistencyMarkers(),
+                                                  getStorageInterface(),
+                                                  OplogApplier::Options(mode),
+                                                  writerPool);
+    }
+
+private:
+    void _doTest() override {
+        MONGO_UNREACHABLE;
+    }
+
+    NoopOplogApplierObserver _observer;
+};
+
+/**
+ * Applies 'ops' through 'applier' in batches of at most 'kBatchLimitOps' operations.
+ */
+void applyInBatches(OperationContext* opCtx,
+                    OplogApplierImpl* applier,
+                    const std::vector<OplogEntry>& ops) {
+    for (size_t begin = 0; begin < ops.size(); begin += kBatchLimitOps) {
+        auto end = std::min(ops.size(), begin + kBatchLimitOps);
+        std::vector<OplogEntry> batch(ops.begin() + begin, ops.begin() + end);
+        uassertStatusOK(applier->applyOplogBatch(opCtx, std::move(batch)));
+    }
+}
+
+/**
+ * Reports the operations applied per second, the fraction of the apply phase the writer threads
+ * spent busy, and the average time per batch spent in each phase of batch application.
+ */
+void reportBatchPhaseStats(benchmark::State& state,
+                           const OplogApplierImpl::BatchPhaseStats& stats,
+                           int numWriters) {
+    state.SetItemsProcessed(stats.ops);
+    auto perBatch = [&](Microseconds phase) {
+        return benchmark::Counter(static_cast<double>(durationCount<Microseconds>(phase)) /
+                                  std::max(stats.batches, 1LL));
+    };
+    state.counters["writeOplogMicrosPerBatch"] = perBatch(stats.writeOplog);
+    state.counters["fillWriterVectorsMicrosPerBatch"] = perBatch(stats.fillWriterVectors);
+    state.counters["applyMicrosPerBatch"] = perBatch(stats.apply);
+    state.counters["finishMicrosPerBatch"] = perBatch(stats.finish);
+
+    auto applyCapacity = durationCount<Microseconds>(stats.apply) * numWriters;
+    state.counters["writerUtilization"] = applyCapacity
+        ? static_cast<double>(durationCount<Microseconds>(stats.writerBusy)) / applyCapacity
+        : 0;
+}
+
+/**
+ * Runs 'makeOps' with the timer paused on every iteration and times the application of the ops
+ * it returns in steady state replication mode, with state.range(0) writer threads.
+ */
+template <typename MakeOps>
+void runSteadyState(benchmark::State& state,
+                    OplogApplierBenchmarkFixture* fixture,
+                    MakeOps makeOps) {
+    const int numWriters = state.range(0);
+    auto writerPool = makeReplWriterPool(numWriters);
+    auto applier = fixture->makeApplier(OplogApplication::Mode::kSecondary, writerPool.get());
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto ops = makeOps();
+        state.ResumeTiming();
+
+        applyInBatches(fixture->opCtx(), applier.get(), ops);
+    }
+
+    reportBatchPhaseStats(state, applier->getBatchPhaseStats(), numWriters);
+}
+
+void BM_ApplyInserts(benchmark::State& state) {
+    OplogApplierBenchmarkFixture fixture;
+    fixture.createCollection(kNss);
+
+    int nextId = 0;
+    runSteadyState(state, &fixture, [&] {
+        std::vector<OplogEntry> ops;
+        ops.reserve(kOpsPerIteration);
+        for (size_t i = 0; i < kOpsPerIteration; ++i, ++nextId) {
+            auto doc = BSON("_id" << nextId << "x" << nextId << "s"
+                                  << "abcdefghijklmnopqrstuvwxyz");
+            ops.push_back(makeInsertDocumentOplogEntry(fixture.nextOpTime(), kNss, doc));
+        }
+        return ops;
+    });
+}
+
+/**
+ * Applies updates produced by the idempotency test update generator to a fixed set of documents.
+ * The generator only sets and unsets top-level fields, so every update is valid in steady state.
+ */
+void BM_ApplyUpdates(benchmark::State& state) {
+    OplogApplierBenchmarkFixture fixture;
+    fixture.createCollection(kNss);
+
+    {
+        auto writerPool = makeReplWriterPool(1);
+        auto applier = fixture.makeApplier(OplogApplication::Mode::kSecondary, writerPool.get());
+        std::vector<OplogEntry> inserts;
+        for (size_t id = 0; id < kNumDocsToUpdate; ++id) {
+            inserts.push_back(makeInsertDocumentOplogEntry(
+                fixture.nextOpTime(), kNss, BSON("_id" << static_cast<int>(id) << "a" << 1)));
+        }
+        applyInBatches(fixture.opCtx(), applier.get(), inserts);
+    }
+
+    PseudoRandom random(1);
+    RandomizedScalarGenerator scalarGenerator{PseudoRandom(random.nextInt64())};
+    UpdateSequenceGenerator generator({{"a", "b", "c", "d"}, 1 /* depth */, 2 /* length */},
+                                      PseudoRandom(random.nextInt64()),
+                                      &scalarGenerator);
+
+    runSteadyState(state, &fixture, [&] {
+        std::vector<OplogEntry> ops;
+        ops.reserve(kOpsPerIteration);
+        for (size_t i = 0; i < kOpsPerIteration; ++i) {
+            auto id = static_cast<int>(random.nextInt32(kNumDocsToUpdate));
+            ops.push_back(makeUpdateDocumentOplogEntry(
+                fixture.nextOpTime(), kNss, BSON("_id" << id), generator.generateUpdate()));
+        }
+        return ops;
+    });
+}
+
+std::vector<OplogEntry> readOplogEntries(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    uassert(4798200, str::stream() << "Cannot open oplog replay file " << path, file);
+    std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::vector<OplogEntry> ops;
+    for (size_t offset = 0; offset < buffer.size();) {
+        BSONObj obj(buffer.data() + offset);
+        uassert(4798201,
+                str::stream() << "Truncated oplog entry at offset " << offset << " of " << path,
+                offset + obj.objsize() <= buffer.size());
+        ops.push_back(uassertStatusOK(OplogEntry::parse(obj.getOwned())));
+        offset += obj.objsize();
+    }
+    return ops;
+}
+
+/**
+ * Replays a recorded oplog segment once. The segment usually starts in the middle of the
+ * history, so every collection its CRUD ops refer to is created up front with the recorded UUID,
+ * and the ops are applied in initial sync mode, which tolerates updates and deletes of documents
+ * inserted before the segment started. Unlike recovery, initial sync still writes the entries to
+ * the oplog. The batches are cut at 'kBatchLimitOps' rather than at the recorded batch
+ * boundaries, which the oplog doesn't keep.
+ */
+void BM_ReplayRecordedOplog(benchmark::State& state) {
+    auto path = std::getenv(kReplayFileEnvVar);
+    if (!path) {
+        state.SkipWithError("OPLOG_APPLIER_BM_REPLAY_FILE is not set");
+        return;
+    }
+
+    OplogApplierBenchmarkFixture fixture;
+    auto ops = readOplogEntries(path);
+
+    stdx::unordered_set<std::string> createdInSegment;
+    for (auto&& op : ops) {
+        if (op.getCommandType() == OplogEntry::CommandType::kCreate) {
+            createdInSegment.insert(op.getNss().db().toString() + "." +
+                                    op.getObject().firstElement().str());
+        }
+    }
+    stdx::unordered_set<std::string> created;
+    for (auto&& op : ops) {
+        if (!op.isCrudOpType() || !op.getUuid()) {
+            continue;
+        }
+        auto ns = op.getNss().ns();
+        if (!createdInSegment.count(ns) && created.insert(ns).second) {
+            fixture.createCollection(op.getNss(), *op.getUuid());
+        }
+    }
+
+    const int numWriters = state.range(0);
+    auto writerPool = makeReplWriterPool(numWriters);
+    auto applier = fixture.makeApplier(OplogApplication::Mode::kInitialSync, writerPool.get());
+    for (auto _ : state) {
+        applyInBatches(fixture.opCtx(), applier.get(), ops);
+    }
+
+    reportBatchPhaseStats(state, applier->getBatchPhaseStats(), numWriters);
+}
+
+BENCHMARK(BM_ApplyInserts)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ApplyUpdates)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+// Each op can only be applied once, so the recorded segment is replayed a single time.
+BENCHMARK(BM_ReplayRecordedOplog)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -573,6 +573,37 @@ TEST_F(OplogApplierImplTest,
     ASSERT_TRUE(AutoGetCollectionForReadCommand(_opCtx.get(), nss).getCollection());
 }
 
+TEST_F(OplogApplierImplTest, ApplyOplogBatchAccumulatesBatchPhaseStats) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    createCollectionWithUuid(_opCtx.get(), nss);
+    auto makeOp = [&](int seconds) {
+        return makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(seconds), 0), 1LL}, nss, BSON("_id" << seconds));
+    };
+
+    const int numWriters = 2;
+    auto writerPool = makeReplWriterPool(numWriters);
+    NoopOplogApplierObserver observer;
+    OplogApplierImpl oplogApplier(
+        nullptr,  // executor
+        nullptr,  // oplogBuffer
+        &observer,
+        ReplicationCoordinator::get(_opCtx.get()),
+        getConsistencyMarkers(),
+        getStorageInterface(),
+        repl::OplogApplier::Options(repl::OplogApplication::Mode::kSecondary),
+        writerPool.get());
+
+    ASSERT_OK(oplogApplier.applyOplogBatch(_opCtx.get(), {makeOp(1), makeOp(2)}));
+    ASSERT_OK(oplogApplier.applyOplogBatch(_opCtx.get(), {makeOp(3)}));
+
+    auto stats = oplogApplier.getBatchPhaseStats();
+    ASSERT_EQ(2, stats.batches);
+    ASSERT_EQ(3, stats.ops);
+    // The writers only run during the apply phase.
+    ASSERT_LTE(stats.writerBusy, stats.apply * numWriters);
+}
+
 class MultiOplogEntryOplogApplierImplTest : public OplogApplierImplTest {
 public:
     MultiOplogEntryOplogApplierImplTest()
@@ -1736,6 +1767,34 @@ TEST_F(OplogApplierImplTest,
     ASSERT_BSONOBJ_EQ(insertOp2b.getObject(), group2[1]);
 }
 
+TEST_F(OplogApplierImplTest,
+       OplogApplicationThreadFuncGroupsUpdateAndDeleteOperationsWhenEnabled) {
+    oplogApplicationGroupsUpdatesAndDeletes.store(true);
+    ON_BLOCK_EXIT([] { oplogApplicationGroupsUpdatesAndDeletes.store(false); });
+
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    auto createOp = makeCreateCollectionOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss);
+    auto insertOp1 =
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 1));
+    auto insertOp2 =
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(3), 0), 1LL}, nss, BSON("_id" << 2));
+    auto insertOp3 =
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(4), 0), 1LL}, nss, BSON("_id" << 3));
+    auto updateOp1 = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(5), 0), 1LL}, nss, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1));
+    auto deleteOp2 =
+        makeDeleteDocumentOplogEntry({Timestamp(Seconds(6), 0), 1LL}, nss, BSON("_id" << 2));
+    auto updateOp3 = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(7), 0), 1LL}, nss, BSON("_id" << 3), BSON("_id" << 3 << "x" << 3));
+
+    ASSERT_OK(runOpsSteadyState(
+        {createOp, insertOp1, insertOp2, insertOp3, updateOp1, deleteOp2, updateOp3}));
+
+    ASSERT_TRUE(docExists(_opCtx.get(), nss, BSON("_id" << 1 << "x" << 1)));
+    ASSERT_FALSE(docExists(_opCtx.get(), nss, BSON("_id" << 2)));
+    ASSERT_TRUE(docExists(_opCtx.get(), nss, BSON("_id" << 3 << "x" << 3)));
+}
+
 TEST_F(OplogApplierImplTest,
        OplogApplicationThreadFuncLimitsBatchCountWhenGroupingInsertOperation) {
     int seconds = 1;
@@ -2710,6 +2769,62 @@ TEST_F(OplogApplierImplTxnTableTest, InterleavedWriteWithTxnMixedWithDirectDelet
     checkTxnTable(sessionInfo, {Timestamp(3, 0), 2}, date);
 }
 
+TEST_F(OplogApplierImplTxnTableTest,
+       InterleavedWriteWithTxnMixedWithDirectDeleteToTxnTableWithBalancedWriterAssignment) {
+    replWriterBalancedAssignment.store(true);
+    ON_BLOCK_EXIT([] { replWriterBalancedAssignment.store(false); });
+
+    const auto sessionId = makeLogicalSessionIdForTest();
+    OperationSessionInfo sessionInfo;
+    sessionInfo.setSessionId(sessionId);
+    sessionInfo.setTxnNumber(3);
+    auto date = Date_t::now();
+
+    auto insertOp = makeOplogEntry(nss(),
+                                   {Timestamp(1, 0), 1},
+                                   repl::OpTypeEnum::kInsert,
+                                   BSON("_id" << 1),
+                                   boost::none,
+                                   sessionInfo,
+                                   date);
+
+    auto deleteOp = makeOplogEntry(NamespaceString::kSessionTransactionsTableNamespace,
+                                   {Timestamp(2, 0), 1},
+                                   repl::OpTypeEnum::kDelete,
+                                   BSON("_id" << sessionInfo.getSessionId()->toBSON()),
+                                   boost::none,
+                                   {},
+                                   Date_t::now());
+
+    date = Date_t::now();
+    sessionInfo.setTxnNumber(7);
+    auto insertOp2 = makeOplogEntry(nss(),
+                                    {Timestamp(3, 0), 2},
+                                    repl::OpTypeEnum::kInsert,
+                                    BSON("_id" << 6),
+                                    boost::none,
+                                    sessionInfo,
+                                    date);
+
+    auto writerPool = makeReplWriterPool();
+    NoopOplogApplierObserver observer;
+    OplogApplierImpl oplogApplier(
+        nullptr,  // executor
+        nullptr,  // oplogBuffer
+        &observer,
+        ReplicationCoordinator::get(_opCtx.get()),
+        getConsistencyMarkers(),
+        getStorageInterface(),
+        repl::OplogApplier::Options(repl::OplogApplication::Mode::kSecondary),
+        writerPool.get());
+
+    // The direct delete and the session table update flushed at the end of the batch target the
+    // same document, so they must still be applied in order by a single writer.
+    ASSERT_OK(oplogApplier.applyOplogBatch(_opCtx.get(), {insertOp, deleteOp, insertOp2}));
+
+    checkTxnTable(sessionInfo, {Timestamp(3, 0), 2}, date);
+}
+
 TEST_F(OplogApplierImplTxnTableTest, InterleavedWriteWithTxnMixedWithDirectUpdateToTxnTable) {
     const auto sessionId = makeLogicalSessionIdForTest();
     OperationSessionInfo sessionInfo;
@@ -32,6 +32,7 @@
 #include "mongo/db/repl/oplog_batcher.h"
 
 #include "mongo/db/catalog_raii.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/db/repl/oplog_applier.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
@@ -41,6 +42,22 @@ namespace mongo {
 namespace repl {
 MONGO_FAIL_POINT_DEFINE(skipOplogBatcherWaitForData);
 
+namespace {
+
+// Weight given to the most recent batch in the moving average of the apply throughput.
+constexpr double kApplyThroughputSmoothing = 0.2;
+
+// The operation limit used for the most recent batch.
+Counter64 batchLimitOpsGauge;
+ServerStatusMetricField<Counter64> displayBatchLimitOps("repl.buffer.batchLimitOps",
+                                                        &batchLimitOpsGauge);
+// The number of adaptively sized batches that were allowed to grow because the buffer was behind.
+Counter64 laggingBatchesCounter;
+ServerStatusMetricField<Counter64> displayLaggingBatches("repl.buffer.adaptiveLaggingBatches",
+                                                         &laggingBatchesCounter);
+
+}  // namespace
+
 OplogBatcher::OplogBatcher(OplogApplier* oplogApplier, OplogBuffer* oplogBuffer)
     : _oplogApplier(oplogApplier), _oplogBuffer(oplogBuffer), _ops(0) {}
 OplogBatcher::~OplogBatcher() {
@@ -270,7 +287,8 @@ void OplogBatcher::_run(StorageInterface* storageInterface) {
         batchLimits.slaveDelayLatestTimestamp = _calculateSlaveDelayLatestTimestamp();
 
         // Check the limits once per batch since users can change them at runtime.
-        batchLimits.ops = getBatchLimitOplogEntries();
+        batchLimits.ops = _calculateBatchLimitOps();
+        batchLimitOpsGauge.increment(batchLimits.ops - batchLimitOpsGauge.get());
 
         // Use the OplogBuffer to populate a local OplogBatch. Note that the buffer may be empty.
         OplogBatch ops(batchLimits.ops);
@@ -337,6 +355,12 @@ void OplogBatcher::_run(StorageInterface* storageInterface) {
             }
         }
 
+        if (!ops.empty()) {
+            // The previous batch is most likely still being applied, so this gives the applier a
+            // chance to prefetch what the next one will touch.
+            _oplogApplier->prefetchBatch(ops.getBatch());
+        }
+
         stdx::unique_lock<Latch> lk(_mutex);
         // Block until the previous batch has been taken.
         _cv.wait(lk, [&] { return _ops.empty() && !_ops.termWhenExhausted(); });
@@ -348,6 +372,50 @@ void OplogBatcher::_run(StorageInterface* storageInterface) {
     }
 }
 
+void OplogBatcher::onBatchApplied(std::size_t numOps, Milliseconds duration) {
+    // Treat sub-millisecond batches as taking one millisecond to avoid dividing by zero.
+    auto millis = std::max<long long>(durationCount<Milliseconds>(duration), 1);
+    auto opsPerMilli = double(numOps) / millis;
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_applyOpsPerMilli == 0) {
+        _applyOpsPerMilli = opsPerMilli;
+    } else {
+        _applyOpsPerMilli = kApplyThroughputSmoothing * opsPerMilli +
+            (1 - kApplyThroughputSmoothing) * _applyOpsPerMilli;
+    }
+}
+
+std::size_t OplogBatcher::_calculateBatchLimitOps() {
+    auto limit = getBatchLimitOplogEntries();
+
+    if (!replBatchLimitAdaptive.load()) {
+        return limit;
+    }
+
+    double opsPerMilli;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        opsPerMilli = _applyOpsPerMilli;
+    }
+    if (opsPerMilli == 0) {
+        // Nothing has been applied yet, so there is no throughput to size the batch from.
+        return limit;
+    }
+
+    // Aim for batches that take about the target time to apply, so that the majority commit point
+    // keeps moving. When the buffer already holds more than that, the node is falling behind its
+    // sync source and larger batches amortize the fixed per-batch cost better.
+    auto target = std::size_t(opsPerMilli * replBatchAdaptiveTargetMillis.load());
+    if (_oplogBuffer->getCount() > target) {
+        target *= 2;
+        laggingBatchesCounter.increment();
+    }
+
+    auto minOps = std::min(std::size_t(replBatchAdaptiveMinOperations.load()), limit);
+    return std::max(minOps, std::min(target, limit));
+}
+
 std::size_t getBatchLimitOplogEntries() {
     return std::size_t(replBatchLimitOperations.load());
 }
@@ -185,6 +185,12 @@ public:
      */
     static std::size_t getOpCount(const OplogEntry& entry);
 
+    /**
+     * Records that the oplog applier took 'duration' to apply a batch of 'numOps' operations.
+     * Used to size subsequent batches when replBatchLimitAdaptive is enabled.
+     */
+    void onBatchApplied(std::size_t numOps, Milliseconds duration);
+
 private:
     /**
      * If slaveDelay is enabled, this function calculates the most recent timestamp of any oplog
@@ -199,6 +205,13 @@ private:
 
     void _run(StorageInterface* storageInterface);
 
+    /**
+     * Returns the maximum number of operations for the next batch. This is
+     * replBatchLimitOperations unless replBatchLimitAdaptive is enabled and a throughput
+     * measurement is available.
+     */
+    std::size_t _calculateBatchLimitOps();
+
     OplogApplier* _oplogApplier;
     OplogBuffer* const _oplogBuffer;
 
@@ -210,6 +223,12 @@ private:
      */
     OplogBatch _ops;
 
+    /**
+     * Moving average of the oplog application throughput, in operations per millisecond, as
+     * reported through onBatchApplied(). Zero until the first batch has been applied.
+     */
+    double _applyOpsPerMilli = 0;
+
     std::unique_ptr<stdx::thread> _thread;
 };
 
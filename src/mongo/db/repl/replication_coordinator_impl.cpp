@@ -4523,10 +4523,29 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig(WithLock lk,
 }
 
 void ReplicationCoordinatorImpl::_wakeReadyWaiters(WithLock lk, boost::optional<OpTime> opTime) {
+    // Waiters are visited in increasing OpTime order, and a write concern that is satisfied at
+    // some OpTime is also satisfied at every earlier one. Once a waiter is found unsatisfied, every
+    // later waiter with the same requirement is unsatisfied too, so skip re-checking them.
+    // Otherwise each wake-up would evaluate every outstanding write against the topology, which is
+    // costly under this mutex with many concurrent w:majority writers.
+    std::vector<const WriteConcernOptions*> unsatisfied;
     _replicationWaiterList.setValueIf_inlock(
-        [this](const OpTime& opTime, const SharedWaiterHandle& waiter) {
+        [this, &unsatisfied](const OpTime& opTime, const SharedWaiterHandle& waiter) {
             invariant(waiter->writeConcern);
-            return _doneWaitingForReplication_inlock(opTime, waiter->writeConcern.get());
+            const auto& writeConcern = waiter->writeConcern.get();
+            auto sameRequirement = [&](const WriteConcernOptions* other) {
+                return other->syncMode == writeConcern.syncMode &&
+                    other->wMode == writeConcern.wMode &&
+                    other->wNumNodes == writeConcern.wNumNodes;
+            };
+            if (std::any_of(unsatisfied.begin(), unsatisfied.end(), sameRequirement)) {
+                return false;
+            }
+            if (_doneWaitingForReplication_inlock(opTime, writeConcern)) {
+                return true;
+            }
+            unsatisfied.push_back(&writeConcern);
+            return false;
         },
         opTime);
 }
@@ -36,6 +36,7 @@
 #include "mongo/db/repl/replication_recovery.h"
 
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/namespace_string.h"
@@ -44,6 +45,7 @@
 #include "mongo/db/repl/oplog_applier_impl.h"
 #include "mongo/db/repl/oplog_buffer.h"
 #include "mongo/db/repl/oplog_interface_local.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_consistency_markers_impl.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
@@ -53,6 +55,10 @@
 #include "mongo/db/transaction_history_iterator.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -229,6 +235,139 @@ private:
     std::unique_ptr<DBClientCursor> _cursor;
 };
 
+/**
+ * Forms the batches of recovery oplog application from an OplogBufferLocalOplog. If
+ * replRecoveryOplogReadAhead is set, the oplog is scanned on a dedicated thread that stays one
+ * batch ahead of the caller, so that reading and prefetching the next batch overlap with the writer
+ * pool applying the current one. Otherwise each batch is read on the caller's operation context.
+ */
+class RecoveryOplogBatcher {
+public:
+    RecoveryOplogBatcher(OplogApplier* oplogApplier,
+                         OplogBufferLocalOplog* oplogBuffer,
+                         OplogApplier::BatchLimits batchLimits)
+        : _oplogApplier(oplogApplier), _oplogBuffer(oplogBuffer), _batchLimits(batchLimits) {}
+
+    ~RecoveryOplogBatcher() {
+        _joinThread();
+    }
+
+    /**
+     * Opens the oplog scan. Must be paired with a call to shutdown().
+     */
+    void startup(OperationContext* opCtx) {
+        if (!replRecoveryOplogReadAhead.load()) {
+            _oplogBuffer->startup(opCtx);
+            return;
+        }
+        _thread = std::make_unique<stdx::thread>([this] { _run(); });
+    }
+
+    /**
+     * Returns the next batch, or an empty batch once the oplog scan is exhausted. Rethrows any
+     * error the read-ahead thread ran into.
+     */
+    std::vector<OplogEntry> getNextBatch(OperationContext* opCtx) {
+        if (!_thread) {
+            return _readBatch(opCtx);
+        }
+
+        stdx::unique_lock<Latch> lk(_mutex);
+        _cv.wait(lk, [&] { return _nextBatch || !_status.isOK(); });
+        uassertStatusOK(_status);
+        auto batch = std::move(*_nextBatch);
+        _nextBatch.reset();
+        _cv.notify_all();
+        return batch;
+    }
+
+    /**
+     * Closes the oplog scan and returns whether every entry in it was handed out.
+     */
+    bool shutdown(OperationContext* opCtx) {
+        if (!_thread) {
+            const bool exhausted = _oplogBuffer->isEmpty();
+            _oplogBuffer->shutdown(opCtx);
+            return exhausted;
+        }
+        _joinThread();
+        return _exhausted;
+    }
+
+private:
+    std::vector<OplogEntry> _readBatch(OperationContext* opCtx) {
+        return fassert(50763, _oplogApplier->getNextApplierBatch(opCtx, _batchLimits));
+    }
+
+    void _run() {
+        Client::initThread("ReplRecoveryBatcher");
+        auto opCtx = cc().makeOperationContext();
+
+        // Batch application holds the ParallelBatchWriterMode lock while it applies the previous
+        // batch, which is exactly when this thread needs to read.
+        ShouldNotConflictWithSecondaryBatchApplicationBlock noPBWMBlock(opCtx->lockState());
+        try {
+            _oplogBuffer->startup(opCtx.get());
+            ON_BLOCK_EXIT([&] { _oplogBuffer->shutdown(opCtx.get()); });
+
+            while (true) {
+                auto batch = _readBatch(opCtx.get());
+                const bool endOfScan = batch.empty();
+                if (endOfScan) {
+                    _exhausted = _oplogBuffer->isEmpty();
+                } else {
+                    _oplogApplier->prefetchBatch(batch);
+                }
+
+                stdx::unique_lock<Latch> lk(_mutex);
+                _cv.wait(lk, [&] { return !_nextBatch || _inShutdown; });
+                if (_inShutdown) {
+                    return;
+                }
+                _nextBatch = std::move(batch);
+                _cv.notify_all();
+                if (endOfScan) {
+                    return;
+                }
+            }
+        } catch (...) {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _status = exceptionToStatus();
+            _cv.notify_all();
+        }
+    }
+
+    void _joinThread() {
+        if (!_thread) {
+            return;
+        }
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _inShutdown = true;
+            _cv.notify_all();
+        }
+        _thread->join();
+        _thread.reset();
+    }
+
+    OplogApplier* const _oplogApplier;
+    OplogBufferLocalOplog* const _oplogBuffer;
+    const OplogApplier::BatchLimits _batchLimits;
+
+    std::unique_ptr<stdx::thread> _thread;
+
+    // Set by the read-ahead thread before it hands out the final, empty batch.
+    bool _exhausted = false;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("RecoveryOplogBatcher::_mutex");
+    stdx::condition_variable _cv;
+
+    // Guarded by _mutex.
+    boost::optional<std::vector<OplogEntry>> _nextBatch;
+    Status _status = Status::OK();
+    bool _inShutdown = false;
+};
+
 boost::optional<Timestamp> recoverFromOplogPrecursor(OperationContext* opCtx,
                                                      StorageInterface* storageInterface) {
     if (!storageInterface->supportsRecoveryTimestamp(opCtx->getServiceContext())) {
@@ -581,7 +720,6 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
           "endPoint"_attr = endPoint);
 
     OplogBufferLocalOplog oplogBuffer(startPoint, endPoint);
-    oplogBuffer.startup(opCtx);
 
     RecoveryOplogApplierStats stats;
 
@@ -599,18 +737,25 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
     batchLimits.bytes = getBatchLimitOplogBytes(opCtx, _storageInterface);
     batchLimits.ops = getBatchLimitOplogEntries();
 
+    oplogApplier.startupPrefetchPool();
+    ON_BLOCK_EXIT([&] { oplogApplier.shutdownPrefetchPool(); });
+
+    // Declared after the prefetch pool guard so that the read-ahead thread, which schedules
+    // prefetches, is joined first.
+    RecoveryOplogBatcher batcher(&oplogApplier, &oplogBuffer, batchLimits);
+    batcher.startup(opCtx);
+
     OpTime applyThroughOpTime;
     std::vector<OplogEntry> batch;
-    while (
-        !(batch = fassert(50763, oplogApplier.getNextApplierBatch(opCtx, batchLimits))).empty()) {
+    while (!(batch = batcher.getNextBatch(opCtx)).empty()) {
         applyThroughOpTime = uassertStatusOK(oplogApplier.applyOplogBatch(opCtx, std::move(batch)));
     }
     stats.complete(applyThroughOpTime);
-    invariant(oplogBuffer.isEmpty(),
+    const bool oplogBufferExhausted = batcher.shutdown(opCtx);
+    invariant(oplogBufferExhausted,
               str::stream() << "Oplog buffer not empty after applying operations. Last operation "
                                "applied with optime: "
                             << applyThroughOpTime.toBSON());
-    oplogBuffer.shutdown(opCtx);
 
     // The applied up to timestamp will be null if no oplog entries were applied.
     if (applyThroughOpTime.isNull()) {
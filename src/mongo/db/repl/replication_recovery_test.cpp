@@ -43,6 +43,7 @@
 #include "mongo/db/repl/oplog_applier_impl_test_fixture.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/oplog_interface_local.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_consistency_markers_mock.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/replication_recovery.h"
@@ -56,6 +57,7 @@
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace {
@@ -663,6 +665,23 @@ TEST_F(ReplicationRecoveryTest,
     testRecoveryAppliesDocumentsWhenAppliedThroughIsBehind(hasStableTimestamp, hasStableCheckpoint);
 }
 
+TEST_F(ReplicationRecoveryTest, RecoveryAppliesDocumentsWithoutOplogReadAhead) {
+    replRecoveryOplogReadAhead.store(false);
+    ON_BLOCK_EXIT([] { replRecoveryOplogReadAhead.store(true); });
+    bool hasStableTimestamp = true;
+    bool hasStableCheckpoint = false;
+    testRecoveryAppliesDocumentsWhenAppliedThroughIsBehind(hasStableTimestamp, hasStableCheckpoint);
+}
+
+TEST_F(ReplicationRecoveryTest, RecoveryAppliesDocumentsWithPrefetchThreads) {
+    const auto originalPrefetchThreadCount = replPrefetchThreadCount;
+    replPrefetchThreadCount = 2;
+    ON_BLOCK_EXIT([&] { replPrefetchThreadCount = originalPrefetchThreadCount; });
+    bool hasStableTimestamp = true;
+    bool hasStableCheckpoint = false;
+    testRecoveryAppliesDocumentsWhenAppliedThroughIsBehind(hasStableTimestamp, hasStableCheckpoint);
+}
+
 void ReplicationRecoveryTest::testRecoveryToStableAppliesDocumentsWithNoAppliedThrough(
     bool hasStableTimestamp) {
     ReplicationRecoveryImpl recovery(getStorageInterface(), getConsistencyMarkers());
@@ -607,16 +607,15 @@ void RollbackImpl::_correctRecordStoreCounts(OperationContext* opCtx) {
             invariant(coll == collToScan,
                       str::stream() << "Catalog returned invalid collection: " << nss.ns() << " ("
                                     << uuid.toString() << ")");
-            auto exec = collToScan->makePlanExecutor(opCtx,
-                                                     PlanYieldPolicy::YieldPolicy::INTERRUPT_ONLY,
-                                                     Collection::ScanDirection::kForward);
+            // Count by walking the record store directly. Going through a query plan would only
+            // add per-document working set overhead to what can be a long, blocking scan.
             long long countFromScan = 0;
-            PlanExecutor::ExecState state;
-            while (PlanExecutor::ADVANCED ==
-                   (state = exec->getNext(static_cast<BSONObj*>(nullptr), nullptr))) {
-                ++countFromScan;
-            }
-            if (PlanExecutor::IS_EOF != state) {
+            try {
+                auto cursor = collToScan->getCursor(opCtx);
+                while (cursor->next()) {
+                    ++countFromScan;
+                }
+            } catch (const DBException& ex) {
                 // We ignore errors here because crashing or leaving rollback would only leave
                 // collection counts more inaccurate.
                 LOGV2_WARNING(21637,
@@ -626,7 +625,7 @@ void RollbackImpl::_correctRecordStoreCounts(OperationContext* opCtx) {
                               "namespace"_attr = nss.ns(),
                               "uuid"_attr = uuid.toString(),
                               "ident"_attr = ident,
-                              "error"_attr = exec->statestr(state));
+                              "error"_attr = ex.toStatus());
                 continue;
             }
             newCount = countFromScan;
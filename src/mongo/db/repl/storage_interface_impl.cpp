@@ -1075,6 +1075,15 @@ boost::optional<BSONObj> StorageInterfaceImpl::findOplogEntryLessThanOrEqualToTi
     invariant(oplog);
     invariant(opCtx->lockState()->isLocked());
 
+    // A record id in the oplog collection is equivalent to the document's timestamp field.
+    RecordId desiredRecordId = RecordId(timestamp.asULL());
+
+    // Callers usually pass the timestamp of an existing entry (e.g. a truncate point taken from
+    // all_durable), which a point lookup finds without walking the oplog backwards from its end.
+    if (auto record = oplog->getCursor(opCtx, false /* forward */)->seekExact(desiredRecordId)) {
+        return record->data.toBson().getOwned();
+    }
+
     std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec =
         InternalPlanner::collectionScan(opCtx,
                                         NamespaceString::kRsOplogNamespace.ns(),
@@ -1082,9 +1091,6 @@ boost::optional<BSONObj> StorageInterfaceImpl::findOplogEntryLessThanOrEqualToTi
                                         PlanYieldPolicy::YieldPolicy::NO_YIELD,
                                         InternalPlanner::BACKWARD);
 
-    // A record id in the oplog collection is equivalent to the document's timestamp field.
-    RecordId desiredRecordId = RecordId(timestamp.asULL());
-
     // Iterate the collection in reverse until the desiredRecordId, or one less than, is found.
     BSONObj bson;
     RecordId recordId;
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/update_delete_group.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "mongo/db/repl/oplog_applier_impl.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+// Bounds the amount of data written by a single storage transaction.
+constexpr auto kUpdateDeleteGroupMaxGroupSize = BSONObjMaxUserSize;
+
+// Limit number of ops in a single group.
+constexpr auto kUpdateDeleteGroupMaxOpCount = 64;
+
+bool isUpdateOrDelete(const OplogEntry& entry) {
+    return entry.getOpType() == OpTypeEnum::kUpdate || entry.getOpType() == OpTypeEnum::kDelete;
+}
+
+}  // namespace
+
+UpdateDeleteGroup::UpdateDeleteGroup(std::vector<const OplogEntry*>* ops,
+                                     OperationContext* opCtx,
+                                     UpdateDeleteGroup::Mode mode)
+    : _doNotGroupBeforePoint(ops->cbegin()), _end(ops->cend()), _opCtx(opCtx), _mode(mode) {}
+
+StatusWith<UpdateDeleteGroup::ConstIterator>
+UpdateDeleteGroup::groupAndApplyUpdatesAndDeletes(ConstIterator it) {
+    const auto& entry = **it;
+
+    // The following conditions must be met before attempting to group the oplog entries starting
+    // at 'oplogEntriesIterator':
+    // 1) The CRUD operation must be an update or a delete;
+    // 2) The namespace cannot be system.views, which needs an exclusive lock for every write;
+    // 3) We have not attempted to group this op during a previous call to this function.
+    if (!isUpdateOrDelete(entry)) {
+        return Status(ErrorCodes::TypeMismatch, "Can only group update and delete operations.");
+    }
+    if (entry.getNss().isSystemDotViews()) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "Cannot group update and delete operations on system.views.");
+    }
+    if (it <= _doNotGroupBeforePoint) {
+        return Status(ErrorCodes::InvalidPath,
+                      "Cannot group an operation that we previously attempted to group.");
+    }
+
+    size_t groupSize = entry.getObject().objsize();
+    auto opCount = std::vector<const OplogEntry*>::size_type(1);
+
+    // Find the first op that can't be added to this group. See InsertGroup for an illustration.
+    auto endOfGroupableOpsIterator =
+        std::find_if(it + 1, _end, [&](const OplogEntry* nextEntry) -> bool {
+            groupSize += nextEntry->getObject().objsize();
+            opCount += 1;
+
+            // Only add the op to this group if it passes the criteria.
+            return !isUpdateOrDelete(*nextEntry)               // Must be an update or delete.
+                || nextEntry->getNss() != entry.getNss()       // Must be in the same namespace.
+                || nextEntry->getUuid() != entry.getUuid()     // Must be on the same collection.
+                || groupSize > kUpdateDeleteGroupMaxGroupSize  // Must not grow too large.
+                || opCount > kUpdateDeleteGroupMaxOpCount;     // Limit number of ops in a group.
+        });
+
+    // See if we were able to create a group that contains more than a single op.
+    if (std::distance(it, endOfGroupableOpsIterator) == 1) {
+        return Status(ErrorCodes::NoSuchKey,
+                      "Not able to create a group with more than a single update or delete");
+    }
+
+    auto status = applyGroupedUpdatesAndDeletes(_opCtx, it, endOfGroupableOpsIterator, _mode);
+    if (status.isOK()) {
+        // It succeeded, advance the oplogEntriesIterator to the end of the group.
+        return endOfGroupableOpsIterator - 1;
+    }
+
+    // The group failed and was rolled back as a whole. The ops will be applied one at a time,
+    // which reports or tolerates the failing op according to the application mode.
+    LOGV2_DEBUG(4969700,
+                2,
+                "Error applying updates and deletes as a group. Applying them individually",
+                "firstOp"_attr = redact(entry.toBSON()),
+                "numOps"_attr = std::distance(it, endOfGroupableOpsIterator),
+                "error"_attr = redact(status));
+
+    // Avoid quadratic run time from a failed group by not retrying until we are beyond it.
+    _doNotGroupBeforePoint = endOfGroupableOpsIterator - 1;
+    return status;
+}
+
+}  // namespace repl
+}  // namespace mongo
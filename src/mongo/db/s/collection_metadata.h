@@ -172,6 +172,15 @@ public:
         return _cm->keyBelongsToShard(key, _thisShardId);
     }
 
+    /**
+     * Same as above, but also returns in 'chunkRange' the bounds of the chunk which contains the
+     * key. See ChunkManager::keyBelongsToShard.
+     */
+    bool keyBelongsToMe(const BSONObj& key, boost::optional<ChunkRange>* chunkRange) const {
+        invariant(isSharded());
+        return _cm->keyBelongsToShard(key, _thisShardId, chunkRange);
+    }
+
     /**
      * Given a key 'lookupKey' in the shard key range, get the next chunk which overlaps or is
      * greater than this key.  Returns true if a chunk exists, false otherwise.
@@ -192,6 +192,23 @@ TEST_F(SingleChunkFixture, KeyBelongsToMe) {
     ASSERT(!makeCollectionMetadata()->keyBelongsToMe(BSONObj()));
 }
 
+TEST_F(SingleChunkFixture, KeyBelongsToMeReturnsContainingChunkRange) {
+    boost::optional<ChunkRange> chunkRange;
+    ASSERT(makeCollectionMetadata()->keyBelongsToMe(BSON("a" << 15), &chunkRange));
+    ASSERT(chunkRange);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 10), chunkRange->getMin());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 20), chunkRange->getMax());
+
+    ASSERT(!makeCollectionMetadata()->keyBelongsToMe(BSON("a" << 25), &chunkRange));
+    ASSERT(chunkRange);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 20), chunkRange->getMin());
+    ASSERT_BSONOBJ_EQ(BSON("a" << MAXKEY), chunkRange->getMax());
+
+    chunkRange = boost::none;
+    ASSERT(!makeCollectionMetadata()->keyBelongsToMe(BSONObj(), &chunkRange));
+    ASSERT(!chunkRange);
+}
+
 TEST_F(SingleChunkFixture, GetNextChunk) {
     ChunkType nextChunk;
     ASSERT(
@@ -438,19 +438,29 @@ repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
     std::function<void(OperationContext*, BSONObj)> insertBatchFn,
     std::function<BSONObj(OperationContext*)> fetchBatchFn) {
 
-    SingleProducerSingleConsumerQueue<BSONObj>::Options options;
-    options.maxQueueDepth = 1;
+    // Batches are handed to a pool of inserter threads, each of which applies whole batches with
+    // its own operation context. Documents in a chunk are disjoint, so batches can be inserted in
+    // any order. The queue is kept one batch deep per inserter so that fetching from the donor
+    // stays ahead of insertion without buffering more of the chunk than the inserters can take.
+    const int numInserters = migrateCloneInsertionThreads.load();
 
-    SingleProducerSingleConsumerQueue<BSONObj> batches(options);
+    SingleProducerMultiConsumerQueue<BSONObj>::Options options;
+    options.maxQueueDepth = numInserters;
+
+    SingleProducerMultiConsumerQueue<BSONObj> batches(options);
+    auto lastOpAppliedMutex = MONGO_MAKE_LATCH("MigrationDestinationManager::lastOpAppliedMutex");
     repl::OpTime lastOpApplied;
 
-    stdx::thread inserterThread{[&] {
+    auto runInserter = [&] {
         Client::initKillableThread("chunkInserter", opCtx->getServiceContext());
 
         auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
         auto consumerGuard = makeGuard([&] {
             batches.closeConsumerEnd();
-            lastOpApplied = repl::ReplClientInfo::forClient(inserterOpCtx->getClient()).getLastOp();
+            const auto& lastOp =
+                repl::ReplClientInfo::forClient(inserterOpCtx->getClient()).getLastOp();
+            stdx::lock_guard<Latch> lk(lastOpAppliedMutex);
+            lastOpApplied = std::max(lastOpApplied, lastOp);
         });
 
         try {
@@ -462,6 +472,9 @@ repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
                 }
                 insertBatchFn(inserterOpCtx.get(), arr);
             }
+        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+            // Either another inserter consumed the final empty batch, or one of them failed and
+            // has already interrupted the producer. The same applies if the producer failed.
         } catch (...) {
             stdx::lock_guard<Client> lk(*opCtx->getClient());
             opCtx->getServiceContext()->killOperation(lk, opCtx, ErrorCodes::Error(51008));
@@ -470,13 +483,19 @@ repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
                   "Batch insertion failed",
                   "error"_attr = redact(exceptionToStatus()));
         }
-    }};
+    };
 
+    std::vector<stdx::thread> inserterThreads;
+    for (int i = 0; i < numInserters; ++i) {
+        inserterThreads.emplace_back(runInserter);
+    }
 
     {
         auto inserterThreadJoinGuard = makeGuard([&] {
             batches.closeProducerEnd();
-            inserterThread.join();
+            for (auto& inserterThread : inserterThreads) {
+                inserterThread.join();
+            }
         });
 
         while (true) {
@@ -977,6 +996,8 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
             uassert(50748, "Migration aborted while copying documents", getState() != ABORT);
         };
 
+        auto secondaryThrottleMutex =
+            MONGO_MAKE_LATCH("MigrationDestinationManager::secondaryThrottleMutex");
         auto insertBatchFn = [&](OperationContext* opCtx, BSONObj arr) {
             auto it = arr.begin();
             while (it != arr.end()) {
@@ -1018,6 +1039,9 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
                     _clonedBytes += batchClonedBytes;
                 }
                 if (_writeConcern.needToWaitForOtherNodes()) {
+                    // The session of the outer operation is checked in and out around the wait,
+                    // which concurrent inserters must not do at the same time.
+                    stdx::lock_guard<Latch> lk(secondaryThrottleMutex);
                     runWithoutSession(outerOpCtx, [&] {
                         repl::ReplicationCoordinator::StatusAndDuration replStatus =
                             repl::ReplicationCoordinator::get(opCtx)->awaitReplication(
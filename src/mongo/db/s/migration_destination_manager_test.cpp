@@ -31,6 +31,8 @@
 
 #include "mongo/db/s/migration_destination_manager.h"
 #include "mongo/db/s/shard_server_test_fixture.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -104,6 +106,43 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
     }
 }
 
+// Tests that every fetched batch is inserted exactly once when several inserter threads are used.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWithMultipleInserters) {
+    migrateCloneInsertionThreads.store(4);
+    ON_BLOCK_EXIT([] { migrateCloneInsertionThreads.store(1); });
+
+    const int numBatches = 20;
+    int batchesFetched = 0;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONObjBuilder fetchBatchResultBuilder;
+
+        if (batchesFetched == numBatches) {
+            fetchBatchResultBuilder.append("objects", BSONObj());
+        } else {
+            ++batchesFetched;
+            fetchBatchResultBuilder.append("objects", createDocumentsToCloneArray());
+        }
+
+        return fetchBatchResultBuilder.obj();
+    };
+
+    auto mutex = MONGO_MAKE_LATCH("MigrationDestinationManagerTest::mutex");
+    std::vector<BSONObj> resultDocs;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        stdx::lock_guard<Latch> lk(mutex);
+        for (auto&& docToClone : docs) {
+            resultDocs.push_back(docToClone.Obj().getOwned());
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn);
+
+    ASSERT_EQ(numBatches * createDocumentsToClone().size(), resultDocs.size());
+}
+
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
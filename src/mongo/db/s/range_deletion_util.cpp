@@ -54,9 +54,11 @@
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/wait_for_majority_service.h"
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/range_deletion_task_gen.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_statistics.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/remove_saver.h"
@@ -237,6 +239,39 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
 }
 
 
+/**
+ * Pauses range deletion when the majority commit point trails this node's last applied write by
+ * more than 'rangeDeleterMaxReplicationLagMS', so that orphan cleanup backs off instead of widening
+ * the lag further. The pause grows with the excess lag but is bounded for each batch, so deletion
+ * still makes progress when a majority of the replica set is persistently behind.
+ */
+void throttleForReplicationLag(OperationContext* opCtx) {
+    const Milliseconds maxLag(rangeDeleterMaxReplicationLagMS.load());
+    if (maxLag <= Milliseconds(0)) {
+        return;
+    }
+
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (!replCoord->isReplEnabled()) {
+        return;
+    }
+
+    const auto lag = replCoord->getMyLastAppliedOpTimeAndWallTime().wallTime -
+        replCoord->getLastCommittedOpTimeAndWallTime().wallTime;
+    if (lag <= maxLag) {
+        return;
+    }
+
+    const auto pause = std::min(lag - maxLag, Milliseconds(Seconds(1)));
+    LOGV2_DEBUG(4797800,
+                2,
+                "Pausing range deletion because of replication lag",
+                "replicationLag"_attr = lag,
+                "pause"_attr = pause);
+    ShardingStatistics::get(opCtx).countRangeDeleterReplicationLagPauses.addAndFetch(1);
+    opCtx->sleepFor(pause);
+}
+
 template <typename Callable>
 auto withTemporaryOperationContext(Callable&& callable) {
     ThreadClient tc(migrationutil::kRangeDeletionThreadName, getGlobalServiceContext());
@@ -303,18 +338,21 @@ ExecutorFuture<void> deleteRangeInBatches(const std::shared_ptr<executor::TaskEx
                        ensureRangeDeletionTaskStillExists(opCtx, *migrationId);
                    }
 
-                   AutoGetCollection autoColl(opCtx, nss, MODE_IX);
-                   auto* const collection = autoColl.getCollection();
+                   auto numDeleted = [&] {
+                       AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+                       auto* const collection = autoColl.getCollection();
 
-                   // Ensure the collection exists and has not been dropped or dropped and
-                   // recreated.
-                   uassert(ErrorCodes::RangeDeletionAbandonedBecauseCollectionWithUUIDDoesNotExist,
+                       // Ensure the collection exists and has not been dropped or dropped and
+                       // recreated.
+                       uassert(
+                           ErrorCodes::RangeDeletionAbandonedBecauseCollectionWithUUIDDoesNotExist,
                            "Collection has been dropped since enqueuing this range "
                            "deletion task. No need to delete documents.",
                            !collectionUuidHasChanged(nss, collection, collectionUuid));
 
-                   auto numDeleted = uassertStatusOK(deleteNextBatch(
-                       opCtx, collection, keyPattern, range, numDocsToRemovePerBatch));
+                       return uassertStatusOK(deleteNextBatch(
+                           opCtx, collection, keyPattern, range, numDocsToRemovePerBatch));
+                   }();
 
                    LOGV2_DEBUG(
                        23769,
@@ -327,6 +365,11 @@ ExecutorFuture<void> deleteRangeInBatches(const std::shared_ptr<executor::TaskEx
                        "collectionUUID"_attr = collectionUuid,
                        "range"_attr = range.toString());
 
+                   // Back off outside of the collection lock, before the next batch is scheduled.
+                   if (numDeleted > 0) {
+                       throttleForReplicationLag(opCtx);
+                   }
+
                    return numDeleted;
                });
            })
@@ -29,9 +29,12 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/s/resharding_util.h"
+
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/operation_context.h"
-#include "mongo/db/s/resharding_util.h"
 #include "mongo/s/grid.h"
 
 namespace mongo {
@@ -110,4 +113,92 @@ void validateZones(const std::vector<mongo::BSONObj>& zones,
     checkForOverlappingZones(validZones);
 }
 
-}  // namespace mongo
\ No newline at end of file
+NamespaceString constructTemporaryReshardingNss(StringData db, const UUID& sourceUuid) {
+    return NamespaceString(db, str::stream() << "system.resharding." << sourceUuid.toString());
+}
+
+std::vector<std::vector<ChunkRange>> partitionRecipientRangesForCloning(
+    std::vector<ReshardedChunk> chunks, const ShardId& recipientShardId, size_t numPartitions) {
+    invariant(numPartitions > 0);
+
+    std::sort(chunks.begin(), chunks.end(), [](const ReshardedChunk& a, const ReshardedChunk& b) {
+        return SimpleBSONObjComparator::kInstance.evaluate(a.getMin() < b.getMin());
+    });
+
+    std::vector<ChunkRange> ownedChunks;
+    for (const auto& chunk : chunks) {
+        if (chunk.getRecipientShardId() == recipientShardId) {
+            ownedChunks.emplace_back(chunk.getMin(), chunk.getMax());
+        }
+    }
+
+    // Adjacent chunks which end up in the same partition are coalesced so that each reader
+    // issues as few range predicates as possible.
+    std::vector<std::vector<ChunkRange>> partitions;
+    if (ownedChunks.empty()) {
+        return partitions;
+    }
+
+    numPartitions = std::min(numPartitions, ownedChunks.size());
+    partitions.resize(numPartitions);
+    for (size_t i = 0; i < ownedChunks.size(); ++i) {
+        auto& partition = partitions[i * numPartitions / ownedChunks.size()];
+        const auto& range = ownedChunks[i];
+        if (!partition.empty() &&
+            SimpleBSONObjComparator::kInstance.evaluate(partition.back().getMax() ==
+                                                        range.getMin())) {
+            partition.back() = ChunkRange(partition.back().getMin(), range.getMax());
+        } else {
+            partition.push_back(range);
+        }
+    }
+
+    return partitions;
+}
+
+BSONObj createRangeFilterForCloning(const KeyPattern& keyPattern,
+                                    const std::vector<ChunkRange>& ranges) {
+    invariant(!ranges.empty());
+    uassert(ErrorCodes::InvalidOptions,
+            "Range-partitioned cloning is not supported for hashed shard keys",
+            IndexNames::findPluginName(keyPattern.toBSON()) != IndexNames::HASHED);
+
+    // The shard key value of a document compared against a range bound as arrays gives the
+    // lexicographic comparison of the shard key, without the type bracketing of query operators.
+    auto appendKeyValues = [](BSONArrayBuilder* builder, const BSONObj& bound) {
+        for (const auto& elem : bound) {
+            BSONObjBuilder literal(builder->subobjStart());
+            literal.appendAs(elem, "$literal");
+        }
+    };
+
+    BSONObjBuilder filterBuilder;
+    BSONObjBuilder exprBuilder(filterBuilder.subobjStart("$expr"));
+    BSONArrayBuilder orBuilder(exprBuilder.subarrayStart("$or"));
+    for (const auto& range : ranges) {
+        BSONObjBuilder rangeBuilder(orBuilder.subobjStart());
+        BSONArrayBuilder andBuilder(rangeBuilder.subarrayStart("$and"));
+        for (auto&& [op, bound] : {std::make_pair("$gte", range.getMin()),
+                                   std::make_pair("$lt", range.getMax())}) {
+            BSONObjBuilder cmpBuilder(andBuilder.subobjStart());
+            BSONArrayBuilder operands(cmpBuilder.subarrayStart(op));
+            {
+                BSONArrayBuilder key(operands.subarrayStart());
+                for (const auto& field : keyPattern.toBSON()) {
+                    BSONObjBuilder ifNull(key.subobjStart());
+                    ifNull.append("$ifNull",
+                                  BSON_ARRAY(std::string("$") + field.fieldName() << BSONNULL));
+                }
+            }
+            {
+                BSONArrayBuilder boundValues(operands.subarrayStart());
+                appendKeyValues(&boundValues, bound);
+            }
+        }
+    }
+    orBuilder.doneFast();
+    exprBuilder.doneFast();
+    return filterBuilder.obj();
+}
+
+}  // namespace mongo
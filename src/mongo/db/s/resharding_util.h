@@ -32,8 +32,11 @@
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_tags.h"
+#include "mongo/util/uuid.h"
 #include "mongo/s/resharded_chunk_gen.h"
 
 namespace mongo {
@@ -66,4 +69,27 @@ void checkForOverlappingZones(std::vector<TagsType>& zones);
 void validateZones(const std::vector<mongo::BSONObj>& zones,
                    const std::vector<TagsType>& authoritativeTags);
 
+/**
+ * Returns the namespace of the temporary collection into which a recipient shard clones the
+ * documents of the collection with UUID 'sourceUuid' in database 'db'.
+ */
+NamespaceString constructTemporaryReshardingNss(StringData db, const UUID& sourceUuid);
+
+/**
+ * Selects the chunks in 'chunks' owned by 'recipientShardId', coalesces adjacent ranges and
+ * splits the result into at most 'numPartitions' groups of roughly equal chunk count, so that
+ * each group can be cloned from the donor shards by a separate reader. Groups are ordered by
+ * their position in the new shard key space and never share a range.
+ */
+std::vector<std::vector<ChunkRange>> partitionRecipientRangesForCloning(
+    std::vector<ReshardedChunk> chunks, const ShardId& recipientShardId, size_t numPartitions);
+
+/**
+ * Returns a query filter which matches the documents whose value for the (non-hashed) shard key
+ * 'keyPattern' falls within any of 'ranges'. Missing shard key fields are treated as null and
+ * comparisons use the full BSON ordering, consistent with how documents are assigned to chunks.
+ */
+BSONObj createRangeFilterForCloning(const KeyPattern& keyPattern,
+                                    const std::vector<ChunkRange>& ranges);
+
 }  // namespace mongo
\ No newline at end of file
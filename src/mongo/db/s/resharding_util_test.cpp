@@ -30,6 +30,9 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/s/config/config_server_test_fixture.h"
 #include "mongo/db/s/resharding_util.h"
 #include "mongo/s/catalog/type_shard.h"
@@ -219,5 +222,76 @@ TEST_F(ReshardingUtilTest, FailWhenOverlappingZones) {
     ASSERT_THROWS_CODE(validateZones(zones, authoritativeTags), DBException, ErrorCodes::BadValue);
 }
 
+TEST_F(ReshardingUtilTest, ConstructTemporaryReshardingNss) {
+    const auto uuid = UUID::gen();
+    auto tempNss = constructTemporaryReshardingNss(nss().db(), uuid);
+    ASSERT_EQ(tempNss.db(), nss().db());
+    ASSERT_EQ(tempNss.coll(), "system.resharding." + uuid.toString());
+}
+
+TEST_F(ReshardingUtilTest, PartitionRecipientRangesForCloning) {
+    auto chunk = [&](const BSONObj& min, const BSONObj& max, StringData shardId) {
+        return ReshardedChunk(ShardId(shardId.toString()), min, max);
+    };
+    std::vector<ReshardedChunk> chunks = {
+        chunk(BSON(shardKey() << 30), BSON(shardKey() << 40), "a"),
+        chunk(keyPattern().globalMin(), BSON(shardKey() << 10), "a"),
+        chunk(BSON(shardKey() << 10), BSON(shardKey() << 20), "a"),
+        chunk(BSON(shardKey() << 20), BSON(shardKey() << 30), "b"),
+        chunk(BSON(shardKey() << 40), keyPattern().globalMax(), "a"),
+    };
+
+    // The four chunks owned by shard 'a' split into two partitions of two chunks each, with the
+    // adjacent chunks within each partition coalesced.
+    auto partitions = partitionRecipientRangesForCloning(chunks, ShardId("a"), 2);
+    ASSERT_EQ(partitions.size(), 2UL);
+    ASSERT_EQ(partitions[0].size(), 1UL);
+    ASSERT_BSONOBJ_EQ(partitions[0][0].getMin(), keyPattern().globalMin());
+    ASSERT_BSONOBJ_EQ(partitions[0][0].getMax(), BSON(shardKey() << 20));
+    ASSERT_EQ(partitions[1].size(), 1UL);
+    ASSERT_BSONOBJ_EQ(partitions[1][0].getMin(), BSON(shardKey() << 30));
+    ASSERT_BSONOBJ_EQ(partitions[1][0].getMax(), keyPattern().globalMax());
+
+    // Asking for more partitions than there are chunks yields one partition per chunk.
+    ASSERT_EQ(partitionRecipientRangesForCloning(chunks, ShardId("a"), 10).size(), 4UL);
+    ASSERT_EQ(partitionRecipientRangesForCloning(chunks, ShardId("b"), 10).size(), 1UL);
+    ASSERT(partitionRecipientRangesForCloning(chunks, ShardId("c"), 10).empty());
+}
+
+TEST_F(ReshardingUtilTest, RangeFilterForCloningUsesShardKeyOrdering) {
+    const KeyPattern compoundKey(BSON("x" << 1 << "y" << 1));
+    const std::vector<ChunkRange> ranges = {
+        ChunkRange(BSON("x" << MINKEY << "y" << MINKEY), BSON("x" << 0 << "y" << 5)),
+        ChunkRange(BSON("x" << 10 << "y" << MINKEY), BSON("x" << MAXKEY << "y" << MAXKEY)),
+    };
+
+    auto expCtx = make_intrusive<ExpressionContextForTest>(operationContext());
+    auto matcher = uassertStatusOK(
+        MatchExpressionParser::parse(createRangeFilterForCloning(compoundKey, ranges),
+                                     expCtx,
+                                     ExtensionsCallbackNoop(),
+                                     MatchExpressionParser::kAllowAllSpecialFeatures));
+
+    // Missing shard key fields are ordered as null, below every number.
+    ASSERT(matcher->matchesBSON(BSONObj()));
+    ASSERT(matcher->matchesBSON(BSON("x" << -1 << "y" << 100)));
+    ASSERT(matcher->matchesBSON(BSON("x" << 0 << "y" << 4)));
+    ASSERT_FALSE(matcher->matchesBSON(BSON("x" << 0 << "y" << 5)));
+    ASSERT_FALSE(matcher->matchesBSON(BSON("x" << 5)));
+    ASSERT(matcher->matchesBSON(BSON("x" << 10)));
+    // Values of types ordered after numbers belong to the upper range despite type bracketing.
+    ASSERT(matcher->matchesBSON(BSON("x"
+                                     << "string")));
+}
+
+TEST_F(ReshardingUtilTest, RangeFilterForCloningRejectsHashedShardKey) {
+    const KeyPattern hashedKey(BSON("x"
+                                    << "hashed"));
+    const std::vector<ChunkRange> ranges = {
+        ChunkRange(hashedKey.globalMin(), hashedKey.globalMax())};
+    ASSERT_THROWS_CODE(
+        createRangeFilterForCloning(hashedKey, ranges), DBException, ErrorCodes::InvalidOptions);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -104,6 +104,10 @@ public:
     bool keyBelongsToMe(const BSONObj& key) const {
         return _impl->get().keyBelongsToMe(key);
     }
+
+    bool keyBelongsToMe(const BSONObj& key, boost::optional<ChunkRange>* chunkRange) const {
+        return _impl->get().keyBelongsToMe(key, chunkRange);
+    }
 };
 
 }  // namespace mongo
@@ -360,32 +360,56 @@ Status updateShardChunks(OperationContext* opCtx,
          * {_id: 14, max: 19, version 7.1}
          * {_id: 19, max: 22, version 2.0}
          *
+         * The chunks returned by the config server never overlap one another, so the overlap
+         * deletes and the inserts are grouped into batched write commands rather than issuing
+         * two commands per chunk. Within each batch all of the deletes are applied before any
+         * of the inserts, which preserves the per-chunk "delete overlap, then insert" semantics.
          */
-        for (auto& chunk : chunks) {
-            invariant(chunk.getVersion().epoch() == currEpoch);
+        auto it = chunks.begin();
+        while (it != chunks.end()) {
+            std::vector<write_ops::DeleteOpEntry> deletes;
+            std::vector<BSONObj> inserts;
+            int batchBytes = 0;
+
+            for (; it != chunks.end() && inserts.size() < write_ops::kMaxWriteBatchSize; ++it) {
+                const auto& chunk = *it;
+                invariant(chunk.getVersion().epoch() == currEpoch);
+
+                // Delete any overlapping chunk ranges. Overlapping chunks will have a min value
+                // ("_id") between (chunk.min, chunk.max].
+                //
+                // query: { "_id" : {"$gte": chunk.min, "$lt": chunk.max}}
+                write_ops::DeleteOpEntry entry;
+                entry.setQ(BSON(ChunkType::minShardID
+                                << BSON("$gte" << chunk.getMin() << "$lt" << chunk.getMax())));
+                entry.setMulti(true);
+
+                auto doc = chunk.toShardBSON();
+
+                // Keep each command comfortably below the maximum user document size, since
+                // the deletes and the inserts are each serialized into a single command object.
+                const int chunkBytes = doc.objsize() + entry.getQ().objsize();
+                if (!inserts.empty() && batchBytes + chunkBytes > BSONObjMaxUserSize / 2) {
+                    break;
+                }
+                batchBytes += chunkBytes;
+
+                deletes.push_back(std::move(entry));
+                inserts.push_back(std::move(doc));
+            }
 
-            // Delete any overlapping chunk ranges. Overlapping chunks will have a min value
-            // ("_id") between (chunk.min, chunk.max].
-            //
-            // query: { "_id" : {"$gte": chunk.min, "$lt": chunk.max}}
             auto deleteCommandResponse = client.runCommand([&] {
                 write_ops::Delete deleteOp(chunkMetadataNss);
-                deleteOp.setDeletes({[&] {
-                    write_ops::DeleteOpEntry entry;
-                    entry.setQ(BSON(ChunkType::minShardID
-                                    << BSON("$gte" << chunk.getMin() << "$lt" << chunk.getMax())));
-                    entry.setMulti(true);
-                    return entry;
-                }()});
+                deleteOp.setDeletes(std::move(deletes));
                 return deleteOp.serialize({});
             }());
             uassertStatusOK(
                 getStatusFromWriteCommandResponse(deleteCommandResponse->getCommandReply()));
 
-            // Now the document can be expected to cleanly insert without overlap
+            // Now the documents can be expected to cleanly insert without overlap
             auto insertCommandResponse = client.runCommand([&] {
                 write_ops::Insert insertOp(chunkMetadataNss);
-                insertOp.setDocuments({chunk.toShardBSON()});
+                insertOp.setDocuments(std::move(inserts));
                 return insertOp.serialize({});
             }());
             uassertStatusOK(
@@ -319,6 +319,40 @@ TEST_F(ShardMetadataUtilTest, UpdateWithWriteNewChunks) {
     checkChunks(kChunkMetadataNss, chunks);
 }
 
+TEST_F(ShardMetadataUtilTest, UpdateWithManyChunksThenMerge) {
+    // Persist enough chunks that each refresh spans several entries of a single batched write.
+    std::vector<ChunkType> chunks;
+    const int kNumChunks = 500;
+    for (int i = 0; i < kNumChunks; ++i) {
+        maxCollVersion.incMinor();
+        BSONObj shardChunk =
+            BSON(ChunkType::minShardID(i == 0 ? BSON("a" << MINKEY) : BSON("a" << i))
+                 << ChunkType::max(i == kNumChunks - 1 ? BSON("a" << MAXKEY) : BSON("a" << i + 1))
+                 << ChunkType::shard(kShardId.toString())
+                 << ChunkType::lastmod(Date_t::fromMillisSinceEpoch(maxCollVersion.toLong())));
+        chunks.push_back(assertGet(ChunkType::fromShardBSON(shardChunk, maxCollVersion.epoch())));
+    }
+
+    ASSERT_OK(updateShardChunks(operationContext(), kNss, chunks, maxCollVersion.epoch()));
+    checkChunks(kChunkMetadataNss, chunks);
+
+    // Merge every other pair of chunks; each merged chunk must replace both of its predecessors.
+    std::vector<ChunkType> mergedChunks;
+    for (int i = 0; i < kNumChunks; i += 2) {
+        maxCollVersion.incMinor();
+        ChunkType merged = chunks[i];
+        merged.setMax(chunks[i + 1].getMax());
+        merged.setVersion(maxCollVersion);
+        mergedChunks.push_back(merged);
+    }
+
+    ASSERT_OK(updateShardChunks(operationContext(), kNss, mergedChunks, maxCollVersion.epoch()));
+    checkChunks(kChunkMetadataNss, mergedChunks);
+
+    DBDirectClient client(operationContext());
+    ASSERT_EQUALS(client.count(kChunkMetadataNss), mergedChunks.size());
+}
+
 TEST_F(ShardMetadataUtilTest, DropChunksAndDeleteCollectionsEntry) {
     setUpShardChunkMetadata();
     ASSERT_OK(dropChunksAndDeleteCollectionsEntry(operationContext(), kNss));
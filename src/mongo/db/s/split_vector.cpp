@@ -44,7 +44,9 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/logv2/log.h"
+#include "mongo/s/shard_key_pattern.h"
 
 namespace mongo {
 namespace {
@@ -52,10 +54,116 @@ namespace {
 const int kMaxObjectPerChunk{250000};
 const int estimatedAdditionalBytesPerItemInBSONArray{2};
 
+// Sampled split points are only trusted if at least this many sampled documents fall in the range
+// being split, and at least kMinSampledKeysPerChunk fall in each of the resulting chunks.
+const size_t kMinSampledKeysInRange{100};
+const size_t kMinSampledKeysPerChunk{10};
+
 BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
 
+/**
+ * Chooses approximately evenly spaced split points for the range [min, max) from the shard keys of
+ * 'sampleSize' random documents of the collection, instead of scanning every key in the range.
+ *
+ * Returns boost::none if the storage engine does not support random cursors or if too few of the
+ * sampled documents fall in the range for the sample to be representative, in which case the
+ * caller should scan the shard key index instead.
+ */
+boost::optional<std::vector<BSONObj>> sampleSplitKeys(OperationContext* opCtx,
+                                                      const NamespaceString& nss,
+                                                      Collection* collection,
+                                                      const BSONObj& keyPattern,
+                                                      const BSONObj& min,
+                                                      const BSONObj& max,
+                                                      bool force,
+                                                      boost::optional<long long> maxSplitPoints,
+                                                      long long recCount,
+                                                      long long keyCount,
+                                                      int sampleSize) {
+    auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return boost::none;
+    }
+
+    const ShardKeyPattern shardKeyPattern(keyPattern);
+    std::vector<BSONObj> sampledKeys;
+    int numSampled = 0;
+    for (; numSampled < sampleSize; numSampled++) {
+        if (numSampled % 128 == 0) {
+            opCtx->checkForInterrupt();
+        }
+
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+
+        auto shardKey = shardKeyPattern.extractShardKeyFromDoc(record->data.toBson());
+        if (shardKey.isEmpty() || (!min.isEmpty() && shardKey.woCompare(min) < 0) ||
+            (!max.isEmpty() && shardKey.woCompare(max) >= 0)) {
+            continue;
+        }
+
+        sampledKeys.push_back(std::move(shardKey));
+    }
+
+    if (sampledKeys.size() < kMinSampledKeysInRange) {
+        return boost::none;
+    }
+
+    // Scale the fraction of sampled documents which fell in the range up to the whole collection to
+    // estimate how many documents the range contains, and from that how many splits it needs.
+    const long long estimatedRangeCount = recCount * sampledKeys.size() / numSampled;
+    long long numSplits = force ? 1 : estimatedRangeCount / std::max(keyCount, 1LL);
+    if (maxSplitPoints && maxSplitPoints.get()) {
+        numSplits = std::min(numSplits, maxSplitPoints.get());
+    }
+
+    if (sampledKeys.size() < kMinSampledKeysPerChunk * (numSplits + 1)) {
+        return boost::none;
+    }
+
+    std::sort(sampledKeys.begin(),
+              sampledKeys.end(),
+              SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    // Pick the keys at evenly spaced positions of the sorted sample. As with the index scan, a key
+    // equal to the previous split point (or to the smallest key in the range) is skipped, so that
+    // all the instances of a given key value live in the same chunk.
+    std::vector<BSONObj> splitKeys;
+    std::size_t splitVectorResponseSize = 0;
+    for (long long i = 1; i <= numSplits; i++) {
+        const auto& key = sampledKeys[i * sampledKeys.size() / (numSplits + 1)];
+        const auto& previousKey = splitKeys.empty() ? sampledKeys.front() : splitKeys.back();
+        if (key.woCompare(previousKey) == 0) {
+            continue;
+        }
+
+        auto additionalKeySize = key.objsize() + estimatedAdditionalBytesPerItemInBSONArray;
+        if (splitVectorResponseSize + additionalKeySize > BSONObjMaxUserSize) {
+            break;
+        }
+
+        splitVectorResponseSize += additionalKeySize;
+        splitKeys.push_back(key);
+    }
+
+    LOGV2(4798000,
+          "Picked {numSplits} split points for chunk {namespace} {minKey} -->> {maxKey} from "
+          "{numSampled} sampled documents, of which {numSampledInRange} fell in the range",
+          "Picked split points from sampled documents",
+          "numSplits"_attr = splitKeys.size(),
+          "namespace"_attr = nss.toString(),
+          "minKey"_attr = redact(min),
+          "maxKey"_attr = redact(max),
+          "numSampled"_attr = numSampled,
+          "numSampledInRange"_attr = sampledKeys.size());
+
+    return splitKeys;
+}
+
 }  // namespace
 
 std::vector<BSONObj> splitVector(OperationContext* opCtx,
@@ -153,6 +261,22 @@ std::vector<BSONObj> splitVector(OperationContext* opCtx,
             keyCount = maxChunkObjects.get();
         }
 
+        if (auto sampleSize = splitVectorSampleSize.load()) {
+            if (auto sampledSplitKeys = sampleSplitKeys(opCtx,
+                                                        nss,
+                                                        collection,
+                                                        keyPattern,
+                                                        min,
+                                                        max,
+                                                        force,
+                                                        maxSplitPoints,
+                                                        recCount,
+                                                        keyCount,
+                                                        sampleSize)) {
+                return std::move(*sampledSplitKeys);
+            }
+        }
+
         //
         // Traverse the index and add the keyCount-th key to the result vector. If that key
         // appeared in the vector before, we omit it. The invariant here is that all the
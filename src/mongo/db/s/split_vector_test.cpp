@@ -35,7 +35,9 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/shard_server_test_fixture.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/split_vector.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -151,6 +153,26 @@ TEST_F(SplitVectorTest, MaxChunkObjectsSet) {
     }
 }
 
+TEST_F(SplitVectorTest, SamplingFallsBackToIndexScanWithoutRandomCursor) {
+    // The storage engine used by the test fixture does not support random cursors, so the split
+    // points must be the exact ones found by scanning the index.
+    splitVectorSampleSize.store(1000);
+    ON_BLOCK_EXIT([] { splitVectorSampleSize.store(0); });
+
+    std::vector<BSONObj> splitKeys = splitVector(operationContext(),
+                                                 kNss,
+                                                 BSON(kPattern << 1),
+                                                 BSON(kPattern << 0),
+                                                 BSON(kPattern << 100),
+                                                 false,
+                                                 boost::none,
+                                                 boost::none,
+                                                 getDocSizeBytes() * 100LL);
+    std::vector<BSONObj> expected = {BSON(kPattern << 50)};
+    ASSERT_EQ(splitKeys.size(), expected.size());
+    ASSERT_BSONOBJ_EQ(splitKeys.front(), expected.front());
+}
+
 TEST_F(SplitVectorTest, SplitEveryThird) {
     std::vector<BSONObj> splitKeys = splitVector(operationContext(),
                                                  kNss,
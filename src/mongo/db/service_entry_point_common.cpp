@@ -78,6 +78,7 @@
 #include "mongo/db/service_entry_point_common.h"
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/query_stats_store.h"
 #include "mongo/db/stats/server_read_concern_metrics.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/transaction_participant.h"
@@ -95,6 +96,7 @@
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/transport/ismaster_metrics.h"
 #include "mongo/transport/session.h"
+#include "mongo/util/cpu_profiler.h"
 #include "mongo/util/duration.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
@@ -690,7 +692,7 @@ bool runCommandImpl(OperationContext* opCtx,
                     BSONObjBuilder* extraFieldsBuilder,
                     const OperationSessionInfoFromClient& sessionOptions) {
     const Command* command = invocation->definition();
-    auto bytesToReserve = command->reserveBytesForReply();
+    auto bytesToReserve = command->bytesToReserveForReply();
 // SERVER-22100: In Windows DEBUG builds, the CRT heap debugging overhead, in conjunction with the
 // additional memory pressure introduced by reply buffer pre-allocation, causes the concurrency
 // suite to run extremely slowly. As a workaround we do not pre-allocate in Windows DEBUG builds.
@@ -920,6 +922,7 @@ void execCommandDatabase(OperationContext* opCtx,
                          rpc::ReplyBuilderInterface* replyBuilder,
                          const ServiceEntryPointCommon::Hooks& behaviors) {
     CommandHelpers::uassertShouldAttemptParse(opCtx, command, request);
+    CpuProfiler::ScopedTag cpuProfilerTag(command->getName());
     BSONObjBuilder extraFieldsBuilder;
     auto startOperationTime = getClientOperationTime(opCtx);
 
@@ -984,6 +987,7 @@ void execCommandDatabase(OperationContext* opCtx,
         BSONElement cmdOptionMaxTimeMSField;
         BSONElement maxTimeMSOpOnlyField;
         BSONElement allowImplicitCollectionCreationField;
+        BSONElement admissionPriorityField;
         BSONElement helpField;
 
         StringMap<int> topLevelFields;
@@ -998,6 +1002,8 @@ void execCommandDatabase(OperationContext* opCtx,
                 maxTimeMSOpOnlyField = element;
             } else if (fieldName == "allowImplicitCollectionCreation") {
                 allowImplicitCollectionCreationField = element;
+            } else if (fieldName == "admissionPriority") {
+                admissionPriorityField = element;
             } else if (fieldName == CommandHelpers::kHelpFieldName) {
                 helpField = element;
             } else if (fieldName == "comment") {
@@ -1107,6 +1113,28 @@ void execCommandDatabase(OperationContext* opCtx,
             }
         }
 
+        // The internal clients of a replica set outside of a sharded cluster are the other
+        // members of the set, which wait for storage engine tickets ahead of user operations unless
+        // they ask otherwise. Shards and config servers also count mongos as an internal client, so
+        // user operations routed through mongos keep the normal priority there.
+        if (isInternalClient && serverGlobalParams.clusterRole == ClusterRole::None) {
+            opCtx->setAdmissionPriority(AdmissionPriority::kHigh);
+        }
+        if (admissionPriorityField) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "admissionPriority must be a string",
+                    admissionPriorityField.type() == String);
+            const auto priority = uassertStatusOK(
+                parseAdmissionPriority(admissionPriorityField.valueStringData()));
+            uassert(ErrorCodes::Unauthorized,
+                    "Only users authorized for internal actions can use admissionPriority 'high'",
+                    priority != AdmissionPriority::kHigh ||
+                        AuthorizationSession::get(opCtx->getClient())
+                            ->isAuthorizedForActionsOnResource(
+                                ResourcePattern::forClusterResource(), ActionType::internal));
+            opCtx->setAdmissionPriority(priority);
+        }
+
         auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
 
         // If the parent operation runs in a transaction, we don't override the read concern.
@@ -1421,7 +1449,11 @@ DbResponse receivedCommands(OperationContext* opCtx,
     }
 
     dbResponse.response = replyBuilder->done();
-    CurOp::get(opCtx)->debug().responseLength = dbResponse.response.header().dataLen();
+    CurOp::get(opCtx)->debug().responseLength =
+        dbResponse.response.headerWithoutFlattening().dataLen();
+    if (c) {
+        c->noteReplySize(dbResponse.response.size());
+    }
 
     return dbResponse;
 }
@@ -1639,6 +1671,30 @@ DbResponse receivedGetMore(OperationContext* opCtx,
     return dbresponse;
 }
 
+/**
+ * Adds the cost of the completed operation to the statistics of its query shape, if it has one.
+ * Only operations which planned a query eligible for the plan cache have a queryHash.
+ */
+void recordQueryStats(OperationContext* opCtx, CurOp& currentOp) {
+    const OpDebug& debug = currentOp.debug();
+    if (!QueryStatsStore::isEnabled() || !debug.queryHash || !currentOp.getCommand() ||
+        !opCtx->shouldIncrementLatencyStats()) {
+        return;
+    }
+
+    QueryStatsMetrics metrics;
+    metrics.latencyMicros = durationCount<Microseconds>(debug.executionTime);
+    metrics.docsExamined = debug.additiveMetrics.docsExamined.value_or(0);
+    metrics.keysExamined = debug.additiveMetrics.keysExamined.value_or(0);
+    metrics.nreturned = std::max(debug.nreturned, 0LL);
+    metrics.bytesReturned = std::max(debug.responseLength, 0);
+
+    QueryStatsStore::get(opCtx->getServiceContext())
+        .record({currentOp.getNS(), currentOp.getCommand()->getName(), *debug.queryHash},
+                metrics,
+                opCtx->getServiceContext()->getFastClockSource()->now());
+}
+
 }  // namespace
 
 BSONObj ServiceEntryPointCommon::getRedactedCopyForLogging(const Command* command,
@@ -1776,6 +1832,8 @@ Future<DbResponse> ServiceEntryPointCommon::handleRequest(OperationContext* opCt
             durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
             currentOp.getReadWriteType());
 
+    recordQueryStats(opCtx, currentOp);
+
     if (currentOp.shouldDBProfile(shouldSample)) {
         // Performance profiling is on
         if (opCtx->lockState()->isReadLocked()) {
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <array>
 #include <boost/optional.hpp>
 #include <vector>
 
@@ -91,13 +92,13 @@ public:
     SessionToKill checkOutSessionForKill(OperationContext* opCtx, KillToken killToken);
 
     /**
-     * Iterates through the SessionCatalog under the SessionCatalog mutex and applies 'workerFn' to
-     * each Session which matches the specified 'matcher'.
+     * Iterates through the SessionCatalog and applies 'workerFn' to each Session which matches the
+     * specified 'matcher'. The catalog is visited one partition at a time and 'workerFn' is invoked
+     * under the mutex of the partition, which owns the session being observed, so the scan is not
+     * an atomic snapshot of the whole catalog.
      *
-     * NOTE: Since this method runs with the session catalog mutex, the work done by 'workerFn' is
-     * not allowed to block, perform I/O or acquire any lock manager locks.
-     * Iterates through the SessionCatalog and applies 'workerFn' to each Session. This locks the
-     * SessionCatalog.
+     * NOTE: Since this method runs with a session catalog partition mutex, the work done by
+     * 'workerFn' is not allowed to block, perform I/O or acquire any lock manager locks.
      */
     using ScanSessionsCallbackFn = std::function<void(ObservableSession&)>;
     void scanSession(const LogicalSessionId& lsid, const ScanSessionsCallbackFn& workerFn);
@@ -105,8 +106,8 @@ public:
                       const ScanSessionsCallbackFn& workerFn);
 
     /**
-     * Shortcut to invoke 'kill' on the specified session under the SessionCatalog mutex. Throws a
-     * NoSuchSession exception if the session doesn't exist.
+     * Shortcut to invoke 'kill' on the specified session under its SessionCatalog partition mutex.
+     * Throws a NoSuchSession exception if the session doesn't exist.
      */
     KillToken killSession(const LogicalSessionId& lsid);
 
@@ -129,22 +130,45 @@ private:
         // sessions entries from the map.
         int numWaitingToCheckOut{0};
 
-        // Signaled when the state becomes available. Uses the transaction table's mutex to protect
-        // the state transitions.
+        // Signaled when the state becomes available. Uses the mutex of the owning partition to
+        // protect the state transitions.
         stdx::condition_variable availableCondVar;
     };
     using SessionRuntimeInfoMap = LogicalSessionIdMap<std::unique_ptr<SessionRuntimeInfo>>;
 
+    /**
+     * Every retryable write and transaction statement checks out its session, so rather than
+     * serializing all of them on a single mutex, the sessions are spread by the hash of their
+     * LogicalSessionId over a fixed number of independently locked partitions.
+     */
+    static constexpr size_t kNumPartitions = 16;
+
+    struct Partition {
+        // Protects the sessions map below and the state of all sessions owned by it
+        mutable Mutex mutex =
+            MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "SessionCatalog::Partition::mutex");
+
+        // Owns the Session objects for all current Sessions, which hash to this partition.
+        SessionRuntimeInfoMap sessions;
+    };
+
+    /**
+     * Returns the partition which owns (or would own) the session for 'lsid'.
+     */
+    Partition& _getPartition(const LogicalSessionId& lsid);
+
     /**
      * Blocking method, which checks-out the session set on 'opCtx'.
      */
     ScopedCheckedOutSession _checkOutSession(OperationContext* opCtx);
 
     /**
-     * Creates or returns the session runtime info for 'lsid' from the '_sessions' map. The returned
-     * pointer is guaranteed to be linked on the map for as long as the mutex is held.
+     * Creates or returns the session runtime info for 'lsid' from the sessions map of 'partition'.
+     * The returned pointer is guaranteed to be linked on the map for as long as the partition mutex
+     * is held.
      */
     SessionRuntimeInfo* _getOrCreateSessionRuntimeInfo(WithLock,
+                                                       Partition& partition,
                                                        OperationContext* opCtx,
                                                        const LogicalSessionId& lsid);
 
@@ -153,12 +177,9 @@ private:
      */
     void _releaseSession(SessionRuntimeInfo* sri, boost::optional<KillToken> killToken);
 
-    // Protects the state below
-    mutable Mutex _mutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "SessionCatalog::_mutex");
-
-    // Owns the Session objects for all current Sessions.
-    SessionRuntimeInfoMap _sessions;
+    // Owns the Session objects for all current Sessions. A thread never holds the mutexes of more
+    // than one partition at a time.
+    std::array<Partition, kNumPartitions> _partitions;
 };
 
 /**
@@ -242,8 +263,8 @@ using SessionToKill = SessionCatalog::SessionToKill;
 /**
  * This type represents access to a session inside of a scanSessions loop.
  * If you have one of these, you're in a scanSessions callback context, and so
- * have locked the whole catalog and, if the observed session is bound to an operation context,
- * you hold that operation context's client's mutex, as well.
+ * have locked the catalog partition which owns the session and, if the observed session is bound
+ * to an operation context, you hold that operation context's client's mutex, as well.
  */
 class ObservableSession {
 public:
@@ -225,6 +225,42 @@ TEST_F(SessionCatalogTestWithDefaultOpCtx, ScanSessions) {
     lsidsFound.clear();
 }
 
+TEST_F(SessionCatalogTestWithDefaultOpCtx, ScanSessionsVisitsAllPartitions) {
+    // Create enough sessions in the catalog so that they are spread over all of its partitions.
+    std::vector<LogicalSessionId> lsids;
+    for (int i = 0; i < 100; ++i) {
+        lsids.push_back(makeLogicalSessionIdForTest());
+    }
+
+    stdx::async(stdx::launch::async,
+                [this, &lsids] {
+                    ThreadClient tc(getServiceContext());
+                    for (const auto& lsid : lsids) {
+                        auto opCtx = makeOperationContext();
+                        opCtx->setLogicalSessionId(lsid);
+                        OperationContextSession ocs(opCtx.get());
+                    }
+                })
+        .get();
+    ASSERT_EQ(lsids.size(), catalog()->size());
+
+    // Every session must be visited exactly once.
+    LogicalSessionIdSet lsidsFound;
+    SessionKiller::Matcher matcherAllSessions(
+        KillAllSessionsByPatternSet{makeKillAllSessionsByPattern(_opCtx)});
+    catalog()->scanSessions(matcherAllSessions, [&lsidsFound](ObservableSession& session) {
+        ASSERT(lsidsFound.insert(session.getSessionId()).second);
+        session.markForReap();
+    });
+    ASSERT_EQ(lsids.size(), lsidsFound.size());
+    for (const auto& lsid : lsids) {
+        ASSERT(lsidsFound.count(lsid));
+    }
+
+    // All the sessions were idle, so all of them must have been reaped.
+    ASSERT_EQ(0U, catalog()->size());
+}
+
 TEST_F(SessionCatalogTestWithDefaultOpCtx, ScanSessionsMarkForReap) {
     // Create three sessions in the catalog.
     const std::vector<LogicalSessionId> lsids{makeLogicalSessionIdForTest(),
@@ -49,6 +49,8 @@
 #include "mongo/db/sorter/sorter.h"
 
 #include <boost/filesystem/operations.hpp>
+#include <deque>
+#include <functional>
 #include <snappy.h>
 #include <vector>
 
@@ -59,8 +61,11 @@
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/str.h"
@@ -151,6 +156,142 @@ private:
     std::deque<Data> _data;
 };
 
+/**
+ * Reads the blocks of a number of sorted data ranges on a thread of its own, one block ahead of
+ * their consumers. While the consumer of a range deserializes one block, the next block is read
+ * from disk, decrypted and decompressed. The FileIterators merged by a MergeIterator share one
+ * instance, which reads the next block of each range in the order the current blocks were taken.
+ */
+class SortedFileReadAhead {
+public:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+    };
+
+    /**
+     * Reads the next block of a range into its argument, or returns false if the range has no more
+     * blocks.
+     */
+    using ReadBlockFn = std::function<bool(Block*)>;
+
+    ~SortedFileReadAhead() {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _stopped = true;
+            _cv.notify_all();
+        }
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    /**
+     * Registers a range and returns the id with which its blocks are taken. All of the ranges must
+     * be added before start() is called.
+     */
+    size_t addRange(ReadBlockFn readBlock) {
+        invariant(!_thread.joinable());
+        _ranges.emplace_back(std::move(readBlock));
+        return _ranges.size() - 1;
+    }
+
+    void start() {
+        for (size_t id = 0; id < _ranges.size(); ++id) {
+            _queue.push_back(id);
+        }
+        _thread = stdx::thread([this] { run(); });
+    }
+
+    /**
+     * Waits for the next block of range 'id' and moves it into 'block', or returns false once the
+     * range is exhausted. Rethrows the error that reading the range failed with, if any.
+     */
+    bool takeBlock(size_t id, Block* block) {
+        stdx::unique_lock<Latch> lk(_mutex);
+        auto& range = _ranges[id];
+        _cv.wait(lk, [&] { return range.next || range.exhausted; });
+        if (!range.next) {
+            uassertStatusOK(range.status);
+            return false;
+        }
+
+        *block = std::move(*range.next);
+        range.next.reset();
+        _queue.push_back(id);
+        _cv.notify_all();
+        return true;
+    }
+
+    /**
+     * Stops reading range 'id', waiting for any read of it that is in progress to finish. The
+     * file of the range may be closed once this returns.
+     */
+    void removeRange(size_t id) {
+        stdx::unique_lock<Latch> lk(_mutex);
+        auto& range = _ranges[id];
+        range.removed = true;
+        _cv.wait(lk, [&] { return !range.reading; });
+    }
+
+private:
+    struct Range {
+        explicit Range(ReadBlockFn readBlock) : readBlock(std::move(readBlock)) {}
+
+        const ReadBlockFn readBlock;
+        boost::optional<Block> next;
+        bool reading = false;
+        bool exhausted = false;
+        bool removed = false;
+        Status status = Status::OK();
+    };
+
+    void run() {
+        stdx::unique_lock<Latch> lk(_mutex);
+        while (true) {
+            _cv.wait(lk, [&] { return _stopped || !_queue.empty(); });
+            if (_stopped) {
+                return;
+            }
+
+            auto& range = _ranges[_queue.front()];
+            _queue.pop_front();
+            if (range.removed) {
+                continue;
+            }
+
+            range.reading = true;
+            lk.unlock();
+            Block block;
+            bool more = false;
+            Status status = Status::OK();
+            try {
+                more = range.readBlock(&block);
+            } catch (const DBException& ex) {
+                status = ex.toStatus();
+            }
+            lk.lock();
+
+            range.reading = false;
+            if (more) {
+                range.next = std::move(block);
+            } else {
+                range.exhausted = true;
+                range.status = std::move(status);
+            }
+            _cv.notify_all();
+        }
+    }
+
+    std::deque<Range> _ranges;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("SortedFileReadAhead::_mutex");
+    stdx::condition_variable _cv;
+    std::deque<size_t> _queue;  // Ranges whose next block has not been read yet.
+    bool _stopped = false;
+    stdx::thread _thread;
+};
+
 /**
  * Returns results from a sorted range within a file. Each instance is given a file name and start
  * and end offsets.
@@ -184,6 +325,20 @@ public:
                 boost::filesystem::file_size(_fileName) != 0);
     }
 
+    ~FileIterator() {
+        stopReadAhead();
+    }
+
+    /**
+     * Has 'readAhead' read the blocks of this range from now on. The source must be open.
+     */
+    void startReadAhead(const std::shared_ptr<SortedFileReadAhead>& readAhead) {
+        invariant(_file.is_open());
+        _readAhead = readAhead;
+        _readAheadId = _readAhead->addRange(
+            [this](SortedFileReadAhead::Block* block) { return readBlock(block); });
+    }
+
     void openSource() {
         _file.open(_fileName.c_str(), std::ios::in | std::ios::binary);
         uassert(16814,
@@ -198,6 +353,7 @@ public:
     }
 
     void closeSource() {
+        stopReadAhead();
         _file.close();
         uassert(50969,
                 str::stream() << "error closing file \"" << _fileName
@@ -262,29 +418,42 @@ private:
     }
 
     /**
-     * Tries to read from disk and places any results in _bufferReader. If there is no more data to
-     * read, then _done is set to true and the function returns immediately.
+     * Places the next block of the range in _bufferReader, from the read-ahead if there is one and
+     * from disk otherwise. If there is no more data to read, then _done is set to true.
      */
     void fillBufferFromDisk() {
-        int32_t rawSize;
-        read(&rawSize, sizeof(rawSize));
-        if (_done)
+        SortedFileReadAhead::Block block;
+        if (!(_readAhead ? _readAhead->takeBlock(_readAheadId, &block) : readBlock(&block))) {
+            _done = true;
             return;
+        }
+        _buffer = std::move(block.data);
+        _bufferReader.reset(new BufReader(_buffer.get(), block.size));
+    }
+
+    /**
+     * Reads the next block of the range from disk and decrypts and decompresses it into 'block'.
+     * Returns false if there is no more data to read. This only touches '_file', so that it can run
+     * on the thread of a SortedFileReadAhead.
+     */
+    bool readBlock(SortedFileReadAhead::Block* block) {
+        int32_t rawSize;
+        if (!read(&rawSize, sizeof(rawSize)))
+            return false;
 
         // negative size means compressed
         const bool compressed = rawSize < 0;
         int32_t blockSize = std::abs(rawSize);
 
-        _buffer.reset(new char[blockSize]);
-        read(_buffer.get(), blockSize);
-        uassert(16816, "file too short?", !_done);
+        std::unique_ptr<char[]> buffer(new char[blockSize]);
+        uassert(16816, "file too short?", read(buffer.get(), blockSize));
 
         auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
         if (encryptionHooks->enabled()) {
             std::unique_ptr<char[]> out(new char[blockSize]);
             size_t outLen;
             Status status =
-                encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(_buffer.get()),
+                encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(buffer.get()),
                                                   blockSize,
                                                   reinterpret_cast<uint8_t*>(out.get()),
                                                   blockSize,
@@ -293,37 +462,39 @@ private:
                     str::stream() << "Failed to unprotect data: " << status.toString(),
                     status.isOK());
             blockSize = outLen;
-            _buffer.swap(out);
+            buffer.swap(out);
         }
 
         if (!compressed) {
-            _bufferReader.reset(new BufReader(_buffer.get(), blockSize));
-            return;
+            block->data = std::move(buffer);
+            block->size = blockSize;
+            return true;
         }
 
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
+        dassert(snappy::IsValidCompressedBuffer(buffer.get(), blockSize));
 
         size_t uncompressedSize;
         uassert(17061,
                 "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
+                snappy::GetUncompressedLength(buffer.get(), blockSize, &uncompressedSize));
 
         std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
         uassert(17062,
                 "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
+                snappy::RawUncompress(buffer.get(), blockSize, decompressionBuffer.get()));
 
         // hold on to decompressed data and throw out compressed data at block exit
-        _buffer.swap(decompressionBuffer);
-        _bufferReader.reset(new BufReader(_buffer.get(), uncompressedSize));
+        block->data = std::move(decompressionBuffer);
+        block->size = uncompressedSize;
+        return true;
     }
 
     /**
-     * Attempts to read data from disk. Sets _done to true when file offset reaches _fileEndOffset.
+     * Attempts to read data from disk. Returns false when file offset reaches _fileEndOffset.
      *
      * Masserts on any file errors
      */
-    void read(void* out, size_t size) {
+    bool read(void* out, size_t size) {
         invariant(_file.is_open());
 
         const std::streampos offset = _file.tellg();
@@ -334,8 +505,7 @@ private:
 
         if (offset >= _fileEndOffset) {
             invariant(offset == _fileEndOffset);
-            _done = true;
-            return;
+            return false;
         }
 
         _file.read(reinterpret_cast<char*>(out), size);
@@ -344,6 +514,17 @@ private:
                               << "\": " << myErrnoWithDescription(),
                 _file.good());
         verify(_file.gcount() == static_cast<std::streamsize>(size));
+        return true;
+    }
+
+    /**
+     * Waits for the read-ahead to stop reading this range, if it is reading it.
+     */
+    void stopReadAhead() {
+        if (_readAhead) {
+            _readAhead->removeRange(_readAheadId);
+            _readAhead.reset();
+        }
     }
 
     const Settings _settings;
@@ -356,6 +537,10 @@ private:
     std::streampos _fileEndOffset;    // File offset at which the sorted data range ends.
     std::ifstream _file;
 
+    // Reads '_file' one block ahead of this iterator, if set.
+    std::shared_ptr<SortedFileReadAhead> _readAhead;
+    size_t _readAheadId = 0;
+
     // Checksum value that is updated with each read of a data object from disk. We can compare
     // this value with _originalChecksum to check for data corruption if and only if the
     // FileIterator is exhausted.
@@ -371,6 +556,11 @@ private:
  * Merge-sorts results from 0 or more FileIterators, all of which should be iterating over sorted
  * ranges within the same file. This class is given the data source file name upon construction and
  * is responsible for deleting the data source file upon destruction.
+ *
+ * The inputs are merged with a tournament tree of losers. Each internal node of the tree holds the
+ * input which lost the comparison there, and the root holds the overall winner. Advancing the
+ * winner replays only the path from its leaf to the root, which takes one comparison per level
+ * rather than the two per level of sifting a binary heap.
  */
 template <typename Key, typename Value, typename Comparator>
 class MergeIterator : public SortIteratorInterface<Key, Value> {
@@ -385,33 +575,48 @@ public:
         : _opts(opts),
           _remaining(opts.limit ? opts.limit : std::numeric_limits<unsigned long long>::max()),
           _first(true),
-          _greater(comp),
+          _comp(comp),
           _itersSourceFileName(itersSourceFileName) {
+        for (auto&& iter : iters) {
+            iter->openSource();
+        }
+
+        if (_opts.readAhead) {
+            auto readAhead = std::make_shared<SortedFileReadAhead>();
+            bool anyFiles = false;
+            for (auto&& iter : iters) {
+                if (auto fileIter = dynamic_cast<FileIterator<Key, Value>*>(iter.get())) {
+                    fileIter->startReadAhead(readAhead);
+                    anyFiles = true;
+                }
+            }
+            if (anyFiles) {
+                readAhead->start();
+            }
+        }
+
         for (size_t i = 0; i < iters.size(); i++) {
-            iters[i]->openSource();
             if (iters[i]->more()) {
-                _heap.push_back(std::make_shared<Stream>(i, iters[i]->next(), iters[i]));
+                _streams.push_back(std::make_unique<Stream>(i, iters[i]->next(), iters[i]));
             } else {
                 iters[i]->closeSource();
             }
         }
 
-        if (_heap.empty()) {
+        if (_streams.empty()) {
             _remaining = 0;
             return;
         }
 
-        std::make_heap(_heap.begin(), _heap.end(), _greater);
-        std::pop_heap(_heap.begin(), _heap.end(), _greater);
-        _current = _heap.back();
-        _heap.pop_back();
+        _numLiveStreams = _streams.size();
+        _tree.resize(_streams.size());
+        _tree[0] = playTournament(1);
     }
 
     ~MergeIterator() {
         // Clear the remaining Stream objects first, to close the file handles before deleting the
         // file. Some systems will error closing the file if any file handles are still open.
-        _current.reset();
-        _heap.clear();
+        _streams.clear();
         DESTRUCTOR_GUARD(boost::filesystem::remove(_itersSourceFileName));
     }
 
@@ -419,7 +624,7 @@ public:
     void closeSource() {}
 
     bool more() {
-        if (_remaining > 0 && (_first || !_heap.empty() || _current->more()))
+        if (_remaining > 0 && (_first || _numLiveStreams > 1 || _streams[_tree[0]]->more()))
             return true;
 
         _remaining = 0;
@@ -433,21 +638,19 @@ public:
 
         if (_first) {
             _first = false;
-            return _current->current();
+            return _streams[_tree[0]]->current();
         }
 
-        if (!_current->advance()) {
-            verify(!_heap.empty());
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            _current = _heap.back();
-            _heap.pop_back();
-        } else if (!_heap.empty() && _greater(_current, _heap.front())) {
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            std::swap(_current, _heap.back());
-            std::push_heap(_heap.begin(), _heap.end(), _greater);
+        const size_t winner = _tree[0];
+        if (!_streams[winner]->advance()) {
+            verify(_numLiveStreams > 1);
+            // Destroying the Stream closes its input.
+            _streams[winner].reset();
+            _numLiveStreams--;
         }
+        replay(winner);
 
-        return _current->current();
+        return _streams[_tree[0]]->current();
     }
 
 
@@ -489,30 +692,63 @@ private:
         std::shared_ptr<Input> _rest;
     };
 
-    class STLComparator {  // uses greater rather than less-than to maintain a MinHeap
-    public:
-        explicit STLComparator(const Comparator& comp) : _comp(comp) {}
-        bool operator()(unowned_ptr<const Stream> lhs, unowned_ptr<const Stream> rhs) const {
-            // first compare data
-            dassertCompIsSane(_comp, lhs->current(), rhs->current());
-            int ret = _comp(lhs->current(), rhs->current());
-            if (ret)
-                return ret > 0;
-
-            // then compare fileNums to ensure stability
-            return lhs->fileNum > rhs->fileNum;
+    /**
+     * Returns true if the current data of stream 'lhs' comes before that of stream 'rhs'. An
+     * exhausted stream comes after every other stream.
+     */
+    bool beats(size_t lhs, size_t rhs) const {
+        if (!_streams[lhs])
+            return false;
+        if (!_streams[rhs])
+            return true;
+
+        // first compare data
+        dassertCompIsSane(_comp, _streams[lhs]->current(), _streams[rhs]->current());
+        int ret = _comp(_streams[lhs]->current(), _streams[rhs]->current());
+        if (ret)
+            return ret < 0;
+
+        // then compare fileNums to ensure stability
+        return _streams[lhs]->fileNum < _streams[rhs]->fileNum;
+    }
+
+    /**
+     * Fills in the losers of the subtree rooted at internal node 'node' and returns its winner.
+     * Node n has children 2n and 2n + 1, and the leaf of stream i is node _streams.size() + i.
+     */
+    size_t playTournament(size_t node) {
+        if (node >= _streams.size())
+            return node - _streams.size();
+
+        const size_t left = playTournament(2 * node);
+        const size_t right = playTournament(2 * node + 1);
+        if (beats(left, right)) {
+            _tree[node] = right;
+            return left;
         }
+        _tree[node] = left;
+        return right;
+    }
 
-    private:
-        const Comparator _comp;
-    };
+    /**
+     * Restores the tree after the current data of stream 'stream', the previous winner, changed.
+     */
+    void replay(size_t stream) {
+        size_t winner = stream;
+        for (size_t node = (_streams.size() + stream) / 2; node > 0; node /= 2) {
+            if (beats(_tree[node], winner))
+                std::swap(_tree[node], winner);
+        }
+        _tree[0] = winner;
+    }
 
     SortOptions _opts;
     unsigned long long _remaining;
     bool _first;
-    std::shared_ptr<Stream> _current;
-    std::vector<std::shared_ptr<Stream>> _heap;  // MinHeap
-    STLComparator _greater;                      // named so calls make sense
+    const Comparator _comp;
+    std::vector<std::unique_ptr<Stream>> _streams;  // Null once exhausted.
+    size_t _numLiveStreams = 0;
+    std::vector<size_t> _tree;  // The overall winner, then the loser at each internal node.
     std::string _itersSourceFileName;
 };
 
@@ -585,13 +821,51 @@ private:
 
     void sort() {
         STLComparator less(_comp);
-        std::stable_sort(_data.begin(), _data.end(), less);
+        const size_t numChunks =
+            std::min(_opts.maxSortThreads, _data.size() / kMinItemsPerSortThread);
+        if (numChunks <= 1) {
+            std::stable_sort(_data.begin(), _data.end(), less);
 
-        // Does 2x more compares than stable_sort
-        // TODO test on windows
-        // std::sort(_data.begin(), _data.end(), comp);
+            // Does 2x more compares than stable_sort
+            // TODO test on windows
+            // std::sort(_data.begin(), _data.end(), comp);
+            return;
+        }
+
+        // Sort equal chunks of the data on threads of their own, then merge neighbouring sorted
+        // runs pairwise until one is left. Both steps are stable, so the result is the same as that
+        // of sorting on this thread.
+        std::vector<typename std::deque<Data>::iterator> bounds;
+        for (size_t i = 0; i <= numChunks; ++i) {
+            bounds.push_back(_data.begin() + _data.size() * i / numChunks);
+        }
+        auto runConcurrently = [](size_t numTasks, const auto& task) {
+            std::vector<stdx::thread> threads;
+            for (size_t i = 0; i < numTasks; ++i) {
+                threads.emplace_back([&task, i] { task(i); });
+            }
+            for (auto&& thread : threads) {
+                thread.join();
+            }
+        };
+
+        runConcurrently(numChunks,
+                        [&](size_t i) { std::stable_sort(bounds[i], bounds[i + 1], less); });
+        for (size_t width = 1; width < numChunks; width *= 2) {
+            const size_t numMerges = (numChunks + width - 1) / (2 * width);
+            runConcurrently(numMerges, [&](size_t merge) {
+                const size_t i = merge * 2 * width;
+                std::inplace_merge(bounds[i],
+                                   bounds[i + width],
+                                   bounds[std::min(i + 2 * width, numChunks)],
+                                   less);
+            });
+        }
     }
 
+    // Sorting fewer items than this on a thread of its own costs more than it saves.
+    static constexpr size_t kMinItemsPerSortThread = 64 * 1024;
+
     void spill() {
         invariant(!_done);
 
@@ -1082,6 +1356,12 @@ SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     _fileEndOffset = currentFileOffset < _fileStartOffset ? _fileStartOffset : currentFileOffset;
     _file.close();
 
+    return makeIterator();
+}
+
+template <typename Key, typename Value>
+SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::makeIterator() const {
+    invariant(!_file.is_open());
     return new sorter::FileIterator<Key, Value>(
         _fileName, _fileStartOffset, _fileEndOffset, _settings, _checksum);
 }
@@ -107,7 +107,20 @@ struct SortOptions {
     // extSortAllowed is true.
     std::string tempDir;
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    // Whether merging spilled data reads the next block of each spilled range on a separate thread
+    // while the current block is consumed.
+    bool readAhead;
+
+    // The number of threads on which the in-memory data may be sorted before it is spilled or
+    // returned. Small amounts of data are always sorted on the calling thread.
+    size_t maxSortThreads;
+
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          readAhead(false),
+          maxSortThreads(1) {}
 
     // Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -130,6 +143,16 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& ReadAhead(bool newReadAhead = true) {
+        readAhead = newReadAhead;
+        return *this;
+    }
+
+    SortOptions& MaxSortThreads(size_t newMaxSortThreads) {
+        maxSortThreads = newMaxSortThreads;
+        return *this;
+    }
 };
 
 /**
@@ -304,6 +327,13 @@ public:
      */
     Iterator* done();
 
+    /**
+     * Returns a new iterator over the data written to disk by this writer, so that the data can be
+     * read more than once. Only call this after done() has been called. The caller must call
+     * openSource() on the iterator before reading from it.
+     */
+    Iterator* makeIterator() const;
+
     /**
      * Only call this after done() has been called to set the end offset.
      */
@@ -0,0 +1,192 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <boost/filesystem/operations.hpp>
+#include <cstring>
+#include <memory>
+
+#include "mongo/bson/util/builder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/sorter/sorter.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
+#include "mongo/util/bufreader.h"
+
+namespace mongo {
+
+/**
+ * Generates a new file name on each call using a static, atomic and monotonically increasing
+ * number.
+ *
+ * Each user of the Sorter must implement this function to ensure that all temporary files that the
+ * Sorter instances produce are uniquely identified using a unique file name extension with separate
+ * atomic variable. This is necessary because the sorter.cpp code is separately included in multiple
+ * places, rather than compiled in one place and linked, and so cannot provide a globally unique ID.
+ */
+std::string nextFileName() {
+    static AtomicWord<unsigned> sorterBmFileCounter;
+    return "extsort-sorter-bm." + std::to_string(sorterBmFileCounter.fetchAndAdd(1));
+}
+
+namespace {
+
+/**
+ * An 8-byte key and a 56-byte value, so that every item sorted is 64 bytes.
+ */
+class BenchmarkKey {
+public:
+    BenchmarkKey(long long key = 0) : _key(key) {}
+
+    struct SorterDeserializeSettings {};
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendNum(_key);
+    }
+    static BenchmarkKey deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        return buf.read<LittleEndian<long long>>().value;
+    }
+    int memUsageForSorter() const {
+        return sizeof(BenchmarkKey);
+    }
+    BenchmarkKey getOwned() const {
+        return *this;
+    }
+
+    long long get() const {
+        return _key;
+    }
+
+private:
+    long long _key;
+};
+
+class BenchmarkValue {
+public:
+    BenchmarkValue() {
+        _payload.fill('v');
+    }
+
+    struct SorterDeserializeSettings {};
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendBuf(_payload.data(), _payload.size());
+    }
+    static BenchmarkValue deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        BenchmarkValue value;
+        std::memcpy(value._payload.data(), buf.skip(value._payload.size()), value._payload.size());
+        return value;
+    }
+    int memUsageForSorter() const {
+        return sizeof(BenchmarkValue);
+    }
+    BenchmarkValue getOwned() const {
+        return *this;
+    }
+
+private:
+    std::array<char, 56> _payload;
+};
+
+using BenchmarkSorter = Sorter<BenchmarkKey, BenchmarkValue>;
+
+class BenchmarkComparator {
+public:
+    int operator()(const BenchmarkSorter::Data& lhs, const BenchmarkSorter::Data& rhs) const {
+        return lhs.first.get() < rhs.first.get() ? -1 : lhs.first.get() > rhs.first.get();
+    }
+};
+
+constexpr long long kItemBytes = sizeof(BenchmarkKey) + sizeof(BenchmarkValue);
+constexpr size_t kMaxMemoryUsageBytes = 100 * 1024 * 1024;
+
+/**
+ * Sorts state.range(0) bytes of items with random keys on up to state.range(1) threads, and reads
+ * back the sorted results. Inputs larger than 100MB are spilled to disk and merged.
+ */
+void BM_Sort(benchmark::State& state) {
+    if (!hasGlobalServiceContext()) {
+        setGlobalServiceContext(ServiceContext::make());
+    }
+    const auto tempDir =
+        boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("sorter-bm-%%%%");
+    boost::filesystem::create_directories(tempDir);
+
+    const long long numItems = state.range(0) / kItemBytes;
+    const auto opts = SortOptions()
+                          .TempDir(tempDir.string())
+                          .ExtSortAllowed()
+                          .MaxMemoryUsageBytes(kMaxMemoryUsageBytes)
+                          .ReadAhead()
+                          .MaxSortThreads(state.range(1));
+    PseudoRandom random(1);
+    const BenchmarkValue value;
+
+    for (auto keepRunning : state) {
+        std::unique_ptr<BenchmarkSorter> sorter(
+            BenchmarkSorter::make(opts, BenchmarkComparator()));
+        for (long long i = 0; i < numItems; ++i) {
+            sorter->add(random.nextInt64(), value);
+        }
+
+        std::unique_ptr<BenchmarkSorter::Iterator> iter(sorter->done());
+        long long previous = std::numeric_limits<long long>::min();
+        while (iter->more()) {
+            auto key = iter->next().first.get();
+            invariant(previous <= key);
+            previous = key;
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * numItems * kItemBytes);
+    boost::filesystem::remove_all(tempDir);
+}
+
+// These use real time, since sorts on several threads do most of their work off the benchmark
+// thread. The inputs of 1GB and more spill to disk and run once; the 10GB ones take minutes.
+BENCHMARK(BM_Sort)
+    ->Args({64LL << 20, 1})
+    ->Args({64LL << 20, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_Sort)
+    ->Args({1LL << 30, 1})
+    ->Args({1LL << 30, 4})
+    ->Args({10LL << 30, 1})
+    ->Args({10LL << 30, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+MONGO_CREATE_SORTER(mongo::BenchmarkKey, mongo::BenchmarkValue, mongo::BenchmarkComparator);
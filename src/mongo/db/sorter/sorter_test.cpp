@@ -584,6 +584,28 @@ public:
     PseudoRandom _random;
 };
 
+template <bool Random = true>
+class LotsOfDataLittleMemoryWithReadAhead : public LotsOfDataLittleMemory<Random> {
+    SortOptions adjustSortOptions(SortOptions opts) override {
+        return LotsOfDataLittleMemory<Random>::adjustSortOptions(opts).ReadAhead();
+    }
+};
+
+template <bool Random = true>
+class LotsOfDataSortedConcurrently : public LotsOfDataLittleMemory<Random> {
+    typedef LotsOfDataLittleMemory<Random> Parent;
+    SortOptions adjustSortOptions(SortOptions opts) override {
+        // Make sure each spill holds enough data to be sorted on several threads
+        MONGO_STATIC_ASSERT(MEM_LIMIT / sizeof(IWPair) >= 4 * 64 * 1024);
+
+        return opts.MaxMemoryUsageBytes(MEM_LIMIT).ExtSortAllowed().MaxSortThreads(4);
+    }
+    boost::optional<size_t> correctNumRanges() const override {
+        return Parent::NUM_ITEMS * sizeof(IWPair) / MEM_LIMIT;
+    }
+    enum { MEM_LIMIT = 2 * 1024 * 1024 };
+};
+
 
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
@@ -632,6 +654,10 @@ public:
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataLittleMemoryWithReadAhead</*random=*/false>>();
+        add<SorterTests::LotsOfDataLittleMemoryWithReadAhead</*random=*/true>>();
+        add<SorterTests::LotsOfDataSortedConcurrently</*random=*/false>>();
+        add<SorterTests::LotsOfDataSortedConcurrently</*random=*/true>>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
@@ -127,5 +127,46 @@ public:
 
 } lockStatsServerStatusSection;
 
+
+class LockContentionServerStatusSection : public ServerStatusSection {
+public:
+    LockContentionServerStatusSection() : ServerStatusSection("lockContention") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder ret;
+
+        {
+            BSONObjBuilder histogramsBuilder(ret.subobjStart("waitHistograms"));
+            reportGlobalLockWaitHistograms(&histogramsBuilder);
+        }
+
+        // The list of top contended resources can be turned off with
+        // {lockContention: {topContendedResources: false}}.
+        bool includeResources = true;
+        if (configElement.type() == BSONType::Object) {
+            BSONElement resourcesElement = configElement.Obj()["topContendedResources"];
+            if (!resourcesElement.eoo()) {
+                includeResources = resourcesElement.trueValue();
+            }
+        }
+
+        if (includeResources) {
+            BSONArrayBuilder resourcesBuilder(ret.subarrayStart("topContendedResources"));
+            reportTopContendedResources(&resourcesBuilder, kNumTopContendedResources);
+        }
+
+        return ret.obj();
+    }
+
+private:
+    static constexpr size_t kNumTopContendedResources = 10;
+
+} lockContentionServerStatusSection;
+
 }  // namespace
 }  // namespace mongo
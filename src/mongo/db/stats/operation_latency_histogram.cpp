@@ -39,58 +39,30 @@
 
 namespace mongo {
 
+namespace {
+
+// Latencies in [2^kMinSubBucketedLog2, 2^kMaxSubBucketedLog2) microseconds, i.e. from about 1ms
+// to about 18 minutes, are split into 2^kLog2SubBucketsPerPowerOfTwo buckets per power of two.
+// Smaller and larger latencies use a single bucket per power of two.
+const int kMinSubBucketedLog2 = 10;
+const int kMaxSubBucketedLog2 = 30;
+const int kLog2SubBucketsPerPowerOfTwo = 2;
+const int kSubBucketsPerPowerOfTwo = 1 << kLog2SubBucketsPerPowerOfTwo;
+
+// Index of the first bucket with lower bound 2^kMaxSubBucketedLog2.
+const int kFirstBucketAboveSubBucketed = kMinSubBucketedLog2 +
+    (kMaxSubBucketedLog2 - kMinSubBucketedLog2) * kSubBucketsPerPowerOfTwo;
+
+}  // namespace
+
 const std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets>
-    OperationLatencyHistogram::kLowerBounds = {0,
-                                               2,
-                                               4,
-                                               8,
-                                               16,
-                                               32,
-                                               64,
-                                               128,
-                                               256,
-                                               512,
-                                               1024,
-                                               2048,
-                                               3072,
-                                               4096,
-                                               6144,
-                                               8192,
-                                               12288,
-                                               16384,
-                                               24576,
-                                               32768,
-                                               49152,
-                                               65536,
-                                               98304,
-                                               131072,
-                                               196608,
-                                               262144,
-                                               393216,
-                                               524288,
-                                               786432,
-                                               1048576,
-                                               1572864,
-                                               2097152,
-                                               4194304,
-                                               8388608,
-                                               16777216,
-                                               33554432,
-                                               67108864,
-                                               134217728,
-                                               268435456,
-                                               536870912,
-                                               1073741824,
-                                               2147483648,
-                                               4294967296,
-                                               8589934592,
-                                               17179869184,
-                                               34359738368,
-                                               68719476736,
-                                               137438953472,
-                                               274877906944,
-                                               549755813888,
-                                               1099511627776};
+    OperationLatencyHistogram::kLowerBounds = [] {
+        std::array<uint64_t, kMaxBuckets> lowerBounds;
+        for (int i = 0; i < kMaxBuckets; i++) {
+            lowerBounds[i] = _getBucketMicros(i);
+        }
+        return lowerBounds;
+    }();
 
 void OperationLatencyHistogram::_append(const HistogramData& data,
                                         const char* key,
@@ -153,7 +125,8 @@ void OperationLatencyHistogram::append(bool includeHistograms,
     _append(_transactions, "transactions", includeHistograms, slowMSBucketsOnly, builder);
 }
 
-// Computes the log base 2 of value, and checks for cases of split buckets.
+// Computes the log base 2 of value, and which of the sub-buckets of that power of two the value
+// falls into, if it is split.
 int OperationLatencyHistogram::_getBucket(uint64_t value) {
     // Zero is a special case since log(0) is undefined.
     if (value == 0) {
@@ -161,22 +134,32 @@ int OperationLatencyHistogram::_getBucket(uint64_t value) {
     }
 
     int log2 = 63 - countLeadingZeros64(value);
-    // Half splits occur in range [2^11, 2^21) giving 10 extra buckets.
-    if (log2 < 11) {
+    if (log2 < kMinSubBucketedLog2) {
         return log2;
-    } else if (log2 < 21) {
-        int extra = log2 - 11;
-        // Split value boundary is at (2^n + 2^(n+1))/2 = 2^n + 2^(n-1).
-        // Which corresponds to (1ULL << log2) | (1ULL << (log2 - 1))
-        // Which is equivalent to the following:
-        uint64_t splitBoundary = 3ULL << (log2 - 1);
-        if (value >= splitBoundary) {
-            extra++;
-        }
-        return log2 + extra;
+    } else if (log2 < kMaxSubBucketedLog2) {
+        // The bits following the most significant one select the sub-bucket.
+        int subBucket = (value >> (log2 - kLog2SubBucketsPerPowerOfTwo)) &
+            (kSubBucketsPerPowerOfTwo - 1);
+        return kMinSubBucketedLog2 + (log2 - kMinSubBucketedLog2) * kSubBucketsPerPowerOfTwo +
+            subBucket;
+    } else {
+        return std::min(kFirstBucketAboveSubBucketed + (log2 - kMaxSubBucketedLog2),
+                        kMaxBuckets - 1);
+    }
+}
+
+// Inverse of _getBucket(): computes the smallest latency which falls into the given bucket.
+uint64_t OperationLatencyHistogram::_getBucketMicros(int bucket) {
+    if (bucket == 0) {
+        return 0;
+    } else if (bucket < kMinSubBucketedLog2) {
+        return 1ULL << bucket;
+    } else if (bucket < kFirstBucketAboveSubBucketed) {
+        int log2 = kMinSubBucketedLog2 + (bucket - kMinSubBucketedLog2) / kSubBucketsPerPowerOfTwo;
+        int subBucket = (bucket - kMinSubBucketedLog2) % kSubBucketsPerPowerOfTwo;
+        return (1ULL << log2) + (subBucket * (1ULL << (log2 - kLog2SubBucketsPerPowerOfTwo)));
     } else {
-        // Add all of the extra 10 buckets.
-        return std::min(log2 + 10, kMaxBuckets - 1);
+        return 1ULL << (kMaxSubBucketedLog2 + (bucket - kFirstBucketAboveSubBucketed));
     }
 }
 
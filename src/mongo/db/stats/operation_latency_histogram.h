@@ -44,7 +44,8 @@ class BSONObjBuilder;
  */
 class OperationLatencyHistogram {
 public:
-    static const int kMaxBuckets = 51;
+    // Buckets up to 2^40 microseconds, split into four per power of two from 2^10 to 2^30.
+    static const int kMaxBuckets = 101;
 
     // Inclusive lower bounds of the histogram buckets.
     static const std::array<uint64_t, kMaxBuckets> kLowerBounds;
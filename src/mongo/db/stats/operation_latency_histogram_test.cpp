@@ -93,6 +93,24 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
     }
 }
 
+TEST(OperationLatencyHistogram, SplitsMillisecondLatenciesIntoQuarters) {
+    OperationLatencyHistogram hist;
+    for (uint64_t micros : {4096, 5119, 5120, 6143, 6144, 7167, 7168, 8191}) {
+        hist.increment(micros, Command::ReadWriteType::kRead);
+    }
+
+    BSONObjBuilder outBuilder;
+    hist.append(true, false, &outBuilder);
+    BSONObj out = outBuilder.done();
+    std::vector<BSONElement> readBuckets = out["reads"]["histogram"].Array();
+    ASSERT_EQUALS(readBuckets.size(), 4U);
+    for (size_t i = 0; i < readBuckets.size(); i++) {
+        BSONObj bucket = readBuckets[i].Obj();
+        ASSERT_EQUALS(bucket["micros"].Long(), static_cast<long long>(4096 + 1024 * i));
+        ASSERT_EQUALS(bucket["count"].Long(), 2);
+    }
+}
+
 TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatencySlowBuckets) {
     OperationLatencyHistogram hist;
     // Increment at the boundary, boundary+1, and boundary-1.
@@ -115,7 +133,7 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatencySlowBuckets) {
     BSONObj out = outBuilder.done();
     ASSERT_EQUALS(static_cast<uint64_t>(out["reads"]["latency"].Long()), expectedSum);
 
-    const size_t kMaxUnFilteredBuckets = 23;
+    const size_t kMaxUnFilteredBuckets = 37;
     // Each bucket has three counts with the exception of the last bucket, which has two.
     ASSERT_EQUALS(out["reads"]["ops"].Long(), 3 * kMaxBuckets - 1);
     std::vector<BSONElement> readBuckets = out["reads"]["histogram"].Array();
@@ -131,7 +149,7 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatencySlowBuckets) {
         BSONObj bucket = readBuckets[kMaxUnFilteredBuckets].Obj();
         ASSERT_EQUALS(static_cast<uint64_t>(bucket["micros"].Long()),
                       kLowerBounds[kMaxUnFilteredBuckets] + 1);
-        ASSERT_EQUALS(bucket["count"].Long(), 83);
+        ASSERT_EQUALS(bucket["count"].Long(), 191);
     }
 }
 }  // namespace mongo
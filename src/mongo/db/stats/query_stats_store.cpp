@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats_store.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/query_stats_store_gen.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getQueryStatsStore = ServiceContext::declareDecoration<QueryStatsStore>();
+
+}  // namespace
+
+int QueryStatsHistogram::getBucket(uint64_t value) {
+    // Zero is a special case since log(0) is undefined.
+    if (value == 0) {
+        return 0;
+    }
+    return std::min(64 - countLeadingZeros64(value), kNumBuckets - 1);
+}
+
+uint64_t QueryStatsHistogram::getBucketLowerBound(int bucket) {
+    return bucket == 0 ? 0 : 1ULL << (bucket - 1);
+}
+
+void QueryStatsHistogram::record(uint64_t value) {
+    _buckets[getBucket(value)]++;
+    _min = _count == 0 ? value : std::min(_min, value);
+    _max = std::max(_max, value);
+    _sum += value;
+    _count++;
+}
+
+void QueryStatsHistogram::append(StringData fieldName, BSONObjBuilder* builder) const {
+    BSONObjBuilder histogramBuilder(builder->subobjStart(fieldName));
+    histogramBuilder.append("sum", static_cast<long long>(_sum));
+    histogramBuilder.append("min", static_cast<long long>(_min));
+    histogramBuilder.append("max", static_cast<long long>(_max));
+
+    BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
+    for (int i = 0; i < kNumBuckets; i++) {
+        if (_buckets[i] == 0) {
+            continue;
+        }
+
+        BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+        entryBuilder.append("lowerBound", static_cast<long long>(getBucketLowerBound(i)));
+        entryBuilder.append("count", static_cast<long long>(_buckets[i]));
+        entryBuilder.doneFast();
+    }
+    arrayBuilder.doneFast();
+    histogramBuilder.doneFast();
+}
+
+// static
+QueryStatsStore& QueryStatsStore::get(ServiceContext* service) {
+    return getQueryStatsStore(service);
+}
+
+// static
+bool QueryStatsStore::isEnabled() {
+    return gQueryStatsStoreMaxEntries > 0;
+}
+
+void QueryStatsStore::record(const QueryStatsKey& key,
+                             const QueryStatsMetrics& metrics,
+                             Date_t now) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (!_entries) {
+        _entries = std::make_unique<EntryMap>(gQueryStatsStoreMaxEntries);
+    }
+
+    Entry* entry;
+    if (!_entries->get(key, &entry).isOK()) {
+        entry = new Entry();
+        entry->firstSeen = now;
+        _entries->add(key, entry);
+    }
+
+    entry->lastSeen = now;
+    entry->latencyMicros.record(metrics.latencyMicros);
+    entry->docsExamined.record(metrics.docsExamined);
+    entry->keysExamined.record(metrics.keysExamined);
+    entry->nreturned.record(metrics.nreturned);
+    entry->bytesReturned.record(metrics.bytesReturned);
+}
+
+std::vector<BSONObj> QueryStatsStore::getStats() const {
+    std::vector<BSONObj> stats;
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (!_entries) {
+        return stats;
+    }
+
+    stats.reserve(_entries->size());
+    for (auto&& [key, entry] : *_entries) {
+        BSONObjBuilder builder;
+        builder.append("ns", key.ns);
+        builder.append("command", key.command);
+        builder.append("queryHash", unsignedIntToFixedLengthHex(key.queryHash));
+        builder.append("execCount", static_cast<long long>(entry->latencyMicros.count()));
+        builder.append("firstSeen", entry->firstSeen);
+        builder.append("lastSeen", entry->lastSeen);
+        entry->latencyMicros.append("latencyMicros", &builder);
+        entry->docsExamined.append("docsExamined", &builder);
+        entry->keysExamined.append("keysExamined", &builder);
+        entry->nreturned.append("nreturned", &builder);
+        entry->bytesReturned.append("bytesReturned", &builder);
+        stats.push_back(builder.obj());
+    }
+    return stats;
+}
+
+void QueryStatsStore::clear() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_entries) {
+        _entries->clear();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/hash/hash.h>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * Summarizes a distribution of non-negative values using buckets whose bounds are powers of two.
+ * The bucket with index i > 0 counts the values in [2^(i-1), 2^i), and bucket 0 counts zeros.
+ *
+ * Note: This class is not thread-safe.
+ */
+class QueryStatsHistogram {
+public:
+    static constexpr int kNumBuckets = 64;
+
+    void record(uint64_t value);
+
+    /**
+     * Appends a subobject named 'fieldName' with the sum, min and max of the recorded values and
+     * the non-empty buckets.
+     */
+    void append(StringData fieldName, BSONObjBuilder* builder) const;
+
+    uint64_t count() const {
+        return _count;
+    }
+
+    uint64_t sum() const {
+        return _sum;
+    }
+
+    static int getBucket(uint64_t value);
+
+    static uint64_t getBucketLowerBound(int bucket);
+
+private:
+    std::array<uint64_t, kNumBuckets> _buckets{};
+    uint64_t _count = 0;
+    uint64_t _sum = 0;
+    uint64_t _min = 0;
+    uint64_t _max = 0;
+};
+
+/**
+ * Identifies a query shape in the QueryStatsStore. Queries share a shape if they run the same
+ * command against the same namespace and have the same queryHash, which is the hash of the
+ * PlanCacheKey's stable part that is also reported by the slow query log and $planCacheStats.
+ */
+struct QueryStatsKey {
+    std::string ns;
+    std::string command;
+    uint32_t queryHash = 0;
+
+    bool operator==(const QueryStatsKey& other) const {
+        return queryHash == other.queryHash && ns == other.ns && command == other.command;
+    }
+
+    template <typename H>
+    friend H AbslHashValue(H h, const QueryStatsKey& key) {
+        return H::combine(std::move(h), key.ns, key.command, key.queryHash);
+    }
+};
+
+/**
+ * The cost of a single execution of a query.
+ */
+struct QueryStatsMetrics {
+    uint64_t latencyMicros = 0;
+    uint64_t docsExamined = 0;
+    uint64_t keysExamined = 0;
+    uint64_t nreturned = 0;
+    uint64_t bytesReturned = 0;
+};
+
+/**
+ * A bounded, process-wide store of execution statistics per query shape, reported by the
+ * $queryStats aggregation stage. When it holds 'queryStatsStoreMaxEntries' shapes, recording a new
+ * shape evicts the least recently executed one.
+ *
+ * This class is thread-safe.
+ */
+class QueryStatsStore {
+public:
+    static QueryStatsStore& get(ServiceContext* service);
+
+    /**
+     * Returns true if the 'queryStatsStoreMaxEntries' server parameter enables collecting query
+     * statistics.
+     */
+    static bool isEnabled();
+
+    /**
+     * Adds a single execution of the query shape 'key' to its statistics.
+     */
+    void record(const QueryStatsKey& key, const QueryStatsMetrics& metrics, Date_t now);
+
+    /**
+     * Returns one document with the statistics of each query shape, ordered from the most to the
+     * least recently executed.
+     */
+    std::vector<BSONObj> getStats() const;
+
+    /**
+     * Removes the statistics of all query shapes.
+     */
+    void clear();
+
+private:
+    struct Entry {
+        Date_t firstSeen;
+        Date_t lastSeen;
+        QueryStatsHistogram latencyMicros;
+        QueryStatsHistogram docsExamined;
+        QueryStatsHistogram keysExamined;
+        QueryStatsHistogram nreturned;
+        QueryStatsHistogram bytesReturned;
+    };
+
+    using EntryMap = LRUKeyValue<QueryStatsKey, Entry, absl::Hash<QueryStatsKey>>;
+
+    // Protects '_entries'.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("QueryStatsStore::_mutex");
+
+    // Created on first use, with the capacity given by 'queryStatsStoreMaxEntries'.
+    std::unique_ptr<EntryMap> _entries;
+};
+
+}  // namespace mongo
@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats_store.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/query_stats_store_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+QueryStatsKey makeKey(uint32_t queryHash) {
+    return {"test.coll", "find", queryHash};
+}
+
+QueryStatsMetrics makeMetrics(uint64_t latencyMicros, uint64_t docsExamined) {
+    QueryStatsMetrics metrics;
+    metrics.latencyMicros = latencyMicros;
+    metrics.docsExamined = docsExamined;
+    metrics.nreturned = 1;
+    return metrics;
+}
+
+TEST(QueryStatsHistogramTest, BucketsArePowersOfTwo) {
+    ASSERT_EQ(QueryStatsHistogram::getBucket(0), 0);
+    ASSERT_EQ(QueryStatsHistogram::getBucket(1), 1);
+    ASSERT_EQ(QueryStatsHistogram::getBucket(2), 2);
+    ASSERT_EQ(QueryStatsHistogram::getBucket(3), 2);
+    ASSERT_EQ(QueryStatsHistogram::getBucket(4), 3);
+    ASSERT_EQ(QueryStatsHistogram::getBucket(1023), 10);
+    ASSERT_EQ(QueryStatsHistogram::getBucket(1024), 11);
+    ASSERT_EQ(QueryStatsHistogram::getBucket(~0ULL), QueryStatsHistogram::kNumBuckets - 1);
+
+    for (int bucket = 0; bucket < QueryStatsHistogram::kNumBuckets; ++bucket) {
+        ASSERT_EQ(QueryStatsHistogram::getBucket(QueryStatsHistogram::getBucketLowerBound(bucket)),
+                  bucket);
+    }
+}
+
+TEST(QueryStatsHistogramTest, AppendReportsNonEmptyBuckets) {
+    QueryStatsHistogram histogram;
+    histogram.record(5);
+    histogram.record(6);
+    histogram.record(100);
+
+    BSONObjBuilder builder;
+    histogram.append("h", &builder);
+    ASSERT_BSONOBJ_EQ(builder.obj(),
+                      BSON("h" << BSON("sum" << 111LL << "min" << 5LL << "max" << 100LL
+                                             << "histogram"
+                                             << BSON_ARRAY(BSON("lowerBound" << 4LL << "count"
+                                                                             << 2LL)
+                                                           << BSON("lowerBound" << 64LL << "count"
+                                                                                << 1LL)))));
+}
+
+TEST(QueryStatsStoreTest, DoesNotRecordWhenDisabled) {
+    QueryStatsStore store;
+    store.record(makeKey(1), makeMetrics(10, 10), Date_t::now());
+    ASSERT(store.getStats().empty());
+}
+
+TEST(QueryStatsStoreTest, AggregatesExecutionsOfTheSameShape) {
+    const auto oldMaxEntries = gQueryStatsStoreMaxEntries;
+    ON_BLOCK_EXIT([&] { gQueryStatsStoreMaxEntries = oldMaxEntries; });
+    gQueryStatsStoreMaxEntries = 10;
+
+    QueryStatsStore store;
+    const Date_t first = Date_t::fromMillisSinceEpoch(1000);
+    const Date_t last = Date_t::fromMillisSinceEpoch(2000);
+    store.record(makeKey(1), makeMetrics(10, 3), first);
+    store.record(makeKey(1), makeMetrics(30, 5), last);
+    store.record(makeKey(2), makeMetrics(20, 0), last);
+
+    auto stats = store.getStats();
+    ASSERT_EQ(stats.size(), 2U);
+
+    // The most recently executed shape is reported first.
+    ASSERT_EQ(stats[0]["queryHash"].String(), "00000002");
+    ASSERT_EQ(stats[1]["queryHash"].String(), "00000001");
+    ASSERT_EQ(stats[1]["ns"].String(), "test.coll");
+    ASSERT_EQ(stats[1]["command"].String(), "find");
+    ASSERT_EQ(stats[1]["execCount"].numberLong(), 2);
+    ASSERT_EQ(stats[1]["firstSeen"].Date(), first);
+    ASSERT_EQ(stats[1]["lastSeen"].Date(), last);
+    ASSERT_EQ(stats[1]["latencyMicros"]["sum"].numberLong(), 40);
+    ASSERT_EQ(stats[1]["latencyMicros"]["max"].numberLong(), 30);
+    ASSERT_EQ(stats[1]["docsExamined"]["min"].numberLong(), 3);
+    ASSERT_EQ(stats[1]["nreturned"]["sum"].numberLong(), 2);
+
+    store.clear();
+    ASSERT(store.getStats().empty());
+}
+
+TEST(QueryStatsStoreTest, EvictsLeastRecentlyExecutedShape) {
+    const auto oldMaxEntries = gQueryStatsStoreMaxEntries;
+    ON_BLOCK_EXIT([&] { gQueryStatsStoreMaxEntries = oldMaxEntries; });
+    gQueryStatsStoreMaxEntries = 2;
+
+    QueryStatsStore store;
+    store.record(makeKey(1), makeMetrics(10, 0), Date_t::now());
+    store.record(makeKey(2), makeMetrics(10, 0), Date_t::now());
+    store.record(makeKey(1), makeMetrics(10, 0), Date_t::now());
+    store.record(makeKey(3), makeMetrics(10, 0), Date_t::now());
+
+    auto stats = store.getStats();
+    ASSERT_EQ(stats.size(), 2U);
+    ASSERT_EQ(stats[0]["queryHash"].String(), "00000003");
+    ASSERT_EQ(stats[1]["queryHash"].String(), "00000001");
+}
+
+}  // namespace
+}  // namespace mongo
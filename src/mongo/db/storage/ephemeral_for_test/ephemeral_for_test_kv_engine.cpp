@@ -36,10 +36,12 @@
 #include <memory>
 
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_parameters_gen.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_recovery_unit.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 namespace ephemeral_for_test {
@@ -121,6 +123,22 @@ bool KVEngine::trySwapMaster(StringStore& newMaster, uint64_t version) {
     return true;
 }
 
+Status KVEngine::checkMemoryUsage() {
+    const auto maxMemoryUsageMB = gMaxMemoryUsageMB.load();
+    if (maxMemoryUsageMB <= 0) {
+        return Status::OK();
+    }
+
+    const auto memoryUsage = StringStore::totalMemory();
+    if (memoryUsage <= maxMemoryUsageMB * 1024 * 1024) {
+        return Status::OK();
+    }
+    _metrics.memoryLimitRejections.fetchAndAdd(1);
+    return {ErrorCodes::ExceededMemoryLimit,
+            str::stream() << kEngineName << " is using " << memoryUsage
+                          << " bytes, more than ephemeralForTestMaxMemoryUsageMB ("
+                          << maxMemoryUsageMB << " MB)"};
+}
 
 Status KVEngine::createSortedDataInterface(OperationContext* opCtx,
                                            const CollectionOptions& collOptions,
@@ -159,6 +159,30 @@ public:
         return _visibilityManager.get();
     }
 
+    /**
+     * Counters reported in the serverStatus section of this storage engine.
+     */
+    struct Metrics {
+        // Transactions which committed writes.
+        AtomicWord<long long> commits{0};
+        // Times a commit merged with a newer master and had to retry swapping it in.
+        AtomicWord<long long> commitRetries{0};
+        // Commits which failed with a WriteConflictException while merging.
+        AtomicWord<long long> writeConflicts{0};
+        // Writes which failed because of 'ephemeralForTestMaxMemoryUsageMB'.
+        AtomicWord<long long> memoryLimitRejections{0};
+    };
+
+    Metrics& metrics() {
+        return _metrics;
+    }
+
+    /**
+     * Returns ExceededMemoryLimit if the memory used by the engine is above
+     * 'ephemeralForTestMaxMemoryUsageMB'. Called before writes which grow the data.
+     */
+    Status checkMemoryUsage();
+
     /**
      * History in the map that is older than the oldest timestamp can be removed. Additionally, if
      * the tree at the oldest timestamp is no longer in use by any active transactions it can be
@@ -181,6 +205,7 @@ private:
     mutable Mutex _identsLock = MONGO_MAKE_LATCH("KVEngine::_identsLock");
     std::map<std::string, bool> _idents;  // TODO : replace with a query to _master.
     std::unique_ptr<VisibilityManager> _visibilityManager;
+    Metrics _metrics;
 
     mutable Mutex _masterLock = MONGO_MAKE_LATCH("KVEngine::_masterLock");
     std::shared_ptr<StringStore> _master;
@@ -39,7 +39,9 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_kv_engine.h"
+#include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_parameters_gen.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace ephemeral_for_test {
@@ -316,5 +318,47 @@ TEST_F(EphemeralForTestKVEngineTest, CleanHistoryWithOpenTransaction) {
     ASSERT_EQ(3, _engine->getHistory_forTest().at(readTime3).use_count());
 }
 
+TEST_F(EphemeralForTestKVEngineTest, WritesFailOnceMemoryLimitIsExceeded) {
+    NamespaceString nss("a.b");
+    std::string ident = "collection-1234";
+    std::string record(64 * 1024, 'x');
+    CollectionOptions defaultCollectionOptions;
+
+    std::unique_ptr<mongo::RecordStore> rs;
+    {
+        OperationContextFromKVEngine opCtx(_engine);
+        ASSERT_OK(_engine->createRecordStore(&opCtx, nss.ns(), ident, defaultCollectionOptions));
+        rs = _engine->getRecordStore(&opCtx, nss.ns(), ident, defaultCollectionOptions);
+        ASSERT(rs);
+    }
+
+    const auto originalMaxMemoryUsageMB = gMaxMemoryUsageMB.load();
+    ON_BLOCK_EXIT([&] { gMaxMemoryUsageMB.store(originalMaxMemoryUsageMB); });
+    gMaxMemoryUsageMB.store(StringStore::totalMemory() / (1024 * 1024) + 1);
+
+    // Each insert adds 64KB, so the limit is hit well before the last iteration.
+    Status status = Status::OK();
+    for (int i = 0; i < 64 && status.isOK(); ++i) {
+        OperationContextFromKVEngine opCtx(_engine);
+        WriteUnitOfWork uow(&opCtx);
+        status = rs->insertRecord(&opCtx, record.c_str(), record.length() + 1, Timestamp())
+                     .getStatus();
+        if (status.isOK()) {
+            uow.commit();
+        }
+    }
+    ASSERT_EQ(ErrorCodes::ExceededMemoryLimit, status);
+    ASSERT_EQ(1, _engine->metrics().memoryLimitRejections.load());
+
+    // Removing the limit lets writes through again.
+    gMaxMemoryUsageMB.store(0);
+    {
+        OperationContextFromKVEngine opCtx(_engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(rs->insertRecord(&opCtx, record.c_str(), record.length() + 1, Timestamp()));
+        uow.commit();
+    }
+}
+
 }  // namespace ephemeral_for_test
 }  // namespace mongo
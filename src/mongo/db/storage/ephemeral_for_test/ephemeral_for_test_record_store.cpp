@@ -160,6 +160,9 @@ Status RecordStore::insertRecords(OperationContext* opCtx,
         return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
 
     auto ru = RecoveryUnit::get(opCtx);
+    if (auto status = ru->checkMemoryUsage(); !status.isOK()) {
+        return status;
+    }
     StringStore* workingCopy(ru->getHead());
     {
         SizeAdjuster adjuster(opCtx, this);
@@ -190,6 +193,9 @@ Status RecordStore::updateRecord(OperationContext* opCtx,
                                  const RecordId& oldLocation,
                                  const char* data,
                                  int len) {
+    if (auto status = RecoveryUnit::get(opCtx)->checkMemoryUsage(); !status.isOK()) {
+        return status;
+    }
     StringStore* workingCopy(RecoveryUnit::get(opCtx)->getHead());
     SizeAdjuster adjuster(opCtx, this);
     {
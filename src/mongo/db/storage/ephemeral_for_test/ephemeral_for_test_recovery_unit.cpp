@@ -64,14 +64,17 @@ void RecoveryUnit::doCommitUnitOfWork() {
                 invariant(_mergeBase);
                 _workingCopy.merge3(*_mergeBase, *masterInfo.second);
             } catch (const merge_conflict_exception&) {
+                _KVEngine->metrics().writeConflicts.fetchAndAdd(1);
                 throw WriteConflictException();
             }
 
             if (_KVEngine->trySwapMaster(_workingCopy, masterInfo.first)) {
                 // Merged successfully
+                _KVEngine->metrics().commits.fetchAndAdd(1);
                 break;
             } else {
                 // Retry the merge, but update the mergeBase since some progress was made merging.
+                _KVEngine->metrics().commitRetries.fetchAndAdd(1);
                 _mergeBase = masterInfo.second;
             }
         }
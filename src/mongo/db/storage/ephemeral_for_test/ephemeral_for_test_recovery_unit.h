@@ -91,6 +91,13 @@ public:
         _dirty = true;
     }
 
+    /**
+     * Returns an error if the engine is over its memory limit, see KVEngine::checkMemoryUsage().
+     */
+    Status checkMemoryUsage() {
+        return _KVEngine->checkMemoryUsage();
+    }
+
     /**
      * Checks if there already exists a current working copy and merge base; if not fetches
      * one and creates them.
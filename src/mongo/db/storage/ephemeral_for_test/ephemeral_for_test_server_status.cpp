@@ -36,6 +36,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_kv_engine.h"
+#include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_parameters_gen.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_radix_store.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_record_store.h"
 #include "mongo/logv2/log.h"
@@ -63,6 +64,13 @@ BSONObj ServerStatusSection::generateSection(OperationContext* opCtx,
     bob.append("totalMemoryUsage", StringStore::totalMemory());
     bob.append("totalNodes", StringStore::totalNodes());
     bob.append("averageChildren", StringStore::averageChildren());
+    bob.append("maxMemoryUsageMB", gMaxMemoryUsageMB.load());
+
+    auto& metrics = _engine->metrics();
+    bob.append("commits", metrics.commits.load());
+    bob.append("commitRetries", metrics.commitRetries.load());
+    bob.append("writeConflicts", metrics.writeConflicts.load());
+    bob.append("memoryLimitRejections", metrics.memoryLimitRejections.load());
 
     return bob.obj();
 }
@@ -1190,6 +1190,9 @@ void SortedDataBuilderBase::commit(bool mayInterrupt) {
 
 Status SortedDataBuilderUnique::addKey(const KeyString::Value& keyString) {
     dassert(KeyString::decodeRecordIdAtEnd(keyString.getBuffer(), keyString.getSize()).isValid());
+    if (auto status = RecoveryUnit::get(_opCtx)->checkMemoryUsage(); !status.isOK()) {
+        return status;
+    }
     StringStore* workingCopy(RecoveryUnit::get(_opCtx)->getHead());
     RecordId loc = KeyString::decodeRecordIdAtEnd(keyString.getBuffer(), keyString.getSize());
 
@@ -1284,6 +1287,9 @@ SortedDataInterfaceUnique::SortedDataInterfaceUnique(const Ordering& ordering, S
 Status SortedDataInterfaceUnique::insert(OperationContext* opCtx,
                                          const KeyString::Value& keyString,
                                          bool dupsAllowed) {
+    if (auto status = RecoveryUnit::get(opCtx)->checkMemoryUsage(); !status.isOK()) {
+        return status;
+    }
     StringStore* workingCopy(RecoveryUnit::get(opCtx)->getHead());
     RecordId loc = KeyString::decodeRecordIdAtEnd(keyString.getBuffer(), keyString.getSize());
 
@@ -1429,6 +1435,9 @@ Status SortedDataInterfaceBase::initAsEmpty(OperationContext* opCtx) {
 
 Status SortedDataBuilderStandard::addKey(const KeyString::Value& keyString) {
     dassert(KeyString::decodeRecordIdAtEnd(keyString.getBuffer(), keyString.getSize()).isValid());
+    if (auto status = RecoveryUnit::get(_opCtx)->checkMemoryUsage(); !status.isOK()) {
+        return status;
+    }
     StringStore* workingCopy(RecoveryUnit::get(_opCtx)->getHead());
     RecordId loc = KeyString::decodeRecordIdAtEnd(keyString.getBuffer(), keyString.getSize());
 
@@ -1480,6 +1489,9 @@ SortedDataInterfaceStandard::SortedDataInterfaceStandard(const Ordering& orderin
 Status SortedDataInterfaceStandard::insert(OperationContext* opCtx,
                                            const KeyString::Value& keyString,
                                            bool dupsAllowed) {
+    if (auto status = RecoveryUnit::get(opCtx)->checkMemoryUsage(); !status.isOK()) {
+        return status;
+    }
     StringStore* workingCopy(RecoveryUnit::get(opCtx)->getHead());
     RecordId loc = KeyString::decodeRecordIdAtEnd(keyString.getBuffer(), keyString.getSize());
 
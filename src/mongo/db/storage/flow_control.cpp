@@ -213,6 +213,13 @@ BSONObj FlowControl::generateSection(OperationContext* opCtx,
     bob.append("isLagged", _isLagged.load());
     bob.append("isLaggedCount", _isLaggedCount.load());
     bob.append("isLaggedTimeMicros", _isLaggedTimeMicros.load());
+    if (gFlowControlPredictive.load()) {
+        BSONObjBuilder forecast(bob.subobjStart("forecast"));
+        forecast.append("horizonSeconds", gFlowControlForecastHorizonSeconds.load());
+        forecast.append("lagMillis", _lastForecastLagMillis.load());
+        forecast.append("lagTrendMillisPerSecond", _lastLagTrendMillisPerSecond.load());
+        forecast.append("smoothedSustainerRate", _lastSmoothedSustainerRate.load());
+    }
 
     return bob.obj();
 }
@@ -236,13 +243,9 @@ void FlowControl::_updateTopologyData() {
               });
 }
 
-int FlowControl::_calculateNewTicketsForLag(const std::vector<repl::MemberData>& prevMemberData,
-                                            const std::vector<repl::MemberData>& currMemberData,
-                                            std::int64_t locksUsedLastPeriod,
-                                            double locksPerOp,
-                                            std::uint64_t lagMillis,
-                                            std::uint64_t thresholdLagMillis) {
-    invariant(lagMillis >= thresholdLagMillis);
+std::int64_t FlowControl::_approximateSustainerAppliedCount(
+    const std::vector<repl::MemberData>& prevMemberData,
+    const std::vector<repl::MemberData>& currMemberData) {
     using namespace fmt::literals;
 
     const auto currSustainerAppliedTs = getMedianAppliedTimestamp(currMemberData);
@@ -277,6 +280,19 @@ int FlowControl::_calculateNewTicketsForLag(const std::vector<repl::MemberData>&
     }
 
     _lastSustainerAppliedCount.store(static_cast<int>(sustainerAppliedCount));
+    return sustainerAppliedCount;
+}
+
+int FlowControl::_calculateNewTicketsForLag(const std::vector<repl::MemberData>& prevMemberData,
+                                            const std::vector<repl::MemberData>& currMemberData,
+                                            std::int64_t locksUsedLastPeriod,
+                                            double locksPerOp,
+                                            std::uint64_t lagMillis,
+                                            std::uint64_t thresholdLagMillis) {
+    invariant(lagMillis >= thresholdLagMillis);
+
+    const std::int64_t sustainerAppliedCount =
+        _approximateSustainerAppliedCount(prevMemberData, currMemberData);
     if (sustainerAppliedCount == -1) {
         // We don't know how many ops the sustainer applied. Hand out less tickets than were
         // used in the last period.
@@ -318,6 +334,110 @@ int FlowControl::_calculateNewTicketsForLag(const std::vector<repl::MemberData>&
     return multiplyWithOverflowCheck(locksPerOp, sustainerAppliedPenalty, kMaxTickets);
 }
 
+void FlowControl::_resetForecast() {
+    _lastForecastTime = boost::none;
+    _lagLevelMillis = 0.0;
+    _lagTrendMillisPerSecond = 0.0;
+    _smoothedSustainerAppliedCount = -1.0;
+}
+
+std::uint64_t FlowControl::_forecastLag(std::uint64_t lagMillis, Date_t now) {
+    const double alpha = gFlowControlForecastSmoothing.load();
+    const auto observedLag = static_cast<double>(lagMillis);
+
+    if (!_lastForecastTime || now <= *_lastForecastTime) {
+        // Without a previous observation, or if the clock went backwards, there is no trend to
+        // speak of. Start over from the current lag.
+        _lagLevelMillis = observedLag;
+        _lagTrendMillisPerSecond = 0.0;
+    } else {
+        // Double exponential smoothing: the level follows the observed lag, the trend follows the
+        // change in level. Both are normalized by the elapsed time since the refresher period is
+        // not exact.
+        const double elapsedSeconds =
+            durationCount<Milliseconds>(now - *_lastForecastTime) / 1000.0;
+        const double prevLevel = _lagLevelMillis;
+        _lagLevelMillis = alpha * observedLag +
+            (1.0 - alpha) * (prevLevel + _lagTrendMillisPerSecond * elapsedSeconds);
+        _lagTrendMillisPerSecond = alpha * (_lagLevelMillis - prevLevel) / elapsedSeconds +
+            (1.0 - alpha) * _lagTrendMillisPerSecond;
+    }
+    _lastForecastTime = now;
+
+    const double forecast = std::max(
+        0.0,
+        _lagLevelMillis + _lagTrendMillisPerSecond * gFlowControlForecastHorizonSeconds.load());
+    const auto forecastLagMillis = static_cast<std::uint64_t>(forecast);
+
+    _lastForecastLagMillis.store(static_cast<std::int64_t>(forecastLagMillis));
+    _lastLagTrendMillisPerSecond.store(_lagTrendMillisPerSecond);
+    return forecastLagMillis;
+}
+
+int FlowControl::_calculateNewTicketsForForecast(
+    const std::vector<repl::MemberData>& prevMemberData,
+    const std::vector<repl::MemberData>& currMemberData,
+    std::int64_t locksUsedLastPeriod,
+    double locksPerOp,
+    std::uint64_t lagMillis,
+    std::uint64_t forecastLagMillis,
+    std::uint64_t thresholdLagMillis) {
+    const std::int64_t sustainerAppliedCount =
+        _approximateSustainerAppliedCount(prevMemberData, currMemberData);
+    if (sustainerAppliedCount == -1) {
+        // We don't know how many ops the sustainer applied. Hand out less tickets than were
+        // used in the last period.
+        return std::min(static_cast<int>(locksUsedLastPeriod / 2.0), kMaxTickets);
+    }
+
+    // A single slow period on the sustainer should not translate into a single period of starved
+    // writers, so the tickets are derived from the smoothed sustainer rate.
+    const double alpha = gFlowControlForecastSmoothing.load();
+    _smoothedSustainerAppliedCount = _smoothedSustainerAppliedCount < 0.0
+        ? sustainerAppliedCount
+        : alpha * sustainerAppliedCount + (1.0 - alpha) * _smoothedSustainerAppliedCount;
+    _lastSmoothedSustainerRate.store(_smoothedSustainerAppliedCount);
+
+    // Same decay as the reactive calculation, applied to the worse of the current and forecasted
+    // lag. A forecast below the threshold together with a current lag below the threshold does not
+    // get here, so the exponent is 0 when only the forecast is lagged.
+    const auto effectiveLagMillis = std::max(lagMillis, forecastLagMillis);
+    const auto exponent = effectiveLagMillis > thresholdLagMillis
+        ? static_cast<double>(effectiveLagMillis - thresholdLagMillis) /
+            static_cast<double>(std::max<std::uint64_t>(thresholdLagMillis, 1))
+        : 0.0;
+    const double reduce = pow(gFlowControlDecayConstant.load(), exponent);
+    const int target = multiplyWithOverflowCheck(
+        locksPerOp,
+        _smoothedSustainerAppliedCount * reduce * gFlowControlFudgeFactor.load(),
+        kMaxTickets);
+
+    // Move only part of the way from what writers were using to the target. Start from the locks
+    // actually used rather than the last grant, which is meaningless when we were not throttling.
+    // If the lag is already past the target lag, take the target as is.
+    const double prevTickets = std::min(static_cast<double>(_lastTargetTicketsPermitted.load()),
+                                        static_cast<double>(std::max<std::int64_t>(
+                                            locksUsedLastPeriod, 0)));
+    int ret = target;
+    if (lagMillis < static_cast<std::uint64_t>(1000.0 * gFlowControlTargetLagSeconds.load())) {
+        ret = static_cast<int>(std::min(alpha * target + (1.0 - alpha) * prevTickets,
+                                        static_cast<double>(kMaxTickets)));
+    }
+
+    LOGV2_DEBUG(4798617,
+                DEBUG_LOG_LEVEL,
+                "Predictive flow control calculation",
+                "sustainerAppliedCount"_attr = sustainerAppliedCount,
+                "smoothedSustainerAppliedCount"_attr = _smoothedSustainerAppliedCount,
+                "lagMillis"_attr = lagMillis,
+                "forecastLagMillis"_attr = forecastLagMillis,
+                "thresholdLagMillis"_attr = thresholdLagMillis,
+                "exponent"_attr = exponent,
+                "target"_attr = target,
+                "granting"_attr = ret);
+    return ret;
+}
+
 int FlowControl::getNumTickets(Date_t now) {
     // Flow control can be disabled until a certain deadline is passed.
     const Date_t disabledUntil = _disableUntil.load();
@@ -346,6 +466,7 @@ int FlowControl::getNumTickets(Date_t now) {
         gFlowControlEnabled.load() == false || canAcceptWrites == false || locksPerOp < 0.0) {
         _trimSamples(std::min(lastCommitted.opTime.getTimestamp(),
                               getMedianAppliedTimestamp(_prevMemberData)));
+        _resetForecast();
         return kMaxTickets;
     }
 
@@ -362,8 +483,21 @@ int FlowControl::getNumTickets(Date_t now) {
     //
     // Don't let the no-op writer on idle systems fool the sophisticated "is the replica set
     // lagged" classifier.
+    const auto lagMillis =
+        ignoreWallTimes ? 0 : getLagMillis(myLastApplied.wallTime, lastCommitted.wallTime);
+
+    // In predictive mode, throttling engages as soon as either the current lag or the lag
+    // extrapolated from its trend crosses the threshold.
+    const bool predictive = gFlowControlPredictive.load();
+    std::uint64_t forecastLagMillis = lagMillis;
+    if (!predictive) {
+        _resetForecast();
+    } else if (!ignoreWallTimes) {
+        forecastLagMillis = _forecastLag(lagMillis, now);
+    }
+
     const bool isHealthy = !ignoreWallTimes &&
-        (getLagMillis(myLastApplied.wallTime, lastCommitted.wallTime) < thresholdLagMillis ||
+        (std::max(lagMillis, forecastLagMillis) < thresholdLagMillis ||
          _approximateOpsBetween(lastCommitted.opTime.getTimestamp(),
                                 myLastApplied.opTime.getTimestamp()) == -1);
 
@@ -383,13 +517,19 @@ int FlowControl::getNumTickets(Date_t now) {
     } else if (!ignoreWallTimes && sustainerAdvanced(_prevMemberData, _currMemberData)) {
         // Expected case where flow control has meaningful data from the last period to make a new
         // calculation.
-        ret =
-            _calculateNewTicketsForLag(_prevMemberData,
-                                       _currMemberData,
-                                       locksUsedLastPeriod,
-                                       locksPerOp,
-                                       getLagMillis(myLastApplied.wallTime, lastCommitted.wallTime),
-                                       thresholdLagMillis);
+        ret = predictive ? _calculateNewTicketsForForecast(_prevMemberData,
+                                                           _currMemberData,
+                                                           locksUsedLastPeriod,
+                                                           locksPerOp,
+                                                           lagMillis,
+                                                           forecastLagMillis,
+                                                           thresholdLagMillis)
+                         : _calculateNewTicketsForLag(_prevMemberData,
+                                                      _currMemberData,
+                                                      locksUsedLastPeriod,
+                                                      locksPerOp,
+                                                      lagMillis,
+                                                      thresholdLagMillis);
         if (!_isLagged.load()) {
             _isLagged.store(true);
             _isLaggedCount.fetchAndAddRelaxed(1);
@@ -411,7 +551,7 @@ int FlowControl::getNumTickets(Date_t now) {
                 DEBUG_LOG_LEVEL,
                 "FlowControl debug.",
                 "isLagged"_attr = (_isLagged.load() ? "true" : "false"),
-                "currlagMillis"_attr = getLagMillis(myLastApplied.wallTime, lastCommitted.wallTime),
+                "currlagMillis"_attr = lagMillis,
                 "opsLagged"_attr = _approximateOpsBetween(lastCommitted.opTime.getTimestamp(),
                                                           myLastApplied.opTime.getTimestamp()),
                 "granting"_attr = ret,
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <deque>
 
 #include "mongo/db/commands/server_status.h"
@@ -127,6 +128,23 @@ public:
                                    double locksPerOp,
                                    std::uint64_t lagMillis,
                                    std::uint64_t thresholdLagMillis);
+
+    /**
+     * Predictive flow control. `_forecastLag` folds the current majority committed lag into a
+     * smoothed level and trend and returns the lag extrapolated `flowControlForecastHorizonSeconds`
+     * ahead. `_calculateNewTicketsForForecast` derives tickets from a smoothed sustainer rate, the
+     * worse of the current and forecasted lag, and moves the issued tickets only part of the way
+     * toward that target each period.
+     */
+    std::uint64_t _forecastLag(std::uint64_t lagMillis, Date_t now);
+    void _resetForecast();
+    int _calculateNewTicketsForForecast(const std::vector<repl::MemberData>& prevMemberData,
+                                        const std::vector<repl::MemberData>& currMemberData,
+                                        std::int64_t locksUsedLastPeriod,
+                                        double locksPerOp,
+                                        std::uint64_t lagMillis,
+                                        std::uint64_t forecastLagMillis,
+                                        std::uint64_t thresholdLagMillis);
     void _trimSamples(const Timestamp trimSamplesTo);
 
     // Sample of (timestamp, ops, lock acquisitions) where ops and lock acquisitions are
@@ -137,6 +155,14 @@ public:
     }
 
 private:
+    /**
+     * Returns how many ops the sustainer applied between the two topology readings, or -1 if that
+     * can't be determined. Also records the result for server status.
+     */
+    std::int64_t _approximateSustainerAppliedCount(
+        const std::vector<repl::MemberData>& prevMemberData,
+        const std::vector<repl::MemberData>& currMemberData);
+
     repl::ReplicationCoordinator* _replCoord;
 
     // These values are updated with each flow control computation and are also surfaced in server
@@ -149,6 +175,9 @@ private:
     // Use an int64_t as this is serialized to bson which does not support unsigned 64-bit numbers.
     AtomicWord<std::int64_t> _isLaggedTimeMicros{0};
     AtomicWord<Date_t> _disableUntil;
+    AtomicWord<std::int64_t> _lastForecastLagMillis{0};
+    AtomicWord<double> _lastLagTrendMillisPerSecond{0.0};
+    AtomicWord<double> _lastSmoothedSustainerRate{0.0};
 
     mutable Mutex _sampledOpsMutex = MONGO_MAKE_LATCH("FlowControl::_sampledOpsMutex");
     std::deque<Sample> _sampledOpsApplied;
@@ -164,6 +193,13 @@ private:
 
     Date_t _lastTimeSustainerAdvanced;
 
+    // State of the predictive model. Only the flow control refresher thread touches these.
+    boost::optional<Date_t> _lastForecastTime;
+    double _lagLevelMillis = 0.0;
+    double _lagTrendMillisPerSecond = 0.0;
+    // Negative until the first sustainer reading is folded in.
+    double _smoothedSustainerAppliedCount = -1.0;
+
     // This value is used for calculating server status metrics.
     std::uint64_t _startWaitTime = 0;
 
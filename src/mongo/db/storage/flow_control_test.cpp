@@ -249,6 +249,83 @@ TEST_F(FlowControlTest, CalculatingTickets) {
                                                       thresholdLag));
 }
 
+TEST_F(FlowControlTest, ForecastingLag) {
+    gFlowControlForecastSmoothing.store(0.5);
+    gFlowControlForecastHorizonSeconds.store(2.0);
+
+    const Date_t start = Date_t::fromMillisSinceEpoch(100 * 1000);
+
+    // A steady lag has no trend and forecasts itself.
+    for (int period = 0; period < 5; ++period) {
+        ASSERT_EQ(500u, flowControl->_forecastLag(500, start + Seconds(period)));
+    }
+
+    // A lag growing by one second every second. The first observation after a reset has no trend.
+    flowControl->_resetForecast();
+    ASSERT_EQ(1000u, flowControl->_forecastLag(1000, start));
+    // Level: 0.5 * 2000 + 0.5 * 1000 = 1500. Trend: 0.5 * 500 = 250/s. Forecast: 1500 + 2 * 250.
+    ASSERT_EQ(2000u, flowControl->_forecastLag(2000, start + Seconds(1)));
+    // Level: 0.5 * 3000 + 0.5 * (1500 + 250) = 2375. Trend: 0.5 * 875 + 0.5 * 250 = 562.5/s.
+    // The forecast now leads the observed lag.
+    ASSERT_EQ(3500u, flowControl->_forecastLag(3000, start + Seconds(2)));
+
+    BSONElement noopVar;
+    gFlowControlPredictive.store(true);
+    auto serverStatusSection = flowControl->generateSection(opCtx.get(), noopVar);
+    gFlowControlPredictive.store(false);
+    ASSERT_EQ(3500, serverStatusSection["forecast"]["lagMillis"].numberLong());
+    ASSERT_EQ(562.5, serverStatusSection["forecast"]["lagTrendMillisPerSecond"].Double());
+
+    // A clock going backwards restarts the model from the observed lag.
+    ASSERT_EQ(100u, flowControl->_forecastLag(100, start));
+}
+
+TEST_F(FlowControlTest, CalculatingTicketsForForecast) {
+    gFlowControlFudgeFactor.store(0.95);
+    gFlowControlForecastSmoothing.store(0.5);
+
+    auto constructMemberData = [](Timestamp ts) -> repl::MemberData {
+        repl::MemberData ret;
+        ret.setLastAppliedOpTimeAndWallTime({{ts, 1}, Date_t()}, Date_t());
+        return ret;
+    };
+
+    // Same topology as `CalculatingTickets`: the sustainer applied 1,000 operations.
+    std::vector<repl::MemberData> prevMemberData;
+    prevMemberData.emplace_back(constructMemberData(Timestamp(1000)));
+    prevMemberData.emplace_back(constructMemberData(Timestamp(1000)));
+    prevMemberData.emplace_back(constructMemberData(Timestamp(1000)));
+
+    std::vector<repl::MemberData> currMemberData;
+    currMemberData.emplace_back(constructMemberData(Timestamp(2000)));
+    currMemberData.emplace_back(constructMemberData(Timestamp(2000)));
+    currMemberData.emplace_back(constructMemberData(Timestamp(3000)));
+
+    for (int ts = 1; ts <= 3000; ++ts) {
+        flowControl->sample(Timestamp(ts), 1);
+    }
+
+    // The target is 1,000 * 0.95 * 2.0 = 1900 tickets, as for the reactive calculation. Writers
+    // used 1,000 locks last period, so half the distance to the target is covered.
+    const std::int64_t locksUsedLastPeriod = 1000;
+    const double locksPerOp = 2.0;
+    const std::uint64_t thresholdLag = 1;
+    ASSERT_EQ(1450,
+              flowControl->_calculateNewTicketsForForecast(prevMemberData,
+                                                           currMemberData,
+                                                           locksUsedLastPeriod,
+                                                           locksPerOp,
+                                                           thresholdLag,
+                                                           thresholdLag,
+                                                           thresholdLag));
+
+    BSONElement noopVar;
+    gFlowControlPredictive.store(true);
+    auto serverStatusSection = flowControl->generateSection(opCtx.get(), noopVar);
+    gFlowControlPredictive.store(false);
+    ASSERT_EQ(1000.0, serverStatusSection["forecast"]["smoothedSustainerRate"].Double());
+}
+
 TEST_F(FlowControlTest, DisableUntil) {
     const int ticketOverride = 52319;
 
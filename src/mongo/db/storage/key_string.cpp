@@ -36,6 +36,10 @@
 #include <cmath>
 #include <type_traits>
 
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#endif
+
 #include "mongo/base/data_cursor.h"
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
@@ -241,10 +245,29 @@ const uint8_t kGreater = 254;
 // some utility functions
 namespace {
 
+/**
+ * Copies 'bytes' bytes from 'src' to 'dst', inverting every bit. Descending fields are stored
+ * inverted, so this is on the hot path of both encoding and decoding them. Works on 16 bytes at a
+ * time where SSE2 is available and on 8 bytes at a time elsewhere. 'dst' may be the same as 'src'
+ * to invert a buffer in place, but the two must not otherwise overlap.
+ */
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
     const char* const end = input + bytes;
+#if defined(_M_AMD64) || defined(__amd64__)
+    const __m128i allOnes = _mm_set1_epi8(-1);
+    for (; end - input >= 16; input += 16, output += 16) {
+        const __m128i word = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_xor_si128(word, allOnes));
+    }
+#endif
+    for (; end - input >= 8; input += 8, output += 8) {
+        uint64_t word;
+        memcpy(&word, input, sizeof(word));
+        word = ~word;
+        memcpy(output, &word, sizeof(word));
+    }
     while (input != end) {
         *output++ = ~(*input++);
     }
@@ -296,10 +319,8 @@ string readInvertedCString(BufReader* reader) {
     const char* end = static_cast<const char*>(memchr(start, 0xFF, reader->remaining()));
     keyStringAssert(50817, "Failed to find '0xFF' in inverted string.", end);
     size_t actualBytes = end - start;
-    string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    string s(actualBytes, '\0');
+    memcpy_flipBits(&s[0], start, actualBytes);
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -326,10 +347,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
-
+    memcpy_flipBits(&out[0], out.data(), out.size());
     return out;
 }
 }  // namespace
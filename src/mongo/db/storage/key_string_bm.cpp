@@ -48,6 +48,7 @@ const int kStrLenMultiplier = 100;
 const int kArrLenMultiplier = 40;
 
 const Ordering ALL_ASCENDING = Ordering::make(BSONObj());
+const Ordering ALL_DESCENDING = Ordering::make(BSON("a" << -1));
 
 struct BsonsAndKeyStrings {
     int bsonSize = 0;
@@ -63,6 +64,7 @@ enum BsonValueType {
     INT,
     DOUBLE,
     STRING,
+    STRING_WITH_NULS,
     ARRAY,
     DECIMAL,
 };
@@ -79,6 +81,13 @@ BSONObj generateBson(BsonValueType bsonValueType) {
             return BSON("" << expReal(gen));
         case STRING:
             return BSON("" << std::string(expDist(gen) * kStrLenMultiplier, 'x'));
+        case STRING_WITH_NULS: {
+            std::string str(expDist(gen) * kStrLenMultiplier, 'x');
+            for (size_t i = 0; i < str.size(); i += 16) {
+                str[i] = '\0';
+            }
+            return BSON("" << str);
+        }
         case ARRAY: {
             const int arrLen = expDist(gen) * kArrLenMultiplier;
             BSONArrayBuilder bab;
@@ -97,13 +106,14 @@ BSONObj generateBson(BsonValueType bsonValueType) {
 }
 
 static BsonsAndKeyStrings generateBsonsAndKeyStrings(BsonValueType bsonValueType,
-                                                     KeyString::Version version) {
+                                                     KeyString::Version version,
+                                                     Ordering ordering = ALL_ASCENDING) {
     BsonsAndKeyStrings result;
     result.bsonSize = 0;
     result.keystringSize = 0;
     for (int i = 0; i < kSampleSize; i++) {
         BSONObj bson = generateBson(bsonValueType);
-        KeyString::Builder ks(version, bson, ALL_ASCENDING);
+        KeyString::Builder ks(version, bson, ordering);
         result.bsonSize += bson.objsize();
         result.keystringSize += ks.getSize();
         result.bsons[i] = bson;
@@ -121,12 +131,14 @@ static BsonsAndKeyStrings generateBsonsAndKeyStrings(BsonValueType bsonValueType
 
 void BM_BSONToKeyString(benchmark::State& state,
                         const KeyString::Version version,
-                        BsonValueType bsonType) {
-    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+                        BsonValueType bsonType,
+                        Ordering ordering = ALL_ASCENDING) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings =
+        generateBsonsAndKeyStrings(bsonType, version, ordering);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         for (auto bson : bsonsAndKeyStrings.bsons) {
-            benchmark::DoNotOptimize(KeyString::Builder(version, bson, ALL_ASCENDING));
+            benchmark::DoNotOptimize(KeyString::Builder(version, bson, ordering));
         }
     }
     state.SetBytesProcessed(state.iterations() * bsonsAndKeyStrings.bsonSize);
@@ -135,8 +147,10 @@ void BM_BSONToKeyString(benchmark::State& state,
 
 void BM_KeyStringToBSON(benchmark::State& state,
                         const KeyString::Version version,
-                        BsonValueType bsonType) {
-    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+                        BsonValueType bsonType,
+                        Ordering ordering = ALL_ASCENDING) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings =
+        generateBsonsAndKeyStrings(bsonType, version, ordering);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         for (size_t i = 0; i < kSampleSize; i++) {
@@ -144,7 +158,7 @@ void BM_KeyStringToBSON(benchmark::State& state,
             benchmark::DoNotOptimize(
                 KeyString::toBson(bsonsAndKeyStrings.keystrings[i].get(),
                                   bsonsAndKeyStrings.keystringLens[i],
-                                  ALL_ASCENDING,
+                                  ordering,
                                   KeyString::TypeBits::fromBuffer(version, &buf)));
         }
     }
@@ -234,6 +248,16 @@ BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_StringWithNuls, KeyString::Version::V1, STRING_WITH_NULS);
+BENCHMARK_CAPTURE(
+    BM_BSONToKeyString, V1_String_Descending, KeyString::Version::V1, STRING, ALL_DESCENDING);
+BENCHMARK_CAPTURE(BM_BSONToKeyString,
+                  V1_StringWithNuls_Descending,
+                  KeyString::Version::V1,
+                  STRING_WITH_NULS,
+                  ALL_DESCENDING);
+BENCHMARK_CAPTURE(
+    BM_BSONToKeyString, V1_Array_Descending, KeyString::Version::V1, ARRAY, ALL_DESCENDING);
 
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Int, KeyString::Version::V1, INT);
@@ -244,6 +268,16 @@ BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_StringWithNuls, KeyString::Version::V1, STRING_WITH_NULS);
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_String_Descending, KeyString::Version::V1, STRING, ALL_DESCENDING);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON,
+                  V1_StringWithNuls_Descending,
+                  KeyString::Version::V1,
+                  STRING_WITH_NULS,
+                  ALL_DESCENDING);
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_Array_Descending, KeyString::Version::V1, ARRAY, ALL_DESCENDING);
 
 }  // namespace
 }  // namespace mongo
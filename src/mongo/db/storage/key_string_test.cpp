@@ -467,6 +467,23 @@ TEST_F(KeyStringBuilderTest, Compound1) {
     ROUNDTRIP(version, BSON("" << BSON("" << 5) << "" << 1));
 }
 
+TEST_F(KeyStringBuilderTest, LongStrings) {
+    // Strings long enough to be inverted several bytes at a time when descending, with NUL bytes
+    // at and around word boundaries.
+    for (size_t length : {0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 100}) {
+        std::string str(length, 'x');
+        ROUNDTRIP(version, BSON("" << str));
+        for (size_t nulPos : {size_t(0), length / 2, length - 1}) {
+            if (nulPos < length) {
+                std::string withNul = str;
+                withNul[nulPos] = '\0';
+                ROUNDTRIP(version, BSON("" << withNul));
+                ROUNDTRIP(version, BSON("" << BSONCode(withNul)));
+            }
+        }
+    }
+}
+
 TEST_F(KeyStringBuilderTest, Undef1) {
     ROUNDTRIP(version, BSON("" << BSONUndefined));
 }
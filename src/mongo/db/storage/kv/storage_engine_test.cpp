@@ -47,10 +47,12 @@
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/storage_engine_impl.h"
 #include "mongo/db/storage/storage_engine_test_fixture.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/unittest/barrier.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/periodic_runner_factory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -131,6 +133,33 @@ TEST_F(StorageEngineTest, LoadCatalogDropsOrphansAfterUncleanShutdown) {
     ASSERT(!collectionExists(opCtx.get(), collNs));
 }
 
+TEST_F(StorageEngineTest, LoadCatalogOpensRecordStoresOnSeveralThreads) {
+    auto opCtx = cc().makeOperationContext();
+
+    std::vector<NamespaceString> namespaces;
+    for (int i = 0; i < 20; ++i) {
+        namespaces.emplace_back("db", str::stream() << "coll" << i);
+        ASSERT_OK(createCollection(opCtx.get(), namespaces.back()).getStatus());
+    }
+
+    const auto originalThreads = gStorageEngineCatalogLoadThreads;
+    gStorageEngineCatalogLoadThreads = 4;
+    ON_BLOCK_EXIT([&] { gStorageEngineCatalogLoadThreads = originalThreads; });
+    {
+        Lock::GlobalWrite writeLock(opCtx.get(), Date_t::max(), Lock::InterruptBehavior::kThrow);
+        _storageEngine->closeCatalog(opCtx.get());
+        _storageEngine->loadCatalog(opCtx.get(), false /* loadingFromUncleanShutdown */);
+    }
+
+    auto& collectionCatalog = CollectionCatalog::get(opCtx.get());
+    for (const auto& nss : namespaces) {
+        auto collection = collectionCatalog.lookupCollectionByNamespace(opCtx.get(), nss);
+        ASSERT(collection) << nss;
+        ASSERT(collection->getRecordStore()) << nss;
+        ASSERT_EQ(nss.ns(), collection->getRecordStore()->ns());
+    }
+}
+
 TEST_F(StorageEngineTest, ReconcileDropsTemporary) {
     auto opCtx = cc().makeOperationContext();
 
@@ -184,6 +184,28 @@ public:
     virtual void saveUnpositioned() {
         save();
     }
+
+    /**
+     * Hints that the caller is about to scan the record store from its beginning in the direction
+     * of the cursor, so storage engines may read data ahead of the cursor. This is only a hint and
+     * storage engines are free to ignore it.
+     */
+    virtual void setSequentialScanHint() {}
+};
+
+/**
+ * Appends records to a RecordStore which was empty when the loader was made, assigning them
+ * increasing RecordIds. The records are written outside of any WriteUnitOfWork, so they can't be
+ * rolled back, and they may not be visible to readers until the loader is destroyed.
+ */
+class RecordStoreBulkLoader {
+public:
+    virtual ~RecordStoreBulkLoader() {}
+
+    /**
+     * Inserts a copy of 'data' and returns the RecordId which was assigned to it.
+     */
+    virtual StatusWith<RecordId> insertRecord(const char* data, int len) = 0;
 };
 
 /**
@@ -386,6 +408,15 @@ public:
         return {};
     }
 
+    /**
+     * Returns a loader which appends records to this record store faster than insertRecords(), or
+     * nullptr if the storage engine can't bulk load it. The record store must be empty, and the
+     * caller must be the only writer to it until the loader is destroyed.
+     */
+    virtual std::unique_ptr<RecordStoreBulkLoader> makeBulkLoader(OperationContext* opCtx) {
+        return {};
+    }
+
     // higher level
 
 
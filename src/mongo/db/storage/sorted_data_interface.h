@@ -30,6 +30,7 @@
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -254,6 +255,38 @@ public:
         virtual boost::optional<IndexKeyEntry> next(RequestedInfo parts = kKeyAndLoc) = 0;
         virtual boost::optional<KeyStringEntry> nextKeyString() = 0;
 
+        /**
+         * Moves forward up to 'maxEntries' times, appending each new entry to 'out', and returns
+         * the number of entries appended. Fewer than 'maxEntries' are appended only if the cursor
+         * runs off the end of the index or past its end position, which leaves it unpositioned
+         * just as next() would.
+         *
+         * The keys in the appended entries are owned, so that they stay valid after the cursor
+         * moves on or is saved. If this throws, the entries appended so far remain valid and the
+         * cursor is positioned on the last of them.
+         *
+         * Implementations may override this to avoid per-entry overhead of next(), which the
+         * default implementation calls repeatedly.
+         */
+        virtual size_t nextBatch(size_t maxEntries,
+                                 std::vector<IndexKeyEntry>* out,
+                                 RequestedInfo parts = kKeyAndLoc) {
+            size_t numAppended = 0;
+            while (numAppended < maxEntries) {
+                auto entry = next(parts);
+                if (!entry) {
+                    break;
+                }
+                if (!entry->key.isOwned()) {
+                    // An empty key, as returned when it isn't requested, needs no copy.
+                    entry->key = entry->key.isEmpty() ? BSONObj() : entry->key.getOwned();
+                }
+                out->push_back(std::move(*entry));
+                ++numAppended;
+            }
+            return numAppended;
+        }
+
         //
         // Seeking
         //
@@ -33,6 +33,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/unittest/unittest.h"
@@ -129,6 +130,52 @@ TEST(SortedDataInterface, ExhaustCursor) {
     }
 }
 
+// Drain a forward cursor with nextBatch() and verify that batches are bounded by the requested
+// size, return entries in key order, and return nothing once the cursor is exhausted.
+TEST(SortedDataInterface, ExhaustCursorInBatches) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(/*unique=*/false, /*partial=*/false));
+
+    int nToInsert = 10;
+    for (int i = 0; i < nToInsert; i++) {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            BSONObj key = BSON("" << i);
+            RecordId loc(42, i * 2);
+            ASSERT_OK(sorted->insert(opCtx.get(), makeKeyString(sorted.get(), key, loc), true));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        auto entry = cursor->seek(makeKeyStringForSeek(sorted.get(), BSONObj(), true, true));
+        ASSERT_EQ(entry, IndexKeyEntry(BSON("" << 0), RecordId(42, 0)));
+
+        std::vector<IndexKeyEntry> batch;
+        int expected = 1;
+        while (expected < nToInsert) {
+            batch.clear();
+            size_t n = cursor->nextBatch(4, &batch);
+            ASSERT_EQ(n, batch.size());
+            ASSERT_EQ(n, std::min<size_t>(4, nToInsert - expected));
+            for (auto&& batchEntry : batch) {
+                ASSERT_EQ(batchEntry,
+                          IndexKeyEntry(BSON("" << expected), RecordId(42, expected * 2)));
+                ++expected;
+            }
+        }
+
+        batch.clear();
+        ASSERT_EQ(0U, cursor->nextBatch(4, &batch));
+        ASSERT(batch.empty());
+        ASSERT(!cursor->next());
+    }
+}
+
 TEST(SortedDataInterface, ExhaustKeyStringCursor) {
     const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
     const std::unique_ptr<SortedDataInterface> sorted(
@@ -45,9 +45,12 @@
 #include "mongo/db/storage/durable_catalog_feature_tracker.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/kv/temporary_kv_record_store.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/db/storage/two_phase_index_build_knobs_gen.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/scopeguard.h"
@@ -193,6 +196,8 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, bool loadingFromUnc
     }
 
     KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    std::vector<CollectionToInit> collectionsToInit;
+    collectionsToInit.reserve(catalogEntries.size());
     for (DurableCatalog::Entry entry : catalogEntries) {
         if (loadingFromUncleanShutdownOrRepair) {
             // If we are loading the catalog after an unclean shutdown or during repair, it's
@@ -231,9 +236,12 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, bool loadingFromUnc
             }
         }
 
-        _initCollection(opCtx, entry.catalogId, entry.nss, _options.forRepair);
-        auto maxPrefixForCollection = _catalog->getMetaData(opCtx, entry.catalogId).getMaxPrefix();
-        maxSeenPrefix = std::max(maxSeenPrefix, maxPrefixForCollection);
+        auto md = _catalog->getMetaData(opCtx, entry.catalogId);
+        uassert(ErrorCodes::MustDowngrade,
+                str::stream() << "Collection does not have UUID in KVCatalog. Collection: "
+                              << entry.nss,
+                md.options.uuid);
+        maxSeenPrefix = std::max(maxSeenPrefix, md.getMaxPrefix());
 
         if (entry.nss.isOrphanCollection()) {
             LOGV2(22248,
@@ -241,8 +249,11 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, bool loadingFromUnc
                   "Orphaned collection found",
                   "namespace"_attr = entry.nss);
         }
+        collectionsToInit.push_back({entry.catalogId, entry.nss, std::move(md)});
     }
 
+    _initCollections(opCtx, collectionsToInit, _options.forRepair);
+
     KVPrefix::setLargestPrefix(maxSeenPrefix);
     opCtx->recoveryUnit()->abandonSnapshot();
 }
@@ -251,30 +262,101 @@ void StorageEngineImpl::_initCollection(OperationContext* opCtx,
                                         RecordId catalogId,
                                         const NamespaceString& nss,
                                         bool forRepair) {
-    BSONCollectionCatalogEntry::MetaData md = _catalog->getMetaData(opCtx, catalogId);
+    CollectionToInit collection{catalogId, nss, _catalog->getMetaData(opCtx, catalogId)};
     uassert(ErrorCodes::MustDowngrade,
             str::stream() << "Collection does not have UUID in KVCatalog. Collection: " << nss,
-            md.options.uuid);
+            collection.md.options.uuid);
+
+    _registerCollection(opCtx, collection, _openRecordStore(opCtx, collection, forRepair));
+}
+
+void StorageEngineImpl::_initCollections(OperationContext* opCtx,
+                                         const std::vector<CollectionToInit>& collections,
+                                         bool forRepair) {
+    std::vector<std::unique_ptr<RecordStore>> recordStores(collections.size());
+
+    // Opening a record store reads its metadata from the storage engine, which is what makes
+    // loading a catalog with many collections slow, so spread it over several threads. The
+    // Collections are still created and registered in catalog order below. The oplog is always
+    // opened on this thread, as opening it also starts the oplog manager.
+    const auto numThreads =
+        std::min(static_cast<size_t>(gStorageEngineCatalogLoadThreads), collections.size());
+    if (!forRepair && numThreads > 1) {
+        AtomicWord<size_t> nextCollection{0};
+        auto mutex = MONGO_MAKE_LATCH("StorageEngineImpl::_initCollections::mutex");
+        Status firstError = Status::OK();
+
+        auto openRecordStores = [&](OperationContext* workerOpCtx) {
+            size_t i;
+            while ((i = nextCollection.fetchAndAdd(1)) < collections.size()) {
+                if (collections[i].nss.isOplog()) {
+                    continue;
+                }
+                try {
+                    recordStores[i] = _openRecordStore(workerOpCtx, collections[i], forRepair);
+                } catch (const DBException& ex) {
+                    stdx::lock_guard<Latch> lk(mutex);
+                    if (firstError.isOK()) {
+                        firstError = ex.toStatus();
+                    }
+                    nextCollection.store(collections.size());
+                }
+            }
+        };
+
+        {
+            std::vector<stdx::thread> workers;
+            ON_BLOCK_EXIT([&] {
+                for (auto&& worker : workers) {
+                    worker.join();
+                }
+            });
+            for (size_t i = 1; i < numThreads; ++i) {
+                workers.emplace_back([&] {
+                    OperationContextNoop workerOpCtx(_engine->newRecoveryUnit());
+                    openRecordStores(&workerOpCtx);
+                    workerOpCtx.recoveryUnit()->abandonSnapshot();
+                });
+            }
+            openRecordStores(opCtx);
+        }
+        uassertStatusOK(firstError);
+    }
 
-    auto ident = _catalog->getEntry(catalogId).ident;
+    for (size_t i = 0; i < collections.size(); ++i) {
+        if (!recordStores[i]) {
+            recordStores[i] = _openRecordStore(opCtx, collections[i], forRepair);
+        }
+        _registerCollection(opCtx, collections[i], std::move(recordStores[i]));
+    }
+}
 
-    std::unique_ptr<RecordStore> rs;
+std::unique_ptr<RecordStore> StorageEngineImpl::_openRecordStore(
+    OperationContext* opCtx, const CollectionToInit& collection, bool forRepair) {
     if (forRepair) {
         // Using a NULL rs since we don't want to open this record store before it has been
         // repaired. This also ensures that if we try to use it, it will blow up.
-        rs = nullptr;
-    } else {
-        rs = _engine->getGroupedRecordStore(opCtx, nss.ns(), ident, md.options, md.prefix);
-        invariant(rs);
+        return nullptr;
     }
 
-    auto uuid = _catalog->getCollectionOptions(opCtx, catalogId).uuid.get();
+    auto ident = _catalog->getEntry(collection.catalogId).ident;
+    auto rs = _engine->getGroupedRecordStore(
+        opCtx, collection.nss.ns(), ident, collection.md.options, collection.md.prefix);
+    invariant(rs);
+    return rs;
+}
+
+void StorageEngineImpl::_registerCollection(OperationContext* opCtx,
+                                            const CollectionToInit& collection,
+                                            std::unique_ptr<RecordStore> rs) {
+    auto uuid = collection.md.options.uuid.get();
 
     auto collectionFactory = Collection::Factory::get(getGlobalServiceContext());
-    auto collection = collectionFactory->make(opCtx, nss, catalogId, uuid, std::move(rs));
+    auto coll = collectionFactory->make(
+        opCtx, collection.nss, collection.catalogId, uuid, std::move(rs));
 
     auto& collectionCatalog = CollectionCatalog::get(getGlobalServiceContext());
-    collectionCatalog.registerCollection(uuid, &collection);
+    collectionCatalog.registerCollection(uuid, &coll);
 }
 
 void StorageEngineImpl::closeCatalog(OperationContext* opCtx) {
@@ -347,11 +347,37 @@ public:
 private:
     using CollIter = std::list<std::string>::iterator;
 
+    /**
+     * A collection in the catalog whose in-memory Collection is yet to be created.
+     */
+    struct CollectionToInit {
+        RecordId catalogId;
+        NamespaceString nss;
+        BSONCollectionCatalogEntry::MetaData md;
+    };
+
     void _initCollection(OperationContext* opCtx,
                          RecordId catalogId,
                          const NamespaceString& nss,
                          bool forRepair);
 
+    /**
+     * Creates and registers the Collections for 'collections'. Their record stores are opened on
+     * up to 'storageEngineCatalogLoadThreads' threads, and the Collections are then registered in
+     * order on the calling thread.
+     */
+    void _initCollections(OperationContext* opCtx,
+                          const std::vector<CollectionToInit>& collections,
+                          bool forRepair);
+
+    std::unique_ptr<RecordStore> _openRecordStore(OperationContext* opCtx,
+                                                  const CollectionToInit& collection,
+                                                  bool forRepair);
+
+    void _registerCollection(OperationContext* opCtx,
+                             const CollectionToInit& collection,
+                             std::unique_ptr<RecordStore> rs);
+
     Status _dropCollectionsNoTimestamp(OperationContext* opCtx,
                                        std::vector<NamespaceString>& toDrop);
 
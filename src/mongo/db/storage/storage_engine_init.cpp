@@ -304,6 +304,10 @@ void appendStorageEngineList(ServiceContext* service, BSONObjBuilder* result) {
 
 namespace {
 
+// The locker of the last operation of each Client, which its next operation reuses, so that
+// lockers and their lock requests are not allocated for every operation.
+const auto getCachedLocker = Client::declareDecoration<std::unique_ptr<LockerImpl>>();
+
 class StorageClientObserver final : public ServiceContext::ClientObserver {
 public:
     void onCreateClient(Client* client) override{};
@@ -321,11 +325,25 @@ public:
         if (!storageEngine) {
             return;
         }
-        opCtx->setLockState(std::make_unique<LockerImpl>());
+        if (auto& cachedLocker = getCachedLocker(opCtx->getClient())) {
+            cachedLocker->updateThreadIdToCurrentThread();
+            opCtx->setLockState(std::move(cachedLocker));
+        } else {
+            opCtx->setLockState(std::make_unique<LockerImpl>());
+        }
         opCtx->setRecoveryUnit(std::unique_ptr<RecoveryUnit>(storageEngine->newRecoveryUnit()),
                                WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
     }
-    void onDestroyOperationContext(OperationContext* opCtx) {}
+    void onDestroyOperationContext(OperationContext* opCtx) {
+        // The locker may have been swapped for another kind of Locker.
+        auto locker = dynamic_cast<LockerImpl*>(opCtx->lockState());
+        if (!locker) {
+            return;
+        }
+        locker->reset();
+        getCachedLocker(opCtx->getClient())
+            .reset(static_cast<LockerImpl*>(opCtx->releaseLockState().release()));
+    }
 };
 
 ServiceContext::ConstructorActionRegisterer registerStorageClientObserverConstructor{
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_checkpoint_scheduler.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+Milliseconds WiredTigerCheckpointScheduler::estimateRecoveryTime(
+    std::int64_t journalBytes, std::int64_t ioBudgetBytesPerSecond) {
+    const auto bytesPerSecond =
+        ioBudgetBytesPerSecond > 0 ? ioBudgetBytesPerSecond : kUnlimitedRecoveryBytesPerSecond;
+    return Milliseconds(std::max<std::int64_t>(journalBytes, 0) * 1000 / bytesPerSecond);
+}
+
+WiredTigerCheckpointScheduler::Decision WiredTigerCheckpointScheduler::shouldCheckpoint(
+    const Sample& sample, const Settings& settings) {
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    // Start counting from the first sample, and over again if the statistics were reset.
+    if (_journalBytesAtLastCheckpoint < 0 ||
+        sample.journalBytesWritten < _journalBytesAtLastCheckpoint) {
+        _journalBytesAtLastCheckpoint = sample.journalBytesWritten;
+    }
+
+    _lastDirtyBytes = sample.dirtyBytes;
+    _lastJournalBytesSinceCheckpoint = sample.journalBytesWritten - _journalBytesAtLastCheckpoint;
+    _lastEstimatedRecoveryTime =
+        estimateRecoveryTime(_lastJournalBytesSinceCheckpoint, settings.ioBudgetBytesPerSecond);
+
+    if (settings.dirtyTriggerBytes > 0 && sample.dirtyBytes >= settings.dirtyTriggerBytes) {
+        return Decision::kDirtyCache;
+    }
+    if (_lastEstimatedRecoveryTime >= settings.targetRecoveryTime) {
+        return Decision::kRecoveryTime;
+    }
+    return Decision::kWait;
+}
+
+void WiredTigerCheckpointScheduler::onCheckpoint(Decision reason,
+                                                 const Sample& atStart,
+                                                 Milliseconds duration) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _journalBytesAtLastCheckpoint = atStart.journalBytesWritten;
+    _lastCheckpointDuration = duration;
+    _lastReason = reason;
+    switch (reason) {
+        case Decision::kScheduled:
+            ++_scheduledCheckpoints;
+            break;
+        case Decision::kDirtyCache:
+            ++_dirtyCacheCheckpoints;
+            break;
+        case Decision::kRecoveryTime:
+            ++_recoveryTimeCheckpoints;
+            break;
+        case Decision::kWait:
+            MONGO_UNREACHABLE;
+    }
+}
+
+void WiredTigerCheckpointScheduler::append(BSONObjBuilder* builder) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    builder->append("lastReason", toString(_lastReason));
+    builder->append("lastDurationMillis", durationCount<Milliseconds>(_lastCheckpointDuration));
+    builder->append("dirtyBytes", _lastDirtyBytes);
+    builder->append("journalBytesSinceCheckpoint", _lastJournalBytesSinceCheckpoint);
+    builder->append("estimatedRecoveryMillis",
+                    durationCount<Milliseconds>(_lastEstimatedRecoveryTime));
+    BSONObjBuilder checkpoints(builder->subobjStart("checkpoints"));
+    checkpoints.append("scheduled", _scheduledCheckpoints);
+    checkpoints.append("dirtyCache", _dirtyCacheCheckpoints);
+    checkpoints.append("recoveryTime", _recoveryTimeCheckpoints);
+}
+
+StringData WiredTigerCheckpointScheduler::toString(Decision decision) {
+    switch (decision) {
+        case Decision::kWait:
+            return "wait"_sd;
+        case Decision::kScheduled:
+            return "scheduled"_sd;
+        case Decision::kDirtyCache:
+            return "dirtyCache"_sd;
+        case Decision::kRecoveryTime:
+            return "recoveryTime"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+/**
+ * Decides when the checkpoint thread should checkpoint ahead of its fixed interval.
+ *
+ * Between checkpoints the thread periodically samples the dirty bytes in the WiredTiger cache and
+ * the bytes written to the journal. A checkpoint is taken early when the dirty bytes reach a
+ * trigger, so that each checkpoint writes less at once, or when replaying the journal written
+ * since the last checkpoint is estimated to take longer than the desired recovery time. The
+ * replay is estimated to proceed at the I/O budget configured for WiredTiger, or at
+ * kUnlimitedRecoveryBytesPerSecond without one.
+ *
+ * The scheduler only makes decisions; the checkpoint thread takes the checkpoints. The decisions
+ * are reported in serverStatus, and hence recorded by FTDC.
+ */
+class WiredTigerCheckpointScheduler {
+    WiredTigerCheckpointScheduler(const WiredTigerCheckpointScheduler&) = delete;
+    WiredTigerCheckpointScheduler& operator=(const WiredTigerCheckpointScheduler&) = delete;
+
+public:
+    // Journal replay rate assumed for the recovery time estimate when there is no I/O budget.
+    static constexpr std::int64_t kUnlimitedRecoveryBytesPerSecond = 100 * 1024 * 1024;
+
+    struct Sample {
+        // Tracked dirty bytes in the cache.
+        std::int64_t dirtyBytes;
+
+        // Bytes written to the journal since startup.
+        std::int64_t journalBytesWritten;
+    };
+
+    struct Settings {
+        // Dirty bytes at which to checkpoint early, 0 to never checkpoint early for dirty bytes.
+        std::int64_t dirtyTriggerBytes;
+
+        Seconds targetRecoveryTime;
+
+        // 0 when WiredTiger's I/O is not throttled.
+        std::int64_t ioBudgetBytesPerSecond;
+    };
+
+    // kScheduled is a checkpoint taken because the interval elapsed or one was requested.
+    enum class Decision { kWait, kScheduled, kDirtyCache, kRecoveryTime };
+
+    WiredTigerCheckpointScheduler() = default;
+
+    /**
+     * Estimates how long replaying 'journalBytes' of journal takes at 'ioBudgetBytesPerSecond'.
+     */
+    static Milliseconds estimateRecoveryTime(std::int64_t journalBytes,
+                                             std::int64_t ioBudgetBytesPerSecond);
+
+    /**
+     * Returns whether to checkpoint now given 'sample': kWait, kDirtyCache or kRecoveryTime.
+     */
+    Decision shouldCheckpoint(const Sample& sample, const Settings& settings);
+
+    /**
+     * Records a checkpoint taken for 'reason' which took 'duration'. 'atStart' was sampled before
+     * the checkpoint started, so that journal written during the checkpoint counts toward the next
+     * one.
+     */
+    void onCheckpoint(Decision reason, const Sample& atStart, Milliseconds duration);
+
+    void append(BSONObjBuilder* builder) const;
+
+    static StringData toString(Decision decision);
+
+private:
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerCheckpointScheduler::_mutex");
+
+    // Journal bytes written when the last checkpoint started, -1 before the first sample.
+    std::int64_t _journalBytesAtLastCheckpoint = -1;
+
+    std::int64_t _lastDirtyBytes = 0;
+    std::int64_t _lastJournalBytesSinceCheckpoint = 0;
+    Milliseconds _lastEstimatedRecoveryTime{0};
+    Milliseconds _lastCheckpointDuration{0};
+    Decision _lastReason = Decision::kScheduled;
+
+    long long _scheduledCheckpoints = 0;
+    long long _dirtyCacheCheckpoints = 0;
+    long long _recoveryTimeCheckpoints = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_checkpoint_scheduler.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+constexpr std::int64_t kMB = 1024 * 1024;
+
+using Decision = WiredTigerCheckpointScheduler::Decision;
+
+const WiredTigerCheckpointScheduler::Settings kSettings{512 * kMB, Seconds(10), 50 * kMB};
+
+TEST(WiredTigerCheckpointSchedulerTest, EstimatesRecoveryTimeFromIOBudget) {
+    ASSERT_EQ(Milliseconds(0), WiredTigerCheckpointScheduler::estimateRecoveryTime(0, 50 * kMB));
+    ASSERT_EQ(Milliseconds(2000),
+              WiredTigerCheckpointScheduler::estimateRecoveryTime(100 * kMB, 50 * kMB));
+    ASSERT_EQ(Milliseconds(1000),
+              WiredTigerCheckpointScheduler::estimateRecoveryTime(
+                  WiredTigerCheckpointScheduler::kUnlimitedRecoveryBytesPerSecond, 0));
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, WaitsWhileBelowTriggers) {
+    WiredTigerCheckpointScheduler scheduler;
+    ASSERT(Decision::kWait == scheduler.shouldCheckpoint({0, 1000 * kMB}, kSettings));
+    ASSERT(Decision::kWait == scheduler.shouldCheckpoint({100 * kMB, 1400 * kMB}, kSettings));
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, CheckpointsOnDirtyBytes) {
+    WiredTigerCheckpointScheduler scheduler;
+    ASSERT(Decision::kDirtyCache == scheduler.shouldCheckpoint({512 * kMB, 0}, kSettings));
+
+    // A trigger of 0 disables checkpointing for dirty bytes.
+    auto settings = kSettings;
+    settings.dirtyTriggerBytes = 0;
+    ASSERT(Decision::kWait == scheduler.shouldCheckpoint({512 * kMB, 0}, settings));
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, CheckpointsOnRecoveryTime) {
+    WiredTigerCheckpointScheduler scheduler;
+    ASSERT(Decision::kWait == scheduler.shouldCheckpoint({0, 1000 * kMB}, kSettings));
+    // 500MB of journal at 50MB/s takes 10 seconds to replay.
+    ASSERT(Decision::kRecoveryTime == scheduler.shouldCheckpoint({0, 1500 * kMB}, kSettings));
+
+    // A checkpoint covers the journal written before it started.
+    scheduler.onCheckpoint(Decision::kRecoveryTime, {0, 1500 * kMB}, Milliseconds(3000));
+    ASSERT(Decision::kWait == scheduler.shouldCheckpoint({0, 1600 * kMB}, kSettings));
+
+    BSONObjBuilder builder;
+    scheduler.append(&builder);
+    auto obj = builder.obj();
+    ASSERT_EQ("recoveryTime", obj["lastReason"].str());
+    ASSERT_EQ(3000, obj["lastDurationMillis"].numberLong());
+    ASSERT_EQ(100 * kMB, obj["journalBytesSinceCheckpoint"].numberLong());
+    ASSERT_EQ(2000, obj["estimatedRecoveryMillis"].numberLong());
+    ASSERT_EQ(0, obj["checkpoints"]["scheduled"].numberLong());
+    ASSERT_EQ(1, obj["checkpoints"]["recoveryTime"].numberLong());
+}
+
+TEST(WiredTigerCheckpointSchedulerTest, RestartsCountingWhenStatisticsReset) {
+    WiredTigerCheckpointScheduler scheduler;
+    ASSERT(Decision::kWait == scheduler.shouldCheckpoint({0, 1000 * kMB}, kSettings));
+    ASSERT(Decision::kWait == scheduler.shouldCheckpoint({0, 10 * kMB}, kSettings));
+    ASSERT(Decision::kWait == scheduler.shouldCheckpoint({0, 500 * kMB}, kSettings));
+}
+
+}  // namespace
+}  // namespace mongo
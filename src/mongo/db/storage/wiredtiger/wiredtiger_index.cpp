@@ -457,6 +457,10 @@ long long WiredTigerIndex::getSpaceUsedBytes(OperationContext* opCtx) const {
         return numEntries * bytesPerEntry;
     }
 
+    if (auto kvEngine = ru->getSessionCache()->getKVEngine()) {
+        return static_cast<long long>(
+            kvEngine->getStatisticsCache()->getIdentSize(session->getSession(), _uri));
+    }
     return static_cast<long long>(WiredTigerUtil::getIdentSize(session->getSession(), _uri));
 }
 
@@ -498,10 +502,7 @@ Status WiredTigerIndex::compact(OperationContext* opCtx) {
     dassert(opCtx->lockState()->isWriteLocked());
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     if (!cache->isEphemeral()) {
-        WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
-        opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, uri().c_str(), "timeout=0");
-        invariantWTOK(ret);
+        return WiredTigerUtil::compact(opCtx, uri());
     }
     return Status::OK();
 }
@@ -843,6 +844,18 @@ public:
         return getKeyStringEntry();
     }
 
+    size_t nextBatch(size_t maxEntries,
+                     std::vector<IndexKeyEntry>* out,
+                     RequestedInfo parts) override {
+        // Keys decoded by curr() are always owned, so they can be handed out as they are.
+        size_t numAppended = 0;
+        while (numAppended < maxEntries && advanceNext() && !_eof) {
+            out->push_back(*curr(parts));
+            ++numAppended;
+        }
+        return numAppended;
+    }
+
     void setEndPosition(const BSONObj& key, bool inclusive) override {
         LOGV2_TRACE_CURSOR(20098,
                            "setEndPosition inclusive: {inclusive} {key}",
@@ -76,6 +76,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_repair_observer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_checkpoint_scheduler.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
@@ -86,6 +87,8 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_controller.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_zstd_dictionaries.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/background.h"
@@ -272,17 +275,24 @@ public:
 
         while (true) {
             auto opCtx = tc->makeOperationContext();
+            _applyIOBudget();
 
+            auto reason = WiredTigerCheckpointScheduler::Decision::kScheduled;
             {
                 stdx::unique_lock<Latch> lock(_mutex);
                 MONGO_IDLE_THREAD_BLOCK;
 
                 // Wait for 'wiredTigerGlobalOptions.checkpointDelaySecs' seconds; or until either
-                // shutdown is signaled or a checkpoint is triggered.
-                _condvar.wait_for(lock,
-                                  stdx::chrono::seconds(static_cast<std::int64_t>(
-                                      wiredTigerGlobalOptions.checkpointDelaySecs)),
-                                  [&] { return _shuttingDown || _triggerCheckpoint; });
+                // shutdown is signaled or a checkpoint is triggered. Adaptive checkpointing may
+                // also decide to checkpoint before the delay elapses.
+                const auto delay = stdx::chrono::seconds(
+                    static_cast<std::int64_t>(wiredTigerGlobalOptions.checkpointDelaySecs));
+                if (gWiredTigerCheckpointAdaptive.load()) {
+                    reason = _waitForAdaptiveCheckpoint(lock, delay);
+                } else {
+                    _condvar.wait_for(
+                        lock, delay, [&] { return _shuttingDown || _triggerCheckpoint; });
+                }
 
                 // If the checkpointDelaySecs is set to 0, that means we should skip checkpointing.
                 // However, checkpointDelaySecs is adjustable by a runtime server parameter, so we
@@ -306,6 +316,8 @@ public:
             pauseCheckpointThread.pauseWhileSet();
 
             const Date_t startTime = Date_t::now();
+            const auto sampleAtStart = _sample();
+            bool tookCheckpoint = true;
 
             const Timestamp stableTimestamp = _wiredTigerKVEngine->getStableTimestamp();
             const Timestamp initialDataTimestamp = _wiredTigerKVEngine->getInitialDataTimestamp();
@@ -353,6 +365,7 @@ public:
                         "{initialDataTimestamp}",
                         "stableTimestamp"_attr = stableTimestamp.toString(),
                         "initialDataTimestamp"_attr = initialDataTimestamp.toString());
+                    tookCheckpoint = false;
                 } else {
                     auto oplogNeededForRollback = _wiredTigerKVEngine->getOplogNeededForRollback();
 
@@ -377,7 +390,19 @@ public:
                     }
                 }
 
-                const auto secondsElapsed = durationCount<Seconds>(Date_t::now() - startTime);
+                // Table files mostly change size when checkpoints write them, so this is when the
+                // cached table sizes are refreshed.
+                {
+                    UniqueWiredTigerSession session = _sessionCache->getSession();
+                    _wiredTigerKVEngine->getStatisticsCache()->refresh(session->getSession());
+                }
+
+                const auto elapsed = Date_t::now() - startTime;
+                if (tookCheckpoint && sampleAtStart) {
+                    _scheduler.onCheckpoint(reason, *sampleAtStart, elapsed);
+                }
+
+                const auto secondsElapsed = durationCount<Seconds>(elapsed);
                 if (secondsElapsed >= 30) {
                     LOGV2_DEBUG(22308,
                                 1,
@@ -443,6 +468,12 @@ public:
         *timestamp = Timestamp(_oplogNeededForCrashRecovery.load());
     }
 
+    void appendSchedulerStats(BSONObjBuilder* builder) const {
+        builder->append("adaptive", gWiredTigerCheckpointAdaptive.load());
+        builder->append("ioBudgetMBPerSec", _appliedIOBudgetMB.load());
+        _scheduler.append(builder);
+    }
+
     void shutdown() {
         {
             stdx::unique_lock<Latch> lock(_mutex);
@@ -455,9 +486,97 @@ public:
     }
 
 private:
+    /**
+     * Waits up to 'delay' like the fixed interval does, but samples the cache and the journal
+     * every kAdaptivePollInterval and returns early when the scheduler decides to checkpoint.
+     * Returns the reason for the upcoming checkpoint.
+     */
+    WiredTigerCheckpointScheduler::Decision _waitForAdaptiveCheckpoint(
+        stdx::unique_lock<Latch>& lock, stdx::chrono::seconds delay) {
+        const auto pred = [&] { return _shuttingDown || _triggerCheckpoint; };
+        const auto deadline = stdx::chrono::steady_clock::now() + delay;
+        while (!pred()) {
+            const auto now = stdx::chrono::steady_clock::now();
+            if (now >= deadline) {
+                break;
+            }
+            const stdx::chrono::steady_clock::duration untilDeadline = deadline - now;
+            if (_condvar.wait_for(lock, std::min(untilDeadline, kAdaptivePollInterval), pred)) {
+                break;
+            }
+
+            // Sampling opens a statistics cursor, so do not block triggers meanwhile.
+            lock.unlock();
+            _applyIOBudget();
+            auto decision = WiredTigerCheckpointScheduler::Decision::kWait;
+            if (auto sample = _sample()) {
+                decision = _scheduler.shouldCheckpoint(
+                    *sample,
+                    {gWiredTigerCheckpointDirtyTriggerMB.load() * 1024LL * 1024LL,
+                     Seconds(gWiredTigerCheckpointTargetRecoverySecs.load()),
+                     _appliedIOBudgetMB.load() * 1024LL * 1024LL});
+            }
+            lock.lock();
+
+            if (decision != WiredTigerCheckpointScheduler::Decision::kWait) {
+                LOGV2_DEBUG(4798618,
+                            2,
+                            "Checkpointing ahead of the checkpoint interval",
+                            "reason"_attr = WiredTigerCheckpointScheduler::toString(decision));
+                return decision;
+            }
+        }
+        return WiredTigerCheckpointScheduler::Decision::kScheduled;
+    }
+
+    /**
+     * Reads the dirty bytes in the cache and the journal bytes written, or returns boost::none if
+     * the statistics are unavailable.
+     */
+    boost::optional<WiredTigerCheckpointScheduler::Sample> _sample() {
+        auto session = _sessionCache->getSession();
+        auto getStat = [&](int key) {
+            return WiredTigerUtil::getStatisticsValue(
+                session->getSession(), "statistics:", "statistics=(fast)", key);
+        };
+        auto dirtyBytes = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+        auto journalBytes = getStat(WT_STAT_CONN_LOG_BYTES_WRITTEN);
+        if (!dirtyBytes.isOK() || !journalBytes.isOK()) {
+            return boost::none;
+        }
+        return WiredTigerCheckpointScheduler::Sample{dirtyBytes.getValue(),
+                                                     journalBytes.getValue()};
+    }
+
+    /**
+     * Passes a changed wiredTigerCheckpointIOBudgetMBPerSec on to WiredTiger.
+     */
+    void _applyIOBudget() {
+        const auto budgetMB = gWiredTigerCheckpointIOBudgetMBPerSec.load();
+        if (budgetMB == _appliedIOBudgetMB.load()) {
+            return;
+        }
+        const std::string config = str::stream() << "io_capacity=(total=" << budgetMB << "MB)";
+        const int ret = _wiredTigerKVEngine->reconfigure(config.c_str());
+        if (ret != 0) {
+            LOGV2_WARNING(4798619,
+                          "Failed to apply the WiredTiger I/O budget",
+                          "ioBudgetMBPerSec"_attr = budgetMB,
+                          "error"_attr = wtRCToStatus(ret));
+        }
+        // Do not retry a budget WiredTiger rejected until it is changed again.
+        _appliedIOBudgetMB.store(budgetMB);
+    }
+
+    static constexpr stdx::chrono::steady_clock::duration kAdaptivePollInterval =
+        stdx::chrono::seconds(1);
+
     WiredTigerKVEngine* _wiredTigerKVEngine;
     WiredTigerSessionCache* _sessionCache;
 
+    WiredTigerCheckpointScheduler _scheduler;
+    AtomicWord<std::int32_t> _appliedIOBudgetMB{0};
+
     Mutex _oplogNeededForCrashRecoveryMutex =
         MONGO_MAKE_LATCH("WiredTigerCheckpointThread::_oplogNeededForCrashRecoveryMutex");
     AtomicWord<std::uint64_t> _oplogNeededForCrashRecovery;
@@ -482,6 +601,9 @@ private:
 namespace {
 TicketHolder openWriteTransaction(128);
 TicketHolder openReadTransaction(128);
+
+WiredTigerTicketController writeTicketController;
+WiredTigerTicketController readTicketController;
 }  // namespace
 
 OpenWriteTransactionParam::OpenWriteTransactionParam(StringData name, ServerParameterType spt)
@@ -526,6 +648,165 @@ Status OpenReadTransactionParam::setFromString(const std::string& str) {
     return _data->resize(num);
 }
 
+/**
+ * Periodically resizes the read and write ticket holders as decided by their
+ * WiredTigerTicketController, while wiredTigerConcurrentTransactionsAdaptive is enabled.
+ */
+class WiredTigerKVEngine::WiredTigerTicketAdjuster : public BackgroundJob {
+public:
+    explicit WiredTigerTicketAdjuster(WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+
+    virtual string name() const {
+        return "WTTicketAdjuster";
+    }
+
+    virtual void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        LOGV2_DEBUG(5021451, 1, "starting {name} thread", "name"_attr = name());
+
+        bool wasEnabled = false;
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<Latch> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(
+                    lock,
+                    stdx::chrono::milliseconds(
+                        gWiredTigerConcurrentTransactionsAdaptiveIntervalMillis.load()));
+            }
+
+            if (_shuttingDown.load()) {
+                break;
+            }
+
+            if (!gWiredTigerConcurrentTransactionsAdaptive.load()) {
+                if (wasEnabled) {
+                    // Start from scratch when re-enabled, throughput is not comparable anymore.
+                    writeTicketController.reset();
+                    readTicketController.reset();
+                    _lastCompletedTransactions = -1;
+                    wasEnabled = false;
+                }
+                continue;
+            }
+
+            wasEnabled = true;
+            _adjust();
+        }
+        LOGV2_DEBUG(5021452, 1, "stopping {name} thread", "name"_attr = name());
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        {
+            stdx::unique_lock<Latch> lock(_mutex);
+            // Wake up the ticket adjuster thread early, we do not want the shutdown to wait for
+            // us too long.
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    void _adjust() {
+        auto session = _sessionCache->getSession();
+        auto getStat = [&](int key) {
+            return WiredTigerUtil::getStatisticsValue(
+                session->getSession(), "statistics:", "statistics=(fast)", key);
+        };
+
+        auto committed = getStat(WT_STAT_CONN_TXN_COMMIT);
+        auto rolledBack = getStat(WT_STAT_CONN_TXN_ROLLBACK);
+        auto bytesInUse = getStat(WT_STAT_CONN_CACHE_BYTES_INUSE);
+        auto dirtyBytes = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+        auto maxBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+        for (const auto& stat : {committed, rolledBack, bytesInUse, dirtyBytes, maxBytes}) {
+            if (!stat.isOK()) {
+                LOGV2_DEBUG(5021453,
+                            1,
+                            "Not adjusting concurrent transactions, failed to read statistics",
+                            "error"_attr = stat.getStatus());
+                return;
+            }
+        }
+
+        // WiredTiger does not tell read and write transactions apart, so both controllers are
+        // given the total throughput.
+        const auto completedTransactions = committed.getValue() + rolledBack.getValue();
+        const auto completed = _lastCompletedTransactions < 0
+            ? -1
+            : completedTransactions - _lastCompletedTransactions;
+        _lastCompletedTransactions = completedTransactions;
+
+        const double evictionPressure = WiredTigerTicketController::evictionPressure(
+            bytesInUse.getValue(), dirtyBytes.getValue(), maxBytes.getValue());
+        const int minTickets = gWiredTigerConcurrentTransactionsAdaptiveMin.load();
+        const int maxTickets =
+            std::max(minTickets, gWiredTigerConcurrentTransactionsAdaptiveMax.load());
+
+        _adjustTickets("write",
+                       &writeTicketController,
+                       &openWriteTransaction,
+                       completed,
+                       evictionPressure,
+                       minTickets,
+                       maxTickets);
+        _adjustTickets("read",
+                       &readTicketController,
+                       &openReadTransaction,
+                       completed,
+                       evictionPressure,
+                       minTickets,
+                       maxTickets);
+    }
+
+    void _adjustTickets(StringData kind,
+                        WiredTigerTicketController* controller,
+                        TicketHolder* tickets,
+                        std::int64_t completed,
+                        double evictionPressure,
+                        int minTickets,
+                        int maxTickets) {
+        const int total = tickets->outof();
+        const int newTotal = controller->adjust(
+            {tickets->used(), total, completed, evictionPressure}, minTickets, maxTickets);
+        if (newTotal == total) {
+            return;
+        }
+
+        // Shrinking waits for the tickets in excess to be released.
+        Status status = tickets->resize(newTotal);
+        if (!status.isOK()) {
+            LOGV2_WARNING(5021454,
+                          "Failed to adjust the number of concurrent transactions",
+                          "kind"_attr = kind,
+                          "totalTickets"_attr = total,
+                          "newTotalTickets"_attr = newTotal,
+                          "error"_attr = status);
+            return;
+        }
+        LOGV2_DEBUG(5021455,
+                    2,
+                    "Adjusted the number of concurrent transactions",
+                    "kind"_attr = kind,
+                    "totalTickets"_attr = total,
+                    "newTotalTickets"_attr = newTotal,
+                    "evictionPressure"_attr = evictionPressure);
+    }
+
+    WiredTigerSessionCache* _sessionCache;
+    AtomicWord<bool> _shuttingDown{false};
+
+    // The number of transactions WiredTiger had completed at the previous adjustment, or -1.
+    std::int64_t _lastCompletedTransactions = -1;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerTicketAdjuster::_mutex");  // protects _condvar
+    // The ticket adjuster thread idles on this condition variable between adjustments. It can be
+    // triggered early to expediate shutdown.
+    stdx::condition_variable _condvar;
+};
+
 StringData WiredTigerKVEngine::kTableUriPrefix = "table:"_sd;
 
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
@@ -704,6 +985,9 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sessionSweeper = std::make_unique<WiredTigerSessionSweeper>(_sessionCache.get());
     _sessionSweeper->go();
 
+    _ticketAdjuster = std::make_unique<WiredTigerTicketAdjuster>(_sessionCache.get());
+    _ticketAdjuster->go();
+
     // Until the Replication layer installs a real callback, prevent truncating the oplog.
     setOldestActiveTransactionTimestampCallback(
         [](Timestamp) { return StatusWith(boost::make_optional(Timestamp::min())); });
@@ -768,6 +1052,12 @@ void WiredTigerKVEngine::startAsyncThreads() {
     }
 }
 
+void WiredTigerKVEngine::appendCheckpointSchedulerStats(BSONObjBuilder* builder) const {
+    if (_checkpointThread) {
+        _checkpointThread->appendSchedulerStats(builder);
+    }
+}
+
 void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
     {
@@ -775,6 +1065,14 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        {
+            BSONObjBuilder queues(bbb.subobjStart("queues"));
+            openWriteTransaction.appendQueueStats(&queues);
+        }
+        if (gWiredTigerConcurrentTransactionsAdaptive.load()) {
+            BSONObjBuilder adaptive(bbb.subobjStart("adaptive"));
+            writeTicketController.append(&adaptive);
+        }
         bbb.done();
     }
     {
@@ -782,6 +1080,14 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        {
+            BSONObjBuilder queues(bbb.subobjStart("queues"));
+            openReadTransaction.appendQueueStats(&queues);
+        }
+        if (gWiredTigerConcurrentTransactionsAdaptive.load()) {
+            BSONObjBuilder adaptive(bbb.subobjStart("adaptive"));
+            readTicketController.append(&adaptive);
+        }
         bbb.done();
     }
     bb.done();
@@ -891,6 +1197,11 @@ void WiredTigerKVEngine::cleanShutdown() {
         _sessionSweeper->shutdown();
         LOGV2(22319, "Finished shutting down session sweeper thread");
     }
+    if (_ticketAdjuster) {
+        LOGV2(5021456, "Shutting down ticket adjuster thread");
+        _ticketAdjuster->shutdown();
+        LOGV2(5021457, "Finished shutting down ticket adjuster thread");
+    }
     if (_checkpointThread) {
         LOGV2(22322, "Shutting down checkpoint thread");
         _checkpointThread->shutdown();
@@ -975,7 +1286,7 @@ Status WiredTigerKVEngine::okToRename(OperationContext* opCtx,
 
 int64_t WiredTigerKVEngine::getIdentSize(OperationContext* opCtx, StringData ident) {
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSession();
-    return WiredTigerUtil::getIdentSize(session->getSession(), _uri(ident));
+    return _statisticsCache.getIdentSize(session->getSession(), _uri(ident));
 }
 
 Status WiredTigerKVEngine::repairIdent(OperationContext* opCtx, StringData ident) {
@@ -1506,6 +1817,31 @@ void WiredTigerKVEngine::setSortedDataInterfaceExtraOptions(const std::string& o
     _indexOptions = options;
 }
 
+namespace {
+/**
+ * zstd dictionaries are local to the node which trained them, so a replicated create of a table
+ * which uses one would fail to apply on the members which lack it. Such tables may only be created
+ * by unreplicated writes, which includes applying the oplog on a node that has the dictionary.
+ */
+Status checkZstdDictionaryUse(OperationContext* opCtx,
+                              const NamespaceString& nss,
+                              StringData config) {
+    if (config.find(WiredTigerZstdDictionaries::kCompressorPrefix) == std::string::npos ||
+        !opCtx->writesAreReplicated()) {
+        return Status::OK();
+    }
+
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (!replCoord || !replCoord->isReplEnabled() || replCoord->isOplogDisabledFor(opCtx, nss)) {
+        return Status::OK();
+    }
+
+    return {ErrorCodes::InvalidOptions,
+            str::stream() << "Cannot use a zstd dictionary block compressor for " << nss
+                          << " on a replica set member, because the dictionary is not replicated"};
+}
+}  // namespace
+
 Status WiredTigerKVEngine::createGroupedRecordStore(OperationContext* opCtx,
                                                     StringData ns,
                                                     StringData ident,
@@ -1521,6 +1857,10 @@ Status WiredTigerKVEngine::createGroupedRecordStore(OperationContext* opCtx,
         return result.getStatus();
     }
     std::string config = result.getValue();
+    auto status = checkZstdDictionaryUse(opCtx, NamespaceString(ns), config);
+    if (!status.isOK()) {
+        return status;
+    }
 
     string uri = _uri(ident);
     WT_SESSION* s = session.getSession();
@@ -1703,6 +2043,10 @@ Status WiredTigerKVEngine::createGroupedSortedDataInterface(OperationContext* op
     }
 
     std::string config = result.getValue();
+    auto status = checkZstdDictionaryUse(opCtx, ns, config);
+    if (!status.isOK()) {
+        return status;
+    }
 
     LOGV2_DEBUG(
         22336,
@@ -1776,6 +2120,7 @@ Status WiredTigerKVEngine::dropIdent(OperationContext* opCtx, RecoveryUnit* ru,
     WiredTigerRecoveryUnit* wtRu = checked_cast<WiredTigerRecoveryUnit*>(ru);
     wtRu->getSessionNoTxn()->closeAllCursors(uri);
     _sessionCache->closeAllCursors(uri);
+    _statisticsCache.erase(uri);
 
     WiredTigerSession session(_conn);
 
@@ -44,6 +44,7 @@
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_statistics_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/util/elapsed_tracker.h"
@@ -315,8 +316,20 @@ public:
         return _oplogManager.get();
     }
 
+    /**
+     * Cache of the table sizes reported by collStats and dbStats. Refreshed after checkpoints.
+     */
+    WiredTigerStatisticsCache* getStatisticsCache() {
+        return &_statisticsCache;
+    }
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
+    /**
+     * Appends the decisions of the checkpoint scheduler, if there is a checkpoint thread.
+     */
+    void appendCheckpointSchedulerStats(BSONObjBuilder* builder) const;
+
     Timestamp getStableTimestamp() const override;
     Timestamp getOldestTimestamp() const override;
     Timestamp getCheckpointTimestamp() const override;
@@ -363,6 +376,7 @@ public:
 private:
     class WiredTigerSessionSweeper;
     class WiredTigerCheckpointThread;
+    class WiredTigerTicketAdjuster;
 
     /**
      * Opens a connection on the WiredTiger database 'path' with the configuration 'wtOpenConfig'.
@@ -430,6 +444,8 @@ private:
     std::size_t _oplogManagerCount = 0;
     std::unique_ptr<WiredTigerOplogManager> _oplogManager;
 
+    WiredTigerStatisticsCache _statisticsCache;
+
     std::string _canonicalName;
     std::string _path;
     std::string _wtOpenConfig;
@@ -452,6 +468,7 @@ private:
 
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerTicketAdjuster> _ticketAdjuster;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -31,6 +31,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "mongo/db/concurrency/lock_state.h"
@@ -101,9 +102,15 @@ void WiredTigerOplogManager::haltVisibilityThread() {
 }
 
 void WiredTigerOplogManager::triggerOplogVisibilityUpdate() {
+    // The visibility thread clears the trigger before it fetches the all_durable timestamp, so a
+    // pending trigger is guaranteed to cover this caller's commit and the mutex can be skipped.
+    if (_triggerOplogVisibilityUpdate.load()) {
+        return;
+    }
+
     stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
-    if (!_triggerOplogVisibilityUpdate) {
-        _triggerOplogVisibilityUpdate = true;
+    if (!_triggerOplogVisibilityUpdate.load()) {
+        _triggerOplogVisibilityUpdate.store(true);
         _oplogVisibilityThreadCV.notify_one();
     }
 }
@@ -132,13 +139,30 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
     // Close transaction before we wait.
     opCtx->recoveryUnit()->abandonSnapshot();
 
+    // Usually the awaited write has already committed, for instance when waiting for one's own
+    // write. Rather than handing off to the visibility thread and waiting for it to be scheduled,
+    // fetch the all_durable timestamp here and publish it directly.
+    if (RecordId(getOplogReadTimestamp()) >= waitingFor) {
+        return;
+    }
+    auto sessionCache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+    const uint64_t allDurable = sessionCache->getKVEngine()->getAllDurableTimestamp().asULL();
+    if (allDurable > currentLatestVisibleTimestamp) {
+        _advanceOplogReadTimestamp(allDurable);
+        if (RecordId(getOplogReadTimestamp()) >= waitingFor) {
+            return;
+        }
+    }
+
     stdx::unique_lock<Latch> lk(_oplogVisibilityStateMutex);
 
     // Prevent any scheduled oplog visibility updates from being delayed for batching and blocking
-    // this wait excessively.
+    // this wait excessively. Wake the visibility thread so it does not notice this only on its
+    // next polling interval.
     ++_opsWaitingForOplogVisibilityUpdate;
     invariant(_opsWaitingForOplogVisibilityUpdate > 0);
     auto exitGuard = makeGuard([&] { --_opsWaitingForOplogVisibilityUpdate; });
+    _oplogVisibilityThreadCV.notify_one();
 
     // Out of order writes to the oplog always call triggerOplogVisibilityUpdate() on commit to
     // prompt the OplogVisibilityThread to run and update the oplog visibility. We simply need to
@@ -181,12 +205,13 @@ void WiredTigerOplogManager::_updateOplogVisibilityLoop(WiredTigerSessionCache*
     // uncommitted entries behind them. This prevents cursors from seeing 'holes' in the oplog and
     // consequently missing data that was not there yet when scanning went passed up to a later
     // timestamp.
+    uint64_t lastNotifiedTimestamp = getOplogReadTimestamp();
     while (true) {
         stdx::unique_lock<Latch> lk(_oplogVisibilityStateMutex);
         {
             MONGO_IDLE_THREAD_BLOCK;
             _oplogVisibilityThreadCV.wait(
-                lk, [&] { return _shuttingDown || _triggerOplogVisibilityUpdate; });
+                lk, [&] { return _shuttingDown || _triggerOplogVisibilityUpdate.load(); });
 
             // If we are not shutting down and nobody is actively waiting for the oplog to become
             // visible, delay a bit to batch more requests into one update and reduce system load.
@@ -218,8 +243,8 @@ void WiredTigerOplogManager::_updateOplogVisibilityLoop(WiredTigerSessionCache*
             return;
         }
 
-        invariant(_triggerOplogVisibilityUpdate);
-        _triggerOplogVisibilityUpdate = false;
+        invariant(_triggerOplogVisibilityUpdate.load());
+        _triggerOplogVisibilityUpdate.store(false);
 
         lk.unlock();
 
@@ -230,21 +255,21 @@ void WiredTigerOplogManager::_updateOplogVisibilityLoop(WiredTigerSessionCache*
         // The newTimestamp may actually go backward during secondary batch application,
         // where we commit data file changes separately from oplog changes, so ignore
         // a non-incrementing timestamp.
-        if (newTimestamp <= _oplogReadTimestamp.load()) {
+        _advanceOplogReadTimestamp(newTimestamp);
+
+        // Waiters may have published the all_durable timestamp themselves, so compare against the
+        // last timestamp awaitData cursors were notified for. That one is reset if the oplog read
+        // timestamp was moved backward, as happens in rollback.
+        const uint64_t visibleTimestamp = getOplogReadTimestamp();
+        lastNotifiedTimestamp = std::min(lastNotifiedTimestamp, visibleTimestamp);
+        if (visibleTimestamp <= lastNotifiedTimestamp) {
             LOGV2_DEBUG(22373,
                         2,
                         "No new oplog entries became visible.",
                         "aNoHolesOplogTimestamp"_attr = Timestamp(newTimestamp));
             continue;
         }
-
-        lk.lock();
-        // Publish the new timestamp value. Avoid going backward.
-        auto currentVisibleTimestamp = getOplogReadTimestamp();
-        if (newTimestamp > currentVisibleTimestamp) {
-            _setOplogReadTimestamp(lk, newTimestamp);
-        }
-        lk.unlock();
+        lastNotifiedTimestamp = visibleTimestamp;
 
         // Wake up any awaitData cursors and tell them more data might be visible now.
         //
@@ -264,6 +289,17 @@ void WiredTigerOplogManager::setOplogReadTimestamp(Timestamp ts) {
     _setOplogReadTimestamp(lk, ts.asULL());
 }
 
+void WiredTigerOplogManager::_advanceOplogReadTimestamp(uint64_t newTimestamp) {
+    if (newTimestamp <= _oplogReadTimestamp.load()) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_oplogVisibilityStateMutex);
+    if (newTimestamp > _oplogReadTimestamp.load()) {
+        _setOplogReadTimestamp(lk, newTimestamp);
+    }
+}
+
 void WiredTigerOplogManager::_setOplogReadTimestamp(WithLock, uint64_t newTimestamp) {
     _oplogReadTimestamp.store(newTimestamp);
     _oplogEntriesBecameVisibleCV.notify_all();
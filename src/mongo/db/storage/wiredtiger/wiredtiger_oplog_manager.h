@@ -44,7 +44,9 @@ class WiredTigerSessionCache;
  * Manages oplog visibility.
  *
  * On demand, queries WiredTiger's all_durable timestamp value and updates the oplog read timestamp.
- * This is done asynchronously on a thread that startVisibilityThread() will set up.
+ * This is done asynchronously on a thread that startVisibilityThread() will set up. Callers of
+ * waitForAllEarlierOplogWritesToBeVisible() also query and publish it themselves first, so they
+ * only wait for the thread if the awaited write is not yet visible.
  *
  * The WT all_durable timestamp is the in-memory timestamp behind which there are no oplog holes
  * in-memory. Note, all_durable is the timestamp that has no holes in-memory, which may NOT be
@@ -106,6 +108,12 @@ private:
     void _updateOplogVisibilityLoop(WiredTigerSessionCache* sessionCache,
                                     WiredTigerRecordStore* oplogRecordStore);
 
+    /**
+     * Publishes 'newTimestamp' as the oplog read timestamp if it is ahead of the current one, and
+     * wakes up waiters. Takes the mutex only when the timestamp actually moves forward.
+     */
+    void _advanceOplogReadTimestamp(uint64_t newTimestamp);
+
     void _setOplogReadTimestamp(WithLock, uint64_t newTimestamp);
 
     AtomicWord<unsigned long long> _oplogReadTimestamp{0};
@@ -126,8 +134,9 @@ private:
     bool _shuttingDown = false;
 
     // Triggers an oplog visibility update -- can be delayed if no callers are waiting for an
-    // update, per the _opsWaitingForOplogVisibility counter.
-    bool _triggerOplogVisibilityUpdate = false;
+    // update, per the _opsWaitingForOplogVisibility counter. Only written with the mutex held, but
+    // read without it by triggerOplogVisibilityUpdate() to skip the mutex when already set.
+    AtomicWord<bool> _triggerOplogVisibilityUpdate{false};
 
     // Incremented when a caller is waiting for more of the oplog to become visible, to avoid update
     // delays for batching.
@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/platform/posix_fadvise.h"
+
+namespace mongo {
+
+WiredTigerSequentialReadAhead::WiredTigerSequentialReadAhead(const boost::filesystem::path& path,
+                                                             int64_t dataSize,
+                                                             int64_t windowBytes)
+    : _windowBytes(windowBytes) {
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+    _fd = ::open(path.c_str(), O_RDONLY);
+    if (_fd < 0) {
+        return;
+    }
+
+    struct stat st;
+    if (::fstat(_fd, &st) != 0) {
+        ::close(_fd);
+        _fd = -1;
+        return;
+    }
+    _fileSize = st.st_size;
+    if (dataSize > 0) {
+        _fileBytesPerDataByte = static_cast<double>(_fileSize) / dataSize;
+    }
+
+    _readAheadWindow();
+#endif
+}
+
+WiredTigerSequentialReadAhead::~WiredTigerSequentialReadAhead() {
+#if !defined(_WIN32)
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+#endif
+}
+
+void WiredTigerSequentialReadAhead::advance(int64_t recordBytes) {
+    if (_fd < 0) {
+        return;
+    }
+
+    _dataBytesScanned += recordBytes;
+    const auto fileOffset = static_cast<int64_t>(_dataBytesScanned * _fileBytesPerDataByte);
+    if (fileOffset + _windowBytes / 2 >= _readAheadOffset) {
+        _readAheadWindow();
+    }
+}
+
+void WiredTigerSequentialReadAhead::_readAheadWindow() {
+    if (_readAheadOffset >= _fileSize) {
+        return;
+    }
+
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+    // Failing to read ahead only makes the scan slower, so errors are ignored.
+    posix_fadvise(_fd, _readAheadOffset, _windowBytes, POSIX_FADV_WILLNEED);
+#endif
+    _readAheadOffset += _windowBytes;
+}
+
+}  // namespace mongo
@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <cstdint>
+
+namespace mongo {
+
+/**
+ * Asks the operating system to read a WiredTiger data file ahead of a forward collection scan, so
+ * that a scan over data which is not in the WiredTiger cache is not limited by the latency of one
+ * page read at a time.
+ *
+ * WiredTiger has no prefetch interface and does not expose where the pages of the scan live in the
+ * file, so the file offset of the scan is estimated from the number of bytes of record data it has
+ * returned, scaled by the ratio of file size to data size. This assumes the pages of the table are
+ * mostly laid out on disk in key order, which holds for collections that are not updated much.
+ * Read-ahead is done with POSIX_FADV_WILLNEED and is a no-op on platforms which do not have it.
+ */
+class WiredTigerSequentialReadAhead {
+    WiredTigerSequentialReadAhead(const WiredTigerSequentialReadAhead&) = delete;
+    WiredTigerSequentialReadAhead& operator=(const WiredTigerSequentialReadAhead&) = delete;
+
+public:
+    /**
+     * Reads ahead 'windowBytes' of the file at 'path' at a time. 'dataSize' is the uncompressed
+     * size of the records stored in the file.
+     */
+    WiredTigerSequentialReadAhead(const boost::filesystem::path& path,
+                                  int64_t dataSize,
+                                  int64_t windowBytes);
+    ~WiredTigerSequentialReadAhead();
+
+    /**
+     * Called for every record returned by the scan with the size of its data. Starts reading the
+     * next window once the scan has reached the middle of the last one.
+     */
+    void advance(int64_t recordBytes);
+
+    /**
+     * The file offset up to which read-ahead has been requested.
+     */
+    int64_t readAheadOffset() const {
+        return _readAheadOffset;
+    }
+
+private:
+    void _readAheadWindow();
+
+    int _fd = -1;
+    int64_t _fileSize = 0;
+    const int64_t _windowBytes;
+
+    // Ratio of the size of the file to the size of the data stored in it.
+    double _fileBytesPerDataByte = 1.0;
+
+    int64_t _dataBytesScanned = 0;
+    int64_t _readAheadOffset = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#endif
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const int64_t kFileSize = 1024 * 1024;
+const int64_t kWindowBytes = 64 * 1024;
+
+boost::filesystem::path makeFile(unittest::TempDir& dir) {
+    boost::filesystem::path path(dir.path());
+    path /= "collection.wt";
+    std::ofstream file(path.string(), std::ios::binary);
+    file << std::string(kFileSize, 'x');
+    return path;
+}
+
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+TEST(WiredTigerSequentialReadAheadTest, ReadsAheadAsTheScanAdvances) {
+    unittest::TempDir dir("wiredtiger_read_ahead_test");
+    // The data compresses to half its size in the file.
+    WiredTigerSequentialReadAhead readAhead(makeFile(dir), 2 * kFileSize, kWindowBytes);
+    ASSERT_EQ(kWindowBytes, readAhead.readAheadOffset());
+
+    // 32KB of data is 16KB of the file, which does not reach the middle of the first window.
+    readAhead.advance(32 * 1024);
+    ASSERT_EQ(kWindowBytes, readAhead.readAheadOffset());
+
+    readAhead.advance(32 * 1024);
+    ASSERT_EQ(2 * kWindowBytes, readAhead.readAheadOffset());
+
+    // Read-ahead stops at the end of the file.
+    for (int i = 0; i < 64; ++i) {
+        readAhead.advance(32 * 1024);
+    }
+    ASSERT_EQ(kFileSize, readAhead.readAheadOffset());
+}
+#endif
+
+TEST(WiredTigerSequentialReadAheadTest, MissingFileIsIgnored) {
+    unittest::TempDir dir("wiredtiger_read_ahead_test");
+    boost::filesystem::path path(dir.path());
+    path /= "missing.wt";
+    WiredTigerSequentialReadAhead readAhead(path, kFileSize, kWindowBytes);
+    readAhead.advance(kFileSize);
+    ASSERT_EQ(0, readAhead.readAheadOffset());
+}
+
+}  // namespace
+}  // namespace mongo
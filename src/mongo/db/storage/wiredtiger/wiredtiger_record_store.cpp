@@ -57,6 +57,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -980,10 +981,10 @@ int64_t WiredTigerRecordStore::storageSize(OperationContext* opCtx,
         return dataSize(opCtx);
     }
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn();
-    auto result = WiredTigerUtil::getStatisticsValue(session->getSession(),
-                                                     "statistics:" + getURI(),
-                                                     "statistics=(size)",
-                                                     WT_STAT_DSRC_BLOCK_SIZE);
+    auto result = _kvEngine->getStatisticsCache()->getStatisticsValue(session->getSession(),
+                                                                      "statistics:" + getURI(),
+                                                                      "statistics=(size)",
+                                                                      WT_STAT_DSRC_BLOCK_SIZE);
     uassertStatusOK(result.getStatus());
 
     int64_t size = result.getValue();
@@ -999,10 +1000,11 @@ int64_t WiredTigerRecordStore::freeStorageSize(OperationContext* opCtx) const {
     invariant(opCtx->lockState()->isReadLocked());
 
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn();
-    auto result = WiredTigerUtil::getStatisticsValue(session->getSession(),
-                                                     "statistics:" + getURI(),
-                                                     "statistics=(fast)",
-                                                     WT_STAT_DSRC_BLOCK_REUSE_BYTES);
+    auto result = _kvEngine->getStatisticsCache()->getStatisticsValue(
+        session->getSession(),
+        "statistics:" + getURI(),
+        "statistics=(fast)",
+        WT_STAT_DSRC_BLOCK_REUSE_BYTES);
     uassertStatusOK(result.getStatus());
     return result.getValue();
 }
@@ -1112,6 +1114,16 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx,
     if (!cappedAndNeedDelete())
         return 0;
 
+    // Size-only capped collections may overshoot their maximum by a bounded amount, so that one
+    // insert truncates a batch of old records rather than every insert deleting one or two. The
+    // overshoot stays well under the back-pressure threshold below.
+    if (_cappedMaxDocs == -1) {
+        const int64_t deferredBytes =
+            std::min<int64_t>(gWiredTigerCappedDeleteBatchBytes.load(), _cappedMaxSizeSlack / 2);
+        if (_sizeInfo->dataSize.load() - _cappedMaxSize < deferredBytes)
+            return 0;
+    }
+
     // ensure only one thread at a time can do deletes, otherwise they'll conflict.
     stdx::unique_lock<stdx::timed_mutex> lock(_cappedDeleterMutex, stdx::defer_lock);
 
@@ -1522,6 +1534,76 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
     return Status::OK();
 }
 
+/**
+ * Appends records to an empty table through a WiredTiger bulk cursor, which writes them directly
+ * into the table's file, bypassing the cache and transactions.
+ */
+class WiredTigerRecordStore::BulkLoader final : public RecordStoreBulkLoader {
+public:
+    BulkLoader(WiredTigerRecordStore* rs,
+               OperationContext* opCtx,
+               UniqueWiredTigerSession session,
+               WT_CURSOR* cursor)
+        : _rs(rs), _opCtx(opCtx), _session(std::move(session)), _cursor(cursor) {}
+
+    ~BulkLoader() {
+        invariantWTOK(_cursor->close(_cursor));
+    }
+
+    StatusWith<RecordId> insertRecord(const char* data, int len) override {
+        // RecordIds are handed out in increasing order, as the bulk cursor requires.
+        const RecordId id = _rs->_nextId(_opCtx);
+        _rs->setKey(_cursor, id);
+        WiredTigerItem value(data, len);
+        _cursor->set_value(_cursor, value.Get());
+        int ret = _cursor->insert(_cursor);
+        if (ret)
+            return wtRCToStatus(ret, "WiredTigerRecordStore::BulkLoader::insertRecord");
+
+        // The insert can't be rolled back, and neither can the size adjustments.
+        _rs->_changeNumRecords(nullptr, 1);
+        _rs->_increaseDataSize(nullptr, len);
+        return id;
+    }
+
+private:
+    WiredTigerRecordStore* const _rs;
+    OperationContext* const _opCtx;
+    UniqueWiredTigerSession const _session;
+    WT_CURSOR* const _cursor;
+};
+
+std::unique_ptr<RecordStoreBulkLoader> WiredTigerRecordStore::makeBulkLoader(
+    OperationContext* opCtx) {
+    dassert(opCtx->lockState()->isWriteLocked());
+    if (_isCapped || _isOplog || numRecords(opCtx) != 0) {
+        return {};
+    }
+
+    // Find the next RecordId now, since that needs an ordinary cursor on the table.
+    _initNextIdIfNeeded(opCtx);
+
+    // Open cursors can cause bulk open_cursor to fail with EBUSY.
+    _getRecoveryUnit(opCtx)->getSession()->closeAllCursors(_uri);
+
+    // Use a different session to ensure we don't hijack an existing transaction. As for index
+    // builds, fail quickly rather than wait for a checkpoint to complete.
+    auto session = _getRecoveryUnit(opCtx)->getSessionCache()->getSession();
+    WT_SESSION* wtSession = session->getSession();
+    WT_CURSOR* cursor;
+    int ret = wtSession->open_cursor(
+        wtSession, _uri.c_str(), nullptr, "bulk,checkpoint_wait=false", &cursor);
+    if (ret) {
+        LOGV2_DEBUG(5021437,
+                    1,
+                    "Failed to create WiredTiger bulk cursor, falling back to non-bulk inserts",
+                    "uri"_attr = _uri,
+                    "error"_attr = wiredtiger_strerror(ret));
+        return {};
+    }
+    return std::make_unique<BulkLoader>(this, opCtx, std::move(session), cursor);
+}
+
 bool WiredTigerRecordStore::isOpHidden_forTest(const RecordId& id) const {
     invariant(id.repr() > 0);
     invariant(_kvEngine->getOplogManager()->isRunning());
@@ -1735,10 +1817,7 @@ Status WiredTigerRecordStore::compact(OperationContext* opCtx) {
 
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     if (!cache->isEphemeral()) {
-        WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
-        opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, getURI().c_str(), "timeout=0");
-        invariantWTOK(ret);
+        return WiredTigerUtil::compact(opCtx, getURI());
     }
     return Status::OK();
 }
@@ -1957,7 +2036,8 @@ void WiredTigerRecordStore::_changeNumRecords(OperationContext* opCtx, int64_t d
         return;
     }
 
-    opCtx->recoveryUnit()->registerChange(std::make_unique<NumRecordsChange>(this, diff));
+    if (opCtx)
+        opCtx->recoveryUnit()->registerChange(std::make_unique<NumRecordsChange>(this, diff));
     if (_sizeInfo->numRecords.fetchAndAdd(diff) < 0)
         _sizeInfo->numRecords.store(std::max(diff, int64_t(0)));
 }
@@ -2176,10 +2256,27 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
 
+    if (_readAhead) {
+        _readAhead->advance(value.size);
+    }
+
     _lastReturnedId = id;
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+void WiredTigerRecordStoreCursorBase::setSequentialScanHint() {
+    const auto readAheadMB = gWiredTigerSequentialReadAheadMB.load();
+    if (!_forward || readAheadMB <= 0 || _rs._isEphemeral || _readAhead) {
+        return;
+    }
+
+    auto path = _rs._kvEngine->getDataFilePathForIdent(_rs.getIdent());
+    if (!path) {
+        return;
+    }
+    _readAhead.emplace(*path, _rs.dataSize(_opCtx), int64_t{readAheadMB} * 1024 * 1024);
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordId& id) {
     invariant(_hasRestored);
     if (_oplogVisibleTs && id.repr() > *_oplogVisibleTs) {
@@ -40,6 +40,7 @@
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/platform/atomic_word.h"
@@ -167,6 +168,8 @@ public:
 
     std::unique_ptr<RecordCursor> getRandomCursor(OperationContext* opCtx) const final;
 
+    std::unique_ptr<RecordStoreBulkLoader> makeBulkLoader(OperationContext* opCtx) override;
+
     virtual std::unique_ptr<RecordCursor> getRandomCursorWithOptions(
         OperationContext* opCtx, StringData extraConfig) const = 0;
 
@@ -283,6 +286,7 @@ private:
 
     class NumRecordsChange;
     class DataSizeChange;
+    class BulkLoader;
 
     static WiredTigerRecoveryUnit* _getRecoveryUnit(OperationContext* opCtx);
 
@@ -426,6 +430,13 @@ public:
         return _prefix;
     }
 
+    /**
+     * A prefixed record store shares its table with other idents, so it can't be bulk loaded.
+     */
+    std::unique_ptr<RecordStoreBulkLoader> makeBulkLoader(OperationContext* opCtx) final {
+        return {};
+    }
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const;
 
@@ -455,6 +466,11 @@ public:
 
     void reattachToOperationContext(OperationContext* opCtx);
 
+    /**
+     * Reads the data file ahead of forward cursors if 'wiredTigerSequentialReadAheadMB' is set.
+     */
+    void setSequentialScanHint() override;
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const = 0;
 
@@ -482,6 +498,7 @@ protected:
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
     bool _hasRestored = true;
+    boost::optional<WiredTigerSequentialReadAhead> _readAhead;
 
 private:
     bool isVisible(const RecordId& id);
@@ -33,6 +33,7 @@
 #include <sstream>
 #include <string>
 #include <time.h>
+#include <vector>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
@@ -43,6 +44,7 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -260,6 +262,36 @@ TEST(WiredTigerRecordStoreTest, CappedCursorRollover) {
     ASSERT(!cursor->next());
 }
 
+TEST(WiredTigerRecordStoreTest, CappedDeleteBatchBytesDefersDeletion) {
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    // The back-pressure threshold of a 10000 byte collection is 1000 bytes, which limits the
+    // deferral to 500 bytes even though more is requested here.
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 10000, -1));
+    gWiredTigerCappedDeleteBatchBytes.store(1000);
+    ON_BLOCK_EXIT([] { gWiredTigerCappedDeleteBatchBytes.store(0); });
+
+    const std::string data(100, 'x');
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto insert = [&] {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), data.c_str(), data.size(), Timestamp())
+                      .getStatus());
+        uow.commit();
+    };
+
+    // Fill the collection and then overshoot it by less than the deferral.
+    for (int i = 0; i < 104; ++i) {
+        insert();
+    }
+    ASSERT_EQ(104, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(10400, rs->dataSize(opCtx.get()));
+
+    // Reaching the deferral deletes the overshoot in one pass.
+    insert();
+    ASSERT_EQ(100, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(10000, rs->dataSize(opCtx.get()));
+}
+
 RecordId _oplogOrderInsertOplog(OperationContext* opCtx,
                                 const unique_ptr<RecordStore>& rs,
                                 int inc) {
@@ -995,5 +1027,41 @@ TEST(WiredTigerRecordStoreTest, CursorInActiveTxnAfterSeek) {
     }
 }
 
+TEST(WiredTigerRecordStoreTest, BulkLoaderAppendsToEmptyRecordStore) {
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const std::vector<std::string> data{"a", "b", "c"};
+    std::vector<RecordId> ids;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto loader = rs->makeBulkLoader(opCtx.get());
+        ASSERT(loader);
+        for (auto&& str : data) {
+            auto res = loader->insertRecord(str.c_str(), str.size() + 1);
+            ASSERT_OK(res.getStatus());
+            ASSERT(ids.empty() || ids.back() < res.getValue());
+            ids.push_back(res.getValue());
+        }
+    }
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    ASSERT_EQ(rs->numRecords(opCtx.get()), static_cast<long long>(data.size()));
+
+    // The records are visible once the loader is destroyed.
+    auto cursor = rs->getCursor(opCtx.get());
+    for (size_t i = 0; i < data.size(); ++i) {
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(record->id, ids[i]);
+        ASSERT_EQ(std::string(record->data.data()), data[i]);
+    }
+    ASSERT_FALSE(cursor->next());
+    cursor.reset();
+
+    // A record store which isn't empty can't be bulk loaded.
+    ASSERT_FALSE(rs->makeBulkLoader(opCtx.get()));
+}
+
 }  // namespace
 }  // namespace mongo
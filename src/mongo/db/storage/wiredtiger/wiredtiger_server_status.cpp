@@ -90,6 +90,16 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
 
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
+    {
+        BSONObjBuilder subsection(bob.subobjStart("checkpointScheduler"));
+        _engine->appendCheckpointSchedulerStats(&subsection);
+    }
+
+    {
+        BSONObjBuilder subsection(bob.subobjStart("groupCommit"));
+        WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->appendGroupCommitStats(&subsection);
+    }
+
     {
         BSONObjBuilder subsection(bob.subobjStart("oplog"));
         subsection.append("visibility timestamp",
@@ -34,6 +34,9 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
 #include <memory>
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 #include "mongo/base/error_codes.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -45,6 +48,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/logv2/log.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -202,6 +206,8 @@ WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
       _conn(engine->getConnection()),
       _clockSource(_engine->getClockSource()),
       _shuttingDown(0),
+      _numPartitions(std::max(ProcessInfo::getNumCores(), 1u)),
+      _partitions(std::make_unique<SessionCachePartition[]>(_numPartitions)),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs)
@@ -209,6 +215,8 @@ WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource*
       _conn(conn),
       _clockSource(cs),
       _shuttingDown(0),
+      _numPartitions(std::max(ProcessInfo::getNumCores(), 1u)),
+      _partitions(std::make_unique<SessionCachePartition[]>(_numPartitions)),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
@@ -238,18 +246,14 @@ void WiredTigerSessionCache::waitUntilDurable(OperationContext* opCtx,
     // For inMemory storage engines, the data is "as durable as it's going to get".
     // That is, a restart is equivalent to a complete node failure.
     if (isEphemeral()) {
-        auto journalListener = [&]() -> JournalListener* {
-            // The JournalListener may not be set immediately, so we must check under a mutex so as
-            // not to access the variable while setting a JournalListener. A JournalListener is only
-            // allowed to be set once, so using the pointer outside of a mutex is safe.
-            stdx::unique_lock<Latch> lk(_journalListenerMutex);
-            return _journalListener;
-        }();
+        // The JournalListener may not be set immediately. It is only allowed to be set once, so
+        // using the pointer after loading it is safe.
+        auto journalListener = _journalListener.load();
         if (journalListener && useListener == UseJournalListener::kUpdate) {
             // Update the JournalListener before we return. Does a write while fetching the
             // timestamp if primary. As far as listeners are concerned, all writes are as 'durable'
             // as they are ever going to get on an inMemory storage engine.
-            auto token = _journalListener->getToken(opCtx);
+            auto token = journalListener->getToken(opCtx);
             journalListener->onDurable(token);
         }
         return;
@@ -278,13 +282,7 @@ void WiredTigerSessionCache::waitUntilDurable(OperationContext* opCtx,
         UniqueWiredTigerSession session = getSession();
         WT_SESSION* s = session->getSession();
         {
-            auto journalListener = [&]() -> JournalListener* {
-                // The JournalListener may not be set immediately, so we must check under a mutex so
-                // as not to access the variable while setting a JournalListener. A JournalListener
-                // is only allowed to be set once, so using the pointer outside of a mutex is safe.
-                stdx::unique_lock<Latch> lk(_journalListenerMutex);
-                return _journalListener;
-            }();
+            auto journalListener = _journalListener.load();
             boost::optional<JournalListener::Token> token;
             if (journalListener && useListener == UseJournalListener::kUpdate) {
                 // Update a persisted value with the latest write timestamp that is safe across
@@ -306,35 +304,109 @@ void WiredTigerSessionCache::waitUntilDurable(OperationContext* opCtx,
         return;
     }
 
-    auto journalListener = [&]() -> JournalListener* {
-        // The JournalListener may not be set immediately, so we must check under a mutex so as not
-        // to access the variable while setting a JournalListener. A JournalListener is only allowed
-        // to be set once, so using the pointer outside of a mutex is safe.
-        stdx::unique_lock<Latch> lk(_journalListenerMutex);
-        return _journalListener;
-    }();
+    _groupCommitFlush(opCtx, useListener);
+}
+
+void WiredTigerSessionCache::_groupCommitFlush(OperationContext* opCtx,
+                                               UseJournalListener useListener) {
+    stdx::unique_lock<Latch> lk(_groupCommitMutex);
+    if (!_nextFlush) {
+        _nextFlush = std::make_unique<SharedPromise<void>>();
+    }
+    auto flushed = _nextFlush->getFuture();
+    ++_nextFlushWaiters;
+    if (useListener == UseJournalListener::kUpdate) {
+        _nextFlushUpdatesListener = true;
+    }
+
+    if (_flushInProgress) {
+        if (_nextLeader) {
+            // Someone else will lead the flush we joined.
+            lk.unlock();
+            flushed.get();
+            return;
+        }
+
+        // We are the first to queue up behind the flush in progress. Wait for it to finish and hand
+        // over the next flush, unless a leader that is still gathering its group includes us in it.
+        auto [promise, future] = makePromiseFuture<bool>();
+        _nextLeader.emplace(std::move(promise));
+        lk.unlock();
+        if (!future.get()) {
+            flushed.get();
+            return;
+        }
+        lk.lock();
+    }
+    _flushInProgress = true;
+
+    const auto maxWindow = Microseconds(gWiredTigerGroupCommitMaxWindowMicros.load());
+    const auto window = std::min(_groupCommitWindow, maxWindow);
+    if (window > Microseconds(0)) {
+        // Give concurrent callers a chance to share this flush.
+        lk.unlock();
+        sleepFor(window);
+        lk.lock();
+    }
+
+    // Everyone who joined so far is covered by this flush, including a caller waiting to lead the
+    // next one.
+    auto group = std::move(_nextFlush);
+    const auto groupSize = std::exchange(_nextFlushWaiters, 0);
+    const bool updateListener = std::exchange(_nextFlushUpdatesListener, false);
+    auto coveredLeader = std::exchange(_nextLeader, boost::none);
+    lk.unlock();
+
+    if (coveredLeader) {
+        coveredLeader->emplaceValue(false);
+    }
+
+    const auto start = _clockSource->now();
+    Status status = Status::OK();
+    try {
+        _flushForGroupCommit(opCtx, updateListener);
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+    const auto elapsed = _clockSource->now() - start;
+
+    lk.lock();
+    ++_groupCommitFlushes;
+    _groupCommitWaiters += groupSize;
+    // Only delay flushes while they are being shared. A flush that covered a single caller shrinks
+    // the window so that a lone durable writer quickly stops paying for it.
+    _groupCommitWindow = groupSize > 1 ? std::min(duration_cast<Microseconds>(elapsed), maxWindow)
+                                       : _groupCommitWindow / 2;
+    if (_nextLeader) {
+        // Callers arrived during the flush. Hand the next flush over to the first of them.
+        auto nextLeader = std::exchange(_nextLeader, boost::none);
+        lk.unlock();
+        nextLeader->emplaceValue(true);
+    } else {
+        _flushInProgress = false;
+        lk.unlock();
+    }
+
+    if (status.isOK()) {
+        group->emplaceValue();
+    } else {
+        group->setError(status);
+    }
+    flushed.get();
+}
+
+void WiredTigerSessionCache::_flushForGroupCommit(OperationContext* opCtx, bool updateListener) {
+    auto journalListener = _journalListener.load();
     boost::optional<JournalListener::Token> token;
-    if (journalListener && useListener == UseJournalListener::kUpdate) {
+    if (journalListener && updateListener) {
         // Update a persisted value with the latest write timestamp that is safe across startup
         // recovery in the repl layer. Then report that timestamp as durable to the repl layer below
-        // after we have flushed in-memory data to disk.
+        // after we have flushed in-memory data to disk. Every caller in the group committed its
+        // writes before joining, so the token covers them all.
         // Note: only does a write if primary, otherwise just fetches the timestamp.
         token = journalListener->getToken(opCtx);
     }
 
-    uint32_t start = _lastSyncTime.load();
-    // Do the remainder in a critical section that ensures only a single thread at a time
-    // will attempt to synchronize.
-    stdx::unique_lock<Latch> lk(_lastSyncMutex);
-    uint32_t current = _lastSyncTime.loadRelaxed();  // synchronized with writes through mutex
-    if (current != start) {
-        // Someone else synced already since we read lastSyncTime, so we're done!
-        return;
-    }
-    _lastSyncTime.store(current + 1);
-
-    // Nobody has synched yet, so we have to sync ourselves.
-
     // Initialize on first use.
     if (!_waitUntilDurableSession) {
         invariantWTOK(
@@ -355,6 +427,13 @@ void WiredTigerSessionCache::waitUntilDurable(OperationContext* opCtx,
     }
 }
 
+void WiredTigerSessionCache::appendGroupCommitStats(BSONObjBuilder* builder) {
+    stdx::lock_guard<Latch> lk(_groupCommitMutex);
+    builder->append("flushes", _groupCommitFlushes);
+    builder->append("waiters", _groupCommitWaiters);
+    builder->append("windowMicros", durationCount<Microseconds>(_groupCommitWindow));
+}
+
 void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
                                                                         std::uint64_t lastCount) {
     invariant(opCtx);
@@ -374,9 +453,12 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (size_t p = 0; p < _numPartitions; ++p) {
+        auto& partition = _partitions[p];
+        stdx::lock_guard<Latch> lock(partition.lock);
+        for (auto&& session : partition.sessions) {
+            session->closeAllCursors(uri);
+        }
     }
 }
 
@@ -384,15 +466,17 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (size_t p = 0; p < _numPartitions; ++p) {
+        auto& partition = _partitions[p];
+        stdx::lock_guard<Latch> lock(partition.lock);
+        for (auto&& session : partition.sessions) {
+            session->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    return _sessions.size();
+    return _numIdleSessions.load();
 }
 
 void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
@@ -402,14 +486,16 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
     }
 
     auto cutoffTime = _clockSource->now() - Milliseconds(idleTimeMillis);
-    {
-        stdx::lock_guard<Latch> lock(_cacheLock);
+    for (size_t p = 0; p < _numPartitions; ++p) {
+        auto& partition = _partitions[p];
+        stdx::lock_guard<Latch> lock(partition.lock);
         // Discard all sessions that became idle before the cutoff time
-        for (auto it = _sessions.begin(); it != _sessions.end();) {
+        for (auto it = partition.sessions.begin(); it != partition.sessions.end();) {
             auto session = *it;
             invariant(session->getIdleExpireTime() != Date_t::min());
             if (session->getIdleExpireTime() < cutoffTime) {
-                it = _sessions.erase(it);
+                it = partition.sessions.erase(it);
+                _numIdleSessions.fetchAndSubtract(1);
                 delete (session);
             } else {
                 ++it;
@@ -419,17 +505,23 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. Sessions of the old
+    // epoch which are released from now on are not cached, since releaseSession() checks the epoch
+    // while holding the lock of the partition.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<Latch> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
-    }
+    for (size_t p = 0; p < _numPartitions; ++p) {
+        SessionCache swap;
+        {
+            auto& partition = _partitions[p];
+            stdx::lock_guard<Latch> lock(partition.lock);
+            partition.sessions.swap(swap);
+            _numIdleSessions.fetchAndSubtract(swap.size());
+        }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+        for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
+            delete (*i);
+        }
     }
 }
 
@@ -442,13 +534,18 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<Latch> lock(_cacheLock);
-        if (!_sessions.empty()) {
+    // Start with the partition of this CPU, and only look at the others if it is empty. Checking
+    // the total first avoids locking every partition when the cache is empty.
+    const size_t firstPartition = _currentPartition();
+    for (size_t i = 0; i < _numPartitions && _numIdleSessions.load() > 0; ++i) {
+        auto& partition = _partitions[(firstPartition + i) % _numPartitions];
+        stdx::lock_guard<Latch> lock(partition.lock);
+        if (!partition.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = partition.sessions.back();
+            partition.sessions.pop_back();
+            _numIdleSessions.fetchAndSubtract(1);
             // Reset the idle time
             cachedSession->setIdleExpireTime(Date_t::min());
             return UniqueWiredTigerSession(cachedSession);
@@ -510,10 +607,12 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<Latch> lock(_cacheLock);
+        auto& partition = _partitions[_currentPartition()];
+        stdx::lock_guard<Latch> lock(partition.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
+            _numIdleSessions.fetchAndAdd(1);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -526,14 +625,21 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 }
 
 
-void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
-    stdx::unique_lock<Latch> lk(_journalListenerMutex);
+size_t WiredTigerSessionCache::_currentPartition() const {
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return static_cast<size_t>(cpu) % _numPartitions;
+    }
+#endif
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % _numPartitions;
+}
 
+void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     // A JournalListener can only be set once. Otherwise, accessing a copy of the _journalListener
     // pointer without a mutex would be unsafe.
-    invariant(!_journalListener);
-
-    _journalListener = jl;
+    JournalListener* expected = nullptr;
+    invariant(_journalListener.compareAndSwap(&expected, jl));
 }
 
 bool WiredTigerSessionCache::isEngineCachingCursors() {
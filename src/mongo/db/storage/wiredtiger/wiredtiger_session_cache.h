@@ -34,11 +34,15 @@
 
 #include <wiredtiger.h>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/stdx/new.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/future.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -299,8 +303,10 @@ public:
      * Waits until all commits that happened before this call are made durable.
      *
      * Specifying Fsync::kJournal will flush only the (oplog) journal to disk. Callers are
-     * serialized by a mutex and will return early if it is discovered that another thread started
-     * and completed a flush while they slept.
+     * group committed: one of them flushes on behalf of every caller that arrived before the flush
+     * started, while callers arriving during a flush wait and are covered by the next one. The
+     * leader of a flush may first wait up to wiredTigerGroupCommitMaxWindowMicros for more callers
+     * to join when flushes are being shared.
      *
      * Specifying Fsync::kCheckpointStableTimestamp will take a checkpoint up to and including the
      * stable timestamp.
@@ -318,6 +324,12 @@ public:
      */
     void waitUntilDurable(OperationContext* opCtx, Fsync syncType, UseJournalListener useListener);
 
+    /**
+     * Appends the number of group commit flushes, the callers they covered and the current flush
+     * window to 'builder'.
+     */
+    void appendGroupCommitStats(BSONObjBuilder* builder);
+
     /**
      * Waits until a prepared unit of work has ended (either been commited or aborted). This
      * should be used when encountering WT_PREPARE_CONFLICT errors. The caller is required to retry
@@ -375,9 +387,21 @@ private:
     AtomicWord<unsigned> _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    Mutex _cacheLock = MONGO_MAKE_LATCH("WiredTigerSessionCache::_cacheLock");
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    // Idle sessions are cached in one partition per CPU, each with its own lock, so that threads
+    // running on different CPUs do not contend when getting and releasing sessions. A thread which
+    // finds the partition of its CPU empty takes a session from another partition.
+    struct alignas(stdx::hardware_destructive_interference_size) SessionCachePartition {
+        Mutex lock = MONGO_MAKE_LATCH("WiredTigerSessionCache::SessionCachePartition::lock");
+        SessionCache sessions;
+    };
+    const size_t _numPartitions;
+    std::unique_ptr<SessionCachePartition[]> _partitions;
+
+    // Total number of sessions in '_partitions'. Only updated while holding the lock of the
+    // partition to which a session is added or from which it is removed.
+    AtomicWord<size_t> _numIdleSessions{0};
 
     // Bumped when all open sessions need to be closed
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
@@ -385,9 +409,19 @@ private:
     // Bumped when all open cursors need to be closed
     AtomicWord<unsigned long long> _cursorEpoch;  // atomic so we can check it outside of the lock
 
-    // Counter and critical section mutex for waitUntilDurable
-    AtomicWord<unsigned> _lastSyncTime;
-    Mutex _lastSyncMutex = MONGO_MAKE_LATCH("WiredTigerSessionCache::_lastSyncMutex");
+    // Group commit state for waitUntilDurable, protected by _groupCommitMutex. Callers join
+    // _nextFlush, which is fulfilled once a flush started after they joined completes. While a
+    // flush is in progress, the first caller to join the next one waits on _nextLeader to be told
+    // whether to lead it.
+    Mutex _groupCommitMutex = MONGO_MAKE_LATCH("WiredTigerSessionCache::_groupCommitMutex");
+    bool _flushInProgress = false;
+    std::unique_ptr<SharedPromise<void>> _nextFlush;
+    boost::optional<Promise<bool>> _nextLeader;
+    std::int64_t _nextFlushWaiters = 0;
+    bool _nextFlushUpdatesListener = false;
+    Microseconds _groupCommitWindow{0};
+    std::int64_t _groupCommitFlushes = 0;
+    std::int64_t _groupCommitWaiters = 0;
 
     // Mutex and cond var for waiting on prepare commit or abort.
     Mutex _prepareCommittedOrAbortedMutex =
@@ -395,25 +429,40 @@ private:
     stdx::condition_variable _prepareCommittedOrAbortedCond;
     AtomicWord<std::uint64_t> _prepareCommitOrAbortCounter{0};
 
-    // Protects getting and setting the _journalListener below.
-    Mutex _journalListenerMutex = MONGO_MAKE_LATCH("WiredTigerSessionCache::_journalListenerMutex");
-
     // Notified when we commit to the journal.
     //
-    // This variable should be accessed under the _journalListenerMutex above and saved in a local
-    // variable before use. That way, we can avoid holding a mutex across calls on the object. It is
-    // only allowed to be set once, in order to ensure the memory to which a copy of the pointer
-    // points is always valid.
-    JournalListener* _journalListener = nullptr;
+    // It is only allowed to be set once, in order to ensure the memory to which a copy of the
+    // pointer points is always valid. Being atomic, durable waiters read it without contending on
+    // a mutex.
+    AtomicWord<JournalListener*> _journalListener{nullptr};
 
-    WT_SESSION* _waitUntilDurableSession = nullptr;  // owned, and never explicitly closed
-                                                     // (uses connection close to clean up)
+    // owned, and never explicitly closed (uses connection close to clean up). Only used by the
+    // leader of a group commit flush.
+    WT_SESSION* _waitUntilDurableSession = nullptr;
 
     /**
      * Returns a session to the cache for later reuse. If closeAll was called between getting this
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Returns the partition of '_partitions' for the CPU on which the calling thread is running.
+     */
+    size_t _currentPartition() const;
+
+    /**
+     * Joins the next group commit flush of the journal (or a checkpoint of all data without
+     * journaling) and returns once it completes, leading it if no other caller does.
+     */
+    void _groupCommitFlush(OperationContext* opCtx, UseJournalListener useListener);
+
+    /**
+     * Flushes the journal, or takes a checkpoint if journaling is disabled. The JournalListener
+     * token is fetched before the flush so it covers every write of the group. Only called by the
+     * leader of a group commit.
+     */
+    void _flushForGroupCommit(OperationContext* opCtx, bool updateListener);
 };
 
 /**
@@ -29,12 +29,15 @@
 
 #include "mongo/platform/basic.h"
 
+#include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/system_clock_source.h"
@@ -113,4 +116,83 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, ReusesSessionsReleasedOnOtherThreads) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    const size_t kNumThreads = 8;
+    std::vector<UniqueWiredTigerSession> sessions;
+    std::set<WiredTigerSession*> released;
+    for (size_t i = 0; i < kNumThreads; ++i) {
+        sessions.push_back(sessionCache->getSession());
+        released.insert(sessions.back().get());
+    }
+
+    // Release each session on its own thread, so that they may be cached in different partitions.
+    std::vector<stdx::thread> threads;
+    for (auto&& session : sessions) {
+        threads.emplace_back([&session] { session.reset(); });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), kNumThreads);
+
+    // Every cached session is handed out again, wherever it was released.
+    for (auto&& session : sessions) {
+        session = sessionCache->getSession();
+        ASSERT_EQUALS(released.erase(session.get()), 1U);
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+
+    // Sessions acquired before closeAll() are not cached when they are released.
+    sessions.pop_back();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+    sessionCache->closeAll();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+    sessions.clear();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
+TEST(WiredTigerSessionCacheTest, GroupCommitsConcurrentDurableWaiters) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    auto groupCommitStats = [&] {
+        BSONObjBuilder builder;
+        sessionCache->appendGroupCommitStats(&builder);
+        return builder.obj();
+    };
+
+    // A lone waiter leads its own flush.
+    sessionCache->waitUntilDurable(nullptr,
+                                   WiredTigerSessionCache::Fsync::kJournal,
+                                   WiredTigerSessionCache::UseJournalListener::kSkip);
+    ASSERT_EQ(1, groupCommitStats()["flushes"].numberLong());
+    ASSERT_EQ(1, groupCommitStats()["waiters"].numberLong());
+
+    const size_t kNumThreads = 16;
+    const size_t kWaitsPerThread = 20;
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&] {
+            for (size_t j = 0; j < kWaitsPerThread; ++j) {
+                sessionCache->waitUntilDurable(nullptr,
+                                               WiredTigerSessionCache::Fsync::kJournal,
+                                               WiredTigerSessionCache::UseJournalListener::kSkip);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    // Every waiter was covered by exactly one flush, and no flush covered nobody.
+    const auto stats = groupCommitStats();
+    ASSERT_EQ(static_cast<long long>(1 + kNumThreads * kWaitsPerThread),
+              stats["waiters"].numberLong());
+    ASSERT_LTE(stats["flushes"].numberLong(), stats["waiters"].numberLong());
+    ASSERT_GTE(stats["flushes"].numberLong(), static_cast<long long>(1 + kWaitsPerThread));
+}
+
 }  // namespace mongo
@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_statistics_cache.h"
+
+#include <limits>
+#include <vector>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+
+namespace mongo {
+namespace {
+
+// Statistics which are not asked for within this many times the maximum age are dropped.
+const int kUnusedEntryMaxAgeFactor = 10;
+
+const std::string kStatisticsUriPrefix = "statistics:";
+
+}  // namespace
+
+StatusWith<int64_t> WiredTigerStatisticsCache::getStatisticsValue(WT_SESSION* session,
+                                                                  const std::string& uri,
+                                                                  const std::string& config,
+                                                                  int statisticsKey) {
+    const Seconds maxAge{gWiredTigerStatisticsCacheMaxAgeSecs.load()};
+    if (maxAge <= Seconds(0)) {
+        return WiredTigerUtil::getStatisticsValue(session, uri, config, statisticsKey);
+    }
+
+    Key key{uri, config, statisticsKey};
+    const auto now = Date_t::now();
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end() && now - it->second.refreshed < maxAge) {
+            it->second.lastUsed = now;
+            return it->second.value;
+        }
+    }
+
+    auto result = WiredTigerUtil::getStatisticsValue(session, uri, config, statisticsKey);
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (result.isOK()) {
+        _entries[std::move(key)] = {result.getValue(), now, now};
+    } else {
+        _entries.erase(key);
+    }
+    return result;
+}
+
+int64_t WiredTigerStatisticsCache::getIdentSize(WT_SESSION* session, const std::string& uri) {
+    auto result = getStatisticsValue(
+        session, kStatisticsUriPrefix + uri, "statistics=(size)", WT_STAT_DSRC_BLOCK_SIZE);
+    if (!result.isOK()) {
+        if (result.getStatus().code() == ErrorCodes::CursorNotFound) {
+            // ident gone, so its 0
+            return 0;
+        }
+        uassertStatusOK(result.getStatus());
+    }
+    return result.getValue();
+}
+
+void WiredTigerStatisticsCache::refresh(WT_SESSION* session) {
+    const Seconds maxAge{gWiredTigerStatisticsCacheMaxAgeSecs.load()};
+    const auto now = Date_t::now();
+
+    std::vector<Key> keys;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (maxAge <= Seconds(0)) {
+            _entries.clear();
+            return;
+        }
+
+        for (auto it = _entries.begin(); it != _entries.end();) {
+            if (now - it->second.lastUsed > maxAge * kUnusedEntryMaxAgeFactor) {
+                it = _entries.erase(it);
+            } else {
+                keys.push_back(it->first);
+                ++it;
+            }
+        }
+    }
+
+    // Read the statistics without holding the mutex, so that callers can still be served from
+    // the cache meanwhile.
+    for (const auto& key : keys) {
+        auto result = WiredTigerUtil::getStatisticsValue(
+            session, std::get<0>(key), std::get<1>(key), std::get<2>(key));
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            // Erased while being read.
+            continue;
+        }
+        if (result.isOK()) {
+            it->second.value = result.getValue();
+            it->second.refreshed = now;
+        } else {
+            _entries.erase(it);
+        }
+    }
+}
+
+void WiredTigerStatisticsCache::erase(const std::string& uri) {
+    const auto statisticsUri = kStatisticsUriPrefix + uri;
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _entries.lower_bound(Key{statisticsUri, "", std::numeric_limits<int>::min()});
+    while (it != _entries.end() && std::get<0>(it->first) == statisticsUri) {
+        it = _entries.erase(it);
+    }
+}
+
+size_t WiredTigerStatisticsCache::size() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _entries.size();
+}
+
+}  // namespace mongo
@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <tuple>
+
+#include <wiredtiger.h>
+
+#include "mongo/base/status_with.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Caches the values of WiredTiger data source statistics, such as the size of a table's file,
+ * which collStats, dbStats and $collStats read for every collection and index. Reading them opens
+ * a statistics cursor, which can be slow and contend with other schema operations on instances
+ * with many collections.
+ *
+ * Caching is enabled by 'wiredTigerStatisticsCacheMaxAgeSecs'. Cached values are served for up to
+ * that long, and are refreshed in the background by the checkpoint thread, since the sizes of
+ * tables mostly change when checkpoints write them. Values which have not been asked for in a
+ * while are dropped from the cache rather than refreshed.
+ */
+class WiredTigerStatisticsCache {
+    WiredTigerStatisticsCache(const WiredTigerStatisticsCache&) = delete;
+    WiredTigerStatisticsCache& operator=(const WiredTigerStatisticsCache&) = delete;
+
+public:
+    WiredTigerStatisticsCache() = default;
+
+    /**
+     * Same as WiredTigerUtil::getStatisticsValue(), but returns a cached value if there is one
+     * that is recent enough.
+     */
+    StatusWith<int64_t> getStatisticsValue(WT_SESSION* session,
+                                           const std::string& uri,
+                                           const std::string& config,
+                                           int statisticsKey);
+
+    /**
+     * Same as WiredTigerUtil::getIdentSize(), but returns a cached value if there is one that is
+     * recent enough.
+     */
+    int64_t getIdentSize(WT_SESSION* session, const std::string& uri);
+
+    /**
+     * Reads the statistics in the cache again from WiredTiger. Statistics of tables which no
+     * longer exist or which have not been asked for recently are removed from the cache.
+     */
+    void refresh(WT_SESSION* session);
+
+    /**
+     * Removes the statistics of the table 'uri' from the cache, e.g. because it was dropped.
+     */
+    void erase(const std::string& uri);
+
+    size_t size() const;
+
+private:
+    // Statistics cursor URI, cursor configuration and statistics key.
+    using Key = std::tuple<std::string, std::string, int>;
+
+    struct Entry {
+        int64_t value;
+        Date_t refreshed;
+        Date_t lastUsed;
+    };
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerStatisticsCache::_mutex");
+    std::map<Key, Entry> _entries;
+};
+
+}  // namespace mongo
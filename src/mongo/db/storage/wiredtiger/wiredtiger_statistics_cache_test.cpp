@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_statistics_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const std::string kTableUri = "table:statistics_cache";
+
+class WiredTigerStatisticsCacheTest : public unittest::Test {
+public:
+    WiredTigerStatisticsCacheTest() : _home("wt_statistics_cache_test") {
+        ASSERT_OK(wtRCToStatus(wiredtiger_open(_home.path().c_str(), nullptr, "create", &_conn)));
+        ASSERT_OK(wtRCToStatus(_conn->open_session(_conn, nullptr, nullptr, &_session)));
+        ASSERT_OK(wtRCToStatus(
+            _session->create(_session, kTableUri.c_str(), "key_format=q,value_format=u")));
+    }
+
+    ~WiredTigerStatisticsCacheTest() {
+        _conn->close(_conn, nullptr);
+        gWiredTigerStatisticsCacheMaxAgeSecs.store(_originalMaxAgeSecs);
+    }
+
+    void insertAndCheckpoint(int count) {
+        const std::string data(1024, 'x');
+        WT_CURSOR* cursor;
+        ASSERT_OK(wtRCToStatus(
+            _session->open_cursor(_session, kTableUri.c_str(), nullptr, nullptr, &cursor)));
+        for (int i = 0; i < count; ++i) {
+            WT_ITEM value{data.data(), data.size()};
+            cursor->set_key(cursor, static_cast<int64_t>(_nextKey++));
+            cursor->set_value(cursor, &value);
+            ASSERT_OK(wtRCToStatus(cursor->insert(cursor)));
+        }
+        ASSERT_OK(wtRCToStatus(cursor->close(cursor)));
+        ASSERT_OK(wtRCToStatus(_session->checkpoint(_session, nullptr)));
+    }
+
+protected:
+    unittest::TempDir _home;
+    WT_CONNECTION* _conn;
+    WT_SESSION* _session;
+    WiredTigerStatisticsCache _cache;
+    int _nextKey = 0;
+    const int32_t _originalMaxAgeSecs = gWiredTigerStatisticsCacheMaxAgeSecs.load();
+};
+
+TEST_F(WiredTigerStatisticsCacheTest, DisabledCacheReadsFromWiredTiger) {
+    gWiredTigerStatisticsCacheMaxAgeSecs.store(0);
+    const auto emptySize = _cache.getIdentSize(_session, kTableUri);
+    insertAndCheckpoint(1000);
+    ASSERT_GT(_cache.getIdentSize(_session, kTableUri), emptySize);
+    ASSERT_EQ(0U, _cache.size());
+}
+
+TEST_F(WiredTigerStatisticsCacheTest, CachedSizeIsUpdatedByRefresh) {
+    gWiredTigerStatisticsCacheMaxAgeSecs.store(3600);
+    const auto emptySize = _cache.getIdentSize(_session, kTableUri);
+    ASSERT_EQ(1U, _cache.size());
+
+    insertAndCheckpoint(1000);
+    ASSERT_EQ(emptySize, _cache.getIdentSize(_session, kTableUri));
+
+    _cache.refresh(_session);
+    const auto size = _cache.getIdentSize(_session, kTableUri);
+    ASSERT_GT(size, emptySize);
+    ASSERT_EQ(WiredTigerUtil::getIdentSize(_session, kTableUri), size);
+}
+
+TEST_F(WiredTigerStatisticsCacheTest, EraseAndDropRemoveEntries) {
+    gWiredTigerStatisticsCacheMaxAgeSecs.store(3600);
+    _cache.getIdentSize(_session, kTableUri);
+    ASSERT_EQ(1U, _cache.size());
+    _cache.erase(kTableUri);
+    ASSERT_EQ(0U, _cache.size());
+
+    _cache.getIdentSize(_session, kTableUri);
+    ASSERT_OK(wtRCToStatus(_session->drop(_session, kTableUri.c_str(), nullptr)));
+    _cache.refresh(_session);
+    ASSERT_EQ(0U, _cache.size());
+    ASSERT_EQ(0, _cache.getIdentSize(_session, kTableUri));
+}
+
+}  // namespace
+}  // namespace mongo
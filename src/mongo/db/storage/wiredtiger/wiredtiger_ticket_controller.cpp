@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_controller.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+// WiredTiger's default 'eviction_trigger' and 'eviction_dirty_trigger', in percent of the cache.
+constexpr double kEvictionTrigger = 95;
+constexpr double kEvictionDirtyTrigger = 20;
+
+// Throughput has dropped after an increase if it falls below this fraction of what it was before.
+constexpr double kThroughputDropRatio = 0.9;
+
+}  // namespace
+
+double WiredTigerTicketController::evictionPressure(std::int64_t bytesInUse,
+                                                    std::int64_t dirtyBytes,
+                                                    std::int64_t maxBytes) {
+    if (maxBytes <= 0) {
+        return 0;
+    }
+    const double inUsePercent = 100.0 * bytesInUse / maxBytes;
+    const double dirtyPercent = 100.0 * dirtyBytes / maxBytes;
+    return std::max(inUsePercent / kEvictionTrigger, dirtyPercent / kEvictionDirtyTrigger);
+}
+
+int WiredTigerTicketController::adjust(const Sample& sample, int minTickets, int maxTickets) {
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    int newTotal = sample.total;
+    StringData reason = "idle"_sd;
+    if (sample.evictionPressure >= 1) {
+        newTotal = sample.total * 3 / 4;
+        reason = "evictionPressure"_sd;
+    } else if (_lastDecision == Decision::kIncrease && _lastCompleted >= 0 &&
+               sample.completed < _lastCompleted * kThroughputDropRatio) {
+        newTotal = sample.total - kIncreaseStep;
+        reason = "throughputDropped"_sd;
+    } else if (sample.used >= sample.total) {
+        if (sample.evictionPressure < kHoldEvictionPressure) {
+            newTotal = sample.total + kIncreaseStep;
+            reason = "saturated"_sd;
+        } else {
+            reason = "cachePressure"_sd;
+        }
+    }
+
+    const int clamped = std::max(minTickets, std::min(maxTickets, newTotal));
+    if (clamped != newTotal) {
+        reason = "bounds"_sd;
+        newTotal = clamped;
+    }
+
+    Decision decision = Decision::kHold;
+    if (newTotal > sample.total) {
+        decision = Decision::kIncrease;
+        ++_increases;
+    } else if (newTotal < sample.total) {
+        decision = Decision::kDecrease;
+        ++_decreases;
+    }
+
+    _lastDecision = decision;
+    _lastReason = reason;
+    _lastEvictionPressure = sample.evictionPressure;
+    _lastCompleted = sample.completed;
+    _lastTotal = newTotal;
+    return newTotal;
+}
+
+void WiredTigerTicketController::reset() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _lastDecision = Decision::kHold;
+    _lastReason = "none"_sd;
+    _lastEvictionPressure = 0;
+    _lastCompleted = -1;
+}
+
+void WiredTigerTicketController::append(BSONObjBuilder* builder) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    builder->append("lastDecision", _toString(_lastDecision));
+    builder->append("lastReason", _lastReason);
+    builder->append("lastTotalTickets", _lastTotal);
+    builder->append("lastEvictionPressure", _lastEvictionPressure);
+    builder->append("lastCompletedTransactions", static_cast<long long>(_lastCompleted));
+    builder->append("increases", _increases);
+    builder->append("decreases", _decreases);
+}
+
+StringData WiredTigerTicketController::_toString(Decision decision) {
+    switch (decision) {
+        case Decision::kHold:
+            return "hold"_sd;
+        case Decision::kIncrease:
+            return "increase"_sd;
+        case Decision::kDecrease:
+            return "decrease"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
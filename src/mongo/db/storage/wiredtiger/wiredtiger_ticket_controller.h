@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/mutex.h"
+
+namespace mongo {
+
+/**
+ * Decides how many tickets a TicketHolder for concurrent storage transactions should have, in the
+ * spirit of additive-increase/multiplicative-decrease congestion control.
+ *
+ * Each adjustment is given a sample of the ticket usage, the number of transactions WiredTiger
+ * completed since the previous sample, and the pressure on the WiredTiger cache. The count is
+ * increased by a fixed step while all the tickets are in use, as long as doing so does not make
+ * throughput drop. It is cut by a fixed factor once the cache is full enough for application
+ * threads to be drafted into eviction, because admitting more transactions then only adds work.
+ *
+ * The controller only makes decisions; the caller applies them with TicketHolder::resize(). The
+ * decisions are reported in serverStatus, and hence recorded by FTDC.
+ */
+class WiredTigerTicketController {
+    WiredTigerTicketController(const WiredTigerTicketController&) = delete;
+    WiredTigerTicketController& operator=(const WiredTigerTicketController&) = delete;
+
+public:
+    // Number of tickets added by each additive increase.
+    static constexpr int kIncreaseStep = 8;
+
+    // Cache pressure at and above which the ticket count is not increased any further.
+    static constexpr double kHoldEvictionPressure = 0.9;
+
+    struct Sample {
+        int used;
+        int total;
+
+        // Number of transactions committed or rolled back since the previous sample.
+        std::int64_t completed;
+
+        // Cache fill ratio relative to the point at which WiredTiger makes application threads
+        // evict, see evictionPressure().
+        double evictionPressure;
+    };
+
+    enum class Decision { kHold, kIncrease, kDecrease };
+
+    WiredTigerTicketController() = default;
+
+    /**
+     * Computes the pressure on a WiredTiger cache of 'maxBytes' holding 'bytesInUse' bytes, of
+     * which 'dirtyBytes' are dirty. It is 1 when either reaches the threshold at which WiredTiger
+     * has application threads evict pages, which are the 'eviction_trigger' and
+     * 'eviction_dirty_trigger' configuration defaults.
+     */
+    static double evictionPressure(std::int64_t bytesInUse,
+                                   std::int64_t dirtyBytes,
+                                   std::int64_t maxBytes);
+
+    /**
+     * Returns the ticket count to use after 'sample', which is between 'minTickets' and
+     * 'maxTickets'.
+     */
+    int adjust(const Sample& sample, int minTickets, int maxTickets);
+
+    /**
+     * Forgets the history of previous samples, e.g. because adaptive ticket counts were disabled.
+     */
+    void reset();
+
+    void append(BSONObjBuilder* builder) const;
+
+private:
+    static StringData _toString(Decision decision);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerTicketController::_mutex");
+
+    Decision _lastDecision = Decision::kHold;
+    StringData _lastReason = "none"_sd;
+    double _lastEvictionPressure = 0;
+    std::int64_t _lastCompleted = -1;
+    int _lastTotal = 0;
+
+    long long _increases = 0;
+    long long _decreases = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_controller.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+constexpr int kMin = 16;
+constexpr int kMax = 256;
+constexpr int kStep = WiredTigerTicketController::kIncreaseStep;
+
+TEST(WiredTigerTicketControllerTest, EvictionPressure) {
+    ASSERT_EQ(0, WiredTigerTicketController::evictionPressure(0, 0, 0));
+    ASSERT_EQ(0, WiredTigerTicketController::evictionPressure(0, 0, 100));
+    ASSERT_APPROX_EQUAL(1.0, WiredTigerTicketController::evictionPressure(95, 0, 100), 1e-9);
+    ASSERT_APPROX_EQUAL(0.5, WiredTigerTicketController::evictionPressure(40, 10, 100), 1e-9);
+    ASSERT_APPROX_EQUAL(2.0, WiredTigerTicketController::evictionPressure(50, 40, 100), 1e-9);
+}
+
+TEST(WiredTigerTicketControllerTest, HoldsWhileTicketsAreAvailable) {
+    WiredTigerTicketController controller;
+    ASSERT_EQ(128, controller.adjust({64, 128, 1000, 0.5}, kMin, kMax));
+    ASSERT_EQ(128, controller.adjust({127, 128, 1000, 0.5}, kMin, kMax));
+}
+
+TEST(WiredTigerTicketControllerTest, IncreasesAdditivelyWhileSaturated) {
+    WiredTigerTicketController controller;
+    ASSERT_EQ(128 + kStep, controller.adjust({128, 128, 1000, 0.5}, kMin, kMax));
+    ASSERT_EQ(128 + 2 * kStep, controller.adjust({136, 136, 1050, 0.5}, kMin, kMax));
+
+    BSONObjBuilder builder;
+    controller.append(&builder);
+    auto obj = builder.obj();
+    ASSERT_EQ("increase", obj["lastDecision"].str());
+    ASSERT_EQ("saturated", obj["lastReason"].str());
+    ASSERT_EQ(2, obj["increases"].numberLong());
+    ASSERT_EQ(0, obj["decreases"].numberLong());
+}
+
+TEST(WiredTigerTicketControllerTest, DoesNotIncreaseUnderCachePressure) {
+    WiredTigerTicketController controller;
+    ASSERT_EQ(128, controller.adjust({128, 128, 1000, 0.95}, kMin, kMax));
+}
+
+TEST(WiredTigerTicketControllerTest, DecreasesMultiplicativelyOnEvictionPressure) {
+    WiredTigerTicketController controller;
+    ASSERT_EQ(96, controller.adjust({128, 128, 1000, 1.2}, kMin, kMax));
+    ASSERT_EQ(72, controller.adjust({96, 96, 1000, 1.0}, kMin, kMax));
+
+    BSONObjBuilder builder;
+    controller.append(&builder);
+    auto obj = builder.obj();
+    ASSERT_EQ("decrease", obj["lastDecision"].str());
+    ASSERT_EQ("evictionPressure", obj["lastReason"].str());
+    ASSERT_EQ(2, obj["decreases"].numberLong());
+}
+
+TEST(WiredTigerTicketControllerTest, BacksOffWhenThroughputDropsAfterIncrease) {
+    WiredTigerTicketController controller;
+    ASSERT_EQ(128 + kStep, controller.adjust({128, 128, 1000, 0.5}, kMin, kMax));
+    ASSERT_EQ(128, controller.adjust({136, 136, 800, 0.5}, kMin, kMax));
+
+    // A drop in throughput which does not follow an increase is not attributed to the increase.
+    ASSERT_EQ(128, controller.adjust({100, 128, 500, 0.5}, kMin, kMax));
+}
+
+TEST(WiredTigerTicketControllerTest, StaysWithinBounds) {
+    WiredTigerTicketController controller;
+    ASSERT_EQ(kMax, controller.adjust({kMax, kMax, 1000, 0.5}, kMin, kMax));
+    ASSERT_EQ(kMin, controller.adjust({kMin, kMin, 1000, 5.0}, kMin, kMax));
+    ASSERT_EQ(kMax, controller.adjust({10, 1000, 1000, 0.5}, kMin, kMax));
+
+    BSONObjBuilder builder;
+    controller.append(&builder);
+    ASSERT_EQ("bounds", builder.obj()["lastReason"].str());
+}
+
+TEST(WiredTigerTicketControllerTest, ResetForgetsPreviousIncrease) {
+    WiredTigerTicketController controller;
+    ASSERT_EQ(128 + kStep, controller.adjust({128, 128, 1000, 0.5}, kMin, kMax));
+    controller.reset();
+    ASSERT_EQ(136, controller.adjust({100, 136, 500, 0.5}, kMin, kMax));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -394,6 +394,27 @@ int64_t WiredTigerUtil::getIdentSize(WT_SESSION* s, const std::string& uri) {
     return result.getValue();
 }
 
+Status WiredTigerUtil::compact(OperationContext* opCtx, const std::string& uri) {
+    WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    opCtx->recoveryUnit()->abandonSnapshot();
+
+    // WiredTiger's timeout is in seconds and 0 means no timeout, so round up to at least 1.
+    long long timeoutSecs = 0;
+    if (opCtx->hasDeadline()) {
+        const auto remaining = opCtx->getRemainingMaxTimeMicros() + Seconds(1) - Microseconds(1);
+        timeoutSecs = std::max<long long>(1, durationCount<Seconds>(remaining));
+    }
+
+    const std::string config = str::stream() << "timeout=" << timeoutSecs;
+    int ret = s->compact(s, uri.c_str(), config.c_str());
+    if (ret == ETIMEDOUT) {
+        return {opCtx->getTimeoutError(),
+                str::stream() << "compaction of " << uri << " did not finish in time"};
+    }
+    invariantWTOK(ret);
+    return Status::OK();
+}
+
 size_t WiredTigerUtil::getCacheSizeMB(double requestedCacheSizeGB) {
     double cacheSizeMB;
     const double kMaxSizeCacheMB = 10 * 1000 * 1000;
@@ -598,7 +619,41 @@ bool WiredTigerUtil::useTableLogging(NamespaceString ns, bool replEnabled) {
     return true;
 }
 
+namespace {
+
+std::string tableLoggingSetting(bool on) {
+    return on ? "log=(enabled=true)" : "log=(enabled=false)";
+}
+
+/**
+ * Returns whether the creation metadata of the table 'uri' already has 'setting'. This does some
+ * "weak" parsing of the metadata.
+ */
+bool hasTableLoggingSetting(const std::string& uri,
+                            const std::string& existingMetadata,
+                            const std::string& setting) {
+    if (existingMetadata.find("log=(enabled=true)") != std::string::npos &&
+        existingMetadata.find("log=(enabled=false)") != std::string::npos) {
+        // Sanity check against a table having multiple logging specifications.
+        invariant(false,
+                  str::stream() << "Table has contradictory logging settings. Uri: " << uri
+                                << " Conf: " << existingMetadata);
+    }
+    return existingMetadata.find(setting) != std::string::npos;
+}
+
+}  // namespace
+
 Status WiredTigerUtil::setTableLogging(OperationContext* opCtx, const std::string& uri, bool on) {
+    // Tables are created with the proper settings, so the table almost always has them already.
+    // Check with the operation's own session first, which avoids closing cursors and opening a
+    // dedicated session for every table when opening many tables, such as at startup.
+    auto existingMetadata = getMetadataCreate(opCtx, uri);
+    if (existingMetadata.isOK() &&
+        hasTableLoggingSetting(uri, existingMetadata.getValue(), tableLoggingSetting(on))) {
+        return Status::OK();
+    }
+
     // Try to close as much as possible to avoid EBUSY errors.
     WiredTigerRecoveryUnit::get(opCtx)->getSession()->closeAllCursors(uri);
     WiredTigerSessionCache* sessionCache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
@@ -610,30 +665,16 @@ Status WiredTigerUtil::setTableLogging(OperationContext* opCtx, const std::strin
 }
 
 Status WiredTigerUtil::setTableLogging(WT_SESSION* session, const std::string& uri, bool on) {
-    std::string setting;
-    if (on) {
-        setting = "log=(enabled=true)";
-    } else {
-        setting = "log=(enabled=false)";
-    }
+    const std::string setting = tableLoggingSetting(on);
 
-    // This method does some "weak" parsing to see if the table is in the expected logging
-    // state. Only attempt to alter the table when a change is needed. This avoids grabbing heavy
-    // locks in WT when creating new tables for collections and indexes. Those tables are created
-    // with the proper settings and consequently should not be getting changed here.
+    // Only attempt to alter the table when a change is needed. This avoids grabbing heavy locks in
+    // WT when creating new tables for collections and indexes. Those tables are created with the
+    // proper settings and consequently should not be getting changed here.
     //
     // If the settings need to be changed (only expected at startup), the alter table call must
     // succeed.
     std::string existingMetadata = getMetadataCreate(session, uri).getValue();
-    if (existingMetadata.find("log=(enabled=true)") != std::string::npos &&
-        existingMetadata.find("log=(enabled=false)") != std::string::npos) {
-        // Sanity check against a table having multiple logging specifications.
-        invariant(false,
-                  str::stream() << "Table has contradictory logging settings. Uri: " << uri
-                                << " Conf: " << existingMetadata);
-    }
-
-    if (existingMetadata.find(setting) != std::string::npos) {
+    if (hasTableLoggingSetting(uri, existingMetadata, setting)) {
         // The table is running with the expected logging settings.
         return Status::OK();
     }
@@ -220,6 +220,13 @@ public:
 
     static int64_t getIdentSize(WT_SESSION* s, const std::string& uri);
 
+    /**
+     * Compacts the table 'uri'. If 'opCtx' has a deadline, WiredTiger stops compacting once it is
+     * reached, to the second, and the timeout error of 'opCtx' is returned. The space reclaimed up
+     * to then stays reclaimed, so a later call carries on from there.
+     */
+    static Status compact(OperationContext* opCtx, const std::string& uri);
+
 
     /**
      * Return amount of memory to use for the WiredTiger cache based on either the startup
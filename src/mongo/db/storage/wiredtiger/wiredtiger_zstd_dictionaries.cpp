@@ -0,0 +1,394 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_zstd_dictionaries.h"
+
+#include <boost/filesystem.hpp>
+#include <cctype>
+#include <fstream>
+#include <memory>
+#include <zdict.h>
+#include <zstd.h>
+
+#include "mongo/base/data_view.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_file_util.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+namespace fs = boost::filesystem;
+
+// The level at which WiredTiger's own zstd compressor compresses by default.
+const int kCompressionLevel = 6;
+
+// Decompression needs the exact size of the compressed data, which WiredTiger doesn't track, so it
+// is stored ahead of the compressed data, as WiredTiger's zstd compressor does.
+const size_t kSizePrefix = sizeof(uint64_t);
+
+const StringData kDictionaryFileExtension = ".dict"_sd;
+
+// Serializes the creation of dictionaries.
+Mutex addDictionaryMutex = MONGO_MAKE_LATCH("WiredTigerZstdDictionaries::addDictionaryMutex");
+
+ServiceContext::ConstructorActionRegisterer registerZstdDictionaryExtension{
+    "RegisterWiredTigerZstdDictionaryExtension", [](ServiceContext* service) {
+        WiredTigerExtensions::get(service)->addExtension(
+            WiredTigerZstdDictionaries::kOpenExtensionConfig);
+    }};
+
+struct ZstdDeleter {
+    void operator()(ZSTD_CCtx* cctx) const {
+        ZSTD_freeCCtx(cctx);
+    }
+    void operator()(ZSTD_DCtx* dctx) const {
+        ZSTD_freeDCtx(dctx);
+    }
+    void operator()(ZSTD_CDict* cdict) const {
+        ZSTD_freeCDict(cdict);
+    }
+    void operator()(ZSTD_DDict* ddict) const {
+        ZSTD_freeDDict(ddict);
+    }
+};
+
+// Each thread reuses its contexts, which are expensive to create, across pages.
+ZSTD_CCtx* getCompressionContext() {
+    thread_local std::unique_ptr<ZSTD_CCtx, ZstdDeleter> cctx(ZSTD_createCCtx());
+    return cctx.get();
+}
+
+ZSTD_DCtx* getDecompressionContext() {
+    thread_local std::unique_ptr<ZSTD_DCtx, ZstdDeleter> dctx(ZSTD_createDCtx());
+    return dctx.get();
+}
+
+/**
+ * A WiredTiger compressor using one dictionary. Once registered, it is owned by the connection,
+ * which destroys it through the terminate callback when it is closed.
+ */
+class ZstdDictionaryCompressor : public WT_COMPRESSOR {
+public:
+    ZstdDictionaryCompressor(std::string name, StringData dictionary)
+        : WT_COMPRESSOR{},
+          _name(std::move(name)),
+          _cdict(ZSTD_createCDict(dictionary.rawData(), dictionary.size(), kCompressionLevel)),
+          _ddict(ZSTD_createDDict(dictionary.rawData(), dictionary.size())) {
+        compress = &_compress;
+        decompress = &_decompress;
+        pre_size = &_preSize;
+        terminate = &_terminate;
+    }
+
+    const std::string& name() const {
+        return _name;
+    }
+
+    bool isValid() const {
+        return _cdict && _ddict;
+    }
+
+private:
+    static int _compress(WT_COMPRESSOR* compressor,
+                         WT_SESSION* session,
+                         uint8_t* src,
+                         size_t srcLen,
+                         uint8_t* dst,
+                         size_t dstLen,
+                         size_t* resultLen,
+                         int* compressionFailed) {
+        auto self = static_cast<ZstdDictionaryCompressor*>(compressor);
+        *compressionFailed = 1;
+        if (dstLen <= kSizePrefix) {
+            return 0;
+        }
+
+        // Any failure leaves the page uncompressed, so it is not an error.
+        size_t ret = ZSTD_compress_usingCDict(getCompressionContext(),
+                                              dst + kSizePrefix,
+                                              dstLen - kSizePrefix,
+                                              src,
+                                              srcLen,
+                                              self->_cdict.get());
+        if (ZSTD_isError(ret) || ret + kSizePrefix >= srcLen) {
+            return 0;
+        }
+
+        DataView(reinterpret_cast<char*>(dst)).write<LittleEndian<uint64_t>>(ret);
+        *resultLen = ret + kSizePrefix;
+        *compressionFailed = 0;
+        return 0;
+    }
+
+    static int _decompress(WT_COMPRESSOR* compressor,
+                           WT_SESSION* session,
+                           uint8_t* src,
+                           size_t srcLen,
+                           uint8_t* dst,
+                           size_t dstLen,
+                           size_t* resultLen) {
+        auto self = static_cast<ZstdDictionaryCompressor*>(compressor);
+        uint64_t compressedLen = std::numeric_limits<uint64_t>::max();
+        if (srcLen >= kSizePrefix) {
+            compressedLen =
+                ConstDataView(reinterpret_cast<const char*>(src)).read<LittleEndian<uint64_t>>();
+        }
+        if (compressedLen > srcLen - kSizePrefix) {
+            LOGV2_ERROR(5021438,
+                        "Stored size of compressed data exceeds the source size",
+                        "compressor"_attr = self->_name,
+                        "storedSize"_attr = compressedLen,
+                        "sourceSize"_attr = srcLen);
+            return WT_ERROR;
+        }
+
+        size_t ret = ZSTD_decompress_usingDDict(getDecompressionContext(),
+                                                dst,
+                                                dstLen,
+                                                src + kSizePrefix,
+                                                compressedLen,
+                                                self->_ddict.get());
+        if (ZSTD_isError(ret)) {
+            LOGV2_ERROR(5021439,
+                        "Failed to decompress data",
+                        "compressor"_attr = self->_name,
+                        "error"_attr = ZSTD_getErrorName(ret));
+            return WT_ERROR;
+        }
+        *resultLen = ret;
+        return 0;
+    }
+
+    static int _preSize(WT_COMPRESSOR* compressor,
+                        WT_SESSION* session,
+                        uint8_t* src,
+                        size_t srcLen,
+                        size_t* resultLen) {
+        *resultLen = ZSTD_compressBound(srcLen) + kSizePrefix;
+        return 0;
+    }
+
+    static int _terminate(WT_COMPRESSOR* compressor, WT_SESSION* session) {
+        delete static_cast<ZstdDictionaryCompressor*>(compressor);
+        return 0;
+    }
+
+    const std::string _name;
+    const std::unique_ptr<ZSTD_CDict, ZstdDeleter> _cdict;
+    const std::unique_ptr<ZSTD_DDict, ZstdDeleter> _ddict;
+};
+
+bool isValidDictionaryName(StringData name) {
+    return !name.empty() && name.size() <= 64 &&
+        std::all_of(name.begin(), name.end(), [](char c) {
+               return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+           });
+}
+
+fs::path getDictionaryDirectory(WT_CONNECTION* conn) {
+    return fs::path(conn->get_home(conn)) /
+        WiredTigerZstdDictionaries::kDirectoryName.toString();
+}
+
+StatusWith<std::unique_ptr<ZstdDictionaryCompressor>> makeCompressor(StringData name,
+                                                                     StringData dictionary) {
+    auto compressor = std::make_unique<ZstdDictionaryCompressor>(
+        WiredTigerZstdDictionaries::compressorName(name), dictionary);
+    if (!compressor->isValid()) {
+        return {ErrorCodes::BadValue, str::stream() << "Invalid zstd dictionary '" << name << "'"};
+    }
+    return {std::move(compressor)};
+}
+
+Status registerCompressor(WT_CONNECTION* conn,
+                          std::unique_ptr<ZstdDictionaryCompressor> compressor) {
+    int ret = conn->add_compressor(conn, compressor->name().c_str(), compressor.get(), nullptr);
+    if (ret) {
+        return wtRCToStatus(ret, "WiredTigerZstdDictionaries: add_compressor");
+    }
+    // The connection owns the compressor from now on.
+    compressor.release();
+    return Status::OK();
+}
+
+int addZstdDictionaryCompressors(WT_CONNECTION* conn) {
+    auto status = WiredTigerZstdDictionaries::registerAll(conn);
+    if (!status.isOK()) {
+        LOGV2_ERROR(5021440,
+                    "Failed to register the zstd dictionary compressors",
+                    "error"_attr = status);
+        return WT_ERROR;
+    }
+    return 0;
+}
+
+}  // namespace
+
+std::string WiredTigerZstdDictionaries::compressorName(StringData name) {
+    return str::stream() << kCompressorPrefix << name;
+}
+
+StatusWith<std::string> WiredTigerZstdDictionaries::train(const std::vector<BSONObj>& samples,
+                                                          size_t maxDictionarySize) {
+    std::string sampleBuffer;
+    std::vector<size_t> sampleSizes;
+    sampleSizes.reserve(samples.size());
+    for (auto&& sample : samples) {
+        sampleBuffer.append(sample.objdata(), sample.objsize());
+        sampleSizes.push_back(sample.objsize());
+    }
+
+    std::string dictionary(maxDictionarySize, '\0');
+    size_t ret = ZDICT_trainFromBuffer(&dictionary[0],
+                                       dictionary.size(),
+                                       sampleBuffer.data(),
+                                       sampleSizes.data(),
+                                       sampleSizes.size());
+    if (ZDICT_isError(ret)) {
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "Failed to train a zstd dictionary on " << samples.size()
+                              << " documents: " << ZDICT_getErrorName(ret)};
+    }
+    dictionary.resize(ret);
+    return {std::move(dictionary)};
+}
+
+Status WiredTigerZstdDictionaries::add(WT_CONNECTION* conn,
+                                       StringData name,
+                                       StringData dictionary) {
+    if (!isValidDictionaryName(name)) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Invalid zstd dictionary name '" << name
+                              << "': it must consist of 1 to 64 letters, digits or underscores"};
+    }
+
+    auto compressor = makeCompressor(name, dictionary);
+    if (!compressor.isOK()) {
+        return compressor.getStatus();
+    }
+
+    stdx::lock_guard<Latch> lk(addDictionaryMutex);
+    try {
+        const auto directory = getDictionaryDirectory(conn);
+        const auto file = directory / (name.toString() + kDictionaryFileExtension.toString());
+        if (fs::exists(file)) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "A zstd dictionary named '" << name << "' already exists"};
+        }
+
+        if (fs::create_directories(directory)) {
+            auto status = fsyncParentDirectory(directory);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+
+        // Write the dictionary to a temporary file first, so that a partially written dictionary
+        // is never registered when the connection is next opened.
+        auto tmpFile = file;
+        tmpFile += ".tmp";
+        {
+            std::ofstream out(tmpFile.string(), std::ios::binary | std::ios::trunc);
+            out.write(dictionary.rawData(), dictionary.size());
+            out.close();
+            if (!out) {
+                return {ErrorCodes::FileStreamFailed,
+                        str::stream()
+                            << "Failed to write zstd dictionary file " << tmpFile.string()};
+            }
+        }
+        auto status = fsyncFile(tmpFile);
+        if (!status.isOK()) {
+            return status;
+        }
+        status = fsyncRename(tmpFile, file);
+        if (!status.isOK()) {
+            return status;
+        }
+    } catch (const fs::filesystem_error& ex) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to store zstd dictionary '" << name << "': " << ex.what()};
+    }
+
+    return registerCompressor(conn, std::move(compressor.getValue()));
+}
+
+Status WiredTigerZstdDictionaries::registerAll(WT_CONNECTION* conn) {
+    try {
+        const auto directory = getDictionaryDirectory(conn);
+        if (!fs::exists(directory)) {
+            return Status::OK();
+        }
+
+        for (auto&& entry : fs::directory_iterator(directory)) {
+            const auto& file = entry.path();
+            if (!fs::is_regular_file(file) ||
+                file.extension().string() != kDictionaryFileExtension) {
+                continue;
+            }
+
+            std::ifstream in(file.string(), std::ios::binary);
+            std::string dictionary{std::istreambuf_iterator<char>(in),
+                                   std::istreambuf_iterator<char>()};
+            if (in.bad()) {
+                return {ErrorCodes::FileStreamFailed,
+                        str::stream() << "Failed to read zstd dictionary file " << file.string()};
+            }
+
+            auto compressor = makeCompressor(file.stem().string(), dictionary);
+            if (!compressor.isOK()) {
+                return compressor.getStatus();
+            }
+            auto status = registerCompressor(conn, std::move(compressor.getValue()));
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    } catch (const fs::filesystem_error& ex) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to load zstd dictionaries: " << ex.what()};
+    }
+    return Status::OK();
+}
+
+}  // namespace mongo
+
+extern "C" MONGO_COMPILER_API_EXPORT int mongo_addZstdDictionaryCompressors(WT_CONNECTION* conn,
+                                                                            WT_CONFIG_ARG* config) {
+    return mongo::addZstdDictionaryCompressors(conn);
+}
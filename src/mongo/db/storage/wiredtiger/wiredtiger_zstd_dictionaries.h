@@ -0,0 +1,93 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <wiredtiger.h>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * WiredTiger block compressors which compress pages with zstd using a dictionary trained on a
+ * sample of documents. Small and repetitive documents compress much better this way than with a
+ * compressor which only learns from the page being compressed.
+ *
+ * A dictionary named <name> is registered as the block compressor "zstd_dict_<name>", which a
+ * collection selects with "block_compressor=zstd_dict_<name>" in its WiredTiger 'configString'.
+ * WiredTiger needs the compressors of a table before recovery reads it, so the dictionaries are
+ * kept in files under '<dbpath>/zstdDictionaries' and are registered by a WiredTiger extension
+ * each time a connection is opened.
+ */
+class WiredTigerZstdDictionaries {
+public:
+    static constexpr StringData kCompressorPrefix = "zstd_dict_"_sd;
+    static constexpr StringData kDirectoryName = "zstdDictionaries"_sd;
+
+    /**
+     * The 'extensions' entry which registers the dictionaries of a connection when it is opened.
+     */
+    static constexpr StringData kOpenExtensionConfig =
+        "local=(entry=mongo_addZstdDictionaryCompressors)"_sd;
+
+    /**
+     * Returns the name of the block compressor using the dictionary 'name'.
+     */
+    static std::string compressorName(StringData name);
+
+    /**
+     * Trains a dictionary of at most 'maxDictionarySize' bytes on the given documents.
+     */
+    static StatusWith<std::string> train(const std::vector<BSONObj>& samples,
+                                         size_t maxDictionarySize);
+
+    /**
+     * Durably stores 'dictionary' under 'name' in the home directory of 'conn', and registers its
+     * compressor with 'conn'. Fails if a dictionary of that name already exists.
+     */
+    static Status add(WT_CONNECTION* conn, StringData name, StringData dictionary);
+
+    /**
+     * Registers the compressors of every dictionary stored in the home directory of 'conn'.
+     */
+    static Status registerAll(WT_CONNECTION* conn);
+};
+
+}  // namespace mongo
+
+/**
+ * The entry point of the WiredTiger extension named by kOpenExtensionConfig.
+ */
+extern "C" int mongo_addZstdDictionaryCompressors(WT_CONNECTION* conn, WT_CONFIG_ARG* config);
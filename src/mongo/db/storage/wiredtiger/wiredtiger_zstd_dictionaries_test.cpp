@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_zstd_dictionaries.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const char* kTableUri = "table:zstd_dictionary";
+
+std::vector<BSONObj> makeDocuments(int count) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < count; ++i) {
+        const std::string customer = str::stream() << "customer " << i % 17;
+        docs.push_back(BSON("_id" << i << "status" << (i % 3 == 0 ? "active" : "inactive")
+                                  << "customer"
+                                  << BSON("name" << customer << "region"
+                                                 << (i % 2 ? "north" : "south"))
+                                  << "amount" << i * 1.5));
+    }
+    return docs;
+}
+
+WT_CONNECTION* openConnection(const std::string& home) {
+    WT_CONNECTION* conn;
+    ASSERT_OK(wtRCToStatus(wiredtiger_open(home.c_str(), nullptr, "create", &conn)));
+    return conn;
+}
+
+void closeConnection(WT_CONNECTION* conn) {
+    ASSERT_OK(wtRCToStatus(conn->close(conn, nullptr)));
+}
+
+void insertDocuments(WT_CONNECTION* conn, const std::vector<BSONObj>& docs) {
+    WT_SESSION* session;
+    ASSERT_OK(wtRCToStatus(conn->open_session(conn, nullptr, nullptr, &session)));
+    WT_CURSOR* cursor;
+    ASSERT_OK(wtRCToStatus(session->open_cursor(session, kTableUri, nullptr, nullptr, &cursor)));
+    for (size_t i = 0; i < docs.size(); ++i) {
+        WT_ITEM value{docs[i].objdata(), static_cast<size_t>(docs[i].objsize())};
+        cursor->set_key(cursor, static_cast<int64_t>(i));
+        cursor->set_value(cursor, &value);
+        ASSERT_OK(wtRCToStatus(cursor->insert(cursor)));
+    }
+    ASSERT_OK(wtRCToStatus(session->checkpoint(session, nullptr)));
+    ASSERT_OK(wtRCToStatus(session->close(session, nullptr)));
+}
+
+void assertDocuments(WT_CONNECTION* conn, const std::vector<BSONObj>& docs) {
+    WT_SESSION* session;
+    ASSERT_OK(wtRCToStatus(conn->open_session(conn, nullptr, nullptr, &session)));
+    WT_CURSOR* cursor;
+    ASSERT_OK(wtRCToStatus(session->open_cursor(session, kTableUri, nullptr, nullptr, &cursor)));
+    for (size_t i = 0; i < docs.size(); ++i) {
+        ASSERT_OK(wtRCToStatus(cursor->next(cursor)));
+        int64_t key;
+        WT_ITEM value;
+        ASSERT_OK(wtRCToStatus(cursor->get_key(cursor, &key)));
+        ASSERT_OK(wtRCToStatus(cursor->get_value(cursor, &value)));
+        ASSERT_EQ(static_cast<int64_t>(i), key);
+        ASSERT_BSONOBJ_EQ(docs[i], BSONObj(static_cast<const char*>(value.data)));
+    }
+    ASSERT_EQ(WT_NOTFOUND, cursor->next(cursor));
+    ASSERT_OK(wtRCToStatus(session->close(session, nullptr)));
+}
+
+TEST(WiredTigerZstdDictionariesTest, CompressorName) {
+    ASSERT_EQ("zstd_dict_orders", WiredTigerZstdDictionaries::compressorName("orders"));
+}
+
+TEST(WiredTigerZstdDictionariesTest, TablesRoundTripThroughDictionaryCompressor) {
+    unittest::TempDir home("wt_zstd_dictionaries_test");
+    const auto docs = makeDocuments(2000);
+    auto dictionary = WiredTigerZstdDictionaries::train(docs, 16 * 1024);
+    ASSERT_OK(dictionary.getStatus());
+    ASSERT_GT(dictionary.getValue().size(), 0U);
+
+    auto conn = openConnection(home.path());
+    ASSERT_OK(WiredTigerZstdDictionaries::add(conn, "orders", dictionary.getValue()));
+    {
+        WT_SESSION* session;
+        ASSERT_OK(wtRCToStatus(conn->open_session(conn, nullptr, nullptr, &session)));
+        ASSERT_OK(wtRCToStatus(session->create(
+            session, kTableUri, "key_format=q,value_format=u,block_compressor=zstd_dict_orders")));
+        ASSERT_OK(wtRCToStatus(session->close(session, nullptr)));
+    }
+    insertDocuments(conn, docs);
+    closeConnection(conn);
+
+    // The dictionary is durable, so a new connection can read the table once its compressors
+    // have been registered.
+    conn = openConnection(home.path());
+    ASSERT_OK(WiredTigerZstdDictionaries::registerAll(conn));
+    assertDocuments(conn, docs);
+    closeConnection(conn);
+}
+
+TEST(WiredTigerZstdDictionariesTest, AddRejectsInvalidAndDuplicateNames) {
+    unittest::TempDir home("wt_zstd_dictionaries_test");
+    auto dictionary = WiredTigerZstdDictionaries::train(makeDocuments(2000), 16 * 1024);
+    ASSERT_OK(dictionary.getStatus());
+
+    auto conn = openConnection(home.path());
+    ASSERT_EQ(ErrorCodes::BadValue,
+              WiredTigerZstdDictionaries::add(conn, "", dictionary.getValue()));
+    ASSERT_EQ(ErrorCodes::BadValue,
+              WiredTigerZstdDictionaries::add(conn, "../orders", dictionary.getValue()));
+    ASSERT_OK(WiredTigerZstdDictionaries::add(conn, "orders", dictionary.getValue()));
+    ASSERT_EQ(ErrorCodes::BadValue,
+              WiredTigerZstdDictionaries::add(conn, "orders", dictionary.getValue()));
+    closeConnection(conn);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,189 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_zstd_dictionaries.h"
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+namespace {
+
+constexpr long long kDefaultSampleSize = 1000;
+constexpr long long kMaxSampleSize = 100000;
+constexpr long long kDefaultMaxDictionarySize = 110 * 1024;
+constexpr long long kMaxDictionarySize = 16 * 1024 * 1024;
+
+long long getOptionalLongField(const BSONObj& cmdObj,
+                               StringData fieldName,
+                               long long defaultValue,
+                               long long maxValue) {
+    auto elem = cmdObj[fieldName];
+    if (elem.eoo()) {
+        return defaultValue;
+    }
+    uassert(5021441,
+            str::stream() << "'" << fieldName << "' must be a number",
+            elem.isNumber());
+    auto value = elem.safeNumberLong();
+    uassert(5021442,
+            str::stream() << "'" << fieldName << "' must be between 1 and " << maxValue,
+            value > 0 && value <= maxValue);
+    return value;
+}
+
+/**
+ * Trains a zstd dictionary on a random sample of the documents of a collection and registers it
+ * as a WiredTiger block compressor, which collections created afterwards may select with
+ * "block_compressor=zstd_dict_<name>" in their WiredTiger 'configString':
+ *
+ * {
+ *     trainZstdDictionary: <collection>,
+ *     name: <dictionary name>,
+ *     sampleSize: <number of documents to sample, default 1000>,
+ *     maxDictionarySize: <bytes, default 110KB>
+ * }
+ *
+ * Dictionaries are local to the node which trained them and are not replicated. A collection
+ * using one can only be created on a node which has a dictionary of that name, and only as an
+ * unreplicated write on a replica set member, since the other members may lack the dictionary.
+ */
+class CmdTrainZstdDictionary : public BasicCommand {
+public:
+    CmdTrainZstdDictionary() : BasicCommand("trainZstdDictionary") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "train a zstd dictionary on a sample of a collection and register it as the "
+               "WiredTiger block compressor zstd_dict_<name>\n"
+               "{trainZstdDictionary: <collection>, name: <dictionary name>, "
+               "sampleSize: <documents>, maxDictionarySize: <bytes>}";
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        auto authSession = AuthorizationSession::get(client);
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+        if (!authSession->isAuthorizedForActionsOnResource(ResourcePattern::forExactNamespace(nss),
+                                                           ActionType::find) ||
+            !authSession->isAuthorizedForActionsOnResource(ResourcePattern::forClusterResource(),
+                                                           ActionType::setParameter)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+
+        auto nameElem = cmdObj["name"];
+        uassert(5021443, "'name' must be a string", nameElem.type() == String);
+        const auto name = nameElem.valueStringData();
+        const auto sampleSize =
+            getOptionalLongField(cmdObj, "sampleSize", kDefaultSampleSize, kMaxSampleSize);
+        const auto maxDictionarySize = getOptionalLongField(
+            cmdObj, "maxDictionarySize", kDefaultMaxDictionarySize, kMaxDictionarySize);
+
+        auto engine = dynamic_cast<WiredTigerKVEngine*>(
+            opCtx->getServiceContext()->getStorageEngine()->getEngine());
+        uassert(ErrorCodes::CommandNotSupported,
+                "trainZstdDictionary requires the WiredTiger storage engine",
+                engine);
+
+        std::vector<BSONObj> samples;
+        {
+            AutoGetCollectionForReadCommand autoColl(opCtx, nss);
+            auto collection = autoColl.getCollection();
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Collection " << nss << " does not exist",
+                    collection);
+
+            auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+            uassert(ErrorCodes::IllegalOperation,
+                    str::stream() << "Collection " << nss << " does not support random sampling",
+                    cursor);
+
+            samples.reserve(sampleSize);
+            while (static_cast<long long>(samples.size()) < sampleSize) {
+                auto record = cursor->next();
+                if (!record) {
+                    break;
+                }
+                samples.push_back(record->data.toBson().getOwned());
+            }
+        }
+        uassert(ErrorCodes::IllegalOperation,
+                str::stream() << "Collection " << nss << " is empty",
+                !samples.empty());
+
+        auto dictionary =
+            uassertStatusOK(WiredTigerZstdDictionaries::train(samples, maxDictionarySize));
+        uassertStatusOK(WiredTigerZstdDictionaries::add(engine->getConnection(), name, dictionary));
+
+        LOGV2(5021444,
+              "Trained zstd dictionary",
+              "dictionary"_attr = name,
+              "namespace"_attr = nss,
+              "sampleSize"_attr = samples.size(),
+              "dictionarySize"_attr = dictionary.size());
+
+        result.append("compressor", WiredTigerZstdDictionaries::compressorName(name));
+        result.append("sampleSize", static_cast<long long>(samples.size()));
+        result.append("dictionarySize", static_cast<long long>(dictionary.size()));
+        return true;
+    }
+} cmdTrainZstdDictionary;
+
+}  // namespace
+}  // namespace mongo
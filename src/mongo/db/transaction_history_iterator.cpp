@@ -38,6 +38,7 @@
 #include "mongo/db/query/query_request.h"
 #include "mongo/db/repl/local_oplog_info.h"
 #include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/transaction_history_iterator.h"
 #include "mongo/logv2/redaction.h"
 #include "mongo/util/str.h"
@@ -46,6 +47,47 @@ namespace mongo {
 
 namespace {
 
+/**
+ * Looks up the oplog entry with the given optime by seeking directly to its RecordId, avoiding
+ * the cost of planning a query for every link of a session's write history. Returns boost::none
+ * if the oplog's record store does not key its records by timestamp, in which case the caller
+ * must fall back to a query. Otherwise returns the entry, or an empty object if the oplog has no
+ * entry with that optime.
+ */
+boost::optional<BSONObj> seekOneOplogEntry(OperationContext* opCtx,
+                                           const Collection* oplog,
+                                           const repl::OpTime& opTime) {
+    if (!oplog) {
+        return boost::none;
+    }
+
+    auto goal = oploghack::keyForOptime(opTime.getTimestamp());
+    if (!goal.isOK()) {
+        return boost::none;
+    }
+
+    auto recordStore = oplog->getRecordStore();
+    auto startLoc = recordStore->oplogStartHack(opCtx, goal.getValue());
+    if (!startLoc) {
+        return boost::none;
+    }
+
+    RecordData record;
+    if (*startLoc != goal.getValue() || !recordStore->findRecord(opCtx, *startLoc, &record)) {
+        return BSONObj();
+    }
+
+    auto oplogBSON = record.releaseToBson().getOwned();
+
+    // An entry written at the same timestamp in a different term is not the one being sought.
+    auto entryOpTime = repl::OpTime::parseFromOplogEntry(oplogBSON);
+    if (!entryOpTime.isOK() || entryOpTime.getValue() != opTime) {
+        return BSONObj();
+    }
+
+    return oplogBSON;
+}
+
 /**
  * Query the oplog for an entry with the given timestamp.
  */
@@ -56,6 +98,26 @@ BSONObj findOneOplogEntry(OperationContext* opCtx,
     BSONObj oplogBSON;
     invariant(!opTime.isNull());
 
+    AutoGetOplog oplogRead(opCtx, OplogAccessMode::kRead);
+    const auto localDb = DatabaseHolder::get(opCtx)->getDb(opCtx, NamespaceString::kLocalDb);
+    invariant(localDb);
+    AutoStatsTracker statsTracker(
+        opCtx,
+        NamespaceString::kRsOplogNamespace,
+        Top::LockType::ReadLocked,
+        AutoStatsTracker::LogMode::kUpdateTop,
+        CollectionCatalog::get(opCtx).getDatabaseProfileLevel(NamespaceString::kLocalDb),
+        Date_t::max());
+
+    if (auto seekResult = seekOneOplogEntry(opCtx, oplogRead.getCollection(), opTime)) {
+        uassert(ErrorCodes::IncompleteTransactionHistory,
+                str::stream() << "oplog no longer contains the complete write history of this "
+                                 "transaction, log with opTime "
+                              << opTime.toBSON() << " cannot be found",
+                !seekResult->isEmpty());
+        return *seekResult;
+    }
+
     auto qr = std::make_unique<QueryRequest>(NamespaceString::kRsOplogNamespace);
     qr->setFilter(opTime.asQuery());
 
@@ -76,17 +138,6 @@ BSONObj findOneOplogEntry(OperationContext* opCtx,
                             << causedBy(statusWithCQ.getStatus()));
     std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
 
-    AutoGetOplog oplogRead(opCtx, OplogAccessMode::kRead);
-    const auto localDb = DatabaseHolder::get(opCtx)->getDb(opCtx, NamespaceString::kLocalDb);
-    invariant(localDb);
-    AutoStatsTracker statsTracker(
-        opCtx,
-        NamespaceString::kRsOplogNamespace,
-        Top::LockType::ReadLocked,
-        AutoStatsTracker::LogMode::kUpdateTop,
-        CollectionCatalog::get(opCtx).getDatabaseProfileLevel(NamespaceString::kLocalDb),
-        Date_t::max());
-
     auto exec = uassertStatusOK(
         getExecutorFind(opCtx, oplogRead.getCollection(), std::move(cq), permitYield));
 
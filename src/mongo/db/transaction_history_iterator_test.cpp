@@ -176,4 +176,16 @@ TEST_F(SessionHistoryIteratorTest, OplogInWriteHistoryChainWithMissingPrevTSShou
     ASSERT_THROWS_CODE(iter.next(opCtx()), AssertionException, ErrorCodes::FailedToParse);
 }
 
+TEST_F(SessionHistoryIteratorTest, NextShouldAssertIfEntryAtTimestampHasDifferentTerm) {
+    auto entry = makeOplogEntry(repl::OpTime(Timestamp(67, 54801), 2),  // optime
+                                BSON("y" << 50),                        // o
+                                repl::OpTime());  // optime of previous write in transaction
+    insertOplogEntry(entry);
+
+    TransactionHistoryIterator iter(repl::OpTime(Timestamp(67, 54801), 1));
+    ASSERT_TRUE(iter.hasNext());
+    ASSERT_THROWS_CODE(
+        iter.next(opCtx()), AssertionException, ErrorCodes::IncompleteTransactionHistory);
+}
+
 }  // namespace mongo
@@ -33,6 +33,8 @@
 
 #include "mongo/db/ttl.h"
 
+#include <utility>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -71,9 +73,11 @@ const auto getTTLMonitor = ServiceContext::declareDecoration<std::unique_ptr<TTL
 MONGO_FAIL_POINT_DEFINE(hangTTLMonitorWithLock);
 
 Counter64 ttlPasses;
+Counter64 ttlSubPasses;
 Counter64 ttlDeletedDocuments;
 
 ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
+ServerStatusMetricField<Counter64> ttlSubPassesDisplay("ttl.subPasses", &ttlSubPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
 
@@ -109,10 +113,17 @@ public:
             tc.get()->setSystemOperationKillable(lk);
         }
 
+        // Set when the last pass stopped deleting from some TTL index before it ran out of
+        // expired documents, in which case the next pass continues after a short wait.
+        bool moreWork = false;
+
         while (true) {
             {
-                // Wait until either ttlMonitorSleepSecs passes or a shutdown is requested.
-                auto deadline = Date_t::now() + Seconds(ttlMonitorSleepSecs.load());
+                // Wait until either ttlMonitorSleepSecs passes or a shutdown is requested. If the
+                // last pass left expired documents behind, only wait ttlMonitorSubPassSleepMillis.
+                auto deadline = Date_t::now() +
+                    (moreWork ? Milliseconds(ttlMonitorSubPassSleepMillis.load())
+                              : Milliseconds(Seconds(ttlMonitorSleepSecs.load())));
                 stdx::unique_lock<Latch> lk(_stateMutex);
 
                 MONGO_IDLE_THREAD_BLOCK;
@@ -126,6 +137,8 @@ public:
 
             LOGV2_DEBUG(22528, 3, "thread awake");
 
+            const bool isSubPass = std::exchange(moreWork, false);
+
             if (!ttlMonitorEnabled.load()) {
                 LOGV2_DEBUG(22529, 1, "disabled");
                 continue;
@@ -139,7 +152,7 @@ public:
             }
 
             try {
-                doTTLPass();
+                moreWork = doTTLPass(isSubPass);
             } catch (const WriteConflictException&) {
                 LOGV2_DEBUG(22531, 1, "got WriteConflictException");
             } catch (const ExceptionForCat<ErrorCategory::Interruption>& interruption) {
@@ -167,9 +180,11 @@ public:
 
 private:
     /**
-     * Gets all TTL indexes from every collection and performs doTTLForIndex().
+     * Gets all TTL indexes from every collection and performs doTTLForIndex(). Returns true if any
+     * index still had expired documents when its deletions were cut off by
+     * ttlIndexDeleteTargetDocs. A pass which continues such a pass is counted as a sub-pass.
      */
-    void doTTLPass() {
+    bool doTTLPass(bool isSubPass) {
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
@@ -177,7 +192,7 @@ private:
         if (repl::ReplicationCoordinator::get(&opCtx)->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
             !repl::ReplicationCoordinator::get(&opCtx)->getMemberState().readable())
-            return;
+            return false;
 
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::pair<UUID, std::string>> ttlInfos = ttlCollectionCache.getTTLInfos();
@@ -185,7 +200,10 @@ private:
         // Pair of collection namespace and index spec.
         std::vector<std::pair<NamespaceString, BSONObj>> ttlIndexes;
 
-        ttlPasses.increment();
+        if (!isSubPass) {
+            ttlPasses.increment();
+        }
+        ttlSubPasses.increment();
 
         // Get all TTL indexes from every collection.
         for (const std::pair<UUID, std::string>& ttlInfo : ttlInfos) {
@@ -233,16 +251,17 @@ private:
             ttlIndexes.push_back(std::make_pair(*nss, spec.getOwned()));
         }
 
+        bool moreWork = false;
         for (const auto& it : ttlIndexes) {
             try {
-                doTTLForIndex(&opCtx, it.first, it.second);
+                moreWork |= doTTLForIndex(&opCtx, it.first, it.second);
             } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
                 LOGV2_WARNING(22537,
                               "TTLMonitor was interrupted, waiting {ttlMonitorSleepSecs_load} "
                               "seconds before doing another pass",
                               "TTLMonitor was interrupted, waiting before doing another pass",
                               "wait"_attr = Milliseconds(Seconds(ttlMonitorSleepSecs.load())));
-                return;
+                return false;
             } catch (const DBException& dbex) {
                 LOGV2_ERROR(22538,
                             "Error processing ttl index: {it_second} -- {dbex}",
@@ -253,15 +272,18 @@ private:
                 continue;
             }
         }
+        return moreWork;
     }
 
     /**
      * Removes documents from the collection using the specified TTL index after a sufficient amount
-     * of time has passed according to its expiry specification.
+     * of time has passed according to its expiry specification. Deletes at most
+     * ttlIndexDeleteTargetDocs documents, in index key order, and returns true if it stopped
+     * because of that limit.
      */
-    void doTTLForIndex(OperationContext* opCtx, NamespaceString collectionNSS, BSONObj idx) {
+    bool doTTLForIndex(OperationContext* opCtx, NamespaceString collectionNSS, BSONObj idx) {
         if (collectionNSS.isDropPendingNamespace()) {
-            return;
+            return false;
         }
         if (!userAllowedWriteNS(collectionNSS).isOK()) {
             LOGV2_ERROR(
@@ -270,7 +292,7 @@ private:
                 "Namespace doesn't allow deletes, skipping TTL job",
                 logAttrs(collectionNSS),
                 "index"_attr = idx);
-            return;
+            return false;
         }
 
         const BSONObj key = idx["key"].Obj();
@@ -280,7 +302,7 @@ private:
                         "key for ttl index can only have 1 field, skipping ttl job for: {index}",
                         "Key for ttl index can only have 1 field, skipping TTL job",
                         "index"_attr = idx);
-            return;
+            return false;
         }
 
         LOGV2_DEBUG(22533,
@@ -300,11 +322,11 @@ private:
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return false;
         }
 
         if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return false;
         }
 
         const IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
@@ -314,7 +336,7 @@ private:
                         "index not found (index build in progress? index dropped?), skipping ttl "
                         "job for: {idx}",
                         "idx"_attr = idx);
-            return;
+            return false;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition changed
@@ -326,7 +348,7 @@ private:
                         "special index can't be used as a ttl index, skipping ttl job for: {index}",
                         "Special index can't be used as a TTL index, skipping TTL job",
                         "index"_attr = idx);
-            return;
+            return false;
         }
 
         BSONElement secondsExpireElt = idx[IndexDescriptor::kExpireAfterSecondsFieldName];
@@ -338,7 +360,7 @@ private:
                         "field"_attr = IndexDescriptor::kExpireAfterSecondsFieldName,
                         "type"_attr = typeName(secondsExpireElt.type()),
                         "index"_attr = idx);
-            return;
+            return false;
         }
 
         const Date_t kDawnOfTime =
@@ -363,8 +385,10 @@ private:
         auto canonicalQuery = CanonicalQuery::canonicalize(opCtx, std::move(qr));
         invariant(canonicalQuery.getStatus());
 
+        const long long deleteLimit = ttlIndexDeleteTargetDocs.load();
         auto params = std::make_unique<DeleteStageParams>();
         params->isMulti = true;
+        params->limit = deleteLimit;
         params->canonicalQuery = canonicalQuery.getValue().get();
 
         auto exec =
@@ -383,19 +407,20 @@ private:
         } catch (const ExceptionFor<ErrorCodes::QueryPlanKilled>&) {
             // It is expected that a collection drop can kill a query plan while the TTL monitor is
             // deleting an old document, so ignore this error.
-            return;
+            return false;
         } catch (const DBException& exception) {
             LOGV2_WARNING(22543,
                           "ttl query execution for index {index} failed with status: {error}",
                           "TTL query execution failed",
                           "index"_attr = idx,
                           "error"_attr = redact(exception.toStatus()));
-            return;
+            return false;
         }
 
         const long long numDeleted = DeleteStage::getNumDeleted(*exec);
         ttlDeletedDocuments.increment(numDeleted);
         LOGV2_DEBUG(22536, 1, "deleted: {numDeleted}", "numDeleted"_attr = numDeleted);
+        return numDeleted >= deleteLimit;
     }
 
     // Protects the state below.
@@ -31,6 +31,8 @@
 
 #include "mongo/db/update/addtoset_node.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/db/query/collation/collator_interface.h"
 
@@ -60,6 +62,21 @@ void deduplicate(std::vector<BSONElement>& elements, const CollatorInterface* co
     }
 }
 
+/**
+ * Returns whether any element of 'array' compares equal to 'elem' using 'collator'.
+ */
+bool arrayContains(const mutablebson::Element& array,
+                   const BSONElement& elem,
+                   const CollatorInterface* collator) {
+    for (auto existingElem = array.leftChild(); existingElem.ok();
+         existingElem = existingElem.rightSibling()) {
+        if (existingElem.compareWithBSONElement(elem, collator, false) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 }  // namespace
 
 Status AddToSetNode::init(BSONElement modExpr,
@@ -114,16 +131,38 @@ ModifierNode::ModifyResult AddToSetNode::updateExistingElement(
 
     // Find the set of elements that do not already exist in the array 'element'.
     std::vector<BSONElement> elementsToAdd;
-    for (auto&& elem : _elements) {
-        auto shouldAdd = true;
+    if (_elements.size() == 1) {
+        // With a single candidate, a scan that stops at the first match does no more work than
+        // hashing every existing element would.
+        if (!arrayContains(*element, _elements.front(), _collator)) {
+            elementsToAdd.push_back(_elements.front());
+        }
+    } else {
+        // Index the existing array by value so that each candidate is looked up in constant time.
+        // The collation-aware hash keeps this consistent with compareWithBSONElement(). Elements
+        // without a serialized value can only be compared one by one.
+        BSONElementComparator eltCmp(BSONElementComparator::FieldNamesMode::kIgnore, _collator);
+        auto existingValues = eltCmp.makeBSONEltUnorderedSet();
+        std::vector<mutablebson::ConstElement> existingWithoutValue;
         for (auto existingElem = element->leftChild(); existingElem.ok();
              existingElem = existingElem.rightSibling()) {
-            if (existingElem.compareWithBSONElement(elem, _collator, false) == 0) {
-                shouldAdd = false;
-                break;
+            if (existingElem.hasValue()) {
+                existingValues.insert(existingElem.getValue());
+            } else {
+                existingWithoutValue.push_back(existingElem);
             }
         }
-        if (shouldAdd) {
+
+        for (auto&& elem : _elements) {
+            if (existingValues.count(elem) > 0 ||
+                std::any_of(existingWithoutValue.begin(),
+                            existingWithoutValue.end(),
+                            [&](const auto& existingElem) {
+                                return existingElem.compareWithBSONElement(
+                                           elem, _collator, false) == 0;
+                            })) {
+                continue;
+            }
             elementsToAdd.push_back(elem);
         }
     }
@@ -361,6 +361,39 @@ TEST_F(AddToSetNodeTest, ApplyComparisonToExistingElementsRespectsCollation) {
     ASSERT_EQUALS(getModifiedPaths(), "{a}");
 }
 
+TEST_F(AddToSetNodeTest, ApplyEachComparesNumericValuesOfDifferentTypes) {
+    auto update = fromjson("{$addToSet: {a: {$each: [1, 2.0, NumberLong(3), {b: 4}]}}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    AddToSetNode node;
+    ASSERT_OK(node.init(update["$addToSet"]["a"], expCtx));
+
+    mutablebson::Document doc(fromjson("{a: [1.0, NumberDecimal('2'), {b: NumberLong(4)}]}"));
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]), getUpdateNodeApplyParams());
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [1.0, NumberDecimal('2'), {b: NumberLong(4)}, NumberLong(3)]}"),
+                  doc);
+}
+
+TEST_F(AddToSetNodeTest, ApplyEachComparesToElementsWithoutSerializedValue) {
+    auto update = fromjson("{$addToSet: {a: {$each: [{b: 1}, 2]}}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    AddToSetNode node;
+    ASSERT_OK(node.init(update["$addToSet"]["a"], expCtx));
+
+    // An object built through the mutable BSON API has no serialized value to hash.
+    mutablebson::Document doc(fromjson("{a: [3]}"));
+    auto obj = doc.makeElementObject("");
+    ASSERT_OK(obj.appendInt("b", 1));
+    ASSERT_OK(doc.root()["a"].pushBack(obj));
+    ASSERT_FALSE(doc.root()["a"].rightChild().hasValue());
+
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]), getUpdateNodeApplyParams());
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [3, {b: 1}, 2]}"), doc);
+}
+
 TEST_F(AddToSetNodeTest, ApplyRespectsCollationFromSetCollator) {
     auto update = fromjson("{$addToSet: {a: {$each: ['abc', 'ABC', 'def', 'abc']}}}");
     boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
@@ -31,6 +31,9 @@
 
 #include "mongo/db/update/pullall_node.h"
 
+#include <algorithm>
+
+#include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/query/collation/collator_interface.h"
 
@@ -39,13 +42,20 @@ namespace mongo {
 class PullAllNode::SetMatcher final : public ArrayCullingNode::ElementMatcher {
 public:
     SetMatcher(std::vector<BSONElement> elementsToMatch, const CollatorInterface* collator)
-        : _elementsToMatch(std::move(elementsToMatch)), _collator(collator) {}
+        : _elementsToMatch(std::move(elementsToMatch)) {
+        setCollator(collator);
+    }
 
     std::unique_ptr<ElementMatcher> clone() const final {
-        return std::make_unique<SetMatcher>(*this);
+        // '_elementSet' refers to this matcher's own comparator, so it has to be rebuilt rather
+        // than copied.
+        return std::make_unique<SetMatcher>(_elementsToMatch, _collator);
     }
 
     bool match(const mutablebson::ConstElement& element) final {
+        if (element.hasValue()) {
+            return _elementSet->count(element.getValue()) > 0;
+        }
         return std::any_of(_elementsToMatch.begin(),
                            _elementsToMatch.end(),
                            [&element, collator{_collator}](const auto& elementToMatch) {
@@ -56,6 +66,14 @@ public:
 
     void setCollator(const CollatorInterface* collator) final {
         _collator = collator;
+
+        // Hash the elements to match so that culling an array costs one lookup per array element.
+        // The collation-aware hash keeps lookups consistent with compareWithBSONElement().
+        _elementSet.reset();
+        _comparator = std::make_unique<BSONElementComparator>(
+            BSONElementComparator::FieldNamesMode::kIgnore, _collator);
+        _elementSet = std::make_unique<BSONEltUnorderedSet>(_comparator->makeBSONEltUnorderedSet());
+        _elementSet->insert(_elementsToMatch.begin(), _elementsToMatch.end());
     }
 
 private:
@@ -70,7 +88,9 @@ private:
     }
 
     std::vector<BSONElement> _elementsToMatch;
-    const CollatorInterface* _collator;
+    const CollatorInterface* _collator = nullptr;
+    std::unique_ptr<BSONElementComparator> _comparator;
+    std::unique_ptr<BSONEltUnorderedSet> _elementSet;
 };
 
 Status PullAllNode::init(BSONElement modExpr,
@@ -272,6 +272,56 @@ TEST_F(PullAllNodeTest, ApplyWithCollator) {
     ASSERT_EQUALS(fromjson("{$set: {a: ['baz']}}"), getLogDoc());
 }
 
+TEST_F(PullAllNodeTest, ApplyMatchesNumericValuesOfDifferentTypes) {
+    auto update = fromjson("{$pullAll : {a: [1, 2.0, {b: NumberLong(3)}]}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    PullAllNode node;
+    ASSERT_OK(node.init(update["$pullAll"]["a"], expCtx));
+
+    mutablebson::Document doc(
+        fromjson("{a: [1.0, NumberLong(2), {b: 3}, NumberDecimal('1'), {b: 3, c: 1}, 4]}"));
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]), getUpdateNodeApplyParams());
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [{b: 3, c: 1}, 4]}"), doc);
+}
+
+TEST_F(PullAllNodeTest, ApplyMatchesElementsWithoutSerializedValue) {
+    auto update = fromjson("{$pullAll : {a: [{b: 1}, 2]}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    PullAllNode node;
+    ASSERT_OK(node.init(update["$pullAll"]["a"], expCtx));
+
+    // An object built through the mutable BSON API has no serialized value to hash.
+    mutablebson::Document doc(fromjson("{a: [2, 3]}"));
+    auto obj = doc.makeElementObject("");
+    ASSERT_OK(obj.appendInt("b", 1));
+    ASSERT_OK(doc.root()["a"].pushBack(obj));
+    ASSERT_FALSE(doc.root()["a"].rightChild().hasValue());
+
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]), getUpdateNodeApplyParams());
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [3]}"), doc);
+}
+
+TEST_F(PullAllNodeTest, ApplyWithCollatorAfterClone) {
+    auto update = fromjson("{$pullAll : {a: ['FOO', 'BAR']}}");
+    auto collator =
+        std::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kToLowerString);
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->setCollator(std::move(collator));
+    PullAllNode node;
+    ASSERT_OK(node.init(update["$pullAll"]["a"], expCtx));
+    auto cloned = node.clone();
+
+    mutablebson::Document doc(fromjson("{a: ['foo', 'bar', 'baz']}"));
+    setPathTaken("a");
+    auto result = cloned->apply(getApplyParams(doc.root()["a"]), getUpdateNodeApplyParams());
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: ['baz']}"), doc);
+}
+
 TEST_F(PullAllNodeTest, ApplyAfterSetCollator) {
     auto update = fromjson("{$pullAll : {a: ['FOO', 'BAR']}}");
     boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
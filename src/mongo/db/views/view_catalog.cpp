@@ -101,6 +101,7 @@ Status ViewCatalog::_reload(WithLock,
                 "db"_attr = _durable->getName());
 
     _viewMap.clear();
+    _resolvedViews.clear();
     _valid = false;
     _viewGraphNeedsRefresh = true;
 
@@ -157,6 +158,7 @@ void ViewCatalog::clear() {
     stdx::unique_lock<Latch> lk(_mutex);
 
     _viewMap.clear();
+    _resolvedViews.clear();
     _viewGraph.clear();
     _valid = true;
     _viewGraphNeedsRefresh = false;
@@ -225,6 +227,7 @@ Status ViewCatalog::_createOrUpdateView(WithLock lk,
 
     _durable->upsert(opCtx, viewName, viewDefBuilder.obj());
     _viewMap[viewName.ns()] = view;
+    _resolvedViews.clear();
 
     // Register the view in the CollectionCatalog mapping from ResourceID->namespace
     CollectionCatalog& catalog = CollectionCatalog::get(opCtx);
@@ -233,6 +236,7 @@ Status ViewCatalog::_createOrUpdateView(WithLock lk,
 
     opCtx->recoveryUnit()->onRollback([this, viewName, opCtx, viewRid]() {
         this->_viewMap.erase(viewName.ns());
+        this->_resolvedViews.clear();
         this->_viewGraphNeedsRefresh = true;
         CollectionCatalog& catalog = CollectionCatalog::get(opCtx);
         catalog.removeResource(viewRid, viewName.ns());
@@ -464,6 +468,7 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
 
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition, opCtx]() {
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_resolvedViews.clear();
         auto viewRid = ResourceId(RESOURCE_COLLECTION, viewName.ns());
         CollectionCatalog& catalog = CollectionCatalog::get(opCtx);
         catalog.addResource(viewRid, viewName.ns());
@@ -504,6 +509,7 @@ Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& vie
     _durable->remove(opCtx, viewName);
     _viewGraph.remove(savedDefinition.name());
     _viewMap.erase(viewName.ns());
+    _resolvedViews.clear();
 
     CollectionCatalog& catalog = CollectionCatalog::get(opCtx);
     auto viewRid = ResourceId(RESOURCE_COLLECTION, viewName.ns());
@@ -512,6 +518,7 @@ Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& vie
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition, opCtx, viewRid]() {
         this->_viewGraphNeedsRefresh = true;
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_resolvedViews.clear();
         CollectionCatalog& catalog = CollectionCatalog::get(opCtx);
         catalog.addResource(viewRid, viewName.ns());
     });
@@ -572,6 +579,11 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
 
     _requireValidCatalog(lock);
 
+    auto cachedIt = _resolvedViews.find(nss.ns());
+    if (cachedIt != _resolvedViews.end()) {
+        return cachedIt->second;
+    }
+
     // Keep looping until the resolution completes. If the catalog is invalidated during the
     // resolution, we start over from the beginning.
     while (true) {
@@ -604,10 +616,14 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                             str::stream() << "View pipeline exceeds maximum size; maximum size is "
                                           << ViewGraph::kMaxViewPipelineSizeBytes};
                 }
-                return StatusWith<ResolvedView>(
-                    {*resolvedNss,
-                     std::move(resolvedPipeline),
-                     collation ? std::move(collation.get()) : CollationSpec::kSimpleSpec});
+                ResolvedView resolved(
+                    *resolvedNss,
+                    std::move(resolvedPipeline),
+                    collation ? std::move(collation.get()) : CollationSpec::kSimpleSpec);
+                if (depth > 0) {
+                    _resolvedViews.emplace(nss.ns(), resolved);
+                }
+                return std::move(resolved);
             }
 
             resolvedNss = &view->viewOn();
@@ -622,8 +638,10 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
 
             // If the first stage is a $collStats, then we return early with the viewOn namespace.
             if (toPrepend.size() > 0 && !toPrepend[0]["$collStats"].eoo()) {
-                return StatusWith<ResolvedView>(
-                    {*resolvedNss, std::move(resolvedPipeline), std::move(collation.get())});
+                ResolvedView resolved(
+                    *resolvedNss, std::move(resolvedPipeline), std::move(collation.get()));
+                _resolvedViews.emplace(nss.ns(), resolved);
+                return std::move(resolved);
             }
         }
 
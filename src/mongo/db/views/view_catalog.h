@@ -132,6 +132,8 @@ public:
      * Resolve the views on 'nss', transforming the pipeline appropriately. This function returns a
      * fully-resolved view definition containing the backing namespace, the resolved pipeline and
      * the collation to use for the operation.
+     *
+     * Successful resolutions of views are cached until the next change to the view catalog.
      */
     StatusWith<ResolvedView> resolveView(OperationContext* opCtx, const NamespaceString& nss);
 
@@ -202,6 +204,11 @@ private:
     Mutex _mutex = MONGO_MAKE_LATCH("ViewCatalog::_mutex");  // Protects all members.
     ViewMap _viewMap;
     ViewMap _viewMapBackup;
+
+    // Fully resolved definitions of the views which have been resolved since the last change to
+    // '_viewMap', keyed by view namespace. Must be cleared whenever '_viewMap' changes.
+    StringMap<ResolvedView> _resolvedViews;
+
     std::unique_ptr<DurableViewCatalog> _durable;
     bool _valid;
     ViewGraph _viewGraph;
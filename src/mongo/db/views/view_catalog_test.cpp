@@ -673,6 +673,46 @@ TEST_F(ViewCatalogFixture, ResolveViewCorrectPipeline) {
     }
 }
 
+TEST_F(ViewCatalogFixture, ResolveViewReflectsChangesToUnderlyingViews) {
+    const NamespaceString view1("db.view1");
+    const NamespaceString view2("db.view2");
+    const NamespaceString viewOn("db.coll");
+    BSONArrayBuilder pipeline1;
+    BSONArrayBuilder pipeline2;
+    BSONArrayBuilder modifiedPipeline1;
+
+    pipeline1 << BSON("$match" << BSON("foo" << 1));
+    pipeline2 << BSON("$match" << BSON("foo" << 2));
+    modifiedPipeline1 << BSON("$match" << BSON("foo" << 3));
+
+    ASSERT_OK(createView(operationContext(), view1, viewOn, pipeline1.arr(), emptyCollation));
+    ASSERT_OK(createView(operationContext(), view2, view1, pipeline2.arr(), emptyCollation));
+
+    auto resolve = [&] {
+        Lock::DBLock dbLock(operationContext(), "db", MODE_IS);
+        return uassertStatusOK(getViewCatalog()->resolveView(operationContext(), view2));
+    };
+
+    // Resolve twice so that the second resolution is served from the cache.
+    ASSERT_EQ(resolve().getPipeline().size(), 2U);
+    auto resolvedView = resolve();
+    ASSERT_EQ(resolvedView.getNamespace(), viewOn);
+    ASSERT_EQ(resolvedView.getPipeline().size(), 2U);
+    ASSERT_BSONOBJ_EQ(resolvedView.getPipeline()[0], BSON("$match" << BSON("foo" << 1)));
+
+    ASSERT_OK(modifyView(operationContext(), view1, viewOn, modifiedPipeline1.arr()));
+    resolvedView = resolve();
+    ASSERT_EQ(resolvedView.getPipeline().size(), 2U);
+    ASSERT_BSONOBJ_EQ(resolvedView.getPipeline()[0], BSON("$match" << BSON("foo" << 3)));
+    ASSERT_BSONOBJ_EQ(resolvedView.getPipeline()[1], BSON("$match" << BSON("foo" << 2)));
+
+    ASSERT_OK(dropView(operationContext(), view1));
+    resolvedView = resolve();
+    ASSERT_EQ(resolvedView.getNamespace(), view1);
+    ASSERT_EQ(resolvedView.getPipeline().size(), 1U);
+    ASSERT_BSONOBJ_EQ(resolvedView.getPipeline()[0], BSON("$match" << BSON("foo" << 2)));
+}
+
 TEST_F(ViewCatalogFixture, ResolveViewOnCollectionNamespace) {
     const NamespaceString collectionNamespace("db.coll");
 
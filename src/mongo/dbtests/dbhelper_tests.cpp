@@ -36,6 +36,7 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/dbhelpers.h"
+#include "mongo/db/query/query_request.h"
 #include "mongo/db/range_arithmetic.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/dbtests/dbtests.h"
@@ -88,11 +89,39 @@ private:
     int _max;
 };
 
+/** Helpers::findAll returns every matching document in the requested order. */
+class FindAll {
+public:
+    void run() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        DBDirectClient client(&opCtx);
+        client.dropCollection(ns);
+        for (int i = 0; i < 10; ++i) {
+            client.insert(ns, BSON("_id" << i << "even" << (i % 2 == 0)));
+        }
+
+        auto qr = std::make_unique<QueryRequest>(NamespaceString(ns));
+        qr->setFilter(BSON("even" << true));
+        qr->setSort(BSON("_id" << -1));
+        auto docs = Helpers::findAll(&opCtx, std::move(qr));
+        ASSERT_EQUALS(5U, docs.size());
+        for (size_t i = 0; i < docs.size(); ++i) {
+            ASSERT_BSONOBJ_EQ(BSON("_id" << static_cast<int>(8 - 2 * i) << "even" << true),
+                              docs[i]);
+        }
+
+        auto missing = std::make_unique<QueryRequest>(NamespaceString("unittests.missing"));
+        ASSERT(Helpers::findAll(&opCtx, std::move(missing)).empty());
+    }
+};
+
 class All : public OldStyleSuiteSpecification {
 public:
     All() : OldStyleSuiteSpecification("remove") {}
     void setupTests() {
         add<RemoveRange>();
+        add<FindAll>();
     }
 };
 
@@ -711,6 +711,10 @@ TEST(FromJsonTest, EscapedCharacters) {
         {R"({ "a" : "\% \{ \a \z \$ \# \' \ " })",
          B().append("a", "% { a z $ # '  ").obj()},               // NonEscapedCharacters
         {"{ \"a\" : \"\x7f\" }", B().append("a", "\x7f").obj()},  // AllowedControlCharacter
+        {R"({ "a" : "leading run\tmiddle \"run\"\u0041trailing run" })",
+         B().append("a", "leading run\tmiddle \"run\"Atrailing run").obj()},  // EscapesBetweenRuns
+        {R"({ 'a' : 'single "quoted" run' })",
+         B().append("a", "single \"quoted\" run").obj()},  // SingleQuotedRun
     });
     checkRejectionEach({
         "{ \"a\" : \"\x1f\" }",  // InvalidControlCharacter
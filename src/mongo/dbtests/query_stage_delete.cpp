@@ -253,6 +253,48 @@ public:
     }
 };
 
+/**
+ * Test that a multi delete with a limit stops once it has deleted that many documents.
+ */
+class QueryStageDeleteLimit : public QueryStageDeleteBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        Collection* coll = ctx.getCollection();
+        ASSERT(coll);
+
+        CollectionScanParams collScanParams;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        const long long limit = 10;
+        auto deleteStageParams = std::make_unique<DeleteStageParams>();
+        deleteStageParams->isMulti = true;
+        deleteStageParams->limit = limit;
+
+        WorkingSet ws;
+        DeleteStage deleteStage(
+            _expCtx.get(),
+            std::move(deleteStageParams),
+            &ws,
+            coll,
+            new CollectionScan(_expCtx.get(), coll, collScanParams, &ws, nullptr));
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            invariant(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+
+        ASSERT_EQUALS(static_cast<size_t>(limit), stats->docsDeleted);
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+        ASSERT_EQUALS(numObj() - limit, recordIds.size());
+    }
+};
+
 class All : public OldStyleSuiteSpecification {
 public:
     All() : OldStyleSuiteSpecification("query_stage_delete") {}
@@ -261,6 +303,7 @@ public:
         // Stage-specific tests below.
         add<QueryStageDeleteUpcomingObjectWasDeleted>();
         add<QueryStageDeleteReturnOldDoc>();
+        add<QueryStageDeleteLimit>();
     }
 };
 
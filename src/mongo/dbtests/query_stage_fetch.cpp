@@ -34,6 +34,7 @@
 #include "mongo/platform/basic.h"
 
 #include <memory>
+#include <vector>
 
 #include "mongo/client/dbclient_cursor.h"
 #include "mongo/db/catalog/collection.h"
@@ -226,6 +227,66 @@ public:
     }
 };
 
+//
+// Test that a batched fetch returns each batch of its child in RecordId order.
+//
+class FetchStageRecordIdBatches : public QueryStageFetchBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll =
+            CollectionCatalog::get(&_opCtx).lookupCollectionByNamespace(&_opCtx, nss());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        for (int i = 0; i < 5; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(5), recordIds.size());
+
+        // Return the records in reverse RecordId order, with a NEED_TIME in the first batch.
+        auto mockStage = std::make_unique<QueuedDataStage>(_expCtx.get(), &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            ws.get(id)->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+            if (it == recordIds.rbegin()) {
+                mockStage->pushBack(PlanStage::NEED_TIME);
+            }
+        }
+
+        auto fetchStage = std::make_unique<FetchStage>(
+            _expCtx.get(), &ws, std::move(mockStage), nullptr, coll, 3);
+
+        std::vector<RecordId> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while ((state = fetchStage->work(&id)) != PlanStage::IS_EOF) {
+            if (PlanStage::ADVANCED == state) {
+                ASSERT_TRUE(ws.get(id)->hasObj());
+                results.push_back(ws.get(id)->recordId);
+            }
+        }
+
+        // The first batch holds the three largest RecordIds and the second the two smallest.
+        std::vector<RecordId> all(recordIds.begin(), recordIds.end());
+        std::vector<RecordId> expected{all[2], all[3], all[4], all[0], all[1]};
+        ASSERT(expected == results);
+
+        auto stats = static_cast<const FetchStats*>(fetchStage->getSpecificStats());
+        ASSERT_EQUALS(size_t(2), stats->recordIdBatches);
+    }
+};
+
 class All : public OldStyleSuiteSpecification {
 public:
     All() : OldStyleSuiteSpecification("query_stage_fetch") {}
@@ -233,6 +294,7 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStageRecordIdBatches>();
     }
 };
 
@@ -76,6 +76,7 @@
 #include "mongo/util/periodic_runner_factory.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 #include <boost/filesystem.hpp>
 
@@ -191,11 +192,16 @@ void shutdown(ServiceContext* srvContext) {
 ServiceContext* initialize(const char* yaml_config) {
     srand(static_cast<unsigned>(curTimeMicros64()));
 
+    // Cold start time matters for embedding applications, so time each phase of startup to make
+    // regressions visible in the startup log.
+    Timer startupTimer;
+
     if (yaml_config)
         embedded::EmbeddedOptionsConfig::instance().set(yaml_config);
 
     Status status = mongo::runGlobalInitializers(std::vector<std::string>{});
     uassertStatusOKWithContext(status, "Global initilization failed");
+    const auto globalInitializersMillis = startupTimer.millis();
     auto giGuard = makeGuard([] { mongo::runGlobalDeinitializers().ignore(); });
     setGlobalServiceContext(ServiceContext::make());
 
@@ -235,11 +241,13 @@ ServiceContext* initialize(const char* yaml_config) {
         serviceContext, serviceContext->getPreciseClockSource());
     serviceContext->setPeriodicRunner(std::move(periodicRunner));
 
+    Timer storageEngineTimer;
     setUpCatalog(serviceContext);
     auto lastStorageEngineShutdownState =
         initializeStorageEngine(serviceContext, StorageEngineInitFlags::kAllowNoLockFile);
     invariant(LastStorageEngineShutdownState::kClean == lastStorageEngineShutdownState);
     StorageControl::startStorageControls(serviceContext);
+    const auto storageEngineStartupMillis = storageEngineTimer.millis();
 
     // Warn if we detect configurations for multiple registered storage engines in the same
     // configuration file/environment.
@@ -282,6 +290,7 @@ ServiceContext* initialize(const char* yaml_config) {
 
     auto startupOpCtx = serviceContext->makeOperationContext(&cc());
 
+    Timer recoveryTimer;
     bool canCallFCVSetIfCleanStartup =
         !storageGlobalParams.readOnly && !(storageGlobalParams.engine == "devnull");
     if (canCallFCVSetIfCleanStartup) {
@@ -304,6 +313,7 @@ ServiceContext* initialize(const char* yaml_config) {
     // Ensure FCV document exists and is initialized in-memory. Fatally asserts if there is an
     // error.
     FeatureCompatibilityVersion::fassertInitializedAfterStartup(startupOpCtx.get());
+    const auto recoveryMillis = recoveryTimer.millis();
 
     if (storageGlobalParams.upgrade) {
         LOGV2(22553, "finished checking dbs");
@@ -328,6 +338,14 @@ ServiceContext* initialize(const char* yaml_config) {
 
     serviceContext->notifyStartupComplete();
 
+    LOGV2_OPTIONS(4798621,
+                  {LogComponent::kControl},
+                  "Embedded startup complete",
+                  "globalInitializersMillis"_attr = globalInitializersMillis,
+                  "storageEngineStartupMillis"_attr = storageEngineStartupMillis,
+                  "recoveryMillis"_attr = recoveryMillis,
+                  "durationMillis"_attr = startupTimer.millis());
+
     // Init succeeded, no need for global deinit.
     giGuard.dismiss();
 
@@ -226,7 +226,8 @@ class ConnectionPool::SpecificPool final
 
 public:
     /**
-     * Whenever a function enters a specific pool, the function needs to be guarded by the lock.
+     * Whenever a function enters a specific pool, the function needs to be guarded by the pool's
+     * lock.
      *
      * This callback also (perhaps overly aggressively) binds a shared pointer to the guard.
      * It is *always* safe to reference the original specific pool in the guarded function object.
@@ -241,7 +242,7 @@ public:
     auto guardCallback(Callback&& cb) {
         return
             [this, cb = std::forward<Callback>(cb), anchor = shared_from_this()](auto&&... args) {
-                stdx::lock_guard lk(_parent->_mutex);
+                stdx::lock_guard lk(_mutex);
                 cb(std::forward<decltype(args)>(args)...);
                 updateState();
             };
@@ -268,16 +269,30 @@ public:
     void updateState();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Gets a connection from the specific pool. The caller must hold the pool's lock.
      */
     Future<ConnectionHandle> getConnection(Milliseconds timeout);
 
+    /**
+     * Returns the lock that guards the state of this pool. When both are needed, it must be taken
+     * after the parent's lock.
+     */
+    Mutex& mutex() const {
+        return _mutex;
+    }
+
+    /**
+     * Returns true once the pool has been removed from its parent.
+     */
+    bool isShutdown() const {
+        return _health.isShutdown;
+    }
+
     /**
      * Triggers the shutdown procedure. This function sets isShutdown to true
      * and calls processFailure below with the status provided. This immediately removes this pool
      * from the ConnectionPool. The actual destruction will happen eventually as ConnectionHandles
-     * are deleted.
+     * are deleted. The caller must hold both the parent's lock and the pool's lock.
      */
     void triggerShutdown(const Status& status);
 
@@ -401,6 +416,8 @@ private:
 
     const PoolId _id;
 
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ExecutorConnectionPool::SpecificPool::_mutex");
+
     LRUOwnershipPool _readyPool;
     OwnershipPool _processingPool;
     OwnershipPool _droppedProcessingPool;
@@ -442,6 +459,7 @@ auto ConnectionPool::SpecificPool::make(std::shared_ptr<ConnectionPool> parent,
     controller.addHost(pool->_id, hostAndPort);
 
     // Set our timers and health
+    stdx::lock_guard lk(pool->_mutex);
     pool->updateEventTimer();
     pool->updateHealth();
     return pool;
@@ -487,6 +505,7 @@ void ConnectionPool::shutdown() {
 
     for (const auto& pair : pools) {
         stdx::lock_guard lk(_mutex);
+        stdx::lock_guard poolLk(pair.second->mutex());
         pair.second->triggerShutdown(
             Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"));
     }
@@ -500,7 +519,8 @@ void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
     if (iter == _pools.end())
         return;
 
-    auto& pool = iter->second;
+    auto pool = iter->second;
+    stdx::lock_guard poolLk(pool->mutex());
     pool->triggerShutdown(
         Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"));
 }
@@ -508,8 +528,11 @@ void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
 void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
     stdx::lock_guard lk(_mutex);
 
-    for (const auto& pair : _pools) {
+    // Shutting a pool down removes it from _pools, so iterate over a copy.
+    auto pools = _pools;
+    for (const auto& pair : pools) {
         auto& pool = pair.second;
+        stdx::lock_guard poolLk(pool->mutex());
 
         if (pool->matchesTags(tags))
             continue;
@@ -530,6 +553,7 @@ void ConnectionPool::mutateTags(
         return;
 
     auto pool = iter->second;
+    stdx::lock_guard poolLk(pool->mutex());
     pool->mutateTags(mutateFunc);
 }
 
@@ -548,21 +572,34 @@ void ConnectionPool::get_forTest(const HostAndPort& hostAndPort,
 SemiFuture<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                                  transport::ConnectSSLMode sslMode,
                                                                  Milliseconds timeout) {
-    stdx::lock_guard lk(_mutex);
+    while (true) {
+        // Only the lookup happens under the global lock. The connection itself is taken under the
+        // lock of the specific pool.
+        auto pool = [&] {
+            stdx::lock_guard lk(_mutex);
+
+            auto& pool = _pools[hostAndPort];
+            if (!pool) {
+                pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
+            } else {
+                pool->fassertSSLModeIs(sslMode);
+            }
 
-    auto& pool = _pools[hostAndPort];
-    if (!pool) {
-        pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
-    } else {
-        pool->fassertSSLModeIs(sslMode);
-    }
+            invariant(pool);
+            return pool;
+        }();
 
-    invariant(pool);
+        stdx::lock_guard lk(pool->mutex());
+        if (pool->isShutdown()) {
+            // The pool was dropped after we looked it up, so look up its replacement.
+            continue;
+        }
 
-    auto connFuture = pool->getConnection(timeout);
-    pool->updateState();
+        auto connFuture = pool->getConnection(timeout);
+        pool->updateState();
 
-    return std::move(connFuture).semi();
+        return std::move(connFuture).semi();
+    }
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
@@ -572,6 +609,7 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
         HostAndPort host = kv.first;
 
         auto& pool = kv.second;
+        stdx::lock_guard poolLk(pool->mutex());
         ConnectionStatsPer hostStats{pool->inUseConnections(),
                                      pool->availableConnections(),
                                      pool->createdConnections(),
@@ -584,6 +622,7 @@ size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort)
     stdx::lock_guard lk(_mutex);
     auto iter = _pools.find(hostAndPort);
     if (iter != _pools.end()) {
+        stdx::lock_guard poolLk(iter->second->mutex());
         return iter->second->openConnections();
     }
 
@@ -678,7 +717,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
 
 auto ConnectionPool::SpecificPool::makeHandle(ConnectionInterface* connection) -> ConnectionHandle {
     auto deleter = [this, anchor = shared_from_this()](ConnectionInterface* connection) {
-        stdx::lock_guard lk(_parent->_mutex);
+        stdx::lock_guard lk(_mutex);
         returnConnection(connection);
         _lastActiveTime = _parent->_factory->now();
         updateState();
@@ -1175,7 +1214,14 @@ void ConnectionPool::SpecificPool::updateController() {
                 continue;
             }
 
-            auto& pool = it->second;
+            // We already hold our own lock. Taking the lock of another pool in the group is safe
+            // because it only ever happens under the parent's lock.
+            auto pool = it->second;
+            stdx::unique_lock<Latch> poolLk;
+            if (pool.get() != this) {
+                poolLk = stdx::unique_lock<Latch>(pool->_mutex);
+            }
+
             if (!pool->_health.isExpired) {
                 // Just because a HostGroup "canShutdown" doesn't mean that a SpecificPool should
                 // shutdown. For example, it is always inappropriate to shutdown a SpecificPool with
@@ -1239,6 +1285,7 @@ void ConnectionPool::SpecificPool::updateState() {
             invariant(status);
 
             stdx::lock_guard lk(_parent->_mutex);
+            stdx::lock_guard poolLk(_mutex);
             _updateScheduled = false;
             updateController();
         });
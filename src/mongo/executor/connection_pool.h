@@ -261,7 +261,9 @@ private:
 
     std::shared_ptr<ControllerInterface> _controller;
 
-    // The global mutex for specific pool access and the generation counter
+    // Guards the set of specific pools and their membership in the controller. Each specific pool
+    // guards its own connections and requests with a mutex that is taken after this one, so that
+    // getting and returning connections for one host does not contend with other hosts.
     mutable Mutex _mutex =
         MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "ExecutorConnectionPool::_mutex");
     PoolId _nextPoolId = 0;
@@ -81,6 +81,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result, bool forFT
     result.appendNumber("totalAvailable", totalAvailable);
     result.appendNumber("totalCreated", totalCreated);
     result.appendNumber("totalRefreshing", totalRefreshing);
+    result.appendNumber("totalCoalescedCommands", totalCoalescedCommands);
+    result.appendNumber("totalCoalescedBatches", totalCoalescedBatches);
 
     if (forFTDC) {
         BSONObjBuilder poolBuilder(result.subobjStart("connectionsInUsePerPool"));
@@ -67,6 +67,10 @@ struct ConnectionPoolStats {
     size_t totalCreated = 0u;
     size_t totalRefreshing = 0u;
 
+    // Commands that were pipelined over a shared connection, and the batches they were sent in.
+    size_t totalCoalescedCommands = 0u;
+    size_t totalCoalescedBatches = 0u;
+
     using StatsByHost = std::map<HostAndPort, ConnectionStatsPer>;
 
     struct PoolStats final : public ConnectionStatsPer {
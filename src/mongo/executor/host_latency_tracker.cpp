@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/host_latency_tracker.h"
+
+#include <algorithm>
+
+#include "mongo/util/static_immortal.h"
+
+namespace mongo {
+namespace executor {
+
+void HostLatencyTracker::HostStats::onRequestStarted() {
+    _numInFlight.fetchAndAdd(1);
+}
+
+void HostLatencyTracker::HostStats::onRequestFinished(boost::optional<Milliseconds> latency,
+                                                      Date_t now) {
+    _numInFlight.fetchAndSubtract(1);
+    if (!latency) {
+        return;
+    }
+
+    auto sample = static_cast<double>(duration_cast<Microseconds>(*latency).count());
+    if (auto average = getAverageLatency(now)) {
+        // new_average = alpha * sample + (1 - alpha) * old_average
+        sample = kLatencyAlpha * sample + (1 - kLatencyAlpha) * average->count();
+    }
+    _averageLatencyMicros.store(static_cast<long long>(sample));
+    _lastSampleMillis.store(now.toMillisSinceEpoch());
+}
+
+boost::optional<Microseconds> HostLatencyTracker::HostStats::getAverageLatency(Date_t now) const {
+    auto average = _averageLatencyMicros.load();
+    if (average < 0 ||
+        now - Date_t::fromMillisSinceEpoch(_lastSampleMillis.load()) > kSampleExpiration) {
+        return boost::none;
+    }
+    return Microseconds(average);
+}
+
+long long HostLatencyTracker::HostStats::getNumInFlight() const {
+    return _numInFlight.load();
+}
+
+HostLatencyTracker::HostLatencyTracker() : _random(SecureRandom().nextInt64()) {}
+
+bool HostLatencyTracker::isLatencySample(const BSONObj& cmdObj) {
+    auto commandName = cmdObj.firstElementFieldNameStringData();
+    if (commandName == "ping"_sd) {
+        return true;
+    }
+    // An awaitable isMaster is only answered once the topology changes or 'maxAwaitTimeMS' passes.
+    return (commandName == "isMaster"_sd || commandName == "ismaster"_sd) &&
+        !cmdObj.hasField("maxAwaitTimeMS"_sd);
+}
+
+HostLatencyTracker* HostLatencyTracker::get() {
+    // The tracker is shared by every network interface in the process, since they all talk to the
+    // same hosts and the replica set monitors consult it without knowing which interface will be
+    // used to send the command.
+    static StaticImmortal<HostLatencyTracker> tracker{};
+    return &tracker.value();
+}
+
+std::shared_ptr<HostLatencyTracker::HostStats> HostLatencyTracker::getHostStats(
+    const HostAndPort& host) {
+    stdx::lock_guard lk(_mutex);
+    auto& stats = _hosts[host];
+    if (!stats) {
+        stats = std::make_shared<HostStats>();
+    }
+    return stats;
+}
+
+void HostLatencyTracker::orderByExpectedLatency(std::vector<HostAndPort>* hosts, Date_t now) {
+    if (hosts->size() < 2) {
+        return;
+    }
+
+    struct Candidate {
+        HostAndPort host;
+        boost::optional<Microseconds> latency;
+        long long numInFlight;
+        double cost = 0;
+    };
+
+    std::vector<Candidate> candidates;
+    candidates.reserve(hosts->size());
+    boost::optional<Microseconds> fastest;
+    for (auto& host : *hosts) {
+        auto stats = getHostStats(host);
+        auto latency = stats->getAverageLatency(now);
+        if (latency && (!fastest || *latency < *fastest)) {
+            fastest = latency;
+        }
+        candidates.push_back({std::move(host), latency, stats->getNumInFlight()});
+    }
+
+    if (fastest) {
+        for (auto& candidate : candidates) {
+            // Clamp to one microsecond so that outstanding requests still count against hosts
+            // whose replies arrive within the clock resolution.
+            auto latency = std::max(candidate.latency.value_or(*fastest), Microseconds(1));
+            candidate.cost =
+                static_cast<double>(latency.count()) * (std::max(candidate.numInFlight, 0LL) + 1);
+        }
+
+        size_t first, second;
+        {
+            stdx::lock_guard lk(_mutex);
+            first = _random.nextInt64(candidates.size());
+            second = _random.nextInt64(candidates.size() - 1);
+        }
+        if (second >= first) {
+            ++second;
+        }
+        auto winner = candidates[second].cost < candidates[first].cost ? second : first;
+        std::swap(candidates[0], candidates[winner]);
+
+        // The caller's order, which is typically already shuffled, breaks ties among the rest.
+        std::stable_sort(
+            candidates.begin() + 1, candidates.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.cost < rhs.cost;
+            });
+    }
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        (*hosts)[i] = std::move(candidates[i].host);
+    }
+}
+
+}  // namespace executor
+}  // namespace mongo
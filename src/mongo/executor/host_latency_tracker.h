@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace executor {
+
+/**
+ * Process-wide record of how quickly each remote host has been answering commands sent through
+ * the egress networking layer, and of how many commands are currently outstanding against it.
+ *
+ * The latency is only sampled from ping and isMaster round trips, whose execution time does not
+ * depend on the work the caller asked for, so that a host which happens to have been sent costly
+ * commands is not mistaken for a slow one. Since these round trips go through the same connection
+ * pools and are queued behind other commands on the host, a reachable but overloaded host is still
+ * penalized, and its load also shows in the number of outstanding commands.
+ */
+class HostLatencyTracker {
+    HostLatencyTracker(const HostLatencyTracker&) = delete;
+    HostLatencyTracker& operator=(const HostLatencyTracker&) = delete;
+
+public:
+    // Weight given to each new latency sample in the moving average.
+    static constexpr double kLatencyAlpha = 0.2;
+
+    // Samples older than this no longer describe the host. A host whose latest sample is stale
+    // is treated as unmeasured, so that a host which was slow for a while is eventually retried.
+    static constexpr Seconds kSampleExpiration{10};
+
+    /**
+     * Latency and load statistics for a single host. Updates are lock-free; concurrent updates
+     * to the moving average may occasionally drop a sample, which is acceptable for an estimate.
+     */
+    class HostStats {
+    public:
+        void onRequestStarted();
+
+        /**
+         * Records the completion of a request. 'latency' is boost::none when the request did not
+         * produce a response from the host (e.g. it was canceled or the connection failed), in
+         * which case only the count of outstanding requests is updated.
+         */
+        void onRequestFinished(boost::optional<Milliseconds> latency, Date_t now);
+
+        /**
+         * Returns the moving average of the command latency, or boost::none if there is no
+         * sample younger than kSampleExpiration.
+         */
+        boost::optional<Microseconds> getAverageLatency(Date_t now) const;
+
+        long long getNumInFlight() const;
+
+    private:
+        AtomicWord<long long> _numInFlight{0};
+        AtomicWord<long long> _averageLatencyMicros{-1};
+        AtomicWord<long long> _lastSampleMillis{0};
+    };
+
+    HostLatencyTracker();
+
+    static HostLatencyTracker* get();
+
+    /**
+     * Returns true if the round trip of 'cmdObj' should be recorded as a latency sample, that is
+     * if it is a ping or an isMaster which does not wait for a topology change.
+     */
+    static bool isLatencySample(const BSONObj& cmdObj);
+
+    /**
+     * Returns the statistics for 'host', creating them if this is the first time it is seen.
+     */
+    std::shared_ptr<HostStats> getHostStats(const HostAndPort& host);
+
+    /**
+     * Reorders 'hosts' so that the host expected to answer soonest comes first, followed by the
+     * remaining hosts in increasing order of expected latency. The expected latency of a host is
+     * its average latency scaled by the number of requests already outstanding against it;
+     * unmeasured hosts are assumed to be as fast as the fastest measured one.
+     *
+     * The first host is chosen by comparing two random candidates rather than taking the global
+     * minimum, so that many callers choosing at once do not all pile onto the same host.
+     */
+    void orderByExpectedLatency(std::vector<HostAndPort>* hosts, Date_t now);
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("HostLatencyTracker::_mutex");
+    stdx::unordered_map<HostAndPort, std::shared_ptr<HostStats>> _hosts;
+    PseudoRandom _random;
+};
+
+}  // namespace executor
+}  // namespace mongo
@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/host_latency_tracker.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+const HostAndPort kFast("fast:27017");
+const HostAndPort kSlow("slow:27017");
+const HostAndPort kUnmeasured("unmeasured:27017");
+
+const Date_t kNow = Date_t::fromMillisSinceEpoch(100000);
+
+void recordLatency(HostLatencyTracker* tracker,
+                   const HostAndPort& host,
+                   Milliseconds latency,
+                   Date_t now = kNow) {
+    auto stats = tracker->getHostStats(host);
+    stats->onRequestStarted();
+    stats->onRequestFinished(latency, now);
+}
+
+TEST(HostLatencyTrackerTest, AverageIsUnsetUntilFirstSample) {
+    HostLatencyTracker tracker;
+    ASSERT_FALSE(tracker.getHostStats(kFast)->getAverageLatency(kNow));
+
+    recordLatency(&tracker, kFast, Milliseconds(10));
+    ASSERT_EQ(Microseconds(10000), *tracker.getHostStats(kFast)->getAverageLatency(kNow));
+}
+
+TEST(HostLatencyTrackerTest, AverageIsExponentiallyWeighted) {
+    HostLatencyTracker tracker;
+    recordLatency(&tracker, kFast, Milliseconds(10));
+    recordLatency(&tracker, kFast, Milliseconds(20));
+
+    // 0.2 * 20ms + 0.8 * 10ms
+    ASSERT_EQ(Microseconds(12000), *tracker.getHostStats(kFast)->getAverageLatency(kNow));
+}
+
+TEST(HostLatencyTrackerTest, StaleAverageIsDiscarded) {
+    HostLatencyTracker tracker;
+    recordLatency(&tracker, kSlow, Milliseconds(500));
+
+    auto later = kNow + HostLatencyTracker::kSampleExpiration + Milliseconds(1);
+    ASSERT_FALSE(tracker.getHostStats(kSlow)->getAverageLatency(later));
+
+    // The next sample replaces the stale average instead of being blended with it.
+    recordLatency(&tracker, kSlow, Milliseconds(5), later);
+    ASSERT_EQ(Microseconds(5000), *tracker.getHostStats(kSlow)->getAverageLatency(later));
+}
+
+TEST(HostLatencyTrackerTest, RequestsWithoutResponseOnlyUpdateInFlightCount) {
+    HostLatencyTracker tracker;
+    auto stats = tracker.getHostStats(kFast);
+    stats->onRequestStarted();
+    stats->onRequestStarted();
+    ASSERT_EQ(2, stats->getNumInFlight());
+
+    stats->onRequestFinished(boost::none, kNow);
+    ASSERT_EQ(1, stats->getNumInFlight());
+    ASSERT_FALSE(stats->getAverageLatency(kNow));
+}
+
+TEST(HostLatencyTrackerTest, OrderPrefersFasterHost) {
+    HostLatencyTracker tracker;
+    recordLatency(&tracker, kFast, Milliseconds(1));
+    recordLatency(&tracker, kSlow, Milliseconds(100));
+
+    // With two candidates the random pair always covers both of them.
+    for (int i = 0; i < 10; ++i) {
+        std::vector<HostAndPort> hosts{kSlow, kFast};
+        tracker.orderByExpectedLatency(&hosts, kNow);
+        ASSERT_EQ(kFast, hosts[0]);
+        ASSERT_EQ(kSlow, hosts[1]);
+    }
+}
+
+TEST(HostLatencyTrackerTest, OrderAccountsForOutstandingRequests) {
+    HostLatencyTracker tracker;
+    recordLatency(&tracker, kFast, Milliseconds(10));
+    recordLatency(&tracker, kSlow, Milliseconds(20));
+
+    // Three outstanding requests make the fast host's expected latency 40ms.
+    auto fastStats = tracker.getHostStats(kFast);
+    for (int i = 0; i < 3; ++i) {
+        fastStats->onRequestStarted();
+    }
+
+    std::vector<HostAndPort> hosts{kFast, kSlow};
+    tracker.orderByExpectedLatency(&hosts, kNow);
+    ASSERT_EQ(kSlow, hosts[0]);
+    ASSERT_EQ(kFast, hosts[1]);
+}
+
+TEST(HostLatencyTrackerTest, UnmeasuredHostIsAssumedAsFastAsFastestHost) {
+    HostLatencyTracker tracker;
+    recordLatency(&tracker, kFast, Milliseconds(1));
+    recordLatency(&tracker, kSlow, Milliseconds(100));
+
+    for (int i = 0; i < 10; ++i) {
+        std::vector<HostAndPort> hosts{kSlow, kUnmeasured, kFast};
+        tracker.orderByExpectedLatency(&hosts, kNow);
+        ASSERT_EQ(kSlow, hosts[2]);
+    }
+}
+
+TEST(HostLatencyTrackerTest, OrderIsUnchangedWithoutMeasurements) {
+    HostLatencyTracker tracker;
+    std::vector<HostAndPort> hosts{kSlow, kUnmeasured, kFast};
+    tracker.orderByExpectedLatency(&hosts, kNow);
+    ASSERT_EQ(kSlow, hosts[0]);
+    ASSERT_EQ(kUnmeasured, hosts[1]);
+    ASSERT_EQ(kFast, hosts[2]);
+}
+
+TEST(HostLatencyTrackerTest, OnlyPingAndIsMasterAreLatencySamples) {
+    ASSERT_TRUE(HostLatencyTracker::isLatencySample(BSON("ping" << 1)));
+    ASSERT_TRUE(HostLatencyTracker::isLatencySample(BSON("isMaster" << 1)));
+    ASSERT_TRUE(HostLatencyTracker::isLatencySample(BSON("ismaster" << 1)));
+
+    ASSERT_FALSE(HostLatencyTracker::isLatencySample(BSON("find"
+                                                          << "coll")));
+    ASSERT_FALSE(HostLatencyTracker::isLatencySample(BSON("aggregate"
+                                                          << "coll"
+                                                          << "pipeline" << BSONArray())));
+    ASSERT_FALSE(HostLatencyTracker::isLatencySample(BSONObj()));
+}
+
+TEST(HostLatencyTrackerTest, AwaitableIsMasterIsNotALatencySample) {
+    ASSERT_FALSE(HostLatencyTracker::isLatencySample(
+        BSON("isMaster" << 1 << "topologyVersion" << BSONObj() << "maxAwaitTimeMS" << 10000)));
+}
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface_integration_fixture.h"
+#include "mongo/executor/network_interface_tl_gen.h"
 #include "mongo/executor/test_network_connection_hook.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -665,6 +666,56 @@ TEST_F(NetworkInterfaceTest, FireAndForget) {
     assertNumOps(0u, 0u, 0u, 5u);
 }
 
+TEST_F(NetworkInterfaceTest, CoalescedCommandsReceiveTheirOwnReplies) {
+    gNetworkInterfaceCoalesceCommands.store(true);
+    ON_BLOCK_EXIT([] { gNetworkInterfaceCoalesceCommands.store(false); });
+
+    // Commands started back to back are likely to be pipelined over one connection. Whether or not
+    // they are, every command has to get the reply to its own request.
+    const int numRequests = 8;
+    std::vector<Future<RemoteCommandResponse>> futures;
+    for (int i = 0; i < numRequests; i++) {
+        auto request = makeTestCommand(kNoTimeout, BSON("echo" << 1 << "index" << i));
+        futures.push_back(runCommand(makeCallbackHandle(), std::move(request)));
+    }
+
+    for (int i = 0; i < numRequests; i++) {
+        auto result = futures[i].get();
+        uassertStatusOK(result.status);
+        ASSERT_EQ(1, result.data.getIntField("ok"));
+        ASSERT_EQ(i, result.data.getObjectField("echo").getIntField("index"));
+    }
+
+    ConnectionPoolStats stats;
+    net().appendConnectionStats(&stats);
+    ASSERT_LTE(stats.totalCoalescedCommands, size_t(numRequests));
+    ASSERT_LTE(stats.totalCoalescedBatches * 2, stats.totalCoalescedCommands);
+    assertNumOps(0u, 0u, 0u, numRequests);
+}
+
+TEST_F(NetworkInterfaceTest, FailureDetectionCommandsAreNotCoalesced) {
+    gNetworkInterfaceCoalesceCommands.store(true);
+    ON_BLOCK_EXIT([] { gNetworkInterfaceCoalesceCommands.store(false); });
+
+    const int numRequests = 8;
+    std::vector<Future<RemoteCommandResponse>> futures;
+    for (int i = 0; i < numRequests; i++) {
+        auto request = makeTestCommand(kNoTimeout, BSON("isMaster" << 1));
+        futures.push_back(runCommand(makeCallbackHandle(), std::move(request)));
+    }
+
+    for (auto& future : futures) {
+        auto result = future.get();
+        uassertStatusOK(result.status);
+        ASSERT_EQ(1, result.data.getIntField("ok"));
+    }
+
+    ConnectionPoolStats stats;
+    net().appendConnectionStats(&stats);
+    ASSERT_EQ(0U, stats.totalCoalescedCommands);
+    assertNumOps(0u, 0u, 0u, numRequests);
+}
+
 TEST_F(NetworkInterfaceInternalClientTest, StartCommandOnAny) {
     // The echo command below uses hedging so after a response is returned, we will issue
     // a _killOperations command to kill the pending operation. As a result, the number of
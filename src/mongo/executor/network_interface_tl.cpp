@@ -33,9 +33,12 @@
 
 #include "mongo/executor/network_interface_tl.h"
 
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/server_options.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/connection_pool_tl.h"
 #include "mongo/executor/hedging_metrics.h"
+#include "mongo/executor/network_interface_tl_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/transport/transport_layer_manager.h"
@@ -98,7 +101,17 @@ private:
 namespace {
 const Status kNetworkInterfaceShutdownInProgress = {ErrorCodes::ShutdownInProgress,
                                                     "NetworkInterface shutdown in progress"};
+
+/**
+ * Returns true for the commands which replication and topology monitoring use to detect failures
+ * and elect primaries. They must never wait behind other commands on a shared connection.
+ */
+bool isFailureDetectionCommand(StringData commandName) {
+    return commandName == "replSetHeartbeat"_sd || commandName == "replSetRequestVotes"_sd ||
+        commandName == "replSetUpdatePosition"_sd || commandName == "isMaster"_sd ||
+        commandName == "ismaster"_sd || commandName == "hello"_sd || commandName == "ping"_sd;
 }
+}  // namespace
 
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
@@ -156,6 +169,9 @@ void NetworkInterfaceTL::appendConnectionStats(ConnectionPoolStats* stats) const
     }();
     if (pool)
         pool->appendConnectionStats(stats);
+
+    stats->totalCoalescedCommands += _numCoalescedCommands.load();
+    stats->totalCoalescedBatches += _numCoalescedBatches.load();
 }
 
 NetworkInterface::Counters NetworkInterfaceTL::getCounters() const {
@@ -534,13 +550,28 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         return Status::OK();
     }
 
+    if (_canCoalesce(*cmdState, baton)) {
+        _coalesceCommand(std::move(cmdState));
+        return Status::OK();
+    }
+
+    _acquireConnsAndSend(std::move(cmdState), targetHostsInAlphabeticalOrder);
+    return Status::OK();
+} catch (const DBException& ex) {
+    return ex.toStatus();
+}
+
+void NetworkInterfaceTL::_acquireConnsAndSend(std::shared_ptr<CommandState> cmdState,
+                                              bool sendInOrder) {
+    const auto& request = cmdState->requestOnAny;
+
     // Attempt to get a connection to every target host
     for (size_t idx = 0; idx < request.target.size(); ++idx) {
         auto connFuture = _pool->get(request.target[idx], request.sslMode, request.timeout);
 
         // If connection future is ready or requests should be sent in order, send the request
         // immediately.
-        if (connFuture.isReady() || targetHostsInAlphabeticalOrder) {
+        if (connFuture.isReady() || sendInOrder) {
             cmdState->requestManager->trySend(std::move(connFuture).getNoThrow(), idx);
             continue;
         }
@@ -550,10 +581,211 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
             cmdState->requestManager->trySend(std::move(swConn), idx);
         });
     }
+}
 
-    return Status::OK();
-} catch (const DBException& ex) {
-    return ex.toStatus();
+bool NetworkInterfaceTL::_canCoalesce(const CommandState& cmdState,
+                                      const BatonHandle& baton) const {
+    if (!gNetworkInterfaceCoalesceCommands.load()) {
+        return false;
+    }
+
+    // Only plain commands to a single host qualify. Hedged and fire-and-forget commands need a
+    // connection of their own, commands with an operation key are killed remotely through the
+    // request that carried them, and commands with a baton must run on it. Heartbeats and the
+    // other failure detection commands are not held up behind slower commands on the same
+    // connection, where a timeout would be mistaken for an unreachable host.
+    const auto& request = cmdState.requestOnAny;
+    if (baton || request.target.size() != 1 || request.hedgeOptions || request.operationKey ||
+        request.sslMode != transport::kGlobalSSLMode ||
+        request.fireAndForgetMode != RemoteCommandRequest::FireAndForgetMode::kOff ||
+        isFailureDetectionCommand(request.cmdObj.firstElementFieldNameStringData())) {
+        return false;
+    }
+
+    auto size = request.cmdObj.objsize() + request.metadata.objsize();
+    return size <= gNetworkInterfaceCoalesceMaxCommandBytes.load();
+}
+
+void NetworkInterfaceTL::_coalesceCommand(std::shared_ptr<CommandState> cmdState) {
+    auto target = cmdState->requestOnAny.target[0];
+
+    bool shouldScheduleFlush = [&] {
+        stdx::lock_guard lk(_coalesceMutex);
+        auto& commands = _coalescedCommands[target];
+        commands.push_back(std::move(cmdState));
+        return commands.size() == 1;
+    }();
+
+    if (shouldScheduleFlush) {
+        _reactor->schedule(
+            [this, target](Status status) { _flushCoalescedCommands(target, std::move(status)); });
+    }
+}
+
+void NetworkInterfaceTL::_flushCoalescedCommands(const HostAndPort& target, Status status) {
+    auto commands = [&] {
+        stdx::lock_guard lk(_coalesceMutex);
+        auto it = _coalescedCommands.find(target);
+        invariant(it != _coalescedCommands.end());
+        auto commands = std::move(it->second);
+        _coalescedCommands.erase(it);
+        return commands;
+    }();
+
+    if (!status.isOK()) {
+        for (auto& cmdState : commands) {
+            if (cmdState->finishLine.arriveStrongly()) {
+                cmdState->fulfillFinalPromise(status);
+            }
+        }
+        return;
+    }
+
+    const size_t maxBatchSize = gNetworkInterfaceCoalesceMaxBatchSize.load();
+    for (auto it = commands.begin(); it != commands.end();) {
+        auto batchEnd = it + std::min(maxBatchSize, size_t(commands.end() - it));
+        std::vector<std::shared_ptr<CommandState>> batch(std::make_move_iterator(it),
+                                                         std::make_move_iterator(batchEnd));
+        _sendCommandBatch(target, std::move(batch));
+        it = batchEnd;
+    }
+}
+
+void NetworkInterfaceTL::_sendCommandBatch(const HostAndPort& target,
+                                           std::vector<std::shared_ptr<CommandState>> batch) {
+    // Commands that were canceled or timed out while they waited don't need to be sent.
+    batch.erase(std::remove_if(batch.begin(),
+                               batch.end(),
+                               [](const auto& cmdState) { return cmdState->finishLine.isReady(); }),
+                batch.end());
+
+    if (batch.empty()) {
+        return;
+    }
+
+    if (batch.size() == 1) {
+        return _acquireConnsAndSend(std::move(batch.front()), false);
+    }
+
+    // The connection is shared, so wait for it as long as the most patient command would. The
+    // other commands time out through their own timers.
+    auto timeout = RemoteCommandRequest::kNoTimeout;
+    for (const auto& cmdState : batch) {
+        if (cmdState->requestOnAny.timeout == RemoteCommandRequest::kNoTimeout) {
+            timeout = RemoteCommandRequest::kNoTimeout;
+            break;
+        }
+        timeout = std::max(timeout, cmdState->requestOnAny.timeout);
+    }
+
+    _pool->get(target, transport::kGlobalSSLMode, timeout)
+        .thenRunOn(_reactor)
+        .getAsync([this, target, batch = std::move(batch)](auto swConn) mutable {
+            _runCommandBatch(std::move(swConn), target, std::move(batch));
+        });
+}
+
+void NetworkInterfaceTL::_runCommandBatch(StatusWith<ConnectionPool::ConnectionHandle> swConn,
+                                          const HostAndPort& target,
+                                          std::vector<std::shared_ptr<CommandState>> batch) {
+    if (!swConn.isOK()) {
+        for (auto& cmdState : batch) {
+            if (cmdState->finishLine.arriveStrongly()) {
+                cmdState->fulfillFinalPromise(swConn.getStatus());
+            }
+        }
+        return;
+    }
+
+    std::vector<std::shared_ptr<CommandState>> sentCommands;
+    std::vector<RemoteCommandRequest> requests;
+    for (auto& cmdState : batch) {
+        try {
+            cmdState->setTimer();
+        } catch (const DBException& ex) {
+            if (cmdState->finishLine.arriveStrongly()) {
+                cmdState->fulfillFinalPromise(ex.toStatus());
+            }
+            continue;
+        }
+
+        requests.emplace_back(cmdState->requestOnAny, 0);
+        sentCommands.push_back(std::move(cmdState));
+    }
+
+    RequestState::ConnectionHandle conn = std::move(swConn.getValue());
+    if (sentCommands.empty()) {
+        conn->indicateSuccess();
+        return;
+    }
+
+    LOGV2_DEBUG(4937000,
+                2,
+                "Sending coalesced requests",
+                "target"_attr = target,
+                "numRequests"_attr = sentCommands.size());
+
+    _numCoalescedCommands.fetchAndAdd(sentCommands.size());
+    _numCoalescedBatches.fetchAndAdd(1);
+    if (_counters) {
+        for (size_t i = 0; i < sentCommands.size(); ++i) {
+            _counters->recordSent();
+        }
+    }
+
+    // The connection goes back to the pool once every reply is in, marked as failed if any of
+    // them failed. All of the callbacks run on the reactor thread.
+    struct BatchState {
+        RequestState::ConnectionHandle conn;
+        size_t outstanding;
+        Status status = Status::OK();
+    };
+    auto batchState = std::make_shared<BatchState>();
+    batchState->outstanding = sentCommands.size();
+
+    auto futures = RequestState::getClient(conn)->runPipelinedCommandRequests(std::move(requests));
+    batchState->conn = std::move(conn);
+
+    for (size_t i = 0; i < sentCommands.size(); ++i) {
+        std::move(futures[i])
+            .thenRunOn(_reactor)
+            .getAsync([target, batchState, cmdState = std::move(sentCommands[i])](
+                          StatusWith<RemoteCommandResponse> swResponse) {
+                auto response = [&] {
+                    if (!swResponse.isOK()) {
+                        return RemoteCommandOnAnyResponse(
+                            target, swResponse.getStatus(), cmdState->stopwatch.elapsed());
+                    }
+
+                    RemoteCommandOnAnyResponse response(target, std::move(swResponse.getValue()));
+                    try {
+                        cmdState->doMetadataHook(response);
+                    } catch (const DBException& ex) {
+                        return RemoteCommandOnAnyResponse(
+                            target, ex.toStatus(), cmdState->stopwatch.elapsed());
+                    }
+                    return response;
+                }();
+
+                if (!response.status.isOK() && batchState->status.isOK()) {
+                    batchState->status = response.status;
+                }
+
+                if (--batchState->outstanding == 0) {
+                    auto conn = std::exchange(batchState->conn, {});
+                    if (batchState->status.isOK()) {
+                        conn->indicateUsed();
+                        conn->indicateSuccess();
+                    } else {
+                        conn->indicateFailure(batchState->status);
+                    }
+                }
+
+                if (cmdState->finishLine.arriveStrongly()) {
+                    cmdState->fulfillFinalPromise(std::move(response));
+                }
+            });
+    }
 }
 
 void NetworkInterfaceTL::testEgress(const HostAndPort& hostAndPort,
@@ -780,6 +1012,9 @@ void NetworkInterfaceTL::RequestManager::trySend(
         counters->recordSent();
     }
 
+    requestState->hostStats = HostLatencyTracker::get()->getHostStats(requestState->host);
+    requestState->hostStats->onRequestStarted();
+
     requestState->resolve(cmdState->sendRequest(requestState));
 }
 
@@ -807,6 +1042,14 @@ void NetworkInterfaceTL::RequestState::resolve(Future<RemoteCommandResponse> fut
 
             returnConnection(status);
 
+            // Only the round trips of cheap probes are latency samples; requests that failed or
+            // were canceled before the host answered say nothing about how quickly it responds.
+            hostStats->onRequestFinished(
+                status.isOK() && HostLatencyTracker::isLatencySample(request->cmdObj)
+                    ? boost::make_optional(stopwatch.elapsed())
+                    : boost::none,
+                interface()->now());
+
             auto commandStatus = getStatusFromCommandResult(response.data);
             // Ignore maxTimeMS expiration errors for hedged reads without triggering the finish
             // line.
@@ -828,6 +1071,21 @@ void NetworkInterfaceTL::RequestState::resolve(Future<RemoteCommandResponse> fut
                             "target"_attr = request->target,
                             "status"_attr = commandStatus);
 
+                // The losing request of a hedged read may have opened a cursor that nobody will
+                // ever iterate.
+                if (cmdState->requestOnAny.hedgeOptions && commandStatus.isOK()) {
+                    auto killStatus =
+                        interface()->_killHedgedCursor(shared_from_this(), response.data);
+                    if (!killStatus.isOK()) {
+                        LOGV2_DEBUG(4798614,
+                                    2,
+                                    "Failed to kill the cursor of a hedged request",
+                                    "requestId"_attr = request->id,
+                                    "target"_attr = request->target,
+                                    "error"_attr = killStatus);
+                    }
+                }
+
                 return;
             }
 
@@ -1082,6 +1340,68 @@ Status NetworkInterfaceTL::_killOperation(std::shared_ptr<RequestState> requestS
     return ex.toStatus();
 }
 
+Status NetworkInterfaceTL::_killHedgedCursor(std::shared_ptr<RequestState> requestState,
+                                             const BSONObj& response) try {
+    auto cursor = response["cursor"];
+    if (cursor.type() != Object) {
+        return Status::OK();
+    }
+
+    auto cursorId = cursor["id"].safeNumberLong();
+    NamespaceString nss(cursor["ns"].str());
+    if (cursorId == 0 || !nss.isValid()) {
+        return Status::OK();
+    }
+
+    auto [target, sslMode] = [&] {
+        invariant(requestState->request);
+        auto request = requestState->request.get();
+        return std::make_pair(request.target, request.sslMode);
+    }();
+
+    executor::RemoteCommandRequest killCursorsRequest(
+        target,
+        nss.db().toString(),
+        BSON("killCursors" << nss.coll() << "cursors" << BSON_ARRAY(cursorId)),
+        nullptr,
+        kCancelCommandTimeout);
+
+    LOGV2_DEBUG(4798615,
+                2,
+                "Sending killCursors for the cursor of a hedged request that lost the race",
+                "cursorId"_attr = cursorId,
+                "namespace"_attr = nss,
+                "target"_attr = target);
+
+    auto cbHandle = executor::TaskExecutor::CallbackHandle();
+    auto [killCursorsCmdState, future] = CommandState::make(this, killCursorsRequest, cbHandle);
+    killCursorsCmdState->deadline =
+        killCursorsCmdState->stopwatch.start() + killCursorsRequest.timeout;
+
+    std::move(future).getAsync(
+        [cursorId, target = target](StatusWith<RemoteCommandOnAnyResponse> swr) {
+            invariant(swr.isOK());
+            auto rs = std::move(swr.getValue());
+            LOGV2_DEBUG(4798616,
+                        2,
+                        "killCursors for the cursor of a hedged request finished with response",
+                        "cursorId"_attr = cursorId,
+                        "target"_attr = target,
+                        "response"_attr =
+                            redact(rs.isOK() ? rs.data.toString() : rs.status.toString()));
+        });
+
+    auto connFuture = _pool->get(target, sslMode, killCursorsRequest.kNoTimeout);
+    std::move(connFuture)
+        .thenRunOn(_reactor)
+        .getAsync([this, killCursorsCmdState = killCursorsCmdState](auto swConn) {
+            killCursorsCmdState->requestManager->trySend(std::move(swConn), 0);
+        });
+    return Status::OK();
+} catch (const DBException& ex) {
+    return ex.toStatus();
+}
+
 Status NetworkInterfaceTL::schedule(unique_function<void(Status)> action) {
     if (inShutdown()) {
         return kNetworkInterfaceShutdownInProgress;
@@ -34,6 +34,7 @@
 #include "mongo/client/async_client.h"
 #include "mongo/db/service_context.h"
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/host_latency_tracker.h"
 #include "mongo/executor/network_interface.h"
 #include "mongo/logv2/log_severity.h"
 #include "mongo/platform/mutex.h"
@@ -296,6 +297,9 @@ private:
         ConnectionHandle conn;
         WeakConnectionHandle weakConn;
 
+        // Latency and load statistics of 'host', updated when the request is sent and answered.
+        std::shared_ptr<HostLatencyTracker::HostStats> hostStats;
+
         // Internal id of this request as tracked by the RequestManager.
         size_t reqId;
 
@@ -329,10 +333,43 @@ private:
     void _shutdownAllAlarms();
     void _answerAlarm(Status status, std::shared_ptr<AlarmState> state);
 
+    /**
+     * Acquire a connection to each target host of the command and send it over the first ones.
+     */
+    void _acquireConnsAndSend(std::shared_ptr<CommandState> cmdState, bool sendInOrder);
+
+    /**
+     * Return true if the command may be pipelined with other commands to the same host.
+     */
+    bool _canCoalesce(const CommandState& cmdState, const BatonHandle& baton) const;
+
+    /**
+     * Queue the command for its host. The first command queued for a host schedules a flush on
+     * the reactor, and every command queued for that host before the flush runs joins its batch.
+     */
+    void _coalesceCommand(std::shared_ptr<CommandState> cmdState);
+    void _flushCoalescedCommands(const HostAndPort& target, Status status);
+
+    /**
+     * Send the batch over a single connection. A batch of one is sent the usual way.
+     */
+    void _sendCommandBatch(const HostAndPort& target,
+                           std::vector<std::shared_ptr<CommandState>> batch);
+    void _runCommandBatch(StatusWith<ConnectionPool::ConnectionHandle> swConn,
+                          const HostAndPort& target,
+                          std::vector<std::shared_ptr<CommandState>> batch);
+
     void _run();
 
     Status _killOperation(std::shared_ptr<RequestState> requestStateToKill);
 
+    /**
+     * Kill the cursor that a hedged request which lost the race opened on its target, as described
+     * by the request's 'response'. Does nothing if the response did not leave a cursor open.
+     */
+    Status _killHedgedCursor(std::shared_ptr<RequestState> requestState,
+                             const BSONObj& response);
+
     std::string _instanceName;
     ServiceContext* _svcCtx = nullptr;
     transport::TransportLayer* _tl = nullptr;
@@ -371,6 +408,14 @@ private:
 
     stdx::condition_variable _workReadyCond;
     bool _isExecutorRunnable = false;
+
+    Mutex _coalesceMutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "NetworkInterfaceTL::_coalesceMutex");
+    stdx::unordered_map<HostAndPort, std::vector<std::shared_ptr<CommandState>>>
+        _coalescedCommands;
+
+    AtomicWord<size_t> _numCoalescedCommands{0};
+    AtomicWord<size_t> _numCoalescedBatches{0};
 };
 
 }  // namespace executor
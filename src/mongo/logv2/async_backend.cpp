@@ -0,0 +1,280 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logv2/async_backend.h"
+
+#include <algorithm>
+
+#ifndef _WIN32
+#include <csignal>
+#include <pthread.h>
+#endif
+
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo::logv2 {
+namespace {
+// Upper bound on how long the writer sleeps, in case it missed the wakeup of a producer.
+constexpr auto kMaxWriterSleep = Milliseconds(100);
+
+AtomicWord<unsigned long long> nextQueueId{0};
+}  // namespace
+
+struct AsyncRecordQueue::Ring {
+    struct Slot {
+        unsigned long long seq;
+        std::string formatted;
+    };
+
+    explicit Ring(size_t capacity) : slots(capacity) {}
+
+    size_t size() const {
+        return head.load() - tail.load();
+    }
+
+    std::vector<Slot> slots;
+    // Number of records published, only advanced by the producing thread.
+    AtomicWord<unsigned long long> head{0};
+    // Number of records written, only advanced by the writer thread.
+    AtomicWord<unsigned long long> tail{0};
+    // Set once the producing thread has exited, the writer unregisters the ring once it is empty.
+    AtomicWord<bool> orphaned{false};
+    // Set once the queue is destroyed, the producing thread then forgets about the ring.
+    AtomicWord<bool> detached{false};
+};
+
+AsyncRecordQueue::AsyncRecordQueue(Options options, WriteBatchFn writeBatch)
+    : _options(std::move(options)),
+      _writeBatch(std::move(writeBatch)),
+      _id(nextQueueId.fetchAndAdd(1)) {
+    invariant(_options.bufferSize > 0);
+    _writer = stdx::thread([this] { _run(); });
+}
+
+AsyncRecordQueue::~AsyncRecordQueue() {
+    {
+        stdx::lock_guard lk(_mutex);
+        _shutdown = true;
+        _wakeWriter.notify_one();
+    }
+    _writer.join();
+
+    stdx::lock_guard lk(_ringsMutex);
+    for (auto& ring : _rings) {
+        ring->detached.store(true);
+    }
+}
+
+AsyncRecordQueue::Ring* AsyncRecordQueue::_threadRing() {
+    // The rings of this thread, keyed by the id of the queue they belong to.
+    class ThreadRings {
+    public:
+        ~ThreadRings() {
+            for (auto& entry : _rings) {
+                entry.second->orphaned.store(true);
+            }
+        }
+
+        Ring* find(unsigned long long id) {
+            for (auto& entry : _rings) {
+                if (entry.first == id) {
+                    return entry.second.get();
+                }
+            }
+            return nullptr;
+        }
+
+        void add(unsigned long long id, std::shared_ptr<Ring> ring) {
+            _rings.erase(std::remove_if(_rings.begin(),
+                                        _rings.end(),
+                                        [](const auto& entry) {
+                                            return entry.second->detached.load();
+                                        }),
+                         _rings.end());
+            _rings.emplace_back(id, std::move(ring));
+        }
+
+    private:
+        std::vector<std::pair<unsigned long long, std::shared_ptr<Ring>>> _rings;
+    };
+    thread_local ThreadRings threadRings;
+
+    if (auto ring = threadRings.find(_id)) {
+        return ring;
+    }
+
+    auto ring = std::make_shared<Ring>(_options.bufferSize);
+    {
+        stdx::lock_guard lk(_ringsMutex);
+        _rings.push_back(ring);
+    }
+    threadRings.add(_id, ring);
+    return ring.get();
+}
+
+void AsyncRecordQueue::push(const std::string& formatted) {
+    auto ring = _threadRing();
+    const auto capacity = ring->slots.size();
+    const auto head = ring->head.load();
+
+    if (head - ring->tail.load() == capacity) {
+        if (_options.dropOnOverflow) {
+            _numDropped.fetchAndAdd(1);
+            return;
+        }
+
+        stdx::unique_lock lk(_mutex);
+        _wakeWriter.notify_one();
+        _batchWritten.wait(lk, [&] { return head - ring->tail.load() < capacity; });
+    }
+
+    auto& slot = ring->slots[head % capacity];
+    slot.seq = _nextSeq.fetchAndAdd(1);
+    slot.formatted.assign(formatted);
+    ring->head.store(head + 1);
+    _numPushed.fetchAndAdd(1);
+
+    // The writer publishes that it is idle before checking the rings a last time, so either it
+    // sees this record or this thread sees it idle and wakes it.
+    if (_writerIdle.load()) {
+        stdx::lock_guard lk(_mutex);
+        _wakeWriter.notify_one();
+    }
+}
+
+void AsyncRecordQueue::drain() {
+    const auto target = _numPushed.load();
+
+    stdx::unique_lock lk(_mutex);
+    if (_numWritten.load() >= target) {
+        return;
+    }
+    _wakeWriter.notify_one();
+    _batchWritten.wait(lk, [&] { return _numWritten.load() >= target || _writerExited; });
+}
+
+bool AsyncRecordQueue::_hasPending() {
+    stdx::lock_guard lk(_ringsMutex);
+    return std::any_of(
+        _rings.begin(), _rings.end(), [](const auto& ring) { return ring->size() > 0; });
+}
+
+bool AsyncRecordQueue::_writePending() {
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        stdx::lock_guard lk(_ringsMutex);
+        // A ring whose producer exited receives no more records, so once the writer has caught up
+        // with it the ring can be unregistered.
+        _rings.erase(std::remove_if(_rings.begin(),
+                                    _rings.end(),
+                                    [](const auto& ring) {
+                                        return ring->orphaned.load() && ring->size() == 0;
+                                    }),
+                     _rings.end());
+        rings = _rings;
+    }
+
+    std::vector<const Ring::Slot*> slots;
+    std::vector<unsigned long long> heads;
+    heads.reserve(rings.size());
+    for (auto& ring : rings) {
+        const auto capacity = ring->slots.size();
+        const auto head = ring->head.load();
+        for (auto i = ring->tail.load(); i != head; ++i) {
+            slots.push_back(&ring->slots[i % capacity]);
+        }
+        heads.push_back(head);
+    }
+
+    if (slots.empty()) {
+        return false;
+    }
+
+    std::sort(slots.begin(), slots.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->seq < rhs->seq;
+    });
+
+    std::vector<const std::string*> batch;
+    batch.reserve(slots.size());
+    for (auto slot : slots) {
+        batch.push_back(&slot->formatted);
+    }
+    _writeBatch(batch);
+
+    for (size_t i = 0; i < rings.size(); ++i) {
+        rings[i]->tail.store(heads[i]);
+    }
+    _numWritten.fetchAndAdd(batch.size());
+    return true;
+}
+
+void AsyncRecordQueue::_run() {
+#ifndef _WIN32
+    // This thread may be started before the signal processing thread masks the signals it handles,
+    // make sure they are never delivered here.
+    sigset_t sigset;
+    sigfillset(&sigset);
+    pthread_sigmask(SIG_BLOCK, &sigset, nullptr);
+#endif
+    setThreadName("AsyncLogWriter");
+
+    stdx::unique_lock lk(_mutex);
+    ON_BLOCK_EXIT([&] {
+        _writerExited = true;
+        _batchWritten.notify_all();
+    });
+
+    while (true) {
+        const bool shutdown = _shutdown;
+
+        lk.unlock();
+        const bool wrote = _writePending();
+        lk.lock();
+
+        if (wrote) {
+            _batchWritten.notify_all();
+            continue;
+        }
+        if (shutdown) {
+            return;
+        }
+
+        _writerIdle.store(true);
+        if (!_shutdown && !_hasPending()) {
+            _wakeWriter.wait_for(lk, kMaxWriterSleep.toSystemDuration());
+        }
+        _writerIdle.store(false);
+    }
+}
+
+}  // namespace mongo::logv2
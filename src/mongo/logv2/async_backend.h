@@ -0,0 +1,223 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/log/attributes/value_extraction.hpp>
+#include <boost/log/detail/locking_ptr.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/frontend_requirements.hpp>
+#include <boost/optional.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/logv2/attributes.h"
+#include "mongo/logv2/log_severity.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo::logv2 {
+
+/**
+ * Hands formatted log records over from the logging threads to a background writer thread.
+ *
+ * Every producing thread owns a bounded single-producer/single-consumer ring of record slots, so
+ * pushing a record is wait-free unless the ring of that thread is full. Records are stamped with a
+ * global sequence number and the writer restores the global order within each batch it collects.
+ * When a ring is full the record is either dropped or the producer waits for the writer, depending
+ * on the configured overflow policy.
+ */
+class AsyncRecordQueue {
+public:
+    struct Options {
+        // Number of records each producing thread can have in flight.
+        size_t bufferSize = 1024;
+        // Drop records when the ring of the logging thread is full instead of waiting for space.
+        bool dropOnOverflow = false;
+    };
+
+    // Writes one batch of records, in their logging order. Only called from the writer thread.
+    using WriteBatchFn = std::function<void(const std::vector<const std::string*>&)>;
+
+    AsyncRecordQueue(Options options, WriteBatchFn writeBatch);
+
+    /**
+     * Writes out all pending records and stops the writer thread.
+     */
+    ~AsyncRecordQueue();
+
+    AsyncRecordQueue(const AsyncRecordQueue&) = delete;
+    AsyncRecordQueue& operator=(const AsyncRecordQueue&) = delete;
+
+    /**
+     * Queues a copy of 'formatted' for the writer thread.
+     */
+    void push(const std::string& formatted);
+
+    /**
+     * Blocks until every record pushed before this call has been handed to the write function.
+     */
+    void drain();
+
+    const Options& options() const {
+        return _options;
+    }
+
+    /**
+     * Number of records discarded because of the drop overflow policy.
+     */
+    long long droppedRecords() const {
+        return _numDropped.load();
+    }
+
+private:
+    struct Ring;
+
+    Ring* _threadRing();
+    bool _hasPending();
+    bool _writePending();
+    void _run();
+
+    const Options _options;
+    const WriteBatchFn _writeBatch;
+    const unsigned long long _id;
+
+    AtomicWord<unsigned long long> _nextSeq{0};
+    AtomicWord<long long> _numPushed{0};
+    AtomicWord<long long> _numWritten{0};
+    AtomicWord<long long> _numDropped{0};
+    AtomicWord<bool> _writerIdle{false};
+
+    // Guards the registry of rings, which producers only touch when logging for the first time.
+    stdx::mutex _ringsMutex;  // NOLINT
+    std::vector<std::shared_ptr<Ring>> _rings;
+
+    // Guards the sleeping and waking of the writer and of the threads waiting on it.
+    stdx::mutex _mutex;  // NOLINT
+    stdx::condition_variable _wakeWriter;
+    stdx::condition_variable _batchWritten;
+    bool _shutdown = false;
+    bool _writerExited = false;
+
+    stdx::thread _writer;
+};
+
+/**
+ * boost::log sink backend which decouples the logging threads from the I/O of the wrapped backend.
+ *
+ * When constructed with queue options, records are copied into an AsyncRecordQueue on the logging
+ * thread and written to the wrapped backend by the background writer, which also flushes the
+ * wrapped backend once per batch. Records of severity Error and above drain the queue and are then
+ * written synchronously, so that they are on disk before e.g. a fatal assertion terminates the
+ * process. Without queue options every record is written synchronously.
+ */
+template <typename Backend>
+class AsyncBackend
+    : public boost::log::sinks::basic_formatted_sink_backend<
+          char,
+          boost::log::sinks::combine_requirements<boost::log::sinks::concurrent_feeding,
+                                                  boost::log::sinks::flushing>::type> {
+public:
+    AsyncBackend(boost::shared_ptr<Backend> backend,
+                 boost::optional<AsyncRecordQueue::Options> asyncOptions)
+        : _backend(std::move(backend)) {
+        if (asyncOptions) {
+            _queue = std::make_unique<AsyncRecordQueue>(
+                *asyncOptions, [this](const auto& batch) { _writeBatch(batch); });
+        }
+    }
+
+    /**
+     * Locking accessor to the wrapped backend.
+     */
+    auto lockedBackend() {
+        return boost::log::aux::locking_ptr(_backend, _mutex);
+    }
+
+    bool isAsync() const {
+        return static_cast<bool>(_queue);
+    }
+
+    const AsyncRecordQueue* queue() const {
+        return _queue.get();
+    }
+
+    void consume(boost::log::record_view const& rec, string_type const& formatted_string) {
+        if (_queue) {
+            auto severity = boost::log::extract<LogSeverity>(attributes::severity(), rec);
+            if (!severity || severity.get() < LogSeverity::Error()) {
+                _queue->push(formatted_string);
+                return;
+            }
+            _queue->drain();
+        }
+
+        stdx::lock_guard lock(_mutex);
+        _backend->consume(rec, formatted_string);
+    }
+
+    void flush() {
+        if (_queue) {
+            _queue->drain();
+        }
+
+        stdx::lock_guard lock(_mutex);
+        _flushBackend();
+    }
+
+private:
+    void _writeBatch(const std::vector<const std::string*>& batch) {
+        stdx::lock_guard lock(_mutex);
+        for (auto formatted : batch) {
+            _backend->consume(boost::log::record_view(), *formatted);
+        }
+        _flushBackend();
+    }
+
+    void _flushBackend() {
+        if constexpr (boost::log::sinks::has_requirement<typename Backend::frontend_requirements,
+                                                         boost::log::sinks::flushing>::value) {
+            _backend->flush();
+        }
+    }
+
+    boost::shared_ptr<Backend> _backend;
+
+    // Serializes all access to the wrapped backend.
+    stdx::mutex _mutex;  // NOLINT
+
+    // Declared last so that the writer thread, which uses the members above, is stopped first.
+    std::unique_ptr<AsyncRecordQueue> _queue;
+};
+
+}  // namespace mongo::logv2
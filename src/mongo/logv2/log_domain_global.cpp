@@ -30,6 +30,7 @@
 #include "log_domain_global.h"
 
 #include "mongo/config.h"
+#include "mongo/logv2/async_backend.h"
 #include "mongo/logv2/component_settings_filter.h"
 #include "mongo/logv2/composite_backend.h"
 #include "mongo/logv2/console.h"
@@ -54,7 +55,7 @@ void LogDomainGlobal::ConfigurationOptions::makeDisabled() {
 }
 
 struct LogDomainGlobal::Impl {
-    typedef CompositeBackend<boost::log::sinks::text_ostream_backend,
+    typedef CompositeBackend<AsyncBackend<boost::log::sinks::text_ostream_backend>,
                              RamLogSink,
                              RamLogSink,
                              UserAssertSink>
@@ -66,17 +67,21 @@ struct LogDomainGlobal::Impl {
                              UserAssertSink>
         SyslogBackend;
 #endif
-    typedef CompositeBackend<FileRotateSink, RamLogSink, RamLogSink, UserAssertSink>
+    typedef CompositeBackend<AsyncBackend<FileRotateSink>, RamLogSink, RamLogSink, UserAssertSink>
         RotatableFileBackend;
 
     Impl(LogDomainGlobal& parent);
     Status configure(LogDomainGlobal::ConfigurationOptions const& options);
     Status rotate(bool rename, StringData renameSuffix);
+    void flush();
 
     const ConfigurationOptions& config() const;
 
     LogSource& source();
 
+    boost::shared_ptr<boost::log::sinks::unlocked_sink<ConsoleBackend>> makeConsoleSink(
+        LogDomainGlobal::ConfigurationOptions const& options);
+
     LogDomainGlobal& _parent;
     LogComponentSettings _settings;
     ConfigurationOptions _config;
@@ -90,29 +95,62 @@ struct LogDomainGlobal::Impl {
     bool isInShutdown{false};
 };
 
+namespace {
+boost::optional<AsyncRecordQueue::Options> asyncOptions(
+    LogDomainGlobal::ConfigurationOptions const& options) {
+    if (!options.asyncEnabled)
+        return boost::none;
+
+    AsyncRecordQueue::Options asyncOptions;
+    asyncOptions.bufferSize = options.asyncBufferSize;
+    asyncOptions.dropOnOverflow = options.asyncOverflowPolicy ==
+        LogDomainGlobal::ConfigurationOptions::OverflowPolicy::kDrop;
+    return asyncOptions;
+}
+
+bool asyncOptionsEqual(LogDomainGlobal::ConfigurationOptions const& lhs,
+                       LogDomainGlobal::ConfigurationOptions const& rhs) {
+    if (!lhs.asyncEnabled || !rhs.asyncEnabled)
+        return lhs.asyncEnabled == rhs.asyncEnabled;
+    return lhs.asyncBufferSize == rhs.asyncBufferSize &&
+        lhs.asyncOverflowPolicy == rhs.asyncOverflowPolicy;
+}
+}  // namespace
+
 LogDomainGlobal::Impl::Impl(LogDomainGlobal& parent) : _parent(parent) {
+    _consoleSink = makeConsoleSink(_config);
+
+    // Set default configuration
+    invariant(configure({}).isOK());
+
+    // Make a call to source() to make sure the internal thread_local is created as early as
+    // possible and thus destroyed as late as possible.
+    source();
+}
+
+boost::shared_ptr<boost::log::sinks::unlocked_sink<LogDomainGlobal::Impl::ConsoleBackend>>
+LogDomainGlobal::Impl::makeConsoleSink(LogDomainGlobal::ConfigurationOptions const& options) {
     auto console = boost::make_shared<ConsoleBackend>(
-        boost::make_shared<boost::log::sinks::text_ostream_backend>(),
+        boost::make_shared<AsyncBackend<boost::log::sinks::text_ostream_backend>>(
+            boost::make_shared<boost::log::sinks::text_ostream_backend>(), asyncOptions(options)),
         boost::make_shared<RamLogSink>(RamLog::get("global")),
         boost::make_shared<RamLogSink>(RamLog::get("startupWarnings")),
         boost::make_shared<UserAssertSink>());
 
-    console->lockedBackend<0>()->add_stream(
-        boost::shared_ptr<std::ostream>(&Console::out(), boost::null_deleter()));
-    console->lockedBackend<0>()->auto_flush();
+    {
+        auto backend = console->lockedBackend<0>()->lockedBackend();
+        backend->add_stream(
+            boost::shared_ptr<std::ostream>(&Console::out(), boost::null_deleter()));
+        // The asynchronous writer flushes once per batch instead.
+        backend->auto_flush(!options.asyncEnabled);
+    }
     console->setFilter<2>(
         TaggedSeverityFilter(_parent, {LogTag::kStartupWarnings}, LogSeverity::Log()));
 
-    _consoleSink =
+    auto sink =
         boost::make_shared<boost::log::sinks::unlocked_sink<ConsoleBackend>>(std::move(console));
-    _consoleSink->set_filter(ComponentSettingsFilter(_parent, _settings));
-
-    // Set default configuration
-    invariant(configure({}).isOK());
-
-    // Make a call to source() to make sure the internal thread_local is created as early as
-    // possible and thus destroyed as late as possible.
-    source();
+    sink->set_filter(ComponentSettingsFilter(_parent, _settings));
+    return sink;
 }
 
 Status LogDomainGlobal::Impl::configure(LogDomainGlobal::ConfigurationOptions const& options) {
@@ -159,16 +197,22 @@ Status LogDomainGlobal::Impl::configure(LogDomainGlobal::ConfigurationOptions co
 
     if (options.fileEnabled) {
         auto backend = boost::make_shared<RotatableFileBackend>(
-            boost::make_shared<FileRotateSink>(options.timestampFormat),
+            boost::make_shared<AsyncBackend<FileRotateSink>>(
+                boost::make_shared<FileRotateSink>(options.timestampFormat),
+                asyncOptions(options)),
             boost::make_shared<RamLogSink>(RamLog::get("global")),
             boost::make_shared<RamLogSink>(RamLog::get("startupWarnings")),
             boost::make_shared<UserAssertSink>());
-        Status ret = backend->lockedBackend<0>()->addFile(
-            options.filePath,
-            options.fileOpenMode == ConfigurationOptions::OpenMode::kAppend ? true : false);
-        if (!ret.isOK())
-            return ret;
-        backend->lockedBackend<0>()->auto_flush(true);
+        {
+            auto fileBackend = backend->lockedBackend<0>()->lockedBackend();
+            Status ret = fileBackend->addFile(
+                options.filePath,
+                options.fileOpenMode == ConfigurationOptions::OpenMode::kAppend ? true : false);
+            if (!ret.isOK())
+                return ret;
+            // The asynchronous writer flushes once per batch instead.
+            fileBackend->auto_flush(!options.asyncEnabled);
+        }
         backend->setFilter<2>(
             TaggedSeverityFilter(_parent, {LogTag::kStartupWarnings}, LogSeverity::Log()));
 
@@ -182,6 +226,13 @@ Status LogDomainGlobal::Impl::configure(LogDomainGlobal::ConfigurationOptions co
         _rotatableFileSink.reset();
     }
 
+    if (!asyncOptionsEqual(options, _config)) {
+        if (_consoleSink.use_count() > 1) {
+            boost::log::core::get()->remove_sink(_consoleSink);
+        }
+        _consoleSink = makeConsoleSink(options);
+    }
+
     auto setFormatters = [this](auto&& mkFmt) {
         _consoleSink->set_formatter(mkFmt());
         if (_rotatableFileSink)
@@ -225,11 +276,19 @@ const LogDomainGlobal::ConfigurationOptions& LogDomainGlobal::Impl::config() con
 Status LogDomainGlobal::Impl::rotate(bool rename, StringData renameSuffix) {
     if (_rotatableFileSink) {
         auto backend = _rotatableFileSink->locked_backend()->lockedBackend<0>();
-        return backend->rotate(rename, renameSuffix);
+        // Records logged before the rotation belong in the file being rotated away.
+        backend->flush();
+        return backend->lockedBackend()->rotate(rename, renameSuffix);
     }
     return Status::OK();
 }
 
+void LogDomainGlobal::Impl::flush() {
+    _consoleSink->flush();
+    if (_rotatableFileSink)
+        _rotatableFileSink->flush();
+}
+
 LogSource& LogDomainGlobal::Impl::source() {
     // Use a thread_local logger so we don't need to have locking. thread_locals are destroyed
     // before statics so keep track of number of thread_locals we have active and if this code
@@ -283,6 +342,10 @@ Status LogDomainGlobal::rotate(bool rename, StringData renameSuffix) {
     return _impl->rotate(rename, renameSuffix);
 }
 
+void LogDomainGlobal::flush() {
+    _impl->flush();
+}
+
 LogComponentSettings& LogDomainGlobal::settings() {
     return _impl->_settings;
 }
@@ -39,6 +39,7 @@ public:
     struct ConfigurationOptions {
         enum class RotationMode { kRename, kReopen };
         enum class OpenMode { kTruncate, kAppend };
+        enum class OverflowPolicy { kBlock, kDrop };
 
         bool consoleEnabled{true};
         bool fileEnabled{false};
@@ -50,6 +51,11 @@ public:
         int syslogFacility{-1};  // invalid facility by default, must be set
         LogFormat format{LogFormat::kDefault};
         const AtomicWord<int32_t>* maxAttributeSizeKB = nullptr;
+        // Console and file records are written by a background thread, each logging thread can
+        // have up to 'asyncBufferSize' records in flight.
+        bool asyncEnabled{false};
+        size_t asyncBufferSize{1024};
+        OverflowPolicy asyncOverflowPolicy{OverflowPolicy::kBlock};
 
         void makeDisabled();
     };
@@ -62,6 +68,9 @@ public:
     Status configure(ConfigurationOptions const& options);
     Status rotate(bool rename, StringData renameSuffix);
 
+    // Waits until the records queued for asynchronous writing have been written.
+    void flush();
+
     const ConfigurationOptions& config() const;
 
     LogComponentSettings& settings();
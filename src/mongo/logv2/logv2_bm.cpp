@@ -29,6 +29,7 @@
 
 #define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kDefault
 
+#include "mongo/logv2/async_backend.h"
 #include "mongo/logv2/component_settings_filter.h"
 #include "mongo/logv2/log.h"
 #include "mongo/logv2/log_domain_global.h"
@@ -40,6 +41,7 @@
 #include <boost/iostreams/stream.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
 #include <boost/log/sinks/text_ostream_backend.hpp>
+#include <boost/log/sinks/unlocked_frontend.hpp>
 #include <boost/make_shared.hpp>
 #include <iostream>
 
@@ -52,13 +54,16 @@ boost::shared_ptr<std::ostream> makeNullStream() {
     return boost::make_shared<bios::stream<bios::null_sink>>(bios::null_sink{});
 }
 
+// How the benchmark sink writes records. All modes discard the output.
+enum class SinkMode { kSync, kAsyncBlock, kAsyncDrop };
+
 // RAII style helper class for init/deinit new log system
 class ScopedLogV2Bench {
 public:
-    ScopedLogV2Bench(benchmark::State& state) {
+    ScopedLogV2Bench(benchmark::State& state, SinkMode mode = SinkMode::kSync) {
         _shouldInit = state.thread_index == 0;
         if (_shouldInit) {
-            setupAppender();
+            setupAppender(mode);
         }
     }
 
@@ -69,7 +74,7 @@ public:
     }
 
 private:
-    void setupAppender() {
+    void setupAppender(SinkMode mode) {
         logv2::LogDomainGlobal::ConfigurationOptions config;
         config.makeDisabled();
         invariant(logv2::LogManager::global().getGlobalDomainInternal().configure(config).isOK());
@@ -78,22 +83,39 @@ private:
         backend->add_stream(makeNullStream());
         backend->auto_flush(true);
 
-        _sink = boost::make_shared<
-            boost::log::sinks::synchronous_sink<boost::log::sinks::text_ostream_backend>>(backend);
-        _sink->set_filter(
+        if (mode == SinkMode::kSync) {
+            _sink = configureSink(boost::make_shared<boost::log::sinks::synchronous_sink<
+                                      boost::log::sinks::text_ostream_backend>>(backend));
+        } else {
+            // The asynchronous writer flushes once per batch.
+            backend->auto_flush(false);
+
+            logv2::AsyncRecordQueue::Options options;
+            options.dropOnOverflow = mode == SinkMode::kAsyncDrop;
+            using AsyncBackend = logv2::AsyncBackend<boost::log::sinks::text_ostream_backend>;
+            auto async = boost::make_shared<AsyncBackend>(backend, options);
+            _sink = configureSink(
+                boost::make_shared<boost::log::sinks::unlocked_sink<AsyncBackend>>(async));
+        }
+        boost::log::core::get()->add_sink(_sink);
+    }
+
+    template <typename SinkPtr>
+    static SinkPtr configureSink(SinkPtr sink) {
+        sink->set_filter(
             logv2::ComponentSettingsFilter(logv2::LogManager::global().getGlobalDomain(),
                                            logv2::LogManager::global().getGlobalSettings()));
-        _sink->set_formatter(logv2::TextFormatter());
-        boost::log::core::get()->add_sink(_sink);
+        sink->set_formatter(logv2::TextFormatter());
+        return sink;
     }
 
     void tearDownAppender() {
         boost::log::core::get()->remove_sink(_sink);
+        _sink.reset();
         invariant(logv2::LogManager::global().getGlobalDomainInternal().configure({}).isOK());
     }
 
-    boost::shared_ptr<boost::log::sinks::synchronous_sink<boost::log::sinks::text_ostream_backend>>
-        _sink;
+    boost::shared_ptr<boost::log::sinks::sink> _sink;
     bool _shouldInit;
 };
 
@@ -117,22 +139,22 @@ void BM_NoopLogV2Arg(benchmark::State& state) {
         LOGV2_DEBUG(20075, 1, "noop log {}", "str"_attr = createLongString());
 }
 
-void BM_EnabledLogV2(benchmark::State& state) {
-    ScopedLogV2Bench init(state);
+void BM_EnabledLogV2(benchmark::State& state, SinkMode mode) {
+    ScopedLogV2Bench init(state, mode);
 
     for (auto _ : state)
         LOGV2(20071, "enabled log");
 }
 
-void BM_EnabledLogV2ExpensiveArg(benchmark::State& state) {
-    ScopedLogV2Bench init(state);
+void BM_EnabledLogV2ExpensiveArg(benchmark::State& state, SinkMode mode) {
+    ScopedLogV2Bench init(state, mode);
 
     for (auto _ : state)
         LOGV2(20072, "enabled log {}", "str"_attr = createLongString());
 }
 
-void BM_EnabledLogV2ManySmallArg(benchmark::State& state) {
-    ScopedLogV2Bench init(state);
+void BM_EnabledLogV2ManySmallArg(benchmark::State& state, SinkMode mode) {
+    ScopedLogV2Bench init(state, mode);
 
     for (auto _ : state) {
         LOGV2(20073,
@@ -158,9 +180,19 @@ void ThreadCounts(benchmark::internal::Benchmark* b) {
 
 BENCHMARK(BM_NoopLogV2)->Apply(ThreadCounts);
 BENCHMARK(BM_NoopLogV2Arg)->Apply(ThreadCounts);
-BENCHMARK(BM_EnabledLogV2)->Apply(ThreadCounts);
-BENCHMARK(BM_EnabledLogV2ExpensiveArg)->Apply(ThreadCounts);
-BENCHMARK(BM_EnabledLogV2ManySmallArg)->Apply(ThreadCounts);
+BENCHMARK_CAPTURE(BM_EnabledLogV2, sync, SinkMode::kSync)->Apply(ThreadCounts);
+BENCHMARK_CAPTURE(BM_EnabledLogV2, asyncBlock, SinkMode::kAsyncBlock)->Apply(ThreadCounts);
+BENCHMARK_CAPTURE(BM_EnabledLogV2, asyncDrop, SinkMode::kAsyncDrop)->Apply(ThreadCounts);
+BENCHMARK_CAPTURE(BM_EnabledLogV2ExpensiveArg, sync, SinkMode::kSync)->Apply(ThreadCounts);
+BENCHMARK_CAPTURE(BM_EnabledLogV2ExpensiveArg, asyncBlock, SinkMode::kAsyncBlock)
+    ->Apply(ThreadCounts);
+BENCHMARK_CAPTURE(BM_EnabledLogV2ExpensiveArg, asyncDrop, SinkMode::kAsyncDrop)
+    ->Apply(ThreadCounts);
+BENCHMARK_CAPTURE(BM_EnabledLogV2ManySmallArg, sync, SinkMode::kSync)->Apply(ThreadCounts);
+BENCHMARK_CAPTURE(BM_EnabledLogV2ManySmallArg, asyncBlock, SinkMode::kAsyncBlock)
+    ->Apply(ThreadCounts);
+BENCHMARK_CAPTURE(BM_EnabledLogV2ManySmallArg, asyncDrop, SinkMode::kAsyncDrop)
+    ->Apply(ThreadCounts);
 
 }  // namespace
 }  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/json.h"
 #include "mongo/bson/oid.h"
+#include "mongo/logv2/async_backend.h"
 #include "mongo/logv2/bson_formatter.h"
 #include "mongo/logv2/component_settings_filter.h"
 #include "mongo/logv2/composite_backend.h"
@@ -1516,6 +1517,77 @@ TEST_F(LogV2Test, Threads) {
     ASSERT(linesJson.size() == threads.size() * kNumPerThread);
 }
 
+TEST_F(LogV2Test, AsyncBackend) {
+    std::vector<std::string> lines;
+    AsyncRecordQueue::Options options;
+    options.bufferSize = 16;
+    auto sink = wrapInUnlockedSink(boost::make_shared<AsyncBackend<LogCaptureBackend>>(
+        boost::make_shared<LogCaptureBackend>(lines), options));
+    applyDefaultFilterToSink(sink);
+    sink->set_formatter(PlainFormatter());
+    attachSink(sink);
+
+    constexpr int kNumThreads = 4;
+    constexpr int kNumPerThread = 1000;
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < kNumPerThread; ++i)
+                LOGV2(4798400, "{thread} {i}", "thread"_attr = t, "i"_attr = i);
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    sink->flush();
+
+    // Every record is written and the records of each thread keep their order.
+    ASSERT_EQ(lines.size(), kNumThreads * kNumPerThread);
+    std::vector<int> next(kNumThreads, 0);
+    for (const auto& line : lines) {
+        std::istringstream is(line);
+        int t, i;
+        is >> t >> i;
+        ASSERT_EQ(i, next[t]++);
+    }
+}
+
+TEST_F(LogV2Test, AsyncBackendDropOnOverflow) {
+    std::vector<std::string> lines;
+    AsyncRecordQueue::Options options;
+    options.bufferSize = 1;
+    options.dropOnOverflow = true;
+    auto backend = boost::make_shared<AsyncBackend<LogCaptureBackend>>(
+        boost::make_shared<LogCaptureBackend>(lines), options);
+    auto sink = wrapInUnlockedSink(backend);
+    applyDefaultFilterToSink(sink);
+    sink->set_formatter(PlainFormatter());
+    attachSink(sink);
+
+    constexpr int kNumRecords = 1000;
+    for (int i = 0; i < kNumRecords; ++i)
+        LOGV2(4798401, "test {i}", "i"_attr = i);
+    sink->flush();
+
+    ASSERT_EQ(lines.size() + backend->queue()->droppedRecords(), kNumRecords);
+}
+
+TEST_F(LogV2Test, AsyncBackendErrorIsSynchronous) {
+    std::vector<std::string> lines;
+    auto sink = wrapInUnlockedSink(boost::make_shared<AsyncBackend<LogCaptureBackend>>(
+        boost::make_shared<LogCaptureBackend>(lines), AsyncRecordQueue::Options{}));
+    applyDefaultFilterToSink(sink);
+    sink->set_formatter(PlainFormatter());
+    attachSink(sink);
+
+    // The error drains the records queued before it and is written before LOGV2_ERROR returns.
+    LOGV2(4798402, "info");
+    LOGV2_ERROR(4798403, "error");
+    ASSERT_EQ(lines.size(), 2);
+    ASSERT_EQ(lines[0], "info");
+    ASSERT_EQ(lines[1], "error");
+}
+
 TEST_F(LogV2Test, Ramlog) {
     RamLog* ramlog = RamLog::get("test_ramlog");
     auto sink = wrapInUnlockedSink(boost::make_shared<RamLogSink>(ramlog));
@@ -32,6 +32,7 @@
 #include "mongo/rpc/message.h"
 
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -43,4 +44,25 @@ int32_t nextMessageId() {
     return NextMsgId.fetchAndAdd(1);
 }
 
+void Message::_flattenSlow() const {
+    auto flattened = SharedBuffer::allocate(size());
+    size_t pos = 0;
+    forEachSegment([&](const char* data, size_t size) {
+        memcpy(flattened.get() + pos, data, size);
+        pos += size;
+    });
+    invariant(pos == static_cast<size_t>(size()));
+
+    _buf = std::move(flattened);
+    _fragments.clear();
+}
+
+int Message::_bufferedSize() const {
+    int size = this->size();
+    for (const auto& fragment : _fragments) {
+        size -= fragment.size;
+    }
+    return size;
+}
+
 }  // namespace mongo
@@ -30,11 +30,13 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/encoded_value_storage.h"
 #include "mongo/base/static_assert.h"
+#include "mongo/util/shared_buffer.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -390,18 +392,53 @@ inline int ConstView::dataLen() const {
 
 }  // namespace MsgData
 
+/**
+ * A wire protocol message.
+ *
+ * A message may be fragmented: some of its bytes are then held by other buffers (typically large
+ * documents that a reply references rather than copies) and are logically inserted into the
+ * message buffer at recorded offsets. The header always lives in the message buffer. Accessors
+ * that expose the data of the message flatten it into a single buffer first, so only code that
+ * is written for fragments, like the networking layer using forEachSegment(), avoids the copy.
+ */
 class Message {
 public:
+    /**
+     * Bytes held outside of the message buffer that logically precede the byte at "offset" in it.
+     */
+    struct Fragment {
+        int offset;
+        ConstSharedBuffer owner;
+        const char* data;
+        int size;
+    };
+
     Message() = default;
     explicit Message(SharedBuffer data) : _buf(std::move(data)) {}
 
+    /**
+     * Fragments must be ordered by offset, and the length in the header of "data" must account for
+     * their bytes.
+     */
+    Message(SharedBuffer data, std::vector<Fragment> fragments)
+        : _buf(std::move(data)), _fragments(std::move(fragments)) {}
+
     MsgData::View header() const {
+        _flatten();
+        return headerWithoutFlattening();
+    }
+
+    /**
+     * Returns a view that may only be used to access the header and the first four bytes of the
+     * data, which are never part of a fragment.
+     */
+    MsgData::View headerWithoutFlattening() const {
         verify(!empty());
         return _buf.get();
     }
 
     NetworkOp operation() const {
-        return header().getNetworkOp();
+        return headerWithoutFlattening().getNetworkOp();
     }
 
     MsgData::View singleData() const {
@@ -413,6 +450,10 @@ public:
         return !_buf;
     }
 
+    bool isFragmented() const {
+        return !_fragments.empty();
+    }
+
     int size() const {
         if (_buf) {
             return MsgData::ConstView(_buf.get()).getLen();
@@ -425,15 +466,18 @@ public:
     }
 
     size_t capacity() const {
+        _flatten();
         return _buf.capacity();
     }
 
     void realloc(size_t size) {
+        _flatten();
         _buf.reallocOrCopy(size);
     }
 
     void reset() {
         _buf = {};
+        _fragments.clear();
     }
 
     // use to set first buffer if empty
@@ -456,23 +500,62 @@ public:
     }
 
     char* buf() {
+        _flatten();
         return _buf.get();
     }
 
     const char* buf() const {
+        _flatten();
         return _buf.get();
     }
 
     SharedBuffer sharedBuffer() {
+        _flatten();
         return _buf;
     }
 
     ConstSharedBuffer sharedBuffer() const {
+        _flatten();
         return _buf;
     }
 
+    /**
+     * Calls "callback(const char* data, size_t size)" for each non-empty contiguous segment of the
+     * message, in order, without flattening it.
+     */
+    template <typename Callback>
+    void forEachSegment(Callback&& callback) const {
+        if (empty()) {
+            return;
+        }
+        const auto segment = [&](const char* data, size_t size) {
+            if (size) {
+                callback(data, size);
+            }
+        };
+        int pos = 0;
+        for (const auto& fragment : _fragments) {
+            segment(_buf.get() + pos, fragment.offset - pos);
+            segment(fragment.data, fragment.size);
+            pos = fragment.offset;
+        }
+        segment(_buf.get() + pos, _bufferedSize() - pos);
+    }
+
 private:
-    SharedBuffer _buf;
+    void _flatten() const {
+        if (MONGO_unlikely(isFragmented())) {
+            _flattenSlow();
+        }
+    }
+
+    void _flattenSlow() const;
+
+    // The number of bytes of the message that are held in the message buffer.
+    int _bufferedSize() const;
+
+    mutable SharedBuffer _buf;
+    mutable std::vector<Fragment> _fragments;
 };
 
 /**
@@ -83,7 +83,8 @@ uint32_t OpMsg::flags(const Message& message) {
     if (message.operation() != dbMsg)
         return 0;  // Other command protocols are the same as no flags set.
 
-    return BufReader(message.singleData().data(), message.dataSize())
+    // The flags are never part of a fragment, so there is no need to flatten the message.
+    return BufReader(message.headerWithoutFlattening().data(), message.dataSize())
         .read<LittleEndian<uint32_t>>();
 }
 
@@ -92,7 +93,7 @@ void OpMsg::replaceFlags(Message* message, uint32_t flags) {
     invariant(message->operation() == dbMsg);
     invariant(message->dataSize() >= static_cast<int>(sizeof(uint32_t)));
 
-    DataView(message->singleData().data()).write<LittleEndian<uint32_t>>(flags);
+    DataView(message->headerWithoutFlattening().data()).write<LittleEndian<uint32_t>>(flags);
 }
 
 uint32_t OpMsg::getChecksum(const Message& message) {
@@ -306,8 +307,34 @@ BSONObjBuilder OpMsgBuilder::resumeBody() {
 
 AtomicWord<bool> OpMsgBuilder::disableDupeFieldCheck_forTest{false};
 
+void OpMsgBuilder::appendBodyFragment(const BSONObj& obj) {
+    invariant(_state == kBody);
+    invariant(obj.isOwned());
+    _fragments.push_back({_buf.len(), obj.sharedBuffer(), obj.objdata(), obj.objsize()});
+    _fragmentBytes += obj.objsize();
+}
+
+void OpMsgBuilder::applyFragmentLengths() {
+    const auto addToLength = [&](int lengthOffset, int bytes) {
+        DataView view(_buf.buf());
+        view.write<LittleEndian<int32_t>>(view.read<LittleEndian<int32_t>>(lengthOffset) + bytes,
+                                          lengthOffset);
+    };
+
+    for (auto lengthOffset : _fragmentContainers) {
+        int bytes = 0;
+        for (const auto& fragment : _fragments) {
+            if (fragment.offset > lengthOffset) {
+                bytes += fragment.size;
+            }
+        }
+        addToLength(lengthOffset, bytes);
+    }
+    addToLength(_bodyStart, _fragmentBytes);
+}
+
 Message OpMsgBuilder::finish() {
-    const auto size = _buf.len();
+    const auto size = _buf.len() + _fragmentBytes;
     uassert(ErrorCodes::BSONObjectTooLarge,
             str::stream() << "BSON size limit hit while building Message. Size: " << size << " (0x"
                           << integerToHex(size) << "); maxSize: " << BSONObjMaxInternalSize << "("
@@ -336,12 +363,16 @@ Message OpMsgBuilder::finishWithoutSizeChecking() {
     invariant(!_openBuilder);
     _state = kDone;
 
-    const auto size = _buf.len();
+    const auto size = _buf.len() + _fragmentBytes;
     MSGHEADER::View header(_buf.buf());
     header.setMessageLength(size);
     // header.setRequestMsgId(...); // These are currently filled in by the networking layer.
     // header.setResponseToMsgId(...);
     header.setOpCode(dbMsg);
+    if (!_fragments.empty()) {
+        applyFragmentLengths();
+        return Message(_buf.release(), std::move(_fragments));
+    }
     return Message(_buf.release());
 }
 
@@ -350,6 +381,13 @@ BSONObj OpMsgBuilder::releaseBody() {
     invariant(_bodyStart);
     invariant(_bodyStart == sizeof(MSGHEADER::Layout) + 4 /*flags*/ + 1 /*body kind byte*/);
     invariant(!_openBuilder);
+
+    if (!_fragments.empty()) {
+        // Flattening the finished message copies the fragments into the buffer that holds the body.
+        auto buffer = finishWithoutSizeChecking().sharedBuffer();
+        return BSONObj(buffer.get() + _bodyStart).shareOwnershipWith(std::move(buffer));
+    }
+
     _state = kDone;
 
     auto bson = BSONObj(_buf.buf() + _bodyStart);
@@ -261,6 +261,9 @@ public:
         _buf.reset();
         skipHeaderAndFlags();
         _bodyStart = 0;
+        _fragments.clear();
+        _fragmentContainers.clear();
+        _fragmentBytes = 0;
         _state = kEmpty;
         _openBuilder = false;
     }
@@ -292,6 +295,33 @@ public:
         _buf.claimReservedBytes(bytes);
     }
 
+    /**
+     * Makes the owned document "obj" the next bytes of the body without copying it. The finished
+     * Message then references "obj" as a fragment. It is illegal to call this unless a body
+     * builder is open, and the caller must already have appended the element header that the
+     * document completes.
+     *
+     * The lengths of the body and of any object registered with addFragmentContainer() account
+     * for the fragments only once the message is finished, so until then the body must not be
+     * inspected below the top level of the object that holds the fragments.
+     */
+    void appendBodyFragment(const BSONObj& obj);
+
+    /**
+     * Registers the offset of the length of an object in the body, so that finishing the message
+     * adds the size of the fragments appended after that offset to it.
+     */
+    void addFragmentContainer(int lengthOffset) {
+        _fragmentContainers.push_back(lengthOffset);
+    }
+
+    /**
+     * The number of bytes of the body held in fragments.
+     */
+    int fragmentBytes() const {
+        return _fragmentBytes;
+    }
+
 private:
     friend class DocSequenceBuilder;
 
@@ -304,6 +334,12 @@ private:
 
     void finishDocumentStream(DocSequenceBuilder* docSequenceBuilder);
 
+    /**
+     * Adds the size of the fragments to the lengths of the objects that contain them. Must only be
+     * called once the body is complete.
+     */
+    void applyFragmentLengths();
+
     void skipHeaderAndFlags() {
         _buf.skip(sizeof(MSGHEADER::Layout));  // This is filled in by finish().
         _buf.appendNum(uint32_t(0));           // flags (currently always 0).
@@ -312,6 +348,9 @@ private:
     // When adding members, remember to update reset().
     BufBuilder _buf;
     int _bodyStart = 0;
+    std::vector<Message::Fragment> _fragments;
+    std::vector<int> _fragmentContainers;
+    int _fragmentBytes = 0;
     State _state = kEmpty;
     bool _openBuilder = false;
 };
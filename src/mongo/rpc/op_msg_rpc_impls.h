@@ -66,6 +66,15 @@ public:
     OpMsgBuilder::DocSequenceBuilder getDocSequenceBuilder(StringData name) override {
         return _builder.beginDocSequence(name);
     }
+    bool supportsBodyFragments() const override {
+        return true;
+    }
+    void appendBodyFragment(const BSONObj& obj) override {
+        _builder.appendBodyFragment(obj);
+    }
+    void addBodyFragmentContainer(int lengthOffset) override {
+        _builder.addFragmentContainer(lengthOffset);
+    }
     rpc::Protocol getProtocol() const override {
         return rpc::Protocol::kOpMsg;
     }
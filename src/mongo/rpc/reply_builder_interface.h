@@ -35,6 +35,7 @@
 #include "mongo/bson/util/builder.h"
 #include "mongo/rpc/op_msg.h"
 #include "mongo/rpc/protocol.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 class BSONObj;
@@ -76,6 +77,26 @@ public:
         uasserted(50875, "Only OpMsg may use document sequences");
     }
 
+    /**
+     * Returns true if owned documents can be referenced in the body with appendBodyFragment()
+     * rather than copied into it. See OpMsgBuilder::appendBodyFragment().
+     */
+    virtual bool supportsBodyFragments() const {
+        return false;
+    }
+
+    virtual void appendBodyFragment(const BSONObj& obj) {
+        MONGO_UNREACHABLE;
+    }
+
+    /**
+     * Registers the offset, in the buffer of the body builder, of the length of an object which
+     * contains body fragments.
+     */
+    virtual void addBodyFragmentContainer(int lengthOffset) {
+        MONGO_UNREACHABLE;
+    }
+
     /**
      * Sets the reply for this command. If an engaged StatusWith<BSONObj> is passed, the command
      * reply will be set to the contained BSONObj, augmented with the element {ok, 1.0} if it
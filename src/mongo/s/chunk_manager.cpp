@@ -215,40 +215,69 @@ void validateChunk(const std::shared_ptr<ChunkInfo>& chunk, const ChunkVersion&
 }
 
 ChunkMap ChunkMap::createMerged(const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks) {
-    size_t chunkMapIndex = 0;
-    size_t changedChunkIndex = 0;
-
     ChunkMap updatedChunkMap(getVersion().epoch(), _chunkMap.size() + changedChunks.size());
+    updatedChunkMap._collectionVersion = getVersion();
 
-    while (chunkMapIndex < _chunkMap.size() || changedChunkIndex < changedChunks.size()) {
-        if (chunkMapIndex >= _chunkMap.size()) {
-            validateChunk(changedChunks[changedChunkIndex], getVersion());
-            updatedChunkMap.appendChunk(changedChunks[changedChunkIndex++]);
-            continue;
+    // Both the existing chunks and the changed chunks are ordered by max key and do not overlap,
+    // so the ranges of existing chunks untouched by the refresh are located with binary searches
+    // on the precomputed max KeyStrings and copied over wholesale. This keeps the BSON range
+    // comparisons proportional to the number of changed chunks rather than to the routing table.
+    //
+    // Only the first chunk of a copied range can overlap the previously appended changed chunk, so
+    // it alone goes through appendChunk, which discards it if it is older.
+    auto appendRange = [&updatedChunkMap](ChunkVector::const_iterator begin,
+                                          ChunkVector::const_iterator end) {
+        if (begin == end)
+            return;
+        updatedChunkMap.appendChunk(*begin);
+        updatedChunkMap._chunkMap.insert(updatedChunkMap._chunkMap.end(), std::next(begin), end);
+    };
+
+    auto current = _chunkMap.cbegin();
+    for (const auto& changedChunk : changedChunks) {
+        validateChunk(changedChunk, getVersion());
+
+        // The first existing chunk whose max is greater than the min of the changed chunk is the
+        // first one it overlaps.
+        const auto changedMinKeyString = ShardKeyPattern::toKeyString(changedChunk->getMin());
+        const auto firstOverlap = std::upper_bound(
+            current, _chunkMap.cend(), changedMinKeyString, [](const auto& key, const auto& chunk) {
+                return key < chunk->getMaxKeyString();
+            });
+
+        // Every chunk up to the first one whose max reaches the max of the changed chunk overlaps
+        // it, and that one does as well unless it starts at or after the changed chunk's max.
+        auto endOverlap = std::lower_bound(
+            firstOverlap,
+            _chunkMap.cend(),
+            changedChunk->getMaxKeyString(),
+            [](const auto& chunk, const auto& key) { return chunk->getMaxKeyString() < key; });
+        if (endOverlap != _chunkMap.cend() &&
+            SimpleBSONObjComparator::kInstance.evaluate((*endOverlap)->getMin() <
+                                                        changedChunk->getMax())) {
+            ++endOverlap;
         }
 
-        if (changedChunkIndex >= changedChunks.size()) {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
-            continue;
+        // The changed chunk inherits the writes tracked against the first chunk it replaces.
+        if (firstOverlap != endOverlap) {
+            auto bytesInReplacedChunk = (*firstOverlap)->getWritesTracker()->getBytesWritten();
+            changedChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
         }
 
-        auto overlap = _chunkMap[chunkMapIndex]->getRange().overlaps(
-            changedChunks[changedChunkIndex]->getRange());
-
-        if (overlap) {
-            auto& changedChunk = changedChunks[changedChunkIndex++];
-            auto& chunkInfo = _chunkMap[chunkMapIndex];
+        appendRange(current, firstOverlap);
+        updatedChunkMap.appendChunk(changedChunk);
 
-            auto bytesInReplacedChunk = chunkInfo->getWritesTracker()->getBytesWritten();
-            changedChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
-
-            validateChunk(changedChunk, getVersion());
-            updatedChunkMap.appendChunk(changedChunk);
-        } else {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
-        }
+        // A split leaves a replaced chunk overlapping the next changed chunk as well, so only the
+        // chunks that end within this one are consumed.
+        current = std::lower_bound(
+            firstOverlap,
+            endOverlap,
+            changedChunk->getMaxKeyString(),
+            [](const auto& chunk, const auto& key) { return chunk->getMaxKeyString() <= key; });
     }
 
+    appendRange(current, _chunkMap.cend());
+
     return updatedChunkMap;
 }
 
@@ -358,6 +387,12 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj
 }
 
 bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const {
+    return keyBelongsToShard(shardKey, shardId, nullptr);
+}
+
+bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey,
+                                     const ShardId& shardId,
+                                     boost::optional<ChunkRange>* chunkRange) const {
     if (shardKey.isEmpty())
         return false;
 
@@ -367,6 +402,9 @@ bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& sha
 
     invariant(chunkInfo->containsKey(shardKey));
 
+    if (chunkRange)
+        *chunkRange = chunkInfo->getRange();
+
     return chunkInfo->getShardIdAt(_clusterTime) == shardId;
 }
 
@@ -373,6 +373,16 @@ public:
      */
     bool keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const;
 
+    /**
+     * Same as above, but also returns in "chunkRange" the bounds of the chunk which contains
+     * "shardKey", so that callers checking many keys can answer for subsequent keys which fall in
+     * the same range without repeating the lookup. "chunkRange" is left unchanged if "shardKey" is
+     * empty or is not contained in any chunk.
+     */
+    bool keyBelongsToShard(const BSONObj& shardKey,
+                           const ShardId& shardId,
+                           boost::optional<ChunkRange>* chunkRange) const;
+
     /**
      * Returns true if any chunk owned by the shard with the given "shardId" overlaps "range".
      */
@@ -85,6 +85,7 @@
 #include "mongo/s/transaction_router.h"
 #include "mongo/transport/ismaster_metrics.h"
 #include "mongo/transport/session.h"
+#include "mongo/util/cpu_profiler.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
@@ -312,6 +313,7 @@ void runCommand(OperationContext* opCtx,
     }
 
     CommandHelpers::uassertShouldAttemptParse(opCtx, command, request);
+    CpuProfiler::ScopedTag cpuProfilerTag(command->getName());
 
     // Parse the 'maxTimeMS' command option, and use it to set a deadline for the operation on
     // the OperationContext. Be sure to do this as soon as possible so that further processing by
@@ -336,6 +338,23 @@ void runCommand(OperationContext* opCtx,
         opCtx->setComment(commentField.wrap());
     }
 
+    // Shards treat mongos as an internal client, so a raised admission priority is only forwarded
+    // to them on behalf of clients which could have requested it from the shards directly.
+    if (auto admissionPriorityField = request.body["admissionPriority"]) {
+        uassert(ErrorCodes::TypeMismatch,
+                "admissionPriority must be a string",
+                admissionPriorityField.type() == String);
+        const auto priority =
+            uassertStatusOK(parseAdmissionPriority(admissionPriorityField.valueStringData()));
+        uassert(ErrorCodes::Unauthorized,
+                "Only users authorized for internal actions can use admissionPriority 'high'",
+                priority != AdmissionPriority::kHigh ||
+                    AuthorizationSession::get(opCtx->getClient())
+                        ->isAuthorizedForActionsOnResource(ResourcePattern::forClusterResource(),
+                                                           ActionType::internal));
+        opCtx->setAdmissionPriority(priority);
+    }
+
     std::shared_ptr<CommandInvocation> invocation = command->parse(opCtx, request);
     CommandInvocation::set(opCtx, invocation);
 
@@ -45,6 +45,33 @@ const std::set<std::string> supportedCmds{"collStats",
                                           "listCollections",
                                           "listIndexes",
                                           "planCacheListFilters"};
+
+// Aggregation stages that write, consume cursors opened by another request, or must stay on the
+// node they were opened on. An aggregate containing any of them is not hedged.
+const std::set<StringData> unhedgeableStages{"$changeStream", "$merge", "$mergeCursors", "$out"};
+
+/**
+ * Returns true if the aggregate 'cmdObj' only reads, so that running it twice is harmless. The
+ * cursor opened by whichever request loses the race is killed by the network interface.
+ */
+bool isHedgeableAggregate(const BSONObj& cmdObj) {
+    if (cmdObj.hasField("exchange")) {
+        return false;
+    }
+
+    auto pipeline = cmdObj["pipeline"];
+    if (pipeline.type() != Array) {
+        return false;
+    }
+
+    for (auto&& stage : pipeline.Obj()) {
+        if (stage.type() != Object || stage.Obj().isEmpty() ||
+            unhedgeableStages.count(stage.Obj().firstElementFieldNameStringData())) {
+            return false;
+        }
+    }
+    return true;
+}
 }  // namespace
 
 boost::optional<executor::RemoteCommandRequestOnAny::HedgeOptions> extractHedgeOptions(
@@ -56,7 +83,9 @@ boost::optional<executor::RemoteCommandRequestOnAny::HedgeOptions> extractHedgeO
 
     auto cmdName(cmdObj.firstElement().fieldNameStringData().toString());
 
-    if (supportedCmds.count(cmdName)) {
+    // A getMore must go to the host that owns the cursor, so it is never hedged.
+    if (supportedCmds.count(cmdName) ||
+        (cmdName == "aggregate" && gReadHedgingAggregates.load() && isHedgeableAggregate(cmdObj))) {
         return executor::RemoteCommandRequestOnAny::HedgeOptions{1,
                                                                  gMaxTimeMSForHedgedReads.load()};
     }
@@ -93,10 +93,12 @@ protected:
     static inline const std::string kReadHedgingModeFieldName = "readHedgingMode";
     static inline const std::string kMaxTimeMSForHedgedReadsFieldName = "maxTimeMSForHedgedReads";
     static inline const int kMaxTimeMSForHedgedReadsDefault = 10;
+    static inline const std::string kReadHedgingAggregatesFieldName = "readHedgingAggregates";
 
-    static inline const BSONObj kDefaultParameters =
-        BSON(kReadHedgingModeFieldName << "on" << kMaxTimeMSForHedgedReadsFieldName
-                                       << kMaxTimeMSForHedgedReadsDefault);
+    static inline const BSONObj kDefaultParameters = BSON(
+        kReadHedgingModeFieldName << "on" << kMaxTimeMSForHedgedReadsFieldName
+                                  << kMaxTimeMSForHedgedReadsDefault
+                                  << kReadHedgingAggregatesFieldName << false);
 
 private:
     ServiceContext::UniqueServiceContext _serviceCtx = ServiceContext::make();
@@ -125,7 +127,71 @@ TEST_F(HedgeOptionsUtilTestFixture, ImplicitOperationHedging) {
 TEST_F(HedgeOptionsUtilTestFixture, BlacklistAggregate) {
     const auto parameters = BSONObj();
     const auto cmdObj =
-        BSON("aggregate" << kCollName << "pipeline" << BSONObj() << "cursor" << BSONObj());
+        BSON("aggregate" << kCollName << "pipeline" << BSONArray() << "cursor" << BSONObj());
+    const auto rspObj = BSON("mode"
+                             << "nearest"
+                             << "hedge" << BSONObj());
+
+    checkHedgeOptions(parameters, cmdObj, rspObj, false);
+}
+
+TEST_F(HedgeOptionsUtilTestFixture, ReadOnlyAggregate) {
+    const auto parameters = BSON(kReadHedgingAggregatesFieldName << true);
+    const auto rspObj = BSON("mode"
+                             << "nearest"
+                             << "hedge" << BSONObj());
+
+    {
+        const auto cmdObj =
+            BSON("aggregate" << kCollName << "pipeline" << BSONArray() << "cursor" << BSONObj());
+        checkHedgeOptions(parameters, cmdObj, rspObj, true);
+    }
+
+    {
+        const auto cmdObj = BSON("aggregate" << kCollName << "pipeline"
+                                             << BSON_ARRAY(BSON("$match" << BSON("x" << 1))
+                                                           << BSON("$project" << BSON("x" << 1)))
+                                             << "cursor" << BSONObj());
+        checkHedgeOptions(parameters, cmdObj, rspObj, true);
+    }
+}
+
+TEST_F(HedgeOptionsUtilTestFixture, BlacklistAggregateWithUnhedgeableStages) {
+    const auto parameters = BSON(kReadHedgingAggregatesFieldName << true);
+    const auto rspObj = BSON("mode"
+                             << "nearest"
+                             << "hedge" << BSONObj());
+
+    for (auto&& stage : {BSON("$out"
+                              << "targetColl"),
+                         BSON("$merge"
+                              << "targetColl"),
+                         BSON("$mergeCursors" << BSONObj()),
+                         BSON("$changeStream" << BSONObj())}) {
+        const auto cmdObj = BSON("aggregate" << kCollName << "pipeline"
+                                             << BSON_ARRAY(BSON("$match" << BSONObj()) << stage)
+                                             << "cursor" << BSONObj());
+        checkHedgeOptions(parameters, cmdObj, rspObj, false);
+    }
+}
+
+TEST_F(HedgeOptionsUtilTestFixture, BlacklistAggregateWithExchange) {
+    const auto parameters = BSON(kReadHedgingAggregatesFieldName << true);
+    const auto cmdObj = BSON("aggregate" << kCollName << "pipeline" << BSONArray() << "exchange"
+                                         << BSON("policy"
+                                                 << "roundrobin"
+                                                 << "consumers" << 2)
+                                         << "cursor" << BSONObj());
+    const auto rspObj = BSON("mode"
+                             << "nearest"
+                             << "hedge" << BSONObj());
+
+    checkHedgeOptions(parameters, cmdObj, rspObj, false);
+}
+
+TEST_F(HedgeOptionsUtilTestFixture, BlacklistGetMore) {
+    const auto parameters = BSONObj();
+    const auto cmdObj = BSON("getMore" << 1LL << "collection" << kCollName);
     const auto rspObj = BSON("mode"
                              << "nearest"
                              << "hedge" << BSONObj());
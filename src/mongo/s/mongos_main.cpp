@@ -107,6 +107,7 @@
 #include "mongo/util/cmdline_utils/censor_cmdline.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/cpu_profiler.h"
 #include "mongo/util/exception_filter_win32.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fast_clock_source_factory.h"
@@ -975,6 +976,9 @@ ExitCode mongos_main(int argc, char* argv[]) {
 
         startSignalProcessingThread();
 
+        // The CPU profiler only samples the threads created after it starts.
+        CpuProfiler::startIfEnabled();
+
         return main(service);
     } catch (const DBException& e) {
         LOGV2_ERROR(22862,
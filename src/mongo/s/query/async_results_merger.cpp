@@ -86,7 +86,9 @@ BSONObj extractSortKey(BSONObj obj, bool compareWholeSortKey) {
  * Returns an int less than 0 if 'leftSortKey' < 'rightSortKey', 0 if the two are equal, and an int
  * > 0 if 'leftSortKey' > 'rightSortKey' according to the pattern 'sortKeyPattern'.
  */
-int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPattern) {
+int compareSortKeys(const BSONObj& leftSortKey,
+                    const BSONObj& rightSortKey,
+                    const BSONObj& sortKeyPattern) {
     // This does not need to sort with a collator, since mongod has already mapped strings to their
     // ICU comparison keys as part of the $sortKey meta projection.
     const BSONObj::ComparisonRulesSet rules = 0;  // 'considerFieldNames' flag is not set.
@@ -105,8 +107,7 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(
-          _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
+      _mergeQueue(MergingComparator(_params.getSort().value_or(BSONObj()))),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
@@ -311,10 +312,7 @@ bool AsyncResultsMerger::_readySortedTailable(WithLock lk) {
         return false;
     }
 
-    auto smallestRemote = _mergeQueue.top();
-    auto smallestResult = _remotes[smallestRemote].docBuffer.front();
-    auto keyWeWantToReturn =
-        extractSortKey(*smallestResult.getResult(), _params.getCompareWholeSortKey());
+    const auto& keyWeWantToReturn = _mergeQueue.top().first;
     // We should always have a minPromisedSortKey from every shard in the sorted tailable case.
     auto minPromisedSortKey = _getMinPromisedSortKey(lk);
     invariant(minPromisedSortKey);
@@ -355,7 +353,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
@@ -363,7 +361,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
         return {};
     }
 
-    size_t smallestRemote = _mergeQueue.top();
+    size_t smallestRemote = _mergeQueue.top().second;
     _mergeQueue.pop();
 
     invariant(!_remotes[smallestRemote].docBuffer.empty());
@@ -375,7 +373,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
     if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+        _pushToMergeQueue(lk, smallestRemote);
     }
 
     // For sorted tailable awaitData cursors, update the high water mark to the document's sort key.
@@ -389,6 +387,12 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     return front;
 }
 
+void AsyncResultsMerger::_pushToMergeQueue(WithLock, size_t remoteIndex) {
+    const auto& front = _remotes[remoteIndex].docBuffer.front();
+    _mergeQueue.emplace(extractSortKey(*front.getResult(), _params.getCompareWholeSortKey()),
+                        remoteIndex);
+}
+
 ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
@@ -790,7 +794,7 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
     // queue.
     if (_params.getSort() && !response.getBatch().empty()) {
-        _mergeQueue.push(remoteIndex);
+        _pushToMergeQueue(lk, remoteIndex);
     }
     return true;
 }
@@ -907,13 +911,9 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 // AsyncResultsMerger::MergingComparator
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
-    const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
-    const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
-
-    return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
-                           extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
+bool AsyncResultsMerger::MergingComparator::operator()(const SortKeyRemoteIdPair& lhs,
+                                                       const SortKeyRemoteIdPair& rhs) const {
+    return compareSortKeys(lhs.first, rhs.first, _sort) > 0;
 }
 
 bool AsyncResultsMerger::PromisedMinSortKeyComparator::operator()(
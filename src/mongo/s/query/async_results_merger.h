@@ -320,24 +320,20 @@ private:
         long long fetchedCount = 0;
     };
 
+    // An entry in the merge queue: the sort key of the first buffered result of a remote, paired
+    // with the index of that remote into '_remotes'. The sort key is extracted once, when the entry
+    // is queued, rather than on every comparison. It may point into the buffered result, which
+    // stays at the front of the remote's buffer for as long as the entry is queued.
+    using SortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
+
     class MergingComparator {
     public:
-        MergingComparator(const std::vector<RemoteCursorData>& remotes,
-                          const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+        MergingComparator(const BSONObj& sort) : _sort(sort) {}
 
-        bool operator()(const size_t& lhs, const size_t& rhs);
+        bool operator()(const SortKeyRemoteIdPair& lhs, const SortKeyRemoteIdPair& rhs) const;
 
     private:
-        const std::vector<RemoteCursorData>& _remotes;
-
         const BSONObj _sort;
-
-        // When '_compareWholeSortKey' is true, $sortKey is a scalar value, rather than an object.
-        // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
-        // be {$sortKey: 1}.
-        const bool _compareWholeSortKey;
     };
 
     using MinSortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
@@ -393,6 +389,12 @@ private:
     ClusterQueryResult _nextReadySorted(WithLock);
     ClusterQueryResult _nextReadyUnsorted(WithLock);
 
+    /**
+     * Places the remote at 'remoteIndex', which must have buffered results, onto the merge queue
+     * keyed by the sort key of its first buffered result.
+     */
+    void _pushToMergeQueue(WithLock, size_t remoteIndex);
+
     using CbData = executor::TaskExecutor::RemoteCommandCallbackArgs;
     using CbResponse = executor::TaskExecutor::ResponseStatus;
 
@@ -486,9 +488,10 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // The top of this priority queue holds the index into '_remotes' for the remote host that has
+    // the next document to return, according to the sort order. Used only if there is a sort.
+    std::priority_queue<SortKeyRemoteIdPair, std::vector<SortKeyRemoteIdPair>, MergingComparator>
+        _mergeQueue;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
@@ -168,14 +168,16 @@ StatusWith<std::unique_ptr<QueryRequest>> transformQueryForShards(
 
 /**
  * Constructs the find commands sent to each targeted shard to establish cursors, attaching the
- * shardVersion and txnNumber, if necessary.
+ * shardVersion and txnNumber, if necessary. If 'shardIdsToSend' is set, only the commands for that
+ * subset of the targeted 'shardIds' are constructed.
  */
 std::vector<std::pair<ShardId, BSONObj>> constructRequestsForShards(
     OperationContext* opCtx,
     const CachedCollectionRoutingInfo& routingInfo,
     const std::set<ShardId>& shardIds,
     const CanonicalQuery& query,
-    bool appendGeoNearDistanceProjection) {
+    bool appendGeoNearDistanceProjection,
+    const boost::optional<std::set<ShardId>>& shardIdsToSend = boost::none) {
 
     std::unique_ptr<QueryRequest> qrToForward;
     if (shardIds.size() > 1) {
@@ -195,7 +197,7 @@ std::vector<std::pair<ShardId, BSONObj>> constructRequestsForShards(
 
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     std::vector<std::pair<ShardId, BSONObj>> requests;
-    for (const auto& shardId : shardIds) {
+    for (const auto& shardId : shardIdsToSend.value_or(shardIds)) {
         const auto shard = uassertStatusOK(shardRegistry->getShard(opCtx, shardId));
         invariant(!shard->isConfig() || shard->getConnString().type() != ConnectionString::INVALID);
 
@@ -220,6 +222,146 @@ std::vector<std::pair<ShardId, BSONObj>> constructRequestsForShards(
     return requests;
 }
 
+/**
+ * Establishes cursors on the shards targeted by the query. A sharded scatter-gather query outside
+ * of a transaction does not give up the cursors which were successfully established when some of
+ * the shards reject their request with a stale shard version. Instead, the routing table entries
+ * of those shards are refreshed and only the stale shards are retried, as long as the refresh
+ * changed neither the set of targeted shards nor the version of any shard which already has a
+ * cursor. Otherwise the established cursors are killed and the stale shard version error is
+ * thrown, so that the whole query is retried.
+ */
+std::vector<RemoteCursor> establishCursorsOnTargetedShards(
+    OperationContext* opCtx,
+    const CanonicalQuery& query,
+    const ReadPreferenceSetting& readPref,
+    const CachedCollectionRoutingInfo& routingInfo,
+    const std::set<ShardId>& shardIds,
+    bool appendGeoNearDistanceProjection) {
+    auto executor = Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor();
+    const bool allowPartialResults = query.getQueryRequest().isAllowPartialResults();
+
+    auto requests = constructRequestsForShards(
+        opCtx, routingInfo, shardIds, query, appendGeoNearDistanceProjection);
+
+    if (!routingInfo.cm() || TransactionRouter::get(opCtx)) {
+        return establishCursors(
+            opCtx, executor, query.nss(), readPref, requests, allowPartialResults);
+    }
+
+    // The shard versions the established cursors were opened with.
+    stdx::unordered_map<ShardId, ChunkVersion, ShardId::Hasher> establishedVersions;
+    auto currentRoutingInfo = routingInfo;
+    std::vector<RemoteCursor> cursors;
+
+    auto killEstablishedCursors = [&] {
+        for (auto& cursor : cursors) {
+            if (cursor.getCursorResponse().getCursorId() != CursorId(0)) {
+                killRemoteCursor(opCtx, executor.get(), std::move(cursor), query.nss());
+            }
+        }
+    };
+
+    for (int attempt = 1;; ++attempt) {
+        std::vector<std::pair<ShardId, Status>> staleShardErrors;
+        auto newCursors = [&] {
+            try {
+                return establishCursors(opCtx,
+                                        executor,
+                                        query.nss(),
+                                        readPref,
+                                        requests,
+                                        allowPartialResults,
+                                        Shard::RetryPolicy::kIdempotent,
+                                        &staleShardErrors);
+            } catch (const DBException&) {
+                killEstablishedCursors();
+                throw;
+            }
+        }();
+
+        for (auto& cursor : newCursors) {
+            if (!cursor.getCursorResponse().getPartialResultsReturned()) {
+                const ShardId shardId(cursor.getShardId().toString());
+                establishedVersions.emplace(shardId, currentRoutingInfo.cm()->getVersion(shardId));
+            }
+            cursors.push_back(std::move(cursor));
+        }
+
+        if (staleShardErrors.empty()) {
+            return cursors;
+        }
+
+        const auto& firstStaleError = staleShardErrors.front().second;
+        auto failWithStaleError = [&] {
+            killEstablishedCursors();
+            uassertStatusOK(firstStaleError);
+        };
+
+        if (attempt >= kMaxNumStaleVersionRetries) {
+            failWithStaleError();
+        }
+
+        LOGV2_DEBUG(4798622,
+                    1,
+                    "Retrying cursor establishment on stale shards",
+                    "query"_attr = redact(query.toStringShort()),
+                    "numStaleShards"_attr = staleShardErrors.size(),
+                    "numEstablishedCursors"_attr = cursors.size(),
+                    "attemptNumber"_attr = attempt,
+                    "error"_attr = redact(firstStaleError));
+
+        auto const catalogCache = Grid::get(opCtx)->catalogCache();
+        std::set<ShardId> staleShardIds;
+        for (const auto& [shardId, status] : staleShardErrors) {
+            if (auto staleInfo = status.extraInfo<StaleConfigInfo>()) {
+                catalogCache->invalidateShardOrEntireCollectionEntryForShardedCollection(
+                    opCtx,
+                    query.nss(),
+                    staleInfo->getVersionWanted(),
+                    staleInfo->getVersionReceived(),
+                    staleInfo->getShardId());
+            } else {
+                catalogCache->onEpochChange(query.nss());
+            }
+            staleShardIds.insert(shardId);
+        }
+
+        catalogCache->setOperationShouldBlockBehindCatalogCacheRefresh(opCtx, true);
+        auto swRefreshedRoutingInfo = catalogCache->getCollectionRoutingInfo(opCtx, query.nss());
+        if (!swRefreshedRoutingInfo.isOK() || !swRefreshedRoutingInfo.getValue().cm() ||
+            swRefreshedRoutingInfo.getValue().cm()->getVersion().epoch() !=
+                currentRoutingInfo.cm()->getVersion().epoch()) {
+            failWithStaleError();
+        }
+        auto refreshedRoutingInfo = std::move(swRefreshedRoutingInfo.getValue());
+
+        // Chunks can only have moved between the stale shards if the refresh left the targeted
+        // shards and the versions of the shards with established cursors unchanged.
+        auto refreshedShardIds = getTargetedShardsForQuery(query.getExpCtx(),
+                                                           refreshedRoutingInfo,
+                                                           query.getQueryRequest().getFilter(),
+                                                           query.getQueryRequest().getCollation());
+        if (refreshedShardIds != shardIds ||
+            std::any_of(establishedVersions.begin(),
+                        establishedVersions.end(),
+                        [&](const auto& shardAndVersion) {
+                            return refreshedRoutingInfo.cm()->getVersion(shardAndVersion.first) !=
+                                shardAndVersion.second;
+                        })) {
+            failWithStaleError();
+        }
+
+        currentRoutingInfo = std::move(refreshedRoutingInfo);
+        requests = constructRequestsForShards(opCtx,
+                                              currentRoutingInfo,
+                                              shardIds,
+                                              query,
+                                              appendGeoNearDistanceProjection,
+                                              staleShardIds);
+    }
+}
+
 void updateNumHostsTargetedMetrics(OperationContext* opCtx,
                                    const CachedCollectionRoutingInfo& routingInfo,
                                    int nTargetedShards) {
@@ -303,19 +445,9 @@ CursorId runQueryWithoutRetrying(OperationContext* opCtx,
     // Tailable cursors can't have a sort, which should have already been validated.
     invariant(sortComparatorObj.isEmpty() || !query.getQueryRequest().isTailable());
 
-    // Construct the requests that we will use to establish cursors on the targeted shards,
-    // attaching the shardVersion and txnNumber, if necessary.
-
-    auto requests = constructRequestsForShards(
-        opCtx, routingInfo, shardIds, query, appendGeoNearDistanceProjection);
-
     // Establish the cursors with a consistent shardVersion across shards.
-    params.remotes = establishCursors(opCtx,
-                                      Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
-                                      query.nss(),
-                                      readPref,
-                                      requests,
-                                      query.getQueryRequest().isAllowPartialResults());
+    params.remotes = establishCursorsOnTargetedShards(
+        opCtx, query, readPref, routingInfo, shardIds, appendGeoNearDistanceProjection);
 
     // Determine whether the cursor we may eventually register will be single- or multi-target.
 
@@ -94,13 +94,15 @@ void killOpOnShards(std::shared_ptr<executor::TaskExecutor> executor,
 
 }  // namespace
 
-std::vector<RemoteCursor> establishCursors(OperationContext* opCtx,
-                                           std::shared_ptr<executor::TaskExecutor> executor,
-                                           const NamespaceString& nss,
-                                           const ReadPreferenceSetting readPref,
-                                           const std::vector<std::pair<ShardId, BSONObj>>& remotes,
-                                           bool allowPartialResults,
-                                           Shard::RetryPolicy retryPolicy) {
+std::vector<RemoteCursor> establishCursors(
+    OperationContext* opCtx,
+    std::shared_ptr<executor::TaskExecutor> executor,
+    const NamespaceString& nss,
+    const ReadPreferenceSetting readPref,
+    const std::vector<std::pair<ShardId, BSONObj>>& remotes,
+    bool allowPartialResults,
+    Shard::RetryPolicy retryPolicy,
+    std::vector<std::pair<ShardId, Status>>* staleShardErrors) {
     // Construct the requests
     std::vector<AsyncRequestsSender::Request> requests;
 
@@ -171,6 +173,19 @@ std::vector<RemoteCursor> establishCursors(OperationContext* opCtx,
                     uassertStatusOK(cursor.getStatus());
                 }
             } catch (const AssertionException& ex) {
+                // Stale shard version errors are reported to the caller when it asked for them,
+                // provided the remote did not also return any cursors which would be duplicated by
+                // a retry.
+                if (staleShardErrors && ErrorCodes::isStaleShardVersionError(ex.code()) &&
+                    std::none_of(remoteCursors.begin(),
+                                 remoteCursors.end(),
+                                 [&](const RemoteCursor& cursor) {
+                                     return cursor.getShardId() == response.shardId.toString();
+                                 })) {
+                    staleShardErrors->emplace_back(response.shardId, ex.toStatus());
+                    continue;
+                }
+
                 // Retriable errors are swallowed if 'allowPartialResults' is true. Targeting shard
                 // replica sets can also throw FailedToSatisfyReadPreference, so we swallow it too.
                 bool isEligibleException = (isMongosRetriableError(ex.code()) ||
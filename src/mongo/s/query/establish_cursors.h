@@ -62,6 +62,11 @@ class CursorResponse;
  * @param allowPartialResults: If true, unreachable hosts are ignored, and only cursors established
  *                             on reachable hosts are returned.
  *
+ * @param staleShardErrors: If not null, remotes which reject their request with a stale shard
+ *                          version error do not fail the call. Instead, their shard ids and errors
+ *                          are appended to 'staleShardErrors' and the cursors established on the
+ *                          other remotes are returned, so that the caller can retry only the stale
+ *                          remotes after refreshing its routing table.
  */
 std::vector<RemoteCursor> establishCursors(
     OperationContext* opCtx,
@@ -70,7 +75,8 @@ std::vector<RemoteCursor> establishCursors(
     const ReadPreferenceSetting readPref,
     const std::vector<std::pair<ShardId, BSONObj>>& remotes,
     bool allowPartialResults,
-    Shard::RetryPolicy retryPolicy = Shard::RetryPolicy::kIdempotent);
+    Shard::RetryPolicy retryPolicy = Shard::RetryPolicy::kIdempotent,
+    std::vector<std::pair<ShardId, Status>>* staleShardErrors = nullptr);
 
 /**
  * Schedules a remote killCursor command for 'cursor'.
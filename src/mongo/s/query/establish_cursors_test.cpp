@@ -39,6 +39,7 @@
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/query/establish_cursors.h"
 #include "mongo/s/sharding_router_test_fixture.h"
+#include "mongo/s/stale_exception.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -447,6 +448,65 @@ TEST_F(EstablishCursorsTest, MultipleRemotesOneRemoteRespondsWithNonretriableErr
     future.default_timed_get();
 }
 
+TEST_F(EstablishCursorsTest, MultipleRemotesOneRemoteRespondsWithStaleConfigReportsStaleShard) {
+    BSONObj cmdObj = fromjson("{find: 'testcoll'}");
+    std::vector<std::pair<ShardId, BSONObj>> remotes{
+        {kTestShardIds[0], cmdObj}, {kTestShardIds[1], cmdObj}, {kTestShardIds[2], cmdObj}};
+
+    auto future = launchAsync([&] {
+        std::vector<std::pair<ShardId, Status>> staleShardErrors;
+        auto cursors = establishCursors(operationContext(),
+                                        executor(),
+                                        _nss,
+                                        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                                        remotes,
+                                        false,  // allowPartialResults
+                                        Shard::RetryPolicy::kIdempotent,
+                                        &staleShardErrors);
+
+        // The cursors established on the other remotes are kept.
+        ASSERT_EQUALS(2UL, cursors.size());
+        for (const auto& cursor : cursors) {
+            ASSERT_NE(kTestShardIds[1].toString(), cursor.getShardId());
+        }
+
+        ASSERT_EQUALS(1UL, staleShardErrors.size());
+        ASSERT_EQUALS(kTestShardIds[1], staleShardErrors.front().first);
+        ASSERT_EQUALS(ErrorCodes::StaleConfig, staleShardErrors.front().second);
+    });
+
+    // First remote responds with success.
+    onCommand([&](const RemoteCommandRequest& request) {
+        ASSERT_EQ(_nss.coll(), request.cmdObj.firstElement().valueStringData());
+
+        std::vector<BSONObj> batch = {fromjson("{_id: 1}"), fromjson("{_id: 2}")};
+        CursorResponse cursorResponse(_nss, CursorId(123), batch);
+        return cursorResponse.toBSON(CursorResponse::ResponseType::InitialResponse);
+    });
+
+    // Second remote responds with a stale shard version error.
+    onCommand([this](const RemoteCommandRequest& request) {
+        ASSERT_EQ(_nss.coll(), request.cmdObj.firstElement().valueStringData());
+        return createErrorCursorResponse(
+            Status(StaleConfigInfo(_nss,
+                                   ChunkVersion(1, 0, OID::gen()),
+                                   boost::none,
+                                   kTestShardIds[1]),
+                   "stale shard version"));
+    });
+
+    // Third remote responds with success.
+    onCommand([&](const RemoteCommandRequest& request) {
+        ASSERT_EQ(_nss.coll(), request.cmdObj.firstElement().valueStringData());
+
+        std::vector<BSONObj> batch = {fromjson("{_id: 1}"), fromjson("{_id: 2}")};
+        CursorResponse cursorResponse(_nss, CursorId(123), batch);
+        return cursorResponse.toBSON(CursorResponse::ResponseType::InitialResponse);
+    });
+
+    future.default_timed_get();
+}
+
 TEST_F(EstablishCursorsTest,
        MultipleRemotesOneRemoteRespondsWithNonretriableErrorAllowPartialResults) {
     BSONObj cmdObj = fromjson("{find: 'testcoll'}");
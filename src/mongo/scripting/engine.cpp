@@ -346,6 +346,8 @@ void Scope::execCoreFiles() {
 }
 
 namespace {
+constexpr Seconds kMaxScopeReuseTime = Seconds(10);
+
 class ScopeCache {
 public:
     void release(const string& poolName, const std::shared_ptr<Scope>& scope) {
@@ -404,7 +406,6 @@ private:
 
     // Note: if these numbers change, reconsider choice of datastructure for _pools
     static const unsigned kMaxPoolSize = 10;
-    constexpr static inline Seconds kMaxScopeReuseTime = Seconds(10);
 
     typedef std::deque<ScopeAndPool> Pools;  // More-recently used Scopes are kept at the front.
     Pools _pools;                            // protected by _mutex
@@ -412,10 +413,80 @@ private:
 };
 
 ScopeCache scopeCache;
+
+// A scope for the current thread can only be destroyed by its own thread, so an idle thread holds
+// on to its released scope until it runs JavaScript again or exits. The number of such scopes is
+// capped across all threads, as with the scopes kept by the ScopeCache.
+const int kMaxThreadScopes = 10;
+AtomicWord<int> numThreadScopes{0};
+
+// Incremented by ScriptEngine::dropScopeCache(), so that the scope kept by every other thread is no
+// longer reused and is destroyed when that thread next looks for a scope.
+AtomicWord<long long> threadScopeGeneration{0};
+
+// The scope released by this thread, see ScriptEngine::getPooledScopeForCurrentThread().
+class ThreadScope {
+public:
+    ~ThreadScope() {
+        take();
+    }
+
+    /**
+     * Keeps 'scope' unless as many scopes are already kept by other threads.
+     */
+    void store(const ScriptEngine* engine, const string& poolName, std::unique_ptr<Scope> scope) {
+        invariant(!_scope);
+        if (numThreadScopes.addAndFetch(1) > kMaxThreadScopes) {
+            numThreadScopes.subtractAndFetch(1);
+            return;
+        }
+        _engine = engine;
+        _poolName = poolName;
+        _generation = threadScopeGeneration.load();
+        _releaseTime = Date_t::now();
+        _scope = std::move(scope);
+    }
+
+    /**
+     * Returns the kept scope if it was released to 'engine' under 'poolName' recently enough and
+     * since the last ScriptEngine::dropScopeCache(). Any other kept scope is destroyed.
+     */
+    std::unique_ptr<Scope> takeFor(const ScriptEngine* engine, const string& poolName) {
+        auto scope = take();
+        if (scope && _engine == engine && _poolName == poolName &&
+            _generation == threadScopeGeneration.load() &&
+            Date_t::now() - _releaseTime <= kMaxScopeReuseTime &&
+            Date_t::now() - scope->getCreateTime() <= kMaxScopeReuseTime) {
+            return scope;
+        }
+        return nullptr;
+    }
+
+    std::unique_ptr<Scope> take() {
+        if (_scope) {
+            numThreadScopes.subtractAndFetch(1);
+        }
+        return std::move(_scope);
+    }
+
+    bool hasScope() const {
+        return bool(_scope);
+    }
+
+private:
+    const ScriptEngine* _engine = nullptr;
+    string _poolName;
+    long long _generation = 0;
+    Date_t _releaseTime;
+    std::unique_ptr<Scope> _scope;
+};
+thread_local ThreadScope threadScope;
 }  // anonymous namespace
 
 void ScriptEngine::dropScopeCache() {
     scopeCache.clear();
+    threadScopeGeneration.fetchAndAdd(1);
+    threadScope.take();
 }
 
 class PooledScope : public Scope {
@@ -577,6 +648,33 @@ unique_ptr<Scope> ScriptEngine::getPooledScope(OperationContext* opCtx,
     return p;
 }
 
+unique_ptr<Scope> ScriptEngine::getPooledScopeForCurrentThread(const string& poolName,
+                                                               boost::optional<int> jsHeapLimitMB) {
+    // A released scope which can't be reused must be destroyed before creating a new one.
+    if (auto scope = threadScope.takeFor(this, poolName); scope && !poolName.empty()) {
+        scope->reset();
+        return scope;
+    }
+    return unique_ptr<Scope>(newScopeForCurrentThread(jsHeapLimitMB));
+}
+
+void ScriptEngine::releaseScopeForCurrentThread(const string& poolName, unique_ptr<Scope> scope) {
+    if (poolName.empty() || scope->hasOutOfMemoryException() || !scope->getError().empty() ||
+        Date_t::now() - scope->getCreateTime() > kMaxScopeReuseTime) {
+        return;
+    }
+
+    if (threadScope.hasScope()) {
+        // The thread had more than one scope at a time, so neither of them can be relied on to be
+        // its current scope any more.
+        threadScope.take();
+        return;
+    }
+
+    scope->reset();
+    threadScope.store(this, poolName, std::move(scope));
+}
+
 void (*ScriptEngine::_connectCallback)(DBClientBase&, StringData) = nullptr;
 
 ScriptEngine* getGlobalScriptEngine() {
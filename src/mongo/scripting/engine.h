@@ -244,6 +244,12 @@ public:
      * ignored.
      */
     static void setup(bool disableLoadStored = true);
+
+    /**
+     * Destroys the pooled scopes and the scope kept by the calling thread. A scope kept by any
+     * other thread is no longer reused, and that thread destroys it the next time it looks for a
+     * scope.
+     */
     static void dropScopeCache();
 
     /** gets a scope from the pool or a new one if pool is empty
@@ -256,6 +262,24 @@ public:
                                           const std::string& db,
                                           const std::string& scopeType);
 
+    /**
+     * Gets the scope the current thread released under 'poolName' if it is recent enough, or a new
+     * scope for the current thread otherwise. Scopes for the current thread cannot be shared with
+     * other threads and only one of them can be alive on a thread at a time, so each thread keeps
+     * at most one released scope.
+     * @param poolName A unique id to limit scope sharing; an empty name never reuses a scope.
+     *                 This must include authenticated users.
+     */
+    std::unique_ptr<Scope> getPooledScopeForCurrentThread(const std::string& poolName,
+                                                          boost::optional<int> jsHeapLimitMB);
+
+    /**
+     * Keeps 'scope', which must have been returned by getPooledScopeForCurrentThread() on this
+     * thread, for the next call with the same 'poolName' within 10 seconds. The scope is destroyed
+     * instead if too many threads already keep a scope.
+     */
+    void releaseScopeForCurrentThread(const std::string& poolName, std::unique_ptr<Scope> scope);
+
     void setScopeInitCallback(void (*func)(Scope&)) {
         _scopeInitCallback = func;
     }
@@ -32,6 +32,7 @@
 #include "mongo/base/status.h"
 #include "mongo/base/system_error.h"
 #include "mongo/config.h"
+#include "mongo/rpc/message.h"
 #include "mongo/util/errno_util.h"
 #include "mongo/util/future.h"
 #include "mongo/util/net/hostandport.h"
@@ -43,6 +44,7 @@
 #endif  // ndef _WIN32
 
 #include <asio.hpp>
+#include <vector>
 
 namespace mongo {
 namespace transport {
@@ -321,6 +323,60 @@ boost::optional<std::array<std::uint8_t, 7>> checkTLSRequest(const Buffer& buffe
 }
 #endif
 
+/**
+ * A buffer sequence over the segments of a fragmented Message, which lets the whole message be
+ * written with one gathering write. Like asio::const_buffer, it can be advanced past the bytes
+ * that have already been written. The message must outlive the sequence.
+ */
+class MessageSegments {
+public:
+    using value_type = asio::const_buffer;
+    using const_iterator = std::vector<asio::const_buffer>::const_iterator;
+
+    explicit MessageSegments(const Message& message) {
+        _append(message);
+    }
+
+    /**
+     * Lays out several messages back to back, so that they can be sent with a single write.
+     */
+    explicit MessageSegments(const std::vector<Message>& messages) {
+        for (const auto& message : messages) {
+            _append(message);
+        }
+    }
+
+    const_iterator begin() const {
+        return _buffers.begin() + _first;
+    }
+
+    const_iterator end() const {
+        return _buffers.end();
+    }
+
+    MessageSegments& operator+=(std::size_t bytes) {
+        while (bytes && _first < _buffers.size()) {
+            auto& buffer = _buffers[_first];
+            if (bytes < buffer.size()) {
+                buffer += bytes;
+                break;
+            }
+            bytes -= buffer.size();
+            ++_first;
+        }
+        return *this;
+    }
+
+private:
+    void _append(const Message& message) {
+        message.forEachSegment(
+            [&](const char* data, size_t size) { _buffers.emplace_back(data, size); });
+    }
+
+    std::vector<asio::const_buffer> _buffers;
+    std::size_t _first = 0;
+};
+
 /**
  * Pass this to asio functions in place of a callback to have them return a Future<T>. This behaves
  * similarly to asio::use_future_t, however it returns a mongo::Future<T> rather than a
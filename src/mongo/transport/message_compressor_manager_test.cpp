@@ -240,6 +240,20 @@ TEST(ZstdMessageCompressor, Fidelity) {
     checkFidelity(testMessage, std::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdDictionaryMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, std::make_unique<ZstdDictionaryMessageCompressor>("Hello, world!"));
+}
+
+TEST(ZstdMessageCompressor, CompressionLevelDecreasesWithMessageSize) {
+    ASSERT_EQ(ZstdMessageCompressor::compressionLevel(100, 3, 1024), 3);
+    ASSERT_EQ(ZstdMessageCompressor::compressionLevel(1024, 3, 1024), 3);
+    ASSERT_EQ(ZstdMessageCompressor::compressionLevel(1025, 3, 1024), 2);
+    ASSERT_EQ(ZstdMessageCompressor::compressionLevel(2048, 3, 1024), 2);
+    ASSERT_EQ(ZstdMessageCompressor::compressionLevel(2049, 3, 1024), 1);
+    ASSERT_EQ(ZstdMessageCompressor::compressionLevel(1024 * 1024, 3, 1024), 1);
+}
+
 TEST(SnappyMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<SnappyMessageCompressor>());
 }
@@ -252,6 +266,10 @@ TEST(ZstdMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdDictionaryMessageCompressor, Overflow) {
+    checkOverflow(std::make_unique<ZstdDictionaryMessageCompressor>("We embrace reality."));
+}
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
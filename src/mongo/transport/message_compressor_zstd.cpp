@@ -29,50 +29,170 @@
 
 #include "mongo/platform/basic.h"
 
+#include <fstream>
 #include <memory>
+#include <sstream>
 
 #include <zstd.h>
 
 #include "mongo/base/init.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/transport/message_compressor_zstd_gen.h"
 
 namespace mongo {
+namespace {
+
+struct ZstdDeleter {
+    void operator()(ZSTD_CCtx* cctx) const {
+        ZSTD_freeCCtx(cctx);
+    }
+    void operator()(ZSTD_DCtx* dctx) const {
+        ZSTD_freeDCtx(dctx);
+    }
+};
+
+ZSTD_CCtx* getCompressionContext() {
+    thread_local std::unique_ptr<ZSTD_CCtx, ZstdDeleter> cctx(ZSTD_createCCtx());
+    return cctx.get();
+}
+
+ZSTD_DCtx* getDecompressionContext() {
+    thread_local std::unique_ptr<ZSTD_DCtx, ZstdDeleter> dctx(ZSTD_createDCtx());
+    return dctx.get();
+}
+
+int currentCompressionLevel(size_t inputSize) {
+    return ZstdMessageCompressor::compressionLevel(
+        inputSize,
+        gZstdNetworkCompressionLevel.load(),
+        static_cast<size_t>(gZstdNetworkCompressionLargeMessageBytes.load()));
+}
+
+StatusWith<std::size_t> checkCompressResult(size_t ret) {
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+    return {ret};
+}
+
+StatusWith<std::size_t> checkDecompressResult(size_t ret) {
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not decompress message: " << ZSTD_getErrorName(ret)};
+    }
+    return {ret};
+}
+
+}  // namespace
 
 ZstdMessageCompressor::ZstdMessageCompressor() : MessageCompressorBase(MessageCompressor::kZstd) {}
 
+int ZstdMessageCompressor::compressionLevel(size_t inputSize,
+                                            int level,
+                                            size_t largeMessageBytes) {
+    for (auto size = largeMessageBytes; size < inputSize && level > 1; size *= 2) {
+        --level;
+    }
+    return level;
+}
+
 std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
     return ZSTD_compressBound(inputSize);
 }
 
 StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
                                                             DataRange output) {
-    size_t ret = ZSTD_compress(const_cast<char*>(output.data()),
-                               output.length(),
-                               input.data(),
-                               input.length(),
-                               ZSTD_CLEVEL_DEFAULT);
+    size_t ret = ZSTD_compressCCtx(getCompressionContext(),
+                                   const_cast<char*>(output.data()),
+                                   output.length(),
+                                   input.data(),
+                                   input.length(),
+                                   currentCompressionLevel(input.length()));
 
-    if (ZSTD_isError(ret)) {
-        return Status{ErrorCodes::BadValue,
-                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    auto swSize = checkCompressResult(ret);
+    if (swSize.isOK()) {
+        counterHitCompress(input.length(), ret);
     }
-    counterHitCompress(input.length(), ret);
-    return {ret};
+    return swSize;
 }
 
 StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange input,
                                                               DataRange output) {
-    size_t ret = ZSTD_decompress(
-        const_cast<char*>(output.data()), output.length(), input.data(), input.length());
+    size_t ret = ZSTD_decompressDCtx(getDecompressionContext(),
+                                     const_cast<char*>(output.data()),
+                                     output.length(),
+                                     input.data(),
+                                     input.length());
 
-    if (ZSTD_isError(ret)) {
-        return Status{ErrorCodes::BadValue,
-                      str::stream() << "Could not decompress message: " << ZSTD_getErrorName(ret)};
+    auto swSize = checkDecompressResult(ret);
+    if (swSize.isOK()) {
+        counterHitDecompress(input.length(), ret);
     }
+    return swSize;
+}
 
-    counterHitDecompress(input.length(), ret);
-    return {ret};
+ZstdDictionaryMessageCompressor::ZstdDictionaryMessageCompressor(std::string dictionary)
+    : MessageCompressorBase(MessageCompressor::kZstdDictionary),
+      _dictionary(std::move(dictionary)),
+      _ddict(ZSTD_createDDict(_dictionary.data(), _dictionary.size())) {
+    invariant(_ddict);
+}
+
+ZstdDictionaryMessageCompressor::~ZstdDictionaryMessageCompressor() {
+    for (auto&& [level, cdict] : _cdicts) {
+        ZSTD_freeCDict(cdict);
+    }
+    ZSTD_freeDDict(_ddict);
+}
+
+ZSTD_CDict* ZstdDictionaryMessageCompressor::_getCDict(int level) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto& cdict = _cdicts[level];
+    if (!cdict) {
+        cdict = ZSTD_createCDict(_dictionary.data(), _dictionary.size(), level);
+        invariant(cdict);
+    }
+    return cdict;
+}
+
+std::size_t ZstdDictionaryMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdDictionaryMessageCompressor::compressData(ConstDataRange input,
+                                                                      DataRange output) {
+    size_t ret = ZSTD_compress_usingCDict(getCompressionContext(),
+                                          const_cast<char*>(output.data()),
+                                          output.length(),
+                                          input.data(),
+                                          input.length(),
+                                          _getCDict(currentCompressionLevel(input.length())));
+
+    auto swSize = checkCompressResult(ret);
+    if (swSize.isOK()) {
+        counterHitCompress(input.length(), ret);
+    }
+    return swSize;
+}
+
+StatusWith<std::size_t> ZstdDictionaryMessageCompressor::decompressData(ConstDataRange input,
+                                                                        DataRange output) {
+    // A message compressed with a different trained dictionary fails here rather than producing
+    // garbage, since zstd frames record the ID of a trained dictionary.
+    size_t ret = ZSTD_decompress_usingDDict(getDecompressionContext(),
+                                            const_cast<char*>(output.data()),
+                                            output.length(),
+                                            input.data(),
+                                            input.length(),
+                                            _ddict);
+
+    auto swSize = checkDecompressResult(ret);
+    if (swSize.isOK()) {
+        counterHitDecompress(input.length(), ret);
+    }
+    return swSize;
 }
 
 
@@ -82,6 +202,19 @@ MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
 (InitializerContext* context) {
     auto& compressorRegistry = MessageCompressorRegistry::get();
     compressorRegistry.registerImplementation(std::make_unique<ZstdMessageCompressor>());
+
+    if (!gZstdNetworkCompressionDictionaryFile.empty()) {
+        std::ifstream file(gZstdNetworkCompressionDictionaryFile, std::ios::binary);
+        std::stringstream dictionary;
+        dictionary << file.rdbuf();
+        if (!file || dictionary.str().empty()) {
+            return {ErrorCodes::FileOpenFailed,
+                    str::stream() << "Could not read the zstd network compression dictionary "
+                                  << gZstdNetworkCompressionDictionaryFile};
+        }
+        compressorRegistry.registerImplementation(
+            std::make_unique<ZstdDictionaryMessageCompressor>(dictionary.str()));
+    }
     return Status::OK();
 }
 }  // namespace mongo
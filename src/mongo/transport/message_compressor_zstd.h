@@ -27,8 +27,17 @@
  *    it in the license file.
  */
 
+#include <map>
+#include <string>
+
+#include "mongo/platform/mutex.h"
 #include "mongo/transport/message_compressor_base.h"
 
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+typedef struct ZSTD_CDict_s ZSTD_CDict;
+typedef struct ZSTD_DDict_s ZSTD_DDict;
+
 namespace mongo {
 class ZstdMessageCompressor final : public MessageCompressorBase {
 public:
@@ -39,6 +48,40 @@ public:
     StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
 
     StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+    /**
+     * Returns the compression level for a message of 'inputSize' bytes, given the configured
+     * level and the size above which messages are compressed at lower levels.
+     */
+    static int compressionLevel(size_t inputSize, int level, size_t largeMessageBytes);
+};
+
+/**
+ * Compresses messages with zstd using the dictionary in zstdNetworkCompressionDictionaryFile, so
+ * that small messages can refer to the strings that recur across messages. Registered as
+ * "zstd_dict" only when a dictionary file is configured.
+ */
+class ZstdDictionaryMessageCompressor final : public MessageCompressorBase {
+public:
+    explicit ZstdDictionaryMessageCompressor(std::string dictionary);
+    ~ZstdDictionaryMessageCompressor();
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+private:
+    // Returns the digested dictionary for 'level', creating it on first use.
+    ZSTD_CDict* _getCDict(int level);
+
+    const std::string _dictionary;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("ZstdDictionaryMessageCompressor::_mutex");
+    std::map<int, ZSTD_CDict*> _cdicts;
+
+    ZSTD_DDict* const _ddict;
 };
 
 
@@ -47,6 +47,8 @@ namespace {
 constexpr auto kThreadsRunning = "threadsRunning"_sd;
 constexpr auto kExecutorLabel = "executor"_sd;
 constexpr auto kExecutorName = "fixed"_sd;
+constexpr auto kLocalTasksRun = "localTasksRun"_sd;
+constexpr auto kTasksStolen = "tasksStolen"_sd;
 }  // namespace
 
 ServiceExecutorFixed::ServiceExecutorFixed(ThreadPool::Options options)
@@ -137,20 +139,93 @@ Status ServiceExecutorFixed::scheduleTask(Task task, ScheduleFlags flags) {
 
     hangBeforeSchedulingServiceExecutorFixedTask.pauseWhileSet();
 
+    if (_executorContext && fixedServiceExecutorUseLocalQueues.loadRelaxed()) {
+        return _scheduleLocalTask(std::move(task));
+    }
+
     // May throw if an attempt is made to schedule after the thread pool is shutdown.
     try {
-        _threadPool->schedule([task = std::move(task)](Status status) mutable {
+        _threadPool->schedule([this, task = std::move(task)](Status status) mutable {
             internalAssert(status);
             invariant(_executorContext);
             _executorContext->run(std::move(task));
+            _runLocalTasks();
+        });
+    } catch (DBException& e) {
+        return e.toStatus();
+    }
+
+    return Status::OK();
+}
+
+Status ServiceExecutorFixed::_scheduleLocalTask(Task task) {
+    invariant(_executorContext);
+    auto queue = _executorContext->localQueue();
+    queue->push(std::move(task));
+
+    // The steal token must be scheduled after the task is queued, so whichever thread runs the
+    // token either finds the task or knows that the owner has already run it.
+    try {
+        _threadPool->schedule([this, queue](Status status) mutable {
+            internalAssert(status);
+            invariant(_executorContext);
+            if (auto task = queue->popFront()) {
+                if (queue != _executorContext->localQueue()) {
+                    _numTasksStolen.fetchAndAddRelaxed(1);
+                }
+                _executorContext->run(std::move(task));
+            }
+            _runLocalTasks();
         });
     } catch (DBException& e) {
+        // Nothing will ever run the token, so take a task back off the queue. Every other queued
+        // task has a token of its own and only the calling thread pops from the back, so the
+        // queue cannot be empty here.
+        invariant(queue->popBack());
         return e.toStatus();
     }
 
     return Status::OK();
 }
 
+void ServiceExecutorFixed::_runLocalTasks() {
+    invariant(_executorContext);
+    const auto& queue = _executorContext->localQueue();
+    for (int i = 0; i < kMaxConsecutiveLocalTasks; ++i) {
+        auto task = queue->popBack();
+        if (!task) {
+            return;
+        }
+        _numLocalTasksRun.fetchAndAddRelaxed(1);
+        _executorContext->run(std::move(task));
+    }
+}
+
+void ServiceExecutorFixed::LocalTaskQueue::push(Task task) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _tasks.push_back(std::move(task));
+}
+
+ServiceExecutor::Task ServiceExecutorFixed::LocalTaskQueue::popBack() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_tasks.empty()) {
+        return {};
+    }
+    auto task = std::move(_tasks.back());
+    _tasks.pop_back();
+    return task;
+}
+
+ServiceExecutor::Task ServiceExecutorFixed::LocalTaskQueue::popFront() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_tasks.empty()) {
+        return {};
+    }
+    auto task = std::move(_tasks.front());
+    _tasks.pop_front();
+    return task;
+}
+
 void ServiceExecutorFixed::runOnDataAvailable(Session* session,
                                               OutOfLineExecutor::Task onCompletionCallback) {
     invariant(session);
@@ -159,7 +234,8 @@ void ServiceExecutorFixed::runOnDataAvailable(Session* session,
 
 void ServiceExecutorFixed::appendStats(BSONObjBuilder* bob) const {
     *bob << kExecutorLabel << kExecutorName << kThreadsRunning
-         << static_cast<int>(_numRunningExecutorThreads.load());
+         << static_cast<int>(_numRunningExecutorThreads.load()) << kLocalTasksRun
+         << _numLocalTasksRun.loadRelaxed() << kTasksStolen << _numTasksStolen.loadRelaxed();
 }
 
 int ServiceExecutorFixed::getRecursionDepthForExecutorThread() const {
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/base/status.h"
@@ -74,11 +75,35 @@ public:
     int getRecursionDepthForExecutorThread() const;
 
 private:
+    /**
+     * Holds the tasks that an executor thread schedules while running another task. The owning
+     * thread pops from the back once its current task returns, so the continuation of a request
+     * runs on the thread (and likely the core) whose caches are still warm. Every queued task is
+     * paired with a steal token in the shared thread pool, and whichever idle thread runs the
+     * token takes the oldest task from the front if the owner has not run it by then.
+     */
+    class LocalTaskQueue {
+    public:
+        void push(Task task);
+
+        /**
+         * Return an empty task if the queue is empty.
+         */
+        Task popBack();
+        Task popFront();
+
+    private:
+        Mutex _mutex =
+            MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "LocalTaskQueue::_mutex");
+        std::deque<Task> _tasks;
+    };
+
     // Maintains the execution state (e.g., recursion depth) for executor threads
     class ExecutorThreadContext {
     public:
         ExecutorThreadContext(std::weak_ptr<ServiceExecutorFixed> serviceExecutor)
-            : _executor(std::move(serviceExecutor)) {
+            : _executor(std::move(serviceExecutor)),
+              _localQueue(std::make_shared<LocalTaskQueue>()) {
             _adjustRunningExecutorThreads(1);
         }
 
@@ -102,6 +127,10 @@ private:
             return _recursionDepth;
         }
 
+        const std::shared_ptr<LocalTaskQueue>& localQueue() const {
+            return _localQueue;
+        }
+
     private:
         void _adjustRunningExecutorThreads(int adjustment) {
             if (auto executor = _executor.lock()) {
@@ -111,10 +140,28 @@ private:
 
         int _recursionDepth = 0;
         std::weak_ptr<ServiceExecutorFixed> _executor;
+        std::shared_ptr<LocalTaskQueue> _localQueue;
     };
 
+    /**
+     * Queues the task on the local queue of the calling executor thread and schedules a steal
+     * token for it with the thread pool.
+     */
+    Status _scheduleLocalTask(Task task);
+
+    /**
+     * Runs the tasks left on the local queue of the calling executor thread, newest first, until
+     * the queue is empty or the thread has run "kMaxConsecutiveLocalTasks" of them. The remaining
+     * tasks are left to their steal tokens so a busy session cannot monopolize its thread.
+     */
+    void _runLocalTasks();
+
+    static constexpr int kMaxConsecutiveLocalTasks = 16;
+
 private:
     AtomicWord<size_t> _numRunningExecutorThreads{0};
+    AtomicWord<long long> _numLocalTasksRun{0};
+    AtomicWord<long long> _numTasksStolen{0};
     AtomicWord<bool> _canScheduleWork{false};
 
     mutable Mutex _mutex =
@@ -278,6 +278,36 @@ TEST_F(ServiceExecutorFixedFixture, FlattenRecursiveScheduledTasks) {
     barrier->countDownAndWait();
 }
 
+TEST_F(ServiceExecutorFixedFixture, IdleThreadStealsLocalTask) {
+    fixedServiceExecutorUseLocalQueues.store(true);
+    ON_BLOCK_EXIT([] { fixedServiceExecutorUseLocalQueues.store(false); });
+
+    ServiceExecutorHandle executorHandle(ServiceExecutorHandle::kStartExecutor);
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    auto stolen = std::make_shared<SharedPromise<void>>();
+
+    // The outer task queues its continuation locally and then blocks until the continuation has
+    // run, so only the other executor thread can run it by stealing it through its token.
+    ASSERT_OK(executorHandle->scheduleTask(
+        [executor = *executorHandle, barrier, stolen]() mutable {
+            const auto ownerThreadId = stdx::this_thread::get_id();
+            ASSERT_OK(executor->scheduleTask(
+                [ownerThreadId, stolen]() mutable {
+                    ASSERT(stdx::this_thread::get_id() != ownerThreadId);
+                    stolen->emplaceValue();
+                },
+                ServiceExecutor::kEmptyFlags));
+            stolen->getFuture().get();
+            barrier->countDownAndWait();
+        },
+        ServiceExecutor::kEmptyFlags));
+    barrier->countDownAndWait();
+
+    BSONObjBuilder bob;
+    executorHandle->appendStats(&bob);
+    ASSERT_EQ(bob.obj().getField("tasksStolen").numberLong(), 1);
+}
+
 TEST_F(ServiceExecutorFixedFixture, ShutdownTimeLimit) {
     ServiceExecutorHandle executorHandle(ServiceExecutorHandle::kStartExecutor);
     auto invoked = std::make_shared<SharedPromise<void>>();
@@ -45,6 +45,7 @@
 #include "mongo/rpc/op_msg.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/service_state_machine_gen.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/assert_util.h"
@@ -140,8 +141,9 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
 
     // The id of the response is used as the request id of this 'synthetic' request. Re-checksum
     // if needed.
-    exhaustMessage.header().setId(dbresponse->response.header().getId());
-    exhaustMessage.header().setResponseToMsgId(dbresponse->response.header().getResponseToMsgId());
+    const auto responseHeader = dbresponse->response.headerWithoutFlattening();
+    exhaustMessage.header().setId(responseHeader.getId());
+    exhaustMessage.header().setResponseToMsgId(responseHeader.getResponseToMsgId());
     OpMsg::setFlag(&exhaustMessage, OpMsg::kExhaustSupported);
     if (checksumPresent) {
         OpMsg::appendChecksum(&exhaustMessage);
@@ -356,6 +358,64 @@ void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
     sinkMsgImpl().getAsync([this](Status status) { _sinkCallback(std::move(status)); });
 }
 
+void ServiceStateMachine::_startExhaustSink(Message toSink) {
+    invariant(_transportMode == transport::Mode::kSynchronous);
+
+    if (!_exhaustSinkThread.joinable()) {
+        _exhaustSinkThread = stdx::thread([this, session = _session()] {
+            setThreadName(_threadName + "-exhaustSink");
+
+            stdx::unique_lock<Latch> lk(_exhaustSinkMutex);
+            while (true) {
+                _exhaustSinkCV.wait(lk, [&] { return _exhaustSinkToSink || _exhaustSinkShutdown; });
+                if (!_exhaustSinkToSink) {
+                    return;
+                }
+
+                auto toSink = std::move(*_exhaustSinkToSink);
+                _exhaustSinkToSink.reset();
+                lk.unlock();
+                auto status = session->sinkMessage(std::move(toSink));
+                lk.lock();
+
+                _exhaustSinkStatus = std::move(status);
+                _exhaustSinkInFlight = false;
+                _exhaustSinkCV.notify_all();
+            }
+        });
+    }
+
+    stdx::lock_guard<Latch> lk(_exhaustSinkMutex);
+    invariant(!_exhaustSinkInFlight);
+    _exhaustSinkToSink = std::move(toSink);
+    _exhaustSinkInFlight = true;
+    _exhaustSinkCV.notify_all();
+}
+
+Status ServiceStateMachine::_waitForExhaustSink() {
+    if (!_exhaustSinkThread.joinable()) {
+        return Status::OK();
+    }
+
+    stdx::unique_lock<Latch> lk(_exhaustSinkMutex);
+    _exhaustSinkCV.wait(lk, [&] { return !_exhaustSinkInFlight; });
+    return std::exchange(_exhaustSinkStatus, Status::OK());
+}
+
+void ServiceStateMachine::_stopExhaustSink() {
+    if (!_exhaustSinkThread.joinable()) {
+        return;
+    }
+
+    _waitForExhaustSink().ignore();
+    {
+        stdx::lock_guard<Latch> lk(_exhaustSinkMutex);
+        _exhaustSinkShutdown = true;
+        _exhaustSinkCV.notify_all();
+    }
+    _exhaustSinkThread.join();
+}
+
 void ServiceStateMachine::_sourceCallback(Status status) {
     // The first thing to do is create a ThreadGuard which will take ownership of the SSM in this
     // thread.
@@ -480,6 +540,18 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
             invariant(!_killedOpCtx);
             _killedOpCtx = std::move(opCtx);
 
+            // If the previous response of an exhaust stream is still being written, it must reach
+            // the client before anything else does.
+            if (auto sinkStatus = _waitForExhaustSink(); !sinkStatus.isOK()) {
+                LOGV2(4798613,
+                      "Error sending exhaust response to client. Ending connection from remote",
+                      "error"_attr = sinkStatus,
+                      "remote"_attr = _session()->remote(),
+                      "connectionId"_attr = _session()->id());
+                _state.store(State::EndSession);
+                return _runNextInGuard(std::move(guard));
+            }
+
             // Format our response, if we have one
             Message& toSink = dbresponse.response;
             if (!toSink.empty()) {
@@ -487,8 +559,8 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
                 invariant(!OpMsg::isFlagSet(toSink, OpMsg::kChecksumPresent));
 
                 // Update the header for the response message.
-                toSink.header().setId(nextMessageId());
-                toSink.header().setResponseToMsgId(_inMessage.header().getId());
+                toSink.headerWithoutFlattening().setId(nextMessageId());
+                toSink.headerWithoutFlattening().setResponseToMsgId(_inMessage.header().getId());
                 if (OpMsg::isFlagSet(_inMessage, OpMsg::kChecksumPresent)) {
 #ifdef MONGO_CONFIG_SSL
                     if (!SSLPeerInfo::forSession(_session()).isTLS) {
@@ -519,6 +591,16 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
                     .observe(
                         _sessionHandle, _serviceContext->getPreciseClockSource()->now(), toSink);
 
+                if (_inExhaust && _transportMode == transport::Mode::kSynchronous &&
+                    gOverlapSynchronousExhaustWrites.load()) {
+                    // Generate the next response while this one is written to the network, rather
+                    // than blocking on the write first.
+                    _startExhaustSink(std::move(toSink));
+                    return _scheduleNextWithGuard(std::move(guard),
+                                                  ServiceExecutor::kDeferredTask |
+                                                      ServiceExecutor::kMayYieldBeforeSchedule);
+                }
+
                 _sinkMessage(std::move(guard), std::move(toSink));
 
             } else {
@@ -691,6 +773,9 @@ void ServiceStateMachine::_cleanupSession(ThreadGuard guard) {
     }
     invariant(!_killedOpCtx);
 
+    // Any exhaust response still being written is abandoned along with the session.
+    _stopExhaustSink();
+
     _cleanupExhaustResources();
 
     _state.store(State::Ended);
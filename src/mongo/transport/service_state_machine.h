@@ -38,6 +38,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/transport/message_compressor_base.h"
 #include "mongo/transport/service_entry_point.h"
@@ -80,6 +81,7 @@ public:
      * transitions are:
      * Source -> SourceWait -> Process -> SinkWait -> Source (standard RPC)
      * Source -> SourceWait -> Process -> SinkWait -> Process -> SinkWait ... (exhaust)
+     * Source -> SourceWait -> Process -> Process ... -> SinkWait (overlapSynchronousExhaustWrites)
      * Source -> SourceWait -> Process -> Source (fire-and-forget)
      */
     enum class State {
@@ -214,6 +216,19 @@ private:
     void _sourceMessage(ThreadGuard guard);
     void _sinkMessage(ThreadGuard guard, Message toSink);
 
+    /*
+     * In a synchronous exhaust stream with 'overlapSynchronousExhaustWrites' enabled, each
+     * response is written to the network by a writer thread while the next response is generated,
+     * so that network and database work overlap. _startExhaustSink() hands 'toSink' to the writer,
+     * which is started by the first response of the session. _waitForExhaustSink() waits for the
+     * previous write, if any, and returns its result. At most one write is in flight at a time,
+     * which keeps the responses in order. _stopExhaustSink() waits for the last write and stops
+     * the writer.
+     */
+    void _startExhaustSink(Message toSink);
+    Status _waitForExhaustSink();
+    void _stopExhaustSink();
+
     /*
      * Releases all the resources associated with the session and call the cleanupHook.
      */
@@ -242,6 +257,16 @@ private:
     boost::optional<MessageCompressorId> _compressorId;
     Message _inMessage;
 
+    // Writes exhaust responses to the network, see _startExhaustSink(). The members below the
+    // thread are protected by '_exhaustSinkMutex'.
+    stdx::thread _exhaustSinkThread;
+    Mutex _exhaustSinkMutex = MONGO_MAKE_LATCH("ServiceStateMachine::_exhaustSinkMutex");
+    stdx::condition_variable _exhaustSinkCV;
+    boost::optional<Message> _exhaustSinkToSink;
+    bool _exhaustSinkInFlight = false;
+    bool _exhaustSinkShutdown = false;
+    Status _exhaustSinkStatus = Status::OK();
+
     // Allows delegating destruction of opCtx to another function to potentially remove its cost
     // from the critical path. This is currently only used in `_processMessage()`.
     ServiceContext::UniqueOperationContext _killedOpCtx;
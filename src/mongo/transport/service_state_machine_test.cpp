@@ -46,10 +46,12 @@
 #include "mongo/transport/service_executor.h"
 #include "mongo/transport/service_executor_utils.h"
 #include "mongo/transport/service_state_machine.h"
+#include "mongo/transport/service_state_machine_gen.h"
 #include "mongo/transport/transport_layer_mock.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/tick_source_mock.h"
 
 namespace mongo {
@@ -177,7 +179,11 @@ public:
 
         Status sinkMessage(Message message) override {
             auto tl = checked_cast<MockTL*>(getTransportLayer());
-            ASSERT_EQ(tl->_ssm->state(), ServiceStateMachine::State::SinkWait);
+            // Overlapped exhaust responses are sunk while the SSM processes the next request.
+            auto state = tl->_ssm->state();
+            ASSERT(state == ServiceStateMachine::State::SinkWait ||
+                   (gOverlapSynchronousExhaustWrites.load() &&
+                    state == ServiceStateMachine::State::Process));
             tl->_lastTicketSource = false;
 
             LOGV2(22996, "In sinkMessage");
@@ -191,8 +197,10 @@ public:
             }
 
             auto out = MockSession::sinkMessage(message);
-            if (out.isOK())
+            if (out.isOK()) {
                 tl->_lastSunk = message;
+                tl->_allSunk.push_back(message);
+            }
 
             return out;
         }
@@ -217,6 +225,10 @@ public:
         return std::move(_lastSunk);
     }
 
+    const std::vector<Message>& getAllSunk() const {
+        return _allSunk;
+    }
+
     bool ranSink() const {
         return _ranSink;
     }
@@ -239,6 +251,7 @@ private:
     bool _ranSource = false;
     FailureMode _nextShouldFail = Nothing;
     Message _lastSunk;
+    std::vector<Message> _allSunk;
     ServiceStateMachine* _ssm;
     std::function<void()> _waitHook;
 
@@ -498,6 +511,95 @@ TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaust) {
     ASSERT_EQ(firstResponseId, msg.header().getResponseToMsgId());
 }
 
+TEST_F(ServiceStateMachineFixture, TestGetMoreWithOverlappedExhaustWrites) {
+    gOverlapSynchronousExhaustWrites.store(true);
+    ON_BLOCK_EXIT([] { gOverlapSynchronousExhaustWrites.store(false); });
+
+    // Construct a 'getMore' OP_MSG request with the exhaust flag set.
+    const int32_t initRequestId = 1;
+    const long long cursorId = 42;
+    const std::string nss = "test.coll";
+    Message getMoreWithExhaust = getMoreRequestWithExhaust(nss, cursorId, initRequestId);
+
+    // Construct a 'getMore' response, with a non-zero cursor id and an empty batch.
+    BSONObj getMoreResBody =
+        BSON("ok" << 1 << "cursor"
+                  << BSON("id" << cursorId << "ns" << nss << "nextBatch" << BSONArray()));
+    Message getMoreRes = buildOpMsg(getMoreResBody);
+
+    _tl->setSourceMessage(getMoreWithExhaust);
+    _sep->setResponseMessage(getMoreRes);
+
+    // Let the 'getMore' request be sourced from the network and processed in the database.
+    // Because the request message has an exhaust flag, we should end up back in the 'Process'
+    // state, rather than in 'Source' state, while the response is sunk on another thread.
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Process);
+    _ssm->runNext();
+    ASSERT_FALSE(haveClient());
+    ASSERT_EQ(_ssm->state(), State::Process);
+
+    // Construct a terminal 'getMore' response, indicated by a cursor id equal to zero.
+    BSONObj getMoreTerminalResBody =
+        BSON("ok" << 1 << "cursor" << BSON("id" << 0 << "ns" << nss << "nextBatch" << BSONArray()));
+    Message getMoreTerminalRes = buildOpMsg(getMoreTerminalResBody);
+
+    // Process another 'getMore' message. This time the ServiceEntryPoint should respond with a
+    // terminal getMore, indicating that the exhaust stream should be ended. The first response
+    // must have been sunk before this one.
+    _sep->setResponseMessage(getMoreTerminalRes);
+
+    LOGV2(4798624, "runNext to terminate the exhaust stream");
+    _ssm->runNext();
+    ASSERT_FALSE(haveClient());
+    ASSERT_EQ(_ssm->state(), State::Source);
+
+    const auto& sunk = _tl->getAllSunk();
+    ASSERT_EQ(2U, sunk.size());
+
+    // Check the first sunk message.
+    auto msg = sunk[0];
+    auto firstResponseId = msg.header().getId();
+    ASSERT(!msg.empty());
+    ASSERT_EQ(initRequestId, msg.header().getResponseToMsgId());
+    auto reply = OpMsg::parse(msg);
+    ASSERT(OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    ASSERT_BSONOBJ_EQ(getMoreResBody, reply.body);
+
+    // Check the final sunk message.
+    msg = sunk[1];
+    ASSERT(!msg.empty());
+    reply = OpMsg::parse(msg);
+    ASSERT(!OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    ASSERT_BSONOBJ_EQ(getMoreTerminalResBody, reply.body);
+    ASSERT_EQ(firstResponseId, msg.header().getResponseToMsgId());
+}
+
+TEST_F(ServiceStateMachineFixture, TestGetMoreWithOverlappedExhaustWritesSinkError) {
+    gOverlapSynchronousExhaustWrites.store(true);
+    ON_BLOCK_EXIT([] { gOverlapSynchronousExhaustWrites.store(false); });
+
+    const long long cursorId = 42;
+    const std::string nss = "test.coll";
+    _tl->setSourceMessage(getMoreRequestWithExhaust(nss, cursorId, 1));
+    _sep->setResponseMessage(buildOpMsg(BSON(
+        "ok" << 1 << "cursor"
+             << BSON("id" << cursorId << "ns" << nss << "nextBatch" << BSONArray()))));
+
+    // The first response fails to sink while the next one is being generated.
+    _tl->setNextFailure(MockTL::Sink);
+    _ssm->runNext();
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Process);
+
+    // The failure is noticed before the next response is sunk, and ends the session.
+    _ssm->runNext();
+    ASSERT_FALSE(haveClient());
+    ASSERT_EQ(_ssm->state(), State::Ended);
+    ASSERT_TRUE(_tl->ranSink());
+    ASSERT_EQ(0U, _tl->getAllSunk().size());
+}
+
 TEST_F(ServiceStateMachineFixture, TestThrowHandling) {
     _sep->setUassertInHandler();
 
@@ -73,5 +73,16 @@ Session::TagMask Session::getTags() const {
     return _tags.load();
 }
 
+Future<void> Session::asyncSinkMessages(std::vector<Message> messages, const BatonHandle& handle) {
+    auto future = Future<void>::makeReady();
+    for (auto& message : messages) {
+        future = std::move(future).then(
+            [session = shared_from_this(), message = std::move(message), handle]() mutable {
+                return session->asyncSinkMessage(std::move(message), handle);
+            });
+    }
+    return future;
+}
+
 }  // namespace transport
 }  // namespace mongo
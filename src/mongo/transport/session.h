@@ -30,6 +30,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/config.h"
 #include "mongo/db/baton.h"
@@ -128,6 +129,14 @@ public:
     virtual Status sinkMessage(Message message) = 0;
     virtual Future<void> asyncSinkMessage(Message message, const BatonHandle& handle = nullptr) = 0;
 
+    /**
+     * Sink several Messages back to back, as if by consecutive calls to asyncSinkMessage().
+     * Networked implementations may send them with a single write. The default implementation
+     * sinks them one after another.
+     */
+    virtual Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                           const BatonHandle& handle = nullptr);
+
     /**
      * Cancel any outstanding async operations. There is no way to cancel synchronous calls.
      * Futures will finish with an ErrorCodes::CallbackCancelled error if they haven't already
@@ -37,6 +37,7 @@
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/transport_layer_asio.h"
+#include "mongo/transport/transport_options_gen.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/net/socket_utils.h"
 #ifdef MONGO_CONFIG_SSL
@@ -168,6 +169,9 @@ public:
     }
 
     Future<void> waitForData() override {
+        if (_bytesReadAhead > 0) {
+            return Future<void>::makeReady();
+        }
 #ifdef MONGO_CONFIG_SSL
         if (_sslSocket)
             return asio::async_read(*_sslSocket, asio::null_buffers(), UseFuture{}).ignoreValue();
@@ -178,7 +182,7 @@ public:
     Status sinkMessage(Message message) override {
         ensureSync();
 
-        return write(asio::buffer(message.buf(), message.size()))
+        return writeMessage(message)
             .then([this, &message] {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -189,7 +193,7 @@ public:
 
     Future<void> asyncSinkMessage(Message message, const BatonHandle& baton = nullptr) override {
         ensureAsync();
-        return write(asio::buffer(message.buf(), message.size()), baton)
+        return writeMessage(message, baton)
             .then([this, message /*keep the buffer alive*/]() {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -197,6 +201,19 @@ public:
             });
     }
 
+    Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                   const BatonHandle& baton = nullptr) override {
+        ensureAsync();
+        auto written = write(MessageSegments(messages), baton);
+        return std::move(written).then([this, messages = std::move(messages)]() {
+            if (_isIngressSession) {
+                for (const auto& message : messages) {
+                    networkCounter.hitPhysicalOut(message.size());
+                }
+            }
+        });
+    }
+
     void cancelAsyncOperations(const BatonHandle& baton = nullptr) override {
         LOGV2_DEBUG(4615608,
                     3,
@@ -403,8 +420,13 @@ private:
         return _socket;
     }
 
+    static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
     Future<Message> sourceMessageImpl(const BatonHandle& baton = nullptr) {
-        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+        const auto readAheadBytes = size_t(gNetworkReadAheadBytes.load());
+        if (_bytesReadAhead > 0 || (readAheadBytes > 0 && canReadAhead())) {
+            return sourceMessageWithReadAhead(readAheadBytes, baton);
+        }
 
         auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
         auto ptr = headerBuffer.get();
@@ -415,19 +437,8 @@ private:
                 }
 
                 const auto msgLen = size_t(MSGHEADER::View(headerBuffer.get()).getMessageLength());
-                if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
-                    StringBuilder sb;
-                    sb << "recv(): message msgLen " << msgLen << " is invalid. "
-                       << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
-                    const auto str = sb.str();
-                    LOGV2(4615638,
-                          "recv(): message msgLen {msgLen} is invalid. Min: {min} Max: {max}",
-                          "recv(): message mstLen is invalid.",
-                          "msgLen"_attr = msgLen,
-                          "min"_attr = kHeaderSize,
-                          "max"_attr = MaxMessageSizeBytes);
-
-                    return Future<Message>::makeReady(Status(ErrorCodes::ProtocolError, str));
+                if (auto status = checkMessageLength(msgLen); !status.isOK()) {
+                    return Future<Message>::makeReady(std::move(status));
                 }
 
                 if (msgLen == kHeaderSize) {
@@ -452,6 +463,115 @@ private:
             });
     }
 
+    /**
+     * Receives a message by asking for up to 'readAheadBytes' bytes when reading its header, so
+     * that a small message is usually received with a single system call. Whatever is received
+     * beyond the end of the message is kept in '_readAheadBuffer' for the next call.
+     */
+    Future<Message> sourceMessageWithReadAhead(size_t readAheadBytes, const BatonHandle& baton) {
+        auto buffer =
+            SharedBuffer::allocate(std::max({kHeaderSize, readAheadBytes, _bytesReadAhead}));
+        const size_t buffered = _bytesReadAhead;
+        if (buffered > 0) {
+            memcpy(buffer.get(), _readAheadBuffer.get(), buffered);
+            _readAheadBuffer = {};
+            _bytesReadAhead = 0;
+        }
+
+        auto received = buffered >= kHeaderSize
+            ? Future<size_t>::makeReady(buffered)
+            : readAtLeast(asio::buffer(buffer.get() + buffered, buffer.capacity() - buffered),
+                          kHeaderSize - buffered,
+                          baton)
+                  .then([buffered](size_t size) { return buffered + size; });
+
+        return std::move(received).then(
+            [this, buffer = std::move(buffer), baton](size_t received) mutable {
+                if (checkForHTTPRequest(asio::buffer(buffer.get(), kHeaderSize))) {
+                    return sendHTTPResponse(baton);
+                }
+
+                const auto msgLen = size_t(MSGHEADER::View(buffer.get()).getMessageLength());
+                if (auto status = checkMessageLength(msgLen); !status.isOK()) {
+                    return Future<Message>::makeReady(std::move(status));
+                }
+
+                if (received >= msgLen) {
+                    if (received > msgLen) {
+                        _bytesReadAhead = received - msgLen;
+                        _readAheadBuffer = SharedBuffer::allocate(_bytesReadAhead);
+                        memcpy(_readAheadBuffer.get(), buffer.get() + msgLen, _bytesReadAhead);
+                    }
+                    if (_isIngressSession) {
+                        networkCounter.hitPhysicalIn(msgLen);
+                    }
+                    return Future<Message>::makeReady(Message(std::move(buffer)));
+                }
+
+                if (msgLen > buffer.capacity()) {
+                    auto largerBuffer = SharedBuffer::allocate(msgLen);
+                    memcpy(largerBuffer.get(), buffer.get(), received);
+                    buffer = std::move(largerBuffer);
+                }
+
+                auto ptr = buffer.get() + received;
+                return read(asio::buffer(ptr, msgLen - received), baton)
+                    .then([this, buffer = std::move(buffer), msgLen]() mutable {
+                        if (_isIngressSession) {
+                            networkCounter.hitPhysicalIn(msgLen);
+                        }
+                        return Message(std::move(buffer));
+                    });
+            });
+    }
+
+    Status checkMessageLength(size_t msgLen) {
+        if (msgLen >= kHeaderSize && msgLen <= MaxMessageSizeBytes) {
+            return Status::OK();
+        }
+
+        StringBuilder sb;
+        sb << "recv(): message msgLen " << msgLen << " is invalid. "
+           << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+        const auto str = sb.str();
+        LOGV2(4615638,
+              "recv(): message msgLen {msgLen} is invalid. Min: {min} Max: {max}",
+              "recv(): message mstLen is invalid.",
+              "msgLen"_attr = msgLen,
+              "min"_attr = kHeaderSize,
+              "max"_attr = MaxMessageSizeBytes);
+
+        return Status(ErrorCodes::ProtocolError, str);
+    }
+
+    /**
+     * Reading ahead must wait until we know whether the session uses TLS, because the bytes
+     * following the header of a TLS handshake must be left to the TLS stream.
+     */
+    bool canReadAhead() const {
+#ifdef MONGO_CONFIG_SSL
+        return _sslSocket || _ranHandshake;
+#else
+        return true;
+#endif
+    }
+
+    /**
+     * Reads at least 'minBytes' and at most the size of 'buffers', and returns how many bytes
+     * were read. Unlike read(), this does not detect the TLS handshake, see canReadAhead().
+     */
+    template <typename MutableBufferSequence>
+    Future<size_t> readAtLeast(const MutableBufferSequence& buffers,
+                               size_t minBytes,
+                               const BatonHandle& baton = nullptr) {
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket) {
+            return opportunisticReadAtLeast(*_sslSocket, buffers, minBytes, baton);
+        }
+#endif
+        return opportunisticReadAtLeast(_socket, buffers, minBytes, baton);
+    }
+
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers, const BatonHandle& baton = nullptr) {
         // TODO SERVER-47229 Guard active ops for cancelation here.
@@ -478,6 +598,17 @@ private:
         return opportunisticRead(_socket, buffers, baton);
     }
 
+    /**
+     * Writes "message", gathering its segments if it is fragmented. The message must stay alive
+     * until the returned future is ready.
+     */
+    Future<void> writeMessage(const Message& message, const BatonHandle& baton = nullptr) {
+        if (message.isFragmented()) {
+            return write(MessageSegments(message), baton);
+        }
+        return write(asio::buffer(message.buf(), message.size()), baton);
+    }
+
     template <typename ConstBufferSequence>
     Future<void> write(const ConstBufferSequence& buffers, const BatonHandle& baton = nullptr) {
         // TODO SERVER-47229 Guard active ops for cancelation here.
@@ -506,6 +637,15 @@ private:
     Future<void> opportunisticRead(Stream& stream,
                                    const MutableBufferSequence& buffers,
                                    const BatonHandle& baton = nullptr) {
+        return opportunisticReadAtLeast(stream, buffers, asio::buffer_size(buffers), baton)
+            .ignoreValue();
+    }
+
+    template <typename Stream, typename MutableBufferSequence>
+    Future<size_t> opportunisticReadAtLeast(Stream& stream,
+                                            const MutableBufferSequence& buffers,
+                                            size_t minBytes,
+                                            const BatonHandle& baton = nullptr) {
         std::error_code ec;
         size_t size;
 
@@ -521,12 +661,12 @@ private:
                 size = asio::read(stream, localBuffer, ec);
             } while (ec == asio::error::interrupted);  // retry syscall EINTR
 
-            if (!ec && buffers.size() > 1) {
+            if (!ec && minBytes > 1) {
                 ec = asio::error::would_block;
             }
         } else {
             do {
-                size = asio::read(stream, buffers, ec);
+                size = asio::read(stream, buffers, asio::transfer_at_least(minBytes), ec);
             } while (ec == asio::error::interrupted);  // retry syscall EINTR
         }
 
@@ -539,6 +679,8 @@ private:
             if (size > 0) {
                 asyncBuffers += size;
             }
+            const size_t remaining = minBytes - size;
+            auto addSize = [size](size_t asyncSize) { return size + asyncSize; };
 
             if (auto networkingBaton = baton ? baton->networking() : nullptr;
                 networkingBaton && networkingBaton->canWait()) {
@@ -553,14 +695,17 @@ private:
 
                         return error;
                     })
-                    .then([&stream, asyncBuffers, baton, this] {
-                        return opportunisticRead(stream, asyncBuffers, baton);
-                    });
+                    .then([&stream, asyncBuffers, remaining, baton, this] {
+                        return opportunisticReadAtLeast(stream, asyncBuffers, remaining, baton);
+                    })
+                    .then(addSize);
             }
 
-            return asio::async_read(stream, asyncBuffers, UseFuture{}).ignoreValue();
+            return asio::async_read(
+                       stream, asyncBuffers, asio::transfer_at_least(remaining), UseFuture{})
+                .then(addSize);
         } else {
-            return futurize(ec);
+            return futurize(ec, size);
         }
     }
 
@@ -609,16 +754,16 @@ private:
 
         if (MONGO_unlikely(transportLayerASIOshortOpportunisticReadWrite.shouldFail()) &&
             _blockingMode == Async) {
-            asio::const_buffer localBuffer = buffers;
+            asio::const_buffer localBuffer = *asio::buffer_sequence_begin(buffers);
 
-            if (buffers.size()) {
-                localBuffer = asio::const_buffer(buffers.data(), 1);
+            if (localBuffer.size()) {
+                localBuffer = asio::const_buffer(localBuffer.data(), 1);
             }
 
             do {
                 size = asio::write(stream, localBuffer, ec);
             } while (ec == asio::error::interrupted);  // retry syscall EINTR
-            if (!ec && buffers.size() > 1) {
+            if (!ec && asio::buffer_size(buffers) > 1) {
                 ec = asio::error::would_block;
             }
         } else {
@@ -820,6 +965,11 @@ private:
 
     TransportLayerASIO* const _tl;
     bool _isIngressSession;
+
+    // Bytes which were read ahead of the end of the last message received, see
+    // sourceMessageWithReadAhead().
+    SharedBuffer _readAheadBuffer;
+    size_t _bytesReadAhead = 0;
 };
 
 }  // namespace transport
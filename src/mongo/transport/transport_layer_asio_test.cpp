@@ -36,9 +36,11 @@
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/op_msg.h"
 #include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_options_gen.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/net/sock.h"
+#include "mongo/util/scopeguard.h"
 
 #include "asio.hpp"
 
@@ -275,15 +277,26 @@ public:
     }
 
     void sendMessage() {
-        OpMsgBuilder builder;
-        builder.setBody(BSON("ping" << 1));
-        Message msg = builder.finish();
-        msg.header().setResponseToMsgId(0);
-        msg.header().setId(0);
-        OpMsg::appendChecksum(&msg);
+        sendMessages({BSON("ping" << 1)});
+    }
+
+    /**
+     * Sends a message for each of 'bodies' with a single write.
+     */
+    void sendMessages(const std::vector<BSONObj>& bodies) {
+        std::string data;
+        for (const auto& body : bodies) {
+            OpMsgBuilder builder;
+            builder.setBody(body);
+            Message msg = builder.finish();
+            msg.header().setResponseToMsgId(0);
+            msg.header().setId(0);
+            OpMsg::appendChecksum(&msg);
+            data.append(msg.buf(), msg.size());
+        }
 
         std::error_code ec;
-        asio::write(_sock, asio::buffer(msg.buf(), msg.size()), ec);
+        asio::write(_sock, asio::buffer(data), ec);
         ASSERT_FALSE(ec);
     }
 
@@ -386,5 +399,59 @@ TEST(TransportLayerASIO, SwitchTimeoutModes) {
     tla->shutdown();
 }
 
+class ReadAheadSEP : public TimeoutSEP {
+public:
+    explicit ReadAheadSEP(size_t numMessages) : _numMessages(numMessages) {}
+
+    void startSession(transport::SessionHandle session) override {
+        startWorkerThread([this, session = std::move(session)]() mutable {
+            for (size_t i = 0; i < _numMessages; ++i) {
+                auto swMessage = session->sourceMessage();
+                ASSERT_OK(swMessage.getStatus());
+                received.push_back(OpMsg::parse(swMessage.getValue()).body.getOwned());
+            }
+
+            session.reset();
+            notifyComplete();
+        });
+    }
+
+    // Only written by the worker thread until it notifies completion.
+    std::vector<BSONObj> received;
+
+private:
+    const size_t _numMessages;
+};
+
+/* check that reading ahead receives both messages that arrive together and larger messages */
+TEST(TransportLayerASIO, ReadAheadReceivesPipelinedMessages) {
+    const auto originalReadAheadBytes = transport::gNetworkReadAheadBytes.load();
+    transport::gNetworkReadAheadBytes.store(64);
+    ON_BLOCK_EXIT([&] { transport::gNetworkReadAheadBytes.store(originalReadAheadBytes); });
+
+    const std::vector<BSONObj> bodies = {BSON("ping" << 1),
+                                         BSON("ping" << 2),
+                                         BSON("ping" << 3 << "padding" << std::string(200, 'x')),
+                                         BSON("ping" << 4),
+                                         BSON("ping" << 5)};
+
+    ReadAheadSEP sep(bodies.size());
+    auto tla = makeAndStartTL(&sep);
+
+    // The first message is received before the session knows whether it uses TLS, so it is not
+    // read ahead of.
+    TimeoutConnector connector(tla->listenerPort(), false);
+    connector.sendMessages({bodies.front()});
+    connector.sendMessages({bodies.begin() + 1, bodies.end()});
+
+    ASSERT_TRUE(sep.waitForTimeout());
+    ASSERT_EQ(sep.received.size(), bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        ASSERT_BSONOBJ_EQ(sep.received[i], bodies[i]);
+    }
+
+    tla->shutdown();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -35,6 +35,8 @@
 #include "mongo/util/fast_clock_source_factory.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/system_clock_source.h"
+#include "mongo/util/system_tick_source.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -76,5 +78,26 @@ BENCHMARK(BM_ClockNow)
     ->Arg(1)
     ->Arg(10);
 
+/**
+ * Benchmark calls to the getTicks() method of the SystemTickSource, which backs Timer and the
+ * operation timing in CurOp, and the cost of reading a Timer.
+ */
+void BM_SystemTickSourceGetTicks(benchmark::State& state) {
+    auto tickSource = SystemTickSource::get();
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(tickSource->getTicks());
+    }
+}
+
+void BM_TimerMicros(benchmark::State& state) {
+    Timer timer;
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(timer.micros());
+    }
+}
+
+BENCHMARK(BM_SystemTickSourceGetTicks)->ThreadRange(1, ProcessInfo::getNumAvailableCores());
+BENCHMARK(BM_TimerMicros);
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+/**
+ * The class of service an operation gets when it waits for a ticket to enter the storage engine.
+ * Waiting operations are admitted by weighted fair queuing between the classes, see TicketHolder.
+ */
+enum class AdmissionPriority {
+    // Long-running work which can yield to everything else, such as analytics queries.
+    kLow,
+    kNormal,
+    // Work which the deployment depends on, such as reads by other members of the replica set.
+    kHigh,
+};
+
+constexpr std::size_t kNumAdmissionPriorities = 3;
+
+inline StringData toString(AdmissionPriority priority) {
+    switch (priority) {
+        case AdmissionPriority::kLow:
+            return "low"_sd;
+        case AdmissionPriority::kNormal:
+            return "normal"_sd;
+        case AdmissionPriority::kHigh:
+            return "high"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+inline StatusWith<AdmissionPriority> parseAdmissionPriority(StringData str) {
+    for (auto priority :
+         {AdmissionPriority::kLow, AdmissionPriority::kNormal, AdmissionPriority::kHigh}) {
+        if (str == toString(priority)) {
+            return priority;
+        }
+    }
+    return {ErrorCodes::BadValue,
+            str::stream() << "Invalid admission priority '" << str
+                          << "', expected 'low', 'normal' or 'high'"};
+}
+
+}  // namespace mongo
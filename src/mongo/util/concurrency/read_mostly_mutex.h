@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+
+/**
+ * A reader/writer mutex for state which is read on nearly every operation but written rarely.
+ *
+ * Readers announce themselves by incrementing one of several cache-line aligned counters, chosen
+ * per thread, so concurrent readers on different cores neither block each other nor contend on a
+ * shared cache line. A writer is exclusive with other writers and with all readers: it raises a
+ * flag which turns away new readers and then waits for every counter to drain, which makes
+ * exclusive acquisition considerably more expensive than that of an ordinary Mutex.
+ *
+ * Shared acquisition is not recursive. A thread which already holds the mutex, in either mode,
+ * must not acquire it in shared mode again, since a waiting writer would deadlock it.
+ *
+ * Exclusive acquisition meets the BasicLockable requirements and so can be used through
+ * stdx::lock_guard and stdx::unique_lock. Shared acquisition is only available through SharedLock.
+ */
+class ReadMostlyMutex {
+    ReadMostlyMutex(const ReadMostlyMutex&) = delete;
+    ReadMostlyMutex& operator=(const ReadMostlyMutex&) = delete;
+
+    using Slot = CacheAligned<AtomicWord<long long>>;
+
+public:
+    static constexpr size_t kNumSlots = 64;
+
+    /**
+     * RAII guard holding a ReadMostlyMutex in shared mode for its lifetime.
+     */
+    class SharedLock {
+        SharedLock(const SharedLock&) = delete;
+        SharedLock& operator=(const SharedLock&) = delete;
+
+    public:
+        explicit SharedLock(const ReadMostlyMutex& mutex) : _slot(mutex._lockShared()) {}
+
+        ~SharedLock() {
+            _slot.fetchAndSubtract(1);
+        }
+
+    private:
+        // The guard remembers its slot, rather than recomputing it on release, so that it stays
+        // correct even if it is destroyed on a different thread than the one which created it.
+        Slot& _slot;
+    };
+
+    ReadMostlyMutex() = default;
+
+    void lock() {
+        _writerMutex.lock();
+        _writerActive.store(true);
+        for (auto& slot : _slots) {
+            while (slot.load() != 0) {
+                stdx::this_thread::yield();
+            }
+        }
+    }
+
+    void unlock() {
+        _writerActive.store(false);
+        _writerMutex.unlock();
+    }
+
+private:
+    Slot& _lockShared() const {
+        auto& slot = _slots[_slotIndexForThisThread()];
+        while (true) {
+            // Both the increment and the check are sequentially consistent, which pairs with the
+            // store of '_writerActive' and the loads of the slots in lock(): either this reader
+            // sees the writer's flag, or the writer sees this reader's count.
+            slot.fetchAndAdd(1);
+            if (MONGO_likely(!_writerActive.load())) {
+                return slot;
+            }
+            slot.fetchAndSubtract(1);
+
+            // Block until the writer is done, by briefly acquiring the mutex which it holds.
+            stdx::lock_guard<Latch> lk(_writerMutex);
+        }
+    }
+
+    static size_t _slotIndexForThisThread() {
+        static AtomicWord<unsigned> nextSlot;
+        thread_local const size_t slotIndex = nextSlot.fetchAndAdd(1) % kNumSlots;
+        return slotIndex;
+    }
+
+    mutable std::array<Slot, kNumSlots> _slots;
+
+    AtomicWord<bool> _writerActive{false};
+
+    // Serializes writers, and is what readers block on while a writer is active.
+    mutable Mutex _writerMutex = MONGO_MAKE_LATCH("ReadMostlyMutex::_writerMutex");
+};
+
+}  // namespace mongo
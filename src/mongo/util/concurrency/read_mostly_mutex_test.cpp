@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/read_mostly_mutex.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+TEST(ReadMostlyMutex, ReadersDoNotExcludeEachOther) {
+    ReadMostlyMutex mutex;
+    ReadMostlyMutex::SharedLock lk(mutex);
+
+    bool otherReaderRan = false;
+    stdx::thread reader([&] {
+        ReadMostlyMutex::SharedLock otherLk(mutex);
+        otherReaderRan = true;
+    });
+    reader.join();
+    ASSERT(otherReaderRan);
+}
+
+TEST(ReadMostlyMutex, WriterWaitsForReaders) {
+    ReadMostlyMutex mutex;
+    AtomicWord<bool> writerAcquired{false};
+
+    boost::optional<ReadMostlyMutex::SharedLock> lk;
+    lk.emplace(mutex);
+    stdx::thread writer([&] {
+        stdx::lock_guard<ReadMostlyMutex> writeLk(mutex);
+        writerAcquired.store(true);
+    });
+
+    sleepFor(Milliseconds(50));
+    ASSERT_FALSE(writerAcquired.load());
+
+    lk.reset();
+    writer.join();
+    ASSERT_TRUE(writerAcquired.load());
+}
+
+TEST(ReadMostlyMutex, ReadersNeverObserveAPartialWrite) {
+    constexpr int kNumReaders = 16;
+    constexpr int kNumWriters = 2;
+    constexpr int kWritesPerWriter = 2000;
+
+    ReadMostlyMutex mutex;
+    long long first = 0;
+    long long second = 0;
+    AtomicWord<bool> done{false};
+    AtomicWord<long long> tornReads{0};
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumReaders; ++i) {
+        threads.emplace_back([&] {
+            while (!done.load()) {
+                ReadMostlyMutex::SharedLock lk(mutex);
+                if (first != second) {
+                    tornReads.fetchAndAdd(1);
+                }
+            }
+        });
+    }
+
+    std::vector<stdx::thread> writers;
+    for (int i = 0; i < kNumWriters; ++i) {
+        writers.emplace_back([&] {
+            for (int j = 0; j < kWritesPerWriter; ++j) {
+                stdx::lock_guard<ReadMostlyMutex> lk(mutex);
+                ++first;
+                ++second;
+            }
+        });
+    }
+
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    done.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(tornReads.load(), 0);
+    ASSERT_EQ(first, kNumWriters * kWritesPerWriter);
+    ASSERT_EQ(second, kNumWriters * kWritesPerWriter);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -238,9 +238,42 @@ void ThreadPool::schedule(Task task) {
     if (_numIdleThreads <= _pendingTasks.size()) {
         _lastFullUtilizationDate = Date_t::now();
     }
+    _notifyWorkAvailable_inlock();
+}
+
+void ThreadPool::_notifyWorkAvailable_inlock() {
+    // A thread which is idle but not waiting, for instance because it just finished a task or was
+    // just started, is bound to pick up a pending task by itself. Waking up a waiting thread on top
+    // of it would only make that thread contend on _mutex to find an empty queue.
+    const auto numAwakeIdleThreads = _numIdleThreads - _numWaitingThreads + _numPendingWakeups;
+    if (_pendingTasks.size() <= numAwakeIdleThreads ||
+        _numPendingWakeups >= _numWaitingThreads) {
+        return;
+    }
+    ++_numPendingWakeups;
     _workAvailable.notify_one();
 }
 
+void ThreadPool::_waitForWork_inlock(stdx::unique_lock<Latch>* lk,
+                                     boost::optional<Date_t> deadline) {
+    ++_numWaitingThreads;
+    {
+        MONGO_IDLE_THREAD_BLOCK;
+        if (deadline) {
+            _workAvailable.wait_until(*lk, deadline->toSystemTimePoint());
+        } else {
+            _workAvailable.wait(*lk);
+        }
+    }
+    --_numWaitingThreads;
+
+    // Whether this thread was notified, timed out or woke up spuriously, it is going to look at
+    // _pendingTasks, so it stands for one of the pending wakeups, if there are any.
+    if (_numPendingWakeups > 0) {
+        --_numPendingWakeups;
+    }
+}
+
 void ThreadPool::waitForIdle() {
     stdx::unique_lock<Latch> lk(_mutex);
     // If there are any pending tasks, or non-idle threads, the pool is not idle.
@@ -323,8 +356,7 @@ void ThreadPool::_consumeTasks() {
                             "{nextThreadRetirementDate}",
                             "Not reaping this thread",
                             "nextThreadRetirementDate"_attr = nextThreadRetirementDate);
-                MONGO_IDLE_THREAD_BLOCK;
-                _workAvailable.wait_until(lk, nextThreadRetirementDate.toSystemTimePoint());
+                _waitForWork_inlock(&lk, nextThreadRetirementDate);
             } else {
                 // Since the number of threads is not more than minThreads, this thread is not
                 // eligible for retirement. It is OK to sleep until _workAvailable is signaled,
@@ -337,8 +369,7 @@ void ThreadPool::_consumeTasks() {
                             "Waiting for work",
                             "numThreads"_attr = _threads.size(),
                             "minThreads"_attr = _options.minThreads);
-                MONGO_IDLE_THREAD_BLOCK;
-                _workAvailable.wait(lk);
+                _waitForWork_inlock(&lk, boost::none);
             }
             continue;
         }
@@ -34,6 +34,8 @@
 #include <string>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
@@ -213,6 +215,18 @@ private:
      */
     void _doOneTask(stdx::unique_lock<Latch>* lk) noexcept;
 
+    /**
+     * Wakes up a thread waiting on _workAvailable, unless enough idle threads are already awake,
+     * or have already been woken up, to take care of all the pending tasks.
+     */
+    void _notifyWorkAvailable_inlock();
+
+    /**
+     * Blocks on _workAvailable, until "deadline" if one is given, while keeping track of the number
+     * of threads waiting for work and of the wakeups they haven't consumed yet.
+     */
+    void _waitForWork_inlock(stdx::unique_lock<Latch>* lk, boost::optional<Date_t> deadline);
+
     /**
      * Changes the lifecycle state (_state) of the pool and wakes up any threads waiting for a state
      * change. Has no effect if _state == newState.
@@ -261,6 +275,14 @@ private:
     // Count of idle threads.
     size_t _numIdleThreads = 0;
 
+    // Count of the idle threads which are blocked on _workAvailable. The remaining idle threads are
+    // awake and will look at _pendingTasks before waiting again.
+    size_t _numWaitingThreads = 0;
+
+    // Count of the notifications of _workAvailable which have been sent to waiting threads and not
+    // yet consumed by one of them waking up.
+    size_t _numPendingWakeups = 0;
+
     // Id counter for assigning thread names
     size_t _nextThreadId = 0;
 
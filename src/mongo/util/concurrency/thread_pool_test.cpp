@@ -309,4 +309,45 @@ TEST(ThreadPoolTest, JoinAllRetiredThreads) {
     ASSERT_EQ(pool.getStats().numIdleThreads, 0);
 }
 
+TEST(ThreadPoolTest, ConcurrentlyScheduledTasksAllRun) {
+    // Tasks are scheduled both from outside the pool and from its own tasks, so that wakeups are
+    // skipped as often as possible in favor of threads which are already awake.
+    constexpr int kNumProducers = 4;
+    constexpr int kNumTasksPerProducer = 5000;
+    ThreadPool::Options options;
+    options.minThreads = 2;
+    options.maxThreads = 4;
+    ThreadPool pool(options);
+    pool.startup();
+
+    AtomicWord<int> numTasksRun(0);
+    std::vector<stdx::thread> producers;
+    for (int i = 0; i < kNumProducers; ++i) {
+        producers.emplace_back([&] {
+            for (int j = 0; j < kNumTasksPerProducer; ++j) {
+                pool.schedule([&](auto status) {
+                    ASSERT_OK(status);
+                    pool.schedule([&](auto status) {
+                        ASSERT_OK(status);
+                        numTasksRun.addAndFetch(1);
+                    });
+                });
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    // Every task must get picked up without any further scheduling activity.
+    while (numTasksRun.load() < kNumProducers * kNumTasksPerProducer) {
+        sleepmillis(1);
+    }
+    pool.waitForIdle();
+    ASSERT_EQ(pool.getStats().numPendingTasks, 0);
+
+    pool.shutdown();
+    pool.join();
+}
+
 }  // namespace
@@ -33,9 +33,11 @@
 
 #include "mongo/util/concurrency/ticketholder.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -61,14 +63,6 @@ void check(int ret) {
         return;
     failWithErrno(errno);
 }
-
-/**
- * Takes a Date_t deadline and sets the appropriate values in a timespec structure.
- */
-void tsFromDate(const Date_t& deadline, struct timespec& ts) {
-    ts.tv_sec = deadline.toTimeT();
-    ts.tv_nsec = (deadline.toMillisSinceEpoch() % 1000) * 1'000'000;
-}
 }  // namespace
 
 TicketHolder::TicketHolder(int num) : _outof(num) {
@@ -89,48 +83,32 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
+void TicketHolder::waitForTicket(OperationContext* opCtx, AdmissionPriority priority) {
+    waitForTicketUntil(opCtx, Date_t::max(), priority);
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    // Attempt to get a ticket without waiting in order to avoid expensive time calculations.
-    if (sem_trywait(&_sem) == 0) {
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx,
+                                      Date_t until,
+                                      AdmissionPriority priority) {
+    // Attempt to get a ticket without waiting, unless other operations are already queued for
+    // one, in order to avoid taking the queue mutex.
+    if (_numQueued.load() == 0 && sem_trywait(&_sem) == 0) {
         return true;
     }
 
-    const Milliseconds intervalMs(500);
-    struct timespec ts;
-
-    // To support interrupting ticket acquisition while still benefiting from semaphores, we do a
-    // timed wait on an interval to periodically check for interrupts.
-    // The wait period interval is the smaller of the default interval and the provided
-    // deadline.
-    Date_t deadline = std::min(until, Date_t::now() + intervalMs);
-    tsFromDate(deadline, ts);
-
-    while (0 != sem_timedwait(&_sem, &ts)) {
-        if (errno == ETIMEDOUT) {
-            // If we reached the deadline without being interrupted, we have completely timed out.
-            if (deadline == until)
-                return false;
-
-            deadline = std::min(until, Date_t::now() + intervalMs);
-            tsFromDate(deadline, ts);
-        } else if (errno != EINTR) {
-            failWithErrno(errno);
-        }
-
-        // To correctly handle errors from sem_timedwait, we should check for interrupts last.
-        // It is possible to unset 'errno' after a call to checkForInterrupt().
-        if (opCtx)
-            opCtx->checkForInterrupt();
-    }
-    return true;
+    stdx::unique_lock<Latch> lk(_queueMutex);
+    return _waitInQueue(lk, opCtx, until, priority);
 }
 
 void TicketHolder::release() {
     check(sem_post(&_sem));
+
+    // A waiter checks for an available ticket after it is queued, so either it finds the ticket
+    // just posted, or it is seen here.
+    if (_numQueued.load() > 0) {
+        stdx::lock_guard<Latch> lk(_queueMutex);
+        _grantWaiters(lk);
+    }
 }
 
 Status TicketHolder::resize(int newSize) {
@@ -173,6 +151,14 @@ int TicketHolder::outof() const {
     return _outof.load();
 }
 
+bool TicketHolder::_tryTakeTicket(WithLock) {
+    return tryAcquire();
+}
+
+void TicketHolder::_returnTicket(WithLock) {
+    check(sem_post(&_sem));
+}
+
 #else
 
 TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
@@ -184,34 +170,24 @@ bool TicketHolder::tryAcquire() {
     return _tryAcquire();
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    stdx::unique_lock<Latch> lk(_mutex);
-
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
-    }
+void TicketHolder::waitForTicket(OperationContext* opCtx, AdmissionPriority priority) {
+    waitForTicketUntil(opCtx, Date_t::max(), priority);
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx,
+                                      Date_t until,
+                                      AdmissionPriority priority) {
     stdx::unique_lock<Latch> lk(_mutex);
-
-    if (opCtx) {
-        return opCtx->waitForConditionOrInterruptUntil(
-            _newTicket, lk, until, [this] { return _tryAcquire(); });
-    } else {
-        return _newTicket.wait_until(
-            lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
+    if (_numQueued.load() == 0 && _tryAcquire()) {
+        return true;
     }
+    return _waitInQueue(lk, opCtx, until, priority);
 }
 
 void TicketHolder::release() {
-    {
-        stdx::lock_guard<Latch> lk(_mutex);
-        _num++;
-    }
-    _newTicket.notify_one();
+    stdx::lock_guard<Latch> lk(_mutex);
+    _num++;
+    _grantWaiters(lk);
 }
 
 Status TicketHolder::resize(int newSize) {
@@ -231,8 +207,7 @@ Status TicketHolder::resize(int newSize) {
     _outof.store(newSize);
     _num = _outof.load() - used;
 
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
+    _grantWaiters(lk);
     return Status::OK();
 }
 
@@ -258,5 +233,116 @@ bool TicketHolder::_tryAcquire() {
     _num--;
     return true;
 }
+
+bool TicketHolder::_tryTakeTicket(WithLock) {
+    return _tryAcquire();
+}
+
+void TicketHolder::_returnTicket(WithLock) {
+    _num++;
+}
 #endif
+
+namespace {
+
+// How far a queue's pass moves ahead on each of its turns, indexed by AdmissionPriority. A queue
+// gets turns in inverse proportion, so high priority waiters are admitted 16 times as often as
+// low priority ones while both are waiting.
+constexpr std::array<std::uint64_t, kNumAdmissionPriorities> kStrides = {16, 4, 1};
+
+}  // namespace
+
+bool TicketHolder::_waitInQueue(stdx::unique_lock<Latch>& lk,
+                                OperationContext* opCtx,
+                                Date_t until,
+                                AdmissionPriority priority) {
+    Waiter waiter(priority);
+    auto& queue = _queues[static_cast<size_t>(priority)];
+    if (queue.waiters.empty()) {
+        // A queue which was idle does not get to catch up on the turns it did not use.
+        queue.pass = std::max(queue.pass, _virtualTime);
+    }
+    queue.waiters.push_back(&waiter);
+    _numQueued.fetchAndAdd(1);
+
+    // A ticket may have been released before this waiter was queued.
+    _grantWaiters(lk);
+
+    auto leaveQueueGuard = makeGuard([&] {
+        if (waiter.granted) {
+            // The wait was interrupted after a ticket was handed over, so pass it on.
+            _returnTicket(lk);
+            _grantWaiters(lk);
+        } else {
+            _removeWaiter(lk, &waiter);
+        }
+    });
+
+    auto isGranted = [&] { return waiter.granted; };
+    if (opCtx) {
+        opCtx->waitForConditionOrInterruptUntil(waiter.cv, lk, until, isGranted);
+    } else if (until == Date_t::max()) {
+        waiter.cv.wait(lk, isGranted);
+    } else {
+        waiter.cv.wait_until(lk, until.toSystemTimePoint(), isGranted);
+    }
+
+    if (!waiter.granted) {
+        return false;
+    }
+    leaveQueueGuard.dismiss();
+    return true;
+}
+
+void TicketHolder::_grantWaiters(WithLock lk) {
+    while (_numQueued.load() > 0 && _tryTakeTicket(lk)) {
+        auto waiter = _nextWaiter(lk);
+        waiter->granted = true;
+        waiter->cv.notify_one();
+    }
+}
+
+TicketHolder::Waiter* TicketHolder::_nextWaiter(WithLock) {
+    Queue* next = nullptr;
+    size_t nextIndex = 0;
+    // Ties go to the higher priority.
+    for (size_t i = kNumAdmissionPriorities; i-- > 0;) {
+        auto& queue = _queues[i];
+        if (!queue.waiters.empty() && (!next || queue.pass < next->pass)) {
+            next = &queue;
+            nextIndex = i;
+        }
+    }
+    invariant(next);
+
+    _virtualTime = next->pass;
+    next->pass += kStrides[nextIndex];
+    next->admitted.fetchAndAdd(1);
+
+    auto waiter = next->waiters.front();
+    next->waiters.pop_front();
+    _numQueued.subtractAndFetch(1);
+    return waiter;
+}
+
+void TicketHolder::_removeWaiter(WithLock, Waiter* waiter) {
+    auto& waiters = _queues[static_cast<size_t>(waiter->priority)].waiters;
+    auto it = std::find(waiters.begin(), waiters.end(), waiter);
+    invariant(it != waiters.end());
+    waiters.erase(it);
+    _numQueued.subtractAndFetch(1);
+}
+
+void TicketHolder::appendQueueStats(BSONObjBuilder* builder) const {
+#if defined(__linux__)
+    stdx::lock_guard<Latch> lk(_queueMutex);
+#else
+    stdx::lock_guard<Latch> lk(_mutex);
+#endif
+    for (size_t i = 0; i < kNumAdmissionPriorities; ++i) {
+        BSONObjBuilder queueBuilder(builder->subobjStart(toString(AdmissionPriority(i))));
+        queueBuilder.append("queueDepth", static_cast<int>(_queues[i].waiters.size()));
+        queueBuilder.append("admittedFromQueue", _queues[i].admitted.load());
+    }
+}
 }  // namespace mongo
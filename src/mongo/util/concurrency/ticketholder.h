@@ -32,15 +32,29 @@
 #include <semaphore.h>
 #endif
 
+#include <array>
+#include <deque>
+
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/admission_priority.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/hierarchical_acquisition.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+/**
+ * Limits the number of operations which can hold a ticket at the same time.
+ *
+ * Operations which find no ticket available wait in one queue per AdmissionPriority. When tickets
+ * are released, they are handed to the waiting operations by weighted fair queuing between the
+ * queues, so that a burst of waiting low priority operations cannot starve the others, while
+ * no queue is starved either. Within a queue, operations are admitted in arrival order.
+ */
 class TicketHolder {
     TicketHolder(const TicketHolder&) = delete;
     TicketHolder& operator=(const TicketHolder&) = delete;
@@ -55,8 +69,10 @@ public:
      * Attempts to acquire a ticket. Blocks until a ticket is acquired or the OperationContext
      * 'opCtx' is killed, throwing an AssertionException.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
+     * If no ticket is available, waits in the queue for 'priority'.
      */
-    void waitForTicket(OperationContext* opCtx);
+    void waitForTicket(OperationContext* opCtx,
+                       AdmissionPriority priority = AdmissionPriority::kNormal);
     void waitForTicket() {
         waitForTicket(nullptr);
     }
@@ -67,8 +83,11 @@ public:
      * AssertionException if the OperationContext 'opCtx' is killed and no waits for tickets can
      * proceed.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
+     * If no ticket is available, waits in the queue for 'priority'.
      */
-    bool waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    bool waitForTicketUntil(OperationContext* opCtx,
+                            Date_t until,
+                            AdmissionPriority priority = AdmissionPriority::kNormal);
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
@@ -82,7 +101,74 @@ public:
 
     int outof() const;
 
+    /**
+     * Appends the current depth of the queue and the number of operations admitted from it, for
+     * each AdmissionPriority.
+     */
+    void appendQueueStats(BSONObjBuilder* builder) const;
+
 private:
+    struct Waiter {
+        explicit Waiter(AdmissionPriority priority) : priority(priority) {}
+
+        const AdmissionPriority priority;
+
+        // Set once a ticket was handed to this waiter and it was removed from its queue.
+        bool granted = false;
+
+        stdx::condition_variable cv;
+    };
+
+    struct Queue {
+        std::deque<Waiter*> waiters;
+
+        // The virtual time at which this queue gets its next turn, see _nextWaiter().
+        std::uint64_t pass = 0;
+
+        AtomicWord<long long> admitted{0};
+    };
+
+    /**
+     * Waits in the queue for 'priority' until a ticket is handed over, 'until' or the
+     * interruption of 'opCtx'. 'lk' must hold the mutex which protects the queues.
+     */
+    bool _waitInQueue(stdx::unique_lock<Latch>& lk,
+                      OperationContext* opCtx,
+                      Date_t until,
+                      AdmissionPriority priority);
+
+    /**
+     * Hands the available tickets to queued waiters.
+     */
+    void _grantWaiters(WithLock);
+
+    /**
+     * Removes the waiter which should be admitted next from its queue. Queues take turns in
+     * proportion to their weight, as in stride scheduling: each turn moves a queue's pass ahead
+     * by its stride, and the non-empty queue with the lowest pass goes next.
+     */
+    Waiter* _nextWaiter(WithLock);
+
+    void _removeWaiter(WithLock, Waiter* waiter);
+
+    /**
+     * Takes one ticket if there is one available, without regard to queued waiters.
+     */
+    bool _tryTakeTicket(WithLock);
+
+    /**
+     * Returns one ticket without handing it to queued waiters.
+     */
+    void _returnTicket(WithLock);
+
+    std::array<Queue, kNumAdmissionPriorities> _queues;
+
+    // The pass of the queue which was given the last turn.
+    std::uint64_t _virtualTime = 0;
+
+    // Can be read without a lock to skip the queues in the common case where nobody waits.
+    AtomicWord<int> _numQueued{0};
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
@@ -90,13 +176,19 @@ private:
     AtomicWord<int> _outof;
     Mutex _resizeMutex =
         MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_resizeMutex");
+
+    // Protects the queues.
+    mutable Mutex _queueMutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "TicketHolder::_queueMutex");
 #else
     bool _tryAcquire();
 
     AtomicWord<int> _outof;
     int _num;
-    Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_mutex");
-    stdx::condition_variable _newTicket;
+
+    // Protects _num and the queues.
+    mutable Mutex _mutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_mutex");
 #endif
 };
 
@@ -32,12 +32,64 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
 
+int queueDepth(const TicketHolder& holder, AdmissionPriority priority) {
+    BSONObjBuilder builder;
+    holder.appendQueueStats(&builder);
+    return builder.obj()[toString(priority)]["queueDepth"].numberInt();
+}
+
+/**
+ * Holds the only ticket of a TicketHolder while threads queue up for it one by one, then lets
+ * them through and records in which order they were admitted.
+ */
+class QueuedWaiters {
+public:
+    QueuedWaiters() : _holder(1) {
+        ASSERT(_holder.tryAcquire());
+    }
+
+    void queue(AdmissionPriority priority) {
+        const int depth = queueDepth(_holder, priority);
+        _threads.emplace_back([this, priority] {
+            _holder.waitForTicket(nullptr, priority);
+            _admitted.push_back(priority);
+            _holder.release();
+        });
+        while (queueDepth(_holder, priority) == depth) {
+            sleepmillis(1);
+        }
+    }
+
+    std::vector<AdmissionPriority> admit() {
+        _holder.release();
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+        return _admitted;
+    }
+
+    TicketHolder& holder() {
+        return _holder;
+    }
+
+private:
+    TicketHolder _holder;
+    std::vector<stdx::thread> _threads;
+
+    // Only written by the thread which holds the ticket.
+    std::vector<AdmissionPriority> _admitted;
+};
+
 TEST(TicketholderTest, BasicTimeout) {
     TicketHolder holder(1);
     ASSERT_EQ(holder.used(), 0);
@@ -72,4 +124,49 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, HigherPriorityIsAdmittedFirst) {
+    QueuedWaiters waiters;
+    waiters.queue(AdmissionPriority::kLow);
+    waiters.queue(AdmissionPriority::kNormal);
+    waiters.queue(AdmissionPriority::kHigh);
+
+    std::vector<AdmissionPriority> expected = {
+        AdmissionPriority::kHigh, AdmissionPriority::kNormal, AdmissionPriority::kLow};
+    ASSERT(waiters.admit() == expected);
+}
+
+TEST(TicketholderTest, LowerPriorityIsNotStarved) {
+    QueuedWaiters waiters;
+    for (int i = 0; i < 2; ++i) {
+        waiters.queue(AdmissionPriority::kLow);
+    }
+    for (int i = 0; i < 20; ++i) {
+        waiters.queue(AdmissionPriority::kHigh);
+    }
+
+    // The low priority queue gets one turn for every 16 of the high priority queue.
+    auto admitted = waiters.admit();
+    ASSERT_EQ(admitted.size(), 22U);
+    std::vector<size_t> lowPositions;
+    for (size_t i = 0; i < admitted.size(); ++i) {
+        if (admitted[i] == AdmissionPriority::kLow) {
+            lowPositions.push_back(i);
+        }
+    }
+    std::vector<size_t> expected = {1, 18};
+    ASSERT(lowPositions == expected);
+}
+
+TEST(TicketholderTest, TimedOutWaiterLeavesQueue) {
+    QueuedWaiters waiters;
+    ASSERT_FALSE(waiters.holder().waitForTicketUntil(
+        nullptr, Date_t::now() + Milliseconds(10), AdmissionPriority::kLow));
+    ASSERT_EQ(queueDepth(waiters.holder(), AdmissionPriority::kLow), 0);
+
+    waiters.queue(AdmissionPriority::kNormal);
+    std::vector<AdmissionPriority> expected = {AdmissionPriority::kNormal};
+    ASSERT(waiters.admit() == expected);
+    ASSERT_EQ(waiters.holder().available(), 1);
+}
 }  // namespace
@@ -31,6 +31,7 @@
 
 #include "mongo/platform/mutex.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/read_mostly_mutex.h"
 
 #include <utility>
 
@@ -76,6 +77,8 @@ struct WithLock {
         invariant(lock.owns_lock());
     }
 
+    WithLock(ReadMostlyMutex::SharedLock const&) noexcept {}
+
     // Add constructors from any other lock types here.
 
     // Pass by value is OK.
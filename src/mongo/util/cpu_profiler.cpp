@@ -0,0 +1,659 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/cpu_profiler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/logv2/log.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/cpu_profiler_gen.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/stacktrace.h"
+#include "mongo/util/time_support.h"
+
+#if defined(__linux__)
+#include <cxxabi.h>
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace mongo {
+
+#if defined(__linux__)
+
+namespace {
+
+long long monotonicNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<long long>(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+}
+
+}  // namespace
+
+namespace cpu_profiler_detail {
+
+/**
+ * The most recent tag transitions of a thread. Samples are only drained periodically, so keeping
+ * a short history lets them be attributed to the tag which was set when they were taken.
+ *
+ * Only the owning thread writes to it. A sample which races with a transition may be attributed to
+ * the wrong tag, which is acceptable for a statistical profile.
+ */
+struct ThreadTags {
+    static constexpr unsigned long long kHistorySize = 16;
+
+    void set(const std::string* tag) {
+        current = tag;
+
+        const auto n = numTransitions.load();
+        auto& transition = history[n % kHistorySize];
+        transition.tag.store(tag);
+        transition.timeNanos.store(monotonicNanos());
+        numTransitions.store(n + 1);
+    }
+
+    /**
+     * Returns the tag which was set at 'timeNanos', or nullptr if it was untagged or the
+     * transition was already overwritten.
+     */
+    const std::string* tagAt(long long timeNanos) const {
+        const auto n = numTransitions.load();
+        for (auto i = n; i > 0 && n - i < kHistorySize; --i) {
+            const auto& transition = history[(i - 1) % kHistorySize];
+            if (transition.timeNanos.load() <= timeNanos) {
+                return transition.tag.load();
+            }
+        }
+        return nullptr;
+    }
+
+    struct Transition {
+        AtomicWord<long long> timeNanos{0};
+        AtomicWord<const std::string*> tag{nullptr};
+    };
+
+    // The tag currently set, only accessed by the owning thread.
+    const std::string* current = nullptr;
+
+    AtomicWord<unsigned long long> numTransitions{0};
+    Transition history[kHistorySize];
+};
+
+}  // namespace cpu_profiler_detail
+
+namespace {
+
+using cpu_profiler_detail::ThreadTags;
+
+/**
+ * Samples the process through one perf_event per CPU, opened on the thread which starts the
+ * profiler and inherited by all the threads it creates afterwards. The kernel unwinds the user
+ * space stack of the thread running when the event fires, using frame pointers, and appends the
+ * call chain to a ring buffer per CPU, which a background thread drains.
+ */
+class PerfEventProfiler {
+public:
+    static PerfEventProfiler* profiler;
+
+    explicit PerfEventProfiler(int sampleHz) : _sampleHz(sampleHz) {}
+
+    Status open() {
+        const long numCpus = sysconf(_SC_NPROCESSORS_CONF);
+        for (long cpu = 0; cpu < numCpus; cpu++) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_CPU_CLOCK;
+            attr.freq = 1;
+            attr.sample_freq = _sampleHz;
+            attr.sample_type = PERF_SAMPLE_TID | PERF_SAMPLE_TIME | PERF_SAMPLE_CALLCHAIN;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.exclude_callchain_kernel = 1;
+            attr.use_clockid = 1;
+            attr.clockid = CLOCK_MONOTONIC;
+
+            const int fd = syscall(SYS_perf_event_open, &attr, 0, cpu, -1, PERF_FLAG_FD_CLOEXEC);
+            if (fd < 0) {
+                const auto savedErrno = errno;
+                if (savedErrno == ENODEV) {
+                    // This CPU is offline.
+                    continue;
+                }
+                return {ErrorCodes::OperationFailed,
+                        str::stream() << "perf_event_open failed on CPU " << cpu << ": "
+                                      << errnoWithDescription(savedErrno)};
+            }
+
+            const size_t mapSize = (kDataPages + 1) * _pageSize;
+            void* base = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (base == MAP_FAILED) {
+                const auto savedErrno = errno;
+                close(fd);
+                return {ErrorCodes::OperationFailed,
+                        str::stream() << "Failed to map the perf_event buffer of CPU " << cpu
+                                      << ": " << errnoWithDescription(savedErrno)};
+            }
+
+            _buffers.push_back({fd, static_cast<char*>(base), kDataPages * _pageSize});
+        }
+
+        if (_buffers.empty()) {
+            return {ErrorCodes::OperationFailed, "No CPU available to profile"};
+        }
+
+        return Status::OK();
+    }
+
+    void start() {
+        stdx::thread([this] {
+            setThreadName("CpuProfiler");
+            std::vector<Sample> samples;
+            while (true) {
+                sleepmillis(kDrainIntervalMillis);
+
+                for (auto& buffer : _buffers) {
+                    _drain(buffer, &samples);
+                }
+                _aggregate(&samples);
+            }
+        }).detach();
+    }
+
+    int sampleHz() const {
+        return _sampleHz;
+    }
+
+    void registerThread(pid_t tid, const ThreadTags* threadTags) {
+        stdx::lock_guard<Latch> lk(_threadTagsMutex);
+        _threadTags[tid] = threadTags;
+    }
+
+    void unregisterThread(pid_t tid) {
+        stdx::lock_guard<Latch> lk(_threadTagsMutex);
+        _threadTags.erase(tid);
+    }
+
+    void report(BSONObjBuilder* builder, size_t maxStacks, bool reset) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _appendStats(builder);
+
+        std::vector<const StackMap::value_type*> stacks;
+        for (const auto& stack : _stacks) {
+            stacks.push_back(&stack);
+        }
+        std::sort(stacks.begin(), stacks.end(), [](const auto* a, const auto* b) {
+            return a->second.count > b->second.count;
+        });
+        if (stacks.size() > maxStacks) {
+            stacks.resize(maxStacks);
+        }
+
+        BSONArrayBuilder stacksBuilder(builder->subarrayStart("stacks"));
+        for (const auto* stack : stacks) {
+            BSONObjBuilder stackBuilder(stacksBuilder.subobjStart());
+            stackBuilder.append("stack", _fold(stack->first));
+            stackBuilder.append("count", stack->second.count);
+        }
+        stacksBuilder.done();
+
+        if (reset) {
+            _reset(lk);
+        }
+    }
+
+    void generateServerStatusSection(BSONObjBuilder* builder) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        {
+            BSONObjBuilder statsBuilder(builder->subobjStart("stats"));
+            _appendStats(&statsBuilder);
+        }
+
+        // Like the heap profiler, only emit the stacks which account for a significant share of the
+        // samples, keep emitting them once they did, and emit them in stackNum order, so that the
+        // section changes shape rarely and compresses well in FTDC. The set of important stacks
+        // is periodically cleared so that it does not accumulate stacks which no longer matter.
+        const bool clearImportant = ++_numServerStatusSections >= kMaxServerStatusSections;
+        if (clearImportant) {
+            _numServerStatusSections = 0;
+        }
+
+        const long long threshold = _numSamples / 100;
+        std::vector<StackMap::value_type*> stacks;
+        for (auto& stack : _stacks) {
+            auto& info = stack.second;
+            if (clearImportant) {
+                info.important = false;
+            }
+            if (!info.important && _numSamples >= kMinSamplesForImportance &&
+                info.count >= threshold) {
+                info.important = true;
+                LOGV2(4798300,
+                      "cpuProfile stack",
+                      "stackNum"_attr = info.stackNum,
+                      "stack"_attr = _fold(stack.first));
+            }
+            if (info.important) {
+                stacks.push_back(&stack);
+            }
+        }
+        std::sort(stacks.begin(), stacks.end(), [](const auto* a, const auto* b) {
+            return a->second.stackNum < b->second.stackNum;
+        });
+
+        BSONObjBuilder stacksBuilder(builder->subobjStart("stacks"));
+        for (const auto* stack : stacks) {
+            stacksBuilder.append(str::stream() << "stack" << stack->second.stackNum,
+                                 stack->second.count);
+        }
+    }
+
+    void reset() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _reset(lk);
+    }
+
+private:
+    // Size of the ring buffer of each CPU. At the default rate, a CPU produces a few kilobytes of
+    // samples per drain interval.
+    static constexpr size_t kDataPages = 16;
+    static constexpr int kDrainIntervalMillis = 100;
+
+    // Bounds the memory used, by discarding the samples of new stacks above this many.
+    static constexpr size_t kMaxStacks = 16 * 1024;
+    static constexpr size_t kMaxFramesPerStack = 64;
+
+    // Stacks are only deemed important once enough samples were taken to tell them apart.
+    static constexpr long long kMinSamplesForImportance = 100;
+
+    // Reset the important stacks every 4 hours at the default FTDC rate of 1 sample per second.
+    static constexpr int kMaxServerStatusSections = 4 * 3600;
+
+    struct Buffer {
+        int fd;
+        char* base;
+        size_t dataSize;
+    };
+
+    struct Sample {
+        pid_t tid;
+        long long timeNanos;
+        std::vector<uint64_t> frames;
+    };
+
+    struct StackKey {
+        template <typename H>
+        friend H AbslHashValue(H h, const StackKey& key) {
+            return H::combine(std::move(h), key.tag, key.frames);
+        }
+
+        bool operator==(const StackKey& other) const {
+            return tag == other.tag && frames == other.frames;
+        }
+
+        const std::string* tag;
+
+        // Innermost frame first.
+        std::vector<uint64_t> frames;
+    };
+
+    struct StackInfo {
+        long long count = 0;
+        long long stackNum = 0;
+        bool important = false;
+    };
+
+    using StackMap = stdx::unordered_map<StackKey, StackInfo>;
+
+    void _copyFromBuffer(const Buffer& buffer, uint64_t position, void* out, size_t len) const {
+        const char* data = buffer.base + _pageSize;
+        const size_t offset = position % buffer.dataSize;
+        const size_t firstLen = std::min(len, buffer.dataSize - offset);
+        memcpy(out, data + offset, firstLen);
+        memcpy(static_cast<char*>(out) + firstLen, data, len - firstLen);
+    }
+
+    void _drain(Buffer& buffer, std::vector<Sample>* samples) {
+        auto meta = reinterpret_cast<perf_event_mmap_page*>(buffer.base);
+        const uint64_t head = __atomic_load_n(&meta->data_head, __ATOMIC_ACQUIRE);
+        uint64_t tail = meta->data_tail;
+
+        std::vector<char> record;
+        while (tail < head) {
+            perf_event_header header;
+            _copyFromBuffer(buffer, tail, &header, sizeof(header));
+            if (header.size < sizeof(header)) {
+                break;
+            }
+
+            record.resize(header.size);
+            _copyFromBuffer(buffer, tail, record.data(), header.size);
+            tail += header.size;
+
+            const char* body = record.data() + sizeof(header);
+            if (header.type == PERF_RECORD_SAMPLE) {
+                _parseSample(body, record.data() + record.size(), samples);
+            } else if (header.type == PERF_RECORD_LOST) {
+                // The body is the event id followed by the number of lost samples.
+                uint64_t lost;
+                memcpy(&lost, body + sizeof(uint64_t), sizeof(lost));
+                _numLostSamples.fetchAndAdd(lost);
+            }
+        }
+
+        __atomic_store_n(&meta->data_tail, tail, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * Parses the body of a PERF_RECORD_SAMPLE, laid out per PERF_SAMPLE_TID, PERF_SAMPLE_TIME and
+     * PERF_SAMPLE_CALLCHAIN as {u32 pid, u32 tid, u64 time, u64 nr, u64 ips[nr]}.
+     */
+    void _parseSample(const char* body, const char* end, std::vector<Sample>* samples) {
+        struct {
+            uint32_t pid;
+            uint32_t tid;
+            uint64_t time;
+            uint64_t nr;
+        } fixed;
+        if (end - body < static_cast<ptrdiff_t>(sizeof(fixed))) {
+            return;
+        }
+        memcpy(&fixed, body, sizeof(fixed));
+        body += sizeof(fixed);
+
+        Sample sample{static_cast<pid_t>(fixed.tid), static_cast<long long>(fixed.time), {}};
+        for (uint64_t i = 0; i < fixed.nr && end - body >= 8; i++, body += 8) {
+            uint64_t ip;
+            memcpy(&ip, body, sizeof(ip));
+            // Skip the markers separating the kernel and user parts of the call chain.
+            if (ip >= static_cast<uint64_t>(PERF_CONTEXT_MAX)) {
+                continue;
+            }
+            if (sample.frames.size() == kMaxFramesPerStack) {
+                break;
+            }
+            sample.frames.push_back(ip);
+        }
+
+        samples->push_back(std::move(sample));
+    }
+
+    void _aggregate(std::vector<Sample>* samples) {
+        if (samples->empty()) {
+            return;
+        }
+
+        std::vector<const std::string*> tags;
+        tags.reserve(samples->size());
+        {
+            stdx::lock_guard<Latch> lk(_threadTagsMutex);
+            for (const auto& sample : *samples) {
+                auto it = _threadTags.find(sample.tid);
+                tags.push_back(it == _threadTags.end() ? nullptr
+                                                       : it->second->tagAt(sample.timeNanos));
+            }
+        }
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (size_t i = 0; i < samples->size(); i++) {
+            StackKey key{tags[i], std::move((*samples)[i].frames)};
+            auto it = _stacks.find(key);
+            if (it == _stacks.end()) {
+                if (_stacks.size() >= kMaxStacks) {
+                    _numDroppedSamples++;
+                    continue;
+                }
+                it = _stacks.emplace(std::move(key), StackInfo()).first;
+                it->second.stackNum = _nextStackNum++;
+            }
+            it->second.count++;
+            _numSamples++;
+        }
+
+        samples->clear();
+    }
+
+    void _reset(WithLock) {
+        _stacks.clear();
+        _numSamples = 0;
+        _numLostSamples.store(0);
+        _numDroppedSamples = 0;
+    }
+
+    void _appendStats(BSONObjBuilder* builder) const {
+        builder->append("sampleHz", _sampleHz);
+        builder->append("samples", _numSamples);
+        builder->append("lostSamples", _numLostSamples.load());
+        builder->append("droppedSamples", _numDroppedSamples);
+        builder->append("numStacks", static_cast<long long>(_stacks.size()));
+    }
+
+    std::string _fold(const StackKey& key) {
+        std::string folded = key.tag ? *key.tag : "none";
+        for (auto it = key.frames.rbegin(); it != key.frames.rend(); ++it) {
+            folded += ';';
+            folded += _symbolize(*it);
+        }
+        return folded;
+    }
+
+    const std::string& _symbolize(uint64_t address) {
+        auto it = _symbols.find(address);
+        if (it != _symbols.end()) {
+            return it->second;
+        }
+
+        std::string name;
+        const auto& meta = _metaGen.load(reinterpret_cast<void*>(address));
+        if (meta.symbol() && !meta.symbol().name().empty()) {
+            name = meta.symbol().name().toString();
+
+            int status = 0;
+            std::unique_ptr<char, decltype(&free)> demangled(
+                abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status), &free);
+            if (demangled) {
+                // Strip the function parameters as they are very verbose and not useful.
+                name = demangled.get();
+                size_t paren = name.find('(');
+                while (paren != std::string::npos &&
+                       name.compare(paren, 20, "(anonymous namespace") == 0) {
+                    paren = name.find('(', paren + 1);
+                }
+                if (paren != std::string::npos) {
+                    name.erase(paren);
+                }
+            }
+        } else {
+            name = "0x" + integerToHex(address);
+        }
+
+        return _symbols.emplace(address, std::move(name)).first->second;
+    }
+
+    const int _sampleHz;
+    const size_t _pageSize = sysconf(_SC_PAGESIZE);
+    std::vector<Buffer> _buffers;
+
+    // Tids of the threads which ever set a tag.
+    Mutex _threadTagsMutex = MONGO_MAKE_LATCH("PerfEventProfiler::_threadTagsMutex");
+    stdx::unordered_map<pid_t, const ThreadTags*> _threadTags;
+
+    // Guards the aggregated samples and the symbols.
+    Mutex _mutex = MONGO_MAKE_LATCH("PerfEventProfiler::_mutex");
+    StackMap _stacks;
+    long long _nextStackNum = 0;
+    long long _numSamples = 0;
+    long long _numDroppedSamples = 0;
+    int _numServerStatusSections = 0;
+    AtomicWord<long long> _numLostSamples{0};
+
+    StackTraceAddressMetadataGenerator _metaGen;
+    stdx::unordered_map<uint64_t, std::string> _symbols;
+};
+
+PerfEventProfiler* PerfEventProfiler::profiler = nullptr;
+
+/**
+ * Registers the tags of the thread it is created on, for the lifetime of that thread.
+ */
+struct ThreadTagsRegistration {
+    ThreadTagsRegistration() : tid(syscall(SYS_gettid)) {
+        PerfEventProfiler::profiler->registerThread(tid, &threadTags);
+    }
+
+    ~ThreadTagsRegistration() {
+        PerfEventProfiler::profiler->unregisterThread(tid);
+    }
+
+    const pid_t tid;
+    ThreadTags threadTags;
+};
+
+ThreadTags* getThreadTags() {
+    thread_local ThreadTagsRegistration registration;
+    return &registration.threadTags;
+}
+
+}  // namespace
+
+CpuProfiler::ScopedTag::ScopedTag(const std::string& tag) {
+    if (!PerfEventProfiler::profiler) {
+        return;
+    }
+
+    _threadTags = getThreadTags();
+    _previous = _threadTags->current;
+    _threadTags->set(&tag);
+}
+
+CpuProfiler::ScopedTag::~ScopedTag() {
+    if (_threadTags) {
+        _threadTags->set(_previous);
+    }
+}
+
+void CpuProfiler::startIfEnabled() {
+    if (!gCpuProfilingEnabled || PerfEventProfiler::profiler) {
+        return;
+    }
+
+    auto profiler = std::make_unique<PerfEventProfiler>(gCpuProfilingSampleHz);
+    if (auto status = profiler->open(); !status.isOK()) {
+        LOGV2_WARNING(4798301, "Failed to start the CPU profiler", "error"_attr = status);
+        return;
+    }
+
+    LOGV2(4798302, "Started the CPU profiler", "sampleHz"_attr = profiler->sampleHz());
+    profiler->start();
+    PerfEventProfiler::profiler = profiler.release();
+}
+
+bool CpuProfiler::isRunning() {
+    return PerfEventProfiler::profiler;
+}
+
+void CpuProfiler::report(BSONObjBuilder* builder, size_t maxStacks, bool reset) {
+    builder->append("running", isRunning());
+    if (isRunning()) {
+        PerfEventProfiler::profiler->report(builder, maxStacks, reset);
+    }
+}
+
+void CpuProfiler::reset() {
+    if (isRunning()) {
+        PerfEventProfiler::profiler->reset();
+    }
+}
+
+namespace {
+
+class CpuProfilerServerStatusSection final : public ServerStatusSection {
+public:
+    CpuProfilerServerStatusSection() : ServerStatusSection("cpuProfile") {}
+
+    bool includeByDefault() const override {
+        return CpuProfiler::isRunning();
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        if (PerfEventProfiler::profiler) {
+            PerfEventProfiler::profiler->generateServerStatusSection(&builder);
+        }
+        return builder.obj();
+    }
+} cpuProfilerServerStatusSection;
+
+}  // namespace
+
+#else  // defined(__linux__)
+
+CpuProfiler::ScopedTag::ScopedTag(const std::string& tag) {}
+
+CpuProfiler::ScopedTag::~ScopedTag() {}
+
+void CpuProfiler::startIfEnabled() {
+    if (gCpuProfilingEnabled) {
+        LOGV2_WARNING(4798303, "The CPU profiler is only supported on Linux");
+    }
+}
+
+bool CpuProfiler::isRunning() {
+    return false;
+}
+
+void CpuProfiler::report(BSONObjBuilder* builder, size_t maxStacks, bool reset) {
+    builder->append("running", false);
+}
+
+void CpuProfiler::reset() {}
+
+#endif  // defined(__linux__)
+
+}  // namespace mongo
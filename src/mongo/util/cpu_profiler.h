@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+namespace cpu_profiler_detail {
+struct ThreadTags;
+}  // namespace cpu_profiler_detail
+
+/**
+ * Continuous sampling CPU profiler, meant to run at a low enough rate to stay enabled in
+ * production.
+ *
+ * When cpuProfilingEnabled is set, the profiler asks the kernel (through perf_events, so it is only
+ * available on Linux) to sample the user space call chain of every thread of the process
+ * cpuProfilingSampleHz times per second of CPU time consumed by that thread. A background thread
+ * drains the samples and aggregates them as folded stacks, each tagged with the command which the
+ * sampled thread was executing.
+ *
+ * The folded stacks are returned by the cpuProfile command, and the most frequent ones are
+ * summarized in the "cpuProfile" serverStatus section, and thus recorded by FTDC.
+ */
+class CpuProfiler {
+public:
+    /**
+     * Tags the samples taken on the current thread with 'tag' for the lifetime of this object.
+     * Only a pointer to 'tag' is kept, so it must live for as long as the process, as command
+     * names do.
+     */
+    class ScopedTag {
+        ScopedTag(const ScopedTag&) = delete;
+        ScopedTag& operator=(const ScopedTag&) = delete;
+
+    public:
+        explicit ScopedTag(const std::string& tag);
+        ~ScopedTag();
+
+    private:
+        cpu_profiler_detail::ThreadTags* _threadTags = nullptr;
+        const std::string* _previous = nullptr;
+    };
+
+    /**
+     * Starts sampling if cpuProfilingEnabled is set. Must be called after the server has forked
+     * and before it starts the threads which should be profiled, since only threads created after
+     * this call are sampled.
+     */
+    static void startIfEnabled();
+
+    static bool isRunning();
+
+    /**
+     * Appends the sampling statistics and up to 'maxStacks' of the most frequently sampled stacks,
+     * in decreasing order of samples. Each stack is formatted as a single "tag;outer;...;inner"
+     * string, which flame graph tools consume as-is. With 'reset', the samples are discarded once
+     * reported, atomically with respect to the samples being aggregated.
+     */
+    static void report(BSONObjBuilder* builder, size_t maxStacks, bool reset = false);
+
+    /**
+     * Discards the samples aggregated so far.
+     */
+    static void reset();
+};
+
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include <stack>
 
 #include "mongo/logv2/log.h"
+#include "mongo/logv2/log_domain_global.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
@@ -69,6 +70,8 @@ void runTasks(decltype(shutdownTasks) tasks, const ShutdownTaskArgs& shutdownArg
 MONGO_COMPILER_NORETURN void logAndQuickExit_inlock() {
     ExitCode code = shutdownExitCode.get();
     LOGV2(23138, "Shutting down with code: {exitCode}", "Shutting down", "exitCode"_attr = code);
+    // quickExit() skips the destructors which would write out the asynchronously queued records.
+    logv2::LogManager::global().getGlobalDomainInternal().flush();
     quickExit(code);
 }
 
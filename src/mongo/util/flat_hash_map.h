@@ -0,0 +1,50 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/stdx/trusted_hasher.h"
+
+#include <absl/container/flat_hash_map.h>
+
+namespace mongo {
+
+/**
+ * Open-addressing hash map using the same hasher hardening as stdx::unordered_map.
+ *
+ * Lookups touch a group of control bytes and the slot, rather than chasing a pointer to a
+ * separately allocated node, which matters for large maps that are searched on hot paths. In
+ * exchange, inserting into the map may move its elements, so references and pointers to the
+ * elements (not just iterators) are invalidated by a rehash. Prefer stdx::unordered_map when the
+ * addresses of the elements must stay stable.
+ */
+template <class Key, class Value, class Hasher = DefaultHasher<Key>, typename... Args>
+using FlatHashMap = absl::flat_hash_map<Key, Value, EnsureTrustedHasher<Hasher, Key>, Args...>;
+
+}  // namespace mongo
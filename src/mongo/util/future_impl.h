@@ -31,7 +31,9 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <boost/optional.hpp>
+#include <cstddef>
 #include <forward_list>
+#include <new>
 #include <type_traits>
 
 #include "mongo/base/checked_cast.h"
@@ -359,6 +361,101 @@ enum class SSBState : uint8_t {
     kFinished,
 };
 
+class SharedStateBase;
+
+/**
+ * Type-erased holder for the callback of a SharedState, similar to a
+ * unique_function<void(SharedStateBase*)>.
+ *
+ * Almost every continuation installs one of these, and the lambdas involved are usually small, so
+ * rather than always allocating like unique_function does, callables which fit in kInlineSize are
+ * stored in place and only larger ones go to the heap. Since SharedStates are neither copied nor
+ * moved, the stored callable never has to be relocated.
+ */
+class SharedStateCallback {
+public:
+    static constexpr size_t kInlineSize = 6 * sizeof(void*);
+
+    SharedStateCallback() = default;
+
+    SharedStateCallback(const SharedStateCallback&) = delete;
+    SharedStateCallback& operator=(const SharedStateCallback&) = delete;
+
+    ~SharedStateCallback() {
+        reset();
+    }
+
+    template <typename Func>
+    SharedStateCallback& operator=(Func&& func) noexcept {
+        using Stored = std::decay_t<Func>;
+        static_assert(std::is_nothrow_invocable_r_v<void, Stored&, SharedStateBase*>);
+
+        reset();
+        if constexpr (kStoredInline<Stored>) {
+            new (&_storage) Stored(std::forward<Func>(func));
+        } else {
+            *reinterpret_cast<Stored**>(&_storage) = new Stored(std::forward<Func>(func));
+        }
+        _ops = &kOps<Stored>;
+        return *this;
+    }
+
+    void operator()(SharedStateBase* ssb) noexcept {
+        invariant(_ops);
+        _ops->call(&_storage, ssb);
+    }
+
+    explicit operator bool() const noexcept {
+        return _ops;
+    }
+
+    void reset() noexcept {
+        if (auto ops = std::exchange(_ops, nullptr))
+            ops->destroy(&_storage);
+    }
+
+private:
+    using Storage = std::aligned_storage_t<kInlineSize, alignof(std::max_align_t)>;
+
+    struct Ops {
+        void (*call)(Storage*, SharedStateBase*) noexcept;
+        void (*destroy)(Storage*) noexcept;
+    };
+
+    template <typename Stored>
+    static constexpr bool kStoredInline = sizeof(Stored) <= sizeof(Storage) &&
+        alignof(Stored) <= alignof(Storage) && std::is_nothrow_move_constructible_v<Stored>;
+
+    template <typename Stored>
+    static Stored& _get(Storage* storage) noexcept {
+        if constexpr (kStoredInline<Stored>) {
+            return *std::launder(reinterpret_cast<Stored*>(storage));
+        } else {
+            return **reinterpret_cast<Stored**>(storage);
+        }
+    }
+
+    template <typename Stored>
+    static void _call(Storage* storage, SharedStateBase* ssb) noexcept {
+        _get<Stored>(storage)(ssb);
+    }
+
+    template <typename Stored>
+    static void _destroy(Storage* storage) noexcept {
+        if constexpr (kStoredInline<Stored>) {
+            _get<Stored>(storage).~Stored();
+        } else {
+            delete &_get<Stored>(storage);
+        }
+    }
+
+    template <typename Stored>
+    static constexpr Ops kOps = {&_call<Stored>, &_destroy<Stored>};
+
+    Storage _storage;
+    const Ops* _ops = nullptr;
+};
+
 class SharedStateBase : public RefCountable {
 public:
     using Children = std::forward_list<boost::intrusive_ptr<SharedStateBase>>;
@@ -493,7 +590,7 @@ public:
     boost::intrusive_ptr<SharedStateBase> continuation;  // F
 
     // Takes this as argument and usually writes to continuation.
-    unique_function<void(SharedStateBase* input)> callback;  // F
+    SharedStateCallback callback;  // F
 
     // These are only used to signal completion to blocking waiters. Benchmarks showed that it was
     // worth deferring the construction of cv, so it can be avoided when it isn't necessary.
@@ -31,6 +31,9 @@
 
 #include "mongo/util/future.h"
 
+#include <array>
+#include <memory>
+
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
@@ -342,6 +345,28 @@ TEST(Future_EdgeCases, SharedPromise_CompleteWithUnreadyFuture) {
     sf.get();
 }
 
+// Continuations are stored inline in the SharedState when they are small enough and on the heap
+// otherwise. Make sure that both kinds run and are destroyed exactly once.
+TEST(Future_EdgeCases, Continuations_inline_and_heap_allocated) {
+    auto token = std::make_shared<int>(1);
+    std::array<char, 4 * future_details::SharedStateCallback::kInlineSize> padding{};
+    padding.back() = 2;
+
+    {
+        auto [promise, future] = makePromiseFuture<int>();
+        auto chained =
+            std::move(future)
+                .then([token](int i) { return i + *token; })
+                .then([token, padding](int i) { return i + *token + padding.back(); })
+                .onCompletion([token](StatusWith<int> swi) { return swi.getValue() + *token; });
+        ASSERT_EQ(token.use_count(), 4);
+
+        promise.emplaceValue(10);
+        ASSERT_EQ(std::move(chained).get(), 15);
+    }
+    ASSERT_EQ(token.use_count(), 1);
+}
+
 // Make sure we actually die if someone throws from the getAsync callback.
 //
 // With gcc 5.8 we terminate, but print "terminate() called. No exception is active". This works in
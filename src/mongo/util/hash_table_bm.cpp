@@ -29,6 +29,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/flat_hash_map.h"
 #include "mongo/util/string_map.h"
 
 #include <absl/container/flat_hash_map.h>
@@ -58,6 +60,10 @@ using AbslFlatHashMapString = absl::flat_hash_map<std::string, bool>;
 using AbslNodeHashMapInt = absl::node_hash_map<uint32_t, bool>;
 using AbslNodeHashMapString = absl::node_hash_map<std::string, bool>;
 
+// The server's own aliases, with pointer values like the cursor, lock and catalog maps hold.
+using StdxUnorderedMapIntPtr = stdx::unordered_map<uint32_t, void*>;
+using FlatHashMapIntPtr = FlatHashMap<uint32_t, void*>;
+
 template <typename>
 struct IsAbslHashMap : std::false_type {};
 
@@ -263,6 +269,16 @@ BENCHMARK_TEMPLATE(BM_Insert, StdUnorderedInt)->Apply(Range<1>);
 BENCHMARK_TEMPLATE(BM_Insert, AbslFlatHashMapInt)->Apply(Range<1>);
 BENCHMARK_TEMPLATE(BM_Insert, AbslNodeHashMapInt)->Apply(Range<1>);
 
+// Integer key to pointer tests
+BENCHMARK_TEMPLATE(BM_SuccessfulLookup, StdxUnorderedMapIntPtr)->Apply(Range);
+BENCHMARK_TEMPLATE(BM_SuccessfulLookup, FlatHashMapIntPtr)->Apply(Range);
+
+BENCHMARK_TEMPLATE(BM_UnsuccessfulLookup, StdxUnorderedMapIntPtr)->Apply(Range);
+BENCHMARK_TEMPLATE(BM_UnsuccessfulLookup, FlatHashMapIntPtr)->Apply(Range);
+
+BENCHMARK_TEMPLATE(BM_Insert, StdxUnorderedMapIntPtr)->Apply(Range<1>);
+BENCHMARK_TEMPLATE(BM_Insert, FlatHashMapIntPtr)->Apply(Range<1>);
+
 // String key tests
 BENCHMARK_TEMPLATE(BM_SuccessfulLookup, StdUnorderedString)->Apply(Range);
 BENCHMARK_TEMPLATE(BM_SuccessfulLookup, AbslFlatHashMapString)->Apply(Range);
@@ -273,6 +289,7 @@ BENCHMARK_TEMPLATE(BM_UnsuccessfulLookup, AbslFlatHashMapString)->Apply(Range);
 BENCHMARK_TEMPLATE(BM_UnsuccessfulLookup, AbslNodeHashMapString)->Apply(Range);
 
 BENCHMARK_TEMPLATE(BM_UnsuccessfulLookupSeq, StdUnorderedString)->Apply(Range);
+BENCHMARK_TEMPLATE(BM_UnsuccessfulLookupSeq, AbslFlatHashMapString)->Apply(Range);
 BENCHMARK_TEMPLATE(BM_UnsuccessfulLookupSeq, AbslNodeHashMapString)->Apply(Range);
 
 BENCHMARK_TEMPLATE(BM_Insert, StdUnorderedString)->Apply(Range<1>);
@@ -82,6 +82,9 @@ public:
     // Get output data to be written to the transport.
     ASIO_DECL asio::mutable_buffer get_output(const asio::mutable_buffer& data);
 
+    // Get the size of the buffer needed to hold all output the engine produces for one write.
+    ASIO_DECL std::size_t output_buffer_size() const;
+
     // Put input data that was read from the transport.
     ASIO_DECL asio::const_buffer put_input(const asio::const_buffer& data);
 
@@ -130,6 +133,9 @@ private:
     SSL* ssl_;
     BIO* ext_bio_;
 
+    // Capacity of the BIO pair's outgoing buffer. Holds gOpensslRecordsPerWrite records.
+    std::size_t output_buffer_size_;
+
     // TLS SNI server name
     std::string _remoteHostName;
 
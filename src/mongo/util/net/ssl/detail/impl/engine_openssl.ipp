@@ -21,7 +21,9 @@
 #include "asio/detail/throw_error.hpp"
 #include "asio/error.hpp"
 #include "mongo/util/net/ssl/detail/engine.hpp"
+#include "mongo/util/net/ssl/detail/stream_core.hpp"
 #include "mongo/util/net/ssl/error.hpp"
+#include "mongo/util/net/ssl_parameters_gen.h"
 
 #include "asio/detail/push_options.hpp"
 
@@ -30,7 +32,9 @@ namespace ssl {
 namespace detail {
 
 engine::engine(SSL_CTX* context, const std::string& remoteHostName)
-    : ssl_(::SSL_new(context)), _remoteHostName(remoteHostName) {
+    : ssl_(::SSL_new(context)),
+      output_buffer_size_(stream_core::max_tls_record_size * mongo::gOpensslRecordsPerWrite),
+      _remoteHostName(remoteHostName) {
     if (!ssl_) {
         asio::error_code ec(static_cast<int>(::ERR_get_error()), asio::error::get_ssl_category());
         asio::detail::throw_error(ec, "engine");
@@ -45,7 +49,7 @@ engine::engine(SSL_CTX* context, const std::string& remoteHostName)
     ::SSL_set_mode(ssl_, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
 
     ::BIO* int_bio = nullptr;
-    ::BIO_new_bio_pair(&int_bio, 0, &ext_bio_, 0);
+    ::BIO_new_bio_pair(&int_bio, output_buffer_size_, &ext_bio_, 0);
     ::SSL_set_bio(ssl_, int_bio, int_bio);
 }
 
@@ -119,6 +123,10 @@ asio::mutable_buffer engine::get_output(const asio::mutable_buffer& data) {
     return asio::buffer(data, length > 0 ? static_cast<std::size_t>(length) : 0);
 }
 
+std::size_t engine::output_buffer_size() const {
+    return output_buffer_size_;
+}
+
 asio::const_buffer engine::put_input(const asio::const_buffer& data) {
     int length = ::BIO_write(ext_bio_, data.data(), static_cast<int>(data.size()));
 
@@ -256,7 +264,24 @@ int engine::do_read(void* data, std::size_t length) {
 }
 
 int engine::do_write(void* data, std::size_t length) {
-    return ::SSL_write(ssl_, data, length < INT_MAX ? static_cast<int>(length) : INT_MAX);
+    // With SSL_MODE_ENABLE_PARTIAL_WRITE each SSL_write produces at most one record. Keep
+    // encrypting while the BIO pair has room for another whole record, so that the caller flushes
+    // up to output_buffer_size_ bytes per socket write rather than one record at a time.
+    auto bytes = static_cast<const char*>(data);
+    std::size_t written = 0;
+    do {
+        std::size_t remaining = length - written;
+        int result = ::SSL_write(
+            ssl_, bytes + written, remaining < INT_MAX ? static_cast<int>(remaining) : INT_MAX);
+        if (result <= 0) {
+            return written > 0 ? static_cast<int>(written) : result;
+        }
+        written += result;
+    } while (written < length &&
+             ::BIO_ctrl_get_write_guarantee(::SSL_get_wbio(ssl_)) >=
+                 stream_core::max_tls_record_size);
+
+    return static_cast<int>(written);
 }
 
 }  // namespace detail
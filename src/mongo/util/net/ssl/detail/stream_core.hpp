@@ -54,7 +54,11 @@ struct stream_core {
         : engine_(context, remoteHostName),
           pending_read_(io_context),
           pending_write_(io_context),
+#if MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+          output_buffer_space_(engine_.output_buffer_size()),
+#else
           output_buffer_space_(max_tls_record_size),
+#endif
           output_buffer_(asio::buffer(output_buffer_space_)),
           input_buffer_space_(max_tls_record_size),
           input_buffer_(asio::buffer(input_buffer_space_)) {
@@ -42,6 +42,20 @@ ReadThroughCacheBase::ReadThroughCacheBase(Mutex& mutex,
 
 ReadThroughCacheBase::~ReadThroughCacheBase() = default;
 
+ReadThroughCacheBase::Stats ReadThroughCacheBase::getStats() const {
+    Stats stats;
+    stats.numLookups = _numLookups.load();
+    stats.totalLookupMicros = _totalLookupMicros.load();
+    stats.numStaleValuesServed = _numStaleValuesServed.load();
+    stats.totalStalenessMillis = _totalStalenessMillis.load();
+    stats.maxStalenessMillis = _maxStalenessMillisServed.load();
+    return stats;
+}
+
+void ReadThroughCacheBase::setMaxStaleness(Milliseconds maxStaleness) {
+    _maxStalenessMillis.store(std::max(durationCount<Milliseconds>(maxStaleness), 0LL));
+}
+
 struct ReadThroughCacheBase::CancelToken::TaskInfo {
     TaskInfo(ServiceContext* service, Mutex& mutex) : service(service), mutex(mutex) {}
 
@@ -103,4 +117,20 @@ Date_t ReadThroughCacheBase::_now() {
     return _serviceContext->getFastClockSource()->now();
 }
 
+void ReadThroughCacheBase::_recordLookup(Microseconds duration) {
+    _numLookups.addAndFetch(1);
+    _totalLookupMicros.addAndFetch(durationCount<Microseconds>(duration));
+}
+
+void ReadThroughCacheBase::_recordStaleValueServed(Milliseconds staleness) {
+    const auto stalenessMillis = durationCount<Milliseconds>(staleness);
+    _numStaleValuesServed.addAndFetch(1);
+    _totalStalenessMillis.addAndFetch(stalenessMillis);
+
+    auto maxStalenessMillis = _maxStalenessMillisServed.load();
+    while (stalenessMillis > maxStalenessMillis &&
+           !_maxStalenessMillisServed.compareAndSwap(&maxStalenessMillis, stalenessMillis)) {
+    }
+}
+
 }  // namespace mongo
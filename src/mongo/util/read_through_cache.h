@@ -38,6 +38,8 @@
 #include "mongo/util/functional.h"
 #include "mongo/util/future.h"
 #include "mongo/util/invalidating_lru_cache.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -48,6 +50,38 @@ class ReadThroughCacheBase {
     ReadThroughCacheBase(const ReadThroughCacheBase&) = delete;
     ReadThroughCacheBase& operator=(const ReadThroughCacheBase&) = delete;
 
+public:
+    /**
+     * Statistics about the lookups performed by the cache and the stale values it served.
+     */
+    struct Stats {
+        // Number of invocations of the blocking 'lookup' function (whether successful or not) and
+        // the total time spent in them
+        long long numLookups{0};
+        long long totalLookupMicros{0};
+
+        // Number of acquisitions, which were served a stale value while a refresh was running in
+        // the background, the total and the highest time since the served values were invalidated
+        long long numStaleValuesServed{0};
+        long long totalStalenessMillis{0};
+        long long maxStalenessMillis{0};
+    };
+
+    Stats getStats() const;
+
+    /**
+     * Enables the "stale-while-revalidate" mode of the cache if 'maxStaleness' is greater than
+     * zero or disables it otherwise.
+     *
+     * In this mode, instead of blocking callers of 'acquireAsync' with a causal consistency of
+     * 'kLatestCached' until a lookup completes, a value which was invalidated no more than
+     * 'maxStaleness' ago is returned to them (with isValid = false), while a single lookup
+     * refreshes it in the background. A stale value stops being served as soon as that lookup
+     * completes, unless it failed, which allows the value to ride over temporary failures of the
+     * backing store for up to 'maxStaleness'.
+     */
+    void setMaxStaleness(Milliseconds maxStaleness);
+
 protected:
     ReadThroughCacheBase(Mutex& mutex, ServiceContext* service, ThreadPoolInterface& threadPool);
 
@@ -80,6 +114,13 @@ protected:
 
     Date_t _now();
 
+    Milliseconds _maxStaleness() const {
+        return Milliseconds(_maxStalenessMillis.load());
+    }
+
+    void _recordLookup(Microseconds duration);
+    void _recordStaleValueServed(Milliseconds staleness);
+
     // Service context under which this cache has been instantiated (used for access to service-wide
     // functionality, such as client/operation context creation)
     ServiceContext* const _serviceContext;
@@ -95,6 +136,16 @@ protected:
     // Used to protect calls to 'tryCancel' above. Has a lock level of 2, meaning what while held,
     // it is only allowed to take the Client lock.
     Mutex _cancelTokenMutex = MONGO_MAKE_LATCH("ReadThroughCacheBase::_cancelTokenMutex");
+
+    // See the comments on 'setMaxStaleness'. Zero means the mode is disabled.
+    AtomicWord<long long> _maxStalenessMillis{0};
+
+    // Backing storage for the values returned by 'getStats'
+    AtomicWord<long long> _numLookups{0};
+    AtomicWord<long long> _totalLookupMicros{0};
+    AtomicWord<long long> _numStaleValuesServed{0};
+    AtomicWord<long long> _totalStalenessMillis{0};
+    AtomicWord<long long> _maxStalenessMillisServed{0};
 };
 
 template <typename Result, typename Key, typename Value, typename Time>
@@ -254,9 +305,16 @@ public:
         if (auto cachedValue = _cache.get(key, causalConsistency))
             return {std::move(cachedValue)};
 
+        // In stale-while-revalidate mode, serve the recently invalidated value instead of waiting
+        // for the lookup
+        auto staleValue = _getStaleValue(ul, key, causalConsistency);
+
         // Join an in-progress lookup if one has already been scheduled
-        if (auto it = _inProgressLookups.find(key); it != _inProgressLookups.end())
+        if (auto it = _inProgressLookups.find(key); it != _inProgressLookups.end()) {
+            if (staleValue)
+                return {std::move(*staleValue)};
             return it->second->addWaiter(ul);
+        }
 
         // Schedule an asynchronous lookup for the key
         auto [cachedValue, timeInStore] = _cache.getCachedValueAndTimeInStore(key);
@@ -266,7 +324,11 @@ public:
                 *this, key, ValueHandle(std::move(cachedValue)), std::move(timeInStore)));
         invariant(emplaced);
         auto& inProgressLookup = *it->second;
-        auto sharedFutureToReturn = inProgressLookup.addWaiter(ul);
+
+        // A lookup without waiters still runs to completion and places its result on the cache
+        auto sharedFutureToReturn = staleValue
+            ? SharedSemiFuture<ValueHandle>(std::move(*staleValue))
+            : inProgressLookup.addWaiter(ul);
 
         ul.unlock();
 
@@ -295,6 +357,7 @@ public:
         stdx::lock_guard lg(_mutex);
         if (auto it = _inProgressLookups.find(key); it != _inProgressLookups.end())
             it->second->invalidateAndCancelCurrentLookupRound(lg);
+        _staleValues.erase(key);
         return _cache.insertOrAssignAndGet(key, {std::move(newValue), updateWallClockTime});
     }
 
@@ -322,12 +385,15 @@ public:
      *    yet completed) will be internally interrupted and rescheduled again, as if 'acquireAsync'
      *    was called *after* the call to invalidate
      *
-     * In essence, the invalidate calls serve as a "barrier" for the affected keys.
+     * In essence, the invalidate calls serve as a "barrier" for the affected keys. The only
+     * exception is the stale-while-revalidate mode (see 'setMaxStaleness'), in which the
+     * invalidated values may still be returned, but with isValid = false.
      */
     void invalidate(const Key& key) {
         stdx::lock_guard lg(_mutex);
         if (auto it = _inProgressLookups.find(key); it != _inProgressLookups.end())
             it->second->invalidateAndCancelCurrentLookupRound(lg);
+        _stashStaleValue(lg, key);
         _cache.invalidate(key);
     }
 
@@ -341,6 +407,7 @@ public:
             if (predicate(entry.first))
                 entry.second->invalidateAndCancelCurrentLookupRound(lg);
         }
+        _stashStaleValuesIf(lg, [&](const Key& key, const Value&) { return predicate(key); });
         _cache.invalidateIf([&](const Key& key, const StoredValue*) { return predicate(key); });
     }
 
@@ -350,6 +417,7 @@ public:
     template <typename Pred>
     void invalidateCachedValueIf(const Pred& predicate) {
         stdx::lock_guard lg(_mutex);
+        _stashStaleValuesIf(lg, [&](const Key&, const Value& value) { return predicate(value); });
         _cache.invalidateIf(
             [&](const Key&, const StoredValue* value) { return predicate(value->value); });
     }
@@ -400,6 +468,96 @@ protected:
 private:
     using InProgressLookupsMap = stdx::unordered_map<Key, std::unique_ptr<InProgressLookup>>;
 
+    /**
+     * A value which was invalidated while the stale-while-revalidate mode was enabled, along with
+     * the time of its invalidation.
+     */
+    struct StaleValue {
+        ValueHandle valueHandle;
+        Date_t invalidationTime;
+    };
+    using StaleValuesMap = stdx::unordered_map<Key, StaleValue>;
+
+    /**
+     * Drops the stale values, which are too old to be served anymore. Returns false if the
+     * stale-while-revalidate mode is disabled, in which case all of them are dropped.
+     */
+    bool _pruneStaleValues(WithLock, Date_t now) {
+        const auto maxStaleness = _maxStaleness();
+        if (maxStaleness <= Milliseconds(0)) {
+            _staleValues.clear();
+            return false;
+        }
+
+        for (auto it = _staleValues.begin(); it != _staleValues.end();) {
+            if (now - it->second.invalidationTime > maxStaleness)
+                _staleValues.erase(it++);
+            else
+                ++it;
+        }
+        return true;
+    }
+
+    /**
+     * In stale-while-revalidate mode, remembers the currently cached value for 'key', which is
+     * about to be invalidated, so that 'acquireAsync' can keep serving it. Values which were
+     * already invalidated keep their original invalidation time.
+     */
+    void _stashStaleValue(WithLock lk, const Key& key) {
+        const auto now = _now();
+        if (!_pruneStaleValues(lk, now) || _staleValues.count(key))
+            return;
+
+        if (auto cachedValue = _cache.get(key))
+            _staleValues.emplace(key, StaleValue{ValueHandle(std::move(cachedValue)), now});
+    }
+
+    /**
+     * Same as '_stashStaleValue' above, but for all the cached values which match 'predicate'.
+     */
+    template <typename Pred>
+    void _stashStaleValuesIf(WithLock lk, const Pred& predicate) {
+        const auto now = _now();
+        if (!_pruneStaleValues(lk, now))
+            return;
+
+        for (const auto& cachedItem : _cache.getCacheInfo()) {
+            if (_staleValues.count(cachedItem.key))
+                continue;
+
+            auto cachedValue = _cache.get(cachedItem.key);
+            if (!cachedValue || !predicate(cachedItem.key, cachedValue->value))
+                continue;
+
+            _staleValues.emplace(cachedItem.key,
+                                 StaleValue{ValueHandle(std::move(cachedValue)), now});
+        }
+    }
+
+    /**
+     * Returns the stale value for 'key', if the stale-while-revalidate mode is enabled, the value
+     * is within the maximum staleness and 'causalConsistency' permits it.
+     */
+    boost::optional<ValueHandle> _getStaleValue(WithLock,
+                                                const Key& key,
+                                                CacheCausalConsistency causalConsistency) {
+        auto it = _staleValues.find(key);
+        if (it == _staleValues.end())
+            return boost::none;
+
+        const auto staleness = _now() - it->second.invalidationTime;
+        if (staleness > _maxStaleness()) {
+            _staleValues.erase(it);
+            return boost::none;
+        }
+
+        if (causalConsistency != CacheCausalConsistency::kLatestCached)
+            return boost::none;
+
+        _recordStaleValueServed(staleness);
+        return it->second.valueHandle;
+    }
+
     /**
      * This method implements an asynchronous "while (!valid)" loop over 'key', which must be on the
      * in-progress map.
@@ -433,6 +591,7 @@ private:
             // 'invalidate'. Place the value on the cache and return the necessary promises to
             // signal (those which are waiting for time < time at the store).
             auto& result = sw.getValue();
+            _staleValues.erase(key);
             auto promisesToSet = inProgressLookup.getPromisesLessThanTime(ul, result.t);
 
             auto valueHandleToSet = [&] {
@@ -497,6 +656,12 @@ private:
     //
     // This map is protected by '_mutex'.
     InProgressLookupsMap _inProgressLookups;
+
+    // Keeps the values which were invalidated while the stale-while-revalidate mode was enabled
+    // and have not been refreshed yet. Protected by '_mutex'.
+    //
+    // NOTE: Must be declared after '_cache', because the stale values must be released before it.
+    StaleValuesMap _staleValues;
 };
 
 /**
@@ -541,6 +706,10 @@ public:
             OperationContext * opCtx, const Status& status) mutable noexcept {
             promise.setWith([&] {
                 uassertStatusOK(status);
+
+                Timer timer;
+                ON_BLOCK_EXIT([&] { _cache._recordLookup(timer.elapsed()); });
+
                 if constexpr (std::is_same_v<Time, CacheNotCausallyConsistent>) {
                     return _cache._lookupFn(opCtx, _key, _cachedValue);
                 } else {
@@ -35,6 +35,7 @@
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/unittest/barrier.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
 #include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/read_through_cache.h"
 #include "mongo/util/scopeguard.h"
@@ -363,6 +364,35 @@ TEST_F(ReadThroughCacheTest, CausalConsistency) {
     ASSERT(cache.acquire(_opCtx, "TestKey", CacheCausalConsistency::kLatestKnown).isValid());
 }
 
+TEST_F(ReadThroughCacheTest, StaleValueIsNotServedPastMaxStaleness) {
+    auto clockSource = std::make_unique<ClockSourceMock>();
+    auto clockSourcePtr = clockSource.get();
+    getServiceContext()->setFastClockSource(std::move(clockSource));
+
+    CacheWithThreadPool<Cache> cache(
+        getServiceContext(),
+        1,
+        [&, nextValue = 0](
+            OperationContext*, const std::string& key, const Cache::ValueHandle&) mutable {
+            return Cache::LookupResult(CachedValue(++nextValue));
+        });
+    cache.setMaxStaleness(Seconds(10));
+
+    ASSERT_EQ(1, cache.acquire(_opCtx, "TestKey")->counter);
+
+    // Once the maximum staleness has elapsed since the invalidation, acquire must wait for the
+    // lookup instead of returning the stale value
+    cache.invalidate("TestKey");
+    clockSourcePtr->advance(Seconds(11));
+
+    auto value = cache.acquire(_opCtx, "TestKey");
+    ASSERT(value.isValid());
+    ASSERT_EQ(2, value->counter);
+    ASSERT_EQ(2, cache.countLookups);
+    ASSERT_EQ(0, cache.getStats().numStaleValuesServed);
+    ASSERT_EQ(2, cache.getStats().numLookups);
+}
+
 /**
  * Fixture for tests, which need to control the creation/destruction of their operation contexts.
  */
@@ -553,6 +583,67 @@ TEST_F(ReadThroughCacheAsyncTest, InvalidateReissuesLookup) {
     ASSERT_EQ(2, future.get()->counter);
 }
 
+TEST_F(ReadThroughCacheAsyncTest, StaleWhileRevalidate) {
+    ThreadPool threadPool{ThreadPool::Options()};
+    threadPool.startup();
+
+    AtomicWord<int> countLookups(0);
+    Barrier lookupStartedBarrier(2);
+    Barrier completeLookupBarrier(2);
+    Cache cache(getServiceContext(),
+                threadPool,
+                1,
+                [&](OperationContext*, const std::string& key, const Cache::ValueHandle&) {
+                    int idx = countLookups.fetchAndAdd(1);
+                    if (idx > 0) {
+                        lookupStartedBarrier.countDownAndWait();
+                        completeLookupBarrier.countDownAndWait();
+                    }
+                    return Cache::LookupResult(CachedValue(idx));
+                });
+    cache.setMaxStaleness(Minutes(10));
+
+    // Join threads before destroying cache. This ensure the internal asynchronous processing tasks
+    // are completed before the cache resources are released.
+    ON_BLOCK_EXIT([&] {
+        threadPool.shutdown();
+        threadPool.join();
+    });
+
+    ASSERT_EQ(0, cache.acquireAsync("TestKey").get()->counter);
+
+    // After the invalidation, the stale value is returned straight away, while a single lookup
+    // refreshes it in the background
+    cache.invalidate("TestKey");
+    for (int i = 0; i < 3; i++) {
+        auto future = cache.acquireAsync("TestKey");
+        ASSERT(future.isReady());
+        auto value = future.get();
+        ASSERT(!value.isValid());
+        ASSERT_EQ(0, value->counter);
+    }
+
+    lookupStartedBarrier.countDownAndWait();
+    ASSERT_EQ(2, countLookups.load());
+    completeLookupBarrier.countDownAndWait();
+
+    // Eventually the refreshed value replaces the stale one
+    while (true) {
+        auto value = cache.acquireAsync("TestKey").get();
+        if (value->counter == 1) {
+            ASSERT(value.isValid());
+            break;
+        }
+        ASSERT_EQ(0, value->counter);
+        sleepmillis(1);
+    }
+    ASSERT_EQ(2, countLookups.load());
+
+    auto stats = cache.getStats();
+    ASSERT_EQ(2, stats.numLookups);
+    ASSERT_GTE(stats.numStaleValuesServed, 3);
+}
+
 TEST_F(ReadThroughCacheAsyncTest, AcquireWithAShutdownThreadPool) {
     ThreadPool threadPool{ThreadPool::Options()};
     threadPool.startup();
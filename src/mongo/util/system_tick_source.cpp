@@ -39,6 +39,14 @@
 #include <unistd.h>
 #endif
 #include <memory>
+#if defined(__linux__) && defined(__x86_64__)
+#include <boost/optional.hpp>
+#include <cmath>
+#include <cpuid.h>
+#include <fstream>
+#include <string>
+#include <x86intrin.h>
+#endif
 
 #include "mongo/base/init.h"
 #include "mongo/util/assert_util.h"
@@ -116,6 +124,106 @@ TickSource::Tick timerNowPosixMonotonicClock() {
     return result;
 }
 
+#if defined(__linux__) && defined(__x86_64__)
+
+/**
+ * Implementation for timer reading the time stamp counter of x86-64 processors, which avoids the
+ * overhead of going through clock_gettime(), even in the vDSO, in hot timing loops.
+ *
+ * This is only used when the counter is known to be reliable: the processor must advertise an
+ * invariant TSC, which ticks at a constant rate regardless of frequency scaling and sleep states,
+ * and the kernel must have selected it as its own clocksource, which it only does once it has
+ * verified that the counters of all the processors are synchronized.
+ */
+TickSource::Tick timerNowTsc() {
+    return __rdtsc();
+}
+
+bool haveReliableTsc() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) {
+        return false;
+    }
+
+    std::ifstream clocksource("/sys/devices/system/clocksource/clocksource0/current_clocksource");
+    std::string name;
+    return (clocksource >> name) && name == "tsc";
+}
+
+/**
+ * A CLOCK_MONOTONIC reading, along with the time stamp counter at the time of the reading.
+ */
+struct TscSample {
+    long long nanos;
+    TickSource::Tick tsc;
+
+    // The number of counter ticks between the two counter reads bracketing the clock reading.
+    // 'tsc' is off by at most half of it.
+    TickSource::Tick bracket;
+};
+
+/**
+ * Reads CLOCK_MONOTONIC several times, each bracketed by two counter reads, and keeps the reading
+ * with the tightest bracket, since a wide one means the reading was delayed by an interrupt, a
+ * preemption or a page fault.
+ */
+TscSample sampleTsc() {
+    const int kReadings = 5;
+    TscSample best{0, 0, std::numeric_limits<TickSource::Tick>::max()};
+    for (int i = 0; i < kReadings; ++i) {
+        timespec the_time;
+        const auto before = __rdtsc();
+        fassert(4798600, !clock_gettime(CLOCK_MONOTONIC, &the_time));
+        const auto bracket = static_cast<TickSource::Tick>(__rdtsc() - before);
+        if (bracket < best.bracket) {
+            best.nanos =
+                static_cast<long long>(the_time.tv_sec) * kNanosPerSecond + the_time.tv_nsec;
+            best.tsc = before + bracket / 2;
+            best.bracket = bracket;
+        }
+    }
+    return best;
+}
+
+/**
+ * Measures the frequency of the time stamp counter against CLOCK_MONOTONIC, over a short and a
+ * longer period starting at the same reading. Returns boost::none, so that the counter is not
+ * used, if the error bounded by the brackets of the readings is too large or if the two periods
+ * disagree about the frequency.
+ */
+boost::optional<TickSource::Tick> calibrateTsc() {
+    // The largest relative error tolerated in the measured frequency.
+    const double kMaxError = 1e-4;
+
+    const auto start = sampleTsc();
+    sleepmillis(10);
+    const auto shortEnd = sampleTsc();
+    sleepmillis(40);
+    const auto longEnd = sampleTsc();
+
+    const auto isPrecise = [&](const TscSample& end) {
+        const auto maxTscError = static_cast<double>(start.bracket + end.bracket) / 2;
+        return end.tsc > start.tsc && end.nanos > start.nanos &&
+            maxTscError <= kMaxError * (end.tsc - start.tsc);
+    };
+    if (!isPrecise(shortEnd) || !isPrecise(longEnd)) {
+        return boost::none;
+    }
+
+    const auto frequency = [&](const TscSample& end) {
+        return static_cast<double>(end.tsc - start.tsc) * kNanosPerSecond /
+            (end.nanos - start.nanos);
+    };
+    const auto shortFrequency = frequency(shortEnd);
+    const auto longFrequency = frequency(longEnd);
+    if (std::abs(shortFrequency - longFrequency) > kMaxError * longFrequency) {
+        return boost::none;
+    }
+    return static_cast<TickSource::Tick>(longFrequency);
+}
+
+#endif
+
 void initTickSource() {
     // If the monotonic clock is not available at runtime (sysconf() returns 0 or -1),
     // do not override the generic implementation or modify ticksPerSecond.
@@ -123,6 +231,18 @@ void initTickSource() {
         return;
     }
 
+#if defined(__linux__) && defined(__x86_64__)
+    if (haveReliableTsc()) {
+        // The counter ticks at a constant rate, so it only needs to be calibrated once. Adjusting
+        // the rate afterwards would make the intervals measured across the adjustment jump.
+        if (auto tscTicksPerSecond = calibrateTsc()) {
+            ticksPerSecond = *tscTicksPerSecond;
+            _timerNow = &timerNowTsc;
+            return;
+        }
+    }
+#endif
+
     ticksPerSecond = kNanosPerSecond;
     _timerNow = &timerNowPosixMonotonicClock;
 
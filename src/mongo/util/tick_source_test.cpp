@@ -30,8 +30,10 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/system_tick_source.h"
 #include "mongo/util/tick_source.h"
 #include "mongo/util/tick_source_mock.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -52,5 +54,21 @@ TEST(TickSourceTest, TicksToDurationConversion) {
     tsMicros.reset(1);
     ASSERT_EQ(tsMicros.ticksTo<Microseconds>(tsMicros.getTicks()).count(), 1);
 }
+
+TEST(TickSourceTest, SystemTickSourceAgreesWithSystemClock) {
+    // Whichever implementation was selected at startup, its ticks must convert to real time.
+    auto tickSource = SystemTickSource::get();
+    ASSERT_GT(tickSource->getTicksPerSecond(), 0);
+
+    const auto startTicks = tickSource->getTicks();
+    const auto startMicros = curTimeMicros64();
+    sleepmillis(100);
+    const auto elapsedTicks = tickSource->getTicks() - startTicks;
+    const auto elapsedMicros = curTimeMicros64() - startMicros;
+
+    const auto measured = tickSource->ticksTo<Microseconds>(elapsedTicks).count();
+    ASSERT_GTE(measured, 100 * 1000 * 9 / 10);
+    ASSERT_LTE(measured, static_cast<long long>(elapsedMicros) * 11 / 10);
+}
 }  // namespace
 }  // namespace mongo